@@ -0,0 +1,14 @@
+# Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+find_path(LIBURING_INCLUDE_DIR liburing.h)
+
+find_library(LIBURING_LIBRARY NAMES uring)
+
+if (LIBURING_INCLUDE_DIR AND LIBURING_LIBRARY)
+    set(LIBURING_FOUND TRUE)
+    message(STATUS "Found liburing library: ${LIBURING_LIBRARY}")
+endif ()
@@ -63,6 +63,13 @@ find_package(LZ4 REQUIRED)
 find_package(Sqlite REQUIRED)
 find_package(Snappy REQUIRED)
 find_package(LibIberty REQUIRED)
+# Optional, used for io_uring reads in RocksDBEnv.
+find_package(Liburing)
+if(LIBURING_FOUND)
+  add_definitions(-DLOGDEVICE_HAVE_LIBURING)
+  include_directories(${LIBURING_INCLUDE_DIR})
+  set(LIBURING_LIBRARIES ${LIBURING_LIBRARY})
+endif()
 include_directories(${LOGDEVICE_STAGING_DIR}/usr/local/include)
 include_directories(${JEMALLOC_INCLUDE_DIR})
 include_directories(${LIBSODIUM_INCLUDE_DIR})
@@ -8,7 +8,10 @@
 
 #include "logdevice/admin/AdminCommandAPIHandler.h"
 
+#include <algorithm>
+
 #include <folly/io/Cursor.h>
+#include <thrift/lib/cpp2/async/ServerStream.h>
 
 namespace facebook { namespace logdevice {
 
@@ -31,4 +34,43 @@ AdminCommandAPIHandler::semifuture_executeAdminCommand(
         return response;
       });
 }
+
+// check admin.thrift for documentation
+apache::thrift::ResponseAndServerStream<thrift::AdminCommandStreamResponse,
+                                        thrift::AdminCommandResponse>
+AdminCommandAPIHandler::streamAdminCommand(
+    std::unique_ptr<thrift::AdminCommandStreamRequest> request) {
+  if (admin_command_handler_ == nullptr) {
+    throw thrift::NotSupported("AdminCommands are not supported on this host");
+  }
+  if (*request->chunk_size_ref() <= 0) {
+    throw thrift::InvalidRequest("chunk_size must be positive");
+  }
+  const size_t chunk_size = *request->chunk_size_ref();
+
+  auto [stream, publisher] =
+      apache::thrift::ServerStream<thrift::AdminCommandResponse>::
+          createPublisher();
+  admin_command_handler_(
+      *request->request_ref(), *getConnectionContext()->getPeerAddress())
+      .via(folly::getCPUExecutor().get())
+      .thenTry([chunk_size, publisher = std::move(publisher)](
+                   folly::Try<std::unique_ptr<folly::IOBuf>>&& buf) mutable {
+        if (buf.hasException()) {
+          std::move(publisher).complete(std::move(buf.exception()));
+          return;
+        }
+        // Send the output as it is laid out in the chain, only copying each
+        // chunk into its response.
+        folly::io::Cursor cursor(buf->get());
+        while (!cursor.isAtEnd()) {
+          thrift::AdminCommandResponse chunk;
+          *chunk.response_ref() = cursor.readFixedString(
+              std::min(chunk_size, cursor.totalLength()));
+          publisher.next(std::move(chunk));
+        }
+        std::move(publisher).complete();
+      });
+  return {thrift::AdminCommandStreamResponse(), std::move(stream)};
+}
 }} // namespace facebook::logdevice
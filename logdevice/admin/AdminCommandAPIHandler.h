@@ -20,6 +20,13 @@ class AdminCommandAPIHandler : public virtual AdminAPIHandlerBase {
   semifuture_executeAdminCommand(
       std::unique_ptr<thrift::AdminCommandRequest> request) override;
 
+  // check admin.thrift for documentation
+  virtual apache::thrift::ResponseAndServerStream<
+      thrift::AdminCommandStreamResponse,
+      thrift::AdminCommandResponse>
+  streamAdminCommand(
+      std::unique_ptr<thrift::AdminCommandStreamRequest> request) override;
+
   virtual void setAdminCommandHandler(AdminCommandHandler handler) {
     admin_command_handler_ = std::move(handler);
   }
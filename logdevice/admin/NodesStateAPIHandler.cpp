@@ -8,16 +8,22 @@
 
 #include "logdevice/admin/NodesStateAPIHandler.h"
 
+#include <folly/executors/GlobalExecutor.h>
+#include <thrift/lib/cpp2/async/ServerStream.h>
+
 #include "logdevice/admin/AdminAPIUtils.h"
 #include "logdevice/admin/maintenance/MaintenanceManager.h"
 #include "logdevice/common/Processor.h"
 #include "logdevice/common/configuration/UpdateableConfig.h"
 #include "logdevice/common/event_log/EventLogRebuildingSet.h"
 
+using apache::thrift::ResponseAndServerStream;
+using apache::thrift::ServerStream;
 using facebook::logdevice::thrift::InvalidRequest;
 using facebook::logdevice::thrift::NodesFilter;
 using facebook::logdevice::thrift::NodesStateRequest;
 using facebook::logdevice::thrift::NodesStateResponse;
+using facebook::logdevice::thrift::NodesStateStreamResponse;
 
 namespace facebook { namespace logdevice {
 void NodesStateAPIHandler::toNodeState(thrift::NodeState& out,
@@ -84,4 +90,58 @@ NodesStateAPIHandler::semifuture_getNodesState(
   }
 }
 
+ResponseAndServerStream<NodesStateStreamResponse, thrift::NodeState>
+NodesStateAPIHandler::streamNodesState(std::unique_ptr<NodesStateRequest> req) {
+  if (req == nullptr) {
+    throw InvalidRequest("Cannot accept streamNodesState without arguments");
+  }
+
+  auto filter = req->filter_ref().value_or(NodesFilter());
+  auto [stream, publisher] = ServerStream<thrift::NodeState>::createPublisher();
+  NodesStateStreamResponse response;
+
+  if (isMaintenanceManagerEnabled()) {
+    // The maintenance manager computes the states of all nodes at once, we can
+    // only spare the client from receiving them in one response.
+    auto expected_output =
+        maintenance_manager_->getNodesState(std::move(filter)).get();
+    if (expected_output.hasError()) {
+      expected_output.error().throwThriftException();
+      ld_check(false);
+    }
+    NodesStateResponse& output = expected_output.value();
+    response.set_version(output.get_version());
+    for (auto& node_state : *output.states_ref()) {
+      publisher.next(std::move(node_state));
+    }
+    std::move(publisher).complete();
+    return {std::move(response), std::move(stream)};
+  }
+
+  // Compute the state of each node only when it's its turn to be streamed.
+  auto nodes_configuration = processor_->getNodesConfiguration();
+  response.set_version(
+      static_cast<int64_t>(nodes_configuration->getVersion().val()));
+  const bool force = req->force_ref().value_or(false);
+  folly::getCPUExecutor()->add([this,
+                                filter = std::move(filter),
+                                nodes_configuration,
+                                force,
+                                publisher = std::move(publisher)]() mutable {
+    try {
+      forFilteredNodes(*nodes_configuration, &filter, [&](node_index_t index) {
+        thrift::NodeState node_state;
+        toNodeState(node_state, index, force);
+        publisher.next(std::move(node_state));
+      });
+    } catch (...) {
+      std::move(publisher).complete(
+          folly::exception_wrapper(std::current_exception()));
+      return;
+    }
+    std::move(publisher).complete();
+  });
+  return {std::move(response), std::move(stream)};
+}
+
 }} // namespace facebook::logdevice
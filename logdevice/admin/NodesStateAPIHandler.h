@@ -26,6 +26,12 @@ class NodesStateAPIHandler : public virtual AdminAPIHandlerBase {
   semifuture_getNodesState(
       std::unique_ptr<thrift::NodesStateRequest> request) override;
 
+  // See admin.thrift for documentation
+  virtual apache::thrift::ResponseAndServerStream<
+      thrift::NodesStateStreamResponse,
+      thrift::NodeState>
+  streamNodesState(std::unique_ptr<thrift::NodesStateRequest> request) override;
+
  private:
   void toNodeState(thrift::NodeState& out, thrift::NodeIndex index, bool force);
 };
@@ -44,6 +44,17 @@ service AdminAPI extends fb303.FacebookService {
    nodes.NodesStateResponse getNodesState(1: nodes.NodesStateRequest request)
        throws (1: exceptions.NodeNotReady notready) (cpp.coroutine);
 
+  /**
+   * Same as getNodesState(), but streams the state of each node instead of
+   * returning them all in one response. Meant for large clusters, where the
+   * response of getNodesState() is huge. Unless the maintenance manager runs
+   * on this node, states are computed as they are streamed, so the server
+   * never holds all of them at once. NodeNotReady is reported by terminating
+   * the stream with it.
+   */
+   nodes.NodesStateStreamResponse, stream<nodes.NodeState> streamNodesState(
+       1: nodes.NodesStateRequest request);
+
   /**
    * Add new nodes to the cluster. The request should contain the spec of each
    * added node (as nodes.NodeConfig). The admin server will then add them to
@@ -329,6 +340,17 @@ service AdminAPI extends fb303.FacebookService {
     1: admin_commands.AdminCommandRequest request) throws
     (1: exceptions.NotSupported notsupported) (cpp.coroutine);
 
+  /**
+   * Same as executeAdminCommand(), but streams the output of the command in
+   * chunks of at most `chunk_size` bytes rather than in one response.
+   * Concatenating the chunks gives the response of executeAdminCommand().
+   */
+  admin_commands.AdminCommandStreamResponse,
+    stream<admin_commands.AdminCommandResponse> streamAdminCommand(
+    1: admin_commands.AdminCommandStreamRequest request) throws
+    (1: exceptions.NotSupported notsupported,
+     2: exceptions.InvalidRequest invalid_request);
+
 
   /**
    * Returns the configured cluster name.
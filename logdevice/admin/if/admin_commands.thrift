@@ -19,3 +19,14 @@ struct AdminCommandRequest {
 struct AdminCommandResponse {
   1: string response;
 }
+
+struct AdminCommandStreamRequest {
+  1: string request;
+  /**
+   * Maximum number of bytes of output per streamed AdminCommandResponse.
+   */
+  2: i32 chunk_size = 65536;
+}
+
+struct AdminCommandStreamResponse {
+}
@@ -492,6 +492,17 @@ struct NodesStateResponse {
   2: common.unsigned64 version,
 }
 
+/**
+ * Response of streamNodesState(). The states of the nodes are streamed after
+ * it.
+ */
+struct NodesStateStreamResponse {
+  /**
+   * Version of the nodes configuration the streamed states are for.
+   */
+  1: common.unsigned64 version,
+}
+
 struct NodesStateRequest {
   1: optional NodesFilter filter,
   /**
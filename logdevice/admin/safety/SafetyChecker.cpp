@@ -84,6 +84,18 @@ void SafetyChecker::onSettingsUpdate() {
   setAbortOnError(true);
   setMaxBatchSize(settings_->safety_check_max_batch_size);
   setErrorSampleSize(settings_->safety_check_failure_sample_size);
+  setCacheMaxEntries(settings_->safety_check_cache_max_entries);
+}
+
+void SafetyChecker::setCacheMaxEntries(size_t max_entries) {
+  if (max_entries == 0) {
+    availability_cache_.reset();
+  } else if (availability_cache_) {
+    availability_cache_->setMaxEntries(max_entries);
+  } else {
+    availability_cache_ =
+        std::make_shared<safety::ReadWriteAvailabilityCache>(max_entries);
+  }
 }
 
 void SafetyChecker::onLogsConfigUpdate() {
@@ -262,6 +274,14 @@ SafetyChecker::performSafetyCheck(
             local_logs_config.getLogsConfigTree();
 
         const auto nodes_config = processor_->getNodesConfiguration();
+        // Shared by internal logs and all batches, so that each storage set
+        // and replication is only evaluated once. Kept between checks unless
+        // safety-check-cache-max-entries is 0.
+        auto availability_cache = availability_cache_;
+        if (!availability_cache) {
+          availability_cache =
+              std::make_shared<safety::ReadWriteAvailabilityCache>();
+        }
         ClusterState* cluster_state = processor_->cluster_state_.get();
 
         // Check impact on capacity
@@ -346,7 +366,8 @@ SafetyChecker::performSafetyCheck(
                                                   abort_on_error_,
                                                   error_sample_size_,
                                                   nodes_config,
-                                                  cluster_state);
+                                                  cluster_state,
+                                                  availability_cache.get());
           if (impact.hasError()) {
             // The operation failed. Possibly because we don't have metadata for
             // this log-id. This is critical.
@@ -415,6 +436,8 @@ SafetyChecker::performSafetyCheck(
                                          safety_margin,
                                          this,
                                          cfg,
+                                         nodes_config,
+                                         availability_cache,
                                          cluster_state](auto&&) {
                                return safety::checkImpactOnLogs(
                                    mbatch,
@@ -427,8 +450,9 @@ SafetyChecker::performSafetyCheck(
                                    /* internal_logs = */ false,
                                    abort_on_error_,
                                    error_sample_size_,
-                                   processor_->getNodesConfiguration(),
-                                   cluster_state);
+                                   nodes_config,
+                                   cluster_state,
+                                   availability_cache.get());
                              }));
           --chunks;
         }
@@ -30,6 +30,9 @@ namespace facebook { namespace logdevice {
 
 class Processor;
 class ClusterState;
+namespace safety {
+class ReadWriteAvailabilityCache;
+}
 
 class SafetyChecker {
  public:
@@ -83,6 +86,10 @@ class SafetyChecker {
     error_sample_size_ = sample_size;
   }
 
+  // See ReadWriteAvailabilityCache. If 0, results are not kept between
+  // checks.
+  void setCacheMaxEntries(size_t max_entries);
+
  private:
   SerialWorkContext work_context_;
   void onSettingsUpdate();
@@ -160,6 +167,9 @@ class SafetyChecker {
   size_t logs_in_flight_{10000};
   bool abort_on_error_{true};
   size_t error_sample_size_{20};
+  // Results of storage set evaluations, kept between checks. nullptr if
+  // disabled.
+  std::shared_ptr<safety::ReadWriteAvailabilityCache> availability_cache_;
 };
 
 }} // namespace facebook::logdevice
@@ -16,6 +16,72 @@ using namespace facebook::logdevice::configuration;
 
 namespace facebook { namespace logdevice { namespace safety {
 
+std::pair<bool, bool> ReadWriteAvailabilityCache::getOrCompute(
+    const ShardAuthoritativeStatusMap& shard_status,
+    const ShardSet& op_shards,
+    const StorageSet& storage_set,
+    StorageState target_storage_state,
+    const ReplicationProperty& replication,
+    const SafetyMargin& safety_margin,
+    const std::shared_ptr<const nodes::NodesConfiguration>& nodes_config,
+    ClusterState* cluster_state,
+    bool require_fully_started,
+    folly::FunctionRef<std::pair<bool, bool>()> compute) {
+  const auto& storage_membership = nodes_config->getStorageMembership();
+  std::vector<uint16_t> shard_states;
+  shard_states.reserve(storage_set.size());
+  for (const ShardID& shard : storage_set) {
+    uint16_t shard_state =
+        static_cast<uint16_t>(shard_status.getShardStatus(shard)) << 8;
+    shard_state |= op_shards.count(shard) ? 1 : 0;
+    shard_state |=
+        isAlive(cluster_state, shard.node(), require_fully_started) ? 2 : 0;
+    shard_state |=
+        shard_status.shardIsTimeRangeRebuilding(shard.node(), shard.shard())
+        ? 4
+        : 0;
+    shard_state |= storage_membership->canWriteToShard(shard) ? 8 : 0;
+    shard_state |= storage_membership->shouldReadFromShard(shard) ? 16 : 0;
+    shard_states.push_back(shard_state);
+  }
+  Key key(storage_set,
+          replication.getDistinctReplicationFactors(),
+          require_fully_started,
+          target_storage_state,
+          safety_margin,
+          std::move(shard_states));
+
+  const auto version = nodes_config->getVersion();
+  {
+    auto state = state_.rlock();
+    if (state->nodes_config_version == version) {
+      auto it = state->results.find(key);
+      if (it != state->results.end()) {
+        return it->second;
+      }
+    }
+  }
+  // Computed outside of the lock. Another thread may compute the same result
+  // concurrently, that's fine.
+  auto result = compute();
+  ++misses_;
+  auto state = state_.wlock();
+  if (state->nodes_config_version != version) {
+    // Results computed with an older nodes configuration are useless. A check
+    // still running with an older one doesn't get to cache its results.
+    if (state->nodes_config_version > version) {
+      return result;
+    }
+    state->results.clear();
+    state->nodes_config_version = version;
+  }
+  if (state->results.size() >= max_entries_.load()) {
+    state->results.clear();
+  }
+  state->results.emplace(std::move(key), result);
+  return result;
+}
+
 folly::Expected<Impact, Status> checkImpactOnLogs(
     const std::vector<logid_t>& log_ids,
     const std::shared_ptr<LogMetaDataFetcher::Results>& metadata,
@@ -29,7 +95,8 @@ folly::Expected<Impact, Status> checkImpactOnLogs(
     size_t error_sample_size,
     const std::shared_ptr<const configuration::nodes::NodesConfiguration>&
         nodes_config,
-    ClusterState* cluster_state) {
+    ClusterState* cluster_state,
+    ReadWriteAvailabilityCache* cache) {
   std::set<thrift::OperationImpact> impact_result_all;
   std::vector<thrift::ImpactOnEpoch> affected_logs_sample;
   size_t logs_done = 0;
@@ -47,7 +114,8 @@ folly::Expected<Impact, Status> checkImpactOnLogs(
                                    target_storage_state,
                                    safety_margin,
                                    nodes_config,
-                                   cluster_state);
+                                   cluster_state,
+                                   cache);
     logs_done++;
     if (result.hasError()) {
       // The operation failed. Possibly because we don't have metadata for
@@ -93,7 +161,8 @@ folly::Expected<thrift::ImpactOnEpoch, Status> checkImpactOnLog(
     const SafetyMargin& safety_margin,
     const std::shared_ptr<const configuration::nodes::NodesConfiguration>&
         nodes_config,
-    ClusterState* cluster_state) {
+    ClusterState* cluster_state,
+    ReadWriteAvailabilityCache* cache) {
   ld_assert(metadata_cache);
   if (metadata_cache->find(log_id) == metadata_cache->end()) {
     // We cannot find the epoch metadata for this log. This can have multiple
@@ -140,16 +209,29 @@ folly::Expected<thrift::ImpactOnEpoch, Status> checkImpactOnLog(
     bool safe_writes;
     bool safe_reads;
 
-    std::tie(safe_reads, safe_writes) =
-        checkReadWriteAvailablity(shard_status,
-                                  op_shards,
-                                  epoch_metadata.shards,
-                                  target_storage_state,
-                                  epoch_metadata.replication,
-                                  safety_margin,
-                                  nodes_config,
-                                  cluster_state,
-                                  require_fully_started);
+    auto check = [&] {
+      return checkReadWriteAvailablity(shard_status,
+                                       op_shards,
+                                       epoch_metadata.shards,
+                                       target_storage_state,
+                                       epoch_metadata.replication,
+                                       safety_margin,
+                                       nodes_config,
+                                       cluster_state,
+                                       require_fully_started);
+    };
+    std::tie(safe_reads, safe_writes) = cache
+        ? cache->getOrCompute(shard_status,
+                              op_shards,
+                              epoch_metadata.shards,
+                              target_storage_state,
+                              epoch_metadata.replication,
+                              safety_margin,
+                              nodes_config,
+                              cluster_state,
+                              require_fully_started,
+                              check)
+        : check();
 
     if (safe_writes && safe_reads) {
       continue;
@@ -7,6 +7,15 @@
  */
 #pragma once
 
+#include <atomic>
+#include <map>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <folly/Function.h>
+#include <folly/SharedMutex.h>
+#include <folly/Synchronized.h>
 #include <folly/container/F14Set.h>
 
 #include "logdevice/admin/if/gen-cpp2/safety_types.h"
@@ -20,8 +29,89 @@
 
 namespace facebook { namespace logdevice { namespace safety {
 
+/**
+ * Results of checkReadWriteAvailablity(), keyed by the storage set, the
+ * replication and everything else the result depends on: for each shard of the
+ * storage set whether it's in op_shards, its authoritative status, whether its
+ * node is alive and its storage membership state, plus the target storage
+ * state and safety margin.
+ *
+ * Most logs share their storage set and replication with many others, so each
+ * combination only needs to be evaluated once per safety check. And since the
+ * key only covers the shards of the storage set, results can be kept between
+ * safety checks: when the shards in a maintenance or their state change, only
+ * storage sets containing the changed shards are evaluated again. Cleared when
+ * the nodes configuration version changes, since the result also depends on
+ * node locations.
+ *
+ * Thread-safe: shared by the batches of logs that SafetyChecker checks in
+ * parallel, and by concurrent safety checks.
+ */
+class ReadWriteAvailabilityCache {
+ public:
+  /**
+   * @param max_entries  the cache is cleared when it reaches this size.
+   */
+  explicit ReadWriteAvailabilityCache(size_t max_entries = 100000)
+      : max_entries_(max_entries) {}
+
+  /**
+   * Returns the cached (safe_for_reads, safe_for_writes) pair for the given
+   * arguments of checkReadWriteAvailablity(), or calls `compute` and caches
+   * its result.
+   */
+  std::pair<bool, bool> getOrCompute(
+      const ShardAuthoritativeStatusMap& shard_status,
+      const ShardSet& op_shards,
+      const StorageSet& storage_set,
+      configuration::StorageState target_storage_state,
+      const ReplicationProperty& replication,
+      const SafetyMargin& safety_margin,
+      const std::shared_ptr<const configuration::nodes::NodesConfiguration>&
+          nodes_config,
+      ClusterState* cluster_state,
+      bool require_fully_started,
+      folly::FunctionRef<std::pair<bool, bool>()> compute);
+
+  void setMaxEntries(size_t max_entries) {
+    max_entries_.store(max_entries);
+  }
+
+  size_t size() const {
+    return state_.rlock()->results.size();
+  }
+
+  // Number of getOrCompute() calls that called `compute`.
+  size_t misses() const {
+    return misses_.load();
+  }
+
+ private:
+  using Key = std::tuple<StorageSet,
+                         std::vector<ReplicationProperty::ScopeReplication>,
+                         bool,
+                         configuration::StorageState,
+                         SafetyMargin,
+                         // State of each shard of the storage set.
+                         std::vector<uint16_t>>;
+
+  struct State {
+    // Version of the nodes configuration the results were computed with.
+    membership::MembershipVersion::Type nodes_config_version{
+        membership::MembershipVersion::EMPTY_VERSION};
+    std::map<Key, std::pair<bool, bool>> results;
+  };
+
+  folly::Synchronized<State, folly::SharedMutex> state_;
+  std::atomic<size_t> max_entries_;
+  std::atomic<size_t> misses_{0};
+};
+
 /**
  * Performs safety check on given logs
+ *
+ * @param cache  if not nullptr, used to avoid evaluating the same storage
+ *               set and replication more than once.
  */
 folly::Expected<Impact, Status> checkImpactOnLogs(
     const std::vector<logid_t>& log_ids,
@@ -36,7 +126,8 @@ folly::Expected<Impact, Status> checkImpactOnLogs(
     size_t error_sample_size,
     const std::shared_ptr<const configuration::nodes::NodesConfiguration>&
         nodes_config,
-    ClusterState* cluster_state);
+    ClusterState* cluster_state,
+    ReadWriteAvailabilityCache* cache = nullptr);
 /**
  * Perform safety check on a single log.
  */
@@ -50,7 +141,8 @@ folly::Expected<thrift::ImpactOnEpoch, Status> checkImpactOnLog(
     const SafetyMargin& safety_margin,
     const std::shared_ptr<const configuration::nodes::NodesConfiguration>&
         nodes_config,
-    ClusterState* cluster_state);
+    ClusterState* cluster_state,
+    ReadWriteAvailabilityCache* cache = nullptr);
 
 /**
  * Checks whether a node is alive in the FailureDetector (gossip) or not.
@@ -72,6 +72,17 @@ void AdminServerSettings::defineSettings(SettingEasyInit& init) {
      SERVER,
      SettingsCategory::AdminAPI)
 
+    ("safety-check-cache-max-entries", &safety_check_cache_max_entries,
+     "100000",
+     nullptr,
+     "The maximum number of storage set evaluations that the safety checker "
+     "keeps between checks. A storage set is only evaluated again if the state "
+     "of one of its shards changed, which makes repeated checks of "
+     "maintenances much cheaper. If 0, results are only reused within a "
+     "single check.",
+     SERVER,
+     SettingsCategory::AdminAPI)
+
     ("max-unavailable-storage-capacity-pct",
      &max_unavailable_storage_capacity_pct,
      "25",
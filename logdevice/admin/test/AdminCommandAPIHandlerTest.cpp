@@ -42,3 +42,35 @@ TEST(AdminCommandAPIHandlerTest, testExecuteAdminCommand) {
     EXPECT_EQ(10000000 + 5 /* "aaaa...aEND\r\n" */, resp.get_response().size());
   }
 }
+
+TEST(AdminCommandAPIHandlerTest, testStreamAdminCommand) {
+  auto cluster = IntegrationTestUtils::ClusterFactory()
+                     .useHashBasedSequencerAssignment()
+                     .create(1);
+  ASSERT_EQ(0, cluster->start());
+  cluster->getNode(0).waitUntilAvailable();
+  auto admin_client = cluster->getNode(0).createAdminClient();
+
+  // The output is split in chunks of at most chunk_size bytes, which add up to
+  // the response of executeAdminCommand().
+  thrift::AdminCommandStreamRequest request;
+  request.set_request("fill 1000000 a");
+  request.set_chunk_size(4096);
+  auto result = admin_client->sync_streamAdminCommand(std::move(request));
+  std::string output;
+  size_t nchunks = 0;
+  std::move(result.stream)
+      .subscribeInline([&](folly::Try<thrift::AdminCommandResponse>&& chunk) {
+        ASSERT_FALSE(chunk.hasException());
+        if (!chunk.hasValue()) {
+          // End of the stream.
+          return;
+        }
+        EXPECT_LE(chunk->get_response().size(), 4096);
+        output += chunk->get_response();
+        ++nchunks;
+      });
+  EXPECT_EQ(1000000 + 5 /* "aaaa...aEND\r\n" */, output.size());
+  EXPECT_EQ(std::string(1000000, 'a') + "END\r\n", output);
+  EXPECT_GT(nchunks, 1);
+}
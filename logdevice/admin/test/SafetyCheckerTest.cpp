@@ -9,6 +9,9 @@
 
 #include <gtest/gtest.h>
 
+#include "logdevice/admin/safety/SafetyCheckerUtils.h"
+#include "logdevice/common/test/NodesConfigurationTestUtil.h"
+
 using namespace facebook::logdevice;
 
 TEST(SafetyCheckerTest, Parse) {
@@ -21,3 +24,67 @@ TEST(SafetyCheckerTest, Parse) {
   ASSERT_EQ(2, safety_margin2[NodeLocationScope::RACK]);
   ASSERT_EQ(5, safety_margin2[NodeLocationScope::NODE]);
 }
+
+TEST(SafetyCheckerTest, ReadWriteAvailabilityCache) {
+  // Storage nodes N1, N2, N9, N11, N13.
+  auto nodes_config = NodesConfigurationTestUtil::provisionNodes();
+  ShardAuthoritativeStatusMap status_map;
+  safety::ReadWriteAvailabilityCache cache;
+  int computed = 0;
+  auto compute = [&] {
+    ++computed;
+    return std::make_pair(true, false);
+  };
+  StorageSet set1{ShardID(1, 0), ShardID(2, 0), ShardID(9, 0)};
+  StorageSet set2{ShardID(1, 0), ShardID(11, 0), ShardID(13, 0)};
+  ReplicationProperty rep({{NodeLocationScope::NODE, 2}});
+  auto check = [&](const StorageSet& storage_set,
+                   const ShardSet& op_shards,
+                   const ReplicationProperty& replication = ReplicationProperty(
+                       {{NodeLocationScope::NODE, 2}}),
+                   bool require_fully_started = true) {
+    return cache.getOrCompute(status_map,
+                              op_shards,
+                              storage_set,
+                              configuration::StorageState::DISABLED,
+                              replication,
+                              SafetyMargin(),
+                              nodes_config,
+                              /* cluster_state = */ nullptr,
+                              require_fully_started,
+                              compute);
+  };
+
+  EXPECT_EQ(std::make_pair(true, false), check(set1, {}));
+  EXPECT_EQ(std::make_pair(true, false), check(set1, {}));
+  EXPECT_EQ(1, computed);
+
+  // A different storage set, replication or require_fully_started is
+  // evaluated separately.
+  check(set2, {});
+  check(set1, {}, ReplicationProperty({{NodeLocationScope::NODE, 3}}));
+  check(set1, {}, rep, /* require_fully_started = */ false);
+  EXPECT_EQ(4, computed);
+
+  // Draining N11 only affects set2.
+  check(set1, {ShardID(11, 0)});
+  EXPECT_EQ(4, computed);
+  check(set2, {ShardID(11, 0)});
+  EXPECT_EQ(5, computed);
+
+  // So does a change of authoritative status of N13.
+  status_map.setShardStatus(13, 0, AuthoritativeStatus::UNAVAILABLE);
+  check(set1, {ShardID(11, 0)});
+  EXPECT_EQ(5, computed);
+  check(set2, {ShardID(11, 0)});
+  EXPECT_EQ(6, computed);
+  EXPECT_EQ(6, cache.misses());
+
+  // A new nodes configuration invalidates everything.
+  auto version = nodes_config->getVersion();
+  nodes_config = nodes_config->withVersion(
+      membership::MembershipVersion::Type(version.val() + 1));
+  check(set1, {});
+  EXPECT_EQ(7, computed);
+  EXPECT_EQ(1, cache.size());
+}
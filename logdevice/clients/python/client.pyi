@@ -50,9 +50,20 @@ class DataRecord:
     payload: Any
     payloads: Dict
 
+class RecordBatch:
+    logids: bytes
+    lsns: bytes
+    timestamps: bytes
+    payload_offsets: bytes
+    payloads: bytes
+    def __len__(self) -> int: ...
+
 class Reader:
     def __iter__(self) -> Iterator: ...
     def __next__(self) -> Tuple[Any, Any]: ...
+    def read_batch(
+        self, max_records: int
+    ) -> Tuple[Optional[RecordBatch], Optional[Any]]: ...
     def stop_iteration(self) -> bool: ...
     def start_reading(self, logid: int, from_: lsn_t, until_: lsn_t) -> bool: ...
     def stop_reading(self, logid: int) -> bool: ...
@@ -9,6 +9,7 @@
 #include <atomic>
 #include <chrono>
 #include <cmath>
+#include <cstring>
 
 #include <boost/make_shared.hpp>
 
@@ -19,6 +20,33 @@
 using namespace boost::python;
 using namespace facebook::logdevice;
 
+// A batch of data records returned by Reader.read_batch(), stored column-wise
+// in a few bytes objects rather than in one Python object per record, so that
+// it can be handed to numpy or Arrow without copying, e.g.
+// numpy.frombuffer(batch.lsns, dtype=numpy.uint64).
+struct RecordBatch {
+  // number of records
+  size_t size;
+  // native-endian uint64 arrays of `size` elements
+  object logids;
+  object lsns;
+  // native-endian int64 array of `size` elements, milliseconds since epoch
+  object timestamps;
+  // native-endian uint64 array of `size` + 1 elements: the payload of record i
+  // is payloads[payload_offsets[i]:payload_offsets[i + 1]]
+  object payload_offsets;
+  // all the payloads, back to back
+  object payloads;
+};
+
+// Returns a new bytes object of `size` bytes to fill in, and points `data` to
+// its contents. Must be called with the GIL held.
+static object new_bytes(size_t size, char** data) {
+  object bytes(handle<>(PyBytes_FromStringAndSize(nullptr, size)));
+  *data = PyBytes_AS_STRING(bytes.ptr());
+  return bytes;
+}
+
 // A class that implements the Python iterator interface, and treats the
 // LogDevice Reader.read method as an infinite iterator -- returning one
 // record at a time, from the internal buffer that the Reader already
@@ -37,6 +65,9 @@ class ReaderWrapper : boost::noncopyable {
     // iteration, this can go away in favour of not emulating their timeout.
     auto timeout = std::chrono::milliseconds(1000);
     reader_->setTimeout(timeout);
+    // let read_batch() return what is available rather than wait for a full
+    // batch; makes no difference to next(), which reads one record at a time
+    reader_->waitOnlyWhenNoData();
   };
 
   /**
@@ -98,6 +129,52 @@ class ReaderWrapper : boost::noncopyable {
     throw std::runtime_error("unpossible, the line above always throws!");
   }
 
+  /**
+   * Return a (RecordBatch, GapRecord) pair, in which exactly one of the two
+   * is not None, or (None, None) once there is nothing left to read or
+   * stop_iteration() was called.
+   *
+   * The batch has up to `max_records` records. Unlike next(), the records are
+   * not wrapped in Python objects, and their payloads are copied once into a
+   * single buffer, with the GIL released.
+   */
+  boost::python::tuple read_batch(size_t max_records) {
+    if (max_records == 0) {
+      throw_python_exception(PyExc_ValueError, "max_records must be positive");
+    }
+    std::vector<std::unique_ptr<DataRecord>> records;
+    GapRecord gap;
+
+    while (keep_reading_ && reader_->isReadingAny()) {
+      if (PyErr_CheckSignals() != 0)
+        throw_python_exception();
+
+      ssize_t n = 0;
+      {
+        gil_release_and_guard guard;
+        n = reader_->read(max_records, &records, &gap);
+      }
+
+      if (n < 0) {
+        if (err == E::GAP) {
+          return boost::python::make_tuple(object(), // RecordBatch is None
+                                           boost::make_shared<GapRecord>(gap));
+        }
+
+        throw_logdevice_exception();
+        throw std::runtime_error("unpossible, the line above always throws!");
+      }
+
+      if (n > 0) {
+        return boost::python::make_tuple(
+            make_batch(records), object() // GapRecord is None
+        );
+      }
+    }
+
+    return boost::python::make_tuple(object(), object());
+  }
+
   bool stop_iteration() {
     keep_reading_ = false;
     return true; // yes, we did stop as you requested
@@ -135,6 +212,52 @@ class ReaderWrapper : boost::noncopyable {
   }
 
  private:
+  // Copies `records` into a new RecordBatch. Must be called with the GIL
+  // held, which is only needed to allocate the buffers.
+  boost::shared_ptr<RecordBatch>
+  make_batch(const std::vector<std::unique_ptr<DataRecord>>& records) {
+    const size_t n = records.size();
+    size_t payload_bytes = 0;
+    for (const auto& record : records) {
+      payload_bytes += record->payload.size();
+    }
+
+    auto batch = boost::make_shared<RecordBatch>();
+    batch->size = n;
+    char* logids;
+    char* lsns;
+    char* timestamps;
+    char* offsets;
+    char* payloads;
+    batch->logids = new_bytes(n * sizeof(uint64_t), &logids);
+    batch->lsns = new_bytes(n * sizeof(uint64_t), &lsns);
+    batch->timestamps = new_bytes(n * sizeof(int64_t), &timestamps);
+    batch->payload_offsets = new_bytes((n + 1) * sizeof(uint64_t), &offsets);
+    batch->payloads = new_bytes(payload_bytes, &payloads);
+
+    // nobody else has seen the buffers yet, fill them in without the GIL
+    gil_release_and_guard guard;
+    uint64_t offset = 0;
+    for (size_t i = 0; i < n; ++i) {
+      const DataRecord& record = *records[i];
+      uint64_t logid = record.logid.val_;
+      uint64_t lsn = record.attrs.lsn;
+      int64_t timestamp = record.attrs.timestamp.count();
+      std::memcpy(logids + i * sizeof(logid), &logid, sizeof(logid));
+      std::memcpy(lsns + i * sizeof(lsn), &lsn, sizeof(lsn));
+      std::memcpy(
+          timestamps + i * sizeof(timestamp), &timestamp, sizeof(timestamp));
+      std::memcpy(offsets + i * sizeof(offset), &offset, sizeof(offset));
+      if (record.payload.size() > 0) {
+        std::memcpy(
+            payloads + offset, record.payload.data(), record.payload.size());
+      }
+      offset += record.payload.size();
+    }
+    std::memcpy(offsets + n * sizeof(offset), &offset, sizeof(offset));
+    return batch;
+  }
+
   // our reader
   std::unique_ptr<Reader> reader_;
 
@@ -166,7 +289,34 @@ BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(start_reading_overloads,
                                        2,
                                        3)
 
+size_t record_batch_len(const RecordBatch& batch) {
+  return batch.size;
+}
+
 void register_logdevice_reader() {
+  class_<RecordBatch, boost::shared_ptr<RecordBatch>, boost::noncopyable>(
+      "RecordBatch",
+      R"DOC(
+Data records returned by Reader.read_batch(), stored column-wise.  Each column
+is a bytes object holding an array of native-endian integers, which can be
+wrapped without copying, e.g. with numpy.frombuffer(batch.lsns, numpy.uint64)
+or memoryview(batch.lsns).cast('Q').
+)DOC",
+      no_init)
+      .def("__len__", &record_batch_len)
+      .def_readonly("logids", &RecordBatch::logids, "uint64 log ids")
+      .def_readonly("lsns", &RecordBatch::lsns, "uint64 LSNs")
+      .def_readonly("timestamps",
+                    &RecordBatch::timestamps,
+                    "int64 timestamps, in milliseconds since the epoch")
+      .def_readonly("payload_offsets",
+                    &RecordBatch::payload_offsets,
+                    "uint64 offsets into payloads, one more than there are "
+                    "records: the payload of record i is "
+                    "payloads[payload_offsets[i]:payload_offsets[i + 1]]")
+      .def_readonly(
+          "payloads", &RecordBatch::payloads, "all the payloads, back to back");
+
   class_<ReaderWrapper, boost::shared_ptr<ReaderWrapper>, boost::noncopyable>(
       "Reader",
       R"DOC(
@@ -194,6 +344,19 @@ Implement the 'next' operation from the Python iterator protocol.
 
 This will read until the 'stop_iteration()' method is called
 from Python, or a record (data or gap) can be returned.
+)DOC")
+
+      .def("read_batch",
+           &ReaderWrapper::read_batch,
+           args("max_records"),
+           R"DOC(
+Read up to MAX_RECORDS data records at once, for consumers that can't afford a
+Python object per record.  Returns a (batch, gap) pair in which exactly one of
+the two is not None: a RecordBatch, or a GapRecord.  Returns (None, None) once
+there is nothing left to read or 'stop_iteration()' was called.
+
+Returns as soon as some records are available, without waiting for the batch
+to fill up.  Don't mix with iteration: both consume the same records.
 )DOC")
 
       .def("stop_iteration",
@@ -138,6 +138,39 @@ class LogDeviceIntegrationTest(TestCase):
                 nread += 1
         self.assertEqual(NWRITES, nread)
 
+    def test_read_batch(self):
+        """read_batch() should return the same records as iteration."""
+        NWRITES = 100
+        logid = 1
+        client = self.client()
+
+        written = {}
+        for i in range(NWRITES):
+            payload = "record {}".format(i).encode()
+            written[client.append(logid, payload)] = payload
+
+        reader = client.create_reader(1)
+        reader.start_reading(logid, logdevice.client.LSN_OLDEST, max(written))
+
+        read = {}
+        while True:
+            batch, gap = reader.read_batch(16)
+            if batch is None and gap is None:
+                break
+            if batch is None:
+                continue
+            self.assertTrue(0 < len(batch) <= 16)
+            lsns = memoryview(batch.lsns).cast("Q")
+            logids = memoryview(batch.logids).cast("Q")
+            offsets = memoryview(batch.payload_offsets).cast("Q")
+            self.assertEqual(len(batch), len(lsns))
+            self.assertEqual(len(batch) + 1, len(offsets))
+            self.assertEqual(len(batch.payloads), offsets[len(batch)])
+            for i in range(len(batch)):
+                self.assertEqual(logid, logids[i])
+                read[lsns[i]] = batch.payloads[offsets[i] : offsets[i + 1]]
+        self.assertEqual(written, read)
+
     def test_is_log_empty(self):
         client = self.client()
         client.append(1, "test")
@@ -170,8 +170,10 @@ typedef AdminCommandTable<int,                       /* Shard */
                           std::string,               /* Append Dirtied By */
                           std::string,               /* Rebuild Dirtied By */
                           bool,                      /* Under Replicated */
-                          uint64_t, /* Approx. Obsolete Bytes */
-                          bool      /* Copyset Index Enabled */
+                          bool,        /* Copyset Index Enabled */
+                          std::string, /* Pending Compaction */
+                          uint64_t,    /* Est. Reclaimable Bytes */
+                          uint64_t     /* Approx. Obsolete Bytes */
                           >
     InfoPartitionsTable;
 
@@ -394,6 +396,13 @@ typedef AdminCommandTable<int,                       /* Stats NodeID */
                           >
     InfoAppendOutliersTable;
 
+typedef AdminCommandTable<int,                       /* Worker */
+                          std::string,               /* Context */
+                          std::chrono::microseconds, /* Duration */
+                          std::chrono::milliseconds  /* End time */
+                          >
+    InfoSlowExecutionsTable;
+
 struct InfoStorageTasksTableFieldOffsets {
   static constexpr int SHARD_ID = 0;
   static constexpr int PRIORITY = 1;
@@ -227,6 +227,23 @@ void AdminCommandTable<Args...>::printJson(folly::io::Appender& output,
   output.printf("%s", "\r\n");
 }
 
+template <typename... Args>
+void AdminCommandTable<Args...>::printBinary(folly::io::Appender& output,
+                                             std::size_t max_col_) const {
+  unsigned int max_col = std::min(max_col_, numCols());
+
+  admin_command_table::writeBinaryHeader(output, max_col, rows_.size());
+  for (unsigned int i = 0; i < max_col; ++i) {
+    admin_command_table::writeBinaryColumn(
+        output,
+        names_[i],
+        rows_.size(),
+        [&](size_t row) -> const folly::Optional<std::string>& {
+          return rows_[row][i];
+        });
+  }
+}
+
 template <typename... Args>
 std::string AdminCommandTable<Args...>::toString(bool json,
                                                  size_t max_col_) const {
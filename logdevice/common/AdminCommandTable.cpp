@@ -7,6 +7,10 @@
  */
 #include "logdevice/common/AdminCommandTable.h"
 
+#include <unordered_map>
+
+#include <folly/Varint.h>
+
 #include "logdevice/common/Address.h"
 #include "logdevice/common/ClientID.h"
 #include "logdevice/common/Timestamp.h"
@@ -109,4 +113,202 @@ std::string Converter<Sockaddr>::operator()(Sockaddr a, bool /*prettify*/) {
   return a.toString();
 }
 
+namespace {
+
+constexpr folly::StringPiece kBinaryMagic{"LDCT"};
+constexpr uint8_t kBinaryVersion = 1;
+
+void writeVarint(folly::io::Appender& output, uint64_t v) {
+  uint8_t buf[folly::kMaxVarintLength64];
+  output.push(buf, folly::encodeVarint(v, buf));
+}
+
+void writeBytes(folly::io::Appender& output, folly::StringPiece s) {
+  writeVarint(output, s.size());
+  output.push(folly::ByteRange(s));
+}
+
+bool readVarint(folly::ByteRange& input, uint64_t& out) {
+  auto v = folly::tryDecodeVarint(input);
+  if (!v.hasValue()) {
+    return false;
+  }
+  out = v.value();
+  return true;
+}
+
+bool readBytes(folly::ByteRange& input, std::string& out) {
+  uint64_t size;
+  if (!readVarint(input, size) || size > input.size()) {
+    return false;
+  }
+  out.assign(reinterpret_cast<const char*>(input.data()), size);
+  input.advance(size);
+  return true;
+}
+
+// Whether parsing `s` as an integer and printing it back gives `s`.
+bool isCanonicalInt(const std::string& s, int64_t& out) {
+  auto v = folly::tryTo<int64_t>(s);
+  if (!v.hasValue() || folly::to<std::string>(v.value()) != s) {
+    return false;
+  }
+  out = v.value();
+  return true;
+}
+
+} // namespace
+
+void writeBinaryHeader(folly::io::Appender& output,
+                       size_t num_cols,
+                       size_t num_rows) {
+  output.push(folly::ByteRange(kBinaryMagic));
+  output.write<uint8_t>(kBinaryVersion);
+  writeVarint(output, num_cols);
+  writeVarint(output, num_rows);
+}
+
+void writeBinaryColumn(
+    folly::io::Appender& output,
+    const std::string& name,
+    size_t num_rows,
+    folly::FunctionRef<const folly::Optional<std::string>&(size_t)> value) {
+  using Encoding = BinaryTable::Encoding;
+
+  std::vector<uint8_t> nulls((num_rows + 7) / 8, 0);
+  std::vector<int64_t> ints;
+  bool all_ints = true;
+  for (size_t row = 0; row < num_rows; ++row) {
+    const auto& v = value(row);
+    if (!v.hasValue()) {
+      continue;
+    }
+    nulls[row / 8] |= 1 << (row % 8);
+    int64_t i;
+    if (all_ints && isCanonicalInt(v.value(), i)) {
+      ints.push_back(i);
+    } else {
+      all_ints = false;
+    }
+  }
+
+  writeBytes(output, name);
+  output.write<uint8_t>(
+      static_cast<uint8_t>(all_ints ? Encoding::INT : Encoding::DICT));
+  output.push(nulls.data(), nulls.size());
+
+  if (all_ints) {
+    for (int64_t i : ints) {
+      writeVarint(output, folly::encodeZigZag(i));
+    }
+    return;
+  }
+
+  // Values point into the table, which outlives this function.
+  std::unordered_map<folly::StringPiece, uint64_t> dict;
+  std::vector<folly::StringPiece> dict_values;
+  std::vector<uint64_t> indices;
+  for (size_t row = 0; row < num_rows; ++row) {
+    const auto& v = value(row);
+    if (!v.hasValue()) {
+      continue;
+    }
+    auto res = dict.emplace(v.value(), dict_values.size());
+    if (res.second) {
+      dict_values.push_back(v.value());
+    }
+    indices.push_back(res.first->second);
+  }
+  writeVarint(output, dict_values.size());
+  for (folly::StringPiece s : dict_values) {
+    writeBytes(output, s);
+  }
+  for (uint64_t idx : indices) {
+    writeVarint(output, idx);
+  }
+}
+
+bool isBinaryTable(folly::StringPiece data) {
+  return data.startsWith(kBinaryMagic);
+}
+
+bool parseBinaryTable(folly::StringPiece data, BinaryTable& out) {
+  using Encoding = BinaryTable::Encoding;
+
+  if (!isBinaryTable(data)) {
+    return false;
+  }
+  folly::ByteRange input(data);
+  input.advance(kBinaryMagic.size());
+  if (input.empty() || input.front() != kBinaryVersion) {
+    return false;
+  }
+  input.advance(1);
+
+  uint64_t num_cols;
+  uint64_t num_rows;
+  if (!readVarint(input, num_cols) || !readVarint(input, num_rows)) {
+    return false;
+  }
+  // Each column takes at least 2 bytes and each row at least one bit in each
+  // column. Don't allocate more than that for garbage input.
+  if (num_cols > input.size() ||
+      (num_cols > 0 && num_rows > input.size() * 8 / num_cols)) {
+    return false;
+  }
+
+  out.headers.resize(num_cols);
+  out.columns.assign(num_cols, {});
+  for (size_t col = 0; col < num_cols; ++col) {
+    if (!readBytes(input, out.headers[col]) || input.empty()) {
+      return false;
+    }
+    const uint8_t encoding = input.front();
+    input.advance(1);
+
+    const size_t nulls_size = (num_rows + 7) / 8;
+    if (input.size() < nulls_size) {
+      return false;
+    }
+    folly::ByteRange nulls(input.data(), nulls_size);
+    input.advance(nulls_size);
+
+    std::vector<std::string> dict;
+    if (encoding == static_cast<uint8_t>(Encoding::DICT)) {
+      uint64_t dict_size;
+      if (!readVarint(input, dict_size) || dict_size > input.size()) {
+        return false;
+      }
+      dict.resize(dict_size);
+      for (auto& s : dict) {
+        if (!readBytes(input, s)) {
+          return false;
+        }
+      }
+    } else if (encoding != static_cast<uint8_t>(Encoding::INT)) {
+      return false;
+    }
+
+    auto& column = out.columns[col];
+    column.resize(num_rows);
+    for (size_t row = 0; row < num_rows; ++row) {
+      if (!(nulls[row / 8] & (1 << (row % 8)))) {
+        continue;
+      }
+      uint64_t v;
+      if (!readVarint(input, v)) {
+        return false;
+      }
+      if (encoding == static_cast<uint8_t>(Encoding::INT)) {
+        column[row] = folly::to<std::string>(folly::decodeZigZag(v));
+      } else if (v < dict.size()) {
+        column[row] = dict[v];
+      } else {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
 }}} // namespace facebook::logdevice::admin_command_table
@@ -13,7 +13,9 @@
 #include <utility>
 #include <vector>
 
+#include <folly/Function.h>
 #include <folly/Optional.h>
+#include <folly/Range.h>
 #include <folly/io/Cursor.h>
 
 #include "logdevice/common/AdminCommandTable-fwd.h"
@@ -46,6 +48,10 @@
  *
  * You can also print the table in json format for easier parsing from scripts:
  * my_table.printJson(evbuffer);
+ *
+ * or in a compact binary columnar format for tools that fetch large tables
+ * from many nodes, such as ldquery. See admin_command_table::BinaryTable.
+ * my_table.printBinary(evbuffer);
  */
 
 namespace facebook { namespace logdevice {
@@ -157,6 +163,17 @@ class AdminCommandTable {
   void printJson(folly::io::Appender& output,
                  std::size_t max_col_ = numCols()) const;
 
+  /**
+   * Print the table to the given evbuffer, in binary columnar format. Can be
+   * parsed with admin_command_table::parseBinaryTable().
+   *
+   * @param output Evbuffer to print the table to.
+   * @param max_col_ Only print the first `max_col_` columns. If not provided,
+   *                 print all the columns.
+   */
+  void printBinary(folly::io::Appender& output,
+                   std::size_t max_col_ = numCols()) const;
+
   std::string toString(bool json = false, size_t max_col_ = numCols()) const;
 
  private:
@@ -169,6 +186,59 @@ class AdminCommandTable {
   bool prettify_;
 };
 
+namespace admin_command_table {
+
+/**
+ * A table in binary columnar format, as written by
+ * AdminCommandTable::printBinary(). Values are stored column by column, so
+ * that they can be encoded by type and repeated values are cheap:
+ *
+ *   "LDCT" <version: 1 byte> <num columns> <num rows>
+ *   for each column:
+ *     <name length> <name>
+ *     <encoding: 1 byte>
+ *     <null bitmap: one bit per row, set if the row has a value>
+ *     if encoding is INT: the values as zigzag varints,
+ *     if encoding is DICT: <dictionary size>, the distinct values as
+ *       <length> <bytes>, then the dictionary index of each value.
+ *
+ * All numbers not marked otherwise are varints. Only rows that have a value
+ * appear after the null bitmap. A column is INT if all its values are
+ * integers in canonical decimal form, so that parsing gives back the same
+ * strings as printJson().
+ */
+struct BinaryTable {
+  enum class Encoding : uint8_t { INT = 0, DICT = 1 };
+
+  std::vector<std::string> headers;
+  // Column index -> row index -> value.
+  std::vector<std::vector<folly::Optional<std::string>>> columns;
+};
+
+void writeBinaryHeader(folly::io::Appender& output,
+                       size_t num_cols,
+                       size_t num_rows);
+
+void writeBinaryColumn(
+    folly::io::Appender& output,
+    const std::string& name,
+    size_t num_rows,
+    folly::FunctionRef<const folly::Optional<std::string>&(size_t)> value);
+
+/**
+ * @return  true if `data` starts like a table in binary format.
+ */
+bool isBinaryTable(folly::StringPiece data);
+
+/**
+ * Parses a table written by AdminCommandTable::printBinary().
+ *
+ * @return  false if `data` is malformed.
+ */
+bool parseBinaryTable(folly::StringPiece data, BinaryTable& out);
+
+} // namespace admin_command_table
+
 }} // namespace facebook::logdevice
 
 #include "logdevice/common/AdminCommandTable-inl.h"
@@ -88,13 +88,21 @@ std::shared_ptr<Sequencer> AllSequencers::findSequencer(logid_t logid) {
     return getMetaDataLogSequencer(logid);
   }
 
-  folly::SharedMutex::ReadHolder map_lock(sequencer_map_mutex_);
   // data log id
+  SequencerCache::Entry& cached = sequencer_cache_->slot(logid.val_);
+  if (cached.logid == logid.val_) {
+    ld_check(cached.sequencer);
+    return cached.sequencer;
+  }
+
+  folly::SharedMutex::ReadHolder map_lock(sequencer_map_mutex_);
   auto it = sequencer_map_.find(logid.val_);
   if (it == sequencer_map_.end()) {
     err = E::NOSEQUENCER;
     return nullptr;
   }
+  cached.logid = logid.val_;
+  cached.sequencer = it->second;
   return it->second;
 }
 
@@ -7,12 +7,14 @@
  */
 #pragma once
 
+#include <array>
 #include <chrono>
 #include <functional>
 #include <memory>
 
 #include <boost/iterator/iterator_facade.hpp>
 #include <folly/SharedMutex.h>
+#include <folly/ThreadLocal.h>
 #include <folly/container/F14Map.h>
 
 #include "logdevice/common/EpochStore.h"
@@ -259,6 +261,10 @@ class AllSequencers {
    * requested is a metadata logid, looks for the meta sequencer for the logid
    * running on the worker thread, if any.
    *
+   * This is called for every append, so successful lookups of data logs are
+   * cached in a small per-thread cache, which is consulted before taking
+   * sequencer_map_mutex_.
+   *
    * @return   on success a pointer to Sequencer found is returned.
    *           If no Sequencer exists in the map at the time of call, nullptr is
    *           returned and err is set to NOSEQUENCER.
@@ -423,9 +429,36 @@ class AllSequencers {
   // NOTE: If we see contention on this mutex, sharding the map should
   //       be an easy remedy (assuming the contention is not on specific
   //       logs).
+  //
+  // Sequencers are only ever inserted in the map, never removed or replaced,
+  // which is what makes SequencerCache below safe.
   folly::SharedMutex sequencer_map_mutex_;
   SequencerMap sequencer_map_;
 
+  // A small direct-mapped cache of sequencers recently looked up by a thread.
+  // With many logs, most of the cost of findSequencer() is the cache misses
+  // of the lookup in sequencer_map_ and of acquiring the shared lock, while
+  // appends on a given worker tend to concentrate on a smaller set of logs.
+  // Since entries of sequencer_map_ never change once inserted, a cached
+  // entry never becomes stale and no invalidation is needed. Only successful
+  // lookups are cached.
+  struct SequencerCache {
+    static constexpr size_t kSize = 512; // must be a power of two
+
+    struct Entry {
+      logid_t::raw_type logid = LOGID_INVALID.val_;
+      std::shared_ptr<Sequencer> sequencer;
+    };
+
+    Entry& slot(logid_t::raw_type logid) {
+      return entries[Hash64<logid_t::raw_type>()(logid) & (kSize - 1)];
+    }
+
+    std::array<Entry, kSize> entries;
+  };
+  // Declared after sequencer_map_ so that cached pointers are released first.
+  folly::ThreadLocal<SequencerCache> sequencer_cache_;
+
   // cluster config used by the Processor that owns this object
   std::shared_ptr<UpdateableConfig> updateable_config_;
 
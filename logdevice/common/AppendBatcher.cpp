@@ -0,0 +1,109 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/AppendBatcher.h"
+
+#include <algorithm>
+
+#include "logdevice/common/AppendRequest.h"
+#include "logdevice/common/Sender.h"
+#include "logdevice/common/Worker.h"
+#include "logdevice/common/protocol/APPENDS_BATCH_Message.h"
+#include "logdevice/common/protocol/APPEND_Message.h"
+#include "logdevice/common/settings/Settings.h"
+#include "logdevice/common/stats/Stats.h"
+#include "logdevice/common/util.h"
+
+namespace facebook { namespace logdevice {
+
+AppendBatcher::AppendBatcher() : timer_([this] { flushAll(); }) {}
+
+bool AppendBatcher::add(std::unique_ptr<APPEND_Message>& msg, NodeID dest) {
+  ld_check(msg);
+  Worker* w = Worker::onThisThread();
+  const Settings& settings = Worker::settings();
+  if (settings.append_batching_window.count() <= 0) {
+    return false;
+  }
+  folly::Optional<uint16_t> proto =
+      w->sender().getSocketProtocolVersion(dest.index());
+  if (!proto.hasValue() || *proto < Compatibility::APPENDS_BATCH_SUPPORT) {
+    return false;
+  }
+  const size_t bytes = msg->size(*proto);
+  if (bytes >= settings.append_batching_max_bytes) {
+    return false;
+  }
+
+  Pending& pending = pending_[dest];
+  pending.appends.push_back(std::move(msg));
+  pending.bytes += bytes;
+  if (pending.bytes >= settings.append_batching_max_bytes) {
+    flush(dest);
+  } else if (!timer_.isActive()) {
+    timer_.activate(settings.append_batching_window);
+  }
+  return true;
+}
+
+void AppendBatcher::flushAll() {
+  timer_.cancel();
+  while (!pending_.empty()) {
+    flush(pending_.begin()->first);
+  }
+}
+
+void AppendBatcher::flush(NodeID dest) {
+  auto it = pending_.find(dest);
+  if (it == pending_.end()) {
+    return;
+  }
+  std::vector<std::unique_ptr<APPEND_Message>> appends =
+      std::move(it->second.appends);
+  pending_.erase(it);
+
+  Worker* w = Worker::onThisThread();
+  auto& running = w->runningAppends().map;
+  appends.erase(std::remove_if(appends.begin(),
+                               appends.end(),
+                               [](const auto& append) {
+                                 return append->cancelled();
+                               }),
+                appends.end());
+  if (appends.empty()) {
+    return;
+  }
+  std::vector<request_id_t> rqids;
+  for (const auto& append : appends) {
+    rqids.push_back(append->header_.rqid);
+  }
+
+  int rv;
+  if (appends.size() == 1) {
+    rv = w->sender().sendMessage(std::move(appends[0]), dest);
+  } else {
+    auto batch = std::make_unique<APPENDS_BATCH_Message>(std::move(appends));
+    rv = w->sender().sendMessage(std::move(batch), dest);
+    if (rv == 0) {
+      STAT_INCR(Worker::stats(), append_batches_sent);
+      STAT_ADD(Worker::stats(), appends_batched, rqids.size());
+    }
+  }
+  const Status st = rv == 0 ? E::OK : err;
+
+  // Look the requests up one by one, handling the outcome may complete any
+  // of them.
+  for (request_id_t rqid : rqids) {
+    auto pos = running.find(rqid);
+    if (pos != running.end()) {
+      checked_downcast<AppendRequest*>(pos->second.get())
+          ->onAppendBatchSent(st, dest);
+    }
+  }
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,70 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "logdevice/common/NodeID.h"
+#include "logdevice/common/Timer.h"
+
+namespace facebook { namespace logdevice {
+
+class APPEND_Message;
+
+/**
+ * @file Coalesces APPEND messages that AppendRequests running on a Worker
+ *       send to the same sequencer node within --append-batching-window into
+ *       APPENDS_BATCH messages. Clients appending small records to many logs
+ *       otherwise pay the full per-message cost for each of them.
+ *
+ *       Once a batch is handed to Sender, AppendBatcher calls
+ *       AppendRequest::onAppendBatchSent() on the requests in it. Appends of
+ *       requests that completed while queued (e.g. timed out) are dropped.
+ *
+ *       One instance per Worker, see Worker::appendBatcher().
+ */
+
+class AppendBatcher {
+ public:
+  AppendBatcher();
+
+  AppendBatcher(const AppendBatcher&) = delete;
+  AppendBatcher& operator=(const AppendBatcher&) = delete;
+
+  /**
+   * Queues `msg` to be sent to `dest` together with other appends.
+   *
+   * @return true if `msg` was queued. false if it should be sent on its own,
+   *         leaving `msg` untouched: batching is disabled, the message is too
+   *         large, or the connection to `dest` isn't handshaken yet or speaks
+   *         a protocol without APPENDS_BATCH.
+   */
+  bool add(std::unique_ptr<APPEND_Message>& msg, NodeID dest);
+
+  /**
+   * Sends everything queued.
+   */
+  void flushAll();
+
+ private:
+  struct Pending {
+    std::vector<std::unique_ptr<APPEND_Message>> appends;
+    size_t bytes = 0;
+  };
+
+  void flush(NodeID dest);
+
+  std::unordered_map<NodeID, Pending, NodeID::Hash> pending_;
+
+  // Fires --append-batching-window after the first append was queued.
+  Timer timer_;
+};
+
+}} // namespace facebook::logdevice
@@ -7,13 +7,20 @@
  */
 #include "logdevice/common/AppendProbeController.h"
 
+#include <algorithm>
+#include <limits>
+
 #include "logdevice/common/debug.h"
 #include "logdevice/common/settings/Settings.h"
 #include "logdevice/common/util.h"
 
 namespace facebook { namespace logdevice {
 
-bool AppendProbeController::shouldProbe(NodeID node_id, logid_t) {
+constexpr std::chrono::seconds AppendProbeController::CREDIT_VALIDITY;
+
+bool AppendProbeController::shouldProbe(NodeID node_id,
+                                        logid_t,
+                                        size_t payload_size) {
   constexpr bool PROBE = true;
   constexpr bool NO_PROBE = false;
 
@@ -24,19 +31,51 @@ bool AppendProbeController::shouldProbe(NodeID node_id, logid_t) {
     return NO_PROBE;
   }
 
-  const State& state = it->second;
+  State& state = it->second;
   switch (state.e.load()) {
     case State::Enum::HEALTHY:
       return NO_PROBE;
     case State::Enum::LAST_APPEND_FAILED:
-      return PROBE;
+      return spendCredit(state, payload_size) ? NO_PROBE : PROBE;
     case State::Enum::RECOVERING:
-      return now() < state.healthy_at.load() ? PROBE : NO_PROBE;
+      if (now() >= state.healthy_at.load()) {
+        return NO_PROBE;
+      }
+      return spendCredit(state, payload_size) ? NO_PROBE : PROBE;
     default:
       std::abort();
   }
 }
 
+bool AppendProbeController::spendCredit(State& state, size_t bytes) {
+  if (now() >= state.credit_expires_at.load()) {
+    return false;
+  }
+  int64_t credit = state.credit_bytes.load();
+  do {
+    if (credit <= 0 || static_cast<uint64_t>(credit) < bytes) {
+      return false;
+    }
+  } while (!state.credit_bytes.compare_exchange_weak(
+      credit, credit - static_cast<int64_t>(bytes)));
+  return true;
+}
+
+void AppendProbeController::onProbeCredit(NodeID node_id,
+                                          logid_t,
+                                          uint64_t credit_bytes) {
+  folly::SharedMutex::ReadHolder guard(node_state_map_mutex_);
+  NodeStateMap::iterator it = node_state_map_.find(node_id);
+  if (it == node_state_map_.end()) {
+    // Implicitly HEALTHY, appends don't probe so credit isn't needed
+    return;
+  }
+  State& state = it->second;
+  state.credit_bytes.store(
+      std::min<uint64_t>(credit_bytes, std::numeric_limits<int64_t>::max()));
+  state.credit_expires_at.store(now() + CREDIT_VALIDITY);
+}
+
 void AppendProbeController::onSuccess(NodeID node_id, logid_t) {
   folly::SharedMutex::ReadHolder guard(node_state_map_mutex_);
   NodeStateMap::iterator it = node_state_map_.find(node_id);
@@ -104,6 +143,8 @@ void AppendProbeController::onFailure(NodeID node_id, logid_t, Status status) {
   }
   // State machine transitions in case of a failure are simple: move/stay in
   // the LAST_APPEND_FAILED state.
+  // The sequencer is struggling after all; don't trust its credit anymore.
+  it->second.credit_bytes.store(0);
   State::Enum prev = it->second.e.exchange(State::Enum::LAST_APPEND_FAILED);
   if (prev != State::Enum::LAST_APPEND_FAILED) {
     ld_debug(
@@ -37,6 +37,12 @@ namespace facebook { namespace logdevice {
  * succeeded.  The purpose of the recovery interval is to avoid flapping when
  * the cluster is accepting some but not all appends.
  *
+ * A sequencer that passes a probe may also grant append credit: a number of
+ * bytes the client may send it over the next second without probing again
+ * (see --append-probe-credit).  While probes are recommended, appends that
+ * fit in the remaining credit skip the probe and spend the credit instead.
+ * Failures revoke the credit.
+ *
  * This class is thread-safe.
  */
 
@@ -49,7 +55,14 @@ class AppendProbeController {
    * Called by AppendRequest to decide if the append should be preceded by a
    * probe.
    */
-  bool shouldProbe(NodeID, logid_t);
+  bool shouldProbe(NodeID, logid_t, size_t payload_size = 0);
+
+  /**
+   * Called by AppendRequest when a sequencer passed a probe and granted
+   * `credit_bytes` bytes of append credit.  Replaces any previous credit
+   * for the node.
+   */
+  void onProbeCredit(NodeID node_id, logid_t log_id, uint64_t credit_bytes);
 
   /**
    * Called by AppendRequest when it receives a reply from a sequencer (also
@@ -93,7 +106,19 @@ class AppendProbeController {
     explicit State(Enum initial_state) : e(initial_state) {}
     std::atomic<Enum> e;
     std::atomic<TimePoint> healthy_at;
+    // Append credit granted with the last successful probe, in bytes, and
+    // when it expires.
+    std::atomic<int64_t> credit_bytes{0};
+    std::atomic<TimePoint> credit_expires_at{TimePoint::zero()};
   };
+
+  // How long credit granted by a probe reply stays valid.
+  static constexpr std::chrono::seconds CREDIT_VALIDITY{1};
+
+  // Spends `bytes` of the node's credit if it has that much, returns true on
+  // success.
+  bool spendCredit(State& state, size_t bytes);
+
   using NodeStateMap = std::unordered_map<NodeID, State, NodeID::Hash>;
   NodeStateMap node_state_map_;
   // Mutex acquired for writing for map insert/erase, which only happens
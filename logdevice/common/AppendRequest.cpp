@@ -13,6 +13,7 @@
 #include <folly/stats/BucketedTimeSeries.h>
 #include <folly/synchronization/Baton.h>
 
+#include "logdevice/common/AppendBatcher.h"
 #include "logdevice/common/AppendProbeController.h"
 #include "logdevice/common/MetaDataLog.h"
 #include "logdevice/common/Processor.h"
@@ -253,7 +254,8 @@ void AppendRequest::onSequencerKnown(NodeID dest,
 
   // Check if we should send a probe
   if (append_probe_controller_ != nullptr &&
-      append_probe_controller_->shouldProbe(dest, record_.logid)) {
+      append_probe_controller_->shouldProbe(
+          dest, record_.logid, record_.payload.size())) {
     sendProbe();
   } else {
     sendAppendMessage();
@@ -308,6 +310,10 @@ void AppendRequest::onProbeReply(const APPEND_PROBE_REPLY_Header& reply,
   // versioning the state machine and including the version in every message.
   ld_check(from.asNodeID() == sequencer_node_);
   if (reply.status == E::OK) {
+    if (reply.credit_bytes > 0 && append_probe_controller_ != nullptr) {
+      append_probe_controller_->onProbeCredit(
+          sequencer_node_, record_.logid, reply.credit_bytes);
+    }
     sendAppendMessage();
   } else {
     // Record that we saved some bandwidth.  Impact!
@@ -351,6 +357,12 @@ void AppendRequest::sendAppendMessage() {
           record_.logid.val_,
           dest.toString().c_str());
 
+  if (getSettings().append_batching_window.count() > 0 &&
+      Worker::onThisThread()->appendBatcher().add(msg, dest)) {
+    // onAppendBatchSent() will be called once the message is sent.
+    return;
+  }
+
   int rv = sender_->sendMessage(std::move(msg), dest, &on_socket_close_);
   if (rv != 0) {
     handleMessageSendError(MessageType::APPEND, err, dest);
@@ -359,6 +371,25 @@ void AppendRequest::sendAppendMessage() {
   }
 }
 
+void AppendRequest::onAppendBatchSent(Status st, NodeID dest) {
+  if (st != E::OK) {
+    handleMessageSendError(MessageType::APPEND, st, dest);
+    // Object may be destroyed, must return
+    return;
+  }
+  // The batch was sent without our socket callback, install it now. If the
+  // connection is already gone, APPEND_Message::onSent() reports the failure.
+  int rv = Worker::onThisThread()->sender().registerOnConnectionClosed(
+      Address(dest), on_socket_close_);
+  if (rv != 0) {
+    ld_debug("Failed to install socket callback for append to log %lu on %s: "
+             "%s",
+             record_.logid.val_,
+             dest.toString().c_str(),
+             error_name(err));
+  }
+}
+
 void AppendRequest::handleMessageSendError(MessageType type,
                                            Status st,
                                            const NodeID dest) {
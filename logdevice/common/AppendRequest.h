@@ -138,6 +138,13 @@ class AppendRequest : public AppendRequestBase,
    */
   void noReply(Status st, const Address& from, bool request_sent);
 
+  /**
+   * Called by AppendBatcher when the APPEND message of this request was
+   * passed to Sender as part of a batch (st == E::OK), or couldn't be (st is
+   * the error of Sender::sendMessage()).
+   */
+  void onAppendBatchSent(Status st, NodeID dest);
+
   /**
    * Forces the append to run on a specific Worker.  If not called or called
    * with an ID < 0, a target Worker will be selected according to the
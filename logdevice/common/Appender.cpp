@@ -10,7 +10,9 @@
 
 #include <algorithm>
 #include <alloca.h>
+#include <cmath>
 #include <cstdlib>
+#include <vector>
 
 #include "logdevice/common/Address.h"
 #include "logdevice/common/AppendRequest.h"
@@ -21,12 +23,14 @@
 #include "logdevice/common/EpochSequencer.h"
 #include "logdevice/common/ExponentialBackoffAdaptiveVariable.h"
 #include "logdevice/common/LocalLogStoreRecordFormat.h"
+#include "logdevice/common/MemoryArenas.h"
 #include "logdevice/common/MetaDataLogWriter.h"
 #include "logdevice/common/PayloadHolder.h"
 #include "logdevice/common/PeriodicReleases.h"
 #include "logdevice/common/Processor.h"
 #include "logdevice/common/Sequencer.h"
 #include "logdevice/common/SocketSender.h"
+#include "logdevice/common/StoreBatcher.h"
 #include "logdevice/common/TailRecord.h"
 #include "logdevice/common/TraceLogger.h"
 #include "logdevice/common/Worker.h"
@@ -56,6 +60,51 @@ static const std::chrono::milliseconds LOG_IF_APPEND_TOOK_LONGER_THAN =
     std::chrono::seconds(20);
 static const int LOG_IF_WAVE_ABOVE = 7;
 
+namespace {
+
+// Memory of deleted Appenders available for reuse on this thread. See
+// Appender::operator new().
+struct AppenderPool {
+  ~AppenderPool() {
+    for (void* ptr : free_list) {
+      MemoryArenas::deallocate(ptr);
+    }
+  }
+
+  std::vector<void*> free_list;
+};
+
+thread_local AppenderPool appender_pool;
+
+} // namespace
+
+void* Appender::operator new(size_t size) {
+  if (size == sizeof(Appender)) {
+    auto& free_list = appender_pool.free_list;
+    if (!free_list.empty()) {
+      void* ptr = free_list.back();
+      free_list.pop_back();
+      WORKER_STAT_INCR(appender_pool_reused);
+      return ptr;
+    }
+    WORKER_STAT_INCR(appender_pool_allocated);
+  }
+  return MemoryArenas::allocate(MemoryArena::APPENDERS, size);
+}
+
+void Appender::operator delete(void* ptr, size_t size) {
+  // The Appender may be deleted on a worker other than the one it was
+  // created on; its memory then goes to the pool of the deleting worker.
+  Worker* w = Worker::onThisThread(false);
+  if (size == sizeof(Appender) && w &&
+      appender_pool.free_list.size() <
+          w->immutable_settings_->appender_pool_size) {
+    appender_pool.free_list.push_back(ptr);
+    return;
+  }
+  MemoryArenas::deallocate(ptr);
+}
+
 Appender::Appender(Worker* worker,
                    std::shared_ptr<TraceLogger> trace_logger,
                    std::chrono::milliseconds client_timeout,
@@ -90,6 +139,8 @@ Appender::Appender(Worker* worker,
     created_on_->totalSizeOfAppenders_ += full_appender_size_;
     STAT_INCR(getStats(), num_appenders);
     STAT_ADD(getStats(), total_size_of_appenders, full_appender_size_);
+    latency_trace_ = LatencyTrace::maybeStart(
+        "append", created_on_->immutable_settings_->latency_trace_sample_rate);
   }
 }
 
@@ -144,6 +195,10 @@ Appender::~Appender() {
     STAT_SUB(getStats(), total_size_of_appenders, full_appender_size_);
   }
 
+  if (latency_trace_) {
+    latency_trace_->finish();
+  }
+
   if (is_linked()) {
     // We must be on the right Worker thread to unlink from
     // `Worker::activeAppenders()'.  Otherwise (if this Appender is being
@@ -185,6 +240,14 @@ int Appender::sendSTORE(const StoreChainLink copyset[],
   Recipient* r = recipients_.find(dest);
   ld_check(r);
 
+  if (created_on_ &&
+      getSettings().sequencer_store_batching_window.count() > 0 &&
+      created_on_->storeBatcher().add(store_msg, dest.asNodeID())) {
+    // Will be sent along with other STOREs to the same node. onCopySent()
+    // gets called once the batch is passed to TCP or fails to be.
+    return 1;
+  }
+
   int rv = sender_->sendMessage(
       std::move(store_msg), dest.asNodeID(), &r->bwAvailCB());
 
@@ -560,6 +623,7 @@ int Appender::sendWave() {
               to_msec(timeout_.value()).count());
     }
     activateStoreTimer(timeout_.value());
+    maybeActivateHedgeTimer();
   }
 
   return rv;
@@ -573,6 +637,10 @@ int Appender::start(std::shared_ptr<EpochSequencer> epoch_sequencer,
     return -1;
   }
 
+  if (latency_trace_) {
+    latency_trace_->mark("sequencer");
+  }
+
   // hold a shared reference of the epoch sequencer object
   epoch_sequencer_ = std::move(epoch_sequencer);
   ld_check(lsn != LSN_INVALID);
@@ -812,6 +880,9 @@ void Appender::sendReply(lsn_t lsn, Status status, NodeID redirect) {
 
   // We are ready to send a reply. Always invoke deleteIfDone when exiting.
   SCOPE_EXIT {
+    if (latency_trace_) {
+      latency_trace_->mark("reply");
+    }
     payload_.reset();
     deleteIfDone(REPLIED);
   };
@@ -1066,11 +1137,11 @@ void Appender::sendRedirect(NodeID to, Status status, lsn_t lsn) {
   sendReply(lsn, status, to);
 }
 
-void Appender::onTimeout() {
+void Appender::onTimeout(bool hedged) {
   ld_check(started());
   ld_check(!recipients_.isFullyReplicated());
 
-  if (store_timeout_set_) {
+  if (store_timeout_set_ && !hedged) {
     if (store_hdr_.wave >= LOG_IF_WAVE_ABOVE) {
       // Separate rate limit for appenders that failed lots of waves.
       // These error messages are expected to be rare and important, don't want
@@ -1104,8 +1175,9 @@ void Appender::onTimeout() {
     }
   }
 
+  // A hedged wave isn't a timeout; don't skew latency histograms with it.
   auto worker = Worker::onThisThread(false);
-  if (worker &&
+  if (worker && !hedged &&
       worker->updateable_settings_->enable_store_histogram_calculations) {
     if (store_hdr_.flags & STORE_Header::CHAIN) {
       worker->getWorkerTimeoutStats().onReply(
@@ -1175,6 +1247,72 @@ void Appender::onTimeout() {
   sendWave();
 }
 
+void Appender::maybeActivateHedgeTimer() {
+  auto worker = Worker::onThisThread(false);
+  if (!worker || !timeout_.has_value() ||
+      replies_expected_ < recipients_.getReplication()) {
+    return;
+  }
+  const auto& settings = Worker::settings();
+  if (settings.hedged_store_budget <= 0 ||
+      !settings.enable_store_histogram_calculations) {
+    return;
+  }
+
+  auto& stats = worker->getWorkerTimeoutStats();
+  stats.addHedgeCredit(settings.hedged_store_budget);
+
+  // A reply is late if it takes longer than p99 of the recipient's recent
+  // STORE latency. Without history for some recipient we can't tell.
+  double delay_ms = 0;
+  for (const Recipient& r : recipients_.getRecipients()) {
+    auto estimations = stats.getEstimations(
+        WorkerTimeoutStats::Levels::TEN_SECONDS, r.getShardID().node());
+    if (!estimations.has_value()) {
+      return;
+    }
+    delay_ms = std::max(
+        delay_ms, (*estimations)[WorkerTimeoutStats::QuantileIndexes::P99]);
+  }
+  auto delay = std::max(
+      std::chrono::milliseconds(1),
+      std::chrono::milliseconds(static_cast<int64_t>(std::ceil(delay_ms))));
+  if (delay >= timeout_.value()) {
+    return;
+  }
+
+  if (!hedge_timer_.isAssigned()) {
+    hedge_timer_.assign([this] { onHedgeTimeout(); });
+  }
+  hedge_timer_.activate(delay);
+}
+
+void Appender::onHedgeTimeout() {
+  if (recipients_.isFullyReplicated() || !storeTimerIsActive()) {
+    return;
+  }
+  // If nobody replied, the slowness is probably not specific to one node
+  // (e.g. this sequencer is overloaded); another wave would only add load.
+  if (recipients_.allRecipientsOutstanding()) {
+    return;
+  }
+  if (!Worker::onThisThread()->getWorkerTimeoutStats().tryTakeHedgeCredit()) {
+    STAT_INCR(getStats(), appender_wave_hedge_over_budget);
+    return;
+  }
+
+  STAT_INCR(getStats(), appender_wave_hedged);
+  RATELIMIT_DEBUG(std::chrono::seconds(1),
+                  1,
+                  "Appender %s is hedging wave %u, recipient set: %s",
+                  store_hdr_.rid.toString().c_str(),
+                  store_hdr_.wave,
+                  recipients_.dumpRecipientSet().c_str());
+  cancelStoreTimer();
+  onTimeout(/* hedged */ true);
+  // `this` may no longer exist here.
+}
+
 void Appender::onChainForwardingFailure(unsigned int index) {
   folly::fbvector<Recipient>& recipients = recipients_.getRecipients();
 
@@ -1735,6 +1873,9 @@ void Appender::onRecipientSucceeded(Recipient* recipient) {
   }
 
   ld_check(!reply_sent_);
+  if (latency_trace_) {
+    latency_trace_->mark("store");
+  }
   // record the latency of this append
   HISTOGRAM_ADD(getStats(), append_latency, usec_since(creation_time_));
   int64_t latency_usec = usec_since(creation_time_);
@@ -1918,6 +2059,9 @@ void Appender::onComplete(bool linked) {
 
 void Appender::onReaped() {
   ld_check(!isDone(REAPED));
+  if (latency_trace_) {
+    latency_trace_->mark("reap");
+  }
   auto release_type = static_cast<ReleaseType>(release_type_.load());
   lsn_t lsn = getLSN();
   epoch_t last_released_epoch;
@@ -2010,11 +2154,14 @@ void Appender::checkWorkerThread() {
 }
 
 void Appender::initStoreTimer() {
-  store_timer_.assign(std::bind(&Appender::onTimeout, this));
+  store_timer_.assign([this] { onTimeout(); });
 }
 
 void Appender::cancelStoreTimer() {
   store_timer_.cancel();
+  if (hedge_timer_.isAssigned()) {
+    hedge_timer_.cancel();
+  }
 }
 void Appender::fireStoreTimer() {
   store_timer_.activate(std::chrono::microseconds(0));
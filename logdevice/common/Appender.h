@@ -21,6 +21,7 @@
 #include "logdevice/common/CopySetManager.h"
 #include "logdevice/common/ExponentialBackoffTimer.h"
 #include "logdevice/common/IntrusiveUnorderedMap.h"
+#include "logdevice/common/LatencyTrace.h"
 #include "logdevice/common/NodeSetState.h"
 #include "logdevice/common/OffsetMap.h"
 #include "logdevice/common/RecipientSet.h"
@@ -129,6 +130,16 @@ class Appender : public IntrusiveUnorderedMapHook {
 
   virtual ~Appender();
 
+  /**
+   * Appenders are allocated and freed once per append, which makes them one
+   * of the hottest allocations on the write path. Memory of deleted
+   * Appenders is kept in a per-thread free list (see --appender-pool-size)
+   * and reused by the next Appender created on that thread. Subclasses,
+   * whose size differs, bypass the pool.
+   */
+  static void* operator new(size_t size);
+  static void operator delete(void* ptr, size_t size);
+
   /**
    * Reason for the retirement of the Appender. Used to determine actions when
    * the appender retires.
@@ -707,6 +718,9 @@ class Appender : public IntrusiveUnorderedMapHook {
 
   // AppenderTracer for tracing append operations
   AppenderTracer tracer_;
+
+  // Breakdown of this append's latency by stage, if it was sampled.
+  std::unique_ptr<LatencyTrace> latency_trace_;
   // Worker on whose thread this Appender was created. May be null in tests so
   // Appender should access this through virtual methods of this class so that
   // tests can override them.
@@ -833,6 +847,10 @@ class Appender : public IntrusiveUnorderedMapHook {
   // Note: in tests, this is left uninitialized.
   Timer store_timer_;
 
+  // Fires when the current wave is late compared to recent latencies, see
+  // maybeActivateHedgeTimer(). Only assigned if hedging is enabled.
+  Timer hedge_timer_;
+
   // special timer, set up with a zero timeout, used to trigger another wave
   // of STOREs to be sent on the next iteration of the event loop
   // Note: in tests, this is left uninitialized.
@@ -990,8 +1008,24 @@ class Appender : public IntrusiveUnorderedMapHook {
    *     a last-wave STORE drops below the replication factor for our log or we
    *     know one of the sync leaders is not available and we need to try
    *     sending a new wave.
+   *
+   * @param hedged  true if called by onHedgeTimeout(), before the STORE
+   *                timeout. The wave isn't counted as timed out then.
+   */
+  void onTimeout(bool hedged = false);
+
+  /**
+   * If --hedged-store-budget is set, starts hedge_timer_ to fire once the
+   * wave just sent takes longer than its recipients' recent p99 latency.
+   */
+  void maybeActivateHedgeTimer();
+
+  /**
+   * Called by hedge_timer_. Unless all recipients are still outstanding or
+   * the worker's hedging budget is used up, gives up on the current wave
+   * early with onTimeout().
    */
-  void onTimeout();
+  void onHedgeTimeout();
 
   /**
    * Mark a storage shard as not available in the NodeSetState so that it will
@@ -13,7 +13,9 @@
 #include "logdevice/common/MetaDataLogWriter.h"
 #include "logdevice/common/Processor.h"
 #include "logdevice/common/Worker.h"
+#include "logdevice/common/chrono_util.h"
 #include "logdevice/common/debug.h"
+#include "logdevice/common/stats/ServerHistograms.h"
 #include "logdevice/include/Err.h"
 
 namespace facebook { namespace logdevice {
@@ -34,11 +36,16 @@ void AppenderBufferQueue::process(AppenderBuffer::AppenderCallback cb) {
   ld_check(num_allowed > 0);
 
   // store appenders that need to be re-enqueued later
-  std::queue<AppenderUniqPtr> re_queue;
+  std::queue<QueuedAppender> re_queue;
 
   while (!queue_.empty() && num_processed < num_allowed) {
-    AppenderUniqPtr& appender = queue_.front();
+    AppenderUniqPtr& appender = queue_.front().appender;
     auto action = cb(logid_, appender);
+    if (action != AppenderBuffer::Action::REQUEUE) {
+      HISTOGRAM_ADD(Worker::stats(),
+                    appender_buffer_wait_latency,
+                    usec_since(queue_.front().enqueue_time));
+    }
     switch (action) {
       case AppenderBuffer::Action::DESTROY:
         break;
@@ -46,7 +53,7 @@ void AppenderBufferQueue::process(AppenderBuffer::AppenderCallback cb) {
         appender.release();
         break;
       case AppenderBuffer::Action::REQUEUE:
-        re_queue.push(std::move(appender));
+        re_queue.push(std::move(queue_.front()));
         break;
     };
 
@@ -94,7 +101,7 @@ void AppenderBuffer::bufferedAppenderSendError(logid_t logid, Status st) {
 
 void AppenderBufferQueue::drainQueueAndSendError(Status st) {
   while (!queue_.empty()) {
-    AppenderUniqPtr& appender = queue_.front();
+    AppenderUniqPtr& appender = queue_.front().appender;
     appender->sendError(st);
     WORKER_STAT_INCR(appenderbuffer_appender_failed_sequencer_activation);
     queue_.pop();
@@ -184,7 +191,8 @@ bool AppenderBuffer::bufferAppender(logid_t logid,
     return false;
   }
 
-  appender_queue->queue_.push(std::move(appender));
+  appender_queue->queue_.push(
+      {std::move(appender), std::chrono::steady_clock::now()});
   WORKER_STAT_INCR(appenderbuffer_appender_buffered);
   WORKER_STAT_INCR(appenderbuffer_pending_appenders);
   return true;
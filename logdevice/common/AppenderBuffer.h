@@ -7,6 +7,7 @@
  */
 #pragma once
 
+#include <chrono>
 #include <functional>
 #include <memory>
 #include <queue>
@@ -167,8 +168,15 @@ class AppenderBufferQueue {
   // logid for the queue
   logid_t logid_;
 
+  struct QueuedAppender {
+    AppenderUniqPtr appender;
+    // When the Appender was first buffered, for the
+    // appender_buffer_wait_latency histogram. Kept across requeues.
+    std::chrono::steady_clock::time_point enqueue_time;
+  };
+
   // a std::queue to store the actual Appender objects
-  std::queue<AppenderUniqPtr> queue_;
+  std::queue<QueuedAppender> queue_;
 
   // This timer is used when the queue of pending Appender objects is
   // sufficiently large, we need to periodically return to libevent loop
@@ -99,6 +99,21 @@ void AppenderPrep::execute(std::unique_ptr<Appender> appender) {
     return;
   }
 
+  if (shouldShedAppend()) {
+    // The worker has more work than it can handle. Turn the append away
+    // before spending anything on it, so that appends already in flight and
+    // traffic from other nodes aren't slowed down further.
+    RATELIMIT_INFO(std::chrono::seconds(10),
+                   1,
+                   "Rejecting APPEND from %s for log %lu with E::OVERLOADED: "
+                   "worker is shedding load",
+                   Sender::describeConnection(from_).c_str(),
+                   header_.logid.val_);
+    STAT_INCR(stats(), append_rejected_load_shedding);
+    sendError(appender.get(), E::OVERLOADED);
+    return;
+  }
+
   // Verify the integrity of the checksum bits: CHECKSUM_PARITY should be the
   // XNOR of the other two.
   bool expected_parity = bool(header_.flags & APPEND_Header::CHECKSUM) ==
@@ -1025,6 +1040,18 @@ bool AppenderPrep::isClientConnected() const {
   return !Worker::onThisThread()->sender().isClosed(Address(from_));
 }
 
+bool AppenderPrep::shouldShedAppend() const {
+  if (!from_.valid()) {
+    return false;
+  }
+  Worker* w = Worker::onThisThread();
+  if (w->loadShedding() == Worker::LoadShedding::NONE) {
+    return false;
+  }
+  const ConnectionInfo* info = w->sender().getConnectionInfo(Address(from_));
+  return info != nullptr && info->isPeerClient();
+}
+
 void AppenderPrep::isAllowed(
     std::shared_ptr<PermissionChecker> permission_checker,
     const PrincipalIdentity& principal,
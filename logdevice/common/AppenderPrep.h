@@ -154,6 +154,10 @@ class AppenderPrep : public std::enable_shared_from_this<AppenderPrep> {
   // Returns whether the client is still connected
   virtual bool isClientConnected() const;
 
+  // Returns true if the append came from a client and the worker is too far
+  // behind to take it, see Worker::loadShedding().
+  virtual bool shouldShedAppend() const;
+
   // Calls the PermissionChecker owned by the processor to determine if the
   // client is allowed to perform an append to the specified logid
   virtual void isAllowed(std::shared_ptr<PermissionChecker> permission_checker,
@@ -50,8 +50,10 @@ Request::Execution CheckSealRequest::execute() {
   Worker* w = Worker::onThisThread();
   initTimer();
 
-  auto& map = w->runningCheckSeals().map;
-  map.insert(std::make_pair(id_, std::unique_ptr<CheckSealRequest>(this)));
+  auto& check_seals = w->runningCheckSeals();
+  check_seals.map.insert(
+      std::make_pair(id_, std::unique_ptr<CheckSealRequest>(this)));
+  check_seals.by_log[log_id_] = id_;
 
   sendCheckSeals();
   return Execution::CONTINUE;
@@ -88,6 +90,18 @@ void CheckSealRequest::sendCheckSeals() {
   }
 }
 
+void CheckSealRequest::join(std::unique_ptr<GET_SEQ_STATE_Message> message,
+                            Address from) {
+  ld_spew("GET_SEQ_STATE (rqid:%lu) for log:%lu joined CheckSealRequest "
+          "(rqid:%lu, gss-rqid:%lu)",
+          message->request_id_.val(),
+          log_id_.val_,
+          id_.val(),
+          gss_message_->request_id_.val());
+  WORKER_STAT_INCR(check_seal_req_joined);
+  joined_.emplace_back(std::move(message), from);
+}
+
 void CheckSealRequest::onSent(ShardID shard, Status status) {
   ld_spew("log:%lu, (rqid:%lu, gss-rqid:%lu) to:%s, status:%s",
           log_id_.val_,
@@ -187,12 +201,14 @@ void CheckSealRequest::onReply(ShardID from,
              gss_message_->request_id_.val());
     gss_message_->notePreempted(
         msg.getHeader().sealed_epoch, msg.getHeader().sequencer);
-    gss_message_->continueExecution(from_);
+    continueExecution();
     finalize();
   } else if (replies_successful_ == copyset_.size()) {
     // If all nodes have replied successfully, finish request.
     // No retry will be sent to client
-    gss_message_->continueExecution(from_);
+    Worker::onThisThread()->runningCheckSeals().last_success[log_id_] =
+        std::make_pair(local_epoch_, std::chrono::steady_clock::now());
+    continueExecution();
     finalize();
   } else if (recvd_from_.size() == copyset_.size()) {
     // If an attempt to connect to all nodes was made
@@ -255,6 +271,16 @@ void CheckSealRequest::sendRetryToClient() {
       LSN_INVALID  // next_lsn
   };
   gss_message_->sendReply(from_, reply_hdr, E::AGAIN, NodeID());
+  for (auto& joined : joined_) {
+    joined.first->sendReply(joined.second, reply_hdr, E::AGAIN, NodeID());
+  }
+}
+
+void CheckSealRequest::continueExecution() {
+  gss_message_->continueExecution(from_);
+  for (auto& joined : joined_) {
+    joined.first->continueExecution(joined.second);
+  }
 }
 
 void CheckSealRequest::finalize() {
@@ -265,7 +291,12 @@ void CheckSealRequest::finalize() {
   }
 
   Worker* w = Worker::onThisThread();
-  auto& map = w->runningCheckSeals().map;
+  auto& check_seals = w->runningCheckSeals();
+  auto by_log_it = check_seals.by_log.find(log_id_);
+  if (by_log_it != check_seals.by_log.end() && by_log_it->second == id_) {
+    check_seals.by_log.erase(by_log_it);
+  }
+  auto& map = check_seals.map;
   auto it = map.find(id_);
   ld_check(it != map.end());
   map.erase(it); // destroys unique_ptr which owns this
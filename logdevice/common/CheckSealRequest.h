@@ -7,7 +7,10 @@
  */
 #pragma once
 
+#include <chrono>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "logdevice/common/Timer.h"
 #include "logdevice/common/protocol/CHECK_SEAL_Message.h"
@@ -29,6 +32,10 @@ namespace facebook { namespace logdevice {
  *
  * If the sequencer's epoch <= storage nodes' seal,
  * Sequencer::notePreempted() is called.
+ *
+ * GET_SEQ_STATE messages for a log that arrive on the same worker while a
+ * CheckSealRequest for the same log and epoch is running join it instead of
+ * sending CHECK_SEALs of their own, and all of them continue with its result.
  */
 class CheckSealRequest;
 
@@ -38,6 +45,16 @@ struct CheckSealRequestMap {
                      std::unique_ptr<CheckSealRequest>,
                      request_id_t::Hash>
       map;
+
+  // The most recent running request of each log.
+  std::unordered_map<logid_t, request_id_t, logid_t::Hash> by_log;
+
+  // For each log, epoch of the sequencer and time of the last request that
+  // found it not preempted. See --check-seal-cache-ttl.
+  std::unordered_map<logid_t,
+                     std::pair<epoch_t, std::chrono::steady_clock::time_point>,
+                     logid_t::Hash>
+      last_success;
 };
 
 class CheckSealRequest : public Request {
@@ -71,6 +88,18 @@ class CheckSealRequest : public Request {
    */
   void onSent(ShardID shard, Status status);
 
+  /**
+   * Makes `message' wait for the result of this request, as if it had issued
+   * it. The caller must have checked that it is for the same log and epoch.
+   *
+   * @param from  sender of `message'
+   */
+  void join(std::unique_ptr<GET_SEQ_STATE_Message> message, Address from);
+
+  epoch_t getLocalEpoch() const {
+    return local_epoch_;
+  }
+
   ~CheckSealRequest() override;
 
  private:
@@ -84,6 +113,12 @@ class CheckSealRequest : public Request {
    */
   Address from_;
 
+  /**
+   * GET_SEQ_STATE messages that joined this request, with their senders.
+   */
+  std::vector<std::pair<std::unique_ptr<GET_SEQ_STATE_Message>, Address>>
+      joined_;
+
   const logid_t log_id_;
 
   /**
@@ -144,6 +179,12 @@ class CheckSealRequest : public Request {
    */
   void sendRetryToClient();
 
+  /**
+   * Continues the execution of the GET_SEQ_STATE message that issued this
+   * request and of all the ones that joined it.
+   */
+  void continueExecution();
+
   /**
    * Setup the overall CheckSealRequest timer as half of what GET_SEQ_STATE
    * client timer is (i.e. 'seq_state_reply_timeout').
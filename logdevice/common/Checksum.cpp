@@ -7,18 +7,130 @@
  */
 #include "logdevice/common/Checksum.h"
 
+#include <algorithm>
+#include <cstring>
+
+#include <folly/CpuId.h>
+#include <folly/Portability.h>
 #include <folly/hash/Checksum.h>
 #include <folly/hash/Hash.h>
+#include <folly/hash/SpookyHashV2.h>
+#include <folly/io/IOBuf.h>
+
+#if FOLLY_X64
+#include <nmmintrin.h>
+#endif
 
 namespace facebook { namespace logdevice {
 
+namespace {
+// randomly generated
+const uint64_t CHECKSUM_64BIT_SEED = 0x5715d9be01f6a3f8ULL;
+
+#if FOLLY_X64
+// Slices longer than this are checksummed one at a time by folly::crc32c(),
+// which already interleaves within a long buffer.
+constexpr size_t CRC32C_BATCH_MAX_SLICE_SIZE = 4096;
+// Number of slices checksummed together. The CRC32 instruction has a latency
+// of 3 cycles and a throughput of 1 per cycle.
+constexpr size_t CRC32C_BATCH_WIDTH = 3;
+
+FOLLY_TARGET_ATTRIBUTE("sse4.2")
+uint32_t crc32c_hw(uint32_t crc, const uint8_t* p, size_t len) {
+  uint64_t crc64 = crc;
+  for (; len >= 8; p += 8, len -= 8) {
+    uint64_t word;
+    memcpy(&word, p, sizeof(word));
+    crc64 = _mm_crc32_u64(crc64, word);
+  }
+  crc = static_cast<uint32_t>(crc64);
+  for (; len > 0; ++p, --len) {
+    crc = _mm_crc32_u8(crc, *p);
+  }
+  return crc;
+}
+
+// Checksums CRC32C_BATCH_WIDTH slices at once: their common length in 8-byte
+// words interleaved, then the rest of each one by one.
+FOLLY_TARGET_ATTRIBUTE("sse4.2")
+void crc32c_hw_interleaved(const Slice* const* slices, uint32_t* const* out) {
+  const uint8_t* p[CRC32C_BATCH_WIDTH];
+  uint64_t crc[CRC32C_BATCH_WIDTH];
+  size_t words = SIZE_MAX;
+  for (size_t i = 0; i < CRC32C_BATCH_WIDTH; ++i) {
+    p[i] = reinterpret_cast<const uint8_t*>(slices[i]->data);
+    // Same starting value as folly::crc32c().
+    crc[i] = ~0U;
+    words = std::min(words, slices[i]->size / 8);
+  }
+  static_assert(CRC32C_BATCH_WIDTH == 3, "unroll below");
+  for (size_t w = 0; w < words; ++w) {
+    uint64_t word[CRC32C_BATCH_WIDTH];
+    memcpy(&word[0], p[0] + w * 8, 8);
+    memcpy(&word[1], p[1] + w * 8, 8);
+    memcpy(&word[2], p[2] + w * 8, 8);
+    crc[0] = _mm_crc32_u64(crc[0], word[0]);
+    crc[1] = _mm_crc32_u64(crc[1], word[1]);
+    crc[2] = _mm_crc32_u64(crc[2], word[2]);
+  }
+  for (size_t i = 0; i < CRC32C_BATCH_WIDTH; ++i) {
+    *out[i] = crc32c_hw(static_cast<uint32_t>(crc[i]),
+                        p[i] + words * 8,
+                        slices[i]->size - words * 8);
+  }
+}
+#endif
+} // namespace
+
 uint32_t checksum_32bit(Slice slice) {
   return folly::crc32c((const uint8_t*)slice.data, slice.size);
 }
 
+void checksum_32bit_batch(const Slice* slices, size_t n, uint32_t* out) {
+#if FOLLY_X64
+  static const bool hw_supported = folly::CpuId().sse42();
+  if (hw_supported) {
+    const Slice* group[CRC32C_BATCH_WIDTH];
+    uint32_t* group_out[CRC32C_BATCH_WIDTH];
+    size_t group_size = 0;
+    for (size_t i = 0; i < n; ++i) {
+      if (slices[i].size > CRC32C_BATCH_MAX_SLICE_SIZE) {
+        out[i] = checksum_32bit(slices[i]);
+        continue;
+      }
+      group[group_size] = &slices[i];
+      group_out[group_size] = &out[i];
+      if (++group_size == CRC32C_BATCH_WIDTH) {
+        crc32c_hw_interleaved(group, group_out);
+        group_size = 0;
+      }
+    }
+    for (size_t i = 0; i < group_size; ++i) {
+      *group_out[i] = checksum_32bit(*group[i]);
+    }
+    return;
+  }
+#endif
+  for (size_t i = 0; i < n; ++i) {
+    out[i] = checksum_32bit(slices[i]);
+  }
+}
+
 uint64_t checksum_64bit(Slice slice) {
-  const uint64_t seed = 0x5715d9be01f6a3f8ULL; // randomly generated
-  return folly::hash::SpookyHashV2::Hash64(slice.data, slice.size, seed);
+  return folly::hash::SpookyHashV2::Hash64(
+      slice.data, slice.size, CHECKSUM_64BIT_SEED);
+}
+
+uint64_t checksum_64bit(const folly::IOBuf& chain) {
+  // Incremental SpookyHash gives the same result as the one-shot version.
+  folly::hash::SpookyHashV2 hasher;
+  hasher.Init(CHECKSUM_64BIT_SEED, CHECKSUM_64BIT_SEED);
+  for (const auto& range : chain) {
+    hasher.Update(range.data(), range.size());
+  }
+  uint64_t hash1, hash2;
+  hasher.Final(&hash1, &hash2);
+  return hash1;
 }
 
 Slice checksum_bytes(Slice blob, int nbits, char* buf_out) {
@@ -9,6 +9,10 @@
 
 #include "logdevice/common/types_internal.h"
 
+namespace folly {
+class IOBuf;
+}
+
 namespace facebook { namespace logdevice {
 
 /**
@@ -39,6 +43,20 @@ namespace facebook { namespace logdevice {
 uint32_t checksum_32bit(Slice slice);
 uint64_t checksum_64bit(Slice slice);
 
+/**
+ * Computes checksum_32bit() of each of the `n` slices into `out`. Faster than
+ * one at a time for many small slices: the CRC32C instruction takes a few
+ * cycles to complete but a new one can start every cycle, so several slices
+ * are checksummed in an interleaved way.
+ */
+void checksum_32bit_batch(const Slice* slices, size_t n, uint32_t* out);
+
+/**
+ * Same as checksum_64bit() of the concatenated data of the IOBuf chain, but
+ * computed without flattening the chain.
+ */
+uint64_t checksum_64bit(const folly::IOBuf& chain);
+
 /**
  * Writes a binary checksum of the given blob to the given output buffer.  The
  * output buffer must be at least 8 bytes large to fit a 64-bit checksum.
@@ -32,8 +32,9 @@ void ConfigPermissionChecker::isAllowed(ACTION action,
   const auto log = config->getLogGroupByIDShared(logid);
 
   if (log && log->attrs().permissions()) {
-    auto permissions = log->attrs().permissions().value();
-    for (auto identity : principal.identities) {
+    // Don't copy the permissions map, this runs for every append and read.
+    const auto& permissions = log->attrs().permissions().value();
+    for (const auto& identity : principal.identities) {
       auto iter = permissions.find(identity.second);
       if (iter != permissions.end()) {
         if (iter->second[static_cast<int>(action)]) {
@@ -57,9 +58,10 @@ void ConfigPermissionChecker::isAllowed(ACTION action,
 
 bool ConfigPermissionChecker::isAdmin(
     const PrincipalIdentity& principal) const {
-  auto config = Worker::onThisThread()->getConfig()->serverConfig();
-  for (auto identity : principal.identities) {
-    if (config->getSecurityConfig().isAdmin(identity.second)) {
+  auto server_config = Worker::onThisThread()->getServerConfig();
+  const auto& security_config = server_config->getSecurityConfig();
+  for (const auto& identity : principal.identities) {
+    if (security_config.isAdmin(identity.second)) {
       return true;
     }
   }
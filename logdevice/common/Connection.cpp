@@ -36,16 +36,21 @@
 #include "logdevice/common/configuration/ServerConfig.h"
 #include "logdevice/common/configuration/nodes/NodesConfiguration.h"
 #include "logdevice/common/debug.h"
+#include "logdevice/common/network/MessageCompressor.h"
 #include "logdevice/common/network/MessageReader.h"
 #include "logdevice/common/network/SessionInjectorCallback.h"
 #include "logdevice/common/network/SocketAdapter.h"
 #include "logdevice/common/network/SocketConnectCallback.h"
+#include "logdevice/common/protocol/APPENDS_BATCH_Message.h"
+#include "logdevice/common/protocol/COMPRESSED_Message.h"
 #include "logdevice/common/protocol/Compatibility.h"
 #include "logdevice/common/protocol/Message.h"
 #include "logdevice/common/protocol/MessageTypeNames.h"
 #include "logdevice/common/protocol/ProtocolHeader.h"
 #include "logdevice/common/protocol/ProtocolReader.h"
 #include "logdevice/common/protocol/ProtocolWriter.h"
+#include "logdevice/common/protocol/STORES_BATCH_Message.h"
+#include "logdevice/common/protocol/TRIMS_BATCH_Message.h"
 #include "logdevice/common/settings/Settings.h"
 #include "logdevice/common/stats/Stats.h"
 #include "logdevice/common/util.h"
@@ -228,7 +233,9 @@ Connection::Connection(int fd,
   sock_write_cb_ = SocketWriteCallback(proto_handler_.get());
   proto_handler_->getSentEvent()->attachCallback([this] { drainSendQueue(); });
   // Set the read callback.
-  read_cb_.reset(new MessageReader(*proto_handler_, getProto()));
+  read_cb_.reset(new MessageReader(*proto_handler_,
+                                   getProto(),
+                                   getSettings().socket_read_pool_buffer_size));
   proto_handler_->sock()->setReadCB(read_cb_.get());
 }
 
@@ -377,6 +384,7 @@ int Connection::preConnectAttempt() {
 
 static folly::SocketOptionMap
 getDefaultSocketOptions(const folly::SocketAddress& sock_addr,
+                        SocketType socket_type,
                         const Settings& settings) {
   folly::SocketOptionMap options;
   sa_family_t sa_family = sock_addr.getFamily();
@@ -424,8 +432,12 @@ getDefaultSocketOptions(const folly::SocketAddress& sock_addr,
   }
 #endif
 
-  const uint8_t default_dscp = settings.server ? settings.server_dscp_default
-                                               : settings.client_dscp_default;
+  uint8_t default_dscp = settings.server ? settings.server_dscp_default
+                                         : settings.client_dscp_default;
+  const bool is_gossip = settings.server && socket_type == SocketType::GOSSIP;
+  if (is_gossip && settings.gossip_dscp >= 0) {
+    default_dscp = settings.gossip_dscp;
+  }
   const int diff_svcs = default_dscp << 2;
   switch (sa_family) {
     case AF_INET: {
@@ -439,6 +451,13 @@ getDefaultSocketOptions(const folly::SocketAddress& sock_addr,
     default:
       break;
   }
+
+#ifdef __linux__
+  if (is_gossip && settings.gossip_socket_priority >= 0) {
+    options.emplace(
+        OptionKey{SOL_SOCKET, SO_PRIORITY}, settings.gossip_socket_priority);
+  }
+#endif
   return options;
 }
 
@@ -447,8 +466,10 @@ folly::Future<Status> Connection::asyncConnect() {
   size_t max_retries = getSettings().connection_retries;
   auto connect_timeout_retry_multiplier =
       getSettings().connect_timeout_retry_multiplier;
-  folly::SocketOptionMap options(getDefaultSocketOptions(
-      info_.peer_address.getSocketAddress(), getSettings()));
+  folly::SocketOptionMap options(
+      getDefaultSocketOptions(info_.peer_address.getSocketAddress(),
+                              info_.socket_type,
+                              getSettings()));
 
   for (size_t retry_count = 1; retry_count < max_retries; ++retry_count) {
     timeout += std::chrono::duration_cast<std::chrono::milliseconds>(
@@ -524,7 +545,10 @@ int Connection::connect() {
     auto g = folly::makeGuard(deps_->setupContextGuard());
     if (st == E::ISCONN) {
       transitionToConnected();
-      read_cb_.reset(new MessageReader(*proto_handler_, getProto()));
+      read_cb_.reset(
+          new MessageReader(*proto_handler_,
+                            getProto(),
+                            getSettings().socket_read_pool_buffer_size));
       proto_handler_->sock()->setReadCB(read_cb_.get());
     }
   };
@@ -683,6 +707,18 @@ void Connection::setSoMark(uint32_t so_mark) {
   }
 }
 
+void Connection::setSoPriority(int priority) {
+  const int rc = deps_->setSoPriority(fd_, priority);
+
+  if (rc != 0) {
+    RATELIMIT_ERROR(std::chrono::seconds(1),
+                    10,
+                    "SO_PRIORITY(%d) configuration failed: %s",
+                    priority,
+                    strerror(errno));
+  }
+}
+
 bool Connection::isIdleAfter(SteadyTimestamp watermark) {
   // If connection has any on_close listeners set we consider it as "not idle"
   // assuming that active listener indicates waiting for some data to arrive
@@ -753,6 +789,7 @@ void Connection::close(Status reason) {
   }
   sock_write_cb_.clear();
   sendChain_.reset();
+  send_chain_bytes_ = 0;
   sched_write_chain_.cancelTimeout();
   // Invoke closeNow to close the socket.
   proto_handler_->sock()->closeNow();
@@ -873,27 +910,95 @@ std::unique_ptr<folly::IOBuf> Connection::serializeMessage(const Message& msg) {
     close(err);
     return nullptr;
   }
+  if (maybeCompress(msg, result) != 0) {
+    close(err);
+    return nullptr;
+  }
   return result;
 }
 
+int Connection::maybeCompress(const Message& msg,
+                              std::unique_ptr<folly::IOBuf>& buf) {
+  const Settings& settings = getSettings();
+  if (settings.message_compression != Compression::ZSTD ||
+      getProto() < Compatibility::COMPRESSED_MESSAGE_SUPPORT ||
+      isHandshakeMessage(msg.type_)) {
+    return 0;
+  }
+  const size_t msglen = buf->computeChainDataLength();
+  if (msglen < settings.message_compression_min_size) {
+    return 0;
+  }
+
+  if (!compressor_) {
+    compressor_ = std::make_unique<MessageCompressor>(
+        settings.message_compression_zstd_level);
+  }
+  std::unique_ptr<folly::IOBuf> blob = compressor_->compress(*buf);
+  if (!blob) {
+    err = E::INTERNAL;
+    return -1;
+  }
+  // Once a message went through the compression stream it has to be sent
+  // compressed even if that didn't save anything, since the next messages
+  // may refer to its data.
+  COMPRESSED_Header header = {
+      Compression::ZSTD, static_cast<uint32_t>(msglen)};
+  COMPRESSED_Message compressed(header, std::move(blob), msg.tc_);
+  auto result = compressed.serialize(getProto(), /* checksum_enabled */ false);
+  if (!result) {
+    return -1;
+  }
+  STAT_INCR(deps_->getStats(), messages_compressed);
+  STAT_ADD(deps_->getStats(),
+           message_compression_bytes_saved,
+           static_cast<int64_t>(msglen) -
+               static_cast<int64_t>(result->computeChainDataLength()));
+  buf = std::move(result);
+  return 0;
+}
+
 Connection::SendStatus
 Connection::sendBuffer(std::unique_ptr<folly::IOBuf>&& io_buf) {
   if (proto_handler_->good()) {
+    const size_t prev_bytes = send_chain_bytes_;
+    send_chain_bytes_ += io_buf->computeChainDataLength();
+    // Don't wait for the time trigger once the batch is large enough. The
+    // write still happens from the event loop rather than inline, so that
+    // write callbacks never run while a message is being sent.
+    const size_t size_trigger = getSettings().socket_batching_size_trigger;
+    const bool size_triggered = size_trigger > 0 &&
+        prev_bytes < size_trigger && send_chain_bytes_ >= size_trigger;
     if (sendChain_) {
       ld_check(sched_write_chain_.isScheduled());
       sendChain_->prependChain(std::move(io_buf));
+      if (size_triggered) {
+        sched_write_chain_.cancelTimeout();
+        sched_write_chain_.scheduleTimeout(std::chrono::milliseconds::zero());
+      }
     } else {
       sendChain_ = std::move(io_buf);
       ld_check(!sched_write_chain_.isScheduled());
       sched_write_chain_.attachCallback([this]() { scheduleWriteChain(); });
       sched_write_chain_.scheduleTimeout(
-          getSettings().socket_batching_time_trigger);
+          size_triggered ? std::chrono::milliseconds::zero()
+                         : getSettings().socket_batching_time_trigger);
       sched_start_time_ = SteadyTimestamp::now();
     }
   }
   return Connection::SendStatus::SCHEDULED;
 }
 
+bool Connection::useZeroCopy() {
+  if (!zero_copy_checked_) {
+    zero_copy_checked_ = true;
+    // With TLS the data is encrypted into a separate buffer anyway.
+    zero_copy_enabled_ = proto_handler_->sock()->getSSL() == nullptr &&
+        proto_handler_->sock()->setZeroCopy(true);
+  }
+  return zero_copy_enabled_;
+}
+
 void Connection::scheduleWriteChain() {
   auto g = folly::makeGuard(deps_->setupContextGuard());
   if (!proto_handler_->good()) {
@@ -911,7 +1016,16 @@ void Connection::scheduleWriteChain() {
       SocketWriteCallback::WriteUnit{bytes_in_sendq, now});
   // These bytes are now buffered in socket and will be removed from sendq.
   sock_write_cb_.bytes_buffered += bytes_in_sendq;
-  proto_handler_->sock()->writeChain(&sock_write_cb_, std::move(sendChain_));
+  // The whole chain goes out in as few writev() calls as the socket allows.
+  folly::WriteFlags flags = folly::WriteFlags::NONE;
+  const size_t zero_copy_threshold = getSettings().socket_zero_copy_threshold;
+  if (zero_copy_threshold > 0 && send_chain_bytes_ >= zero_copy_threshold &&
+      useZeroCopy()) {
+    flags = folly::WriteFlags::WRITE_MSG_ZEROCOPY;
+  }
+  send_chain_bytes_ = 0;
+  proto_handler_->sock()->writeChain(
+      &sock_write_cb_, std::move(sendChain_), flags);
   // All the bytes will be now removed from sendq now that we have written into
   // the asyncsocket.
   onBytesAdmittedToSend(bytes_in_sendq);
@@ -1400,8 +1514,171 @@ bool Connection::processHandshakeMessage(const Message* msg) {
   return true;
 }
 
+int Connection::dispatchCompressedMessage(
+    const ProtocolHeader& ph,
+    std::unique_ptr<folly::IOBuf> inbuf) {
+  auto g = folly::makeGuard(deps_->setupContextGuard());
+  ProtocolReader reader(ph.type, std::move(inbuf), getProto());
+  std::unique_ptr<Message> msg = deps_->deserialize(ph, reader);
+  if (!msg) {
+    ld_error("PROTOCOL ERROR: got an invalid COMPRESSED message from peer %s",
+             conn_description_.c_str());
+    err = E::BADMSG;
+    return -1;
+  }
+  const auto& compressed = checked_downcast<const COMPRESSED_Message&>(*msg);
+
+  if (!decompressor_) {
+    decompressor_ = std::make_unique<MessageDecompressor>();
+  }
+  std::unique_ptr<folly::IOBuf> buf = decompressor_->decompress(
+      *compressed.blob_, compressed.header_.uncompressed_size);
+  if (!buf) {
+    ld_error("PROTOCOL ERROR: failed to decompress a COMPRESSED message from "
+             "peer %s",
+             conn_description_.c_str());
+    err = E::BADMSG;
+    return -1;
+  }
+
+  ProtocolHeader inner;
+  if (!readWrappedProtocolHeader(*buf, inner) ||
+      inner.type == MessageType::COMPRESSED ||
+      isHandshakeMessage(inner.type)) {
+    ld_error("PROTOCOL ERROR: COMPRESSED message from peer %s wraps an "
+             "invalid message of type %s and length %u",
+             conn_description_.c_str(),
+             messageTypeNames()[inner.type].c_str(),
+             inner.len);
+    err = E::BADMSG;
+    return -1;
+  }
+  if (!proto_handler_->validateProtocolHeader(inner)) {
+    return -1;
+  }
+  STAT_INCR(deps_->getStats(), messages_decompressed);
+  return dispatchMessageBody(inner, std::move(buf));
+}
+
+bool Connection::readWrappedProtocolHeader(folly::IOBuf& buf,
+                                           ProtocolHeader& out) {
+  const size_t min_protohdr_bytes =
+      sizeof(ProtocolHeader) - sizeof(ProtocolHeader::cksum);
+  buf.coalesce();
+  out.type = MessageType::INVALID;
+  out.len = 0;
+  if (buf.length() < min_protohdr_bytes) {
+    return false;
+  }
+  memcpy(&out, buf.data(), min_protohdr_bytes);
+  const size_t protohdr_bytes =
+      ProtocolHeader::bytesNeeded(out.type, getProto());
+  if (buf.length() < protohdr_bytes || out.len != buf.length()) {
+    return false;
+  }
+  memcpy(&out, buf.data(), protohdr_bytes);
+  buf.trimStart(protohdr_bytes);
+  return true;
+}
+
+int Connection::dispatchBatchMessage(const ProtocolHeader& ph,
+                                     std::unique_ptr<folly::IOBuf> inbuf) {
+  auto g = folly::makeGuard(deps_->setupContextGuard());
+  ProtocolReader reader(ph.type, std::move(inbuf), getProto());
+  if (!verifyChecksum(ph, reader)) {
+    err = E::BADMSG;
+    return -1;
+  }
+  std::unique_ptr<Message> msg = deps_->deserialize(ph, reader);
+  if (!msg) {
+    ld_error("PROTOCOL ERROR: got an invalid %s message from peer %s",
+             messageTypeNames()[ph.type].c_str(),
+             conn_description_.c_str());
+    err = E::BADMSG;
+    return -1;
+  }
+
+  // Type of the messages the batch may carry, and their serialized form.
+  MessageType inner_type;
+  std::vector<std::unique_ptr<folly::IOBuf>>* serialized;
+  if (ph.type == MessageType::APPENDS_BATCH) {
+    inner_type = MessageType::APPEND;
+    serialized =
+        &checked_downcast<APPENDS_BATCH_Message&>(*msg).serialized_appends_;
+    STAT_INCR(deps_->getStats(), append_batches_received);
+  } else if (ph.type == MessageType::STORES_BATCH) {
+    inner_type = MessageType::STORE;
+    serialized =
+        &checked_downcast<STORES_BATCH_Message&>(*msg).serialized_stores_;
+    STAT_INCR(deps_->getStats(), store_batches_received);
+  } else {
+    ld_check(ph.type == MessageType::TRIMS_BATCH);
+    inner_type = MessageType::TRIM;
+    serialized =
+        &checked_downcast<TRIMS_BATCH_Message&>(*msg).serialized_trims_;
+    STAT_INCR(deps_->getStats(), trim_batches_received);
+  }
+
+  std::vector<WrappedMessage> msgs;
+  msgs.reserve(serialized->size());
+  for (auto& buf : *serialized) {
+    ProtocolHeader inner;
+    if (!readWrappedProtocolHeader(*buf, inner) || inner.type != inner_type) {
+      ld_error("PROTOCOL ERROR: %s message from peer %s carries an invalid "
+               "message of type %s and length %u",
+               messageTypeNames()[ph.type].c_str(),
+               conn_description_.c_str(),
+               messageTypeNames()[inner.type].c_str(),
+               inner.len);
+      err = E::BADMSG;
+      return -1;
+    }
+    msgs.emplace_back(inner, std::move(buf));
+  }
+  return dispatchWrappedMessages(std::move(msgs));
+}
+
+int Connection::dispatchWrappedMessages(std::vector<WrappedMessage> msgs) {
+  for (size_t i = 0; i < msgs.size(); ++i) {
+    if (!proto_handler_->validateProtocolHeader(msgs[i].first)) {
+      return -1;
+    }
+    std::unique_ptr<folly::IOBuf> body = msgs[i].second->clone();
+    int rv = dispatchMessageBody(msgs[i].first, std::move(msgs[i].second));
+    if (rv == 0) {
+      continue;
+    }
+    if (err == E::NOBUFS && retry_receipt_of_message_.isScheduled()) {
+      // dispatchMessageBody() only retries the message that didn't fit.
+      // Retry the rest of the batch along with it.
+      msgs[i].second = std::move(body);
+      msgs.erase(msgs.begin(), msgs.begin() + i);
+      retry_receipt_of_message_.cancelTimeout();
+      retry_receipt_of_message_.attachCallback(
+          [this, rest = std::move(msgs)]() mutable {
+            if (dispatchWrappedMessages(std::move(rest)) == 0) {
+              proto_handler_->sock()->setReadCB(read_cb_.get());
+            } else if (err != E::NOBUFS) {
+              close(err);
+            }
+          });
+      retry_receipt_of_message_.scheduleTimeout(0);
+    }
+    return rv;
+  }
+  return 0;
+}
+
 int Connection::dispatchMessageBody(ProtocolHeader header,
                                     std::unique_ptr<folly::IOBuf> inbuf) {
+  if (header.type == MessageType::COMPRESSED) {
+    return dispatchCompressedMessage(header, std::move(inbuf));
+  }
+  if (header.type == MessageType::APPENDS_BATCH ||
+      header.type == MessageType::STORES_BATCH ||
+      header.type == MessageType::TRIMS_BATCH) {
+    return dispatchBatchMessage(header, std::move(inbuf));
+  }
   auto g = folly::makeGuard(deps_->setupContextGuard());
   ProtocolHeader& ph = header;
   // Tell the Worker that we're processing a message, so it can time it.
@@ -1417,6 +1694,22 @@ int Connection::dispatchMessageBody(ProtocolHeader header,
       ProtocolHeader::bytesNeeded(ph.type, getProto());
   size_t payload_size = ph.len - protocol_bytes_already_read;
 
+  if (handshaken_ && info_.isPeerClient() &&
+      deps_->shouldPauseClientReads()) {
+    // The worker is too far behind. Leave messages from clients in the socket
+    // until it catches up, so that the work it already took on, and the
+    // traffic from other nodes it needs to finish that work, get through.
+    RATELIMIT_INFO(std::chrono::seconds(10),
+                   1,
+                   "Pausing reads from client %s: worker is shedding load.",
+                   conn_description_.c_str());
+    STAT_INCR(deps_->getStats(), client_reads_paused_load_shedding);
+    err = E::NOBUFS;
+    retryReceiptOfMessage(
+        header, std::move(inbuf), LOAD_SHEDDING_RETRY_DELAY_MS);
+    return -1;
+  }
+
   // Request reservation to add this message into the system.
   auto resource_token = deps_->getResourceToken(payload_size);
   if (!resource_token && !shouldBeInlined(ph.type)) {
@@ -1431,17 +1724,7 @@ int Connection::dispatchMessageBody(ProtocolHeader header,
     // No space to push more messages on the worker, disable the read
     // callback. Retry this message and if successful it will add back the
     // ReadCallback.
-    ld_check(!retry_receipt_of_message_.isScheduled());
-    retry_receipt_of_message_.attachCallback(
-        [this, hdr = header, payload = std::move(inbuf)]() mutable {
-          if (proto_handler_->dispatchMessageBody(hdr, std::move(payload)) ==
-              0) {
-            proto_handler_->sock()->setReadCB(read_cb_.get());
-          }
-        });
-    retry_receipt_of_message_.scheduleTimeout(0);
-    proto_handler_->sock()->setReadCB(nullptr);
-
+    retryReceiptOfMessage(header, std::move(inbuf), 0);
     return -1;
   }
 
@@ -1573,6 +1856,21 @@ int Connection::dispatchMessageBody(ProtocolHeader header,
   return 0;
 }
 
+void Connection::retryReceiptOfMessage(ProtocolHeader header,
+                                       std::unique_ptr<folly::IOBuf> inbuf,
+                                       uint32_t delay_ms) {
+  ld_check(!retry_receipt_of_message_.isScheduled());
+  retry_receipt_of_message_.attachCallback(
+      [this, hdr = header, payload = std::move(inbuf)]() mutable {
+        if (proto_handler_->dispatchMessageBody(hdr, std::move(payload)) ==
+            0) {
+          proto_handler_->sock()->setReadCB(read_cb_.get());
+        }
+      });
+  retry_receipt_of_message_.scheduleTimeout(delay_ms);
+  proto_handler_->sock()->setReadCB(nullptr);
+}
+
 int Connection::pushOnCloseCallback(SocketCallback& cb) {
   if (cb.active()) {
     RATELIMIT_CRITICAL(
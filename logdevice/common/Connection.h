@@ -9,6 +9,8 @@
 
 #include <chrono>
 #include <memory>
+#include <utility>
+#include <vector>
 
 #include <folly/futures/Future.h>
 #include <folly/io/async/AsyncSocket.h>
@@ -35,6 +37,8 @@ namespace facebook { namespace logdevice {
 
 class BWAvailableCallback;
 class FlowGroup;
+class MessageCompressor;
+class MessageDecompressor;
 class ProtocolHandler;
 class SocketAdapter;
 class SocketCallback;
@@ -370,6 +374,12 @@ class Connection : public TrafficShappingSocket {
    */
   void setSoMark(uint32_t so_mark);
 
+  /**
+   * Set the SO_PRIORITY of this socket, which orders its packets in the
+   * host's queueing disciplines.
+   */
+  void setSoPriority(int priority);
+
   /**
    * @return true iff close() has been called on the socket, or if it is
    *         a server socket that has never been connected
@@ -597,6 +607,13 @@ class Connection : public TrafficShappingSocket {
    */
   void scheduleWriteChain();
 
+  /**
+   * Enables MSG_ZEROCOPY on the socket the first time it's called.
+   *
+   * @return true if writes to this socket can use MSG_ZEROCOPY.
+   */
+  bool useZeroCopy();
+
   void onSent(std::unique_ptr<Envelope>,
               Status,
               Message::CompletionMethod = Message::CompletionMethod::IMMEDIATE);
@@ -683,6 +700,61 @@ class Connection : public TrafficShappingSocket {
    */
   std::unique_ptr<folly::IOBuf> serializeMessage(const Message& msg);
 
+  /**
+   * If --message-compression is enabled and the peer supports it, replaces
+   * the serialized message `buf` with a COMPRESSED message wrapping it. Does
+   * nothing for small messages and messages that are part of the handshake.
+   *
+   * @return 0 on success, -1 if compression failed. The compression stream
+   *         of the connection can't be used after that and err is set to
+   *         E::INTERNAL.
+   */
+  int maybeCompress(const Message& msg, std::unique_ptr<folly::IOBuf>& buf);
+
+  /**
+   * Called by dispatchMessageBody() for a COMPRESSED message. Decompresses
+   * the wrapped message and dispatches it.
+   */
+  int dispatchCompressedMessage(const ProtocolHeader& header,
+                                std::unique_ptr<folly::IOBuf> inbuf);
+
+  /**
+   * Called by dispatchMessageBody() for an APPENDS_BATCH, STORES_BATCH or
+   * TRIMS_BATCH message. Dispatches each of the messages it carries.
+   */
+  int dispatchBatchMessage(const ProtocolHeader& header,
+                           std::unique_ptr<folly::IOBuf> inbuf);
+
+  // ProtocolHeader and body of a message carried inside another one.
+  using WrappedMessage =
+      std::pair<ProtocolHeader, std::unique_ptr<folly::IOBuf>>;
+
+  /**
+   * Reads the ProtocolHeader of a serialized message carried inside another
+   * one into `out` and trims it off `buf`.
+   *
+   * @return false if `buf` doesn't contain exactly one message.
+   */
+  bool readWrappedProtocolHeader(folly::IOBuf& buf, ProtocolHeader& out);
+
+  /**
+   * Dispatches `msgs` in order. If one of them has to be retried because
+   * the worker is out of buffer space, the ones after it are retried with it.
+   */
+  int dispatchWrappedMessages(std::vector<WrappedMessage> msgs);
+
+  /**
+   * Stops reading from the socket and dispatches the message again after
+   * `delay_ms`. Reading resumes once the message is dispatched.
+   */
+  void retryReceiptOfMessage(ProtocolHeader header,
+                             std::unique_ptr<folly::IOBuf> inbuf,
+                             uint32_t delay_ms);
+
+  // How often a client connection paused for load shedding checks whether
+  // the worker has caught up.
+  static constexpr uint32_t LOAD_SHEDDING_RETRY_DELAY_MS = 10;
+
   /**
    * Invoked by connect() to initiate the connection to peer.
    * Returns Future that is fulfilled once the connection completes.
@@ -946,9 +1018,9 @@ class Connection : public TrafficShappingSocket {
   // layers.
   std::unique_ptr<folly::AsyncSocket::ReadCallback> read_cb_;
 
-  // If receive of a message hit ENOBUFS then we will retry the same message
-  // again till it succeeds. This will all stop reading more messages from the
-  // socket.
+  // If receive of a message hit ENOBUFS, or the worker is shedding client
+  // load, then we will retry the same message again till it succeeds. This
+  // will all stop reading more messages from the socket.
   EvTimer retry_receipt_of_message_;
 
   SocketWriteCallback sock_write_cb_;
@@ -959,6 +1031,20 @@ class Connection : public TrafficShappingSocket {
   // not invoke computeChainDataLength on it frequently.
   std::unique_ptr<folly::IOBuf> sendChain_;
 
+  // Number of bytes in sendChain_. Compared against
+  // --socket-batching-size-trigger to write the batch early.
+  size_t send_chain_bytes_{0};
+
+  // True once we tried to enable MSG_ZEROCOPY on the socket, see
+  // --socket-zero-copy-threshold. zero_copy_enabled_ is the outcome.
+  bool zero_copy_checked_{false};
+  bool zero_copy_enabled_{false};
+
+  // Compression streams of the messages sent and received on this
+  // connection, see --message-compression. Created on first use.
+  std::unique_ptr<MessageCompressor> compressor_;
+  std::unique_ptr<MessageDecompressor> decompressor_;
+
   // Timer used to schedule event as soon as data is added to sendChain_.The
   // callback of this timer add data into the asyncsocket.
   EvTimer sched_write_chain_;
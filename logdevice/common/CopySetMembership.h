@@ -0,0 +1,124 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "logdevice/common/ShardID.h"
+
+/**
+ * @file Vectorized membership tests on copysets, used by the copyset filters
+ * of rebuilding and SCD reads. These run for every copyset index entry a
+ * filtered read visits, so they are a significant part of the CPU cost of
+ * rebuilding a shard.
+ *
+ * A ShardID is 4 bytes, and a copyset is a contiguous array of them, so four
+ * copyset entries are compared against a shard with a single SSE2
+ * instruction. Without SSE2 the functions fall back to plain loops.
+ */
+
+namespace facebook { namespace logdevice { namespace copyset_membership {
+
+namespace detail {
+
+inline int32_t pack(ShardID shard) {
+  static_assert(sizeof(ShardID) == sizeof(int32_t), "");
+  int32_t v;
+  std::memcpy(&v, &shard, sizeof(v));
+  return v;
+}
+
+#if defined(__SSE2__)
+// Loads min(4, size) ShardIDs starting at `copyset`. Returns the mask of
+// movemask bits that correspond to the loaded lanes.
+inline __m128i load(const ShardID* copyset, size_t size, int* lane_mask) {
+  if (size >= 4) {
+    *lane_mask = 0xffff;
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(copyset));
+  }
+  uint32_t buf[4] = {0, 0, 0, 0};
+  std::memcpy(buf, copyset, size * sizeof(ShardID));
+  *lane_mask = (1 << (size * 4)) - 1;
+  return _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf));
+}
+#endif
+
+} // namespace detail
+
+/**
+ * Returns the index of the first occurrence of `shard` in
+ * `copyset[0..size)`, or `size` if there's none.
+ */
+inline size_t find(const ShardID* copyset, size_t size, ShardID shard) {
+#if defined(__SSE2__)
+  const __m128i needle = _mm_set1_epi32(detail::pack(shard));
+  for (size_t i = 0; i < size; i += 4) {
+    int lane_mask;
+    __m128i v = detail::load(copyset + i, size - i, &lane_mask);
+    int m = _mm_movemask_epi8(_mm_cmpeq_epi32(v, needle)) & lane_mask;
+    if (m != 0) {
+      return i + __builtin_ctz(m) / 4;
+    }
+  }
+  return size;
+#else
+  for (size_t i = 0; i < size; ++i) {
+    if (copyset[i] == shard) {
+      return i;
+    }
+  }
+  return size;
+#endif
+}
+
+inline bool contains(const ShardID* copyset, size_t size, ShardID shard) {
+  return find(copyset, size, shard) != size;
+}
+
+/**
+ * Returns true if at least one of `shards[0..num_shards)` appears in
+ * `copyset[0..size)`.
+ *
+ * Each chunk of the copyset is loaded once and compared against all of
+ * `shards`, which is expected to be small (e.g. the rebuilding set).
+ */
+inline bool containsAny(const ShardID* copyset,
+                        size_t size,
+                        const ShardID* shards,
+                        size_t num_shards) {
+#if defined(__SSE2__)
+  for (size_t i = 0; i < size; i += 4) {
+    int lane_mask;
+    __m128i v = detail::load(copyset + i, size - i, &lane_mask);
+    __m128i eq = _mm_setzero_si128();
+    for (size_t j = 0; j < num_shards; ++j) {
+      eq = _mm_or_si128(
+          eq, _mm_cmpeq_epi32(v, _mm_set1_epi32(detail::pack(shards[j]))));
+    }
+    if ((_mm_movemask_epi8(eq) & lane_mask) != 0) {
+      return true;
+    }
+  }
+  return false;
+#else
+  for (size_t i = 0; i < size; ++i) {
+    for (size_t j = 0; j < num_shards; ++j) {
+      if (copyset[i] == shards[j]) {
+        return true;
+      }
+    }
+  }
+  return false;
+#endif
+}
+
+}}} // namespace facebook::logdevice::copyset_membership
@@ -274,6 +274,18 @@ class DRRScheduler {
     return dequeueInternal();
   }
 
+  /*
+   * Same as blockingDequeue(), but returns NULL if
+   * no request shows up within `timeout`.
+   */
+  T* timedDequeue(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!cond_.wait_for(lock, timeout, [this] { return numReqs_ != 0; })) {
+      return NULL;
+    }
+    return dequeueInternal();
+  }
+
   /*
    * Non-blocking interface for dequeueing the next
    * eligible request. Returns NULL if all the
@@ -7,11 +7,44 @@
  */
 #include "logdevice/common/EpochMetaDataCache.h"
 
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+
 namespace facebook { namespace logdevice {
 
-EpochMetaDataCache::EpochMetaDataCache(size_t max_entries)
-    : cache_(max_entries) {
+EpochMetaDataCache::EpochMetaDataCache(size_t max_entries, size_t num_shards) {
   ld_check(max_entries > 0);
+  ld_check(num_shards > 0);
+  // every shard must be able to hold at least one entry
+  num_shards = std::min(num_shards, max_entries);
+  const size_t shard_entries = (max_entries + num_shards - 1) / num_shards;
+  shards_.reserve(num_shards);
+  for (size_t i = 0; i < num_shards; ++i) {
+    shards_.push_back(std::make_unique<Shard>(shard_entries));
+  }
+}
+
+std::shared_ptr<EpochMetaDataCache>
+EpochMetaDataCache::getForCluster(const std::string& cluster_name,
+                                  size_t max_entries,
+                                  size_t num_shards) {
+  static std::mutex mutex;
+  static std::unordered_map<std::string, std::weak_ptr<EpochMetaDataCache>>
+      caches;
+
+  std::lock_guard<std::mutex> guard(mutex);
+  auto& weak = caches[cluster_name];
+  std::shared_ptr<EpochMetaDataCache> cache = weak.lock();
+  if (!cache) {
+    cache = std::make_shared<EpochMetaDataCache>(max_entries, num_shards);
+    weak = cache;
+  }
+  return cache;
+}
+
+EpochMetaDataCache::Shard& EpochMetaDataCache::getShard(logid_t logid) const {
+  return *shards_[folly::hash::twang_mix64(logid.val_) % shards_.size()];
 }
 
 bool EpochMetaDataCache::getMetaData(logid_t logid,
@@ -23,9 +56,10 @@ bool EpochMetaDataCache::getMetaData(logid_t logid,
   ld_check(until_out != nullptr);
   ld_check(metadata_out != nullptr);
   ld_check(source_out != nullptr);
-  folly::SharedMutex::WriteHolder write_guard(cache_mutex_);
-  auto it = cache_.find(std::make_pair(logid, epoch));
-  if (it == cache_.end()) {
+  Shard& shard = getShard(logid);
+  folly::SharedMutex::WriteHolder write_guard(shard.mutex);
+  auto it = shard.cache.find(std::make_pair(logid, epoch));
+  if (it == shard.cache.end()) {
     return false;
   }
 
@@ -54,9 +88,10 @@ bool EpochMetaDataCache::getMetaDataNoPromotion(logid_t logid,
   ld_check(source_out != nullptr);
 
   // using read locks here since the cache is immutable
-  folly::SharedMutex::ReadHolder read_guard(cache_mutex_);
-  auto it = cache_.findWithoutPromotion(std::make_pair(logid, epoch));
-  if (it == cache_.end()) {
+  const Shard& shard = getShard(logid);
+  folly::SharedMutex::ReadHolder read_guard(shard.mutex);
+  auto it = shard.cache.findWithoutPromotion(std::make_pair(logid, epoch));
+  if (it == shard.cache.end()) {
     return false;
   }
 
@@ -85,16 +120,17 @@ void EpochMetaDataCache::setMetaData(logid_t logid,
     return;
   }
 
-  folly::SharedMutex::WriteHolder write_guard(cache_mutex_);
-  auto it = cache_.findWithoutPromotion(std::make_pair(logid, epoch));
-  if (it != cache_.end() &&
+  Shard& shard = getShard(logid);
+  folly::SharedMutex::WriteHolder write_guard(shard.mutex);
+  auto it = shard.cache.findWithoutPromotion(std::make_pair(logid, epoch));
+  if (it != shard.cache.end() &&
       it->second.source == RecordSource::CACHED_CONSISTENT &&
       source == RecordSource::CACHED_SOFT) {
     // do not overwrite an existing consistent record with a soft one
     return;
   }
 
-  cache_.set(std::make_pair(logid, epoch), {until, source, metadata});
+  shard.cache.set(std::make_pair(logid, epoch), {until, source, metadata});
 }
 
 }} // namespace facebook::logdevice
@@ -7,7 +7,10 @@
  */
 #pragma once
 
+#include <memory>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include <boost/noncopyable.hpp>
 #include <folly/SharedMutex.h>
@@ -36,12 +39,16 @@ namespace facebook { namespace logdevice {
  *         directly from metadata logs instead.
  *
  *  The cache is meant to be shared among all worker threads and is proteceted
- *  by locks.
+ *  by locks. Entries are split by log id into independently locked LRU
+ *  shards, so that readers of different logs don't contend on one lock and
+ *  the eviction order is only approximately LRU.
+ *
+ *  A cache can also be shared by all clients of the same cluster in the
+ *  process, see getForCluster().
  *
  * TODO: write our own LRU cache implementation that supports:
  *       1) epoch interval ranged looked up
- *       2) finer grained locking
- *       3) reduce write frequency by rate limiting promotions
+ *       2) reduce write frequency by rate limiting promotions
  */
 
 class EpochMetaData;
@@ -50,8 +57,18 @@ class EpochMetaDataCache : boost::noncopyable {
  public:
   using RecordSource = MetaDataLogReader::RecordSource;
 
-  // create the cache with maximum entry size of @param max_entries
-  explicit EpochMetaDataCache(size_t max_entries);
+  // create the cache with maximum entry size of @param max_entries, split
+  // into @param num_shards LRU shards of equal capacity
+  explicit EpochMetaDataCache(size_t max_entries, size_t num_shards = 1);
+
+  // Returns the cache shared by all callers in the process that pass the same
+  // @param cluster_name, creating it with the given capacity and number of
+  // shards if there is none. The cache is destroyed when the last reference
+  // to it goes away.
+  static std::shared_ptr<EpochMetaDataCache>
+  getForCluster(const std::string& cluster_name,
+                size_t max_entries,
+                size_t num_shards);
 
   // Given logid and epoch, search the epoch metadata in the cache.
   // @return       true if there is a cache hit, and results (metadata and
@@ -95,12 +112,21 @@ class EpochMetaDataCache : boost::noncopyable {
     EpochMetaData metadata;
   };
 
-  // the internal LRU cache
   using LRUCache = folly::EvictingCacheMap<Key, Value, KeyHasher>;
-  LRUCache cache_;
 
-  // protect the access to lru_cache_
-  folly::SharedMutex cache_mutex_;
+  struct Shard {
+    explicit Shard(size_t max_entries) : cache(max_entries) {}
+
+    // the internal LRU cache
+    LRUCache cache;
+
+    // protect the access to cache
+    mutable folly::SharedMutex mutex;
+  };
+
+  Shard& getShard(logid_t logid) const;
+
+  std::vector<std::unique_ptr<Shard>> shards_;
 };
 
 }} // namespace facebook::logdevice
@@ -371,6 +371,14 @@ bool EpochRecovery::onDigestComplete() {
   ld_check(!grace_period_->isActive());
   ld_check(state_ == State::DIGEST);
 
+  if (!tail_record_before_this_epoch_.isValid()) {
+    // The digest was built ahead of the recovery of previous epochs (see
+    // startDigest()). Mutations depend on the tail record of the previous
+    // epoch, wait for activate() to provide it.
+    digest_complete_deferred_ = true;
+    return false;
+  }
+
   // make one final effort for checking shards in DIGESTED are eligible for
   // mutation
   auto digested_shards =
@@ -1173,9 +1181,7 @@ void EpochRecovery::onNodeStateChanged(ShardID shard, RecoveryNode::State to) {
 }
 
 void EpochRecovery::activate(const TailRecord& prev_tail_record) {
-  ld_check(!active_);
-
-  active_ = true;
+  ld_check(!tail_record_before_this_epoch_.isValid());
 
   ld_check(prev_tail_record.isValid());
   ld_check(!prev_tail_record.containOffsetWithinEpoch());
@@ -1184,6 +1190,26 @@ void EpochRecovery::activate(const TailRecord& prev_tail_record) {
   last_timestamp_ =
       std::max(last_timestamp_, prev_tail_record.header.timestamp);
 
+  if (!active_) {
+    active_ = true;
+    activation_time_ = std::chrono::steady_clock::now();
+    onSealedOrActivated();
+    return;
+  }
+
+  // startDigest() was called earlier and the digest may already be complete.
+  // The set of digested nodes may have changed while we were waiting, so
+  // evaluate it again. The grace period, if any, has already been given.
+  if (digest_complete_deferred_) {
+    digest_complete_deferred_ = false;
+    onDigestMayHaveBecomeComplete(/*grace_period_expired=*/true);
+  }
+}
+
+void EpochRecovery::startDigest() {
+  ld_check(!active_);
+
+  active_ = true;
   activation_time_ = std::chrono::steady_clock::now();
 
   onSealedOrActivated();
@@ -1402,8 +1428,9 @@ void EpochRecovery::onDigestStreamEndReached(ShardID from) {
  */
 bool EpochRecovery::onDigestMayHaveBecomeComplete(bool grace_period_expired) {
   ld_check(active_);
-  if (digestComplete()) {
-    // onDigestComplete() was already called, nothing to do here.
+  if (digestComplete() || digest_complete_deferred_) {
+    // onDigestComplete() was already called, nothing to do here. If it was
+    // deferred, activate() will check again.
     return false;
   }
 
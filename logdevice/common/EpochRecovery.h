@@ -444,6 +444,14 @@ class EpochRecovery {
    */
   void activate(const TailRecord& prev_tail_record);
 
+  /**
+   * Set active_ to true before the tail record of the previous epoch is
+   * known, so that the digest of this epoch is built while earlier epochs
+   * are still being recovered. Once the digest is complete, mutations are
+   * held back until activate() supplies the previous tail record.
+   */
+  void startDigest();
+
   /**
    * @return true iff this RecoveryEpoch is done building the digest and
    *         is now in the mutation and cleaning phase
@@ -637,9 +645,14 @@ class EpochRecovery {
   // EpochRecovery machines do not transition any nodes into DIGESTING
   // even if enough nodes are in SEALED. The LogRecoveryRequest driver
   // sets the lowest-numbered epoch active. Once that EpochRecovery machine
-  // finishes, it activates the next epoch.
+  // finishes, it activates the next epoch. A few of the following epochs may
+  // also be made active early through startDigest().
   bool active_ = false;
 
+  // set if the digest was complete before activate() provided the tail record
+  // of the previous epoch. activate() then completes the digest.
+  bool digest_complete_deferred_ = false;
+
   // best estimate of last known good ESN for epoch_ so far
   esn_t lng_ = ESN_INVALID;
 
@@ -7,6 +7,9 @@
  */
 #include "logdevice/common/EpochSequencer.h"
 
+#include <algorithm>
+#include <limits>
+
 #include "logdevice/common/AbortAppendersEpochRequest.h"
 #include "logdevice/common/AllSequencers.h"
 #include "logdevice/common/Appender.h"
@@ -41,7 +44,8 @@ EpochSequencer::EpochSequencer(
       state_(State::ACTIVE),
       window_(epoch,
               immutable_options_.window_size,
-              immutable_options_.esn_max),
+              immutable_options_.esn_max,
+              immutable_options_.max_window_size),
       lng_(compose_lsn(epoch, ESN_INVALID)),
       last_reaped_(compose_lsn(epoch, ESN_INVALID)),
       write_streams_(immutable_options_.write_streams_map_max_capacity,
@@ -54,6 +58,7 @@ operator==(const EpochSequencerImmutableOptions& rhs) {
   auto tup = [](const EpochSequencerImmutableOptions& o) {
     return std::make_tuple(o.synced_copies,
                            o.window_size,
+                           o.max_window_size,
                            o.esn_max,
                            o.write_streams_map_max_capacity,
                            o.write_streams_map_clear_size);
@@ -65,9 +70,10 @@ operator!=(const EpochSequencerImmutableOptions& rhs) {
   return !(*this == rhs);
 }
 std::string EpochSequencerImmutableOptions::toString() const {
-  return folly::sformat("synced: {}, window: {}, esn_max: {}",
+  return folly::sformat("synced: {}, window: {}, max window: {}, esn_max: {}",
                         synced_copies,
                         window_size,
+                        max_window_size,
                         esn_max.val());
 }
 
@@ -76,6 +82,10 @@ EpochSequencerImmutableOptions::EpochSequencerImmutableOptions(
     const Settings& settings) {
   synced_copies = log_attrs.syncedCopies().value();
   window_size = log_attrs.maxWritesInFlight().value();
+  const int64_t growth =
+      std::max<int64_t>(1, settings.sequencer_window_max_growth);
+  max_window_size = std::min<int64_t>(
+      int64_t(window_size) * growth, std::numeric_limits<int>::max());
   const size_t ESN_T_BITS = 8 * sizeof(esn_t::raw_type);
   ld_check(settings.esn_bits > 0);
   ld_check(settings.esn_bits <= ESN_T_BITS);
@@ -95,7 +105,7 @@ lsn_t EpochSequencer::assignLsnForWriteStream(Appender* appender) {
   if (it == write_streams_.end()) {
     // We do not know about the write stream
     if (appender->canResumeWriteStream()) {
-      lsn = window_.grow(appender);
+      lsn = growWindow(appender);
       if (lsn != LSN_INVALID) {
         // LSN alloc succeeded, insert sequence number into the map.
         write_streams_.insert(stream_id, seq_num);
@@ -107,7 +117,7 @@ lsn_t EpochSequencer::assignLsnForWriteStream(Appender* appender) {
   } else {
     auto expected_seq_num = next_seq_num(it->second);
     if (appender->canResumeWriteStream() || (seq_num == expected_seq_num)) {
-      lsn = window_.grow(appender);
+      lsn = growWindow(appender);
       if (lsn != LSN_INVALID) {
         // LSN alloc succeeded, update sequence number. So, we either insert
         // the (n+1)th message or a completely random seq num that the client
@@ -126,6 +136,17 @@ lsn_t EpochSequencer::assignLsnForWriteStream(Appender* appender) {
   return lsn;
 }
 
+lsn_t EpochSequencer::growWindow(Appender* appender) {
+  lsn_t lsn = window_.grow(appender);
+  // If the window is full but allowed to expand, expand it rather than
+  // rejecting the append. Bounded: expand() fails once it reaches the max.
+  while (lsn == LSN_INVALID && err == E::NOBUFS && window_.expand()) {
+    WORKER_STAT_INCR(sequencer_window_expanded);
+    lsn = window_.grow(appender);
+  }
+  return lsn;
+}
+
 RunAppenderStatus EpochSequencer::runAppender(Appender* appender) {
   if (!appender || appender->started()) {
     ld_check(false);
@@ -141,7 +162,7 @@ RunAppenderStatus EpochSequencer::runAppender(Appender* appender) {
 
   lsn_t lsn = appender->isWriteStreamAppend()
       ? assignLsnForWriteStream(appender)
-      : window_.grow(appender);
+      : growWindow(appender);
 
   if (lsn == LSN_INVALID) {
     // 1. window full;
@@ -310,6 +331,16 @@ bool EpochSequencer::noteAppenderReaped(Appender::FullyReplicated replicated,
 
   // Step 1.5: if lng changed, update tail record for the epoch
   if (lng_changed_out) {
+    if (tail_record->hasPayload()) {
+      const size_t capacity = getSettings().sequencer_tail_buffer_size;
+      std::lock_guard<std::mutex> lock(recent_records_mutex_);
+      if (capacity > 0) {
+        recent_records_.push_back(tail_record);
+      }
+      while (recent_records_.size() > capacity) {
+        recent_records_.pop_front();
+      }
+    }
     // no need to do compare and swap here since this function is called
     // sequentially as Appenders are reaped
     tail_record_.store(std::move(tail_record));
@@ -624,6 +655,30 @@ void EpochSequencer::schedulePeriodicReleases() {
   parent_->schedulePeriodicReleases();
 }
 
+bool EpochSequencer::getRecentRecords(
+    lsn_t after,
+    std::vector<std::shared_ptr<TailRecord>>* out) const {
+  ld_check(out != nullptr);
+  // first LSN of this epoch that `out` must start with
+  const lsn_t first = std::max(after, compose_lsn(epoch_, ESN_INVALID)) + 1;
+
+  std::lock_guard<std::mutex> lock(recent_records_mutex_);
+  if (recent_records_.empty()) {
+    // nothing to return is only right if no record after `after` was released
+    // in the epoch
+    return getLastKnownGood() < first;
+  }
+  if (recent_records_.front()->header.lsn > first) {
+    return false;
+  }
+  for (const auto& record : recent_records_) {
+    if (record->header.lsn >= first) {
+      out->push_back(record);
+    }
+  }
+  return true;
+}
+
 const Settings& EpochSequencer::getSettings() const {
   return Worker::settings();
 }
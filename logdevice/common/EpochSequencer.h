@@ -8,9 +8,11 @@
 #pragma once
 
 #include <cstdint>
+#include <deque>
 #include <functional>
 #include <memory>
 #include <mutex>
+#include <vector>
 
 #include <folly/concurrency/AtomicSharedPtr.h>
 #include <folly/container/EvictingCacheMap.h>
@@ -48,6 +50,9 @@ class TailRecord;
 struct EpochSequencerImmutableOptions {
   copyset_size_t synced_copies = 0;
   int window_size = SLIDING_WINDOW_MIN_CAPACITY;
+  // The window may expand up to this size when it fills up. See
+  // Settings::sequencer_window_max_growth.
+  int max_window_size = SLIDING_WINDOW_MIN_CAPACITY;
   esn_t esn_max = ESN_MAX;
   size_t write_streams_map_max_capacity = 1000;
   size_t write_streams_map_clear_size = 100;
@@ -274,6 +279,17 @@ class EpochSequencer : public std::enable_shared_from_this<EpochSequencer> {
     return tail_record_.load();
   }
 
+  /**
+   * Appends to `out` the records of this epoch with LSNs greater than `after`
+   * that are in recent_records_, oldest first. Records are only kept if
+   * Settings::sequencer_tail_buffer_size is positive.
+   *
+   * @return false if some records of the epoch with LSNs greater than `after`
+   *         are not available, i.e. if they were already evicted.
+   */
+  bool getRecentRecords(lsn_t after,
+                        std::vector<std::shared_ptr<TailRecord>>* out) const;
+
   /**
    * @return LSN of the last reaped Appender in the sliding window. Returns
    *         lsn(epoch_, ESN_INVALID) if current epoch does not yet have any
@@ -411,6 +427,10 @@ class EpochSequencer : public std::enable_shared_from_this<EpochSequencer> {
   // last_accepted_seq_num in the internal map.
   lsn_t assignLsnForWriteStream(Appender* append);
 
+  // Inserts the appender into window_, expanding the window if it is full
+  // and hasn't reached immutable_options_.max_window_size yet.
+  lsn_t growWindow(Appender* appender);
+
   // notify parent sequencer that draining for this epoch is completed and
   // all records in the epoch are fully stored
   virtual void noteDrainingCompleted(Status drain_status);
@@ -501,6 +521,13 @@ class EpochSequencer : public std::enable_shared_from_this<EpochSequencer> {
   // the epoch
   folly::atomic_shared_ptr<TailRecord> tail_record_;
 
+  // Tail records with payloads of the last few records of the epoch, up to
+  // Settings::sequencer_tail_buffer_size of them, in LSN order. Since LNG
+  // only advances one ESN at a time, there are no gaps between them.
+  // Protected by recent_records_mutex_.
+  std::deque<std::shared_ptr<TailRecord>> recent_records_;
+  mutable std::mutex recent_records_mutex_;
+
   // An evicting cache hash map of write stream id to last accepted sequence
   // number in the corresponding write streams. It is not thread-safe.
   WriteStreamsMap write_streams_;
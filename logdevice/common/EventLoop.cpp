@@ -110,6 +110,15 @@ EventLoop::~EventLoop() {
   thread_.join();
 }
 
+folly::HHWheelTimer& EventLoop::getWheelTimer() {
+  ld_check(onThisThread() == this);
+  if (!wheel_timer_) {
+    wheel_timer_ = folly::HHWheelTimer::newTimer(
+        base_.get(), std::chrono::milliseconds(1));
+  }
+  return *wheel_timer_;
+}
+
 void EventLoop::startRunning() {
   ld_check(!started_running_);
   start_running_.post();
@@ -126,6 +135,13 @@ void EventLoop::addWithPriority(folly::Function<void()> func, int8_t priority) {
       priority_queues_enabled_ ? priority : folly::Executor::HI_PRI);
 }
 
+int EventLoop::addBatchWithPriority(std::vector<folly::Function<void()>> funcs,
+                                    int8_t priority) {
+  return task_queue_->addBatchWithPriority(
+      std::move(funcs),
+      priority_queues_enabled_ ? priority : folly::Executor::HI_PRI);
+}
+
 Status EventLoop::init(
     EvBase::EvBaseType base_type,
     size_t request_pump_capacity,
@@ -154,6 +170,8 @@ void EventLoop::run() {
   if (status != EvBase::Status::OK) {
     ld_error("EvBase::loop() exited abnormally");
   }
+  // Cancels all timeouts still scheduled on the wheel.
+  wheel_timer_.reset();
   // the thread on which this EventLoop ran terminates here
 }
 
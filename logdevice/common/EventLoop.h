@@ -14,8 +14,10 @@
 #include <semaphore.h>
 #include <thread>
 #include <unordered_map>
+#include <vector>
 
 #include <folly/Executor.h>
+#include <folly/io/async/HHWheelTimer.h>
 
 #include "logdevice/common/EventLoopTaskQueue.h"
 #include "logdevice/common/PThread.h"
@@ -92,6 +94,17 @@ class EventLoop : public folly::Executor {
    */
   void addWithPriority(folly::Function<void()>, int8_t priority) override;
 
+  /**
+   * Enqueues several functions with the same priority at once, waking up the
+   * event loop at most once for all of them. See
+   * EventLoopTaskQueue::addBatchWithPriority().
+   *
+   * @return 0 on success, -1 with err set to E::SHUTDOWN if the event loop
+   *         no longer accepts work.
+   */
+  int addBatchWithPriority(std::vector<folly::Function<void()>> funcs,
+                           int8_t priority);
+
   /**
    * Get the thread handle of this EventLoop.
    *
@@ -109,6 +122,14 @@ class EventLoop : public folly::Executor {
     return *task_queue_;
   }
 
+  /**
+   * Timing wheel with millisecond ticks running on this loop, created on
+   * first use. Scheduling and cancelling a timeout on it is O(1), which
+   * makes it cheaper than libevent timers for large numbers of timers that
+   * are mostly cancelled before firing. Must be called on this loop's thread.
+   */
+  folly::HHWheelTimer& getWheelTimer();
+
   /**
    * @return   a pointer to the EventLoop object running on this thread, or
    *           nullptr if this thread is not running a EventLoop.
@@ -158,6 +179,9 @@ class EventLoop : public folly::Executor {
   // Main task queue; (shutting down this TaskQueue stops the event loop)
   std::unique_ptr<EventLoopTaskQueue> task_queue_;
 
+  // See getWheelTimer(). Destroyed on this loop's thread when the loop exits.
+  folly::HHWheelTimer::UniquePtr wheel_timer_;
+
   // The thread will block on this semaphore before it starts processing
   // requests.
   Semaphore start_running_;
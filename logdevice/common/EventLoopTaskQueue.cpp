@@ -7,6 +7,8 @@
  */
 #include "logdevice/common/EventLoopTaskQueue.h"
 
+#include <algorithm>
+
 #include <folly/Function.h>
 
 #include "logdevice/common/ConstructorFailed.h"
@@ -87,12 +89,36 @@ int EventLoopTaskQueue::addWithPriority(Func func, int8_t priority) {
   ld_check(func);
   // During dequeue, semaphore is decremented by a value followed by dequeue of
   // equal number of elements. Hence, enqueue here is done in order
-  Task t(std::move(func), folly::RequestContext::saveContext());
+  Task t(std::move(func),
+         folly::RequestContext::saveContext(),
+         std::chrono::steady_clock::now());
   queues_[translatePriority(priority)].enqueue(std::move(t));
   sem_.post();
   return 0;
 }
 
+int EventLoopTaskQueue::addBatchWithPriority(std::vector<Func> funcs,
+                                             int8_t priority) {
+  if (UNLIKELY(sem_.isShutdown())) {
+    err = E::SHUTDOWN;
+    return -1;
+  }
+  if (funcs.empty()) {
+    return 0;
+  }
+  auto context = folly::RequestContext::saveContext();
+  const auto now = std::chrono::steady_clock::now();
+  auto& queue = queues_[translatePriority(priority)];
+  for (Func& func : funcs) {
+    ld_check(func);
+    queue.enqueue(Task(std::move(func), context, now));
+  }
+  // Same as in addWithPriority(), the tasks must be in the queue before the
+  // semaphore lets the consumer dequeue them.
+  sem_.post(static_cast<uint32_t>(funcs.size()));
+  return 0;
+}
+
 void EventLoopTaskQueue::haveTasksEventHandler() {
   ld_check(sem_waiter_);
   try {
@@ -124,12 +150,40 @@ void EventLoopTaskQueue::haveTasksEventHandler() {
 void EventLoopTaskQueue::executeTasks(uint32_t tokens) {
   std::array<uint32_t, kNumberOfPriorities> dequeues_to_execute{0};
   std::array<uint32_t, kNumberOfPriorities> tasks_available{0};
+  std::array<uint32_t, kNumberOfPriorities> shares = dequeues_per_iteration_;
+
+  // Lower priorities whose oldest task is older than aging_threshold_ go
+  // first, with the share of the highest priority.
+  std::array<bool, kNumberOfPriorities> aged{};
+  if (aging_threshold_.count() > 0) {
+    const auto now = std::chrono::steady_clock::now();
+    for (size_t i = 1; i < kNumberOfPriorities; ++i) {
+      const Task* oldest = queues_[i].try_peek();
+      if (oldest && now - oldest->enqueue_time > aging_threshold_) {
+        aged[i] = true;
+        shares[i] = std::max(shares[i], shares[0]);
+      }
+    }
+  }
+  std::array<size_t, kNumberOfPriorities> order;
+  size_t num_ordered = 0;
+  for (size_t i = 0; i < kNumberOfPriorities; ++i) {
+    if (aged[i]) {
+      order[num_ordered++] = i;
+    }
+  }
+  for (size_t i = 0; i < kNumberOfPriorities; ++i) {
+    if (!aged[i]) {
+      order[num_ordered++] = i;
+    }
+  }
 
   // Assign just the required slots first.
-  for (uint32_t i = 0; tokens > 0 && i < dequeues_to_execute.size(); ++i) {
+  for (size_t k = 0; tokens > 0 && k < order.size(); ++k) {
+    const size_t i = order[k];
     tasks_available[i] = queues_[i].size();
-    dequeues_to_execute[i] = std::min(
-        std::min(tasks_available[i], dequeues_per_iteration_[i]), tokens);
+    dequeues_to_execute[i] =
+        std::min(std::min(tasks_available[i], shares[i]), tokens);
     tokens -= dequeues_to_execute[i];
   }
 
@@ -7,6 +7,7 @@
  */
 #pragma once
 
+#include <atomic>
 #include <thread>
 
 #include <folly/ScopeGuard.h>
@@ -148,6 +149,18 @@ class FlowGroup {
   explicit FlowGroup(std::shared_ptr<FlowGroupDependencies> deps)
       : deps_(std::move(deps)) {}
 
+  // Only used while a ShapingContainer builds its FlowGroups, before any
+  // callbacks are queued and before the TrafficShaper can see them.
+  FlowGroup(FlowGroup&& other) noexcept
+      : deps_(std::move(other.deps_)),
+        priorityq_(std::move(other.priorityq_)),
+        meter_(other.meter_),
+        scope_(other.scope_),
+        configured_(other.configured_),
+        enabled_(other.enabled_.load()),
+        reordering_allowed_at_priority_(other.reordering_allowed_at_priority_),
+        assert_can_drain_(other.assert_can_drain_) {}
+
   bool configured() const {
     return configured_;
   }
@@ -179,7 +192,7 @@ class FlowGroup {
 
   /**
    * Debit priority's meter unconditionally, e.g. if we took out
-   * more credit than anticipated.
+   * more credit than anticipated. Doesn't need the ShapingContainer's lock.
    **/
   void debitMeter(Priority p, size_t debit_amount) {
     meter_.entries[asInt(p)].drain(
@@ -238,6 +251,11 @@ class FlowGroup {
    * If possible, consume cost bytes from the FlowMeter associated with
    * the priority.
    *
+   * May be called from the owning Worker without holding the
+   * ShapingContainer's lock. If it fails, the caller must take the lock and
+   * try again before pushing a callback with push(), so that it doesn't miss
+   * a concurrent deposit of credit by the TrafficShaper.
+   *
    * @return true if the FlowMeter had credit and the cost was decremented.
    */
   bool drain(const Envelope& e) {
@@ -400,7 +418,9 @@ class FlowGroup {
 
   // If true, the FlowMeters in this FlowGroup control the passage of
   // traffic. Otherwise, all packets are released immediately.
-  bool enabled_ = false;
+  // Atomic because the Worker reads it without holding the
+  // ShapingContainer's lock while the TrafficShaper updates it.
+  std::atomic<bool> enabled_{false};
 
   // Usually if priorityq_ is not empty we don't allow sending messages, only
   // pushing more callbacks to priorityq_. But there's one exception: if we're
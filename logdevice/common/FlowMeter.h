@@ -9,6 +9,7 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 
 #include <folly/ConstexprMath.h>
 
@@ -41,6 +42,15 @@ namespace facebook { namespace logdevice {
  *        connections. This would allow us to safely perform mid-message
  *        flow-control. Currently, that approach is considered to be too
  *        resource intensive.
+ *
+ *        Every Worker has its own FlowMeters, so only the owning Worker
+ *        debits them. The level of an Entry is atomic so that the Worker can
+ *        debit it without holding the ShapingContainer's lock while the
+ *        TrafficShaper deposits credit. drain(), unconditionalDrain(),
+ *        level(), canDrain() and debt() may run concurrently with any other
+ *        method. All other methods must be serialized by the caller. They
+ *        apply their changes to the level as a single atomic delta, so a
+ *        concurrent debit is never lost.
  */
 
 class FlowMeter {
@@ -49,8 +59,20 @@ class FlowMeter {
    public:
     static constexpr size_t UNRESTRICTED_BUDGET{INT64_MAX};
 
+    Entry() = default;
+    Entry(const Entry& other)
+        : level_(other.level()),
+          bucket_capacity_(other.bucket_capacity_),
+          returned_credits_(other.returned_credits_) {}
+    Entry& operator=(const Entry& other) {
+      level_.store(other.level());
+      bucket_capacity_ = other.bucket_capacity_;
+      returned_credits_ = other.returned_credits_;
+      return *this;
+    }
+
     int64_t level() const {
-      return level_;
+      return level_.load();
     }
 
     void setCapacity(int64_t capacity) {
@@ -79,24 +101,25 @@ class FlowMeter {
           amount, size_t(0), static_cast<size_t>(INT64_MAX)));
       size_t overflow = amount - clamped_amount;
 
+      const int64_t level = level_.load();
       int64_t max_level =
-          folly::constexpr_add_overflow_clamped(level_, clamped_amount);
+          folly::constexpr_add_overflow_clamped(level, clamped_amount);
       int64_t new_level = std::min(max_level, bucket_capacity_);
 
       if (max_level == INT64_MAX) {
         // Possible integer overflow detected. Retain this credit in the
         // overflow accounting used for bucket spills.
-        ld_check(level_ >= 0);
+        ld_check(level >= 0);
         overflow = folly::constexpr_add_overflow_clamped(
             overflow,
-            static_cast<size_t>(level_) - (max_level - clamped_amount));
+            static_cast<size_t>(level) - (max_level - clamped_amount));
       }
 
       // Catch the bucket spill
       overflow = folly::constexpr_add_overflow_clamped(
           overflow, static_cast<size_t>(max_level - new_level));
 
-      level_ = new_level;
+      level_.fetch_add(new_level - level);
       returned_credits_ =
           folly::constexpr_add_overflow_clamped(returned_credits_, overflow);
 
@@ -120,12 +143,13 @@ class FlowMeter {
       ld_check(bucket_capacity_ >= 0);
 
       // Enforce budget and burst limits.
+      const int64_t level = level_.load();
       ssize_t consumed_credit = std::min(credit, budget);
-      ssize_t new_level = level_ + consumed_credit;
+      ssize_t new_level = level + consumed_credit;
       new_level = std::min(new_level, bucket_capacity_);
-      consumed_credit = new_level - level_;
+      consumed_credit = new_level - level;
 
-      level_ = new_level;
+      level_.fetch_add(consumed_credit);
 
       // Calculate budget consumption and bandwidth bucket overflow.
       // NOTE: If the bucket capacity has been reduced from historic levels,
@@ -148,7 +172,7 @@ class FlowMeter {
      *               drain at negative level is not allowed)
      */
     bool drain(size_t amount, bool drain_on_negative_level = false) {
-      if (!drain_on_negative_level && (level_ <= 0)) {
+      if (!drain_on_negative_level && (level_.load() <= 0)) {
         return false;
       }
 
@@ -157,10 +181,10 @@ class FlowMeter {
     }
 
     int64_t unconditionalDrain(size_t amount) {
-      int64_t new_level = level_ - amount;
-      ld_check(new_level < level_);
-      level_ = new_level;
-      return level_;
+      int64_t old_level = level_.fetch_sub(amount);
+      int64_t new_level = old_level - amount;
+      ld_check(new_level < old_level);
+      return new_level;
     }
 
     /**
@@ -172,39 +196,40 @@ class FlowMeter {
                         size_t requested_amount,
                         size_t& bwSink_budget) {
       int64_t transfer_amount = std::min(requested_amount, bwSink_budget);
-      transfer_amount = std::min(transfer_amount, level_);
+      transfer_amount = std::min(transfer_amount, level());
       transfer_amount =
-          std::min(bwSink.bucket_capacity_ - bwSink.level_, transfer_amount);
+          std::min(bwSink.bucket_capacity_ - bwSink.level(), transfer_amount);
       if (transfer_amount < 0) {
         return false;
       }
 
-      level_ -= transfer_amount;
-      bwSink.level_ += transfer_amount;
+      level_.fetch_sub(transfer_amount);
+      bwSink.level_.fetch_add(transfer_amount);
       bwSink_budget -= transfer_amount;
       return static_cast<size_t>(transfer_amount) == requested_amount;
     }
 
     /** @return  true  iff a call to drain() on this Entry will succeed. */
     bool canDrain() const {
-      return level_ > 0;
+      return level() > 0;
     }
 
     /** @return  true  iff there is debt to cancel on this meter. */
     size_t debt() const {
-      return level_ >= 0 ? 0 : -level_;
+      int64_t level = this->level();
+      return level >= 0 ? 0 : -level;
     }
 
     /**
      * Discard all accumulated capacity.
      */
     void reset(int32_t level) {
-      level_ = level;
+      level_.store(level);
     }
 
    private:
     // Current bucket capacity.
-    int64_t level_ = 0;
+    std::atomic<int64_t> level_{0};
 
     // Bucket size as calculated from config
     int64_t bucket_capacity_{0};
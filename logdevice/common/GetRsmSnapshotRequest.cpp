@@ -8,7 +8,10 @@
 
 #include "logdevice/common/GetRsmSnapshotRequest.h"
 
+#include <algorithm>
+
 #include <folly/Memory.h>
+#include <folly/Random.h>
 
 #include "logdevice/common/AllSequencers.h"
 #include "logdevice/common/Checksum.h"
@@ -89,29 +92,50 @@ ClusterState* GetRsmSnapshotRequest::getClusterState() const {
 }
 
 void GetRsmSnapshotRequest::start() {
-  if (!candidates_.size()) {
-    auto limit_reached = retryLimitReached();
-    if (limit_reached) {
-      ld_info("Exhausted all possible nodes, id_:%lu", id_.val_);
+  const size_t fanout =
+      std::max<size_t>(1, getSettings().rsm_snapshot_request_fanout);
+  const auto& nodes_cfg = getNodesConfiguration();
+  bool sent = false;
+  while (outstanding_.size() < fanout) {
+    std::vector<node_index_t> idle;
+    for (node_index_t idx : candidates_) {
+      if (!outstanding_.count(idx)) {
+        idle.push_back(idx);
+      }
     }
-    if (limit_reached || !populateCandidates()) {
-      finalize(E::FAILED, "", LSN_INVALID);
-      return;
+    if (idle.empty()) {
+      if (!outstanding_.empty()) {
+        // Wait for the nodes we already asked.
+        break;
+      }
+      auto limit_reached = retryLimitReached();
+      if (limit_reached) {
+        ld_info("Exhausted all possible nodes, id_:%lu", id_.val_);
+      }
+      if (limit_reached || !populateCandidates()) {
+        finalize(E::FAILED, "", LSN_INVALID);
+        return;
+      }
+      retry_cnt_++;
+      continue;
     }
-    retry_cnt_++;
-  }
 
-  const auto& nodes_cfg = getNodesConfiguration();
-  auto random_it = std::next(
-      candidates_.begin(),
-      folly::Random::rand32(static_cast<uint32_t>(candidates_.size())));
-  NodeID dest = nodes_cfg->getNodeID(*random_it);
-  if (nodes_cfg->isNodeInServiceDiscoveryConfig(dest.index())) {
-    sendTo(dest);
-  } else {
-    ld_debug("Removing N%hu as it's no longer in config", dest.index());
-    candidates_.erase(*random_it);
-    start();
+    node_index_t idx =
+        idle[folly::Random::rand32(static_cast<uint32_t>(idle.size()))];
+    NodeID dest = nodes_cfg->getNodeID(idx);
+    if (!nodes_cfg->isNodeInServiceDiscoveryConfig(dest.index())) {
+      ld_debug("Removing N%hu as it's no longer in config", dest.index());
+      candidates_.erase(idx);
+      continue;
+    }
+    if (sendTo(dest) != 0) {
+      candidates_.erase(idx);
+      continue;
+    }
+    sent = true;
+  }
+  if (sent) {
+    activateWaveTimer();
   }
 }
 
@@ -125,16 +149,29 @@ void GetRsmSnapshotRequest::onError(Status st, NodeID dest) {
            dest.index(),
            id_.val_,
            key_.c_str());
-  cancelWaveTimer();
+  outstanding_.erase(dest.index());
+  if (outstanding_.empty()) {
+    cancelWaveTimer();
+  }
   candidates_.erase(dest.index());
   start();
 }
 
 void GetRsmSnapshotRequest::onWaveTimeout() {
-  onError(E::TIMEDOUT, last_dest_);
+  ld_debug("Wave timed out, removing %zu nodes, id_:%lu, key_:%s",
+           outstanding_.size(),
+           id_.val_,
+           key_.c_str());
+  // None of the nodes asked in this wave replied in time.
+  for (node_index_t idx : outstanding_) {
+    candidates_.erase(idx);
+  }
+  outstanding_.clear();
+  cancelWaveTimer();
+  start();
 }
 
-void GetRsmSnapshotRequest::sendTo(NodeID to, bool force) {
+int GetRsmSnapshotRequest::sendTo(NodeID to, bool force) {
   ld_debug("Sending GET_RSM_SNAPSHOT_Message to Node %s%s, id_:%lu, key:%s",
            Sender::describeConnection(to).c_str(),
            force ? " forcefully" : "",
@@ -144,7 +181,6 @@ void GetRsmSnapshotRequest::sendTo(NodeID to, bool force) {
   flags |= force ? GET_RSM_SNAPSHOT_Message::FORCE : 0;
   GET_RSM_SNAPSHOT_Header header = {min_ver_, id_, flags};
   auto msg = std::make_unique<GET_RSM_SNAPSHOT_Message>(header, key_);
-  activateWaveTimer();
   last_dest_ = to;
   int rv = sender_->sendMessage(std::move(msg), to);
   if (rv != 0) {
@@ -152,8 +188,10 @@ void GetRsmSnapshotRequest::sendTo(NodeID to, bool force) {
              Sender::describeConnection(to).c_str(),
              error_description(err),
              id_.val_);
-    onError(err, to);
+    return -1;
   }
+  outstanding_.insert(to.index());
+  return 0;
 }
 
 void GetRsmSnapshotRequest::onReply(const Address& from,
@@ -196,7 +234,12 @@ void GetRsmSnapshotRequest::onReply(const Address& from,
       ld_debug("Following REDIRECT from %s to %s",
                Sender::describeConnection(from).c_str(),
                Sender::describeConnection(dest).c_str());
-      sendTo(dest, true /*force*/);
+      outstanding_.erase(from.asNodeID().index());
+      if (sendTo(dest, true /*force*/) != 0) {
+        onError(err, dest);
+      } else {
+        activateWaveTimer();
+      }
     } break;
     default:
       ld_error("Received invalid status:%s from %s",
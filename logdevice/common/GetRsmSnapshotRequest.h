@@ -78,8 +78,11 @@ class GetRsmSnapshotRequest : public Request {
  protected:
   /**
    * Construct a GET_RSM_SNAPSHOT_Message and send it to given node.
+   *
+   * @return  0 on success, -1 if the message couldn't be sent, with err set
+   *          by Sender::sendMessage().
    */
-  void sendTo(NodeID to, bool force = false);
+  int sendTo(NodeID to, bool force = false);
 
   virtual bool init();
   virtual void initTimers();
@@ -109,6 +112,9 @@ class GetRsmSnapshotRequest : public Request {
   std::unique_ptr<SenderBase> sender_;
   // Holds the candidate server nodes to which this request can be sent
   std::unordered_set<node_index_t> candidates_;
+  // Nodes we sent the request to and haven't heard back from in the current
+  // wave. Up to rsm_snapshot_request_fanout of them at a time.
+  std::unordered_set<node_index_t> outstanding_;
 
  private:
   WorkerType worker_type_;
@@ -7,6 +7,9 @@
  */
 #pragma once
 
+#include <memory>
+#include <vector>
+
 #include <folly/Optional.h>
 
 #include "logdevice/common/NodeID.h"
@@ -36,5 +39,8 @@ struct GetSeqStateRequestResult {
   std::shared_ptr<const EpochMetaDataMap> metadata_map;
   std::shared_ptr<TailRecord> tail_record;
   folly::Optional<bool> is_log_empty;
+  // set if the sequencer had all the records asked for with
+  // Options::recent_records_after
+  folly::Optional<std::vector<std::shared_ptr<TailRecord>>> recent_records;
 };
 }} // namespace facebook::logdevice
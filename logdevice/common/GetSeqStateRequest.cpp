@@ -312,6 +312,11 @@ void GetSeqStateRequest::onReply(NodeID from,
     is_log_empty_ = msg.is_log_empty_;
   }
 
+  if (msg.header_.flags &
+      GET_SEQ_STATE_REPLY_Header::INCLUDES_RECENT_RECORDS) {
+    recent_records_ = msg.recent_records_;
+  }
+
   switch (status_) {
     case E::REDIRECTED:
     case E::PREEMPTED:
@@ -448,6 +453,9 @@ void GetSeqStateRequest::onSequencerKnown(NodeID dest,
   if (options_.skip_remote_preemption_check) {
     flags |= GET_SEQ_STATE_Message::SKIP_REMOTE_PREEMPTION_CHECK;
   }
+  if (options_.recent_records_after.has_value()) {
+    flags |= GET_SEQ_STATE_Message::INCLUDE_RECENT_RECORDS;
+  }
 
   // Keep track of the current destination node. In case of a timeout, we
   // might want to skip this one and let SequencerRouter pick a different
@@ -462,8 +470,13 @@ void GetSeqStateRequest::onSequencerKnown(NodeID dest,
            flags);
 
   auto* w = Worker::onThisThread();
-  auto msg = std::make_unique<GET_SEQ_STATE_Message>(
-      log_id_, id_, flags, ctx_, options_.min_epoch);
+  auto msg =
+      std::make_unique<GET_SEQ_STATE_Message>(log_id_,
+                                              id_,
+                                              flags,
+                                              ctx_,
+                                              options_.min_epoch,
+                                              options_.recent_records_after);
   /*
    * It is possible that we are attempting to send while the
    * bandwidth callback was already registered on a previous attempt
@@ -667,7 +680,8 @@ void GetSeqStateRequest::executeCallbacks() {
                                     epoch_offsets_,
                                     metadata_map_,
                                     tail_record_,
-                                    is_log_empty_};
+                                    is_log_empty_,
+                                    recent_records_};
   for (auto& cb : callback_list_) {
     ld_debug("Executing callback #%lu for log:%lu, rqid:%lu, ctx:%s",
              ++num_cbs,
@@ -777,13 +791,14 @@ GetSeqStateRequestMap::getListOfGssEntriesForLog(logid_t log_id) {
 bool GetSeqStateRequest::matchOptions(
     const GetSeqStateRequest::Options& other_req_options) {
   // feeble attempt at detecting changes to Options
-  static_assert(sizeof(GetSeqStateRequest::Options) == 48,
+  static_assert(sizeof(GetSeqStateRequest::Options) == 64,
                 "please makes sure matchOptions() includes comparisons for all "
                 "relevant options");
 #define OPTION_EQ(o) (options_.o == other_req_options.o)
   return OPTION_EQ(wait_for_recovery) && OPTION_EQ(include_tail_attributes) &&
       OPTION_EQ(include_epoch_offset) &&
-      OPTION_EQ(include_historical_metadata) && OPTION_EQ(min_epoch);
+      OPTION_EQ(include_historical_metadata) && OPTION_EQ(min_epoch) &&
+      OPTION_EQ(recent_records_after);
 #undef OPTION_EQ
 }
 
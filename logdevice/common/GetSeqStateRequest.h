@@ -200,6 +200,10 @@ class GetSeqStateRequest : public Request, public SequencerRouter::Handler {
     // The minimum epoch the sequencer should be in. If it is running in an
     // epoch below the one specified, it should reactivate
     folly::Optional<epoch_t> min_epoch;
+
+    // If set, sequencer will include the released records with LSNs greater
+    // than this that it has in memory, see Sequencer::getRecentRecords().
+    folly::Optional<lsn_t> recent_records_after;
   };
 
   GetSeqStateRequest(logid_t log_id, Context ctx, Options opts = Options())
@@ -368,6 +372,8 @@ class GetSeqStateRequest : public Request, public SequencerRouter::Handler {
 
   folly::Optional<bool> is_log_empty_ = folly::none;
 
+  folly::Optional<std::vector<std::shared_ptr<TailRecord>>> recent_records_;
+
   std::vector<CompletionCallback> callback_list_;
 
   friend class GetSeqStateRequestTest;
@@ -4,6 +4,7 @@
 
 #include "logdevice/common/OutlierDetection.h"
 #include "logdevice/common/Worker.h"
+#include "logdevice/common/client_read_stream/AllClientReadStreams.h"
 #include "logdevice/common/configuration/ServerConfig.h"
 #include "logdevice/include/NodeLocationScope.h"
 
@@ -47,7 +48,11 @@ void GraylistingTracker::start() {
     return;
   }
   timer_.setCallback([this]() {
+    auto prev_graylist = graylist_;
     updateGraylist(SteadyTimestamp::now());
+    if (graylist_ != prev_graylist) {
+      Worker::onThisThread()->clientReadStreams().noteGraylistChanged();
+    }
     timer_.activate(Worker::settings().graylisting_refresh_interval);
   });
   timer_.activate(Worker::settings().graylisting_refresh_interval);
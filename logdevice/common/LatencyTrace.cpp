@@ -0,0 +1,110 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/LatencyTrace.h"
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <utility>
+
+#include <folly/Random.h>
+#include <folly/ThreadLocal.h>
+
+#include "logdevice/common/checks.h"
+
+namespace facebook { namespace logdevice {
+
+namespace {
+
+struct RingBuffer {
+  // Only contended when collect() runs.
+  std::mutex mutex;
+  std::vector<LatencyTrace::Record> records;
+  // Position of the next record to overwrite once `records` is full.
+  size_t next = 0;
+};
+
+struct RingBufferTag {};
+folly::ThreadLocal<RingBuffer, RingBufferTag> ring_buffers;
+
+std::atomic<uint64_t> next_trace_id{1};
+
+} // namespace
+
+std::unique_ptr<LatencyTrace> LatencyTrace::maybeStart(const char* kind,
+                                                       double sample_rate) {
+  if (sample_rate <= 0 ||
+      (sample_rate < 1 && folly::Random::randDouble01() >= sample_rate)) {
+    return nullptr;
+  }
+  return std::make_unique<LatencyTrace>(kind);
+}
+
+LatencyTrace::LatencyTrace(const char* kind)
+    : last_mark_(std::chrono::steady_clock::now()) {
+  record_.kind = kind;
+  record_.id = next_trace_id.fetch_add(1, std::memory_order_relaxed);
+  record_.start_time = std::chrono::system_clock::now();
+  record_.num_stages = 0;
+}
+
+void LatencyTrace::mark(const char* name) {
+  auto now = std::chrono::steady_clock::now();
+  auto duration =
+      std::chrono::duration_cast<std::chrono::microseconds>(now - last_mark_);
+  last_mark_ = now;
+
+  if (record_.num_stages < kMaxStages) {
+    record_.stages[record_.num_stages++] = Stage{name, duration};
+  } else {
+    record_.stages[kMaxStages - 1].duration += duration;
+  }
+}
+
+void LatencyTrace::finish() {
+  RingBuffer& buf = *ring_buffers;
+  std::lock_guard<std::mutex> lock(buf.mutex);
+  if (buf.records.size() < kRingBufferSize) {
+    buf.records.push_back(record_);
+  } else {
+    buf.records[buf.next] = record_;
+    buf.next = (buf.next + 1) % kRingBufferSize;
+  }
+}
+
+std::vector<LatencyTrace::Record> LatencyTrace::collect() {
+  std::vector<Record> res;
+  for (RingBuffer& buf : ring_buffers.accessAllThreads()) {
+    std::lock_guard<std::mutex> lock(buf.mutex);
+    ld_check_le(buf.next, buf.records.size());
+    res.insert(res.end(), buf.records.begin() + buf.next, buf.records.end());
+    res.insert(res.end(), buf.records.begin(), buf.records.begin() + buf.next);
+  }
+  return res;
+}
+
+std::string
+LatencyTrace::toFoldedStacks(const std::vector<Record>& records) {
+  // Sorted, to make the output stable.
+  std::map<std::pair<std::string, std::string>, int64_t> usec;
+  for (const Record& r : records) {
+    for (size_t i = 0; i < r.num_stages; ++i) {
+      usec[std::make_pair(r.kind, r.stages[i].name)] +=
+          r.stages[i].duration.count();
+    }
+  }
+
+  std::string res;
+  for (const auto& kv : usec) {
+    res += kv.first.first + ";" + kv.first.second + " " +
+        std::to_string(kv.second) + "\n";
+  }
+  return res;
+}
+
+}} // namespace facebook::logdevice
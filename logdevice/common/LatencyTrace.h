@@ -0,0 +1,100 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file  Sampled tracing of where individual operations (appends, storage
+ *        tasks) spend their time.
+ *
+ *        A sampled operation owns a LatencyTrace and calls mark() each time it
+ *        finishes a stage. When the operation is done, finish() records the
+ *        trace into a ring buffer of the calling thread, which is cheap
+ *        enough to keep sampling enabled all the time. LatencyTrace::collect()
+ *        gathers the recent traces of all threads, and toFoldedStacks() turns
+ *        them into the "folded stacks" input of flamegraph.pl.
+ *
+ *        Traces don't cross node boundaries: a sampled append and the storage
+ *        tasks writing its copies are traced independently.
+ */
+
+class LatencyTrace {
+ public:
+  static constexpr size_t kMaxStages = 8;
+  // Number of finished traces each thread keeps.
+  static constexpr size_t kRingBufferSize = 1024;
+
+  struct Stage {
+    const char* name;
+    std::chrono::microseconds duration;
+  };
+
+  // A finished trace.
+  struct Record {
+    // Kind of operation, e.g. "append" or the storage task type.
+    const char* kind;
+    uint64_t id;
+    std::chrono::system_clock::time_point start_time;
+    std::array<Stage, kMaxStages> stages;
+    size_t num_stages;
+  };
+
+  /**
+   * @param kind         must outlive the trace, usually a string literal
+   * @param sample_rate  probability of sampling the operation, in [0, 1]
+   *
+   * @return  a new trace if the operation was sampled, nullptr otherwise
+   */
+  static std::unique_ptr<LatencyTrace> maybeStart(const char* kind,
+                                                  double sample_rate);
+
+  explicit LatencyTrace(const char* kind);
+
+  /**
+   * Attributes the time since the previous mark() (or since the trace was
+   * started) to the stage `name`, which must be a string literal. Stages
+   * past kMaxStages are merged into the last one.
+   */
+  void mark(const char* name);
+
+  /**
+   * Records the trace in the ring buffer of the calling thread. Should be
+   * called once, when the operation is done.
+   */
+  void finish();
+
+  uint64_t getID() const {
+    return record_.id;
+  }
+
+  /**
+   * @return  recent finished traces of all threads, oldest first within each
+   *          thread.
+   */
+  static std::vector<Record> collect();
+
+  /**
+   * Sums up time spent in each stage of each kind of operation, one line per
+   * stage: "<kind>;<stage> <total usec>".
+   */
+  static std::string toFoldedStacks(const std::vector<Record>& records);
+
+ private:
+  Record record_;
+  std::chrono::steady_clock::time_point last_mark_;
+};
+
+}} // namespace facebook::logdevice
@@ -737,7 +737,21 @@ int parse(const Slice& log_store_blob,
   }
 }
 
-int checkWellFormed(Slice blob, Slice payload) {
+namespace {
+
+// Payload checksum of a record, to be verified by checkWellFormed().
+struct ChecksumToVerify {
+  // Payload without the checksum.
+  Slice payload;
+  // Checksum stored in the record. Empty if the record has no checksum.
+  Slice checksum;
+};
+
+// Everything checkWellFormed() does except computing the payload checksum.
+int checkWellFormedExceptChecksum(Slice blob,
+                                  Slice payload,
+                                  ChecksumToVerify& out) {
+  out = ChecksumToVerify();
   Payload parsed_payload_p;
   flags_t flags;
   uint32_t wave;
@@ -817,28 +831,80 @@ int checkWellFormed(Slice blob, Slice payload) {
       payload.data = (const char*)payload.data + checksum_size;
       payload.size -= checksum_size;
     }
-    char buf[8];
-    checksum_bytes(
-        Slice((const char*)payload.data, payload.size), checksum_size * 8, buf);
-    if (memcmp(buf, checksum_slice.data, checksum_size) != 0) {
-      uint64_t payload_checksum = 0;
-      uint64_t expected_checksum = 0;
-      memcpy(&payload_checksum, checksum_slice.data, checksum_size);
-      memcpy(&expected_checksum, buf, checksum_size);
-      RATELIMIT_ERROR(std::chrono::seconds(10),
-                      100,
-                      "checksum mismatch: Invalid record. Payload: %s, "
-                      "expected checksum: %lu, checksum in payload: %lu",
-                      hexdump_buf(payload, 500).c_str(),
-                      expected_checksum,
-                      payload_checksum);
-      err = E::CHECKSUM_MISMATCH;
-      return -1;
-    }
+    out.payload = Slice((const char*)payload.data, payload.size);
+    out.checksum = Slice(checksum_slice.data, checksum_size);
+  }
+  return 0;
+}
+
+// Compares the checksum stored in the record with `computed`, which has the
+// same size.
+int compareChecksum(const ChecksumToVerify& c, const char* computed) {
+  if (memcmp(computed, c.checksum.data, c.checksum.size) != 0) {
+    uint64_t payload_checksum = 0;
+    uint64_t expected_checksum = 0;
+    memcpy(&payload_checksum, c.checksum.data, c.checksum.size);
+    memcpy(&expected_checksum, computed, c.checksum.size);
+    RATELIMIT_ERROR(std::chrono::seconds(10),
+                    100,
+                    "checksum mismatch: Invalid record. Payload: %s, "
+                    "expected checksum: %lu, checksum in payload: %lu",
+                    hexdump_buf(c.payload, 500).c_str(),
+                    expected_checksum,
+                    payload_checksum);
+    err = E::CHECKSUM_MISMATCH;
+    return -1;
   }
   return 0;
 }
 
+} // namespace
+
+int checkWellFormed(Slice blob, Slice payload) {
+  ChecksumToVerify c;
+  int rv = checkWellFormedExceptChecksum(blob, payload, c);
+  if (rv != 0 || c.checksum.size == 0) {
+    return rv;
+  }
+  char buf[8];
+  checksum_bytes(c.payload, c.checksum.size * 8, buf);
+  return compareChecksum(c, buf);
+}
+
+void checkWellFormed(const std::vector<std::pair<Slice, Slice>>& records,
+                     std::vector<int>& results_out) {
+  results_out.resize(records.size());
+  std::vector<ChecksumToVerify> checksums(records.size());
+  // Payloads with 32-bit checksums, and their indices in `records`.
+  std::vector<Slice> payloads_32bit;
+  std::vector<size_t> indices_32bit;
+  for (size_t i = 0; i < records.size(); ++i) {
+    results_out[i] = checkWellFormedExceptChecksum(
+        records[i].first, records[i].second, checksums[i]);
+    if (results_out[i] == 0 && checksums[i].checksum.size == 4) {
+      payloads_32bit.push_back(checksums[i].payload);
+      indices_32bit.push_back(i);
+    }
+  }
+
+  std::vector<uint32_t> checksums_32bit(payloads_32bit.size());
+  checksum_32bit_batch(
+      payloads_32bit.data(), payloads_32bit.size(), checksums_32bit.data());
+  for (size_t j = 0; j < indices_32bit.size(); ++j) {
+    const size_t i = indices_32bit[j];
+    results_out[i] = compareChecksum(
+        checksums[i], reinterpret_cast<const char*>(&checksums_32bit[j]));
+  }
+
+  for (size_t i = 0; i < records.size(); ++i) {
+    if (results_out[i] == 0 && checksums[i].checksum.size == 8) {
+      uint64_t c64 = checksum_64bit(checksums[i].payload);
+      results_out[i] =
+          compareChecksum(checksums[i], reinterpret_cast<const char*>(&c64));
+    }
+  }
+}
+
 int parseTimestamp(const Slice& log_store_blob,
                    std::chrono::milliseconds* timestamp_out) {
   ld_check(timestamp_out != nullptr);
@@ -9,6 +9,8 @@
 
 #include <chrono>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include <folly/Range.h>
 
@@ -416,6 +418,15 @@ int getCopysetHash(const Slice& log_store_blob, size_t* hash_out);
  */
 int checkWellFormed(Slice blob, Slice payload = Slice());
 
+/**
+ * Same as calling checkWellFormed(records[i].first, records[i].second) for
+ * each record and putting the results in `results_out`, but faster for many
+ * small records: their 32-bit checksums are computed together with
+ * checksum_32bit_batch().
+ */
+void checkWellFormed(const std::vector<std::pair<Slice, Slice>>& records,
+                     std::vector<int>& results_out);
+
 /**
  * Helper method to forms Slice from optional_keys
  * @ param  optional_keys_string  a pointer to string that will hold serialized
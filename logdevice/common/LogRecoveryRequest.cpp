@@ -1022,8 +1022,46 @@ void LogRecoveryRequest::sealLog() {
 
   ld_check(epoch_recovery_machines_.size() > 0);
 
+  activateEpochRecoveries();
+}
+
+void LogRecoveryRequest::activateEpochRecoveries() {
+  ld_check(epoch_recovery_machines_.size() > 0);
   ld_check(tail_record_.has_value());
+
   epoch_recovery_machines_.begin()->activate(tail_record_.value());
+
+  // Let the following epochs seal and digest ahead of time. They will hold
+  // off mutations until they become the oldest epoch and get activated.
+  size_t n_active = 1;
+  const size_t max_active = Worker::settings().recovery_max_concurrent_epochs;
+  for (auto it = std::next(epoch_recovery_machines_.begin());
+       it != epoch_recovery_machines_.end() && n_active < max_active;
+       ++it, ++n_active) {
+    if (!it->isActive()) {
+      it->startDigest();
+    }
+  }
+}
+
+EpochRecovery* LogRecoveryRequest::getActiveEpochRecovery(epoch_t epoch) {
+  for (auto& erm : epoch_recovery_machines_) {
+    if (erm.epoch_ == epoch) {
+      return erm.isActive() ? &erm : nullptr;
+    }
+  }
+  return nullptr;
+}
+
+EpochRecovery*
+LogRecoveryRequest::getDigestingEpochRecovery(ShardID shard,
+                                              read_stream_id_t rsid) {
+  for (auto& erm : epoch_recovery_machines_) {
+    if (erm.isActive() && erm.digestingReadStream(shard, rsid)) {
+      return &erm;
+    }
+  }
+  return nullptr;
 }
 
 void LogRecoveryRequest::checkNodesForSeal() {
@@ -1461,6 +1499,9 @@ void LogRecoveryRequest::complete(Status status) {
     ld_info("Log recovery completed for log %lu, next_epoch:%u",
             log_id_.val_,
             next_epoch_.val_);
+    HISTOGRAM_ADD(Worker::stats(),
+                  log_recovery,
+                  usec_since(creation_timestamp_.timePoint()));
   } else {
     ld_info("Log recovery for log %lu failed with error code %s, next_epoch:%u",
             log_id_.val_,
@@ -1597,8 +1638,7 @@ void LogRecoveryRequest::onEpochRecovered(epoch_t epoch,
   epoch_recovery_machines_.pop_front();
 
   if (epoch_recovery_machines_.begin() != epoch_recovery_machines_.end()) {
-    ld_check(tail_record_.has_value());
-    epoch_recovery_machines_.begin()->activate(tail_record_.value());
+    activateEpochRecoveries();
   } else {
     // finished recoverying all epochs in [lce+1, next_epoch-1]
     allEpochsRecovered();
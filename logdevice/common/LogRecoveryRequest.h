@@ -199,6 +199,22 @@ class LogRecoveryRequest : public Request,
     return &*first;
   }
 
+  /**
+   * @return the active EpochRecovery machine for @param epoch. Besides the
+   *         oldest epoch, machines for later epochs may be active while they
+   *         build their digests ahead of time, see
+   *         recovery-max-concurrent-epochs. nullptr if there is none.
+   */
+  EpochRecovery* getActiveEpochRecovery(epoch_t epoch);
+
+  /**
+   * @return the active EpochRecovery machine that reads its digest from
+   *         @param shard using read stream @param rsid, nullptr if there is
+   *         none.
+   */
+  EpochRecovery* getDigestingEpochRecovery(ShardID shard,
+                                           read_stream_id_t rsid);
+
   /**
    * Returns the epoch number through which this recovery request will seal the
    * log.
@@ -396,6 +412,11 @@ class LogRecoveryRequest : public Request,
   // keep waiting for the metadata to appear in the metadata log.
   void allEpochsRecovered();
 
+  // Activates the oldest EpochRecovery machine with the tail record of the
+  // previous epoch and lets up to recovery-max-concurrent-epochs - 1 of the
+  // following ones build their digests.
+  void activateEpochRecoveries();
+
   // Sends SEAL messages to nodes in the cluster. Once some f-majority responds,
   // baton is handed off to EpochRecovery. A grace period is used to allow
   // additional nodes to also participate in recovery (as long as they reply
@@ -0,0 +1,155 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/MemoryArenas.h"
+
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <new>
+#include <string>
+
+#include "logdevice/common/config.h"
+#include "logdevice/common/debug.h"
+
+#ifdef LOGDEVICE_USING_JEMALLOC
+// As in StatsJemalloc.h, weak declarations instead of jemalloc.h let us check
+// at runtime whether the binary is actually linked with jemalloc.
+extern "C" int mallctl(const char*, void*, size_t*, void*, size_t)
+    __attribute__((__nothrow__, __weak__));
+extern "C" void* mallocx(size_t, int) __attribute__((__nothrow__, __weak__));
+extern "C" void dallocx(void*, int) __attribute__((__nothrow__, __weak__));
+#endif
+
+namespace facebook { namespace logdevice { namespace MemoryArenas {
+
+namespace {
+
+constexpr size_t kNumArenas = static_cast<size_t>(MemoryArena::MAX);
+
+// Same values as the MALLOCX_ARENA() and MALLOCX_TCACHE_NONE macros of
+// jemalloc.h. Thread caches are bypassed since they are not per arena; the
+// subsystems keep their own caches of hot objects in front of the arenas.
+constexpr int mallocxArena(unsigned idx) {
+  return static_cast<int>((idx + 1) << 20);
+}
+constexpr int kMallocxTcacheNone = 1 << 8;
+
+std::atomic<bool> arenas_enabled{false};
+std::array<unsigned, kNumArenas> arena_indices;
+
+} // namespace
+
+bool enable() {
+  ld_check(!arenas_enabled.load());
+#ifdef LOGDEVICE_USING_JEMALLOC
+  if (mallctl == nullptr || mallocx == nullptr || dallocx == nullptr) {
+    ld_error("Not creating dedicated memory arenas: not linked with jemalloc");
+    return false;
+  }
+  for (size_t i = 0; i < kNumArenas; ++i) {
+    unsigned idx;
+    size_t len = sizeof(idx);
+    int rv = mallctl("arenas.create", &idx, &len, nullptr, 0);
+    if (rv != 0) {
+      ld_error("Failed to create memory arena %s: %s",
+               name(static_cast<MemoryArena>(i)),
+               strerror(rv));
+      return false;
+    }
+    arena_indices[i] = idx;
+    ld_info("Created memory arena %s with index %u",
+            name(static_cast<MemoryArena>(i)),
+            idx);
+  }
+  arenas_enabled.store(true);
+  return true;
+#else
+  ld_error("Not creating dedicated memory arenas: built without jemalloc");
+  return false;
+#endif
+}
+
+bool enabled() {
+  return arenas_enabled.load(std::memory_order_relaxed);
+}
+
+void* allocate(MemoryArena arena, size_t size) {
+#ifdef LOGDEVICE_USING_JEMALLOC
+  if (enabled()) {
+    ld_check(arena < MemoryArena::MAX);
+    int flags = mallocxArena(arena_indices[static_cast<size_t>(arena)]) |
+        kMallocxTcacheNone;
+    void* p = mallocx(size > 0 ? size : 1, flags);
+    if (p == nullptr) {
+      throw std::bad_alloc();
+    }
+    return p;
+  }
+#endif
+  return ::operator new(size);
+}
+
+void deallocate(void* p) {
+#ifdef LOGDEVICE_USING_JEMALLOC
+  if (enabled()) {
+    // Also correct for blocks allocated before the arenas were created:
+    // operator new uses jemalloc too, and dallocx() finds the arena of the
+    // block by itself.
+    if (p != nullptr) {
+      dallocx(p, kMallocxTcacheNone);
+    }
+    return;
+  }
+#endif
+  ::operator delete(p);
+}
+
+uint64_t allocatedBytes(MemoryArena arena) {
+#ifdef LOGDEVICE_USING_JEMALLOC
+  if (!enabled()) {
+    return 0;
+  }
+  ld_check(arena < MemoryArena::MAX);
+
+  // Statistics are only updated by jemalloc when the epoch is advanced.
+  uint64_t epoch = 1;
+  size_t len = sizeof(epoch);
+  mallctl("epoch", &epoch, &len, &epoch, len);
+
+  const std::string prefix = "stats.arenas." +
+      std::to_string(arena_indices[static_cast<size_t>(arena)]) + ".";
+  uint64_t total = 0;
+  for (const char* what : {"small.allocated", "large.allocated"}) {
+    size_t allocated = 0;
+    len = sizeof(allocated);
+    if (mallctl((prefix + what).c_str(), &allocated, &len, nullptr, 0) == 0) {
+      total += allocated;
+    }
+  }
+  return total;
+#else
+  (void)arena;
+  return 0;
+#endif
+}
+
+const char* name(MemoryArena arena) {
+  switch (arena) {
+    case MemoryArena::APPENDERS:
+      return "appenders";
+    case MemoryArena::MESSAGES:
+      return "messages";
+    case MemoryArena::ROCKSDB_BLOCK_CACHE:
+      return "rocksdb_block_cache";
+    case MemoryArena::MAX:
+      break;
+  }
+  return "invalid";
+}
+
+}}} // namespace facebook::logdevice::MemoryArenas
@@ -0,0 +1,66 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file Dedicated jemalloc arenas for the subsystems that allocate the most
+ *       memory on a server. Keeping their allocations apart makes the memory
+ *       used by each of them measurable (see the memory_arena_* stats), and
+ *       keeps long-lived objects of one subsystem from pinning pages full of
+ *       short-lived ones of another.
+ *
+ *       Arenas are off by default and are created once on startup by
+ *       MemoryArenas::enable() (--dedicated-memory-arenas). Until then, or if
+ *       the process is not linked with jemalloc, allocate() and deallocate()
+ *       use the default allocator.
+ */
+
+enum class MemoryArena : uint8_t {
+  // Appender objects, see Appender::operator new()
+  APPENDERS = 0,
+  // pooled messages, see MessagePool
+  MESSAGES,
+  // blocks of the RocksDB block caches
+  ROCKSDB_BLOCK_CACHE,
+  MAX
+};
+
+namespace MemoryArenas {
+
+// Creates the arenas. Must be called before other threads start allocating
+// from them, and at most once.
+// @return  true on success, false if jemalloc is not available or creating
+//          an arena failed, in which case the default allocator keeps being
+//          used
+bool enable();
+
+// @return  true if enable() succeeded
+bool enabled();
+
+// Allocates `size` bytes from `arena`. Throws std::bad_alloc on failure.
+void* allocate(MemoryArena arena, size_t size);
+
+// Frees memory returned by allocate().
+void deallocate(void* p);
+
+// @return  number of bytes currently allocated from `arena`, 0 if the arenas
+//          are disabled. Refreshes jemalloc statistics, so this is meant to
+//          be called when stats are collected, not on a hot path.
+uint64_t allocatedBytes(MemoryArena arena);
+
+// Name of the arena, for logging.
+const char* name(MemoryArena arena);
+
+} // namespace MemoryArenas
+
+}} // namespace facebook::logdevice
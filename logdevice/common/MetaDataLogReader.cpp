@@ -66,9 +66,9 @@ void MetaDataLogReader::startReading() {
       compose_lsn(EPOCH_MIN, ESN_MIN), // first valid lsn possibly written
       LSN_MAX - 1,                     // greatest lsn possible
       Worker::settings().client_read_flow_control_threshold,
-      // Note: using std::map based buffer implementation since LSNs of
-      // a metadata log records are guaranteed to be sparse (one record per
-      // epoch)
+      // Note: using a sparse buffer implementation since LSNs of a metadata
+      // log records are guaranteed to be sparse (one record per epoch). With
+      // this capacity the factory picks the sorted vector based one.
       ClientReadStreamBufferType::ORDERED_MAP,
       // the capacity of the buffer is set to be 128 epochs, which means a
       // metadata storage node can send 128 metadata log records in the window
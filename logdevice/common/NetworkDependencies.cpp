@@ -273,6 +273,11 @@ NetworkDependencies::getResourceToken(size_t payload_size) {
   return processor_->getIncomingMessageToken(payload_size);
 }
 
+bool NetworkDependencies::shouldPauseClientReads() {
+  return worker_ &&
+      worker_->loadShedding() == Worker::LoadShedding::PAUSE_CLIENT_READS;
+}
+
 std::unique_ptr<Message>
 NetworkDependencies::createHelloMessage(NodeID destNodeID) {
   uint16_t max_protocol = getSettings().max_protocol;
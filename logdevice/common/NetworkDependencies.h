@@ -76,6 +76,9 @@ class NetworkDependencies {
   virtual void onStartedRunning(RunContext context);
   virtual void onStoppedRunning(RunContext prev_context);
   virtual ResourceBudget::Token getResourceToken(size_t payload_size);
+  // Whether the worker is too far behind to take more messages from clients,
+  // see Worker::loadShedding().
+  virtual bool shouldPauseClientReads();
   virtual std::unique_ptr<Message> createHelloMessage(NodeID destNodeID);
   virtual std::unique_ptr<Message>
   createShutdownMessage(uint32_t serverInstanceID);
@@ -8,6 +8,9 @@
 
 #include "logdevice/common/NodesConfigurationInit.h"
 
+#include <sys/stat.h>
+
+#include <folly/FileUtil.h>
 #include <folly/futures/Retrying.h>
 
 #include "logdevice/common/ConfigSourceLocationParser.h"
@@ -29,6 +32,9 @@ bool NodesConfigurationInit::init(
     std::shared_ptr<PluginRegistry> plugin_registry,
     const std::string& server_seed_str,
     std::shared_ptr<ServerConfig> current_server_config) {
+  if (loadFromCacheFile(nodes_configuration_config)) {
+    return true;
+  }
   ld_info("Trying to fetch the NodesConfiguration using the server seed: %s",
           server_seed_str.c_str());
   std::vector<std::string> host_list;
@@ -65,6 +71,9 @@ bool NodesConfigurationInit::init(
 
 bool NodesConfigurationInit::initWithoutProcessor(
     std::shared_ptr<UpdateableNodesConfiguration> nodes_configuration_config) {
+  if (loadFromCacheFile(nodes_configuration_config)) {
+    return true;
+  }
   return getConfigWithRetryingAndTimeout(
              std::move(nodes_configuration_config),
              /*processor=*/nullptr,
@@ -202,6 +211,52 @@ NodesConfigurationInit::parseNodesConfiguration(const std::string& config) {
   return configuration::nodes::NodesConfigurationCodec::deserialize(config);
 }
 
+bool NodesConfigurationInit::loadFromCacheFile(
+    const std::shared_ptr<UpdateableNodesConfiguration>&
+        nodes_configuration_config) const {
+  const std::string& path = settings_->nodes_configuration_init_cache_file;
+  if (settings_->server || path.empty()) {
+    return false;
+  }
+
+  struct stat st;
+  if (::stat(path.c_str(), &st) != 0) {
+    if (errno != ENOENT) {
+      ld_warning("Failed to stat nodes configuration cache file %s: %s",
+                 path.c_str(),
+                 strerror(errno));
+    }
+    return false;
+  }
+  auto age = std::chrono::system_clock::now() -
+      std::chrono::system_clock::from_time_t(st.st_mtime);
+  if (age > settings_->nodes_configuration_init_cache_max_age) {
+    ld_info("Nodes configuration cache file %s is %lds old, not using it",
+            path.c_str(),
+            std::chrono::duration_cast<std::chrono::seconds>(age).count());
+    return false;
+  }
+
+  std::string serialized;
+  if (!folly::readFile(path.c_str(), serialized)) {
+    ld_warning("Failed to read nodes configuration cache file %s: %s",
+               path.c_str(),
+               strerror(errno));
+    return false;
+  }
+  auto nc = parseNodesConfiguration(serialized);
+  if (nc == nullptr) {
+    ld_warning("Failed to parse nodes configuration cache file %s",
+               path.c_str());
+    return false;
+  }
+  ld_info("Using NodesConfiguration of version %lu from cache file %s",
+          nc->getVersion().val(),
+          path.c_str());
+  nodes_configuration_config->update(std::move(nc));
+  return true;
+}
+
 folly::Future<bool> NodesConfigurationInit::getConfigWithRetryingAndTimeout(
     std::shared_ptr<UpdateableNodesConfiguration> nodes_configuration_config,
     Processor* processor,
@@ -274,9 +329,12 @@ folly::SemiFuture<bool> NodesConfigurationInit::getConfigImpl(
     std::shared_ptr<UpdateableNodesConfiguration> nodes_configuration_config) {
   folly::Promise<bool> promise;
   auto future = promise.getSemiFuture();
+  std::string cache_file =
+      settings_->server ? "" : settings_->nodes_configuration_init_cache_file;
   auto config_cb = [nodes_configuration_config =
                         std::move(nodes_configuration_config),
-                    promise = std::move(promise)](
+                    promise = std::move(promise),
+                    cache_file = std::move(cache_file)](
                        Status status, std::string config) mutable {
     if (status == Status::OK) {
       auto nc = parseNodesConfiguration(config);
@@ -287,6 +345,15 @@ folly::SemiFuture<bool> NodesConfigurationInit::getConfigImpl(
       }
       ld_info(
           "Got a NodesConfiguration of version: %lu", nc->getVersion().val());
+      if (!cache_file.empty()) {
+        try {
+          folly::writeFileAtomic(cache_file, config);
+        } catch (const std::exception& ex) {
+          ld_warning("Failed to write nodes configuration cache file %s: %s",
+                     cache_file.c_str(),
+                     folly::exceptionStr(ex).toStdString().c_str());
+        }
+      }
       nodes_configuration_config->update(std::move(nc));
       promise.setValue(true);
     } else {
@@ -63,6 +63,9 @@ class NodesConfigurationInit {
    * 6. When the config is successfully parsed, we update the
    * UpdateableNodesConfiguration.
    *
+   * On clients, if nodes-configuration-init-cache-file holds a recent enough
+   * config, it is used instead and none of the above happens.
+   *
    * @return true on success, false otherwise.
    */
   bool
@@ -107,6 +110,13 @@ class NodesConfigurationInit {
   static std::shared_ptr<const configuration::nodes::NodesConfiguration>
   parseNodesConfiguration(const std::string& config);
 
+  // Updates nodes_configuration_config with the config saved in
+  // nodes-configuration-init-cache-file, if any. Only used on clients.
+  // @return      true if a valid and recent enough config was loaded
+  bool loadFromCacheFile(
+      const std::shared_ptr<UpdateableNodesConfiguration>&
+          nodes_configuration_config) const;
+
   // @param processor    if not nullptr, execute the config fetch workflow on
   //                     the given Processor context, otherwise, execute the
   //                     fetch on the current context
@@ -376,7 +376,8 @@ int decodeMetadata(PayloadKey key,
 
 size_t PayloadGroupCodec::decode(Slice binary,
                                  std::vector<PayloadGroup>& payload_groups_out,
-                                 bool allow_buffer_sharing) {
+                                 bool allow_buffer_sharing,
+                                 const std::unordered_set<PayloadKey>* keys) {
   thrift::CompressedPayloadGroups compressed_payload_groups;
   const size_t deserialized_size = ThriftCodec::deserialize<ThriftSerializer>(
       binary,
@@ -398,6 +399,28 @@ size_t PayloadGroupCodec::decode(Slice binary,
       return 0;
     }
 
+    // All descriptors must have same size. Preallocate decoded_groups when
+    // first group is decoded and verify equality for the remaining groups.
+    if (!batch_size) {
+      batch_size = metadata.descriptors_ref()->size();
+      decoded_groups.resize(*batch_size);
+    } else {
+      if (metadata.descriptors_ref()->size() != *batch_size) {
+        RATELIMIT_ERROR(std::chrono::seconds(1),
+                        1,
+                        "Descriptors sizes mismatch for key %d: %zu vs %zu",
+                        key,
+                        *batch_size,
+                        metadata.descriptors_ref()->size());
+        err = E::BADMSG;
+        return 0;
+      }
+    }
+    if (keys != nullptr && keys->count(key) == 0) {
+      // Metadata is still decoded above to know the number of groups.
+      continue;
+    }
+
     size_t payloads_uncompressed_size = 0;
     for (const auto& opt_descriptor : *metadata.descriptors_ref()) {
       if (auto descriptor = opt_descriptor.descriptor_ref()) {
@@ -419,24 +442,6 @@ size_t PayloadGroupCodec::decode(Slice binary,
       uncompressed_payloads->makeManaged();
     }
 
-    // All descriptors must have same size. Preallocate decoded_groups when
-    // first group is decoded and verify equality for the remaining groups.
-    if (!batch_size) {
-      batch_size = metadata.descriptors_ref()->size();
-      decoded_groups.resize(*batch_size);
-    } else {
-      if (metadata.descriptors_ref()->size() != *batch_size) {
-        RATELIMIT_ERROR(std::chrono::seconds(1),
-                        1,
-                        "Descriptors sizes mismatch for key %d: %zu vs %zu",
-                        key,
-                        *batch_size,
-                        metadata.descriptors_ref()->size());
-        err = E::BADMSG;
-        return 0;
-      }
-    }
-
     // Split uncompressed_payloads into pieces according to the
     // uncompressed_size specified in descriptors.
     size_t index = 0;
@@ -135,11 +135,15 @@ class PayloadGroupCodec {
    * Returns number of bytes consumed, or 0 in case of error.
    * Resulting PayloadGroup can optionally share data with input (for example in
    * case it's uncompressed).
+   * If keys is not null, only payloads with these keys are decoded. Payloads
+   * of each key are compressed separately, so payloads of other keys aren't
+   * even uncompressed; decoded groups just don't contain them.
    */
   FOLLY_NODISCARD
   static size_t decode(Slice binary,
                        std::vector<PayloadGroup>& payload_groups_out,
-                       bool allow_buffer_sharing);
+                       bool allow_buffer_sharing,
+                       const std::unordered_set<PayloadKey>* keys = nullptr);
 
   /**
    * Decodes compressed representation of payload groups batch.
@@ -8,6 +8,7 @@
 #include "logdevice/common/Processor.h"
 
 #include <algorithm>
+#include <map>
 #include <memory>
 #include <numeric>
 #include <vector>
@@ -35,6 +36,7 @@
 #include "logdevice/common/SecurityInformation.h"
 #include "logdevice/common/SequencerBatching.h"
 #include "logdevice/common/SequencerLocator.h"
+#include "logdevice/common/SequencerPlacementCache.h"
 #include "logdevice/common/TLSCredMonitor.h"
 #include "logdevice/common/Thread.h"
 #include "logdevice/common/TraceLogger.h"
@@ -53,6 +55,7 @@
 #include "logdevice/common/stats/Stats.h"
 #include "logdevice/common/thrift/ThriftRouter.h"
 #include "logdevice/common/types_internal.h"
+#include "logdevice/common/util.h"
 #include "logdevice/include/Err.h"
 
 namespace {
@@ -124,6 +127,7 @@ class ProcessorImpl {
 
   WheelTimer wheel_timer_;
   AppendProbeController append_probe_controller_;
+  SequencerPlacementCache sequencer_placement_cache_;
   WorkerLoadBalancing worker_load_balancing_;
   ClientIdxAllocator client_idx_allocator_;
   ResourceBudget incoming_message_budget_;
@@ -289,6 +293,17 @@ workers_t Processor::createWorkerPool(WorkerType type, size_t count) {
   workers_t workers;
   workers.reserve(count);
 
+  EvBase::EvBaseType base_type = EvBase::FOLLY_EVENTBASE;
+  if (local_settings->worker_io_uring_event_loop) {
+    if (EvBaseWithIoUring::isAvailable()) {
+      base_type = EvBase::IO_URING;
+    } else {
+      ld_warning("worker-io-uring-event-loop is set but io_uring is not "
+                 "available, %s workers will use the default event base",
+                 workerTypeStr(type));
+    }
+  }
+
   for (int i = 0; i < count; i++) {
     // increment the next worker idx
     std::unique_ptr<Worker> worker;
@@ -303,7 +318,7 @@ workers_t Processor::createWorkerPool(WorkerType type, size_t count) {
               local_settings->hi_requests_per_iteration,
               local_settings->mid_requests_per_iteration,
               local_settings->lo_requests_per_iteration),
-          EvBase::FOLLY_EVENTBASE,
+          base_type,
           /* start_running */ false));
       auto executor = folly::getKeepAliveToken(loops.back().get());
       worker.reset(createWorker(std::move(executor), worker_id_t(i), type));
@@ -466,6 +481,85 @@ int Processor::postImpl(std::unique_ptr<Request>& rq,
   return postToWorker(rq, w, worker_type, worker_id_t(target_thread), force);
 }
 
+int Processor::postRequestBatch(std::vector<std::unique_ptr<Request>>& rqs) {
+  if (isShuttingDown()) {
+    err = E::SHUTDOWN;
+    return -1;
+  }
+
+  // Indices into `rqs` by target worker, in order.
+  std::map<std::pair<WorkerType, int>, std::vector<size_t>> by_worker;
+  for (size_t i = 0; i < rqs.size(); ++i) {
+    if (!rqs[i]) {
+      err = E::INVALID_PARAM;
+      return -1;
+    }
+    const WorkerType worker_type = rqs[i]->getWorkerTypeAffinity();
+    const int target_thread = getTargetThreadForRequest(rqs[i]);
+    if (target_thread >= getWorkerCount(worker_type)) {
+      err = E::INVALID_PARAM;
+      return -1;
+    }
+    by_worker[std::make_pair(worker_type, target_thread)].push_back(i);
+  }
+
+  for (const auto& kv : by_worker) {
+    if (getWorker(worker_id_t(kv.first.second), kv.first.first)
+            .requestQueueFull()) {
+      for (size_t i : kv.second) {
+        Request::bumpStatsWhenPosted(stats_,
+                                     rqs[i]->type_,
+                                     kv.first.first,
+                                     worker_id_t(kv.first.second),
+                                     false);
+      }
+      err = E::NOBUFS;
+      return -1;
+    }
+  }
+
+  int rv = 0;
+  for (const auto& kv : by_worker) {
+    const WorkerType worker_type = kv.first.first;
+    const worker_id_t worker_idx(kv.first.second);
+    std::vector<std::unique_ptr<Request>> batch;
+    std::vector<RequestType> types;
+    for (size_t i : kv.second) {
+      types.push_back(rqs[i]->type_);
+      batch.push_back(std::move(rqs[i]));
+    }
+    const bool posted =
+        getWorker(worker_idx, worker_type).forcePostBatch(batch) == 0;
+    for (size_t j = 0; j < kv.second.size(); ++j) {
+      Request::bumpStatsWhenPosted(
+          stats_, types[j], worker_type, worker_idx, posted);
+      if (!posted) {
+        rqs[kv.second[j]] = std::move(batch[j]);
+      }
+    }
+    if (!posted) {
+      rv = -1;
+    }
+  }
+  return rv;
+}
+
+bool Processor::reserveReadWindowMemory(size_t bytes) {
+  const size_t budget = settings()->client_read_window_memory_budget;
+  if (budget == 0) {
+    read_window_memory_reserved_.fetch_add(bytes);
+    return true;
+  }
+  size_t reserved = read_window_memory_reserved_.load();
+  do {
+    if (reserved + bytes > budget) {
+      return false;
+    }
+  } while (!read_window_memory_reserved_.compare_exchange_weak(
+      reserved, reserved + bytes));
+  return true;
+}
+
 bool Processor::isDataMissingFromShard(uint32_t shard_idx) {
   return !shards_not_missing_data_[shard_idx];
 }
@@ -638,7 +732,13 @@ Worker* Processor::createWorker(WorkContext::KeepAlive executor,
       new Worker(std::move(executor), this, idx, config_, stats_, worker_type);
   // Finish the remaining initialization on the executor.
   worker->addWithPriority(
-      [worker] { worker->setupWorker(); }, folly::Executor::HI_PRI);
+      [worker, cpus = settings_->worker_cpus] {
+        if (!cpus.empty()) {
+          set_cpu_affinity_of_this_thread(cpus);
+        }
+        worker->setupWorker();
+      },
+      folly::Executor::HI_PRI);
   return worker;
 }
 
@@ -650,6 +750,10 @@ AppendProbeController& Processor::appendProbeController() const {
   return impl_->append_probe_controller_;
 }
 
+SequencerPlacementCache& Processor::sequencerPlacementCache() const {
+  return impl_->sequencer_placement_cache_;
+}
+
 AllSequencers& Processor::allSequencers() const {
   return *impl_->allSequencers_;
 }
@@ -58,6 +58,7 @@ class PrincipalParser;
 class ProcessorImpl;
 class Request;
 class SequencerBatching;
+class SequencerPlacementCache;
 class ReadStreamDebugInfoSamplingConfig;
 class SequencerLocator;
 class SSLSessionCache;
@@ -259,6 +260,22 @@ class Processor : public folly::enable_shared_from_this<Processor>,
    */
   Worker& getWorker(worker_id_t worker_id, WorkerType type);
 
+  /**
+   * Posts several requests at once. Each one goes to the worker postRequest()
+   * would pick, but each worker gets its requests in a single submission,
+   * waking it up at most once. Requests going to the same worker with the
+   * same priority run in the order they appear in `rqs`.
+   *
+   * The queue capacity check is done for all workers up front: either none
+   * of the requests is posted because of NOBUFS, or all of them are.
+   *
+   * @return 0 if all requests were posted. -1 on failure, with err set as
+   *         for postRequest(). Posted requests are moved out, leaving
+   *         nullptr in `rqs`. On failure none are posted, except in case of
+   *         SHUTDOWN racing with the call, when some may have been.
+   */
+  int postRequestBatch(std::vector<std::unique_ptr<Request>>& rqs);
+
   /**
    * Get all EventLoops owned by the Processor.
    * Used for tests.
@@ -442,6 +459,10 @@ class Processor : public folly::enable_shared_from_this<Processor>,
   // of probes to save bandwidth
   AppendProbeController& appendProbeController() const;
 
+  // Sequencer nodes that clients learned from redirects, shared by all
+  // workers. See SequencerPlacementCache.h.
+  SequencerPlacementCache& sequencerPlacementCache() const;
+
   // a map from log ids to Sequencer objects owned by this Processor that
   // manage append requests on those logs.
   AllSequencers& allSequencers() const;
@@ -515,6 +536,23 @@ class Processor : public folly::enable_shared_from_this<Processor>,
     return read_stream_id_t(next_read_stream_id_.fetch_add(1));
   }
 
+  /**
+   * Reserves `bytes` of the memory budget that read streams of this Processor
+   * share for growing their window, see --client-read-window-memory-budget.
+   *
+   * @return true if the budget had room, false otherwise. Nothing is reserved
+   *         in the latter case.
+   */
+  bool reserveReadWindowMemory(size_t bytes);
+
+  /**
+   * Returns memory reserved by reserveReadWindowMemory().
+   */
+  void releaseReadWindowMemory(size_t bytes) {
+    ld_check(read_window_memory_reserved_.load() >= bytes);
+    read_window_memory_reserved_.fetch_sub(bytes);
+  }
+
   buffered_writer_id_t issueBufferedWriterID() {
     return buffered_writer_id_t(next_buffered_writer_id_++);
   }
@@ -648,6 +686,9 @@ class Processor : public folly::enable_shared_from_this<Processor>,
   // Next ID for issueReadStreamID()
   std::atomic<read_stream_id_t::raw_type> next_read_stream_id_{1};
 
+  // Total reserved through reserveReadWindowMemory()
+  std::atomic<size_t> read_window_memory_reserved_{0};
+
   // Next ID for issueBufferedWriterID()
   std::atomic<buffered_writer_id_t::raw_type> next_buffered_writer_id_{1};
 
@@ -0,0 +1,70 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file Average time that work items waited in the queues of a Worker before
+ *       running, over the last WINDOW or so. Used by the Worker to decide
+ *       whether to shed client load, see Worker::loadShedding().
+ *
+ *       Samples are averaged per window of WINDOW. get() returns the average
+ *       of the last complete window, or of the current one if that is
+ *       higher, so that a growing backlog is noticed before the window ends.
+ *       A worker that ran nothing for a whole window is idle, so older
+ *       averages are forgotten.
+ *
+ *       Not thread-safe, only used on the worker thread.
+ */
+
+class QueueDelayTracker {
+ public:
+  using TimePoint = std::chrono::steady_clock::time_point;
+
+  static constexpr std::chrono::milliseconds WINDOW{100};
+
+  void add(std::chrono::microseconds delay, TimePoint now) {
+    if (now - window_start_ >= WINDOW) {
+      prev_avg_ = now - window_start_ < 2 * WINDOW
+          ? currentAverage()
+          : std::chrono::microseconds::zero();
+      window_start_ = now;
+      sum_ = std::chrono::microseconds::zero();
+      count_ = 0;
+    }
+    sum_ += delay;
+    ++count_;
+  }
+
+  std::chrono::microseconds get(TimePoint now) const {
+    if (now - window_start_ >= 2 * WINDOW) {
+      return std::chrono::microseconds::zero();
+    }
+    if (now - window_start_ >= WINDOW) {
+      return currentAverage();
+    }
+    return std::max(prev_avg_, currentAverage());
+  }
+
+ private:
+  std::chrono::microseconds currentAverage() const {
+    return count_ ? sum_ / count_ : std::chrono::microseconds::zero();
+  }
+
+  TimePoint window_start_{};
+  std::chrono::microseconds sum_{0};
+  int64_t count_{0};
+  std::chrono::microseconds prev_avg_{0};
+};
+
+}} // namespace facebook::logdevice
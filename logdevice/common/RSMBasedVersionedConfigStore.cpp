@@ -42,6 +42,8 @@ RSMBasedVersionedConfigStore::RSMBasedVersionedConfigStore(
     ready_.store(true);
   };
   subscription_handle_ = state_machine_->subscribe(std::move(cb));
+  state_machine_->setMaxDeltasPerRecord(
+      processor_->settings()->rsm_max_deltas_per_record);
 
   std::unique_ptr<Request> rq = std::make_unique<
       StartReplicatedStateMachineRequest<KeyValueStoreStateMachine>>(
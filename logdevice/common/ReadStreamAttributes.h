@@ -7,6 +7,13 @@
  */
 #pragma once
 
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <folly/Range.h>
+
 #include "logdevice/common/ServerRecordFilter.h"
 
 /**
@@ -21,6 +28,12 @@ namespace facebook { namespace logdevice {
  *                              record filtering. @see ServerRecordFilter.h
  *              filter_key1     param for constructing ServerRecordFilter
  *              filter_key2     param for constructing ServerRecordFilter
+ *
+ *              sampling        sampling and timestamp window, see
+ *                              ServerRecordSampling
+ *
+ * For IN_SET filters filter_key1 holds the encoded set of keys, build such
+ * attributes with inSet().
  */
 
 struct ReadStreamAttributes {
@@ -34,22 +47,72 @@ struct ReadStreamAttributes {
   ReadStreamAttributes(const ReadStreamAttributes& rhs)
       : filter_type(rhs.filter_type),
         filter_key1(rhs.filter_key1),
-        filter_key2(rhs.filter_key2) {}
+        filter_key2(rhs.filter_key2),
+        sampling(rhs.sampling) {}
 
   ReadStreamAttributes& operator=(const ReadStreamAttributes& rhs) {
     filter_type = rhs.filter_type;
     filter_key1 = rhs.filter_key1;
     filter_key2 = rhs.filter_key2;
+    sampling = rhs.sampling;
     return *this;
   }
 
   bool operator==(const ReadStreamAttributes& other) const {
     return filter_type == other.filter_type &&
-        filter_key1 == other.filter_key1 && filter_key2 == other.filter_key2;
+        filter_key1 == other.filter_key1 && filter_key2 == other.filter_key2 &&
+        sampling == other.sampling;
+  }
+
+  /**
+   * @return attributes of a filter passing records whose key is one of
+   *         `keys`.
+   */
+  static ReadStreamAttributes inSet(const std::vector<std::string>& keys) {
+    return ReadStreamAttributes(
+        ServerRecordFilterType::IN_SET, encodeKeySet(keys), "");
+  }
+
+  /**
+   * Encodes `keys` as a sequence of 32-bit lengths each followed by the
+   * bytes of the key.
+   */
+  static std::string encodeKeySet(const std::vector<std::string>& keys) {
+    std::string out;
+    for (const std::string& key : keys) {
+      const uint32_t len = key.size();
+      out.append(reinterpret_cast<const char*>(&len), sizeof(len));
+      out.append(key);
+    }
+    return out;
+  }
+
+  /**
+   * Inverse of encodeKeySet().
+   *
+   * @return false if `encoded` is malformed
+   */
+  static bool decodeKeySet(folly::StringPiece encoded,
+                           std::vector<folly::StringPiece>* keys_out) {
+    while (!encoded.empty()) {
+      uint32_t len;
+      if (encoded.size() < sizeof(len)) {
+        return false;
+      }
+      memcpy(&len, encoded.data(), sizeof(len));
+      encoded.advance(sizeof(len));
+      if (encoded.size() < len) {
+        return false;
+      }
+      keys_out->push_back(encoded.subpiece(0, len));
+      encoded.advance(len);
+    }
+    return true;
   }
 
   ServerRecordFilterType filter_type;
   std::string filter_key1;
   std::string filter_key2;
+  ServerRecordSampling sampling;
 };
 }} // namespace facebook::logdevice
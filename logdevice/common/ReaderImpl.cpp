@@ -56,6 +56,9 @@ class ReaderBridgeImpl : public ReaderBridge {
   std::atomic<int> callbacks_in_progress_{0};
 };
 
+// Maximum number of entries read() takes off a producer queue at a time
+static constexpr size_t READ_FETCH_BATCH = 256;
+
 static size_t calculate_queue_capacity(size_t max_logs,
                                        size_t client_read_buffer_size,
                                        double flow_control_threshold) {
@@ -111,9 +114,9 @@ ReaderImpl::ReaderImpl(size_t max_logs,
       epoch_metadata_cache_(epoch_metadata_cache),
       client_shared_(std::move(client_shared)),
       csid_(std::move(csid)),
-      queue_(calculate_queue_capacity(max_logs,
-                                      client_read_buffer_size,
-                                      flow_control_threshold)) {}
+      queue_capacity_(calculate_queue_capacity(max_logs,
+                                               client_read_buffer_size,
+                                               flow_control_threshold)) {}
 
 ReaderImpl::~ReaderImpl() {
   // The destructor needs to ensure that all reading is stopped, otherwise
@@ -533,7 +536,7 @@ int ReaderImpl::read_popQueue(QueueEntry& entry_out) {
     return 0;
   }
 
-  while (!queue_.read(entry_out)) {
+  while (fetched_.empty() && !read_fetch()) {
     if (!may_wait_) {
       return -1;
     }
@@ -541,16 +544,52 @@ int ReaderImpl::read_popQueue(QueueEntry& entry_out) {
     // read_wait() may have set may_wait_ to false in which case the loop
     // will terminate next time around
   }
-  // Decrement record_count_ as a result of removing an entry from queue_. Note
-  // that record_count_ may temporarily become negative if this executes before
-  // ReaderBridgeImpl::onEntry() updates the counter.
-  record_count_ -= entry_out.getRecordCount();
-  if (entry_out.getType() == QueueEntry::Type::GAP) {
-    --gap_count_;
-  }
+  entry_out = std::move(fetched_.front());
+  fetched_.pop_front();
   return 0;
 }
 
+bool ReaderImpl::read_fetch() {
+  ld_check(fetched_.empty());
+  if (num_producer_queues_.load() != consumer_queues_.size()) {
+    std::lock_guard<std::mutex> guard(producer_queues_mutex_);
+    consumer_queues_.clear();
+    for (const auto& q : producer_queues_) {
+      consumer_queues_.push_back(q.get());
+    }
+  }
+
+  int64_t nrecords = 0;
+  int64_t ngaps = 0;
+  const size_t nqueues = consumer_queues_.size();
+  for (size_t i = 0; i < nqueues; ++i) {
+    ProducerQueue* q = consumer_queues_[(next_consumer_queue_ + i) % nqueues];
+    QueueEntry entry;
+    for (size_t n = 0; n < READ_FETCH_BATCH && q->try_dequeue(entry); ++n) {
+      nrecords += entry.getRecordCount();
+      if (entry.getType() == QueueEntry::Type::GAP) {
+        ++ngaps;
+      }
+      fetched_.push_back(std::move(entry));
+    }
+  }
+  if (nqueues > 0) {
+    next_consumer_queue_ = (next_consumer_queue_ + 1) % nqueues;
+  }
+  if (fetched_.empty()) {
+    return false;
+  }
+
+  // Decrement the counters as a result of removing entries from the queues,
+  // once for the whole batch. Note that record_count_ may temporarily become
+  // negative if this executes before ReaderBridgeImpl::onEntry() updates the
+  // counter.
+  queue_size_ -= fetched_.size();
+  record_count_ -= nrecords;
+  gap_count_ -= ngaps;
+  return true;
+}
+
 void ReaderImpl::read_wait() {
   ld_check(may_wait_);
   ld_check(nrecords_ > nread_);
@@ -560,7 +599,7 @@ void ReaderImpl::read_wait() {
   // client's request.
   const int64_t watermark = wait_only_when_no_data_
       ? 1
-      : std::min(queue_.capacity(), nrecords_ - nread_);
+      : std::min(queue_capacity_, nrecords_ - nread_);
 
   auto wait_predicate = [=]() {
     return
@@ -576,18 +615,25 @@ void ReaderImpl::read_wait() {
         notify_count_.load() > 0;
   };
 
-  std::unique_lock<std::mutex> lock(cv_mutex_);
   wait_watermark_.store(watermark);
-  if (timeout_.count() == -1) {
-    cv_.wait(lock, wait_predicate);
-  } else {
-    bool timed_out = !cv_.wait_until(lock, until_, wait_predicate);
-    if (timed_out) {
-      // If the semaphore wait timed out, disallow further waiting.  We'll
-      // process whatever is on the queue then stop.
-      may_wait_ = false;
-      wait_watermark_.store(-1);
+  if (!wait_predicate()) {
+    if (timeout_.count() == -1) {
+      wake_sem_.wait();
+      return;
+    }
+    if (wake_sem_.try_wait_until(until_)) {
+      return;
     }
+    // If the semaphore wait timed out, disallow further waiting.  We'll
+    // process whatever is on the queues then stop.
+    may_wait_ = false;
+  }
+  // We are not waiting anymore.  If a producer reset the watermark first, it
+  // is about to post wake_sem_; consume that post so that it doesn't cut
+  // short the next wait.
+  int64_t expected = watermark;
+  if (!wait_watermark_.compare_exchange_strong(expected, -1)) {
+    wake_sem_.wait();
   }
 }
 
@@ -739,6 +785,17 @@ void ReaderImpl::notifyWorker(LogState& state) {
   }
 }
 
+ReaderImpl::ProducerQueue& ReaderImpl::getProducerQueue() {
+  ProducerQueue*& q = *my_producer_queue_;
+  if (!q) {
+    std::lock_guard<std::mutex> guard(producer_queues_mutex_);
+    producer_queues_.push_back(std::make_unique<ProducerQueue>());
+    q = producer_queues_.back().get();
+    num_producer_queues_.store(producer_queues_.size());
+  }
+  return *q;
+}
+
 ReaderBridge* ReaderImpl::TEST_getBridge() {
   // The test can't do this upcast itself because it doesn't have access to
   // ReaderBridgeImpl definition.
@@ -760,7 +817,8 @@ int ReaderBridgeImpl::onEntry(ReaderImpl::QueueEntry&& entry,
   }
   const int64_t nrecords = entry.getRecordCount();
   const bool is_gap = entry.getType() == ReaderImpl::QueueEntry::Type::GAP;
-  if (!owner_->queue_.write(std::move(entry))) {
+  if (owner_->queue_size_.fetch_add(1) >= owner_->queue_capacity_) {
+    --owner_->queue_size_;
     // Queue write failed.  We'll push back on ClientReadStream.  It will try
     // again later, by when the consumer will have hopefully made some space
     // in the queue.
@@ -772,6 +830,7 @@ int ReaderBridgeImpl::onEntry(ReaderImpl::QueueEntry&& entry,
     }
     return -1;
   }
+  owner_->getProducerQueue().enqueue(std::move(entry));
   owner_->record_count_ += nrecords;
   if (is_gap) {
     ++owner_->gap_count_;
@@ -828,9 +887,7 @@ void ReaderBridgeImpl::maybeWakeConsumer() {
     }
 
     if (atom.compare_exchange_strong(watermark, -1)) {
-      // Wait until consumer is inside the monitor (lock is free), then notify
-      std::unique_lock<std::mutex> lock(owner_->cv_mutex_);
-      owner_->cv_.notify_one();
+      owner_->wake_sem_.post();
       break;
     }
   }
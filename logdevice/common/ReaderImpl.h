@@ -7,21 +7,25 @@
  */
 #pragma once
 
+#include <atomic>
 #include <chrono>
-#include <condition_variable>
+#include <deque>
 #include <memory>
 #include <mutex>
 #include <unordered_map>
+#include <vector>
 
 #include <boost/multi_index/hashed_index.hpp>
 #include <boost/multi_index/mem_fun.hpp>
 #include <boost/multi_index/member.hpp>
 #include <boost/multi_index_container.hpp>
 #include <boost/noncopyable.hpp>
-#include <folly/MPMCQueue.h>
 #include <folly/Optional.h>
+#include <folly/ThreadLocal.h>
+#include <folly/concurrency/UnboundedQueue.h>
 
 #include "logdevice/common/DataRecordOwnsPayload.h"
+#include "logdevice/common/LifoEventSem.h"
 #include "logdevice/common/ReadStreamAttributes.h"
 #include "logdevice/common/Semaphore.h"
 #include "logdevice/common/client_read_stream/ClientReadStream.h"
@@ -193,7 +197,8 @@ class ReaderImpl : public Reader {
   ClientReadStreamBufferType buffer_type_{ClientReadStreamBufferType::CIRCULAR};
 
   /**
-   * This gets put on the MPMCQueue when ClientReadStream sends us something.
+   * This gets put on a producer queue when ClientReadStream sends us
+   * something.
    * Each entry wraps either a DataRecord or a GapRecord.
    */
   struct QueueEntry : boost::noncopyable {
@@ -286,10 +291,10 @@ class ReaderImpl : public Reader {
     }
 
    private:
-    // Order of members is optimized for space usage.  We use 23 bytes;
-    // folly::MPMCQueue adds another 32-bit int for a total 28 bytes per queue
-    // entry with padding.  Without __attribute__((__packed__)) the total would
-    // be 32 bytes due to padding and alignment.
+    // Order of members is optimized for space usage.  We use 23 bytes, the
+    // producer queues add a flag per entry.  Without
+    // __attribute__((__packed__)) the entry alone would be 32 bytes due to
+    // padding and alignment.
     read_stream_id_t rsid_;
     // We own either `data' or `gap' depending on `type_'.
     union {
@@ -318,10 +323,36 @@ class ReaderImpl : public Reader {
     }
   } __attribute__((__packed__));
 
-  // The main queue for ClientReadStream to send stuff through
-  folly::MPMCQueue<QueueEntry> queue_;
-  // Entries that we picked off queue_ but couldn't process immediately.
-  // These should be processed before queue_.  Can contain:
+  // ClientReadStream instances send stuff through one queue per producer
+  // thread, i.e. per worker, that read() merges.  A queue only has one
+  // producer and one consumer, so writes and reads are cheap and producers
+  // on different workers don't contend with each other.  Entries of a read
+  // stream all come from the worker that runs it, so they stay in order.
+  using ProducerQueue = folly::USPSCQueue<QueueEntry, false>;
+  // Maximum total number of entries in the producer queues, see
+  // calculate_queue_capacity()
+  const size_t queue_capacity_;
+  // Total number of entries in the producer queues.  Producer writes fail
+  // when it reaches queue_capacity_.
+  std::atomic<size_t> queue_size_{0};
+  // All producer queues, in creation order.  Producers append under
+  // producer_queues_mutex_ the first time they send something, queues are
+  // only destroyed with the ReaderImpl.
+  std::vector<std::unique_ptr<ProducerQueue>> producer_queues_;
+  std::mutex producer_queues_mutex_;
+  std::atomic<size_t> num_producer_queues_{0};
+  // Queue of the calling producer thread, nullptr until it sends something
+  folly::ThreadLocal<ProducerQueue*> my_producer_queue_;
+  // read()'s copy of producer_queues_, refreshed when a queue is added
+  std::vector<ProducerQueue*> consumer_queues_;
+  // Index in consumer_queues_ of the queue to drain first next time, so that
+  // no producer is starved
+  size_t next_consumer_queue_ = 0;
+  // Entries that read() took off the producer queues in bulk, to be
+  // processed in order before the producer queues.
+  std::deque<QueueEntry> fetched_;
+  // Entries that we picked off the queues but couldn't process immediately.
+  // These should be processed before fetched_.  Can contain:
   // - A gap that wasn't immediately delivered because we'd already delivered
   //   data records in the same read() call.
   // - Decoded BufferedWriter writes.
@@ -331,17 +362,19 @@ class ReaderImpl : public Reader {
   // producers (ClientReadStream instances running on worker threads) and the
   // consumer (read() running on an application thread).
   //
-  // The consumer picks things off the queue.  If it empties the queue but the
-  // client asked for a larger batch of records, it wants to wait for more
+  // The consumer picks things off the queues.  If it empties the queues but
+  // the client asked for a larger batch of records, it wants to wait for more
   // data to become available.  It sets wait_watermark_ to however many more
-  // records it needs, then waits on the condition variable.  On the
-  // production side, whenever something is put onto the queue, the producer
-  // checks if the consumer is waiting (watermark != -1) and if the queue size
-  // has reached the watermark.
+  // records it needs, then waits on wake_sem_.  On the production side,
+  // whenever something is put onto a queue, the producer checks if the
+  // consumer is waiting (watermark != -1) and if the number of queued records
+  // has reached the watermark.  The producer that resets the watermark to -1
+  // posts wake_sem_, so there is at most one wakeup per wait no matter how
+  // many records arrive.
   //
   // In this setup, producers usually just check the watermark then go about
-  // their business, while the consumer typically waits on the condition
-  // variable 0 or 1 times per read().
+  // their business, while the consumer typically waits on the semaphore 0 or
+  // 1 times per read().
   //
   // An additional wrinkle is a possible deadlock that can occur with large
   // batches.  Suppose an application requests 10000 records from one log and
@@ -356,16 +389,15 @@ class ReaderImpl : public Reader {
   // woken up.
   std::atomic<int64_t> wait_watermark_{-1};
   std::atomic<int64_t> notify_count_{0};
-  std::mutex cv_mutex_;
-  std::condition_variable cv_;
-  // Number of individual data records currently in queue_. May differ from
-  // queue_.sizeGuess() since for buffered writes (where we have a single
+  LifoEventSem wake_sem_;
+  // Number of individual data records currently in the producer queues. May
+  // differ from queue_size_ since for buffered writes (where we have a single
   // QueueEntry with multiple data records) we actually count the number of
   // records in the batch. This is compared to wait_watermark_ to decide if
   // the consumer needs to be woken up.
   std::atomic<int64_t> record_count_{0};
-  // Number of gaps currently in queue_.  Tracked separately from data records
-  // because we want every gap to wake blocking reads.
+  // Number of gaps currently in the producer queues.  Tracked separately from
+  // data records because we want every gap to wake blocking reads.
   std::atomic<int64_t> gap_count_{0};
 
   std::set<std::string> monitoring_tags_{};
@@ -384,7 +416,7 @@ class ReaderImpl : public Reader {
 
   // A multi-index container allowing hash lookups by log ID and read stream
   // ID.  Lookups by read stream ID are most common because data coming from
-  // workers (queue_ entries) is tagged with the read stream ID.
+  // workers (queue entries) is tagged with the read stream ID.
   struct LogIndex {};
   struct ReadStreamIDIndex {};
   boost::multi_index::multi_index_container<
@@ -427,10 +459,13 @@ class ReaderImpl : public Reader {
 
   // Initializes may_wait_ and until_.
   void read_initWaitParams();
-  // Attempts to pop some work off queue_, waiting if if necessary (and
+  // Attempts to pop some work off the queues, waiting if if necessary (and
   // allowed).  Returns 0 if we got something, -1 if we timed out without
   // getting anything.
   int read_popQueue(QueueEntry& entry_out);
+  // Moves the entries currently in the producer queues to fetched_, up to
+  // READ_FETCH_BATCH per queue.  Returns false if there were none.
+  bool read_fetch();
   // Waits for work to appear in the queue.
   void read_wait();
   // Handlers for data and gap records.
@@ -447,6 +482,9 @@ class ReaderImpl : public Reader {
   // generated instead.
   void read_decodeBuffered(QueueEntry& entry);
 
+  // Returns the queue of the calling producer thread, creating it if needed.
+  ProducerQueue& getProducerQueue();
+
   ReaderBridge* TEST_getBridge();
 
   friend class TestReader;
@@ -187,6 +187,11 @@ class ShardRebuildingInterface {
   virtual void noteConfigurationChanged() = 0;
   virtual void noteRebuildingSettingsChanged() = 0;
 
+  // Scales the limits on re-replication in flight by @param factor, in (0, 1].
+  // Used by RebuildingCoordinator to back off when foreground latencies on
+  // this node are high. Can be called before start().
+  virtual void setThroughputFactor(double factor) = 0;
+
   // Fills the current row of @param table with debug information about the
   // state of rebuilding for this shard. Used by admin commands.
   virtual void getDebugInfo(InfoRebuildingShardsTable& table) const = 0;
@@ -67,7 +67,7 @@ class RunContext {
     return !operator==(b);
   }
 
-  std::string describe() {
+  std::string describe() const {
     std::string res("[");
     switch (type_) {
       case NONE:
@@ -31,6 +31,14 @@ void SSLSessionCache::setCachedSSLSession(
     return;
   }
 
+  // Every successful connection of every worker reports its session here, and
+  // when sessions are resumed it's usually the one already cached. Check that
+  // under the shared lock so that a reconnect storm doesn't serialize all
+  // workers on the upgrade lock.
+  if (cached_server_session_.rlock()->session == session) {
+    return;
+  }
+
   auto cached_session_ulock = cached_server_session_.ulock();
   if (session == cached_session_ulock->session) {
     return;
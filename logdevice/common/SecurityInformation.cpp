@@ -23,7 +23,9 @@ bool Principal::isAllowedInConfig(const std::string& str) {
 
 folly::dynamic Principal::toFollyDynamic() const {
   return folly::dynamic::object("name", name)(
-      "max_read_traffic_class", trafficClasses()[max_read_traffic_class]);
+      "max_read_traffic_class", trafficClasses()[max_read_traffic_class])(
+      "read_share", read_share)("min_read_bytes_per_sec",
+                                min_read_bytes_per_sec);
 };
 
 std::string AuthenticationTypeTranslator::toString(AuthenticationType type) {
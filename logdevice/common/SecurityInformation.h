@@ -67,6 +67,18 @@ class Principal {
   // The RFC 2474 "Differentiated Services Field Code Point" value to use
   // for all packets sent on connections associated with this principal.
   uint8_t egress_dscp = 0;
+
+  // Relative share of storage read bandwidth that clients identified by this
+  // Principal get when storage nodes share reading between clients. See
+  // Settings::catchup_queue_drr_quantum_bytes and
+  // Settings::read_throttling_share_by_principal.
+  uint64_t read_share = 1;
+
+  // Storage read I/O, in bytes per second, that every storage node lets
+  // clients identified by this Principal issue even when read throttling
+  // would hold them back. It is still charged to the node's read budget.
+  // See Settings::read_throttling_share_by_principal. 0 means no guarantee.
+  uint64_t min_read_bytes_per_sec = 0;
 };
 
 /**
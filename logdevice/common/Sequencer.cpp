@@ -603,6 +603,8 @@ Sequencer::updateMetaDataMap(epoch_t epoch, const EpochMetaData& metadata) {
   ld_check(epoch == metadata.h.epoch);
 
   std::shared_ptr<const EpochMetaDataMap> existing_map = metadata_map_.get();
+  std::shared_ptr<const EpochMetaDataMap> retained_map =
+      std::move(retained_metadata_map_);
   std::shared_ptr<const EpochMetaDataMap> new_map;
   if (existing_map != nullptr) {
     auto last = existing_map->getLastEpochMetaData();
@@ -719,6 +721,33 @@ Sequencer::updateMetaDataMap(epoch_t epoch, const EpochMetaData& metadata) {
       metadata_map_.update(new_map);
       return std::make_pair(UpdateMetaDataMapResult::UPDATED, new_map);
     }
+
+    if (retained_map != nullptr && retained_map->getEffectiveUntil() < epoch) {
+      // The sequencer was active here before and is being reactivated, e.g.
+      // sequencers are failing back to this node. The historical metadata it
+      // had can be reused under the same conditions as an existing map above,
+      // which avoids reading the metadata log of every such log at once.
+      // Anything unexpected is not treated as an inconsistency since other
+      // sequencers may have run the log in between: just read the metadata
+      // log as we would have.
+      auto last = retained_map->getLastEpochMetaData();
+      ld_check(last != nullptr);
+      if (last->h.effective_since == metadata.h.effective_since &&
+          last->identicalInMetaDataLog(metadata)) {
+        new_map = retained_map->withNewEffectiveUntil(epoch);
+      } else if (last->h.effective_since < metadata.h.effective_since &&
+                 retained_map->getEffectiveUntil() ==
+                     epoch_t(metadata.h.effective_since.val_ - 1)) {
+        auto metadata_insert = metadata;
+        metadata_insert.h.epoch = metadata_insert.h.effective_since;
+        new_map = retained_map->withNewEntry(metadata_insert, epoch);
+      }
+      if (new_map != nullptr) {
+        STAT_INCR(stats_, sequencer_reused_historical_metadata);
+        metadata_map_.update(new_map);
+        return std::make_pair(UpdateMetaDataMapResult::UPDATED, new_map);
+      }
+    }
   }
 
   // for all other case, read the metadata log for historical metadata
@@ -1549,6 +1578,18 @@ int Sequencer::sendReleases(lsn_t lsn,
   // Header is the same for all messages we send below.
   const RELEASE_Header header{rid, release_type};
 
+  // Byte offsets at the start of `epoch`, if known, so that storage nodes
+  // don't need to look them up for readers. getEpochOffsetMap() describes the
+  // current epoch; checking the epoch after reading them makes sure they
+  // aren't those of a newer one.
+  OffsetMap epoch_offsets;
+  if (release_type == ReleaseType::GLOBAL) {
+    epoch_offsets = getEpochOffsetMap();
+    if (getCurrentEpoch() != epoch) {
+      epoch_offsets.clear();
+    }
+  }
+
   int rv = 0;
   for (const auto& shard : *all_shards) {
     // Skip shards that fail the predicate, if any.
@@ -1556,7 +1597,8 @@ int Sequencer::sendReleases(lsn_t lsn,
       auto h = header;
       h.shard = shard.shard();
       if (sender.sendMessage(
-              std::make_unique<RELEASE_Message>(h), shard.asNodeID()) != 0) {
+              std::make_unique<RELEASE_Message>(h, epoch_offsets),
+              shard.asNodeID()) != 0) {
         RATELIMIT_DEBUG(
             std::chrono::seconds(1),
             1,
@@ -1816,6 +1858,9 @@ void Sequencer::setUnavailable(UnavailabilityReason r) {
       return;
     }
     current_epoch_.store(EPOCH_INVALID.val_);
+    // keep the historical metadata around in case the sequencer gets
+    // reactivated here, see updateMetaDataMap()
+    retained_metadata_map_ = metadata_map_.get();
     clearMetaDataMapImpl();
     // evict all epochs
     if (drain) {
@@ -1957,22 +2002,81 @@ std::shared_ptr<const TailRecord> Sequencer::getTailRecord() const {
 
   // The tail is at the current epoch, but we need to compute the accumulative
   // byteoffset and replace the one in the per-epoch tail
-  auto ret_tail = std::make_shared<TailRecord>(*current_epoch_tail);
+  return accumulateTailOffsets(*current_epoch_tail, *previous_tail);
+}
+
+/* static */
+std::shared_ptr<TailRecord>
+Sequencer::accumulateTailOffsets(const TailRecord& in_epoch_tail,
+                                 const TailRecord& previous_tail) {
+  auto ret_tail = std::make_shared<TailRecord>(in_epoch_tail);
   ld_check(ret_tail->containOffsetWithinEpoch());
 
   ret_tail->header.flags &= ~TailRecordHeader::OFFSET_WITHIN_EPOCH;
   if (!ret_tail->offsets_map_.isValid() ||
-      !previous_tail->offsets_map_.isValid()) {
+      !previous_tail.offsets_map_.isValid()) {
     ret_tail->offsets_map_.clear();
   } else {
     ret_tail->offsets_map_ = OffsetMap::mergeOffsets(
-        previous_tail->offsets_map_, current_epoch_tail->offsets_map_);
+        previous_tail.offsets_map_, in_epoch_tail.offsets_map_);
   }
 
   ld_check(!ret_tail->containOffsetWithinEpoch());
   return ret_tail;
 }
 
+int Sequencer::getRecentRecords(
+    lsn_t after,
+    std::vector<std::shared_ptr<TailRecord>>* out) const {
+  ld_check(out != nullptr);
+  if (settings_->sequencer_tail_buffer_size == 0) {
+    err = E::NOTFOUND;
+    return -1;
+  }
+
+  // same as in getTailRecord(), prevents the sequencer from reactivating
+  // while we combine the state of two epochs
+  folly::SharedMutex::ReadHolder read_lock(state_mutex_);
+
+  if (getState() == State::PERMANENT_ERROR ||
+      getState() == State::UNAVAILABLE) {
+    err = E::AGAIN;
+    return -1;
+  }
+
+  auto current_epoch = getCurrentEpochSequencer();
+  if (current_epoch == nullptr || !isRecoveryComplete()) {
+    err = E::AGAIN;
+    return -1;
+  }
+
+  auto previous_tail = tail_record_previous_epoch_.get();
+  ld_check(previous_tail != nullptr);
+  if (lsn_to_epoch(after) < current_epoch->getEpoch() &&
+      after < previous_tail->header.lsn) {
+    // the reader is missing records of previous epochs, which are not
+    // buffered
+    err = E::NOTFOUND;
+    return -1;
+  }
+
+  std::vector<std::shared_ptr<TailRecord>> records;
+  if (!current_epoch->getRecentRecords(after, &records)) {
+    err = E::NOTFOUND;
+    return -1;
+  }
+
+  // records can be in the buffer a little before they are released
+  const lsn_t last_released = getLastReleased();
+  for (const auto& record : records) {
+    if (record->header.lsn > last_released) {
+      break;
+    }
+    out->push_back(accumulateTailOffsets(*record, *previous_tail));
+  }
+  return 0;
+}
+
 OffsetMap Sequencer::getEpochOffsetMap() const {
   if (!isRecoveryComplete()) {
     return OffsetMap();
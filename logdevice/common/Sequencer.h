@@ -13,6 +13,7 @@
 #include <memory>
 #include <mutex>
 #include <shared_mutex>
+#include <vector>
 
 #include <folly/SharedMutex.h>
 
@@ -693,6 +694,25 @@ class Sequencer {
    */
   std::shared_ptr<const TailRecord> getTailRecord() const;
 
+  /**
+   * Retrieve the released records of the log with LSNs greater than `after`,
+   * from the records of the current epoch that EpochSequencer keeps in memory
+   * (see Settings::sequencer_tail_buffer_size). Only records of tail optimized
+   * logs are kept. Like getTailRecord(), the records have accumulated offsets.
+   *
+   * @return    0 on success, with the records appended to `out` in LSN order.
+   *            `out` may be left empty if no record after `after` is released
+   *            yet. On failure -1 is returned and err is set to:
+   *              AGAIN     sequencer is not active or log recovery is not
+   *                        completed yet
+   *              NOTFOUND  some of the records are not in the buffer, e.g.
+   *                        because they were evicted, they belong to a
+   *                        previous epoch or the buffer is disabled. The
+   *                        caller should read them from storage nodes.
+   */
+  int getRecentRecords(lsn_t after,
+                       std::vector<std::shared_ptr<TailRecord>>* out) const;
+
   /**
    * @return    the accumulative, epoch-end OffsetMap of the previous epoch.
    *            it is invalid if the information is not available (e.g.,
@@ -822,6 +842,14 @@ class Sequencer {
     std::shared_ptr<EpochSequencer> draining;
   };
 
+  // Returns a copy of `in_epoch_tail`, a tail record of the current epoch,
+  // with the offsets within epoch replaced by offsets accumulated since the
+  // beginning of the log, using `previous_tail`, the tail of the previous
+  // epoch.
+  static std::shared_ptr<TailRecord>
+  accumulateTailOffsets(const TailRecord& in_epoch_tail,
+                        const TailRecord& previous_tail);
+
   // id of log managed by this sequencer
   logid_t log_id_;
 
@@ -862,6 +890,11 @@ class Sequencer {
   UpdateableSharedPtr<const NodeSetFinder::MetaDataExtrasMap>
       metadata_extras_map_;
 
+  // metadata_map_ as of the last time the sequencer became unavailable, used
+  // by updateMetaDataMap() to skip reading the metadata log if the sequencer
+  // is reactivated on this node. Protected by state_mutex_.
+  std::shared_ptr<const EpochMetaDataMap> retained_metadata_map_;
+
   // limits the number of sequencer reactivations
   RateLimiter reactivation_limiter_;
 
@@ -7,10 +7,12 @@
  */
 #include "logdevice/common/SequencerBatching.h"
 
+#include <algorithm>
 #include <chrono>
 
 #include <folly/container/F14Set.h>
 
+#include "logdevice/common/AllSequencers.h"
 #include "logdevice/common/AppendRequestBase.h"
 #include "logdevice/common/Appender.h"
 #include "logdevice/common/AppenderPrep.h"
@@ -21,10 +23,12 @@
 #include "logdevice/common/PayloadHolder.h"
 #include "logdevice/common/Processor.h"
 #include "logdevice/common/Sender.h"
+#include "logdevice/common/Sequencer.h"
 #include "logdevice/common/Worker.h"
 #include "logdevice/common/buffered_writer/BufferedWriteCodec.h"
 #include "logdevice/common/buffered_writer/BufferedWriterImpl.h"
 #include "logdevice/common/debug.h"
+#include "logdevice/common/request_util.h"
 #include "logdevice/common/settings/Settings.h"
 
 namespace facebook { namespace logdevice {
@@ -65,13 +69,18 @@ static BufferedWriter::LogOptions get_log_options(logid_t log_id) {
   return opts;
 }
 
+// Window over which adaptive batching measures the append rate of a log.
+static constexpr std::chrono::milliseconds kAdaptiveRateWindow = 1s;
+
 SequencerBatching::SequencerBatching(Processor* processor)
     : sender_(std::make_unique<SenderProxy>()),
       processor_(processor),
       worker_state_machines_(processor_->settings()->num_workers),
       buffered_writer_(new ProcessorProxy(processor_),
                        nullptr, // BufferedWriter::AppendCallback
-                       &get_log_options,
+                       [this](logid_t log_id) {
+                         return getLogOptions(log_id);
+                       },
                        -1,   // infinite memory limit
                        this, // BufferedWriterAppendSink
                        processor_->stats_) {
@@ -83,6 +92,84 @@ SequencerBatching::~SequencerBatching() {
   shutDown(); // no-op if already called
 }
 
+BufferedWriter::LogOptions SequencerBatching::getLogOptions(logid_t log_id) {
+  BufferedWriter::LogOptions opts = get_log_options(log_id);
+  if (Worker::settings().sequencer_batching_adaptive) {
+    adaptLogOptions(log_id, &opts);
+  }
+  return opts;
+}
+
+void SequencerBatching::recordAppendRate(logid_t log_id,
+                                         size_t count,
+                                         size_t bytes) {
+  auto it = append_rates_.find(log_id);
+  if (it == append_rates_.cend()) {
+    it = append_rates_.insert(log_id, std::make_unique<AppendRate>()).first;
+  }
+  const SteadyTimestamp now = SteadyTimestamp::now();
+  it->second->appends.addValue(count, kAdaptiveRateWindow, now);
+  it->second->bytes.addValue(bytes, kAdaptiveRateWindow, now);
+}
+
+void SequencerBatching::adaptLogOptions(logid_t log_id,
+                                        BufferedWriter::LogOptions* opts) {
+  const std::chrono::milliseconds max_delay = opts->time_trigger;
+  if (max_delay.count() <= 0) {
+    // Not waiting for anything already.
+    return;
+  }
+
+  int64_t appends = 0;
+  int64_t bytes = 0;
+  // Logs that only recently started getting appends are treated as if they
+  // had been idle for the rest of the window, so that their first appends
+  // don't look like a burst.
+  int64_t window_ms = kAdaptiveRateWindow.count();
+  auto it = append_rates_.find(log_id);
+  if (it != append_rates_.cend()) {
+    const SteadyTimestamp now = SteadyTimestamp::now();
+    auto rate = it->second->appends.getRate(kAdaptiveRateWindow, now);
+    appends = rate.first;
+    window_ms = std::max(window_ms, int64_t(rate.second.count()));
+    bytes = it->second->bytes.getRate(kAdaptiveRateWindow, now).first;
+  }
+  // Number of appends we expect to arrive during the configured time trigger.
+  const double expected = double(appends) * max_delay.count() / window_ms;
+  if (expected < 2) {
+    // Waiting is unlikely to batch this append with anything.
+    opts->time_trigger = std::chrono::milliseconds::zero();
+    STAT_INCR(processor_->stats_, seq_batching_adaptive_no_delay);
+    return;
+  }
+
+  // While the sequencer's window has room, appends aren't queueing behind
+  // each other and holding them back only adds latency. As the window fills
+  // up, batch more so that fewer Appenders take up slots.
+  double occupancy = 1;
+  std::shared_ptr<Sequencer> sequencer =
+      processor_->allSequencers().findSequencer(log_id);
+  if (sequencer) {
+    const size_t window_size = sequencer->getMaxWindowSize();
+    if (window_size > 0) {
+      occupancy = std::min(
+          1.0, double(sequencer->getNumAppendsInFlight()) / window_size);
+    }
+  }
+  // But wait at least long enough for another append to arrive.
+  const double fraction = std::min(1.0, std::max(occupancy, 2 / expected));
+  opts->time_trigger = std::chrono::milliseconds(
+      std::max<int64_t>(1, max_delay.count() * fraction));
+
+  // Flush once the batch holds as many bytes as the log typically gets
+  // during that time, so a burst doesn't wait for the deadline.
+  const ssize_t expected_bytes = std::max<ssize_t>(
+      1, bytes * opts->time_trigger.count() / window_ms);
+  if (opts->size_trigger < 0 || expected_bytes < opts->size_trigger) {
+    opts->size_trigger = expected_bytes;
+  }
+}
+
 void SequencerBatching::shutDown() {
   // Must not be on a worker or BufferedWriter::shutDown() will deadlock
   ld_check(!Worker::onThisThread(false));
@@ -332,6 +419,10 @@ bool SequencerBatching::buffer(logid_t log_id,
     return true;
   }
 
+  if (settings.sequencer_batching_adaptive) {
+    recordAppendRate(log_id, appends.size(), appender->getPayload()->size());
+  }
+
   // Using appendAtomic() to ensure that an incoming append that contained a
   // BufferedWriter batch (which we unpacked) does not get split across a
   // batch boundary by BufferedWriter, since such batches would get different
@@ -424,6 +515,53 @@ std::pair<Status, NodeID> SequencerBatching::appendBuffered(
     unique_contexts.insert(context.first);
   }
 
+  // All batches of a log are flushed on the same worker. For a hot log, have
+  // some of them run their Appender on one of the following workers instead.
+  // The LSN is still allocated by the EpochSequencer, and records are still
+  // released in LSN order by its sliding window; only the Appender work
+  // (copyset selection, STOREs, retries) moves.
+  size_t spread = Worker::settings().sequencer_batching_appender_spread;
+  if (spread > 1) {
+    const int nworkers = processor_->getWorkerCount(WorkerType::GENERAL);
+    spread = std::min<size_t>(spread, nworkers);
+    const size_t k = next_appender_worker_.fetch_add(1) % spread;
+    if (k != 0) {
+      const worker_id_t worker((target_worker.val_ + k) % nworkers);
+      // BufferedWriter expects the outcome on `target_worker'.
+      Processor* processor = processor_;
+      auto remote_callback = [processor, target_worker, ia_callback](
+                                 Status st,
+                                 lsn_t lsn,
+                                 NodeID redirect,
+                                 RecordTimestamp ts) {
+        run_on_worker_nonblocking(
+            processor,
+            target_worker,
+            WorkerType::GENERAL,
+            RequestType::SEQUENCER_BATCHING_APPEND_DONE,
+            [ia_callback, st, lsn, redirect, ts] {
+              ia_callback(st, lsn, redirect, ts);
+            },
+            /* with_retrying */ true);
+      };
+      std::unique_ptr<Request> rq =
+          std::make_unique<RunBufferedAppendRequest>(worker,
+                                                     logid,
+                                                     std::move(attrs),
+                                                     std::move(payload),
+                                                     std::move(remote_callback),
+                                                     flags,
+                                                     checksum_bits,
+                                                     client_timeout_ms,
+                                                     unique_contexts.size());
+      if (processor_->postRequest(rq) != 0) {
+        return std::make_pair(err, NodeID());
+      }
+      STAT_INCR(Worker::stats(), seq_batching_appends_offloaded);
+      return std::make_pair(E::OK, NodeID());
+    }
+  }
+
   auto reply = runBufferedAppend(logid,
                                  std::move(attrs),
                                  std::move(payload),
@@ -445,6 +583,67 @@ std::pair<Status, NodeID> SequencerBatching::appendBuffered(
   return std::make_pair(E::OK, NodeID());
 }
 
+// Runs the Appender of a batch on a worker other than the one BufferedWriter
+// flushed it on. See Settings::sequencer_batching_appender_spread.
+class SequencerBatching::RunBufferedAppendRequest : public Request {
+ public:
+  RunBufferedAppendRequest(worker_id_t worker,
+                           logid_t logid,
+                           AppendAttributes attrs,
+                           PayloadHolder&& payload,
+                           InternalAppendRequest::Callback callback,
+                           APPEND_flags_t flags,
+                           int checksum_bits,
+                           uint32_t timeout_ms,
+                           uint32_t append_message_count)
+      : Request(RequestType::SEQUENCER_BATCHING_RUN_APPEND),
+        worker_(worker),
+        logid_(logid),
+        attrs_(std::move(attrs)),
+        payload_(std::move(payload)),
+        callback_(std::move(callback)),
+        flags_(flags),
+        checksum_bits_(checksum_bits),
+        timeout_ms_(timeout_ms),
+        append_message_count_(append_message_count) {}
+
+  int getThreadAffinity(int) override {
+    return worker_.val_;
+  }
+
+  Execution execute() override {
+    SequencerBatching& batching =
+        Worker::onThisThread()->processor_->sequencerBatching();
+    auto reply = batching.runBufferedAppend(logid_,
+                                            std::move(attrs_),
+                                            std::move(payload_),
+                                            callback_,
+                                            flags_,
+                                            checksum_bits_,
+                                            timeout_ms_,
+                                            append_message_count_);
+    if (reply.has_value()) {
+      // Failed synchronously without invoking the callback.
+      callback_(reply->status,
+                LSN_INVALID,
+                reply->redirect,
+                reply->timestamp);
+    }
+    return Execution::COMPLETE;
+  }
+
+ private:
+  const worker_id_t worker_;
+  const logid_t logid_;
+  AppendAttributes attrs_;
+  PayloadHolder payload_;
+  InternalAppendRequest::Callback callback_;
+  const APPEND_flags_t flags_;
+  const int checksum_bits_;
+  const uint32_t timeout_ms_;
+  const uint32_t append_message_count_;
+};
+
 class SequencerBatching::DispatchResultsRequest : public Request {
  public:
   DispatchResultsRequest(int target_worker,
@@ -11,9 +11,11 @@
 
 #include <folly/IntrusiveList.h>
 #include <folly/Preprocessor.h>
+#include <folly/concurrency/ConcurrentHashMap.h>
 
 #include "logdevice/common/ClientID.h"
 #include "logdevice/common/InternalAppendRequest.h"
+#include "logdevice/common/RateEstimator.h"
 #include "logdevice/common/Sender.h"
 #include "logdevice/common/Timestamp.h"
 #include "logdevice/common/buffered_writer/BufferedWriterImpl.h"
@@ -217,6 +219,14 @@ class SequencerBatching : public BufferedWriterImpl::AppendCallbackInternal,
   // State machines grouped by owner worker.
   std::vector<StateMachineList> worker_state_machines_;
 
+  // Recent rate of appends buffered for each log. Only maintained when
+  // --sequencer-batching-adaptive is on. Entries are never removed.
+  struct AppendRate {
+    RateEstimator appends;
+    RateEstimator bytes;
+  };
+  folly::ConcurrentHashMap<logid_t, std::unique_ptr<AppendRate>> append_rates_;
+
   // Needs to be destroyed first to disarm callbacks before state machines are
   // destroyed
   BufferedWriterImpl buffered_writer_;
@@ -225,10 +235,28 @@ class SequencerBatching : public BufferedWriterImpl::AppendCallbackInternal,
   // sequencers.
   std::atomic<size_t> totalBufferedAppendSize_{0};
 
+  // Options for the next batch of a log. Called by BufferedWriter on the
+  // worker that buffers the log.
+  BufferedWriter::LogOptions getLogOptions(logid_t log_id);
+
+  // Records that `count` appends with `bytes` of payload were buffered for
+  // the log, for adaptive batching.
+  void recordAppendRate(logid_t log_id, size_t count, size_t bytes);
+
+  // Shortens the triggers in `opts` according to the recent append rate of
+  // the log and the occupancy of its sequencer's window. See
+  // --sequencer-batching-adaptive.
+  void adaptLogOptions(logid_t log_id, BufferedWriter::LogOptions* opts);
+
   bool shouldPassthru(const Appender& appender,
                       const logsconfig::LogGroupNode* group,
                       const Settings& settings) const;
 
+  // For spreading Appenders of batches over workers, see
+  // Settings::sequencer_batching_appender_spread.
+  class RunBufferedAppendRequest;
+  std::atomic<size_t> next_appender_worker_{0};
+
   // Common handling of BufferedWriter success and failure
   class DispatchResultsRequest;
   void onResult(logid_t,
@@ -0,0 +1,50 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/SequencerPlacementCache.h"
+
+#include "logdevice/common/checks.h"
+
+namespace facebook { namespace logdevice {
+
+folly::Optional<NodeID> SequencerPlacementCache::get(logid_t log_id) const {
+  folly::SharedMutex::ReadHolder guard(mutex_);
+  auto it = map_.find(log_id);
+  if (it == map_.end()) {
+    return folly::none;
+  }
+  return it->second;
+}
+
+void SequencerPlacementCache::update(logid_t log_id, NodeID node) {
+  ld_check(node.isNodeID());
+  {
+    folly::SharedMutex::ReadHolder guard(mutex_);
+    auto it = map_.find(log_id);
+    if (it != map_.end() && it->second == node) {
+      // Most updates confirm what we already know.
+      return;
+    }
+  }
+  folly::SharedMutex::WriteHolder guard(mutex_);
+  map_[log_id] = node;
+}
+
+void SequencerPlacementCache::invalidate(logid_t log_id, NodeID node) {
+  folly::SharedMutex::WriteHolder guard(mutex_);
+  auto it = map_.find(log_id);
+  if (it != map_.end() && it->second == node) {
+    map_.erase(it);
+  }
+}
+
+size_t SequencerPlacementCache::size() const {
+  folly::SharedMutex::ReadHolder guard(mutex_);
+  return map_.size();
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,65 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <unordered_map>
+
+#include <folly/Optional.h>
+#include <folly/SharedMutex.h>
+
+#include "logdevice/common/NodeID.h"
+#include "logdevice/include/types.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file
+ *
+ * Remembers, for each log, the node that a sequencer most recently redirected
+ * (or preempted) a request of this client to. SequencerLocator hashes log ids
+ * onto the sequencer nodes that the client believes are alive, so when a
+ * sequencer moves, e.g. after a failover, the client keeps sending to the old
+ * node until its cluster state catches up, and every worker pays a redirect
+ * for every log. With this cache, which all workers of the Processor share,
+ * SequencerRouter learns the new placement from the first redirect and later
+ * requests on any worker go straight to the right node.
+ *
+ * Entries are hints. SequencerRouter only uses one if ClusterState, which is
+ * kept up to date by GetClusterStateRequest on clients and pushed to all
+ * workers on change, still considers the node alive. Entries of nodes that
+ * could not be reached are dropped.
+ *
+ * This class is thread-safe.
+ */
+
+class SequencerPlacementCache {
+ public:
+  /**
+   * @return the node last seen running the sequencer of data log `log_id`, if
+   *         any.
+   */
+  folly::Optional<NodeID> get(logid_t log_id) const;
+
+  /**
+   * Notes that the sequencer of data log `log_id` runs on `node`.
+   */
+  void update(logid_t log_id, NodeID node);
+
+  /**
+   * Forgets the entry of `log_id` if it points to `node`.
+   */
+  void invalidate(logid_t log_id, NodeID node);
+
+  size_t size() const;
+
+ private:
+  std::unordered_map<logid_t, NodeID, logid_t::Hash> map_;
+  mutable folly::SharedMutex mutex_;
+};
+
+}} // namespace facebook::logdevice
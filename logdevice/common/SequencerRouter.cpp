@@ -10,6 +10,7 @@
 #include "logdevice/common/MetaDataLog.h"
 #include "logdevice/common/Processor.h"
 #include "logdevice/common/SequencerLocator.h"
+#include "logdevice/common/SequencerPlacementCache.h"
 #include "logdevice/common/Worker.h"
 #include "logdevice/common/configuration/Configuration.h"
 #include "logdevice/common/debug.h"
@@ -32,6 +33,15 @@ void SequencerRouter::start() {
     sendTo(force_sequencer_choice, REDIRECT_CYCLE);
     return;
   }
+  folly::Optional<NodeID> cached = getCachedSequencer();
+  if (cached.hasValue()) {
+    ld_debug("Sending to %s for log:%lu because a previous request was "
+             "redirected there",
+             cached->toString().c_str(),
+             log_id_.val_);
+    sendTo(*cached, flags_t(0));
+    return;
+  }
   // If this SequencerRouter object gets destroyed before the callback is
   // called, trying to access its variables will cause a crash. Using
   // WeakRefHolder to prevent that.
@@ -278,6 +288,12 @@ void SequencerRouter::onRedirected(NodeID from, NodeID to, Status status) {
     redirected_[to] = attempts_;
   }
 
+  // Let requests for this log on all workers go to `to' directly.
+  SequencerPlacementCache* cache = getPlacementCache();
+  if (cache) {
+    cache->update(MetaDataLog::dataLogID(log_id_), to);
+  }
+
   if (!getSettings().server) {
     // This block only applies to clients - on server-side, the Failure
     // detector is solely responsible for updating the cluster state.
@@ -320,6 +336,11 @@ void SequencerRouter::onDeadNode(NodeID node, Status status) {
                  handler_->getRequestTypeName().c_str(),
                  handler_);
 
+  SequencerPlacementCache* cache = getPlacementCache();
+  if (cache) {
+    cache->invalidate(MetaDataLog::dataLogID(log_id_), node);
+  }
+
   auto node_state = ClusterState::NodeState::FAILING_OVER;
   switch (status) {
     case E::DISABLED:
@@ -506,6 +527,41 @@ void SequencerRouter::sendTo(NodeID dest, flags_t flags) {
   handler_->onSequencerKnown(dest, flags);
 }
 
+folly::Optional<NodeID> SequencerRouter::getCachedSequencer() {
+  SequencerPlacementCache* cache = getPlacementCache();
+  if (!cache) {
+    return folly::none;
+  }
+  const logid_t datalog_id = MetaDataLog::dataLogID(log_id_);
+  folly::Optional<NodeID> node = cache->get(datalog_id);
+  if (!node.hasValue() || *node == last_unavailable_.first) {
+    return folly::none;
+  }
+
+  // Nodes blacklisted by this router have zero weight in sequencers_.
+  const ServerConfig::SequencersConfig& sequencers = sequencers_
+      ? *sequencers_
+      : getNodesConfiguration()->getSequencersConfig();
+  auto it = std::find(sequencers.nodes.begin(), sequencers.nodes.end(), *node);
+  if (it == sequencers.nodes.end()) {
+    // No longer a sequencer node, or a different generation.
+    cache->invalidate(datalog_id, *node);
+    return folly::none;
+  }
+  if (sequencers.weights[std::distance(sequencers.nodes.begin(), it)] <= 0) {
+    return folly::none;
+  }
+
+  ClusterState* cs = getClusterState();
+  if (cs &&
+      (!cs->isNodeAlive(node->index()) ||
+       cs->isNodeBoycotted(node->index()))) {
+    // Fall back to the locator, which avoids this node too.
+    return folly::none;
+  }
+  return node;
+}
+
 bool SequencerRouter::blacklist(NodeID node) {
   if (!sequencers_) {
     // make a copy of the sequencer list from the cluster config
@@ -558,6 +614,14 @@ ClusterState* SequencerRouter::getClusterState() const {
   return Worker::getClusterState();
 }
 
+SequencerPlacementCache* SequencerRouter::getPlacementCache() const {
+  const Settings& settings = getSettings();
+  if (settings.server || !settings.client_sequencer_placement_cache) {
+    return nullptr;
+  }
+  return &Worker::onThisThread()->processor_->sequencerPlacementCache();
+}
+
 void SequencerRouter::startClusterStateRefreshTimer() {
   if (getSettings().sequencer_router_internal_timeout <
           std::chrono::milliseconds::max() &&
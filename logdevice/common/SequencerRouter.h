@@ -10,6 +10,8 @@
 #include <memory>
 #include <unordered_map>
 
+#include <folly/Optional.h>
+
 #include "logdevice/common/ClusterState.h"
 #include "logdevice/common/Timer.h"
 #include "logdevice/common/WeakRefHolder.h"
@@ -35,11 +37,16 @@ namespace facebook { namespace logdevice {
  *        machine, as well as onRedirect() and onNodeUnavailable() to influence
  *        the decision on which node to pick next.
  *
+ *        On clients with --client-sequencer-placement-cache, nodes that
+ *        redirects point to are remembered in the Processor's
+ *        SequencerPlacementCache and tried before hashing.
+ *
  *        Each SequencerRouter object should only be used from a single Worker
  *        thread.
  */
 
 class SequencerLocator;
+class SequencerPlacementCache;
 struct Settings;
 
 class SequencerRouter {
@@ -139,6 +146,10 @@ class SequencerRouter {
   // Returns a pointer to the ClusterState object to check cluster/nodes health
   virtual ClusterState* getClusterState() const;
 
+  // Returns the cache of known sequencer placements, or nullptr if it's not
+  // to be used.
+  virtual SequencerPlacementCache* getPlacementCache() const;
+
   // Called when cluster_state_refresh_timer_ expires, and initiates an
   // asynchronous cluster state refresh
   virtual void onTimeout();
@@ -194,6 +205,10 @@ class SequencerRouter {
   // it, but we already failed to send to it.
   std::pair<NodeID, Status> last_unavailable_{NodeID(), E::UNKNOWN};
 
+  // Returns the node from the placement cache if there is one for the log
+  // and it's still a sequencer node that's alive and not blacklisted.
+  folly::Optional<NodeID> getCachedSequencer();
+
   // Calls handler_->sendTo() and updates flags_.
   void sendTo(NodeID dest, flags_t flags);
 
@@ -11,27 +11,35 @@
 #include <string>
 
 #include <folly/Range.h>
+#include <folly/hash/Hash.h>
+
+#include "logdevice/include/types.h"
 
 namespace facebook { namespace logdevice {
 
 /**
  * @file This class serves as an interface for server-side filter classes.
- *       There are two implementations right now. Experimental feature:
- *       Use with caution.
+ *       Experimental feature: Use with caution.
  */
 
 /**
- * Currently only two types.
  * 1) EQUALITY means exact match. It describes string equality filter based for
  *    now.
  * 2) RANGE means filter by upper and lower bounds. It describes string
  *    based range filter for now.
+ * 3) IN_SET means the key is one of a set of keys, i.e. an OR of EQUALITY
+ *    filters. @see ReadStreamAttributes::inSet()
+ * 4) PREFIX means the key starts with a given string.
+ *
+ * IN_SET and PREFIX need protocol SERVER_RECORD_FILTER_SETS_SUPPORT.
  */
 
 enum class ServerRecordFilterType : uint8_t {
   NOFILTER = 0,
   EQUALITY = 1,
   RANGE = 2,
+  IN_SET = 3,
+  PREFIX = 4,
   MAX
 };
 
@@ -41,4 +49,41 @@ class ServerRecordFilter {
   virtual std::string toString() const = 0;
   virtual ~ServerRecordFilter() {}
 };
+
+/**
+ * Sampling and timestamp window applied by storage nodes next to the key
+ * filter above. Unlike the key filter, it also applies to records without a
+ * FILTERABLE key. Records it drops are reported as FILTERED_OUT gaps.
+ *
+ * Needs protocol SERVER_RECORD_SAMPLING_SUPPORT.
+ */
+struct ServerRecordSampling {
+  // Pass one in `one_in` records. The decision is a hash of the LSN, so all
+  // storage nodes and all readers with the same value agree on it. 0 and 1
+  // pass all records.
+  uint32_t one_in = 0;
+  // Pass only records with timestamps in [min_timestamp, max_timestamp].
+  std::chrono::milliseconds min_timestamp = std::chrono::milliseconds::min();
+  std::chrono::milliseconds max_timestamp = std::chrono::milliseconds::max();
+
+  bool enabled() const {
+    return one_in > 1 || min_timestamp != std::chrono::milliseconds::min() ||
+        max_timestamp != std::chrono::milliseconds::max();
+  }
+
+  /**
+   * @return  whether the record at `lsn` with `timestamp` should be shipped
+   */
+  bool passes(lsn_t lsn, std::chrono::milliseconds timestamp) const {
+    if (timestamp < min_timestamp || timestamp > max_timestamp) {
+      return false;
+    }
+    return one_in <= 1 || folly::hash::twang_mix64(lsn) % one_in == 0;
+  }
+
+  bool operator==(const ServerRecordSampling& other) const {
+    return one_in == other.one_in && min_timestamp == other.min_timestamp &&
+        max_timestamp == other.max_timestamp;
+  }
+};
 }} // namespace facebook::logdevice
@@ -54,8 +54,9 @@ class ShapingContainer {
 
   ~ShapingContainer() {}
 
-  // Lock to prevent race between worker threads and TrafficShaper thread
-  // trying to debit/credit bandwidth into FlowGroups
+  // Lock to prevent race between worker threads registering for bandwidth
+  // and the TrafficShaper thread crediting bandwidth into FlowGroups. Not
+  // needed to debit bandwidth, see FlowGroup::drain().
   std::unique_lock<std::mutex> lock() {
     return std::unique_lock<std::mutex>(flow_meters_mutex_);
   }
@@ -157,8 +158,10 @@ class ShapingContainer {
 
   std::vector<FlowGroup> flow_groups_;
   // Provides mutual exclusion between application of flow group updates
-  // by the TrafficShaper thread and normal packet transmission on this
-  // Sender.
+  // by the TrafficShaper thread and deferral of messages on this Sender.
+  // Messages for which there is bandwidth credit are sent without taking
+  // it: FlowMeter levels are atomic, and the Worker only falls back to the
+  // lock when the lock-free debit fails.
   //
   // Note: Flow group updates only modify the FlowMeters within FlowGroups
   //       and perform thread safe tests to see if FlowGroups need to
@@ -21,10 +21,14 @@ namespace facebook { namespace logdevice {
 AuthoritativeStatus
 ShardAuthoritativeStatusMap::getShardStatus(node_index_t node,
                                             uint32_t shard) const {
-  if (!shards_.count(node) || !shards_.find(node)->second.count(shard)) {
-    return AuthoritativeStatus::FULLY_AUTHORITATIVE;
+  auto node_kv = shards_.find(node);
+  if (node_kv != shards_.end()) {
+    auto shard_kv = node_kv->second.find(shard);
+    if (shard_kv != node_kv->second.end()) {
+      return shard_kv->second.auth_status;
+    }
   }
-  return shards_.find(node)->second.find(shard)->second.auth_status;
+  return AuthoritativeStatus::FULLY_AUTHORITATIVE;
 }
 
 AuthoritativeStatus
@@ -133,9 +137,16 @@ Request::Execution UpdateShardAuthoritativeMapRequest::execute() {
     // The worker already has a more up to date version.
     return Execution::COMPLETE;
   }
+  // Most event log records (e.g. donor progress) bump the version without
+  // changing the status of any shard. Don't make subscribers, and in turn all
+  // read streams and the clients we forward the map to, recompute anything in
+  // that case.
+  const bool changed = !map.hasSameShardStatuses(map_);
   map = std::move(map_);
 
-  Worker::onThisThread()->shardStatusManager().notifySubscribers();
+  if (changed) {
+    Worker::onThisThread()->shardStatusManager().notifySubscribers();
+  }
 
   return Execution::COMPLETE;
 }
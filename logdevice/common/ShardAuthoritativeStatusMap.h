@@ -146,6 +146,14 @@ class ShardAuthoritativeStatusMap {
   bool operator==(const ShardAuthoritativeStatusMap& other) const;
   bool operator!=(const ShardAuthoritativeStatusMap& other) const;
 
+  /**
+   * @return True if this and other contain the same authoritative status for
+   * all shards, regardless of their versions.
+   */
+  bool hasSameShardStatuses(const ShardAuthoritativeStatusMap& other) const {
+    return shards_ == other.shards_;
+  }
+
   // Entry to serialize in a SHARD_STATUS_UPDATE_Message.
   struct SerializedEntry {
     node_index_t node;
@@ -38,8 +38,10 @@ namespace facebook { namespace logdevice {
  * such objects are present in the window.
  *
  * The window is implemented as a circular array A of N entries, where N is
- * max-in-flight for the log. Each entry is a 4-aligned pointer with bits 0
- * and 1 used as flags. Entry values and their meaning:
+ * the largest size the window may grow to (max-in-flight for the log, or
+ * more if the window is allowed to expand, see expand()). Each entry is a
+ * 4-aligned pointer with bits 0 and 1 used as flags. Entry values and their
+ * meaning:
  *
  *  0 : entry is free
  *  non-zero, bits 0 and 1 are off: entry is in use (U)
@@ -52,7 +54,9 @@ namespace facebook { namespace logdevice {
  * The array is initialized to {0, T, 0, 0, 0...}  (tail is at entry MIN_ESN)
  *
  * A separate shared atomic counter n is used to limit the total number of
- * outstanding objects to at most N.
+ * outstanding objects to at most C, the current capacity, C <= N. Since the
+ * slot of an ESN depends only on N, C can be raised at any time without
+ * moving entries around.
  *
  * Every object in the window is identified by a 32-bit ESN (epoch-relative
  * part of LSN) assigned to the record that it attempts to store. That ESN e
@@ -79,21 +83,27 @@ class SlidingWindowSingleEpoch {
    * @param capacity   Window size limit. Must be at least MIN_CAPACITY.
    * @param esn_max    largest ESN to issue in the epoch (typically ESN_MAX
    *                   but can be configured smaller)
+   * @param max_capacity  largest capacity expand() may raise the limit to.
+   *                      Memory for that many entries is allocated upfront.
+   *                      Values below @param capacity mean no expansion.
    *
    * @throws ConstructorFailed and sets err to INVALID_PARAM if @param capacity
    *         is smaller than MIN_CAPACITY.  Debug builds assert on failure.
    */
   explicit SlidingWindowSingleEpoch(epoch_t epoch,
                                     int capacity,
-                                    esn_t esn_max = ESN_MAX)
+                                    esn_t esn_max = ESN_MAX,
+                                    int max_capacity = 0)
       : epoch_(epoch),
         size_(0),
         esn_max_(std::min(esn_max.val_, ESN_MAX.val_ - 1)),
         // This is a bit tricky.  We need all slots in the window to map to
         // valid ESNs (at most `esn_max_')
-        capacity_(std::min<uint64_t>(capacity, esn_max_.val_)),
+        num_slots_(std::min<uint64_t>(std::max(capacity, max_capacity),
+                                      esn_max_.val_)),
+        capacity_(std::min<uint64_t>(capacity, num_slots_)),
         right_(compose_lsn(epoch_, ESN_MIN)) {
-    if (capacity_ < SlidingWindowSingleEpoch::MIN_CAPACITY ||
+    if (capacity_.load() < SlidingWindowSingleEpoch::MIN_CAPACITY ||
         esn_max < ESN_MIN) {
       ld_check(false);
       err = E::INVALID_PARAM;
@@ -101,8 +111,8 @@ class SlidingWindowSingleEpoch {
     }
 
     ld_check(epoch_ != EPOCH_INVALID);
-    state_.reset(new std::atomic<uintptr_t>[capacity_]);
-    std::fill(state_.get(), state_.get() + capacity_, (uintptr_t)0);
+    state_.reset(new std::atomic<uintptr_t>[num_slots_]);
+    std::fill(state_.get(), state_.get() + num_slots_, (uintptr_t)0);
     // mark the first slot to assign as the tail
     slot(right_.load()) = SW_TAIL;
   }
@@ -152,7 +162,7 @@ class SlidingWindowSingleEpoch {
     // impossible to overflow uint64_t in practice
     size_t token = size_.fetch_add(1);
 
-    if (token >= capacity_) {
+    if (token >= capacity_.load()) {
       size_.fetch_sub(1);
       err = E::NOBUFS;
       return LSN_INVALID;
@@ -206,7 +216,7 @@ class SlidingWindowSingleEpoch {
 
     } while (!right_.compare_exchange_weak(r, r + 1));
 
-    // now atomically |= p into state_[r % capacity_]
+    // now atomically |= p into state_[r % num_slots_]
     // We do it with an explicit cas loop to check invariants.
 
     uintptr_t cur; // value of slot [r % N] before we mark it INUSE
@@ -220,7 +230,7 @@ class SlidingWindowSingleEpoch {
       // slot/token
       ld_check((cur & ~SW_TAIL) == 0);
       // cur cannot contain a pointer because we hold 1 space in the
-      // window of size capacity_ (=N). The only LSNs that can
+      // window of size capacity_ (<= N). The only LSNs that can
       // occupy the same entry as r in the state_[] vector are in the
       // set {r + kN} for arbitrary integers k.  The
       // (size_.fetch_add(1) > capacity_) check at the beginning
@@ -380,14 +390,40 @@ class SlidingWindowSingleEpoch {
    * @return   current window size
    */
   size_t size() const {
-    return std::min(size_.load(), capacity_);
+    return std::min(size_.load(), capacity_.load());
   }
 
   /**
    * @return   maximum allowed window size
    */
   size_t capacity() const {
-    return capacity_;
+    return capacity_.load();
+  }
+
+  /**
+   * @return   the largest size expand() can raise capacity() to
+   */
+  size_t maxCapacity() const {
+    return num_slots_;
+  }
+
+  /**
+   * Raises the window size limit to min(2 * capacity(), maxCapacity()).
+   * Lock-free; may be called concurrently with grow() and retire(). The
+   * limit is never lowered for the lifetime of the window.
+   *
+   * @return  true if the limit was raised, by this or a concurrent call;
+   *          false if it already was maxCapacity()
+   */
+  bool expand() {
+    size_t cur = capacity_.load();
+    while (cur < num_slots_) {
+      if (capacity_.compare_exchange_weak(
+              cur, std::min<size_t>(cur * 2, num_slots_))) {
+        return true;
+      }
+    }
+    return false;
   }
 
   /**
@@ -433,11 +469,11 @@ class SlidingWindowSingleEpoch {
    *         entry for LSN @param lsn
    */
   unsigned index(lsn_t lsn) const {
-    return lsn_to_esn(lsn).val_ % capacity();
+    return lsn_to_esn(lsn).val_ % num_slots_;
   }
 
   unsigned next_index(unsigned idx) const {
-    return (idx < capacity() - 1) ? (idx + 1) : 0;
+    return (idx < num_slots_ - 1) ? (idx + 1) : 0;
   }
 
   std::atomic<uintptr_t>& slot(lsn_t lsn) {
@@ -486,8 +522,11 @@ class SlidingWindowSingleEpoch {
   // Max ESN to issue, inclusive (typically ESN_MAX - 1)
   const esn_t esn_max_;
 
-  // Maximum window size
-  const size_t capacity_;
+  // Number of entries in state_[], the largest capacity_ can grow to.
+  const size_t num_slots_;
+
+  // Maximum window size. Only goes up, see expand().
+  std::atomic<size_t> capacity_;
 
   // right edge of the window (max LSN in window plus one), or LSN_DISABLED if
   // the window is disabled. Next successful call to grow() will return this
@@ -503,7 +542,7 @@ class SlidingWindowSingleEpoch {
   std::atomic<lsn_t> next_lsn_before_disabled_{LSN_DISABLED};
 
   // circular array of Element pointers and flags defined below. Its size is
-  // fixed at construction and equals the capacity.
+  // fixed at construction and equals num_slots_.
   std::unique_ptr<std::atomic<uintptr_t>[]> state_;
 
   // a special value that may be stored in `prev_epoch_tail_`. used to
@@ -105,6 +105,10 @@ int SocketNetworkDependencies::setSoMark(int fd, uint32_t so_mark) {
   return setsockopt(fd, SOL_SOCKET, SO_MARK, &so_mark, sizeof(so_mark));
 }
 
+int SocketNetworkDependencies::setSoPriority(int fd, int priority) {
+  return setsockopt(fd, SOL_SOCKET, SO_PRIORITY, &priority, sizeof(priority));
+}
+
 int SocketNetworkDependencies::getTCPInfo(TCPInfo* info, int fd) {
   LinuxNetUtils util;
   return util.getTCPInfo(info, fd);
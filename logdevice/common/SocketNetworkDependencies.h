@@ -50,6 +50,7 @@ class SocketNetworkDependencies : public NetworkDependencies {
   virtual void processDeferredMessageCompletions();
   virtual int setDSCP(int fd, sa_family_t sa_family, uint8_t default_dscp);
   virtual int setSoMark(int fd, uint32_t so_mark);
+  virtual int setSoPriority(int fd, int priority);
 
   virtual int getTCPInfo(TCPInfo* info, int fd);
 
@@ -192,6 +192,10 @@ int SocketSender::addClient(int fd,
       return -1;
     }
 
+    if (type == SocketType::GOSSIP) {
+      setGossipSocketOptions(*res.first->second);
+    }
+
     auto* cb = new DisconnectedClientCallback(this);
     // self-managed, destroyed by own operator()
 
@@ -309,6 +313,12 @@ bool SocketSender::canSendToImpl(const Address& addr,
 
   Priority p = PriorityMap::fromTrafficClass()[tc];
 
+  // Common case: there is credit, no need to synchronize with the
+  // TrafficShaper.
+  if (conn->flow_group_.canDrain(p)) {
+    return true;
+  }
+
   auto lock = nw_shaping_container_->lock();
   if (!conn->flow_group_.canDrain(p)) {
     conn->flow_group_.push(on_bw_avail, p);
@@ -400,8 +410,6 @@ int SocketSender::sendMessageImpl(std::unique_ptr<Message>&& msg,
     conn.pushOnCloseCallback(*onclose);
   }
 
-  auto lock = nw_shaping_container_->lock();
-
   Status error_to_inject = Worker::settings().message_error_injection_status;
   if (UNLIKELY(error_to_inject == E::DROPPED) &&
       envelope->message().type_ != MessageType::HELLO &&
@@ -422,8 +430,21 @@ int SocketSender::sendMessageImpl(std::unique_ptr<Message>&& msg,
             Worker::settings().message_error_injection_chance_percent);
   };
 
-  if (!inject_shaping_event() && conn.flow_group_.drain(*envelope)) {
-    lock.unlock();
+  // Try to debit the FlowMeter without the lock first. Only if that fails,
+  // take the lock, which excludes a concurrent deposit by the TrafficShaper,
+  // and try again before deferring the message.
+  bool drained = error_to_inject != E::CBREGISTERED &&
+      conn.flow_group_.drain(*envelope);
+  std::unique_lock<std::mutex> lock;
+  if (!drained) {
+    lock = nw_shaping_container_->lock();
+    drained = !inject_shaping_event() && conn.flow_group_.drain(*envelope);
+  }
+
+  if (drained) {
+    if (lock.owns_lock()) {
+      lock.unlock();
+    }
     FLOW_GROUP_STAT_INCR(Worker::stats(), conn.flow_group_, direct_dispatched);
     // Note: Some errors can only be detected during message
     // serialization.
@@ -1005,12 +1026,24 @@ bool SocketSender::setConnectionInfo(const Address& address,
     return false;
   }
   if (address.isClientAddress() && info.peer_node_idx) {
-    connection->setDSCP(settings_->server_dscp_default);
+    if (connection->getInfo().socket_type == SocketType::GOSSIP) {
+      setGossipSocketOptions(*connection);
+    } else {
+      connection->setDSCP(settings_->server_dscp_default);
+    }
   }
   connection->setInfo(std::move(info));
   return true;
 }
 
+void SocketSender::setGossipSocketOptions(Connection& conn) {
+  conn.setDSCP(settings_->gossip_dscp >= 0 ? settings_->gossip_dscp
+                                           : settings_->server_dscp_default);
+  if (settings_->gossip_socket_priority >= 0) {
+    conn.setSoPriority(settings_->gossip_socket_priority);
+  }
+}
+
 std::pair<Sender::ExtractPeerIdentityResult, PrincipalIdentity>
 SocketSender::extractPeerIdentity(const Address& addr) {
   auto connection = findConnection(addr);
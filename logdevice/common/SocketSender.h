@@ -387,6 +387,12 @@ class SocketSender : public Sender {
    */
   Connection* initServerConnection(NodeID nid, SocketType sock_type);
 
+  /**
+   * Applies gossip-dscp and gossip-socket-priority to an incoming gossip
+   * connection. Outgoing ones get them when connecting.
+   */
+  void setGossipSocketOptions(Connection& conn);
+
   /**
    * This method gets the Connection associated with a given ClientID. The
    * connection must already exist for this method to succeed.
@@ -17,6 +17,7 @@
 #include "logdevice/common/settings/Settings.h"
 #include "logdevice/common/settings/UpdateableSettings.h"
 #include "logdevice/common/stats/Stats.h"
+#include "logdevice/common/stats/StatsSnapshotFile.h"
 
 namespace facebook { namespace logdevice {
 
@@ -121,11 +122,16 @@ std::unique_ptr<StatsCollectionThread> StatsCollectionThread::maybeCreate(
 
   auto factory = plugin_registry->getSinglePlugin<StatsPublisherFactory>(
       PluginType::STATS_PUBLISHER_FACTORY);
-  if (!factory) {
-    return nullptr;
+  std::unique_ptr<StatsPublisher> stats_publisher;
+  if (factory) {
+    stats_publisher = (*factory)(settings, num_shards);
+  }
+  if (!settings->stats_snapshot_path.empty()) {
+    stats_publisher = std::make_unique<StatsSnapshotFilePublisher>(
+        settings->stats_snapshot_path,
+        /* include_log_groups */ true,
+        std::move(stats_publisher));
   }
-
-  auto stats_publisher = (*factory)(settings, num_shards);
   if (!stats_publisher) {
     return nullptr;
   }
@@ -0,0 +1,103 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/StoreBatcher.h"
+
+#include <algorithm>
+
+#include "logdevice/common/Sender.h"
+#include "logdevice/common/Worker.h"
+#include "logdevice/common/protocol/STORES_BATCH_Message.h"
+#include "logdevice/common/protocol/STORE_Message.h"
+#include "logdevice/common/settings/Settings.h"
+#include "logdevice/common/stats/Stats.h"
+
+namespace facebook { namespace logdevice {
+
+StoreBatcher::StoreBatcher() : timer_([this] { flushAll(); }) {}
+
+bool StoreBatcher::add(std::unique_ptr<STORE_Message>& msg, NodeID dest) {
+  ld_check(msg);
+  Worker* w = Worker::onThisThread();
+  const Settings& settings = Worker::settings();
+  if (settings.sequencer_store_batching_window.count() <= 0) {
+    return false;
+  }
+  folly::Optional<uint16_t> proto =
+      w->sender().getSocketProtocolVersion(dest.index());
+  if (!proto.hasValue() || *proto < Compatibility::STORES_BATCH_SUPPORT) {
+    return false;
+  }
+  const size_t bytes = msg->size(*proto);
+  if (bytes >= settings.sequencer_store_batching_max_bytes) {
+    return false;
+  }
+
+  Pending& pending = pending_[dest];
+  pending.stores.push_back(std::move(msg));
+  pending.bytes += bytes;
+  if (pending.bytes >= settings.sequencer_store_batching_max_bytes) {
+    flush(dest);
+  } else if (!timer_.isActive()) {
+    timer_.activate(settings.sequencer_store_batching_window);
+  }
+  return true;
+}
+
+void StoreBatcher::flushAll() {
+  timer_.cancel();
+  while (!pending_.empty()) {
+    flush(pending_.begin()->first);
+  }
+}
+
+void StoreBatcher::flush(NodeID dest) {
+  auto it = pending_.find(dest);
+  if (it == pending_.end()) {
+    return;
+  }
+  std::vector<std::unique_ptr<STORE_Message>> stores =
+      std::move(it->second.stores);
+  pending_.erase(it);
+
+  stores.erase(std::remove_if(stores.begin(),
+                              stores.end(),
+                              [](const auto& store) {
+                                return store->cancelled();
+                              }),
+               stores.end());
+  if (stores.empty()) {
+    return;
+  }
+
+  Worker* w = Worker::onThisThread();
+  const size_t nstores = stores.size();
+  if (nstores == 1) {
+    std::unique_ptr<STORE_Message> store = std::move(stores[0]);
+    if (w->sender().sendMessage(std::move(store), dest) != 0) {
+      ld_check(store);
+      store->onSentCommon(err, Address(dest));
+    }
+    return;
+  }
+
+  auto batch = std::make_unique<STORES_BATCH_Message>(std::move(stores));
+  if (w->sender().sendMessage(std::move(batch), dest) == 0) {
+    STAT_INCR(Worker::stats(), sequencer_store_batches_sent);
+    STAT_ADD(Worker::stats(), sequencer_stores_batched, nstores);
+    return;
+  }
+  // The batch was not sent, so STORE_onSent() won't be called. Let the
+  // Appenders know, handling the failure may retire any of them.
+  ld_check(batch);
+  const Status st = err;
+  for (const auto& store : batch->stores_) {
+    store->onSentCommon(st, Address(dest));
+  }
+}
+
+}} // namespace facebook::logdevice
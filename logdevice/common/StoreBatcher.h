@@ -0,0 +1,77 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "logdevice/common/NodeID.h"
+#include "logdevice/common/Timer.h"
+
+namespace facebook { namespace logdevice {
+
+class STORE_Message;
+
+/**
+ * @file Coalesces STORE messages that Appenders running on a sequencer
+ *       Worker send to the same storage node within
+ *       --sequencer-store-batching-window into STORES_BATCH messages. A
+ *       sequencer running many low-rate logs otherwise sends one message per
+ *       record copy, so its message rate grows with the number of logs rather
+ *       than with throughput.
+ *
+ *       The storage node dispatches each STORE of a batch on its own. They
+ *       reach the storage threads together, which write them in the same
+ *       WriteBatchStorageTask.
+ *
+ *       Once a batch is handed to Sender, the sent status reaches every
+ *       Appender through STORE_onSent() as usual. If it can't be, StoreBatcher
+ *       reports the error to the Appenders itself. STOREs of Appenders that
+ *       retired while queued are dropped.
+ *
+ *       One instance per Worker, see Worker::storeBatcher().
+ */
+
+class StoreBatcher {
+ public:
+  StoreBatcher();
+
+  StoreBatcher(const StoreBatcher&) = delete;
+  StoreBatcher& operator=(const StoreBatcher&) = delete;
+
+  /**
+   * Queues `msg` to be sent to `dest` together with other STOREs.
+   *
+   * @return true if `msg` was queued. false if it should be sent on its own,
+   *         leaving `msg` untouched: batching is disabled, the message is too
+   *         large, or the connection to `dest` isn't handshaken yet or speaks
+   *         a protocol without STORES_BATCH.
+   */
+  bool add(std::unique_ptr<STORE_Message>& msg, NodeID dest);
+
+  /**
+   * Sends everything queued.
+   */
+  void flushAll();
+
+ private:
+  struct Pending {
+    std::vector<std::unique_ptr<STORE_Message>> stores;
+    size_t bytes = 0;
+  };
+
+  void flush(NodeID dest);
+
+  std::unordered_map<NodeID, Pending, NodeID::Hash> pending_;
+
+  // Fires --sequencer-store-batching-window after the first STORE was queued.
+  Timer timer_;
+};
+
+}} // namespace facebook::logdevice
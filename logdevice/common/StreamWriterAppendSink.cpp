@@ -112,6 +112,10 @@ StreamWriterAppendSink::getAppendRetryTimeout() noexcept {
       append_retry_timeout_);
 }
 
+size_t StreamWriterAppendSink::getInflightWindow() noexcept {
+  return processor_->updateableSettings()->stream_writer_inflight_window;
+}
+
 std::pair<Status, NodeID> StreamWriterAppendSink::appendBuffered(
     logid_t logid,
     const BufferedWriter::AppendCallback::ContextSet& contexts,
@@ -171,9 +175,14 @@ std::pair<Status, NodeID> StreamWriterAppendSink::appendBuffered(
                             stream_req_id));
   ld_check(result.second);
 
-  // If the message is next one to be posted, then post immediately.
-  if (stream_req_id.seq_num ==
-      next_seq_num(stream.max_inflight_window_seq_num_)) {
+  const size_t window = getInflightWindow();
+  if (window > 0) {
+    // Post immediately if the inflight window has room, otherwise the request
+    // waits until earlier ones are acked.
+    fillInflightWindow(stream, window);
+  } else if (stream_req_id.seq_num ==
+             next_seq_num(stream.max_inflight_window_seq_num_)) {
+    // If the message is next one to be posted, then post immediately.
     postNextReadyRequestsIfExists(stream, 1);
   }
 
@@ -231,6 +240,7 @@ void StreamWriterAppendSink::onCallback(Stream& stream,
   // Update last status, inflight_request.
   req_state.last_status = status;
   req_state.inflight_request = nullptr;
+  const size_t window = getInflightWindow();
 
   if (status == Status::OK) {
     // Check that LSN returned does not violate monotonicity for sequence
@@ -263,14 +273,22 @@ void StreamWriterAppendSink::onCallback(Stream& stream,
       // ONE_AT_A_TIME mode. We chose 2 so that the client can systematically
       // improve the input throughput by having many inflight, as a proper write
       // stream connection is established with a sequencer.
-      // TODO: Try out more than 2 triggers for each sequencer prefix ACK.
+      // With a fixed inflight window, we instead refill the window.
       if (req_seq_num == next_seq_num(stream.max_prefix_acked_seq_num_)) {
         auto num_called_back = stream.triggerPrefixCallbacks();
-        postNextReadyRequestsIfExists(stream, 2 * num_called_back);
+        if (window > 0) {
+          fillInflightWindow(stream, window);
+        } else {
+          postNextReadyRequestsIfExists(stream, 2 * num_called_back);
+        }
       }
     } else {
       rewindStreamUntil(stream, req_seq_num);
-      postNextReadyRequestsIfExists(stream, 2);
+      if (window > 0) {
+        fillInflightWindow(stream, window);
+      } else {
+        postNextReadyRequestsIfExists(stream, 2);
+      }
     }
   } else {
     // Rewinding a stream until req_seq_num discards any previous successful
@@ -280,6 +298,14 @@ void StreamWriterAppendSink::onCallback(Stream& stream,
     // than all these. To maintain LSN monotonicity property, we will retry all
     // of them anyway!
     rewindStreamUntil(stream, req_seq_num);
+    if (window > 0 &&
+        req_seq_num != next_seq_num(stream.max_prefix_acked_seq_num_)) {
+      // The earliest pending request is still in flight, so this is not a
+      // failure of the whole stream (e.g. a sequencer change was already
+      // picked up through it). Resend the failed suffix right away instead of
+      // waiting for the earlier requests to be acked.
+      fillInflightWindow(stream, window);
+    }
     ensureEarliestPendingRequestInflight(stream);
   }
 }
@@ -296,9 +322,7 @@ epoch_t StreamWriterAppendSink::getSeenEpoch(worker_id_t worker_id,
 
 std::unique_ptr<BackoffTimer>
 StreamWriterAppendSink::createBackoffTimer(Stream& stream) {
-  auto wrapped_callback = [this, &stream]() {
-    postNextReadyRequestsIfExists(stream, 1);
-  };
+  auto wrapped_callback = [this, &stream]() { retryStream(stream); };
   std::unique_ptr<BackoffTimer> retry_timer =
       std::make_unique<ExponentialBackoffTimer>(
           wrapped_callback, expbackoff_settings_);
@@ -341,6 +365,26 @@ void StreamWriterAppendSink::postNextReadyRequestsIfExists(
   }
 }
 
+void StreamWriterAppendSink::retryStream(Stream& stream) {
+  const size_t window = getInflightWindow();
+  if (window > 0) {
+    fillInflightWindow(stream, window);
+  } else {
+    postNextReadyRequestsIfExists(stream, 1);
+  }
+}
+
+void StreamWriterAppendSink::fillInflightWindow(Stream& stream,
+                                                size_t window) {
+  ld_check(stream.max_inflight_window_seq_num_ >=
+           stream.max_prefix_acked_seq_num_);
+  const size_t inflight = stream.max_inflight_window_seq_num_.val_ -
+      stream.max_prefix_acked_seq_num_.val_;
+  if (inflight < window) {
+    postNextReadyRequestsIfExists(stream, window - inflight);
+  }
+}
+
 void StreamWriterAppendSink::ensureEarliestPendingRequestInflight(
     Stream& stream) {
   auto earliest_seq_num = next_seq_num(stream.max_prefix_acked_seq_num_);
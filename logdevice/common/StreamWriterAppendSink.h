@@ -276,6 +276,11 @@ class StreamWriterAppendSink : public BufferedWriterAppendSink {
   // stream.max_inflight_window_seq_num_.
   void postNextReadyRequestsIfExists(Stream& stream, size_t suggested_count);
 
+  // Called by the retry timer once the earliest pending request is due to be
+  // retried. Posts it, and with an inflight window (see getInflightWindow())
+  // also the requests after it, up to the window.
+  void retryStream(Stream& stream);
+
  protected:
   // can override in tests
   virtual void postAppend(Stream& stream, StreamAppendRequestState& req_state);
@@ -284,6 +289,11 @@ class StreamWriterAppendSink : public BufferedWriterAppendSink {
 
   virtual std::chrono::milliseconds getAppendRetryTimeout() noexcept;
 
+  // Maximum number of requests of a stream in the inflight window, from
+  // --stream-writer-inflight-window. 0 means no fixed window: the window
+  // starts at one request and grows by two for each request acked in order.
+  virtual size_t getInflightWindow() noexcept;
+
   // Obtain the seen_epoch for log from specified worker. This MUST be called
   // from within the corresponding worker for thread safety. Currently it is
   // called by the callback that is executed by the worker when
@@ -291,7 +301,7 @@ class StreamWriterAppendSink : public BufferedWriterAppendSink {
   virtual epoch_t getSeenEpoch(worker_id_t worker_id, logid_t logid);
 
   // Creates an exponential backoff timer with a callback that invokes
-  // postNextReadyRequest() on stream with a suggested_count of 1.
+  // retryStream() on stream.
   virtual std::unique_ptr<BackoffTimer> createBackoffTimer(Stream& stream);
 
   Stream* getStream(logid_t log_id);
@@ -341,6 +351,10 @@ class StreamWriterAppendSink : public BufferedWriterAppendSink {
   // failed stream append requests.
   chrono_expbackoff_t<std::chrono::milliseconds> expbackoff_settings_;
 
+  // Posts ready requests until the inflight window of the stream holds
+  // `window` requests or there are no more ready requests.
+  void fillInflightWindow(Stream& stream, size_t window);
+
   // Checks if the earliest pending request, (also the first one in the inflight
   // window), which corresponds to sequence number
   // (stream.max_prefix_acked_seq_num_ + 1) in the stream is in flight. If not,
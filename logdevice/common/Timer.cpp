@@ -7,6 +7,8 @@
  */
 #include "logdevice/common/Timer.h"
 
+#include <folly/io/async/HHWheelTimer.h>
+
 #include "logdevice/common/EventLoop.h"
 #include "logdevice/common/LibeventTimer.h"
 #include "logdevice/common/Processor.h"
@@ -100,6 +102,52 @@ class WheelTimerDispatchImpl : public TimerInterface {
   bool is_activated_{false};
 };
 
+// Timer on the timing wheel of the worker's own event loop. Activating it
+// doesn't allocate, cancelling it removes it from the wheel and it fires on
+// the worker thread directly.
+class WorkerWheelTimerImpl : public TimerInterface,
+                             private folly::HHWheelTimer::Callback {
+ public:
+  WorkerWheelTimerImpl() {}
+
+  void activate(std::chrono::microseconds delay) override;
+
+  void cancel() override {
+    cancelTimeout();
+  }
+
+  bool isActive() const override {
+    return isScheduled();
+  }
+
+  void setCallback(std::function<void()> callback) override {
+    callback_ = std::move(callback);
+  }
+
+  void assign(std::function<void()> callback) override {
+    setCallback(std::move(callback));
+  }
+
+  bool isAssigned() const override {
+    return !!callback_;
+  }
+
+ private:
+  WorkerWheelTimerImpl(const WorkerWheelTimerImpl&) = delete;
+  WorkerWheelTimerImpl(WorkerWheelTimerImpl&&) = delete;
+  WorkerWheelTimerImpl& operator=(WorkerWheelTimerImpl&&) = delete;
+  WorkerWheelTimerImpl& operator=(const WorkerWheelTimerImpl&) = delete;
+
+  void timeoutExpired() noexcept override;
+
+  // The default implementation calls timeoutExpired().
+  void callbackCanceled() noexcept override {}
+
+  std::function<void()> callback_;
+  Worker* worker_{nullptr};
+  RunContext workerRunContext_;
+};
+
 decltype(auto)
 WheelTimerDispatchImpl::makeWheelTimerInternalExecutor(Worker* worker) {
   return [timer = this, canceled = is_canceled_, worker]() mutable {
@@ -129,6 +177,30 @@ WheelTimerDispatchImpl::makeWheelTimerInternalExecutor(Worker* worker) {
   };
 }
 
+void WorkerWheelTimerImpl::activate(microseconds delay) {
+  ld_check(callback_);
+  worker_ = Worker::onThisThread();
+  // Reschedules the timeout if it's already scheduled.
+  EventLoop::onThisThread()->getWheelTimer().scheduleTimeout(
+      this, duration_cast<milliseconds>(delay));
+  workerRunContext_ = worker_->currentlyRunning_;
+}
+
+void WorkerWheelTimerImpl::timeoutExpired() noexcept {
+  Worker* worker = worker_;
+  RunContext run_context = workerRunContext_;
+  WorkerContextScopeGuard g(worker);
+  worker->onStartedRunning(run_context);
+  {
+    // Make a local copy of callback to make sure it's not destroyed while
+    // it's running, in particular if it calls setCallback().
+    std::function<void()> cb = callback_;
+    cb();
+    // `this` might have been destroyed.
+  }
+  worker->onStoppedRunning(run_context);
+}
+
 } // namespace
 
 // Sometimes the worker is unavailable i.e. in tests and we cannot assign.
@@ -196,7 +268,10 @@ TimerInterface& Timer::getTimerImpl() const {
     // This is called from tests and ldbench workers. Caller cannot assume
     // Worker interface to be available in those cases.
     auto worker = Worker::onThisThread(false /* enforce_worker */);
-    if (worker && worker->updateable_settings_->enable_hh_wheel_backed_timers) {
+    if (worker && worker->updateable_settings_->enable_worker_wheel_timers) {
+      impl_ = std::make_unique<WorkerWheelTimerImpl>();
+    } else if (worker &&
+               worker->updateable_settings_->enable_hh_wheel_backed_timers) {
       impl_ = std::make_unique<WheelTimerDispatchImpl>();
     } else {
       impl_ = std::make_unique<LibEventTimerImpl>();
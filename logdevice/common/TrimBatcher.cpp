@@ -0,0 +1,95 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/TrimBatcher.h"
+
+#include <algorithm>
+
+#include "logdevice/common/Sender.h"
+#include "logdevice/common/TrimRequest.h"
+#include "logdevice/common/Worker.h"
+#include "logdevice/common/protocol/TRIMS_BATCH_Message.h"
+#include "logdevice/common/protocol/TRIM_Message.h"
+#include "logdevice/common/settings/Settings.h"
+#include "logdevice/common/stats/Stats.h"
+
+namespace facebook { namespace logdevice {
+
+TrimBatcher::TrimBatcher() : timer_([this] { flushAll(); }) {}
+
+bool TrimBatcher::add(std::unique_ptr<TRIM_Message>& msg, NodeID dest) {
+  ld_check(msg);
+  Worker* w = Worker::onThisThread();
+  const Settings& settings = Worker::settings();
+  if (settings.trim_batching_window.count() <= 0) {
+    return false;
+  }
+  folly::Optional<uint16_t> proto =
+      w->sender().getSocketProtocolVersion(dest.index());
+  if (!proto.hasValue() || *proto < Compatibility::TRIMS_BATCH_SUPPORT) {
+    return false;
+  }
+
+  auto& pending = pending_[dest];
+  pending.push_back(std::move(msg));
+  if (pending.size() >= settings.trim_batching_max_trims) {
+    flush(dest);
+  } else if (!timer_.isActive()) {
+    timer_.activate(settings.trim_batching_window);
+  }
+  return true;
+}
+
+void TrimBatcher::flushAll() {
+  timer_.cancel();
+  while (!pending_.empty()) {
+    flush(pending_.begin()->first);
+  }
+}
+
+void TrimBatcher::flush(NodeID dest) {
+  auto it = pending_.find(dest);
+  if (it == pending_.end()) {
+    return;
+  }
+  std::vector<std::unique_ptr<TRIM_Message>> trims = std::move(it->second);
+  pending_.erase(it);
+
+  Worker* w = Worker::onThisThread();
+  const auto& running = w->runningTrimRequests().map;
+  trims.erase(std::remove_if(trims.begin(),
+                             trims.end(),
+                             [&](const auto& trim) {
+                               return !running.count(
+                                   trim->getHeader().client_rqid);
+                             }),
+              trims.end());
+  if (trims.empty()) {
+    return;
+  }
+
+  // Sender leaves the message with us if it fails. Report the failure to the
+  // TrimRequests the same way a failure after queueing would be.
+  if (trims.size() == 1) {
+    if (w->sender().sendMessage(std::move(trims[0]), dest) != 0) {
+      const Status st = err;
+      trims[0]->onSent(st, Address(dest));
+    }
+    return;
+  }
+  const size_t ntrims = trims.size();
+  auto batch = std::make_unique<TRIMS_BATCH_Message>(std::move(trims));
+  if (w->sender().sendMessage(std::move(batch), dest) != 0) {
+    const Status st = err;
+    batch->onSent(st, Address(dest));
+    return;
+  }
+  STAT_INCR(Worker::stats(), trim_batches_sent);
+  STAT_ADD(Worker::stats(), trims_batched, ntrims);
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,68 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "logdevice/common/NodeID.h"
+#include "logdevice/common/Timer.h"
+
+namespace facebook { namespace logdevice {
+
+class TRIM_Message;
+
+/**
+ * @file Coalesces TRIM messages that TrimRequests running on a Worker send to
+ *       the same storage node within --trim-batching-window into TRIMS_BATCH
+ *       messages. Trimming many logs at once (e.g. from a retention job)
+ *       otherwise sends one message per log per storage shard.
+ *
+ *       The outcome of sending a batch reaches each TrimRequest through
+ *       TRIM_Message::onSent(), as for unbatched TRIMs. TRIMs of requests
+ *       that completed while queued are dropped.
+ *
+ *       One instance per Worker, see Worker::trimBatcher().
+ */
+
+class TrimBatcher {
+ public:
+  TrimBatcher();
+
+  TrimBatcher(const TrimBatcher&) = delete;
+  TrimBatcher& operator=(const TrimBatcher&) = delete;
+
+  /**
+   * Queues `msg` to be sent to `dest` together with other trims.
+   *
+   * @return true if `msg` was queued. false if it should be sent on its own,
+   *         leaving `msg` untouched: batching is disabled, or the connection
+   *         to `dest` isn't handshaken yet or speaks a protocol without
+   *         TRIMS_BATCH.
+   */
+  bool add(std::unique_ptr<TRIM_Message>& msg, NodeID dest);
+
+  /**
+   * Sends everything queued.
+   */
+  void flushAll();
+
+ private:
+  void flush(NodeID dest);
+
+  std::unordered_map<NodeID,
+                     std::vector<std::unique_ptr<TRIM_Message>>,
+                     NodeID::Hash>
+      pending_;
+
+  // Fires --trim-batching-window after the first trim was queued.
+  Timer timer_;
+};
+
+}} // namespace facebook::logdevice
@@ -12,6 +12,7 @@
 #include "logdevice/common/Processor.h"
 #include "logdevice/common/Sender.h"
 #include "logdevice/common/SyncSequencerRequest.h"
+#include "logdevice/common/TrimBatcher.h"
 #include "logdevice/common/Worker.h"
 #include "logdevice/common/debug.h"
 #include "logdevice/common/protocol/TRIM_Message.h"
@@ -301,7 +302,12 @@ int TrimRequest::sendOneMessage(ShardID to) {
   NodeID node_id(to.node());
   TRIM_Header header = {id_, log_id_, trim_point_, to.shard()};
   auto msg = std::make_unique<TRIM_Message>(header);
-  return Worker::onThisThread()->sender().sendMessage(std::move(msg), node_id);
+  Worker* w = Worker::onThisThread();
+  if (w->trimBatcher().add(msg, node_id)) {
+    // The outcome of sending the batch will reach onMessageSent().
+    return 0;
+  }
+  return w->sender().sendMessage(std::move(msg), node_id);
 }
 
 StorageSetAccessor::SendResult TrimRequest::sendTo(ShardID shard) {
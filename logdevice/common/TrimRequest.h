@@ -135,7 +135,8 @@ class TrimRequest : public DistributedRequest {
   // Invoke callback_ with the supplied status and delete this instance.
   void finalize(Status);
 
-  // send a single TRIM message to the specified node
+  // send a single TRIM message to the specified node, possibly batched with
+  // TRIMs of other requests (see TrimBatcher)
   int sendOneMessage(ShardID to);
 
   virtual std::unique_ptr<NodeSetFinder> makeNodeSetFinder();
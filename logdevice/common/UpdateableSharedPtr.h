@@ -15,6 +15,7 @@
 #include <folly/Optional.h>
 #include <folly/SpinLock.h>
 #include <folly/ThreadLocal.h>
+#include <folly/synchronization/Rcu.h>
 
 namespace facebook { namespace logdevice {
 
@@ -281,4 +282,85 @@ class UpdateableSharedPtr : boost::noncopyable {
   mutable std::mutex mutex_;
 };
 
+/**
+ * An UpdateableSharedPtr that can also be read without taking a reference to
+ * the managed object. withReadPtr() enters an RCU read-side critical section
+ * (folly::rcu_reader), which only touches a thread-local counter, and passes a
+ * raw pointer to the current object to the given function. Unlike get(), it
+ * doesn't lock the thread-local cache or bump any reference counter, so it is
+ * the cheapest way for hot paths to look at a read-mostly snapshot, such as a
+ * config, for the duration of a call.
+ *
+ * update() and friends retire the previous object with folly::rcu_retire():
+ * the reference held on behalf of RCU readers is dropped once all readers
+ * that may have seen it are done, on an RCU thread.
+ */
+template <typename T, typename Tag = void>
+class RCUUpdateableSharedPtr : boost::noncopyable {
+ public:
+  explicit RCUUpdateableSharedPtr(std::shared_ptr<T> ptr = nullptr)
+      : ptr_(ptr), rcuPtr_(new std::shared_ptr<T>(std::move(ptr))) {}
+
+  ~RCUUpdateableSharedPtr() {
+    delete rcuPtr_.load();
+  }
+
+  void update(std::shared_ptr<T> desired) {
+    exchange(std::move(desired));
+  }
+
+  bool compare_and_swap(std::shared_ptr<T>& expected,
+                        std::shared_ptr<T> desired) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!ptr_.compare_and_swap(expected, desired)) {
+      return false;
+    }
+    publish(std::move(desired));
+    return true;
+  }
+
+  std::shared_ptr<T> exchange(std::shared_ptr<T> desired) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::shared_ptr<T> prev = ptr_.exchange(desired);
+    publish(std::move(desired));
+    return prev;
+  }
+
+  /**
+   * See UpdateableSharedPtr::get(). Use it to keep the object past the
+   * current call, e.g. in a request or a callback.
+   */
+  std::shared_ptr<T> get() const {
+    return ptr_.get();
+  }
+
+  /**
+   * Calls f(T*) with the current object, possibly nullptr, and returns its
+   * result. The object stays alive until f returns. f must not keep the
+   * pointer after it returns, nor block for long, as that would hold back
+   * the destruction of every object retired in the meantime.
+   */
+  template <typename Func>
+  auto withReadPtr(Func&& f) const {
+    folly::rcu_reader guard;
+    return f(rcuPtr_.load(std::memory_order_acquire)->get());
+  }
+
+ private:
+  // Called with mutex_ held.
+  void publish(std::shared_ptr<T> ptr) {
+    std::shared_ptr<T>* prev = rcuPtr_.exchange(
+        new std::shared_ptr<T>(std::move(ptr)), std::memory_order_acq_rel);
+    folly::rcu_retire(prev);
+  }
+
+  UpdateableSharedPtr<T, Tag> ptr_;
+
+  // Same object as ptr_, for withReadPtr(). Retired with rcu_retire().
+  std::atomic<std::shared_ptr<T>*> rcuPtr_;
+
+  // Keeps updates of ptr_ and rcuPtr_ in the same order.
+  std::mutex mutex_;
+};
+
 }} // namespace facebook::logdevice
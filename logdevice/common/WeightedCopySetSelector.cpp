@@ -626,12 +626,51 @@ WeightedCopySetSelector::prepareCachedNodeAvailability() const {
       bool was_disabled = cache.adjusted_hierarchy->attachNode(shard);
       ld_check(was_disabled);
       cache.avoid_detaching_my_domain = false;
+      cache.local_detached_hierarchy_stale = true;
     }
   }
 
   return cache;
 }
 
+const WeightedCopySetSelector::AdjustedHierarchy&
+WeightedCopySetSelector::getBaseHierarchy(NodeAvailabilityCache& cache,
+                                          bool detach_my_domain) const {
+  if (!detach_my_domain) {
+    return cache.adjusted_hierarchy.value();
+  }
+  if (cache.local_detached_hierarchy_stale) {
+    cache.local_detached_hierarchy.emplace(cache.adjusted_hierarchy.value());
+    bool wasnt_detached = cache.local_detached_hierarchy->detachDomain(
+        {my_domain_idx_.value()});
+    ld_check(wasnt_detached);
+    cache.local_detached_hierarchy_stale = false;
+  }
+  return cache.local_detached_hierarchy.value();
+}
+
+bool WeightedCopySetSelector::checkAvailability(
+    const StoreChainLink copyset_chain[],
+    size_t copyset_size,
+    StoreChainLink* out_chain_links,
+    bool* out_chain) const {
+  for (size_t i = 0; i < copyset_size; ++i) {
+    StoreChainLink destination;
+    auto node_status = deps_->getNodeAvailability()->checkNode(
+        nodeset_state_.get(), copyset_chain[i].destination, &destination);
+    if (node_status == NodeStatus::NOT_AVAILABLE) {
+      return false;
+    }
+    if (out_chain) {
+      *out_chain &= node_status == NodeStatus::AVAILABLE;
+    }
+    if (out_chain_links) {
+      out_chain_links[i] = destination;
+    }
+  }
+  return true;
+}
+
 bool WeightedCopySetSelector::checkAvailabilityAndBlacklist(
     const StoreChainLink copyset_chain[],
     size_t copyset_size,
@@ -659,6 +698,7 @@ bool WeightedCopySetSelector::checkAvailabilityAndBlacklist(
       if (was_enabled_cache) {
         cache.unavailable_nodes.push_back(node);
         cache.avoid_detaching_my_domain = false;
+        cache.local_detached_hierarchy_stale = true;
       } else {
         // Be extra paranoid and don't allow cache.unavailable_nodes to grow
         // unboundedly if there's a bug.
@@ -702,9 +742,6 @@ WeightedCopySetSelector::select(StoreChainLink copyset_out[],
                                 RNG& rng,
                                 bool retry) const {
   NodeAvailabilityCache& cache = prepareCachedNodeAvailability();
-  // Need to make a copy in case we'll detach local domain - don't want to
-  // cache that.
-  AdjustedHierarchy hierarchy = cache.adjusted_hierarchy.value();
   const double total_weight = hierarchy_.root.weights.totalWeight();
 
   bool biased = false;
@@ -786,11 +823,16 @@ WeightedCopySetSelector::select(StoreChainLink copyset_out[],
     // between the two approaches is that the first one sometimes picks 2 copies
     // in rack A, which forces it to sometimes pick 0 copies in rack A (so that
     // it's 1 on average, as required by weights).
-    bool wasnt_detached = hierarchy.detachDomain({my_domain_idx_.value()});
-    ld_check(wasnt_detached);
     pick_local_separately = true;
   }
 
+  // Selection only reads the hierarchy, so start from the one cached for this
+  // thread. It's copied only if this call has to blacklist some nodes, which
+  // keeps the common path free of allocations.
+  const AdjustedHierarchy* hierarchy =
+      &getBaseHierarchy(cache, pick_local_separately);
+  folly::Optional<AdjustedHierarchy> own_hierarchy;
+
   while (true) {
     if (attempts >= MAX_BLACKLISTING_ITERATIONS) {
       RATELIMIT_ERROR(
@@ -809,7 +851,7 @@ WeightedCopySetSelector::select(StoreChainLink copyset_out[],
 
     // Select copyset.
 
-    double outside_weight = hierarchy.getRoot().getWeights().totalWeight();
+    double outside_weight = hierarchy->getRoot().getWeights().totalWeight();
     if (secondary_replication_ > 1 &&
         outside_weight <= Sampling::EPSILON * total_weight) {
       return ret = retry_or_complain_on_too_many_unavailable();
@@ -819,7 +861,7 @@ WeightedCopySetSelector::select(StoreChainLink copyset_out[],
       // Simple case: all domains are treated the same way.
       size_t num_picked = selectCrossDomain(secondary_replication_,
                                             replication_,
-                                            hierarchy.getRoot(),
+                                            hierarchy->getRoot(),
                                             copyset_chain.data(),
                                             &biased,
                                             rng);
@@ -829,7 +871,7 @@ WeightedCopySetSelector::select(StoreChainLink copyset_out[],
     } else {
       // Local domain is detached. Pick copies from it separately.
       AdjustedDomain my_domain =
-          hierarchy.getRoot().getSubdomain(my_domain_idx_.value());
+          hierarchy->getRoot().getSubdomain(my_domain_idx_.value());
       double local_weight = my_domain.getWeights().totalWeight();
       copyset_size_t target_num_local_copies = randomRound(
           local_weight / (outside_weight + local_weight) * replication_, rng);
@@ -847,7 +889,7 @@ WeightedCopySetSelector::select(StoreChainLink copyset_out[],
                 NodeLocation::scopeNames()[secondary_replication_scope_]
                     .c_str(),
                 local_weight,
-                hierarchy.getRoot().getWeights().toString().c_str());
+                hierarchy->getRoot().getWeights().toString().c_str());
           }
           biased = true;
         }
@@ -867,7 +909,7 @@ WeightedCopySetSelector::select(StoreChainLink copyset_out[],
         num_picked_outside =
             selectCrossDomain(secondary_replication_ - (num_picked_locally > 0),
                               replication_ - num_picked_locally,
-                              hierarchy.getRoot(),
+                              hierarchy->getRoot(),
                               copyset_chain.data() + num_picked_locally,
                               &biased,
                               rng);
@@ -891,7 +933,7 @@ WeightedCopySetSelector::select(StoreChainLink copyset_out[],
                 (int)secondary_replication_,
                 NodeLocation::scopeNames()[secondary_replication_scope_]
                     .c_str(),
-                hierarchy.getRoot().getWeights().toString().c_str());
+                hierarchy->getRoot().getWeights().toString().c_str());
           }
           biased = true;
         }
@@ -936,9 +978,18 @@ WeightedCopySetSelector::select(StoreChainLink copyset_out[],
     }
 
     // Check if all selected nodes are available. If not, blacklist and retry.
+    if (!own_hierarchy) {
+      if (checkAvailability(
+              copyset_chain.data(), replication_, copyset_out, chain_out)) {
+        *copyset_size_out = replication_;
+        return ret = Result::SUCCESS;
+      }
+      own_hierarchy.emplace(*hierarchy);
+      hierarchy = &own_hierarchy.value();
+    }
     if (checkAvailabilityAndBlacklist(copyset_chain.data(),
                                       replication_,
-                                      hierarchy,
+                                      own_hierarchy.value(),
                                       cache,
                                       &biased,
                                       copyset_out,
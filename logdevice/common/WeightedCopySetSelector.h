@@ -268,6 +268,12 @@ class WeightedCopySetSelector : public CopySetSelector {
     // that detaching the local domain is probably not a good idea.
     // This is reset back to false every time `unavailable_nodes` changes.
     bool avoid_detaching_my_domain = false;
+
+    // `adjusted_hierarchy` with the local domain detached, used by select()
+    // when locality is enabled. Rebuilt lazily the first time it's needed
+    // after `adjusted_hierarchy` changes, instead of on every select().
+    folly::Optional<AdjustedHierarchy> local_detached_hierarchy;
+    bool local_detached_hierarchy_stale = true;
   };
 
   const logid_t logid_;
@@ -341,6 +347,19 @@ class WeightedCopySetSelector : public CopySetSelector {
   // initializing it if needed and re-checking the cached blacklist of nodes.
   NodeAvailabilityCache& prepareCachedNodeAvailability() const;
 
+  // Returns the hierarchy select() should start from: the cached one, or the
+  // cached one with the local domain detached if `detach_my_domain`.
+  const AdjustedHierarchy&
+  getBaseHierarchy(NodeAvailabilityCache& cache, bool detach_my_domain) const;
+
+  // Returns true if all nodes of the copyset are available, filling
+  // `out_chain_links` and `out_chain` like checkAvailabilityAndBlacklist().
+  // Doesn't blacklist anything.
+  bool checkAvailability(const StoreChainLink copyset[],
+                         size_t copyset_size,
+                         StoreChainLink* out_chain_links,
+                         bool* out_chain) const;
+
   bool checkAvailabilityAndBlacklist(const StoreChainLink copyset[],
                                      size_t copyset_size,
                                      AdjustedHierarchy& hierarchy,
@@ -14,12 +14,14 @@
 #include <unistd.h>
 
 #include <folly/Memory.h>
+#include <folly/Random.h>
 #include <folly/stats/BucketedTimeSeries.h>
 #include <sys/resource.h>
 #include <sys/time.h>
 
 #include "logdevice/common/AbortAppendersEpochRequest.h"
 #include "logdevice/common/AllSequencers.h"
+#include "logdevice/common/AppendBatcher.h"
 #include "logdevice/common/AppendRequest.h"
 #include "logdevice/common/AppendRequestBase.h"
 #include "logdevice/common/Appender.h"
@@ -59,6 +61,8 @@
 #include "logdevice/common/SocketSender.h"
 #include "logdevice/common/SyncSequencerRequest.h"
 #include "logdevice/common/TraceLogger.h"
+#include "logdevice/common/StoreBatcher.h"
+#include "logdevice/common/TrimBatcher.h"
 #include "logdevice/common/TrimRequest.h"
 #include "logdevice/common/WorkerTimeoutStats.h"
 #include "logdevice/common/WriteMetaDataRecord.h"
@@ -166,6 +170,7 @@ class WorkerImpl {
   FindKeyRequestMap runningFindKey_;
   FireAndForgetRequestMap runningFireAndForgets_;
   TrimRequestMap runningTrimRequests_;
+  std::unique_ptr<TrimBatcher> trimBatcher_;
   GetRsmSnapshotRequestMap runningGetRsmSnapshotRequests_;
   GetTrimPointRequestMap runningGetTrimPoint_;
   DataSizeRequestMap runningDataSize_;
@@ -177,6 +182,8 @@ class WorkerImpl {
   LogsConfigManagerReplyMap runningLogsConfigManagerReplies_;
   SettingOverrideTTLRequestMap activeSettingOverrides_;
   AppendRequestMap runningAppends_;
+  std::unique_ptr<AppendBatcher> appendBatcher_;
+  std::unique_ptr<StoreBatcher> storeBatcher_;
   CheckSealRequestMap runningCheckSeals_;
   ConfigurationFetchRequestMap runningConfigurationFetches_;
   GetSeqStateRequestMap runningGetSeqState_;
@@ -257,6 +264,7 @@ Worker::~Worker() {
   ld_check(active_buffered_writers_.empty());
 
   dispose_metareader_timer_.reset();
+  logs_config_invalidation_timer_.reset();
 
   for (auto it = runningWriteMetaDataRecords().map.begin();
        it != runningWriteMetaDataRecords().map.end();) {
@@ -310,6 +318,16 @@ Worker::getNodesConfiguration() const {
   return config_->getNodesConfiguration();
 }
 
+void Worker::withNodesConfiguration(
+    folly::FunctionRef<void(const configuration::nodes::NodesConfiguration&)>
+        f) const {
+  config_->withNodesConfiguration(
+      [&](const configuration::nodes::NodesConfiguration* nodes_configuration) {
+        ld_check(nodes_configuration != nullptr);
+        f(*nodes_configuration);
+      });
+}
+
 std::shared_ptr<LogsConfig> Worker::getLogsConfig() const {
   ld_check((bool)config_);
   return config_->getLogsConfig();
@@ -421,6 +439,24 @@ OverloadDetector* Worker::overloadDetector() {
   return w->overload_detector_.get();
 }
 
+Worker::LoadShedding Worker::loadShedding() const {
+  const Settings& s = settings();
+  if (!s.server) {
+    return LoadShedding::NONE;
+  }
+  const auto delay = queue_delay_.get(std::chrono::steady_clock::now());
+  auto exceeds = [delay](std::chrono::milliseconds threshold) {
+    return threshold.count() > 0 && delay > threshold;
+  };
+  if (exceeds(s.load_shedding_pause_client_reads_queue_delay)) {
+    return LoadShedding::PAUSE_CLIENT_READS;
+  }
+  if (exceeds(s.load_shedding_reject_appends_queue_delay)) {
+    return LoadShedding::REJECT_CLIENT_APPENDS;
+  }
+  return LoadShedding::NONE;
+}
+
 void Worker::onSettingsUpdated() {
   // If SettingsUpdatedRequest are posted faster than they're processed,
   // each request will pick up multiple settings updates. This would mean
@@ -437,6 +473,8 @@ void Worker::onSettingsUpdated() {
       {immutable_settings_->hi_requests_per_iteration,
        immutable_settings_->mid_requests_per_iteration,
        immutable_settings_->lo_requests_per_iteration});
+  event_loop->getTaskQueue().setAgingThreshold(
+      immutable_settings_->worker_task_aging_threshold);
   clientReadStreams().noteSettingsUpdated();
   if (logsconfig_manager_) {
     // LogsConfigManager might want to start or stop the underlying RSM if
@@ -560,6 +598,10 @@ void Worker::setupWorker() {
   cluster_state_polling_ = std::make_unique<Timer>(
       []() { getClusterState()->refreshClusterStateAsync(); });
 
+  checked_downcast<EventLoop*>(getExecutor())
+      ->getTaskQueue()
+      .setAgingThreshold(immutable_settings_->worker_task_aging_threshold);
+
   // Now that virtual calls are available (unlike in the constructor),
   // initialise `message_dispatch_'
   message_dispatch_ = createMessageDispatch();
@@ -573,6 +615,7 @@ void Worker::setupWorker() {
   initializeSubscriptions();
 
   clientReadStreams().registerForShardAuthoritativeStatusUpdates();
+  clientReadStreams().registerForClusterStateUpdates();
   if (overload_detector_) {
     overload_detector_->start();
   }
@@ -802,6 +845,47 @@ EpochRecovery* Worker::findActiveEpochRecovery(logid_t logid) const {
   return erm;
 }
 
+EpochRecovery* Worker::findActiveEpochRecovery(logid_t logid,
+                                               epoch_t epoch) const {
+  ld_check(logid != LOGID_INVALID);
+
+  auto it = runningLogRecoveries().map.find(logid);
+  if (it == runningLogRecoveries().map.end()) {
+    err = E::NOTFOUND;
+    return nullptr;
+  }
+
+  ld_check(it->second);
+  EpochRecovery* erm = it->second->getActiveEpochRecovery(epoch);
+
+  if (!erm) {
+    err = E::NOTFOUND;
+  }
+
+  return erm;
+}
+
+EpochRecovery* Worker::findDigestingEpochRecovery(logid_t logid,
+                                                  ShardID shard,
+                                                  read_stream_id_t rsid) const {
+  ld_check(logid != LOGID_INVALID);
+
+  auto it = runningLogRecoveries().map.find(logid);
+  if (it == runningLogRecoveries().map.end()) {
+    err = E::NOTFOUND;
+    return nullptr;
+  }
+
+  ld_check(it->second);
+  EpochRecovery* erm = it->second->getDigestingEpochRecovery(shard, rsid);
+
+  if (!erm) {
+    err = E::NOTFOUND;
+  }
+
+  return erm;
+}
+
 bool Worker::requestsPending() const {
   std::vector<std::string> counts;
 #define PROCESS(x, name)                                     \
@@ -913,6 +997,27 @@ void Worker::disposeOfMetaReader(std::unique_ptr<MetaDataLogReader> reader) {
   }
 }
 
+bool Worker::scheduleLogsConfigInvalidation(
+    std::chrono::milliseconds max_delay) {
+  if (shutting_down_ || !accepting_work_) {
+    return false;
+  }
+  if (logs_config_invalidation_timer_ == nullptr) {
+    logs_config_invalidation_timer_.reset(new Timer([this] {
+      int rv = getUpdateableConfig()->updateableLogsConfig()->invalidate();
+      if (rv != 0) {
+        ld_error("Config reload failed with error %s", error_description(err));
+      }
+    }));
+  }
+  if (logs_config_invalidation_timer_->isActive()) {
+    return false;
+  }
+  logs_config_invalidation_timer_->activate(std::chrono::milliseconds(
+      folly::Random::rand64(max_delay.count() + 1)));
+  return true;
+}
+
 void Worker::reportLoad() {
   if (worker_type_ != WorkerType::GENERAL) {
     // specialised workers are not meant to take normal worker load,
@@ -990,7 +1095,10 @@ void Worker::onStoppedRunning(RunContext prev_context) {
   auto end_time = currentlyRunningStart_;
   // Bumping the counters
   auto duration = end_time - start_time;
-  if (duration >= settings().request_execution_delay_threshold) {
+  auto usec =
+      std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+  const bool slow = duration >= settings().request_execution_delay_threshold;
+  if (slow) {
     RATELIMIT_WARNING(std::chrono::seconds(1),
                       2,
                       "Slow request/timer callback: %.3fs, source: %s",
@@ -1006,10 +1114,26 @@ void Worker::onStoppedRunning(RunContext prev_context) {
             std::chrono::duration_cast<std::chrono::milliseconds>(duration));
       }
     }
+
+    SlowExecution execution{prev_context,
+                            std::chrono::microseconds(usec),
+                            std::chrono::system_clock::now()};
+    auto it = std::upper_bound(
+        slowExecutions_.begin(),
+        slowExecutions_.end(),
+        execution,
+        [](const SlowExecution& a, const SlowExecution& b) {
+          return a.duration > b.duration;
+        });
+    if (it != slowExecutions_.end() ||
+        slowExecutions_.size() < MAX_SLOW_EXECUTIONS) {
+      slowExecutions_.insert(it, execution);
+      if (slowExecutions_.size() > MAX_SLOW_EXECUTIONS) {
+        slowExecutions_.pop_back();
+      }
+    }
   }
 
-  auto usec =
-      std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
   switch (prev_context.type_) {
     case RunContext::MESSAGE: {
       auto msg_type = static_cast<int>(prev_context.subtype_.message);
@@ -1017,6 +1141,12 @@ void Worker::onStoppedRunning(RunContext prev_context) {
       MESSAGE_TYPE_STAT_ADD(
           Worker::stats(), msg_type, message_worker_usec, usec);
       HISTOGRAM_ADD(Worker::stats(), message_callback_duration[msg_type], usec);
+      if (slow) {
+        MESSAGE_TYPE_STAT_INCR(
+            Worker::stats(), msg_type, message_slow_callbacks);
+        MESSAGE_TYPE_STAT_ADD(
+            Worker::stats(), msg_type, message_slow_callback_usec, usec);
+      }
       break;
     }
     case RunContext::REQUEST: {
@@ -1024,6 +1154,12 @@ void Worker::onStoppedRunning(RunContext prev_context) {
       ld_check(rqtype < static_cast<int>(RequestType::MAX));
       REQUEST_TYPE_STAT_ADD(Worker::stats(), rqtype, request_worker_usec, usec);
       HISTOGRAM_ADD(Worker::stats(), request_execution_duration[rqtype], usec);
+      if (slow) {
+        REQUEST_TYPE_STAT_INCR(
+            Worker::stats(), rqtype, request_slow_executions);
+        REQUEST_TYPE_STAT_ADD(
+            Worker::stats(), rqtype, request_slow_execution_usec, usec);
+      }
       break;
     }
     case RunContext::STORAGE_TASK_RESPONSE: {
@@ -1042,6 +1178,14 @@ void Worker::onStoppedRunning(RunContext prev_context) {
           Worker::stats(),
           request_execution_duration[static_cast<int>(RequestType::INVALID)],
           usec);
+      if (slow) {
+        REQUEST_TYPE_STAT_INCR(
+            Worker::stats(), RequestType::INVALID, request_slow_executions);
+        REQUEST_TYPE_STAT_ADD(Worker::stats(),
+                              RequestType::INVALID,
+                              request_slow_execution_usec,
+                              usec);
+      }
       break;
     }
   }
@@ -1140,6 +1284,14 @@ TrimRequestMap& Worker::runningTrimRequests() const {
   return impl_->runningTrimRequests_;
 }
 
+TrimBatcher& Worker::trimBatcher() const {
+  // Created lazily since its timer has to be created on the worker thread.
+  if (!impl_->trimBatcher_) {
+    impl_->trimBatcher_ = std::make_unique<TrimBatcher>();
+  }
+  return *impl_->trimBatcher_;
+}
+
 GetTrimPointRequestMap& Worker::runningGetTrimPoint() const {
   return impl_->runningGetTrimPoint_;
 }
@@ -1180,10 +1332,26 @@ AppenderMap& Worker::activeAppenders() const {
   return impl_->activeAppenders_;
 }
 
+StoreBatcher& Worker::storeBatcher() const {
+  // Created lazily since its timer has to be created on the worker thread.
+  if (!impl_->storeBatcher_) {
+    impl_->storeBatcher_ = std::make_unique<StoreBatcher>();
+  }
+  return *impl_->storeBatcher_;
+}
+
 AppendRequestMap& Worker::runningAppends() const {
   return impl_->runningAppends_;
 }
 
+AppendBatcher& Worker::appendBatcher() const {
+  // Created lazily since its timer has to be created on the worker thread.
+  if (!impl_->appendBatcher_) {
+    impl_->appendBatcher_ = std::make_unique<AppendBatcher>();
+  }
+  return *impl_->appendBatcher_;
+}
+
 CheckSealRequestMap& Worker::runningCheckSeals() const {
   return impl_->runningCheckSeals_;
 }
@@ -1357,8 +1525,7 @@ int Worker::tryPost(std::unique_ptr<Request>& req) {
     return -1;
   }
 
-  if (num_requests_enqueued_.load(std::memory_order_relaxed) >
-      updateable_settings_->worker_request_pipe_capacity) {
+  if (requestQueueFull()) {
     err = E::NOBUFS;
     return -1;
   }
@@ -1385,39 +1552,42 @@ void Worker::addWithPriority(folly::Func func, int8_t priority) {
       break;
   }
 
+  WorkContext::addWithPriority(wrapWork(std::move(func), priority), priority);
+}
+
+folly::Func Worker::wrapWork(folly::Func func, int8_t priority) {
   num_requests_enqueued_.fetch_add(1, std::memory_order_relaxed);
-  WorkContext::addWithPriority(
-      [this,
-       func = std::move(func),
-       priority,
-       enqueue_time = std::chrono::steady_clock::now()]() mutable {
-        WorkerContextScopeGuard g(this);
-        num_requests_enqueued_.fetch_sub(1, std::memory_order_relaxed);
-
-        const auto queue_time =
-            std::chrono::duration_cast<std::chrono::microseconds>(
-                std::chrono::steady_clock::now() - enqueue_time);
-
-        HISTOGRAM_ADD(stats_, requests_queue_latency, queue_time.count());
-        switch (priority) {
-          case folly::Executor::HI_PRI:
-            HISTOGRAM_ADD(stats_, hi_pri_requests_latency, queue_time.count());
-            STAT_INCR(processor_->stats_, worker_executed_hi_pri_work);
-            break;
-          case folly::Executor::MID_PRI:
-            HISTOGRAM_ADD(stats_, mid_pri_requests_latency, queue_time.count());
-            STAT_INCR(processor_->stats_, worker_executed_mid_pri_work);
-            break;
-          case folly::Executor::LO_PRI:
-            HISTOGRAM_ADD(stats_, lo_pri_requests_latency, queue_time.count());
-            STAT_INCR(processor_->stats_, worker_executed_lo_pri_work);
-            break;
-          default:
-            break;
-        }
-        func();
-      },
-      priority);
+  return [this,
+          func = std::move(func),
+          priority,
+          enqueue_time = std::chrono::steady_clock::now()]() mutable {
+    WorkerContextScopeGuard g(this);
+    num_requests_enqueued_.fetch_sub(1, std::memory_order_relaxed);
+
+    const auto queue_time =
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - enqueue_time);
+
+    HISTOGRAM_ADD(stats_, requests_queue_latency, queue_time.count());
+    queue_delay_.add(queue_time, std::chrono::steady_clock::now());
+    switch (priority) {
+      case folly::Executor::HI_PRI:
+        HISTOGRAM_ADD(stats_, hi_pri_requests_latency, queue_time.count());
+        STAT_INCR(processor_->stats_, worker_executed_hi_pri_work);
+        break;
+      case folly::Executor::MID_PRI:
+        HISTOGRAM_ADD(stats_, mid_pri_requests_latency, queue_time.count());
+        STAT_INCR(processor_->stats_, worker_executed_mid_pri_work);
+        break;
+      case folly::Executor::LO_PRI:
+        HISTOGRAM_ADD(stats_, lo_pri_requests_latency, queue_time.count());
+        STAT_INCR(processor_->stats_, worker_executed_lo_pri_work);
+        break;
+      default:
+        break;
+    }
+    func();
+  };
 }
 
 int Worker::forcePost(std::unique_ptr<Request>& req) {
@@ -1441,6 +1611,73 @@ int Worker::forcePost(std::unique_ptr<Request>& req) {
   return 0;
 }
 
+int Worker::forcePostBatch(std::vector<std::unique_ptr<Request>>& reqs) {
+  if (shutting_down_) {
+    err = E::SHUTDOWN;
+    return -1;
+  }
+  for (const auto& req : reqs) {
+    if (!req) {
+      err = E::INVALID_PARAM;
+      return -1;
+    }
+  }
+
+  // Requests of different priorities go to different queues anyway, so
+  // only the order within a priority is preserved, as with forcePost().
+  std::vector<std::pair<int8_t, std::vector<folly::Func>>> batches;
+  for (auto& req : reqs) {
+    req->enqueue_time_ = std::chrono::steady_clock::now();
+    const int8_t priority = req->getExecutorPriority();
+    auto it = std::find_if(batches.begin(),
+                           batches.end(),
+                           [&](const auto& b) { return b.first == priority; });
+    if (it == batches.end()) {
+      batches.emplace_back(priority, std::vector<folly::Func>());
+      it = batches.end() - 1;
+    }
+    it->second.push_back(wrapWork(
+        [rq = std::move(req), this]() mutable {
+          processRequest(std::move(rq));
+        },
+        priority));
+  }
+
+  EventLoop* ev = checked_downcast<EventLoop*>(getExecutor());
+  for (auto& batch : batches) {
+    switch (batch.first) {
+      case folly::Executor::HI_PRI:
+        STAT_ADD(processor_->stats_,
+                 worker_enqueued_hi_pri_work,
+                 batch.second.size());
+        break;
+      case folly::Executor::MID_PRI:
+        STAT_ADD(processor_->stats_,
+                 worker_enqueued_mid_pri_work,
+                 batch.second.size());
+        break;
+      case folly::Executor::LO_PRI:
+        STAT_ADD(processor_->stats_,
+                 worker_enqueued_lo_pri_work,
+                 batch.second.size());
+        break;
+      default:
+        break;
+    }
+    // Like forcePost(), this relies on the event loop being alive for as long
+    // as the worker isn't shutting down.
+    int rv = ev->addBatchWithPriority(std::move(batch.second), batch.first);
+    ld_check(rv == 0);
+  }
+
+  return 0;
+}
+
+bool Worker::requestQueueFull() const {
+  return num_requests_enqueued_.load(std::memory_order_relaxed) >
+      updateable_settings_->worker_request_pipe_capacity;
+}
+
 void Worker::generateErrorInjection(double error_chance,
                                     std::chrono::milliseconds sleep_duration) {
   if (UNLIKELY(worker_type_ == WorkerType::GENERAL && error_chance > 0 &&
@@ -28,6 +28,7 @@
 #include "logdevice/common/ClientID.h"
 #include "logdevice/common/EventLoop.h"
 #include "logdevice/common/ExponentialBackoffTimer.h"
+#include "logdevice/common/QueueDelayTracker.h"
 #include "logdevice/common/RecordID.h"
 #include "logdevice/common/RunContext.h"
 #include "logdevice/common/ThreadID.h"
@@ -111,6 +112,7 @@ namespace facebook { namespace logdevice {
  *       pass the requests to a Worker.
  */
 
+class AppendBatcher;
 class AppenderBuffer;
 class BufferedWriterShard;
 class ClusterState;
@@ -136,8 +138,10 @@ class ShapingContainer;
 class ShardAuthoritativeStatusManager;
 class SocketCallback;
 class StatsHolder;
+class StoreBatcher;
 class SyncSequencerRequestList;
 class TraceLogger;
+class TrimBatcher;
 class UpdateableConfig;
 class WorkerImpl;
 class WorkerTimeoutStats;
@@ -274,6 +278,15 @@ class Worker : public WorkContext {
   std::shared_ptr<const configuration::nodes::NodesConfiguration>
   getNodesConfiguration() const;
 
+  /**
+   * Calls `f` with the NodesConfiguration of this worker. Cheaper than
+   * getNodesConfiguration() when it's only needed during the call, as it
+   * doesn't take a reference to it; `f` must not keep it.
+   */
+  void withNodesConfiguration(
+      folly::FunctionRef<void(const configuration::nodes::NodesConfiguration&)>
+          f) const;
+
   /**
    * @return logs configuration object cached on this Worker and
    *         auto updated
@@ -418,6 +431,10 @@ class Worker : public WorkContext {
   // a map of all currently running TrimRequests
   TrimRequestMap& runningTrimRequests() const;
 
+  // coalesces TRIMs of TrimRequests running on this worker, created on first
+  // use
+  TrimBatcher& trimBatcher() const;
+
   // a map of all currently running GetTrimPointRequest
   GetTrimPointRequestMap& runningGetTrimPoint() const;
 
@@ -454,6 +471,10 @@ class Worker : public WorkContext {
   // a map of all currently running AppendRequests
   AppendRequestMap& runningAppends() const;
 
+  // coalesces APPENDs of AppendRequests running on this worker, created on
+  // first use
+  AppendBatcher& appendBatcher() const;
+
   // a map of all currently running CheckSealRequest
   CheckSealRequestMap& runningCheckSeals() const;
   ShapingContainer& readShapingContainer() const;
@@ -466,6 +487,10 @@ class Worker : public WorkContext {
   // a map of all currently active Appenders created by this Worker
   AppenderMap& activeAppenders() const;
 
+  // coalesces STOREs of Appenders running on this worker, created on first
+  // use
+  StoreBatcher& storeBatcher() const;
+
   // a map of all currently running GetLogInfoRequests
   GetLogInfoRequestMaps& runningGetLogInfo() const;
 
@@ -525,6 +550,19 @@ class Worker : public WorkContext {
 
   static OverloadDetector* overloadDetector();
 
+  // How much client load a server worker should shed, based on how long work
+  // recently waited in its queues. Levels are cumulative.
+  enum class LoadShedding {
+    NONE,
+    // Over --load-shedding-reject-appends-queue-delay: reject APPENDs from
+    // clients with E::OVERLOADED.
+    REJECT_CLIENT_APPENDS,
+    // Over --load-shedding-pause-client-reads-queue-delay: also stop reading
+    // from client connections.
+    PAUSE_CLIENT_READS,
+  };
+  LoadShedding loadShedding() const;
+
   // EventLogStateMachine only exists on Worker 0 of a server. It provides an
   // interface for listening to updates arriving on the event log.
   EventLogStateMachine* event_log_{nullptr};
@@ -639,6 +677,22 @@ class Worker : public WorkContext {
    */
   EpochRecovery* findActiveEpochRecovery(logid_t logid) const;
 
+  /**
+   * Same as above, but returns the active EpochRecovery machine for
+   * @param epoch, which may be building its digest ahead of the oldest
+   * recovering epoch of the log.
+   */
+  EpochRecovery* findActiveEpochRecovery(logid_t logid, epoch_t epoch) const;
+
+  /**
+   * @return the active EpochRecovery machine of @param logid reading its
+   *         digest from @param shard through read stream @param rsid, or
+   *         nullptr if there is none.
+   */
+  EpochRecovery* findDigestingEpochRecovery(logid_t logid,
+                                            ShardID shard,
+                                            read_stream_id_t rsid) const;
+
   /**
    * A utility method to register a new ExponentialBackoffTimer with this
    * Worker. The newly created timer is owned by this Worker and is destroyed
@@ -669,6 +723,17 @@ class Worker : public WorkContext {
    */
   void disposeOfMetaReader(std::unique_ptr<MetaDataLogReader> reader);
 
+  /**
+   * Invalidates the logs config after a random delay of up to max_delay.
+   * Calls made while an invalidation is already scheduled are coalesced into
+   * it. Used by clients with a remote logs config so that a config change
+   * doesn't make all of them re-fetch log groups at the same time.
+   *
+   * @return  true if a new invalidation was scheduled, false if the call was
+   *          coalesced into a pending one.
+   */
+  bool scheduleLogsConfigInvalidation(std::chrono::milliseconds max_delay);
+
   EventLogStateMachine* getEventLogStateMachine();
 
   /**
@@ -702,6 +767,18 @@ class Worker : public WorkContext {
   // Time when currentlyRunning_ was set
   std::chrono::steady_clock::time_point currentlyRunningStart_;
 
+  struct SlowExecution {
+    RunContext context;
+    std::chrono::microseconds duration;
+    std::chrono::system_clock::time_point end_time;
+  };
+  static constexpr size_t MAX_SLOW_EXECUTIONS = 16;
+
+  // The longest request / message callback executions on this worker that
+  // took longer than request-exec-threshold, longest first. Shown and
+  // cleared by the "info slow_executions" admin command.
+  std::vector<SlowExecution> slowExecutions_;
+
   // This should be called whenever the ServerConfig  has been updated.
   // Has to be called from the worker thread
   virtual void onServerConfigUpdated();
@@ -789,6 +866,23 @@ class Worker : public WorkContext {
    */
   int forcePost(std::unique_ptr<Request>& req);
 
+  /**
+   * Same as forcePost() for several requests at once, see
+   * Processor::postRequestBatch(). Requests are queued in order and the
+   * worker is woken up at most once per priority.
+   *
+   * @return 0 if all requests were posted, in which case all of `reqs` are
+   *         moved out. Otherwise -1 with err set to E::SHUTDOWN, and `reqs`
+   *         is left untouched.
+   */
+  int forcePostBatch(std::vector<std::unique_ptr<Request>>& reqs);
+
+  /**
+   * @return true if tryPost() would fail with E::NOBUFS because the number of
+   *         enqueued requests exceeds --worker-request-pipe-capacity.
+   */
+  bool requestQueueFull() const;
+
   virtual void setupWorker();
   // Callback functions that register worker id and duration of slow/delayed
   // action.
@@ -822,6 +916,11 @@ class Worker : public WorkContext {
 
   void disableSequencersDueIsolationTimeout();
 
+  // Wraps `func` to run in the context of this worker and account for queue
+  // latency. Counts it as enqueued, used by addWithPriority() and
+  // forcePostBatch().
+  folly::Func wrapWork(folly::Func func, int8_t priority);
+
   // Initializes subscriptions to config and setting updates
   void initializeSubscriptions();
 
@@ -905,6 +1004,9 @@ class Worker : public WorkContext {
   // finished MetaDataLogReader objects to be disposed
   std::queue<std::unique_ptr<MetaDataLogReader>> finished_meta_readers_;
 
+  // fires the invalidation scheduled by scheduleLogsConfigInvalidation()
+  std::unique_ptr<Timer> logs_config_invalidation_timer_;
+
   // List of timers associated with this Worker object. Owned by Worker so
   // that they're destroyed when the worker thread is shutting down. Note that
   // ExponentialBackoffTimerNode objects are not owned by this list (it's an
@@ -931,6 +1033,9 @@ class Worker : public WorkContext {
   // Used to return NOBUFS when count goes above worker_request_pipe_capacity.
   std::atomic<size_t> num_requests_enqueued_{0};
 
+  // Queueing delay of recently executed work, see loadShedding().
+  QueueDelayTracker queue_delay_;
+
   // Stop on EventLogStateMachine should only be called once.
   // Set to true once stop has been called
   bool event_log_stopped_{false};
@@ -126,6 +126,18 @@ void WorkerTimeoutStats::clear() {
   lookup_table_.clear();
 }
 
+void WorkerTimeoutStats::addHedgeCredit(double budget) {
+  hedge_credits_ = std::min(kMaxHedgeCredits, hedge_credits_ + budget);
+}
+
+bool WorkerTimeoutStats::tryTakeHedgeCredit() {
+  if (hedge_credits_ < 1) {
+    return false;
+  }
+  hedge_credits_ -= 1;
+  return true;
+}
+
 uint64_t WorkerTimeoutStats::getMinSamplesPerBucket() const {
   return Worker::settings().store_histogram_min_samples_per_bucket;
 }
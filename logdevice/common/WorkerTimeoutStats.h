@@ -58,6 +58,13 @@ class WorkerTimeoutStats {
 
   void clear();
 
+  // Budget for hedged STORE waves, see Settings::hedged_store_budget. Every
+  // wave sent adds `budget` credits, up to kMaxHedgeCredits, and every hedged
+  // wave takes one.
+  void addHedgeCredit(double budget);
+  // @return  true if a credit was taken, false if the budget is used up.
+  bool tryTakeHedgeCredit();
+
   folly::Optional<std::array<Latency, WorkerTimeoutStats::kQuantiles.size()>>
   getEstimations(Levels level,
                  int node = -1,
@@ -76,6 +83,10 @@ class WorkerTimeoutStats {
       lookup_table_;
 
   std::list<std::pair<MessageKey, Timepoint>> outgoing_messages_;
+
+  // Caps how many hedged waves can be sent in a burst.
+  static constexpr double kMaxHedgeCredits = 10;
+  double hedge_credits_{0};
 };
 
 }} // namespace facebook::logdevice
@@ -17,6 +17,7 @@
 
 #include "logdevice/common/Checksum.h"
 #include "logdevice/common/buffered_writer/BufferedWriteDecoderImpl.h"
+#include "logdevice/common/buffered_writer/ZstdDictionaryRegistry.h"
 #include "logdevice/common/debug.h"
 #include "logdevice/include/types.h"
 
@@ -44,10 +45,12 @@ void BufferedWriteSinglePayloadsCodec::Encoder::append(
   }
 }
 
-void BufferedWriteSinglePayloadsCodec::Encoder::encode(folly::IOBufQueue& out,
-                                                       Compression& compression,
-                                                       int zstd_level) {
-  bool compressed = compress(compression, zstd_level);
+void BufferedWriteSinglePayloadsCodec::Encoder::encode(
+    folly::IOBufQueue& out,
+    Compression& compression,
+    int zstd_level,
+    uint32_t zstd_dictionary_id) {
+  bool compressed = compress(compression, zstd_level, zstd_dictionary_id);
   if (!compressed) {
     compression = Compression::NONE;
   }
@@ -56,7 +59,8 @@ void BufferedWriteSinglePayloadsCodec::Encoder::encode(folly::IOBufQueue& out,
 
 bool BufferedWriteSinglePayloadsCodec::Encoder::compress(
     Compression compression,
-    int zstd_level) {
+    int zstd_level,
+    uint32_t zstd_dictionary_id) {
   if (compression == Compression::NONE) {
     // Nothing to do.
     return true;
@@ -88,11 +92,35 @@ bool BufferedWriteSinglePayloadsCodec::Encoder::compress(
   size_t compressed_size;
   if (compression == Compression::ZSTD) {
     ld_check(zstd_level > 0);
-    compressed_size = ZSTD_compress(out,              // dst
-                                    end - out,        // dstCapacity
-                                    to_compress.data, // src
-                                    to_compress.size, // srcSize
-                                    zstd_level);      // level
+    std::shared_ptr<const ZSTD_CDict> cdict;
+    if (zstd_dictionary_id != 0) {
+      cdict = ZstdDictionaryRegistry::get().getCDict(
+          zstd_dictionary_id, zstd_level);
+      if (!cdict) {
+        RATELIMIT_WARNING(std::chrono::seconds(10),
+                          1,
+                          "ZSTD dictionary %u is not registered, compressing "
+                          "without it",
+                          zstd_dictionary_id);
+      }
+    }
+    if (cdict) {
+      // The frame header records the dictionary ID for the decoder.
+      thread_local std::unique_ptr<ZSTD_CCtx, size_t (*)(ZSTD_CCtx*)> cctx(
+          ZSTD_createCCtx(), ZSTD_freeCCtx);
+      compressed_size = ZSTD_compress_usingCDict(cctx.get(),
+                                                 out,
+                                                 end - out,
+                                                 to_compress.data,
+                                                 to_compress.size,
+                                                 cdict.get());
+    } else {
+      compressed_size = ZSTD_compress(out,              // dst
+                                      end - out,        // dstCapacity
+                                      to_compress.data, // src
+                                      to_compress.size, // srcSize
+                                      zstd_level);      // level
+    }
     if (ZSTD_isError(compressed_size)) {
       ld_critical(
           "ZSTD_compress() failed: %s", ZSTD_getErrorName(compressed_size));
@@ -172,10 +200,34 @@ folly::Optional<folly::IOBuf> uncompress(const Slice& slice,
       ld_check(false);
       return folly::none;
     case Compression::ZSTD: {
-      size_t rv = ZSTD_decompress(out.writableTail(), // dst
-                                  uncompressed_size,  // dstCapacity
-                                  ptr,                // src
-                                  end - ptr);         // compressedSize
+      size_t rv;
+      // Non-zero if the batch was compressed with a dictionary, see
+      // ZstdDictionaryRegistry.
+      const unsigned dict_id = ZSTD_getDictID_fromFrame(ptr, end - ptr);
+      if (dict_id != 0) {
+        auto ddict = ZstdDictionaryRegistry::get().getDDict(dict_id);
+        if (!ddict) {
+          RATELIMIT_ERROR(std::chrono::seconds(1),
+                          1,
+                          "Batch is compressed with ZSTD dictionary %u which "
+                          "is not registered",
+                          dict_id);
+          return folly::none;
+        }
+        thread_local std::unique_ptr<ZSTD_DCtx, size_t (*)(ZSTD_DCtx*)> dctx(
+            ZSTD_createDCtx(), ZSTD_freeDCtx);
+        rv = ZSTD_decompress_usingDDict(dctx.get(),
+                                        out.writableTail(),
+                                        uncompressed_size,
+                                        ptr,
+                                        end - ptr,
+                                        ddict.get());
+      } else {
+        rv = ZSTD_decompress(out.writableTail(), // dst
+                             uncompressed_size,  // dstCapacity
+                             ptr,                // src
+                             end - ptr);         // compressedSize
+      }
       if (ZSTD_isError(rv)) {
         RATELIMIT_ERROR(std::chrono::seconds(1),
                         1,
@@ -364,7 +416,8 @@ template <typename PayloadsEncoder>
 void BufferedWriteCodec::Encoder<PayloadsEncoder>::encode(
     folly::IOBufQueue& out,
     Compression compression,
-    int zstd_level) {
+    int zstd_level,
+    uint32_t zstd_dictionary_id) {
   folly::IOBufQueue queue;
   if constexpr (std::is_same_v<PayloadsEncoder, PayloadGroupCodec::Encoder>) {
     // Make sure there's headroom reserved
@@ -375,7 +428,13 @@ void BufferedWriteCodec::Encoder<PayloadsEncoder>::encode(
     queue.append(std::move(iobuf));
   }
 
-  payloads_encoder_.encode(queue, compression, zstd_level);
+  if constexpr (std::is_same_v<PayloadsEncoder, PayloadGroupCodec::Encoder>) {
+    // Dictionaries are only supported for single payloads.
+    payloads_encoder_.encode(queue, compression, zstd_level);
+  } else {
+    payloads_encoder_.encode(
+        queue, compression, zstd_level, zstd_dictionary_id);
+  }
 
   auto blob = queue.move();
   if constexpr (std::is_same_v<PayloadsEncoder, PayloadGroupCodec::Encoder>) {
@@ -645,7 +704,8 @@ void convert(std::vector<folly::IOBuf>&& payloads,
 FOLLY_NODISCARD
 size_t BufferedWriteCodec::decode(Slice binary,
                                   std::vector<PayloadGroup>& payload_groups_out,
-                                  bool allow_buffer_sharing) {
+                                  bool allow_buffer_sharing,
+                                  const std::unordered_set<PayloadKey>* keys) {
   BufferedWriteDecoderImpl::flags_t flags;
   Format format;
   size_t batch_size;
@@ -667,12 +727,17 @@ size_t BufferedWriteCodec::decode(Slice binary,
       if (bytes_decoded == 0) {
         return 0;
       }
-      convert(std::move(payloads), payload_groups_out);
+      if (keys != nullptr && keys->count(0) == 0) {
+        // Payloads aren't stored separately, so they were all decoded anyway.
+        payload_groups_out.resize(payload_groups_out.size() + payloads.size());
+      } else {
+        convert(std::move(payloads), payload_groups_out);
+      }
       return header_size + bytes_decoded;
     }
     case Format::PAYLOAD_GROUPS: {
       const size_t bytes_decoded = PayloadGroupCodec::decode(
-          binary, payload_groups_out, allow_buffer_sharing);
+          binary, payload_groups_out, allow_buffer_sharing, keys);
       if (bytes_decoded == 0) {
         return 0;
       }
@@ -39,14 +39,19 @@ class BufferedWriteSinglePayloadsCodec {
      */
     void encode(folly::IOBufQueue& out,
                 Compression& compression,
-                int zstd_level = 0);
+                int zstd_level = 0,
+                uint32_t zstd_dictionary_id = 0);
 
    private:
     /**
      * Replaces blob with compressed blob if compression saves some space and
      * returns true. Otherwise leaves blob as is and returns false.
+     * zstd_dictionary_id, if non-zero, is a dictionary from
+     * ZstdDictionaryRegistry to compress with.
      */
-    bool compress(Compression compression, int zstd_level);
+    bool compress(Compression compression,
+                  int zstd_level,
+                  uint32_t zstd_dictionary_id);
 
     // Payloads are appended to the blob_ using appender_ */
     folly::IOBuf blob_;
@@ -109,10 +114,14 @@ class BufferedWriteCodec {
      * encoded payloads.
      * Encoder must not be re-used after calling this.
      * zstd_level must be specified if ZSTD compression is used.
+     * zstd_dictionary_id, if non-zero, is a dictionary from
+     * ZstdDictionaryRegistry to compress with. Only used for the
+     * SINGLE_PAYLOADS format.
      */
     void encode(folly::IOBufQueue& out,
                 Compression compression,
-                int zstd_level = 0);
+                int zstd_level = 0,
+                uint32_t zstd_dictionary_id = 0);
 
    private:
     /** Writes header (checksum, flags, etc) to the blob's headroom */
@@ -189,12 +198,15 @@ class BufferedWriteCodec {
    * Decodes payloads stored in batch.
    * Resulting payloads can optionally share data with input (for example in
    * case it's uncompressed).
+   * If keys is not null, only payloads with these keys are decoded (see
+   * PayloadGroupCodec::decode()). Single payloads have key 0.
    * Returns number of bytes consumed, or 0 if decoding fails.
    */
   FOLLY_NODISCARD
   static size_t decode(Slice binary,
                        std::vector<PayloadGroup>& payload_groups_out,
-                       bool allow_buffer_sharing);
+                       bool allow_buffer_sharing,
+                       const std::unordered_set<PayloadKey>* keys = nullptr);
 
   /**
    * Decodes payload groups without uncompressing them. This requires payloads
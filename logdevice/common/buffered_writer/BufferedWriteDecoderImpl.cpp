@@ -12,6 +12,7 @@
 
 #include <folly/Overload.h>
 #include <folly/Varint.h>
+#include <folly/futures/Future.h>
 
 #include "logdevice/common/DataRecordOwnsPayload.h"
 #include "logdevice/common/buffered_writer/BufferedWriteCodec.h"
@@ -21,6 +22,52 @@ namespace facebook { namespace logdevice {
 
 using Compression = BufferedWriter::Options::Compression;
 
+namespace {
+/**
+ * Gets IOBuf from the record to allow IOBuf sharing. If record is backed by
+ * IOBuf, then that IOBuf is returned. Otherwise just wraps payload in IOBuf.
+ */
+folly::IOBuf getIOBuf(const DataRecord& record) {
+  auto record_owns_payload =
+      dynamic_cast<const DataRecordOwnsPayload*>(&record);
+  if (record_owns_payload != nullptr) {
+    const folly::IOBuf* iobuf =
+        std::visit(folly::overload(
+                       [&](const PayloadHolder& payload_holder) {
+                         return &payload_holder.iobuf();
+                       },
+                       [](const std::shared_ptr<BufferedWriteDecoder>&)
+                           -> const folly::IOBuf* { return nullptr; }),
+                   record_owns_payload->owner_);
+    if (iobuf != nullptr) {
+      return *iobuf;
+    }
+  }
+  return folly::IOBuf::wrapBufferAsValue(
+      record.payload.data(), record.payload.size());
+}
+
+/**
+ * If `iobuf` doesn't manage its data and points into the data of `owner`,
+ * makes it share the buffer of `owner`. Otherwise, if it doesn't manage its
+ * data, copies the data.
+ */
+void shareBuffer(folly::IOBuf& iobuf, const folly::IOBuf& owner) {
+  if (iobuf.isManaged()) {
+    return;
+  }
+  if (!iobuf.isChained() && !owner.isChained() && owner.isManagedOne() &&
+      iobuf.data() >= owner.data() && iobuf.tail() <= owner.tail()) {
+    folly::IOBuf shared = owner.cloneOneAsValue();
+    shared.trimStart(iobuf.data() - owner.data());
+    shared.trimEnd(owner.tail() - iobuf.tail());
+    iobuf = std::move(shared);
+    return;
+  }
+  iobuf.makeManaged();
+}
+} // namespace
+
 int BufferedWriteDecoderImpl::decode(
     std::vector<std::unique_ptr<DataRecord>>&& records,
     std::vector<Payload>& payloads_out) {
@@ -65,16 +112,71 @@ int BufferedWriteDecoderImpl::decodeOne(std::unique_ptr<DataRecord>&& record,
 int BufferedWriteDecoderImpl::decodeOne(
     std::unique_ptr<DataRecord>&& record,
     std::vector<PayloadGroup>& payload_groups_out) {
-  // TODO this can be switched to using IOBuf, taken from the record (after
-  // casting to DataRecordOwnsPayload) and allow buffer sharing to avoid copying
-  // buffer
-  Slice slice(record->payload);
-  return decodeOne(slice,
-                   payload_groups_out,
-                   std::move(record),
-                   /* allow_buffer_sharing */ false);
+  return decodeOne(std::move(record), payload_groups_out, nullptr);
+}
+
+int BufferedWriteDecoderImpl::decodeOne(
+    std::unique_ptr<DataRecord>&& record,
+    std::vector<PayloadGroup>& payload_groups_out,
+    const std::unordered_set<PayloadKey>* keys) {
+  // For the memory ownership transfer to work as intended, `recordptr'
+  // needs to be a DataRecordOwnsPayload under the hood.
+  ld_assert(dynamic_cast<DataRecordOwnsPayload*>(record.get()) != nullptr);
+
+  // Payloads of uncompressed batches are decoded pointing into the record.
+  // Instead of copying them, make them share the record's IOBuf, so that
+  // they stay valid after the record and this decoder are gone. This doesn't
+  // touch the state of the decoder, which allows decoding records in
+  // parallel.
+  const folly::IOBuf owner = getIOBuf(*record);
+  const size_t start_index = payload_groups_out.size();
+  if (decodeOne(Slice(record->payload),
+                payload_groups_out,
+                nullptr,
+                /* allow_buffer_sharing */ true,
+                keys) != 0) {
+    return -1;
+  }
+  for (auto it = payload_groups_out.begin() + start_index;
+       it != payload_groups_out.end();
+       ++it) {
+    for (auto& [key, iobuf] : *it) {
+      shareBuffer(iobuf, owner);
+    }
+  }
+  record.reset();
+  return 0;
 };
 
+int BufferedWriteDecoderImpl::decode(
+    std::vector<std::unique_ptr<DataRecord>>&& records,
+    std::vector<PayloadGroup>& payload_groups_out,
+    folly::Executor& executor) {
+  // Decode each record into its own vector, then append them in the order
+  // of `records`, so that the order of payloads is the same as with
+  // decode().
+  std::vector<std::vector<PayloadGroup>> decoded(records.size());
+  std::vector<folly::Future<int>> futures;
+  futures.reserve(records.size());
+  for (size_t i = 0; i < records.size(); ++i) {
+    futures.push_back(folly::via(&executor, [&, i] {
+      return decodeOne(std::move(records[i]), decoded[i]);
+    }));
+  }
+  int rv = 0;
+  auto results = folly::collectAll(futures).get();
+  for (size_t i = 0; i < records.size(); ++i) {
+    if (!results[i].hasValue() || results[i].value() != 0) {
+      rv = -1;
+      continue;
+    }
+    payload_groups_out.insert(payload_groups_out.end(),
+                              std::make_move_iterator(decoded[i].begin()),
+                              std::make_move_iterator(decoded[i].end()));
+  }
+  return rv;
+}
+
 int BufferedWriteDecoderImpl::decodeOne(const DataRecord& record,
                                         std::vector<Payload>& payloads_out) {
   return decodeOne(Slice(record.payload),
@@ -143,7 +245,8 @@ int BufferedWriteDecoderImpl::decodeOne(
     Slice blob,
     std::vector<PayloadGroup>& payload_groups_out,
     std::unique_ptr<DataRecord>&& record,
-    bool allow_buffer_sharing) {
+    bool allow_buffer_sharing,
+    const std::unordered_set<PayloadKey>* keys) {
   if (record) {
     // For the memory ownership transfer to work as intended, `recordptr'
     // needs to be a DataRecordOwnsPayload under the hood.
@@ -152,7 +255,7 @@ int BufferedWriteDecoderImpl::decodeOne(
 
   const size_t start_index = payload_groups_out.size();
   size_t bytes_decoded = BufferedWriteCodec::decode(
-      blob, payload_groups_out, allow_buffer_sharing);
+      blob, payload_groups_out, allow_buffer_sharing, keys);
   if (bytes_decoded == 0) {
     return -1;
   }
@@ -177,32 +280,6 @@ int BufferedWriteDecoderImpl::decodeOne(
   return 0;
 }
 
-namespace {
-/**
- * Gets IOBuf from the record to allow IOBuf sharing. If record is backed by
- * IOBuf, then that IOBuf is returned. Otherwise just wraps payload in IOBuf.
- */
-folly::IOBuf getIOBuf(const DataRecord& record) {
-  auto record_owns_payload =
-      dynamic_cast<const DataRecordOwnsPayload*>(&record);
-  if (record_owns_payload != nullptr) {
-    const folly::IOBuf* iobuf =
-        std::visit(folly::overload(
-                       [&](const PayloadHolder& payload_holder) {
-                         return &payload_holder.iobuf();
-                       },
-                       [](const std::shared_ptr<BufferedWriteDecoder>&)
-                           -> const folly::IOBuf* { return nullptr; }),
-                   record_owns_payload->owner_);
-    if (iobuf != nullptr) {
-      return *iobuf;
-    }
-  }
-  return folly::IOBuf::wrapBufferAsValue(
-      record.payload.data(), record.payload.size());
-}
-} // namespace
-
 int BufferedWriteDecoderImpl::decodeOneCompressed(
     std::unique_ptr<DataRecord>&& record,
     CompressedPayloadGroups& compressed_payload_groups_out) {
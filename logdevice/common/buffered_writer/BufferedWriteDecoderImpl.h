@@ -9,6 +9,7 @@
 
 #include <deque>
 #include <memory>
+#include <unordered_set>
 #include <vector>
 
 #include <folly/FBVector.h>
@@ -38,6 +39,9 @@ class BufferedWriteDecoderImpl : public BufferedWriteDecoder {
              std::vector<Payload>& payloads_out);
   int decode(std::vector<std::unique_ptr<DataRecord>>&& records,
              std::vector<PayloadGroup>& payload_groups_out);
+  int decode(std::vector<std::unique_ptr<DataRecord>>&& records,
+             std::vector<PayloadGroup>& payload_groups_out,
+             folly::Executor& executor);
   // Decodes a single DataRecord.  Claims ownership of the DataRecord if
   // successful.  Allowed to partially fill `payloads_out' in case of failed
   // decoding.  If necessary, caller will ensure atomicity in appending to the
@@ -46,6 +50,10 @@ class BufferedWriteDecoderImpl : public BufferedWriteDecoder {
                 std::vector<Payload>& payloads_out);
   int decodeOne(std::unique_ptr<DataRecord>&& record,
                 std::vector<PayloadGroup>& payload_groups_out);
+  // Only decodes payloads with the given keys, if keys is not null.
+  int decodeOne(std::unique_ptr<DataRecord>&& record,
+                std::vector<PayloadGroup>& payload_groups_out,
+                const std::unordered_set<PayloadKey>* keys);
   // Variant that does not consume the input DataRecord.  Instead, the blob is
   // copied if uncompressed.  This is useful when the caller cannot afford to
   // unconditionally relinquish ownership of the DataRecord.
@@ -71,7 +79,8 @@ class BufferedWriteDecoderImpl : public BufferedWriteDecoder {
   int decodeOne(Slice blob,
                 std::vector<PayloadGroup>& payload_groups_out,
                 std::unique_ptr<DataRecord>&& record,
-                bool allow_buffer_sharing);
+                bool allow_buffer_sharing,
+                const std::unordered_set<PayloadKey>* keys = nullptr);
 
   template <typename T>
   int decodeImpl(std::vector<std::unique_ptr<DataRecord>>&& records,
@@ -7,6 +7,7 @@
  */
 #include "logdevice/common/buffered_writer/BufferedWriterSingleLog.h"
 
+#include <algorithm>
 #include <chrono>
 #include <lz4.h>
 #include <lz4hc.h>
@@ -138,8 +139,15 @@ int BufferedWriterSingleLog::appendImpl(AppendChunk& chunk,
 
     // Refresh log options once per batch.
     options_ = get_log_options_(log_id_);
+    if (options_.adaptive_latency_target.count() >= 0 &&
+        adaptive_size_trigger_ < 0) {
+      adaptive_size_trigger_ = options_.size_trigger >= 0
+          ? options_.size_trigger
+          : options_.adaptive_min_size_trigger;
+    }
 
     auto batch = std::make_unique<Batch>(next_batch_num_++);
+    batch->create_time = std::chrono::steady_clock::now();
 
     // Calculate how many bytes these records will take up in the blob
     for (const BufferedWriter::Append& append : chunk) {
@@ -224,8 +232,9 @@ void BufferedWriterSingleLog::flushMeMaybe(bool defer_client_size_trigger) {
 
   // If client set `Options::size_trigger', check if the sum of payload bytes
   // buffered exceeds it
-  if (!defer_client_size_trigger && options_.size_trigger >= 0 &&
-      batch.payload_memory_bytes_total >= options_.size_trigger) {
+  const ssize_t size_trigger = sizeTrigger();
+  if (!defer_client_size_trigger && size_trigger >= 0 &&
+      batch.payload_memory_bytes_total >= size_trigger) {
     STAT_INCR(w->getStats(), buffered_writer_size_trigger_flush);
     flushBuildingBatch();
     return;
@@ -304,9 +313,14 @@ void BufferedWriterSingleLog::sendBatch(Batch& batch) {
   if (batch.state == Batch::State::BUILDING) {
     ld_check_eq(batch.blob.length(), 0);
 
+    batch.flush_time = std::chrono::steady_clock::now();
     setBatchState(batch, Batch::State::CONSTRUCTING_BLOB);
     construct_blob(
-        batch, checksumBits(), options_.compression, options_.destroy_payloads);
+        batch,
+        checksumBits(),
+        options_.compression,
+        options_.zstd_dictionary_id,
+        options_.destroy_payloads);
   } else {
     // This is a retry, so we must have already sent it, so we can skip the
     // purgatory of READY_TO_SEND.
@@ -371,6 +385,7 @@ void BufferedWriterSingleLog::appendBatch(Batch& batch) {
   }
 
   setBatchState(batch, Batch::State::INFLIGHT);
+  batch.send_time = std::chrono::steady_clock::now();
 
   // Call into BufferedWriter::appendBuffered() which in production is just a
   // proxy for ClientImpl::appendBuffered() or
@@ -404,6 +419,7 @@ void BufferedWriterSingleLog::onAppendReply(Batch& batch,
 
   if (status == E::OK) {
     WORKER_STAT_INCR(buffered_writer_batches_succeeded);
+    adaptTriggers(batch);
   } else {
     WORKER_STAT_INCR(buffered_writer_batches_failed);
   }
@@ -512,7 +528,8 @@ void BufferedWriterSingleLog::dropBlockedAppends(Status status,
 }
 
 void BufferedWriterSingleLog::activateTimeTrigger() {
-  if (options_.time_trigger.count() < 0) {
+  const std::chrono::milliseconds time_trigger = timeTrigger();
+  if (time_trigger.count() < 0) {
     return;
   }
 
@@ -524,8 +541,66 @@ void BufferedWriterSingleLog::activateTimeTrigger() {
     });
   }
   if (!time_trigger_timer_->isActive()) {
-    time_trigger_timer_->activate(options_.time_trigger);
+    time_trigger_timer_->activate(time_trigger);
+  }
+}
+
+ssize_t BufferedWriterSingleLog::sizeTrigger() const {
+  if (options_.adaptive_latency_target.count() < 0 ||
+      adaptive_size_trigger_ < 0) {
+    return options_.size_trigger;
+  }
+  return std::max(
+      options_.adaptive_min_size_trigger,
+      std::min(adaptive_size_trigger_, options_.adaptive_max_size_trigger));
+}
+
+std::chrono::milliseconds BufferedWriterSingleLog::timeTrigger() const {
+  using std::chrono::milliseconds;
+  if (options_.adaptive_latency_target.count() < 0) {
+    return options_.time_trigger;
+  }
+  // Leave enough time for the round trip.
+  const milliseconds budget =
+      std::max(milliseconds(1),
+               options_.adaptive_latency_target -
+                   std::chrono::duration_cast<milliseconds>(append_rtt_));
+  return options_.time_trigger.count() >= 0
+      ? std::min(options_.time_trigger, budget)
+      : budget;
+}
+
+void BufferedWriterSingleLog::adaptTriggers(const Batch& batch) {
+  if (options_.adaptive_latency_target.count() < 0) {
+    return;
   }
+  const auto now = std::chrono::steady_clock::now();
+  const auto rtt = now - batch.send_time;
+  const auto buffered = batch.flush_time - batch.create_time;
+  // Moving average with a weight of 1/8 for the new sample, as for TCP's
+  // smoothed RTT.
+  append_rtt_ =
+      append_rtt_.count() == 0 ? rtt : append_rtt_ + (rtt - append_rtt_) / 8;
+
+  const size_t inflight = std::count_if(
+      batches_->begin(), batches_->end(), [](const auto& b) {
+        return b->state == Batch::State::INFLIGHT;
+      });
+  ssize_t trigger = sizeTrigger();
+  if (buffered + rtt <= options_.adaptive_latency_target) {
+    // Within the latency budget. Probe for larger batches.
+    trigger += std::max<ssize_t>(trigger / 8, 1);
+  } else if (buffered >= rtt) {
+    // Over budget mostly because of waiting for the batch to fill up.
+    trigger /= 2;
+  } else if (inflight > 1) {
+    // Over budget because appends queue up in LogDevice. Fewer, larger
+    // batches make better use of the sequencer.
+    trigger *= 2;
+  }
+  adaptive_size_trigger_ = std::max(
+      options_.adaptive_min_size_trigger,
+      std::min(trigger, options_.adaptive_max_size_trigger));
 }
 
 int BufferedWriterSingleLog::scheduleRetry(Batch& batch,
@@ -626,6 +701,7 @@ void encode_batch(BufferedWriterSingleLog::Batch& batch,
                   int checksum_bits,
                   Compression compression,
                   int zstd_level,
+                  uint32_t zstd_dictionary_id,
                   bool destroy_payloads) {
   ld_check(batch.total_size_freed == 0);
 
@@ -678,7 +754,7 @@ void encode_batch(BufferedWriterSingleLog::Batch& batch,
     }
   }
   folly::IOBufQueue encoded;
-  encoder.encode(encoded, compression, zstd_level);
+  encoder.encode(encoded, compression, zstd_level, zstd_dictionary_id);
   batch.blob = encoded.moveAsValue();
 }
 } // namespace
@@ -688,16 +764,26 @@ void BufferedWriterSingleLog::Impl::construct_compressed_blob(
     int checksum_bits,
     Compression compression,
     int zstd_level,
+    uint32_t zstd_dictionary_id,
     bool destroy_payloads) {
   switch (batch.blob_format) {
     case BufferedWriteCodec::Format::SINGLE_PAYLOADS: {
       encode_batch<BufferedWriteSinglePayloadsCodec::Encoder>(
-          batch, checksum_bits, compression, zstd_level, destroy_payloads);
+          batch,
+          checksum_bits,
+          compression,
+          zstd_level,
+          zstd_dictionary_id,
+          destroy_payloads);
       break;
     }
     case BufferedWriteCodec::Format::PAYLOAD_GROUPS: {
-      encode_batch<PayloadGroupCodec::Encoder>(
-          batch, checksum_bits, compression, zstd_level, destroy_payloads);
+      encode_batch<PayloadGroupCodec::Encoder>(batch,
+                                               checksum_bits,
+                                               compression,
+                                               zstd_level,
+                                               zstd_dictionary_id,
+                                               destroy_payloads);
       break;
     }
   }
@@ -708,17 +794,23 @@ void BufferedWriterSingleLog::Impl::construct_blob_long_running(
     int checksum_bits,
     Compression compression,
     const int zstd_level,
+    uint32_t zstd_dictionary_id,
     bool destroy_payloads) {
   ld_check(batch.state == Batch::State::CONSTRUCTING_BLOB);
 
-  construct_compressed_blob(
-      batch, checksum_bits, compression, zstd_level, destroy_payloads);
+  construct_compressed_blob(batch,
+                            checksum_bits,
+                            compression,
+                            zstd_level,
+                            zstd_dictionary_id,
+                            destroy_payloads);
 }
 
 void BufferedWriterSingleLog::construct_blob(
     BufferedWriterSingleLog::Batch& batch,
     int checksum_bits,
     Compression compression,
+    uint32_t zstd_dictionary_id,
     bool destroy_payloads) {
   ld_check(batch.state == Batch::State::CONSTRUCTING_BLOB);
 
@@ -734,10 +826,21 @@ void BufferedWriterSingleLog::construct_blob(
   // process more requests.  However, if it's small, we just do that inline
   // since the queueing & switching overhead would cost more than we save.
 
+  //
+  // If the background queue is full, we also do it inline rather than wait
+  // for room in the queue: the background threads are already busy, and
+  // blocking here would stall the event loop of this worker for as long as
+  // they take to catch up. readyToSend() keeps the batches of a log in order
+  // no matter which ones were constructed in the background.
+
   if (batch.blob_bytes_total <
       Worker::settings().buffered_writer_bg_thread_bytes_threshold) {
-    Impl::construct_blob_long_running(
-        batch, checksum_bits, compression, zstd_level, destroy_payloads);
+    Impl::construct_blob_long_running(batch,
+                                      checksum_bits,
+                                      compression,
+                                      zstd_level,
+                                      zstd_dictionary_id,
+                                      destroy_payloads);
     readyToSend(batch);
   } else {
     ProcessorProxy* processor_proxy = parent_->parent_->processorProxy();
@@ -748,7 +851,7 @@ void BufferedWriterSingleLog::construct_blob(
             batches_->size(),
             parent_->parent_->recentNumBackground());
 
-    processor_proxy->processor()->enqueueToBackgroundBlocking(
+    bool enqueued = processor_proxy->processor()->enqueueToBackground(
         [&batch,
          checksum_bits,
          destroy_payloads,
@@ -757,9 +860,15 @@ void BufferedWriterSingleLog::construct_blob(
          thread_affinity = Worker::onThisThread()->idx_.val(),
          compression,
          zstd_level,
+         zstd_dictionary_id,
          this]() mutable {
           BufferedWriterSingleLog::Impl::construct_blob_long_running(
-              batch, checksum_bits, compression, zstd_level, destroy_payloads);
+              batch,
+              checksum_bits,
+              compression,
+              zstd_level,
+              zstd_dictionary_id,
+              destroy_payloads);
           std::unique_ptr<Request> request =
               std::make_unique<ContinueBlobSendRequest>(
                   this, batch, thread_affinity);
@@ -776,6 +885,17 @@ void BufferedWriterSingleLog::construct_blob(
             ld_error("Processor::postWithRetrying() failed: %d", rc);
           }
         });
+    if (!enqueued) {
+      STAT_INCR(parent_->parent_->processor()->stats_,
+                buffered_writer_bg_queue_full);
+      Impl::construct_blob_long_running(batch,
+                                        checksum_bits,
+                                        compression,
+                                        zstd_level,
+                                        zstd_dictionary_id,
+                                        destroy_payloads);
+      readyToSend(batch);
+    }
   }
 }
 
@@ -7,6 +7,7 @@
  */
 #pragma once
 
+#include <chrono>
 #include <deque>
 #include <queue>
 #include <string>
@@ -120,6 +121,12 @@ class BufferedWriterSingleLog {
     // INFLIGHT.
     folly::IOBuf blob;
 
+    // When the batch was created, flushed, and last sent out; for adaptive
+    // flushing.
+    std::chrono::steady_clock::time_point create_time;
+    std::chrono::steady_clock::time_point flush_time;
+    std::chrono::steady_clock::time_point send_time;
+
     // How many times we've retried sending this batch
     int retry_count = 0;
     // Retry timer if in state RETRY_PENDING
@@ -166,6 +173,7 @@ class BufferedWriterSingleLog {
                                             int checksum_bits,
                                             Compression compression,
                                             int zstd_level,
+                                            uint32_t zstd_dictionary_id,
                                             bool destroy_payloads);
 
     // Constructs a blob from a batch.  Copies and compresses the data, so is
@@ -174,6 +182,7 @@ class BufferedWriterSingleLog {
                                           int checksum_bits,
                                           Compression compression,
                                           int zstd_level,
+                                          uint32_t zstd_dictionary_id,
                                           bool destroy_payloads);
   };
 
@@ -243,6 +252,13 @@ class BufferedWriterSingleLog {
   // Ensures that time_trigger_timer_ is active if Options::time_trigger was
   // set by client
   void activateTimeTrigger();
+  // Size and time triggers in effect, which differ from options_ with
+  // adaptive flushing (negative for no trigger).
+  ssize_t sizeTrigger() const;
+  std::chrono::milliseconds timeTrigger() const;
+  // With adaptive flushing, updates the size trigger and the round trip
+  // estimate after a batch was successfully appended.
+  void adaptTriggers(const Batch& batch);
   // Called when a batch fails to send.  Attempts to schedule a retry if
   // configured, returns 0 if the retry was successfully scheduled.
   int scheduleRetry(Batch& batch, Status, const DataRecord& dr_batch);
@@ -279,6 +295,7 @@ class BufferedWriterSingleLog {
   void construct_blob(Batch& batch,
                       int checksum_bits,
                       Compression compresssion,
+                      uint32_t zstd_dictionary_id,
                       bool destroy_payloads);
 
   BufferedWriterShard* parent_;
@@ -312,6 +329,11 @@ class BufferedWriterSingleLog {
 
   // Does a flush() call have anything to do?
   bool is_flushable_ = false;
+
+  // With adaptive flushing, the current size trigger (negative until the
+  // first batch), and a moving average of append round trip times.
+  ssize_t adaptive_size_trigger_ = -1;
+  std::chrono::steady_clock::duration append_rtt_{0};
 };
 
 }} // namespace facebook::logdevice
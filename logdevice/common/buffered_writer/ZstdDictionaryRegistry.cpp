@@ -0,0 +1,99 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/buffered_writer/ZstdDictionaryRegistry.h"
+
+#include <zdict.h>
+#include <zstd.h>
+
+#include "logdevice/common/debug.h"
+
+namespace facebook { namespace logdevice {
+
+ZstdDictionaryRegistry& ZstdDictionaryRegistry::get() {
+  static ZstdDictionaryRegistry registry;
+  return registry;
+}
+
+std::string
+ZstdDictionaryRegistry::train(const std::vector<std::string>& samples,
+                              size_t max_size) {
+  std::string concatenated;
+  std::vector<size_t> sizes;
+  sizes.reserve(samples.size());
+  for (const std::string& sample : samples) {
+    concatenated += sample;
+    sizes.push_back(sample.size());
+  }
+  std::string dictionary(max_size, '\0');
+  size_t rv = ZDICT_trainFromBuffer(&dictionary[0],
+                                    dictionary.size(),
+                                    concatenated.data(),
+                                    sizes.data(),
+                                    sizes.size());
+  if (ZDICT_isError(rv)) {
+    ld_error("Failed to train a ZSTD dictionary on %zu samples: %s",
+             samples.size(),
+             ZDICT_getErrorName(rv));
+    return std::string();
+  }
+  dictionary.resize(rv);
+  return dictionary;
+}
+
+uint32_t ZstdDictionaryRegistry::add(std::string dictionary) {
+  const uint32_t id = ZDICT_getDictID(dictionary.data(), dictionary.size());
+  if (id == 0) {
+    return 0;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (entries_.count(id)) {
+    return id;
+  }
+  ZSTD_DDict* ddict = ZSTD_createDDict(dictionary.data(), dictionary.size());
+  if (!ddict) {
+    return 0;
+  }
+  Entry& entry = entries_[id];
+  entry.dictionary = std::move(dictionary);
+  entry.ddict.reset(ddict, [](const ZSTD_DDict* d) {
+    ZSTD_freeDDict(const_cast<ZSTD_DDict*>(d));
+  });
+  return id;
+}
+
+std::shared_ptr<const ZSTD_CDict_s>
+ZstdDictionaryRegistry::getCDict(uint32_t id, int level) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = entries_.find(id);
+  if (it == entries_.end()) {
+    return nullptr;
+  }
+  auto& cdict = it->second.cdicts[level];
+  if (!cdict) {
+    const std::string& dictionary = it->second.dictionary;
+    ZSTD_CDict* created =
+        ZSTD_createCDict(dictionary.data(), dictionary.size(), level);
+    if (!created) {
+      it->second.cdicts.erase(level);
+      return nullptr;
+    }
+    cdict.reset(created, [](const ZSTD_CDict* d) {
+      ZSTD_freeCDict(const_cast<ZSTD_CDict*>(d));
+    });
+  }
+  return cdict;
+}
+
+std::shared_ptr<const ZSTD_DDict_s>
+ZstdDictionaryRegistry::getDDict(uint32_t id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = entries_.find(id);
+  return it == entries_.end() ? nullptr : it->second.ddict;
+}
+
+}} // namespace facebook::logdevice
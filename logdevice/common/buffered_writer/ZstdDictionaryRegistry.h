@@ -0,0 +1,78 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct ZSTD_CDict_s;
+struct ZSTD_DDict_s;
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file Process-wide set of ZSTD dictionaries that buffered writes can be
+ *       compressed with. A dictionary is identified by the ID ZSTD stores
+ *       in it. The same ID is written into the header of every ZSTD frame
+ *       compressed with it, so decoding finds the dictionary without any
+ *       change to the batch format.
+ *
+ *       Writers and readers of a log must register the same dictionaries.
+ *       Distributing them is up to the application.
+ */
+class ZstdDictionaryRegistry {
+ public:
+  static ZstdDictionaryRegistry& get();
+
+  /**
+   * Trains a dictionary on sample payloads, e.g. records of a log group.
+   *
+   * @return the dictionary, or an empty string if ZSTD couldn't train one
+   *         (typically because there are too few samples).
+   */
+  static std::string train(const std::vector<std::string>& samples,
+                           size_t max_size);
+
+  /**
+   * Adds a dictionary. Adding a dictionary with the ID of an existing one
+   * has no effect.
+   *
+   * @return ID of the dictionary, or 0 if `dictionary` isn't a ZSTD
+   *         dictionary with an ID.
+   */
+  uint32_t add(std::string dictionary);
+
+  /**
+   * @return dictionary `id` prepared for compression at `level`, or nullptr
+   *         if there's no such dictionary.
+   */
+  std::shared_ptr<const ZSTD_CDict_s> getCDict(uint32_t id, int level);
+
+  /**
+   * @return dictionary `id` prepared for decompression, or nullptr if
+   *         there's no such dictionary.
+   */
+  std::shared_ptr<const ZSTD_DDict_s> getDDict(uint32_t id);
+
+ private:
+  struct Entry {
+    std::string dictionary;
+    std::shared_ptr<const ZSTD_DDict_s> ddict;
+    // By compression level, created on first use.
+    std::map<int, std::shared_ptr<const ZSTD_CDict_s>> cdicts;
+  };
+
+  std::mutex mutex_;
+  std::unordered_map<uint32_t, Entry> entries_;
+};
+
+}} // namespace facebook::logdevice
@@ -7,6 +7,8 @@
  */
 #include "logdevice/common/client_read_stream/AllClientReadStreams.h"
 
+#include <algorithm>
+
 #include <folly/small_vector.h>
 
 #include "logdevice/common/AdminCommandTable.h"
@@ -15,6 +17,7 @@
 #include "logdevice/common/Worker.h"
 #include "logdevice/common/protocol/STOP_Message.h"
 #include "logdevice/common/request_util.h"
+#include "logdevice/common/stats/Stats.h"
 #include "logdevice/include/Err.h"
 
 namespace facebook { namespace logdevice {
@@ -126,6 +129,9 @@ void AllClientReadStreams::noteConfigurationChanged() {
 void AllClientReadStreams::noteSettingsUpdated() {
   forEachStream(
       [](ClientReadStream& read_stream) { read_stream.onSettingsUpdated(); });
+  // reader_health_signals_failover may have been turned off, in which case
+  // the streams need to forget the graylist.
+  scheduleHealthSignals();
 }
 
 void AllClientReadStreams::onShardStatusChanged() {
@@ -136,6 +142,103 @@ void AllClientReadStreams::onShardStatusChanged() {
   });
 }
 
+void AllClientReadStreams::registerForClusterStateUpdates() {
+  ClusterState* cluster_state = Worker::getClusterState();
+  if (!cluster_state) {
+    return;
+  }
+  // Subscriptions are kept by the worker, which outlives us.
+  cluster_state->subscribeToUpdates(
+      [this](node_index_t nid, ClusterStateNodeState state) {
+        noteNodeStateChanged(nid, state);
+      });
+}
+
+void AllClientReadStreams::noteNodeStateChanged(node_index_t nid,
+                                                ClusterStateNodeState state) {
+  if (!Worker::settings().reader_health_signals_failover) {
+    return;
+  }
+  pending_node_states_[nid] = state;
+  scheduleHealthSignals();
+}
+
+void AllClientReadStreams::noteGraylistChanged() {
+  if (!Worker::settings().reader_health_signals_failover) {
+    return;
+  }
+  scheduleHealthSignals();
+}
+
+void AllClientReadStreams::scheduleHealthSignals() {
+  if (streams_.empty()) {
+    pending_node_states_.clear();
+    return;
+  }
+  if (!health_signals_timer_.isAssigned()) {
+    health_signals_timer_.assign([this] { applyHealthSignals(); });
+  }
+  if (!health_signals_timer_.isActive()) {
+    health_signals_timer_.activate(
+        Worker::settings().reader_health_signals_batch_delay);
+  }
+}
+
+void AllClientReadStreams::applyHealthSignals() {
+  std::unordered_set<node_index_t> dead_nodes;
+  std::unordered_set<node_index_t> graylisted_nodes;
+  if (Worker::settings().reader_health_signals_failover) {
+    for (const auto& it : pending_node_states_) {
+      if (it.second == ClusterStateNodeState::DEAD) {
+        dead_nodes.insert(it.first);
+      }
+    }
+    graylisted_nodes = Worker::onThisThread()->getGraylistedNodes();
+  }
+  pending_node_states_.clear();
+
+  forEachStream([&](ClientReadStream& read_stream) {
+    read_stream.onNodeHealthChanged(dead_nodes, graylisted_nodes);
+  });
+}
+
+bool AllClientReadStreams::queueRewind(read_stream_id_t id) {
+  if (Worker::settings().reader_rewind_batch_size == 0) {
+    return false;
+  }
+  rewind_queue_.push_back(id);
+  WORKER_STAT_INCR(rewinds_queued);
+  if (!rewind_queue_timer_.isAssigned()) {
+    rewind_queue_timer_.assign([this] { rewindQueuedStreams(); });
+  }
+  if (!rewind_queue_timer_.isActive()) {
+    // Let the other streams whose rewinds are due in this iteration of the
+    // event loop join the batch.
+    rewind_queue_timer_.activate(std::chrono::milliseconds(0));
+  }
+  return true;
+}
+
+void AllClientReadStreams::rewindQueuedStreams() {
+  WORKER_STAT_INCR(rewind_batches);
+  // Streams rewinding now may queue again, they go after the others.
+  size_t n = std::min(
+      rewind_queue_.size(), Worker::settings().reader_rewind_batch_size);
+  while (n-- > 0) {
+    read_stream_id_t id = rewind_queue_.front();
+    rewind_queue_.pop_front();
+    ClientReadStream* stream = getStream(id);
+    if (stream) {
+      stream->onQueuedRewindDue();
+    }
+  }
+  if (!rewind_queue_.empty()) {
+    // Also postpones the timer if a stream that rewound queued again.
+    rewind_queue_timer_.activate(
+        Worker::settings().reader_rewind_batch_interval);
+  }
+}
+
 ClientReadStream* AllClientReadStreams::getStream(read_stream_id_t id) {
   auto it = streams_.find(id);
   if (it == streams_.end()) {
@@ -7,12 +7,16 @@
  */
 #pragma once
 
+#include <deque>
 #include <memory>
+#include <unordered_map>
 
 #include <folly/container/F14Map.h>
 
 #include "logdevice/common/AdminCommandTable-fwd.h"
+#include "logdevice/common/ClusterState.h"
 #include "logdevice/common/ShardAuthoritativeStatusMap.h"
+#include "logdevice/common/Timer.h"
 #include "logdevice/common/client_read_stream/ClientReadStream.h"
 #include "logdevice/common/protocol/GAP_Message.h"
 #include "logdevice/common/protocol/STARTED_Message.h"
@@ -101,6 +105,35 @@ class AllClientReadStreams : public ShardAuthoritativeStatusSubscriber {
 
   void onShardStatusChanged() override;
 
+  /**
+   * Subscribes to node state changes in ClusterState, if there is one.
+   * Called when the worker starts.
+   */
+  void registerForClusterStateUpdates();
+
+  /**
+   * Called when the state of a node in ClusterState changed.
+   */
+  void noteNodeStateChanged(node_index_t nid, ClusterStateNodeState state);
+
+  /**
+   * Called when the worker's GraylistingTracker changed the graylist.
+   */
+  void noteGraylistChanged();
+
+  /**
+   * Queues a rewind of stream `id` whose RewindScheduler delay expired.
+   * Queued rewinds are done Settings::reader_rewind_batch_size at a time,
+   * one batch per Settings::reader_rewind_batch_interval, starting in the
+   * next iteration of the event loop. This spreads out the START messages
+   * sent when many streams rewind at once, e.g. when a storage node goes
+   * down, instead of sending all of them in one go.
+   *
+   * @return false if Settings::reader_rewind_batch_size is 0, in which case
+   *         the stream should rewind right away.
+   */
+  bool queueRewind(read_stream_id_t id);
+
   /**
    * Forces the map to get cleared and all read streams destroyed.
    */
@@ -146,6 +179,32 @@ class AllClientReadStreams : public ShardAuthoritativeStatusSubscriber {
     });
   }
 
+  // Activates health_signals_timer_ if it isn't active.
+  void scheduleHealthSignals();
+
+  // Passes nodes that became dead since the last call, and the current
+  // graylist, to all read streams. Passes nothing if
+  // Settings::reader_health_signals_failover is not set.
+  void applyHealthSignals();
+
+  // Last state of the nodes whose state changed since applyHealthSignals().
+  std::unordered_map<node_index_t, ClusterStateNodeState> pending_node_states_;
+
+  // Calls applyHealthSignals(). Batches node state and graylist changes for
+  // Settings::reader_health_signals_batch_delay, so that each read stream
+  // rewinds once for a burst of changes rather than once per change.
+  Timer health_signals_timer_;
+
+  // Rewinds up to Settings::reader_rewind_batch_size streams from
+  // rewind_queue_ and reactivates rewind_queue_timer_ if some are left.
+  void rewindQueuedStreams();
+
+  // Streams waiting to rewind, in the order their rewinds were due.
+  std::deque<read_stream_id_t> rewind_queue_;
+
+  // Calls rewindQueuedStreams().
+  Timer rewind_queue_timer_;
+
   // Actual container
   folly::F14FastMap<read_stream_id_t,
                     std::unique_ptr<ClientReadStream>,
@@ -17,6 +17,7 @@
 #include <folly/CppAttributes.h>
 #include <folly/Memory.h>
 #include <folly/Overload.h>
+#include <folly/ScopeGuard.h>
 #include <folly/String.h>
 
 #include "logdevice/common/AdminCommandTable.h"
@@ -623,14 +624,20 @@ void ClientReadStream::sendStart(ShardID shard_id, SenderState& state) {
       SCDCopysetReordering::HASH_SHUFFLE_CLIENT_SEED,
       SCDCopysetReordering(deps_->getSettings().scd_copyset_reordering_max)));
 
+  const std::vector<node_index_t>* preferred_nodes = nullptr;
   if (scd_->isActive()) {
     header.flags |= START_Header::SINGLE_COPY_DELIVERY;
     if (scd_->localScdEnabled()) {
       header.flags |= START_Header::LOCAL_SCD_ENABLED;
     }
+    if (!scd_->getPreferredNodes().empty() &&
+        coordinated_proto_ >= Compatibility::SCD_PREFERRED_NODES_SUPPORT) {
+      header.flags |= START_Header::SCD_PREFERRED_NODES;
+      preferred_nodes = &scd_->getPreferredNodes();
+    }
   }
-  int rv =
-      deps_->sendStartMessage(shard_id, onclose, header, filtered_out, &attrs_);
+  int rv = deps_->sendStartMessage(
+      shard_id, onclose, header, filtered_out, &attrs_, preferred_nodes);
 
   state.cancelReconnectTimer();
   state.cancelStartedTimer();
@@ -679,6 +686,7 @@ void ClientReadStream::onStartSent(ShardID shard_id, Status status) {
   if (status == E::OK) {
     state.setConnectionState(ConnectionState::START_SENT);
     state.activateStartedTimer();
+    state.start_sent_time = deps_->getCurrentTime();
   } else if (status == E::PROTONOSUPPORT) {
     handleStartPROTONOSUPPORT(shard_id);
   } else {
@@ -816,6 +824,15 @@ void ClientReadStream::onStarted(ShardID from, const STARTED_Message& msg) {
       state.setConnectionState(ConnectionState::READING);
       state.resetReconnectTimer();
       if (status == E::OK) {
+        if (window_autotuning_.hasValue() &&
+            state.start_sent_time != std::chrono::steady_clock::time_point()) {
+          // Smoothed like TCP's SRTT.
+          auto& rtt = window_autotuning_->rtt;
+          const auto sample =
+              std::chrono::duration_cast<std::chrono::microseconds>(
+                  deps_->getCurrentTime() - state.start_sent_time);
+          rtt = rtt.count() == 0 ? sample : (rtt * 7 + sample) / 8;
+        }
         updateLastReleased(msg.header_.last_released_lsn);
         // Send a quick WINDOW message in case this server missed out on any
         // window updates while the read stream was starting
@@ -967,6 +984,13 @@ void ClientReadStream::onDataRecord(ShardID shard,
                                     std::unique_ptr<RawDataRecord> record) {
   ld_check(!done());
 
+  const auto stage_start = stageTimingStart();
+  SCOPE_EXIT {
+    if (stage_start.hasValue()) {
+      WORKER_STAT_ADD(client_read_stream_usec, usec_since(*stage_start));
+    }
+  };
+
   // There are several possible actions to take with the record:
   // (1) Ignore:
   // (1a) Record is a copy of one that we already delivered to the
@@ -981,6 +1005,12 @@ void ClientReadStream::onDataRecord(ShardID shard,
 
   const lsn_t lsn = record->attrs.lsn;
 
+  if (window_autotuning_.hasValue()) {
+    double& avg = window_autotuning_->avg_record_bytes;
+    const double size = record->payload.size();
+    avg = avg == 0 ? size : avg * 0.9 + size * 0.1;
+  }
+
   ld_spew("Log=%lu,%s%s,%s from %s, next_lsn_to_deliver=%s",
           log_id_.val_,
           lsn_to_string(lsn).c_str(),
@@ -1233,6 +1263,13 @@ void ClientReadStream::onDataRecord(ShardID shard,
 
 void ClientReadStream::onGap(ShardID shard, const GAP_Message& msg) {
   ld_check(!done());
+
+  const auto stage_start = stageTimingStart();
+  SCOPE_EXIT {
+    if (stage_start.hasValue()) {
+      WORKER_STAT_ADD(client_read_stream_usec, usec_since(*stage_start));
+    }
+  };
   auto& gap = msg.getHeader();
 
   ld_spew("%s from %s", gap.identify().c_str(), shard.toString().c_str());
@@ -1567,7 +1604,13 @@ void ClientReadStream::findGapsAndRecords(bool grace_period_expired,
     }
 
     if (rstate != nullptr) {
-      if (rstate->record != nullptr || rstate->filtered_out) {
+      if (canDeliverInBatch(*rstate)) {
+        // There are one or more records to ship with the record batch
+        // callback.
+        if (deliverRecordBatch() != 0) {
+          return false;
+        }
+      } else if (rstate->record != nullptr || rstate->filtered_out) {
         // There's a record or FILTERED_OUT gap to ship.
         if (handleRecord(rstate, grace_period_expired, rstate->filtered_out) !=
             0) {
@@ -1618,6 +1661,11 @@ void ClientReadStream::findGapsAndRecords(bool grace_period_expired,
     return true;
   };
 
+  coalescing_gaps_ = deps_->getSettings().client_read_coalesce_gaps;
+  SCOPE_EXIT {
+    coalescing_gaps_ = false;
+  };
+
   while (!done()) {
     while (try_make_progress()) {
       if (grace_period_ != nullptr) {
@@ -1626,7 +1674,10 @@ void ClientReadStream::findGapsAndRecords(bool grace_period_expired,
         grace_period_->cancel();
       }
     }
-    if (!slideSenderWindows()) {
+    // A gap held back for coalescing may cover next_lsn_to_slide_window_, so
+    // it must be delivered (and Reader asked to notify us) before the window
+    // slides.
+    if (flushCoalescedGap() != 0 || !slideSenderWindows()) {
       break;
     }
   }
@@ -2195,6 +2246,18 @@ void ClientReadStream::onSettingsUpdated() {
   // `this` may be destroyed here.
 }
 
+void ClientReadStream::onNodeHealthChanged(
+    const std::unordered_set<node_index_t>& dead_nodes,
+    const std::unordered_set<node_index_t>& graylisted_nodes) {
+  if (scd_ && current_metadata_ && !done()) {
+    scd_->onNodeHealthChanged(dead_nodes, graylisted_nodes);
+  }
+}
+
+void ClientReadStream::onQueuedRewindDue() {
+  rewind_scheduler_->onDequeued();
+}
+
 void ClientReadStream::setShardAuthoritativeStatus(SenderState& state,
                                                    AuthoritativeStatus status) {
   auto prev_status = state.getAuthoritativeStatus();
@@ -2794,6 +2857,7 @@ void ClientReadStream::onEpochMetaData(Status st,
       return;
     }
     updateLastEpochWithMetaData(st, epoch, until, source);
+    maybePrefetchEpochMetaData();
   }
 
   // both current_metadata_ and last_epoch_with_metadata_ have been updated,
@@ -3078,6 +3142,11 @@ void ClientReadStream::resumeReading() {
   }
 }
 
+bool ClientReadStream::canResumeElsewhere() const {
+  return started_ && !done() && !inside_callback_ && !coalesced_gap_ &&
+      !(redelivery_timer_ != nullptr && redelivery_timer_->isActive());
+}
+
 bool ClientReadStream::canDeliverRecordsNow() const {
   const RecordState* rstate = buffer_->front();
   return rstate && (rstate->record || rstate->filtered_out);
@@ -3325,6 +3394,13 @@ int ClientReadStream::handleBridgeRecord(lsn_t bridge_record_lsn,
 int ClientReadStream::deliverRecord(
     std::unique_ptr<DataRecordOwnsPayload>& record) {
   lsn_t lsn = record->attrs.lsn;
+  // This special record type is reported as a HOLE gap to clients
+  const bool hole = (record->flags_ & RECORD_Header::HOLE) &&
+      !ship_pseudorecords_;
+  // A gap held back for coalescing must be delivered first.
+  if (!hole && flushCoalescedGap() != 0) {
+    return -1;
+  }
   if (last_delivered_lsn_ > LSN_INVALID && last_delivered_lsn_ >= lsn) {
     // make sure we are delivering record in order
     ld_critical("Order guarantee violated! Record %s of log %lu is delivered "
@@ -3369,8 +3445,7 @@ int ClientReadStream::deliverRecord(
     }
   }
 
-  if ((record->flags_ & RECORD_Header::HOLE) && !ship_pseudorecords_) {
-    // This special record type is reported as a HOLE gap to clients
+  if (hole) {
     return deliverGap(GapType::HOLE, lsn, lsn);
   }
 
@@ -3391,7 +3466,9 @@ int ClientReadStream::deliverRecord(
     inside_callback_ = true;
     // This is tricky.  Upcasting from DataRecordOwnsPayload ...
     std::unique_ptr<DataRecord> record_upcast(std::move(record));
+    const auto delivery_start = stageTimingStart();
     success = deps_->recordCallback(record_upcast);
+    addDeliveryTime(delivery_start);
     if (success) {
       if (lsn >= until_lsn_) {
         deps_->doneCallback(log_id_);
@@ -3430,33 +3507,7 @@ int ClientReadStream::deliverRecord(
       // lsn appropriately in that case.
       last_delivered_lsn_ = lsn;
     }
-    if (MetaDataLog::isMetaDataLog(log_id_)) {
-      if (wait_for_all_copies_) {
-        WORKER_STAT_INCR(metadata_log_records_delivered_wait_for_all);
-      } else {
-        WORKER_STAT_INCR(metadata_log_records_delivered);
-      }
-      WORKER_STAT_ADD(metadata_log_bytes_delivered,
-                      payload_size_map.getCounter(BYTE_OFFSET));
-    } else {
-      if (wait_for_all_copies_) {
-        WORKER_STAT_INCR(records_delivered_wait_for_all);
-      } else {
-        WORKER_STAT_INCR(records_delivered);
-        WORKER_STAT_INCR(durability_total);
-        if (scd_ && scd_->isActive()) {
-          WORKER_STAT_INCR(records_delivered_scd);
-        } else {
-          WORKER_STAT_INCR(records_delivered_noscd);
-        }
-      }
-      WORKER_STAT_ADD(
-          bytes_delivered, payload_size_map.getCounter(BYTE_OFFSET));
-    }
-    num_records_delivered_++;
-    num_bytes_delivered_ += payload_size_map.getCounter(BYTE_OFFSET);
-    // Updating info reg. buffer usage.
-    bytes_buffered_ -= payload_size_map.getCounter(BYTE_OFFSET);
+    onRecordsDelivered(1, payload_size_map.getCounter(BYTE_OFFSET));
     if (current_offsets.isValid()) {
       accumulated_offsets_ = std::move(current_offsets);
     }
@@ -3469,10 +3520,216 @@ int ClientReadStream::deliverRecord(
   return success ? 0 : -1;
 }
 
+void ClientReadStream::onRecordsDelivered(size_t nrecords, uint64_t nbytes) {
+  if (MetaDataLog::isMetaDataLog(log_id_)) {
+    if (wait_for_all_copies_) {
+      WORKER_STAT_ADD(metadata_log_records_delivered_wait_for_all, nrecords);
+    } else {
+      WORKER_STAT_ADD(metadata_log_records_delivered, nrecords);
+    }
+    WORKER_STAT_ADD(metadata_log_bytes_delivered, nbytes);
+  } else {
+    if (wait_for_all_copies_) {
+      WORKER_STAT_ADD(records_delivered_wait_for_all, nrecords);
+    } else {
+      WORKER_STAT_ADD(records_delivered, nrecords);
+      WORKER_STAT_ADD(durability_total, nrecords);
+      if (scd_ && scd_->isActive()) {
+        WORKER_STAT_ADD(records_delivered_scd, nrecords);
+      } else {
+        WORKER_STAT_ADD(records_delivered_noscd, nrecords);
+      }
+    }
+    WORKER_STAT_ADD(bytes_delivered, nbytes);
+  }
+  num_records_delivered_ += nrecords;
+  num_bytes_delivered_ += nbytes;
+  // Updating info reg. buffer usage.
+  bytes_buffered_ -= nbytes;
+}
+
+bool ClientReadStream::canDeliverInBatch(const RecordState& rstate) const {
+  // Besides calling the record callback, handleRecord() and deliverRecord()
+  // must have nothing to do for these records that depends on whether the
+  // application accepted the preceding records of the run.
+  return !reader_ && !wait_for_all_copies_ &&
+      !(additional_start_flags_ & START_Header::INCLUDE_BYTE_OFFSET) &&
+      deps_->hasRecordBatchCallback() && rstate.record != nullptr &&
+      !rstate.filtered_out &&
+      !(rstate.record->flags_ &
+        (RECORD_Header::HOLE | RECORD_Header::BRIDGE |
+         RECORD_Header::BUFFERED_WRITER_BLOB));
+}
+
+folly::Optional<std::chrono::steady_clock::time_point>
+ClientReadStream::stageTimingStart() const {
+  if (!deps_->getSettings().client_read_stage_timing) {
+    return folly::none;
+  }
+  return std::chrono::steady_clock::now();
+}
+
+void ClientReadStream::addDeliveryTime(
+    const folly::Optional<std::chrono::steady_clock::time_point>& start) {
+  if (start.hasValue()) {
+    WORKER_STAT_ADD(client_read_delivery_usec, usec_since(*start));
+  }
+}
+
+int ClientReadStream::deliverRecordBatch() {
+  ld_check(next_lsn_to_deliver_ == buffer_->getBufferHead());
+  ld_check(delivery_batch_.empty());
+  ld_check(delivery_batch_slots_.empty());
+
+  if (flushCoalescedGap() != 0) {
+    return -1;
+  }
+
+  // Collect the run of records at the front of the buffer. Unlinking the
+  // record states up front is what handleRecord() would do for each of them
+  // before delivering it; it has no effect if delivery has to be retried.
+  const lsn_t first_lsn = next_lsn_to_deliver_;
+  const lsn_t max_lsn = std::min(window_high_, until_lsn_);
+  uint64_t nbytes = 0;
+  OffsetMap last_offsets;
+  for (lsn_t lsn = first_lsn; lsn <= max_lsn; ++lsn) {
+    RecordState* rstate = buffer_->find(lsn);
+    if (rstate == nullptr || !canDeliverInBatch(*rstate)) {
+      break;
+    }
+    DataRecordOwnsPayload* record = rstate->record.get();
+    ld_check(record->attrs.lsn == lsn);
+    unlinkRecordState(lsn, *rstate);
+    nbytes += record->payload.size();
+    last_in_record_ts_ = record->attrs.timestamp;
+    OffsetMap offsets = OffsetMap::fromRecord(record->attrs.offsets);
+    if (offsets.isValid()) {
+      last_offsets = std::move(offsets);
+    }
+    delivery_batch_.emplace_back(std::move(rstate->record));
+    delivery_batch_slots_.push_back(rstate);
+    if (lsn == LSN_MAX) {
+      break;
+    }
+  }
+  ld_check(!delivery_batch_.empty());
+  const lsn_t last_lsn = first_lsn + delivery_batch_.size() - 1;
+  if (last_delivered_lsn_ > LSN_INVALID && last_delivered_lsn_ >= first_lsn) {
+    ld_critical("Order guarantee violated! Record %s of log %lu is delivered "
+                "after record/gap at lsn %s",
+                lsn_to_string(first_lsn).c_str(),
+                log_id_.val(),
+                lsn_to_string(last_delivered_lsn_).c_str());
+    ld_check(last_delivered_lsn_ < first_lsn);
+  }
+  last_received_ts_ = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::system_clock::now().time_since_epoch());
+
+  inside_callback_ = true;
+  const auto delivery_start = stageTimingStart();
+  bool success = deps_->recordBatchCallback(folly::range(delivery_batch_));
+  addDeliveryTime(delivery_start);
+  inside_callback_ = false;
+
+  if (!success) {
+    // Put the records back into the buffer for redelivery.
+    for (size_t i = 0; i < delivery_batch_.size(); ++i) {
+      // Application must not drain the unique_ptrs when it rejects
+      ld_check(delivery_batch_[i] != nullptr);
+      ld_check(delivery_batch_[i]->attrs.lsn == first_lsn + i);
+      delivery_batch_slots_[i]->record.reset(
+          static_cast<DataRecordOwnsPayload*>(delivery_batch_[i].release()));
+    }
+    delivery_batch_.clear();
+    delivery_batch_slots_.clear();
+    if (!MetaDataLog::isMetaDataLog(log_id_)) {
+      WORKER_STAT_INCR(records_redelivery_attempted);
+    }
+    adjustRedeliveryTimer(false);
+    return -1;
+  }
+
+  // Free the records the application didn't take and advance past them.
+  for (RecordState* rstate : delivery_batch_slots_) {
+    ld_check(next_lsn_to_deliver_ == buffer_->getBufferHead());
+    ld_check(rstate->list.empty());
+    ++next_lsn_to_deliver_;
+    rstate->reset();
+    buffer_->popFront();
+    buffer_->advanceBufferHead();
+  }
+  const size_t nrecords = delivery_batch_.size();
+  delivery_batch_.clear();
+  delivery_batch_slots_.clear();
+  ld_check(next_lsn_to_deliver_ == last_lsn + 1);
+
+  last_delivered_lsn_ = last_lsn;
+  onRecordsDelivered(nrecords, nbytes);
+  if (last_offsets.isValid()) {
+    accumulated_offsets_ = std::move(last_offsets);
+  }
+  WORKER_STAT_INCR(record_batches_delivered);
+  if (last_lsn >= until_lsn_) {
+    deps_->doneCallback(log_id_);
+  }
+  adjustRedeliveryTimer(true);
+  return 0;
+}
+
 int ClientReadStream::deliverGap(GapType type, lsn_t lo, lsn_t hi) {
   ld_check(hi <= until_lsn_);
   ld_check(lo <= hi);
 
+  const bool coalesce = coalescing_gaps_ &&
+      (type == GapType::BRIDGE || type == GapType::HOLE ||
+       type == GapType::FILTERED_OUT);
+  if (coalesce && coalesced_gap_ && coalesced_gap_->type == type &&
+      coalesced_gap_->hi + 1 == lo) {
+    if (hi < until_lsn_) {
+      coalesced_gap_->hi = hi;
+      WORKER_STAT_INCR(gaps_coalesced);
+      return 0;
+    }
+    // This gap reaches the end of the stream, deliver it right away with the
+    // one held back. On failure the caller retries this gap, so keep the held
+    // back one as it was.
+    if (deliverGapNow(type, coalesced_gap_->lo, hi) != 0) {
+      return -1;
+    }
+    coalesced_gap_.clear();
+    WORKER_STAT_INCR(gaps_coalesced);
+    return 0;
+  }
+
+  if (flushCoalescedGap() != 0) {
+    return -1;
+  }
+  // Gaps reaching until_lsn_ are never held back, so that the stream is never
+  // done() with a gap left to deliver.
+  if (coalesce && hi < until_lsn_) {
+    coalesced_gap_ = GapRecord(log_id_, type, lo, hi);
+    return 0;
+  }
+  return deliverGapNow(type, lo, hi);
+}
+
+int ClientReadStream::flushCoalescedGap() {
+  if (!coalesced_gap_) {
+    return 0;
+  }
+  if (deliverGapNow(coalesced_gap_->type,
+                    coalesced_gap_->lo,
+                    coalesced_gap_->hi) != 0) {
+    return -1;
+  }
+  coalesced_gap_.clear();
+  return 0;
+}
+
+int ClientReadStream::deliverGapNow(GapType type, lsn_t lo, lsn_t hi) {
+  ld_check(hi <= until_lsn_);
+  ld_check(lo <= hi);
+
   if (type == GapType::DATALOSS) {
     RATELIMIT_WARNING(std::chrono::seconds(10),
                       2,
@@ -3505,7 +3762,9 @@ int ClientReadStream::deliverGap(GapType type, lsn_t lo, lsn_t hi) {
     success = (rv == 0);
   } else {
     inside_callback_ = true;
+    const auto delivery_start = stageTimingStart();
     success = deps_->gapCallback(gap);
+    addDeliveryTime(delivery_start);
     if (success && hi >= until_lsn_) {
       deps_->doneCallback(log_id_);
     }
@@ -3755,11 +4014,86 @@ void ClientReadStream::updateServerWindow() {
 void ClientReadStream::updateWindowSize() {
   if (deps_->hasMemoryPressure()) {
     // cut the window size in half
-    window_size_ = std::max(size_t(1), window_size_ / 2);
+    setWindowSize(std::max(size_t(1), window_size_ / 2));
+  } else if (window_autotuning_.hasValue()) {
+    setWindowSize(autoTunedWindowSize());
   } else {
     // increment window size but not more than what the buffer can hold
-    window_size_ = std::min(buffer_->capacity(), window_size_ + 1);
+    setWindowSize(std::min(buffer_->capacity(), window_size_ + 1));
+  }
+}
+
+void ClientReadStream::enableWindowAutoTuning(size_t min_window_size) {
+  ld_check(!started_);
+  ld_check(min_window_size > 0);
+  window_autotuning_.assign(WindowAutoTuning());
+  window_autotuning_->min_window_size =
+      std::min(min_window_size, buffer_->capacity());
+  window_size_ = window_autotuning_->min_window_size;
+}
+
+size_t ClientReadStream::autoTunedWindowSize() {
+  ld_check(window_autotuning_.hasValue());
+  WindowAutoTuning& tuning = window_autotuning_.value();
+
+  const auto now = deps_->getCurrentTime();
+  const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+      now - tuning.last_slide_time);
+  // LSNs are not contiguous across epochs; skip the sample in that case.
+  const lsn_t delivered = (tuning.last_slide_lsn != LSN_INVALID &&
+                           lsn_to_epoch(tuning.last_slide_lsn) ==
+                               lsn_to_epoch(next_lsn_to_deliver_))
+      ? next_lsn_to_deliver_ - tuning.last_slide_lsn
+      : 0;
+  tuning.last_slide_lsn = next_lsn_to_deliver_;
+  tuning.last_slide_time = now;
+
+  if (delivered == 0 || elapsed.count() <= 0 || tuning.rtt.count() == 0) {
+    // Not enough information yet.
+    return window_size_;
+  }
+
+  // The window slides once flow_control_threshold_ of it is delivered, and
+  // the rest needs to cover what is delivered while the WINDOW message makes
+  // its round trip. Aim for twice that: when the window is what limits the
+  // delivery rate, the measured rate underestimates what the stream could
+  // do, and the window would never grow otherwise.
+  const double lsns_per_rtt =
+      double(delivered) * tuning.rtt.count() / elapsed.count();
+  const double target =
+      2 * lsns_per_rtt / std::max(1 - flow_control_threshold_, 0.01);
+
+  // At most double or halve the window at a time.
+  const double upper =
+      std::min(double(buffer_->capacity()), 2.0 * window_size_);
+  const double lower =
+      std::max(double(tuning.min_window_size), window_size_ / 2.0);
+  return static_cast<size_t>(std::max(lower, std::min(upper, target)));
+}
+
+void ClientReadStream::setWindowSize(size_t window_size) {
+  if (!window_autotuning_.hasValue()) {
+    window_size_ = window_size;
+    return;
+  }
+
+  WindowAutoTuning& tuning = window_autotuning_.value();
+  const size_t extra_records = window_size > tuning.min_window_size
+      ? window_size - tuning.min_window_size
+      : 0;
+  const size_t bytes = extra_records * size_t(tuning.avg_record_bytes);
+  if (bytes > tuning.reserved_bytes) {
+    if (!deps_->reserveWindowMemory(bytes - tuning.reserved_bytes)) {
+      WORKER_STAT_INCR(client_read_window_memory_budget_exhausted);
+      // Out of budget, only allow shrinking.
+      window_size_ = std::min(window_size_, window_size);
+      return;
+    }
+  } else if (bytes < tuning.reserved_bytes) {
+    deps_->releaseWindowMemory(tuning.reserved_bytes - bytes);
   }
+  tuning.reserved_bytes = bytes;
+  window_size_ = window_size;
 }
 
 bool ClientReadStream::slideSenderWindows() {
@@ -3773,6 +4107,11 @@ bool ClientReadStream::slideSenderWindows() {
         until_lsn_ > window_high_)) {
     return false;
   }
+  if (coalesced_gap_) {
+    // findGapsAndRecords() could not deliver a gap it held back, see
+    // deliverGap(). Slide once it is delivered.
+    return false;
+  }
 
   updateWindowSize();
   calcWindowHigh();
@@ -3944,14 +4283,50 @@ int ClientReadStream::deliverFastForwardGap(GapType type, lsn_t next_lsn) {
 
 void ClientReadStream::updateLastReleased(lsn_t last_released_lsn) {
   if (last_released_lsn > last_released_) {
+    const epoch_t prev_epoch = lsn_to_epoch(last_released_);
     last_released_ = last_released_lsn;
+    if (lsn_to_epoch(last_released_) > prev_epoch) {
+      maybePrefetchEpochMetaData();
+    }
   }
 }
 
+void ClientReadStream::maybePrefetchEpochMetaData() {
+  const size_t prefetch_epochs =
+      deps_->getSettings().client_read_stream_metadata_prefetch_epochs;
+  if (prefetch_epochs == 0 || MetaDataLog::isMetaDataLog(log_id_) ||
+      !use_epoch_metadata_cache_ || ignore_released_status_ ||
+      last_epoch_with_metadata_ == EPOCH_INVALID ||
+      last_epoch_with_metadata_ >= EPOCH_MAX) {
+    return;
+  }
+  if (epoch_metadata_requested_.hasValue() &&
+      epoch_metadata_requested_.value() > last_epoch_with_metadata_) {
+    // The read stream is already waiting for the metadata of the next epoch.
+    return;
+  }
+
+  const epoch_t next_epoch(last_epoch_with_metadata_.val_ + 1);
+  if (next_epoch <= epoch_metadata_prefetched_ ||
+      // Metadata is only authentic for released epochs.
+      lsn_to_epoch(last_released_) < next_epoch ||
+      // Still far enough from the end of the known metadata.
+      uint64_t(currentEpoch().val_) + prefetch_epochs <=
+          last_epoch_with_metadata_.val_) {
+    return;
+  }
+
+  epoch_metadata_prefetched_ = next_epoch;
+  deps_->prefetchMetaDataForEpoch(next_epoch);
+}
+
 ClientReadStream::~ClientReadStream() {
   if (started_) {
     TAGGED_STAT_DECR(Worker::stats(), monitoring_tags_, num_read_streams);
   }
+  if (window_autotuning_.hasValue() && window_autotuning_->reserved_bytes > 0) {
+    deps_->releaseWindowMemory(window_autotuning_->reserved_bytes);
+  }
 
   // Not safe to destroy while executing a callback
   ld_check(!inside_callback_);
@@ -4175,6 +4550,15 @@ void ClientReadStream::scheduleRewind(RewindReason reason,
       case RewindReason::CONNECTION_FAILURE:
         WORKER_STAT_INCR(rewind_scheduled_connection_failure);
         break;
+      case RewindReason::NODE_DEAD:
+        WORKER_STAT_INCR(rewind_scheduled_node_dead);
+        break;
+      case RewindReason::NODE_GRAYLISTED:
+        WORKER_STAT_INCR(rewind_scheduled_node_graylisted);
+        break;
+      case RewindReason::REPLICA_RANKING_CHANGED:
+        WORKER_STAT_INCR(rewind_scheduled_replica_ranking_changed);
+        break;
     }
   } else {
     // Don't update stats, but still call rewind_scheduler_->schedule() above
@@ -4428,6 +4812,20 @@ bool ClientReadStreamDependencies::hasMemoryPressure() const {
   return false;
 }
 
+bool ClientReadStreamDependencies::reserveWindowMemory(size_t bytes) {
+  if (window_memory_processor_ == nullptr) {
+    Worker* w = Worker::onThisThread();
+    ld_check(w);
+    window_memory_processor_ = w->processor_;
+  }
+  return window_memory_processor_->reserveReadWindowMemory(bytes);
+}
+
+void ClientReadStreamDependencies::releaseWindowMemory(size_t bytes) {
+  ld_check(window_memory_processor_ != nullptr);
+  window_memory_processor_->releaseReadWindowMemory(bytes);
+}
+
 bool ClientReadStreamDependencies::isWorkerOverloaded() const {
   auto w = Worker::onThisThread(/*enforce=*/false);
   if (w) {
@@ -4654,12 +5052,78 @@ void ClientReadStreamDependencies::updateEpochMetaDataCache(
   }
 }
 
+void ClientReadStreamDependencies::prefetchMetaDataForEpoch(epoch_t epoch) {
+  if (metadata_cache_ == nullptr || MetaDataLog::isMetaDataLog(log_id_) ||
+      prefetch_nodeset_finder_ != nullptr) {
+    return;
+  }
+  {
+    epoch_t until;
+    EpochMetaData metadata;
+    MetaDataLogReader::RecordSource source;
+    if (metadata_cache_->getMetaDataNoPromotion(
+            log_id_, epoch, &until, &metadata, &source)) {
+      // Already cached.
+      return;
+    }
+  }
+
+  auto cb = [this, epoch](Status st) {
+    // Keep the NodeSetFinder alive until the callback returns, see
+    // getMetaDataForEpoch().
+    std::unique_ptr<NodeSetFinder> nf;
+    prefetch_nodeset_finder_.swap(nf);
+    if (st != E::OK) {
+      ld_debug("Failed to prefetch epoch metadata for log %lu epoch %u: %s",
+               log_id_.val(),
+               epoch.val(),
+               error_name(st));
+      return;
+    }
+    auto map = nf->getResult();
+    if (epoch > map->getEffectiveUntil()) {
+      // Not released yet as far as the metadata source knows. The read stream
+      // will fetch it when it gets there.
+      return;
+    }
+    auto it = map->find(epoch);
+    ld_check(it != map->end());
+    // Same entries getMetaDataForEpoch() would have cached for a request of
+    // `epoch`.
+    auto entry = *it;
+    updateEpochMetaDataCache(
+        epoch,
+        entry.first.second,
+        entry.second,
+        MetaDataLogReader::RecordSource::CACHED_CONSISTENT);
+    for (++it; it != map->end(); ++it) {
+      auto elem = *it;
+      updateEpochMetaDataCache(
+          elem.first.first,
+          elem.first.second,
+          elem.second,
+          MetaDataLogReader::RecordSource::CACHED_CONSISTENT);
+    }
+  };
+
+  WORKER_STAT_INCR(client_read_stream_metadata_prefetches);
+  prefetch_nodeset_finder_ = std::make_unique<NodeSetFinder>(
+      log_id_,
+      MAX_RETRY_READ_METADATA_DELAY,
+      std::move(cb),
+      getSettings().read_streams_use_metadata_log_only
+          ? NodeSetFinder::Source::METADATA_LOG
+          : NodeSetFinder::Source::BOTH);
+  prefetch_nodeset_finder_->start();
+}
+
 int ClientReadStreamDependencies::sendStartMessage(
     ShardID shard,
     SocketCallback* onclose,
     START_Header header,
     const small_shardset_t& filtered_out,
-    const ReadStreamAttributes* attrs) {
+    const ReadStreamAttributes* attrs,
+    const std::vector<node_index_t>* preferred_nodes) {
   auto w = Worker::onThisThread();
   ld_check(w);
   ld_check(header.start_lsn <= header.until_lsn);
@@ -4670,6 +5134,9 @@ int ClientReadStreamDependencies::sendStartMessage(
 
   auto msg = std::make_unique<START_Message>(
       header, filtered_out, attrs, client_session_id_);
+  if (preferred_nodes) {
+    msg->scd_preferred_nodes_ = *preferred_nodes;
+  }
   return w->sender().sendMessage(std::move(msg), shard.asNodeID(), onclose);
 }
 
@@ -4772,6 +5239,11 @@ ClientReadStreamDependencies::createTimer(std::function<void()> cb) {
   return timer;
 }
 
+bool ClientReadStreamDependencies::queueRewind() {
+  return Worker::onThisThread()->clientReadStreams().queueRewind(
+      read_stream_id_);
+}
+
 std::function<ClientReadStream*(read_stream_id_t)>
 ClientReadStreamDependencies::getStreamByIDCallback() {
   return [](read_stream_id_t rsid) {
@@ -7,14 +7,18 @@
  */
 #pragma once
 
+#include <chrono>
 #include <cstddef>
 #include <functional>
 #include <memory>
 #include <queue>
 #include <set>
+#include <unordered_set>
+#include <vector>
 
 #include <boost/noncopyable.hpp>
 #include <folly/Optional.h>
+#include <folly/Range.h>
 
 #include "logdevice/common/AdminCommandTable-fwd.h"
 #include "logdevice/common/DataRecordOwnsPayload.h"
@@ -48,6 +52,7 @@ class ClientReadTracer;
 class ClientReadersFlowTracer;
 class ClientStalledReadTracer;
 class EpochMetaDataCache;
+class Processor;
 class ShardAuthoritativeStatusMap;
 class STARTED_Message;
 class UpdateableConfig;
@@ -71,6 +76,9 @@ enum class RewindReason : uint8_t {
   SHARD_BECAME_AUTHORITATIVE_EMPTY,
   WINDOW,
   CONNECTION_FAILURE,
+  NODE_DEAD,
+  NODE_GRAYLISTED,
+  REPLICA_RANKING_CHANGED,
 };
 
 /**
@@ -113,6 +121,9 @@ class ClientReadStreamDependencies {
   ClientReadStreamDependencies();
 
   using record_cb_t = std::function<bool(std::unique_ptr<DataRecord>&)>;
+  using record_batch_cb_t = std::function<bool(
+      logid_t,
+      folly::Range<std::unique_ptr<DataRecord>*>)>;
   using gap_cb_t = std::function<bool(const GapRecord&)>;
   using done_cb_t = std::function<void(logid_t)>;
   using record_copy_cb_t = std::function<void(ShardID, const RawDataRecord*)>;
@@ -196,12 +207,17 @@ class ClientReadStreamDependencies {
    *                       the behavior of the read stream. In
    *                       particular it is used to pass filters
    *                       for the server-side filtering experimental feature.
-   */
-  virtual int sendStartMessage(ShardID shard,
-                               SocketCallback* onclose,
-                               START_Header header,
-                               const small_shardset_t& filtered_out,
-                               const ReadStreamAttributes* attrs = nullptr);
+   * @param preferred_nodes Nodes storage shards should prefer when doing
+   *                       single copy delivery, fastest first. Must be set
+   *                       iff the SCD_PREFERRED_NODES flag is set.
+   */
+  virtual int
+  sendStartMessage(ShardID shard,
+                   SocketCallback* onclose,
+                   START_Header header,
+                   const small_shardset_t& filtered_out,
+                   const ReadStreamAttributes* attrs = nullptr,
+                   const std::vector<node_index_t>* preferred_nodes = nullptr);
 
   /**
    * Sends a message to the storage shard to stop sending records.
@@ -226,6 +242,24 @@ class ClientReadStreamDependencies {
     return record_callback_ ? record_callback_(record) : true;
   }
 
+  /**
+   * @return true if the application supplied a callback to deliver runs of
+   *         records with; see recordBatchCallback().
+   */
+  virtual bool hasRecordBatchCallback() const {
+    return record_batch_callback_ != nullptr;
+  }
+
+  /**
+   * Call the application-supplied callback to deliver a run of consecutive
+   * records. Same contract as recordCallback(): if this returns false, none
+   * of the records were drained.
+   */
+  virtual bool
+  recordBatchCallback(folly::Range<std::unique_ptr<DataRecord>*> records) {
+    return record_batch_callback_(log_id_, records);
+  }
+
   /**
    * Call the application-supplied callback to report a gap.
    */
@@ -294,6 +328,15 @@ class ClientReadStreamDependencies {
   virtual std::unique_ptr<Timer>
   createTimer(std::function<void()> cb = nullptr);
 
+  /**
+   * Queues the scheduled rewind of this stream with the other rewinds on this
+   * worker. See AllClientReadStreams::queueRewind().
+   *
+   * @return false if rewinds are not batched, in which case the caller
+   *         should rewind right away.
+   */
+  virtual bool queueRewind();
+
   /**
    * Returns the callback that resolves a ClientReadStream id to an instance
    */
@@ -320,10 +363,26 @@ class ClientReadStreamDependencies {
                                         const EpochMetaData& metadata,
                                         MetaDataLogReader::RecordSource source);
 
+  /**
+   * Start fetching the epoch metadata for `epoch` and the epochs after it
+   * into the epoch metadata cache, so that a later getMetaDataForEpoch()
+   * for these epochs is a cache hit. Only fetches metadata of epochs that are
+   * already released. No-op if there is no cache, if `epoch` is already
+   * cached or if a prefetch is already in flight.
+   *
+   * Independent of the request made by getMetaDataForEpoch(); doesn't call
+   * back into the read stream.
+   */
+  virtual void prefetchMetaDataForEpoch(epoch_t epoch);
+
   virtual void setReaderName(const std::string& reader_name) {
     reader_name_ = reader_name;
   }
 
+  void setRecordBatchCallback(record_batch_cb_t cb) {
+    record_batch_callback_ = std::move(cb);
+  }
+
   read_stream_id_t getReadStreamID() const {
     return read_stream_id_;
   }
@@ -346,6 +405,17 @@ class ClientReadStreamDependencies {
 
   virtual bool hasMemoryPressure() const;
 
+  /**
+   * Proxies for Processor::reserveReadWindowMemory() and
+   * Processor::releaseReadWindowMemory().
+   */
+  virtual bool reserveWindowMemory(size_t bytes);
+  virtual void releaseWindowMemory(size_t bytes);
+
+  virtual std::chrono::steady_clock::time_point getCurrentTime() const {
+    return std::chrono::steady_clock::now();
+  }
+
   virtual bool isWorkerOverloaded() const;
 
  private:
@@ -354,6 +424,7 @@ class ClientReadStreamDependencies {
   std::string client_session_id_;
   std::string reader_name_;
   record_cb_t record_callback_;
+  record_batch_cb_t record_batch_callback_;
   gap_cb_t gap_callback_;
   done_cb_t done_callback_;
   // If our owner requested health updates, this is the callback.
@@ -376,6 +447,13 @@ class ClientReadStreamDependencies {
 
   // currently running NodeSetFinder
   std::unique_ptr<NodeSetFinder> nodeset_finder_;
+
+  // NodeSetFinder started by prefetchMetaDataForEpoch(), if any
+  std::unique_ptr<NodeSetFinder> prefetch_nodeset_finder_;
+
+  // Processor that reserveWindowMemory() reserved memory from. Processor
+  // outlives read streams.
+  Processor* window_memory_processor_{nullptr};
 };
 
 /**
@@ -595,6 +673,16 @@ class ClientReadStream : boost::noncopyable {
     addStartFlags(START_Header::INCLUDE_BYTE_OFFSET);
   }
 
+  /**
+   * Start with a window of `min_window_size` records and resize it each time
+   * it slides so that it covers the records delivered during a round trip to
+   * the senders, between `min_window_size` and the buffer capacity. Growth
+   * beyond `min_window_size` is bounded by the memory budget shared by all
+   * read streams (see ClientReadStreamDependencies::reserveWindowMemory()).
+   * This must not be called after start().
+   */
+  void enableWindowAutoTuning(size_t min_window_size);
+
   /**
    * By default the read stream will attempt to read from and update the
    * epoch metadata cache when fetching epoch metadata if possbile. This
@@ -652,6 +740,21 @@ class ClientReadStream : boost::noncopyable {
    */
   void onSettingsUpdated();
 
+  /**
+   * Called by AllClientReadStreams when nodes were reported dead by
+   * ClusterState or the worker's graylist changed.
+   * @see ClientReadStreamScd::onNodeHealthChanged().
+   */
+  void
+  onNodeHealthChanged(const std::unordered_set<node_index_t>& dead_nodes,
+                      const std::unordered_set<node_index_t>& graylisted_nodes);
+
+  /**
+   * Called by AllClientReadStreams when the rewind queued through
+   * ClientReadStreamDependencies::queueRewind() is due.
+   */
+  void onQueuedRewindDue();
+
   /**
    * Called when we know of a change in authoritativeness of a shard either
    * because the shard sent a message STARTED(E::REBUILDING) or because we were
@@ -763,6 +866,15 @@ class ClientReadStream : boost::noncopyable {
    */
   void resumeReading();
 
+  /**
+   * @return true if this stream can be replaced by a new one starting at
+   *         getNextLSNToDeliver() without the application missing or seeing
+   *         twice a record or gap: everything before that LSN was delivered,
+   *         no gap is held back and no delivery is being retried. Used to
+   *         move read streams between workers.
+   */
+  bool canResumeElsewhere() const;
+
   /**
    * Attempts to deliver a NOTINCONFIG Gap record to the client. When
    * successful, this ReadStream is destroyed. If it is not, we will try to
@@ -933,13 +1045,57 @@ class ClientReadStream : boost::noncopyable {
    */
   int deliverRecord(std::unique_ptr<DataRecordOwnsPayload>& record);
 
+  /**
+   * @return true if the record in `rstate` can be delivered with the record
+   *         batch callback of the application by deliverRecordBatch().
+   */
+  bool canDeliverInBatch(const RecordState& rstate) const;
+
+  /**
+   * Delivers the run of consecutive records at the front of the buffer for
+   * which canDeliverInBatch() is true with one call of the record batch
+   * callback, and pops them from the buffer.
+   *
+   * @return 0 on success, -1 on failure (downstream didn't accept)
+   */
+  int deliverRecordBatch();
+
+  // Bumps stats and counters after records were delivered to the application.
+  void onRecordsDelivered(size_t nrecords, uint64_t nbytes);
+
+  // With --client-read-stage-timing, returns the start time of a stage of the
+  // read path measured in the client_read_*_usec stats, otherwise folly::none.
+  folly::Optional<std::chrono::steady_clock::time_point>
+  stageTimingStart() const;
+
+  // Adds the time since `start` to client_read_delivery_usec.
+  void addDeliveryTime(
+      const folly::Optional<std::chrono::steady_clock::time_point>& start);
+
   /**
    * Attempts to delivers parameter gap record.
    *
+   * While findGapsAndRecords() runs with --client-read-coalesce-gaps, BRIDGE,
+   * HOLE and FILTERED_OUT gaps that don't reach until_lsn_ are held back in
+   * coalesced_gap_ instead, and extended by adjacent gaps of the same type.
+   * They are delivered by flushCoalescedGap() before anything else.
+   *
    * @return 0 on success, -1 on failure (downstream didn't accept)
    */
   int deliverGap(GapType type, lsn_t lo, lsn_t hi);
 
+  // Delivers a gap to the application or Reader right away.
+  int deliverGapNow(GapType type, lsn_t lo, lsn_t hi);
+
+  /**
+   * Delivers coalesced_gap_, if any.
+   *
+   * @return 0 on success or if there was nothing to deliver, -1 if delivery
+   *         failed, in which case coalesced_gap_ is kept and the redelivery
+   *         timer retries.
+   */
+  int flushCoalescedGap();
+
   /**
    * Attempts to deliver access Gap record to the client. When successful, this
    * ReadStream is destroyed. If it is not, all out going data records are
@@ -1183,6 +1339,14 @@ class ClientReadStream : boost::noncopyable {
                                    epoch_t until,
                                    MetaDataLogReader::RecordSource source);
 
+  /**
+   * If the read stream is getting close to last_epoch_with_metadata_ and the
+   * next epoch is already released, asks deps_ to prefetch the metadata of
+   * the next epochs into the epoch metadata cache. See
+   * --client-read-stream-metadata-prefetch-epochs.
+   */
+  void maybePrefetchEpochMetaData();
+
   /**
    * Update the storage_set_states_ according to current epoch metadata
    * configuration and cluster configuration. Called when the read stream
@@ -1272,6 +1436,14 @@ class ClientReadStream : boost::noncopyable {
   // record before the grace period timer fired
   void updateGraceCounters();
 
+  // With window auto-tuning, the window size that covers the LSNs delivered
+  // during a round trip, given the delivery rate since the window last slid.
+  size_t autoTunedWindowSize();
+
+  // Sets window_size_ and, with window auto-tuning, adjusts the memory
+  // reserved for it. Doesn't grow the window if the reservation fails.
+  void setWindowSize(size_t window_size);
+
   // Check whether checkFMajority() should enable grace period timer and wait
   // for grace period.
   bool shouldWaitForGracePeriod(FmajorityResult fmajority_result,
@@ -1444,6 +1616,25 @@ class ClientReadStream : boost::noncopyable {
    */
   size_t window_size_;
 
+  struct WindowAutoTuning {
+    size_t min_window_size;
+    // Moving average of the time between sending START to a sender and
+    // getting STARTED back, zero until the first STARTED.
+    std::chrono::microseconds rtt{0};
+    // Moving average of the size of records received, in bytes.
+    double avg_record_bytes{0};
+    // next_lsn_to_deliver_ and time when the window last slid, to measure the
+    // delivery rate.
+    lsn_t last_slide_lsn{LSN_INVALID};
+    std::chrono::steady_clock::time_point last_slide_time;
+    // Bytes reserved with deps_->reserveWindowMemory() for the part of the
+    // window above min_window_size.
+    size_t reserved_bytes{0};
+  };
+
+  // Set by enableWindowAutoTuning().
+  folly::Optional<WindowAutoTuning> window_autotuning_;
+
   /**
    * The largest LSN in sender's sliding window. This member variable
    * is employed to avoid doing the math every time we call
@@ -1469,6 +1660,10 @@ class ClientReadStream : boost::noncopyable {
   // highest epoch whose metadata is ever requested by the read stream
   folly::Optional<epoch_t> epoch_metadata_requested_;
 
+  // highest epoch maybePrefetchEpochMetaData() asked to prefetch the metadata
+  // of
+  epoch_t epoch_metadata_prefetched_{EPOCH_INVALID};
+
   // this is the epoch of the last released LSN at the time when the read stream
   // issued the last epoch metadata request. Used to determine the `effective
   // until epoch' of record gotten from metadata logs
@@ -1613,6 +1808,17 @@ class ClientReadStream : boost::noncopyable {
   // callback.
   bool inside_callback_ = false;
 
+  // Records passed to the record batch callback by deliverRecordBatch() and
+  // the buffer slots they came from. Members only to reuse the allocations.
+  std::vector<std::unique_ptr<DataRecord>> delivery_batch_;
+  std::vector<RecordState*> delivery_batch_slots_;
+
+  // True while findGapsAndRecords() may hold back gaps in coalesced_gap_.
+  bool coalescing_gaps_ = false;
+  // Gap that deliverGap() held back to merge it with the next one, see
+  // deliverGap(). next_lsn_to_deliver_ is already past it.
+  folly::Optional<GapRecord> coalesced_gap_;
+
   // If `true`, there's an ongoing rewind, and any rewinds scheduled now will
   // be unscheduled and merged into the current rewind instead. This flag
   // is used to avoid updating rewind-scheduling stats in this situation.
@@ -11,6 +11,7 @@
 
 #include "logdevice/common/client_read_stream/ClientReadStreamCircularBuffer.h"
 #include "logdevice/common/client_read_stream/ClientReadStreamOrderedMapBuffer.h"
+#include "logdevice/common/client_read_stream/ClientReadStreamSortedVectorBuffer.h"
 
 namespace facebook { namespace logdevice {
 
@@ -21,13 +22,22 @@ namespace facebook { namespace logdevice {
 enum class ClientReadStreamBufferType : uint8_t {
   CIRCULAR = 0,
   ORDERED_MAP,
+  SORTED_VECTOR,
 };
 
 class ClientReadStreamBufferFactory {
  public:
+  // ORDERED_MAP buffers whose capacity is at least this large are created as
+  // SORTED_VECTOR buffers, which hold many descriptors more compactly
+  static constexpr size_t kSortedVectorMinCapacity = 1ul << 16;
+
   static std::unique_ptr<ClientReadStreamBuffer>
   create(ClientReadStreamBufferType type, size_t capacity, lsn_t buffer_head) {
     ld_check(capacity > 0);
+    if (type == ClientReadStreamBufferType::ORDERED_MAP &&
+        capacity >= kSortedVectorMinCapacity) {
+      type = ClientReadStreamBufferType::SORTED_VECTOR;
+    }
     switch (type) {
       case ClientReadStreamBufferType::CIRCULAR:
         return std::make_unique<ClientReadStreamCircularBuffer>(
@@ -35,6 +45,9 @@ class ClientReadStreamBufferFactory {
       case ClientReadStreamBufferType::ORDERED_MAP:
         return std::make_unique<ClientReadStreamOrderedMapBuffer>(
             capacity, buffer_head);
+      case ClientReadStreamBufferType::SORTED_VECTOR:
+        return std::make_unique<ClientReadStreamSortedVectorBuffer>(
+            capacity, buffer_head);
     }
 
     ld_check(false);
@@ -16,13 +16,74 @@ namespace facebook { namespace logdevice {
 
 using RecordState = ClientReadStreamRecordState;
 
+// true if the slot holds neither a record nor a gap marker
+static bool isPlaceholder(const RecordState& state) {
+  return !state.record && !state.gap && !state.filtered_out;
+}
+
+ClientReadStreamCircularBuffer::ClientReadStreamCircularBuffer(
+    size_t capacity,
+    lsn_t buffer_head)
+    : capacity_(capacity),
+      chunks_((capacity + kSlotsPerChunk - 1) / kSlotsPerChunk),
+      buffer_head_(buffer_head) {
+  ld_check(capacity > 0);
+}
+
+ClientReadStreamCircularBuffer::~ClientReadStreamCircularBuffer() = default;
+
+RecordState* ClientReadStreamCircularBuffer::getSlot(size_t index,
+                                                     bool allocate) {
+  const size_t pos = getPosition(index);
+  const size_t chunk = pos / kSlotsPerChunk;
+  if (!chunks_[chunk]) {
+    if (!allocate) {
+      return nullptr;
+    }
+    if (spare_chunk_ && chunkSize(chunk) == kSlotsPerChunk) {
+      chunks_[chunk] = std::move(spare_chunk_);
+    } else {
+      chunks_[chunk] = std::make_unique<RecordState[]>(chunkSize(chunk));
+    }
+  }
+  return &chunks_[chunk][pos % kSlotsPerChunk];
+}
+
+void ClientReadStreamCircularBuffer::maybeReleaseChunk(size_t chunk) {
+  if (!chunks_[chunk]) {
+    return;
+  }
+  const size_t n = chunkSize(chunk);
+  for (size_t i = 0; i < n; ++i) {
+    if (!isPlaceholder(chunks_[chunk][i])) {
+      return;
+    }
+    ld_check(chunks_[chunk][i].list.empty());
+  }
+  if (!spare_chunk_ && n == kSlotsPerChunk) {
+    spare_chunk_ = std::move(chunks_[chunk]);
+  } else {
+    chunks_[chunk].reset();
+  }
+}
+
+size_t ClientReadStreamCircularBuffer::allocatedSlots() const {
+  size_t res = 0;
+  for (size_t i = 0; i < chunks_.size(); ++i) {
+    if (chunks_[i]) {
+      res += chunkSize(i);
+    }
+  }
+  return res;
+}
+
 RecordState* ClientReadStreamCircularBuffer::createOrGet(lsn_t lsn) {
   // lsn must be with in the range of
   // [buffer_head, buffer_head + capacity() - 1]
   if (!LSNInBuffer(lsn)) {
     return nullptr;
   }
-  return &buffer_[getIndex(lsn)];
+  return getSlot(getIndex(lsn), /*allocate=*/true);
 }
 
 RecordState* ClientReadStreamCircularBuffer::find(lsn_t lsn) {
@@ -30,15 +91,15 @@ RecordState* ClientReadStreamCircularBuffer::find(lsn_t lsn) {
     return nullptr;
   }
 
-  RecordState& state = buffer_[getIndex(lsn)];
-  if (!state.record && !state.gap && !state.filtered_out) {
+  RecordState* state = getSlot(getIndex(lsn), /*allocate=*/false);
+  if (!state || isPlaceholder(*state)) {
     // this is an empty placeholder RecordState, treat it as not
     // exist
-    ld_check(state.list.empty());
+    ld_check(!state || state->list.empty());
     return nullptr;
   }
 
-  return &state;
+  return state;
 }
 
 std::pair<ClientReadStreamRecordState*, lsn_t>
@@ -48,13 +109,23 @@ ClientReadStreamCircularBuffer::findFirstMarker() {
   size_t limit =
       std::min(capacity(), LSN_MAX - std::max(buffer_head_, 1lu) + 1);
 
-  for (size_t i = 0; i < limit; ++i) {
-    if (buffer_[i].gap || buffer_[i].record || buffer_[i].filtered_out) {
-      return std::make_pair(&buffer_[i], getLSN(i));
+  size_t i = 0;
+  while (i < limit) {
+    const size_t pos = getPosition(i);
+    const size_t chunk = pos / kSlotsPerChunk;
+    if (!chunks_[chunk]) {
+      // skip the rest of an unallocated chunk
+      i += chunk * kSlotsPerChunk + chunkSize(chunk) - pos;
+      continue;
+    }
+    RecordState& state = chunks_[chunk][pos % kSlotsPerChunk];
+    if (!isPlaceholder(state)) {
+      return std::make_pair(&state, getLSN(i));
     }
     // for slot that is not a record/gap marker, its list must be
     // empty
-    ld_check(buffer_[i].list.empty());
+    ld_check(state.list.empty());
+    ++i;
   }
 
   // no gap/record marker in buffer
@@ -62,21 +133,25 @@ ClientReadStreamCircularBuffer::findFirstMarker() {
 }
 
 ClientReadStreamRecordState* ClientReadStreamCircularBuffer::front() {
-  if (buffer_.front().record || buffer_.front().gap ||
-      buffer_.front().filtered_out) {
-    return &buffer_.front();
+  RecordState* state = getSlot(0, /*allocate=*/false);
+  if (state && !isPlaceholder(*state)) {
+    return state;
   }
 
   // the descriptor is a placeholder, return nullptr
-  ld_check(buffer_.front().list.empty());
+  ld_check(!state || state->list.empty());
   return nullptr;
 }
 
 void ClientReadStreamCircularBuffer::popFront() {
+  RecordState* state = getSlot(0, /*allocate=*/false);
+  if (!state) {
+    return;
+  }
   // record and list, if exist, must be already consumed
-  ld_check(!buffer_.front().record && !buffer_.front().filtered_out);
-  ld_check(buffer_.front().list.empty());
-  buffer_.front().reset();
+  ld_check(!state->record && !state->filtered_out);
+  ld_check(state->list.empty());
+  state->reset();
 }
 
 void ClientReadStreamCircularBuffer::advanceBufferHead(size_t offset) {
@@ -87,19 +162,48 @@ void ClientReadStreamCircularBuffer::advanceBufferHead(size_t offset) {
     size_t limit =
         std::min(std::min(offset, capacity()), LSN_MAX - buffer_head_ + 1);
     for (size_t i = 0; i < limit; ++i) {
-      ld_check(!buffer_[i].gap && !buffer_[i].record &&
-               !buffer_[i].filtered_out);
-      ld_check(buffer_[i].list.empty());
+      const RecordState* state = getSlot(i, /*allocate=*/false);
+      ld_check(!state || isPlaceholder(*state));
+      ld_check(!state || state->list.empty());
     }
   }
 
-  buffer_.rotate(offset);
+  // Rotate the ring chunk by chunk, releasing the chunks the buffer head
+  // leaves if they are empty.
+  size_t remaining = std::min(offset, capacity_);
+  size_t pos = front_;
+  while (remaining > 0) {
+    const size_t chunk = pos / kSlotsPerChunk;
+    const size_t chunk_end = chunk * kSlotsPerChunk + chunkSize(chunk);
+    const size_t n = std::min(remaining, chunk_end - pos);
+    pos += n;
+    remaining -= n;
+    if (pos == chunk_end) {
+      maybeReleaseChunk(chunk);
+      if (pos == capacity_) {
+        pos = 0;
+      }
+    }
+  }
+  if (offset >= capacity_) {
+    // went all the way around the ring
+    ld_check(pos == front_);
+    pos = (front_ + offset % capacity_) % capacity_;
+  }
+  front_ = pos;
   buffer_head_ += offset;
 }
 
 void ClientReadStreamCircularBuffer::clear() {
-  for (size_t i = 0; i < buffer_.size(); ++i) {
-    buffer_[i].reset();
+  for (size_t chunk = 0; chunk < chunks_.size(); ++chunk) {
+    if (!chunks_[chunk]) {
+      continue;
+    }
+    const size_t n = chunkSize(chunk);
+    for (size_t i = 0; i < n; ++i) {
+      chunks_[chunk][i].reset();
+    }
+    maybeReleaseChunk(chunk);
   }
 }
 
@@ -123,7 +227,9 @@ void ClientReadStreamCircularBuffer::forEach(
   size_t count = (reverse) ? from - to + 1 : to - from + 1;
   size_t limit = std::min(count, capacity());
   for (size_t i = 0; i < limit; i++) {
-    if (!cb(from, buffer_[getIndex(from)])) {
+    // The callback may turn a placeholder into a marker, so the slot has to
+    // be backed by memory.
+    if (!cb(from, *getSlot(getIndex(from), /*allocate=*/true))) {
       break;
     }
     from += (reverse) ? -1 : 1;
@@ -7,7 +7,11 @@
  */
 #pragma once
 
-#include "logdevice/common/CircularBuffer.h"
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "logdevice/common/checks.h"
 #include "logdevice/common/client_read_stream/ClientReadStreamBuffer.h"
 
 namespace facebook { namespace logdevice {
@@ -15,15 +19,24 @@ namespace facebook { namespace logdevice {
 /**
  * @file ClientReadStreamCircularBuffer is an implementatin of
  *       ClientReadStreamBuffer using a random access circular buffer. Each
- *       RecordState descriptor for LSNs in the buffer is preallocated as
- *       placeholders. Advancing the buffer head is implemented by simply
- *       rotating the circular buffer.
+ *       LSN in the buffer has a RecordState descriptor slot in the ring.
+ *       Advancing the buffer head is implemented by simply rotating the ring.
+ *
+ *       The ring is split into fixed-size chunks of slots that are allocated
+ *       when a slot in them is first needed and released when the buffer head
+ *       leaves them empty. A stream reading near the tail only keeps the few
+ *       chunks between the buffer head and the highest LSN it received, so
+ *       readers with thousands of streams don't pay for `capacity` slots per
+ *       stream, and the slots in use stay contiguous in memory. Slots never
+ *       move, so descriptor pointers stay valid until the slot is advanced
+ *       past.
  */
 
 class ClientReadStreamCircularBuffer : public ClientReadStreamBuffer {
  public:
-  ClientReadStreamCircularBuffer(size_t capacity, lsn_t buffer_head)
-      : buffer_(capacity), buffer_head_(buffer_head) {}
+  ClientReadStreamCircularBuffer(size_t capacity, lsn_t buffer_head);
+
+  ~ClientReadStreamCircularBuffer() override;
 
   // see ClientReadStreamBuffer::createOrGet()
   // complexity O(1)
@@ -51,7 +64,7 @@ class ClientReadStreamCircularBuffer : public ClientReadStreamBuffer {
 
   // see ClientReadStreamBuffer::capacity()
   size_t capacity() const override {
-    return buffer_.size();
+    return capacity_;
   }
 
   // see ClientReadStreamBuffer::clear()
@@ -77,7 +90,15 @@ class ClientReadStreamCircularBuffer : public ClientReadStreamBuffer {
     return buffer_head_;
   }
 
+  // Number of descriptor slots currently backed by memory.
+  size_t allocatedSlots() const;
+
+  // Descriptor slots are allocated in chunks of this many
+  static constexpr size_t kSlotsPerChunk = 64;
+
  private:
+  using Chunk = std::unique_ptr<ClientReadStreamRecordState[]>;
+
   // get the index for the given lsn. lsn must fit in the current buffer
   size_t getIndex(lsn_t lsn) const {
     ld_assert(LSNInBuffer(lsn));
@@ -92,8 +113,38 @@ class ClientReadStreamCircularBuffer : public ClientReadStreamBuffer {
     return buffer_head_ + index;
   }
 
-  // circular buffer that holds all descriptors
-  CircularBuffer<ClientReadStreamRecordState> buffer_;
+  // position in the ring of the slot `index` slots after the buffer head
+  size_t getPosition(size_t index) const {
+    ld_check(index < capacity_);
+    return index < capacity_ - front_ ? front_ + index
+                                      : index - (capacity_ - front_);
+  }
+
+  // number of slots in the given chunk; the last one may be shorter
+  size_t chunkSize(size_t chunk) const {
+    ld_check(chunk < chunks_.size());
+    return std::min(kSlotsPerChunk, capacity_ - chunk * kSlotsPerChunk);
+  }
+
+  // Returns the descriptor in the slot `index` slots after the buffer head.
+  // If the chunk of the slot is not allocated, the slot is an empty
+  // placeholder; the chunk is then allocated if `allocate` is true, otherwise
+  // nullptr is returned.
+  ClientReadStreamRecordState* getSlot(size_t index, bool allocate);
+
+  // Frees the chunk if none of its slots holds a marker.
+  void maybeReleaseChunk(size_t chunk);
+
+  const size_t capacity_;
+  // ring of capacity_ descriptor slots, kSlotsPerChunk slots per chunk;
+  // a null chunk only has empty placeholder slots
+  std::vector<Chunk> chunks_;
+  // A released full-size chunk kept for reuse, so that a stream steadily
+  // moving through the ring doesn't free and allocate a chunk every
+  // kSlotsPerChunk records.
+  Chunk spare_chunk_;
+  // position in the ring of the slot for the buffer head
+  size_t front_ = 0;
   // tracks the buffer head
   lsn_t buffer_head_;
 };
@@ -304,6 +304,19 @@ void ClientReadStreamFailureDetector::checkForShardsBlockingWindow(TS now) {
   }
 }
 
+ClientReadStreamFailureDetector::Samples
+ClientReadStreamFailureDetector::getShardLatencies(TS now) {
+  Samples samples;
+  samples.reserve(shards_.size());
+  for (auto& p : shards_) {
+    p.second.moving_avg->update(now);
+    if (p.second.moving_avg->count() > 0) {
+      samples.emplace_back(p.first, p.second.moving_avg->avg());
+    }
+  }
+  return samples;
+}
+
 ClientReadStreamFailureDetector::Samples
 ClientReadStreamFailureDetector::generateSamples(WindowState& window, TS now) {
   const std::chrono::milliseconds delta =
@@ -192,6 +192,13 @@ class ClientReadStreamFailureDetector {
   using Sample = std::pair<ShardID, TS::rep>;
   using Samples = std::vector<Sample>;
 
+  /**
+   * @return average time (in ms) it took each tracked shard to complete a
+   *         window over the last `moving_avg_duration`. Shards that did not
+   *         complete any window during that time are omitted.
+   */
+  Samples getShardLatencies(TS now);
+
   // Look at which shards have not completed the current window. If the number
   // of such shards is small enough, run the outlier detection algorithm (by
   // calling findShardsBlockingWindow()). If the algorithm does not detect
@@ -7,6 +7,11 @@
  */
 #include "logdevice/common/client_read_stream/ClientReadStreamScd.h"
 
+#include <algorithm>
+#include <limits>
+#include <tuple>
+#include <unordered_map>
+
 #include "folly/container/Array.h"
 #include "logdevice/common/DataRecordOwnsPayload.h"
 #include "logdevice/common/Timer.h"
@@ -339,6 +344,11 @@ bool ClientReadStreamScd::FilteredOut::eraseShard(ShardID shard) {
 }
 
 void ClientReadStreamScd::applyScheduledChanges() {
+  if (scheduled_preferred_nodes_.has_value()) {
+    preferred_nodes_ = std::move(scheduled_preferred_nodes_.value());
+    scheduled_preferred_nodes_.reset();
+  }
+
   if (!scheduledTransitionTo(Mode::ALL_SEND_ALL) &&
       filtered_out_.applyDeferredChanges()) {
     updateFailureDetectorWorkingSet();
@@ -528,6 +538,89 @@ void ClientReadStreamScd::onWindowSlid(lsn_t hi,
   if (outlier_detector_) {
     outlier_detector_->onWindowSlid(hi, filter_version);
   }
+  maybeUpdatePreferredNodes();
+}
+
+void ClientReadStreamScd::maybeUpdatePreferredNodes() {
+  const auto interval =
+      owner_->deps_->getSettings().scd_replica_ranking_interval;
+
+  std::vector<node_index_t> ranking;
+  if (interval.count() > 0 && outlier_detector_ && isActive()) {
+    const auto now = SteadyTimestamp::now();
+    if (now - last_ranking_time_ < interval) {
+      return;
+    }
+    last_ranking_time_ = now;
+    ranking = rankNodes(now);
+  }
+
+  const auto& current = scheduled_preferred_nodes_.has_value()
+      ? scheduled_preferred_nodes_.value()
+      : preferred_nodes_;
+  if (ranking == current) {
+    return;
+  }
+
+  // All storage shards must use the same ranking, otherwise some records
+  // might be shipped by no shard. Send the new ranking to all of them with a
+  // rewind.
+  scheduled_preferred_nodes_ = std::move(ranking);
+  owner_->scheduleRewind(
+      RewindReason::REPLICA_RANKING_CHANGED, "replica ranking changed");
+}
+
+std::vector<node_index_t>
+ClientReadStreamScd::rankNodes(SteadyTimestamp now) const {
+  ld_check(outlier_detector_);
+  auto samples = outlier_detector_->getShardLatencies(now);
+  if (samples.empty()) {
+    return {};
+  }
+
+  // A node may have several shards in the read set, use the slowest one.
+  // Nodes we have no measurement for are ranked after the others.
+  using Latency = ClientReadStreamFailureDetector::TS::rep;
+  const Latency kUnknown = std::numeric_limits<Latency>::max();
+  std::unordered_map<node_index_t, Latency> latencies;
+  for (const auto& it : owner_->storage_set_states_) {
+    latencies.emplace(it.first.node(), kUnknown);
+  }
+  for (const auto& sample : samples) {
+    auto it = latencies.find(sample.first.node());
+    if (it != latencies.end()) {
+      it->second = it->second == kUnknown
+          ? sample.second
+          : std::max(it->second, sample.second);
+    }
+  }
+
+  const auto& client_location = owner_->deps_->getSettings().client_location;
+  const auto& nodes_configuration =
+      owner_->getConfig()->getNodesConfiguration();
+  auto is_remote = [&](node_index_t node) {
+    if (!client_location.has_value()) {
+      return false;
+    }
+    const auto* sd = nodes_configuration->getNodeServiceDiscovery(node);
+    return !sd || !sd->location.has_value() ||
+        !client_location->sharesScopeWith(
+            sd->location.value(), NodeLocationScope::REGION);
+  };
+
+  std::vector<std::tuple<bool, Latency, node_index_t>> keys;
+  keys.reserve(latencies.size());
+  for (const auto& it : latencies) {
+    keys.emplace_back(is_remote(it.first), it.second, it.first);
+  }
+  std::sort(keys.begin(), keys.end());
+
+  std::vector<node_index_t> ranking;
+  ranking.reserve(keys.size());
+  for (const auto& key : keys) {
+    ranking.push_back(std::get<2>(key));
+  }
+  return ranking;
 }
 
 void ClientReadStreamScd::onOutliersChanged(ShardSet outliers,
@@ -564,6 +657,19 @@ void ClientReadStreamScd::rewindWithOutliers(ShardSet outliers,
   }
   ld_check(isActive());
 
+  if (!graylisted_shards_.empty() && owner_->current_metadata_) {
+    // Filter out graylisted shards too, but leave enough shards to read each
+    // record from.
+    const size_t max_filtered_out = std::max(
+        owner_->current_metadata_->replication.getReplicationFactor() - 1, 0);
+    for (ShardID shard : graylisted_shards_) {
+      if (outliers.size() + getShardsDown().size() >= max_filtered_out) {
+        break;
+      }
+      outliers.insert(shard);
+    }
+  }
+
   if (filtered_out_.deferredChangeShardsSlow(outliers)) {
     owner_->scheduleRewind(
         reason,
@@ -575,6 +681,51 @@ void ClientReadStreamScd::rewindWithOutliers(ShardSet outliers,
   }
 }
 
+ShardSet ClientReadStreamScd::getDetectorOutliers() const {
+  if (!outlier_detector_ ||
+      owner_->deps_->getSettings().reader_slow_shards_detection !=
+          Settings::ReaderSlowShardDetectionState::ENABLED) {
+    return ShardSet{};
+  }
+  return outlier_detector_->getCurrentOutliers();
+}
+
+void ClientReadStreamScd::onNodeHealthChanged(
+    const std::unordered_set<node_index_t>& dead_nodes,
+    const std::unordered_set<node_index_t>& graylisted_nodes) {
+  if (!isActive() || scheduledTransitionTo(Mode::ALL_SEND_ALL)) {
+    return;
+  }
+
+  std::vector<ShardID> graylisted;
+  for (const auto& it : owner_->storage_set_states_) {
+    const ShardID shard = it.first;
+    if (dead_nodes.count(shard.node())) {
+      addToShardsDownAndScheduleRewind(
+          shard,
+          RewindReason::NODE_DEAD,
+          folly::format("{} added to known down list because cluster state "
+                        "reports its node dead",
+                        shard.toString())
+              .str());
+    }
+    if (graylisted_nodes.count(shard.node())) {
+      graylisted.push_back(shard);
+    }
+  }
+
+  std::sort(graylisted.begin(), graylisted.end());
+  if (graylisted != graylisted_shards_) {
+    graylisted_shards_ = std::move(graylisted);
+    rewindWithOutliers(
+        getDetectorOutliers(),
+        RewindReason::NODE_GRAYLISTED,
+        folly::format("graylisted shards changed to {}",
+                      toString(graylisted_shards_).c_str())
+            .str());
+  }
+}
+
 bool ClientReadStreamScd::updateStorageShardsSet(
     const StorageSet& storage_set,
     const ReplicationProperty& replication) {
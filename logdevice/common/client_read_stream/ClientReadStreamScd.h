@@ -7,6 +7,9 @@
  */
 #pragma once
 
+#include <unordered_set>
+#include <vector>
+
 #include <boost/noncopyable.hpp>
 #include <folly/FBVector.h>
 
@@ -214,6 +217,14 @@ class ClientReadStreamScd : public boost::noncopyable {
     return filtered_out_.getAllShards();
   }
 
+  /**
+   * @return Nodes storage shards should prefer when picking which shard ships
+   * a record, fastest first. Empty if replica ranking is disabled.
+   */
+  const std::vector<node_index_t>& getPreferredNodes() const {
+    return preferred_nodes_;
+  }
+
   /**
    * @return List of shards considered down.
    */
@@ -269,6 +280,21 @@ class ClientReadStreamScd : public boost::noncopyable {
                                         RewindReason reason,
                                         std::string reason_str);
 
+  /**
+   * Called by AllClientReadStreams with nodes that ClusterState reported dead
+   * and the nodes currently graylisted by the worker's GraylistingTracker,
+   * if Settings::reader_health_signals_failover is set.
+   *
+   * Shards of dead nodes are added to the shards down list, like when the
+   * socket to them is closed. Graylisted shards are added to the shards slow
+   * list next to the outliers found by ClientReadStreamFailureDetector, as
+   * long as fewer than replication factor shards are filtered out. Either
+   * schedules a rewind, so several calls in a row rewind the stream once.
+   */
+  void
+  onNodeHealthChanged(const std::unordered_set<node_index_t>& dead_nodes,
+                      const std::unordered_set<node_index_t>& graylisted_nodes);
+
   /**
    * Called when ClientReadStream changed the GapState of a sender.
    * Used to maintain a proper accounting of the number of shards in the
@@ -465,12 +491,19 @@ class ClientReadStreamScd : public boost::noncopyable {
 
   FilteredOut filtered_out_;
 
+  // Shards in the read set whose nodes are graylisted, sorted. Set by
+  // onNodeHealthChanged().
+  std::vector<ShardID> graylisted_shards_;
+
+  // Outliers currently reported by the outlier detector, if it is enabled.
+  ShardSet getDetectorOutliers() const;
+
   // Callback called by ClientReadStreamFailureDetector when it detects
   // outliers.  Will blacklist the outliers according to SCD rules if the
   // outlier detector is not configured in observe-only mode.
   void onOutliersChanged(ShardSet outliers, std::string reason);
-  // Blacklist a set of outliers according to SCD rules. No-op if this read
-  // stream is in ALL_SEND_ALL mode.
+  // Blacklist a set of outliers, and graylisted_shards_, according to SCD
+  // rules. No-op if this read stream is in ALL_SEND_ALL mode.
   void rewindWithOutliers(ShardSet outliers,
                           RewindReason reason,
                           std::string reason_str);
@@ -479,6 +512,26 @@ class ClientReadStreamScd : public boost::noncopyable {
   // shards is enabled.
   bool isSlowShardsDetectionEnabled();
 
+  // Nodes sent to storage shards in START so that each record is shipped by
+  // the closest and fastest of its replicas. See getPreferredNodes().
+  std::vector<node_index_t> preferred_nodes_;
+
+  // Set when the ranking changed and a rewind was scheduled to send it.
+  // Moved to `preferred_nodes_' by applyScheduledChanges().
+  folly::Optional<std::vector<node_index_t>> scheduled_preferred_nodes_;
+
+  // Last time the nodes were ranked.
+  SteadyTimestamp last_ranking_time_;
+
+  // If scd-replica-ranking-interval elapsed since the last ranking, rank the
+  // nodes of the read set again and schedule a rewind if the ranking changed.
+  void maybeUpdatePreferredNodes();
+
+  // Ranks the nodes of the read set: nodes in the client's region first, then
+  // by the average time their shards took to complete a window, as measured
+  // by the outlier detector.
+  std::vector<node_index_t> rankNodes(SteadyTimestamp now) const;
+
   /**
    * Checks if we need to rewind after the storage shards set has been updated.
    *
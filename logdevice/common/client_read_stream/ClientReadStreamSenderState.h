@@ -126,6 +126,11 @@ class ClientReadStreamSenderState : boost::noncopyable {
   // behind the current filter version, but are catching up.
   filter_version_t last_received_filter_version;
 
+  // When the last START message to this sender was written to the socket.
+  // Used to estimate the round trip time to the sender when it replies with
+  // STARTED.
+  std::chrono::steady_clock::time_point start_sent_time;
+
   // BlacklistState of the sender shard, initialized to NONE. Must remain
   // NONE if single-copy-delivery is not enabled.
   BlacklistState blacklist_state = BlacklistState::NONE;
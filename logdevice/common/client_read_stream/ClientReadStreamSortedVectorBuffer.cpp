@@ -0,0 +1,293 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/client_read_stream/ClientReadStreamSortedVectorBuffer.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include "logdevice/common/DataRecordOwnsPayload.h"
+#include "logdevice/common/client_read_stream/ClientReadStream.h"
+#include "logdevice/common/debug.h"
+
+namespace facebook { namespace logdevice {
+
+using RecordState = ClientReadStreamRecordState;
+
+ClientReadStreamSortedVectorBuffer::~ClientReadStreamSortedVectorBuffer() =
+    default;
+
+RecordState* ClientReadStreamSortedVectorBuffer::createOrGet(lsn_t lsn) {
+  // lsn must be with in the range of
+  // [buffer_head, buffer_head + capacity() - 1]
+  if (!LSNInBuffer(lsn)) {
+    return nullptr;
+  }
+
+  if (chunks_.empty() || lsn > chunks_.back()->last()) {
+    // common case: records arrive in order and are appended
+    if (chunks_.empty() || chunks_.back()->full()) {
+      chunks_.push_back(newChunk());
+    }
+    Chunk& c = *chunks_.back();
+    c.lsns.push_back(lsn);
+    c.states.emplace_back();
+    return &c.states.back();
+  }
+
+  Pos pos = lowerBound(lsn);
+  ld_check(pos.chunk < chunks_.size());
+  Chunk& c = *chunks_[pos.chunk];
+  if (c.lsns[pos.idx] == lsn) {
+    return &c.states[pos.idx];
+  }
+  return insertAt(pos, lsn);
+}
+
+RecordState* ClientReadStreamSortedVectorBuffer::find(lsn_t lsn) {
+  if (chunks_.empty() || lsn < chunks_.front()->first()) {
+    return nullptr;
+  }
+
+  Pos pos = lowerBound(lsn);
+  if (pos.chunk == chunks_.size()) {
+    return nullptr;
+  }
+  Chunk& c = *chunks_[pos.chunk];
+  if (c.lsns[pos.idx] != lsn) {
+    return nullptr;
+  }
+
+  ld_assert(LSNInBuffer(lsn));
+  return &c.states[pos.idx];
+}
+
+std::pair<ClientReadStreamRecordState*, lsn_t>
+ClientReadStreamSortedVectorBuffer::findFirstMarker() {
+  if (chunks_.empty()) {
+    return std::make_pair(nullptr, LSN_INVALID);
+  }
+
+  Chunk& c = *chunks_.front();
+  ld_assert(LSNInBuffer(c.first()));
+  return std::make_pair(&c.states[c.begin], c.first());
+}
+
+ClientReadStreamRecordState* ClientReadStreamSortedVectorBuffer::front() {
+  if (chunks_.empty()) {
+    return nullptr;
+  }
+
+  Chunk& c = *chunks_.front();
+  if (c.first() > buffer_head_) {
+    return nullptr;
+  }
+
+  ld_check(c.first() == buffer_head_);
+  return &c.states[c.begin];
+}
+
+void ClientReadStreamSortedVectorBuffer::popFront() {
+  // record and list, if exist, must be already consumed
+  if (chunks_.empty()) {
+    return;
+  }
+
+  Chunk& c = *chunks_.front();
+  if (c.first() == buffer_head_) {
+    ld_check(!c.states[c.begin].record && !c.states[c.begin].filtered_out);
+    ld_check(c.states[c.begin].list.empty());
+    eraseAt(Pos{0, c.begin});
+  }
+}
+
+void ClientReadStreamSortedVectorBuffer::advanceBufferHead(size_t offset) {
+  // caller needs to ensure that there must not be any marker
+  // in the buffer slots that get advanced. assert this below.
+  ld_check(chunks_.empty() ||
+           chunks_.front()->first() >= buffer_head_ + offset);
+  buffer_head_ += offset;
+}
+
+void ClientReadStreamSortedVectorBuffer::clear() {
+  chunks_.clear();
+}
+
+size_t ClientReadStreamSortedVectorBuffer::size() const {
+  size_t n = 0;
+  for (const auto& c : chunks_) {
+    n += c->size();
+  }
+  return n;
+}
+
+void ClientReadStreamSortedVectorBuffer::forEach(
+    lsn_t from,
+    lsn_t to,
+    std::function<bool(lsn_t, ClientReadStreamRecordState& record)> cb) {
+  const bool reverse = from > to;
+
+  Pos pos = lowerBound(from);
+  bool valid = pos.chunk < chunks_.size();
+  if (reverse && (!valid || chunks_[pos.chunk]->lsns[pos.idx] != from)) {
+    valid = prev(pos);
+  }
+
+  while (valid) {
+    const lsn_t lsn = chunks_[pos.chunk]->lsns[pos.idx];
+    if ((reverse && lsn < to) || (!reverse && lsn > to)) {
+      break;
+    }
+
+    bool done = !cb(lsn, chunks_[pos.chunk]->states[pos.idx]);
+
+    // The callback may have created descriptors, which can move this one.
+    pos = lowerBound(lsn);
+    ld_check(pos.chunk < chunks_.size());
+    ld_check(chunks_[pos.chunk]->lsns[pos.idx] == lsn);
+    RecordState& rstate = chunks_[pos.chunk]->states[pos.idx];
+    if (!rstate.record && !rstate.gap && !rstate.filtered_out) {
+      ld_check(rstate.list.empty());
+      eraseAt(pos);
+    }
+
+    if (done || lsn == to) {
+      break;
+    }
+    if (reverse) {
+      pos = lowerBound(lsn);
+      valid = prev(pos);
+    } else {
+      pos = lowerBound(lsn + 1);
+      valid = pos.chunk < chunks_.size();
+    }
+  }
+}
+
+void ClientReadStreamSortedVectorBuffer::forEachUpto(
+    lsn_t to,
+    std::function<void(lsn_t, RecordState& record)> callback) {
+  if (chunks_.empty()) {
+    return;
+  }
+  auto from = chunks_.front()->first();
+  if (from > to) {
+    return;
+  }
+  forEach(from, to, [cb = std::move(callback)](lsn_t lsn, RecordState& rstate) {
+    cb(lsn, rstate);
+    return true;
+  });
+}
+
+ClientReadStreamSortedVectorBuffer::Pos
+ClientReadStreamSortedVectorBuffer::lowerBound(lsn_t lsn) const {
+  auto cit = std::lower_bound(
+      chunks_.begin(),
+      chunks_.end(),
+      lsn,
+      [](const std::unique_ptr<Chunk>& c, lsn_t l) { return c->last() < l; });
+  if (cit == chunks_.end()) {
+    return Pos{chunks_.size(), 0};
+  }
+  const Chunk& c = **cit;
+  auto it = std::lower_bound(c.lsns.begin() + c.begin, c.lsns.end(), lsn);
+  ld_check(it != c.lsns.end());
+  return Pos{static_cast<size_t>(std::distance(chunks_.begin(), cit)),
+             static_cast<size_t>(std::distance(c.lsns.begin(), it))};
+}
+
+bool ClientReadStreamSortedVectorBuffer::prev(Pos& pos) const {
+  if (pos.chunk < chunks_.size() && pos.idx > chunks_[pos.chunk]->begin) {
+    --pos.idx;
+    return true;
+  }
+  if (pos.chunk == 0) {
+    return false;
+  }
+  --pos.chunk;
+  pos.idx = chunks_[pos.chunk]->lsns.size() - 1;
+  return true;
+}
+
+RecordState* ClientReadStreamSortedVectorBuffer::insertAt(Pos pos,
+                                                          lsn_t lsn) {
+  Chunk& c = *chunks_[pos.chunk];
+  ld_check(lsn < c.lsns[pos.idx]);
+
+  if (pos.idx == c.begin) {
+    // reuse a popped slot in front of the chunk
+    if (c.begin > 0) {
+      --c.begin;
+      c.lsns[c.begin] = lsn;
+      c.states[c.begin] = RecordState();
+      return &c.states[c.begin];
+    }
+    // or append to the previous chunk
+    if (pos.chunk > 0 && !chunks_[pos.chunk - 1]->full()) {
+      Chunk& p = *chunks_[pos.chunk - 1];
+      p.lsns.push_back(lsn);
+      p.states.emplace_back();
+      return &p.states.back();
+    }
+  }
+
+  if (!c.full()) {
+    c.lsns.insert(c.lsns.begin() + pos.idx, lsn);
+    return &*c.states.emplace(c.states.begin() + pos.idx);
+  }
+
+  // The chunk is full, move the descriptors after the new one to a new chunk.
+  // Descriptors with lower LSNs stay where they are.
+  std::unique_ptr<Chunk> next = newChunk();
+  next->lsns.assign(c.lsns.begin() + pos.idx, c.lsns.end());
+  next->states.assign(std::make_move_iterator(c.states.begin() + pos.idx),
+                      std::make_move_iterator(c.states.end()));
+  c.lsns.erase(c.lsns.begin() + pos.idx, c.lsns.end());
+  c.states.erase(c.states.begin() + pos.idx, c.states.end());
+  c.lsns.push_back(lsn);
+  c.states.emplace_back();
+  chunks_.insert(chunks_.begin() + pos.chunk + 1, std::move(next));
+  return &c.states.back();
+}
+
+void ClientReadStreamSortedVectorBuffer::eraseAt(Pos pos) {
+  Chunk& c = *chunks_[pos.chunk];
+  if (pos.idx == c.begin) {
+    c.states[c.begin] = RecordState();
+    ++c.begin;
+  } else {
+    c.lsns.erase(c.lsns.begin() + pos.idx);
+    c.states.erase(c.states.begin() + pos.idx);
+  }
+  if (c.size() == 0) {
+    dropChunk(pos.chunk);
+  }
+}
+
+std::unique_ptr<ClientReadStreamSortedVectorBuffer::Chunk>
+ClientReadStreamSortedVectorBuffer::newChunk() {
+  if (spare_) {
+    return std::move(spare_);
+  }
+  auto c = std::make_unique<Chunk>();
+  c->lsns.reserve(kChunkSize);
+  c->states.reserve(kChunkSize);
+  return c;
+}
+
+void ClientReadStreamSortedVectorBuffer::dropChunk(size_t i) {
+  ld_check(chunks_[i]->size() == 0);
+  std::unique_ptr<Chunk> c = std::move(chunks_[i]);
+  chunks_.erase(chunks_.begin() + i);
+  c->lsns.clear();
+  c->states.clear();
+  c->begin = 0;
+  spare_ = std::move(c);
+}
+
+}} // namespace facebook::logdevice
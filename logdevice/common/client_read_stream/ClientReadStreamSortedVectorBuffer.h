@@ -0,0 +1,167 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "logdevice/common/client_read_stream/ClientReadStreamBuffer.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file ClientReadStreamSortedVectorBuffer is an implementation of
+ *       ClientReadStreamBuffer that, like ClientReadStreamOrderedMapBuffer,
+ *       only stores descriptors for LSNs that have a record or gap marker,
+ *       but keeps them in a sequence of sorted chunks of up to kChunkSize
+ *       entries instead of a tree. LSNs of a chunk are contiguous in memory,
+ *       so lookups are two binary searches over a few cache lines, and no
+ *       allocation is needed per descriptor. This makes it a better fit than
+ *       the map for sparse reads with large windows, where many descriptors
+ *       can be buffered at once.
+ *
+ *       Records mostly arrive in LSN order, so a run of records is appended
+ *       to the last chunk without searching. popFront() only moves the
+ *       beginning of the first chunk, which is dropped once empty.
+ *
+ *       A descriptor never moves when a descriptor with a higher LSN is
+ *       created or erased. ClientReadStream relies on this, e.g. it creates
+ *       the descriptor of a gap's end while holding the one of its start.
+ */
+
+class ClientReadStreamSortedVectorBuffer : public ClientReadStreamBuffer {
+ public:
+  // maximum number of descriptors per chunk
+  static constexpr size_t kChunkSize = 64;
+
+  ClientReadStreamSortedVectorBuffer(size_t capacity, lsn_t buffer_head)
+      : capacity_(capacity), buffer_head_(buffer_head) {}
+
+  ~ClientReadStreamSortedVectorBuffer() override;
+
+  // see ClientReadStreamBuffer::createOrGet()
+  // complexity O(1) when appending, O(log(N) + kChunkSize) otherwise
+  ClientReadStreamRecordState* createOrGet(lsn_t lsn) override;
+
+  // see ClientReadStreamBuffer::find()
+  // complexity O(logN)
+  ClientReadStreamRecordState* find(lsn_t lsn) override;
+
+  // see ClientReadStreamBuffer::findFirstMarker()
+  // complexity O(1)
+  std::pair<ClientReadStreamRecordState*, lsn_t> findFirstMarker() override;
+
+  // see ClientReadStreamBuffer::front()
+  // complexity O(1)
+  ClientReadStreamRecordState* front() override;
+
+  // see ClientReadStreamBuffer::popFront()
+  // complexity O(1)
+  void popFront() override;
+
+  // see ClientReadStreamBuffer::advanceBufferHead()
+  // complexity O(1)
+  void advanceBufferHead(size_t offset = 1) override;
+
+  // see ClientReadStreamBuffer::capacity()
+  size_t capacity() const override {
+    return capacity_;
+  }
+
+  // see ClientReadStreamBuffer::clear()
+  void clear() override;
+
+  // see ClientReadStreamBuffer::forEachUpto()
+  // complexity O(logN + (to - buffer_head_))
+  void forEachUpto(
+      lsn_t to,
+      std::function<void(lsn_t, ClientReadStreamRecordState& record)> cb)
+      override;
+
+  // see ClientReadStreamBuffer::forEach()
+  // complexity O(logN * min(n, abs(to - from)))
+  void forEach(lsn_t from,
+               lsn_t to,
+               std::function<bool(lsn_t, ClientReadStreamRecordState& record)>
+                   cb) override;
+
+  // see ClientReadStreamBuffer::getBufferHead()
+  lsn_t getBufferHead() const override {
+    return buffer_head_;
+  }
+
+  // number of descriptors in the buffer, for tests
+  size_t size() const;
+
+  // number of chunks in the buffer, for tests
+  size_t numChunks() const {
+    return chunks_.size();
+  }
+
+ private:
+  // Sorted descriptors. Only entries at [begin, lsns.size()) are in use, the
+  // ones before were popped. Both vectors have a capacity of kChunkSize and
+  // never grow beyond it, so they are never reallocated.
+  struct Chunk {
+    std::vector<lsn_t> lsns;
+    std::vector<ClientReadStreamRecordState> states;
+    size_t begin = 0;
+
+    size_t size() const {
+      return lsns.size() - begin;
+    }
+    bool full() const {
+      return lsns.size() == kChunkSize;
+    }
+    lsn_t first() const {
+      return lsns[begin];
+    }
+    lsn_t last() const {
+      return lsns.back();
+    }
+  };
+
+  // Position of a descriptor.
+  struct Pos {
+    size_t chunk;
+    size_t idx;
+  };
+
+  // @return  position of the first descriptor with an LSN >= lsn, with
+  //          chunk == chunks_.size() if there is none
+  Pos lowerBound(lsn_t lsn) const;
+
+  // Moves `pos` to the previous descriptor.
+  // @return  false if there is none
+  bool prev(Pos& pos) const;
+
+  // Inserts a new descriptor for `lsn` right before `pos`.
+  ClientReadStreamRecordState* insertAt(Pos pos, lsn_t lsn);
+
+  // Erases the descriptor at `pos`, moving only descriptors with higher LSNs.
+  void eraseAt(Pos pos);
+
+  // Returns a new empty chunk, reusing the last dropped one if there is one.
+  std::unique_ptr<Chunk> newChunk();
+
+  // Drops chunks_[i], which must be empty.
+  void dropChunk(size_t i);
+
+  // determine the maximum LSN to accept in the buffer
+  size_t capacity_;
+  // tracks the buffer head
+  lsn_t buffer_head_;
+  // non-empty chunks, in LSN order
+  std::deque<std::unique_ptr<Chunk>> chunks_;
+  // last dropped chunk, kept to avoid an allocation when reading
+  // sequentially
+  std::unique_ptr<Chunk> spare_;
+};
+
+}} // namespace facebook::logdevice
@@ -15,7 +15,8 @@
 namespace facebook { namespace logdevice {
 
 RewindScheduler::RewindScheduler(ClientReadStream* owner)
-    : owner_(owner), timer_(owner_->deps_->createTimer([this] { rewind(); })) {}
+    : owner_(owner),
+      timer_(owner_->deps_->createTimer([this] { onTimer(); })) {}
 
 void RewindScheduler::schedule(std::string reason) {
   if (isScheduled()) {
@@ -40,6 +41,22 @@ void RewindScheduler::schedule(std::string reason) {
   }
 }
 
+void RewindScheduler::onTimer() {
+  if (owner_->deps_->queueRewind()) {
+    queued_ = true;
+    return;
+  }
+  rewind();
+}
+
+void RewindScheduler::onDequeued() {
+  if (!queued_) {
+    return;
+  }
+  queued_ = false;
+  rewind();
+}
+
 void RewindScheduler::rewind() {
   std::string reason_tmp;
   std::swap(reason_tmp, reason_);
@@ -49,11 +66,12 @@ void RewindScheduler::rewind() {
 
 void RewindScheduler::cancel() {
   timer_->cancel();
+  queued_ = false;
   reason_.clear();
 }
 
 bool RewindScheduler::isScheduled() const {
-  return timer_->isActive();
+  return timer_->isActive() || queued_;
 }
 
 }} // namespace facebook::logdevice
@@ -21,6 +21,11 @@ class Timer;
  * RewindScheduler allows scheduling a rewind. It uses
  * ChronoExponentialBackoffAdaptiveVariable to protect against too many rewinds
  * using an adaptive delay between each rewind.
+ *
+ * When the delay expires, the rewind may be queued with the rewinds of the
+ * other read streams on the worker (see AllClientReadStreams::queueRewind()),
+ * so that the START messages of many streams rewinding at once are sent in
+ * batches. The rewind still counts as scheduled while queued.
  */
 class RewindScheduler {
  public:
@@ -43,6 +48,12 @@ class RewindScheduler {
    */
   bool isScheduled() const;
 
+  /**
+   * Called by AllClientReadStreams when it's this stream's turn to rewind.
+   * No-op if the rewind was cancelled while queued.
+   */
+  void onDequeued();
+
  private:
   ClientReadStream* owner_;
 
@@ -63,6 +74,12 @@ class RewindScheduler {
 
   std::unique_ptr<Timer> timer_;
 
+  // True while the rewind waits in AllClientReadStreams' queue.
+  bool queued_{false};
+
+  // Called when timer_ fires.
+  void onTimer();
+
   void rewind();
 };
 
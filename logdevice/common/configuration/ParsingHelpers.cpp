@@ -562,6 +562,26 @@ bool parsePrincipals(const folly::dynamic& clusterMap,
       return false;
     }
 
+    successful = getIntFromMap(principal, "read_share", map_entry->read_share);
+    // "read_share" is an optional field, so ignore NOTFOUND errors.
+    if ((!successful && err != E::NOTFOUND) || map_entry->read_share == 0) {
+      ld_error("\"read_share\" of principal \"%s\" must be a positive "
+               "integer.",
+               name.c_str());
+      err = E::INVALID_CONFIG;
+      return false;
+    }
+
+    successful = getIntFromMap(
+        principal, "min_read_bytes_per_sec", map_entry->min_read_bytes_per_sec);
+    // "min_read_bytes_per_sec" is an optional field, so ignore NOTFOUND
+    // errors.
+    if (!successful && err != E::NOTFOUND) {
+      ld_error("While processing principal \"%s\".", name.c_str());
+      err = E::INVALID_CONFIG;
+      return false;
+    }
+
     principals_map.insert({name, map_entry});
   }
 
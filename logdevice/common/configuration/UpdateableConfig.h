@@ -73,6 +73,13 @@ class UpdateableConfig : public configuration::UpdateableConfigBase {
     return updateable_nodes_configuration_->get();
   }
 
+  // Calls f(const NodesConfiguration*) without taking a reference to the
+  // NodesConfiguration. See UpdateableConfigTmpl::withConfig().
+  template <typename Func>
+  auto withNodesConfiguration(Func&& f) const {
+    return updateable_nodes_configuration_->withConfig(std::forward<Func>(f));
+  }
+
   std::shared_ptr<configuration::LocalLogsConfig> getLocalLogsConfig() const;
   std::shared_ptr<UpdateableServerConfig> updateableServerConfig() const {
     return updateable_server_config_;
@@ -75,7 +75,8 @@ using subscription_callback_t = std::function<SubscriptionStatus()>;
  * fit for our need) were measured at ~1us cpu time per read.
  *
  * The end design uses a combination of std::shared_ptr, versioning,
- * thread-local storage and locking. See UpdateableSharedPtr.h for details.
+ * thread-local storage and locking, plus RCU for readers that don't need to
+ * hold on to the config. See UpdateableSharedPtr.h for details.
  */
 
 /**
@@ -177,6 +178,19 @@ class UpdateableConfigTmpl : public UpdateableConfigBase {
     return config_.get();
   }
 
+  /**
+   * Calls f(Config*) with the current config, possibly nullptr, without
+   * taking a reference to it. Cheaper than get() for hot paths that only
+   * look at the config during the call; f must not keep the pointer. See
+   * RCUUpdateableSharedPtr::withReadPtr().
+   *
+   * This method is thread-safe.
+   */
+  template <typename Func>
+  auto withConfig(Func&& f) const {
+    return config_.withReadPtr(std::forward<Func>(f));
+  }
+
   /**
    * Updates this config with a Config instance, applying any
    * existing, local, configuration overrides. This can be called, for
@@ -315,7 +329,7 @@ class UpdateableConfigTmpl : public UpdateableConfigBase {
   }
 
   // Updated with locked mutex_.
-  UpdateableSharedPtr<Config> config_;
+  RCUUpdateableSharedPtr<Config> config_;
 
   // List of registered config hooks
   HookList hooks_;
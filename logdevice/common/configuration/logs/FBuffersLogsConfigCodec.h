@@ -135,6 +135,35 @@ class LogsConfigCodec<CodecType::FLATBUFFERS> {
   static std::unique_ptr<Out>
   deserialize(const facebook::logdevice::Payload& payload,
               const std::string& delimiter) {
+    std::unique_ptr<uint8_t[]> buf;
+    const uint8_t* ptr = decode<Out>(payload, buf, nullptr);
+    if (!ptr) {
+      return nullptr;
+    }
+    auto ret = fbuffers_deserialize<Out>(
+        flatbuffers::GetRoot<typename TypeMapping<Out>::to>(ptr), delimiter);
+
+    if (!ret) {
+      STAT_INCR(Worker::stats(), logsconfig_manager_serialization_errors);
+    }
+
+    return ret;
+  }
+
+  /**
+   * Strips the header of a serialized Payload, decompresses it if needed and
+   * verifies that it holds a valid flatbuffer of the type Out maps to.
+   *
+   * @param buf       holds the decompressed flatbuffer if the payload was
+   *                  compressed, otherwise the result points into payload
+   * @param size_out  if not nullptr, set to the size of the flatbuffer
+   *
+   * @return  a pointer to the flatbuffer, or nullptr on error
+   */
+  template <typename Out>
+  static const uint8_t* decode(const facebook::logdevice::Payload& payload,
+                               std::unique_ptr<uint8_t[]>& buf,
+                               size_t* size_out) {
     const uint8_t* ptr = static_cast<const uint8_t*>(payload.data());
     const uint8_t* end = ptr + payload.size();
     if (payload.size() == 0 || ptr + 1 >= end) {
@@ -155,7 +184,6 @@ class LogsConfigCodec<CodecType::FLATBUFFERS> {
     }
 
     bool shouldDecompress = (*ptr++ == 1) ? true : false;
-    std::unique_ptr<uint8_t[]> buf;
     if (shouldDecompress) {
       // Try to Decompress
       size_t uncompressed_size = ZSTD_getDecompressedSize(ptr, end - ptr);
@@ -219,14 +247,10 @@ class LogsConfigCodec<CodecType::FLATBUFFERS> {
             .count();
 
     ld_debug("Payload verification took %zums.", verification_latency_ms);
-    auto ret = fbuffers_deserialize<Out>(
-        flatbuffers::GetRoot<typename TypeMapping<Out>::to>(ptr), delimiter);
-
-    if (!ret) {
-      STAT_INCR(Worker::stats(), logsconfig_manager_serialization_errors);
+    if (size_out) {
+      *size_out = end - ptr;
     }
-
-    return ret;
+    return ptr;
   }
 
   /* Internal Intemediate Serializers */
@@ -0,0 +1,149 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/configuration/logs/FBuffersLogsConfigView.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "logdevice/common/configuration/logs/DefaultLogAttributes.h"
+#include "logdevice/common/configuration/logs/FBuffersLogsConfigCodec.h"
+#include "logdevice/common/debug.h"
+
+namespace facebook { namespace logdevice { namespace logsconfig {
+
+std::unique_ptr<FBuffersLogsConfigView>
+FBuffersLogsConfigView::create(const Payload& payload, std::string delimiter) {
+  std::unique_ptr<uint8_t[]> buf;
+  size_t size;
+  const uint8_t* ptr =
+      FBuffersLogsConfigCodec::decode<LogsConfigTree>(payload, buf, &size);
+  if (!ptr) {
+    return nullptr;
+  }
+  if (!buf) {
+    // The payload wasn't compressed, the flatbuffer points into it.
+    buf = std::make_unique<uint8_t[]>(size);
+    std::memcpy(buf.get(), ptr, size);
+  }
+
+  auto view = std::unique_ptr<FBuffersLogsConfigView>(
+      new FBuffersLogsConfigView(std::move(buf), std::move(delimiter)));
+  if (!view->root_ || !view->root_->root_dir()) {
+    err = E::BADMSG;
+    ld_critical("LogsConfig Tree deserialization failed, this is most likely "
+                "a bad payload in the snapshot log");
+    return nullptr;
+  }
+  return view;
+}
+
+FBuffersLogsConfigView::FBuffersLogsConfigView(std::unique_ptr<uint8_t[]> buf,
+                                               std::string delimiter)
+    : buf_(std::move(buf)),
+      root_(flatbuffers::GetRoot<fbuffers::LogsConfig>(buf_.get())),
+      delimiter_(std::move(delimiter)) {
+  if (root_ && root_->root_dir()) {
+    indexDirectory(root_->root_dir(), -1);
+  }
+  std::sort(log_groups_.begin(),
+            log_groups_.end(),
+            [](const LogGroupEntry& a, const LogGroupEntry& b) {
+              return a.from < b.from;
+            });
+}
+
+void FBuffersLogsConfigView::indexDirectory(const fbuffers::Directory* dir,
+                                            ssize_t parent) {
+  const size_t idx = directories_.size();
+  directories_.push_back(DirectoryEntry{dir, parent});
+  if (dir->log_groups()) {
+    for (const auto* group : *dir->log_groups()) {
+      if (!group->range()) {
+        continue;
+      }
+      log_groups_.push_back(LogGroupEntry{
+          group->range()->from(), group->range()->to(), group, idx});
+    }
+  }
+  if (dir->children()) {
+    for (const auto* child : *dir->children()) {
+      indexDirectory(child, idx);
+    }
+  }
+}
+
+const FBuffersLogsConfigView::LogGroupEntry*
+FBuffersLogsConfigView::findLogGroup(logid_t id) const {
+  // Log ranges of different log groups don't overlap, so the only candidate
+  // is the last group starting at or before the log.
+  auto it = std::upper_bound(
+      log_groups_.begin(),
+      log_groups_.end(),
+      id.val_,
+      [](logid_t::raw_type log, const LogGroupEntry& e) {
+        return log < e.from;
+      });
+  if (it == log_groups_.begin()) {
+    return nullptr;
+  }
+  --it;
+  return id.val_ <= it->to ? &*it : nullptr;
+}
+
+const LogAttributes&
+FBuffersLogsConfigView::getDirectoryAttributes(size_t idx) const {
+  auto it = directory_attrs_.find(idx);
+  if (it != directory_attrs_.end()) {
+    return it->second;
+  }
+
+  // Same inheritance rules as fbuffers_deserialize<DirectoryNode>().
+  const DirectoryEntry& entry = directories_[idx];
+  LogAttributes attrs;
+  if (entry.dir->attrs()) {
+    if (entry.parent >= 0) {
+      attrs = FBuffersLogsConfigCodec::fbuffers_deserialize<LogAttributes>(
+          entry.dir->attrs(), getDirectoryAttributes(entry.parent));
+    } else {
+      attrs = FBuffersLogsConfigCodec::fbuffers_deserialize<LogAttributes>(
+          entry.dir->attrs(), DefaultLogAttributes());
+    }
+  }
+  return directory_attrs_.emplace(idx, std::move(attrs)).first->second;
+}
+
+LogGroupNodePtr
+FBuffersLogsConfigView::getLogGroupByIDShared(logid_t id) const {
+  const LogGroupEntry* entry = findLogGroup(id);
+  if (!entry) {
+    err = E::NOTFOUND;
+    return nullptr;
+  }
+
+  const size_t idx = entry - log_groups_.data();
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = materialized_groups_.find(idx);
+  if (it != materialized_groups_.end()) {
+    return it->second;
+  }
+  LogGroupNodePtr group =
+      FBuffersLogsConfigCodec::fbuffers_deserialize<LogGroupNode>(
+          entry->group, delimiter_, getDirectoryAttributes(entry->directory));
+  materialized_groups_.emplace(idx, group);
+  return group;
+}
+
+bool FBuffersLogsConfigView::logExists(logid_t id) const {
+  return findLogGroup(id) != nullptr;
+}
+
+uint64_t FBuffersLogsConfigView::version() const {
+  return root_->version();
+}
+
+}}} // namespace facebook::logdevice::logsconfig
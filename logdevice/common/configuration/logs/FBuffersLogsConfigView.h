@@ -0,0 +1,105 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "logdevice/common/configuration/logs/LogsConfigStructures_generated.h"
+#include "logdevice/common/configuration/logs/LogsConfigTree.h"
+#include "logdevice/include/Record.h"
+#include "logdevice/include/types.h"
+
+namespace facebook { namespace logdevice { namespace logsconfig {
+
+/**
+ * @file A read-only view of a serialized LogsConfigTree (a LogsConfig
+ * flatbuffer, as written by FBuffersLogsConfigCodec) that answers lookups by
+ * log id straight from the flatbuffer.
+ *
+ * Creating the view only builds a sorted index of log ranges; attributes are
+ * not parsed. LogGroupNode objects (with attributes inherited from their
+ * directories) are materialized the first time a log of the group is looked
+ * up and cached afterwards. This is much cheaper in CPU and memory than
+ * FBuffersLogsConfigCodec::deserialize<LogsConfigTree>() for large trees of
+ * which a process only uses a few log groups.
+ *
+ * The view can't be modified; apply deltas to a full LogsConfigTree instead.
+ * Thread-safe.
+ */
+class FBuffersLogsConfigView {
+ public:
+  /**
+   * Decodes and verifies a serialized LogsConfigTree.
+   *
+   * @return  the view, or nullptr on error with err set to BADPAYLOAD or
+   *          BADMSG.
+   */
+  static std::unique_ptr<FBuffersLogsConfigView>
+  create(const Payload& payload, std::string delimiter);
+
+  /**
+   * @return  the log group containing the log, or nullptr with err set to
+   *          NOTFOUND if no log group contains it.
+   */
+  LogGroupNodePtr getLogGroupByIDShared(logid_t id) const;
+
+  bool logExists(logid_t id) const;
+
+  uint64_t version() const;
+
+  size_t numLogGroups() const {
+    return log_groups_.size();
+  }
+
+ private:
+  FBuffersLogsConfigView(std::unique_ptr<uint8_t[]> buf,
+                         std::string delimiter);
+
+  struct DirectoryEntry {
+    const fbuffers::Directory* dir;
+    // Index of the parent directory in directories_, -1 for the root.
+    ssize_t parent;
+  };
+
+  struct LogGroupEntry {
+    logid_t::raw_type from;
+    logid_t::raw_type to;
+    const fbuffers::LogGroup* group;
+    // Index of the directory in directories_.
+    size_t directory;
+  };
+
+  void indexDirectory(const fbuffers::Directory* dir, ssize_t parent);
+
+  // Returns the entry of the log group containing the log, or nullptr.
+  const LogGroupEntry* findLogGroup(logid_t id) const;
+
+  // Returns the attributes of directories_[idx], with inherited ones
+  // resolved. Caches them. Must be called with mutex_ held.
+  const LogAttributes& getDirectoryAttributes(size_t idx) const;
+
+  // The flatbuffer; all fbuffers:: pointers below point into it.
+  std::unique_ptr<uint8_t[]> buf_;
+  const fbuffers::LogsConfig* root_;
+  std::string delimiter_;
+
+  std::vector<DirectoryEntry> directories_;
+  // Sorted by range.
+  std::vector<LogGroupEntry> log_groups_;
+
+  mutable std::mutex mutex_;
+  // Log groups and directory attributes materialized so far, by index.
+  mutable std::unordered_map<size_t, LogGroupNodePtr> materialized_groups_;
+  mutable std::unordered_map<size_t, LogAttributes> directory_attrs_;
+};
+
+}}} // namespace facebook::logdevice::logsconfig
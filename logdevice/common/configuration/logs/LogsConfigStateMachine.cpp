@@ -55,6 +55,7 @@ LogsConfigStateMachine::LogsConfigStateMachine(
 
   self_subscription_ = subscribe(update_cb);
   setSnapshottingGracePeriod(settings_->logsconfig_snapshotting_period);
+  setMaxDeltasPerRecord(settings_->rsm_max_deltas_per_record);
 }
 
 void LogsConfigStateMachine::start() {
@@ -105,8 +105,8 @@ int NodeAttributesConfig<Attributes>::applyUpdate(
     const NodeUpdate& node_update = kv.second;
 
     bool erased;
-    auto current_node_attributes = getNodeAttributes(node);
-    bool node_exist = current_node_attributes.hasValue();
+    const Attributes* current_node_attributes = getNodeAttributesPtr(node);
+    bool node_exist = current_node_attributes != nullptr;
 
     if (!node_exist && node_update.transition != UpdateType::PROVISION) {
       err = E::NOTINCONFIG;
@@ -146,7 +146,7 @@ int NodeAttributesConfig<Attributes>::applyUpdate(
   }
 
   if (new_config_out != nullptr) {
-    *new_config_out = target_config;
+    *new_config_out = std::move(target_config);
   }
 
   dcheckConsistency();
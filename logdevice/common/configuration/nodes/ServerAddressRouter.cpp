@@ -103,6 +103,14 @@ ServerAddressRouter::getAddress(node_index_t idx,
                                 SocketType socket_type,
                                 ConnectionType connection_type,
                                 const Settings& settings) const {
+  if (!settings.server && socket_type == SocketType::DATA &&
+      connection_type == ConnectionType::PLAIN) {
+    auto it = settings.local_data_unix_sockets.find(idx);
+    if (it != settings.local_data_unix_sockets.end()) {
+      // The node runs on the same host, talk to it through a unix socket.
+      return it->second;
+    }
+  }
   return getAddress(idx,
                     node_svc,
                     socket_type,
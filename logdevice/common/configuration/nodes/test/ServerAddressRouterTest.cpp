@@ -13,6 +13,7 @@
 #include "logdevice/common/Sockaddr.h"
 #include "logdevice/common/SocketTypes.h"
 #include "logdevice/common/configuration/nodes/ServiceDiscoveryConfig.h"
+#include "logdevice/common/settings/util.h"
 
 using namespace facebook::logdevice;
 
@@ -426,4 +427,47 @@ TEST(ServerAddressRouterTest,
   }
 }
 
+// Clients use the local unix socket of a node, if configured, for plain data
+// connections to it.
+TEST(ServerAddressRouterTest, LocalDataUnixSocketClient) {
+  NodeServiceDiscovery nodeServiceDiscovery;
+  nodeServiceDiscovery.default_client_data_address = kTestDefaultAddress;
+  nodeServiceDiscovery.ssl_address = kTestSslAddress;
+  const Sockaddr local_address("/tmp/logdevice_local.sock");
+
+  Settings settings = create_default_settings<Settings>();
+  settings.server = false;
+  settings.local_data_unix_sockets[1] = local_address;
+
+  ServerAddressRouter router;
+  EXPECT_EQ(local_address,
+            router.getAddress(1,
+                              nodeServiceDiscovery,
+                              SocketType::DATA,
+                              ConnectionType::PLAIN,
+                              settings));
+  // Other nodes and SSL connections are not affected.
+  EXPECT_EQ(kTestDefaultAddress,
+            router.getAddress(2,
+                              nodeServiceDiscovery,
+                              SocketType::DATA,
+                              ConnectionType::PLAIN,
+                              settings));
+  EXPECT_EQ(kTestSslAddress,
+            router.getAddress(1,
+                              nodeServiceDiscovery,
+                              SocketType::DATA,
+                              ConnectionType::SSL,
+                              settings));
+
+  // Servers ignore the setting.
+  settings.server = true;
+  EXPECT_EQ(kTestDefaultAddress,
+            router.getAddress(1,
+                              nodeServiceDiscovery,
+                              SocketType::DATA,
+                              ConnectionType::PLAIN,
+                              settings));
+}
+
 } // namespace
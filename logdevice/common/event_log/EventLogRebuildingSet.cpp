@@ -1146,22 +1146,18 @@ bool EventLogRebuildingSet::waitingForRecoverableShards() const {
 
 EventLogRebuildingSet::RebuildingShardInfo const*
 EventLogRebuildingSet::getForShardOffset(uint32_t shard) const {
-  if (!shards_.count(shard)) {
-    return nullptr;
-  }
-  return &shards_.find(shard)->second;
+  auto it = shards_.find(shard);
+  return it == shards_.end() ? nullptr : &it->second;
 }
 
 EventLogRebuildingSet::NodeInfo const*
 EventLogRebuildingSet::getNodeInfo(node_index_t node, uint32_t shard) const {
-  if (!shards_.count(shard)) {
-    return nullptr;
-  }
-  const RebuildingShardInfo& shard_info = shards_.find(shard)->second;
-  if (!shard_info.nodes_.count(node)) {
+  auto it_shard = shards_.find(shard);
+  if (it_shard == shards_.end()) {
     return nullptr;
   }
-  return &shard_info.nodes_.find(node)->second;
+  auto it_node = it_shard->second.nodes_.find(node);
+  return it_node == it_shard->second.nodes_.end() ? nullptr : &it_node->second;
 }
 
 bool EventLogRebuildingSet::isDonor(node_index_t node, uint32_t shard) const {
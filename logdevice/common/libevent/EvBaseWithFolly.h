@@ -70,6 +70,10 @@ class EvBaseWithFolly : public IEvBase {
   }
 
  protected:
+  // Lets subclasses pick another backend for the underlying EventBase.
+  explicit EvBaseWithFolly(folly::EventBase::Options options)
+      : base_(std::move(options)) {}
+
   folly::EventBase base_;
 };
 
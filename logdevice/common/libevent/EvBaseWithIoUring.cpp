@@ -0,0 +1,61 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/libevent/EvBaseWithIoUring.h"
+
+#include <stdexcept>
+
+#if __has_include(<folly/experimental/io/IoUringBackend.h>)
+#include <folly/experimental/io/IoUringBackend.h>
+#endif
+
+namespace facebook { namespace logdevice {
+
+namespace {
+
+folly::EventBase::Options makeOptions() {
+  folly::EventBase::Options options;
+#if FOLLY_HAS_LIBURING
+  options.setBackendFactory([] {
+    folly::IoUringBackend::Options backend_options;
+    backend_options.setCapacity(EvBaseWithIoUring::kCapacity)
+        .setMaxSubmit(EvBaseWithIoUring::kMaxSubmit)
+        .setMaxGet(EvBaseWithIoUring::kMaxGet);
+    return std::make_unique<folly::IoUringBackend>(backend_options);
+  });
+#else
+  options.setBackendFactory(
+      []() -> std::unique_ptr<folly::EventBaseBackendBase> {
+        throw std::runtime_error("folly was built without io_uring support");
+      });
+#endif
+  return options;
+}
+
+} // namespace
+
+EvBaseWithIoUring::EvBaseWithIoUring() : EvBaseWithFolly(makeOptions()) {}
+
+bool EvBaseWithIoUring::isAvailable() {
+#if FOLLY_HAS_LIBURING
+  return folly::IoUringBackend::isAvailable();
+#else
+  return false;
+#endif
+}
+
+EvBaseWithIoUring::Status EvBaseWithIoUring::init(int num_priorities) {
+  // The io_uring backend has no notion of event priorities, all ready events
+  // are handled in completion order.
+  if (num_priorities < 1 ||
+      num_priorities > static_cast<int>(Priorities::MAX_PRIORITIES)) {
+    return Status::INVALID_PRIORITY;
+  }
+  return Status::OK;
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,57 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include "logdevice/common/libevent/EvBaseWithFolly.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file EvBaseWithIoUring is an EvBaseWithFolly whose folly::EventBase uses
+ *       an io_uring backend instead of libevent. Fd registrations and timer
+ *       expirations are queued as submission entries and handed to the
+ *       kernel in batches, so an iteration of a busy loop costs about one
+ *       io_uring_enter() instead of an epoll_wait() followed by an
+ *       epoll_ctl() per re-armed event.
+ *
+ *       Everything built on top of folly::EventBase (EventWithFolly,
+ *       EvTimerWithFolly, AsyncSocket) works unchanged. There is no libevent
+ *       base underneath though: getRawBaseDEPRECATED() returns nullptr and
+ *       priorities passed to init() are only validated.
+ *
+ *       Constructing this class throws if io_uring is not available, use
+ *       isAvailable() to check first.
+ */
+
+class EvBaseWithIoUring : public EvBaseWithFolly {
+ public:
+  // number of submission queue entries of the ring
+  static constexpr size_t kCapacity = 4096;
+  // maximum number of entries submitted by a single io_uring_enter()
+  static constexpr size_t kMaxSubmit = 128;
+  // maximum number of completions processed per loop iteration
+  static constexpr size_t kMaxGet = 128;
+
+  EvBaseWithIoUring();
+  ~EvBaseWithIoUring() override {}
+
+  /**
+   * @return  true if folly was built with io_uring support and the running
+   *          kernel allows creating a ring
+   */
+  static bool isAvailable();
+
+  Status init(int num_priorities =
+                  static_cast<int>(Priorities::NUM_PRIORITIES)) override;
+
+  event_base* getRawBaseDEPRECATED() override {
+    return nullptr;
+  }
+};
+
+}} // namespace facebook::logdevice
@@ -17,6 +17,8 @@ static EvBase::EvBaseType getType(IEvBase* base) {
   EvBase::EvBaseType base_type = EvBase::UNKNOWN;
   if (specific_base) {
     base_type = specific_base->getType();
+  } else if (dynamic_cast<EvBaseWithIoUring*>(base)) {
+    base_type = EvBase::IO_URING;
   } else if (dynamic_cast<EvBaseWithFolly*>(base)) {
     base_type = EvBase::FOLLY_EVENTBASE;
   } else {
@@ -29,10 +31,22 @@ static EvBase::EvBaseType getType(IEvBase* base) {
 void EvBase::selectEvBase(EvBaseType base_type) {
   ld_check(!curr_selection_);
   ld_check(base_type_ == UNKNOWN);
-  ld_check_in(base_type, ({FOLLY_EVENTBASE}));
+  ld_check_in(base_type, ({FOLLY_EVENTBASE, IO_URING}));
+  if (base_type == IO_URING) {
+    try {
+      ev_base_with_io_uring_ = std::make_unique<EvBaseWithIoUring>();
+    } catch (const std::exception& e) {
+      ld_error("Failed to create an io_uring event base, falling back to "
+               "the default one: %s",
+               e.what());
+      base_type = FOLLY_EVENTBASE;
+    }
+  }
   base_type_ = base_type;
   if (base_type == FOLLY_EVENTBASE) {
     curr_selection_ = &ev_base_with_folly_;
+  } else if (base_type == IO_URING) {
+    curr_selection_ = ev_base_with_io_uring_.get();
   }
 }
 
@@ -108,6 +122,7 @@ Event::Event(IEvBase::EventCallback callback,
   auto base_type = getType(base);
   switch (base_type) {
     case EvBase::FOLLY_EVENTBASE:
+    case EvBase::IO_URING:
       event_folly_ = std::make_unique<EventWithFolly>(
           std::move(callback), events, fd, base);
       break;
@@ -123,6 +138,7 @@ EvTimer::EvTimer(IEvBase* base) {
   auto base_type = getType(base);
   switch (base_type) {
     case EvBase::FOLLY_EVENTBASE:
+    case EvBase::IO_URING:
       evtimer_folly_ = std::make_unique<EvTimerWithFolly>(base);
       break;
     case EvBase::UNKNOWN:
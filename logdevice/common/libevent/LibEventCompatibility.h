@@ -7,7 +7,10 @@
  */
 #pragma once
 
+#include <memory>
+
 #include "logdevice/common/libevent/EvBaseWithFolly.h"
+#include "logdevice/common/libevent/EvBaseWithIoUring.h"
 #include "logdevice/common/libevent/EvTimerWithFolly.h"
 #include "logdevice/common/libevent/EventWithFolly.h"
 #include "logdevice/common/libevent/IEvBase.h"
@@ -15,12 +18,17 @@ namespace facebook { namespace logdevice {
 
 class EvBase : public IEvBase {
  public:
-  enum EvBaseType { UNKNOWN, FOLLY_EVENTBASE };
+  enum EvBaseType { UNKNOWN, FOLLY_EVENTBASE, IO_URING };
   EvBase() {}
   EvBase(const EvBase&) = delete;
   EvBase& operator=(const EvBase&) = delete;
   ~EvBase() override {}
 
+  /**
+   * Selects the implementation to use. IO_URING falls back to
+   * FOLLY_EVENTBASE if an io_uring backed event base cannot be created,
+   * getType() tells which one was picked.
+   */
   void selectEvBase(EvBaseType type);
   Status init(int num_priorities =
                   static_cast<int>(Priorities::NUM_PRIORITIES)) override;
@@ -64,6 +72,8 @@ class EvBase : public IEvBase {
  protected:
   EvBaseType base_type_{UNKNOWN};
   EvBaseWithFolly ev_base_with_folly_;
+  // only created if IO_URING is selected
+  std::unique_ptr<EvBaseWithIoUring> ev_base_with_io_uring_;
 
   IEvBase* curr_selection_{nullptr};
 };
@@ -39,5 +39,6 @@ TEST_P(EvBaseTest, LoopOnce) {
 
 INSTANTIATE_TEST_CASE_P(TestAllBase,
                         EvBaseTest,
-                        ::testing::Values(EvBase::EvBaseType::FOLLY_EVENTBASE));
+                        ::testing::Values(EvBase::EvBaseType::FOLLY_EVENTBASE,
+                                          EvBase::EvBaseType::IO_URING));
 }} // namespace facebook::logdevice
@@ -239,7 +239,7 @@ int SequencerMembership::applyUpdate(
   }
 
   if (new_sequencer_membership_out != nullptr) {
-    *new_sequencer_membership_out = target_membership_state;
+    *new_sequencer_membership_out = std::move(target_membership_state);
   }
 
   dcheckConsistency();
@@ -552,7 +552,7 @@ int StorageMembership::applyUpdate(const Membership::Update& membership_update,
   }
 
   if (new_storage_membership_out != nullptr) {
-    *new_storage_membership_out = target_membership_state;
+    *new_storage_membership_out = std::move(target_membership_state);
   }
 
   dcheckConsistency();
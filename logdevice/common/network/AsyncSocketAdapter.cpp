@@ -118,6 +118,10 @@ const SSL* AsyncSocketAdapter::getSSL() const {
   return ssl_socket->getSSL();
 }
 
+bool AsyncSocketAdapter::setZeroCopy(bool enable) {
+  return transport_->setZeroCopy(enable);
+}
+
 size_t AsyncSocketAdapter::getRawBytesWritten() const {
   return transport_->getRawBytesWritten();
 }
@@ -217,6 +217,8 @@ class AsyncSocketAdapter : public SocketAdapter {
    */
   const SSL* getSSL() const override;
 
+  bool setZeroCopy(bool enable) override;
+
   size_t getRawBytesWritten() const override;
   size_t getRawBytesReceived() const override;
 
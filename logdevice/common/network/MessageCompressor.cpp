@@ -0,0 +1,124 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/network/MessageCompressor.h"
+
+#include <zstd.h>
+
+#include <folly/io/IOBufQueue.h>
+
+#include "logdevice/common/debug.h"
+
+namespace facebook { namespace logdevice {
+
+MessageCompressor::MessageCompressor(int zstd_level)
+    : ctx_(ZSTD_createCStream()) {
+  ld_check(ctx_);
+  size_t rv = ZSTD_initCStream(ctx_, zstd_level);
+  if (ZSTD_isError(rv)) {
+    ld_error("ZSTD_initCStream() failed: %s", ZSTD_getErrorName(rv));
+    failed_ = true;
+  }
+}
+
+MessageCompressor::~MessageCompressor() {
+  ZSTD_freeCStream(ctx_);
+}
+
+std::unique_ptr<folly::IOBuf>
+MessageCompressor::compress(const folly::IOBuf& in) {
+  if (failed_) {
+    return nullptr;
+  }
+  folly::IOBufQueue out(folly::IOBufQueue::cacheChainLength());
+  const size_t min_alloc = ZSTD_CStreamOutSize();
+  auto fail = [&](size_t rv) {
+    RATELIMIT_ERROR(std::chrono::seconds(1),
+                    1,
+                    "ZSTD compression of a message failed: %s",
+                    ZSTD_getErrorName(rv));
+    failed_ = true;
+    return nullptr;
+  };
+
+  for (const folly::ByteRange range : in) {
+    ZSTD_inBuffer input = {range.data(), range.size(), 0};
+    while (input.pos < input.size) {
+      auto space = out.preallocate(min_alloc, min_alloc);
+      ZSTD_outBuffer output = {space.first, space.second, 0};
+      size_t rv = ZSTD_compressStream(ctx_, &output, &input);
+      out.postallocate(output.pos);
+      if (ZSTD_isError(rv)) {
+        return fail(rv);
+      }
+    }
+  }
+  // Flush so that the other end can decompress the whole message without
+  // waiting for the next one.
+  size_t remaining;
+  do {
+    auto space = out.preallocate(min_alloc, min_alloc);
+    ZSTD_outBuffer output = {space.first, space.second, 0};
+    remaining = ZSTD_flushStream(ctx_, &output);
+    out.postallocate(output.pos);
+    if (ZSTD_isError(remaining)) {
+      return fail(remaining);
+    }
+  } while (remaining > 0);
+
+  return out.move();
+}
+
+MessageDecompressor::MessageDecompressor() : ctx_(ZSTD_createDStream()) {
+  ld_check(ctx_);
+  ZSTD_initDStream(ctx_);
+}
+
+MessageDecompressor::~MessageDecompressor() {
+  ZSTD_freeDStream(ctx_);
+}
+
+std::unique_ptr<folly::IOBuf>
+MessageDecompressor::decompress(const folly::IOBuf& in,
+                                size_t uncompressed_size) {
+  auto out = folly::IOBuf::create(uncompressed_size);
+  ZSTD_outBuffer output = {out->writableData(), uncompressed_size, 0};
+  for (const folly::ByteRange range : in) {
+    ZSTD_inBuffer input = {range.data(), range.size(), 0};
+    while (input.pos < input.size) {
+      const size_t prev_input_pos = input.pos;
+      const size_t prev_output_pos = output.pos;
+      size_t rv = ZSTD_decompressStream(ctx_, &output, &input);
+      if (ZSTD_isError(rv)) {
+        RATELIMIT_ERROR(std::chrono::seconds(1),
+                        1,
+                        "ZSTD decompression of a message failed: %s",
+                        ZSTD_getErrorName(rv));
+        return nullptr;
+      }
+      if (input.pos == prev_input_pos && output.pos == prev_output_pos) {
+        // No progress, the message is larger than uncompressed_size.
+        return nullptr;
+      }
+    }
+  }
+  if (output.pos != uncompressed_size) {
+    return nullptr;
+  }
+  // The decoder may still hold data that didn't fit into `out`.
+  uint8_t extra;
+  ZSTD_outBuffer probe = {&extra, sizeof(extra), 0};
+  ZSTD_inBuffer no_input = {nullptr, 0, 0};
+  size_t rv = ZSTD_decompressStream(ctx_, &probe, &no_input);
+  if (ZSTD_isError(rv) || probe.pos > 0) {
+    return nullptr;
+  }
+  out->append(uncompressed_size);
+  return out;
+}
+
+}} // namespace facebook::logdevice
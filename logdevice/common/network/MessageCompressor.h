@@ -0,0 +1,72 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <memory>
+
+#include <folly/io/IOBuf.h>
+
+struct ZSTD_CCtx_s;
+struct ZSTD_DCtx_s;
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file ZSTD compression stream of the messages sent over one connection.
+ *       All messages are compressed as parts of the same ZSTD frame, each
+ *       one flushed separately. This lets a message refer to data of the
+ *       messages compressed before it, so similar messages (e.g. STOREs of
+ *       the same log) compress much better than each one on its own.
+ *
+ *       The other end must decompress the messages in the same order with a
+ *       single MessageDecompressor.
+ */
+class MessageCompressor {
+ public:
+  explicit MessageCompressor(int zstd_level);
+  ~MessageCompressor();
+
+  MessageCompressor(const MessageCompressor&) = delete;
+  MessageCompressor& operator=(const MessageCompressor&) = delete;
+
+  /**
+   * Compresses `in` as the next message of the stream.
+   *
+   * @return compressed bytes, or nullptr if ZSTD failed. In that case the
+   *         stream is broken and no more messages can be compressed.
+   */
+  std::unique_ptr<folly::IOBuf> compress(const folly::IOBuf& in);
+
+ private:
+  ZSTD_CCtx_s* ctx_;
+  bool failed_{false};
+};
+
+class MessageDecompressor {
+ public:
+  MessageDecompressor();
+  ~MessageDecompressor();
+
+  MessageDecompressor(const MessageDecompressor&) = delete;
+  MessageDecompressor& operator=(const MessageDecompressor&) = delete;
+
+  /**
+   * Decompresses the next message of the stream.
+   *
+   * @param uncompressed_size  expected size of the decompressed message.
+   * @return decompressed bytes, or nullptr if the data is corrupted or
+   *         doesn't decompress to exactly `uncompressed_size` bytes.
+   */
+  std::unique_ptr<folly::IOBuf> decompress(const folly::IOBuf& in,
+                                           size_t uncompressed_size);
+
+ private:
+  ZSTD_DCtx_s* ctx_;
+};
+
+}} // namespace facebook::logdevice
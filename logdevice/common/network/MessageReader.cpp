@@ -15,9 +15,12 @@
 #include "logdevice/common/settings/Settings.h"
 
 namespace facebook { namespace logdevice {
-MessageReader::MessageReader(IProtocolHandler& proto_handler, uint16_t proto)
+MessageReader::MessageReader(IProtocolHandler& proto_handler,
+                             uint16_t proto,
+                             size_t pool_buffer_size)
     : next_buffer_allocation_size_(sizeof(ProtocolHeader)),
       read_buf_(folly::IOBuf::create(next_buffer_allocation_size_)),
+      pool_buffer_size_(pool_buffer_size),
       proto_handler_(proto_handler),
       proto_(proto) {}
 
@@ -49,7 +52,20 @@ void MessageReader::prepareMessageBody() {
   auto payload_size = recv_message_ph_.len -
       ProtocolHeader::bytesNeeded(recv_message_ph_.type, proto_);
   next_buffer_allocation_size_ = payload_size;
-  read_buf_ = folly::IOBuf::create(next_buffer_allocation_size_);
+  // Only small bodies go to the pool buffer so that a large message doesn't
+  // leave most of a pool buffer unused.
+  if (payload_size > 0 && payload_size <= pool_buffer_size_ / 4) {
+    if (!pool_buf_ || pool_buf_->tailroom() < payload_size) {
+      pool_buf_ = folly::IOBuf::create(pool_buffer_size_);
+    }
+    // Empty view of the unused part of the pool buffer. The body is read
+    // into its tailroom.
+    read_buf_ = pool_buf_->cloneOne();
+    read_buf_->trimStart(read_buf_->length());
+    pool_buf_->append(payload_size);
+  } else {
+    read_buf_ = folly::IOBuf::create(next_buffer_allocation_size_);
+  }
   // Add the 8 byte of message read if cksum is absent into the read_buf and
   // move the writableTail().
   if (!ProtocolHeader::needChecksumInHeader(recv_message_ph_.type, proto_)) {
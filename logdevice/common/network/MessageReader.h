@@ -37,10 +37,17 @@ namespace facebook { namespace logdevice {
  * completely. If we were expecting header and it was read completely allocate a
  * new buffer using the message len in header. If the message was read
  * completely, dispatch the message forward for processing.
+ *
+ * If pool_buffer_size is positive, bodies of small messages aren't allocated
+ * one by one. They are read back to back into a pool buffer of that size, and
+ * each message is dispatched as an IOBuf sharing the pool buffer. A pool
+ * buffer is freed once all messages read into it are destroyed.
  */
 class MessageReader : public folly::AsyncSocket::ReadCallback {
  public:
-  MessageReader(IProtocolHandler& conn, uint16_t proto);
+  MessageReader(IProtocolHandler& conn,
+                uint16_t proto,
+                size_t pool_buffer_size = 0);
 
   ~MessageReader() override {}
   /*
@@ -74,6 +81,10 @@ class MessageReader : public folly::AsyncSocket::ReadCallback {
   bool expecting_protocol_header_{true};
   size_t next_buffer_allocation_size_;
   std::unique_ptr<folly::IOBuf> read_buf_;
+  // Buffer the bodies of small messages are read into, see pool_buffer_size_.
+  // Its length covers the bodies handed out so far.
+  std::unique_ptr<folly::IOBuf> pool_buf_;
+  const size_t pool_buffer_size_;
   ProtocolHeader recv_message_ph_;
   IProtocolHandler& proto_handler_;
   uint16_t proto_;
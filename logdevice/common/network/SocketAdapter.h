@@ -157,6 +157,16 @@ class SocketAdapter {
     return nullptr;
   }
 
+  /**
+   * Enable or disable MSG_ZEROCOPY support on the socket. Writes only use
+   * zero copy if they are also passed folly::WriteFlags::WRITE_MSG_ZEROCOPY.
+   *
+   * @return true if the socket supports zero copy.
+   */
+  virtual bool setZeroCopy(bool /* enable */) {
+    return false;
+  }
+
   virtual size_t getRawBytesWritten() const = 0;
   virtual size_t getRawBytesReceived() const = 0;
 
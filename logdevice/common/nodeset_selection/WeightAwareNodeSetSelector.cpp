@@ -7,7 +7,7 @@
  */
 #include "logdevice/common/nodeset_selection/WeightAwareNodeSetSelector.h"
 
-#include <map>
+#include <algorithm>
 #include <queue>
 #include <utility>
 
@@ -18,6 +18,63 @@
 
 namespace facebook { namespace logdevice {
 
+std::shared_ptr<const WeightAwareNodeSetSelector::DomainIndex>
+WeightAwareNodeSetSelector::getDomainIndex(
+    const configuration::nodes::NodesConfiguration& nodes_configuration,
+    NodeLocationScope scope) {
+  const auto& service_discovery = nodes_configuration.getServiceDiscovery();
+  const auto& membership = nodes_configuration.getStorageMembership();
+  {
+    std::lock_guard<std::mutex> lock(domain_index_mutex_);
+    if (domain_index_ && domain_index_->scope == scope &&
+        domain_index_->service_discovery == service_discovery &&
+        domain_index_->membership == membership) {
+      return domain_index_;
+    }
+  }
+
+  auto index = std::make_shared<DomainIndex>();
+  index->service_discovery = service_discovery;
+  index->membership = membership;
+  index->scope = scope;
+
+  std::unordered_map<node_index_t, std::string> node_domain_names;
+  for (const auto node : *membership) {
+    const auto* sd = nodes_configuration.getNodeServiceDiscovery(node);
+    ld_check(sd != nullptr);
+    if (scope == NodeLocationScope::ROOT) {
+      // All nodes are in the same replication domain.
+      node_domain_names[node] = "";
+    } else if (sd->location.has_value() &&
+               sd->location.value().scopeSpecified(scope)) {
+      node_domain_names[node] = sd->location.value().getDomain(scope, node);
+    }
+  }
+  for (const auto& kv : node_domain_names) {
+    index->domain_names.push_back(kv.second);
+  }
+  std::sort(index->domain_names.begin(), index->domain_names.end());
+  index->domain_names.erase(
+      std::unique(index->domain_names.begin(), index->domain_names.end()),
+      index->domain_names.end());
+  for (const auto& name : index->domain_names) {
+    index->domain_name_hashes.push_back(folly::hash::fnv64(name));
+  }
+  for (const auto node : *membership) {
+    auto it = node_domain_names.find(node);
+    index->node_domains[node] = it == node_domain_names.end()
+        ? -1
+        : std::lower_bound(index->domain_names.begin(),
+                           index->domain_names.end(),
+                           it->second) -
+            index->domain_names.begin();
+  }
+
+  std::lock_guard<std::mutex> lock(domain_index_mutex_);
+  domain_index_ = index;
+  return index;
+}
+
 NodeSetSelector::Result WeightAwareNodeSetSelector::getStorageSet(
     logid_t log_id,
     const Configuration* cfg,
@@ -99,7 +156,9 @@ NodeSetSelector::Result WeightAwareNodeSetSelector::getStorageSet(
     // To pick a node, we pop one from the back.
     std::vector<CandidateNode> nodes;
   };
-  std::map<std::string, Domain> domains;
+  auto domain_index = getDomainIndex(nodes_configuration, replication_scope);
+  // Same order as domain_index->domain_names.
+  std::vector<Domain> domains(domain_index->domain_names.size());
 
   const auto& membership = nodes_configuration.getStorageMembership();
   for (const auto node : *membership) {
@@ -119,13 +178,10 @@ NodeSetSelector::Result WeightAwareNodeSetSelector::getStorageSet(
       continue;
     }
 
-    const auto* sd = nodes_configuration.getNodeServiceDiscovery(node);
-    ld_check(sd != nullptr);
-
-    std::string location_str;
-    if (replication_scope == NodeLocationScope::ROOT) {
-      // All nodes are in the same replication domain.
-    } else {
+    const int domain_idx = domain_index->node_domains.at(node);
+    if (domain_idx < 0) {
+      const auto* sd = nodes_configuration.getNodeServiceDiscovery(node);
+      ld_check(sd != nullptr);
       if (!sd->location.has_value()) {
         ld_error("Can't select nodeset because node %d (%s) does not have "
                  "location information",
@@ -135,17 +191,14 @@ NodeSetSelector::Result WeightAwareNodeSetSelector::getStorageSet(
       }
 
       const NodeLocation& location = sd->location.value();
-      assert(!location.isEmpty());
-      if (!location.scopeSpecified(replication_scope)) {
-        ld_error("Can't select nodeset because location %s of node %d (%s) "
-                 "doesn't have location for scope %s.",
-                 location.toString().c_str(),
-                 node,
-                 sd->default_client_data_address.toString().c_str(),
-                 NodeLocation::scopeNames()[replication_scope].c_str());
-        return res;
-      }
-      location_str = location.getDomain(replication_scope, node);
+      ld_check(!location.scopeSpecified(replication_scope));
+      ld_error("Can't select nodeset because location %s of node %d (%s) "
+               "doesn't have location for scope %s.",
+               location.toString().c_str(),
+               node,
+               sd->default_client_data_address.toString().c_str(),
+               NodeLocation::scopeNames()[replication_scope].c_str());
+      return res;
     }
 
     CandidateNode n;
@@ -163,13 +216,18 @@ NodeSetSelector::Result WeightAwareNodeSetSelector::getStorageSet(
     } else {
       n.shard_id_hash = folly::Random::rand64();
     }
-    domains[location_str].nodes.push_back(n);
+    domains[domain_idx].nodes.push_back(n);
   }
 
-  for (auto& kv : domains) {
-    Domain* d = &kv.second;
+  for (size_t i = 0; i < domains.size(); ++i) {
+    Domain* d = &domains[i];
+    if (d->nodes.empty()) {
+      // No candidate of this log in the domain.
+      continue;
+    }
     d->priority = consistentHashing_
-        ? hash_tuple({seed, log_id.val(), folly::hash::fnv64(kv.first)})
+        ? hash_tuple(
+              {seed, log_id.val(), domain_index->domain_name_hashes[i]})
         : folly::Random::rand64();
     std::sort(d->nodes.begin(),
               d->nodes.end(),
@@ -230,8 +288,8 @@ NodeSetSelector::Result WeightAwareNodeSetSelector::getStorageSet(
 
     // Initialize queue.
     size_t result_size = 0;
-    for (auto& kv : domains) {
-      Domain* d = &kv.second;
+    for (auto& domain : domains) {
+      Domain* d = &domain;
       result_size += only_writable ? d->num_picked_writable : d->num_picked;
       if (!d->nodes.empty()) {
         queue.push(d);
@@ -7,6 +7,10 @@
  */
 #pragma once
 
+#include <mutex>
+#include <unordered_map>
+
+#include "logdevice/common/configuration/nodes/NodesConfiguration.h"
 #include "logdevice/common/nodeset_selection/NodeSetSelector.h"
 
 namespace facebook { namespace logdevice {
@@ -48,8 +52,36 @@ class WeightAwareNodeSetSelector : public NodeSetSelector {
       const Options& options) override;
 
  private:
+  // The replication domain of each storage node for a given replication
+  // scope. It only depends on the nodes configuration, not on the log, so
+  // it's computed once and shared by all logs instead of building location
+  // domain strings for every node of every log.
+  struct DomainIndex {
+    // Keep the config objects it was computed from alive, so that pointer
+    // comparison tells whether it's still valid.
+    std::shared_ptr<const configuration::nodes::ServiceDiscoveryConfig>
+        service_discovery;
+    std::shared_ptr<const membership::StorageMembership> membership;
+    NodeLocationScope scope;
+
+    // Sorted.
+    std::vector<std::string> domain_names;
+    // fnv64() of each of domain_names.
+    std::vector<uint64_t> domain_name_hashes;
+    // Index in domain_names of the domain of each storage node, -1 if the
+    // node has no location for `scope`.
+    std::unordered_map<node_index_t, int> node_domains;
+  };
+
+  std::shared_ptr<const DomainIndex> getDomainIndex(
+      const configuration::nodes::NodesConfiguration& nodes_configuration,
+      NodeLocationScope scope);
+
   MapLogToShardFn mapLogToShard_;
   bool consistentHashing_;
+
+  std::mutex domain_index_mutex_;
+  std::shared_ptr<const DomainIndex> domain_index_;
 };
 
 }} // namespace facebook::logdevice
@@ -0,0 +1,107 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/protocol/APPENDS_BATCH_Message.h"
+
+#include <algorithm>
+
+#include "logdevice/common/debug.h"
+#include "logdevice/common/protocol/ProtocolReader.h"
+#include "logdevice/common/protocol/ProtocolWriter.h"
+
+namespace facebook { namespace logdevice {
+
+APPENDS_BATCH_Message::APPENDS_BATCH_Message(
+    std::vector<std::unique_ptr<APPEND_Message>> appends)
+    : Message(MessageType::APPENDS_BATCH, TrafficClass::APPEND),
+      appends_(std::move(appends)) {
+  ld_check(!appends_.empty());
+}
+
+APPENDS_BATCH_Message::APPENDS_BATCH_Message(
+    std::vector<std::unique_ptr<folly::IOBuf>> serialized_appends)
+    : Message(MessageType::APPENDS_BATCH, TrafficClass::APPEND),
+      serialized_appends_(std::move(serialized_appends)) {}
+
+void APPENDS_BATCH_Message::serialize(ProtocolWriter& writer) const {
+  APPENDS_BATCH_Header header = {static_cast<uint32_t>(appends_.size())};
+  writer.write(header);
+
+  for (const auto& append : appends_) {
+    if (writer.isBlackHole()) {
+      // Only the size is needed, don't copy the payload.
+      uint32_t size = append->size(writer.proto());
+      writer.write(size);
+      writer.write(nullptr, size);
+      continue;
+    }
+    // The inner messages are not checksummed separately, the checksum of
+    // the APPENDS_BATCH message covers them.
+    std::unique_ptr<folly::IOBuf> buf =
+        append->serialize(writer.proto(), /* checksum_enabled */ false);
+    if (!buf) {
+      writer.setError(err);
+      return;
+    }
+    uint32_t size = buf->computeChainDataLength();
+    writer.write(size);
+    writer.writeWithoutCopy(buf.get());
+  }
+}
+
+MessageReadResult APPENDS_BATCH_Message::deserialize(ProtocolReader& reader) {
+  APPENDS_BATCH_Header header;
+  reader.read(&header);
+  if (reader.ok() && header.nappends == 0) {
+    reader.setError(E::BADMSG);
+  }
+
+  std::vector<std::unique_ptr<folly::IOBuf>> serialized_appends;
+  for (uint32_t i = 0; i < header.nappends && reader.ok(); ++i) {
+    uint32_t size = 0;
+    reader.read(&size);
+    if (!reader.ok()) {
+      break;
+    }
+    if (size == 0 || size > reader.bytesRemaining()) {
+      reader.setError(E::BADMSG);
+      break;
+    }
+    auto buf = std::make_unique<folly::IOBuf>();
+    reader.readIOBuf(buf.get(), size);
+    serialized_appends.push_back(std::move(buf));
+  }
+
+  return reader.result([&] {
+    return new APPENDS_BATCH_Message(std::move(serialized_appends));
+  });
+}
+
+Message::Disposition APPENDS_BATCH_Message::onReceived(const Address&) {
+  ld_check(false);
+  err = E::PROTO;
+  return Disposition::ERROR;
+}
+
+void APPENDS_BATCH_Message::onSent(Status st, const Address& to) const {
+  for (const auto& append : appends_) {
+    append->onSent(st, to);
+  }
+}
+
+bool APPENDS_BATCH_Message::cancelled() const {
+  return std::all_of(
+      appends_.begin(), appends_.end(), [](const auto& append) {
+        return append->cancelled();
+      });
+}
+
+uint16_t APPENDS_BATCH_Message::getMinProtocolVersion() const {
+  return Compatibility::APPENDS_BATCH_SUPPORT;
+}
+
+}} // namespace facebook::logdevice
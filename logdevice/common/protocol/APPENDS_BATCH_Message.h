@@ -0,0 +1,75 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <folly/io/IOBuf.h>
+
+#include "logdevice/common/protocol/APPEND_Message.h"
+#include "logdevice/common/protocol/Message.h"
+#include "logdevice/include/types.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file Sent by clients to deliver APPENDs of several logs to a sequencer
+ *       node in one message (see AppendBatcher). For small records the
+ *       per-message overhead of APPEND (protocol header, envelope, Sender
+ *       accounting and a write to the socket) dominates the payload.
+ *
+ *       Each APPEND is carried whole, including its ProtocolHeader. The
+ *       receiving Connection unwraps them and dispatches each one as if it
+ *       had come off the socket directly, so they go through the same
+ *       permission checks and resource accounting as unbatched APPENDs.
+ */
+
+struct APPENDS_BATCH_Header {
+  uint32_t nappends;
+
+  // Header is followed by `nappends` entries, each made of a uint32_t size
+  // followed by that many bytes of a serialized APPEND message, including
+  // its ProtocolHeader.
+} __attribute__((__packed__));
+
+class APPENDS_BATCH_Message : public Message {
+ public:
+  /**
+   * @param appends  at least one APPEND, all going to the same node.
+   */
+  explicit APPENDS_BATCH_Message(
+      std::vector<std::unique_ptr<APPEND_Message>> appends);
+
+  APPENDS_BATCH_Message(const APPENDS_BATCH_Message&) = delete;
+  APPENDS_BATCH_Message& operator=(const APPENDS_BATCH_Message&) = delete;
+
+  // see Message.h
+  void serialize(ProtocolWriter&) const override;
+  // Connection unwraps APPENDS_BATCH messages itself, this is never called.
+  Disposition onReceived(const Address& from) override;
+  // Hands the status to APPEND_Message::onSent() of every APPEND.
+  void onSent(Status st, const Address& to) const override;
+  // Cancelled if all the AppendRequests are gone.
+  bool cancelled() const override;
+  uint16_t getMinProtocolVersion() const override;
+  static Message::deserializer_t deserialize;
+
+  // Set on the sending side.
+  std::vector<std::unique_ptr<APPEND_Message>> appends_;
+
+  // Set on the receiving side: the serialized APPEND messages, including
+  // their ProtocolHeaders.
+  std::vector<std::unique_ptr<folly::IOBuf>> serialized_appends_;
+
+ private:
+  explicit APPENDS_BATCH_Message(
+      std::vector<std::unique_ptr<folly::IOBuf>> serialized_appends);
+};
+
+}} // namespace facebook::logdevice
@@ -7,6 +7,8 @@
  */
 #include "logdevice/common/protocol/APPEND_PROBE_Message.h"
 
+#include <algorithm>
+
 #include <folly/Memory.h>
 
 #include "logdevice/common/AllSequencers.h"
@@ -100,6 +102,24 @@ static Status calculate_response(const Address& from,
   return E::OK;
 }
 
+// Number of bytes the client may append without probing again, given that
+// the probe succeeded. Bounded by the room this worker has left below the soft
+// limit on the total size of appenders.
+static uint64_t calculate_credit() {
+  Worker* w = Worker::onThisThread();
+  const Settings& settings = Worker::settings();
+  if (settings.append_probe_credit == 0) {
+    return 0;
+  }
+  const size_t soft_limit =
+      settings.max_total_appenders_size_soft / settings.num_workers;
+  const size_t total_size = w->totalSizeOfAppenders_.load();
+  if (total_size >= soft_limit) {
+    return 0;
+  }
+  return std::min(settings.append_probe_credit, soft_limit - total_size);
+}
+
 template <>
 Message::Disposition APPEND_PROBE_Message::onReceived(Address const& from) {
   Status status = calculate_response(from, header_);
@@ -109,6 +129,7 @@ Message::Disposition APPEND_PROBE_Message::onReceived(Address const& from) {
       status,
       NodeID(),
       APPEND_PROBE_REPLY_flags_t(0),
+      status == E::OK ? calculate_credit() : 0,
   };
   auto msg = std::make_unique<APPEND_PROBE_REPLY_Message>(replyhdr);
   int rv = Worker::onThisThread()->sender().sendMessage(std::move(msg), from);
@@ -13,6 +13,24 @@
 
 namespace facebook { namespace logdevice {
 
+template <>
+void APPEND_PROBE_REPLY_Message::serialize(ProtocolWriter& writer) const {
+  writer.write(&header_, APPEND_PROBE_REPLY_Header::headerSize(writer.proto()));
+}
+
+template <>
+MessageReadResult
+APPEND_PROBE_REPLY_Message::deserialize(ProtocolReader& reader) {
+  std::unique_ptr<APPEND_PROBE_REPLY_Message> m(
+      new APPEND_PROBE_REPLY_Message());
+  // Defaults for old protocols
+  m->header_.credit_bytes = 0;
+  reader.read(&m->header_,
+              APPEND_PROBE_REPLY_Header::headerSize(reader.proto()));
+  reader.allowTrailingBytes();
+  return reader.resultMsg(std::move(m));
+}
+
 template <>
 Message::Disposition
 APPEND_PROBE_REPLY_Message::onReceived(Address const& from) {
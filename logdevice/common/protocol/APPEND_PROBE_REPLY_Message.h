@@ -8,6 +8,7 @@
 #pragma once
 
 #include "logdevice/common/Request.h"
+#include "logdevice/common/protocol/Compatibility.h"
 #include "logdevice/common/protocol/FixedSizeMessage.h"
 #include "logdevice/include/types.h"
 
@@ -22,6 +23,19 @@ struct APPEND_PROBE_REPLY_Header {
   NodeID redirect; // when status is PREEMPTED, indicates which sequencer
                    // should receive appends for the log
   APPEND_PROBE_REPLY_flags_t flags; // bitset of flags, currently unused
+  // When status is OK, number of bytes the client may append to this
+  // sequencer within the next second without probing again. 0 if the
+  // sequencer doesn't grant credit. Only sent with protocol
+  // APPEND_PROBE_REPLY_CREDIT or higher.
+  uint64_t credit_bytes;
+
+  // size of the header in message given the protocol version
+  static size_t headerSize(uint16_t proto) {
+    if (proto < Compatibility::APPEND_PROBE_REPLY_CREDIT) {
+      return offsetof(APPEND_PROBE_REPLY_Header, credit_bytes);
+    }
+    return sizeof(APPEND_PROBE_REPLY_Header);
+  }
 } __attribute__((__packed__));
 
 using APPEND_PROBE_REPLY_Message =
@@ -29,4 +43,11 @@ using APPEND_PROBE_REPLY_Message =
                      MessageType::APPEND_PROBE_REPLY,
                      TrafficClass::APPEND>;
 
+// The header size depends on the protocol, see specializations in the .cpp
+template <>
+void APPEND_PROBE_REPLY_Message::serialize(ProtocolWriter& writer) const;
+template <>
+MessageReadResult
+APPEND_PROBE_REPLY_Message::deserialize(ProtocolReader& reader);
+
 }} // namespace facebook::logdevice
@@ -0,0 +1,57 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/protocol/COMPRESSED_Message.h"
+
+#include "logdevice/common/debug.h"
+#include "logdevice/common/protocol/ProtocolReader.h"
+#include "logdevice/common/protocol/ProtocolWriter.h"
+
+namespace facebook { namespace logdevice {
+
+COMPRESSED_Message::COMPRESSED_Message(const COMPRESSED_Header& header,
+                                       std::unique_ptr<folly::IOBuf> blob,
+                                       TrafficClass tc)
+    : Message(MessageType::COMPRESSED, tc),
+      header_(header),
+      blob_(std::move(blob)) {
+  ld_check(blob_);
+}
+
+void COMPRESSED_Message::serialize(ProtocolWriter& writer) const {
+  writer.write(header_);
+  writer.writeWithoutCopy(blob_.get());
+}
+
+MessageReadResult COMPRESSED_Message::deserialize(ProtocolReader& reader) {
+  COMPRESSED_Header header;
+  reader.read(&header);
+  if (reader.ok() && (header.compression != Compression::ZSTD ||
+                      reader.bytesRemaining() == 0)) {
+    reader.setError(E::BADMSG);
+  }
+  auto blob = std::make_unique<folly::IOBuf>();
+  reader.readIOBuf(blob.get(), reader.bytesRemaining());
+  // The traffic class of the wrapped message isn't known until it's
+  // decompressed, and doesn't matter for the wrapper.
+  return reader.result([&] {
+    return new COMPRESSED_Message(
+        header, std::move(blob), TrafficClass::HANDSHAKE);
+  });
+}
+
+Message::Disposition COMPRESSED_Message::onReceived(const Address&) {
+  ld_check(false);
+  err = E::PROTO;
+  return Disposition::ERROR;
+}
+
+uint16_t COMPRESSED_Message::getMinProtocolVersion() const {
+  return Compatibility::COMPRESSED_MESSAGE_SUPPORT;
+}
+
+}} // namespace facebook::logdevice
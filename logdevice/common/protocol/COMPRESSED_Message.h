@@ -0,0 +1,56 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <folly/io/IOBuf.h>
+
+#include "logdevice/common/protocol/Message.h"
+#include "logdevice/include/types.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file Wraps another message, including its ProtocolHeader, compressed with
+ *       the compression stream of the connection (see MessageCompressor).
+ *       Connection creates these when sending large messages and unwraps
+ *       them before dispatching, so they never reach state machines.
+ *
+ *       Compressed messages on a connection must be decompressed in the
+ *       order they were sent, since each one may refer to data of the
+ *       previous ones.
+ */
+
+struct COMPRESSED_Header {
+  // Only ZSTD is supported.
+  Compression compression;
+  // Size of the wrapped message, including its ProtocolHeader.
+  uint32_t uncompressed_size;
+  // Header is followed by the compressed bytes.
+} __attribute__((__packed__));
+
+class COMPRESSED_Message : public Message {
+ public:
+  COMPRESSED_Message(const COMPRESSED_Header& header,
+                     std::unique_ptr<folly::IOBuf> blob,
+                     TrafficClass tc);
+
+  COMPRESSED_Message(const COMPRESSED_Message&) = delete;
+  COMPRESSED_Message& operator=(const COMPRESSED_Message&) = delete;
+
+  // see Message.h
+  void serialize(ProtocolWriter&) const override;
+  // Connection unwraps COMPRESSED messages itself, this is never called.
+  Disposition onReceived(const Address& from) override;
+  uint16_t getMinProtocolVersion() const override;
+  static Message::deserializer_t deserialize;
+
+  COMPRESSED_Header header_;
+  std::unique_ptr<folly::IOBuf> blob_;
+};
+
+}} // namespace facebook::logdevice
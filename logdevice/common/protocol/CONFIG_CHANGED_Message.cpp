@@ -250,6 +250,17 @@ CONFIG_CHANGED_Message::handleReloadAction(const Address& from) {
     return Disposition::NORMAL;
   }
 
+  auto spread = Worker::settings().remote_logs_config_invalidation_spread;
+  if (spread.count() > 0) {
+    // Spread the re-fetches of all clients over time rather than have all of
+    // them hit the servers right after the change.
+    if (!worker->scheduleLogsConfigInvalidation(spread)) {
+      WORKER_STAT_INCR(config_changed_reload_coalesced);
+    }
+    WORKER_STAT_INCR(config_changed_reload);
+    return Disposition::NORMAL;
+  }
+
   int rv = worker->getUpdateableConfig()->updateableLogsConfig()->invalidate();
   if (rv != 0) {
     ld_error("Config reload failed with error %s", error_description(err));
@@ -53,6 +53,44 @@ enum ProtocolVersion : uint16_t {
 
   GET_RSM_SNAPSHOT_MESSAGE_SUPPORT, // = 103
 
+  // APPEND_PROBE_REPLY_Message carries append credit
+  APPEND_PROBE_REPLY_CREDIT, // = 104
+
+  // Storage nodes may pack consecutive records of a read stream into a
+  // RECORDS_BATCH message
+  RECORDS_BATCH_SUPPORT, // = 105
+
+  // Large messages may be sent compressed, wrapped in a COMPRESSED message
+  COMPRESSED_MESSAGE_SUPPORT, // = 106
+
+  // Clients may send APPENDs of several logs in one APPENDS_BATCH message
+  APPENDS_BATCH_SUPPORT, // = 107
+
+  // START messages may carry IN_SET and PREFIX server-side record filters
+  SERVER_RECORD_FILTER_SETS_SUPPORT, // = 108
+
+  // START messages may carry a sampling rate and a timestamp window
+  SERVER_RECORD_SAMPLING_SUPPORT, // = 109
+
+  // Rebuilding may send STOREs of several records in one STORES_BATCH message
+  STORES_BATCH_SUPPORT, // = 110
+
+  // GOSSIP messages may carry only the entries that changed recently, plus
+  // compact heartbeats for the other nodes
+  GOSSIP_DELTA_SUPPORT, // = 111
+
+  // Clients may send TRIMs of several logs in one TRIMS_BATCH message
+  TRIMS_BATCH_SUPPORT, // = 112
+
+  // RELEASE messages may carry the byte offsets at the start of the epoch
+  RELEASE_EPOCH_OFFSETS_SUPPORT, // = 113
+
+  // GET_SEQ_STATE may ask for the records the sequencer keeps in memory
+  SEQUENCER_RECENT_RECORDS_SUPPORT, // = 114
+
+  // START messages may carry the client's ranking of nodes for SCD
+  SCD_PREFERRED_NODES_SUPPORT, // = 115
+
   // NOTE: insert new protocol versions here
 
   // Maximum version number of the protocol this version of LogDevice
@@ -77,6 +115,18 @@ static_assert(HEALTH_MONITOR_SUPPORT_IN_GOSSIP == 100, "");
 static_assert(NODE_STATUS_AND_HASHMAP_SUPPORT_IN_CLUSTER_STATE == 101, "");
 static_assert(INCLUDE_VERSIONS_IN_GOSSIP == 102, "");
 static_assert(GET_RSM_SNAPSHOT_MESSAGE_SUPPORT == 103, "");
+static_assert(APPEND_PROBE_REPLY_CREDIT == 104, "");
+static_assert(RECORDS_BATCH_SUPPORT == 105, "");
+static_assert(COMPRESSED_MESSAGE_SUPPORT == 106, "");
+static_assert(APPENDS_BATCH_SUPPORT == 107, "");
+static_assert(SERVER_RECORD_FILTER_SETS_SUPPORT == 108, "");
+static_assert(SERVER_RECORD_SAMPLING_SUPPORT == 109, "");
+static_assert(STORES_BATCH_SUPPORT == 110, "");
+static_assert(GOSSIP_DELTA_SUPPORT == 111, "");
+static_assert(TRIMS_BATCH_SUPPORT == 112, "");
+static_assert(RELEASE_EPOCH_OFFSETS_SUPPORT == 113, "");
+static_assert(SEQUENCER_RECENT_RECORDS_SUPPORT == 114, "");
+static_assert(SCD_PREFERRED_NODES_SUPPORT == 115, "");
 
 constexpr uint16_t MIN_PROTOCOL_SUPPORTED = PROTOCOL_VERSION_LOWER_BOUND + 1;
 constexpr uint16_t MAX_PROTOCOL_SUPPORTED = PROTOCOL_VERSION_UPPER_BOUND - 1;
@@ -83,12 +83,14 @@ Message::Disposition GAP_Message::onReceived(Address const& from) {
   EpochRecovery* recovery = nullptr;
   if (header_.flags & GAP_Header::DIGEST) {
     // this is a digest GAP, route to an EpochRecovery object
-    recovery = w->findActiveEpochRecovery(header_.log_id);
+    recovery = w->findActiveEpochRecovery(
+        header_.log_id, lsn_to_epoch(header_.start_lsn));
     if (!recovery) {
       RATELIMIT_INFO(std::chrono::seconds(1),
                      10,
                      "Got an invalid or stale digest GAP message %s from %s "
-                     "No epoch recovery machine is active for log. Ignoring.",
+                     "No epoch recovery machine is active for its epoch. "
+                     "Ignoring.",
                      header_.identify().c_str(),
                      Sender::describeConnection(from).c_str());
       return Disposition::NORMAL;
@@ -27,6 +27,7 @@ MessageReadResult GET_SEQ_STATE_Message::deserialize(ProtocolReader& reader) {
   GET_SEQ_STATE_flags_t flags = 0;
   GetSeqStateRequest::Context calling_ctx{GetSeqStateRequest::Context::UNKNOWN};
   folly::Optional<epoch_t> min_epoch;
+  folly::Optional<lsn_t> recent_records_after;
   reader.read(&log_id);
   reader.read(&request_id);
 
@@ -46,19 +47,31 @@ MessageReadResult GET_SEQ_STATE_Message::deserialize(ProtocolReader& reader) {
     min_epoch.assign(read_min_epoch);
   }
 
+  if (flags & GET_SEQ_STATE_Message::INCLUDE_RECENT_RECORDS) {
+    lsn_t read_after;
+    reader.read(&read_after);
+    recent_records_after.assign(read_after);
+  }
+
   if (reader.proto() < Compatibility::IS_LOG_EMPTY_IN_GSS_REPLY) {
     flags &= ~GET_SEQ_STATE_Message::INCLUDE_IS_LOG_EMPTY;
   }
 
   reader.allowTrailingBytes();
   return reader.result([&] {
-    return new GET_SEQ_STATE_Message(
-        log_id, request_id, flags, calling_ctx, min_epoch);
+    return new GET_SEQ_STATE_Message(log_id,
+                                     request_id,
+                                     flags,
+                                     calling_ctx,
+                                     min_epoch,
+                                     recent_records_after);
   });
 }
 
 uint16_t GET_SEQ_STATE_Message::getMinProtocolVersion() const {
-  if (flags_ & GET_SEQ_STATE_Message::INCLUDE_IS_LOG_EMPTY) {
+  if (flags_ & GET_SEQ_STATE_Message::INCLUDE_RECENT_RECORDS) {
+    return Compatibility::SEQUENCER_RECENT_RECORDS_SUPPORT;
+  } else if (flags_ & GET_SEQ_STATE_Message::INCLUDE_IS_LOG_EMPTY) {
     return Compatibility::IS_LOG_EMPTY_IN_GSS_REPLY;
   } else {
     return Compatibility::MIN_PROTOCOL_SUPPORTED;
@@ -83,6 +96,11 @@ void GET_SEQ_STATE_Message::serialize(ProtocolWriter& writer) const {
     ld_check(min_epoch_.has_value());
     writer.write(min_epoch_.value());
   }
+
+  if (flags_ & GET_SEQ_STATE_Message::INCLUDE_RECENT_RECORDS) {
+    ld_check(recent_records_after_.has_value());
+    writer.write(recent_records_after_.value());
+  }
 }
 
 CopySetSelector::Result
@@ -170,6 +188,19 @@ GET_SEQ_STATE_Message::checkSeals(Address src, std::shared_ptr<Sequencer> seq) {
     ld_check(false);
   }
 
+  // If a CheckSealRequest for the same log and epoch is already running on
+  // this worker, wait for its result instead of sending more CHECK_SEALs.
+  auto& check_seals = Worker::onThisThread()->runningCheckSeals();
+  auto running = check_seals.by_log.find(datalog_id);
+  if (running != check_seals.by_log.end()) {
+    auto it = check_seals.map.find(running->second);
+    ld_check(it != check_seals.map.end());
+    if (it->second->getLocalEpoch() == seq->getCurrentEpoch()) {
+      it->second->join(std::unique_ptr<GET_SEQ_STATE_Message>(this), src);
+      return Disposition::KEEP;
+    }
+  }
+
   std::vector<ShardID> copyset;
   if (getCopySet(seq, copyset) != CopySetSelector::Result::SUCCESS) {
     ld_debug("Can't pick a copyset for log:%lu, GSS rqid:%lu",
@@ -441,6 +472,19 @@ Message::Disposition GET_SEQ_STATE_Message::onReceived(Address const& from) {
   return Disposition::KEEP;
 }
 
+bool GET_SEQ_STATE_Message::sealsCheckedRecently(logid_t datalog_id,
+                                                 epoch_t epoch) const {
+  const auto ttl = Worker::settings().check_seal_cache_ttl;
+  if (ttl.count() <= 0) {
+    return false;
+  }
+  const auto& last_success =
+      Worker::onThisThread()->runningCheckSeals().last_success;
+  auto it = last_success.find(datalog_id);
+  return it != last_success.end() && it->second.first == epoch &&
+      std::chrono::steady_clock::now() - it->second.second < ttl;
+}
+
 bool GET_SEQ_STATE_Message::shouldPerformCheckSeals() const {
   auto w = Worker::onThisThread();
   auto failure_detector_running = w->processor_->isFailureDetectorRunning();
@@ -507,6 +551,13 @@ void GET_SEQ_STATE_Message::onSequencerNodeFound(Status status,
           // figureout the latest sequencer to send more accurate redirects
           /* BOOST_FALLTHROUGH */
         case Sequencer::State::ACTIVE:
+          if (state == Sequencer::State::ACTIVE &&
+              sealsCheckedRecently(datalog_id, cur_epoch)) {
+            // A check found this sequencer not preempted a moment ago, let
+            // continueExecution() reply without checking again.
+            WORKER_STAT_INCR(check_seal_req_skipped_recent);
+            break;
+          }
           if (checkSeals(from, sequencer) == Disposition::KEEP) {
             // ownership is transferred to CheckSealsRequest
             msg.release();
@@ -578,6 +629,7 @@ void GET_SEQ_STATE_Message::continueExecution(Address const& from) {
   std::shared_ptr<const EpochMetaDataMap> metadata_map;
   std::shared_ptr<TailRecord> tail_record;
   folly::Optional<bool> is_log_empty = folly::none;
+  folly::Optional<std::vector<std::shared_ptr<TailRecord>>> recent_records;
 
   if (status == E::OK) {
     // If the request is for the metadata log, provide last_released_lsn with
@@ -649,6 +701,24 @@ void GET_SEQ_STATE_Message::continueExecution(Address const& from) {
         status = res.first;
         is_log_empty = res.second;
       }
+
+      if (flags_ & GET_SEQ_STATE_Message::INCLUDE_RECENT_RECORDS) {
+        ld_check(recent_records_after_.has_value());
+        std::vector<std::shared_ptr<TailRecord>> records;
+        int rv = sequencer->getRecentRecords(
+            recent_records_after_.value(), &records);
+        if (rv == 0) {
+          reply_hdr.flags |=
+              GET_SEQ_STATE_REPLY_Header::INCLUDES_RECENT_RECORDS;
+          recent_records.assign(std::move(records));
+        } else if (err == E::AGAIN) {
+          status = E::AGAIN;
+        } else {
+          // E::NOTFOUND, the reply goes without records and the reader
+          // reads them from storage nodes
+          ld_check(err == E::NOTFOUND);
+        }
+      }
     }
   }
 
@@ -660,7 +730,8 @@ void GET_SEQ_STATE_Message::continueExecution(Address const& from) {
             std::move(epoch_offsets),
             std::move(metadata_map),
             std::move(tail_record),
-            is_log_empty);
+            is_log_empty,
+            std::move(recent_records));
 }
 
 void GET_SEQ_STATE_Message::onSent(Status status, const Address& to) const {
@@ -911,7 +982,8 @@ void GET_SEQ_STATE_Message::sendReply(
     folly::Optional<OffsetMap> epoch_offsets,
     std::shared_ptr<const EpochMetaDataMap> metadata_map,
     std::shared_ptr<TailRecord> tail_record,
-    folly::Optional<bool> is_log_empty) {
+    folly::Optional<bool> is_log_empty,
+    folly::Optional<std::vector<std::shared_ptr<TailRecord>>> recent_records) {
   auto msg = std::make_unique<GET_SEQ_STATE_REPLY_Message>(header);
   msg->request_id_ = request_id_;
   msg->status_ = status;
@@ -931,6 +1003,9 @@ void GET_SEQ_STATE_Message::sendReply(
   if (is_log_empty.has_value()) {
     msg->is_log_empty_ = is_log_empty.value();
   }
+  if (recent_records.has_value()) {
+    msg->recent_records_ = std::move(recent_records.value());
+  }
 
   ld_spew("Sending GET_SEQ_STATE_REPLY(log:%lu, rqid:%lu, status=%s, "
           "last_released_lsn:%s, next_lsn:%s, ctx:%s) to %s(%s)",
@@ -986,6 +1061,7 @@ GET_SEQ_STATE_Message::getDebugInfo() const {
     FLAG(MIN_EPOCH)
     FLAG(INCLUDE_HISTORICAL_METADATA)
     FLAG(INCLUDE_TAIL_RECORD)
+    FLAG(INCLUDE_RECENT_RECORDS)
 #undef FLAG
     return folly::join('|', strings);
   };
@@ -1000,6 +1076,9 @@ GET_SEQ_STATE_Message::getDebugInfo() const {
   if (min_epoch_.has_value()) {
     add("min_epoch", min_epoch_.value().val());
   }
+  if (recent_records_after_.has_value()) {
+    add("recent_records_after", lsn_to_string(recent_records_after_.value()));
+  }
   return res;
 }
 
@@ -43,13 +43,16 @@ class GET_SEQ_STATE_Message : public Message {
                         request_id_t request_id,
                         GET_SEQ_STATE_flags_t flags,
                         GetSeqStateRequest::Context calling_ctx,
-                        folly::Optional<epoch_t> min_epoch = folly::none)
+                        folly::Optional<epoch_t> min_epoch = folly::none,
+                        folly::Optional<lsn_t> recent_records_after =
+                            folly::none)
       : Message(MessageType::GET_SEQ_STATE, TrafficClass::RECOVERY),
         log_id_(log_id),
         request_id_(request_id),
         flags_(flags),
         calling_ctx_(calling_ctx),
-        min_epoch_(min_epoch) {}
+        min_epoch_(min_epoch),
+        recent_records_after_(recent_records_after) {}
 
   // If set in flags, a sequencer node that receives the message will make an
   // attempt to process it, possibly (re)activating a sequencer, even if it
@@ -89,6 +92,12 @@ class GET_SEQ_STATE_Message : public Message {
   // decrease response time at the expense of consistency.
   static const GET_SEQ_STATE_flags_t SKIP_REMOTE_PREEMPTION_CHECK = 1u << 9;
 
+  // If set, recent_records_after will be appended to the serialized message
+  // (after min_epoch), and the sequencer will include the released records
+  // with greater LSNs that it has in memory, see
+  // Sequencer::getRecentRecords().
+  static const GET_SEQ_STATE_flags_t INCLUDE_RECENT_RECORDS = 1u << 10;
+
   // implementation of the Message interface
   void serialize(ProtocolWriter&) const override;
   static Message::deserializer_t deserialize;
@@ -120,6 +129,10 @@ class GET_SEQ_STATE_Message : public Message {
   // Min epoch in which the sequencer should reactivate
   folly::Optional<epoch_t> min_epoch_;
 
+  // LSN of the last record the reader has, set iff INCLUDE_RECENT_RECORDS is
+  // set
+  folly::Optional<lsn_t> recent_records_after_;
+
   // Copyset selector and nodeset. Needed to select nodes to send checkseals to.
   std::shared_ptr<CopySetManager> copyset_manager_;
 
@@ -265,7 +278,9 @@ class GET_SEQ_STATE_Message : public Message {
             folly::Optional<OffsetMap> epoch_offsets = folly::none,
             std::shared_ptr<const EpochMetaDataMap> metadata_map = nullptr,
             std::shared_ptr<TailRecord> tail_record = nullptr,
-            folly::Optional<bool> is_log_empty = folly::none);
+            folly::Optional<bool> is_log_empty = folly::none,
+            folly::Optional<std::vector<std::shared_ptr<TailRecord>>>
+                recent_records = folly::none);
 
   void onSequencerNodeFound(Status status,
                             logid_t datalog_id,
@@ -274,6 +289,11 @@ class GET_SEQ_STATE_Message : public Message {
 
   bool shouldPerformCheckSeals() const;
 
+  // Returns true if a CheckSealRequest found the sequencer of `datalog_id'
+  // not preempted in `epoch' less than --check-seal-cache-ttl ago on this
+  // worker.
+  bool sealsCheckedRecently(logid_t datalog_id, epoch_t epoch) const;
+
   friend class CheckSealRequest;
 };
 
@@ -69,6 +69,16 @@ GET_SEQ_STATE_REPLY_Message::deserialize(ProtocolReader& reader) {
     reader.read(&msg->is_log_empty_);
   }
 
+  if (header.flags & GET_SEQ_STATE_REPLY_Header::INCLUDES_RECENT_RECORDS) {
+    uint32_t nrecords = 0;
+    reader.read(&nrecords);
+    for (uint32_t i = 0; i < nrecords && reader.ok(); ++i) {
+      auto record = std::make_shared<TailRecord>();
+      record->deserialize(reader, /*zero_copy*/ true);
+      msg->recent_records_.push_back(std::move(record));
+    }
+  }
+
   return reader.resultMsg(std::move(msg));
 }
 
@@ -117,6 +127,17 @@ void GET_SEQ_STATE_REPLY_Message::serialize(ProtocolWriter& writer) const {
 
     writer.write(is_log_empty_);
   }
+
+  if (header_.flags & GET_SEQ_STATE_REPLY_Header::INCLUDES_RECENT_RECORDS) {
+    // only sent in reply to GET_SEQ_STATE with INCLUDE_RECENT_RECORDS, which
+    // requires SEQUENCER_RECENT_RECORDS_SUPPORT
+    ld_check(writer.proto() >=
+             Compatibility::SEQUENCER_RECENT_RECORDS_SUPPORT);
+    writer.write(static_cast<uint32_t>(recent_records_.size()));
+    for (const auto& record : recent_records_) {
+      record->serialize(writer);
+    }
+  }
 }
 
 Message::Disposition
@@ -191,6 +212,7 @@ GET_SEQ_STATE_REPLY_Message::getDebugInfo() const {
     FLAG(INCLUDES_EPOCH_OFFSET)
     FLAG(INCLUDES_HISTORICAL_METADATA)
     FLAG(INCLUDES_TAIL_RECORD)
+    FLAG(INCLUDES_RECENT_RECORDS)
 #undef FLAG
     return folly::join('|', strings);
   };
@@ -218,6 +240,9 @@ GET_SEQ_STATE_REPLY_Message::getDebugInfo() const {
   if (header_.flags & GET_SEQ_STATE_REPLY_Header::INCLUDES_TAIL_RECORD) {
     add("tail_record", tail_record_ ? tail_record_->toString() : "null");
   }
+  if (header_.flags & GET_SEQ_STATE_REPLY_Header::INCLUDES_RECENT_RECORDS) {
+    add("recent_records", recent_records_.size());
+  }
   return res;
 }
 
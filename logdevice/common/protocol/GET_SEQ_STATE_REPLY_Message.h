@@ -9,6 +9,8 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <memory>
+#include <vector>
 
 #include "logdevice/common/EpochMetaDataMap.h"
 #include "logdevice/common/NodeID.h"
@@ -61,6 +63,11 @@ struct GET_SEQ_STATE_REPLY_Header {
   // if set in .flags, if the reply status is E::OK, it will contain a bool
   // indicating whether the log is empty.
   static const GET_SEQ_STATE_REPLY_flags_t INCLUDES_IS_LOG_EMPTY = 1 << 4;
+
+  // if set in .flags, the reply will contain the records asked for with
+  // GET_SEQ_STATE_Message::INCLUDE_RECENT_RECORDS. Not set if the sequencer
+  // doesn't have all of them.
+  static const GET_SEQ_STATE_REPLY_flags_t INCLUDES_RECENT_RECORDS = 1 << 5;
 } __attribute__((__packed__));
 
 class GET_SEQ_STATE_REPLY_Message : public Message {
@@ -116,6 +123,10 @@ class GET_SEQ_STATE_REPLY_Message : public Message {
 
   bool is_log_empty_{false};
 
+  // released records in LSN order, with payloads, see
+  // Sequencer::getRecentRecords()
+  std::vector<std::shared_ptr<TailRecord>> recent_records_;
+
   virtual std::vector<std::pair<std::string, folly::dynamic>>
   getDebugInfo() const override;
 };
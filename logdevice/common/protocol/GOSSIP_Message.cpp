@@ -75,6 +75,13 @@ void GOSSIP_Message::serialize(ProtocolWriter& writer) const {
     if (flags & HAS_IN_MEM_VERSIONS || flags & HAS_DURABLE_SNAPSHOT_VERSIONS) {
       writeVersions(writer);
     }
+    // Full messages are serialized the same way as before
+    // GOSSIP_DELTA_SUPPORT.
+    if (!heartbeat_list_.empty() &&
+        writer.proto() >=
+            Compatibility::ProtocolVersion::GOSSIP_DELTA_SUPPORT) {
+      writer.writeLengthPrefixedVector(heartbeat_list_);
+    }
   }
 }
 
@@ -113,6 +120,11 @@ MessageReadResult GOSSIP_Message::deserialize(ProtocolReader& reader) {
       // in future iteration(once Local snapshot store is implemented)
       msg->readVersions(reader, num_nodes);
     }
+    if (reader.proto() >=
+            Compatibility::ProtocolVersion::GOSSIP_DELTA_SUPPORT &&
+        reader.ok() && reader.bytesRemaining() > 0) {
+      reader.readLengthPrefixedVector(&msg->heartbeat_list_);
+    }
   }
   return reader.resultMsg(std::move(msg));
 }
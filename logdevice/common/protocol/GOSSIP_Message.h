@@ -53,6 +53,19 @@ struct GOSSIP_Node : public GOSSIP_Node_Legacy {
   }
 };
 
+// Compact entry of a delta GOSSIP_Message, for a node whose entry didn't
+// change recently other than its heartbeat counter.
+struct GOSSIP_Heartbeat {
+  node_index_t node_id_;
+
+  // Same as GOSSIP_Node::gossip_.
+  uint32_t gossip_;
+
+  // Low 32 bits of GOSSIP_Node::gossip_ts_. The receiver only applies the
+  // counter if it knows the same instance of the node.
+  uint32_t instance_tag_;
+};
+
 struct Versions_Node {
   size_t node_id_;
   // RSM Versions contained here follow the order of rsm types in
@@ -81,6 +94,7 @@ class GOSSIP_Message : public Message {
   using GOSSIP_flags_t = uint8_t;
   using rsmtype_list_t = std::vector<logid_t>; // delta log of RSM
   using versions_node_list_t = std::vector<Versions_Node>;
+  using heartbeat_list_t = std::vector<GOSSIP_Heartbeat>;
 
   GOSSIP_Message()
       : Message(MessageType::GOSSIP, TrafficClass::FAILURE_DETECTOR),
@@ -128,6 +142,11 @@ class GOSSIP_Message : public Message {
   // RSM and NCM versions
   versions_node_list_t versions_;
 
+  // Only in delta messages (see GossipSettings::gossip_full_sync_frequency):
+  // nodes that are not in node_list_, with only their heartbeat counters.
+  // Empty in full messages, which list all nodes in node_list_.
+  heartbeat_list_t heartbeat_list_;
+
   // When set in flags_, indicates that the message includes the failover list.
   static const GOSSIP_flags_t HAS_FAILOVER_LIST_FLAG = 1 << 0;
 
@@ -9,6 +9,7 @@
 
 #include "logdevice/common/protocol/ACK_Message.h"
 #include "logdevice/common/protocol/APPENDED_Message.h"
+#include "logdevice/common/protocol/APPENDS_BATCH_Message.h"
 #include "logdevice/common/protocol/APPEND_Message.h"
 #include "logdevice/common/protocol/APPEND_PROBE_Message.h"
 #include "logdevice/common/protocol/APPEND_PROBE_REPLY_Message.h"
@@ -18,6 +19,7 @@
 #include "logdevice/common/protocol/CHECK_SEAL_REPLY_Message.h"
 #include "logdevice/common/protocol/CLEANED_Message.h"
 #include "logdevice/common/protocol/CLEAN_Message.h"
+#include "logdevice/common/protocol/COMPRESSED_Message.h"
 #include "logdevice/common/protocol/CONFIG_CHANGED_Message.h"
 #include "logdevice/common/protocol/CONFIG_FETCH_Message.h"
 #include "logdevice/common/protocol/DATA_SIZE_Message.h"
@@ -50,6 +52,7 @@
 #include "logdevice/common/protocol/NODE_STATS_AGGREGATE_REPLY_Message.h"
 #include "logdevice/common/protocol/NODE_STATS_Message.h"
 #include "logdevice/common/protocol/NODE_STATS_REPLY_Message.h"
+#include "logdevice/common/protocol/RECORDS_BATCH_Message.h"
 #include "logdevice/common/protocol/RECORD_Message.h"
 #include "logdevice/common/protocol/RELEASE_Message.h"
 #include "logdevice/common/protocol/SEALED_Message.h"
@@ -60,9 +63,11 @@
 #include "logdevice/common/protocol/START_Message.h"
 #include "logdevice/common/protocol/STOP_Message.h"
 #include "logdevice/common/protocol/STORED_Message.h"
+#include "logdevice/common/protocol/STORES_BATCH_Message.h"
 #include "logdevice/common/protocol/STORE_Message.h"
 #include "logdevice/common/protocol/TEST_Message.h"
 #include "logdevice/common/protocol/TRIMMED_Message.h"
+#include "logdevice/common/protocol/TRIMS_BATCH_Message.h"
 #include "logdevice/common/protocol/TRIM_Message.h"
 #include "logdevice/common/protocol/WINDOW_Message.h"
 
@@ -0,0 +1,86 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/protocol/MessagePool.h"
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <vector>
+
+#include "logdevice/common/MemoryArenas.h"
+#include "logdevice/common/Worker.h"
+#include "logdevice/common/stats/Stats.h"
+
+namespace facebook { namespace logdevice { namespace MessagePool {
+
+namespace {
+
+// Max number of free blocks cached per message type and thread.
+constexpr size_t kMaxCachedBlocks = 1024;
+
+struct TypeCache {
+  // Size of the blocks in the cache, set by the first block freed.
+  size_t block_size{0};
+  std::vector<void*> blocks;
+};
+
+// Set when the caches of this thread are destroyed at thread exit. Messages
+// freed after that go straight to the allocator.
+thread_local bool caches_destroyed{false};
+
+struct ThreadCaches {
+  std::array<TypeCache, std::numeric_limits<uint8_t>::max() + 1> by_type;
+
+  ~ThreadCaches() {
+    caches_destroyed = true;
+    for (TypeCache& cache : by_type) {
+      for (void* p : cache.blocks) {
+        MemoryArenas::deallocate(p);
+      }
+    }
+  }
+};
+
+TypeCache* cacheFor(MessageType type) {
+  if (caches_destroyed) {
+    return nullptr;
+  }
+  static thread_local ThreadCaches caches;
+  return &caches.by_type[static_cast<uint8_t>(type)];
+}
+
+} // namespace
+
+void* allocate(MessageType type, size_t size) {
+  TypeCache* cache = cacheFor(type);
+  if (cache && size == cache->block_size && !cache->blocks.empty()) {
+    void* p = cache->blocks.back();
+    cache->blocks.pop_back();
+    MESSAGE_TYPE_STAT_INCR(Worker::stats(), type, message_pool_reused);
+    return p;
+  }
+  MESSAGE_TYPE_STAT_INCR(Worker::stats(), type, message_allocated);
+  return MemoryArenas::allocate(MemoryArena::MESSAGES, size);
+}
+
+void deallocate(MessageType type, void* p, size_t size) {
+  TypeCache* cache = cacheFor(type);
+  if (cache) {
+    if (cache->block_size == 0) {
+      cache->block_size = size;
+    }
+    if (size == cache->block_size && cache->blocks.size() < kMaxCachedBlocks) {
+      cache->blocks.push_back(p);
+      return;
+    }
+  }
+  MemoryArenas::deallocate(p);
+}
+
+}}} // namespace facebook::logdevice::MessagePool
@@ -0,0 +1,52 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <cstddef>
+
+#include "logdevice/common/protocol/MessageType.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file Thread-local caches of memory blocks for messages of hot types
+ *       (STORE, STORED, RECORD, ...). A worker allocates and frees one
+ *       object of these types for every message it receives or sends;
+ *       reusing the blocks freed on the same thread saves a trip to the
+ *       allocator for most of them.
+ *
+ *       Message classes opt in by also deriving from PooledMessage<TYPE>.
+ *       Blocks freed on a thread go to the cache of that thread, up to a
+ *       limit. Objects of subclasses with a different size bypass the cache.
+ */
+
+namespace MessagePool {
+
+// Returns a block of `size` bytes for a message of the given type, reusing a
+// block freed on this thread if there is one.
+void* allocate(MessageType type, size_t size);
+
+// Keeps the block in the cache of this thread, or frees it if the cache is
+// full.
+void deallocate(MessageType type, void* p, size_t size);
+
+} // namespace MessagePool
+
+template <MessageType Type>
+class PooledMessage {
+ public:
+  static void* operator new(size_t size) {
+    return MessagePool::allocate(Type, size);
+  }
+
+  static void operator delete(void* p, size_t size) {
+    MessagePool::deallocate(Type, p, size);
+  }
+};
+
+}} // namespace facebook::logdevice
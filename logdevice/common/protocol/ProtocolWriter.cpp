@@ -93,17 +93,9 @@ class IOBufDestination : public ProtocolWriter::Destination {
   }
 
   uint64_t computeChecksum() override {
-    uint64_t checksum = 0;
-    const size_t len = iobuf_->computeChainDataLength();
-    std::string data(len, 0);
-    auto it = data.begin();
-    for (auto& buf : *iobuf_) {
-      std::copy(buf.begin(), buf.end(), it);
-      it += buf.size();
-    }
-    Slice slice(&data[0], len);
-    checksum_bytes(slice, 64, (char*)&checksum);
-    return checksum;
+    // The chain references payloads shared with other messages (e.g. all
+    // STOREs of a record), don't copy them just to checksum.
+    return checksum_64bit(*iobuf_);
   }
   const char* identify() const override {
     return "iobuf destination";
@@ -0,0 +1,179 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/protocol/RECORDS_BATCH_Message.h"
+
+#include <folly/Varint.h>
+
+#include "logdevice/common/PayloadHolder.h"
+#include "logdevice/common/debug.h"
+#include "logdevice/common/protocol/ProtocolReader.h"
+#include "logdevice/common/protocol/ProtocolWriter.h"
+
+namespace facebook { namespace logdevice {
+
+static void write_varint(ProtocolWriter& writer, uint64_t val) {
+  uint8_t buf[folly::kMaxVarintLength64];
+  size_t n = folly::encodeVarint(val, buf);
+  writer.write(buf, n);
+}
+
+// Sets a protocol error on `reader` if the varint is malformed.
+static uint64_t read_varint(ProtocolReader& reader) {
+  uint64_t val = 0;
+  for (int shift = 0; shift < 64 && reader.ok(); shift += 7) {
+    uint8_t byte = 0;
+    reader.read(&byte);
+    val |= uint64_t(byte & 0x7f) << shift;
+    if (!(byte & 0x80)) {
+      return val;
+    }
+  }
+  reader.setError(E::BADMSG);
+  return 0;
+}
+
+RECORDS_BATCH_Message::RECORDS_BATCH_Message(
+    std::vector<std::unique_ptr<RECORD_Message>> records,
+    TrafficClass tc)
+    : Message(MessageType::RECORDS_BATCH, tc), records_(std::move(records)) {
+  ld_check(!records_.empty());
+  const RECORD_Header& first = records_.front()->header_;
+  header_ = {first.log_id,
+             first.read_stream_id,
+             first.shard,
+             static_cast<uint32_t>(records_.size()),
+             first.lsn,
+             first.timestamp};
+}
+
+bool RECORDS_BATCH_Message::canBatch(const RECORD_Message& record) {
+  return !record.extra_metadata_ && !record.offsets_.isValid() &&
+      !(record.header_.flags &
+        (RECORD_Header::INCLUDES_EXTRA_METADATA |
+         RECORD_Header::INCLUDE_BYTE_OFFSET |
+         RECORD_Header::INCLUDE_OFFSET_WITHIN_EPOCH));
+}
+
+void RECORDS_BATCH_Message::serialize(ProtocolWriter& writer) const {
+  writer.write(header_);
+
+  lsn_t prev_lsn = header_.base_lsn;
+  uint64_t prev_timestamp = header_.base_timestamp;
+  for (const auto& record : records_) {
+    const RECORD_Header& h = record->header_;
+    ld_check(h.log_id == header_.log_id);
+    ld_check(h.read_stream_id == header_.read_stream_id);
+    ld_check(h.shard == header_.shard);
+    ld_check(h.lsn >= prev_lsn);
+    ld_check(canBatch(*record));
+
+    write_varint(writer, h.flags);
+    write_varint(writer, h.lsn - prev_lsn);
+    write_varint(writer,
+                 folly::encodeZigZag(static_cast<int64_t>(h.timestamp) -
+                                     static_cast<int64_t>(prev_timestamp)));
+    prev_lsn = h.lsn;
+    prev_timestamp = h.timestamp;
+
+    // Checksum, if any, is a part of the payload on the sending side.
+    Payload p = record->payload_.getPayload();
+    write_varint(writer, p.size());
+    if (p.size() <= MAX_COPY_TO_EVBUFFER_PAYLOAD_SIZE) {
+      writer.write(p.data(), p.size());
+    } else {
+      record->payload_.serialize(writer);
+    }
+  }
+}
+
+MessageReadResult RECORDS_BATCH_Message::deserialize(ProtocolReader& reader) {
+  RECORDS_BATCH_Header header;
+  reader.read(&header);
+  if (reader.ok() && header.nrecords == 0) {
+    reader.setError(E::BADMSG);
+  }
+
+  std::vector<std::unique_ptr<RECORD_Message>> records;
+  lsn_t prev_lsn = header.base_lsn;
+  uint64_t prev_timestamp = header.base_timestamp;
+  for (uint32_t i = 0; i < header.nrecords && reader.ok(); ++i) {
+    RECORD_Header h;
+    h.log_id = header.log_id;
+    h.read_stream_id = header.read_stream_id;
+    h.shard = header.shard;
+    h.flags = static_cast<RECORD_flags_t>(read_varint(reader));
+    h.lsn = prev_lsn + read_varint(reader);
+    int64_t timestamp_delta = folly::decodeZigZag(read_varint(reader));
+    h.timestamp = static_cast<uint64_t>(static_cast<int64_t>(prev_timestamp) +
+                                        timestamp_delta);
+    size_t payload_size = read_varint(reader);
+    if (!reader.ok()) {
+      break;
+    }
+    if (payload_size > reader.bytesRemaining() ||
+        (h.flags & RECORD_Header::INCLUDES_EXTRA_METADATA) ||
+        (h.flags & RECORD_Header::INCLUDE_BYTE_OFFSET)) {
+      reader.setError(E::BADMSG);
+      break;
+    }
+    prev_lsn = h.lsn;
+    prev_timestamp = h.timestamp;
+
+    uint64_t expected_checksum =
+        RECORD_Message::readChecksum(reader, h, &payload_size);
+    PayloadHolder payload = PayloadHolder::deserialize(reader, payload_size);
+
+    // Same as in RECORD_Message::deserialize().
+    TrafficClass tc = (h.flags & RECORD_Header::DIGEST)
+        ? TrafficClass::RECOVERY
+        : TrafficClass::READ_TAIL;
+    auto record = std::make_unique<RECORD_Message>(
+        h, tc, std::move(payload), nullptr);
+    record->expected_checksum_ = expected_checksum;
+    records.push_back(std::move(record));
+  }
+
+  return reader.result([&] {
+    return new RECORDS_BATCH_Message(
+        std::move(records), TrafficClass::READ_TAIL);
+  });
+}
+
+Message::Disposition RECORDS_BATCH_Message::onReceived(const Address& from) {
+  for (auto& record : records_) {
+    Disposition disp = record->onReceived(from);
+    // RECORD_Message::onReceived() never keeps the message.
+    ld_check(disp != Disposition::KEEP);
+    if (disp == Disposition::ERROR) {
+      return disp;
+    }
+  }
+  return Disposition::NORMAL;
+}
+
+uint16_t RECORDS_BATCH_Message::getMinProtocolVersion() const {
+  return Compatibility::RECORDS_BATCH_SUPPORT;
+}
+
+std::vector<std::pair<std::string, folly::dynamic>>
+RECORDS_BATCH_Message::getDebugInfo() const {
+  std::vector<std::pair<std::string, folly::dynamic>> res;
+  auto add = [&](const char* key, folly::dynamic val) {
+    res.push_back(
+        std::make_pair<std::string, folly::dynamic>(key, std::move(val)));
+  };
+  add("log_id", toString(header_.log_id));
+  add("shard", header_.shard);
+  add("read_stream_id", header_.read_stream_id.val());
+  add("nrecords", header_.nrecords);
+  add("first_lsn", lsn_to_string(records_.front()->header_.lsn));
+  add("last_lsn", lsn_to_string(records_.back()->header_.lsn));
+  return res;
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,84 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "logdevice/common/protocol/Message.h"
+#include "logdevice/common/protocol/RECORD_Message.h"
+#include "logdevice/include/types.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file Sent by storage nodes to deliver several consecutive records of a
+ *       read stream in one message. For small records the per-message
+ *       overhead of RECORD (protocol header, envelope, Sender accounting)
+ *       dominates the payload.
+ *
+ *       Only records without extra metadata and byte offsets can be batched.
+ *       The header carries the fields that are the same for all records; for
+ *       each record, the LSN and timestamp are encoded as varint deltas from
+ *       the previous one.
+ */
+
+struct RECORDS_BATCH_Header {
+  logid_t log_id;
+  read_stream_id_t read_stream_id;
+  shard_index_t shard;
+  uint32_t nrecords;
+  // LSN and timestamp the deltas of the first record are relative to.
+  lsn_t base_lsn;
+  uint64_t base_timestamp;
+
+  // Header is followed by `nrecords` entries, each made of the following
+  // varints:
+  // - RECORD_Header::flags
+  // - LSN minus the LSN of the previous record (or base_lsn), positive
+  // - timestamp minus the timestamp of the previous record (or
+  //   base_timestamp), zigzag-encoded
+  // - size of the checksum and payload that follow, as in RECORD
+} __attribute__((__packed__));
+
+class RECORDS_BATCH_Message : public Message {
+ public:
+  /**
+   * @param records  at least one record. All must be for the same log, read
+   *                 stream and shard, in increasing LSN order, and without
+   *                 extra metadata or byte offsets.
+   */
+  RECORDS_BATCH_Message(std::vector<std::unique_ptr<RECORD_Message>> records,
+                        TrafficClass tc);
+
+  RECORDS_BATCH_Message(const RECORDS_BATCH_Message&) = delete;
+  RECORDS_BATCH_Message& operator=(const RECORDS_BATCH_Message&) = delete;
+
+  /**
+   * @return true if `record` can be delivered as part of a RECORDS_BATCH
+   *         message.
+   */
+  static bool canBatch(const RECORD_Message& record);
+
+  // see Message.h
+  void serialize(ProtocolWriter&) const override;
+  // Hands each record to RECORD_Message::onReceived().
+  Disposition onReceived(const Address& from) override;
+  uint16_t getMinProtocolVersion() const override;
+  static Message::deserializer_t deserialize;
+  // onSent() handler lives in server/RECORD_onSent.cpp
+
+  std::vector<std::pair<std::string, folly::dynamic>>
+  getDebugInfo() const override;
+
+  RECORDS_BATCH_Header header_;
+
+  std::vector<std::unique_ptr<RECORD_Message>> records_;
+};
+
+}} // namespace facebook::logdevice
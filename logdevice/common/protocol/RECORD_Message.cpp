@@ -108,6 +108,25 @@ MessageReadResult RECORD_Message::deserialize(ProtocolReader& reader) {
   // If flags indicate that the payload includes a checksum, strip it now.
   // The payload size reported to the client will be just the actual client
   // payload.
+  size_t payload_size = reader.ok() ? reader.bytesRemaining() : 0;
+  uint64_t expected_checksum = readChecksum(reader, header, &payload_size);
+  ld_check(payload_size < Message::MAX_LEN);
+
+  PayloadHolder payload_holder =
+      PayloadHolder::deserialize(reader, payload_size);
+
+  return reader.result([&] {
+    auto m = std::make_unique<RECORD_Message>(
+        header, tc, std::move(payload_holder), std::move(extra_metadata));
+    m->expected_checksum_ = expected_checksum;
+    m->offsets_ = std::move(offsets);
+    return m;
+  });
+}
+
+uint64_t RECORD_Message::readChecksum(ProtocolReader& reader,
+                                      const RECORD_Header& header,
+                                      size_t* payload_size) {
   uint64_t expected_checksum = 0;
   if (reader.ok() && (header.flags & RECORD_Header::CHECKSUM)) {
     union {
@@ -124,14 +143,14 @@ MessageReadResult RECORD_Message::deserialize(ProtocolReader& reader) {
       checksum_size = sizeof u.c32;
     }
 
-    if (reader.bytesRemaining() < checksum_size) {
+    if (*payload_size < checksum_size) {
       RATELIMIT_ERROR(
           std::chrono::seconds(10),
           10,
           "Malformed RECORD message: ran out of bytes while reading "
           "checksum (expected %zu, got %zu); log: %lu lsn: %s rsid: %lu",
           checksum_size,
-          reader.bytesRemaining(),
+          *payload_size,
           header.log_id.val_,
           lsn_to_string(header.lsn).c_str(),
           header.read_stream_id.val_);
@@ -141,24 +160,12 @@ MessageReadResult RECORD_Message::deserialize(ProtocolReader& reader) {
       expected_checksum = 0x5000b4df00f00f00ul;
     } else {
       reader.read(ptr, checksum_size);
+      *payload_size -= checksum_size;
       expected_checksum =
           (header.flags & RECORD_Header::CHECKSUM_64BIT) ? u.c64 : u.c32;
     }
   }
-
-  size_t payload_size = reader.ok() ? reader.bytesRemaining() : 0;
-  ld_check(payload_size < Message::MAX_LEN);
-
-  PayloadHolder payload_holder =
-      PayloadHolder::deserialize(reader, payload_size);
-
-  return reader.result([&] {
-    auto m = std::make_unique<RECORD_Message>(
-        header, tc, std::move(payload_holder), std::move(extra_metadata));
-    m->expected_checksum_ = expected_checksum;
-    m->offsets_ = std::move(offsets);
-    return m;
-  });
+  return expected_checksum;
 }
 
 std::string RECORD_Message::identify() const {
@@ -195,13 +202,14 @@ Message::Disposition RECORD_Message::onReceived(const Address& from) {
 
   if (header_.flags & RECORD_Header::DIGEST) {
     // this is a digest record, route to an EpochRecovery object
-    recovery = w->findActiveEpochRecovery(header_.log_id);
+    recovery =
+        w->findActiveEpochRecovery(header_.log_id, lsn_to_epoch(header_.lsn));
     if (!recovery) {
       RATELIMIT_INFO(std::chrono::seconds(1),
                      10,
                      "Got an invalid or stale digest record %s from %s for "
                      "read stream %lu. No epoch recovery machine is active "
-                     "for log. Ignoring.",
+                     "for its epoch. Ignoring.",
                      identify().c_str(),
                      Sender::describeConnection(from).c_str(),
                      header_.read_stream_id.val_);
@@ -15,6 +15,7 @@
 #include "logdevice/common/OffsetMap.h"
 #include "logdevice/common/PayloadHolder.h"
 #include "logdevice/common/protocol/Message.h"
+#include "logdevice/common/protocol/MessagePool.h"
 #include "logdevice/common/types_internal.h"
 #include "logdevice/include/Record.h"
 #include "logdevice/include/types.h"
@@ -130,7 +131,9 @@ struct ExtraMetadata {
   OffsetMap offsets_within_epoch;
 };
 
-class RECORD_Message : public Message, boost::noncopyable {
+class RECORD_Message : public Message,
+                       public PooledMessage<MessageType::RECORD>,
+                       boost::noncopyable {
  public:
   // identifies the origin of the record
   enum class Source { LOCAL_LOG_STORE, CACHED_DIGEST, UNKNOWN };
@@ -173,6 +176,18 @@ class RECORD_Message : public Message, boost::noncopyable {
   static Message::deserializer_t deserialize;
   // onSent() handler lives in server/RECORD_onSent.cpp
 
+  /**
+   * Reads the checksum that prefixes the payload of a record if
+   * header.flags say there is one, and subtracts its size from
+   * *payload_size, the number of bytes of checksum and payload left in the
+   * message. Also used by RECORDS_BATCH_Message.
+   *
+   * @return the checksum to be verified by onReceived(), or 0 if there is none
+   */
+  static uint64_t readChecksum(ProtocolReader& reader,
+                               const RECORD_Header& header,
+                               size_t* payload_size);
+
   /**
    * @return a human-readable string with the record's log id, epoch, and ESN
    *         for use in error messages
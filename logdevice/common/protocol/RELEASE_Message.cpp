@@ -21,11 +21,17 @@
 
 namespace facebook { namespace logdevice {
 
-RELEASE_Message::RELEASE_Message(const RELEASE_Header& header)
-    : Message(MessageType::RELEASE, TrafficClass::READ_TAIL), header_(header) {}
+RELEASE_Message::RELEASE_Message(const RELEASE_Header& header,
+                                 OffsetMap epoch_offsets)
+    : Message(MessageType::RELEASE, TrafficClass::READ_TAIL),
+      header_(header),
+      epoch_offsets_(std::move(epoch_offsets)) {}
 
 void RELEASE_Message::serialize(ProtocolWriter& writer) const {
   writer.write(&header_, RELEASE_Header::headerSize(writer.proto()));
+  if (writer.proto() >= Compatibility::RELEASE_EPOCH_OFFSETS_SUPPORT) {
+    epoch_offsets_.serialize(writer);
+  }
 }
 
 MessageReadResult RELEASE_Message::deserialize(ProtocolReader& reader) {
@@ -35,9 +41,14 @@ MessageReadResult RELEASE_Message::deserialize(ProtocolReader& reader) {
   hdr.release_type = ReleaseType::GLOBAL;
 
   reader.read(&hdr, RELEASE_Header::headerSize(reader.proto()));
+  OffsetMap epoch_offsets;
+  if (reader.proto() >= Compatibility::RELEASE_EPOCH_OFFSETS_SUPPORT) {
+    epoch_offsets.deserialize(reader, false /* unused */);
+  }
 
   reader.allowTrailingBytes();
-  return reader.result([&] { return new RELEASE_Message(hdr); });
+  return reader.result(
+      [&] { return new RELEASE_Message(hdr, std::move(epoch_offsets)); });
 }
 
 void RELEASE_Message::onSent(Status st, const Address& to) const {
@@ -109,6 +120,9 @@ RELEASE_Message::getDebugInfo() const {
   add("upto_lsn", lsn_to_string(header_.rid.lsn()));
   add("release_type", release_type_to_string(header_.release_type));
   add("shard", header_.shard);
+  if (epoch_offsets_.isValid()) {
+    add("epoch_offsets", epoch_offsets_.toString());
+  }
   return res;
 }
 
@@ -10,9 +10,11 @@
 #include <cstdint>
 #include <string>
 
+#include "logdevice/common/OffsetMap.h"
 #include "logdevice/common/RecordID.h"
 #include "logdevice/common/configuration/TrafficClass.h"
 #include "logdevice/common/protocol/FixedSizeMessage.h"
+#include "logdevice/common/protocol/MessagePool.h"
 
 namespace facebook { namespace logdevice {
 
@@ -37,9 +39,11 @@ struct RELEASE_Header {
   }
 } __attribute__((__packed__));
 
-class RELEASE_Message : public Message {
+class RELEASE_Message : public Message,
+                        public PooledMessage<MessageType::RELEASE> {
  public:
-  explicit RELEASE_Message(const RELEASE_Header& header);
+  explicit RELEASE_Message(const RELEASE_Header& header,
+                           OffsetMap epoch_offsets = OffsetMap());
 
   RELEASE_Message(const RELEASE_Message&) noexcept = delete;
   RELEASE_Message(RELEASE_Message&&) noexcept = delete;
@@ -67,6 +71,14 @@ class RELEASE_Message : public Message {
   getDebugInfo() const override;
 
   RELEASE_Header header_;
+
+  // Byte offsets of the log at the start of epoch rid.epoch, as known to the
+  // sequencer. Lets storage nodes keep LogStorageState's epoch offsets current
+  // so that readers asking for byte offsets don't have to read them from the
+  // local log store or ask the sequencer. Invalid if the sequencer doesn't
+  // know them yet (e.g. recovery of the previous epochs isn't done), and
+  // always on protocols older than RELEASE_EPOCH_OFFSETS_SUPPORT.
+  OffsetMap epoch_offsets_;
 };
 
 const std::string& release_type_to_string(ReleaseType release_type);
@@ -18,6 +18,7 @@
 #include "logdevice/common/debug.h"
 #include "logdevice/common/protocol/ProtocolReader.h"
 #include "logdevice/common/protocol/ProtocolWriter.h"
+#include "logdevice/common/toString.h"
 #include "logdevice/include/Err.h"
 
 namespace facebook { namespace logdevice {
@@ -37,9 +38,10 @@ void START_Message::onSent(Status st, const Address& to) const {
     // EpochRecovery machine and on to the RecoveryNode that sent the message,
     // if they are still around.
     const epoch_t recovering_epoch = lsn_to_epoch(header_.start_lsn);
-    EpochRecovery* active_recovery = w->findActiveEpochRecovery(header_.log_id);
+    EpochRecovery* active_recovery =
+        w->findActiveEpochRecovery(header_.log_id, recovering_epoch);
 
-    if (!active_recovery || active_recovery->epoch_ != recovering_epoch) {
+    if (!active_recovery) {
       RATELIMIT_WARNING(std::chrono::seconds(1),
                         10,
                         "Got a stale onSent() for a START message sent by an "
@@ -80,6 +82,11 @@ void START_Message::serialize(ProtocolWriter& writer) const {
   writer.write(static_cast<uint8_t>(attrs_.filter_type));
   writer.writeLengthPrefixedVector(attrs_.filter_key1);
   writer.writeLengthPrefixedVector(attrs_.filter_key2);
+  if (writer.proto() >= Compatibility::SERVER_RECORD_SAMPLING_SUPPORT) {
+    writer.write(attrs_.sampling.one_in);
+    writer.write(int64_t(attrs_.sampling.min_timestamp.count()));
+    writer.write(int64_t(attrs_.sampling.max_timestamp.count()));
+  }
 
   if (header_.scd_copyset_reordering ==
       SCDCopysetReordering::HASH_SHUFFLE_CLIENT_SEED) {
@@ -95,6 +102,26 @@ void START_Message::serialize(ProtocolWriter& writer) const {
     writer.write(h1);
     writer.write(h2);
   }
+
+  if (header_.flags & START_Header::SCD_PREFERRED_NODES) {
+    writer.writeLengthPrefixedVector(scd_preferred_nodes_);
+  }
+}
+
+uint16_t START_Message::getMinProtocolVersion() const {
+  if (header_.flags & START_Header::SCD_PREFERRED_NODES) {
+    return Compatibility::SCD_PREFERRED_NODES_SUPPORT;
+  }
+  if (attrs_.sampling.enabled()) {
+    return Compatibility::SERVER_RECORD_SAMPLING_SUPPORT;
+  }
+  switch (attrs_.filter_type) {
+    case ServerRecordFilterType::IN_SET:
+    case ServerRecordFilterType::PREFIX:
+      return Compatibility::SERVER_RECORD_FILTER_SETS_SUPPORT;
+    default:
+      return Message::getMinProtocolVersion();
+  }
 }
 
 MessageReadResult START_Message::deserialize(ProtocolReader& reader) {
@@ -118,21 +145,31 @@ MessageReadResult START_Message::deserialize(ProtocolReader& reader) {
     uint8_t temp;
     reader.read(&temp, sizeof(temp));
     m->attrs_.filter_type = static_cast<ServerRecordFilterType>(temp);
-    if (m->attrs_.filter_type != ServerRecordFilterType::EQUALITY &&
-        m->attrs_.filter_type != ServerRecordFilterType::RANGE &&
-        m->attrs_.filter_type != ServerRecordFilterType::NOFILTER) {
+    if (m->attrs_.filter_type >= ServerRecordFilterType::MAX) {
       ld_error("Bad START message, unknown ServerRecordFilterType: %d",
                static_cast<int>(m->attrs_.filter_type));
       return reader.errorResult(E::BADMSG);
     }
     reader.readLengthPrefixedVector(&m->attrs_.filter_key1);
     reader.readLengthPrefixedVector(&m->attrs_.filter_key2);
+    if (proto >= Compatibility::SERVER_RECORD_SAMPLING_SUPPORT) {
+      int64_t min_ts, max_ts;
+      reader.read(&m->attrs_.sampling.one_in);
+      reader.read(&min_ts);
+      reader.read(&max_ts);
+      m->attrs_.sampling.min_timestamp = std::chrono::milliseconds(min_ts);
+      m->attrs_.sampling.max_timestamp = std::chrono::milliseconds(max_ts);
+    }
 
     if (m->header_.scd_copyset_reordering ==
         SCDCopysetReordering::HASH_SHUFFLE_CLIENT_SEED) {
       reader.read(&m->csid_hash_pt1, sizeof(m->csid_hash_pt1));
       reader.read(&m->csid_hash_pt2, sizeof(m->csid_hash_pt2));
     }
+
+    if (m->header_.flags & START_Header::SCD_PREFERRED_NODES) {
+      reader.readLengthPrefixedVector(&m->scd_preferred_nodes_);
+    }
   }
 
   return reader.resultMsg(std::move(m));
@@ -156,6 +193,9 @@ START_Message::getDebugInfo() const {
   add("replication", header_.replication);
   add("scd_copyset_reordering", int(header_.scd_copyset_reordering));
   add("flags", header_.flags);
+  if (header_.flags & START_Header::SCD_PREFERRED_NODES) {
+    add("scd_preferred_nodes", toString(scd_preferred_nodes_));
+  }
   return res;
 }
 
@@ -7,6 +7,8 @@
  */
 #pragma once
 
+#include <vector>
+
 #include <folly/Optional.h>
 #include <folly/small_vector.h>
 
@@ -104,6 +106,12 @@ struct START_Header {
   // if it is the primary recipient (left-most in copyset) of the record in the
   // client's region.
   static const START_flags_t LOCAL_SCD_ENABLED = 1u << 11; //=2048
+
+  // If set in .flags, the message carries a list of nodes the client prefers
+  // to read from, fastest first. When doing single copy delivery, the storage
+  // node moves these nodes to the front of the (reordered) copyset, in that
+  // order, before picking the primary recipient.
+  static const START_flags_t SCD_PREFERRED_NODES = 1u << 12; //=4096
 } __attribute__((__packed__));
 
 class START_Message : public Message {
@@ -143,6 +151,7 @@ class START_Message : public Message {
     std::abort();
   }
   void onSent(Status st, const Address& to) const override;
+  uint16_t getMinProtocolVersion() const override;
   bool warnAboutOldProtocol() const override {
     // We have highly sophisticated handling for protocol versions
     return false;
@@ -165,6 +174,10 @@ class START_Message : public Message {
   uint64_t csid_hash_pt1 = 0;     // Session id hash, pt1
   uint64_t csid_hash_pt2 = 0;     // Session id hash, pt2
 
+  // Nodes the client prefers to read from, fastest first. Only sent if
+  // START_Header::SCD_PREFERRED_NODES is set.
+  std::vector<node_index_t> scd_preferred_nodes_;
+
   virtual std::vector<std::pair<std::string, folly::dynamic>>
   getDebugInfo() const override;
 };
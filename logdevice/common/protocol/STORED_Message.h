@@ -15,6 +15,7 @@
 #include "logdevice/common/ShardID.h"
 #include "logdevice/common/configuration/TrafficClass.h"
 #include "logdevice/common/protocol/Message.h"
+#include "logdevice/common/protocol/MessagePool.h"
 #include "logdevice/include/Err.h"
 #include "logdevice/include/types.h"
 
@@ -99,7 +100,8 @@ struct STORED_Header {
   static const STORED_flags_t LOW_WATERMARK_NOSPC = 1ul << 5; //=32
 } __attribute__((__packed__));
 
-class STORED_Message : public Message {
+class STORED_Message : public Message,
+                       public PooledMessage<MessageType::STORED> {
  public:
   static TrafficClass calcTrafficClass(const STORED_Header& header) {
     return (header.flags & STORED_Header::REBUILDING) ? TrafficClass::REBUILD
@@ -0,0 +1,104 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/protocol/STORES_BATCH_Message.h"
+
+#include <algorithm>
+
+#include "logdevice/common/debug.h"
+#include "logdevice/common/protocol/ProtocolReader.h"
+#include "logdevice/common/protocol/ProtocolWriter.h"
+
+namespace facebook { namespace logdevice {
+
+STORES_BATCH_Message::STORES_BATCH_Message(
+    std::vector<std::unique_ptr<STORE_Message>> stores)
+    : Message(MessageType::STORES_BATCH, TrafficClass::REBUILD),
+      stores_(std::move(stores)) {
+  ld_check(!stores_.empty());
+}
+
+STORES_BATCH_Message::STORES_BATCH_Message(
+    std::vector<std::unique_ptr<folly::IOBuf>> serialized_stores)
+    : Message(MessageType::STORES_BATCH, TrafficClass::REBUILD),
+      serialized_stores_(std::move(serialized_stores)) {}
+
+void STORES_BATCH_Message::serialize(ProtocolWriter& writer) const {
+  STORES_BATCH_Header header = {static_cast<uint32_t>(stores_.size())};
+  writer.write(header);
+
+  for (const auto& store : stores_) {
+    if (writer.isBlackHole()) {
+      // Only the size is needed, don't copy the payload.
+      uint32_t size = store->size(writer.proto());
+      writer.write(size);
+      writer.write(nullptr, size);
+      continue;
+    }
+    // The inner messages are not checksummed separately, the checksum of
+    // the STORES_BATCH message covers them.
+    std::unique_ptr<folly::IOBuf> buf =
+        store->serialize(writer.proto(), /* checksum_enabled */ false);
+    if (!buf) {
+      writer.setError(err);
+      return;
+    }
+    uint32_t size = buf->computeChainDataLength();
+    writer.write(size);
+    writer.writeWithoutCopy(buf.get());
+  }
+}
+
+MessageReadResult STORES_BATCH_Message::deserialize(ProtocolReader& reader) {
+  STORES_BATCH_Header header;
+  reader.read(&header);
+  if (reader.ok() && header.nstores == 0) {
+    reader.setError(E::BADMSG);
+  }
+
+  std::vector<std::unique_ptr<folly::IOBuf>> serialized_stores;
+  for (uint32_t i = 0; i < header.nstores && reader.ok(); ++i) {
+    uint32_t size = 0;
+    reader.read(&size);
+    if (!reader.ok()) {
+      break;
+    }
+    if (size == 0 || size > reader.bytesRemaining()) {
+      reader.setError(E::BADMSG);
+      break;
+    }
+    auto buf = std::make_unique<folly::IOBuf>();
+    reader.readIOBuf(buf.get(), size);
+    serialized_stores.push_back(std::move(buf));
+  }
+
+  return reader.result([&] {
+    return new STORES_BATCH_Message(std::move(serialized_stores));
+  });
+}
+
+Message::Disposition STORES_BATCH_Message::onReceived(const Address&) {
+  ld_check(false);
+  err = E::PROTO;
+  return Disposition::ERROR;
+}
+
+void STORES_BATCH_Message::onSent(Status, const Address&) const {
+  ld_check(false);
+}
+
+bool STORES_BATCH_Message::cancelled() const {
+  return std::all_of(stores_.begin(), stores_.end(), [](const auto& store) {
+    return store->cancelled();
+  });
+}
+
+uint16_t STORES_BATCH_Message::getMinProtocolVersion() const {
+  return Compatibility::STORES_BATCH_SUPPORT;
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,78 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <folly/io/IOBuf.h>
+
+#include "logdevice/common/protocol/Message.h"
+#include "logdevice/common/protocol/STORE_Message.h"
+#include "logdevice/include/types.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file Sent by rebuilding donors to deliver the STOREs (or amends) of
+ *       several records of a chunk to one storage node in one message, see
+ *       ChunkRebuilding. Rebuilding many small records is otherwise bound by
+ *       the per-message cost of STORE rather than by bandwidth. Sequencers
+ *       also use it to send STOREs of different logs to the same node
+ *       together, see StoreBatcher.
+ *
+ *       Like APPENDS_BATCH, each STORE is carried whole, including its
+ *       ProtocolHeader, and the receiving Connection dispatches each one as if
+ *       it had come off the socket directly. Each STORE gets its own STORED
+ *       reply.
+ */
+
+struct STORES_BATCH_Header {
+  uint32_t nstores;
+
+  // Header is followed by `nstores` entries, each made of a uint32_t size
+  // followed by that many bytes of a serialized STORE message, including its
+  // ProtocolHeader.
+} __attribute__((__packed__));
+
+class STORES_BATCH_Message : public Message {
+ public:
+  /**
+   * @param stores  at least one STORE, all going to the same node.
+   */
+  explicit STORES_BATCH_Message(
+      std::vector<std::unique_ptr<STORE_Message>> stores);
+
+  STORES_BATCH_Message(const STORES_BATCH_Message&) = delete;
+  STORES_BATCH_Message& operator=(const STORES_BATCH_Message&) = delete;
+
+  // see Message.h
+  void serialize(ProtocolWriter&) const override;
+  // Connection unwraps STORES_BATCH messages itself, this is never called.
+  Disposition onReceived(const Address& from) override;
+  // The handler lives in server/ServerMessageDispatch.cpp, which hands the
+  // status to STORE_onSent() of every STORE. This should never get called.
+  void onSent(Status st, const Address& to) const override;
+  // Cancelled if all the STOREs are.
+  bool cancelled() const override;
+  uint16_t getMinProtocolVersion() const override;
+  static Message::deserializer_t deserialize;
+
+  // Set on the sending side.
+  std::vector<std::unique_ptr<STORE_Message>> stores_;
+
+  // Set on the receiving side: the serialized STORE messages, including their
+  // ProtocolHeaders.
+  std::vector<std::unique_ptr<folly::IOBuf>> serialized_stores_;
+
+ private:
+  explicit STORES_BATCH_Message(
+      std::vector<std::unique_ptr<folly::IOBuf>> serialized_stores);
+};
+
+}} // namespace facebook::logdevice
@@ -27,6 +27,7 @@
 #include "logdevice/common/ShardID.h"
 #include "logdevice/common/configuration/TrafficClass.h"
 #include "logdevice/common/protocol/Message.h"
+#include "logdevice/common/protocol/MessagePool.h"
 #include "logdevice/common/settings/Durability.h"
 #include "logdevice/common/types_internal.h"
 #include "logdevice/include/Record.h"
@@ -230,7 +231,8 @@ struct STORE_Extra {
   }
 };
 
-class STORE_Message : public Message {
+class STORE_Message : public Message,
+                      public PooledMessage<MessageType::STORE> {
  public:
   /**
    * Appender and Mutator use this constructor when composing STORE messages to
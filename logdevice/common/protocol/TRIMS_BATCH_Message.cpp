@@ -0,0 +1,98 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/protocol/TRIMS_BATCH_Message.h"
+
+#include "logdevice/common/debug.h"
+#include "logdevice/common/protocol/ProtocolReader.h"
+#include "logdevice/common/protocol/ProtocolWriter.h"
+
+namespace facebook { namespace logdevice {
+
+TRIMS_BATCH_Message::TRIMS_BATCH_Message(
+    std::vector<std::unique_ptr<TRIM_Message>> trims)
+    : Message(MessageType::TRIMS_BATCH, TrafficClass::TRIM),
+      trims_(std::move(trims)) {
+  ld_check(!trims_.empty());
+}
+
+TRIMS_BATCH_Message::TRIMS_BATCH_Message(
+    std::vector<std::unique_ptr<folly::IOBuf>> serialized_trims)
+    : Message(MessageType::TRIMS_BATCH, TrafficClass::TRIM),
+      serialized_trims_(std::move(serialized_trims)) {}
+
+void TRIMS_BATCH_Message::serialize(ProtocolWriter& writer) const {
+  TRIMS_BATCH_Header header = {static_cast<uint32_t>(trims_.size())};
+  writer.write(header);
+
+  for (const auto& trim : trims_) {
+    if (writer.isBlackHole()) {
+      // Only the size is needed, don't copy the payload.
+      uint32_t size = trim->size(writer.proto());
+      writer.write(size);
+      writer.write(nullptr, size);
+      continue;
+    }
+    // The inner messages are not checksummed separately, the checksum of
+    // the TRIMS_BATCH message covers them.
+    std::unique_ptr<folly::IOBuf> buf =
+        trim->serialize(writer.proto(), /* checksum_enabled */ false);
+    if (!buf) {
+      writer.setError(err);
+      return;
+    }
+    uint32_t size = buf->computeChainDataLength();
+    writer.write(size);
+    writer.writeWithoutCopy(buf.get());
+  }
+}
+
+MessageReadResult TRIMS_BATCH_Message::deserialize(ProtocolReader& reader) {
+  TRIMS_BATCH_Header header;
+  reader.read(&header);
+  if (reader.ok() && header.ntrims == 0) {
+    reader.setError(E::BADMSG);
+  }
+
+  std::vector<std::unique_ptr<folly::IOBuf>> serialized_trims;
+  for (uint32_t i = 0; i < header.ntrims && reader.ok(); ++i) {
+    uint32_t size = 0;
+    reader.read(&size);
+    if (!reader.ok()) {
+      break;
+    }
+    if (size == 0 || size > reader.bytesRemaining()) {
+      reader.setError(E::BADMSG);
+      break;
+    }
+    auto buf = std::make_unique<folly::IOBuf>();
+    reader.readIOBuf(buf.get(), size);
+    serialized_trims.push_back(std::move(buf));
+  }
+
+  return reader.result([&] {
+    return new TRIMS_BATCH_Message(std::move(serialized_trims));
+  });
+}
+
+Message::Disposition TRIMS_BATCH_Message::onReceived(const Address&) {
+  ld_check(false);
+  err = E::PROTO;
+  return Disposition::ERROR;
+}
+
+void TRIMS_BATCH_Message::onSent(Status st, const Address& to) const {
+  for (const auto& trim : trims_) {
+    trim->onSent(st, to);
+  }
+}
+
+uint16_t TRIMS_BATCH_Message::getMinProtocolVersion() const {
+  return Compatibility::TRIMS_BATCH_SUPPORT;
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,73 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <folly/io/IOBuf.h>
+
+#include "logdevice/common/protocol/Message.h"
+#include "logdevice/common/protocol/TRIM_Message.h"
+#include "logdevice/include/types.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file Sent by clients to deliver TRIMs of several logs to a storage node in
+ *       one message (see TrimBatcher). Retention jobs trimming many logs
+ *       otherwise send one TRIM per log per storage shard.
+ *
+ *       Each TRIM is carried whole, including its ProtocolHeader. The
+ *       receiving Connection unwraps them and dispatches each one as if it
+ *       had come off the socket directly, so they go through the same
+ *       per-log permission checks as unbatched TRIMs. The storage node then
+ *       coalesces the trim points of a shard into a single write.
+ */
+
+struct TRIMS_BATCH_Header {
+  uint32_t ntrims;
+
+  // Header is followed by `ntrims` entries, each made of a uint32_t size
+  // followed by that many bytes of a serialized TRIM message, including its
+  // ProtocolHeader.
+} __attribute__((__packed__));
+
+class TRIMS_BATCH_Message : public Message {
+ public:
+  /**
+   * @param trims  at least one TRIM, all going to the same node.
+   */
+  explicit TRIMS_BATCH_Message(
+      std::vector<std::unique_ptr<TRIM_Message>> trims);
+
+  TRIMS_BATCH_Message(const TRIMS_BATCH_Message&) = delete;
+  TRIMS_BATCH_Message& operator=(const TRIMS_BATCH_Message&) = delete;
+
+  // see Message.h
+  void serialize(ProtocolWriter&) const override;
+  // Connection unwraps TRIMS_BATCH messages itself, this is never called.
+  Disposition onReceived(const Address& from) override;
+  // Hands the status to TRIM_Message::onSent() of every TRIM.
+  void onSent(Status st, const Address& to) const override;
+  uint16_t getMinProtocolVersion() const override;
+  static Message::deserializer_t deserialize;
+
+  // Set on the sending side.
+  std::vector<std::unique_ptr<TRIM_Message>> trims_;
+
+  // Set on the receiving side: the serialized TRIM messages, including their
+  // ProtocolHeaders.
+  std::vector<std::unique_ptr<folly::IOBuf>> serialized_trims_;
+
+ private:
+  explicit TRIMS_BATCH_Message(
+      std::vector<std::unique_ptr<folly::IOBuf>> serialized_trims);
+};
+
+}} // namespace facebook::logdevice
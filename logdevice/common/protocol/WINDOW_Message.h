@@ -8,6 +8,7 @@
 #pragma once
 
 #include "logdevice/common/protocol/Message.h"
+#include "logdevice/common/protocol/MessagePool.h"
 #include "logdevice/common/types_internal.h"
 #include "logdevice/include/types.h"
 
@@ -33,7 +34,8 @@ struct WINDOW_Header {
                                    // protocol.
 } __attribute__((__packed__));
 
-class WINDOW_Message : public Message {
+class WINDOW_Message : public Message,
+                       public PooledMessage<MessageType::WINDOW> {
  public:
   /**
    * Construct a WINDOW message.
@@ -148,6 +148,13 @@ void ReplicatedStateMachine<T, D>::stop() {
   stop_read_stream(delta_log_rsid_);
 
   stopped_ = true;
+  // Deltas queued for batching will never be appended.
+  std::vector<PendingDeltaAppend> batch;
+  batch.swap(delta_batch_);
+  delta_batch_bytes_ = 0;
+  for (const auto& delta : batch) {
+    onDeltaAppended(delta, E::SHUTDOWN, LSN_INVALID);
+  }
   cancelGracePeriodForSnapshotting();
   read_stream_deletion_timer_.cancel();
   // This will unblock anyone that called wait().
@@ -802,34 +809,87 @@ bool ReplicatedStateMachine<T, D>::onDeltaRecord(
     return true;
   }
 
+  delta_log_byte_offset_ += record->payload.size();
+  ++delta_log_offset_;
+
+  // A record normally contains a single delta, or several if it was written
+  // by a state machine batching its deltas (@see setMaxDeltasPerRecord()).
+  // They are all applied in order at the lsn of the record.
+  std::vector<Payload> payloads;
+  DeltaHeader header;
+  if (deserializeDeltaHeader(record->payload, header) &&
+      (header.flags & DeltaHeader::BATCH)) {
+    if (splitDeltaBatch(record->payload, header, payloads) != 0) {
+      rsm_error(rsm_type_,
+                "Could not split batch of deltas in record with lsn=%s ts=%s",
+                lsn_to_string(record->attrs.lsn).c_str(),
+                format_time(record->attrs.timestamp).c_str());
+      payloads.clear();
+    }
+  } else {
+    payloads.push_back(record->payload);
+  }
+
+  std::vector<std::unique_ptr<D>> applied;
+  for (const Payload& payload : payloads) {
+    auto delta = processDelta(*record, payload);
+    if (delta) {
+      applied.push_back(std::move(delta));
+    }
+  }
+
+  // This call catches the case where we could not parse the deltas's header and
+  // thus its uuid.
+  discardSkippedPendingDeltas();
+
+  if (sync_state_ == SyncState::TAILING || deliver_while_replaying_) {
+    for (const auto& delta : applied) {
+      notifySubscribers(delta.get());
+    }
+  }
+
+  if (sync_state_ == SyncState::SYNC_DELTAS &&
+      record->attrs.lsn >= delta_sync_) {
+    // We finished reading the backlog and reached the tail. This function will
+    // inform all subscribers of the initial state.
+    onReachedDeltaLogTailLSN();
+  }
+
+  return true;
+}
+
+template <typename T, typename D>
+std::unique_ptr<D>
+ReplicatedStateMachine<T, D>::processDelta(const DataRecord& record,
+                                           const Payload& payload) {
   Status st = E::OK;
 
   DeltaHeader header;
   std::unique_ptr<D> delta;
-  int rv = deserializeDelta(*record, delta, header);
+  int rv = deserializeDelta(payload, delta, header);
   // A string to be filled by the delta application in case of failure.
   std::string failure_reason;
 
   if (rv != 0) {
     rsm_info(rsm_type_,
              "Could not deserialize delta record with lsn=%s ts=%s: %s",
-             lsn_to_string(record->attrs.lsn).c_str(),
-             format_time(record->attrs.timestamp).c_str(),
+             lsn_to_string(record.attrs.lsn).c_str(),
+             format_time(record.attrs.timestamp).c_str(),
              error_name(err));
     st = err;
   } else {
     ld_check(data_);
     rv = applyDelta(*delta,
                     *data_,
-                    record->attrs.lsn,
-                    record->attrs.timestamp,
+                    record.attrs.lsn,
+                    record.attrs.timestamp,
                     failure_reason);
     if (rv != 0) {
       rsm_info(rsm_type_,
                "Could not apply delta record with lsn=%s ts=%s on base with "
                "version %s: %s, %s",
-               lsn_to_string(record->attrs.lsn).c_str(),
-               format_time(record->attrs.timestamp).c_str(),
+               lsn_to_string(record.attrs.lsn).c_str(),
+               format_time(record.attrs.timestamp).c_str(),
                lsn_to_string(version_).c_str(),
                error_name(err),
                failure_reason.c_str());
@@ -837,61 +897,45 @@ bool ReplicatedStateMachine<T, D>::onDeltaRecord(
     } else {
       rsm_info(rsm_type_,
                "Applied delta record with lsn=%s ts=%s",
-               lsn_to_string(record->attrs.lsn).c_str(),
-               format_time(record->attrs.timestamp).c_str());
+               lsn_to_string(record.attrs.lsn).c_str(),
+               format_time(record.attrs.timestamp).c_str());
 
       // Only update the version if the delta was successfully applied.
       // This ensures that the replicated state machine version is the version
       // of the last delta (or snapshot) seen by subscribers. Indeed, if a
       // delta cannot be applied, it won't be passed to subscribers.
       // See T21314227.
-      version_ = record->attrs.lsn;
+      version_ = record.attrs.lsn;
     }
   }
 
-  delta_log_byte_offset_ += record->payload.size();
-  ++delta_log_offset_;
-
   if (!header.uuid.is_nil()) {
     auto it = pending_confirmation_by_uuid_.find(header.uuid);
     if (it != pending_confirmation_by_uuid_.end()) {
       // Either the append was not confirmed yet (lsn == LSN_INVALID) or the
       // lsns match.
       ld_check(it->second->lsn == LSN_INVALID ||
-               it->second->lsn == record->attrs.lsn);
+               it->second->lsn == record.attrs.lsn);
       if (state_delivery_blocked_) {
         rsm_info(rsm_type_,
                  "RSM just got unblocked from executing a callback on a delta "
                  "because the EXPERIMENTATION setting (block-%s-rsm = true) "
                  "the delta LSN is %s.",
                  toString(rsm_type_).c_str(),
-                 lsn_to_string(record->attrs.lsn).c_str());
+                 lsn_to_string(record.attrs.lsn).c_str());
       } else {
-        it->second->cb(st, record->attrs.lsn, failure_reason);
+        it->second->cb(st, record.attrs.lsn, failure_reason);
         pending_confirmation_.erase(it->second);
         pending_confirmation_by_uuid_.erase(it);
       }
     }
   }
 
-  // This call catches the case where we could not parse the deltas's header and
-  // thus its uuid.
-  discardSkippedPendingDeltas();
-
-  if (st == E::OK &&
-      (sync_state_ == SyncState::TAILING || deliver_while_replaying_)) {
-    ld_check(delta);
-    notifySubscribers(delta.get());
-  }
-
-  if (sync_state_ == SyncState::SYNC_DELTAS &&
-      record->attrs.lsn >= delta_sync_) {
-    // We finished reading the backlog and reached the tail. This function will
-    // inform all subscribers of the initial state.
-    onReachedDeltaLogTailLSN();
+  if (st != E::OK) {
+    return nullptr;
   }
-
-  return true;
+  ld_check(delta);
+  return delta;
 }
 
 template <typename T, typename D>
@@ -931,12 +975,12 @@ bool ReplicatedStateMachine<T, D>::deserializeDeltaHeader(
 }
 
 template <typename T, typename D>
-int ReplicatedStateMachine<T, D>::deserializeDelta(const DataRecord& record,
+int ReplicatedStateMachine<T, D>::deserializeDelta(const Payload& payload,
                                                    std::unique_ptr<D>& out,
                                                    DeltaHeader& header) {
-  bool use_header = deserializeDeltaHeader(record.payload, header);
-  size_t payload_sz = record.payload.size();
-  const uint8_t* ptr = reinterpret_cast<const uint8_t*>(record.payload.data());
+  bool use_header = deserializeDeltaHeader(payload, header);
+  size_t payload_sz = payload.size();
+  const uint8_t* ptr = reinterpret_cast<const uint8_t*>(payload.data());
 
   if (use_header) {
     payload_sz -= header.header_sz;
@@ -1090,6 +1134,56 @@ ReplicatedStateMachine<T, D>::createDeltaPayload(std::string user_payload,
   return buf;
 }
 
+template <typename T, typename D>
+std::string ReplicatedStateMachine<T, D>::createDeltaBatchPayload(
+    const std::vector<std::string>& deltas) {
+  ld_check(write_delta_header_);
+  size_t size = 0;
+  for (const auto& delta : deltas) {
+    size += sizeof(uint32_t) + delta.size();
+  }
+
+  std::string buf;
+  buf.reserve(size);
+  for (const auto& delta : deltas) {
+    const uint32_t len = delta.size();
+    buf.append(reinterpret_cast<const char*>(&len), sizeof(len));
+    buf.append(delta);
+  }
+
+  DeltaHeader header{};
+  header.flags = DeltaHeader::BATCH;
+  return createDeltaPayload(std::move(buf), header);
+}
+
+template <typename T, typename D>
+int ReplicatedStateMachine<T, D>::splitDeltaBatch(const Payload& payload,
+                                                  const DeltaHeader& header,
+                                                  std::vector<Payload>& out) {
+  ld_check(header.flags & DeltaHeader::BATCH);
+  ld_check(header.header_sz <= payload.size());
+  const uint8_t* ptr =
+      reinterpret_cast<const uint8_t*>(payload.data()) + header.header_sz;
+  const uint8_t* end =
+      reinterpret_cast<const uint8_t*>(payload.data()) + payload.size();
+
+  out.clear();
+  while (ptr < end) {
+    uint32_t len;
+    if (static_cast<size_t>(end - ptr) < sizeof(len)) {
+      return -1;
+    }
+    memcpy(&len, ptr, sizeof(len));
+    ptr += sizeof(len);
+    if (static_cast<size_t>(end - ptr) < len) {
+      return -1;
+    }
+    out.emplace_back(ptr, len);
+    ptr += len;
+  }
+  return 0;
+}
+
 template <typename T, typename D>
 void ReplicatedStateMachine<T, D>::writeDelta(
     std::string payload,
@@ -1167,46 +1261,120 @@ void ReplicatedStateMachine<T, D>::writeDelta(
     pending_confirmation_by_uuid_[header.uuid] = it;
   }
 
-  auto append_cb = [=](Status st, lsn_t lsn) {
+  PendingDeltaAppend delta{std::move(buf),
+                           header.uuid,
+                           mode,
+                           std::move(cb),
+                           timeout.value_or(delta_append_timeout_)};
+
+  if (max_deltas_per_record_ > 1 && write_delta_header_ &&
+      delta_appends_in_flight_ > 0) {
+    // An append is in flight. Queue this delta, it will be appended along
+    // with the others written until that append completes.
+    if (delta_batch_bytes_ + delta.payload.size() > MAX_PAYLOAD_SIZE_PUBLIC) {
+      flushDeltaBatch();
+    }
+    delta_batch_bytes_ += delta.payload.size();
+    delta_batch_.push_back(std::move(delta));
+    if (delta_batch_.size() >= max_deltas_per_record_) {
+      flushDeltaBatch();
+    }
+    return;
+  }
+
+  std::vector<PendingDeltaAppend> deltas;
+  deltas.push_back(std::move(delta));
+  appendDeltas(std::move(deltas));
+}
+
+template <typename T, typename D>
+void ReplicatedStateMachine<T, D>::flushDeltaBatch() {
+  if (delta_batch_.empty()) {
+    return;
+  }
+  std::vector<PendingDeltaAppend> deltas;
+  deltas.swap(delta_batch_);
+  delta_batch_bytes_ = 0;
+  appendDeltas(std::move(deltas));
+}
+
+template <typename T, typename D>
+void ReplicatedStateMachine<T, D>::appendDeltas(
+    std::vector<PendingDeltaAppend> deltas) {
+  ld_check(!deltas.empty());
+
+  std::string buf;
+  std::chrono::milliseconds timeout{0};
+  if (deltas.size() == 1) {
+    buf = std::move(deltas[0].payload);
+    timeout = deltas[0].timeout;
+  } else {
+    std::vector<std::string> payloads;
+    payloads.reserve(deltas.size());
+    for (auto& delta : deltas) {
+      payloads.push_back(std::move(delta.payload));
+      timeout = std::max(timeout, delta.timeout);
+    }
+    buf = createDeltaBatchPayload(payloads);
+    rsm_debug(rsm_type_,
+              "Appending %zu deltas in a single record",
+              deltas.size());
+  }
+
+  auto append_cb = [this, deltas = std::move(deltas)](Status st, lsn_t lsn) {
     ld_check(delta_appends_in_flight_ > 0);
     --delta_appends_in_flight_;
 
     if (st != E::OK) {
-      rsm_error(rsm_type_, "Could not write delta: %s.", error_description(st));
+      rsm_error(rsm_type_,
+                "Could not write %zu delta(s): %s.",
+                deltas.size(),
+                error_description(st));
     } else {
       rsm_info(rsm_type_,
-               "Successfully wrote delta with lsn %s",
+               "Successfully wrote %zu delta(s) with lsn %s",
+               deltas.size(),
                lsn_to_string(lsn).c_str());
     }
-    if (mode == WriteMode::CONFIRM_APPLIED) {
-      auto it = pending_confirmation_by_uuid_.find(header.uuid);
-      if (it != pending_confirmation_by_uuid_.end()) {
-        if (st == E::OK) {
-          it->second->lsn = lsn;
-          activateConfirmTimer(header.uuid);
-          // may be we fast forwarded with a snapshot past that lsn.
-          discardSkippedPendingDeltas();
-        } else {
-          it->second->cb(
-              st,
-              LSN_INVALID,
-              "Cannot perform operation: cannot enqueue the message!");
-          pending_confirmation_.erase(it->second);
-          pending_confirmation_by_uuid_.erase(it);
-        }
-      }
-    } else {
-      // We don't pass the failure reason in the case of
-      // WriteMode::CONFIRM_APPEND_ONLY because we don't have any!
-      cb(st, st == E::OK ? lsn : LSN_INVALID, "");
+    for (const auto& delta : deltas) {
+      onDeltaAppended(delta, st, lsn);
+    }
+    if (!stopped_) {
+      // Append the deltas written while this append was in flight.
+      flushDeltaBatch();
     }
   };
 
   ++delta_appends_in_flight_;
-  postAppendRequest(delta_log_id_,
-                    std::move(buf),
-                    timeout.value_or(delta_append_timeout_),
-                    append_cb);
+  postAppendRequest(delta_log_id_, std::move(buf), timeout, append_cb);
+}
+
+template <typename T, typename D>
+void ReplicatedStateMachine<T, D>::onDeltaAppended(
+    const PendingDeltaAppend& delta,
+    Status st,
+    lsn_t lsn) {
+  if (delta.mode == WriteMode::CONFIRM_APPLIED) {
+    auto it = pending_confirmation_by_uuid_.find(delta.uuid);
+    if (it != pending_confirmation_by_uuid_.end()) {
+      if (st == E::OK) {
+        it->second->lsn = lsn;
+        activateConfirmTimer(delta.uuid);
+        // may be we fast forwarded with a snapshot past that lsn.
+        discardSkippedPendingDeltas();
+      } else {
+        it->second->cb(st,
+                       LSN_INVALID,
+                       "Cannot perform operation: cannot enqueue the message!");
+        pending_confirmation_.erase(it->second);
+        pending_confirmation_by_uuid_.erase(it);
+      }
+    }
+  } else {
+    // We don't pass the failure reason in the case of
+    // WriteMode::CONFIRM_APPEND_ONLY because we don't have any!
+    delta.cb(st, st == E::OK ? lsn : LSN_INVALID, "");
+  }
 }
 
 template <typename T, typename D>
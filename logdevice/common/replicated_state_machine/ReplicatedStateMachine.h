@@ -6,9 +6,11 @@
  * LICENSE file in the root directory of this source tree.
  */
 #pragma once
+#include <algorithm>
 #include <chrono>
 #include <list>
 #include <memory>
+#include <vector>
 #include <zstd.h>
 
 #include <boost/functional/hash.hpp>
@@ -209,6 +211,23 @@ class ReplicatedStateMachine {
     max_pending_confirmation_ = max;
   }
 
+  /**
+   * Allow writeDelta() to group up to `max` deltas in a single record of the
+   * delta log. Deltas written while an append is already in flight are queued
+   * and appended together once it completes, so a writer issuing many deltas
+   * pays one append round trip per batch instead of one per delta. The deltas
+   * of a batch are applied in order at the LSN of the record, so readers and
+   * snapshots see either all or none of them, and each writer's callback is
+   * called individually. 1 (default) disables batching.
+   *
+   * Readers that do not understand batched records skip them, so this should
+   * only be used once all binaries reading the state machine do. This has no
+   * effect if doNotWriteDeltaHeader() was called.
+   */
+  void setMaxDeltasPerRecord(size_t max) {
+    max_deltas_per_record_ = std::max<size_t>(max, 1);
+  }
+
   /*
    * @param Timeout to use for AppendRequest on the delta log.
    */
@@ -472,9 +491,12 @@ class ReplicatedStateMachine {
     uint32_t checksum{0};
     uint32_t header_sz{0};
     uint32_t format_version{0}; // unused, might be handy in the future.
-    uint32_t flags{0};          // unused, might be handy in the future.
+    uint32_t flags{0};
 
     boost::uuids::uuid uuid = boost::uuids::nil_generator()();
+
+    // The record contains several deltas, @see createDeltaBatchPayload().
+    static constexpr uint32_t BATCH = 1u << 0;
   };
   // Prefer a static assert rather than using __attribute__((__packed__)) to
   // prevent inadvertent creation of unaligned fields that trigger undefined
@@ -489,6 +511,18 @@ class ReplicatedStateMachine {
   static bool deserializeDeltaHeader(const Payload& payload,
                                      DeltaHeader& header);
 
+  // Create the payload of a record containing several deltas, each created
+  // with createDeltaPayload(). The payload is a header with the BATCH flag
+  // and a nil uuid, followed by each delta prefixed with its 32-bit length.
+  std::string createDeltaBatchPayload(const std::vector<std::string>& deltas);
+
+  // Split the payload of a record whose header has the BATCH flag into the
+  // payloads of its deltas. The returned payloads point into `payload`.
+  // @return 0 on success, -1 if the payload is malformed.
+  static int splitDeltaBatch(const Payload& payload,
+                             const DeltaHeader& header,
+                             std::vector<Payload>& out);
+
   // Returns the current state object
   const T& getState() const {
     return *data_;
@@ -729,11 +763,18 @@ class ReplicatedStateMachine {
   // after creating a new snapshot.
   bool canFastForward(lsn_t lsn);
 
-  // Called when we receive a delta record. Deserialize its header and payload.
-  int deserializeDelta(const DataRecord& record,
+  // Called for each delta of a record read from the delta log. Deserialize
+  // its header and payload.
+  int deserializeDelta(const Payload& payload,
                        std::unique_ptr<D>& out,
                        DeltaHeader& header);
 
+  // Deserialize and apply one delta of `record` and call the callback of its
+  // writer if it was written with CONFIRM_APPLIED.
+  // @return the delta if it was applied, nullptr otherwise.
+  std::unique_ptr<D> processDelta(const DataRecord& record,
+                                  const Payload& payload);
+
   // Called by `onDeltaRecord()` or `onDeltaGap()` once we have reached the tail
   // lsn `delta_sync_` of the record log. When this function is
   // called, we consider that we have finished reading the backlog of deltas and
@@ -854,6 +895,33 @@ class ReplicatedStateMachine {
 
   size_t delta_appends_in_flight_{0};
 
+  // A delta waiting to be appended, or whose append is in flight.
+  struct PendingDeltaAppend {
+    // Payload created by createDeltaPayload(), moved out once appended.
+    std::string payload;
+    boost::uuids::uuid uuid;
+    WriteMode mode;
+    std::function<void(Status, lsn_t, const std::string&)> cb;
+    std::chrono::milliseconds timeout;
+  };
+
+  // Append `deltas` as a single record of the delta log.
+  void appendDeltas(std::vector<PendingDeltaAppend> deltas);
+
+  // Called when the append of `delta` completes.
+  void onDeltaAppended(const PendingDeltaAppend& delta, Status st, lsn_t lsn);
+
+  // Append the deltas queued in delta_batch_, if any.
+  void flushDeltaBatch();
+
+  // @see setMaxDeltasPerRecord().
+  size_t max_deltas_per_record_{1};
+
+  // Deltas written while an append was in flight, waiting to be appended in
+  // a single record, and the size of their payloads.
+  std::vector<PendingDeltaAppend> delta_batch_;
+  size_t delta_batch_bytes_{0};
+
   // List of callbacks to call when the local state gets updated.
   std::list<update_cb_t> subscribers_;
 
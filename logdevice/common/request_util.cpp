@@ -8,6 +8,7 @@
 #include "logdevice/common/request_util.h"
 
 #include "logdevice/common/Worker.h"
+#include "logdevice/common/stats/Stats.h"
 
 namespace facebook { namespace logdevice {
 
@@ -26,6 +27,80 @@ FuncRequest::Execution FuncRequest::execute() {
 
 FuncRequest::~FuncRequest() {}
 
+namespace {
+
+// Runs the continuation of a run_in_background() call on the worker that
+// started it.
+class BackgroundContinuationRequest : public Request {
+ public:
+  BackgroundContinuationRequest(worker_id_t worker,
+                                WorkerType worker_type,
+                                RequestType type,
+                                folly::Function<void()> func)
+      : Request(type),
+        worker_(worker),
+        worker_type_(worker_type),
+        func_(std::move(func)) {}
+
+  int getThreadAffinity(int /*nthreads*/) override {
+    return worker_.val_;
+  }
+
+  WorkerType getWorkerTypeAffinity() override {
+    return worker_type_;
+  }
+
+  Execution execute() override {
+    func_();
+    return Execution::COMPLETE;
+  }
+
+ private:
+  worker_id_t worker_;
+  WorkerType worker_type_;
+  folly::Function<void()> func_;
+};
+
+} // namespace
+
+namespace detail {
+
+void run_in_background_impl(
+    Processor* processor,
+    RequestType type,
+    folly::Function<folly::Function<void()>()> work) {
+  Worker* w = Worker::onThisThread();
+  ld_check(w);
+  const worker_id_t worker = w->idx_;
+  const WorkerType worker_type = w->worker_type_;
+
+  // enqueueToBackground() destroys the task if the queue is full, keep it
+  // around so that it can run inline in that case.
+  auto task = std::make_shared<folly::Function<folly::Function<void()>()>>(
+      std::move(work));
+  bool enqueued = processor->enqueueToBackground(
+      [processor, type, worker, worker_type, task] {
+        std::unique_ptr<Request> rq =
+            std::make_unique<BackgroundContinuationRequest>(
+                worker, worker_type, type, (*task)());
+        if (processor->postImportant(rq) != 0) {
+          RATELIMIT_WARNING(std::chrono::seconds(10),
+                            2,
+                            "Failed to post the continuation of a background "
+                            "task of type %s back to %s: %s",
+                            requestTypeNames[type].c_str(),
+                            Worker::getName(worker_type, worker).c_str(),
+                            error_name(err));
+        }
+      });
+  if (!enqueued) {
+    STAT_INCR(processor->stats_, background_queue_full_inline);
+    (*task)()();
+  }
+}
+
+} // namespace detail
+
 bool run_on_worker_nonblocking(Processor* processor,
                                worker_id_t worker_id,
                                WorkerType worker_type,
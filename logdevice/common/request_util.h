@@ -10,6 +10,7 @@
 #include <numeric>
 
 #include <folly/Format.h>
+#include <folly/Function.h>
 #include <folly/Memory.h>
 #include <folly/Optional.h>
 #include <folly/Random.h>
@@ -123,6 +124,42 @@ bool run_on_worker_nonblocking(Processor* processor,
                                std::function<void()>&& func,
                                bool with_retrying = false);
 
+namespace detail {
+void run_in_background_impl(
+    Processor* processor,
+    RequestType type,
+    folly::Function<folly::Function<void()>()> work);
+} // namespace detail
+
+/**
+ * Runs work() on whichever of the Processor's background threads gets to it
+ * first, then continuation(result) on the worker this is called from. Meant
+ * for CPU-heavy steps of a request (decoding, checksumming, parsing) that
+ * don't touch worker state, so that they don't stall the event loop of the
+ * worker the request landed on.
+ *
+ * Must be called on a worker thread. If the background queue is full, both
+ * run inline. The continuation is dropped if it can't be posted back because
+ * the Processor is shutting down.
+ */
+template <typename Work, typename Continuation>
+void run_in_background(Processor* processor,
+                       RequestType type,
+                       Work work,
+                       Continuation continuation) {
+  detail::run_in_background_impl(
+      processor,
+      type,
+      [work = std::move(work),
+       continuation =
+           std::move(continuation)]() mutable -> folly::Function<void()> {
+        return [result = work(),
+                continuation = std::move(continuation)]() mutable {
+          continuation(std::move(result));
+        };
+      });
+}
+
 /**
  * A utility function for running a function on some worker threads and
  * retrieving the return value of all calls.
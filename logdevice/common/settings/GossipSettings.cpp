@@ -169,6 +169,17 @@ void GossipSettings::defineSettings(SettingEasyInit& init) {
        "1/10th of the GOSSIP_Messages.",
        SERVER,
        SettingsCategory::FailureDetector);
+  init("gossip-full-sync-frequency",
+       &gossip_full_sync_frequency,
+       "1",
+       parse_positive<int32_t>(),
+       "How frequently to send a GOSSIP_Message with the full state of all "
+       "nodes. If the value is 10, one in 10 messages is full, and the others "
+       "only carry the entries that changed in the last 10 gossip rounds, plus "
+       "heartbeat counters of the other nodes in compact form. Messages "
+       "carrying RSM versions are always full. 1 sends full messages only.",
+       SERVER,
+       SettingsCategory::FailureDetector);
 };
 
 }} // namespace facebook::logdevice
@@ -49,6 +49,7 @@ struct GossipSettings : public SettingsBundle {
 
   // See .cpp for documentation
   int32_t gossip_include_rsm_versions_frequency;
+  int32_t gossip_full_sync_frequency;
 
   const char* getName() const override {
     return "GossipSettings";
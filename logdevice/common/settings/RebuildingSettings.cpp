@@ -152,6 +152,98 @@ void RebuildingSettings::defineSettings(SettingEasyInit& init) {
       "node can have in flight at the same time, per shard.",
       SERVER,
       SettingsCategory::Rebuilding);
+  init("rebuilding-store-batch-max-bytes",
+       &store_batch_max_bytes,
+       "0",
+       parse_nonnegative<size_t>(),
+       "If nonzero, a rebuilding donor sends the STOREs and amends of records "
+       "of the same chunk that go to the same node in STORES_BATCH messages of "
+       "up to this size, and starts the amends of a chunk together once all of "
+       "its records are stored. Rebuilding many small records is otherwise "
+       "bound by message rate. STOREs at least this big are sent on their own. "
+       "Only used for recipients that support it. 0 disables batching.",
+       SERVER,
+       SettingsCategory::Rebuilding);
+  init("rebuilding-read-buffer-max-bytes",
+       &read_buffer_max_bytes,
+       "0",
+       parse_nonnegative<size_t>(),
+       "Memory budget, per shard, for records that a rebuilding donor has read "
+       "ahead but not yet handed to re-replication, including the read batch "
+       "in flight. Within it, the donor adapts how far it reads ahead: it "
+       "reads further when re-replication runs out of records to send, and "
+       "less when reading gets ahead of re-replication. 0 means a fixed read "
+       "ahead of 3 times --rebuilding-max-batch-bytes per read cursor (see "
+       "--rebuilding-read-cursors).",
+       SERVER,
+       SettingsCategory::Rebuilding);
+  init("rebuilding-read-cursors",
+       &read_cursors,
+       "1",
+       parse_positive<size_t>(),
+       "Number of concurrent read cursors a rebuilding donor uses per shard. "
+       "The shard's logs are split among the cursors, and each cursor has its "
+       "own iterator and storage task in flight. All cursors share the "
+       "--rebuilding-read-buffer-max-bytes budget and the "
+       "--rebuilding-rate-limit. Useful on fast devices that a single cursor "
+       "can't keep busy. Takes effect for shard rebuildings started after the "
+       "change.",
+       SERVER,
+       SettingsCategory::Rebuilding);
+  init("rebuilding-throttle-store-latency-p99",
+       &throttle_store_latency_p99,
+       "0ms",
+       [](std::chrono::milliseconds val) {
+         if (val.count() < 0) {
+           throw boost::program_options::error(
+               "rebuilding-throttle-store-latency-p99 must be nonnegative");
+         }
+       },
+       "If nonzero, rebuilding on this node backs off whenever the p99 latency "
+       "of foreground (non-rebuilding) stores on this node over the last "
+       "--rebuilding-throttle-interval exceeds this value, and speeds back up "
+       "gradually while it doesn't. The static limits "
+       "--rebuilding-max-records-in-flight and "
+       "--rebuilding-max-record-bytes-in-flight are the ceiling. 0 disables.",
+       SERVER,
+       SettingsCategory::Rebuilding);
+  init("rebuilding-throttle-read-latency-p99",
+       &throttle_read_latency_p99,
+       "0ms",
+       [](std::chrono::milliseconds val) {
+         if (val.count() < 0) {
+           throw boost::program_options::error(
+               "rebuilding-throttle-read-latency-p99 must be nonnegative");
+         }
+       },
+       "Like --rebuilding-throttle-store-latency-p99 but for the p99 latency "
+       "of storage tasks reading records for foreground read streams. "
+       "0 disables.",
+       SERVER,
+       SettingsCategory::Rebuilding);
+  init("rebuilding-throttle-interval",
+       &throttle_interval,
+       "10s",
+       [](std::chrono::milliseconds val) {
+         if (val.count() <= 0) {
+           throw boost::program_options::error(
+               "rebuilding-throttle-interval must be positive");
+         }
+       },
+       "How often rebuilding re-evaluates foreground latencies and adjusts "
+       "its throughput. See --rebuilding-throttle-store-latency-p99.",
+       SERVER,
+       SettingsCategory::Rebuilding);
+  init("rebuilding-throttle-min-percent",
+       &throttle_min_percent,
+       "10",
+       parse_validate_range<size_t>(1, 100),
+       "Lowest percentage of --rebuilding-max-records-in-flight and "
+       "--rebuilding-max-record-bytes-in-flight that latency-based throttling "
+       "can bring rebuilding down to. Keeps rebuilding from starving "
+       "completely.",
+       SERVER,
+       SettingsCategory::Rebuilding);
   init(
       "rebuilding-max-get-seq-state-in-flight",
       &max_get_seq_state_in_flight,
@@ -169,6 +261,19 @@ void RebuildingSettings::defineSettings(SettingEasyInit& init) {
       "done in order to determine the LSN at which to stop rebuilding the log.",
       SERVER,
       SettingsCategory::Rebuilding);
+  init("rebuilding-max-get-seq-state-in-flight-per-sequencer",
+       &max_get_seq_state_in_flight_per_sequencer,
+       "0",
+       parse_nonnegative<size_t>(),
+       "If nonzero, lets a rebuilding donor have up to this many 'get sequencer "
+       "state' requests in flight per sequencer node in the cluster, if that's "
+       "more than --rebuilding-max-get-seq-state-in-flight. Requests for "
+       "different logs go to different sequencer nodes, so this keeps the load "
+       "on each sequencer bounded while making planning time scale with the "
+       "number of logs per sequencer node rather than the total number of "
+       "logs.",
+       SERVER,
+       SettingsCategory::Rebuilding);
   init("rebuilding-planner-sync-seq-retry-interval",
        &rebuilding_planner_sync_seq_retry_interval,
        "60s..5min",
@@ -44,9 +44,17 @@ struct RebuildingSettings : public SettingsBundle {
   std::chrono::milliseconds max_batch_time;
   size_t max_records_in_flight;
   size_t max_record_bytes_in_flight;
+  size_t store_batch_max_bytes;
+  size_t read_buffer_max_bytes;
+  size_t read_cursors;
+  std::chrono::milliseconds throttle_store_latency_p99;
+  std::chrono::milliseconds throttle_read_latency_p99;
+  std::chrono::milliseconds throttle_interval;
+  size_t throttle_min_percent;
   bool use_rocksdb_cache;
   RebuildingReadOnlyOption read_only;
   size_t max_get_seq_state_in_flight;
+  size_t max_get_seq_state_in_flight_per_sequencer;
   chrono_interval_t<std::chrono::milliseconds> retry_timeout;
   chrono_interval_t<std::chrono::milliseconds> store_timeout;
   chrono_interval_t<std::chrono::milliseconds>
@@ -108,6 +108,39 @@ parse_recipients_list(const std::string& value) {
   return recipients;
 }
 
+static std::unordered_map<node_index_t, Sockaddr>
+parse_local_data_unix_sockets(const std::string& value) {
+  std::unordered_map<node_index_t, Sockaddr> res;
+  std::vector<std::string> tokens;
+  folly::split(',', value, tokens, true);
+  for (const std::string& tok : tokens) {
+    // tok format: "N7:/path/to/socket" or "7:/path/to/socket"
+    size_t colon = tok.find(':');
+    folly::Optional<node_index_t> node;
+    if (colon != std::string::npos && colon + 1 < tok.size()) {
+      folly::StringPiece node_str(tok.data(), colon);
+      node_str.removePrefix("N");
+      auto parsed = folly::tryTo<node_index_t>(node_str);
+      if (parsed.hasValue()) {
+        node = parsed.value();
+      }
+    }
+    if (!node.hasValue()) {
+      throw boost::program_options::error(
+          "Invalid value for local-data-unix-sockets: \"" + tok +
+          "\". Expected format: \"N<node index>:<path>,...\"");
+    }
+    try {
+      res.emplace(node.value(), Sockaddr(tok.substr(colon + 1)));
+    } catch (const ConstructorFailed&) {
+      throw boost::program_options::error(
+          "Invalid unix socket path in local-data-unix-sockets: \"" + tok +
+          "\"");
+    }
+  }
+  return res;
+}
+
 static std::unordered_set<logid_t> parse_log_set(const std::string& value) {
   std::unordered_set<logid_t> res;
 
@@ -354,6 +387,16 @@ Compression parse_compression(const std::string& value) {
   return compression;
 }
 
+static Compression parse_message_compression(const std::string& value) {
+  Compression compression = parse_compression(value);
+  if (compression != Compression::NONE && compression != Compression::ZSTD) {
+    throw boost::program_options::error(
+        "Only 'none' and 'zstd' are supported for message compression, got " +
+        value);
+  }
+  return compression;
+}
+
 std::unordered_map<ShardID, AuthoritativeStatus>
 parse_authoritative_status_overrides(const std::string& value) {
   std::unordered_map<ShardID, AuthoritativeStatus> res;
@@ -493,6 +536,19 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "per CPU core",
        SERVER | CLIENT | REQUIRES_RESTART /* used in Processor ctor */,
        SettingsCategory::Execution);
+  init("client-append-workers",
+       &client_append_workers,
+       "0",
+       validate_nonnegative<ssize_t>(),
+       "If positive, appends are only executed on this many of the client's "
+       "workers, chosen by log id, instead of on all of them. Since every "
+       "worker has its own connection to each server it talks to, this caps "
+       "the number of connections a writer process opens to each sequencer "
+       "node, which matters to servers when there are very many clients. "
+       "Appends that ask for a specific worker, e.g. from BufferedWriter or "
+       "write streams, are not affected. 0 means all workers.",
+       CLIENT,
+       SettingsCategory::Execution);
   init("msg-error-injection-chance",
        &message_error_injection_chance_percent,
        "0",
@@ -520,6 +576,15 @@ void Settings::defineSettings(SettingEasyInit& init) {
        " otherwise FBTraceLogger is used",
        SERVER | CLIENT | REQUIRES_RESTART /* init'ed at startup */,
        SettingsCategory::Monitoring);
+  init("latency-trace-sample-rate",
+       &latency_trace_sample_rate,
+       "0.001",
+       validate_range<double>(0, 1.0),
+       "Fraction of appends and storage tasks for which the time spent in each "
+       "processing stage is recorded. Recent samples are shown by the "
+       "'info latency_traces' admin command. 0 disables sampling.",
+       SERVER,
+       SettingsCategory::Monitoring);
   init("outbytes-mb",
        &outbufs_mb_max_per_thread,
        "512",
@@ -601,6 +666,45 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "max-time-to-allow-socket-drain. Then the socket is closed.",
        SERVER | CLIENT,
        SettingsCategory::Network);
+  init("socket-read-pool-buffer-size",
+       &socket_read_pool_buffer_size,
+       "0",
+       nullptr, // no validation
+       "If positive, bodies of incoming messages up to a quarter of this size "
+       "are read back to back into shared buffers of this size, saving an "
+       "allocation per message. A buffer is freed once all messages read "
+       "into it are destroyed. 0 allocates a buffer for every message. "
+       "Applies to new connections.",
+       SERVER | CLIENT,
+       SettingsCategory::Network);
+  init("message-compression",
+       &message_compression,
+       "none",
+       parse_message_compression,
+       "Compression of large messages sent over the network: 'none' or "
+       "'zstd'. Messages of at least --message-compression-min-size bytes "
+       "sent to peers that support it are compressed as part of a ZSTD "
+       "stream per connection, so that they can refer to data of earlier "
+       "messages on the same connection. Worth it for links where bandwidth "
+       "is more expensive than CPU, e.g. between regions.",
+       SERVER | CLIENT,
+       SettingsCategory::Network);
+  init("message-compression-min-size",
+       &message_compression_min_size,
+       "4096",
+       parse_positive<ssize_t>(),
+       "Messages smaller than this many bytes are never compressed, see "
+       "--message-compression.",
+       SERVER | CLIENT,
+       SettingsCategory::Network);
+  init("message-compression-zstd-level",
+       &message_compression_zstd_level,
+       "1",
+       parse_validate_range<int>(1, ZSTD_maxCLevel()),
+       "Zstd compression level for --message-compression. A connection keeps "
+       "the level it compressed its first message with.",
+       SERVER | CLIENT,
+       SettingsCategory::Network);
   init("socket-idle-threshold",
        &socket_idle_threshold,
        "1000000",
@@ -670,6 +774,16 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "digesting",
        SERVER | REQUIRES_RESTART /* used in Worker ctor */,
        SettingsCategory::Recovery);
+  init("cached-digest-snapshot-reuse-ttl",
+       &cached_digest_snapshot_reuse_ttl,
+       "0ms",
+       validate_nonnegative<ssize_t>(),
+       "How long a storage node keeps the record cache snapshot taken for a "
+       "cached digest, so that a restarted or retried recovery of the same "
+       "epoch can be served from it as long as the cache hasn't changed. "
+       "0 disables reuse.",
+       SERVER | REQUIRES_RESTART /* used in Worker ctor */,
+       SettingsCategory::Recovery);
   init(
       "max-active-cached-digests",
       &max_active_cached_digests,
@@ -686,6 +800,41 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "amount of RECORD data to read from local log store at once",
        SERVER,
        SettingsCategory::ReadPath);
+  init("catchup-readahead-max",
+       &catchup_readahead_max_bytes,
+       "0",
+       parse_nonnegative<ssize_t>(),
+       "Maximum read-ahead for catch-up reads that go to disk. Such reads "
+       "are long forward scans through old data; reading ahead lets the "
+       "filesystem fetch the following blocks in large sequential requests "
+       "instead of one block per iterator step. The window is the amount of "
+       "record data the stream is allowed to deliver in one batch (see "
+       "--output-max-records-kb), capped by this value. 0 disables "
+       "read-ahead.",
+       SERVER,
+       SettingsCategory::ReadPath);
+  init("read-storage-task-zero-copy",
+       &read_storage_task_zero_copy,
+       "true",
+       nullptr,
+       "If true, payloads of records read by storage threads are handed to "
+       "RECORD messages without being copied again on the worker thread. The "
+       "record data is copied out of the local log store exactly once.",
+       SERVER,
+       SettingsCategory::ReadPath);
+  init("records-batch-max-payload",
+       &records_batch_max_payload,
+       "0",
+       nullptr,
+       "Records with payloads of at most this many bytes are delivered to "
+       "readers in RECORDS_BATCH messages: consecutive records of a read "
+       "stream shipped in one catch-up pass are packed into one message, "
+       "which is bounded by --output-max-records-kb. Saves the per-message "
+       "overhead for small records. Only applies to readers that support it "
+       "and don't request extra metadata or byte offsets. 0 disables "
+       "batching.",
+       SERVER,
+       SettingsCategory::ReadPath);
   init("max-record-read-execution-time",
        &max_record_read_execution_time,
        "1s",
@@ -720,6 +869,16 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "number of LO_PRI requests to process per worker event loop iteration",
        SERVER | CLIENT,
        SettingsCategory::Execution);
+  init("worker-task-aging-threshold",
+       &worker_task_aging_threshold,
+       "1s",
+       validate_nonnegative<ssize_t>(),
+       "If the oldest MID_PRI or LO_PRI request on a worker has waited for "
+       "longer than this, requests of that priority are processed first and "
+       "at the HI_PRI rate until the old ones are gone, so that they don't "
+       "starve during a burst of higher priority requests. 0 disables this.",
+       SERVER | CLIENT,
+       SettingsCategory::Execution);
   init("worker-request-pipe-capacity",
        &worker_request_pipe_capacity,
        "524288",
@@ -745,6 +904,16 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "logdevice. DEPRECATED as libevent2 is being removed from codebase",
        SERVER | CLIENT | REQUIRES_RESTART | DEPRECATED,
        SettingsCategory::Execution);
+  init("worker-io-uring-event-loop",
+       &worker_io_uring_event_loop,
+       "false",
+       nullptr,
+       "Run worker event loops on io_uring instead of libevent. Socket "
+       "readiness and timer expirations are then submitted to the kernel in "
+       "batches, taking about one system call per loop iteration. Ignored "
+       "with a warning if io_uring is not available on this host.",
+       SERVER | CLIENT | REQUIRES_RESTART | EXPERIMENTAL,
+       SettingsCategory::Execution);
   init("request-exec-threshold",
        &request_execution_delay_threshold,
        "10ms",
@@ -791,6 +960,30 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "maximum byte limit of unprocessed messages within the system.",
        SERVER | CLIENT | REQUIRES_RESTART,
        SettingsCategory::Network);
+  init("load-shedding-reject-appends-queue-delay",
+       &load_shedding_reject_appends_queue_delay,
+       "0ms",
+       validate_nonnegative<ssize_t>(),
+       "If positive, when work waits longer than this on average in the queues "
+       "of a worker, the worker rejects new APPENDs from clients with "
+       "E::OVERLOADED before doing anything else for them. Traffic between "
+       "nodes is not affected. Set it above the queueing delays seen under "
+       "normal load, e.g. around health-monitor-max-queue-stalls-avg. "
+       "0 disables.",
+       SERVER,
+       SettingsCategory::ResourceManagement);
+  init("load-shedding-pause-client-reads-queue-delay",
+       &load_shedding_pause_client_reads_queue_delay,
+       "0ms",
+       validate_nonnegative<ssize_t>(),
+       "If positive, when work waits longer than this on average in the queues "
+       "of a worker, the worker stops reading messages from client "
+       "connections until the delay goes down, which pushes back on clients "
+       "through TCP. Connections to other nodes, which carry e.g. STORED, "
+       "RELEASE and gossip messages, are still read. Should be higher than "
+       "load-shedding-reject-appends-queue-delay. 0 disables.",
+       SERVER,
+       SettingsCategory::ResourceManagement);
   init("max-inflight-storage-tasks",
        &max_inflight_storage_tasks,
        "4096",
@@ -839,6 +1032,50 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "size of the record cache.",
        SERVER,
        SettingsCategory::Recovery);
+  init("record-cache-compress-cold-epochs",
+       &record_cache_compress_cold_epochs,
+       "false",
+       nullptr, // no validation
+       "If true, when the record cache grows over --record-cache-max-size, "
+       "first compress the payloads of records cached for older unclean "
+       "epochs of each log with LZ4, and only evict whole logs if that "
+       "doesn't free enough memory. Records are decompressed when read for "
+       "log recovery.",
+       SERVER,
+       SettingsCategory::Recovery);
+  init("record-cache-eviction-policy",
+       &record_cache_eviction_policy,
+       "size",
+       [](const std::string& val) {
+         if (val == "size") {
+           return RecordCacheEvictionPolicy::SIZE;
+         } else if (val == "frequency") {
+           return RecordCacheEvictionPolicy::FREQUENCY;
+         } else {
+           throw boost::program_options::error(
+               "Invalid value for --record-cache-eviction-policy: " + val +
+               ". Must be one of \"size\", \"frequency\"");
+         }
+       },
+       "How to pick the logs to evict when the record cache grows over "
+       "--record-cache-max-size. 'size' evicts the logs with the most bytes "
+       "cached. 'frequency' evicts the logs whose record caches were looked "
+       "up the least, by readers checking the last known good ESN of an "
+       "unclean epoch and by log recovery. Lookup counts of all logs are "
+       "halved after each eviction, so that they reflect recent demand. This "
+       "keeps caching logs with tailing readers at the same memory cost.",
+       SERVER,
+       SettingsCategory::Recovery);
+  init("record-cache-repopulation-threads",
+       &record_cache_repopulation_threads,
+       "1",
+       parse_positive<ssize_t>(),
+       "Number of threads per shard that rebuild record caches from the "
+       "snapshots persisted at the last shutdown. With more than one, the "
+       "snapshot blobs of a shard are read first and then deserialized across "
+       "logs in parallel, which shortens startup when many logs are cached.",
+       SERVER | REQUIRES_RESTART,
+       SettingsCategory::Recovery);
 
   init("abort-on-failed-check",
        &abort_on_failed_check,
@@ -1071,6 +1308,24 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "through the cluster.",
        SERVER,
        SettingsCategory::Security);
+  init("gossip-dscp",
+       &gossip_dscp,
+       "-1",
+       parse_validate_range<int>(-1, 63),
+       "DSCP to set on gossip sockets, incoming and outgoing, so that the "
+       "network can prioritize failure detection traffic over data traffic. "
+       "-1 means use server-default-dscp.",
+       SERVER | REQUIRES_RESTART,
+       SettingsCategory::FailureDetector);
+  init("gossip-socket-priority",
+       &gossip_socket_priority,
+       "-1",
+       parse_validate_range<int>(-1, 6),
+       "SO_PRIORITY to set on gossip sockets, incoming and outgoing, so that "
+       "gossip packets go ahead of data packets in the host's queueing "
+       "disciplines. -1 means don't set it.",
+       SERVER | REQUIRES_RESTART,
+       SettingsCategory::FailureDetector);
   init("max-nodes",
        &max_nodes,
        "512",
@@ -1121,6 +1376,17 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "never send a wave of STORE messages through a chain",
        SERVER,
        SettingsCategory::WritePath);
+  init("store-chain-forward-early",
+       &store_chain_forward_early,
+       "false",
+       nullptr, // no validation
+       "When a storage node gets a STORE sent through a chain, forward it to "
+       "the next node in the chain as soon as the copyset is validated, "
+       "rather than after the seal of the log is known. Saves the next links "
+       "from waiting on seal recovery or a soft seal update on this node, "
+       "at the cost of a copy of the STORE header per hop.",
+       SERVER,
+       SettingsCategory::WritePath);
   init("sbr-low-watermark-check-interval",
        &sbr_low_watermark_check_interval,
        "60s",
@@ -1310,6 +1576,19 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "Throttle Disk I/O due to log read streams",
        SERVER,
        SettingsCategory::ReadPath);
+  init("read-throttling-share-by-principal",
+       &read_throttling_share_by_principal,
+       "false",
+       nullptr, // no validation
+       "With --enable-read-throttling, share read I/O bandwidth between "
+       "client principals. A principal's min_read_bytes_per_sec from the "
+       "principals config is always available to its clients (and still "
+       "counted against the budget). Read streams waiting for bandwidth are "
+       "woken in weighted fair order by the read_share of their principals "
+       "rather than first come first served. Clients whose principals are "
+       "not in the config share the \"default\" principal.",
+       SERVER,
+       SettingsCategory::ReadPath);
   init("enable-adaptive-store-timeout",
        &enable_adaptive_store_timeout,
        "false",
@@ -1317,6 +1596,42 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "decides whether to enable an adaptive store timeout",
        SERVER | EXPERIMENTAL,
        SettingsCategory::WritePath);
+  init("hedged-store-budget",
+       &hedged_store_budget,
+       "0",
+       validate_range<double>(0, 1.0),
+       "If positive, an Appender sends a new wave of STOREs as soon as a "
+       "recipient's reply is later than that node's recent p99 STORE latency "
+       "(as tracked with --enable-store-histogram-calculations), instead of "
+       "waiting for the store timeout. The slow node is graylisted, so the new "
+       "wave goes to a spare node, and the copies that were already stored "
+       "are only amended. The value caps the number of such hedged waves, as "
+       "a fraction of all waves sent by a worker. Hedging is skipped if no "
+       "recipient has replied yet, since then the slowness is likely not "
+       "specific to one node. 0 disables hedging.",
+       SERVER | EXPERIMENTAL,
+       SettingsCategory::WritePath);
+  init("sequencer-store-batching-window",
+       &sequencer_store_batching_window,
+       "0us",
+       validate_nonnegative<ssize_t>(),
+       "If positive, STOREs that a sequencer worker sends to the same storage "
+       "node within this window are sent together in one message, even if "
+       "they are for different logs. This keeps the message rate of "
+       "sequencers running many low-rate logs in check, at the cost of "
+       "adding up to this much latency to appends. Only used with storage "
+       "nodes that support it. 0 disables batching.",
+       SERVER,
+       SettingsCategory::WritePath);
+  init("sequencer-store-batching-max-bytes",
+       &sequencer_store_batching_max_bytes,
+       "65536",
+       parse_positive<ssize_t>(),
+       "STOREs batched because of --sequencer-store-batching-window are sent "
+       "as soon as the ones queued for a node add up to this many bytes. "
+       "Larger STOREs are never batched.",
+       SERVER,
+       SettingsCategory::WritePath);
   init("write-batch-size",
        &write_batch_size,
        "1024",
@@ -1347,6 +1662,26 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "Use something like 1MB for byte based scheduling.",
        SERVER,
        SettingsCategory::Storage);
+  init("storage-threads-steal-tasks",
+       &storage_threads_steal_tasks,
+       "false",
+       nullptr,
+       "If true, a storage thread that has had nothing to do for "
+       "--storage-threads-steal-idle-interval executes queued tasks of the "
+       "same thread type from other shards, taking them from the shard with "
+       "the longest queue. Task priorities and DRR scheduling are respected "
+       "within each shard's queue. Lets idle shards help out a hot one.",
+       SERVER | REQUIRES_RESTART,
+       SettingsCategory::Storage);
+  init("storage-threads-steal-idle-interval",
+       &storage_threads_steal_idle_interval,
+       "10ms",
+       validate_positive<ssize_t>(),
+       "How long a storage thread waits for tasks in its own shard before "
+       "looking for tasks in other shards. Only used if "
+       "--storage-threads-steal-tasks is true.",
+       SERVER,
+       SettingsCategory::Storage);
 
 #define STORAGE_TASK_PRINCIPAL(name, key, shareVal)                      \
   init("storage-task-" #key "-share",                                    \
@@ -1447,6 +1782,61 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "window update messages (less means more often)",
        CLIENT | SERVER /* for event log reads */,
        SettingsCategory::ReadPath);
+  init("client-read-buffer-max-size",
+       &client_read_buffer_max_size,
+       "0",
+       parse_nonnegative<ssize_t>(),
+       "If larger than --client-read-buffer-size, AsyncReader read streams "
+       "auto-tune their window between --client-read-buffer-size and this "
+       "many records, so that it covers the records delivered during a round "
+       "trip to the storage nodes. This lets high-latency readers reach full "
+       "throughput without a large fixed buffer. If this setting is changed "
+       "on-the-fly, the change will only apply to new read streams",
+       CLIENT,
+       SettingsCategory::ReadPath);
+  init("client-read-window-memory-budget",
+       &client_read_window_memory_budget,
+       "268435456", // 256MB
+       parse_nonnegative<ssize_t>(),
+       "maximum number of bytes of records that all read streams of a client "
+       "together may buffer in addition to --client-read-buffer-size when "
+       "their window grows because of --client-read-buffer-max-size. "
+       "Estimated from the average record size of each stream. 0 means no "
+       "limit.",
+       CLIENT,
+       SettingsCategory::ReadPath);
+  init("client-read-stream-rebalance-interval",
+       &client_read_stream_rebalance_interval,
+       "0s",
+       validate_nonnegative<ssize_t>(),
+       "how often an AsyncReader measures the bytes its read streams delivered "
+       "on each worker. If the busiest worker delivered more than twice as "
+       "much as the least busy one, one read stream is moved between them: "
+       "it is stopped right after a delivered record and a new stream resumes "
+       "from the next LSN on the other worker. Records the old stream had "
+       "buffered are read again. 0 disables rebalancing.",
+       CLIENT,
+       SettingsCategory::ReadPath);
+  init("client-read-stage-timing",
+       &client_read_stage_timing,
+       "false",
+       nullptr, // no validation
+       "measure the time read streams spend buffering records and handling "
+       "gaps in ClientReadStream, decoding buffered writes and running "
+       "application callbacks, and report it in the client_read_*_usec "
+       "stats. Costs a few clock reads per delivered record.",
+       CLIENT,
+       SettingsCategory::ReadPath);
+  init("client-read-coalesce-gaps",
+       &client_read_coalesce_gaps,
+       "false",
+       nullptr, // no validation
+       "when a read stream finds several adjacent BRIDGE, HOLE or "
+       "FILTERED_OUT gaps of the same type at once, e.g. when crossing many "
+       "empty epochs, deliver them to the application as a single gap "
+       "covering the whole range instead of one gap each.",
+       CLIENT,
+       SettingsCategory::ReadPath);
   init("client-epoch-metadata-cache-size",
        &client_epoch_metadata_cache_size,
        "50000",
@@ -1455,6 +1845,40 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "Set it to 0 to disable the epoch metadata cache.",
        CLIENT | REQUIRES_RESTART,
        SettingsCategory::ReadPath);
+  init("client-epoch-metadata-cache-shards",
+       &client_epoch_metadata_cache_shards,
+       "16",
+       parse_positive<ssize_t>(),
+       "number of independently locked LRU shards the client-side epoch "
+       "metadata cache is split into, by log id. The capacity set by "
+       "--client-epoch-metadata-cache-size is divided evenly among them.",
+       CLIENT | REQUIRES_RESTART,
+       SettingsCategory::ReadPath);
+  init("client-epoch-metadata-cache-shared",
+       &client_epoch_metadata_cache_shared,
+       "false",
+       nullptr,
+       "If true, all clients of the same cluster (by cluster name) in the "
+       "process share a single epoch metadata cache, so that readers created "
+       "through different clients don't each read the metadata log for the "
+       "same logs. The size and number of shards of the shared cache are "
+       "those of the client that created it.",
+       CLIENT | REQUIRES_RESTART,
+       SettingsCategory::ReadPath);
+  init("client-read-stream-metadata-prefetch-epochs",
+       &client_read_stream_metadata_prefetch_epochs,
+       "0",
+       nullptr,
+       "If positive, a read stream that gets within this many epochs of the "
+       "end of the epoch metadata it knows, while later epochs are already "
+       "released, fetches the metadata for the next epochs into the client "
+       "epoch metadata cache in the background. This hides metadata fetch "
+       "latency at epoch boundaries, e.g. when reading through many short "
+       "epochs after sequencer failovers, at the cost of extra metadata "
+       "reads. Has no effect if the epoch metadata cache is disabled (see "
+       "--client-epoch-metadata-cache-size).",
+       CLIENT,
+       SettingsCategory::ReadPath);
   init("client-readers-flow-tracer-period",
        &client_readers_flow_tracer_period,
        "0s",
@@ -1598,6 +2022,17 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "epoch recovery timeout. Millisecond granularity.",
        SERVER,
        SettingsCategory::Recovery);
+  init("recovery-max-concurrent-epochs",
+       &recovery_max_concurrent_epochs,
+       "1",
+       parse_positive<size_t>(),
+       "Maximum number of unclean epochs of a log whose recovery digests are "
+       "built concurrently. Epochs after the oldest one seal and digest "
+       "ahead, but start mutations only once all preceding epochs have been "
+       "recovered, since they need the tail record of the previous epoch. "
+       "1 recovers epochs strictly one at a time.",
+       SERVER,
+       SettingsCategory::Recovery);
   init("gap-grace-period",
        &gap_grace_period,
        "100ms",
@@ -1685,6 +2120,33 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "smaller of this value and half the value of --seq-state-reply-timeout.",
        SERVER,
        SettingsCategory::Sequencer);
+  init("check-seal-cache-ttl",
+       &check_seal_cache_ttl,
+       "0ms",
+       validate_nonnegative<ssize_t>(),
+       "If positive, after a 'check seal' request found that the sequencer of "
+       "a log was not preempted, 'get sequencer state' requests for that log "
+       "received by the same worker during this time reply without sending "
+       "'check seal' requests again, as long as the sequencer's epoch did not "
+       "change. This lets a sequencer answer a burst of such requests, e.g. "
+       "from many readers after a failover, at the cost of noticing that it "
+       "was preempted up to this much later. Requests received while a "
+       "'check seal' request for the log is running always wait for its "
+       "result instead of sending their own.",
+       SERVER,
+       SettingsCategory::Sequencer);
+  init("sequencer-tail-buffer-size",
+       &sequencer_tail_buffer_size,
+       "0",
+       parse_nonnegative<ssize_t>(),
+       "Number of the most recently released records of each tail optimized "
+       "log that the sequencer keeps in memory, with their payloads. Readers "
+       "that are caught up can get these records from the sequencer with a "
+       "'get sequencer state' request instead of waiting for storage nodes to "
+       "process the release. A reader that is further behind gets a miss and "
+       "reads from storage nodes. 0 disables the buffer.",
+       SERVER | EXPERIMENTAL,
+       SettingsCategory::Sequencer);
   init("update-metadata-map-interval",
        &update_metadata_map_interval,
        "1h",
@@ -1802,6 +2264,17 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "expiration time of idle RocksDB iterators in the iterator cache.",
        SERVER,
        SettingsCategory::RocksDB);
+  init("iterator-cache-max-streams",
+       &iterator_cache_max_streams,
+       "0",
+       parse_nonnegative<size_t>(),
+       "If positive, at most this many read streams per worker keep cached "
+       "RocksDB iterators. When more streams cache iterators, the least "
+       "recently used ones release theirs and create new ones on their next "
+       "read. Bounds memory pinned by iterators of many mostly idle readers. "
+       "0 means no limit other than --iterator-cache-ttl.",
+       SERVER,
+       SettingsCategory::RocksDB);
   init("max-protocol",
        &max_protocol,
        std::to_string(Compatibility::MAX_PROTOCOL_SUPPORTED).c_str(),
@@ -1829,6 +2302,26 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "we start rejecting new appends.",
        SERVER,
        SettingsCategory::ResourceManagement);
+  init("append-probe-credit",
+       &append_probe_credit,
+       "0",
+       nullptr,
+       "When a client whose appends recently failed probes this sequencer "
+       "node and the probe succeeds, grant the client credit for up to this "
+       "many bytes of appends to the same log within the next second, sent "
+       "without further probes. Credit is capped by the room left below "
+       "--max-total-appenders-size-soft on the worker. 0 disables credit.",
+       SERVER,
+       SettingsCategory::ResourceManagement);
+  init("appender-pool-size",
+       &appender_pool_size,
+       "1024",
+       nullptr,
+       "Maximum number of freed Appender objects each worker keeps for "
+       "reuse by new appends, saving an allocation per append. 0 disables "
+       "pooling.",
+       SERVER,
+       SettingsCategory::ResourceManagement);
   init("max-total-buffered-append-size",
        &max_total_buffered_append_size,
        "1073741824", // 1GB
@@ -1912,6 +2405,19 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "from timestamps to LSNs in LogsDB data partitions.",
        SERVER,
        SettingsCategory::Performance);
+  init("write-find-time-index-interval",
+       &write_find_time_index_interval,
+       "0ms",
+       validate_nonnegative<ssize_t>(),
+       "If nonzero, --write-find-time-index writes a sparse index: a record "
+       "gets an index entry only if at least this much time passed (by record "
+       "timestamps) since the last indexed record of the same log on the same "
+       "shard. Records with timestamps lower than the last indexed one are "
+       "always indexed. Readers of a sparse index should set "
+       "--rocksdb-find-time-index-scan-limit to cover the records between "
+       "index entries. 0 means indexing every record.",
+       SERVER,
+       SettingsCategory::Performance);
   init("on-demand-logs-config",
        &on_demand_logs_config,
        "false",
@@ -1940,6 +2446,18 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "be.",
        CLIENT | REQUIRES_RESTART /* used in ClientImpl::create() */,
        SettingsCategory::Configuration);
+  init("remote-logs-config-invalidation-spread",
+       &remote_logs_config_invalidation_spread,
+       "0ms",
+       validate_nonnegative<ssize_t>(),
+       "When a client using the remote logs config is notified that the logs "
+       "config changed, it waits a random delay of up to this long before "
+       "invalidating its cache. Notifications received while waiting are "
+       "coalesced. This spreads the re-fetches of many clients over time "
+       "instead of having all of them hit the servers at once. 0 invalidates "
+       "immediately.",
+       CLIENT,
+       SettingsCategory::Configuration);
   init("alternative-layout-property",
        &alternative_layout_property,
        "",
@@ -1967,6 +2485,29 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "Maximum amount of memory that can be allocated by read storage tasks.",
        SERVER,
        SettingsCategory::ResourceManagement);
+  init("read-storage-task-batch-size",
+       &read_storage_task_batch_size,
+       "1",
+       parse_positive<size_t>(),
+       "Maximum number of read storage tasks that a worker thread coalesces "
+       "into one storage task for a shard. Tasks issued by read streams during "
+       "the same event loop iteration are grouped and executed by one storage "
+       "thread in log id order, which reduces storage task overhead when many "
+       "readers catch up at once. Each read stream keeps its own byte budget. "
+       "1 disables batching.",
+       SERVER,
+       SettingsCategory::ReadPath);
+  init("catchup-queue-drr-quantum-bytes",
+       &catchup_queue_drr_quantum_bytes,
+       "0",
+       parse_nonnegative<size_t>(),
+       "If positive, read streams of different clients on a worker are served "
+       "with deficit round robin on record bytes: a client that queued this "
+       "many bytes since its last turn waits until every other client with "
+       "backlogged streams had a turn. Keeps clients with many backlogged "
+       "streams from starving lighter ones. 0 disables it.",
+       SERVER,
+       SettingsCategory::ReadPath);
   init("append-stores-max-mem-bytes",
        &append_stores_max_mem_bytes,
        "2G",
@@ -2008,6 +2549,38 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "format to the parent znode",
        SERVER,
        SettingsCategory::EpochStore);
+  init("epoch-store-write-batch-size",
+       &epoch_store_write_batch_size,
+       "1",
+       parse_positive<ssize_t>(),
+       "Maximum number of znode writes of different logs that the Zookeeper "
+       "epoch store groups into a single multi-op. Batching speeds up mass "
+       "sequencer activations, e.g. after a failover. If any write of a batch "
+       "fails, the writes of the batch are retried one by one. 1 disables "
+       "batching.",
+       SERVER,
+       SettingsCategory::EpochStore);
+  init("epoch-store-write-batches-in-flight",
+       &epoch_store_write_batches_in_flight,
+       "8",
+       parse_positive<ssize_t>(),
+       "If --epoch-store-write-batch-size is greater than 1, maximum number "
+       "of write batches the Zookeeper epoch store has in flight. Writes "
+       "issued while the limit is reached are queued and sent in the next "
+       "batches.",
+       SERVER,
+       SettingsCategory::EpochStore);
+  init("epoch-store-serialize-log-requests",
+       &epoch_store_serialize_log_requests,
+       "true",
+       nullptr,
+       "If true, the Zookeeper epoch store runs at most one request per log at "
+       "a time. Requests issued for a log while another one is in flight are "
+       "queued and started when it completes, so that their read-modify-writes "
+       "don't conflict with each other and fail with E::AGAIN. Requests for "
+       "different logs still run concurrently.",
+       SERVER,
+       SettingsCategory::EpochStore);
   init("ssl-load-client-cert",
        &ssl_load_client_cert,
        "false",
@@ -2107,6 +2680,55 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "\"any\" or \"\" to keep the default.",
        SERVER | REQUIRES_RESTART /* used once when ExecStorageThread starts */,
        SettingsCategory::ResourceManagement);
+  init("worker-cpus",
+       &worker_cpus,
+       "",
+       [](const std::string& val) -> std::vector<int> {
+         std::vector<int> res;
+         if (parse_cpu_list(val, &res) != 0) {
+           throw boost::program_options::error(
+               "value of --worker-cpus must be a list of CPUs, e.g. "
+               "0-11,24-35; " +
+               val + " given.");
+         }
+         return res;
+       },
+       "CPUs to restrict worker threads to, in the format of "
+       "/sys/devices/system/cpu/online, e.g. \"0-11,24-35\". Use it to keep "
+       "workers on the NUMA node the NIC is attached to, so that their memory "
+       "is allocated on that node too. \"\" to not restrict them.",
+       SERVER | CLIENT |
+           REQUIRES_RESTART /* used once when the worker starts */,
+       SettingsCategory::ResourceManagement);
+  init("storage-thread-cpus",
+       &storage_thread_cpus,
+       "",
+       [](const std::string& val) -> std::vector<std::vector<int>> {
+         std::vector<std::vector<int>> res;
+         if (val.empty()) {
+           return res;
+         }
+         std::vector<std::string> lists;
+         folly::split(';', val, lists);
+         for (const std::string& list : lists) {
+           std::vector<int> cpus;
+           if (parse_cpu_list(list, &cpus) != 0 || cpus.empty()) {
+             throw boost::program_options::error(
+                 "value of --storage-thread-cpus must be semicolon-separated "
+                 "lists of CPUs, e.g. 0-11;12-23; " +
+                 val + " given.");
+           }
+           res.push_back(std::move(cpus));
+         }
+         return res;
+       },
+       "CPUs to restrict storage threads to, as semicolon-separated lists of "
+       "CPUs, e.g. \"0-11;12-23\". Storage threads of shard i are restricted "
+       "to list i modulo the number of lists. Use it to keep storage threads "
+       "on the NUMA node the shard's disk is attached to. \"\" to not "
+       "restrict them.",
+       SERVER | REQUIRES_RESTART /* used once when storage threads start */,
+       SettingsCategory::ResourceManagement);
 
   init("checksumming-enabled",
        &checksumming_enabled,
@@ -2156,6 +2778,57 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "for some time",
        SERVER /* for event log */ | CLIENT,
        SettingsCategory::ReaderFailover);
+  init("scd-replica-ranking-interval",
+       &scd_replica_ranking_interval,
+       "0s",
+       validate_nonnegative<ssize_t>(),
+       "If positive, readers doing single copy delivery rank the nodes they "
+       "read from at this interval, nodes in the client's region (see "
+       "--my-location) first, then by how fast their shards completed "
+       "recent windows. Storage nodes then have each record shipped by its "
+       "best ranked replica instead of by the first one of its shuffled "
+       "copyset. A change of ranking rewinds the read stream. Requires "
+       "--reader-slow-shards-detection to not be disabled, as its latency "
+       "measurements are used.",
+       CLIENT,
+       SettingsCategory::ReaderFailover);
+  init("reader-rewind-batch-size",
+       &reader_rewind_batch_size,
+       "1000",
+       nullptr,
+       "Maximum number of read streams on a worker that rewind, sending START "
+       "messages to their storage shards, in one batch. Rewinds due at the "
+       "same time beyond that, e.g. when a storage node goes down, wait for "
+       "the next batch. 0 means rewind each stream as soon as it is due.",
+       SERVER /* for event log */ | CLIENT,
+       SettingsCategory::ReaderFailover);
+  init("reader-rewind-batch-interval",
+       &reader_rewind_batch_interval,
+       "10ms",
+       validate_nonnegative<ssize_t>(),
+       "Time between batches of read stream rewinds on a worker. See "
+       "reader-rewind-batch-size.",
+       SERVER /* for event log */ | CLIENT,
+       SettingsCategory::ReaderFailover);
+  init("reader-health-signals-failover",
+       &reader_health_signals_failover,
+       "true",
+       nullptr,
+       "If true, readers in SCD mode add shards of nodes that cluster state "
+       "reports dead to the shards down list, and shards of graylisted nodes "
+       "to the shards slow list, as soon as they learn about it instead of "
+       "waiting for scd-timeout or slow shards detection.",
+       SERVER /* for event log */ | CLIENT,
+       SettingsCategory::ReaderFailover);
+  init("reader-health-signals-batch-delay",
+       &reader_health_signals_batch_delay,
+       "50ms",
+       validate_nonnegative<ssize_t>(),
+       "With reader-health-signals-failover, how long to collect node state "
+       "and graylist changes before passing them to all read streams on a "
+       "worker, so that a burst of changes causes each stream to rewind once.",
+       SERVER /* for event log */ | CLIENT,
+       SettingsCategory::ReaderFailover);
   init(
       "verify-checksum-before-replicating",
       &verify_checksum_before_replicating,
@@ -2230,6 +2903,27 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "fetch.",
        CLIENT | SERVER,
        SettingsCategory::Configuration);
+  init("nodes-configuration-init-cache-file",
+       &nodes_configuration_init_cache_file,
+       "",
+       nullptr, // no validation
+       "If not empty, the client saves the serialized nodes configuration it "
+       "fetches when starting to this file. Later starts use the file instead "
+       "of fetching the nodes configuration from the cluster, which avoids "
+       "waiting for the fetch, as long as the file is younger than "
+       "--nodes-configuration-init-cache-max-age. The nodes configuration "
+       "manager then brings the configuration up to date in the background.",
+       CLIENT | REQUIRES_RESTART,
+       SettingsCategory::Configuration);
+  init("nodes-configuration-init-cache-max-age",
+       &nodes_configuration_init_cache_max_age,
+       "1h",
+       validate_nonnegative<ssize_t>(),
+       "Maximum age of the file set by --nodes-configuration-init-cache-file "
+       "for it to be used instead of fetching the nodes configuration. Older "
+       "files are refreshed by fetching.",
+       CLIENT | REQUIRES_RESTART,
+       SettingsCategory::Configuration);
   init("use-tcp-keep-alive",
        &use_tcp_keep_alive,
        "true",
@@ -2313,6 +3007,16 @@ void Settings::defineSettings(SettingEasyInit& init) {
                                              StatsCollectionThread */
        ,
        SettingsCategory::Monitoring);
+  init("stats-snapshot-path",
+       &stats_snapshot_path,
+       "",
+       nullptr, // no validation
+       "If not empty, every stats-collection-interval a binary snapshot of all "
+       "counters is atomically written to this file, for local agents to read "
+       "instead of querying the 'stats' admin command. Put it on a tmpfs, e.g. "
+       "/dev/shm. See StatsSnapshotFile.h for the format.",
+       SERVER | REQUIRES_RESTART /* passed to ctor of StatsCollectionThread */,
+       SettingsCategory::Monitoring);
   init(
       "esn-bits",
       &esn_bits,
@@ -2322,6 +3026,19 @@ void Settings::defineSettings(SettingEasyInit& init) {
       " 32) are guaranteed to be 0. Used for testing ESN exhaustion.",
       SERVER | REQUIRES_RESTART /* passed to Sequencer ctor in AllSequencers */,
       SettingsCategory::Testing);
+  init("sequencer-window-max-growth",
+       &sequencer_window_max_growth,
+       "1",
+       parse_positive<ssize_t>(),
+       "Lets the sliding window of Appenders of a sequencer expand when it is "
+       "full, up to this many times the maxWritesInFlight attribute of the "
+       "log, instead of rejecting appends with SEQNOBUFS. The window doubles "
+       "its capacity each time it fills up and goes back to maxWritesInFlight "
+       "in the next epoch. Memory for the largest window is allocated when "
+       "the epoch starts. 1 disables expansion. Applies to epochs activated "
+       "after the change.",
+       SERVER,
+       SettingsCategory::Sequencer);
   init("client-initial-redelivery-delay",
        &client_initial_redelivery_delay,
        "1s",
@@ -2379,6 +3096,26 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "messages.",
        SERVER | CLIENT,
        SettingsCategory::Batching);
+  init("socket-batching-size-trigger",
+       &socket_batching_size_trigger,
+       "0",
+       nullptr, // no validation
+       "If positive, the messages batched for a socket (see "
+       "--socket-batching-time-trigger) are written to it as soon as they "
+       "add up to this many bytes, without waiting for the time trigger. "
+       "All batched messages are written with a single writev().",
+       SERVER | CLIENT,
+       SettingsCategory::Batching);
+  init("socket-zero-copy-threshold",
+       &socket_zero_copy_threshold,
+       "0",
+       nullptr, // no validation
+       "If positive, writes of at least this many bytes to plaintext "
+       "sockets use MSG_ZEROCOPY, which saves copying the data into the "
+       "kernel at the cost of a completion notification per write. Only "
+       "pays off for large writes. 0 disables zero copy.",
+       SERVER | CLIENT,
+       SettingsCategory::Batching);
   init("sequencer-batching-time-trigger",
        &sequencer_batching_time_trigger,
        "1s",
@@ -2421,6 +3158,32 @@ void Settings::defineSettings(SettingEasyInit& init) {
       "benefit of batching and recompressing would be small.",
       SERVER,
       SettingsCategory::Batching);
+  init("sequencer-batching-adaptive",
+       &sequencer_batching_adaptive,
+       "false",
+       nullptr, // no validation
+       "Makes sequencer batching (if used) adapt to the append rate of each "
+       "log: logs that would get fewer than two appends within the time "
+       "trigger are flushed without delay, and hot logs wait for a fraction "
+       "of the time trigger that grows with the occupancy of the sequencer's "
+       "sliding window, flushing early once the batch holds as many bytes as "
+       "the log usually gets during that time. The time and size triggers "
+       "configured for the log act as upper bounds.",
+       SERVER,
+       SettingsCategory::Batching);
+  init("sequencer-batching-appender-spread",
+       &sequencer_batching_appender_spread,
+       "1",
+       parse_positive<ssize_t>(),
+       "Sequencer batching (if used) flushes all batches of a log on one "
+       "worker. If greater than 1, the Appenders storing those batches are "
+       "run round robin on that worker and the next this-many-minus-one "
+       "workers, so that a single hot log doesn't saturate one worker. LSNs "
+       "are still allocated atomically by the sequencer, but consecutive "
+       "batches of a log may get LSNs in a different order than they were "
+       "flushed in.",
+       SERVER,
+       SettingsCategory::Batching);
   init("num-processor-background-threads",
        &num_processor_background_threads,
        "0",
@@ -2439,7 +3202,8 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "down.  If the total size of the batch is less than this, it will "
        "constructed / compressed on the Worker thread, blocking other appends "
        "to all logs in that shard.  If larger, it will be enqueued to a helper "
-       "thread.",
+       "thread, unless the queue of helper threads (--background-queue-size) "
+       "is full.",
        SERVER | CLIENT,
        SettingsCategory::Batching);
   init("buffered-writer-zstd-level",
@@ -2661,6 +3425,18 @@ void Settings::defineSettings(SettingEasyInit& init) {
        SERVER,
        SettingsCategory::Network);
 
+  init("local-data-unix-sockets",
+       &local_data_unix_sockets,
+       "",
+       parse_local_data_unix_sockets,
+       "Unix domain sockets through which this client connects to nodes "
+       "running on the same host, instead of their TCP data addresses. Every "
+       "such node needs to listen on the socket (see "
+       "--local-data-unix-socket). Only used for non-SSL connections. Format: "
+       "\"N<node index>:<path>,...\", e.g. \"N3:/var/run/logdevice.sock\"",
+       CLIENT | REQUIRES_RESTART,
+       SettingsCategory::Network);
+
   init("test-bypass-recovery",
        &bypass_recovery,
        "false",
@@ -2999,6 +3775,29 @@ void Settings::defineSettings(SettingEasyInit& init) {
        CLIENT,
        SettingsCategory::Monitoring);
 
+  init("shadow-log-sample-ratio",
+       &shadow_log_sample_ratio,
+       "1",
+       validate_range<double>(0, 1),
+       "Fraction of the logs with traffic shadowing configured whose appends "
+       "are actually shadowed. Logs are picked by hashing their ID, so a "
+       "given log is either shadowed (subject to the ratio configured in "
+       "LogsConfig) or not at all, and the shadow cluster sees complete "
+       "streams for the logs it gets. See traffic-shadow-enabled.",
+       CLIENT,
+       SettingsCategory::Monitoring);
+
+  init("shadow-max-in-flight-appends",
+       &shadow_max_in_flight_appends,
+       "10000",
+       validate_positive<ssize_t>(),
+       "Maximum number of shadow appends that may be in flight to a shadow "
+       "cluster. Further shadow appends are dropped (and counted in the "
+       "shadow_append_dropped stat) rather than queued, so that a slow shadow "
+       "cluster never holds up appends to this one.",
+       CLIENT,
+       SettingsCategory::Monitoring);
+
   init("enable-nodes-configuration-manager",
        &enable_nodes_configuration_manager,
        "true",
@@ -3160,6 +3959,19 @@ void Settings::defineSettings(SettingEasyInit& init) {
       "looking elsewhere.",
       SERVER | CLIENT,
       SettingsCategory::WritePath);
+  init("client-sequencer-placement-cache",
+       &client_sequencer_placement_cache,
+       "false",
+       nullptr, // no validation
+       "If true, when a sequencer redirects or preempts a request, the node it "
+       "points to is remembered for the log and used by all workers of the "
+       "client for later appends and sequencer state requests, instead of "
+       "hashing the log id again. After a sequencer moves, only the first "
+       "request to reach the old node gets redirected rather than one per "
+       "worker. Entries are dropped as soon as cluster state updates mark the "
+       "node as not alive or the node is unreachable.",
+       CLIENT,
+       SettingsCategory::WritePath);
   init("real-time-max-bytes",
        &real_time_max_bytes,
        "100000000",
@@ -3404,6 +4216,31 @@ void Settings::defineSettings(SettingEasyInit& init) {
        CLIENT | SERVER,
        SettingsCategory::Configuration);
 
+  init("rsm-snapshot-request-fanout",
+       &rsm_snapshot_request_fanout,
+       "1",
+       validate_positive<ssize_t>(),
+       "Number of nodes to request an RSM snapshot from in parallel when "
+       "fetching it via MessageBased Store. The first usable reply is used, "
+       "so a slow or overloaded node doesn't delay the catch-up of a "
+       "restarting node. 1 asks one node at a time.",
+       CLIENT | SERVER,
+       SettingsCategory::Configuration);
+
+  init("rsm-max-deltas-per-record",
+       &rsm_max_deltas_per_record,
+       "1",
+       validate_positive<ssize_t>(),
+       "Maximum number of deltas written to the LogsConfig or key-value store "
+       "replicated state machines that are appended as a single record of "
+       "the delta log. Deltas written while an append of the same state "
+       "machine is in flight are queued and appended together once it "
+       "completes, and each is confirmed to its writer individually. 1 "
+       "disables batching. Only raise this once all servers and clients "
+       "reading these state machines understand batched delta records.",
+       CLIENT | SERVER,
+       SettingsCategory::Configuration);
+
   init(
       "rsm-snapshot-store-type",
       &rsm_snapshot_store_type,
@@ -3473,6 +4310,18 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "being slow sometimes",
        SERVER | EXPERIMENTAL,
        SettingsCategory::Performance);
+  init("max-worker-read-execution-time",
+       &max_worker_read_execution_time,
+       "5ms",
+       validate_positive<ssize_t>(),
+       "With --allow-reads-on-workers, maximum time a cache-only read on a "
+       "worker thread may take. A read taking longer, e.g. because it has to "
+       "filter out many records, ships what it got so far and continues on "
+       "a storage thread, so that it doesn't hold up other work on the "
+       "worker. 'max' means no limit other than "
+       "--max-record-read-execution-time.",
+       SERVER | EXPERIMENTAL,
+       SettingsCategory::Performance);
   init("findkey-timeout",
        &findkey_timeout,
        "",
@@ -3480,6 +4329,15 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "Findkey API call timeout. If omitted the client timeout will be used.",
        CLIENT,
        SettingsCategory::Core);
+  init("batch-api-max-in-flight",
+       &batch_api_max_in_flight,
+       "1000",
+       parse_positive<ssize_t>(),
+       "Maximum number of logs a Client::*Batch() call (e.g. findTimeBatch(), "
+       "getTailAttributesBatch()) looks up concurrently. The remaining logs "
+       "of the batch are looked up as earlier lookups complete.",
+       CLIENT,
+       SettingsCategory::Core);
   init("append-timeout",
        &append_timeout,
        "",
@@ -3487,6 +4345,57 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "Timeout for appends. If omitted the client timeout will be used.",
        CLIENT,
        SettingsCategory::Core);
+  init("append-batching-window",
+       &append_batching_window,
+       "0ms",
+       validate_nonnegative<ssize_t>(),
+       "If positive, appends going to the same sequencer node within this "
+       "window are sent together in one message, which cuts the per-message "
+       "overhead of small appends to many logs at the cost of adding up to "
+       "this much latency. Only used with servers that support it. 0 "
+       "disables batching.",
+       CLIENT,
+       SettingsCategory::Performance);
+  init("append-batching-max-bytes",
+       &append_batching_max_bytes,
+       "65536",
+       parse_positive<ssize_t>(),
+       "Appends batched because of --append-batching-window are sent as soon "
+       "as the ones queued for a node add up to this many bytes. Larger "
+       "appends are never batched.",
+       CLIENT,
+       SettingsCategory::Performance);
+  init("trim-batching-window",
+       &trim_batching_window,
+       "0ms",
+       validate_nonnegative<ssize_t>(),
+       "If positive, trims going to the same storage node within this window "
+       "are sent together in one message, and the storage node writes the "
+       "trim points of a shard in one batch. Speeds up trimming many logs at "
+       "once (e.g. by retention jobs) at the cost of adding up to this much "
+       "latency to each trim. Only used with servers that support it. 0 "
+       "disables batching.",
+       CLIENT,
+       SettingsCategory::Performance);
+  init("trim-batching-max-trims",
+       &trim_batching_max_trims,
+       "1000",
+       parse_positive<ssize_t>(),
+       "Trims batched because of --trim-batching-window are sent as soon as "
+       "this many are queued for a node.",
+       CLIENT,
+       SettingsCategory::Performance);
+  init("stream-writer-inflight-window",
+       &stream_writer_inflight_window,
+       "0",
+       nullptr,
+       "Number of appends of a single write stream (BufferedWriter in STREAM "
+       "mode) to keep in flight. Later appends wait in the stream until "
+       "earlier ones are acked, and after a failure the whole failed suffix "
+       "is resent at once, up to the window. 0 starts with one append in "
+       "flight and sends two more for every acked one.",
+       CLIENT,
+       SettingsCategory::WritePath);
   init("logsconfig-timeout",
        &logsconfig_timeout,
        "",
@@ -3522,6 +4431,16 @@ void Settings::defineSettings(SettingEasyInit& init) {
        "and use HHWheelTimer backend.",
        SERVER | CLIENT | REQUIRES_RESTART,
        SettingsCategory::Core);
+  init("enable-worker-wheel-timers",
+       &enable_worker_wheel_timers,
+       "true",
+       nullptr, // no validation
+       "Makes timers on workers use an HHWheelTimer running on the worker's "
+       "own event loop, with O(1) activation and cancellation and no hop "
+       "between threads when they fire. Takes precedence over "
+       "--enable-hh-wheel-backed-timers.",
+       SERVER | CLIENT | REQUIRES_RESTART,
+       SettingsCategory::Core);
   init("enable-store-histograms-calculations",
        &enable_store_histogram_calculations,
        "false",
@@ -82,6 +82,10 @@ struct Settings : public SettingsBundle {
   // number of worker threads to run
   int num_workers;
 
+  // (client-only setting) If positive, appends without a target worker only
+  // run on this many workers, see .cpp.
+  int client_append_workers;
+
   // Time interval after which watchdog wakes up and detects stalls
   std::chrono::milliseconds watchdog_poll_interval_ms;
 
@@ -148,6 +152,10 @@ struct Settings : public SettingsBundle {
   // If true, turn off TraceLogger by using NoopTraceLogger implementation
   bool trace_logger_disabled;
 
+  // Fraction of appends and storage tasks for which LatencyTrace records a
+  // per-stage latency breakdown.
+  double latency_trace_sample_rate;
+
   // If false: no checksumming is done at the Protocol Layer
   // If true: 'checksumming_blacklisted_messages' is consulted
   bool checksumming_enabled;
@@ -205,6 +213,16 @@ struct Settings : public SettingsBundle {
   // details.
   size_t socket_idle_threshold;
 
+  // If positive, bodies of small incoming messages are read into shared
+  // buffers of this size instead of being allocated one by one.
+  size_t socket_read_pool_buffer_size;
+
+  // Compression applied to messages of at least message_compression_min_size
+  // bytes sent to peers that support it. Only NONE and ZSTD are allowed.
+  Compression message_compression;
+  size_t message_compression_min_size;
+  size_t message_compression_zstd_level;
+
   // A Connection is considered active if it had bytes pending in the Connection
   // above socket-idle-threshold for greater than
   // min-socket-idle-threshold-percent of socket-health-check-period.
@@ -235,6 +253,21 @@ struct Settings : public SettingsBundle {
   // Similar to output_max_records_kb but is applied *before* filtering records.
   int64_t max_record_bytes_read_at_once;
 
+  // If true, storage threads copy records read by ReadStorageTask into
+  // IOBufs, and RECORD messages share those buffers instead of copying the
+  // payloads once more on the worker thread.
+  bool read_storage_task_zero_copy;
+
+  // Records with payloads of at most this many bytes are delivered to
+  // readers in RECORDS_BATCH messages, packing consecutive records of a read
+  // stream into one message. 0 disables batching.
+  size_t records_batch_max_payload;
+
+  // Upper bound on the read-ahead window of iterators created by catch-up
+  // reads on storage threads. The window itself is the amount of data the
+  // stream may deliver in one batch. 0 disables read-ahead.
+  int64_t catchup_readahead_max_bytes;
+
   // Maximum execution time for reading records
   std::chrono::milliseconds max_record_read_execution_time;
 
@@ -249,6 +282,11 @@ struct Settings : public SettingsBundle {
   uint32_t mid_requests_per_iteration;
   uint32_t lo_requests_per_iteration;
 
+  // Lower priority tasks on a worker that have waited for longer than this
+  // are served ahead of higher priority ones. See
+  // EventLoopTaskQueue::setAgingThreshold().
+  std::chrono::milliseconds worker_task_aging_threshold;
+
   // Size worker request pipe to hold this many requests.
   //
   // NOTE: This currently translates to a fcntl(F_SETPIPE_SZ) call which is
@@ -267,6 +305,10 @@ struct Settings : public SettingsBundle {
   // eventbase otherwise it will be instantiated with folly eventbase.
   bool use_legacy_eventbase;
 
+  // If true, worker EventLoops use an event base backed by io_uring instead
+  // of libevent, when the kernel and folly support it.
+  bool worker_io_uring_event_loop;
+
   // Request Execution time(in milli-seconds) after which it is considered slow
   // and Worker stats 'worker_slow_requests' is bumped
   std::chrono::milliseconds request_execution_delay_threshold;
@@ -282,6 +324,12 @@ struct Settings : public SettingsBundle {
   // The maximum number of unprocessed messages in the system.
   size_t incoming_messages_max_bytes_limit;
 
+  // When the recent queueing delay of a worker exceeds these, the worker
+  // rejects APPENDs from clients with E::OVERLOADED, and stops reading from
+  // client connections, respectively. Zero disables. See Worker::loadShedding.
+  std::chrono::milliseconds load_shedding_reject_appends_queue_delay;
+  std::chrono::milliseconds load_shedding_pause_client_reads_queue_delay;
+
   // Maximum number of StorageTask instances that one worker thread may have
   // in flight to each database shard (waiting on the storage thread pool to
   // complete them).  This is used to size pipes and queues.
@@ -295,6 +343,13 @@ struct Settings : public SettingsBundle {
   // Setting to control read I/O bandwidth throttling.
   bool enable_read_throttling;
 
+  // With read throttling, split a worker's read I/O bandwidth between client
+  // principals: clients of a principal with min_read_bytes_per_sec in the
+  // principals config may read that much regardless of the budget, and
+  // read streams waiting for bandwidth are woken in weighted fair order, by
+  // the read_share of their principals.
+  bool read_throttling_share_by_principal;
+
   // A way to turn off putting nodes in graylist, to be able to revert
   // to normal copyset selection behavior.
   bool disable_graylisting;
@@ -320,6 +375,16 @@ struct Settings : public SettingsBundle {
   // estimate first wave timeout.
   bool enable_adaptive_store_timeout;
 
+  // Fraction of STORE waves that may be hedged, see .cpp. 0 disables hedging.
+  double hedged_store_budget;
+
+  // If positive, STOREs sent by Appenders to the same storage node are held
+  // for up to this long and sent together in one STORES_BATCH message, see
+  // StoreBatcher.
+  std::chrono::microseconds sequencer_store_batching_window;
+  // STOREs queued for a node are sent once they add up to this many bytes.
+  size_t sequencer_store_batching_max_bytes;
+
   // (client-only setting) When the client loses the connection to a server,
   // it will attempt to reconnect repeatedly, with the delay increasing
   // exponentially up to this max.
@@ -340,6 +405,24 @@ struct Settings : public SettingsBundle {
   // size of the record cache
   std::chrono::seconds record_cache_monitor_interval;
 
+  // if true, when the record cache exceeds record_cache_max_size, the
+  // monitor thread first LZ4-compresses the payloads of records in unclean
+  // epochs other than the latest one of each log, and only evicts whole logs
+  // if that didn't free enough memory
+  bool record_cache_compress_cold_epochs;
+
+  // How the record cache monitor thread picks the logs to evict once the
+  // record cache exceeds record_cache_max_size. SIZE evicts the logs with
+  // the most bytes cached. FREQUENCY evicts the logs whose caches were looked
+  // up the least (by readers, digests and seals), with counts halved after
+  // each eviction, which keeps logs with tailing readers cached.
+  enum class RecordCacheEvictionPolicy { SIZE, FREQUENCY };
+  RecordCacheEvictionPolicy record_cache_eviction_policy;
+
+  // number of threads per shard deserializing record cache snapshots on
+  // startup
+  size_t record_cache_repopulation_threads;
+
   // When an ld_check() fails, call abort().  If not, just continue
   // executing.  We'll log either way.
   bool abort_on_failed_check;
@@ -390,6 +473,12 @@ struct Settings : public SettingsBundle {
   // 3. And finally set send_to_gossip_port = true
   bool ssl_on_gossip_port;
 
+  // DSCP of gossip sockets, or -1 to use server_dscp_default.
+  int gossip_dscp;
+
+  // SO_PRIORITY of gossip sockets, or -1 to leave it alone.
+  int gossip_socket_priority;
+
   // (sequencer-only setting) Limit on the number of nodes in the cluster. Used
   // to size some of the data structures Sequencer uses.
   size_t max_nodes;
@@ -418,6 +507,10 @@ struct Settings : public SettingsBundle {
   // chain.
   bool disable_chain_sending;
 
+  // If set, storage nodes forward chained STOREs to the next link before
+  // checking seals, instead of after.
+  bool store_chain_forward_early;
+
   // Time interval that a node health check probe is sent if there is
   // an outstanding probe from the same node in nodeset
   std::chrono::seconds node_health_check_retry_interval;
@@ -497,6 +590,12 @@ struct Settings : public SettingsBundle {
   // Quanta for the DRR scheduler.
   uint64_t storage_tasks_drr_quanta = 1;
 
+  // If true, storage threads that have been idle for
+  // storage_threads_steal_idle_interval take tasks of their thread type from
+  // the queues of other shards.
+  bool storage_threads_steal_tasks;
+  std::chrono::milliseconds storage_threads_steal_idle_interval;
+
   // Shares for StorageTask principals.
   std::array<StorageTaskShare, (uint64_t)StorageTaskPrincipal::NUM_PRINCIPALS>
       storage_task_shares;
@@ -513,6 +612,10 @@ struct Settings : public SettingsBundle {
   // for one client
   size_t max_cached_digest_record_queued_kb;
 
+  // How long a storage node keeps the epoch record cache snapshot of a cached
+  // digest for reuse by another digest of the same epoch. 0 disables reuse.
+  std::chrono::milliseconds cached_digest_snapshot_reuse_ttl;
+
   // Consider worker's storage task queue overloaded if it was last dropped at
   // most this long ago.
   std::chrono::milliseconds queue_drop_overload_time;
@@ -566,6 +669,11 @@ struct Settings : public SettingsBundle {
   // procedure is restarted from scratch.
   std::chrono::seconds recovery_timeout;
 
+  // maximum number of unclean epochs of a log that may build their recovery
+  // digests at the same time. Mutations still run one epoch at a time,
+  // oldest first.
+  size_t recovery_max_concurrent_epochs;
+
   // Initial retry timeout used for checking if the latest metadata log record
   // is fully replicated during log recovery.
   chrono_expbackoff_t<std::chrono::milliseconds> recovery_seq_metadata_timeout;
@@ -627,6 +735,15 @@ struct Settings : public SettingsBundle {
   // Minium timeout for a CheckSealRequest
   std::chrono::milliseconds check_seal_req_min_timeout;
 
+  // How long the result of a check-seal that found the sequencer not
+  // preempted is reused for other GET_SEQ_STATE messages for the same log.
+  // 0 disables reuse.
+  std::chrono::milliseconds check_seal_cache_ttl;
+
+  // Number of recently released records of each tail optimized log that
+  // sequencers keep to serve readers, 0 to disable, see .cpp.
+  size_t sequencer_tail_buffer_size;
+
   // interval for update_medatata_map_timer_; default 1 hr
   std::chrono::milliseconds update_metadata_map_interval{
       std::chrono::seconds(3600)};
@@ -669,10 +786,47 @@ struct Settings : public SettingsBundle {
   // but also wire chatter.
   double client_read_flow_control_threshold;
 
+  // (client-only setting) If larger than client_read_buffer_size, the window
+  // of AsyncReader read streams is auto-tuned between the two based on the
+  // delivery rate and round trip time to storage nodes.
+  size_t client_read_buffer_max_size;
+
+  // (client-only setting) Bytes of records that all read streams of a client
+  // together may buffer beyond client_read_buffer_size because of window
+  // auto-tuning. 0 means no limit.
+  size_t client_read_window_memory_budget;
+
+  // (client-only setting) How often AsyncReader compares the delivery
+  // throughput of the workers its read streams run on and moves a read stream
+  // from the busiest worker to the least busy one. 0 disables rebalancing.
+  std::chrono::milliseconds client_read_stream_rebalance_interval;
+
+  // (client-only setting) Measure the CPU time readers spend in each stage of
+  // the client read path and report it in the client_read_*_usec stats.
+  bool client_read_stage_timing;
+
+  // (client-only setting) Deliver adjacent BRIDGE, HOLE and FILTERED_OUT gaps
+  // of the same type that a read stream finds at once as a single gap.
+  bool client_read_coalesce_gaps;
+
   // (client-only setting) maximum number of epoch metadata entries cached in
   // the client. Set it to 0 to disable epoch metadata caching
   size_t client_epoch_metadata_cache_size;
 
+  // (client-only setting) number of independently locked shards the client
+  // epoch metadata cache is split into
+  size_t client_epoch_metadata_cache_shards;
+
+  // (client-only setting) if true, all clients of the same cluster in the
+  // process share one epoch metadata cache
+  bool client_epoch_metadata_cache_shared;
+
+  // (client-only setting) When a read stream is within this many epochs of the
+  // last epoch it knows the metadata of, and later epochs have been released,
+  // fetch the metadata of the following epochs into the epoch metadata cache
+  // in the background. 0 disables prefetching.
+  size_t client_read_stream_metadata_prefetch_epochs;
+
   // (client-only setting) Period for logging in logdevice_readers_flow scuba
   // table. Set it to 0 to disable feature.
   std::chrono::milliseconds client_readers_flow_tracer_period;
@@ -752,6 +906,10 @@ struct Settings : public SettingsBundle {
   // invalidating them.
   std::chrono::milliseconds iterator_cache_ttl;
 
+  // If positive, at most this many read streams per worker keep cached
+  // iterators; the least recently used ones release theirs.
+  size_t iterator_cache_max_streams;
+
   // Maximum version of the protocol to use on this client/server.
   // Intented to be used for testing.
   uint16_t max_protocol;
@@ -769,6 +927,14 @@ struct Settings : public SettingsBundle {
   // we start rejecting new appends.
   size_t max_total_appenders_size_hard;
 
+  // Maximum number of bytes of appends a sequencer node lets a client send
+  // without probing again after a successful APPEND_PROBE. 0 disables credit.
+  size_t append_probe_credit;
+
+  // Maximum number of freed Appenders each worker keeps around for reuse by
+  // new Appenders. 0 disables pooling.
+  size_t appender_pool_size;
+
   // Maximum amount of memory that BufferedWriter in sequencers should use for
   // buffering writes. It will reject writes when this threshold is
   // exceeded.
@@ -816,6 +982,10 @@ struct Settings : public SettingsBundle {
   // When true, the findTime index is written.
   bool write_find_time_index;
 
+  // If nonzero, the findTime index is sparse: a log gets an index entry at
+  // most once per this much time (by record timestamps) on each shard.
+  std::chrono::milliseconds write_find_time_index_interval;
+
   // (client-only setting) When set to true on the client, this will get the
   // log configuration from the server on-demand, if it's not present in the
   // main config file.
@@ -836,6 +1006,13 @@ struct Settings : public SettingsBundle {
   // the client will be.
   std::chrono::seconds remote_logs_config_cache_ttl;
 
+  // (client-only setting) When the remote logs config is invalidated by a
+  // CONFIG_CHANGED message, wait a random delay up to this long before
+  // dropping the cached entries. Notifications received in the meantime are
+  // coalesced. Spreads re-fetches of many clients over time. 0 invalidates
+  // immediately.
+  std::chrono::milliseconds remote_logs_config_invalidation_spread;
+
   // (server-only setting) Override the client FindKeyAccuracy setting with
   // FindKeyAccuracy::APPROXIMATE.
   bool findtime_force_approximate;
@@ -852,9 +1029,32 @@ struct Settings : public SettingsBundle {
   // format to the parent znode.
   bool epoch_store_double_write_new_serialization_format;
 
+  // Maximum number of znode writes of different epoch store requests that the
+  // Zookeeper epoch store groups into a single multi-op. 1 disables batching.
+  size_t epoch_store_write_batch_size;
+
+  // Maximum number of write batches the Zookeeper epoch store has in flight
+  // (if batching is enabled). Writes queue up while the limit is reached.
+  size_t epoch_store_write_batches_in_flight;
+
+  // If true, the Zookeeper epoch store runs at most one request per log at a
+  // time and queues the others, instead of letting concurrent
+  // read-modify-writes of the same log race and fail with version conflicts.
+  bool epoch_store_serialize_log_requests;
+
   // Maximum amount of memory that can be allocated by read storage tasks.
   size_t read_storage_tasks_max_mem_bytes;
 
+  // Maximum number of ReadStorageTasks sent to a shard during one event loop
+  // iteration that a worker groups into a single ReadBatchStorageTask.
+  // 1 disables batching.
+  size_t read_storage_task_batch_size;
+
+  // If positive, a worker shares reading between the CatchupQueues of its
+  // clients with deficit round robin: each turn a client may queue this many
+  // record bytes. 0 lets every client read whenever it has room.
+  size_t catchup_queue_drr_quantum_bytes;
+
   size_t append_stores_max_mem_bytes;
   size_t rebuilding_stores_max_mem_bytes;
 
@@ -894,6 +1094,15 @@ struct Settings : public SettingsBundle {
   // See man ioprio_set for possible values.
   folly::Optional<std::pair<int, int>> slow_ioprio;
 
+  // CPUs to restrict Worker threads to, e.g. the CPUs of the NUMA node the
+  // NIC is attached to. Empty means no restriction.
+  std::vector<int> worker_cpus;
+
+  // CPUs to restrict storage threads to, one list per shard (shard i uses
+  // list i modulo the number of lists), e.g. the CPUs of the NUMA node the
+  // shard's disk is attached to. Empty means no restriction.
+  std::vector<std::vector<int>> storage_thread_cpus;
+
   // (client-only setting) Timeout after which ClientReadStream considers a
   // storage node down if it does not send any data for some time but the socket
   // to it remains open. This can happen if:
@@ -916,6 +1125,26 @@ struct Settings : public SettingsBundle {
   // it is reasonable to keep it as high as 5min.
   std::chrono::milliseconds scd_all_send_all_timeout;
 
+  // (client-only setting) How often a reader doing single copy delivery ranks
+  // the nodes it reads from by region and window completion latency, and asks
+  // storage nodes to have each record shipped by its best ranked replica.
+  // 0 disables ranking.
+  std::chrono::milliseconds scd_replica_ranking_interval;
+
+  // Maximum number of read streams on a worker that rewind in one batch, and
+  // time between batches. 0 disables batching.
+  size_t reader_rewind_batch_size;
+  std::chrono::milliseconds reader_rewind_batch_interval;
+
+  // If true, ClientReadStream in SCD mode filters out shards of nodes that
+  // ClusterState reports dead, or that the worker's GraylistingTracker
+  // graylisted, as soon as it is told about them.
+  bool reader_health_signals_failover;
+
+  // How long AllClientReadStreams collects the above signals before passing
+  // them to all read streams.
+  std::chrono::milliseconds reader_health_signals_batch_delay;
+
   // Time interval that ConfigurationUpdatedRequest would retry sending
   // CONFIG_CHANGED messages after it got NOBUFS.
   // TODO (t13314297): this setting is not modified anywhere
@@ -954,6 +1183,13 @@ struct Settings : public SettingsBundle {
   // fetch
   std::chrono::milliseconds nodes_configuration_init_timeout;
 
+  // (client-only setting) If not empty, the nodes configuration fetched
+  // during bootstrapping is saved to this file, and the next start uses it
+  // instead of fetching one if it's younger than
+  // nodes_configuration_init_cache_max_age.
+  std::string nodes_configuration_init_cache_file;
+  std::chrono::milliseconds nodes_configuration_init_cache_max_age;
+
   // Flag indicating whether tcp keep alive should be on.
   bool use_tcp_keep_alive;
 
@@ -996,6 +1232,10 @@ struct Settings : public SettingsBundle {
   // Set to <=0 to disable collection of stats.
   std::chrono::seconds stats_collection_interval;
 
+  // If not empty, each time stats are collected a binary snapshot of them is
+  // written to this file. See StatsSnapshotFile.h.
+  std::string stats_snapshot_path;
+
   // How long should we wait before disabling isolated sequencers.
   std::chrono::seconds isolated_sequencer_ttl;
 
@@ -1003,6 +1243,11 @@ struct Settings : public SettingsBundle {
   // 32) are guaranteed to be 0.
   int esn_bits;
 
+  // When the sliding window of Appenders of an epoch is full, it may double
+  // its capacity, up to this many times maxWritesInFlight of the log, instead
+  // of rejecting appends. 1 means the window never expands.
+  size_t sequencer_window_max_growth;
+
   // Initial delay to use when downstream rejects a record or gap.
   std::chrono::milliseconds client_initial_redelivery_delay;
 
@@ -1029,6 +1274,14 @@ struct Settings : public SettingsBundle {
 
   std::chrono::milliseconds socket_batching_time_trigger;
 
+  // Flush the socket batch without waiting for
+  // socket_batching_time_trigger once it holds this many bytes (if positive).
+  size_t socket_batching_size_trigger;
+
+  // Writes to plaintext sockets of at least this many bytes are sent with
+  // MSG_ZEROCOPY (if positive).
+  size_t socket_zero_copy_threshold;
+
   // DEPRECATED! Corresponding log attribute should be used instead.
   // Sequencer batching flushes buffered appends for a log when the total
   // amount of buffered uncompressed data reaches this many bytes (if
@@ -1045,6 +1298,16 @@ struct Settings : public SettingsBundle {
   // batching and recompressing would be small.
   ssize_t sequencer_batching_passthru_threshold;
 
+  // If true, sequencer batching derives the time and size triggers of each
+  // new batch from the recent append rate of the log and the occupancy of
+  // its Appender window. The configured triggers become upper bounds.
+  bool sequencer_batching_adaptive;
+
+  // If greater than 1, the Appenders of sequencer batches of a log run on
+  // this many workers (round robin) rather than only on the worker that
+  // buffers the log.
+  size_t sequencer_batching_appender_spread;
+
   // Number of background threads.  Currently, background threads are used by
   // BufferedWriter to construct/compress large batches.  If 0 (the default),
   // use num_workers.
@@ -1079,6 +1342,15 @@ struct Settings : public SettingsBundle {
   chrono_expbackoff_t<std::chrono::milliseconds>
       rsm_snapshot_request_wave_timeout;
 
+  // Number of nodes GetRsmSnapshotRequest asks for a snapshot at the same
+  // time. The first usable reply wins.
+  size_t rsm_snapshot_request_fanout;
+
+  // Maximum number of deltas a replicated state machine groups into a single
+  // delta log record while a previous append is in flight. 1 disables
+  // batching.
+  size_t rsm_max_deltas_per_record;
+
   // Maximum duration of Sender::runFlowGroups() before yielding to the
   // event loop.
   std::chrono::microseconds flow_groups_run_yield_interval;
@@ -1104,6 +1376,10 @@ struct Settings : public SettingsBundle {
   // and use HHWheelTimer backend.
   bool enable_hh_wheel_backed_timers;
 
+  // If true, timers on workers use a timing wheel running on the worker's own
+  // event loop. Takes precedence over enable_hh_wheel_backed_timers.
+  bool enable_worker_wheel_timers;
+
   // If true, use the new version of timers which run on a different thread
   // and use HHWheelTimer backend.
   bool enable_store_histogram_calculations;
@@ -1214,6 +1490,12 @@ struct Settings : public SettingsBundle {
   // complete.
   bool use_dedicated_server_to_server_address;
 
+  // (client-only setting) Unix domain sockets, by node index, through which
+  // plain data connections go to nodes running on the same host as this
+  // client, instead of their TCP addresses. See --local-data-unix-socket on
+  // the server.
+  std::unordered_map<node_index_t, Sockaddr> local_data_unix_sockets;
+
   // If set, sequencers will not automatically run recovery upon
   // activation. Recovery can be started using the 'startrecovery' admin
   // command.  Note that last released lsn won't get advanced without
@@ -1315,6 +1597,13 @@ struct Settings : public SettingsBundle {
   // See .cpp
   std::chrono::milliseconds shadow_client_timeout;
 
+  // Fraction of logs whose appends are shadowed, see .cpp
+  double shadow_log_sample_ratio;
+
+  // Shadow appends in flight to a shadow cluster beyond which new ones are
+  // dropped
+  size_t shadow_max_in_flight_appends;
+
   // Defaults to false, should only be set by traffic shadowing framework
   bool shadow_client;
 
@@ -1351,6 +1640,10 @@ struct Settings : public SettingsBundle {
   // location given by sequencerAffinity before looking elsewhere.
   bool use_sequencer_affinity;
 
+  // (client-only setting) If true, sequencer nodes learned from redirects are
+  // shared by all workers, see SequencerPlacementCache.
+  bool client_sequencer_placement_cache;
+
   // Client only setting:
 
   // The following settings list logs for which certain operations should be
@@ -1408,6 +1701,10 @@ struct Settings : public SettingsBundle {
 
   bool allow_reads_on_workers{true};
 
+  // Time a cache-only read attempted on a worker thread may take before
+  // handing the read to a storage thread.
+  std::chrono::milliseconds max_worker_read_execution_time;
+
   std::vector<node_index_t> test_do_not_pick_in_copysets;
 
   std::unordered_set<MessageType> message_tracing_types;
@@ -1424,8 +1721,28 @@ struct Settings : public SettingsBundle {
 
   folly::Optional<std::chrono::milliseconds> findkey_timeout;
 
+  // Maximum number of requests a single Client::*Batch() call runs
+  // concurrently.
+  size_t batch_api_max_in_flight;
+
   folly::Optional<std::chrono::milliseconds> append_timeout;
 
+  // If positive, APPENDs to the same sequencer node are held for up to this
+  // long and sent together in one APPENDS_BATCH message, see AppendBatcher.
+  std::chrono::microseconds append_batching_window;
+  // APPENDs queued for a node are sent once they add up to this many bytes.
+  size_t append_batching_max_bytes;
+
+  // If positive, TRIMs to the same storage node are held for up to this long
+  // and sent together in one TRIMS_BATCH message, see TrimBatcher.
+  std::chrono::microseconds trim_batching_window;
+  // At most this many TRIMs are sent in one TRIMS_BATCH message.
+  size_t trim_batching_max_trims;
+
+  // If positive, StreamWriterAppendSink keeps up to this many appends of each
+  // stream in flight. 0 means the window grows with acks.
+  size_t stream_writer_inflight_window;
+
   folly::Optional<std::chrono::milliseconds> logsconfig_timeout;
 
   folly::Optional<std::chrono::milliseconds> meta_api_timeout;
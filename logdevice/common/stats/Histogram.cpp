@@ -32,6 +32,54 @@
 
 namespace facebook { namespace logdevice {
 
+namespace {
+
+const std::vector<HistogramUnit>* latencyUnits() {
+  static std::vector<HistogramUnit> units{{1l, "us"},
+                                          {1000l, "ms"},
+                                          {1000000l, "s"},
+                                          {60000000l, "min"},
+                                          {3600000000l, "hr"}};
+  return &units;
+}
+
+const std::vector<HistogramUnit>* sizeUnits() {
+  static std::vector<HistogramUnit> units{{1l, "B"},
+                                          {1l << 10, "KiB"},
+                                          {1l << 20, "MiB"},
+                                          {1l << 30, "GiB"},
+                                          {1l << 40, "TiB"},
+                                          {1l << 50, "PiB"}};
+  return &units;
+}
+
+const std::vector<HistogramUnit>* noUnitUnits() {
+  static std::vector<HistogramUnit> units{{1l, ""},
+                                          {1000l, "K"},
+                                          {1000000l, "M"},
+                                          {1000000000l, "B"},
+                                          {1000000000000l, "T"}};
+  return &units;
+}
+
+const HistogramUnit& pickUnit(const std::vector<HistogramUnit>* units,
+                              int64_t value) {
+  if (units == nullptr) {
+    static HistogramUnit u = {0l, ""};
+    return u;
+  }
+  ld_check(!units->empty());
+
+  // Find the biggest unit smaller than value.
+  size_t idx = units->size() - 1;
+  while (idx > 0 && (*units)[idx].unit > value) {
+    --idx;
+  }
+  return (*units)[idx];
+}
+
+} // namespace
+
 // ~30 years
 const int64_t LatencyHistogram::USEC_MAX = 1000l * 1000 * 1000 * 1000 * 1000;
 // 1 PiB
@@ -871,18 +919,7 @@ std::string CompactHistogram::getUnitName() const {
 }
 
 const CompactHistogram::Unit& CompactHistogram::pickUnit(int64_t value) const {
-  if (units_ == nullptr) {
-    static Unit u = {0l, ""};
-    return u;
-  }
-  ld_check(!units_->empty());
-
-  // Find the biggest unit smaller than value.
-  size_t idx = units_->size() - 1;
-  while (idx > 0 && (*units_)[idx].unit > value) {
-    --idx;
-  }
-  return (*units_)[idx];
+  return facebook::logdevice::pickUnit(units_, value);
 }
 
 std::string CompactHistogram::valueToString(int64_t value) const {
@@ -956,35 +993,277 @@ CompactHistogram& CompactHistogram::operator=(const CompactHistogram& rhs) {
 
 CompactLatencyHistogram::CompactLatencyHistogram(
     folly::Optional<PublishRange> publish_range)
-    : CompactHistogram(
-          [] {
-            static std::vector<Unit> units{{1l, "us"},
-                                           {1000l, "ms"},
-                                           {1000000l, "s"},
-                                           {60000000l, "min"},
-                                           {3600000000l, "hr"}};
-            return &units;
-          }(),
-          std::move(publish_range)) {}
+    : CompactHistogram(latencyUnits(), std::move(publish_range)) {}
 
 CompactSizeHistogram::CompactSizeHistogram()
-    : CompactHistogram([] {
-        static std::vector<Unit> units{{1l, "B"},
-                                       {1l << 10, "KiB"},
-                                       {1l << 20, "MiB"},
-                                       {1l << 30, "GiB"},
-                                       {1l << 40, "TiB"},
-                                       {1l << 50, "PiB"}};
-        return &units;
-      }()) {}
+    : CompactHistogram(sizeUnits()) {}
 
 CompactNoUnitHistogram::CompactNoUnitHistogram()
-    : CompactHistogram([] {
-        static std::vector<Unit> units{{1l, ""},
-                                       {1000l, "K"},
-                                       {1000000l, "M"},
-                                       {1000000000l, "B"},
-                                       {1000000000000l, "T"}};
-        return &units;
-      }()) {}
+    : CompactHistogram(noUnitUnits()) {}
+
+size_t LogLinearHistogram::valueToIndex(int64_t value) {
+  if (value < static_cast<int64_t>(kSubBuckets)) {
+    return value <= 0 ? 0 : value;
+  }
+  // Values [2^msb, 2^(msb+1)) are split into kSubBuckets buckets of width
+  // 2^shift; the bits below the top kSubBucketBits + 1 are dropped.
+  const uint64_t v = static_cast<uint64_t>(value);
+  const size_t msb = folly::findLastSet(v) - 1;
+  const size_t shift = msb - kSubBucketBits;
+  return (shift + 1) * kSubBuckets + ((v >> shift) & (kSubBuckets - 1));
+}
+
+int64_t LogLinearHistogram::bucketMin(size_t idx) {
+  ld_check_lt(idx, kNumBuckets);
+  if (idx < kSubBuckets) {
+    return idx;
+  }
+  return static_cast<int64_t>(kSubBuckets + idx % kSubBuckets)
+      << (idx / kSubBuckets - 1);
+}
+
+int64_t LogLinearHistogram::bucketWidth(size_t idx) {
+  ld_check_lt(idx, kNumBuckets);
+  return idx < kSubBuckets ? 1 : 1l << (idx / kSubBuckets - 1);
+}
+
+void LogLinearHistogram::Snapshot::merge(const Snapshot& other) {
+  // Plain loop over two arrays, vectorized by the compiler.
+  for (size_t i = 0; i < kNumBuckets; ++i) {
+    buckets[i] += other.buckets[i];
+  }
+}
+
+void LogLinearHistogram::Snapshot::estimatePercentiles(
+    const double* percentiles,
+    size_t npercentiles,
+    int64_t* samples_out,
+    uint64_t* count_out,
+    int64_t* sum_out) const {
+  uint64_t count = 0;
+  int64_t sum = 0;
+  for (size_t i = 0; i < kNumBuckets; ++i) {
+    const uint64_t x = buckets[i];
+    count += x;
+    // Don't care that much about overflowing sum because it's exported as is.
+    if (i > 0) {
+      sum += static_cast<int64_t>(x) * (bucketMin(i) + bucketWidth(i) / 2);
+    }
+  }
+  if (count_out) {
+    *count_out = count;
+  }
+  if (sum_out) {
+    *sum_out = sum;
+  }
+
+  if (npercentiles == 0) {
+    return;
+  }
+
+  ld_check(samples_out != nullptr);
+  ld_check(std::is_sorted(percentiles, percentiles + npercentiles));
+  ld_check(std::all_of(percentiles, percentiles + npercentiles, [](double p) {
+    return p >= 0.0 && p <= 1.0;
+  }));
+
+  if (count == 0) {
+    std::fill(samples_out, samples_out + npercentiles, 0l);
+    return;
+  }
+
+  // All percentiles are found in a single pass over the buckets.
+  size_t idx = 0;    // index in percentiles
+  uint64_t seen = 0; // count in buckets seen so far
+  for (size_t i = 0; i < kNumBuckets && idx < npercentiles; ++i) {
+    const uint64_t x = buckets[i];
+    if (x == 0) {
+      continue;
+    }
+    const uint64_t next = seen + x;
+    while (idx < npercentiles &&
+           (percentiles[idx] * count <= next || next == count)) {
+      if (i == 0) {
+        samples_out[idx] = 0;
+      } else {
+        // Linearly interpolate inside the bucket.
+        double p = std::max(0.0, (percentiles[idx] * count - seen) / x);
+        samples_out[idx] = bucketMin(i) +
+            static_cast<int64_t>(std::min(p, 1.0) * (bucketWidth(i) - 1) + .5);
+      }
+      ++idx;
+    }
+    seen = next;
+  }
+
+  ld_check(idx == npercentiles);
+}
+
+std::string LogLinearHistogram::Snapshot::serialize() const {
+  std::string s(kNumBuckets * sizeof(uint64_t), '\0');
+  for (size_t i = 0; i < kNumBuckets; ++i) {
+    uint64_t x = folly::Endian::little(buckets[i]);
+    std::memcpy(&s[i * sizeof(uint64_t)], &x, sizeof(uint64_t));
+  }
+  return s;
+}
+
+bool LogLinearHistogram::Snapshot::deserialize(folly::StringPiece s) {
+  if (s.size() != kNumBuckets * sizeof(uint64_t)) {
+    return false;
+  }
+  for (size_t i = 0; i < kNumBuckets; ++i) {
+    uint64_t x;
+    std::memcpy(&x, s.data() + i * sizeof(uint64_t), sizeof(uint64_t));
+    buckets[i] = folly::Endian::little(x);
+  }
+  return true;
+}
+
+LogLinearHistogram::LogLinearHistogram(
+    const std::vector<HistogramUnit>* units)
+    : units_(units) {}
+
+LogLinearHistogram::LogLinearHistogram(const LogLinearHistogram& rhs)
+    : units_(rhs.units_) {
+  assign(rhs);
+}
+
+LogLinearHistogram& LogLinearHistogram::
+operator=(const LogLinearHistogram& rhs) {
+  assign(rhs);
+  return *this;
+}
+
+void LogLinearHistogram::add(int64_t value) {
+  buckets_[valueToIndex(value)].fetch_add(1, std::memory_order_relaxed);
+}
+
+void LogLinearHistogram::clear() {
+  for (auto& b : buckets_) {
+    b.store(0, std::memory_order_relaxed);
+  }
+}
+
+void LogLinearHistogram::assign(const HistogramInterface& other_if) {
+  auto& other = checked_cref_cast<LogLinearHistogram>(other_if);
+  ld_check(units_ == other.units_);
+  assign(other.snapshot());
+}
+
+void LogLinearHistogram::merge(const HistogramInterface& other_if) {
+  auto& other = checked_cref_cast<LogLinearHistogram>(other_if);
+  ld_check(units_ == other.units_);
+  merge(other.snapshot());
+}
+
+void LogLinearHistogram::subtract(const HistogramInterface& other_if) {
+  auto& other = checked_cref_cast<LogLinearHistogram>(other_if);
+  ld_check(units_ == other.units_);
+
+  for (size_t i = 0; i < kNumBuckets; ++i) {
+    uint64_t x = other.buckets_[i].load(std::memory_order_relaxed);
+    uint64_t prev = buckets_[i].fetch_sub(x, std::memory_order_relaxed);
+    if (!dd_assert(x <= prev,
+                   "Histogram subtraction overflowed. Bucket %lu, this: %lu, "
+                   "right operand: %lu",
+                   i,
+                   prev,
+                   x)) {
+      buckets_[i].store(0, std::memory_order_relaxed);
+    }
+  }
+}
+
+LogLinearHistogram::Snapshot LogLinearHistogram::snapshot() const {
+  Snapshot s;
+  for (size_t i = 0; i < kNumBuckets; ++i) {
+    s.buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+  }
+  return s;
+}
+
+void LogLinearHistogram::assign(const Snapshot& snapshot) {
+  for (size_t i = 0; i < kNumBuckets; ++i) {
+    buckets_[i].store(snapshot.buckets[i], std::memory_order_relaxed);
+  }
+}
+
+void LogLinearHistogram::merge(const Snapshot& snapshot) {
+  for (size_t i = 0; i < kNumBuckets; ++i) {
+    if (snapshot.buckets[i] != 0) {
+      buckets_[i].fetch_add(snapshot.buckets[i], std::memory_order_relaxed);
+    }
+  }
+}
+
+void LogLinearHistogram::estimatePercentiles(const double* percentiles,
+                                             size_t npercentiles,
+                                             int64_t* samples_out,
+                                             uint64_t* count_out,
+                                             int64_t* sum_out) const {
+  // Work on a copy, to avoid race conditions when other threads change values
+  // while we're here.
+  snapshot().estimatePercentiles(
+      percentiles, npercentiles, samples_out, count_out, sum_out);
+}
+
+void LogLinearHistogram::print(std::ostream& out) const {
+  std::array<double, 4> pct = {.5, .75, .95, .99};
+
+  const Snapshot s = snapshot();
+  uint64_t count = 0;
+  for (uint64_t x : s.buckets) {
+    count += x;
+  }
+
+  size_t idx = 0;    // in `pct`
+  uint64_t seen = 0; // count in buckets seen so far
+  for (size_t i = 0; i < kNumBuckets; ++i) {
+    uint64_t x = s.buckets[i];
+    if (x == 0) {
+      continue;
+    }
+
+    int64_t min = i ? bucketMin(i) : 0;
+    // As double, because the end of the last bucket doesn't fit in int64_t.
+    double max = i ? min + static_cast<double>(bucketWidth(i)) : 0;
+    uint64_t next = seen + x;
+
+    const HistogramUnit& u = pickUnit(units_, min);
+    std::string label = folly::sformat(
+        "{:.3f}..{:.3f}{}", 1. * min / u.unit, max / u.unit, u.name);
+
+    std::string pct_str;
+    while (idx < pct.size() && (pct[idx] * count <= next || next == count)) {
+      pct_str += folly::sformat(" p{}", static_cast<int>(pct[idx] * 100 + .5));
+      ++idx;
+    }
+
+    out << std::setw(20) << std::right << label << std::setw(1) << " : "
+        << std::setw(10) << std::left << x << std::setw(1) << pct_str
+        << std::endl;
+
+    seen = next;
+  }
+}
+
+std::string LogLinearHistogram::getUnitName() const {
+  return units_ ? units_->at(0).name : "";
+}
+
+std::string LogLinearHistogram::valueToString(int64_t value) const {
+  const HistogramUnit& u = pickUnit(units_, value);
+  return folly::sformat("{:.3f}{}", 1. * value / u.unit, u.name);
+}
+
+LogLinearLatencyHistogram::LogLinearLatencyHistogram()
+    : LogLinearHistogram(latencyUnits()) {}
+
+LogLinearSizeHistogram::LogLinearSizeHistogram()
+    : LogLinearHistogram(sizeUnits()) {}
+
+LogLinearNoUnitHistogram::LogLinearNoUnitHistogram()
+    : LogLinearHistogram(noUnitUnits()) {}
+
 }} // namespace facebook::logdevice
@@ -7,6 +7,7 @@
  */
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <cstdint>
 #include <iosfwd>
@@ -32,8 +33,9 @@ namespace facebook { namespace logdevice {
  *
  * HistogramInterface is a common interface for the histograms, allowing to
  * add values, merge/subtract histograms and get percentiles.
- * Two implementations of this interface are MultiScaleHistogram and
- * CompactHistogram; those define how the histogram actually works.
+ * Three implementations of this interface are MultiScaleHistogram,
+ * CompactHistogram and LogLinearHistogram; those define how the histogram
+ * actually works.
  *
  * MultiScaleHistogram is an older, fancier and heavyweight implementation
  * with round bucket boundaries and more precise percentiles.
@@ -43,7 +45,11 @@ namespace facebook { namespace logdevice {
  * fewer buckets. Main caveat is that it's sometimes not responsive to small
  * changes in values, see comment starting with "IMPORTANT" below.
  *
- * Each of the two implementations has multiple subclasses for different units
+ * LogLinearHistogram is an HDR-style histogram with a fixed layout of
+ * contiguous counters. It's cheap to merge and serialize, which makes it
+ * suitable for histograms aggregated over many threads or shards.
+ *
+ * Each of the implementations has multiple subclasses for different units
  * of measurement. They define how the histograms are presented
  * (e.g. "1h" instead of "3600000000") and, for MultiScaleHistogram, what
  * the block boundaries are.
@@ -424,6 +430,13 @@ class NoUnitHistogram final : public MultiScaleHistogram {
 //  - less precision: 3x fewer buckets
 //  - bucket boundaries are not round (unless powers of two are considered
 //    round, e.g. for sizes in KiB/MiB/etc)
+// Unit of measurement used to print the values of a histogram.
+struct HistogramUnit {
+  // What value constitutes one of this unit. E.g. 1<<20 for "MiB".
+  int64_t unit;
+  const char* name;
+};
+
 class CompactHistogram : public HistogramInterface {
  public:
   CompactHistogram() = default;
@@ -465,11 +478,7 @@ class CompactHistogram : public HistogramInterface {
   CumulativeFrequencyCounters getCumulativeFrequencyCounters() const override;
 
  protected:
-  struct Unit {
-    // What value constitutes one of this unit. E.g. 1<<20 for "MiB".
-    int64_t unit;
-    const char* name;
-  };
+  using Unit = HistogramUnit;
 
   explicit CompactHistogram(
       const std::vector<Unit>* units,
@@ -502,4 +511,104 @@ class CompactNoUnitHistogram : public CompactHistogram {
   CompactNoUnitHistogram();
 };
 
+// HDR-style histogram: each range of values [2^k, 2^(k+1)) is split into
+// kSubBuckets equal buckets, so that any value is known with a relative error
+// of at most 1/kSubBuckets. Values [0, kSubBuckets) have a bucket each, values
+// <= 0 all go to bucket 0. The whole int64_t range fits in kNumBuckets
+// counters (~4 KB), laid out in a contiguous array.
+//
+// Thread safety is the same as for CompactHistogram.
+//
+// Compared to CompactHistogram: 8x more buckets and an 8x smaller error.
+// Compared to MultiScaleHistogram: no per-bucket sums, but smaller, no heap
+// allocations or mutexes, and cheap to merge.
+//
+// To aggregate many histograms, merge their Snapshots rather than the
+// histograms themselves. Snapshot is a plain array of counters, so merging
+// two of them is an element-wise add that the compiler vectorizes, while
+// merging into a LogLinearHistogram needs an atomic add per bucket.
+// Snapshot::serialize() is the counters as they are in memory, which can be
+// exported as is.
+class LogLinearHistogram : public HistogramInterface {
+ public:
+  static constexpr size_t kSubBucketBits = 3;
+  static constexpr size_t kSubBuckets = 1ul << kSubBucketBits;
+  static constexpr size_t kNumBuckets = (64 - kSubBucketBits) * kSubBuckets;
+
+  // A copy of the counters of a histogram.
+  struct Snapshot {
+    std::array<uint64_t, kNumBuckets> buckets{};
+
+    void merge(const Snapshot& other);
+
+    // Same as HistogramInterface::estimatePercentiles().
+    void estimatePercentiles(const double* percentiles,
+                             size_t npercentiles,
+                             int64_t* samples_out,
+                             uint64_t* count_out = nullptr,
+                             int64_t* sum_out = nullptr) const;
+
+    // kNumBuckets little endian 64-bit counters.
+    std::string serialize() const;
+
+    // Parses the output of serialize(). Returns false if `s` has the wrong
+    // size.
+    bool deserialize(folly::StringPiece s);
+  };
+
+  LogLinearHistogram() = default;
+
+  // Must be the same subclass.
+  LogLinearHistogram(const LogLinearHistogram& rhs);
+  LogLinearHistogram& operator=(const LogLinearHistogram& rhs);
+
+  void add(int64_t value) override;
+  void clear() override;
+  void assign(const HistogramInterface& other) override;
+  void merge(const HistogramInterface& other) override;
+  void subtract(const HistogramInterface& other) override;
+  void estimatePercentiles(const double* percentiles,
+                           size_t npercentiles,
+                           int64_t* samples_out,
+                           uint64_t* count_out = nullptr,
+                           int64_t* sum_out = nullptr) const override;
+  void print(std::ostream& out) const override;
+
+  std::string getUnitName() const override;
+  std::string valueToString(int64_t value) const override;
+
+  Snapshot snapshot() const;
+  void assign(const Snapshot& snapshot);
+  void merge(const Snapshot& snapshot);
+
+  // Index of the bucket `value` falls into.
+  static size_t valueToIndex(int64_t value);
+  // Bucket `idx` contains values [bucketMin(idx), bucketMin(idx) +
+  // bucketWidth(idx)), or values <= 0 for bucket 0.
+  static int64_t bucketMin(size_t idx);
+  static int64_t bucketWidth(size_t idx);
+
+ protected:
+  explicit LogLinearHistogram(const std::vector<HistogramUnit>* units);
+
+ private:
+  std::array<std::atomic<uint64_t>, kNumBuckets> buckets_{};
+  const std::vector<HistogramUnit>* units_ = nullptr;
+};
+
+class LogLinearLatencyHistogram : public LogLinearHistogram {
+ public:
+  LogLinearLatencyHistogram();
+};
+
+class LogLinearSizeHistogram : public LogLinearHistogram {
+ public:
+  LogLinearSizeHistogram();
+};
+
+class LogLinearNoUnitHistogram : public LogLinearHistogram {
+ public:
+  LogLinearNoUnitHistogram();
+};
+
 }} // namespace facebook::logdevice
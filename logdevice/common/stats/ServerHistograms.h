@@ -24,6 +24,7 @@ struct ServerHistograms : public HistogramBundle {
   HistogramBundle::MapType getMap() override {
     return {
         {"append_latency", &append_latency},
+        {"appender_buffer_wait_latency", &appender_buffer_wait_latency},
         {"store_bw_wait_latency", &store_bw_wait_latency},
         {"write_to_read_latency", &write_to_read_latency},
         {"store_timeouts", &store_timeouts},
@@ -40,6 +41,7 @@ struct ServerHistograms : public HistogramBundle {
         {"log_recovery_cleaning_latency", &log_recovery_cleaning},
         {"log_recovery_epoch_recovery_latency", &log_recovery_epoch},
         {"log_recovery_epoch_recovery_restarts", &log_recovery_epoch_restarts},
+        {"log_recovery_latency", &log_recovery},
         {"flow_groups_run_event_loop_delay", &flow_groups_run_event_loop_delay},
         {"flow_groups_run_event_loop_delay_rt",
          &flow_groups_run_event_loop_delay_rt},
@@ -71,6 +73,10 @@ struct ServerHistograms : public HistogramBundle {
   // Latency of appends as seen by the sequencer
   LatencyHistogram append_latency;
 
+  // How long Appenders waited in AppenderBuffer, e.g. for the sequencer to
+  // activate, before being started or failed.
+  LatencyHistogram appender_buffer_wait_latency;
+
   LatencyHistogram write_to_read_latency;
 
   LatencyHistogram store_bw_wait_latency;
@@ -116,6 +122,10 @@ struct ServerHistograms : public HistogramBundle {
   // number of restarts in epoch recovery
   NoUnitHistogram log_recovery_epoch_restarts;
 
+  // Time from creating a LogRecoveryRequest to its successful completion,
+  // including the time spent in the worker's recovery queue.
+  CompactLatencyHistogram log_recovery;
+
   // Time between when we trigger the flow_groups_run_requested libevent event,
   // and when it actually runs.
   LatencyHistogram flow_groups_run_event_loop_delay;
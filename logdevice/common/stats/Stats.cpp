@@ -18,6 +18,7 @@
 #include <folly/stats/BucketedTimeSeries.h>
 #include <folly/stats/MultiLevelTimeSeries.h>
 
+#include "logdevice/common/MemoryArenas.h"
 #include "logdevice/common/stats/ClientHistograms.h"
 #include "logdevice/common/stats/Histogram.h"
 #include "logdevice/common/stats/PerMonitoringTagHistograms.h"
@@ -523,6 +524,27 @@ void Stats::aggregateCompoundStats(Stats const& other,
   }
 }
 
+PerLogStats& Stats::perLogStats(folly::StringPiece log_name) {
+  auto it = per_log_stats_cache_.find(log_name);
+  if (it != per_log_stats_cache_.end()) {
+    if (!it->second->detached.load(std::memory_order_relaxed)) {
+      return *it->second;
+    }
+    // reset() removed the entry from per_log_stats.
+    per_log_stats_cache_.erase(it);
+  }
+
+  auto log_stats = per_log_stats.withWLock([&](auto& map) {
+    auto& ptr = map[log_name.str()];
+    if (ptr == nullptr) {
+      ptr = std::make_shared<PerLogStats>();
+    }
+    return ptr;
+  });
+  per_log_stats_cache_.emplace(log_name.str(), log_stats);
+  return *log_stats;
+}
+
 void Stats::reset() {
 #define RESETTING_STATS
   switch (params->get()->stats_set) {
@@ -576,7 +598,13 @@ void Stats::reset() {
 
       per_worker_stats.wlock()->clear();
 
-      per_log_stats.wlock()->clear();
+      per_log_stats.withWLock([](auto& map) {
+        // Make the owning thread drop them from per_log_stats_cache_.
+        for (auto& kv : map) {
+          kv.second->detached.store(true, std::memory_order_relaxed);
+        }
+        map.clear();
+      });
       break;
     case StatsParams::StatsSet::LDBENCH_WORKER:
 #define STAT_DEFINE(name, _) ldbench->name = {};
@@ -937,6 +965,15 @@ void Stats::deriveStats() {
       s.unhealthy_shards = s.iterator_errors || s.shard_missing_all_data ||
           s.failed_safe_log_stores || s.failing_log_stores;
     }
+
+    if (MemoryArenas::enabled()) {
+      memory_arena_appenders_allocated =
+          MemoryArenas::allocatedBytes(MemoryArena::APPENDERS);
+      memory_arena_messages_allocated =
+          MemoryArenas::allocatedBytes(MemoryArena::MESSAGES);
+      memory_arena_rocksdb_block_cache_allocated =
+          MemoryArenas::allocatedBytes(MemoryArena::ROCKSDB_BLOCK_CACHE);
+    }
   }
 }
 
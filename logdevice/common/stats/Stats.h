@@ -8,6 +8,7 @@
 #pragma once
 
 #include <array>
+#include <atomic>
 #include <chrono>
 #include <cstdint>
 #include <map>
@@ -19,6 +20,7 @@
 
 #include <folly/Conv.h>
 #include <folly/Optional.h>
+#include <folly/Range.h>
 #include <folly/Synchronized.h>
 #include <folly/ThreadLocal.h>
 #include <folly/container/F14Map.h>
@@ -150,6 +152,9 @@ struct PerLogStats {
   // Mutex almost exclusively locked by one thread since PerLogStats objects
   // are contained in thread-local stats
   std::mutex mutex;
+  // Set when the object is removed from Stats::per_log_stats, see
+  // Stats::perLogStats().
+  std::atomic<bool> detached{false};
 };
 
 struct PerTrafficClassStats {
@@ -695,6 +700,19 @@ struct Stats final {
       std::unordered_map<std::string, std::shared_ptr<PerLogStats>>>
       per_log_stats;
 
+  /**
+   * Returns the stats of the log group, creating them if needed. Must only be
+   * called by the thread these thread-local Stats belong to. Entries that
+   * thread already used are found in per_log_stats_cache_, without locking
+   * per_log_stats.
+   */
+  PerLogStats& perLogStats(folly::StringPiece log_name);
+
+  // Entries of per_log_stats used by the thread these Stats belong to. Only
+  // accessed by that thread.
+  folly::F14FastMap<std::string, std::shared_ptr<PerLogStats>>
+      per_log_stats_cache_;
+
   // Server histograms. Initialized only on servers.
   std::unique_ptr<ServerHistograms> server_histograms;
 
@@ -1073,90 +1091,38 @@ class PerShardStatToken {
     }                                     \
   } while (0)
 
-#define LOG_GROUP_STAT_ADD(stats_struct, log_name, name, val)            \
-  do {                                                                   \
-    if (stats_struct) {                                                  \
-      auto stats_ulock = (stats_struct)->get().per_log_stats.ulock();    \
-      auto stats_it = stats_ulock->find((log_name));                     \
-      if (stats_it != stats_ulock->end()) {                              \
-        /* PerLogStats for log_name already exist (common case). */      \
-        /* Just atomically increment the value.  */                      \
-        stats_it->second->name += (val);                                 \
-      } else {                                                           \
-        /* PerLogStats for log_name do not exist yet (rare case). */     \
-        /* Upgrade ulock to wlock and emplace new PerLogStats. */        \
-        /* No risk of deadlock because we are the only writer thread. */ \
-        auto stats_ptr = std::make_shared<PerLogStats>();                \
-        stats_ptr->name += (val);                                        \
-        stats_ulock.moveFromUpgradeToWrite()->emplace_hint(              \
-            stats_it, (log_name), std::move(stats_ptr));                 \
-      }                                                                  \
-    }                                                                    \
+#define LOG_GROUP_STAT_ADD(stats_struct, log_name, name, val)      \
+  do {                                                             \
+    if (stats_struct) {                                            \
+      (stats_struct)->get().perLogStats((log_name)).name += (val); \
+    }                                                              \
   } while (0)
 
-#define LOG_GROUP_TIME_SERIES_ADD(stats_struct, stat_name, log_name, val)      \
-  do {                                                                         \
-    if (stats_struct) {                                                        \
-      auto stats_ulock = (stats_struct)->get().per_log_stats.ulock();          \
-      /* Unfortunately, the type of the lock after a downgrade from write to   \
-       * upgrade isn't the same as the type of upgrade lock initially acquired \
-       */                                                                      \
-      folly::LockedPtr<decltype(stats_ulock)::Synchronized,                    \
-                       folly::LockPolicyFromExclusiveToUpgrade>                \
-          stats_downgraded_ulock;                                              \
-      auto stats_it = stats_ulock->find((log_name));                           \
-      if (UNLIKELY(stats_it == stats_ulock->end())) {                          \
-        /* PerLogStats for log_name do not exist yet (rare case). */           \
-        /* Upgrade ulock to wlock and emplace new PerLogStats. */              \
-        /* No risk of deadlock because we are the only writer thread. */       \
-        auto stats_ptr = std::make_shared<PerLogStats>();                      \
-        auto stats_wlock = stats_ulock.moveFromUpgradeToWrite();               \
-        stats_it =                                                             \
-            stats_wlock->emplace((log_name), std::move(stats_ptr)).first;      \
-        stats_downgraded_ulock = stats_wlock.moveFromWriteToUpgrade();         \
-      }                                                                        \
-      {                                                                        \
-        std::lock_guard<std::mutex> guard(stats_it->second->mutex);            \
-        if (UNLIKELY(!stats_it->second->stat_name)) {                          \
-          stats_it->second->stat_name = std::make_shared<PerLogTimeSeries>(    \
-              (stats_struct)->params_.get()->num_buckets_##stat_name,          \
-              (stats_struct)->params_.get()->time_intervals_##stat_name);      \
-        }                                                                      \
-        stats_it->second->stat_name->addValue(val);                            \
-      }                                                                        \
-    }                                                                          \
+#define LOG_GROUP_TIME_SERIES_ADD(stats_struct, stat_name, log_name, val)     \
+  do {                                                                        \
+    if (stats_struct) {                                                       \
+      PerLogStats& log_stats = (stats_struct)->get().perLogStats((log_name)); \
+      std::lock_guard<std::mutex> guard(log_stats.mutex);                     \
+      if (UNLIKELY(!log_stats.stat_name)) {                                   \
+        log_stats.stat_name = std::make_shared<PerLogTimeSeries>(             \
+            (stats_struct)->params_.get()->num_buckets_##stat_name,           \
+            (stats_struct)->params_.get()->time_intervals_##stat_name);       \
+      }                                                                       \
+      log_stats.stat_name->addValue(val);                                     \
+    }                                                                         \
   } while (0)
 
-#define LOG_GROUP_CUSTOM_COUNTERS_ADD(stats_struct, log_name, val)             \
-  do {                                                                         \
-    if (stats_struct) {                                                        \
-      auto stats_ulock = (stats_struct)->get().per_log_stats.ulock();          \
-      /* Unfortunately, the type of the lock after a downgrade from write to   \
-       * upgrade isn't the same as the type of upgrade lock initially acquired \
-       */                                                                      \
-      folly::LockedPtr<decltype(stats_ulock)::Synchronized,                    \
-                       folly::LockPolicyFromExclusiveToUpgrade>                \
-          stats_downgraded_ulock;                                              \
-      auto stats_it = stats_ulock->find((log_name));                           \
-      if (UNLIKELY(stats_it == stats_ulock->end())) {                          \
-        /* PerLogStats for log_name do not exist yet (rare case). */           \
-        /* Upgrade ulock to wlock and emplace new PerLogStats. */              \
-        /* No risk of deadlock because we are the only writer thread. */       \
-        auto stats_ptr = std::make_shared<PerLogStats>();                      \
-        auto stats_wlock = stats_ulock.moveFromUpgradeToWrite();               \
-        stats_it =                                                             \
-            stats_wlock->emplace((log_name), std::move(stats_ptr)).first;      \
-        stats_downgraded_ulock = stats_wlock.moveFromWriteToUpgrade();         \
-      }                                                                        \
-      {                                                                        \
-        std::lock_guard<std::mutex> guard(stats_it->second->mutex);            \
-        if (UNLIKELY(!stats_it->second->custom_counters)) {                    \
-          stats_it->second->custom_counters =                                  \
-              std::make_shared<CustomCountersTimeSeries>();                    \
-        }                                                                      \
-        stats_it->second->custom_counters->addCustomCounters(val);             \
-      }                                                                        \
-    }                                                                          \
+#define LOG_GROUP_CUSTOM_COUNTERS_ADD(stats_struct, log_name, val)            \
+  do {                                                                        \
+    if (stats_struct) {                                                       \
+      PerLogStats& log_stats = (stats_struct)->get().perLogStats((log_name)); \
+      std::lock_guard<std::mutex> guard(log_stats.mutex);                     \
+      if (UNLIKELY(!log_stats.custom_counters)) {                             \
+        log_stats.custom_counters =                                           \
+            std::make_shared<CustomCountersTimeSeries>();                     \
+      }                                                                       \
+      log_stats.custom_counters->addCustomCounters(val);                      \
+    }                                                                         \
   } while (0)
 
 #define TRAFFIC_CLASS_STAT_ADD(stats_struct, traffic_class, name, val) \
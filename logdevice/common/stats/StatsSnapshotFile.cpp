@@ -0,0 +1,246 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/stats/StatsSnapshotFile.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include <folly/Conv.h>
+#include <folly/ExceptionString.h>
+#include <folly/FileUtil.h>
+#include <folly/lang/Bits.h>
+
+#include "logdevice/common/PriorityMap.h"
+#include "logdevice/common/debug.h"
+#include "logdevice/common/protocol/MessageTypeNames.h"
+#include "logdevice/common/stats/Stats.h"
+
+namespace facebook { namespace logdevice {
+
+namespace {
+
+constexpr char kMagic[4] = {'L', 'D', 'S', 'T'};
+
+// Names counters the same way as the "stats" admin command.
+class CountersCollector : public Stats::EnumerationCallbacks {
+ public:
+  CountersCollector(StatsSnapshot::Counters* out, bool include_log_groups)
+      : out_(out), include_log_groups_(include_log_groups) {}
+
+  void stat(const std::string& name, int64_t val) override {
+    out_->emplace_back(name, val);
+  }
+  void stat(const std::string& name, MessageType msg, int64_t val) override {
+    add(name, messageTypeNames()[msg], val);
+  }
+  void stat(const std::string& name,
+            shard_index_t shard,
+            int64_t val) override {
+    add(name, folly::to<std::string>("shard", shard), val);
+  }
+  void stat(const std::string& name, TrafficClass tc, int64_t val) override {
+    add(name, trafficClasses()[tc], val);
+  }
+  void statWithTag(const std::string& name,
+                   const std::string& tag,
+                   int64_t val) override {
+    add(name, tag, val);
+  }
+  void stat(const std::string& name,
+            NodeLocationScope flow_group,
+            int64_t val) override {
+    add(name, NodeLocation::scopeNames()[flow_group], val);
+  }
+  void stat(const std::string& name,
+            NodeLocationScope flow_group,
+            Priority pri,
+            int64_t val) override {
+    out_->emplace_back(folly::to<std::string>(
+                           name,
+                           ".",
+                           NodeLocation::scopeNames()[flow_group],
+                           ".",
+                           PriorityMap::toName()[pri]),
+                       val);
+  }
+  void stat(const std::string& name, Priority pri, int64_t val) override {
+    add(name, PriorityMap::toName()[pri], val);
+  }
+  void stat(const std::string& name, RequestType rq, int64_t val) override {
+    add(name, requestTypeNames[rq], val);
+  }
+  void stat(const std::string& name,
+            StorageTaskType type,
+            int64_t val) override {
+    add(name, storageTaskTypeNames[type], val);
+  }
+  void stat(const std::string& name,
+            worker_id_t worker_id,
+            uint64_t load) override {
+    out_->emplace_back(
+        folly::to<std::string>(name, "_", worker_id.val()), load);
+  }
+  void stat(const char* name,
+            const std::string& log_group,
+            int64_t val) override {
+    if (!include_log_groups_) {
+      return;
+    }
+    std::string key = log_group;
+    std::replace(key.begin(), key.end(), ' ', '_');
+    add(key, name, val);
+  }
+  void histogram(const std::string& /*name*/,
+                 const HistogramInterface& /*hist*/) override {}
+  void histogram(const std::string& /*name*/,
+                 shard_index_t /*shard*/,
+                 const HistogramInterface& /*hist*/) override {}
+  void histogramWithTag(const std::string& /*name*/,
+                        const std::string& /*tag*/,
+                        const HistogramInterface& /*hist*/) override {}
+
+ private:
+  void add(const std::string& name, folly::StringPiece suffix, int64_t val) {
+    out_->emplace_back(folly::to<std::string>(name, ".", suffix), val);
+  }
+
+  StatsSnapshot::Counters* out_;
+  bool include_log_groups_;
+};
+
+template <typename T>
+void append(std::string& out, T x) {
+  x = folly::Endian::little(x);
+  out.append(reinterpret_cast<const char*>(&x), sizeof(x));
+}
+
+template <typename T>
+bool consume(folly::StringPiece& in, T* x) {
+  if (in.size() < sizeof(T)) {
+    return false;
+  }
+  std::memcpy(x, in.data(), sizeof(T));
+  *x = folly::Endian::little(*x);
+  in.advance(sizeof(T));
+  return true;
+}
+
+} // namespace
+
+StatsSnapshot
+StatsSnapshot::create(const std::vector<const Stats*>& stats_sets,
+                      bool include_log_groups) {
+  StatsSnapshot snapshot;
+  snapshot.timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::system_clock::now().time_since_epoch());
+  for (const Stats* stats : stats_sets) {
+    snapshot.stats_sets.emplace_back();
+    CountersCollector collector(&snapshot.stats_sets.back(),
+                                include_log_groups);
+    stats->enumerate(&collector);
+  }
+  return snapshot;
+}
+
+std::string StatsSnapshot::serialize() const {
+  std::string out(kMagic, sizeof(kMagic));
+  append<uint32_t>(out, VERSION);
+  append<uint64_t>(out, timestamp.count());
+  append<uint32_t>(out, stats_sets.size());
+  for (const Counters& counters : stats_sets) {
+    append<uint32_t>(out, counters.size());
+    for (const auto& kv : counters) {
+      const size_t len = std::min<size_t>(
+          kv.first.size(), std::numeric_limits<uint16_t>::max());
+      append<uint16_t>(out, len);
+      out.append(kv.first.data(), len);
+      append<int64_t>(out, kv.second);
+    }
+  }
+  return out;
+}
+
+bool StatsSnapshot::deserialize(folly::StringPiece data) {
+  if (!data.startsWith(folly::StringPiece(kMagic, sizeof(kMagic)))) {
+    return false;
+  }
+  data.advance(sizeof(kMagic));
+
+  uint32_t version;
+  uint64_t ts;
+  uint32_t num_sets;
+  if (!consume(data, &version) || version != VERSION ||
+      !consume(data, &ts) || !consume(data, &num_sets)) {
+    return false;
+  }
+  timestamp = std::chrono::milliseconds(ts);
+  stats_sets.clear();
+  for (uint32_t i = 0; i < num_sets; ++i) {
+    uint32_t num_counters;
+    if (!consume(data, &num_counters)) {
+      return false;
+    }
+    stats_sets.emplace_back();
+    for (uint32_t j = 0; j < num_counters; ++j) {
+      uint16_t len;
+      int64_t val;
+      if (!consume(data, &len) || data.size() < len) {
+        return false;
+      }
+      std::string name(data.data(), len);
+      data.advance(len);
+      if (!consume(data, &val)) {
+        return false;
+      }
+      stats_sets.back().emplace_back(std::move(name), val);
+    }
+  }
+  return data.empty();
+}
+
+StatsSnapshotFilePublisher::StatsSnapshotFilePublisher(
+    std::string path,
+    bool include_log_groups,
+    std::unique_ptr<StatsPublisher> next)
+    : path_(std::move(path)),
+      include_log_groups_(include_log_groups),
+      next_(std::move(next)) {
+  ld_check(!path_.empty());
+}
+
+void StatsSnapshotFilePublisher::publish(
+    const std::vector<const Stats*>& current,
+    const std::vector<const Stats*>& previous,
+    std::chrono::milliseconds elapsed) {
+  std::string data =
+      StatsSnapshot::create(current, include_log_groups_).serialize();
+  try {
+    // Writes to a temporary file and renames it, so readers never see a
+    // partially written snapshot.
+    folly::writeFileAtomic(path_, data);
+  } catch (const std::exception& ex) {
+    RATELIMIT_ERROR(std::chrono::seconds(60),
+                    1,
+                    "Failed to write stats snapshot to %s: %s",
+                    path_.c_str(),
+                    folly::exceptionStr(ex).toStdString().c_str());
+  }
+
+  if (next_) {
+    next_->publish(current, previous, elapsed);
+  }
+}
+
+void StatsSnapshotFilePublisher::addRollupEntity(std::string entity) {
+  if (next_) {
+    next_->addRollupEntity(std::move(entity));
+  }
+}
+
+}} // namespace facebook::logdevice
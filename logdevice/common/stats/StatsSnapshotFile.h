@@ -0,0 +1,91 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <folly/Range.h>
+
+#include "logdevice/common/StatsPublisher.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file  Binary snapshots of stats, written to a file (usually on a tmpfs
+ *        such as /dev/shm) that local agents read directly instead of
+ *        querying the "stats" admin command, which formats every counter as
+ *        text for each query.
+ *
+ *        The file is replaced atomically, so readers never see a partial
+ *        snapshot. Format (all integers little endian):
+ *
+ *          char[4]   magic "LDST"
+ *          uint32    format version, currently 1
+ *          uint64    time the snapshot was taken, ms since epoch
+ *          uint32    number of stats sets
+ *          for each stats set:
+ *            uint32  number of counters
+ *            for each counter:
+ *              uint16  name length
+ *              char[]  name, same as the key in the "stats" admin command
+ *              int64   value
+ *
+ *        Histograms are not included.
+ */
+
+struct Stats;
+
+struct StatsSnapshot {
+  static constexpr uint32_t VERSION = 1;
+
+  using Counters = std::vector<std::pair<std::string, int64_t>>;
+
+  std::chrono::milliseconds timestamp{0};
+  std::vector<Counters> stats_sets;
+
+  static StatsSnapshot create(const std::vector<const Stats*>& stats_sets,
+                              bool include_log_groups);
+
+  std::string serialize() const;
+
+  /**
+   * @return  true on success, false if `data` is not a valid snapshot or has
+   *          an unsupported version.
+   */
+  bool deserialize(folly::StringPiece data);
+};
+
+/**
+ * StatsPublisher that writes a StatsSnapshot of the current stats to a file
+ * each time stats are collected, then forwards them to another publisher, if
+ * any.
+ */
+class StatsSnapshotFilePublisher : public StatsPublisher {
+ public:
+  StatsSnapshotFilePublisher(std::string path,
+                             bool include_log_groups,
+                             std::unique_ptr<StatsPublisher> next = nullptr);
+
+  void publish(const std::vector<const Stats*>& current,
+               const std::vector<const Stats*>& previous,
+               std::chrono::milliseconds elapsed) override;
+
+  void addRollupEntity(std::string entity) override;
+
+ private:
+  const std::string path_;
+  const bool include_log_groups_;
+  std::unique_ptr<StatsPublisher> next_;
+};
+
+}} // namespace facebook::logdevice
@@ -211,6 +211,7 @@ class MockAppenderPrep : public AppenderPrep {
   bool can_activate_{true};
   NodeID my_node_id_;
   bool is_client_connected_{true};
+  bool shed_append_{false};
   // if set, next call to runAppender() returns this value instead of proxying
   // it to Sequencer
   folly::Optional<Status> next_status_;
@@ -335,6 +336,9 @@ class MockAppenderPrep : public AppenderPrep {
   bool isClientConnected() const {
     return is_client_connected_;
   }
+  bool shouldShedAppend() const override {
+    return shed_append_;
+  }
   void isAllowed(std::shared_ptr<PermissionChecker> permission_checker,
                  const PrincipalIdentity& principal,
                  callback_func_t cb) override {
@@ -862,6 +866,23 @@ TEST_F(APPEND_MessageTest, isNotAcceptingWork) {
   ASSERT_RESULTS(prep, std::make_pair(E::SHUTDOWN, NodeID()));
 }
 
+// Tests that appends are rejected with E::OVERLOADED, without activating a
+// sequencer, while the worker is shedding load.
+TEST_F(APPEND_MessageTest, LoadShedding) {
+  const logid_t log(1);
+  const NodeID N0(0, 1);
+
+  auto prep = create(log);
+  prep->my_node_id_ = N0;
+  prep->setSequencer(log, N0);
+  prep->setAlive({N0});
+  prep->shed_append_ = true;
+
+  prep->execute(std::unique_ptr<Appender>(new MockAppender(*prep)));
+  ASSERT_RESULTS(prep, std::make_pair(E::OVERLOADED, NodeID()));
+  EXPECT_EQ(1, current_epoch_.val_);
+}
+
 // Verifies the correctness of the execute function when the payload has
 // a checksum associated with it
 TEST_F(APPEND_MessageTest, CorruptionBeforeDataStore) {
@@ -0,0 +1,96 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/AdminCommandTable.h"
+
+#include <folly/io/IOBuf.h>
+#include <gtest/gtest.h>
+
+using namespace facebook::logdevice;
+using namespace facebook::logdevice::admin_command_table;
+
+namespace {
+
+template <typename Table>
+std::string toBinary(const Table& table, size_t max_col = Table::numCols()) {
+  folly::IOBuf buffer;
+  folly::io::Appender appender(&buffer, 1024);
+  table.printBinary(appender, max_col);
+  return buffer.coalesce().toString();
+}
+
+} // namespace
+
+TEST(AdminCommandTableTest, BinaryRoundTrip) {
+  AdminCommandTable<logid_t, std::string, int64_t, std::string> table(
+      false, "Log id", "Client", "Delta", "Empty");
+  table.next().set<0>(logid_t(1)).set<1>("C1").set<2>(-5);
+  table.next().set<0>(logid_t(2)).set<1>("C2");
+  table.next().set<0>(logid_t(3)).set<1>("C1").set<2>(INT64_MAX);
+  // More than 8 rows, for the null bitmap to take several bytes.
+  for (int i = 0; i < 10; ++i) {
+    table.next().set<1>("C3").set<2>(i);
+  }
+
+  std::string data = toBinary(table);
+  ASSERT_TRUE(isBinaryTable(data));
+  BinaryTable parsed;
+  ASSERT_TRUE(parseBinaryTable(data, parsed));
+
+  std::vector<std::string> headers{"Log id", "Client", "Delta", "Empty"};
+  EXPECT_EQ(headers, parsed.headers);
+  ASSERT_EQ(4, parsed.columns.size());
+  for (const auto& column : parsed.columns) {
+    ASSERT_EQ(13, column.size());
+  }
+  EXPECT_EQ("1", parsed.columns[0][0].value());
+  EXPECT_EQ("3", parsed.columns[0][2].value());
+  EXPECT_FALSE(parsed.columns[0][3].hasValue());
+  EXPECT_EQ("C1", parsed.columns[1][0].value());
+  EXPECT_EQ("C2", parsed.columns[1][1].value());
+  EXPECT_EQ("C1", parsed.columns[1][2].value());
+  EXPECT_EQ("C3", parsed.columns[1][12].value());
+  EXPECT_EQ("-5", parsed.columns[2][0].value());
+  EXPECT_FALSE(parsed.columns[2][1].hasValue());
+  EXPECT_EQ(std::to_string(INT64_MAX), parsed.columns[2][2].value());
+  EXPECT_EQ("9", parsed.columns[2][12].value());
+  for (const auto& value : parsed.columns[3]) {
+    EXPECT_FALSE(value.hasValue());
+  }
+
+  // Only the first column.
+  ASSERT_TRUE(parseBinaryTable(toBinary(table, 1), parsed));
+  EXPECT_EQ(std::vector<std::string>{"Log id"}, parsed.headers);
+  ASSERT_EQ(1, parsed.columns.size());
+  EXPECT_EQ("2", parsed.columns[0][1].value());
+}
+
+TEST(AdminCommandTableTest, BinaryKeepsNonCanonicalIntegers) {
+  AdminCommandTable<std::string> table(false, "Value");
+  table.next().set<0>("007");
+  table.next().set<0>("7");
+
+  BinaryTable parsed;
+  ASSERT_TRUE(parseBinaryTable(toBinary(table), parsed));
+  ASSERT_EQ(1, parsed.columns.size());
+  EXPECT_EQ("007", parsed.columns[0][0].value());
+  EXPECT_EQ("7", parsed.columns[0][1].value());
+}
+
+TEST(AdminCommandTableTest, BinaryRejectsMalformedInput) {
+  AdminCommandTable<std::string, int> table(false, "Name", "Value");
+  table.next().set<0>("a").set<1>(1);
+  table.next().set<0>("b").set<1>(2);
+  std::string data = toBinary(table);
+
+  BinaryTable parsed;
+  EXPECT_FALSE(parseBinaryTable("{\"headers\": []}", parsed));
+  for (size_t size = 0; size < data.size(); ++size) {
+    EXPECT_FALSE(parseBinaryTable(data.substr(0, size), parsed));
+  }
+  EXPECT_TRUE(parseBinaryTable(data, parsed));
+}
@@ -81,6 +81,43 @@ TEST(AppendProbeControllerTest, Basic) {
   ASSERT_FALSE(controller.shouldProbe(N2, LOG_ID));
 }
 
+TEST(AppendProbeControllerTest, Credit) {
+  std::chrono::milliseconds t(0);
+  auto time_cb = [&]() { return TestAppendProbeController::TimePoint(t); };
+  TestAppendProbeController controller(std::chrono::seconds(1), time_cb);
+
+  const NodeID N1(1, 1), N2(2, 1);
+  const logid_t LOG_ID(1);
+
+  // Credit for a healthy node is ignored
+  controller.onProbeCredit(N2, LOG_ID, 100);
+  ASSERT_FALSE(controller.shouldProbe(N2, LOG_ID, 10));
+
+  t = std::chrono::milliseconds(100);
+  controller.onAppendReply(N1, LOG_ID, E::SEQNOBUFS);
+  ASSERT_TRUE(controller.shouldProbe(N1, LOG_ID, 60));
+
+  // Probe succeeded and granted 100 bytes
+  controller.onProbeCredit(N1, LOG_ID, 100);
+  ASSERT_FALSE(controller.shouldProbe(N1, LOG_ID, 60));
+  // Only 40 bytes left
+  ASSERT_TRUE(controller.shouldProbe(N1, LOG_ID, 60));
+  ASSERT_FALSE(controller.shouldProbe(N1, LOG_ID, 40));
+  ASSERT_TRUE(controller.shouldProbe(N1, LOG_ID, 1));
+
+  // Credit expires after a second
+  controller.onProbeCredit(N1, LOG_ID, 100);
+  t = std::chrono::milliseconds(1099);
+  ASSERT_FALSE(controller.shouldProbe(N1, LOG_ID, 10));
+  t = std::chrono::milliseconds(1100);
+  ASSERT_TRUE(controller.shouldProbe(N1, LOG_ID, 10));
+
+  // Failures revoke credit
+  controller.onProbeCredit(N1, LOG_ID, 100);
+  controller.onAppendReply(N1, LOG_ID, E::SEQNOBUFS);
+  ASSERT_TRUE(controller.shouldProbe(N1, LOG_ID, 10));
+}
+
 // Test that nothing crashes or locks up under stress
 TEST(AppendProbeControllerTest, MultiThreadedStressTest) {
   // dbg::currentLevel = dbg::Level::DEBUG;
@@ -11,11 +11,14 @@
 #include <unordered_map>
 #include <variant>
 
+#include <folly/Format.h>
 #include <folly/Overload.h>
 #include <folly/Varint.h>
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include "logdevice/common/buffered_writer/ZstdDictionaryRegistry.h"
+
 namespace facebook { namespace logdevice {
 
 namespace {
@@ -374,4 +377,78 @@ INSTANTIATE_TEST_CASE_P(EncodeDecodeMatch,
                         ::testing::ValuesIn(payloads));
 } // namespace
 
+namespace {
+// Small records that look alike, like the ones dictionaries are meant for.
+std::vector<std::string> similarPayloads(size_t n, size_t offset = 0) {
+  std::vector<std::string> payloads;
+  for (size_t i = offset; i < offset + n; ++i) {
+    payloads.push_back(folly::sformat(
+        "{{\"user_id\":{},\"event\":\"page_view\",\"page\":\"/item/{}\","
+        "\"client\":\"android\",\"version\":\"{}.{}\"}}",
+        i * 7919 % 100000,
+        i % 97,
+        i % 5,
+        i % 13));
+  }
+  return payloads;
+}
+
+folly::IOBuf encodeZstd(const std::vector<std::string>& payloads_in,
+                        uint32_t zstd_dictionary_id) {
+  const auto payloads = convert(payloads_in);
+  BufferedWriteCodec::Estimator estimator = estimate(payloads);
+  const int checksum_bits = 0;
+  BufferedWriteCodec::Encoder<BufferedWriteSinglePayloadsCodec::Encoder>
+      encoder(checksum_bits,
+              payloads.size(),
+              estimator.calculateSize(checksum_bits));
+  for (const auto& payload : payloads) {
+    withPayload(payload, [&](auto&& p) { encoder.append(std::move(p)); });
+  }
+  folly::IOBufQueue queue;
+  encoder.encode(queue, Compression::ZSTD, 1, zstd_dictionary_id);
+  folly::IOBuf encoded = queue.moveAsValue();
+  encoded.coalesce();
+  return encoded;
+}
+
+std::vector<std::string> decodeAll(const folly::IOBuf& encoded) {
+  std::vector<folly::IOBuf> decoded;
+  size_t consumed =
+      BufferedWriteCodec::decode(Slice(encoded.data(), encoded.length()),
+                                 decoded,
+                                 /* allow_buffer_sharing */ true);
+  EXPECT_EQ(consumed, encoded.length());
+  std::vector<std::string> payloads_out;
+  for (auto& payload : decoded) {
+    payloads_out.push_back(payload.moveToFbString().toStdString());
+  }
+  return payloads_out;
+}
+} // namespace
+
+TEST(BufferedWriteCodecTest, ZstdDictionary) {
+  std::string dictionary =
+      ZstdDictionaryRegistry::train(similarPayloads(2000), 16 * 1024);
+  ASSERT_FALSE(dictionary.empty());
+  const uint32_t id = ZstdDictionaryRegistry::get().add(dictionary);
+  ASSERT_NE(0, id);
+  // Adding the same dictionary again returns the same ID.
+  EXPECT_EQ(id, ZstdDictionaryRegistry::get().add(dictionary));
+  EXPECT_EQ(0, ZstdDictionaryRegistry::get().add("not a dictionary"));
+
+  const auto payloads_in = similarPayloads(10, /* offset */ 5000);
+  folly::IOBuf with_dict = encodeZstd(payloads_in, id);
+  folly::IOBuf without_dict = encodeZstd(payloads_in, 0);
+  EXPECT_LT(with_dict.length(), without_dict.length());
+
+  EXPECT_EQ(payloads_in, decodeAll(with_dict));
+  EXPECT_EQ(payloads_in, decodeAll(without_dict));
+
+  // An unknown dictionary ID falls back to compressing without one.
+  folly::IOBuf unknown_dict = encodeZstd(payloads_in, id + 1);
+  EXPECT_EQ(without_dict.length(), unknown_dict.length());
+  EXPECT_EQ(payloads_in, decodeAll(unknown_dict));
+}
+
 }} // namespace facebook::logdevice
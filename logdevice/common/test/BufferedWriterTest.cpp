@@ -7,10 +7,13 @@
  */
 #include "logdevice/include/BufferedWriter.h"
 
+#include <algorithm>
 #include <random>
 
+#include <folly/Conv.h>
 #include <folly/Memory.h>
 #include <folly/Overload.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <gtest/gtest.h>
 
 #include "logdevice/common/DataRecordOwnsPayload.h"
@@ -681,6 +684,42 @@ TEST_F(BufferedWriterTest, SizeTrigger) {
   ASSERT_EQ(0, cb.failures.size());
 }
 
+// With adaptive flushing and appends well within the latency target, the size
+// trigger grows from the minimum, so batches get larger.
+TEST_F(BufferedWriterTest, AdaptiveSizeTrigger) {
+  TestCallback cb;
+  BufferedWriter::Options opts;
+  opts.adaptive_latency_target = std::chrono::hours(1);
+  opts.adaptive_min_size_trigger = 1024;
+  opts.adaptive_max_size_trigger = 64 * 1024;
+  auto writer = this->createWriter(&cb, opts);
+  const logid_t LOG_ID(1);
+  const std::string payload(1024, 'a');
+  const int APPENDS_PER_ROUND = 8;
+
+  auto run_round = [&] {
+    const size_t nblobs_before = sink_->getFlushedBlobs(LOG_ID).size();
+    for (int i = 0; i < APPENDS_PER_ROUND; ++i) {
+      EXPECT_EQ(0, writer->append(LOG_ID, std::string(payload), NULL_CONTEXT));
+    }
+    writer->flushAll();
+    for (int i = 0; i < APPENDS_PER_ROUND; ++i) {
+      cb.sem.wait();
+    }
+    return sink_->getFlushedBlobs(LOG_ID).size() - nblobs_before;
+  };
+
+  // Initially each append reaches the minimum size trigger on its own.
+  EXPECT_GT(run_round(), 1);
+  size_t nblobs = 0;
+  for (int round = 0; round < 20; ++round) {
+    nblobs = run_round();
+  }
+  // By now the size trigger is larger than all appends of a round.
+  EXPECT_EQ(1, nblobs);
+  ASSERT_EQ(0, cb.failures.size());
+}
+
 // Test writing a payload of size MAX_PAYLOAD_SIZE_PUBLIC.  This should fail
 // because the default soft limit should be lower than
 // MAX_PAYLOAD_SIZE_PUBLIC.
@@ -1049,3 +1088,81 @@ TEST_F(BufferedWriterTest, InitialDelayGreaterThanMaxDelay) {
   std::vector<std::string> expected = {"a"};
   ASSERT_EQ(expected, convertPayloads(cb.payloads_succeeded));
 }
+
+// Decoding PayloadGroups of uncompressed batches doesn't copy the payloads,
+// and decoding in parallel returns the same payloads in the same order.
+TEST_F(BufferedWriterTest, DecodeParallelSharingBuffers) {
+  TestCallback cb;
+  BufferedWriter::Options opts;
+  opts.compression = BufferedWriter::Options::Compression::NONE;
+  opts.size_trigger = 1024;
+  auto writer = this->createWriter(&cb, opts);
+  const logid_t LOG_ID(1);
+  const int NPAYLOADS = 1000;
+  for (int i = 0; i < NPAYLOADS; ++i) {
+    ASSERT_EQ(0,
+              writer->append(LOG_ID,
+                             folly::to<std::string>("payload", i),
+                             NULL_CONTEXT));
+  }
+  writer->flushAll();
+  for (int i = 0; i < NPAYLOADS; ++i) {
+    cb.sem.wait();
+  }
+  const std::vector<std::string> blobs = sink_->getFlushedBlobs(LOG_ID);
+  ASSERT_GT(blobs.size(), 1);
+
+  auto make_records = [&] {
+    std::vector<std::unique_ptr<DataRecord>> records;
+    lsn_t lsn = 1;
+    for (const std::string& blob : blobs) {
+      records.push_back(std::make_unique<DataRecordOwnsPayload>(
+          LOG_ID,
+          PayloadHolder(PayloadHolder::COPY_BUFFER, blob.data(), blob.size()),
+          lsn++,
+          std::chrono::milliseconds(0),
+          RECORD_flags_t(RECORD_Header::BUFFERED_WRITER_BLOB),
+          RecordOffset()));
+    }
+    return records;
+  };
+
+  auto records = make_records();
+  std::vector<std::pair<const char*, const char*>> record_ranges;
+  for (const auto& record : records) {
+    const char* data = static_cast<const char*>(record->payload.data());
+    record_ranges.emplace_back(data, data + record->payload.size());
+  }
+  std::vector<PayloadGroup> sequential;
+  {
+    BufferedWriteDecoderImpl decoder;
+    ASSERT_EQ(0, decoder.decode(std::move(records), sequential));
+  }
+  records = make_records();
+  std::vector<PayloadGroup> parallel;
+  {
+    folly::CPUThreadPoolExecutor executor(4);
+    BufferedWriteDecoderImpl decoder;
+    ASSERT_EQ(0, decoder.decode(std::move(records), parallel, executor));
+  }
+
+  ASSERT_EQ(NPAYLOADS, sequential.size());
+  ASSERT_EQ(NPAYLOADS, parallel.size());
+  for (int i = 0; i < NPAYLOADS; ++i) {
+    const std::string expected = folly::to<std::string>("payload", i);
+    ASSERT_EQ(1, sequential[i].size());
+    ASSERT_EQ(1, parallel[i].size());
+    const folly::IOBuf& iobuf = sequential[i].at(0);
+    EXPECT_TRUE(iobuf.isManaged());
+    EXPECT_EQ(expected, iobuf.cloneAsValue().moveToFbString().toStdString());
+    EXPECT_EQ(
+        expected,
+        parallel[i].at(0).cloneAsValue().moveToFbString().toStdString());
+    // The payload points into one of the records rather than into a copy.
+    const char* data = reinterpret_cast<const char*>(iobuf.data());
+    EXPECT_TRUE(std::any_of(
+        record_ranges.begin(), record_ranges.end(), [&](const auto& range) {
+          return data >= range.first && data < range.second;
+        }));
+  }
+}
@@ -7,9 +7,13 @@
  */
 #include "logdevice/common/Checksum.h"
 
+#include <algorithm>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include <folly/ScopeGuard.h>
+#include <folly/io/IOBuf.h>
 #include <gtest/gtest.h>
 
 #include "logdevice/common/protocol/APPEND_Message.h"
@@ -58,6 +62,48 @@ TEST_F(ChecksumTest, Invariable) {
   EXPECT_EQ(0xf8e4f0d10bd88705, checksum_64bit(data));
 }
 
+// Checksumming an IOBuf chain must match checksumming the flattened data, for
+// both short and long inputs (SpookyHash treats them differently).
+TEST_F(ChecksumTest, Chain) {
+  for (size_t len : {0, 9, 100, 1000, 10000}) {
+    std::string data(len, '\0');
+    for (size_t i = 0; i < len; ++i) {
+      data[i] = char(i * 7 + 3);
+    }
+    auto chain = folly::IOBuf::create(0);
+    for (size_t pos = 0; pos < len;) {
+      size_t n = std::min(len - pos, pos % 13 + 1);
+      chain->prependChain(folly::IOBuf::copyBuffer(data.data() + pos, n));
+      pos += n;
+    }
+    EXPECT_EQ(checksum_64bit(Slice(data.data(), data.size())),
+              checksum_64bit(*chain));
+  }
+}
+
+// Batch checksumming must match checksumming one slice at a time, for slices
+// of various lengths and alignments, short and long.
+TEST_F(ChecksumTest, Batch) {
+  std::string data(20000, '\0');
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = char(i * 13 + 5);
+  }
+  std::vector<Slice> slices;
+  for (size_t offset : {0, 1, 3}) {
+    for (size_t len : {0, 1, 7, 8, 9, 31, 64, 100, 1000, 4096, 4097, 10000}) {
+      slices.emplace_back(data.data() + offset, len);
+    }
+  }
+  // Every number of slices, so that the last group is partial in all ways.
+  for (size_t n = 0; n <= slices.size(); ++n) {
+    std::vector<uint32_t> out(n);
+    checksum_32bit_batch(slices.data(), n, out.data());
+    for (size_t i = 0; i < n; ++i) {
+      EXPECT_EQ(checksum_32bit(slices[i]), out[i]);
+    }
+  }
+}
+
 std::unique_ptr<RECORD_Message> ChecksumTest::roundTrip(
     APPEND_flags_t checksum_flags,
     std::function<void(RECORD_flags_t&, Payload)> mutation) {
@@ -16,6 +16,7 @@
 #include "logdevice/common/client_read_stream/ClientReadStreamBufferFactory.h"
 #include "logdevice/common/client_read_stream/ClientReadStreamCircularBuffer.h"
 #include "logdevice/common/client_read_stream/ClientReadStreamOrderedMapBuffer.h"
+#include "logdevice/common/client_read_stream/ClientReadStreamSortedVectorBuffer.h"
 #include "logdevice/include/types.h"
 
 namespace facebook { namespace logdevice {
@@ -39,11 +40,11 @@ class ClientReadStreamBufferTest
     : public ::testing::TestWithParam<ClientReadStreamBufferType> {
  public:
   void SetUp() override {
-    if (GetParam() == ClientReadStreamBufferType::CIRCULAR) {
-      buf = std::make_unique<ClientReadStreamCircularBuffer>(10, 100);
-    } else {
-      buf = std::make_unique<ClientReadStreamOrderedMapBuffer>(10, 100);
-    }
+    buf = ClientReadStreamBufferFactory::create(GetParam(), 10, 100);
+  }
+  // true if the buffer only holds LSNs that have a descriptor
+  bool sparse() const {
+    return GetParam() != ClientReadStreamBufferType::CIRCULAR;
   }
   std::unique_ptr<ClientReadStreamBuffer> buf;
 };
@@ -59,8 +60,8 @@ TEST_P(ClientReadStreamBufferTest, ForEachForward) {
 }
 
 TEST_P(ClientReadStreamBufferTest, ForEachWithHoles) {
-  // holes are only supported in ordered map
-  if (GetParam() != ClientReadStreamBufferType::ORDERED_MAP) {
+  // holes are only supported in sparse buffers
+  if (!sparse()) {
     return;
   }
   auto reset_buffer = [&]() {
@@ -122,9 +123,9 @@ TEST_P(ClientReadStreamBufferTest, ForEachBackward2) {
 TEST_P(ClientReadStreamBufferTest, ForEachForwardEmpty) {
   Collector collector;
   buf->forEach(100, 102, std::ref(collector));
-  if (GetParam() == ClientReadStreamBufferType::ORDERED_MAP) {
-    // Ordered map only returns actual entries
-    // but since the map is empty, it should not return anything
+  if (sparse()) {
+    // Sparse buffers only return actual entries
+    // but since the buffer is empty, it should not return anything
     ASSERT_COLLECTED(collector);
   } else {
     ASSERT_COLLECTED(collector, 100, 101, 102);
@@ -135,9 +136,9 @@ TEST_P(ClientReadStreamBufferTest, ForEachForwardEmpty) {
 TEST_P(ClientReadStreamBufferTest, ForEachBackwardEmpty) {
   Collector collector;
   buf->forEach(102, 100, std::ref(collector));
-  if (GetParam() == ClientReadStreamBufferType::ORDERED_MAP) {
-    // Ordered map only returns actual entries
-    // but since the map is empty, it should not return anything
+  if (sparse()) {
+    // Sparse buffers only return actual entries
+    // but since the buffer is empty, it should not return anything
     ASSERT_COLLECTED(collector);
   } else {
     ASSERT_COLLECTED(collector, 102, 101, 100);
@@ -145,10 +146,149 @@ TEST_P(ClientReadStreamBufferTest, ForEachBackwardEmpty) {
   ASSERT_TRUE(true);
 }
 
+// Descriptor slots of the circular buffer are only backed by memory where
+// they are used, and don't move while in use.
+TEST(ClientReadStreamCircularBufferTest, AllocatesChunksOnDemand) {
+  constexpr size_t K = ClientReadStreamCircularBuffer::kSlotsPerChunk;
+  // two full chunks and a short one
+  ClientReadStreamCircularBuffer buf(2 * K + 10, 1);
+  EXPECT_EQ(0u, buf.allocatedSlots());
+  EXPECT_EQ(nullptr, buf.find(1));
+  EXPECT_EQ(nullptr, buf.front());
+  EXPECT_EQ(LSN_INVALID, buf.findFirstMarker().second);
+
+  ClientReadStreamRecordState* rstate = buf.createOrGet(10);
+  ASSERT_NE(nullptr, rstate);
+  rstate->gap = true;
+  EXPECT_EQ(K, buf.allocatedSlots());
+
+  // allocating the last chunk doesn't move the first one
+  ASSERT_NE(nullptr, buf.createOrGet(1 + 2 * K + 5));
+  EXPECT_EQ(K + 10, buf.allocatedSlots());
+  EXPECT_EQ(rstate, buf.find(10));
+  EXPECT_EQ(std::make_pair(rstate, lsn_t(10)), buf.findFirstMarker());
+
+  buf.advanceBufferHead(9);
+  ASSERT_EQ(rstate, buf.front());
+  rstate->gap = false;
+  buf.popFront();
+
+  // this slot wraps around to the beginning of the first chunk
+  ClientReadStreamRecordState* wrapped = buf.createOrGet(10 + 2 * K + 6);
+  ASSERT_NE(nullptr, wrapped);
+  wrapped->gap = true;
+  EXPECT_EQ(K + 10, buf.allocatedSlots());
+
+  // the head leaves the first chunk, which still holds a marker
+  buf.advanceBufferHead(K - 9);
+  EXPECT_EQ(K + 10, buf.allocatedSlots());
+  EXPECT_EQ(std::make_pair(wrapped, lsn_t(10 + 2 * K + 6)),
+            buf.findFirstMarker());
+  wrapped->gap = false;
+
+  // the head leaves the other two chunks, then the first one again
+  buf.advanceBufferHead(K + 10);
+  EXPECT_EQ(K, buf.allocatedSlots());
+  buf.advanceBufferHead(K);
+  EXPECT_EQ(0u, buf.allocatedSlots());
+  EXPECT_EQ(1 + 9 + (K - 9) + (K + 10) + K, buf.getBufferHead());
+
+  ASSERT_NE(nullptr, buf.createOrGet(buf.getBufferHead()));
+  EXPECT_EQ(K, buf.allocatedSlots());
+  buf.clear();
+  EXPECT_EQ(0u, buf.allocatedSlots());
+  buf.advanceBufferHead(10 * K);
+  EXPECT_EQ(0u, buf.allocatedSlots());
+  EXPECT_EQ(nullptr, buf.front());
+}
+
+// Descriptors of the sorted vector buffer don't move when descriptors with
+// higher LSNs are created, and chunks are dropped once popped.
+TEST(ClientReadStreamSortedVectorBufferTest, Chunks) {
+  constexpr size_t K = ClientReadStreamSortedVectorBuffer::kChunkSize;
+  ClientReadStreamSortedVectorBuffer buf(100 * K, 1);
+  EXPECT_EQ(nullptr, buf.front());
+  EXPECT_EQ(LSN_INVALID, buf.findFirstMarker().second);
+
+  // a run of records with every other LSN fills two chunks
+  for (lsn_t lsn = 2; lsn <= 4 * K; lsn += 2) {
+    ClientReadStreamRecordState* rstate = buf.createOrGet(lsn);
+    ASSERT_NE(nullptr, rstate);
+    rstate->gap = true;
+  }
+  EXPECT_EQ(2 * K, buf.size());
+  EXPECT_EQ(2u, buf.numChunks());
+  EXPECT_EQ(nullptr, buf.find(3));
+
+  // filling the holes of the first chunk splits it, without moving the
+  // descriptors in front of the new ones
+  ClientReadStreamRecordState* first = buf.find(2);
+  for (lsn_t lsn = 3; lsn < 2 * K; lsn += 2) {
+    ClientReadStreamRecordState* rstate = buf.createOrGet(lsn);
+    ASSERT_NE(nullptr, rstate);
+    rstate->gap = true;
+    ASSERT_EQ(first, buf.find(2));
+    ASSERT_EQ(rstate, buf.find(lsn));
+  }
+  EXPECT_EQ(3 * K - 1, buf.size());
+  EXPECT_GT(buf.numChunks(), 2u);
+  EXPECT_EQ(std::make_pair(first, lsn_t(2)), buf.findFirstMarker());
+
+  Collector collector;
+  buf.forEach(2 * K + 4, 2 * K - 3, std::ref(collector));
+  ASSERT_COLLECTED(collector,
+                   2 * K + 4,
+                   2 * K + 2,
+                   2 * K,
+                   2 * K - 1,
+                   2 * K - 2,
+                   2 * K - 3);
+
+  // pop everything
+  buf.advanceBufferHead(1);
+  lsn_t popped = 0;
+  while (buf.findFirstMarker().first) {
+    ClientReadStreamRecordState* rstate = buf.front();
+    if (!rstate) {
+      buf.advanceBufferHead(1);
+      continue;
+    }
+    rstate->gap = false;
+    buf.popFront();
+    buf.advanceBufferHead(1);
+    ++popped;
+  }
+  EXPECT_EQ(3 * K - 1, popped);
+  EXPECT_EQ(0u, buf.numChunks());
+  EXPECT_EQ(4 * K + 1, buf.getBufferHead());
+
+  // descriptors can be created in front of the first one
+  ASSERT_NE(nullptr, buf.createOrGet(4 * K + 10));
+  ASSERT_NE(nullptr, buf.createOrGet(4 * K + 5));
+  EXPECT_EQ(lsn_t(4 * K + 5), buf.findFirstMarker().second);
+  EXPECT_EQ(nullptr, buf.createOrGet(1));
+  buf.clear();
+  EXPECT_EQ(0u, buf.size());
+}
+
+TEST(ClientReadStreamBufferFactoryTest, LargeWindowsUseSortedVector) {
+  auto small = ClientReadStreamBufferFactory::create(
+      ClientReadStreamBufferType::ORDERED_MAP, 128, 1);
+  EXPECT_NE(nullptr,
+            dynamic_cast<ClientReadStreamOrderedMapBuffer*>(small.get()));
+  auto large = ClientReadStreamBufferFactory::create(
+      ClientReadStreamBufferType::ORDERED_MAP,
+      ClientReadStreamBufferFactory::kSortedVectorMinCapacity,
+      1);
+  EXPECT_NE(nullptr,
+            dynamic_cast<ClientReadStreamSortedVectorBuffer*>(large.get()));
+}
+
 INSTANTIATE_TEST_CASE_P(
     ClientReadStreamBufferTest,
     ClientReadStreamBufferTest,
     ::testing::Values(ClientReadStreamBufferType::CIRCULAR,
-                      ClientReadStreamBufferType::ORDERED_MAP));
+                      ClientReadStreamBufferType::ORDERED_MAP,
+                      ClientReadStreamBufferType::SORTED_VECTOR));
 
 }} // namespace facebook::logdevice
@@ -8,6 +8,7 @@
 #include "logdevice/common/client_read_stream/ClientReadStream.h"
 
 #include <functional>
+#include <limits>
 #include <map>
 #include <memory>
 #include <unordered_map>
@@ -176,8 +177,19 @@ struct TestState {
   std::unordered_map<ShardID, SocketCallback*, ShardID::Hash> on_close;
   std::unordered_map<node_index_t, bool> cluster_state;
   std::vector<epoch_t> metadata_req;
+  // epochs passed to deps_->prefetchMetaDataForEpoch()
+  std::vector<epoch_t> metadata_prefetch;
+  // returned by deps_->getCurrentTime()
+  std::chrono::steady_clock::time_point now{std::chrono::seconds(1)};
+  // memory reserved with deps_->reserveWindowMemory() and its limit
+  size_t window_memory_reserved = 0;
+  size_t window_memory_budget = std::numeric_limits<size_t>::max();
   bool callbacks_accepting = true;
   bool disposed = false;
+  // If set, records are delivered with the record batch callback, which
+  // appends the length of each run to `batches'
+  bool record_batch_callback = false;
+  std::vector<size_t> batches;
 
   // default metadata to be delivered when epoch metadata is requested
   EpochMetaData default_metadata;
@@ -269,11 +281,34 @@ class MockClientReadStreamDependencies : public ClientReadStreamDependencies {
     state_.cache_entries_.push_back(CacheEntry{epoch, until, source, metadata});
   }
 
+  void prefetchMetaDataForEpoch(epoch_t epoch) override {
+    state_.metadata_prefetch.push_back(epoch);
+  }
+
+  std::chrono::steady_clock::time_point getCurrentTime() const override {
+    return state_.now;
+  }
+
+  bool reserveWindowMemory(size_t bytes) override {
+    if (state_.window_memory_reserved + bytes > state_.window_memory_budget) {
+      return false;
+    }
+    state_.window_memory_reserved += bytes;
+    return true;
+  }
+
+  void releaseWindowMemory(size_t bytes) override {
+    ASSERT_GE(state_.window_memory_reserved, bytes);
+    state_.window_memory_reserved -= bytes;
+  }
+
   int sendStartMessage(ShardID shard,
                        SocketCallback* onclose,
                        START_Header header,
                        const small_shardset_t& filtered_out,
-                       const ReadStreamAttributes* attrs) override {
+                       const ReadStreamAttributes* attrs,
+                       const std::vector<node_index_t>*
+                       /* preferred_nodes */) override {
     // Check if the test wants to simulate failure to send START to that shard.
     auto it = state_.send_start_errors.find(shard);
     if (it != state_.send_start_errors.end()) {
@@ -316,6 +351,19 @@ class MockClientReadStreamDependencies : public ClientReadStreamDependencies {
     return state_.callbacks_accepting;
   }
 
+  bool hasRecordBatchCallback() const override {
+    return state_.record_batch_callback;
+  }
+
+  bool recordBatchCallback(
+      folly::Range<std::unique_ptr<DataRecord>*> records) override {
+    for (auto& record : records) {
+      state_.recv.push_back(record->attrs.lsn);
+    }
+    state_.batches.push_back(records.size());
+    return state_.callbacks_accepting;
+  }
+
   bool gapCallback(const GapRecord& gap) override {
     state_.gap.push_back(GapMessage{gap.type, gap.lo, gap.hi});
     return state_.callbacks_accepting;
@@ -502,6 +550,9 @@ class ClientReadStreamTest
     if (wait_for_all_copies_) {
       read_stream_->waitForAllCopies();
     }
+    if (autotune_min_window_ > 0) {
+      read_stream_->enableWindowAutoTuning(autotune_min_window_);
+    }
 
     read_stream_->start();
     // Simulate storage nodes having replied STARTED already
@@ -760,6 +811,8 @@ class ClientReadStreamTest
   bool do_not_skip_partially_trimmed_sections_ = false;
   bool ship_corrupted_records_ = false;
   bool wait_for_all_copies_ = false;
+  // if positive, window auto-tuning is enabled with this minimum window size
+  size_t autotune_min_window_ = 0;
   std::unordered_map<node_index_t, std::string> node_locations_;
 
   TestState state_;
@@ -924,6 +977,34 @@ TEST_P(ClientReadStreamTest, Simple) {
   ASSERT_RECV(lsn(1, 4));
 }
 
+/**
+ * With a record batch callback, records that are ready at the same time are
+ * delivered in one call, and a rejected run is redelivered.
+ */
+TEST_P(ClientReadStreamTest, RecordBatchCallback) {
+  state_.record_batch_callback = true;
+  start();
+  onDataRecord(N0, mockRecord(lsn(1, 1)));
+  ASSERT_RECV(lsn(1, 1));
+  onDataRecord(N0, mockRecord(lsn(1, 3)));
+  onDataRecord(N1, mockRecord(lsn(1, 4)));
+  ASSERT_RECV();
+  onDataRecord(N2, mockRecord(lsn(1, 2)));
+  ASSERT_RECV(lsn(1, 2), lsn(1, 3), lsn(1, 4));
+  EXPECT_EQ(std::vector<size_t>({1, 3}), state_.batches);
+  state_.batches.clear();
+
+  state_.callbacks_accepting = false;
+  onDataRecord(N1, mockRecord(lsn(1, 6)));
+  onDataRecord(N0, mockRecord(lsn(1, 5)));
+  ASSERT_RECV(lsn(1, 5), lsn(1, 6));
+  ASSERT_TRUE(getRedeliveryTimer()->isActive());
+  state_.callbacks_accepting = true;
+  dynamic_cast<MockBackoffTimer*>(getRedeliveryTimer())->trigger();
+  ASSERT_RECV(lsn(1, 5), lsn(1, 6));
+  EXPECT_EQ(std::vector<size_t>({2, 2}), state_.batches);
+}
+
 /**
  * Buffering and delivering records that are received out of order.
  */
@@ -1238,6 +1319,63 @@ TEST_P(ClientReadStreamTest, LargeBuffer) {
   ASSERT_WINDOW_MESSAGES(next_lsn, buffer_max, N0, N1, N2, N3);
 }
 
+// With window auto-tuning, the window starts at the minimum size and grows
+// with the number of records delivered per round trip, within the memory
+// budget.
+TEST_P(ClientReadStreamTest, WindowAutoTuning) {
+  state_.shards = {N0};
+  buffer_size_ = 100;
+  autotune_min_window_ = 10;
+  state_.window_memory_budget = 40;
+  start();
+  ASSERT_START_MESSAGES(start_lsn_,
+                        LSN_MAX,
+                        calc_buffer_max(start_lsn_, 10),
+                        filter_version_t{1},
+                        false,
+                        small_shardset_t{},
+                        N0);
+
+  // START takes 10ms to be answered.
+  overrideConnectionStates(ConnectionState::CONNECTING);
+  onStartSent(N0, E::OK);
+  state_.now += std::chrono::milliseconds(10);
+  ON_STARTED(filter_version_t{1}, N0);
+  state_.window.clear();
+
+  // The first slide has no delivery rate to go by.
+  for (lsn_t lsn = start_lsn_; lsn < start_lsn_ + 5; ++lsn) {
+    onDataRecord(N0, mockRecord(lsn));
+  }
+  ASSERT_WINDOW_MESSAGES(start_lsn_ + 5, start_lsn_ + 14, N0);
+
+  // 5 records per ms is 50 per round trip. The window doubles, which is as
+  // much as it can grow at once.
+  for (lsn_t lsn = start_lsn_ + 5; lsn < start_lsn_ + 10; ++lsn) {
+    if (lsn == start_lsn_ + 9) {
+      state_.now += std::chrono::milliseconds(1);
+    }
+    onDataRecord(N0, mockRecord(lsn));
+  }
+  ASSERT_WINDOW_MESSAGES(start_lsn_ + 10, start_lsn_ + 29, N0);
+  // 10 records above the minimum window, 4 bytes each
+  EXPECT_EQ(40u, state_.window_memory_reserved);
+
+  // Growing more would exceed the memory budget.
+  for (lsn_t lsn = start_lsn_ + 10; lsn < start_lsn_ + 20; ++lsn) {
+    if (lsn == start_lsn_ + 19) {
+      state_.now += std::chrono::milliseconds(1);
+    }
+    onDataRecord(N0, mockRecord(lsn));
+  }
+  ASSERT_WINDOW_MESSAGES(start_lsn_ + 20, start_lsn_ + 39, N0);
+  EXPECT_EQ(40u, state_.window_memory_reserved);
+
+  state_.recv.clear();
+  read_stream_.reset();
+  EXPECT_EQ(0u, state_.window_memory_reserved);
+}
+
 /**
  * If reading a small range of LSNs that all fit into the window, we should
  * never slide the window.
@@ -2085,6 +2223,29 @@ TEST_P(ClientReadStreamTest, HoleGap) {
                       GapMessage{GapType::HOLE, lsn(1, 3), lsn(1, 3)});
 }
 
+// With --client-read-coalesce-gaps, adjacent gaps of the same type that become
+// deliverable at once are delivered as one gap.
+TEST_P(ClientReadStreamTest, CoalesceGaps) {
+  state_.shards.resize(2);
+  state_.settings.client_read_coalesce_gaps = true;
+  start_lsn_ = lsn(1, 1);
+  buffer_size_ = 128;
+  start();
+
+  onDataRecord(N0, mockRecord(lsn(1, 2), RECORD_Header::HOLE));
+  onDataRecord(N0, mockRecord(lsn(1, 3), RECORD_Header::HOLE));
+  onDataRecord(N0, mockRecord(lsn(1, 4), RECORD_Header::HOLE));
+  onDataRecord(N0, mockRecord(lsn(1, 5)));
+  onDataRecord(N0, mockRecord(lsn(1, 6), RECORD_Header::HOLE));
+  ASSERT_RECV();
+  ASSERT_GAP_MESSAGES();
+
+  onDataRecord(N1, mockRecord(lsn(1, 1)));
+  ASSERT_RECV(lsn(1, 1), lsn(1, 5));
+  ASSERT_GAP_MESSAGES(GapMessage{GapType::HOLE, lsn(1, 2), lsn(1, 4)},
+                      GapMessage{GapType::HOLE, lsn(1, 6), lsn(1, 6)});
+}
+
 // Ensures that Access Gaps are being sent correctly
 TEST_P(ClientReadStreamTest, AccessGap) {
   start_lsn_ = lsn(1, 1);
@@ -3262,6 +3423,106 @@ TEST_P(ClientReadStreamTest, ScdOnCloseCallback) {
   ASSERT_GAP_MESSAGES();
 }
 
+// Check that a node reported dead by cluster state is added to the known down
+// list right away.
+TEST_P(ClientReadStreamTest, ScdNodeDeadInClusterState) {
+  state_.shards.resize(4);
+  buffer_size_ = 10;
+  replication_factor_ = 3;
+  scd_enabled_ = true;
+  start();
+
+  const lsn_t buffer_max = calc_buffer_max(start_lsn_, buffer_size_);
+
+  ASSERT_START_MESSAGES(lsn(1, 1),
+                        LSN_MAX,
+                        buffer_max,
+                        filter_version_t{1},
+                        true,
+                        small_shardset_t{},
+                        N0,
+                        N1,
+                        N2,
+                        N3);
+  ON_STARTED(filter_version_t{1}, N0, N1, N2, N3);
+
+  onDataRecord(N0, mockRecord(lsn(1, 1)));
+  ASSERT_RECV(lsn(1, 1));
+
+  read_stream_->onNodeHealthChanged({N1.node()}, {});
+  // Hearing about it again doesn't schedule another change.
+  read_stream_->onNodeHealthChanged({N1.node()}, {});
+  triggerScheduledRewind();
+
+  ASSERT_START_MESSAGES(lsn(1, 2),
+                        LSN_MAX,
+                        buffer_max,
+                        filter_version_t{2},
+                        true,
+                        small_shardset_t{N1},
+                        N0,
+                        N1,
+                        N2,
+                        N3);
+  ON_STARTED(filter_version_t{2}, N0, N1, N2, N3);
+
+  read_stream_->onNodeHealthChanged({N1.node()}, {});
+  ASSERT_FALSE(rewindScheduled());
+}
+
+// Check that graylisted nodes are added to the shards slow list, leaving
+// enough shards to read every record from.
+TEST_P(ClientReadStreamTest, ScdNodeGraylisted) {
+  state_.shards.resize(4);
+  buffer_size_ = 10;
+  replication_factor_ = 2;
+  scd_enabled_ = true;
+  start();
+
+  const lsn_t buffer_max = calc_buffer_max(start_lsn_, buffer_size_);
+
+  ASSERT_START_MESSAGES(lsn(1, 1),
+                        LSN_MAX,
+                        buffer_max,
+                        filter_version_t{1},
+                        true,
+                        small_shardset_t{},
+                        N0,
+                        N1,
+                        N2,
+                        N3);
+  ON_STARTED(filter_version_t{1}, N0, N1, N2, N3);
+
+  // Only one shard can be filtered out with replication factor 2.
+  read_stream_->onNodeHealthChanged({}, {N3.node(), N1.node()});
+  triggerScheduledRewind();
+  ASSERT_START_MESSAGES(lsn(1, 1),
+                        LSN_MAX,
+                        buffer_max,
+                        filter_version_t{2},
+                        true,
+                        small_shardset_t{N1},
+                        N0,
+                        N1,
+                        N2,
+                        N3);
+  ON_STARTED(filter_version_t{2}, N0, N1, N2, N3);
+
+  // The graylist is cleared.
+  read_stream_->onNodeHealthChanged({}, {});
+  triggerScheduledRewind();
+  ASSERT_START_MESSAGES(lsn(1, 1),
+                        LSN_MAX,
+                        buffer_max,
+                        filter_version_t{3},
+                        true,
+                        small_shardset_t{},
+                        N0,
+                        N1,
+                        N2,
+                        N3);
+}
+
 // Check that if the socket for a node closes while all the other nodes are in
 // the known down list, we failover to all send all mode.
 TEST_P(ClientReadStreamTest, ScdOnCloseCallbackFailoverToAllSendAll) {
@@ -4338,6 +4599,38 @@ TEST_P(ClientReadStreamTest, NextEpochWithDisjointNodeSet) {
   ASSERT_GAP_MESSAGES();
 }
 
+// With --client-read-stream-metadata-prefetch-epochs, the read stream asks
+// for the metadata of the next epoch as soon as it learns that the epoch is
+// released, before it gets to the epoch boundary.
+TEST_P(ClientReadStreamTest, PrefetchNextEpochMetaData) {
+  start_lsn_ = lsn(3, 4);
+  buffer_size_ = 1024;
+  state_.disable_default_metadata = true;
+  state_.settings.client_read_stream_metadata_prefetch_epochs = 1;
+  start();
+  ASSERT_METADATA_REQ(epoch_t(3));
+  onEpochMetaData(lsn_to_epoch(start_lsn_),
+                  epoch_t(3),
+                  epoch_t(3),
+                  1,
+                  NodeLocationScope::NODE,
+                  StorageSet{N1, N2});
+  overrideConnectionStates(ConnectionState::READING);
+  onDataRecord(N1, mockRecord(lsn(3, 4)));
+  ASSERT_RECV(lsn(3, 4));
+  // epoch 4 is not known to be released yet
+  ASSERT_EQ(std::vector<epoch_t>(), state_.metadata_prefetch);
+
+  onGap(N2, mockGap(N2, lsn(3, 5), lsn(8, 9)));
+  ASSERT_METADATA_REQ();
+  ASSERT_EQ(std::vector<epoch_t>({epoch_t(4)}), state_.metadata_prefetch);
+
+  // the regular request still happens at the epoch boundary. In production
+  // it is served from the cache filled by the prefetch.
+  onGap(N1, mockGap(N1, lsn(3, 5), lsn(5, 0)));
+  ASSERT_METADATA_REQ(epoch_t(4));
+}
+
 /**
  * epoch bump with overlapping nodesets
  * (1) read stream is reading epoch 3 with nodeset {1, 2} (effective until
@@ -5164,6 +5457,32 @@ TEST_P(ClientReadStreamTest, Redelivery) {
   ASSERT_WINDOW_MESSAGES(lsn(1, 5), lsn(1, 6), N0);
 }
 
+// A stream can only be replaced by one starting at the next LSN to deliver
+// while no delivery is being retried.
+TEST_P(ClientReadStreamTest, CanResumeElsewhere) {
+  state_.shards.resize(1);
+  buffer_size_ = 2;
+  flow_control_threshold_ = 1.0;
+  start();
+
+  onDataRecord(N0, mockRecord(lsn(1, 1)));
+  ASSERT_RECV(lsn(1, 1));
+  ASSERT_TRUE(read_stream_->canResumeElsewhere());
+  ASSERT_EQ(lsn(1, 2), read_stream_->getNextLSNToDeliver());
+
+  state_.callbacks_accepting = false;
+  onDataRecord(N0, mockRecord(lsn(1, 2)));
+  ASSERT_RECV(lsn(1, 2));
+  ASSERT_TRUE(getRedeliveryTimer()->isActive());
+  ASSERT_FALSE(read_stream_->canResumeElsewhere());
+
+  state_.callbacks_accepting = true;
+  dynamic_cast<MockBackoffTimer*>(getRedeliveryTimer())->trigger();
+  ASSERT_RECV(lsn(1, 2));
+  ASSERT_TRUE(read_stream_->canResumeElsewhere());
+  ASSERT_EQ(lsn(1, 3), read_stream_->getNextLSNToDeliver());
+}
+
 // If callbacks reject data, but client receives a TRIM gap in the meantime,
 // it should still redeliver the record.
 TEST_P(ClientReadStreamTest, NoFastForwardWhileRedelivering) {
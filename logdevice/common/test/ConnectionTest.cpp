@@ -1244,6 +1244,53 @@ TEST_F(ClientConnectionTest, SenderBytesPendingTest) {
   EXPECT_EQ(bytes_pending_, 0);
 }
 
+// Once the batch reaches --socket-batching-size-trigger it's written to the
+// socket without waiting for --socket-batching-time-trigger.
+TEST_F(ClientConnectionTest, SocketBatchingSizeTrigger) {
+  std::unique_ptr<folly::IOBuf> written_buf;
+  size_t write_calls = 0;
+  ON_CALL(*sock_, connect_(_, _, _, _, _))
+      .WillByDefault(SaveArg<0>(&conn_callback_));
+  ON_CALL(*sock_, writeChain_(_, _, _))
+      .WillByDefault(Invoke([&](folly::AsyncSocket::WriteCallback* cb,
+                                folly::IOBuf* buf,
+                                folly::WriteFlags) {
+        wr_callback_ = cb;
+        written_buf.reset(buf);
+        ++write_calls;
+      }));
+  ON_CALL(*sock_, setReadCB(_)).WillByDefault(SaveArg<0>(&rd_callback_));
+  EXPECT_EQ(conn_->connect(), 0);
+
+  conn_callback_->connectSuccess();
+  ev_base_folly_.loopOnce();
+  writeSuccess();
+  CHECK_ON_SENT(MessageType::HELLO, E::OK);
+  receiveAckMessage();
+  EXPECT_TRUE(handshaken());
+  EXPECT_EQ(1u, write_calls);
+
+  settings_.socket_batching_time_trigger = std::chrono::hours(1);
+  auto send = [&] {
+    std::unique_ptr<facebook::logdevice::Message> msg(
+        new VarLengthTestMessage(3 /* min_proto */, 42 /* size */));
+    size_t size = msg->size(conn_->getInfo().protocol.value());
+    auto envelope = conn_->registerMessage(std::move(msg));
+    conn_->releaseMessage(*envelope);
+    return size;
+  };
+  size_t msg_size = send();
+  settings_.socket_batching_size_trigger = 2 * msg_size;
+  send();
+  // Both messages are written together in one chain.
+  ev_base_folly_.loopOnce();
+  EXPECT_EQ(2u, write_calls);
+  ASSERT_NE(nullptr, written_buf);
+  EXPECT_EQ(2 * msg_size, written_buf->computeChainDataLength());
+  writeSuccess();
+  EXPECT_EQ(bytes_pending_, 0);
+}
+
 TEST_F(ClientConnectionTest, ShouldDetectChangesInAddressForConnection) {
   using namespace configuration::nodes;
 
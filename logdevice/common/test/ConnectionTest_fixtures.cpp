@@ -147,6 +147,10 @@ int TestNetworkDependencies::setSoMark(int /*fd*/, uint32_t /*so_mark*/) {
   return 0;
 }
 
+int TestNetworkDependencies::setSoPriority(int /*fd*/, int /*priority*/) {
+  return 0;
+}
+
 folly::Executor* TestNetworkDependencies::getExecutor() const {
   return &folly::InlineExecutor::instance();
 }
@@ -81,6 +81,7 @@ class TestNetworkDependencies : public SocketNetworkDependencies {
   void onStoppedRunning(RunContext prev_context) override;
   ResourceBudget::Token getResourceToken(size_t payload_size) override;
   int setSoMark(int fd, uint32_t so_mark) override;
+  int setSoPriority(int fd, int priority) override;
   int getTCPInfo(TCPInfo*, int fd) override;
   std::shared_ptr<const configuration::nodes::NodesConfiguration>
   getNodesConfiguration() const override;
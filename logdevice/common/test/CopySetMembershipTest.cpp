@@ -0,0 +1,86 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/CopySetMembership.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace facebook::logdevice;
+
+namespace {
+
+std::vector<ShardID> randomShards(std::mt19937& rng, size_t n) {
+  std::uniform_int_distribution<int> node(0, 15);
+  std::uniform_int_distribution<int> shard(0, 3);
+  std::vector<ShardID> res;
+  for (size_t i = 0; i < n; ++i) {
+    res.emplace_back(node(rng), shard(rng));
+  }
+  return res;
+}
+
+} // namespace
+
+TEST(CopySetMembershipTest, Find) {
+  std::vector<ShardID> copyset = {ShardID(1, 0),
+                                  ShardID(2, 1),
+                                  ShardID(3, 0),
+                                  ShardID(4, 0),
+                                  ShardID(5, 2),
+                                  ShardID(1, 1)};
+  EXPECT_EQ(0u, copyset_membership::find(copyset.data(), 6, ShardID(1, 0)));
+  EXPECT_EQ(4u, copyset_membership::find(copyset.data(), 6, ShardID(5, 2)));
+  EXPECT_EQ(5u, copyset_membership::find(copyset.data(), 6, ShardID(1, 1)));
+  EXPECT_EQ(6u, copyset_membership::find(copyset.data(), 6, ShardID(2, 0)));
+  // Entries past `size` must be ignored.
+  EXPECT_EQ(5u, copyset_membership::find(copyset.data(), 5, ShardID(1, 1)));
+  EXPECT_EQ(0u, copyset_membership::find(copyset.data(), 0, ShardID(1, 0)));
+  EXPECT_FALSE(copyset_membership::contains(copyset.data(), 3, ShardID()));
+}
+
+TEST(CopySetMembershipTest, ContainsAny) {
+  std::vector<ShardID> copyset = {ShardID(1, 0), ShardID(2, 1), ShardID(3, 0)};
+  std::vector<ShardID> shards = {ShardID(7, 0), ShardID(3, 0)};
+  EXPECT_TRUE(copyset_membership::containsAny(
+      copyset.data(), copyset.size(), shards.data(), shards.size()));
+  EXPECT_FALSE(copyset_membership::containsAny(
+      copyset.data(), 2, shards.data(), shards.size()));
+  EXPECT_FALSE(copyset_membership::containsAny(
+      copyset.data(), copyset.size(), shards.data(), 0));
+  // Invalid ShardIDs must not match the padding of partial chunks.
+  std::vector<ShardID> invalid = {ShardID()};
+  EXPECT_FALSE(copyset_membership::containsAny(
+      copyset.data(), copyset.size(), invalid.data(), invalid.size()));
+}
+
+TEST(CopySetMembershipTest, MatchesLinearSearch) {
+  std::mt19937 rng(4242);
+  for (int iter = 0; iter < 10000; ++iter) {
+    auto copyset = randomShards(rng, rng() % 13);
+    auto shards = randomShards(rng, rng() % 5);
+
+    for (const ShardID& s : shards) {
+      size_t expected =
+          std::find(copyset.begin(), copyset.end(), s) - copyset.begin();
+      ASSERT_EQ(expected,
+                copyset_membership::find(copyset.data(), copyset.size(), s));
+    }
+
+    bool expected = std::any_of(copyset.begin(), copyset.end(), [&](ShardID s) {
+      return std::find(shards.begin(), shards.end(), s) != shards.end();
+    });
+    ASSERT_EQ(expected,
+              copyset_membership::containsAny(copyset.data(),
+                                              copyset.size(),
+                                              shards.data(),
+                                              shards.size()));
+  }
+}
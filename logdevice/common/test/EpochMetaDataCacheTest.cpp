@@ -155,6 +155,67 @@ TEST_F(EpochMetaDataCacheTest, Overwrite) {
   ASSERT_EQ(expected, result_);
 }
 
+TEST_F(EpochMetaDataCacheTest, Sharded) {
+  cache_ = std::make_unique<EpochMetaDataCache>(capacity_, 8);
+  for (uint64_t log = 1; log <= 20; ++log) {
+    cache_->setMetaData(logid_t(log),
+                        epoch_t(log),
+                        epoch_t(log + 10),
+                        RecordSource::CACHED_CONSISTENT,
+                        genEpochMetaData(epoch_t(log)));
+  }
+  for (uint64_t log = 1; log <= 20; ++log) {
+    ASSERT_TRUE(cache_->getMetaData(logid_t(log),
+                                    epoch_t(log),
+                                    &result_.until,
+                                    &result_.metadata,
+                                    &result_.source));
+    Result expected{epoch_t(log + 10),
+                    RecordSource::CACHED_CONSISTENT,
+                    genEpochMetaData(epoch_t(log))};
+    ASSERT_EQ(expected, result_);
+    ASSERT_FALSE(cache_->getMetaDataNoPromotion(logid_t(log),
+                                                epoch_t(log + 1),
+                                                &result_.until,
+                                                &result_.metadata,
+                                                &result_.source));
+  }
+}
+
+TEST_F(EpochMetaDataCacheTest, SharedPerCluster) {
+  auto a = EpochMetaDataCache::getForCluster("cluster_a", capacity_, 4);
+  auto a2 = EpochMetaDataCache::getForCluster("cluster_a", capacity_, 4);
+  auto b = EpochMetaDataCache::getForCluster("cluster_b", capacity_, 4);
+  ASSERT_EQ(a.get(), a2.get());
+  ASSERT_NE(a.get(), b.get());
+
+  a->setMetaData(LOG_ID,
+                 epoch_t(1),
+                 epoch_t(10),
+                 RecordSource::CACHED_CONSISTENT,
+                 genEpochMetaData(epoch_t(1)));
+  ASSERT_TRUE(a2->getMetaData(LOG_ID,
+                              epoch_t(1),
+                              &result_.until,
+                              &result_.metadata,
+                              &result_.source));
+  ASSERT_FALSE(b->getMetaData(LOG_ID,
+                              epoch_t(1),
+                              &result_.until,
+                              &result_.metadata,
+                              &result_.source));
+
+  // once all references are gone, a new cache is created
+  a.reset();
+  a2.reset();
+  a = EpochMetaDataCache::getForCluster("cluster_a", capacity_, 4);
+  ASSERT_FALSE(a->getMetaData(LOG_ID,
+                              epoch_t(1),
+                              &result_.until,
+                              &result_.metadata,
+                              &result_.source));
+}
+
 // TODO: add test(s) for eviction
 
 } // namespace
@@ -557,6 +557,49 @@ TEST_F(EpochRecoveryTest, Basic) {
   ASSERT_TRUE(lce_tail_.sameContent(result_.tail));
 }
 
+// The digest can be built before the tail record of the previous epoch is
+// known, but mutations only start once activate() provides it.
+TEST_F(EpochRecoveryTest, DigestAheadOfActivation) {
+  setUp();
+  OffsetMap om;
+  om.setCounter(BYTE_OFFSET, 19);
+  erm_->startDigest();
+  ASSERT_TRUE(erm_->isActive());
+  erm_->onSealed(N1, esn_t(1), esn_t(1), om, folly::none);
+  erm_->onSealed(N2, esn_t(1), esn_t(1), om, folly::none);
+  checkRecoveryState(ERMState::DIGEST);
+  ASSERT_NODE_STATE(NState::DIGESTING, N1, N2);
+
+  erm_->onMessageSent(N1, MessageType::START, E::OK, read_stream_id_t(1));
+  erm_->onMessageSent(N2, MessageType::START, E::OK, read_stream_id_t(2));
+  erm_->onDigestStreamStarted(N1, read_stream_id_t(1), lsn(epoch_, 1), E::OK);
+  erm_->onDigestStreamStarted(N2, read_stream_id_t(2), lsn(epoch_, 1), E::OK);
+  erm_->onDigestRecord(N1, read_stream_id_t(1), mockRecord(lsn(epoch_, 1), 9));
+  erm_->onDigestRecord(N2, read_stream_id_t(2), mockRecord(lsn(epoch_, 1), 9));
+  erm_->onDigestGap(
+      N1,
+      mockGap(N1, lsn(epoch_, 2), lsn(epoch_, ESN_MAX), read_stream_id_t(1)));
+  erm_->onDigestGap(
+      N2,
+      mockGap(N2, lsn(epoch_, 2), lsn(epoch_, ESN_MAX), read_stream_id_t(2)));
+  ASSERT_NODE_STATE(NState::MUTATABLE, N1, N2);
+
+  // the grace period expires, but the previous epoch is still being recovered
+  ASSERT_TRUE(erm_->getGracePeriodTimer()->isActive());
+  static_cast<MockTimer*>(erm_->getGracePeriodTimer())->trigger();
+  checkRecoveryState(ERMState::DIGEST);
+  ASSERT_FALSE(erm_->getGracePeriodTimer()->isActive());
+  ASSERT_TRUE(erm_->getMutators().empty());
+
+  // the previous epoch is recovered, mutations start right away
+  erm_->activate(prev_tail_);
+  checkRecoveryState(ERMState::MUTATION);
+  ASSERT_EQ(2, erm_->mutationSetSize());
+  ASSERT_EQ(1, erm_->getMutators().size());
+  const auto& mutator = *erm_->getMutators().at(esn_t(2));
+  ASSERT_TRUE(mutator.getStoreHeader().flags & STORE_Header::BRIDGE);
+}
+
 #define SEND_RECORD(nid, esn) \
   erm_->onDigestRecord(       \
       N##nid, read_stream_id_t(nid), mockRecord(lsn(epoch_, esn), 9));
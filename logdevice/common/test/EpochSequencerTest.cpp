@@ -744,6 +744,53 @@ TEST_F(EpochSequencerTest, RetireMultipleAppends) {
   maybeDeleteEpochSequencer();
 }
 
+TEST_F(EpochSequencerTest, RecentRecords) {
+  settings_.sequencer_tail_buffer_size = 10;
+  setUp();
+  const lsn_t first_lsn = compose_lsn(EPOCH, ESN_MIN);
+  std::vector<std::shared_ptr<TailRecord>> records;
+  // nothing is released yet
+  EXPECT_TRUE(es_->getRecentRecords(LSN_INVALID, &records));
+  EXPECT_TRUE(records.empty());
+
+  size_t num_appenders = 25;
+  auto test = [&]() {
+    for (int i = 0; i < num_appenders; ++i) {
+      MockAppender* appender = createAppender();
+      auto status = es_->runAppender(appender);
+      EXPECT_EQ(RunAppenderStatus::SUCCESS_KEEP, status);
+    }
+    return 0;
+  };
+  run_on_worker(processor_.get(), /*worker_id=*/0, test);
+
+  const lsn_t last_lsn = first_lsn + num_appenders - 1;
+  wait_until([&]() {
+    return es_->getLastReaped() == last_lsn &&
+        num_appenders == stats.appender_destroyed;
+  });
+
+  // only the last 10 records are kept
+  EXPECT_TRUE(es_->getRecentRecords(last_lsn - 10, &records));
+  ASSERT_EQ(10, records.size());
+  for (int i = 0; i < records.size(); ++i) {
+    EXPECT_EQ(last_lsn - 9 + i, records[i]->header.lsn);
+    EXPECT_TRUE(records[i]->hasPayload());
+  }
+  records.clear();
+  EXPECT_TRUE(es_->getRecentRecords(last_lsn - 2, &records));
+  EXPECT_EQ(2, records.size());
+  records.clear();
+  EXPECT_TRUE(es_->getRecentRecords(last_lsn, &records));
+  EXPECT_TRUE(records.empty());
+
+  // older records were evicted
+  EXPECT_FALSE(es_->getRecentRecords(last_lsn - 11, &records));
+  EXPECT_FALSE(es_->getRecentRecords(LSN_INVALID, &records));
+  EXPECT_TRUE(records.empty());
+  maybeDeleteEpochSequencer();
+}
+
 TEST_F(EpochSequencerTest, WindowFull) {
   window_size_ = 7;
   setUp();
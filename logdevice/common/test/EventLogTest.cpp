@@ -329,6 +329,8 @@ class EventLogTest : public ::testing::TestWithParam<bool> {
 
   // Last callback that was posted by the state machine for an append.
   std::function<void(Status st, lsn_t lsn)> last_posted_append_rq_;
+  // Payload of the last append posted by the state machine.
+  std::string last_posted_append_payload_;
 
   bool grace_period_for_fast_forward_active_{false};
 };
@@ -344,10 +346,11 @@ void MockEventLogStateMachine::getSnapshotLogTailLSN() {
 
 void MockEventLogStateMachine::postAppendRequest(
     logid_t /*logid*/,
-    std::string /*payload*/,
+    std::string payload,
     std::chrono::milliseconds /*timeout*/,
     std::function<void(Status st, lsn_t lsn)> cb) {
   owner_->last_posted_append_rq_ = std::move(cb);
+  owner_->last_posted_append_payload_ = std::move(payload);
 }
 
 void MockEventLogStateMachine::activateGracePeriodForFastForward() {
@@ -763,6 +766,82 @@ TEST_P(EventLogTest, WriteDeltaConfirmAppliedSimple) {
   subscriber_->assertNoUpdate();
 }
 
+// Deltas written while an append is in flight are appended as a single record.
+// They are applied in order and each writer is confirmed individually.
+TEST_P(EventLogTest, WriteDeltaBatch) {
+  delta_log_tail_lsn_ = lsn_t{42};
+  snapshot_log_tail_lsn_ = lsn_t{4};
+  init();
+  evlog_->setMaxDeltasPerRecord(10);
+  evlog_->start();
+
+  EventLogRebuildingSet set;
+  SNAPSHOT(set, lsn_t{33}, lsn_t{4});
+  DELTA_GAP(BRIDGE, LSN_OLDEST, lsn_t{42});
+  auto u = subscriber_->retrieveNextUpdate();
+  ASSERT_EQ(lsn_t{33}, u.version);
+  subscriber_->assertNoUpdate();
+
+  auto h1 = writeDelta(D(SHARD_NEEDS_REBUILD, node_index_t{1}, uint32_t{0}));
+  ASSERT_NE(nullptr, h1.confirm_append_cb);
+  // The first append is in flight, the next deltas are queued.
+  auto h2 = writeDelta(D(SHARD_NEEDS_REBUILD, node_index_t{2}, uint32_t{0}));
+  auto h3 = writeDelta(D(SHARD_NEEDS_REBUILD, node_index_t{3}, uint32_t{0}));
+  ASSERT_EQ(nullptr, h2.confirm_append_cb);
+  ASSERT_EQ(nullptr, h3.confirm_append_cb);
+
+  // The first append completes, the queued deltas are appended together.
+  h1.confirmAppend(E::OK, lsn_t{48});
+  ASSERT_NE(nullptr, last_posted_append_rq_);
+  auto batch_append_cb = std::move(last_posted_append_rq_);
+  last_posted_append_rq_ = nullptr;
+  const std::string batch_payload = last_posted_append_payload_;
+
+  EventLogStateMachine::DeltaHeader header;
+  ASSERT_TRUE(EventLogStateMachine::deserializeDeltaHeader(
+      Payload(batch_payload.data(), batch_payload.size()), header));
+  ASSERT_TRUE(header.flags & EventLogStateMachine::DeltaHeader::BATCH);
+  std::vector<Payload> payloads;
+  ASSERT_EQ(0,
+            EventLogStateMachine::splitDeltaBatch(
+                Payload(batch_payload.data(), batch_payload.size()),
+                header,
+                payloads));
+  ASSERT_EQ(2, payloads.size());
+
+  batch_append_cb(E::OK, lsn_t{49});
+  h1.onReceived(lsn_t{48});
+  h1.assertCallbackCalled(E::OK, lsn_t{48});
+  h2.assertCallbackNotCalled();
+  h3.assertCallbackNotCalled();
+
+  auto p = std::make_unique<DataRecordOwnsPayload>(
+      configuration::InternalLogs::EVENT_LOG_DELTAS,
+      PayloadHolder::copyString(batch_payload),
+      lsn_t{49},
+      std::chrono::milliseconds{100},
+      0, // flags
+      RecordOffset());
+  evlog_->onDeltaRecord(p);
+  h2.assertCallbackCalled(E::OK, lsn_t{49});
+  h3.assertCallbackCalled(E::OK, lsn_t{49});
+
+  // Subscribers are notified once per delta.
+  u = subscriber_->retrieveNextUpdate();
+  ASSERT_EQ(lsn_t{48}, u.version);
+  ASSERT_NE(nullptr, u.delta);
+  u = subscriber_->retrieveNextUpdate();
+  ASSERT_EQ(lsn_t{49}, u.version);
+  ASSERT_NE(nullptr, u.delta);
+  u = subscriber_->retrieveNextUpdate();
+  ASSERT_EQ(lsn_t{49}, u.version);
+  ASSERT_NE(nullptr, u.delta);
+  ASSERT_SHARD_STATUS(u.state, node_index_t{2}, uint32_t{0}, UNAVAILABLE);
+  ASSERT_SHARD_STATUS(u.state, node_index_t{3}, uint32_t{0}, UNAVAILABLE);
+  subscriber_->assertNoUpdate();
+  ASSERT_EQ(lsn_t{49}, evlog_->getVersion());
+}
+
 // We time out confirming a delta written CONFIRM_APPLIED. However we do receive
 // the delta afterwards.
 TEST_P(EventLogTest, WriteDeltaConfirmAppliedTimeout) {
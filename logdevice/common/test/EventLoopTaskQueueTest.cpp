@@ -7,7 +7,11 @@
  */
 #include "logdevice/common/EventLoopTaskQueue.h"
 
+#include <algorithm>
+#include <chrono>
 #include <memory>
+#include <thread>
+#include <vector>
 
 #include <folly/Executor.h>
 #include <gtest/gtest.h>
@@ -94,3 +98,73 @@ TEST(EventLoopTaskQueue, PostPrioritizedWork) {
   EXPECT_EQ(num_mid_pri_task, num_mid_pri_executed);
   EXPECT_EQ(num_lo_pri_task, num_lo_pri_executed);
 }
+
+TEST(EventLoopTaskQueue, PostBatch) {
+  auto el = std::make_unique<EventLoop>();
+  std::vector<int> executed;
+  Semaphore done;
+
+  std::vector<folly::Function<void()>> funcs;
+  for (int i = 0; i < 100; ++i) {
+    funcs.push_back([i, &executed] { executed.push_back(i); });
+  }
+  funcs.push_back([&done] { done.post(); });
+  int rv = el->addBatchWithPriority(std::move(funcs), folly::Executor::MID_PRI);
+  ASSERT_EQ(0, rv);
+  done.wait();
+
+  ASSERT_EQ(100u, executed.size());
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(i, executed[i]);
+  }
+
+  // An empty batch is a no-op.
+  ASSERT_EQ(0, el->addBatchWithPriority({}, folly::Executor::HI_PRI));
+}
+
+// Low priority tasks that waited for longer than the aging threshold are
+// served ahead of a burst of high priority tasks.
+TEST(EventLoopTaskQueue, Aging) {
+  auto el = std::make_unique<EventLoop>();
+  Semaphore start_loop, primed;
+  el->add([&el, &start_loop, &primed]() {
+    el->getTaskQueue().setDequeuesPerIteration({7, 1, 1});
+    el->getTaskQueue().setAgingThreshold(std::chrono::milliseconds(10));
+    primed.post();
+    start_loop.wait();
+  });
+  primed.wait();
+
+  const int num_lo_pri_tasks = 10;
+  const int num_hi_pri_tasks = 100;
+  std::vector<int8_t> executed;
+  Semaphore done;
+  for (int i = 0; i < num_lo_pri_tasks; ++i) {
+    el->addWithPriority(
+        [&] {
+          executed.push_back(folly::Executor::LO_PRI);
+          done.post();
+        },
+        folly::Executor::LO_PRI);
+  }
+  /* sleep override */
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  for (int i = 0; i < num_hi_pri_tasks; ++i) {
+    el->addWithPriority(
+        [&] {
+          executed.push_back(folly::Executor::HI_PRI);
+          done.post();
+        },
+        folly::Executor::HI_PRI);
+  }
+  start_loop.post();
+  for (int i = 0; i < num_lo_pri_tasks + num_hi_pri_tasks; ++i) {
+    done.wait();
+  }
+
+  // Without aging, one low priority task would run every 9 tasks.
+  auto last_lo_pri =
+      std::find(executed.rbegin(), executed.rend(), folly::Executor::LO_PRI);
+  ASSERT_NE(executed.rend(), last_lo_pri);
+  EXPECT_LT(executed.rend() - last_lo_pri, 30);
+}
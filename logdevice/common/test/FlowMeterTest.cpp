@@ -5,6 +5,8 @@
  * This source code is licensed under the BSD-style license found in the
  * LICENSE file in the root directory of this source tree.
  */
+#include <thread>
+
 #include <gtest/gtest.h>
 
 #include "logdevice/common/test/FlowGroupTest.h"
@@ -243,4 +245,27 @@ TEST(FlowMeterTest, FlowMeterTransferCredit) {
   ASSERT_EQ(dest_bucket.level(), 100);
 }
 
+// The Worker debits a meter without the ShapingContainer's lock while the
+// TrafficShaper fills it. No debit may be lost.
+TEST(FlowMeterTest, ConcurrentDrainAndFill) {
+  constexpr int kIterations = 100000;
+  FlowMeter test_meter;
+  auto& test_bucket = test_meter.entries[0];
+  test_bucket.setCapacity(INT64_MAX);
+
+  std::thread drainer([&] {
+    for (int i = 0; i < kIterations; ++i) {
+      test_bucket.drain(3, /*drain_on_negative_level=*/true);
+    }
+  });
+  size_t deposit_budget = FlowMeter::Entry::UNRESTRICTED_BUDGET;
+  for (int i = 0; i < kIterations; ++i) {
+    ASSERT_EQ(test_bucket.fill(2, deposit_budget), 0);
+  }
+  drainer.join();
+
+  ASSERT_EQ(-kIterations, test_bucket.level());
+  ASSERT_EQ(size_t(kIterations), test_bucket.debt());
+}
+
 } // anonymous namespace
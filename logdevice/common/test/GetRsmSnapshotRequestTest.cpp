@@ -8,6 +8,8 @@
 
 #include "logdevice/common/GetRsmSnapshotRequest.h"
 
+#include <set>
+
 #include <folly/Memory.h>
 #include <gtest/gtest.h>
 
@@ -61,6 +63,10 @@ class MockGetRsmSnapshotRequest : public GetRsmSnapshotRequest {
     return flags_;
   }
 
+  const Settings& getSettings() const override {
+    return settings_;
+  }
+
   void initTimers() override {}
   void activateWaveTimer() override {}
 
@@ -117,10 +123,12 @@ class GetRsmSnapshotRequestTest : public ::testing::Test {
 
   std::unique_ptr<MockGetRsmSnapshotRequest>
   create(std::chrono::milliseconds timeout = std::chrono::seconds(1),
-         std::chrono::milliseconds wave_timeout = std::chrono::seconds(1)) {
+         std::chrono::milliseconds wave_timeout = std::chrono::seconds(1),
+         size_t fanout = 1) {
     callback_called_ = false;
 
     Settings settings = create_default_settings<Settings>();
+    settings.rsm_snapshot_request_fanout = fanout;
     settings.get_cluster_state_timeout = timeout;
     settings.get_cluster_state_wave_timeout = wave_timeout;
     auto snapshot_cb = [&](Status st,
@@ -394,4 +402,38 @@ TEST_F(GetRsmSnapshotRequestTest, StaleReply) {
   checkStatus(E::STALE);
 }
 
+TEST_F(GetRsmSnapshotRequestTest, Fanout) {
+  int num_nodes = 5;
+  init(num_nodes, 1);
+  auto rq = create(std::chrono::seconds(1), std::chrono::seconds(1), 3);
+  ASSERT_EQ(Request::Execution::CONTINUE, rq->execute());
+
+  // The request is sent to 3 different nodes at once.
+  ASSERT_EQ(rq->recipients_.size(), 3);
+  std::set<NodeID> asked(rq->recipients_.begin(), rq->recipients_.end());
+  ASSERT_EQ(asked.size(), 3);
+
+  // An error from one of them makes us ask another node, keeping 3 requests
+  // in flight.
+  GET_RSM_SNAPSHOT_REPLY_Header hdr{
+      E::NOTFOUND, logid_t(1), rq->id_, -1, LSN_OLDEST};
+  const GET_RSM_SNAPSHOT_REPLY_Message msg(hdr, "");
+  rq->onReply(Address(rq->recipients_[0]), msg);
+  ASSERT_EQ(rq->recipients_.size(), 4);
+  ASSERT_EQ(rq->candidatesSize(), num_nodes - 1);
+  ASSERT_EQ(asked.count(rq->recipients_[3]), 0);
+
+  // A wave timeout drops all 3 nodes in flight, only one node is left.
+  rq->onWaveTimeout();
+  ASSERT_EQ(rq->candidatesSize(), 1);
+  ASSERT_EQ(rq->recipients_.size(), 5);
+  callbackCalled(false);
+
+  hdr.st = E::OK;
+  const GET_RSM_SNAPSHOT_REPLY_Message msg2(hdr, "snapshot-blob");
+  rq->onReply(Address(rq->recipients_[4]), msg2);
+  checkStatus(E::OK);
+  callbackCalled(true);
+}
+
 }} // namespace facebook::logdevice
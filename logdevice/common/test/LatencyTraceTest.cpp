@@ -0,0 +1,68 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/LatencyTrace.h"
+
+#include <thread>
+
+#include <gtest/gtest.h>
+
+using namespace facebook::logdevice;
+
+TEST(LatencyTraceTest, Sampling) {
+  EXPECT_EQ(nullptr, LatencyTrace::maybeStart("test", 0));
+  EXPECT_NE(nullptr, LatencyTrace::maybeStart("test", 1));
+}
+
+TEST(LatencyTraceTest, CollectAndFold) {
+  auto count_kind = [](const char* kind) {
+    size_t n = 0;
+    for (const auto& r : LatencyTrace::collect()) {
+      n += std::string(r.kind) == kind;
+    }
+    return n;
+  };
+
+  std::thread([] {
+    for (int i = 0; i < 3; ++i) {
+      LatencyTrace trace("collect_test");
+      trace.mark("a");
+      trace.mark("b");
+      trace.finish();
+    }
+  }).join();
+  // Traces of exited threads are gone.
+  EXPECT_EQ(0, count_kind("collect_test"));
+
+  for (size_t i = 0; i < LatencyTrace::kRingBufferSize + 10; ++i) {
+    LatencyTrace trace("collect_test");
+    trace.mark("a");
+    trace.mark("b");
+    trace.finish();
+  }
+  // Only the most recent kRingBufferSize traces are kept.
+  auto records = LatencyTrace::collect();
+  EXPECT_EQ(LatencyTrace::kRingBufferSize, count_kind("collect_test"));
+  for (size_t i = 1; i < records.size(); ++i) {
+    EXPECT_LT(records[i - 1].id, records[i].id);
+  }
+
+  std::string folded = LatencyTrace::toFoldedStacks(records);
+  EXPECT_NE(std::string::npos, folded.find("collect_test;a "));
+  EXPECT_NE(std::string::npos, folded.find("collect_test;b "));
+}
+
+TEST(LatencyTraceTest, TooManyStages) {
+  LatencyTrace trace("stages_test");
+  for (size_t i = 0; i < LatencyTrace::kMaxStages + 5; ++i) {
+    trace.mark("stage");
+  }
+  trace.finish();
+  auto records = LatencyTrace::collect();
+  ASSERT_FALSE(records.empty());
+  EXPECT_EQ(LatencyTrace::kMaxStages, records.back().num_stages);
+}
@@ -13,6 +13,7 @@
 #include "logdevice/common/MetaDataLog.h"
 #include "logdevice/common/SecurityInformation.h"
 #include "logdevice/common/configuration/logs/FBuffersLogsConfigCodec.h"
+#include "logdevice/common/configuration/logs/FBuffersLogsConfigView.h"
 #include "logdevice/include/LogAttributes.h"
 
 using namespace facebook::logdevice::logsconfig;
@@ -507,6 +508,62 @@ TEST(LogsConfigCodecTest, LogsConfigTreeCodecTest3) {
   ASSERT_FALSE(lg2->attrs().scdEnabled().value());
 }
 
+// A view of a serialized tree answers lookups by log id like the fully
+// deserialized tree does, including inherited attributes.
+TEST(LogsConfigCodecTest, LogsConfigView) {
+  auto defaults = DefaultLogAttributes()
+                      .with_replicationFactor(4)
+                      .with_scdEnabled(false)
+                      .with_syncReplicationScope(NodeLocationScope::REGION);
+  auto tree = LogsConfigTree::create("/", defaults);
+  auto dir1 = tree->addDirectory(
+      "/dir1", false, LogAttributes().with_scdEnabled(true));
+  auto dir2 = tree->addDirectory(
+      "/dir2", false, LogAttributes().with_replicationFactor(24));
+  auto dir2_2 = tree->addDirectory(
+      "/dir2/dir2_2", false, LogAttributes().with_scdEnabled(true));
+  ASSERT_TRUE(tree->addLogGroup(
+      dir1, "log1", logid_range_t{logid_t(67), logid_t(75)}));
+  ASSERT_TRUE(tree->addLogGroup(dir2,
+                                "log1",
+                                logid_range_t{logid_t(15), logid_t(66)},
+                                LogAttributes().with_replicationFactor(6)));
+  ASSERT_TRUE(tree->addLogGroup(
+      dir2_2, "log2", logid_range_t{logid_t(100), logid_t(100)}));
+
+  PayloadHolder payload =
+      FBuffersLogsConfigCodec::serialize<LogsConfigTree>(*tree, false);
+  auto recovered = FBuffersLogsConfigCodec::deserialize<LogsConfigTree>(
+      payload.getPayload(), "/");
+  ASSERT_TRUE(recovered);
+  auto view = FBuffersLogsConfigView::create(payload.getPayload(), "/");
+  ASSERT_TRUE(view);
+  EXPECT_EQ(tree->version(), view->version());
+  EXPECT_EQ(3, view->numLogGroups());
+
+  for (uint64_t id : {1, 14, 15, 40, 66, 67, 75, 76, 99, 100, 101}) {
+    const logid_t logid(id);
+    const auto* expected = recovered->getLogGroupByID(logid);
+    auto group = view->getLogGroupByIDShared(logid);
+    EXPECT_EQ(expected != nullptr, view->logExists(logid)) << id;
+    if (!expected) {
+      EXPECT_EQ(nullptr, group) << id;
+      EXPECT_EQ(E::NOTFOUND, err);
+      continue;
+    }
+    ASSERT_NE(nullptr, group) << id;
+    EXPECT_EQ(expected->log_group->name(), group->name());
+    EXPECT_EQ(expected->log_group->range(), group->range());
+    EXPECT_EQ(expected->log_group->attrs(), group->attrs()) << id;
+    // Materialized groups are cached.
+    EXPECT_EQ(group, view->getLogGroupByIDShared(logid));
+  }
+  EXPECT_EQ(24, view->getLogGroupByIDShared(logid_t(100))
+                    ->attrs()
+                    .replicationFactor()
+                    .value());
+}
+
 // This is disabled as it's covered by an assertion in the code
 TEST(LogsConfigCodecTest, DISABLED_InvalidPayload) {
   std::string invalid_payload = "BAD DATA IN PAYLOAD";
@@ -0,0 +1,77 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/network/MessageCompressor.h"
+
+#include <string>
+
+#include <folly/Random.h>
+#include <gtest/gtest.h>
+
+using namespace facebook::logdevice;
+
+namespace {
+
+std::string randomString(size_t len) {
+  std::string s(len, '\0');
+  for (char& c : s) {
+    c = 'a' + folly::Random::rand32(26);
+  }
+  return s;
+}
+
+std::string toString(const folly::IOBuf& buf) {
+  return buf.cloneAsValue().moveToFbString().toStdString();
+}
+
+} // namespace
+
+// Messages decompress to what was compressed, and a message similar to a
+// previous one compresses much better thanks to the shared stream.
+TEST(MessageCompressorTest, Stream) {
+  MessageCompressor compressor(1);
+  MessageDecompressor decompressor;
+  const std::string payload = randomString(4000);
+
+  auto first = folly::IOBuf::copyBuffer("first" + payload);
+  auto c1 = compressor.compress(*first);
+  ASSERT_NE(nullptr, c1);
+  // Chained input.
+  auto second = folly::IOBuf::copyBuffer("second");
+  second->prependChain(folly::IOBuf::copyBuffer(payload));
+  auto c2 = compressor.compress(*second);
+  ASSERT_NE(nullptr, c2);
+  EXPECT_LT(c2->computeChainDataLength() * 10, c1->computeChainDataLength());
+
+  auto d1 = decompressor.decompress(*c1, first->computeChainDataLength());
+  ASSERT_NE(nullptr, d1);
+  EXPECT_EQ(toString(*first), toString(*d1));
+  auto d2 = decompressor.decompress(*c2, second->computeChainDataLength());
+  ASSERT_NE(nullptr, d2);
+  EXPECT_EQ(toString(*second), toString(*d2));
+}
+
+TEST(MessageCompressorTest, WrongSize) {
+  MessageCompressor compressor(1);
+  auto msg = folly::IOBuf::copyBuffer(randomString(100));
+  auto compressed = compressor.compress(*msg);
+  ASSERT_NE(nullptr, compressed);
+  {
+    MessageDecompressor decompressor;
+    EXPECT_EQ(nullptr, decompressor.decompress(*compressed, 99));
+  }
+  {
+    MessageDecompressor decompressor;
+    EXPECT_EQ(nullptr, decompressor.decompress(*compressed, 101));
+  }
+}
+
+TEST(MessageCompressorTest, Corrupted) {
+  MessageDecompressor decompressor;
+  auto garbage = folly::IOBuf::copyBuffer(randomString(100));
+  EXPECT_EQ(nullptr, decompressor.decompress(*garbage, 1000));
+}
@@ -0,0 +1,46 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/protocol/MessagePool.h"
+
+#include <memory>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+using namespace facebook::logdevice;
+
+namespace {
+
+struct Pooled : public PooledMessage<MessageType::WINDOW> {
+  virtual ~Pooled() {}
+  char data[40];
+};
+
+struct BiggerPooled : public Pooled {
+  char more_data[100];
+};
+
+} // namespace
+
+TEST(MessagePoolTest, ReusesFreedBlocks) {
+  std::thread([] {
+    auto first = std::make_unique<Pooled>();
+    void* p = first.get();
+    first.reset();
+    auto second = std::make_unique<Pooled>();
+    EXPECT_EQ(p, second.get());
+
+    // Subclasses of a different size bypass the cache.
+    std::unique_ptr<Pooled> bigger = std::make_unique<BiggerPooled>();
+    EXPECT_NE(p, bigger.get());
+    second.reset();
+    bigger.reset();
+    auto third = std::make_unique<Pooled>();
+    EXPECT_EQ(p, third.get());
+  }).join();
+}
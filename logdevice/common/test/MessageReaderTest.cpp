@@ -203,3 +203,52 @@ TEST(MessageReaderTest, FailProtocolHeaderValidation) {
   ASSERT_EQ(nullptr, bufReturn);
   ASSERT_EQ(0, lenReturn);
 }
+
+// With a pool buffer, bodies of consecutive small messages are read next to
+// each other into the same buffer.
+TEST(MessageReaderTest, PooledMessageBodies) {
+  MockProtocolHandler mock_conn;
+  MessageReader read_cb(
+      mock_conn, Compatibility::MAX_PROTOCOL_SUPPORTED, 1024 /* pool size */);
+  EXPECT_CALL(mock_conn, validateProtocolHeader(_))
+      .Times(3)
+      .WillRepeatedly(Return(true));
+  EXPECT_CALL(mock_conn, dispatchMessageBody(_, _)).Times(2);
+  ON_CALL(mock_conn, good()).WillByDefault(Return(true));
+  const size_t store_msg_size = 100;
+
+  auto receive_header = [&] {
+    void* bufReturn = nullptr;
+    size_t lenReturn = 0;
+    read_cb.getReadBuffer(&bufReturn, &lenReturn);
+    ASSERT_NE(nullptr, bufReturn);
+    ASSERT_EQ(sizeof(ProtocolHeader), lenReturn);
+    ProtocolHeader* hdr = (ProtocolHeader*)bufReturn;
+    hdr->type = MessageType::STORE;
+    hdr->len = store_msg_size + sizeof(ProtocolHeader);
+    hdr->cksum = 0;
+    read_cb.readDataAvailable(lenReturn);
+  };
+
+  void* first_body = nullptr;
+  size_t lenReturn = 0;
+  receive_header();
+  read_cb.getReadBuffer(&first_body, &lenReturn);
+  ASSERT_NE(nullptr, first_body);
+  ASSERT_EQ(store_msg_size, lenReturn);
+  read_cb.readDataAvailable(store_msg_size);
+
+  void* second_body = nullptr;
+  receive_header();
+  read_cb.getReadBuffer(&second_body, &lenReturn);
+  ASSERT_EQ(store_msg_size, lenReturn);
+  EXPECT_EQ((uint8_t*)first_body + store_msg_size, (uint8_t*)second_body);
+  read_cb.readDataAvailable(store_msg_size);
+
+  // The third body is also read from the pool, right after the second one.
+  void* third_body = nullptr;
+  receive_header();
+  read_cb.getReadBuffer(&third_body, &lenReturn);
+  ASSERT_EQ(store_msg_size, lenReturn);
+  EXPECT_EQ((uint8_t*)second_body + store_msg_size, (uint8_t*)third_body);
+}
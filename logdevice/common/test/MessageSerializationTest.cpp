@@ -16,6 +16,7 @@
 #include "logdevice/common/Processor.h"
 #include "logdevice/common/Worker.h"
 #include "logdevice/common/debug.h"
+#include "logdevice/common/protocol/APPENDS_BATCH_Message.h"
 #include "logdevice/common/protocol/APPEND_Message.h"
 #include "logdevice/common/protocol/CLEAN_Message.h"
 #include "logdevice/common/protocol/DELETE_Message.h"
@@ -25,17 +26,22 @@
 #include "logdevice/common/protocol/HELLO_Message.h"
 #include "logdevice/common/protocol/LOGS_CONFIG_API_Message.h"
 #include "logdevice/common/protocol/MUTATED_Message.h"
+#include "logdevice/common/protocol/RELEASE_Message.h"
 #include "logdevice/common/protocol/MessageDeserializers.h"
 #include "logdevice/common/protocol/MessageTypeNames.h"
+#include "logdevice/common/protocol/ProtocolHeader.h"
 #include "logdevice/common/protocol/ProtocolReader.h"
 #include "logdevice/common/protocol/ProtocolWriter.h"
+#include "logdevice/common/protocol/RECORDS_BATCH_Message.h"
 #include "logdevice/common/protocol/RECORD_Message.h"
 #include "logdevice/common/protocol/SEALED_Message.h"
 #include "logdevice/common/protocol/SHUTDOWN_Message.h"
 #include "logdevice/common/protocol/STARTED_Message.h"
 #include "logdevice/common/protocol/START_Message.h"
 #include "logdevice/common/protocol/STOP_Message.h"
+#include "logdevice/common/protocol/STORES_BATCH_Message.h"
 #include "logdevice/common/protocol/STORE_Message.h"
+#include "logdevice/common/protocol/TRIMS_BATCH_Message.h"
 #include "logdevice/common/request_util.h"
 #include "logdevice/common/test/TestUtil.h"
 #include "logdevice/common/util.h"
@@ -461,6 +467,97 @@ TEST_F(MessageSerializationTest, STORE) {
           nullptr);
 }
 
+TEST_F(MessageSerializationTest, STORES_BATCH) {
+  STORE_Extra extra;
+  extra.rebuilding_version = 0x0123456789abcdef;
+  extra.rebuilding_wave = 3;
+  extra.rebuilding_id = chunk_rebuilding_id_t(42);
+
+  std::vector<std::unique_ptr<STORE_Message>> stores;
+  TestStoreMessageFactory factory;
+  factory.setFlags(STORE_Header::REBUILDING);
+  factory.setExtra(extra, "");
+  stores.push_back(std::make_unique<STORE_Message>(factory.message()));
+  factory.setWave(2);
+  stores.push_back(std::make_unique<STORE_Message>(factory.message()));
+  std::vector<const STORE_Message*> sent = {stores[0].get(), stores[1].get()};
+  STORES_BATCH_Message m(std::move(stores));
+
+  auto check = [&](const STORES_BATCH_Message& m2, uint16_t proto) {
+    ASSERT_EQ(2u, m2.serialized_stores_.size());
+    for (size_t i = 0; i < sent.size(); ++i) {
+      // Each STORE is carried whole, including its ProtocolHeader.
+      std::unique_ptr<folly::IOBuf> buf = m2.serialized_stores_[i]->clone();
+      buf->coalesce();
+      ProtocolHeader ph;
+      const size_t protohdr_bytes =
+          ProtocolHeader::bytesNeeded(MessageType::STORE, proto);
+      ASSERT_GE(buf->length(), protohdr_bytes);
+      memcpy(&ph, buf->data(), protohdr_bytes);
+      EXPECT_EQ(MessageType::STORE, ph.type);
+      EXPECT_EQ(buf->length(), ph.len);
+      buf->trimStart(protohdr_bytes);
+
+      ProtocolReader reader(MessageType::STORE, std::move(buf), proto);
+      std::unique_ptr<Message> msg = STORE_Message::deserialize(reader).msg;
+      ASSERT_NE(nullptr, msg);
+      checkSTORE(*sent[i], dynamic_cast<const STORE_Message&>(*msg), proto);
+    }
+  };
+
+  DO_TEST(m,
+          check,
+          Compatibility::STORES_BATCH_SUPPORT,
+          Compatibility::MAX_PROTOCOL_SUPPORTED,
+          [](uint16_t) { return std::string(); },
+          nullptr);
+}
+
+TEST_F(MessageSerializationTest, TRIMS_BATCH) {
+  std::vector<std::unique_ptr<TRIM_Message>> trims;
+  trims.push_back(std::make_unique<TRIM_Message>(
+      TRIM_Header{request_id_t(1), logid_t(10), lsn_t(100), 0}));
+  trims.push_back(std::make_unique<TRIM_Message>(
+      TRIM_Header{request_id_t(2), logid_t(20), lsn_t(200), 3}));
+  std::vector<TRIM_Header> sent = {
+      trims[0]->getHeader(), trims[1]->getHeader()};
+  TRIMS_BATCH_Message m(std::move(trims));
+
+  auto check = [&](const TRIMS_BATCH_Message& m2, uint16_t proto) {
+    ASSERT_EQ(2u, m2.serialized_trims_.size());
+    for (size_t i = 0; i < sent.size(); ++i) {
+      // Each TRIM is carried whole, including its ProtocolHeader.
+      std::unique_ptr<folly::IOBuf> buf = m2.serialized_trims_[i]->clone();
+      buf->coalesce();
+      ProtocolHeader ph;
+      const size_t protohdr_bytes =
+          ProtocolHeader::bytesNeeded(MessageType::TRIM, proto);
+      ASSERT_GE(buf->length(), protohdr_bytes);
+      memcpy(&ph, buf->data(), protohdr_bytes);
+      EXPECT_EQ(MessageType::TRIM, ph.type);
+      EXPECT_EQ(buf->length(), ph.len);
+      buf->trimStart(protohdr_bytes);
+
+      ProtocolReader reader(MessageType::TRIM, std::move(buf), proto);
+      std::unique_ptr<Message> msg = TRIM_Message::deserialize(reader).msg;
+      ASSERT_NE(nullptr, msg);
+      const TRIM_Header& h =
+          dynamic_cast<const TRIM_Message&>(*msg).getHeader();
+      EXPECT_EQ(sent[i].client_rqid, h.client_rqid);
+      EXPECT_EQ(sent[i].log_id, h.log_id);
+      EXPECT_EQ(sent[i].trim_point, h.trim_point);
+      EXPECT_EQ(sent[i].shard, h.shard);
+    }
+  };
+
+  DO_TEST(m,
+          check,
+          Compatibility::TRIMS_BATCH_SUPPORT,
+          Compatibility::MAX_PROTOCOL_SUPPORTED,
+          [](uint16_t) { return std::string(); },
+          nullptr);
+}
+
 TEST_F(MessageSerializationTest, EmptySTORE) {
   STORE_Extra extra;
   extra.recovery_id = recovery_id_t(0x72555800c6fe911e);
@@ -876,6 +973,59 @@ TEST_F(MessageSerializationTest, APPEND) {
   }
 }
 
+TEST_F(MessageSerializationTest, APPENDS_BATCH) {
+  std::vector<std::unique_ptr<APPEND_Message>> appends;
+  APPEND_Header h1 = {request_id_t(1),
+                      logid_t(10),
+                      EPOCH_INVALID,
+                      1000,
+                      APPEND_Header::CHECKSUM_PARITY};
+  appends.push_back(std::make_unique<APPEND_Message>(
+      h1, LSN_INVALID, AppendAttributes(), PayloadHolder::copyString("ab")));
+  APPEND_Header h2 = {request_id_t(2),
+                      logid_t(20),
+                      EPOCH_INVALID,
+                      2000,
+                      APPEND_Header::CHECKSUM_PARITY |
+                          APPEND_Header::CUSTOM_KEY};
+  AppendAttributes attrs;
+  attrs.optional_keys[KeyType::FINDKEY] = "key";
+  appends.push_back(std::make_unique<APPEND_Message>(
+      h2, LSN_INVALID, attrs, PayloadHolder::copyString("hello")));
+  std::vector<const APPEND_Message*> sent = {
+      appends[0].get(), appends[1].get()};
+  APPENDS_BATCH_Message m(std::move(appends));
+
+  auto check = [&](const APPENDS_BATCH_Message& m2, uint16_t proto) {
+    ASSERT_EQ(2u, m2.serialized_appends_.size());
+    for (size_t i = 0; i < sent.size(); ++i) {
+      // Each APPEND is carried whole, including its ProtocolHeader.
+      std::unique_ptr<folly::IOBuf> buf = m2.serialized_appends_[i]->clone();
+      buf->coalesce();
+      ProtocolHeader ph;
+      const size_t protohdr_bytes =
+          ProtocolHeader::bytesNeeded(MessageType::APPEND, proto);
+      ASSERT_GE(buf->length(), protohdr_bytes);
+      memcpy(&ph, buf->data(), protohdr_bytes);
+      EXPECT_EQ(MessageType::APPEND, ph.type);
+      EXPECT_EQ(buf->length(), ph.len);
+      buf->trimStart(protohdr_bytes);
+
+      ProtocolReader reader(MessageType::APPEND, std::move(buf), proto);
+      std::unique_ptr<Message> msg = APPEND_Message::deserialize(reader).msg;
+      ASSERT_NE(nullptr, msg);
+      checkAPPEND(*sent[i], dynamic_cast<const APPEND_Message&>(*msg), proto);
+    }
+  };
+
+  DO_TEST(m,
+          check,
+          Compatibility::APPENDS_BATCH_SUPPORT,
+          Compatibility::MAX_PROTOCOL_SUPPORTED,
+          [](uint16_t) { return std::string(); },
+          nullptr);
+}
+
 TEST_F(MessageSerializationTest, RECORD) {
   RECORD_Header h = {
       logid_t(0xb1ae6d3809c1cdad),
@@ -982,6 +1132,63 @@ TEST_F(MessageSerializationTest, RECORD_WithWriteStream) {
           deserializer);
 }
 
+TEST_F(MessageSerializationTest, RECORDS_BATCH) {
+  std::vector<std::unique_ptr<RECORD_Message>> records;
+  RECORD_Header h1 = {logid_t(1),
+                      read_stream_id_t(2),
+                      compose_lsn(epoch_t(1), esn_t(5)),
+                      1000,
+                      RECORD_Header::CHECKSUM_PARITY,
+                      3};
+  records.push_back(std::make_unique<RECORD_Message>(
+      h1, TrafficClass::READ_TAIL, PayloadHolder::copyString("ab"), nullptr));
+  // Timestamps of consecutive records may go backwards; the payload is
+  // prefixed with a 64-bit checksum.
+  RECORD_Header h2 = {logid_t(1),
+                      read_stream_id_t(2),
+                      compose_lsn(epoch_t(1), esn_t(8)),
+                      998,
+                      RECORD_Header::CHECKSUM | RECORD_Header::CHECKSUM_64BIT,
+                      3};
+  records.push_back(
+      std::make_unique<RECORD_Message>(h2,
+                                       TrafficClass::READ_TAIL,
+                                       PayloadHolder::copyString("01234567xyz"),
+                                       nullptr));
+  RECORDS_BATCH_Message m(std::move(records), TrafficClass::READ_TAIL);
+
+  auto check = [&](const RECORDS_BATCH_Message& m2, uint16_t /*proto*/) {
+    ASSERT_EQ(2u, m2.records_.size());
+    const RECORD_Message& r1 = *m2.records_[0];
+    EXPECT_EQ(logid_t(1), r1.header_.log_id);
+    EXPECT_EQ(read_stream_id_t(2), r1.header_.read_stream_id);
+    EXPECT_EQ(3, r1.header_.shard);
+    EXPECT_EQ(h1.lsn, r1.header_.lsn);
+    EXPECT_EQ(1000u, r1.header_.timestamp);
+    EXPECT_EQ(h1.flags, r1.header_.flags);
+    EXPECT_EQ("ab", r1.payload_.getPayload().toString());
+    const RECORD_Message& r2 = *m2.records_[1];
+    EXPECT_EQ(h2.lsn, r2.header_.lsn);
+    EXPECT_EQ(998u, r2.header_.timestamp);
+    EXPECT_EQ(h2.flags, r2.header_.flags);
+    // The checksum was stripped from the payload, as in RECORD.
+    EXPECT_EQ("xyz", r2.payload_.getPayload().toString());
+    EXPECT_EQ(0x3736353433323130ul, r2.expected_checksum_);
+  };
+
+  auto expected_fn = [](uint16_t /*proto*/) {
+    return "0100000000000000020000000000000003000200000005000000010000"
+           "00E8030000000000001000000261620C03030B303132333435363778797A";
+  };
+
+  DO_TEST(m,
+          check,
+          Compatibility::RECORDS_BATCH_SUPPORT,
+          Compatibility::MAX_PROTOCOL_SUPPORTED,
+          expected_fn,
+          nullptr);
+}
+
 namespace {
 TailRecord genTailRecord(bool include_payload) {
   TailRecordHeader::flags_t flags =
@@ -1470,6 +1677,43 @@ TEST_F(MessageSerializationTest, MUTATED) {
   }
 }
 
+TEST_F(MessageSerializationTest, RELEASE) {
+  RELEASE_Header h = {RecordID(esn_t(2), epoch_t(3), logid_t(4)),
+                      ReleaseType::GLOBAL,
+                      shard_index_t(7)};
+  OffsetMap epoch_offsets;
+  epoch_offsets.setCounter(BYTE_OFFSET, 0x0102030405060708);
+  RELEASE_Message m(h, epoch_offsets);
+  auto check = [&](const RELEASE_Message& m2, uint16_t proto) {
+    auto& h2 = m2.header_;
+    EXPECT_EQ(2, h2.rid.esn.val());
+    EXPECT_EQ(3, h2.rid.epoch.val());
+    EXPECT_EQ(4, h2.rid.logid.val());
+    EXPECT_EQ(ReleaseType::GLOBAL, h2.release_type);
+    EXPECT_EQ(7, h2.shard);
+    if (proto < Compatibility::RELEASE_EPOCH_OFFSETS_SUPPORT) {
+      EXPECT_FALSE(m2.epoch_offsets_.isValid());
+    } else {
+      EXPECT_EQ(epoch_offsets, m2.epoch_offsets_);
+    }
+  };
+  {
+    std::string expected_old = "02000000030000000400000000000000000700";
+    std::string expected_new = "02000000030000000400000000000000000700"
+                               "01F60807060504030201";
+    DO_TEST(m,
+            check,
+            Compatibility::MIN_PROTOCOL_SUPPORTED,
+            Compatibility::MAX_PROTOCOL_SUPPORTED,
+            [&](uint16_t proto) {
+              return proto >= Compatibility::RELEASE_EPOCH_OFFSETS_SUPPORT
+                  ? expected_new
+                  : expected_old;
+            },
+            nullptr);
+  }
+}
+
 TEST_F(MessageSerializationTest, GET_SEQ_STATE) {
   logid_t log_id(1337);
   request_id_t req_id(7);
@@ -1581,6 +1825,30 @@ TEST_F(MessageSerializationTest, GET_SEQ_STATE) {
             },
             nullptr);
   }
+  {
+    GET_SEQ_STATE_Message gss_recent_records(
+        log_id,
+        req_id,
+        GET_SEQ_STATE_Message::INCLUDE_RECENT_RECORDS,
+        ctx,
+        folly::none,
+        compose_lsn(epoch_t(5), esn_t(9)));
+    DO_TEST(gss_recent_records,
+            [&](const GET_SEQ_STATE_Message& m2, uint16_t /*proto*/) {
+              EXPECT_EQ(GET_SEQ_STATE_Message::INCLUDE_RECENT_RECORDS,
+                        m2.flags_);
+              EXPECT_FALSE(m2.min_epoch_.has_value());
+              EXPECT_EQ(compose_lsn(epoch_t(5), esn_t(9)),
+                        m2.recent_records_after_.value_or(LSN_INVALID));
+            },
+            Compatibility::SEQUENCER_RECENT_RECORDS_SUPPORT,
+            Compatibility::MAX_PROTOCOL_SUPPORTED,
+            [&](uint16_t proto) {
+              return "39050000000000000700000000000000000400001109000000050000"
+                     "00";
+            },
+            nullptr);
+  }
 }
 
 TEST_F(MessageSerializationTest, LOGS_CONFIG_API) {
@@ -10,6 +10,7 @@
 
 #include "logdevice/common/ClusterState.h"
 #include "logdevice/common/HashBasedSequencerLocator.h"
+#include "logdevice/common/SequencerPlacementCache.h"
 #include "logdevice/common/SequencerRouter.h"
 #include "logdevice/common/StaticSequencerLocator.h"
 #include "logdevice/common/configuration/Configuration.h"
@@ -95,8 +96,12 @@ class MockSequencerRouter : public SequencerRouter {
   ClusterState* getClusterState() const override {
     return cluster_state_;
   }
+  SequencerPlacementCache* getPlacementCache() const override {
+    return placement_cache_;
+  }
 
   Settings settings_;
+  SequencerPlacementCache* placement_cache_{nullptr};
   void startClusterStateRefreshTimer() override {}
 
  private:
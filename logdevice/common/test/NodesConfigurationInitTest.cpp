@@ -8,6 +8,8 @@
 
 #include "logdevice/common/NodesConfigurationInit.h"
 
+#include <thread>
+
 #include <folly/futures/Future.h>
 #include <folly/init/Init.h>
 #include <gmock/gmock.h>
@@ -250,6 +252,56 @@ TEST(NodesConfigurationInitTest, WithLongDurationCallback) {
   EXPECT_EQ(*nodes_configuration, *fetched_node_config->get());
 }
 
+TEST(NodesConfigurationInitTest, CacheFile) {
+  auto nodes_configuration = provisionNodes();
+  auto serialized = NodesConfigurationCodec::serialize(*nodes_configuration);
+  TemporaryDirectory temp_dir("NodesConfigurationInitTest");
+
+  Settings settings(create_default_settings<Settings>());
+  settings.nodes_configuration_init_timeout = std::chrono::seconds(1);
+  settings.nodes_configuration_init_retry_timeout =
+      chrono_expbackoff_t<std::chrono::milliseconds>(
+          std::chrono::milliseconds(50), std::chrono::milliseconds(200));
+  settings.nodes_configuration_init_cache_file =
+      (temp_dir.path() / "nodes_configuration").string();
+
+  {
+    // The first fetch writes the cache file.
+    MockNodesConfigurationInit init(
+        std::make_unique<TimeControlledNCS>(
+            serialized, std::chrono::seconds(0)),
+        UpdateableSettings<Settings>(settings));
+    auto fetched_node_config = std::make_shared<UpdateableNodesConfiguration>();
+    EXPECT_TRUE(init.initWithoutProcessor(fetched_node_config));
+  }
+
+  {
+    // The store is unavailable, the config comes from the cache file.
+    MockNodesConfigurationInit init(
+        std::make_unique<TimeControlledNCS>(
+            serialized, std::chrono::seconds(300)),
+        UpdateableSettings<Settings>(settings));
+    auto fetched_node_config = std::make_shared<UpdateableNodesConfiguration>();
+    EXPECT_TRUE(init.initWithoutProcessor(fetched_node_config));
+    ASSERT_NE(nullptr, fetched_node_config->get());
+    EXPECT_EQ(*nodes_configuration, *fetched_node_config->get());
+  }
+
+  {
+    // The cache file is too old to be used.
+    settings.nodes_configuration_init_cache_max_age =
+        std::chrono::milliseconds(0);
+    /* sleep override */
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+    MockNodesConfigurationInit init(
+        std::make_unique<TimeControlledNCS>(
+            serialized, std::chrono::seconds(300)),
+        UpdateableSettings<Settings>(settings));
+    auto fetched_node_config = std::make_shared<UpdateableNodesConfiguration>();
+    EXPECT_FALSE(init.initWithoutProcessor(fetched_node_config));
+  }
+}
+
 } // namespace
 
 int main(int argc, char** argv) {
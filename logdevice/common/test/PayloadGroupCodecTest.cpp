@@ -466,3 +466,46 @@ INSTANTIATE_TEST_CASE_P(EncodeDecodeMatch,
 INSTANTIATE_TEST_CASE_P(EstimateMatch, PayloadGroupEstimatorTest, test_groups);
 
 } // namespace facebook::logdevice
+
+TEST(PayloadGroupDecoderTest, SelectedKeys) {
+  const std::vector<PayloadGroup> payload_groups_in{
+      from_map({{1, "meta1"}, {2, "data1"}}),
+      from_map({{2, "data2"}}),
+      from_map({}),
+      from_map({{1, "meta4"}, {3, "other4"}}),
+  };
+  PayloadGroupCodec::Encoder encoder(payload_groups_in.size());
+  for (const auto& payload_group : payload_groups_in) {
+    encoder.append(payload_group);
+  }
+  folly::IOBufQueue queue;
+  encoder.encode(queue, Compression::ZSTD, 1);
+  folly::IOBuf encoded = queue.moveAsValue();
+  encoded.coalesce();
+
+  auto decode = [&](const std::unordered_set<PayloadKey>& keys) {
+    std::vector<PayloadGroup> payload_groups_out;
+    size_t consumed =
+        PayloadGroupCodec::decode(Slice(encoded.data(), encoded.length()),
+                                  payload_groups_out,
+                                  /* allow_buffer_sharing */ true,
+                                  &keys);
+    EXPECT_EQ(consumed, encoded.length());
+    std::vector<std::unordered_map<PayloadKey, std::string>> result;
+    for (const auto& payload_group : payload_groups_out) {
+      result.push_back(to_map(payload_group));
+    }
+    return result;
+  };
+
+  using Map = std::unordered_map<PayloadKey, std::string>;
+  EXPECT_EQ(
+      (std::vector<Map>{{{1, "meta1"}}, {}, {}, {{1, "meta4"}}}), decode({1}));
+  EXPECT_EQ((std::vector<Map>{{{1, "meta1"}, {2, "data1"}},
+                              {{2, "data2"}},
+                              {},
+                              {{1, "meta4"}}}),
+            decode({1, 2}));
+  // The number of groups is kept even if no payload has the key.
+  EXPECT_EQ((std::vector<Map>(4)), decode({5}));
+}
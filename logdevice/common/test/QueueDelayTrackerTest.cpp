@@ -0,0 +1,43 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/QueueDelayTracker.h"
+
+#include <chrono>
+
+#include <gtest/gtest.h>
+
+namespace facebook { namespace logdevice {
+
+using namespace std::chrono_literals;
+
+TEST(QueueDelayTrackerTest, Basic) {
+  QueueDelayTracker tracker;
+  const auto t0 = std::chrono::steady_clock::now();
+  EXPECT_EQ(0us, tracker.get(t0));
+
+  // Average of the current window.
+  tracker.add(10ms, t0);
+  tracker.add(30ms, t0 + 10ms);
+  EXPECT_EQ(20ms, tracker.get(t0 + 20ms));
+
+  // A new window starts, the previous one counts while it's higher.
+  tracker.add(2ms, t0 + 100ms);
+  EXPECT_EQ(20ms, tracker.get(t0 + 110ms));
+  tracker.add(60ms, t0 + 120ms);
+  EXPECT_EQ(31ms, tracker.get(t0 + 130ms));
+
+  // Once the window is over, only it counts.
+  EXPECT_EQ(31ms, tracker.get(t0 + 250ms));
+
+  // Nothing ran for a whole window: idle.
+  EXPECT_EQ(0us, tracker.get(t0 + 300ms));
+  tracker.add(4ms, t0 + 400ms);
+  EXPECT_EQ(4ms, tracker.get(t0 + 410ms));
+}
+
+}} // namespace facebook::logdevice
@@ -193,6 +193,44 @@ TEST_F(ReaderTestSingleLog, Blocking) {
   producer.join();
 }
 
+/**
+ * Producers on different threads share the capacity of the queue, writes fail
+ * once it is full until read() makes room.
+ */
+TEST_F(ReaderTestSingleLog, QueueFull) {
+  std::vector<std::unique_ptr<DataRecord>> records_out;
+  GapRecord gap_out;
+
+  // 1 log, buffer size 100, flow control threshold 0.5
+  const lsn_t capacity = 151;
+  std::thread producer([&]() {
+    for (lsn_t lsn = 1; lsn <= capacity - 1; ++lsn) {
+      ASSERT_EQ(
+          0, bridge_->onDataRecord(rsid_, make_record(LOG_ID, lsn), false));
+    }
+  });
+  producer.join();
+
+  ASSERT_EQ(
+      0, bridge_->onDataRecord(rsid_, make_record(LOG_ID, capacity), false));
+  auto record = make_record(LOG_ID, capacity + 1);
+  ASSERT_EQ(-1, bridge_->onDataRecord(rsid_, std::move(record), false));
+  // a failed write leaves the record to the caller
+  ASSERT_NE(nullptr, record);
+
+  reader_->setTimeout(std::chrono::milliseconds::zero());
+  ssize_t nread = reader_->read(1, &records_out, &gap_out);
+  ASSERT_EQ(1, nread);
+  ASSERT_EQ(0, bridge_->onDataRecord(rsid_, std::move(record), false));
+
+  nread = reader_->read(capacity + 10, &records_out, &gap_out);
+  ASSERT_EQ(capacity, nread);
+  ASSERT_EQ(capacity + 1, records_out.size());
+  for (lsn_t lsn = 1; lsn <= capacity + 1; ++lsn) {
+    ASSERT_EQ(lsn, records_out[lsn - 1]->attrs.lsn);
+  }
+}
+
 /**
  * If waitOnlyWhenNoData() is called, read() should not block whenever there
  * is some data available to return to the client.
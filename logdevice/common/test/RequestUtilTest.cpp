@@ -58,3 +58,34 @@ TEST(RequestUtilTest, fulfill) {
     EXPECT_EQ(std::move(f).get(), processor->getAllWorkersCount());
   }
 }
+
+TEST(RequestUtilTest, runInBackground) {
+  Settings settings = create_default_settings<Settings>();
+  settings.num_workers = 3;
+  auto processor = make_test_processor(settings);
+
+  folly::Baton<> baton;
+  bool ran_on_worker = false;
+  bool ran_on_background = false;
+  int result = 0;
+  run_on_worker(processor.get(), 1, [&] {
+    run_in_background(
+        processor.get(),
+        RequestType::MISC,
+        [&] {
+          ran_on_background = Worker::onThisThread(false) == nullptr;
+          return 42;
+        },
+        [&](int res) {
+          Worker* w = Worker::onThisThread();
+          ran_on_worker = w && w->idx_.val() == 1;
+          result = res;
+          baton.post();
+        });
+    return 0;
+  });
+  baton.wait();
+  EXPECT_TRUE(ran_on_background);
+  EXPECT_TRUE(ran_on_worker);
+  EXPECT_EQ(42, result);
+}
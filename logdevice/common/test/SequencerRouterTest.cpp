@@ -8,6 +8,7 @@
 #include <folly/Memory.h>
 #include <gtest/gtest.h>
 
+#include "logdevice/common/MetaDataLog.h"
 #include "logdevice/common/SequencerLocator.h"
 #include "logdevice/common/debug.h"
 #include "logdevice/common/test/MockSequencerRouter.h"
@@ -173,6 +174,61 @@ TEST_F(SequencerRouterTest, PreemptedByDeadNode) {
   EXPECT_EQ(E::NOSEQUENCER, status_);
 }
 
+// Tests that a node learned from a redirect is used by later routers for the
+// same log, until it becomes unreachable or dead.
+TEST_F(SequencerRouterTest, PlacementCache) {
+  const NodeID N0(0, 1), N1(1, 1), N2(2, 1);
+
+  // N0 takes care of all logs by default
+  locator_ = std::make_shared<StaticLocator>(N0);
+  auto nodes_config = createSimpleNodesConfig(4);
+  cluster_state_ =
+      std::make_unique<MockClusterState>(nodes_config->clusterSize());
+  SequencerPlacementCache cache;
+  auto create = [&](logid_t log_id) {
+    auto router = std::make_unique<MockSequencerRouter>(
+        log_id, this, nodes_config, locator_, cluster_state_.get());
+    router->placement_cache_ = &cache;
+    return router;
+  };
+
+  auto router = create(logid_t(1));
+  router->start();
+  ASSERT_EQ(std::make_pair(N0, SequencerRouter::flags_t(0)), next_node_);
+  router->onRedirected(N0, N1, E::REDIRECTED);
+  ASSERT_EQ(std::make_pair(N1, SequencerRouter::flags_t(0)), next_node_);
+
+  // Other routers for log 1 and its metadata log go to N1 right away.
+  router = create(logid_t(1));
+  router->start();
+  EXPECT_EQ(std::make_pair(N1, SequencerRouter::flags_t(0)), next_node_);
+  router = create(MetaDataLog::metaDataLogID(logid_t(1)));
+  router->start();
+  EXPECT_EQ(std::make_pair(N1, SequencerRouter::flags_t(0)), next_node_);
+  router = create(logid_t(2));
+  router->start();
+  EXPECT_EQ(std::make_pair(N0, SequencerRouter::flags_t(0)), next_node_);
+
+  // Preemption redirects update the entry. N2 is unreachable, which
+  // invalidates it.
+  router = create(logid_t(1));
+  router->start();
+  router->onRedirected(N1, N2, E::PREEMPTED);
+  ASSERT_EQ(std::make_pair(N2, SequencerRouter::flags_t(0)), next_node_);
+  EXPECT_EQ(N2, cache.get(logid_t(1)).value());
+  router->onNodeUnavailable(N2, E::CONNFAILED);
+  EXPECT_FALSE(cache.get(logid_t(1)).hasValue());
+
+  // Entries of nodes that cluster state says are dead are skipped.
+  router = create(logid_t(1));
+  router->start();
+  router->onRedirected(N0, N1, E::REDIRECTED);
+  cluster_state_->setNodeState(1, ClusterState::NodeState::DEAD);
+  router = create(logid_t(1));
+  router->start();
+  EXPECT_EQ(std::make_pair(N0, SequencerRouter::flags_t(0)), next_node_);
+}
+
 // Tests if the node with the location matching the sequencerAffinity is chosen
 // as the sequencer. If there are none, it makes sure the SequencerLocator
 // still picks something.
@@ -1149,6 +1149,41 @@ TEST_F(SequencerTest, HistoricalMetadataRequest2) {
   ASSERT_EQ(*expected_map, *sequencer_->getMetaDataMap());
 }
 
+// historical metadata is kept when the sequencer becomes unavailable and
+// reused if it gets reactivated on this node
+TEST_F(SequencerTest, HistoricalMetadataAfterUnavailable) {
+  settings_.reactivation_limit = RATE_UNLIMITED;
+  setUp();
+  sequencer_->startActivation([this](logid_t) { return getMetaData(); });
+  completeActivation(5, epoch_t(3));
+  checkHistoricalMetaDataRequestEpoch(epoch_t(5));
+  bool rv = sequencer_->onHistoricalMetaData(
+      E::OK, epoch_t(5), genMetaDataMap({1, 2}), {});
+  ASSERT_FALSE(rv);
+
+  // sequencer becomes unavailable because seq_weight becomes 0
+  sequencer_->noteConfigurationChanged(
+      getConfig(), getNodesConfiguration(), false);
+  ASSERT_EQ(Sequencer::State::UNAVAILABLE, sequencer_->getState());
+  ASSERT_EQ(nullptr, sequencer_->getMetaDataMap());
+
+  // reactivated in epoch 10 with the same metadata
+  sequencer_->startActivation([this](logid_t) { return getMetaData(); });
+  completeActivation(10, epoch_t(3));
+  noHistoricalMetaDataRequested();
+  auto expected_map = genEpochMetaDataMap({1, 2, 3}, epoch_t(10));
+  ASSERT_EQ(*expected_map, *sequencer_->getMetaDataMap());
+
+  // after becoming unavailable again, another sequencer may have changed the
+  // metadata in the meantime: the metadata log must be read
+  sequencer_->noteConfigurationChanged(
+      getConfig(), getNodesConfiguration(), false);
+  ASSERT_EQ(Sequencer::State::UNAVAILABLE, sequencer_->getState());
+  sequencer_->startActivation([this](logid_t) { return getMetaData(); });
+  completeActivation(15, epoch_t(12));
+  checkHistoricalMetaDataRequestEpoch(epoch_t(15));
+}
+
 // TODO: more multi-threaded tests, tests for various race conditions
 
 } // anonymous namespace
@@ -465,3 +465,63 @@ TEST(SlidingWindowTest, ConditionalInsert2) {
   n_reaped = window.retire(compose_lsn(epoch_t(5), esn_t(1)), deleter);
   ASSERT_EQ(2, n_reaped);
 }
+
+TEST(SlidingWindowTest, Expand) {
+  Stats stats;
+  Item::Deleter deleter(&stats);
+  SlidingWindowSingleEpoch<Item, Item::Deleter> window(
+      EPOCH_MIN, 4, ESN_MAX, /* max_capacity */ 10);
+  Item::Deleter::initLastReaped(compose_lsn(EPOCH_MIN, ESN_MIN));
+  ASSERT_EQ(4, window.capacity());
+  ASSERT_EQ(10, window.maxCapacity());
+
+  auto insert = [&] {
+    Item* it = new Item(0);
+    lsn_t lsn = window.grow(it);
+    if (lsn == LSN_INVALID) {
+      delete it;
+    } else {
+      it->id_ = lsn;
+    }
+    return lsn;
+  };
+
+  for (esn_t::raw_type esn = 1; esn <= 4; ++esn) {
+    ASSERT_EQ(compose_lsn(EPOCH_MIN, esn_t(esn)), insert());
+  }
+  ASSERT_EQ(LSN_INVALID, insert());
+  ASSERT_EQ(E::NOBUFS, err);
+
+  // Entries already in the window stay where they are.
+  ASSERT_TRUE(window.expand());
+  ASSERT_EQ(8, window.capacity());
+  for (esn_t::raw_type esn = 5; esn <= 8; ++esn) {
+    ASSERT_EQ(compose_lsn(EPOCH_MIN, esn_t(esn)), insert());
+  }
+  ASSERT_EQ(LSN_INVALID, insert());
+  ASSERT_EQ(8, window.size());
+
+  ASSERT_TRUE(window.expand());
+  ASSERT_EQ(10, window.capacity());
+  ASSERT_FALSE(window.expand());
+  ASSERT_EQ(10, window.capacity());
+  ASSERT_EQ(compose_lsn(EPOCH_MIN, esn_t(9)), insert());
+  ASSERT_EQ(compose_lsn(EPOCH_MIN, esn_t(10)), insert());
+  ASSERT_EQ(LSN_INVALID, insert());
+
+  // Retire out of order; entries must still be reaped in order of ESN and
+  // their slots reused.
+  for (esn_t::raw_type esn = 10; esn >= 2; --esn) {
+    ASSERT_EQ(0, window.retire(compose_lsn(EPOCH_MIN, esn_t(esn)), deleter));
+  }
+  ASSERT_EQ(10, window.retire(compose_lsn(EPOCH_MIN, esn_t(1)), deleter));
+  ASSERT_EQ(0, window.size());
+  for (esn_t::raw_type esn = 11; esn <= 20; ++esn) {
+    ASSERT_EQ(compose_lsn(EPOCH_MIN, esn_t(esn)), insert());
+  }
+  ASSERT_EQ(LSN_INVALID, insert());
+  for (esn_t::raw_type esn = 11; esn <= 20; ++esn) {
+    ASSERT_EQ(1, window.retire(compose_lsn(EPOCH_MIN, esn_t(esn)), deleter));
+  }
+  ASSERT_EQ(20, stats.n_reaped);
+}
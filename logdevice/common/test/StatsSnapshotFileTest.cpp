@@ -0,0 +1,75 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/common/stats/StatsSnapshotFile.h"
+
+#include <folly/FileUtil.h>
+#include <gtest/gtest.h>
+
+#include "logdevice/common/stats/Stats.h"
+#include "logdevice/common/test/TestUtil.h"
+
+using namespace facebook::logdevice;
+
+namespace {
+
+int64_t findCounter(const StatsSnapshot::Counters& counters,
+                    const std::string& name) {
+  for (const auto& kv : counters) {
+    if (kv.first == name) {
+      return kv.second;
+    }
+  }
+  ADD_FAILURE() << "counter " << name << " not found";
+  return -1;
+}
+
+} // namespace
+
+TEST(StatsSnapshotFileTest, Serialization) {
+  StatsHolder holder(StatsParams().setIsServer(true));
+  StatsHolder* stats = &holder;
+  STAT_ADD(stats, store_synced, 42);
+  LOG_GROUP_STAT_ADD(stats, "/my log", append_success, 3);
+  Stats total = holder.aggregate();
+
+  StatsSnapshot snapshot = StatsSnapshot::create({&total}, true);
+  ASSERT_EQ(1, snapshot.stats_sets.size());
+  EXPECT_EQ(42, findCounter(snapshot.stats_sets[0], "store_synced"));
+  EXPECT_EQ(3, findCounter(snapshot.stats_sets[0], "/my_log.append_success"));
+
+  std::string data = snapshot.serialize();
+  StatsSnapshot parsed;
+  ASSERT_TRUE(parsed.deserialize(data));
+  EXPECT_EQ(snapshot.timestamp, parsed.timestamp);
+  EXPECT_EQ(snapshot.stats_sets, parsed.stats_sets);
+
+  // Truncated and unknown versions are rejected.
+  EXPECT_FALSE(parsed.deserialize(folly::StringPiece(data).subpiece(0, 20)));
+  data[4] = 2;
+  EXPECT_FALSE(parsed.deserialize(data));
+}
+
+TEST(StatsSnapshotFileTest, Publisher) {
+  TemporaryDirectory dir("StatsSnapshotFileTest");
+  const std::string path = (dir.path() / "stats").string();
+
+  StatsHolder holder(StatsParams().setIsServer(true));
+  StatsHolder* stats = &holder;
+  STAT_ADD(stats, store_synced, 7);
+  Stats total = holder.aggregate();
+
+  StatsSnapshotFilePublisher publisher(path, false);
+  publisher.publish({&total}, {&total}, std::chrono::seconds(1));
+
+  std::string data;
+  ASSERT_TRUE(folly::readFile(path.c_str(), data));
+  StatsSnapshot parsed;
+  ASSERT_TRUE(parsed.deserialize(data));
+  ASSERT_EQ(1, parsed.stats_sets.size());
+  EXPECT_EQ(7, findCounter(parsed.stats_sets[0], "store_synced"));
+}
@@ -10,6 +10,7 @@
 #include <array>
 #include <atomic>
 #include <condition_variable>
+#include <limits>
 #include <mutex>
 #include <thread>
 #include <unistd.h>
@@ -57,6 +58,35 @@ TEST(StatsTest, StatsAggregateTest) {
   EXPECT_EQ(2, total.records_delivered);
 }
 
+// Per-log stats are updated through a per-thread cache. Increments made after
+// a reset must not go to the entries the reset dropped.
+TEST(StatsTest, PerLogStatsReset) {
+  StatsHolder holder(StatsParams().setIsServer(true));
+  StatsHolder* stats = &holder;
+  auto append_success = [&](const std::string& log_name) -> int64_t {
+    Stats total = holder.aggregate();
+    for (const auto& kv : total.synchronizedCopy(&Stats::per_log_stats)) {
+      if (kv.first == log_name) {
+        return kv.second->append_success;
+      }
+    }
+    return 0;
+  };
+
+  LOG_GROUP_STAT_ADD(stats, "/foo", append_success, 2);
+  LOG_GROUP_STAT_ADD(stats, "/foo", append_success, 3);
+  LOG_GROUP_STAT_ADD(stats, "/bar", append_success, 1);
+  EXPECT_EQ(5, append_success("/foo"));
+  EXPECT_EQ(1, append_success("/bar"));
+
+  holder.reset();
+  EXPECT_EQ(0, append_success("/foo"));
+
+  LOG_GROUP_STAT_ADD(stats, "/foo", append_success, 7);
+  EXPECT_EQ(7, append_success("/foo"));
+  EXPECT_EQ(0, append_success("/bar"));
+}
+
 // This test creates N threads, each of which increments num_connections and
 // store_synced stats. Before threads exit, test asserts that both
 // aggregated counters are N. After threads exit, test that
@@ -310,6 +340,58 @@ TEST(StatsTest, CompactLatencyHistogramShouldGetCumulativeFrequencyCounters) {
   ASSERT_EQ(expected_result2, frequency_counters2);
 }
 
+TEST(StatsTest, LogLinearHistogramBuckets) {
+  using H = LogLinearHistogram;
+  EXPECT_EQ(0, H::valueToIndex(-5));
+  EXPECT_EQ(0, H::valueToIndex(0));
+  EXPECT_EQ(7, H::valueToIndex(7));
+  EXPECT_EQ(8, H::valueToIndex(8));
+  EXPECT_EQ(16, H::valueToIndex(16));
+  EXPECT_EQ(16, H::valueToIndex(17));
+  EXPECT_EQ(H::kNumBuckets - 1,
+            H::valueToIndex(std::numeric_limits<int64_t>::max()));
+
+  // Buckets are contiguous and every value falls into its own bucket.
+  for (size_t i = 1; i + 1 < H::kNumBuckets; ++i) {
+    EXPECT_EQ(H::bucketMin(i) + H::bucketWidth(i), H::bucketMin(i + 1));
+    EXPECT_EQ(i, H::valueToIndex(H::bucketMin(i)));
+    EXPECT_EQ(i, H::valueToIndex(H::bucketMin(i) + H::bucketWidth(i) - 1));
+  }
+}
+
+TEST(StatsTest, LogLinearHistogram) {
+  LogLinearLatencyHistogram h1, h2;
+  for (int64_t v = 1; v <= 1000; ++v) {
+    h1.add(v);
+  }
+  h2.add(1000000);
+
+  // Relative error is at most 1/8.
+  int64_t p50 = h1.estimatePercentile(.5);
+  EXPECT_LE(std::abs(p50 - 500), 500 / 8);
+
+  // Merging snapshots is the same as merging histograms.
+  LogLinearHistogram::Snapshot snapshot = h1.snapshot();
+  snapshot.merge(h2.snapshot());
+  h1.merge(h2);
+  EXPECT_EQ(h1.snapshot().buckets, snapshot.buckets);
+  EXPECT_EQ(1001, h1.getCountAndSum().first);
+  int64_t p100 = h1.estimatePercentile(1.);
+  EXPECT_LE(std::abs(p100 - 1000000), 1000000 / 8);
+
+  h1.subtract(h2);
+  EXPECT_EQ(1000, h1.getCountAndSum().first);
+
+  // Serialization round trip.
+  LogLinearHistogram::Snapshot parsed;
+  std::string serialized = snapshot.serialize();
+  EXPECT_EQ(LogLinearHistogram::kNumBuckets * sizeof(uint64_t),
+            serialized.size());
+  ASSERT_TRUE(parsed.deserialize(serialized));
+  EXPECT_EQ(snapshot.buckets, parsed.buckets);
+  EXPECT_FALSE(parsed.deserialize("foo"));
+}
+
 TEST(StatsTest, PerNodeTimeSeriesSingleThread) {
   StatsHolder holder(
       StatsParams().setIsServer(false).setNodeStatsRetentionTimeOnClients(
@@ -97,6 +97,8 @@ class TestStreamWriterAppendSink : public StreamWriterAppendSink {
   RequestsQueue incoming_queue;
   StreamState stream_state;
   std::unordered_set<StreamAppendRequest*> cancelled;
+  // Returned by getInflightWindow().
+  size_t inflight_window = 0;
 
   TestStreamWriterAppendSink()
       : StreamWriterAppendSink(std::shared_ptr<Processor>(nullptr),
@@ -255,9 +257,7 @@ class TestStreamWriterAppendSink : public StreamWriterAppendSink {
   }
 
   std::unique_ptr<BackoffTimer> createBackoffTimer(Stream& stream) override {
-    auto wrapped_callback = [this, &stream]() {
-      postNextReadyRequestsIfExists(stream, 1);
-    };
+    auto wrapped_callback = [this, &stream]() { retryStream(stream); };
     std::unique_ptr<BackoffTimer> retry_timer =
         std::make_unique<MockBackoffTimer>(true);
     retry_timer->setCallback(wrapped_callback);
@@ -290,6 +290,10 @@ class TestStreamWriterAppendSink : public StreamWriterAppendSink {
     return std::chrono::milliseconds(10000);
   }
 
+  size_t getInflightWindow() noexcept override {
+    return inflight_window;
+  }
+
   epoch_t getSeenEpoch(worker_id_t, logid_t) override {
     return seen_epoch;
   }
@@ -814,3 +818,71 @@ TEST_F(StreamWriterAppendSinkTest,
   ASSERT_EQ(7UL, test_sink_->getMaxPrefixAckedSeqNum(logid).val());
   ASSERT_EQ(7UL, test_sink_->getMaxAckedSeqNum(logid).val());
 }
+
+TEST_F(StreamWriterAppendSinkTest, InflightWindow) {
+  int num_msg_received = 0;
+  auto callback = [&num_msg_received](
+                      Status status, const DataRecord&, NodeID) {
+    ASSERT_EQ(Status::OK, status);
+    num_msg_received++;
+  };
+
+  test_sink_->inflight_window = 2;
+  logid_t logid(1UL);
+  std::vector<TestCommand> cmds;
+  for (auto key : {"a", "b", "c", "d", "e", "f"}) {
+    cmds.push_back(TestCommand::create(ACCEPT, key));
+  }
+  for (auto& cmd : cmds) {
+    appendHelper(logid, cmd, callback);
+  }
+
+  // Only the first two are in flight, each ack lets one more through.
+  ASSERT_EQ(2u, test_sink_->incoming_queue.size());
+  test_sink_->processTestRequests(false);
+  ASSERT_EQ(2, num_msg_received);
+  ASSERT_EQ(2u, test_sink_->incoming_queue.size());
+
+  test_sink_->processTestRequests();
+  ASSERT_EQ(6, num_msg_received);
+  ASSERT_EQ(6UL, test_sink_->getMaxPrefixAckedSeqNum(logid).val());
+}
+
+TEST_F(StreamWriterAppendSinkTest, InflightWindowFastRetransmit) {
+  int num_msg_received = 0;
+  std::queue<std::string> expected_order;
+  for (auto key : {"a", "b", "c", "d"}) {
+    expected_order.push(key);
+  }
+  auto callback = [&num_msg_received, &expected_order](
+                      Status status, const DataRecord& record, NodeID) {
+    ASSERT_EQ(Status::OK, status);
+    num_msg_received++;
+    TestCommand cmd = TestCommand::parsePayload(record.payload);
+    ASSERT_EQ(cmd.key, expected_order.front());
+    expected_order.pop();
+  };
+
+  test_sink_->inflight_window = 4;
+  logid_t logid(1UL);
+  std::vector<TestCommand> cmds;
+  cmds.push_back(TestCommand::create(IGNORE, "a"));
+  cmds.push_back(
+      TestCommand::create(REJECT_ONCE, "b").addArg(toString(E::CONNFAILED)));
+  cmds.push_back(TestCommand::create(ACCEPT, "c"));
+  cmds.push_back(TestCommand::create(ACCEPT, "d"));
+  for (auto& cmd : cmds) {
+    appendHelper(logid, cmd, callback);
+  }
+
+  // "a" stays in flight while "b" fails. "b", "c" and "d" are resent without
+  // waiting for "a" to be acked.
+  test_sink_->processTestRequests(false);
+  ASSERT_EQ(0, num_msg_received);
+  ASSERT_EQ(4u, test_sink_->incoming_queue.size());
+
+  cmds[0].type = ACCEPT;
+  test_sink_->processTestRequests();
+  ASSERT_EQ(4, num_msg_received);
+  ASSERT_EQ(4UL, test_sink_->getMaxPrefixAckedSeqNum(logid).val());
+}
@@ -36,8 +36,7 @@ struct CallbackRequest : public Request {
   folly::Function<void()> callback_;
 };
 
-TEST(Timer, Test) {
-  Settings settings = create_default_settings<Settings>();
+static void testTimers(Settings settings) {
   settings.num_workers = 1;
   auto processor = make_test_processor(settings);
 
@@ -116,6 +115,26 @@ TEST(Timer, Test) {
   ASSERT_EQ(ready.value(), 6);
 }
 
+TEST(Timer, Test) {
+  Settings settings = create_default_settings<Settings>();
+  settings.enable_worker_wheel_timers = true;
+  testTimers(settings);
+}
+
+TEST(Timer, SharedWheelTimer) {
+  Settings settings = create_default_settings<Settings>();
+  settings.enable_worker_wheel_timers = false;
+  settings.enable_hh_wheel_backed_timers = true;
+  testTimers(settings);
+}
+
+TEST(Timer, LibeventTimer) {
+  Settings settings = create_default_settings<Settings>();
+  settings.enable_worker_wheel_timers = false;
+  settings.enable_hh_wheel_backed_timers = false;
+  testTimers(settings);
+}
+
 TEST(Timer, RaceConditionInDestroy) {
   Settings settings = create_default_settings<Settings>();
   settings.num_workers = 1;
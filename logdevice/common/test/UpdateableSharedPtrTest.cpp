@@ -139,3 +139,37 @@ TEST(UpdateableSharedPtrTest, StressTest) {
 
   EXPECT_EQ(0, counter.load());
 }
+
+TEST(UpdateableSharedPtrTest, RCUReadPtr) {
+  std::atomic<int> counter(0);
+  RCUUpdateableSharedPtr<TestObject> ptr(
+      std::make_shared<TestObject>(1, counter));
+  EXPECT_EQ(1, ptr.withReadPtr([](TestObject* obj) { return obj->value; }));
+  EXPECT_EQ(1, ptr.get()->value);
+
+  // An object being read stays alive when it's replaced.
+  ptr.withReadPtr([&](TestObject* obj) {
+    ptr.update(std::make_shared<TestObject>(2, counter));
+    EXPECT_EQ(1, obj->value);
+    EXPECT_EQ(2, ptr.get()->value);
+  });
+  EXPECT_EQ(2, ptr.withReadPtr([](TestObject* obj) { return obj->value; }));
+
+  // Retired objects are destroyed once readers are done.
+  folly::rcu_synchronize();
+  EXPECT_EQ(1, counter.load());
+
+  std::shared_ptr<TestObject> expected = ptr.get();
+  EXPECT_TRUE(
+      ptr.compare_and_swap(expected, std::make_shared<TestObject>(3, counter)));
+  EXPECT_FALSE(
+      ptr.compare_and_swap(expected, std::make_shared<TestObject>(4, counter)));
+  EXPECT_EQ(3, expected->value);
+  EXPECT_EQ(3, ptr.withReadPtr([](TestObject* obj) { return obj->value; }));
+
+  ptr.update(nullptr);
+  EXPECT_EQ(nullptr, ptr.withReadPtr([](TestObject* obj) { return obj; }));
+  expected.reset();
+  folly::rcu_synchronize();
+  EXPECT_EQ(0, counter.load());
+}
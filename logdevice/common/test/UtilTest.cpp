@@ -87,3 +87,18 @@ TEST(UtilTest, SetIfNotNull) {
     EXPECT_EQ(456, **p_ptr);
   }
 }
+
+TEST(UtilTest, ParseCpuList) {
+  std::vector<int> cpus{1};
+  EXPECT_EQ(0, parse_cpu_list("", &cpus));
+  EXPECT_EQ(std::vector<int>(), cpus);
+
+  EXPECT_EQ(0, parse_cpu_list("4,0-2,8-9,1", &cpus));
+  EXPECT_EQ(std::vector<int>({0, 1, 2, 4, 8, 9}), cpus);
+
+  EXPECT_EQ(-1, parse_cpu_list("3-1", &cpus));
+  EXPECT_EQ(-1, parse_cpu_list("-1", &cpus));
+  EXPECT_EQ(-1, parse_cpu_list("1,,2", &cpus));
+  EXPECT_EQ(-1, parse_cpu_list("a-b", &cpus));
+  EXPECT_EQ(std::vector<int>({0, 1, 2, 4, 8, 9}), cpus);
+}
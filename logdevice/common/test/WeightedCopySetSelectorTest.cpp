@@ -805,6 +805,34 @@ TEST_F(WeightedCopySetSelectorTest, Unblacklisting) {
   EXPECT_EQ(std::vector<ShardID>({N2, N0}), cs);
 }
 
+// With locality, select() reuses a cached hierarchy with the local rack
+// detached. Check that it follows nodes going down and coming back up.
+TEST_F(WeightedCopySetSelectorTest, LocalityUnblacklisting) {
+  addNodes("rg.dc.cl.ro.rk0", {1, 1});
+  addNodes("rg.dc.cl.ro.rk1", {1, 1});
+  replication_ = ReplicationProperty({{S::RACK, 2}, {S::NODE, 2}});
+  auto& selector = getSelector(
+      LOG_ID, /* sequencer_node */ -1, /* my_node */ 0, /* locality */ true);
+
+  auto count_local = [&](ShardID local) {
+    int count = 0;
+    std::vector<ShardID> cs;
+    for (int i = 0; i < 50; ++i) {
+      EXPECT_EQ(CopySetSelector::Result::SUCCESS, select(cs, selector));
+      count += std::count(cs.begin(), cs.end(), local);
+    }
+    return count;
+  };
+
+  deps_.setNotAvailableNodes({N0});
+  EXPECT_EQ(0, count_local(N0));
+  EXPECT_EQ(50, count_local(N1));
+  deps_.setNotAvailableNodes({N1});
+  EXPECT_EQ(50, count_local(N0));
+  deps_.setNotAvailableNodes({});
+  EXPECT_GT(count_local(N1), 0);
+}
+
 TEST_F(WeightedCopySetSelectorTest, Augment) {
   addNodes("rg.dc.cl.ro.rk0", {1, 1, 1, 1});
   addNodes("rg.dc.cl.ro.rk1", {1, 1, 1});
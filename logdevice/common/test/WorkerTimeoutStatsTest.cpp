@@ -84,4 +84,28 @@ TEST(WorkerTimeoutStatsTest, StressTest) {
   }
 }
 
+TEST(WorkerTimeoutStatsTest, HedgeBudget) {
+  MockWorkerTimeoutStats stats;
+  EXPECT_FALSE(stats.tryTakeHedgeCredit());
+
+  // 25% of waves: one hedge per 4 waves.
+  for (int i = 0; i < 3; ++i) {
+    stats.addHedgeCredit(0.25);
+  }
+  EXPECT_FALSE(stats.tryTakeHedgeCredit());
+  stats.addHedgeCredit(0.25);
+  EXPECT_TRUE(stats.tryTakeHedgeCredit());
+  EXPECT_FALSE(stats.tryTakeHedgeCredit());
+
+  // Unused credits accumulate up to a cap.
+  for (int i = 0; i < 1000; ++i) {
+    stats.addHedgeCredit(0.5);
+  }
+  int hedges = 0;
+  while (stats.tryTakeHedgeCredit()) {
+    ++hedges;
+  }
+  EXPECT_EQ(10, hedges);
+}
+
 }} // namespace facebook::logdevice
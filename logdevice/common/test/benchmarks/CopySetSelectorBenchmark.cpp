@@ -0,0 +1,282 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+
+#include <folly/Benchmark.h>
+#include <folly/Format.h>
+#include <folly/Singleton.h>
+#include <gflags/gflags.h>
+
+#include "logdevice/common/CrossDomainCopySetSelector.h"
+#include "logdevice/common/EpochMetaData.h"
+#include "logdevice/common/NodeSetState.h"
+#include "logdevice/common/PassThroughCopySetManager.h"
+#include "logdevice/common/StickyCopySetManager.h"
+#include "logdevice/common/WeightedCopySetSelector.h"
+#include "logdevice/common/configuration/ReplicationProperty.h"
+#include "logdevice/common/configuration/logs/DefaultLogAttributes.h"
+#include "logdevice/common/debug.h"
+#include "logdevice/common/test/CopySetSelectorTestUtil.h"
+#include "logdevice/common/test/NodeSetTestUtil.h"
+
+// See StatsJemalloc.h. Used to report bytes allocated per copyset if the
+// binary is linked with jemalloc.
+extern "C" int mallctl(const char*, void*, size_t*, void*, size_t)
+    __attribute__((__nothrow__, __weak__));
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file Benchmarks of copyset selection, which sequencers do for every wave of
+ *       every append: WeightedCopySetSelector and CrossDomainCopySetSelector
+ *       behind a PassThroughCopySetManager, and WeightedCopySetSelector
+ *       behind a StickyCopySetManager. Each runs against nodesets of 10, 100
+ *       and 500 shards, with three failure domain layouts:
+ *        - flat: one rack, replicated across 3 nodes,
+ *        - racks: racks of 5 nodes, replicated across 2 racks,
+ *        - regions: 3 regions with racks of 5 nodes, replicated across
+ *          2 regions.
+ *       Besides time per copyset, each benchmark reports the bytes allocated
+ *       per copyset when running with jemalloc.
+ *
+ *       Run with --bm_min_usec=1000000
+ */
+
+namespace {
+
+const logid_t LOG_ID(1);
+
+enum class Layout { FLAT, RACKS, REGIONS };
+
+const char* layoutName(Layout layout) {
+  switch (layout) {
+    case Layout::FLAT:
+      return "flat";
+    case Layout::RACKS:
+      return "racks";
+    case Layout::REGIONS:
+      return "regions";
+  }
+  return "";
+}
+
+enum class Manager { WEIGHTED, CROSS_DOMAIN, STICKY };
+
+const char* managerName(Manager manager) {
+  switch (manager) {
+    case Manager::WEIGHTED:
+      return "Weighted";
+    case Manager::CROSS_DOMAIN:
+      return "CrossDomain";
+    case Manager::STICKY:
+      return "StickyWeighted";
+  }
+  return "";
+}
+
+// Nodes configuration, nodeset and replication property shared by all
+// copyset managers benchmarked on the same layout and nodeset size.
+struct Cluster {
+  Cluster(Layout layout, size_t nodeset_size) {
+    const size_t nodes_per_rack = 5;
+    for (size_t i = 0; i < nodeset_size; ++i) {
+      std::string location;
+      switch (layout) {
+        case Layout::FLAT:
+          location = "rg0.dc0.cl0.ro0.rk0";
+          break;
+        case Layout::RACKS:
+          location = folly::sformat("rg0.dc0.cl0.ro0.rk{}", i / nodes_per_rack);
+          break;
+        case Layout::REGIONS:
+          location = folly::sformat(
+              "rg{}.dc0.cl0.ro0.rk{}", i % 3, i / (3 * nodes_per_rack));
+          break;
+      }
+      NodeSetTestUtil::addNodes(nodes_config, 1, 1, location);
+      nodeset.push_back(ShardID(i, 0));
+    }
+
+    switch (layout) {
+      case Layout::FLAT:
+        replication = ReplicationProperty({{NodeLocationScope::NODE, 3}});
+        sync_replication_scope = NodeLocationScope::NODE;
+        break;
+      case Layout::RACKS:
+        replication = ReplicationProperty(
+            {{NodeLocationScope::RACK, 2}, {NodeLocationScope::NODE, 3}});
+        sync_replication_scope = NodeLocationScope::RACK;
+        break;
+      case Layout::REGIONS:
+        replication = ReplicationProperty(
+            {{NodeLocationScope::REGION, 2}, {NodeLocationScope::NODE, 3}});
+        sync_replication_scope = NodeLocationScope::REGION;
+        break;
+    }
+  }
+
+  std::unique_ptr<CopySetManager> createManager(Manager manager) {
+    auto nodeset_state = std::make_shared<NodeSetState>(
+        nodeset, LOG_ID, NodeSetState::HealthCheck::DISABLED);
+    std::unique_ptr<CopySetSelector> selector;
+    if (manager == Manager::CROSS_DOMAIN) {
+      selector = std::make_unique<CrossDomainCopySetSelector>(
+          LOG_ID,
+          nodeset,
+          nodeset_state,
+          nodes_config,
+          NodeID(0, 1),
+          replication.getReplicationFactor(),
+          sync_replication_scope,
+          &deps);
+    } else {
+      selector = std::make_unique<WeightedCopySetSelector>(
+          LOG_ID,
+          EpochMetaData(nodeset, replication),
+          nodeset_state,
+          nodes_config,
+          NodeID(0, 1),
+          &log_attrs,
+          /* locality_enabled */ false,
+          /* stats */ nullptr,
+          DefaultRNG::get(),
+          /* print_bias_warnings */ false,
+          &deps);
+    }
+
+    if (manager == Manager::STICKY) {
+      return std::make_unique<StickyCopySetManager>(
+          std::move(selector),
+          nodeset_state,
+          /* sticky_copysets_block_size */ 33554432,
+          /* sticky_copysets_block_max_time */ std::chrono::minutes(10),
+          &deps);
+    }
+    return std::make_unique<PassThroughCopySetManager>(
+        std::move(selector), nodeset_state);
+  }
+
+  std::shared_ptr<const configuration::nodes::NodesConfiguration> nodes_config{
+      std::make_shared<const configuration::nodes::NodesConfiguration>()};
+  StorageSet nodeset;
+  ReplicationProperty replication;
+  NodeLocationScope sync_replication_scope;
+  logsconfig::DefaultLogAttributes log_attrs;
+  // All nodes are available.
+  TestCopySetSelectorDeps deps;
+};
+
+Cluster& getCluster(Layout layout, size_t nodeset_size) {
+  static std::map<std::pair<Layout, size_t>, std::unique_ptr<Cluster>>
+      clusters;
+  auto& cluster = clusters[std::make_pair(layout, nodeset_size)];
+  if (!cluster) {
+    cluster = std::make_unique<Cluster>(layout, nodeset_size);
+  }
+  return *cluster;
+}
+
+// Bytes allocated by the calling thread so far, or 0 without jemalloc.
+uint64_t threadAllocatedBytes() {
+  if (mallctl == nullptr) {
+    return 0;
+  }
+  uint64_t* allocated = nullptr;
+  size_t size = sizeof(allocated);
+  if (mallctl("thread.allocatedp", &allocated, &size, nullptr, 0) != 0 ||
+      allocated == nullptr) {
+    return 0;
+  }
+  return *allocated;
+}
+
+unsigned benchmarkCopySetManager(folly::UserCounters& counters,
+                                 unsigned iters,
+                                 Manager manager_type,
+                                 Layout layout,
+                                 size_t nodeset_size) {
+  std::unique_ptr<CopySetManager> manager;
+  std::unique_ptr<CopySetManager::State> state;
+  BENCHMARK_SUSPEND {
+    manager = getCluster(layout, nodeset_size).createManager(manager_type);
+    state = manager->createState();
+  }
+
+  StoreChainLink copyset[COPYSET_SIZE_MAX];
+  copyset_size_t copyset_size;
+  bool chain;
+  folly::Optional<lsn_t> block_starting_lsn;
+  const uint64_t allocated_before = threadAllocatedBytes();
+  for (unsigned i = 0; i < iters; ++i) {
+    state->reset();
+    auto rv = manager->getCopySet(copyset,
+                                  &copyset_size,
+                                  &chain,
+                                  CopySetManager::AppendContext{100, lsn_t(i)},
+                                  block_starting_lsn,
+                                  *state);
+    ld_check(rv == CopySetSelector::Result::SUCCESS);
+    folly::doNotOptimizeAway(copyset_size);
+  }
+  const uint64_t allocated = threadAllocatedBytes() - allocated_before;
+
+  BENCHMARK_SUSPEND {
+    counters["alloc_bytes_per_op"] = iters ? allocated / iters : 0;
+    state.reset();
+    manager.reset();
+  }
+  return iters;
+}
+
+// Registers a benchmark for each copyset manager, layout and nodeset size.
+struct BenchmarkRegistration {
+  BenchmarkRegistration() {
+    static std::deque<std::string> names;
+    for (Manager manager :
+         {Manager::WEIGHTED, Manager::CROSS_DOMAIN, Manager::STICKY}) {
+      for (Layout layout : {Layout::FLAT, Layout::RACKS, Layout::REGIONS}) {
+        if (manager == Manager::CROSS_DOMAIN && layout == Layout::FLAT) {
+          // CrossDomainCopySetSelector needs a failure domain scope above
+          // NODE.
+          continue;
+        }
+        for (size_t nodeset_size : {10, 100, 500}) {
+          names.push_back(folly::sformat("{}CopySetSelection({},{})",
+                                         managerName(manager),
+                                         layoutName(layout),
+                                         nodeset_size));
+          folly::addBenchmark(
+              __FILE__,
+              names.back().c_str(),
+              [=](folly::UserCounters& counters, unsigned iters) {
+                return benchmarkCopySetManager(
+                    counters, iters, manager, layout, nodeset_size);
+              });
+        }
+      }
+      folly::addBenchmark(__FILE__, "-", []() -> unsigned { return 0; });
+    }
+  }
+} benchmark_registration;
+
+} // namespace
+
+}} // namespace facebook::logdevice
+
+#ifndef BENCHMARK_BUNDLE
+
+int main(int argc, char** argv) {
+  folly::SingletonVault::singleton()->registrationComplete();
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  folly::runBenchmarks();
+  return 0;
+}
+#endif
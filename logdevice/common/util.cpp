@@ -13,11 +13,15 @@
 #include <cstring>
 #include <errno.h>
 #include <limits.h>
+#include <pthread.h>
 #include <pwd.h>
+#include <sched.h>
 #include <signal.h>
 
+#include <folly/Conv.h>
 #include <folly/Format.h>
 #include <folly/Singleton.h>
+#include <folly/String.h>
 #include <folly/synchronization/HazptrThreadPoolExecutor.h>
 #include <sys/prctl.h>
 #include <sys/syscall.h>
@@ -198,6 +202,39 @@ int parse_ioprio(const std::string& val,
   return 0;
 }
 
+int parse_cpu_list(const std::string& val, std::vector<int>* out) {
+  ld_check(out);
+  std::vector<int> res;
+  std::vector<folly::StringPiece> ranges;
+  folly::split(',', val, ranges);
+  for (folly::StringPiece range : ranges) {
+    if (range.empty() && ranges.size() == 1) {
+      break;
+    }
+    int from, to;
+    try {
+      if (range.find('-') != folly::StringPiece::npos) {
+        if (!folly::split('-', range, from, to)) {
+          return -1;
+        }
+      } else {
+        from = to = folly::to<int>(range);
+      }
+    } catch (std::range_error&) {
+      return -1;
+    }
+    if (from < 0 || from > to || to >= CPU_SETSIZE) {
+      return -1;
+    }
+    for (int cpu = from; cpu <= to; ++cpu) {
+      res.push_back(cpu);
+    }
+  }
+  removeDuplicates(&res);
+  *out = std::move(res);
+  return 0;
+}
+
 int parse_compaction_schedule(
     const std::string& val,
     folly::Optional<std::vector<std::chrono::seconds>>& out) {
@@ -528,6 +565,21 @@ int set_io_priority_of_this_thread(std::pair<int, int> prio) {
   return rv;
 }
 
+int set_cpu_affinity_of_this_thread(const std::vector<int>& cpus) {
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (int cpu : cpus) {
+    ld_check(cpu >= 0 && cpu < CPU_SETSIZE);
+    CPU_SET(cpu, &set);
+  }
+  int rv = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+  if (rv != 0) {
+    ld_error("pthread_setaffinity_np() failed: %s", strerror(rv));
+    return -1;
+  }
+  return 0;
+}
+
 int get_io_priority_of_this_thread(std::pair<int, int>* out_prio) {
   int rv = syscall(SYS_ioprio_get,
                    1, // IOPRIO_WHO_PROCESS
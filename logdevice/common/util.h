@@ -189,6 +189,15 @@ int parse_rate_limit(const char* s, rate_limit_t* r);
 int parse_ioprio(const std::string& val,
                  folly::Optional<std::pair<int, int>>* out_prio);
 
+/**
+ * Parse a list of CPUs in the format of /sys/devices/system/cpu/online, e.g.
+ * "0-11,24-35". An empty string gives an empty list.
+ *
+ * @return  0 on success and fills *out with the sorted CPU numbers, -1 if
+ *          the string is not in a correct format
+ */
+int parse_cpu_list(const std::string& val, std::vector<int>* out);
+
 /**
  * Parse a compaction schedule, which isa list of durations, e.g. "3d,7d".
  *
@@ -531,6 +540,13 @@ static bool compare_obj_ptrs(Ptr l, Ptr r) {
 int set_io_priority_of_this_thread(std::pair<int, int> prio);
 int get_io_priority_of_this_thread(std::pair<int, int>* out_prio);
 
+/**
+ * Restricts the calling thread to the given CPUs, e.g. the CPUs of one NUMA
+ * node. Memory the thread touches first is then allocated on that node.
+ * @return 0 on success, -1 on error
+ */
+int set_cpu_affinity_of_this_thread(const std::vector<int>& cpus);
+
 /* Template to remove duplicates from vector of objects */
 template <typename T>
 void removeDuplicates(std::vector<T>* out_objects) {
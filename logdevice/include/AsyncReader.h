@@ -10,6 +10,8 @@
 #include <functional>
 #include <memory>
 
+#include <folly/Range.h>
+
 #include "logdevice/include/Record.h"
 #include "logdevice/include/types.h"
 
@@ -57,6 +59,29 @@ class AsyncReader {
   virtual void
   setRecordCallback(std::function<bool(std::unique_ptr<DataRecord>&)>) = 0;
 
+  /**
+   * Sets a callback that the LogDevice client library will call with runs of
+   * consecutive records of a log, instead of calling the record callback once
+   * per record. This saves the per-record dispatch overhead for readers
+   * consuming at a high rate.
+   *
+   * The callback should return true if all records of the run were
+   * successfully consumed; it may take ownership of any of them by moving out
+   * of the unique_ptrs. If the callback returns false, it must not drain any
+   * of the unique_ptrs, and delivery of the same records will be retried
+   * after some time, possibly in runs of a different length.
+   *
+   * Records decoded from BufferedWriter batches and pseudorecords are
+   * delivered by the record callback if one is set, or in runs of one
+   * record otherwise.
+   *
+   * Either this or the record callback must be set. Only affects subsequent
+   * startReading() calls.
+   */
+  virtual void setRecordBatchCallback(
+      std::function<bool(logid_t, folly::Range<std::unique_ptr<DataRecord>*>)>)
+      = 0;
+
   /**
    * Sets a callback that the LogDevice client library will call when a gap
    * record is delivered for this log. A gap record informs the reader about
@@ -136,8 +161,8 @@ class AsyncReader {
    *          delivery. On failure -1 is returned and logdevice::err is set to
    *             NOBUFS        if request could not be enqueued because a buffer
    *                           space limit was reached
-   *             INVALID_PARAM if from > until or the record callback was not
-   *                           specified.
+   *             INVALID_PARAM if from > until or neither the record callback
+   *                           nor the record batch callback was specified.
    *             SHUTDOWN      the logdevice::Client instance was destroyed.
    *             INTERNAL      An internal error has been detected, check logs.
    *
@@ -8,10 +8,15 @@
 #pragma once
 
 #include <memory>
+#include <unordered_set>
 #include <vector>
 
 #include "logdevice/include/Record.h"
 
+namespace folly {
+class Executor;
+}
+
 namespace facebook { namespace logdevice {
 
 /**
@@ -53,6 +58,8 @@ class BufferedWriteDecoder {
    *
    * PayloadGroup overload:
    * IOBufs in returned PayloadGroups are managed and can outlive the decoder.
+   * Payloads of uncompressed batches share memory with the DataRecord rather
+   * than being copied out of it.
    *
    * It is fine to use the same decoder instance to decode multiple batches of
    * records read from LogDevice. However, the decoder pins memory so it should
@@ -67,6 +74,17 @@ class BufferedWriteDecoder {
   int decode(std::vector<std::unique_ptr<DataRecord>>&& records,
              std::vector<PayloadGroup>& payload_groups_out);
 
+  /**
+   * Same as the PayloadGroup overload of decode(), but decodes the records
+   * on `executor` in parallel, typically a small thread pool shared by
+   * readers of many logs. Payloads are appended to `payload_groups_out' in
+   * the same order as with decode(), so the order of records of each log is
+   * kept. Blocks until all records are decoded.
+   */
+  int decode(std::vector<std::unique_ptr<DataRecord>>&& records,
+             std::vector<PayloadGroup>& payload_groups_out,
+             folly::Executor& executor);
+
   /**
    * Same as decode() but for a single record only.
    *
@@ -78,6 +96,21 @@ class BufferedWriteDecoder {
   int decodeOne(std::unique_ptr<DataRecord>&& record,
                 std::vector<PayloadGroup>& payload_groups_out);
 
+  /**
+   * Same as decodeOne() for PayloadGroups, but only decodes payloads with the
+   * given keys. Payloads of each key are compressed separately, so payloads
+   * with other keys aren't even uncompressed, e.g. a filtering consumer can
+   * decode just a small metadata key of each record. Decoded groups only
+   * contain payloads with the given keys; payloads written as single
+   * payloads have key 0.
+   *
+   * @returns On success, returns 0.  If the DataRecord failed to decode,
+   *          return -1.
+   */
+  int decodeOne(std::unique_ptr<DataRecord>&& record,
+                std::vector<PayloadGroup>& payload_groups_out,
+                const std::unordered_set<PayloadKey>& keys);
+
   /**
    * Decodes record without uncompressing any of the payloads. Batch must be
    * written using PayloadGroups API in BufferedWriter, otherwise decoding will
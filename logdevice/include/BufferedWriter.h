@@ -9,6 +9,7 @@
 
 #include <chrono>
 #include <memory>
+#include <string>
 #include <tuple>
 #include <variant>
 #include <vector>
@@ -171,6 +172,25 @@ class BufferedWriter {
     // bytes buffered (negative for no trigger)
     ssize_t size_trigger = -1;
 
+    // Adaptive flushing (negative to disable).  BufferedWriter adjusts the
+    // size trigger of each log between adaptive_min_size_trigger and
+    // adaptive_max_size_trigger, aiming for appends to complete within this
+    // latency, counting both the time spent buffered and the append round
+    // trip:
+    // - if appends are faster than the target, batches grow to make each
+    //   append cheaper;
+    // - if appends are slower than the target mostly because of buffering,
+    //   batches shrink;
+    // - if they are slower mostly because of the round trip while several
+    //   batches are in flight, LogDevice is the bottleneck, and batches grow
+    //   so that there are fewer of them.
+    // Batches are also flushed once buffered for the target minus the
+    // round trip, unless time_trigger is shorter.  size_trigger, if set, is
+    // the initial size trigger.
+    std::chrono::milliseconds adaptive_latency_target{-1};
+    ssize_t adaptive_min_size_trigger = 1024;
+    ssize_t adaptive_max_size_trigger = 1024 * 1024;
+
     enum class Mode {
       // Write each batch independently (also applies to retries if
       // configured).
@@ -227,6 +247,11 @@ class BufferedWriter {
     // Compression codec.
     Compression compression = Compression::LZ4;
 
+    // With ZSTD compression, ID of a dictionary to compress batches with (see
+    // registerZstdDictionary()). Small batches of similar records compress
+    // much better with a dictionary trained on such records. 0 for none.
+    uint32_t zstd_dictionary_id = 0;
+
     // If set to true, will destroy individual payloads immediately after they
     // are batched together. onSuccess(), onFailure() and onRetry() callbacks
     // will not contain payloads.
@@ -272,6 +297,28 @@ class BufferedWriter {
                                                 AppendCallback* callback,
                                                 Options options = Options());
 
+  /**
+   * Trains a ZSTD dictionary on sample payloads, typically a few thousand
+   * recent records of the logs it will be used for.
+   *
+   * @return the dictionary, or an empty string if training failed (e.g.
+   *         because there were too few samples).
+   */
+  static std::string
+  trainZstdDictionary(const std::vector<std::string>& samples,
+                      size_t max_size = 64 * 1024);
+
+  /**
+   * Makes a dictionary from trainZstdDictionary() available in this
+   * process, both to BufferedWriters (see LogOptions::zstd_dictionary_id)
+   * and to decoding of their batches. Readers of logs written with a
+   * dictionary must register it too, otherwise they fail to decode those
+   * batches. Registered dictionaries are never removed.
+   *
+   * @return ID of the dictionary, or 0 if `dictionary` isn't valid.
+   */
+  static uint32_t registerZstdDictionary(std::string dictionary);
+
   /**
    * Same as Client::append() except the append may get buffered. If the call
    * succeeds it is added into a buffer, and finally appended to the log as a
@@ -49,6 +49,22 @@ class CheckpointStoreFactory {
   createRSMBasedCheckpointStore(std::shared_ptr<Client>& client,
                                 logid_t log_id,
                                 std::chrono::milliseconds stop_timeout);
+
+  /**
+   * Wraps a CheckpointStore so that asynchronous updates are coalesced:
+   * all updates of a customer made within `flush_interval` are written to
+   * `store` at once, with the latest LSN for each log. Use this when
+   * checkpointing many logs frequently, so that the underlying store sees one
+   * update per customer per interval instead of one per log.
+   *
+   * @param store: the store to write the coalesced updates to.
+   * @param flush_interval: how long updates wait to be coalesced. Synchronous
+   *   updates are written right away, along with pending updates of the same
+   *   customer.
+   */
+  std::unique_ptr<CheckpointStore>
+  createBatchingCheckpointStore(std::unique_ptr<CheckpointStore> store,
+                                std::chrono::milliseconds flush_interval);
 };
 
 }} // namespace facebook::logdevice
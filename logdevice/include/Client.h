@@ -13,6 +13,7 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "logdevice/include/AsyncReader.h"
 #include "logdevice/include/ClientFactory.h"
@@ -75,6 +76,17 @@ typedef std::function<void(Status st, const DataRecord& r)> append_callback_t;
  */
 typedef std::function<void(Status, lsn_t result)> find_time_callback_t;
 
+/**
+ * Type of callback that is called when a non-blocking findTimeBatch() request
+ * completes. statuses[i] and results[i] are the outcome of findTime() for the
+ * i-th log passed to findTimeBatch().
+ *
+ * See findTimeBatch() for docs.
+ */
+typedef std::function<void(std::vector<Status> statuses,
+                           std::vector<lsn_t> results)>
+    find_time_batch_callback_t;
+
 /**
  * Type of callback that is called when a non-blocking findKey() request
  * completes.
@@ -107,6 +119,15 @@ typedef std::function<void(Status)> trim_callback_t;
  */
 typedef std::function<void(Status status, bool empty)> is_empty_callback_t;
 
+/**
+ * Type of callback that is called when a non-blocking isLogEmptyBatch()
+ * request completes. statuses[i] and empty[i] are the outcome of
+ * isLogEmpty() for the i-th log passed to isLogEmptyBatch().
+ */
+typedef std::function<void(std::vector<Status> statuses,
+                           std::vector<bool> empty)>
+    is_empty_batch_callback_t;
+
 /**
  * Type of callback that is called when a non-blocking dataSize() request
  * completes.
@@ -188,6 +209,16 @@ typedef std::function<
 typedef std::function<void(Status status, std::unique_ptr<LogTailAttributes>)>
     get_tail_attributes_callback_t;
 
+/**
+ * Type of callback that is called when a non-blocking getTailAttributesBatch()
+ * request completes. statuses[i] and attributes[i] are the outcome of
+ * getTailAttributes() for the i-th log passed to getTailAttributesBatch().
+ */
+typedef std::function<void(
+    std::vector<Status> statuses,
+    std::vector<std::unique_ptr<LogTailAttributes>> attributes)>
+    get_tail_attributes_batch_callback_t;
+
 /**
  * Type of callback that is called when a non-blocking getHeadAttributes()
  * request completes.
@@ -197,6 +228,16 @@ typedef std::function<void(Status status, std::unique_ptr<LogTailAttributes>)>
 typedef std::function<void(Status status, std::unique_ptr<LogHeadAttributes>)>
     get_head_attributes_callback_t;
 
+/**
+ * Type of callback that is called when a non-blocking getHeadAttributesBatch()
+ * request completes. statuses[i] and attributes[i] are the outcome of
+ * getHeadAttributes() for the i-th log passed to getHeadAttributesBatch().
+ */
+typedef std::function<void(
+    std::vector<Status> statuses,
+    std::vector<std::unique_ptr<LogHeadAttributes>> attributes)>
+    get_head_attributes_batch_callback_t;
+
 class Client {
  public:
   /**
@@ -397,6 +438,46 @@ class Client {
                      append_callback_t cb,
                      AppendAttributes attrs = AppendAttributes()) noexcept = 0;
 
+  /**
+   * Appends a new record to the log without blocking, taking ownership of
+   * the payload buffer. The bytes are sent from the buffer as is, without
+   * copying, and the buffer is released once the append completes. Useful
+   * with buffers obtained from a PayloadArena (see PayloadArena.h). Chained
+   * or unmanaged IOBufs are copied into a single managed buffer first.
+   * Behavior is otherwise the same as in append(logid_t, std::string, ...).
+   */
+  virtual int append(logid_t logid,
+                     folly::IOBuf&& payload,
+                     append_callback_t cb,
+                     AppendAttributes attrs = AppendAttributes()) noexcept = 0;
+
+  /**
+   * Appends several records, possibly to different logs, without blocking.
+   * Equivalent to calling append(logid_t, std::string, ...) for each record
+   * in order from the same thread, but cheaper for callers that produce many
+   * appends at once: the records are handed to the client's worker threads
+   * in one submission per worker instead of one per record.
+   *
+   * @param records  (log id, payload) pairs to append
+   *
+   * @param cb       the callback to call once for every record
+   *
+   * @param attrs    additional append attributes, used for all records
+   *
+   * @return  0 if all records were enqueued for delivery. cb will be called
+   *          for each of them. In the rare case the client is shutting down
+   *          while the batch is being enqueued, cb may be called with
+   *          E::SHUTDOWN for some of the records before appendBatch()
+   *          returns.
+   *          On failure -1 is returned, cb will not be called for any record
+   *          and logdevice::err is set as for append(logid_t, std::string,
+   *          ...). Invalid log ids or payloads fail the whole batch.
+   */
+  virtual int
+  appendBatch(std::vector<std::pair<logid_t, std::string>> records,
+              append_callback_t cb,
+              AppendAttributes attrs = AppendAttributes()) noexcept = 0;
+
   /**
    * Creates a Reader object that can be used to read from one or more logs.
    *
@@ -661,6 +742,29 @@ class Client {
            find_time_callback_t cb,
            FindKeyAccuracy accuracy = FindKeyAccuracy::STRICT) noexcept = 0;
 
+  /**
+   * Runs findTime() with the same timestamp for each of `logs`, and calls `cb`
+   * once with the results of all of them. Useful for e.g. positioning readers
+   * of many logs after a restart.
+   *
+   * At most --batch-api-max-in-flight of the lookups are running at any
+   * time, so that a big batch doesn't overflow the request queues of the
+   * client's workers; the rest are started as earlier ones complete.
+   *
+   * @return If the request was successfully submitted for processing, returns
+   * 0.  In that case, the supplied callback is guaranteed to be called at a
+   * later time, on one of the client's worker threads. The per-log statuses
+   * are those of findTime(), plus E::NOBUFS if a lookup couldn't be
+   * submitted. Otherwise, returns -1 with the error:
+   * - E::NOBUFS: Too many requests were pending to be delivered to Workers.
+   * - E::INVALID_PARAM: `logs` is empty.
+   */
+  virtual int findTimeBatch(
+      std::vector<logid_t> logs,
+      std::chrono::milliseconds timestamp,
+      find_time_batch_callback_t cb,
+      FindKeyAccuracy accuracy = FindKeyAccuracy::STRICT) noexcept = 0;
+
   /**
    * A non-blocking version of findKeySync().
    *
@@ -714,6 +818,18 @@ class Client {
    */
   virtual int isLogEmpty(logid_t logid, is_empty_callback_t cb) noexcept = 0;
 
+  /**
+   * Runs isLogEmpty() for each of `logs` and calls `cb` once with the
+   * results of all of them, in the order of `logs`. Like findTimeBatch(),
+   * runs at most --batch-api-max-in-flight requests at a time.
+   *
+   * @return 0 if the request was successfully scheduled. -1 otherwise, with
+   *         err set to E::INVALID_PARAM if `logs` is empty, or to the error
+   *         of isLogEmpty().
+   */
+  virtual int isLogEmptyBatch(std::vector<logid_t> logs,
+                              is_empty_batch_callback_t cb) noexcept = 0;
+
   /**
    * Finds the size of stored data for the given log in the given time range,
    * with accuracy as requested. Please note: this is post-batching and
@@ -874,6 +990,19 @@ class Client {
   virtual int getTailAttributes(logid_t logid,
                                 get_tail_attributes_callback_t cb) noexcept = 0;
 
+  /**
+   * Runs getTailAttributes() for each of `logs` and calls `cb` once with the
+   * results of all of them, in the order of `logs`. Like findTimeBatch(),
+   * runs at most --batch-api-max-in-flight requests at a time.
+   *
+   * @return 0 if the request was successfully scheduled. -1 otherwise, with
+   *         err set to E::INVALID_PARAM if `logs` is empty, or to the error
+   *         of getTailAttributes().
+   */
+  virtual int getTailAttributesBatch(
+      std::vector<logid_t> logs,
+      get_tail_attributes_batch_callback_t cb) noexcept = 0;
+
   /**
    * Return current attributes of the head of the log.
    * See LogHeadAttributes.h docs about possible head attributes.
@@ -906,6 +1035,20 @@ class Client {
    */
   virtual int getHeadAttributes(logid_t logid,
                                 get_head_attributes_callback_t cb) noexcept = 0;
+
+  /**
+   * Runs getHeadAttributes() for each of `logs` and calls `cb` once with the
+   * results of all of them, in the order of `logs`. Like findTimeBatch(),
+   * runs at most --batch-api-max-in-flight requests at a time.
+   *
+   * @return 0 if the request was successfully scheduled. -1 otherwise, with
+   *         err set to E::INVALID_PARAM if `logs` is empty, or to the error
+   *         of getHeadAttributes().
+   */
+  virtual int getHeadAttributesBatch(
+      std::vector<logid_t> logs,
+      get_head_attributes_batch_callback_t cb) noexcept = 0;
+
   /**
    * Looks up the boundaries of a log range by its name as specified
    * in this Client's configuration.
@@ -0,0 +1,83 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+#include <folly/io/IOBuf.h>
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file A pool of preallocated, fixed-size buffers that producers can write
+ *       append payloads into in place, instead of building a std::string
+ *       that the client library then copies or wraps.
+ *
+ *       reserve() hands out one buffer as a folly::IOBuf, to be passed to
+ *       Client::append(logid_t, folly::IOBuf&&, ...). The client sends the
+ *       bytes straight from the buffer to the socket. The buffer goes back to
+ *       the arena once the last reference to it is dropped, i.e. once the
+ *       append completes and its callback has been called, so with a
+ *       bounded number of appends in flight the arena never allocates after
+ *       construction.
+ *
+ *       Buffers may outlive the arena object; its memory is released when
+ *       both the arena and all the buffers are gone.
+ *
+ *       This class is thread-safe.
+ *
+ *       Example:
+ *
+ *         auto arena = PayloadArena::create(4096, 1024);
+ *         std::unique_ptr<folly::IOBuf> buf = arena->reserve(size);
+ *         if (buf) {
+ *           serializeInto(buf->writableData(), size);
+ *           client->append(logid, std::move(*buf), cb);
+ *         }
+ */
+
+class PayloadArena {
+ public:
+  /**
+   * Creates an arena of `nslots` buffers of `slot_size` bytes each, allocated
+   * up front.
+   *
+   * @return  nullptr with err set to INVALID_PARAM if slot_size or nslots
+   *          is zero.
+   */
+  static std::shared_ptr<PayloadArena> create(size_t slot_size,
+                                              size_t nslots);
+
+  /**
+   * Takes a free buffer out of the arena.
+   *
+   * @param size  length of the returned IOBuf, at most slotSize(). The
+   *              caller may shrink it after writing with
+   *              folly::IOBuf::trimEnd().
+   *
+   * @return  an IOBuf pointing into the arena, or nullptr with err set to
+   *            INVALID_PARAM  if size is greater than slotSize()
+   *            NOBUFS         if all buffers are in use
+   */
+  virtual std::unique_ptr<folly::IOBuf> reserve(size_t size) = 0;
+
+  /**
+   * @return  size of each buffer in the arena
+   */
+  virtual size_t slotSize() const = 0;
+
+  /**
+   * @return  number of buffers currently handed out
+   */
+  virtual size_t slotsInUse() const = 0;
+
+  virtual ~PayloadArena() {}
+};
+
+}} // namespace facebook::logdevice
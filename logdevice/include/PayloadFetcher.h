@@ -0,0 +1,79 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include "logdevice/include/Record.h"
+#include "logdevice/include/types.h"
+
+namespace facebook { namespace logdevice {
+
+class Client;
+
+/**
+ * @file Reads the full records at given LSNs of a log. This is the second
+ *       half of two-phase reading for consumers interested in few of the
+ *       records they scan:
+ *
+ *       1. Read the log with a Reader or AsyncReader on which
+ *          withoutPayload() was called, possibly with a ServerRecordFilter
+ *          in ReadStreamAttributes. Storage nodes ship only the record
+ *          headers (LSN, timestamp, offsets) of the records that pass the
+ *          filter.
+ *       2. Pick the records of interest from those headers and fetch their
+ *          payloads with PayloadFetcher::fetch().
+ *
+ *       Only the picked records cross the network with their payloads. Each
+ *       run of consecutive LSNs costs one short read stream, so this pays
+ *       off when the picked records are a small fraction of those scanned.
+ *
+ *       This class is *not* thread-safe - calls should be made from one
+ *       thread at a time.
+ */
+
+class PayloadFetcher {
+ public:
+  /**
+   * Creates a PayloadFetcher reading through `client`.
+   *
+   * @param timeout  limit on how long a fetch() call may wait for records,
+   *                 -1 for no limit
+   *
+   * @return  nullptr on failure, with err set as for Client::createReader()
+   */
+  static std::unique_ptr<PayloadFetcher>
+  create(std::shared_ptr<Client> client,
+         std::chrono::milliseconds timeout = std::chrono::milliseconds(-1));
+
+  /**
+   * Reads the records at `lsns` of log `log_id`, with their payloads.
+   *
+   * @param lsns         LSNs to fetch, in any order. Duplicates are ignored.
+   * @param records_out  the records read are appended to it in LSN order.
+   *                     LSNs that turned out to be gaps (e.g. trimmed since
+   *                     the header was read) have no record.
+   *
+   * @return  0 on success. -1 on failure, with err set to
+   *            TIMEDOUT  if the timeout passed to create() expired before
+   *                      all records were read
+   *            ACCESS    if the client is not allowed to read the log
+   *            any error of Reader::startReading()
+   *          Records read before the failure are still appended to
+   *          `records_out`.
+   */
+  virtual int fetch(logid_t log_id,
+                    std::vector<lsn_t> lsns,
+                    std::vector<std::unique_ptr<DataRecord>>* records_out) = 0;
+
+  virtual ~PayloadFetcher() {}
+};
+
+}} // namespace facebook::logdevice
@@ -26,6 +26,7 @@
 #include "logdevice/common/configuration/UpdateableConfig.h"
 #include "logdevice/common/debug.h"
 #include "logdevice/common/protocol/RECORD_Message.h"
+#include "logdevice/common/request_util.h"
 #include "logdevice/common/settings/Settings.h"
 #include "logdevice/include/Err.h"
 
@@ -37,9 +38,19 @@ AsyncReaderImpl::AsyncReaderImpl(std::shared_ptr<ClientImpl> client,
       processor_(&client_->getProcessor()),
       read_buffer_size_(buffer_size < 0
                             ? processor_->settings()->client_read_buffer_size
-                            : static_cast<size_t>(buffer_size)) {}
+                            : static_cast<size_t>(buffer_size)),
+      migrations_(std::make_shared<Migrations>()) {
+  migrations_->reader = this;
+}
 
 AsyncReaderImpl::~AsyncReaderImpl() {
+  {
+    // Wait for a migration running on a worker, and prevent the ones that did
+    // not run yet from touching this object.
+    std::lock_guard<std::mutex> lock(migrations_->mutex);
+    migrations_->reader = nullptr;
+  }
+
   // The destructor should ensure that all reading is stopped.
   folly::SharedMutex::WriteHolder guard(log_state_mutex_);
 
@@ -93,6 +104,12 @@ void AsyncReaderImpl::setRecordCallback(
   record_callback_ = std::move(cb);
 }
 
+void AsyncReaderImpl::setRecordBatchCallback(
+    std::function<bool(logid_t, folly::Range<std::unique_ptr<DataRecord>*>)>
+        cb) {
+  record_batch_callback_ = std::move(cb);
+}
+
 void AsyncReaderImpl::setGapCallback(std::function<bool(const GapRecord&)> cb) {
   gap_callback_ = std::move(cb);
 }
@@ -198,7 +215,7 @@ bool AsyncReaderImpl::recordCallbackWrapper(
   // must be a DataRecordOwnsPayload. Downcast so we can access the metadata.
   ld_assert(dynamic_cast<DataRecordOwnsPayload*>(record.get()) != nullptr);
 
-  if (!record_callback_) {
+  if (!record_callback_ && !record_batch_callback_) {
     return true;
   }
 
@@ -225,7 +242,7 @@ bool AsyncReaderImpl::recordCallbackWrapper(
       decode_buffered_writes_ && !without_payload_) {
     return handleBufferedWrite(record);
   } else {
-    bool rv = record_callback_(record);
+    bool rv = deliverToApplication(record);
     if (!rv) {
       RATELIMIT_DEBUG(std::chrono::seconds(10),
                       10,
@@ -237,6 +254,24 @@ bool AsyncReaderImpl::recordCallbackWrapper(
   }
 }
 
+bool AsyncReaderImpl::deliverToApplication(
+    std::unique_ptr<DataRecord>& record) {
+  if (record_callback_) {
+    if (!Worker::settings().client_read_stage_timing) {
+      return record_callback_(record);
+    }
+    const auto start = std::chrono::steady_clock::now();
+    bool rv = record_callback_(record);
+    WORKER_STAT_ADD(client_read_callback_usec, usec_since(start));
+    return rv;
+  }
+  // Only a record batch callback was set, deliver a run of one record.
+  ld_check(record_batch_callback_);
+  logid_t log_id = record->logid;
+  return record_batch_callback_(
+      log_id, folly::Range<std::unique_ptr<DataRecord>*>(&record, 1));
+}
+
 int AsyncReaderImpl::startReading(logid_t log_id,
                                   lsn_t from,
                                   lsn_t until,
@@ -257,7 +292,7 @@ int AsyncReaderImpl::startReading(logid_t log_id,
     return -1;
   }
 
-  if (!record_callback_) {
+  if (!record_callback_ && !record_batch_callback_) {
     ld_error("called without specifying record callback for log_id %lu",
              log_id.val_);
     err = E::INVALID_PARAM;
@@ -285,19 +320,63 @@ int AsyncReaderImpl::startReading(logid_t log_id,
 
   // Now construct the ClientReadStream object and pass it to a worker thread
   // by way of a StartReadingRequest.
+  read_stream_id_t rsid = processor_->issueReadStreamID();
+  auto bytes_delivered = std::make_shared<std::atomic<uint64_t>>(0);
+  auto read_stream =
+      createReadStream(rsid, log_id, from, until, attrs, bytes_delivered);
 
-  auto settings = processor_->settings();
+  // Select a worker thread to route the StartReadingRequest to.  We need to
+  // remember it so that we can later route a StopReadingRequest to the same
+  // thread.
+  //
+  // Use load-aware worker assignment to avoid pathological cases like
+  // #7621815.
+  worker_id_t worker_id = processor_->selectWorkerLoadAware();
+  ReadingHandle handle = {worker_id, rsid};
 
-  read_stream_id_t rsid = processor_->issueReadStreamID();
+  {
+    folly::SharedMutex::WriteHolder guard(log_state_mutex_);
+    log_states_.emplace(std::piecewise_construct,
+                        std::forward_as_tuple(log_id),
+                        std::forward_as_tuple(
+                            handle, until, attrs, std::move(bytes_delivered)));
+  }
+
+  std::unique_ptr<Request> req = std::make_unique<StartReadingRequest>(
+      worker_id, log_id, std::move(read_stream));
+
+  int rv = processor_->postRequest(req);
+  if (rv != 0) {
+    folly::SharedMutex::WriteHolder guard(log_state_mutex_);
+    log_states_.erase(log_id);
+  }
+  return rv;
+}
+
+std::unique_ptr<ClientReadStream> AsyncReaderImpl::createReadStream(
+    read_stream_id_t rsid,
+    logid_t log_id,
+    lsn_t from,
+    lsn_t until,
+    const ReadStreamAttributes* attrs,
+    std::shared_ptr<std::atomic<uint64_t>> bytes_delivered) {
+  auto settings = processor_->settings();
 
-  namespace arg = std::placeholders;
   auto deps = std::make_unique<ClientReadStreamDependencies>(
       rsid,
       log_id,
       client_->getClientSessionID(),
-      // Safe to bind to `this', destructor blocks until ClientReadStream is
+      // Safe to capture `this', destructor blocks until ClientReadStream is
       // destroyed
-      std::bind(&AsyncReaderImpl::recordCallbackWrapper, this, arg::_1),
+      [this, bytes_delivered](std::unique_ptr<DataRecord>& record) {
+        const size_t size = record->payload.size();
+        if (!recordCallbackWrapper(record)) {
+          return false;
+        }
+        bytes_delivered->fetch_add(size, std::memory_order_relaxed);
+        maybeRebalanceReadStreams();
+        return true;
+      },
       gap_callback_,
       done_callback_,
       client_->getEpochMetaDataCache(),
@@ -322,7 +401,28 @@ int AsyncReaderImpl::startReading(logid_t log_id,
         }
       });
   deps->setReaderName(reader_name_);
+  if (record_batch_callback_) {
+    deps->setRecordBatchCallback(
+        [this, bytes_delivered](
+            logid_t log,
+            folly::Range<std::unique_ptr<DataRecord>*> records) {
+          size_t size = 0;
+          for (const auto& record : records) {
+            size += record->payload.size();
+          }
+          if (!record_batch_callback_(log, records)) {
+            return false;
+          }
+          bytes_delivered->fetch_add(size, std::memory_order_relaxed);
+          maybeRebalanceReadStreams();
+          return true;
+        });
+  }
 
+  // With window auto-tuning the buffer can hold the largest window, and the
+  // window starts at read_buffer_size_.
+  const bool autotune_window =
+      settings->client_read_buffer_max_size > read_buffer_size_;
   auto read_stream = std::make_unique<ClientReadStream>(
       rsid,
       log_id,
@@ -330,7 +430,8 @@ int AsyncReaderImpl::startReading(logid_t log_id,
       until,
       settings->client_read_flow_control_threshold,
       buffer_type_,
-      read_buffer_size_,
+      autotune_window ? settings->client_read_buffer_max_size
+                      : read_buffer_size_,
       std::move(deps),
       processor_->config_,
       nullptr,
@@ -357,31 +458,164 @@ int AsyncReaderImpl::startReading(logid_t log_id,
     read_stream->includeByteOffset();
   }
 
-  // Select a worker thread to route the StartReadingRequest to.  We need to
-  // remember it so that we can later route a StopReadingRequest to the same
-  // thread.
-  //
-  // Use load-aware worker assignment to avoid pathological cases like
-  // #7621815.
-  worker_id_t worker_id = processor_->selectWorkerLoadAware();
-  ReadingHandle handle = {worker_id, rsid};
+  if (autotune_window) {
+    read_stream->enableWindowAutoTuning(read_buffer_size_);
+  }
+
+  return read_stream;
+}
+
+void AsyncReaderImpl::maybeRebalanceReadStreams() {
+  const auto interval =
+      Worker::settings().client_read_stream_rebalance_interval;
+  if (interval.count() <= 0) {
+    return;
+  }
+  using namespace std::chrono;
+  const int64_t now =
+      duration_cast<nanoseconds>(steady_clock::now().time_since_epoch())
+          .count();
+  int64_t next = next_rebalance_ns_.load(std::memory_order_relaxed);
+  if (now < next) {
+    return;
+  }
+  // Only one worker gets to rebalance.
+  if (!next_rebalance_ns_.compare_exchange_strong(
+          next, now + duration_cast<nanoseconds>(interval).count())) {
+    return;
+  }
+  if (next == 0) {
+    // The first measurement period starts now.
+    return;
+  }
 
+  struct Candidate {
+    logid_t log_id;
+    ReadingHandle handle;
+    uint64_t bytes;
+  };
+  const int nworkers = processor_->getWorkerCount(WorkerType::GENERAL);
+  std::vector<uint64_t> worker_bytes(nworkers, 0);
+  std::vector<Candidate> candidates;
   {
-    folly::SharedMutex::WriteHolder guard(log_state_mutex_);
-    log_states_.emplace(std::piecewise_construct,
-                        std::forward_as_tuple(log_id),
-                        std::forward_as_tuple(handle));
+    folly::SharedMutex::ReadHolder guard(log_state_mutex_);
+    for (auto& kv : log_states_) {
+      const LogState& state = kv.second;
+      const uint64_t bytes = state.bytes_delivered->exchange(0);
+      const int idx = state.handle.worker_id.val_;
+      if (idx < 0 || idx >= nworkers) {
+        continue;
+      }
+      worker_bytes[idx] += bytes;
+      candidates.push_back(Candidate{kv.first, state.handle, bytes});
+    }
+  }
+  if (worker_bytes.size() < 2) {
+    return;
   }
 
-  std::unique_ptr<Request> req = std::make_unique<StartReadingRequest>(
-      worker_id, log_id, std::move(read_stream));
+  const auto hot =
+      std::max_element(worker_bytes.begin(), worker_bytes.end()) -
+      worker_bytes.begin();
+  const auto cold =
+      std::min_element(worker_bytes.begin(), worker_bytes.end()) -
+      worker_bytes.begin();
+  if (worker_bytes[hot] <= 2 * worker_bytes[cold]) {
+    return;
+  }
 
-  int rv = processor_->postRequest(req);
-  if (rv != 0) {
-    folly::SharedMutex::WriteHolder guard(log_state_mutex_);
-    log_states_.erase(log_id);
+  // Moving a stream that delivered `bytes` leaves the two workers with
+  // hot - bytes and cold + bytes. The closer `bytes` is to half the
+  // difference the better. Moving a stream that delivered the whole
+  // difference or more would just swap the two workers.
+  const uint64_t diff = worker_bytes[hot] - worker_bytes[cold];
+  auto distance = [diff](uint64_t bytes) {
+    return bytes * 2 > diff ? bytes * 2 - diff : diff - bytes * 2;
+  };
+  const Candidate* best = nullptr;
+  for (const Candidate& c : candidates) {
+    if (c.handle.worker_id.val_ != hot || c.bytes == 0 || c.bytes >= diff) {
+      continue;
+    }
+    if (!best || distance(c.bytes) < distance(best->bytes)) {
+      best = &c;
+    }
   }
-  return rv;
+  if (!best) {
+    return;
+  }
+
+  ld_debug("Moving read stream of log %lu from W%d (%lu bytes delivered) to "
+           "W%d (%lu bytes delivered)",
+           best->log_id.val_,
+           best->handle.worker_id.val_,
+           worker_bytes[hot],
+           static_cast<int>(cold),
+           worker_bytes[cold]);
+  std::weak_ptr<Migrations> weak(migrations_);
+  auto req = FuncRequest::make(
+      best->handle.worker_id,
+      WorkerType::GENERAL,
+      RequestType::MIGRATE_READ_STREAM,
+      [weak,
+       log_id = best->log_id,
+       handle = best->handle,
+       to = worker_id_t(cold)] {
+        auto migrations = weak.lock();
+        if (!migrations) {
+          return;
+        }
+        std::lock_guard<std::mutex> lock(migrations->mutex);
+        if (migrations->reader) {
+          migrations->reader->migrateReadStream(log_id, handle, to);
+        }
+      });
+  // Best effort, we'll try again after the next interval.
+  processor_->postRequest(req);
+}
+
+void AsyncReaderImpl::migrateReadStream(logid_t log_id,
+                                        ReadingHandle handle,
+                                        worker_id_t to) {
+  Worker* w = Worker::onThisThread();
+  ld_check(w->idx_ == handle.worker_id);
+  ClientReadStream* stream =
+      w->clientReadStreams().getStream(handle.read_stream_id);
+  if (!stream || !stream->canResumeElsewhere()) {
+    return;
+  }
+  // The stream only delivers on this thread, so it cannot deliver anything
+  // else before it is destroyed below.
+  const lsn_t from = stream->getNextLSNToDeliver();
+
+  folly::SharedMutex::WriteHolder guard(log_state_mutex_);
+  auto it = log_states_.find(log_id);
+  if (it == log_states_.end() ||
+      it->second.handle.read_stream_id != handle.read_stream_id ||
+      !it->second.pre_queue.empty()) {
+    // The stream was stopped or restarted, or the application is yet to
+    // accept the rest of a buffered write.
+    return;
+  }
+  LogState& state = it->second;
+
+  read_stream_id_t rsid = processor_->issueReadStreamID();
+  auto read_stream = createReadStream(rsid,
+                                      log_id,
+                                      from,
+                                      state.until,
+                                      state.attrs.get_pointer(),
+                                      state.bytes_delivered);
+  state.handle = ReadingHandle{to, rsid};
+  w->clientReadStreams().erase(handle.read_stream_id);
+
+  std::unique_ptr<Request> req =
+      std::make_unique<StartReadingRequest>(to, log_id, std::move(read_stream));
+  int rv = processor_->postImportant(req);
+  // postImportant() can only fail during Client shutdown. But it's illegal to
+  // destroy a Client while it has an AsyncReader.
+  ld_check(rv == 0);
+  WORKER_STAT_INCR(client_read_streams_migrated);
 }
 
 int AsyncReaderImpl::stopReading(logid_t log_id,
@@ -468,7 +702,15 @@ bool AsyncReaderImpl::handleBufferedWrite(std::unique_ptr<DataRecord>& record) {
   // We use an overload of BufferedWriteDecoderImpl that does not claim
   // ownership of the input DataRecord, in case the client rejects delivery
   // and we need to return the record to ClientReadStream intact.
+  const bool time_decode = Worker::settings().client_read_stage_timing;
+  std::chrono::steady_clock::time_point decode_start;
+  if (time_decode) {
+    decode_start = std::chrono::steady_clock::now();
+  }
   int rv = decoder->decodeOne(*record, payload_groups);
+  if (time_decode) {
+    WORKER_STAT_ADD(client_read_decode_usec, usec_since(decode_start));
+  }
   if (rv != 0) {
     // Whoops, decoding failed. This is tragic and unlikely with checksums
     // but let's generate a DATALOSS gap to inform the client.
@@ -512,7 +754,7 @@ bool AsyncReaderImpl::handleBufferedWrite(std::unique_ptr<DataRecord>& record) {
       log_state->pre_queue.push_back(std::move(sub_record));
       continue;
     }
-    if (!record_callback_(sub_record)) {
+    if (!deliverToApplication(sub_record)) {
       RATELIMIT_DEBUG(std::chrono::seconds(10),
                       10,
                       "Record callback rejected sub-record of record %lu%s",
@@ -582,7 +824,7 @@ int AsyncReaderImpl::drainBufferedRecords(logid_t log_id,
       record_mismatch = true;
     }
 
-    if (!record_callback_(record)) {
+    if (!deliverToApplication(record)) {
       RATELIMIT_DEBUG(std::chrono::seconds(10),
                       10,
                       "Record callback rejected record %lu%s",
@@ -12,6 +12,7 @@
 #include <mutex>
 #include <unordered_map>
 
+#include <folly/Optional.h>
 #include <folly/SharedMutex.h>
 
 #include "logdevice/common/ReadStreamAttributes.h"
@@ -22,6 +23,7 @@
 
 namespace facebook { namespace logdevice {
 
+class ClientReadStream;
 class Semaphore;
 class Processor;
 
@@ -30,6 +32,9 @@ class AsyncReaderImpl : public AsyncReader {
   // see AsyncReader.h for all of these functions:
   void
   setRecordCallback(std::function<bool(std::unique_ptr<DataRecord>&)>) override;
+  void setRecordBatchCallback(
+      std::function<bool(logid_t, folly::Range<std::unique_ptr<DataRecord>*>)>)
+      override;
   void setGapCallback(std::function<bool(const GapRecord&)>) override;
   void setDoneCallback(std::function<void(logid_t)>) override;
   void setHealthChangeCallback(
@@ -65,6 +70,27 @@ class AsyncReaderImpl : public AsyncReader {
   ~AsyncReaderImpl() override;
 
  private:
+  // Creates the read stream of a log, delivering records from `from`.
+  // `bytes_delivered` is bumped by the size of each record it delivers.
+  std::unique_ptr<ClientReadStream>
+  createReadStream(read_stream_id_t rsid,
+                   logid_t log_id,
+                   lsn_t from,
+                   lsn_t until,
+                   const ReadStreamAttributes* attrs,
+                   std::shared_ptr<std::atomic<uint64_t>> bytes_delivered);
+
+  // Called by read streams after delivering a record. Once every
+  // --client-read-stream-rebalance-interval, compares the bytes delivered on
+  // each worker and, if the busiest one delivered more than twice as much as
+  // the least busy one, moves a read stream between them.
+  void maybeRebalanceReadStreams();
+
+  // Runs on the worker of `handle`. Replaces the read stream of `log_id` by a
+  // new one on worker `to` that resumes where it stopped delivering. Does
+  // nothing if the stream was stopped or is in the middle of a delivery.
+  void migrateReadStream(logid_t log_id, ReadingHandle handle, worker_id_t to);
+
   void postStopReadingRequest(ReadingHandle handle, std::function<void()> cb);
   void postStatisticsRequest(std::vector<ReadingHandle> handles,
                              std::function<void(size_t)> cb) const;
@@ -73,6 +99,10 @@ class AsyncReaderImpl : public AsyncReader {
   // automatic decoding of buffered writes
   bool recordCallbackWrapper(std::unique_ptr<DataRecord>& record);
 
+  // Calls the record callback of the application, or the record batch
+  // callback with a run of one record if only that one was set.
+  bool deliverToApplication(std::unique_ptr<DataRecord>& record);
+
   // Handles a record that is a buffered write and needs automatic decoding
   bool handleBufferedWrite(std::unique_ptr<DataRecord>& record);
 
@@ -92,6 +122,8 @@ class AsyncReaderImpl : public AsyncReader {
   Processor* processor_;
 
   std::function<bool(std::unique_ptr<DataRecord>&)> record_callback_;
+  std::function<bool(logid_t, folly::Range<std::unique_ptr<DataRecord>*>)>
+      record_batch_callback_;
   std::function<bool(const GapRecord&)> gap_callback_;
   std::function<void(logid_t)> done_callback_;
   std::function<void(logid_t, HealthChangeType)> health_change_callback_;
@@ -126,10 +158,28 @@ class AsyncReaderImpl : public AsyncReader {
   ClientReadStreamBufferType buffer_type_{ClientReadStreamBufferType::CIRCULAR};
 
   struct LogState {
-    explicit LogState(ReadingHandle handle) : handle(handle) {}
+    LogState(ReadingHandle handle,
+             lsn_t until,
+             const ReadStreamAttributes* attrs,
+             std::shared_ptr<std::atomic<uint64_t>> bytes_delivered)
+        : handle(handle),
+          until(until),
+          bytes_delivered(std::move(bytes_delivered)) {
+      if (attrs) {
+        this->attrs = *attrs;
+      }
+    }
     // ReadingHandle generated when we started reading, used to stop reading
-    // (which requires communication with Worker)
-    const ReadingHandle handle;
+    // (which requires communication with Worker). Changes when the read
+    // stream is moved to another worker.
+    ReadingHandle handle;
+    // Arguments of startReading(), needed to recreate the read stream on
+    // another worker.
+    const lsn_t until;
+    folly::Optional<ReadStreamAttributes> attrs;
+    // Bytes of records delivered since the last rebalancing of read streams.
+    // Bumped on the Worker thread by the read stream's record callback.
+    std::shared_ptr<std::atomic<uint64_t>> bytes_delivered;
     // Connection health for the log as reported by ClientReadStream.  Read
     // from application thread, written on Worker thread (ClientReadStream
     // health callback).
@@ -159,6 +209,19 @@ class AsyncReaderImpl : public AsyncReader {
   std::shared_ptr<PendingStops> pending_stops_ =
       std::make_shared<PendingStops>();
 
+  // Steady clock time, in nanoseconds, of the next rebalancing of read
+  // streams across workers. 0 until the first record is delivered.
+  std::atomic<int64_t> next_rebalance_ns_{0};
+
+  // Read stream migrations posted to workers hold a weak reference to this.
+  // The destructor clears `reader` under `mutex`, so migrations that did not
+  // run yet do nothing.
+  struct Migrations {
+    std::mutex mutex;
+    AsyncReaderImpl* reader;
+  };
+  std::shared_ptr<Migrations> migrations_;
+
   // Use to gather info for a pending stats Request.
   // Trigger callback once there are no more leftover requests.
   struct RequestAcc {
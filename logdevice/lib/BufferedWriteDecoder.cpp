@@ -34,6 +34,13 @@ int BufferedWriteDecoder::decode(
   return impl()->decode(std::move(records), payload_groups_out);
 }
 
+int BufferedWriteDecoder::decode(
+    std::vector<std::unique_ptr<DataRecord>>&& records,
+    std::vector<PayloadGroup>& payload_groups_out,
+    folly::Executor& executor) {
+  return impl()->decode(std::move(records), payload_groups_out, executor);
+}
+
 int BufferedWriteDecoder::decodeOne(std::unique_ptr<DataRecord>&& record,
                                     std::vector<Payload>& payloads_out) {
   return impl()->decodeOne(std::move(record), payloads_out);
@@ -45,6 +52,13 @@ int BufferedWriteDecoder::decodeOne(
   return impl()->decodeOne(std::move(record), payload_groups_out);
 }
 
+int BufferedWriteDecoder::decodeOne(
+    std::unique_ptr<DataRecord>&& record,
+    std::vector<PayloadGroup>& payload_groups_out,
+    const std::unordered_set<PayloadKey>& keys) {
+  return impl()->decodeOne(std::move(record), payload_groups_out, &keys);
+}
+
 int BufferedWriteDecoder::decodeOneCompressed(
     std::unique_ptr<DataRecord>&& record,
     CompressedPayloadGroups& compressed_payload_groups_out) {
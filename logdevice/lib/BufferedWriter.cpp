@@ -11,12 +11,23 @@
 
 #include "logdevice/common/StreamWriterAppendSink.h"
 #include "logdevice/common/buffered_writer/BufferedWriterImpl.h"
+#include "logdevice/common/buffered_writer/ZstdDictionaryRegistry.h"
 #include "logdevice/common/util.h"
 #include "logdevice/lib/ClientImpl.h"
 #include "logdevice/lib/ClientProcessor.h"
 
 namespace facebook { namespace logdevice {
 
+std::string
+BufferedWriter::trainZstdDictionary(const std::vector<std::string>& samples,
+                                    size_t max_size) {
+  return ZstdDictionaryRegistry::train(samples, max_size);
+}
+
+uint32_t BufferedWriter::registerZstdDictionary(std::string dictionary) {
+  return ZstdDictionaryRegistry::get().add(std::move(dictionary));
+}
+
 std::unique_ptr<BufferedWriter>
 BufferedWriter::create(std::shared_ptr<Client> client,
                        AppendCallback* callback,
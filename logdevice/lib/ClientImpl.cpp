@@ -7,11 +7,13 @@
  */
 #include "logdevice/lib/ClientImpl.h"
 
+#include <algorithm>
 #include <chrono>
 #include <unordered_map>
 
 #include <boost/algorithm/string.hpp>
 #include <folly/Memory.h>
+#include <folly/hash/Hash.h>
 #include <folly/Random.h>
 
 #include "logdevice/common/AppendRequest.h"
@@ -60,6 +62,7 @@
 #include "logdevice/lib/ClientProcessor.h"
 #include "logdevice/lib/ClientSettingsImpl.h"
 #include "logdevice/lib/ClusterAttributesImpl.h"
+#include "logdevice/lib/LogBatch.h"
 #include "logdevice/lib/LogsConfigTypesImpl.h"
 #include "logdevice/lib/shadow/Shadow.h"
 
@@ -116,8 +119,17 @@ ClientImpl::ClientImpl(std::string cluster_name,
 
   const size_t metadata_cache_size = settings->client_epoch_metadata_cache_size;
   if (metadata_cache_size > 0) {
-    epoch_metadata_cache_ =
-        std::make_unique<EpochMetaDataCache>(metadata_cache_size);
+    const size_t metadata_cache_shards =
+        settings->client_epoch_metadata_cache_shards;
+    if (settings->client_epoch_metadata_cache_shared) {
+      epoch_metadata_cache_ = EpochMetaDataCache::getForCluster(
+          config_->get()->serverConfig()->getClusterName(),
+          metadata_cache_size,
+          metadata_cache_shards);
+    } else {
+      epoch_metadata_cache_ = std::make_shared<EpochMetaDataCache>(
+          metadata_cache_size, metadata_cache_shards);
+    }
   }
 
   if (settings->stats_collection_interval.count() > 0 ||
@@ -304,6 +316,27 @@ ClientImpl::~ClientImpl() {
           cluster_name_.c_str());
 }
 
+// We need payload to be owned by a folly::IOBuf rather than an std::string.
+// If payload is small, let's just make a copy. If payload is large, we'll
+// use a custom deleter function to avoid copying.
+static PayloadHolder payloadHolderFromString(std::string payload) {
+  if (payload.size() < 256) {
+    return PayloadHolder(
+        PayloadHolder::COPY_BUFFER, payload.data(), payload.size());
+  }
+  std::string* string_on_heap = new std::string(std::move(payload));
+  folly::IOBuf::FreeFunction deleter = +[](void* /* buf */, void* userData) {
+    delete reinterpret_cast<std::string*>(userData);
+  };
+  return PayloadHolder(
+      folly::IOBuf(folly::IOBuf::TAKE_OWNERSHIP,
+                   string_on_heap->data(),
+                   string_on_heap->size(),
+                   deleter,
+                   /* userData */ reinterpret_cast<void*>(string_on_heap)),
+      /* ignore_size_limit */ true);
+}
+
 int ClientImpl::append(logid_t logid,
                        const Payload& payload,
                        append_callback_t cb,
@@ -336,29 +369,8 @@ int ClientImpl::append(logid_t logid,
                        AppendAttributes attrs,
                        worker_id_t target_worker,
                        std::unique_ptr<std::string> per_request_token) {
-  // We need payload to be owned by a folly::IOBuf rather than an std::string.
-  // If payload is small, let's just make a copy. If payload is large, we'll
-  // use a custom deleter function to avoid copying.
-  PayloadHolder payload_holder;
-  if (payload.size() < 256) {
-    payload_holder = PayloadHolder(
-        PayloadHolder::COPY_BUFFER, payload.data(), payload.size());
-  } else {
-    std::string* string_on_heap = new std::string(std::move(payload));
-    folly::IOBuf::FreeFunction deleter = +[](void* /* buf */, void* userData) {
-      delete reinterpret_cast<std::string*>(userData);
-    };
-    payload_holder = PayloadHolder(
-        folly::IOBuf(folly::IOBuf::TAKE_OWNERSHIP,
-                     string_on_heap->data(),
-                     string_on_heap->size(),
-                     deleter,
-                     /* userData */ reinterpret_cast<void*>(string_on_heap)),
-        /* ignore_size_limit */ true);
-  }
-
   auto req = prepareRequest(logid,
-                            std::move(payload_holder),
+                            payloadHolderFromString(std::move(payload)),
                             cb,
                             std::move(attrs),
                             target_worker,
@@ -441,7 +453,8 @@ std::pair<Status, NodeID> ClientImpl::appendBuffered(
   return std::make_pair(rv == 0 ? E::OK : err, NodeID());
 }
 
-int ClientImpl::postAppend(std::unique_ptr<AppendRequest> req_append) {
+std::unique_ptr<AppendRequest>
+ClientImpl::prepareForPosting(std::unique_ptr<AppendRequest> req_append) {
   if (append_error_injector_) {
     // with the set probability of the error injector, maybe replace the request
     // with and append request that is sure to fail
@@ -452,13 +465,15 @@ int ClientImpl::postAppend(std::unique_ptr<AppendRequest> req_append) {
 
   req_append->setAppendProbeController(&processor_->appendProbeController());
 
-  // First perform shadowing. since postRequest can invalidate pointer
+  // Perform shadowing before posting, since posting invalidates the pointer
   if (shadow_ != nullptr) { // Is only null for shadow clients
     shadow_->appendShadow(*req_append.get());
   }
+  return req_append;
+}
 
-  // Then post original client request
-  std::unique_ptr<Request> req(std::move(req_append));
+int ClientImpl::postAppend(std::unique_ptr<AppendRequest> req_append) {
+  std::unique_ptr<Request> req(prepareForPosting(std::move(req_append)));
   int rv = processor_->postRequest(req);
   if (rv != 0) {
     // Instruct ~AppendRequest not to invoke the callback
@@ -470,6 +485,63 @@ int ClientImpl::postAppend(std::unique_ptr<AppendRequest> req_append) {
   return rv;
 }
 
+int ClientImpl::appendBatch(
+    std::vector<std::pair<logid_t, std::string>> records,
+    append_callback_t cb,
+    AppendAttributes attrs) noexcept {
+  if (records.empty()) {
+    return 0;
+  }
+
+  std::vector<logid_t> logids;
+  std::vector<std::unique_ptr<Request>> reqs;
+  logids.reserve(records.size());
+  reqs.reserve(records.size());
+  for (auto& record : records) {
+    auto req = prepareRequest(record.first,
+                              payloadHolderFromString(std::move(record.second)),
+                              cb,
+                              attrs,
+                              worker_id_t{-1},
+                              nullptr);
+    if (!req) {
+      // err was set by prepareRequest(). Fail the whole batch.
+      const Status st = err;
+      for (auto& prepared : reqs) {
+        static_cast<AppendRequest*>(prepared.get())->setFailedToPost();
+      }
+      reqs.clear();
+      err = st;
+      return -1;
+    }
+    logids.push_back(record.first);
+    reqs.push_back(prepareForPosting(std::move(req)));
+  }
+
+  if (processor_->postRequestBatch(reqs) == 0) {
+    return 0;
+  }
+  const Status st = err;
+  const bool any_posted = std::any_of(
+      reqs.begin(), reqs.end(), [](const auto& req) { return !req; });
+  for (size_t i = 0; i < reqs.size(); ++i) {
+    if (!reqs[i]) {
+      continue;
+    }
+    // Instruct ~AppendRequest not to invoke the callback
+    static_cast<AppendRequest*>(reqs[i].get())->setFailedToPost();
+    AppendRequest::bumpStatForOutcome(stats_.get(), st);
+    if (any_posted) {
+      // Part of the batch made it to workers, report the rest through the
+      // callback so that the caller sees exactly one outcome per record.
+      cb(st, DataRecord(logids[i], Payload()));
+    }
+  }
+  reqs.clear();
+  err = st;
+  return any_posted ? 0 : -1;
+}
+
 /**
  * AppendGate is a synchronization functor for appendSync().
  */
@@ -582,6 +654,31 @@ int ClientImpl::append(logid_t logid,
                 nullptr);
 }
 
+int ClientImpl::append(logid_t logid,
+                       folly::IOBuf&& payload,
+                       append_callback_t cb,
+                       AppendAttributes attrs) noexcept {
+  // PayloadHolder needs a single managed buffer. Buffers from PayloadArena
+  // are, so they're sent without a copy.
+  if (payload.isChained()) {
+    payload.coalesce();
+  }
+  if (!payload.isManaged()) {
+    payload.makeManaged();
+  }
+  auto req = prepareRequest(
+      logid,
+      PayloadHolder(std::move(payload), /* ignore_size_limit */ true),
+      std::move(cb),
+      std::move(attrs),
+      worker_id_t{-1},
+      nullptr);
+  if (!req) {
+    return -1;
+  }
+  return postAppend(std::move(req));
+}
+
 lsn_t ClientImpl::appendSync(logid_t logid,
                              const Payload& payload,
                              AppendAttributes attrs,
@@ -1645,6 +1742,31 @@ int ClientImpl::findTime(logid_t logid,
   return processor_->postRequest(req);
 }
 
+int ClientImpl::findTimeBatch(std::vector<logid_t> logs,
+                              std::chrono::milliseconds timestamp,
+                              find_time_batch_callback_t cb,
+                              FindKeyAccuracy accuracy) noexcept {
+  auto timeout = settings_->getSettings()->findkey_timeout.value_or(timeout_);
+  return LogBatch<lsn_t>::start(
+      processor_,
+      std::move(logs),
+      settings_->getSettings()->batch_api_max_in_flight,
+      [timestamp, timeout, accuracy](
+          logid_t log, LogBatch<lsn_t>::done_callback_t done) {
+        return std::make_unique<FindKeyRequest>(
+            log,
+            timestamp,
+            folly::none,
+            timeout,
+            [done](const FindKeyRequest&, Status st, lsn_t result) {
+              done(st, result);
+            },
+            find_key_callback_ex_t(),
+            accuracy);
+      },
+      std::move(cb));
+}
+
 FindKeyResult ClientImpl::findKeySync(logid_t logid,
                                       std::string key,
                                       FindKeyAccuracy accuracy) noexcept {
@@ -1773,6 +1895,37 @@ int ClientImpl::isLogEmpty(logid_t logid, is_empty_callback_t cb) noexcept {
   return processor_->postRequest(req);
 }
 
+int ClientImpl::isLogEmptyBatch(std::vector<logid_t> logs,
+                                is_empty_batch_callback_t cb) noexcept {
+  auto timeout = settings_->getSettings()->meta_api_timeout.value_or(timeout_);
+  return LogBatch<bool>::start(
+      processor_,
+      std::move(logs),
+      settings_->getSettings()->batch_api_max_in_flight,
+      [timeout](logid_t log, LogBatch<bool>::done_callback_t done) {
+        auto req = std::make_unique<SyncSequencerRequest>(
+            log,
+            SyncSequencerRequest::INCLUDE_IS_LOG_EMPTY,
+            [done](Status st,
+                   NodeID /*seq*/,
+                   lsn_t /*next_lsn*/,
+                   std::unique_ptr<LogTailAttributes> /*tail_attributes*/,
+                   std::shared_ptr<const EpochMetaDataMap> /*metadata_map*/,
+                   std::shared_ptr<TailRecord> /*tail_record*/,
+                   folly::Optional<bool> is_log_empty) {
+              ld_check(is_log_empty.has_value() || st != E::OK);
+              done(st, is_log_empty.value_or(false));
+            },
+            GetSeqStateRequest::Context::IS_LOG_EMPTY_V2,
+            timeout);
+        req->setCompleteIfLogNotFound(true);
+        req->setCompleteIfAccessDenied(true);
+        req->setPreventMetadataLogs(true);
+        return req;
+      },
+      std::move(cb));
+}
+
 namespace {
 struct DataSizeGate {
   void operator()(Status status, size_t size) {
@@ -1970,6 +2123,38 @@ int ClientImpl::getTailAttributes(logid_t logid,
   return processor_->postRequest(req);
 }
 
+int ClientImpl::getTailAttributesBatch(
+    std::vector<logid_t> logs,
+    get_tail_attributes_batch_callback_t cb) noexcept {
+  using Batch = LogBatch<std::unique_ptr<LogTailAttributes>>;
+  auto timeout = settings_->getSettings()->meta_api_timeout.value_or(timeout_);
+  return Batch::start(
+      processor_,
+      std::move(logs),
+      settings_->getSettings()->batch_api_max_in_flight,
+      [timeout](logid_t log, Batch::done_callback_t done) {
+        return std::make_unique<SyncSequencerRequest>(
+            log,
+            SyncSequencerRequest::INCLUDE_TAIL_ATTRIBUTES,
+            [done](Status st,
+                   NodeID /*seq*/,
+                   lsn_t /*next_lsn*/,
+                   std::unique_ptr<LogTailAttributes> tail_attributes,
+                   std::shared_ptr<const EpochMetaDataMap> /*unused*/,
+                   std::shared_ptr<TailRecord> /*unused*/,
+                   folly::Optional<bool> /*unused*/) {
+              // Same as getTailAttributes().
+              if (st == E::OK && !tail_attributes) {
+                st = E::AGAIN;
+              }
+              done(st, std::move(tail_attributes));
+            },
+            GetSeqStateRequest::Context::GET_TAIL_ATTRIBUTES,
+            timeout);
+      },
+      std::move(cb));
+}
+
 std::shared_ptr<const EpochMetaDataMap>
 ClientImpl::getHistoricalMetaDataSync(logid_t logid) noexcept {
   std::shared_ptr<const EpochMetaDataMap> historical_metadata;
@@ -2124,6 +2309,47 @@ int ClientImpl::readLogTail(logid_t logid, read_tail_callback_t cb) noexcept {
   return getTailRecord(logid, std::move(cb_wrapper));
 }
 
+int ClientImpl::readRecentRecords(logid_t logid,
+                                  lsn_t after,
+                                  recent_records_callback_t cb) noexcept {
+  GetSeqStateRequest::Options opts;
+  opts.recent_records_after = after;
+  // released records are final, there is no need to check that the sequencer
+  // is not preempted
+  opts.skip_remote_preemption_check = true;
+  opts.on_complete = [cb](GetSeqStateRequest::Result res) {
+    if (res.status != E::OK) {
+      cb(res.status, {});
+      return;
+    }
+    if (!res.recent_records.has_value()) {
+      cb(E::STALE, {});
+      return;
+    }
+
+    std::vector<std::unique_ptr<DataRecord>> records;
+    for (auto& tail : res.recent_records.value()) {
+      ld_check(tail != nullptr);
+      if (!tail->isValid() || !tail->hasPayload()) {
+        cb(E::MALFORMED_RECORD, {});
+        return;
+      }
+      auto data_record = DataRecordFromTailRecord::create(std::move(tail));
+      ld_check(data_record != nullptr);
+      if (data_record->checksumFailed()) {
+        cb(E::CHECKSUM_MISMATCH, {});
+        return;
+      }
+      records.push_back(std::move(data_record));
+    }
+    cb(E::OK, std::move(records));
+  };
+
+  std::unique_ptr<Request> req = std::make_unique<GetSeqStateRequest>(
+      logid, GetSeqStateRequest::Context::GET_TAIL_RECORD, std::move(opts));
+  return processor_->postRequest(req);
+}
+
 std::unique_ptr<LogHeadAttributes>
 ClientImpl::getHeadAttributesSync(logid_t logid) noexcept {
   Semaphore sem;
@@ -2175,6 +2401,28 @@ int ClientImpl::getHeadAttributes(logid_t logid,
   return processor_->postRequest(req);
 }
 
+int ClientImpl::getHeadAttributesBatch(
+    std::vector<logid_t> logs,
+    get_head_attributes_batch_callback_t cb) noexcept {
+  using Batch = LogBatch<std::unique_ptr<LogHeadAttributes>>;
+  auto timeout = settings_->getSettings()->meta_api_timeout.value_or(timeout_);
+  return Batch::start(
+      processor_,
+      std::move(logs),
+      settings_->getSettings()->batch_api_max_in_flight,
+      [timeout](logid_t log, Batch::done_callback_t done) {
+        return std::make_unique<GetHeadAttributesRequest>(
+            log,
+            timeout,
+            [done](const GetHeadAttributesRequest&,
+                   Status st,
+                   std::unique_ptr<LogHeadAttributes> head_attributes) {
+              done(st, std::move(head_attributes));
+            });
+      },
+      std::move(cb));
+}
+
 bool ClientImpl::checkAppendImpl(logid_t logid,
                                  size_t payload_size,
                                  bool allow_extra,
@@ -2321,6 +2569,14 @@ ClientImpl::createRequest(logid_t logid,
     ld_check(target_worker.val_ <
              processor_->getWorkerCount(WorkerType::GENERAL));
     req->setTargetWorker(target_worker);
+  } else if (settings_->getSettings()->client_append_workers > 0) {
+    // Confine appends to the first few workers, so that only they connect to
+    // sequencer nodes. Appends for a log keep going to the same worker.
+    const int nworkers =
+        std::min(settings_->getSettings()->client_append_workers,
+                 processor_->getWorkerCount(WorkerType::GENERAL));
+    req->setTargetWorker(
+        worker_id_t(folly::hash::twang_mix64(logid.val_) % nworkers));
   }
   if (per_request_token) {
     req->setPerRequestToken(std::move(per_request_token));
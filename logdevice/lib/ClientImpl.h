@@ -121,6 +121,16 @@ class ClientImpl : public Client,
              append_callback_t cb,
              AppendAttributes attrs = AppendAttributes()) noexcept override;
 
+  int append(logid_t logid,
+             folly::IOBuf&& payload,
+             append_callback_t cb,
+             AppendAttributes attrs = AppendAttributes()) noexcept override;
+
+  int
+  appendBatch(std::vector<std::pair<logid_t, std::string>> records,
+              append_callback_t cb,
+              AppendAttributes attrs = AppendAttributes()) noexcept override;
+
   int append(logid_t logid,
              std::string payload,
              append_callback_t cb,
@@ -200,6 +210,11 @@ class ClientImpl : public Client,
                find_time_callback_t cb,
                FindKeyAccuracy accuracy) noexcept override;
 
+  int findTimeBatch(std::vector<logid_t> logs,
+                    std::chrono::milliseconds timestamp,
+                    find_time_batch_callback_t cb,
+                    FindKeyAccuracy accuracy) noexcept override;
+
   FindKeyResult findKeySync(logid_t logid,
                             std::string key,
                             FindKeyAccuracy accuracy) noexcept override;
@@ -212,6 +227,9 @@ class ClientImpl : public Client,
 
   int isLogEmpty(logid_t logid, is_empty_callback_t cb) noexcept override;
 
+  int isLogEmptyBatch(std::vector<logid_t> logs,
+                      is_empty_batch_callback_t cb) noexcept override;
+
   int dataSizeSync(logid_t logid,
                    std::chrono::milliseconds start,
                    std::chrono::milliseconds end,
@@ -233,12 +251,20 @@ class ClientImpl : public Client,
   int getTailAttributes(logid_t logid,
                         get_tail_attributes_callback_t cb) noexcept override;
 
+  int getTailAttributesBatch(
+      std::vector<logid_t> logs,
+      get_tail_attributes_batch_callback_t cb) noexcept override;
+
   std::unique_ptr<LogHeadAttributes>
   getHeadAttributesSync(logid_t logid) noexcept override;
 
   int getHeadAttributes(logid_t logid,
                         get_head_attributes_callback_t cb) noexcept override;
 
+  int getHeadAttributesBatch(
+      std::vector<logid_t> logs,
+      get_head_attributes_batch_callback_t cb) noexcept override;
+
   std::chrono::milliseconds getTimeout() const {
     return timeout_;
   }
@@ -367,6 +393,10 @@ class ClientImpl : public Client,
   using read_tail_callback_t =
       std::function<void(Status status, std::unique_ptr<DataRecord>)>;
 
+  using recent_records_callback_t =
+      std::function<void(Status status,
+                         std::vector<std::unique_ptr<DataRecord>>)>;
+
   std::shared_ptr<const EpochMetaDataMap>
   getHistoricalMetaDataSync(logid_t logid) noexcept;
 
@@ -381,6 +411,28 @@ class ClientImpl : public Client,
 
   int readLogTail(logid_t logid, read_tail_callback_t cb) noexcept;
 
+  /**
+   * Gets the records of a tail optimized log with LSNs greater than `after`
+   * from the sequencer, if it still has all of them in memory (see
+   * --sequencer-tail-buffer-size). This lets a reader that is caught up get
+   * new records without waiting for storage nodes to process the release.
+   *
+   * The callback is called on a worker thread with:
+   *   OK     and the released records after `after`, in LSN order; none if
+   *          there are no such records yet
+   *   STALE  if the sequencer doesn't have all the records, e.g. because the
+   *          reader is too far behind or the buffer is disabled. The records
+   *          should be read from storage nodes.
+   *   PROTONOSUPPORT  if the sequencer node is too old
+   *   CHECKSUM_MISMATCH, MALFORMED_RECORD, or any error of
+   *          GetSeqStateRequest, e.g. NOTFOUND or TIMEDOUT
+   *
+   * @return 0 if the request was posted, -1 with err set otherwise.
+   */
+  int readRecentRecords(logid_t logid,
+                        lsn_t after,
+                        recent_records_callback_t cb) noexcept;
+
   ClientSettings& settings() override;
 
   std::string getAllReadStreamsDebugInfo() noexcept override;
@@ -492,6 +544,11 @@ class ClientImpl : public Client,
   // Proxy for Processor::postRequest() with careful error handling
   int postAppend(std::unique_ptr<AppendRequest> req);
 
+  // Error injection, append probes and shadowing, done by postAppend() and
+  // appendBatch() before posting
+  std::unique_ptr<AppendRequest>
+  prepareForPosting(std::unique_ptr<AppendRequest> req);
+
  private:
   // Used to validate that the `cluster_name` does not change across updates to
   // the config.
@@ -534,8 +591,9 @@ class ClientImpl : public Client,
   // Order matters.  Settings need to stick around longer than the Processor.
   std::unique_ptr<ClientSettingsImpl> settings_;
 
-  // cache epoch metadata entries read from the metadata log
-  std::unique_ptr<EpochMetaDataCache> epoch_metadata_cache_;
+  // cache epoch metadata entries read from the metadata log. May be shared
+  // with other clients, see --client-epoch-metadata-cache-shared.
+  std::shared_ptr<EpochMetaDataCache> epoch_metadata_cache_;
 
   std::shared_ptr<UpdateableConfig> config_;
 
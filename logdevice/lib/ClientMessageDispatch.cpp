@@ -80,6 +80,7 @@ void ClientMessageDispatch::onSentImpl(const Message& msg,
     case MessageType::NODE_STATS_AGGREGATE_REPLY:
     case MessageType::NODE_STATS_REPLY:
     case MessageType::RECORD:
+    case MessageType::RECORDS_BATCH:
     case MessageType::SHARD_STATUS_UPDATE:
       RATELIMIT_ERROR(std::chrono::seconds(60),
                       1,
@@ -0,0 +1,158 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "logdevice/common/Processor.h"
+#include "logdevice/common/Request.h"
+#include "logdevice/common/checks.h"
+#include "logdevice/include/Err.h"
+#include "logdevice/include/types.h"
+
+/**
+ * @file Runs one request per log for a batch of logs and reports the outcomes
+ *       of all of them with a single callback. Backs the Client::*Batch()
+ *       methods.
+ *
+ *       At most `max_in_flight` requests are posted at any time; each
+ *       completion posts the request for the next log. This keeps a batch of
+ *       tens of thousands of logs from overflowing the request queues of the
+ *       workers (see --batch-api-max-in-flight).
+ */
+
+namespace facebook { namespace logdevice {
+
+template <typename Result>
+class LogBatch : public std::enable_shared_from_this<LogBatch<Result>> {
+ public:
+  // Called by the request of one log with its outcome.
+  using done_callback_t = std::function<void(Status, Result)>;
+  // Creates the request for `log` that will call `done` when it completes.
+  using request_factory_t =
+      std::function<std::unique_ptr<Request>(logid_t log,
+                                             done_callback_t done)>;
+  // Called once with the outcomes of all logs, in the order of `logs`.
+  using callback_t =
+      std::function<void(std::vector<Status> statuses,
+                         std::vector<Result> results)>;
+
+  /**
+   * @return 0 if the batch was started, in which case `cb` will be called on
+   *         a worker thread once all logs are done. Logs whose request
+   *         couldn't be posted complete with the error of postRequest().
+   *         -1 if nothing was started, with err set to:
+   *          - E::INVALID_PARAM: `logs` is empty.
+   *          - any error of Processor::postRequest().
+   */
+  static int start(std::weak_ptr<Processor> processor,
+                   std::vector<logid_t> logs,
+                   size_t max_in_flight,
+                   request_factory_t factory,
+                   callback_t cb) {
+    if (logs.empty()) {
+      err = E::INVALID_PARAM;
+      return -1;
+    }
+    std::shared_ptr<LogBatch> batch(new LogBatch(std::move(processor),
+                                                 std::move(logs),
+                                                 std::move(factory),
+                                                 std::move(cb)));
+    // Post the first request here so that failing to post anything is
+    // reported to the caller rather than to the callback.
+    batch->next_ = 1;
+    if (batch->post(0) != 0) {
+      return -1;
+    }
+    for (size_t i = 1; i < max_in_flight && i < batch->logs_.size(); ++i) {
+      batch->startNext();
+    }
+    return 0;
+  }
+
+ private:
+  LogBatch(std::weak_ptr<Processor> processor,
+           std::vector<logid_t> logs,
+           request_factory_t factory,
+           callback_t cb)
+      : processor_(std::move(processor)),
+        logs_(std::move(logs)),
+        factory_(std::move(factory)),
+        cb_(std::move(cb)),
+        statuses_(logs_.size(), E::UNKNOWN),
+        results_(logs_.size()),
+        remaining_(logs_.size()) {}
+
+  int post(size_t idx) {
+    auto processor = processor_.lock();
+    if (!processor) {
+      err = E::SHUTDOWN;
+      return -1;
+    }
+    auto self = this->shared_from_this();
+    std::unique_ptr<Request> req =
+        factory_(logs_[idx], [self, idx](Status st, Result result) {
+          // Keep the number of requests in flight constant.
+          self->startNext();
+          self->finish(idx, st, std::move(result));
+        });
+    return processor->postRequest(req);
+  }
+
+  // Posts the request of the next log that hasn't been started, if any.
+  void startNext() {
+    while (true) {
+      size_t idx;
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (next_ >= logs_.size()) {
+          return;
+        }
+        idx = next_++;
+      }
+      if (post(idx) == 0) {
+        return;
+      }
+      finish(idx, err, Result());
+    }
+  }
+
+  void finish(size_t idx, Status st, Result result) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      statuses_[idx] = st;
+      results_[idx] = std::move(result);
+      ld_check(remaining_ > 0);
+      if (--remaining_ > 0) {
+        return;
+      }
+    }
+    cb_(std::move(statuses_), std::move(results_));
+  }
+
+  const std::weak_ptr<Processor> processor_;
+  const std::vector<logid_t> logs_;
+  const request_factory_t factory_;
+  const callback_t cb_;
+
+  // Protects everything below. Requests of different logs complete on
+  // different workers.
+  std::mutex mutex_;
+  std::vector<Status> statuses_;
+  std::vector<Result> results_;
+  // Index of the next log to post a request for.
+  size_t next_ = 0;
+  // Number of logs that haven't completed.
+  size_t remaining_;
+};
+
+}} // namespace facebook::logdevice
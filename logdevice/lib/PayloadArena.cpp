@@ -0,0 +1,116 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/include/PayloadArena.h"
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#include "logdevice/common/debug.h"
+#include "logdevice/include/Err.h"
+
+namespace facebook { namespace logdevice {
+
+namespace {
+
+class PayloadArenaImpl : public PayloadArena {
+ public:
+  PayloadArenaImpl(size_t slot_size, size_t nslots)
+      : slot_size_(slot_size),
+        nslots_(nslots),
+        memory_(new char[slot_size * nslots]) {
+    free_.reserve(nslots);
+    // Hand out low slots first.
+    for (size_t i = nslots; i > 0; --i) {
+      free_.push_back(i - 1);
+    }
+  }
+
+  std::unique_ptr<folly::IOBuf> reserve(size_t size) override {
+    if (size > slot_size_) {
+      err = E::INVALID_PARAM;
+      return nullptr;
+    }
+    size_t slot;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (free_.empty()) {
+        err = E::NOBUFS;
+        return nullptr;
+      }
+      slot = free_.back();
+      free_.pop_back();
+    }
+    // Each handed out buffer keeps the memory alive.
+    refs_.fetch_add(1);
+    return folly::IOBuf::takeOwnership(memory_.get() + slot * slot_size_,
+                                       slot_size_,
+                                       size,
+                                       &PayloadArenaImpl::freeSlot,
+                                       this);
+  }
+
+  size_t slotSize() const override {
+    return slot_size_;
+  }
+
+  size_t slotsInUse() const override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return nslots_ - free_.size();
+  }
+
+  // Called when the user's shared_ptr to the arena goes away.
+  void releaseOwner() {
+    unref();
+  }
+
+ private:
+  static void freeSlot(void* buf, void* user_data) {
+    auto arena = static_cast<PayloadArenaImpl*>(user_data);
+    const size_t offset = static_cast<char*>(buf) - arena->memory_.get();
+    ld_check(offset % arena->slot_size_ == 0);
+    {
+      std::lock_guard<std::mutex> lock(arena->mutex_);
+      arena->free_.push_back(offset / arena->slot_size_);
+    }
+    arena->unref();
+  }
+
+  void unref() {
+    if (refs_.fetch_sub(1) == 1) {
+      delete this;
+    }
+  }
+
+  const size_t slot_size_;
+  const size_t nslots_;
+  std::unique_ptr<char[]> memory_;
+
+  mutable std::mutex mutex_;
+  // Indices of free slots.
+  std::vector<size_t> free_;
+
+  // One for the owner plus one per buffer handed out.
+  std::atomic<size_t> refs_{1};
+};
+
+} // namespace
+
+std::shared_ptr<PayloadArena> PayloadArena::create(size_t slot_size,
+                                                   size_t nslots) {
+  if (slot_size == 0 || nslots == 0) {
+    err = E::INVALID_PARAM;
+    return nullptr;
+  }
+  return std::shared_ptr<PayloadArena>(
+      new PayloadArenaImpl(slot_size, nslots), [](PayloadArena* arena) {
+        static_cast<PayloadArenaImpl*>(arena)->releaseOwner();
+      });
+}
+
+}} // namespace facebook::logdevice
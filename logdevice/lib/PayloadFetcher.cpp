@@ -0,0 +1,104 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/include/PayloadFetcher.h"
+
+#include <algorithm>
+
+#include "logdevice/common/debug.h"
+#include "logdevice/include/Client.h"
+#include "logdevice/include/Err.h"
+#include "logdevice/include/Reader.h"
+
+namespace facebook { namespace logdevice {
+
+namespace {
+
+class PayloadFetcherImpl : public PayloadFetcher {
+ public:
+  PayloadFetcherImpl(std::shared_ptr<Client> client,
+                     std::unique_ptr<Reader> reader)
+      : client_(std::move(client)), reader_(std::move(reader)) {}
+
+  int fetch(logid_t log_id,
+            std::vector<lsn_t> lsns,
+            std::vector<std::unique_ptr<DataRecord>>* records_out) override {
+    ld_check(records_out);
+    std::sort(lsns.begin(), lsns.end());
+    lsns.erase(std::unique(lsns.begin(), lsns.end()), lsns.end());
+
+    size_t begin = 0;
+    while (begin < lsns.size()) {
+      // Read each run of consecutive LSNs with a single read stream.
+      size_t end = begin + 1;
+      while (end < lsns.size() && lsns[end] == lsns[end - 1] + 1) {
+        ++end;
+      }
+      if (readRange(log_id, lsns[begin], lsns[end - 1], records_out) != 0) {
+        return -1;
+      }
+      begin = end;
+    }
+    return 0;
+  }
+
+ private:
+  int readRange(logid_t log_id,
+                lsn_t from,
+                lsn_t until,
+                std::vector<std::unique_ptr<DataRecord>>* records_out) {
+    if (reader_->startReading(log_id, from, until) != 0) {
+      return -1;
+    }
+    const size_t nrecords = until - from + 1;
+    while (reader_->isReading(log_id)) {
+      GapRecord gap;
+      const size_t size_before = records_out->size();
+      ssize_t nread = reader_->read(nrecords, records_out, &gap);
+      if (nread < 0) {
+        ld_check(err == E::GAP);
+        if (gap.type == GapType::ACCESS) {
+          reader_->stopReading(log_id);
+          err = E::ACCESS;
+          return -1;
+        }
+        // The records in the gap are gone, there's nothing to fetch.
+        continue;
+      }
+      if (nread == 0 && records_out->size() == size_before &&
+          reader_->isReading(log_id)) {
+        reader_->stopReading(log_id);
+        err = E::TIMEDOUT;
+        return -1;
+      }
+    }
+    return 0;
+  }
+
+  // Keeps the client alive for as long as reader_ uses it.
+  std::shared_ptr<Client> client_;
+  std::unique_ptr<Reader> reader_;
+};
+
+} // namespace
+
+std::unique_ptr<PayloadFetcher>
+PayloadFetcher::create(std::shared_ptr<Client> client,
+                       std::chrono::milliseconds timeout) {
+  ld_check(client);
+  std::unique_ptr<Reader> reader = client->createReader(1);
+  if (!reader) {
+    return nullptr;
+  }
+  // Return records as soon as they come in, don't wait for full batches.
+  reader->waitOnlyWhenNoData();
+  reader->setTimeout(timeout);
+  return std::make_unique<PayloadFetcherImpl>(
+      std::move(client), std::move(reader));
+}
+
+}} // namespace facebook::logdevice
@@ -57,6 +57,18 @@ void AsyncCheckpointedReaderImpl::setRecordCallback(
   reader_->setRecordCallback(std::move(save_cb));
 }
 
+void AsyncCheckpointedReaderImpl::setRecordBatchCallback(
+    std::function<bool(logid_t, folly::Range<std::unique_ptr<DataRecord>*>)>
+        cb) {
+  auto save_cb = [this, cb](
+                     logid_t log_id,
+                     folly::Range<std::unique_ptr<DataRecord>*> records) {
+    setLastLSNInMap(log_id, records.back()->attrs.lsn);
+    return cb(log_id, records);
+  };
+  reader_->setRecordBatchCallback(std::move(save_cb));
+}
+
 void AsyncCheckpointedReaderImpl::setGapCallback(
     std::function<bool(const GapRecord&)> cb) {
   auto save_cb = [this, cb](const GapRecord& record) {
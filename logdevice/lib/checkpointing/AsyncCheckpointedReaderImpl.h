@@ -31,6 +31,10 @@ class AsyncCheckpointedReaderImpl : public AsyncCheckpointedReader {
   void
   setRecordCallback(std::function<bool(std::unique_ptr<DataRecord>&)>) override;
 
+  void setRecordBatchCallback(
+      std::function<bool(logid_t, folly::Range<std::unique_ptr<DataRecord>*>)>)
+      override;
+
   void setGapCallback(std::function<bool(const GapRecord&)>) override;
 
   void setDoneCallback(std::function<void(logid_t)>) override;
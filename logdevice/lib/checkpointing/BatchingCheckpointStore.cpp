@@ -0,0 +1,295 @@
+/**
+ * Copyright (c) 2019-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "logdevice/lib/checkpointing/BatchingCheckpointStore.h"
+
+#include <folly/executors/GlobalExecutor.h>
+#include <folly/io/async/EventBase.h>
+#include <folly/synchronization/Baton.h>
+
+#include "logdevice/common/checks.h"
+#include "logdevice/common/util.h"
+
+namespace facebook { namespace logdevice {
+
+BatchingCheckpointStore::BatchingCheckpointStore(
+    std::unique_ptr<CheckpointStore> store,
+    std::chrono::milliseconds flush_interval)
+    : store_(std::move(store)),
+      flush_interval_(flush_interval),
+      event_base_(folly::getEventBase()),
+      timer_(folly::HHWheelTimer::newTimer(event_base_)),
+      holder_(this) {
+  ld_check(store_);
+}
+
+BatchingCheckpointStore::~BatchingCheckpointStore() {
+  std::vector<std::string> customers;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& kv : batches_) {
+      customers.push_back(kv.first);
+    }
+  }
+  for (const auto& customer_id : customers) {
+    flush(customer_id);
+  }
+  std::unique_lock<std::mutex> lock(mutex_);
+  written_cv_.wait(lock, [this] {
+    for (const auto& kv : batches_) {
+      if (kv.second.write_in_flight || !kv.second.callbacks.empty()) {
+        return false;
+      }
+    }
+    return true;
+  });
+}
+
+void BatchingCheckpointStore::getLSN(const std::string& customer_id,
+                                     logid_t log_id,
+                                     GetCallback cb) const {
+  folly::Optional<lsn_t> lsn;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = batches_.find(customer_id);
+    if (it != batches_.end()) {
+      const Batch& batch = it->second;
+      auto pending_it = batch.pending.find(log_id);
+      auto in_flight_it = batch.in_flight.find(log_id);
+      if (pending_it != batch.pending.end()) {
+        lsn = pending_it->second;
+      } else if (in_flight_it != batch.in_flight.end()) {
+        lsn = in_flight_it->second;
+      }
+    }
+  }
+  if (lsn.has_value()) {
+    cb(Status::OK, lsn.value());
+    return;
+  }
+  store_->getLSN(customer_id, log_id, std::move(cb));
+}
+
+Status BatchingCheckpointStore::getLSNSync(const std::string& customer_id,
+                                           logid_t log_id,
+                                           lsn_t* value_out) const {
+  folly::Baton<> get_baton;
+  Status return_status = Status::OK;
+  getLSN(customer_id, log_id, [&](Status status, lsn_t lsn) {
+    return_status = status;
+    set_if_not_null(value_out, lsn);
+    get_baton.post();
+  });
+  get_baton.wait();
+  return return_status;
+}
+
+Status BatchingCheckpointStore::updateLSNSync(const std::string& customer_id,
+                                              logid_t log_id,
+                                              lsn_t lsn) {
+  return updateLSNSync(customer_id, {{log_id, lsn}});
+}
+
+Status BatchingCheckpointStore::updateLSNSync(
+    const std::string& customer_id,
+    const std::map<logid_t, lsn_t>& checkpoints) {
+  folly::Baton<> call_baton;
+  Status return_status = Status::OK;
+  addToBatch(customer_id,
+             checkpoints,
+             [&](Status status) {
+               return_status = status;
+               call_baton.post();
+             },
+             /* flush_now = */ true);
+  call_baton.wait();
+  return return_status;
+}
+
+void BatchingCheckpointStore::updateLSN(const std::string& customer_id,
+                                        logid_t log_id,
+                                        lsn_t lsn,
+                                        StatusCallback cb) {
+  updateLSN(customer_id, {{log_id, lsn}}, std::move(cb));
+}
+
+void BatchingCheckpointStore::updateLSN(
+    const std::string& customer_id,
+    const std::map<logid_t, lsn_t>& checkpoints,
+    StatusCallback cb) {
+  addToBatch(customer_id, checkpoints, std::move(cb), /* flush_now = */ false);
+}
+
+void BatchingCheckpointStore::removeCheckpoints(
+    const std::string& customer_id,
+    const std::vector<logid_t>& checkpoints,
+    StatusCallback cb) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = batches_.find(customer_id);
+    if (it != batches_.end()) {
+      for (logid_t log_id : checkpoints) {
+        it->second.pending.erase(log_id);
+        it->second.in_flight.erase(log_id);
+      }
+    }
+  }
+  store_->removeCheckpoints(customer_id, checkpoints, std::move(cb));
+}
+
+void BatchingCheckpointStore::removeAllCheckpoints(
+    const std::string& customer_id,
+    StatusCallback cb) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = batches_.find(customer_id);
+    if (it != batches_.end()) {
+      it->second.pending.clear();
+      it->second.in_flight.clear();
+    }
+  }
+  store_->removeAllCheckpoints(customer_id, std::move(cb));
+}
+
+Status BatchingCheckpointStore::removeCheckpointsSync(
+    const std::string& customer_id,
+    const std::vector<logid_t>& checkpoints) {
+  folly::Baton<> call_baton;
+  Status return_status = Status::OK;
+  removeCheckpoints(customer_id, checkpoints, [&](Status status) {
+    return_status = status;
+    call_baton.post();
+  });
+  call_baton.wait();
+  return return_status;
+}
+
+Status BatchingCheckpointStore::removeAllCheckpointsSync(
+    const std::string& customer_id) {
+  folly::Baton<> call_baton;
+  Status return_status = Status::OK;
+  removeAllCheckpoints(customer_id, [&](Status status) {
+    return_status = status;
+    call_baton.post();
+  });
+  call_baton.wait();
+  return return_status;
+}
+
+void BatchingCheckpointStore::addToBatch(
+    const std::string& customer_id,
+    const std::map<logid_t, lsn_t>& checkpoints,
+    StatusCallback cb,
+    bool flush_now) {
+  bool schedule_flush = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Batch& batch = batches_[customer_id];
+    for (auto [log_id, lsn] : checkpoints) {
+      batch.pending[log_id] = lsn;
+    }
+    batch.callbacks.push_back(std::move(cb));
+    if (!flush_now && !batch.write_in_flight && !batch.flush_scheduled) {
+      batch.flush_scheduled = true;
+      schedule_flush = true;
+    }
+  }
+
+  if (flush_now) {
+    flush(customer_id);
+  } else if (schedule_flush) {
+    event_base_->runInEventBaseThread(
+        [this, ref = holder_.ref(), customer_id]() {
+          if (!ref) {
+            return;
+          }
+          timer_->scheduleTimeoutFn(
+              [this, ref = holder_.ref(), customer_id]() {
+                if (!ref) {
+                  return;
+                }
+                onFlushTimer(customer_id);
+              },
+              flush_interval_);
+        });
+  }
+}
+
+void BatchingCheckpointStore::onFlushTimer(const std::string& customer_id) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = batches_.find(customer_id);
+    if (it == batches_.end()) {
+      return;
+    }
+    it->second.flush_scheduled = false;
+  }
+  flush(customer_id);
+}
+
+void BatchingCheckpointStore::flush(const std::string& customer_id) {
+  std::map<logid_t, lsn_t> checkpoints;
+  std::vector<StatusCallback> callbacks;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = batches_.find(customer_id);
+    if (it == batches_.end()) {
+      return;
+    }
+    Batch& batch = it->second;
+    if (batch.write_in_flight) {
+      // onWritten() will flush again.
+      return;
+    }
+    if (batch.callbacks.empty()) {
+      if (!batch.flush_scheduled) {
+        batches_.erase(it);
+      }
+      return;
+    }
+    checkpoints.swap(batch.pending);
+    callbacks.swap(batch.callbacks);
+    batch.in_flight = checkpoints;
+    batch.write_in_flight = true;
+  }
+
+  if (checkpoints.empty()) {
+    // All updates were for logs removed since.
+    onWritten(customer_id, std::move(callbacks), Status::OK);
+    return;
+  }
+  store_->updateLSN(customer_id,
+                    checkpoints,
+                    [this, customer_id, callbacks = std::move(callbacks)](
+                        Status status) mutable {
+                      onWritten(customer_id, std::move(callbacks), status);
+                    });
+}
+
+void BatchingCheckpointStore::onWritten(const std::string& customer_id,
+                                        std::vector<StatusCallback> callbacks,
+                                        Status status) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = batches_.find(customer_id);
+    ld_check(it != batches_.end());
+    it->second.write_in_flight = false;
+    it->second.in_flight.clear();
+  }
+  for (auto& cb : callbacks) {
+    cb(status);
+  }
+  // Writes updates made while this write was in flight, or forgets the
+  // customer if there are none.
+  flush(customer_id);
+  // Under the lock, so that the destructor can't return before this does.
+  std::lock_guard<std::mutex> lock(mutex_);
+  written_cv_.notify_all();
+}
+
+}} // namespace facebook::logdevice
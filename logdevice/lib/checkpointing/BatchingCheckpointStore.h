@@ -0,0 +1,127 @@
+/**
+ * Copyright (c) 2019-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <unordered_map>
+
+#include <folly/io/async/HHWheelTimer.h>
+
+#include "logdevice/common/WeakRefHolder.h"
+#include "logdevice/include/CheckpointStore.h"
+
+namespace facebook { namespace logdevice {
+/*
+ * @file BatchingCheckpointStore wraps another CheckpointStore and coalesces
+ *       checkpoint updates: updates of a customer made within `flush_interval`
+ *       are written with a single multi-log updateLSN() to the wrapped store,
+ *       where the latest LSN given for each log wins. This turns thousands of
+ *       checkpoint updates per second into one VersionedConfigStore
+ *       read-modify-write per customer per interval.
+ *
+ *       - The callbacks of all coalesced updates are called with the status of
+ *         the write that included them.
+ *       - At most one write per customer is in flight, so that writes are
+ *         applied in order. Updates made meanwhile are written when it
+ *         completes.
+ *       - updateLSNSync() writes all pending updates of the customer right
+ *         away and waits for them.
+ *       - getLSN() returns updates that weren't written yet.
+ *       - Removals are passed through right away. Updates of the removed logs
+ *         that weren't written yet are dropped.
+ *       - Destroying the store writes the pending updates and waits for them.
+ */
+class BatchingCheckpointStore : public CheckpointStore {
+ public:
+  BatchingCheckpointStore(std::unique_ptr<CheckpointStore> store,
+                          std::chrono::milliseconds flush_interval);
+
+  ~BatchingCheckpointStore() override;
+
+  void getLSN(const std::string& customer_id,
+              logid_t log_id,
+              GetCallback cb) const override;
+
+  Status getLSNSync(const std::string& customer_id,
+                    logid_t log_id,
+                    lsn_t* value_out) const override;
+
+  Status updateLSNSync(const std::string& customer_id,
+                       logid_t log_id,
+                       lsn_t lsn) override;
+
+  Status updateLSNSync(const std::string& customer_id,
+                       const std::map<logid_t, lsn_t>& checkpoints) override;
+
+  void updateLSN(const std::string& customer_id,
+                 logid_t log_id,
+                 lsn_t lsn,
+                 StatusCallback cb) override;
+
+  void updateLSN(const std::string& customer_id,
+                 const std::map<logid_t, lsn_t>& checkpoints,
+                 StatusCallback cb) override;
+
+  void removeCheckpoints(const std::string& customer_id,
+                         const std::vector<logid_t>& checkpoints,
+                         StatusCallback cb) override;
+
+  void removeAllCheckpoints(const std::string& customer_id,
+                            StatusCallback cb) override;
+
+  Status
+  removeCheckpointsSync(const std::string& customer_id,
+                        const std::vector<logid_t>& checkpoints) override;
+
+  Status removeAllCheckpointsSync(const std::string& customer_id) override;
+
+ private:
+  struct Batch {
+    // Updates not written yet, and their callbacks.
+    std::map<logid_t, lsn_t> pending;
+    std::vector<StatusCallback> callbacks;
+    // Updates being written.
+    std::map<logid_t, lsn_t> in_flight;
+    bool write_in_flight{false};
+    bool flush_scheduled{false};
+  };
+
+  // Adds the checkpoints to the customer's batch. Schedules a flush in
+  // flush_interval_, or right away if `flush_now`.
+  void addToBatch(const std::string& customer_id,
+                  const std::map<logid_t, lsn_t>& checkpoints,
+                  StatusCallback cb,
+                  bool flush_now);
+
+  // Writes the pending updates of the customer, unless a write is already in
+  // flight. In that case they are written when it completes.
+  void flush(const std::string& customer_id);
+
+  void onFlushTimer(const std::string& customer_id);
+
+  // Called when the write of a customer's batch completed.
+  void onWritten(const std::string& customer_id,
+                 std::vector<StatusCallback> callbacks,
+                 Status status);
+
+  std::unique_ptr<CheckpointStore> store_;
+  const std::chrono::milliseconds flush_interval_;
+
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, Batch> batches_;
+  // Notified when a write completes, for the destructor.
+  std::condition_variable written_cv_;
+
+  folly::EventBase* event_base_;
+  folly::HHWheelTimer::UniquePtr timer_;
+  WeakRefHolder<BatchingCheckpointStore> holder_;
+};
+
+}} // namespace facebook::logdevice
@@ -14,6 +14,7 @@
 #include "logdevice/common/plugin/PluginRegistry.h"
 #include "logdevice/common/plugin/ZookeeperClientFactory.h"
 #include "logdevice/lib/ClientImpl.h"
+#include "logdevice/lib/checkpointing/BatchingCheckpointStore.h"
 #include "logdevice/lib/checkpointing/CheckpointStoreImpl.h"
 
 namespace facebook { namespace logdevice {
@@ -72,4 +73,12 @@ CheckpointStoreFactory::createRSMBasedCheckpointStore(
       std::move(versioned_config_store));
 }
 
+std::unique_ptr<CheckpointStore>
+CheckpointStoreFactory::createBatchingCheckpointStore(
+    std::unique_ptr<CheckpointStore> store,
+    std::chrono::milliseconds flush_interval) {
+  return std::make_unique<BatchingCheckpointStore>(
+      std::move(store), flush_interval);
+}
+
 }} // namespace facebook::logdevice
@@ -0,0 +1,104 @@
+/**
+ * Copyright (c) 2019-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "logdevice/lib/checkpointing/BatchingCheckpointStore.h"
+
+#include <atomic>
+
+#include <folly/synchronization/Baton.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "logdevice/lib/checkpointing/test/MockCheckpointStore.h"
+
+using namespace facebook::logdevice;
+
+using ::testing::_;
+using ::testing::Invoke;
+
+class BatchingCheckpointStoreTest : public ::testing::Test {
+ public:
+  std::unique_ptr<BatchingCheckpointStore>
+  createStore(std::chrono::milliseconds flush_interval) {
+    auto mock_store = std::make_unique<MockCheckpointStore>();
+    mock_store_ = mock_store.get();
+    return std::make_unique<BatchingCheckpointStore>(
+        std::move(mock_store), flush_interval);
+  }
+
+  void expectWrite(const std::string& customer_id,
+                   std::map<logid_t, lsn_t> checkpoints) {
+    EXPECT_CALL(*mock_store_, updateLSN(customer_id, checkpoints, _))
+        .WillOnce(Invoke([](auto, auto, auto cb) { cb(Status::OK); }));
+  }
+
+  MockCheckpointStore* mock_store_;
+};
+
+TEST_F(BatchingCheckpointStoreTest, CoalescesUpdates) {
+  auto store = createStore(std::chrono::milliseconds(50));
+  expectWrite("customer1", {{logid_t(1), 7}, {logid_t(2), 3}});
+  expectWrite("customer2", {{logid_t(1), 4}});
+
+  std::atomic<int> called{0};
+  folly::Baton<> all_called;
+  auto cb = [&](Status status) {
+    EXPECT_EQ(Status::OK, status);
+    if (++called == 4) {
+      all_called.post();
+    }
+  };
+  // The latest LSN of each log wins.
+  store->updateLSN("customer1", logid_t(1), 5, cb);
+  store->updateLSN("customer1", logid_t(1), 7, cb);
+  store->updateLSN("customer1", logid_t(2), 3, cb);
+  store->updateLSN("customer2", logid_t(1), 4, cb);
+  all_called.wait();
+}
+
+TEST_F(BatchingCheckpointStoreTest, SyncUpdateFlushesPending) {
+  auto store = createStore(std::chrono::seconds(10));
+  expectWrite("customer", {{logid_t(1), 5}, {logid_t(2), 3}});
+
+  folly::Baton<> called;
+  store->updateLSN("customer", logid_t(1), 5, [&](Status status) {
+    EXPECT_EQ(Status::OK, status);
+    called.post();
+  });
+  EXPECT_EQ(Status::OK, store->updateLSNSync("customer", logid_t(2), 3));
+  EXPECT_TRUE(called.ready());
+}
+
+TEST_F(BatchingCheckpointStoreTest, GetReturnsPendingUpdates) {
+  auto store = createStore(std::chrono::seconds(10));
+  EXPECT_CALL(*mock_store_, getLSN("customer", logid_t(2), _))
+      .WillOnce(Invoke([](auto, auto, auto cb) { cb(Status::OK, 9); }));
+
+  store->updateLSN("customer", logid_t(1), 5, [](Status) {});
+  lsn_t lsn;
+  EXPECT_EQ(Status::OK, store->getLSNSync("customer", logid_t(1), &lsn));
+  EXPECT_EQ(5, lsn);
+  EXPECT_EQ(Status::OK, store->getLSNSync("customer", logid_t(2), &lsn));
+  EXPECT_EQ(9, lsn);
+
+  // Pending updates are written on destruction.
+  expectWrite("customer", {{logid_t(1), 5}});
+  store.reset();
+}
+
+TEST_F(BatchingCheckpointStoreTest, RemoveDropsPendingUpdates) {
+  auto store = createStore(std::chrono::seconds(10));
+  EXPECT_CALL(*mock_store_, removeCheckpoints("customer", _, _))
+      .WillOnce(Invoke([](auto, auto, auto cb) { cb(Status::OK); }));
+  expectWrite("customer", {{logid_t(2), 3}});
+
+  store->updateLSN(
+      "customer", {{logid_t(1), 5}, {logid_t(2), 3}}, [](Status) {});
+  EXPECT_EQ(Status::OK, store->removeCheckpointsSync("customer", {logid_t(1)}));
+  store.reset();
+}
@@ -9,6 +9,8 @@
 
 #include <algorithm>
 
+#include <folly/hash/Hash.h>
+
 #include "logdevice/common/AppendRequest.h"
 #include "logdevice/lib/shadow/ShadowClient.h"
 
@@ -85,8 +87,11 @@ int Shadow::appendShadow(const AppendRequest& req) {
                                  std::move(payload),
                                  req_attrs,
                                  req.getBufferedWriterBlobFlag(),
-                                 req.getPayloadGroupFlag());
-  if (rv == -1) {
+                                 req.getPayloadGroupFlag(),
+                                 max_in_flight_appends_.load());
+  if (rv == -1 && err == E::SHADOW_BUSY) {
+    STAT_INCR(stats_, client.shadow_append_dropped);
+  } else if (rv == -1) {
     // TODO detailed scuba stats T20416930 including error code
     STAT_INCR(stats_, client.shadow_append_failed);
   }
@@ -99,6 +104,11 @@ Shadow::Attrs Shadow::checkShadowConfig(logid_t logid) {
     return folly::none;
   }
 
+  if (!isLogSampled(logid)) {
+    err = E::SHADOW_SKIP;
+    return folly::none;
+  }
+
   // Determine which log range this logid belongs to, requires locking
   // This function will just return false immediately if it can't acquire the
   // lock because not worth blocking
@@ -159,6 +169,17 @@ void Shadow::reset() {
   shadow_factory_->reset();
 }
 
+bool Shadow::isLogSampled(logid_t logid) const {
+  const double ratio = log_sample_ratio_.load();
+  if (ratio >= 1.0) {
+    return true;
+  }
+  // Map the log to a point in [0, 1) that doesn't depend on how log ids are
+  // allocated.
+  const uint64_t hash = folly::hash::twang_mix64(logid.val_);
+  return static_cast<double>(hash >> 11) * 0x1.0p-53 < ratio;
+}
+
 // **NOTE** Assumes shadow lock has already been acquired
 void Shadow::loadLogRangeForID(logid_t logid) {
   if (pending_logs_.find(logid) != pending_logs_.end()) {
@@ -221,6 +242,9 @@ bool Shadow::checkAndUpdateRatio(ShadowInfo& shadow_info) {
 void Shadow::onSettingsUpdate() {
   // It's expected that settings update callbacks are called from a single
   // thread, so we access stuff without mutex here.
+  log_sample_ratio_.store(client_settings_->shadow_log_sample_ratio);
+  max_in_flight_appends_.store(client_settings_->shadow_max_in_flight_appends);
+
   bool enabled_in_settings = client_settings_->traffic_shadow_enabled;
   auto timeout_in_settings = client_settings_->shadow_client_timeout;
   if (enabled_in_settings != client_shadow_enabled_ ||
@@ -39,6 +39,13 @@
  *       client will only maintain shadowing info about ranges that they are
  *       interested in, i.e. ranges that they have recently appended to.
  *
+ *       Shadowing must never slow down appends to the origin cluster. The
+ *       payload is handed to the shadow client without copying it, the shadow
+ *       append runs on the shadow client's own workers, and once
+ *       --shadow-max-in-flight-appends shadow appends are outstanding, further
+ *       ones are dropped rather than queued. --shadow-log-sample-ratio
+ *       restricts shadowing to a subset of the logs.
+ *
  *       TODO statistics (t20081407), refactor logging (t20117512)
  */
 
@@ -121,6 +128,8 @@ class Shadow {
   Shadow& operator=(const Shadow&) = delete; // non-assignable
 
   void reset(); // Called when shadowing disabled, to free resources
+  // Whether logid is among the logs picked by --shadow-log-sample-ratio
+  bool isLogSampled(logid_t logid) const;
   void loadLogRangeForID(logid_t logid);
   void
   updateLogGroup(const std::shared_ptr<const LogsConfig::LogGroupNode>& group);
@@ -142,6 +151,9 @@ class Shadow {
   bool initial_initialization_done_{false};
   std::atomic_bool client_shadow_enabled_{false};
   std::chrono::milliseconds client_timeout_{std::chrono::milliseconds(0)};
+  // Copies of settings read on every append
+  std::atomic<double> log_sample_ratio_{1.0};
+  std::atomic<size_t> max_in_flight_appends_{0};
 
   /**
    * Members used to cache log ranges for relatively quick logid -> range lookup
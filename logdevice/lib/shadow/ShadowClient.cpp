@@ -214,7 +214,22 @@ int ShadowClient::append(logid_t logid,
                          PayloadHolder&& payload,
                          AppendAttributes attrs,
                          bool buffered_writer_blob,
-                         bool payload_group) noexcept {
+                         bool payload_group,
+                         size_t max_in_flight) noexcept {
+  // Reserve a slot first so that concurrent appenders can't overshoot the
+  // limit, and give it back if we can't have it.
+  if (in_flight_.fetch_add(1) >= max_in_flight && max_in_flight > 0) {
+    in_flight_.fetch_sub(1);
+    RATELIMIT_WARNING(1s,
+                      1,
+                      LD_SHADOW_PREFIX "Dropping shadow append to log %lu: "
+                                       "%zu shadow appends already in flight",
+                      logid.val(),
+                      max_in_flight);
+    err = E::SHADOW_BUSY;
+    return -1;
+  }
+
   auto callback = [&](auto a, const auto& b) { this->appendCallback(a, b); };
 
   ld_spew(LD_SHADOW_PREFIX "Shadowing payload of size %zu to shadow '%s'",
@@ -241,6 +256,7 @@ int ShadowClient::append(logid_t logid,
   }
 
   if (rv == -1) {
+    in_flight_.fetch_sub(1);
     RATELIMIT_WARNING(1s,
                       1,
                       LD_SHADOW_PREFIX "Shadow append failed with '%s'",
@@ -250,6 +266,7 @@ int ShadowClient::append(logid_t logid,
 }
 
 void ShadowClient::appendCallback(Status status, const DataRecord& record) {
+  in_flight_.fetch_sub(1);
   ld_spew(LD_SHADOW_PREFIX "Shadow append finished with lsn=%s",
           lsn_to_string(record.attrs.lsn).c_str());
   if (status == E::OK) {
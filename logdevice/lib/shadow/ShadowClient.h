@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <chrono>
 #include <condition_variable>
 #include <memory>
@@ -122,11 +123,23 @@ class ShadowClient {
 
   ~ShadowClient();
 
+  /**
+   * Posts a shadow append to the shadow cluster, without waiting for it.
+   *
+   * @param max_in_flight  if this many appends posted by this ShadowClient
+   *                       haven't completed yet, the append is dropped; 0
+   *                       means no limit
+   *
+   * @return 0 if the append was posted, -1 otherwise with err set to
+   *         E::SHADOW_BUSY if it was dropped because of max_in_flight, or
+   *         to whatever error posting it failed with
+   */
   int append(logid_t logid,
              PayloadHolder&& payload,
              AppendAttributes attrs,
              bool buffered_writer_blob,
-             bool payload_group) noexcept;
+             bool payload_group,
+             size_t max_in_flight = 0) noexcept;
 
  private:
   ShadowClient(std::shared_ptr<Client> client,
@@ -139,6 +152,9 @@ class ShadowClient {
   Shadow::Attrs shadow_attrs_;
   StatsHolder* stats_;
   std::chrono::milliseconds client_timeout_{0};
+
+  // Appends posted whose callback hasn't been called yet
+  std::atomic<size_t> in_flight_{0};
 };
 
 }} // namespace facebook::logdevice
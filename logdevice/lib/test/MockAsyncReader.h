@@ -25,6 +25,10 @@ class MockAsyncReader : public AsyncReader {
   MOCK_METHOD1(setRecordCallback,
                void(std::function<bool(std::unique_ptr<DataRecord>&)>));
 
+  MOCK_METHOD1(setRecordBatchCallback,
+               void(std::function<bool(
+                        logid_t, folly::Range<std::unique_ptr<DataRecord>*>)>));
+
   MOCK_METHOD1(setGapCallback, void(std::function<bool(const GapRecord&)>));
 
   MOCK_METHOD1(setDoneCallback, void(std::function<void(logid_t)>));
@@ -24,6 +24,10 @@ class MockClient : public Client {
                int(logid_t, std::string, append_callback_t, AppendAttributes));
   MOCK_METHOD4(append,
                int(logid_t, Payload, append_callback_t, AppendAttributes));
+  MOCK_METHOD3(appendBatch,
+               int(std::vector<std::pair<logid_t, std::string>>,
+                   append_callback_t,
+                   AppendAttributes));
   MOCK_METHOD2(createReader, std::unique_ptr<Reader>(size_t, ssize_t));
   MOCK_METHOD1(createAsyncReader, std::unique_ptr<AsyncReader>(ssize_t));
   MOCK_METHOD1(setTimeout, void(std::chrono::milliseconds timeout));
@@ -40,10 +44,17 @@ class MockClient : public Client {
                    std::chrono::milliseconds,
                    find_time_callback_t,
                    FindKeyAccuracy));
+  MOCK_METHOD4(findTimeBatch,
+               int(std::vector<logid_t>,
+                   std::chrono::milliseconds,
+                   find_time_batch_callback_t,
+                   FindKeyAccuracy));
   MOCK_METHOD4(findKey,
                int(logid_t, std::string, find_key_callback_t, FindKeyAccuracy));
   MOCK_METHOD2(isLogEmptySync, int(logid_t logid, bool* empty));
   MOCK_METHOD2(isLogEmpty, int(logid_t logid, is_empty_callback_t cb));
+  MOCK_METHOD2(isLogEmptyBatch,
+               int(std::vector<logid_t> logs, is_empty_batch_callback_t cb));
   MOCK_METHOD5(dataSizeSync,
                int(logid_t logid,
                    std::chrono::milliseconds start,
@@ -62,10 +73,16 @@ class MockClient : public Client {
                std::unique_ptr<LogTailAttributes>(logid_t logid));
   MOCK_METHOD2(getTailAttributes,
                int(logid_t logid, get_tail_attributes_callback_t cb));
+  MOCK_METHOD2(getTailAttributesBatch,
+               int(std::vector<logid_t> logs,
+                   get_tail_attributes_batch_callback_t cb));
   MOCK_METHOD1(getHeadAttributesSync,
                std::unique_ptr<LogHeadAttributes>(logid_t logid));
   MOCK_METHOD2(getHeadAttributes,
                int(logid_t logid, get_head_attributes_callback_t cb));
+  MOCK_METHOD2(getHeadAttributesBatch,
+               int(std::vector<logid_t> logs,
+                   get_head_attributes_batch_callback_t cb));
   MOCK_METHOD1(getLogRangeByName, logid_range_t(const std::string& name));
   MOCK_METHOD2(getLogRangeByName,
                void(const std::string& name,
@@ -0,0 +1,73 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/include/PayloadArena.h"
+
+#include <cstring>
+
+#include <gtest/gtest.h>
+
+#include "logdevice/include/Err.h"
+
+namespace facebook { namespace logdevice {
+
+TEST(PayloadArenaTest, ReserveAndReuse) {
+  auto arena = PayloadArena::create(16, 2);
+  ASSERT_NE(nullptr, arena);
+  EXPECT_EQ(16u, arena->slotSize());
+
+  auto a = arena->reserve(5);
+  ASSERT_NE(nullptr, a);
+  EXPECT_EQ(5u, a->length());
+  memcpy(a->writableData(), "hello", 5);
+  EXPECT_EQ(0, memcmp(a->data(), "hello", 5));
+
+  auto b = arena->reserve(16);
+  ASSERT_NE(nullptr, b);
+  EXPECT_EQ(2u, arena->slotsInUse());
+  EXPECT_NE(a->data(), b->data());
+
+  // All slots in use.
+  EXPECT_EQ(nullptr, arena->reserve(1));
+  EXPECT_EQ(E::NOBUFS, err);
+
+  // Clones share the slot, it's returned when the last reference is gone.
+  const uint8_t* b_data = b->data();
+  auto b_clone = b->clone();
+  b.reset();
+  EXPECT_EQ(2u, arena->slotsInUse());
+  b_clone.reset();
+  EXPECT_EQ(1u, arena->slotsInUse());
+
+  auto c = arena->reserve(8);
+  ASSERT_NE(nullptr, c);
+  EXPECT_EQ(b_data, c->data());
+}
+
+TEST(PayloadArenaTest, InvalidParams) {
+  EXPECT_EQ(nullptr, PayloadArena::create(0, 1));
+  EXPECT_EQ(E::INVALID_PARAM, err);
+  EXPECT_EQ(nullptr, PayloadArena::create(1, 0));
+  EXPECT_EQ(E::INVALID_PARAM, err);
+
+  auto arena = PayloadArena::create(16, 1);
+  EXPECT_EQ(nullptr, arena->reserve(17));
+  EXPECT_EQ(E::INVALID_PARAM, err);
+}
+
+TEST(PayloadArenaTest, BufferOutlivesArena) {
+  auto arena = PayloadArena::create(16, 1);
+  auto buf = arena->reserve(3);
+  ASSERT_NE(nullptr, buf);
+  arena.reset();
+  // The memory stays valid until the buffer is released.
+  memcpy(buf->writableData(), "abc", 3);
+  EXPECT_EQ(0, memcmp(buf->data(), "abc", 3));
+  buf.reset();
+}
+
+}} // namespace facebook::logdevice
@@ -282,6 +282,25 @@ TEST_F(ShadowTest, LogRangeAutoUpdate) {
   ASSERT_EQ(err, E::SHADOW_DISABLED);
 }
 
+// Test that logs not picked by --shadow-log-sample-ratio are never shadowed
+TEST_F(ShadowTest, LogSampling) {
+  genLogsConfig(true);
+  setShadowingEnabled(true);
+
+  settings->set("shadow-log-sample-ratio", "0");
+  for (int i = 0; i < 10; i++) {
+    ASSERT_FALSE(shadow->checkShadowConfig(logid_t{1}));
+    ASSERT_EQ(err, E::SHADOW_SKIP);
+  }
+  // Skipped before even resolving the log range
+  ASSERT_FALSE(shadow->isLogGroupLoaded(kTestData[0].range));
+
+  settings->set("shadow-log-sample-ratio", "1");
+  ASSERT_FALSE(shadow->checkShadowConfig(logid_t{1}));
+  ASSERT_EQ(err, E::SHADOW_LOADING);
+  assertShadowRatio();
+}
+
 // Make sure shadow client initializes without crashing
 TEST(ShadowClientTest, ShadowClientInitAppend) {
   auto nodes_config_path =
@@ -24,23 +24,69 @@
 
 namespace facebook { namespace logdevice {
 
+void InFlightWindow::push(vsn_t seq) {
+  if (empty()) {
+    // Restart the window at `seq`.
+    words_.clear();
+    base_ = oldest_ = end_ = seq;
+  }
+  ld_check(seq == end_);
+  if (end_ - base_ >= words_.size() * 64) {
+    words_.push_back(0);
+  }
+  ++end_;
+  ++in_flight_;
+}
+
+bool InFlightWindow::isCompleted(vsn_t seq) const {
+  const vsn_t idx = seq - base_;
+  return words_[idx / 64] & (uint64_t(1) << (idx % 64));
+}
+
+bool InFlightWindow::contains(vsn_t seq) const {
+  return seq >= oldest_ && seq < end_ && !isCompleted(seq);
+}
+
+bool InFlightWindow::complete(vsn_t seq) {
+  if (!contains(seq)) {
+    return false;
+  }
+  const vsn_t idx = seq - base_;
+  words_[idx / 64] |= uint64_t(1) << (idx % 64);
+  --in_flight_;
+
+  // Slide the window past the appends completed in order.
+  while (oldest_ < end_ && isCompleted(oldest_)) {
+    ++oldest_;
+  }
+  while (oldest_ - base_ >= 64) {
+    words_.pop_front();
+    base_ += 64;
+  }
+  return true;
+}
+
 GenVerifyData::GenVerifyData(uint64_t wid) : writer_id_(wid) {}
 
 // Generates a VerificationData instance to be serialized.
 VerificationData
 GenVerifyData::generateVerificationData(logid_t log_id,
                                         const std::string& payload) {
-  auto& log_state = log_states_[log_id];
   VerificationData vd;
   vd.vdh.magic_number = vflag_;
   vd.vdh.writer_id = writer_id_;
-  vd.vdh.sequence_num = log_state.next_seq_num++;
-  vd.vdh.oldest_in_flight = *(log_state.in_flight.begin());
   vd.vdh.payload_checksum = folly::hash::fnv32(payload);
   vd.vdh.payload_size = payload.size();
-  vd.vdh.ack_list_length = log_state.to_ack_list.size();
-  vd.ack_list.assign(
-      log_state.to_ack_list.begin(), log_state.to_ack_list.end());
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto& log_state = log_states_[log_id];
+    vd.vdh.sequence_num = log_state.next_seq_num++;
+    log_state.in_flight.push(vd.vdh.sequence_num);
+    vd.vdh.oldest_in_flight = log_state.in_flight.oldest();
+    vd.vdh.ack_list_length = log_state.to_ack_list.size();
+    vd.ack_list.assign(
+        log_state.to_ack_list.begin(), log_state.to_ack_list.end());
+  }
 
   // Dry run which will not take time or memory, just want to get the size.
   vd.vdh.payload_pos =
@@ -55,13 +101,12 @@ void GenVerifyData::appendUpdateOnCallback(
     const std::vector<std::pair<vsn_t, lsn_t>>& appended_ack_list) {
   // Append completed, so move the sequence number from in flight to the to-ack
   // list.
+  std::lock_guard<std::mutex> guard(mutex_);
   WriterVerificationData& log_state = log_states_[log_id];
 
-  std::set<vsn_t>::iterator it = log_state.in_flight.find(appended_seq_num);
-  if (it == log_state.in_flight.end()) {
+  if (!log_state.in_flight.complete(appended_seq_num)) {
     ld_check(false);
   }
-  log_state.in_flight.erase(it);
   log_state.to_ack_list.insert(std::make_pair(appended_seq_num, appended_lsn));
 
   // If append was successful, subtract the record's ack list from the to-ack
@@ -10,6 +10,7 @@
 
 #include <atomic>
 #include <chrono>
+#include <deque>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -27,24 +28,73 @@
 
 namespace facebook { namespace logdevice {
 
+// Sequence numbers of a log's appends that haven't completed yet. The writer
+// hands out consecutive sequence numbers, so rather than a set of them this
+// keeps a sliding bitmap starting at the oldest one still in flight, with one
+// bit per sequence number telling whether its append completed. Completing
+// appends in order keeps it at a few words however many appends went through.
+class InFlightWindow {
+ public:
+  // Adds the next sequence number. Must be end(), unless nothing is in flight.
+  void push(vsn_t seq);
+
+  // Marks the append of `seq` completed.
+  // @return false if `seq` wasn't in flight.
+  bool complete(vsn_t seq);
+
+  bool contains(vsn_t seq) const;
+
+  // Oldest sequence number still in flight, or end() if there is none.
+  vsn_t oldest() const {
+    return oldest_;
+  }
+
+  // Sequence number following the last one pushed.
+  vsn_t end() const {
+    return end_;
+  }
+
+  // Number of sequence numbers in flight.
+  size_t size() const {
+    return in_flight_;
+  }
+
+  bool empty() const {
+    return in_flight_ == 0;
+  }
+
+ private:
+  bool isCompleted(vsn_t seq) const;
+
+  // Sequence number of the lowest bit of words_.front().
+  vsn_t base_ = 0;
+  vsn_t oldest_ = 0;
+  vsn_t end_ = 0;
+  size_t in_flight_ = 0;
+  // Bit set iff the append completed.
+  std::deque<uint64_t> words_;
+};
+
+// Generates the verification data prepended to payloads by
+// VerificationWriter. Thread safe: appends and their callbacks may run on
+// different threads.
 class GenVerifyData {
  public:
   struct WriterVerificationData {
-    vsn_t next_seq_num;
-    // TODO: make this a map of sequence numbers to the ack lists of their
-    // corresponding records.
-    std::set<vsn_t> in_flight;
+    vsn_t next_seq_num{0};
+    InFlightWindow in_flight;
     // TODO: use struct
     std::set<std::pair<vsn_t, lsn_t>> to_ack_list;
   };
 
   GenVerifyData(uint64_t wid = folly::Random::rand64());
 
+  // Assigns the next sequence number of the log to the append of `payload`,
+  // which is in flight until appendUpdateOnCallback() is called for it.
   VerificationData generateVerificationData(logid_t log_id,
                                             const std::string& payload);
 
-  // Public because we need to frequently modify log_states_ anyway by
-  // inserting into in_flight whenever an append is called.
+  // Public for tests. Protected by mutex_.
   std::map<logid_t, WriterVerificationData> log_states_;
 
   uint64_t getWriterID();
@@ -57,5 +107,6 @@ class GenVerifyData {
 
  private:
   uint64_t writer_id_;
+  std::mutex mutex_;
 };
 }} // namespace facebook::logdevice
@@ -12,6 +12,7 @@
  */
 #include "logdevice/lib/verifier/ReadVerifyData.h"
 
+#include <algorithm>
 #include <chrono>
 #include <exception>
 #include <string.h>
@@ -30,7 +31,8 @@
 
 namespace facebook { namespace logdevice {
 
-ReadVerifyData::ReadVerifyData() {}
+ReadVerifyData::ReadVerifyData(size_t max_cache_size)
+    : max_cache_size_(max_cache_size) {}
 
 // Checks the data verification parameters for errors, and if it finds any,
 // reports them. Will eventually use Scuba, but using returned error codes
@@ -47,7 +49,8 @@ void ReadVerifyData::checkForErrors(
   std::pair<uint64_t, logid_t> p(vd.vdh.writer_id, log_id);
 
   VerificationFoundError vfe;
-  if (vd.vdh.payload_checksum != folly::hash::fnv32(payload.toString())) {
+  if (vd.vdh.payload_checksum !=
+      folly::hash::fnv32_buf(payload.data(), payload.size())) {
     vfe.vrs = VerificationRecordStatus::CHECKSUM_MISMATCH;
     vfe.error_record = std::make_pair(vd.vdh.sequence_num, vai);
     errors_out.push_back(vfe);
@@ -92,8 +95,8 @@ void ReadVerifyData::checkForErrors(
   // is not in the cache. If the current record's sequence number is beyond
   // (i.e. lower than) the cache range then we don't know, but assume that it is
   // not a duplicate.
-  auto trimmed_it = curr_trimmed_cache.find(vd.vdh.sequence_num);
-  if (trimmed_it != curr_trimmed_cache.end()) {
+  auto trimmed_it = curr_trimmed_cache.entries.find(vd.vdh.sequence_num);
+  if (trimmed_it != curr_trimmed_cache.entries.end()) {
     vfe.vrs = VerificationRecordStatus::DUPLICATE;
     vfe.error_record = std::make_pair(vd.vdh.sequence_num, vai);
     vfe.error_discovery_record = *trimmed_it;
@@ -145,7 +148,8 @@ void ReadVerifyData::checkForErrors(
   for (const std::pair<vsn_t, lsn_t>& curr_ack : vd.ack_list) {
     auto uw_it = curr_unacked_window.find(curr_ack.first);
     if (uw_it == curr_unacked_window.end() &&
-        !curr_trimmed_cache.count(curr_ack.first)) {
+        curr_ack.first >= curr_trimmed_cache.evicted_below &&
+        !curr_trimmed_cache.entries.count(curr_ack.first)) {
       // The append of this sequence number was acked (whether as success or
       // failure), but we have not seen the corresponding record yet. Therefore,
       // if we ever see the corresponding record, it is a reordering error,
@@ -159,6 +163,9 @@ void ReadVerifyData::checkForErrors(
       vfe.error_record = std::make_pair(curr_ack.first, lost_vai);
       vfe.error_discovery_record = std::make_pair(vd.vdh.sequence_num, vai);
       curr_acked_unread[curr_ack.first] = vfe;
+      if (curr_acked_unread.size() > max_cache_size_) {
+        curr_acked_unread.erase(curr_acked_unread.begin());
+      }
 
       // IF THE RECORD WAS ACKED AS SUCCESS, then this is data loss. Note that
       // in this case, the record being checked is fine; instead, the record
@@ -202,9 +209,15 @@ void ReadVerifyData::checkForErrors(
   // Trim the window and check for lost acks.
   while (true) {
     if (curr_unacked_window.begin()->second.first) {
-      curr_trimmed_cache[curr_unacked_window.begin()->first] =
+      curr_trimmed_cache.entries[curr_unacked_window.begin()->first] =
           curr_unacked_window.begin()->second.second;
       curr_unacked_window.erase(curr_unacked_window.begin()); // Trim window
+      if (curr_trimmed_cache.entries.size() > max_cache_size_) {
+        auto oldest = curr_trimmed_cache.entries.begin();
+        curr_trimmed_cache.evicted_below =
+            std::max(curr_trimmed_cache.evicted_below, oldest->first + 1);
+        curr_trimmed_cache.entries.erase(oldest);
+      }
       continue;
     }
     if (curr_unacked_window.begin()->first < vd.vdh.oldest_in_flight) {
@@ -255,22 +268,30 @@ std::unique_ptr<DataRecord> ReadVerifyData::verifyRestoreRecordPayload(
   checkForErrors(log_id, ver.user_payload, ver.vd, vai, errors_out);
 
   // Extract the original payload.
-  // Note that we must perform a payload duplication here.
-  // This is because the Reader's read() function returns unique_ptr's to
-  // instances of DataRecordOwnsPayload upcasted to DataRecords. Hence, given_dr
-  // points to a DataRecordOwnsPayload. We need to return a DataRecord that
-  // points to the actual (non-verification-data-prepended) payload, but we
-  // cannot modify the DataRecordOwnsPayload's payload field. Therefore, we must
-  // instantiate a new DataRecordOwnsPayload with the correct payload.
-  // TODO: use a shared_ptr<void> owning dr, to avoid needing to duplicate
-  // the payload.
+  // The Reader's read() function returns unique_ptr's to instances of
+  // DataRecordOwnsPayload upcasted to DataRecords, and we cannot modify the
+  // DataRecordOwnsPayload's payload field. Therefore, we instantiate a new
+  // DataRecordOwnsPayload whose payload points into the old record's, which
+  // it keeps alive instead of copying the payload.
+  const lsn_t lsn = drop_ptr->attrs.lsn;
+  const std::chrono::milliseconds timestamp = drop_ptr->attrs.timestamp;
+  const RECORD_flags_t flags = drop_ptr->flags_;
+  RecordOffset offsets = drop_ptr->attrs.offsets;
+  folly::IOBuf user_payload(
+      folly::IOBuf::TAKE_OWNERSHIP,
+      const_cast<void*>(ver.user_payload.data()),
+      ver.user_payload.size(),
+      [](void* /*buf*/, void* record) {
+        delete static_cast<DataRecord*>(record);
+      },
+      dr.release());
   return std::make_unique<DataRecordOwnsPayload>(
-      drop_ptr->logid,
-      PayloadHolder(PayloadHolder::COPY_BUFFER, ver.user_payload),
-      drop_ptr->attrs.lsn,
-      drop_ptr->attrs.timestamp,
-      drop_ptr->flags_,
-      drop_ptr->attrs.offsets);
+      log_id,
+      PayloadHolder(std::move(user_payload)),
+      lsn,
+      timestamp,
+      flags,
+      std::move(offsets));
 }
 
 }} // namespace facebook::logdevice
@@ -44,7 +44,11 @@ class ReadVerifyData {
   verifyRestoreRecordPayload(std::unique_ptr<DataRecord> dr,
                              std::vector<VerificationFoundError>& errors_out);
 
-  ReadVerifyData();
+  // @param max_cache_size  how many sequence numbers per writer and log to
+  //                        remember in trimmed_cache_ and acked_unread_.
+  //                        Verifying a high rate of appends would otherwise
+  //                        grow them without bound.
+  explicit ReadVerifyData(size_t max_cache_size = 100000);
 
  private:
   // Checks a payload and verification data for errors. If any errors are
@@ -78,12 +82,17 @@ class ReadVerifyData {
                      std::map<vsn_t, std::pair<bool, VerificationAppendInfo>>>
       unacked_windows_;
   // Cache of all sequence numbers that were acked successfully and therefore
-  // trimmed from the unacked_windows_, up to a certain size. Used to check
-  // duplicates. Also carries the VerificationAppendInfo FROM THE READER
+  // trimmed from the unacked_windows_, up to max_cache_size_ of them. Used to
+  // check duplicates. Also carries the VerificationAppendInfo FROM THE READER
   // which can be checked against the VerificationAppendInfo FROM THE CALLBACK
   // later.
-  std::unordered_map<std::pair<uint32_t, logid_t>,
-                     std::map<vsn_t, VerificationAppendInfo>>
+  struct TrimmedCache {
+    std::map<vsn_t, VerificationAppendInfo> entries;
+    // Sequence numbers below this one were evicted from `entries` to keep it
+    // under max_cache_size_. They are assumed to have been read.
+    vsn_t evicted_below = 0;
+  };
+  std::unordered_map<std::pair<uint64_t, logid_t>, TrimmedCache>
       trimmed_cache_;
   // Cache of all sequence numbers that were in an ack list with ack status of
   // "success" (i.e. they were assigned LSN), but were NOT in the window of
@@ -110,8 +119,12 @@ class ReadVerifyData {
   // A note on definition of reordered records: a record x is defined as
   // reordered if and only if there exists a record y before record x, such that
   // y's ack list contains record x.
-  std::unordered_map<std::pair<uint32_t, logid_t>,
+  // Capped at max_cache_size_ entries per writer and log, dropping the lowest
+  // sequence numbers first.
+  std::unordered_map<std::pair<uint64_t, logid_t>,
                      std::map<vsn_t, VerificationFoundError>>
       acked_unread_;
+
+  const size_t max_cache_size_;
 };
 }} // namespace facebook::logdevice
@@ -55,10 +55,14 @@ int VerificationWriter::append(logid_t logid,
            logid, Payload(customer_payload_ptr, payload_size), r.attrs.lsn));
   };
 
-  // Insert the just-appended sequence number into the in-flight list.
-  gvd_->log_states_[logid].in_flight.insert(appended_seq_num);
   new_payload_buffer += payload;
-  return ds_->append(logid, std::move(new_payload_buffer), mod_cb, attrs);
+  int rv = ds_->append(logid, std::move(new_payload_buffer), mod_cb, attrs);
+  if (rv != 0) {
+    // The callback won't be called. Complete the append as failed, otherwise
+    // its sequence number would stay in flight forever.
+    gvd_->appendUpdateOnCallback(logid, appended_seq_num, LSN_INVALID, {});
+  }
+  return rv;
 }
 
 }} // namespace facebook::logdevice
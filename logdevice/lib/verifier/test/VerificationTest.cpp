@@ -36,7 +36,7 @@ TEST(VerificationTest, serializeVerificationDataTest) {
     log_state.next_seq_num = vsn_t(folly::Random::rand64());
     int num_in_flight = folly::Random::rand64(5, 20);
     for (int j = 0; j < num_in_flight; j++) {
-      log_state.in_flight.insert(vsn_t(folly::Random::rand64()));
+      log_state.in_flight.push(log_state.next_seq_num++);
     }
     int num_to_ack = folly::Random::rand64(5, 20);
     for (int j = 0; j < num_to_ack; j++) {
@@ -55,7 +55,7 @@ TEST(VerificationTest, serializeVerificationDataTest) {
     vd.vdh.magic_number = vflag_;
     vd.vdh.writer_id = gvd.getWriterID();
     vd.vdh.sequence_num = log_state.next_seq_num - 1;
-    vd.vdh.oldest_in_flight = *(log_state.in_flight.begin());
+    vd.vdh.oldest_in_flight = log_state.next_seq_num - num_in_flight - 1;
     vd.vdh.payload_checksum = folly::hash::fnv32(ps);
     vd.ack_list = std::vector<std::pair<vsn_t, lsn_t>>(
         log_state.to_ack_list.begin(), log_state.to_ack_list.end());
@@ -77,6 +77,45 @@ TEST(VerificationTest, serializeVerificationDataTest) {
   }
 }
 
+TEST(VerificationTest, InFlightWindowTest) {
+  InFlightWindow window;
+  EXPECT_TRUE(window.empty());
+
+  // Push enough sequence numbers to span several words of the bitmap.
+  const vsn_t first = 1000;
+  const size_t n = 200;
+  for (vsn_t seq = first; seq < first + n; seq++) {
+    window.push(seq);
+  }
+  EXPECT_EQ(n, window.size());
+  EXPECT_EQ(first, window.oldest());
+  EXPECT_EQ(first + n, window.end());
+
+  // Completing appends out of order only slides the window once the oldest
+  // one completes.
+  EXPECT_TRUE(window.complete(first + 1));
+  EXPECT_FALSE(window.complete(first + 1));
+  EXPECT_FALSE(window.contains(first + 1));
+  EXPECT_EQ(first, window.oldest());
+  EXPECT_TRUE(window.complete(first));
+  EXPECT_EQ(first + 2, window.oldest());
+  EXPECT_EQ(n - 2, window.size());
+  EXPECT_FALSE(window.complete(first));
+
+  for (vsn_t seq = first + n - 1; seq >= first + 2; seq--) {
+    EXPECT_TRUE(window.contains(seq));
+    EXPECT_TRUE(window.complete(seq));
+  }
+  EXPECT_TRUE(window.empty());
+  EXPECT_EQ(window.end(), window.oldest());
+
+  // Once empty, the window restarts wherever the next push is.
+  window.push(5);
+  EXPECT_EQ(5, window.oldest());
+  EXPECT_TRUE(window.contains(5));
+  EXPECT_FALSE(window.contains(first));
+}
+
 static void
 initializeAndAppend(VerificationWriter& vw,
                     logid_t curr_logid,
@@ -174,8 +213,9 @@ TEST(VerificationTest, AppendCompletedVerificationDataUpdatesTest) {
     }
     std::stable_sort(record_ack_list.begin(), record_ack_list.end());
 
+    auto& log_state = gvd.log_states_[curr_logid];
     for (int j = 0; j < folly::Random::rand64(5, 20); j++) {
-      gvd.log_states_[curr_logid].in_flight.insert(folly::Random::rand64());
+      log_state.in_flight.push(log_state.next_seq_num++);
     }
     lsn_t appended_lsn;
     bool appendsuccess = folly::Random::oneIn(2);
@@ -186,15 +226,12 @@ TEST(VerificationTest, AppendCompletedVerificationDataUpdatesTest) {
     } else {
       appended_lsn = LSN_INVALID;
     }
-    std::set<uint64_t>::iterator it =
-        gvd.log_states_[curr_logid].in_flight.begin();
-    std::advance(
-        it,
-        folly::Random::rand64(0, gvd.log_states_[curr_logid].in_flight.size()));
-    uint64_t appended_seq_num = *it;
-    std::set<uint64_t> expected_in_flight =
-        gvd.log_states_[curr_logid].in_flight;
-    expected_in_flight.erase(appended_seq_num);
+    uint64_t appended_seq_num;
+    do {
+      appended_seq_num = folly::Random::rand64(
+          log_state.in_flight.oldest(), log_state.in_flight.end());
+    } while (!log_state.in_flight.contains(appended_seq_num));
+    size_t expected_in_flight_size = log_state.in_flight.size() - 1;
     std::set<std::pair<uint64_t, lsn_t>> expected_to_ack_list =
         gvd.log_states_[curr_logid].to_ack_list;
     expected_to_ack_list.insert(std::make_pair(appended_seq_num, appended_lsn));
@@ -202,7 +239,8 @@ TEST(VerificationTest, AppendCompletedVerificationDataUpdatesTest) {
     gvd.appendUpdateOnCallback(
         curr_logid, appended_seq_num, appended_lsn, record_ack_list);
 
-    EXPECT_EQ(gvd.log_states_[curr_logid].in_flight, expected_in_flight);
+    EXPECT_FALSE(log_state.in_flight.contains(appended_seq_num));
+    EXPECT_EQ(expected_in_flight_size, log_state.in_flight.size());
 
     if (appendsuccess) {
       std::set<std::pair<uint64_t, lsn_t>> new_to_ack_list;
@@ -59,6 +59,9 @@ struct Context {
   folly::Optional<std::chrono::milliseconds> commandTimeout;
   std::string config_path;
   bool use_ssl{false};
+  // Maximum number of nodes an admin command is sent to at a time. 0 means
+  // no limit.
+  size_t max_admin_commands_in_flight{256};
 
   // If true, convert values of some types to human-readable strings,
   // e.g. LSNs like "e5n42" and timestamps like "2017-02-23 12:20:34.137".
@@ -353,4 +353,12 @@ bool LDQuery::getPrettyOutput() const {
   return ctx_->pretty_output;
 }
 
+void LDQuery::setMaxAdminCommandsInFlight(size_t val) {
+  ctx_->max_admin_commands_in_flight = val;
+}
+
+size_t LDQuery::getMaxAdminCommandsInFlight() const {
+  return ctx_->max_admin_commands_in_flight;
+}
+
 }}} // namespace facebook::logdevice::ldquery
@@ -72,6 +72,13 @@ class LDQuery {
   void setPrettyOutput(bool val);
   bool getPrettyOutput() const;
 
+  /**
+   * @param val maximum number of nodes that tables backed by admin commands
+   *            query at a time. 0 means all nodes at once.
+   */
+  void setMaxAdminCommandsInFlight(size_t val);
+  size_t getMaxAdminCommandsInFlight() const;
+
  private:
   // Call sqlite3_step() to extract rows from the given statement and build a
   // QueryResult object.
@@ -190,6 +190,27 @@ bool Table::columnHasEqualityConstraintOnLogid(int col,
   return true;
 }
 
+bool Table::columnHasEqualityConstraintOnClientID(int col,
+                                                  QueryContext& ctx,
+                                                  int32_t& client_idx) const {
+  std::string expr;
+  if (!columnHasEqualityConstraint(col, ctx, expr)) {
+    return false;
+  }
+  folly::StringPiece str(expr);
+  int32_t idx = 0;
+  if (str.removePrefix("C")) {
+    idx = folly::tryTo<int32_t>(str).value_or(0);
+  }
+  if (idx <= 0) {
+    // Not a client id the server can filter on. Let SQLite filter.
+    ctx.used_constraints.erase(col);
+    return false;
+  }
+  client_idx = idx;
+  return true;
+}
+
 bool Table::columnHasConstraintsOnLSN(int col,
                                       QueryContext& ctx,
                                       std::pair<lsn_t, lsn_t>& range) const {
@@ -264,6 +264,19 @@ class Table {
                                           QueryContext& ctx,
                                           logid_t& logid) const;
 
+  /**
+   * Checks if there is an equality constraint on column `col` for a client id
+   * such as "C42".
+   * @param col Column for which to look for constraints;
+   * @param ctx Query context;
+   * @param client_idx if there is an equality constraint on a valid client
+   *        id, populate this with its index (42 in the example above).
+   * @return True if such an equality constraint was found.
+   */
+  bool columnHasEqualityConstraintOnClientID(int col,
+                                             QueryContext& ctx,
+                                             int32_t& client_idx) const;
+
   /**
    * Checks if there are constraints to be applied on the column `col` that is
    * for a LSN.
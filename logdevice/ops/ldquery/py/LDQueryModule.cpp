@@ -131,6 +131,13 @@ BOOST_PYTHON_MODULE(ext) {
            args("val"))
       .def("server_side_filtering_enabled",
            +[](LDQuery& self) { return self.serverSideFilteringEnabled(); })
+      .def("set_max_admin_commands_in_flight",
+           +[](LDQuery& self, object val) {
+             self.setMaxAdminCommandsInFlight(extract<size_t>(val));
+           },
+           args("val"))
+      .def("get_max_admin_commands_in_flight",
+           +[](LDQuery& self) { return self.getMaxAdminCommandsInFlight(); })
 
       .def("query",
            &ldquery_query,
@@ -47,6 +47,18 @@ class LDQuery(object):
     def server_side_filtering(self, val):
         self._client.enable_server_side_filtering(val)
 
+    @property
+    def max_admin_commands_in_flight(self):
+        """
+        Maximum number of nodes queried at a time by tables backed by admin
+        commands. 0 means all nodes at once.
+        """
+        return self._client.get_max_admin_commands_in_flight()
+
+    @max_admin_commands_in_flight.setter
+    def max_admin_commands_in_flight(self, val):
+        self._client.set_max_admin_commands_in_flight(val)
+
     def execute(self, statement):
         """
         Runs the query string (can be multiple queries separated by semi-column)
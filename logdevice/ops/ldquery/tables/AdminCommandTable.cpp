@@ -14,6 +14,7 @@
 #include <folly/json.h>
 
 #include "external/gason/gason.h"
+#include "logdevice/common/AdminCommandTable.h"
 #include "logdevice/common/configuration/UpdateableConfig.h"
 #include "logdevice/common/debug.h"
 #include "logdevice/lib/ClientImpl.h"
@@ -283,7 +284,11 @@ void AdminCommandTable::refillCache(QueryContext& ctx) {
           requests.size());
 
   steady_clock::time_point tstart = steady_clock::now();
-  auto responses = ld_admin_client.send(requests, command_timeout_);
+  auto responses =
+      ld_admin_client.send(requests,
+                           command_timeout_,
+                           std::chrono::milliseconds(5000),
+                           ld_ctx_->max_admin_commands_in_flight);
   ld_check(requests.size() == responses.size());
   steady_clock::time_point tend = steady_clock::now();
   double duration =
@@ -631,6 +636,39 @@ PartialTableData AdminCommandTable::jsonToTableData(std::string json) const {
   return PartialTableData{std::move(results), true, ""};
 }
 
+PartialTableData AdminCommandTable::binaryToTableData(std::string data) const {
+  admin_command_table::BinaryTable table;
+  if (!admin_command_table::parseBinaryTable(data, table)) {
+    RATELIMIT_ERROR(std::chrono::seconds(1), 1, "Cannot parse binary result");
+    return PartialTableData{folly::none, false, "MALFORMED_RESPONSE"};
+  }
+
+  // Values are already grouped by column, so columns are moved as a whole.
+  TableData results;
+  for (size_t i = 0; i < table.headers.size(); ++i) {
+    std::string name = std::move(table.headers[i]);
+    NameNormalizer::normalize(name);
+
+    auto it = nameToPosMap_.find(name);
+    if (it == nameToPosMap_.end()) {
+      // LDQuery does not know about this column. Just ignore it.
+      continue;
+    }
+    const int col_pos = it->second;
+    ld_check(getFetchableColumns()[col_pos].name == name);
+    const DataType type = getFetchableColumns()[col_pos].type;
+    Column& column = results.cols[name];
+    column = std::move(table.columns[i]);
+    for (auto& value : column) {
+      if (value.hasValue()) {
+        preprocessColumn(type, &value);
+      }
+    }
+  }
+
+  return PartialTableData{std::move(results), true, ""};
+}
+
 PartialTableData
 AdminCommandTable::statToTableData(std::string stat_output) const {
   TableData result;
@@ -688,6 +726,9 @@ PartialTableData
 AdminCommandTable::transformData(std::string response_from_node) const {
   switch (type_) {
     case Type::JSON_TABLE:
+      if (admin_command_table::isBinaryTable(response_from_node)) {
+        return binaryToTableData(std::move(response_from_node));
+      }
       return jsonToTableData(std::move(response_from_node));
     case Type::STAT:
       return statToTableData(std::move(response_from_node));
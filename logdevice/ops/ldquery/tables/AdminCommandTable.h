@@ -61,6 +61,10 @@ class AdminCommandTable : public Table {
   // converts json to a column representation
   PartialTableData jsonToTableData(std::string json) const;
 
+  // converts a table in binary format (see
+  // admin_command_table::BinaryTable) to a column representation
+  PartialTableData binaryToTableData(std::string data) const;
+
   // converts stat output to a column representation
   PartialTableData statToTableData(std::string stat_output) const;
 
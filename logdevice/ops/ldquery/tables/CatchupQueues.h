@@ -75,8 +75,13 @@ class CatchupQueues : public AdminCommandTable {
          "schedule more reads under certain conditions.  This column indicates "
          "whether the timer is currently active."}};
   }
-  std::string getCommandToSend(QueryContext& /*ctx*/) const override {
-    return std::string("info catchup_queues --json\n");
+  std::string getCommandToSend(QueryContext& ctx) const override {
+    int32_t client_idx;
+    if (columnHasEqualityConstraintOnClientID(1, ctx, client_idx)) {
+      return std::string("info catchup_queues --client ") +
+          std::to_string(client_idx) + " --binary\n";
+    }
+    return std::string("info catchup_queues --binary\n");
   }
 };
 
@@ -116,7 +116,20 @@ class Partitions : public AdminCommandTable {
         {"copyset_index_enabled",
          DataType::BOOL,
          "Whether or not copyset_index is enabled for this partition. "
-         "This is controlled by --rocksdb-write-copyset-index setting."}};
+         "This is controlled by --rocksdb-write-copyset-index setting."},
+        {"pending_compaction",
+         DataType::TEXT,
+         "If the low-priority background thread of the shard plans to compact "
+         "this partition, position of the compaction in its queue and its "
+         "reason, e.g. \"#0 RETENTION\". Says if the compaction was postponed "
+         "by --rocksdb-partition-compaction-io-budget or "
+         "--rocksdb-partition-compaction-backoff-read-latency."},
+        {"est_reclaimable_bytes",
+         DataType::BIGINT,
+         "For a pending retention-based compaction, estimated size of the "
+         "records of trimmed logs in the partition, if "
+         "--rocksdb-partition-compaction-min-reclaim-ratio or "
+         "--rocksdb-partition-compaction-order-by-reclaim is set."}};
   }
   std::string getCommandToSend(QueryContext& ctx) const override {
     std::string expr;
@@ -124,11 +124,15 @@ class Readers : public AdminCommandTable {
   }
   std::string getCommandToSend(QueryContext& ctx) const override {
     logid_t logid;
+    int32_t client_idx;
     if (columnHasEqualityConstraintOnLogid(3, ctx, logid)) {
       return std::string("info readers log ") + std::to_string(logid.val_) +
-          " --json\n";
+          " --binary\n";
+    } else if (columnHasEqualityConstraintOnClientID(2, ctx, client_idx)) {
+      return std::string("info readers client ") +
+          std::to_string(client_idx) + " --binary\n";
     } else {
-      return std::string("info readers all --json\n");
+      return std::string("info readers all --binary\n");
     }
   }
 };
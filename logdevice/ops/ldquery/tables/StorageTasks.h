@@ -81,9 +81,10 @@ class StorageTasks : public AdminCommandTable {
   virtual std::string getCommandToSend(QueryContext& ctx) const override {
     std::string expr;
     if (columnHasEqualityConstraint(1, ctx, expr)) {
-      return std::string("info storage_tasks ") + expr.c_str() + " --json\n";
+      return std::string("info storage_tasks ") + expr.c_str() +
+          " --binary\n";
     } else {
-      return std::string("info storage_tasks --json\n");
+      return std::string("info storage_tasks --binary\n");
     }
   }
 };
@@ -52,7 +52,7 @@ class StoredLogs : public AdminCommandTable {
          "\"rocksdb-partition-duration\" setting."}};
   }
   std::string getCommandToSend(QueryContext& /*ctx*/) const override {
-    return std::string("info stored_logs --extended --json\n");
+    return std::string("info stored_logs --extended --binary\n");
   }
 };
 
@@ -7,6 +7,8 @@
  */
 #include "logdevice/ops/py_extensions/admin_command_client/AdminCommandClient.h"
 
+#include <algorithm>
+
 #include <folly/io/async/AsyncSocket.h>
 #include <thrift/lib/cpp/async/TAsyncSSLSocket.h>
 #include <thrift/lib/cpp2/async/HeaderClientChannel.h>
@@ -20,75 +22,84 @@ std::vector<folly::SemiFuture<AdminCommandClient::Response>>
 AdminCommandClient::asyncSend(
     const std::vector<AdminCommandClient::Request>& rr,
     std::chrono::milliseconds command_timeout,
-    std::chrono::milliseconds connect_timeout) const {
-  std::vector<folly::SemiFuture<AdminCommandClient::Response>> futures;
-  futures.reserve(rr.size());
-
-  for (auto& r : rr) {
-    futures.push_back(
-        folly::via(executor_.get())
-            .then([executor = executor_.get(),
-                   r,
+    std::chrono::milliseconds connect_timeout,
+    size_t max_in_flight) const {
+  auto send_one = [executor = executor_.get(),
                    connect_timeout,
-                   command_timeout](auto&&) mutable {
-              auto evb = executor->getEventBase();
+                   command_timeout](AdminCommandClient::Request r) {
+    return folly::via(executor).then(
+        [executor, r, connect_timeout, command_timeout](auto&&) mutable {
+          auto evb = executor->getEventBase();
 
-              auto command = r.request;
-              // Ldquery appends an extra new line at the end of the commands.
-              // Strip it for now, and remove it in the next diff.
-              if (folly::StringPiece(command).endsWith("\n")) {
-                command.resize(command.size() - 1);
-              }
+          auto command = r.request;
+          // Ldquery appends an extra new line at the end of the commands.
+          // Strip it for now, and remove it in the next diff.
+          if (folly::StringPiece(command).endsWith("\n")) {
+            command.resize(command.size() - 1);
+          }
 
-              std::shared_ptr<folly::SSLContext> ssl_context{nullptr};
-              std::shared_ptr<folly::AsyncSocket> transport;
-              if (r.type == Request::ConnectionType::PLAIN) {
-                transport = folly::AsyncSocket::newSocket(evb);
-              } else {
-                ssl_context = std::make_shared<folly::SSLContext>();
-                transport = apache::thrift::async::TAsyncSSLSocket::newSocket(
-                    ssl_context, evb);
-              }
-              transport->connect(nullptr, r.sockaddr, connect_timeout.count());
-              auto channel = apache::thrift::HeaderClientChannel::newChannel(
-                  std::move(transport));
-              channel->setTimeout(connect_timeout.count());
-              auto client = std::make_unique<thrift::AdminAPIAsyncClient>(
-                  std::move(channel));
+          std::shared_ptr<folly::SSLContext> ssl_context{nullptr};
+          std::shared_ptr<folly::AsyncSocket> transport;
+          if (r.type == Request::ConnectionType::PLAIN) {
+            transport = folly::AsyncSocket::newSocket(evb);
+          } else {
+            ssl_context = std::make_shared<folly::SSLContext>();
+            transport = apache::thrift::async::TAsyncSSLSocket::newSocket(
+                ssl_context, evb);
+          }
+          transport->connect(nullptr, r.sockaddr, connect_timeout.count());
+          auto channel = apache::thrift::HeaderClientChannel::newChannel(
+              std::move(transport));
+          channel->setTimeout(connect_timeout.count());
+          auto client = std::make_unique<thrift::AdminAPIAsyncClient>(
+              std::move(channel));
 
-              apache::thrift::RpcOptions rpc_options;
-              rpc_options.setTimeout(command_timeout);
+          apache::thrift::RpcOptions rpc_options;
+          rpc_options.setTimeout(command_timeout);
 
-              thrift::AdminCommandRequest req;
-              *req.request_ref() = command;
+          thrift::AdminCommandRequest req;
+          *req.request_ref() = command;
 
-              return client
-                  ->semifuture_executeAdminCommand(rpc_options, std::move(req))
-                  .via(evb)
-                  .thenTry([ssl_context](auto response) {
-                    if (response.hasException()) {
-                      return AdminCommandClient::Response{
-                          "", false, response.exception().what().toStdString()};
-                    }
-                    std::string result = *response->response_ref();
-                    // Strip the trailing END
-                    if (folly::StringPiece(result).endsWith("END\r\n")) {
-                      result.resize(result.size() - 5);
-                    }
-                    return AdminCommandClient::Response{
-                        std::move(result), true, ""};
-                  });
-            }));
-  }
+          return client
+              ->semifuture_executeAdminCommand(rpc_options, std::move(req))
+              .via(evb)
+              .thenTry([ssl_context](auto response) {
+                if (response.hasException()) {
+                  return AdminCommandClient::Response{
+                      "", false, response.exception().what().toStdString()};
+                }
+                std::string result = *response->response_ref();
+                // Strip the trailing END
+                if (folly::StringPiece(result).endsWith("END\r\n")) {
+                  result.resize(result.size() - 5);
+                }
+                return AdminCommandClient::Response{
+                    std::move(result), true, ""};
+              });
+        });
+  };
 
+  // Start the next request whenever one completes, so that at most
+  // `max_in_flight` connections are open at a time.
+  std::vector<folly::SemiFuture<AdminCommandClient::Response>> futures;
+  futures.reserve(rr.size());
+  for (auto& f : folly::window(
+           rr,
+           std::move(send_one),
+           max_in_flight == 0 ? std::max<size_t>(rr.size(), 1)
+                              : max_in_flight)) {
+    futures.push_back(std::move(f).semi());
+  }
   return futures;
 }
 
 std::vector<AdminCommandClient::Response>
 AdminCommandClient::send(const std::vector<AdminCommandClient::Request>& rr,
                          std::chrono::milliseconds command_timeout,
-                         std::chrono::milliseconds connect_timeout) const {
-  return collectAll(asyncSend(rr, command_timeout, connect_timeout))
+                         std::chrono::milliseconds connect_timeout,
+                         size_t max_in_flight) const {
+  return collectAll(
+             asyncSend(rr, command_timeout, connect_timeout, max_in_flight))
       .via(executor_.get())
       .thenValue(
           [](std::vector<folly::Try<AdminCommandClient::Response>> results) {
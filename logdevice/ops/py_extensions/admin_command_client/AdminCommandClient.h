@@ -51,16 +51,23 @@ class AdminCommandClient {
     std::string failure_reason{""};
   };
 
+  /**
+   * @param max_in_flight  maximum number of requests sent at a time. The
+   *                       next request is sent when one completes. 0 means
+   *                       no limit.
+   */
   std::vector<Response> send(const std::vector<Request>& r,
                              std::chrono::milliseconds command_timeout,
                              std::chrono::milliseconds connect_timeout =
-                                 std::chrono::milliseconds(5000)) const;
+                                 std::chrono::milliseconds(5000),
+                             size_t max_in_flight = 0) const;
 
   std::vector<folly::SemiFuture<Response>>
   asyncSend(const std::vector<Request>& rr,
             std::chrono::milliseconds command_timeout,
             std::chrono::milliseconds connect_timeout =
-                std::chrono::milliseconds(5000)) const;
+                std::chrono::milliseconds(5000),
+            size_t max_in_flight = 0) const;
 
  private:
   std::unique_ptr<folly::IOThreadPoolExecutor> executor_;
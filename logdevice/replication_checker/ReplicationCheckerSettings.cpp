@@ -28,6 +28,27 @@ void ReplicationCheckerSettings::defineSettings(SettingEasyInit& init) {
        nullptr,
        "Maximum read throughput per log in bytes per seconds",
        CLIENT);
+  init("max-total-bps",
+       &max_total_bps,
+       "0",
+       nullptr,
+       "Maximum read throughput of this checker process over all logs in bytes "
+       "per second, split evenly between worker threads. Use it to keep "
+       "continuous checking within the read IO budget of the cluster. 0 means "
+       "unlimited.",
+       CLIENT);
+  init("progress-file",
+       &progress_file,
+       "",
+       nullptr,
+       "If set, remember in this file up to which LSN each log was checked, "
+       "and start checking each log right after that LSN. This makes repeated "
+       "runs incremental, only checking records written since the previous "
+       "run, and lets an interrupted run resume where it stopped. The file is "
+       "saved every minute and when the checker finishes. When splitting the "
+       "work with --num-tasks, give each task its own file. Takes precedence "
+       "over --read-starting-point for logs present in the file.",
+       CLIENT);
   init("num-logs-to-check",
        &num_logs_to_check,
        "-1",
@@ -33,6 +33,8 @@ class ReplicationCheckerSettings : public SettingsBundle {
   // See cpp file for a documentation about these settings.
   size_t logs_in_flight_per_worker;
   size_t per_log_max_bps;
+  size_t max_total_bps;
+  std::string progress_file;
   double num_logs_to_check;
   bool csi_data_only;
   bool only_data_logs;
@@ -6,15 +6,18 @@
  * LICENSE file in the root directory of this source tree.
  */
 #include <signal.h>
+#include <cstdio>
 #include <unordered_map>
 #include <unordered_set>
 
 #include <boost/program_options.hpp>
 #include <boost/tokenizer.hpp>
 #include <folly/Bits.h>
+#include <folly/FileUtil.h>
 #include <folly/Random.h>
 #include <folly/Range.h>
 #include <folly/Singleton.h>
+#include <folly/String.h>
 #include <folly/Varint.h>
 #include <folly/dynamic.h>
 #include <folly/json.h>
@@ -99,6 +102,18 @@ std::chrono::steady_clock::time_point start_time;
 size_t logs_to_check_initial_count;
 std::atomic<size_t> num_failures_to_stop{0};
 
+// If --progress-file is set, up to which LSN each log was checked, including
+// logs checked by previous runs. Protected by `mutex`.
+std::map<logid_t, lsn_t> checked_until;
+
+// Bytes read by all LogCheckers of a worker thread in the current throttling
+// period, for --max-total-bps.
+struct WorkerReadBudget {
+  std::chrono::steady_clock::time_point period_start;
+  size_t bytes = 0;
+};
+static thread_local WorkerReadBudget worker_read_budget;
+
 class PerWorkerCoordinatorRequest;
 std::vector<std::unique_ptr<PerWorkerCoordinatorRequest>> worker_coordinators;
 
@@ -633,6 +648,11 @@ class LogChecker : public std::enable_shared_from_this<LogChecker> {
     return latest_replication_factor_;
   }
 
+  // All records up to this LSN were checked, or LSN_INVALID if none were.
+  lsn_t getCheckedUntil() const {
+    return checked_until_;
+  }
+
   std::set<copyset_size_t> getReplicationFactors() const {
     return replication_factors_;
   }
@@ -647,9 +667,11 @@ class LogChecker : public std::enable_shared_from_this<LogChecker> {
     auto callback_ticket = callbackHelper_.ticket();
     // Invoke findtime to get the starting lsn for read. FindTime does not work
     // for metadata logs. Hence, read them completely hoping that they are quick
-    // to read.
+    // to read. Not needed if we continue from where the previous run stopped
+    // (--progress-file).
     if (checker_settings->read_starting_point.count() > 0 &&
-        !MetaDataLog::isMetaDataLog(log_id_) && did_findtime_ == false) {
+        !MetaDataLog::isMetaDataLog(log_id_) && did_findtime_ == false &&
+        start_lsn_ == LSN_OLDEST) {
       auto timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
           std::chrono::system_clock::now().time_since_epoch() -
           checker_settings->read_starting_point);
@@ -752,6 +774,7 @@ class LogChecker : public std::enable_shared_from_this<LogChecker> {
   const std::function<void(std::shared_ptr<LogChecker>)> done_callback_;
   lsn_t start_lsn_;
   lsn_t until_lsn_;
+  lsn_t checked_until_{LSN_INVALID};
   size_t latest_replication_factor_;
   read_stream_id_t rsid_{READ_STREAM_ID_INVALID};
   std::shared_ptr<UpdateableNodesConfiguration> nodes_cfg_;
@@ -779,6 +802,26 @@ class LogChecker : public std::enable_shared_from_this<LogChecker> {
   bool finished_{false};
   size_t bytes_ = 0;
 
+  // Throttling of all logs read by this worker, for --max-total-bps. Uses
+  // the same 100ms periods as per-log throttling; throttled logs try again on
+  // their next onThrottleTimerTick().
+  static bool workerReadBudgetExhausted() {
+    if (checker_settings->max_total_bps == 0) {
+      return false;
+    }
+    const auto period = std::chrono::milliseconds{100};
+    auto now = std::chrono::steady_clock::now();
+    if (now - worker_read_budget.period_start >= period) {
+      worker_read_budget.period_start = now;
+      worker_read_budget.bytes = 0;
+    }
+    const size_t nworkers =
+        std::max(1, processor->getWorkerCount(WorkerType::GENERAL));
+    return worker_read_budget.bytes >=
+        checker_settings->max_total_bps / nworkers /
+        (std::chrono::milliseconds{1000} / period);
+  }
+
   void onThrottleTimerTick() {
     bytes_ = 0;
     if (throttled_) {
@@ -798,6 +841,7 @@ class LogChecker : public std::enable_shared_from_this<LogChecker> {
   }
 
   void startReading() {
+    checked_until_ = start_lsn_ - 1;
     if (until_lsn_ < start_lsn_) {
       finish("");
       return;
@@ -823,6 +867,7 @@ class LogChecker : public std::enable_shared_from_this<LogChecker> {
                 if (!self->gotAllCopiesOfRecord(record->attrs.lsn)) {
                   return false;
                 }
+                self->checked_until_ = record->attrs.lsn;
                 record.reset();
                 return true;
               }
@@ -831,11 +876,13 @@ class LogChecker : public std::enable_shared_from_this<LogChecker> {
             [self_weak](const GapRecord& gap) {
               if (auto self = self_weak.lock()) {
                 self->gotGap(gap);
+                self->checked_until_ = gap.hi;
               }
               return true;
             },
             [self_weak](logid_t) {
               if (auto self = self_weak.lock()) {
+                self->checked_until_ = self->until_lsn_;
                 self->finish("");
               }
             },
@@ -926,7 +973,8 @@ class LogChecker : public std::enable_shared_from_this<LogChecker> {
 
   bool gotAllCopiesOfRecord(lsn_t lsn) {
     auto g = std::chrono::milliseconds{1000} / std::chrono::milliseconds{100};
-    if (bytes_ >= checker_settings->per_log_max_bps / g) {
+    if (bytes_ >= checker_settings->per_log_max_bps / g ||
+        workerReadBudgetExhausted()) {
       throttled_ = true;
       return false;
     }
@@ -998,6 +1046,7 @@ class LogChecker : public std::enable_shared_from_this<LogChecker> {
     }
 
     bytes_ += copies.begin()->second.payload_size;
+    worker_read_budget.bytes += copies.begin()->second.payload_size;
     Slice s;
     folly::Range<const ShardID*> copyset(copies.begin()->second.copyset.begin(),
                                          copies.begin()->second.copyset.end());
@@ -1493,6 +1542,12 @@ class PerWorkerCoordinatorRequest : public Request {
     ++perf_stats_->finished_logs;
     ld_check(in_flight_.count(c));
     in_flight_.erase(c);
+    if (!checker_settings->progress_file.empty() &&
+        c->getCheckedUntil() != LSN_INVALID) {
+      std::lock_guard<std::mutex> lock(mutex);
+      lsn_t& lsn = checked_until[rq.log_id];
+      lsn = std::max(lsn, c->getCheckedUntil());
+    }
     ld_info("finished log %lu%s, %lu in flight",
             rq.log_id.val_,
             (c->getError().empty() ? std::string()
@@ -1547,6 +1602,62 @@ class PerWorkerCoordinatorRequest : public Request {
   }
 };
 
+// Reads `checked_until` from --progress-file. The file is a JSON object
+// mapping log ids to the LSN up to which they were checked. Returns false if
+// the file exists but can't be read.
+static bool load_progress(const std::string& path) {
+  std::string contents;
+  if (!folly::readFile(path.c_str(), contents)) {
+    if (errno == ENOENT) {
+      ld_info("Progress file %s doesn't exist yet, checking all logs from the "
+              "beginning",
+              path.c_str());
+      return true;
+    }
+    ld_error("Failed to read progress file %s: %s",
+             path.c_str(),
+             folly::errnoStr(errno).c_str());
+    return false;
+  }
+  try {
+    folly::dynamic progress = folly::parseJson(contents);
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto& kv : progress.items()) {
+      logid_t log_id(folly::to<logid_t::raw_type>(kv.first.asString()));
+      checked_until[log_id] = kv.second.asInt();
+    }
+  } catch (const std::exception& ex) {
+    ld_error("Invalid progress file %s: %s", path.c_str(), ex.what());
+    return false;
+  }
+  ld_info("Loaded progress of %lu logs from %s",
+          checked_until.size(),
+          path.c_str());
+  return true;
+}
+
+// Writes `checked_until` to --progress-file, replacing it atomically.
+static void save_progress() {
+  const std::string& path = checker_settings->progress_file;
+  if (path.empty()) {
+    return;
+  }
+  folly::dynamic progress = folly::dynamic::object();
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto& kv : checked_until) {
+      progress[folly::to<std::string>(kv.first.val_)] = kv.second;
+    }
+  }
+  const std::string tmp_path = path + ".tmp";
+  if (!folly::writeFile(folly::toJson(progress), tmp_path.c_str()) ||
+      std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+    ld_error("Failed to write progress file %s: %s",
+             path.c_str(),
+             folly::errnoStr(errno).c_str());
+  }
+}
+
 class StatThread {
  public:
   explicit StatThread(std::shared_ptr<PerfStats> perf_stats)
@@ -1564,10 +1675,16 @@ class StatThread {
 
     uint64_t last_ncopies_received = 0;
     uint64_t last_payload_bytes = 0;
+    auto last_progress_save_time = tstart;
 
     while (!shutdown_.waitFor(std::chrono::seconds(1))) {
       auto tnow = steady_clock::now();
 
+      if (tnow - last_progress_save_time >= std::chrono::minutes(1)) {
+        save_progress();
+        last_progress_save_time = tnow;
+      }
+
       uint64_t ncopies_received = perf_stats_->ncopies_received.load();
       uint64_t payload_bytes = perf_stats_->payload_bytes.load();
       uint64_t nrecords_processed = perf_stats_->nrecords_processed.load();
@@ -1737,8 +1854,10 @@ void print_stats_signal(int) {
 void print_stats_and_die_signal(int) {
   ld_info("Received termination signal. Printing current stats. Hit control-C "
           "again to terminate immediately");
-  std::unique_ptr<Request> rq =
-      std::make_unique<CurrentStatsRequest>([] { _exit(130); });
+  std::unique_ptr<Request> rq = std::make_unique<CurrentStatsRequest>([] {
+    save_progress();
+    _exit(130);
+  });
   processor->postWithRetrying(rq);
 }
 
@@ -1953,6 +2072,11 @@ int main(int argc, const char** argv) {
   ClientImpl* client_impl = static_cast<ClientImpl*>(ldclient.get());
   config = client_impl->getConfig();
 
+  if (!checker_settings->progress_file.empty() &&
+      !load_progress(checker_settings->progress_file)) {
+    return 1;
+  }
+
   auto cfg = config->get();
   auto logs_config = cfg->localLogsConfig();
   std::set<logid_t> logids_to_check_set(
@@ -1965,11 +2089,14 @@ int main(int argc, const char** argv) {
 
       if ((log_id.val_ % numTasks) == taskId) {
         ld_debug("Queueing log %lu for checking", log_id.val_);
+        // Continue after the last LSN checked by previous runs, if any.
+        auto progress_it = checked_until.find(log_id);
         logs_to_check.push_back({
             log_id,
             replication_factor,
-            1,       // start_lsn
-            LSN_MAX, // until_lsn
+            progress_it != checked_until.end() ? progress_it->second + 1
+                                               : 1, // start_lsn
+            LSN_MAX,                                // until_lsn
         });
       } else {
         ld_debug("Skipping log %lu due to instance filter", log_id.val_);
@@ -2060,6 +2187,7 @@ int main(int argc, const char** argv) {
   setup_signal_handler(SIGUSR1, SIG_DFL);
 
   stat_thread_obj.stop();
+  save_progress();
 
   GlobalStats st;
   for (const auto& rq : worker_coordinators) {
@@ -9,8 +9,10 @@
 
 #include <algorithm>
 #include <chrono>
+#include <vector>
 
 #include <folly/Memory.h>
+#include <folly/ScopeGuard.h>
 #include <folly/small_vector.h>
 
 #include "logdevice/common/AdminCommandTable.h"
@@ -90,6 +92,7 @@ EpochRecordCache::createFromSnapshot(logid_t log_id,
   // copy the tail record if it is valid
   if (header->flags & CacheHeader::VALID_TAIL_RECORD) {
     result->tail_record_ = snapshot.tail_record_;
+    result->publishTailRecord();
   } else {
     ld_check(!result->tail_record_.isValid());
   }
@@ -152,19 +155,64 @@ esn_t EpochRecordCache::getLNG(esn_t::raw_type head) {
   return (head > ESN_INVALID.val_ ? esn_t(head - 1) : ESN_INVALID);
 }
 
+std::shared_lock<EpochRecordCache::FairRWLock>
+EpochRecordCache::lockForRead() const {
+  std::shared_lock<FairRWLock> guard(rw_lock_, std::try_to_lock);
+  if (!guard.owns_lock()) {
+    STAT_INCR(deps_->getStatsHolder(), record_cache_read_lock_contended);
+    guard.lock();
+  }
+  return guard;
+}
+
+std::unique_lock<EpochRecordCache::FairRWLock>
+EpochRecordCache::lockForWrite() {
+  std::unique_lock<FairRWLock> guard(rw_lock_, std::try_to_lock);
+  if (!guard.owns_lock()) {
+    STAT_INCR(deps_->getStatsHolder(), record_cache_write_lock_contended);
+    guard.lock();
+  }
+  return guard;
+}
+
+template <typename Func>
+bool EpochRecordCache::readConsistent(const Func& func) const {
+  // Number of lock-free attempts before falling back to rw_lock_.
+  constexpr int MAX_ATTEMPTS = 4;
+  for (int attempt = 0; attempt < MAX_ATTEMPTS; ++attempt) {
+    const uint64_t seq = seq_.load();
+    if (seq % 2 == 0) {
+      const bool result = func();
+      if (seq_.load() == seq) {
+        return result;
+      }
+    }
+  }
+  STAT_INCR(deps_->getStatsHolder(), record_cache_seqlock_read_fallbacks);
+  auto read_guard = lockForRead();
+  return func();
+}
+
+void EpochRecordCache::publishTailRecord() {
+  published_tail_record_.store(
+      tail_record_.isValid() ? std::make_shared<TailRecord>(tail_record_)
+                             : nullptr);
+}
+
 bool EpochRecordCache::empty() const {
-  // TODO: if locking turns out to be cpu-intensive, consider
-  // merging the two atomics into a single 64-bit atomic variable
-  FairRWLock::ReadHolder read_guard(rw_lock_);
-  // never stored or all records evicted (lng >= max_seen)
-  return head_ == ESN_INVALID.val_ || head_ > max_seen_esn_;
+  return readConsistent([this] {
+    // never stored or all records evicted (lng >= max_seen)
+    return head_ == ESN_INVALID.val_ || head_ > max_seen_esn_;
+  });
 }
 
 bool EpochRecordCache::emptyWithoutTailPayload() const {
-  FairRWLock::ReadHolder read_guard(rw_lock_);
-  // never stored or all records evicted (lng >= max_seen)
-  return (head_ == ESN_INVALID.val_ || head_ > max_seen_esn_) &&
-      !tail_record_.hasPayload();
+  return readConsistent([this] {
+    // never stored or all records evicted (lng >= max_seen)
+    const auto tail = published_tail_record_.load();
+    return (head_ == ESN_INVALID.val_ || head_ > max_seen_esn_) &&
+        (tail == nullptr || !tail->hasPayload());
+  });
 }
 
 bool EpochRecordCache::isConsistent() const {
@@ -289,7 +337,11 @@ int EpochRecordCache::putRecord(RecordID rid,
   };
 
   do {
-    FairRWLock::WriteHolder write_guard(rw_lock_);
+    auto write_guard = lockForWrite();
+    seq_.fetch_add(1);
+    SCOPE_EXIT {
+      seq_.fetch_add(1);
+    };
 
     // recheck with the lock held
     head = esn_t(head_.load());
@@ -301,6 +353,10 @@ int EpochRecordCache::putRecord(RecordID rid,
     // update the cache based on the new lng received, evicting entries if
     // necessary
     advanceLNGImpl(head, lng, entries_to_drop);
+    if (disabled_.load()) {
+      rv = -1;
+      break;
+    }
 
     // insert the record to the cache
     head = esn_t(head_.load());
@@ -411,6 +467,7 @@ void EpochRecordCache::updateTailRecord(
                   {}},
                  std::move(offsets),
                  tail_optimized_ == TailOptimized::YES ? tail : nullptr);
+  publishTailRecord();
 }
 
 // must be called with write lock held
@@ -418,6 +475,7 @@ void EpochRecordCache::advanceLNGImpl(esn_t current_head,
                                       esn_t lng,
                                       ReleasedVector& disposal) {
   ld_assert(!disabled_.load());
+  const size_t first_evicted = disposal.size();
 
   if (current_head != ESN_INVALID) {
     if (lng >= current_head) {
@@ -440,6 +498,25 @@ void EpochRecordCache::advanceLNGImpl(esn_t current_head,
       buffer_.rotate(new_head - current_head.val_);
       head_.store(new_head);
 
+      // Released records become the tail record and may be shipped to
+      // readers, which need the payloads as stored.
+      for (size_t i = first_evicted; i < disposal.size(); ++i) {
+        if (!uncompressEntry(disposal[i])) {
+          // The payload is lost. Disable the cache so that readers fall back
+          // to the local log store, as disableCache() would.
+          disabled_.store(true);
+          tail_record_.reset();
+          publishTailRecord();
+          for (size_t j = 0; j < capacity(); ++j) {
+            if (buffer_[j] != nullptr) {
+              noteEntryRemoved(*buffer_[j]);
+              disposal.push_back(std::move(buffer_[j]));
+            }
+          }
+          return;
+        }
+      }
+
       if (evicted) {
         ld_check(!disposal.empty());
         updateTailRecord(disposal.back());
@@ -470,7 +547,11 @@ void EpochRecordCache::advanceLNG(esn_t new_lng) {
 
   ReleasedVector entries_to_drop;
   {
-    FairRWLock::WriteHolder write_guard(rw_lock_);
+    auto write_guard = lockForWrite();
+    seq_.fetch_add(1);
+    SCOPE_EXIT {
+      seq_.fetch_add(1);
+    };
     // recheck with the lock held
     head = esn_t(head_.load());
     if (disabled_.load() || new_lng < head) {
@@ -505,19 +586,24 @@ void EpochRecordCache::amendExistingEntry(
 }
 
 TailRecord EpochRecordCache::getTailRecord() const {
-  FairRWLock::ReadHolder read_guard(rw_lock_);
-  return tail_record_;
+  const auto tail = published_tail_record_.load();
+  return tail != nullptr ? *tail : TailRecord();
 }
 
 void EpochRecordCache::disableCache() {
   bool prev_disabled;
   {
-    FairRWLock::WriteHolder write_guard(rw_lock_);
+    auto write_guard = lockForWrite();
+    seq_.fetch_add(1);
+    SCOPE_EXIT {
+      seq_.fetch_add(1);
+    };
     prev_disabled = disabled_.exchange(true);
     // clear the tail record, have to do it under the lock since there
     // might be readers for the tail optimized log.
     if (!prev_disabled) {
       tail_record_.reset();
+      publishTailRecord();
     }
   }
 
@@ -534,13 +620,102 @@ void EpochRecordCache::disableCache() {
   }
 }
 
+size_t EpochRecordCache::compressPayloads() {
+  if (disabled_.load()) {
+    return 0;
+  }
+
+  // Pick the entries to compress, and compress them, without the lock.
+  std::vector<std::pair<esn_t, std::shared_ptr<EpochRecordCacheEntry>>>
+      candidates;
+  {
+    auto read_guard = lockForRead();
+    const esn_t::raw_type head = head_.load();
+    const esn_t::raw_type max_seen = max_seen_esn_.load();
+    if (disabled_.load() || head == ESN_INVALID.val_ || max_seen < head) {
+      return 0;
+    }
+    for (size_t i = 0; i <= max_seen - head; ++i) {
+      const auto& e = buffer_[i];
+      if (e != nullptr && !e->isPayloadCompressed()) {
+        candidates.emplace_back(esn_t(head + i), e);
+      }
+    }
+  }
+
+  std::vector<std::shared_ptr<EpochRecordCacheEntry>> compressed(
+      candidates.size());
+  const EpochRecordCacheEntry::Disposer disposer(deps_);
+  for (size_t i = 0; i < candidates.size(); ++i) {
+    compressed[i] = candidates[i].second->compressed(disposer);
+    if (compressed[i] != nullptr) {
+      STAT_ADD(deps_->getStatsHolder(),
+               record_cache_bytes_cached_estimate,
+               compressed[i]->getBytesEstimate());
+    }
+  }
+
+  // Swap in the compressed entries that weren't evicted or replaced in the
+  // meantime. Entries that didn't make it in are disposed of outside the
+  // lock, along with the uncompressed entries.
+  size_t records_compressed = 0;
+  size_t bytes_saved = 0;
+  {
+    auto write_guard = lockForWrite();
+    if (!disabled_.load()) {
+      for (size_t i = 0; i < candidates.size(); ++i) {
+        const esn_t esn = candidates[i].first;
+        if (compressed[i] == nullptr || esn.val_ < head_.load() ||
+            esn > maxESNToAccept()) {
+          continue;
+        }
+        auto& slot = buffer_[getIndex(esn)];
+        if (slot != candidates[i].second) {
+          continue;
+        }
+        bytes_saved += slot->payload.size() - compressed[i]->payload.size();
+        ++records_compressed;
+        noteEntryRemoved(*slot);
+        noteEntryAdded(*compressed[i]);
+        slot.swap(compressed[i]);
+      }
+    }
+  }
+
+  STAT_ADD(deps_->getStatsHolder(),
+           record_cache_records_compressed,
+           records_compressed);
+  STAT_ADD(deps_->getStatsHolder(),
+           record_cache_bytes_saved_by_compression,
+           bytes_saved);
+  return bytes_saved;
+}
+
+bool EpochRecordCache::uncompressEntry(
+    std::shared_ptr<EpochRecordCacheEntry>& entry) const {
+  if (!entry->isPayloadCompressed()) {
+    return true;
+  }
+  auto uncompressed =
+      entry->uncompressed(EpochRecordCacheEntry::Disposer(deps_));
+  if (uncompressed == nullptr) {
+    STAT_INCR(deps_->getStatsHolder(), record_cache_decompression_failed);
+    return false;
+  }
+  STAT_ADD(deps_->getStatsHolder(),
+           record_cache_bytes_cached_estimate,
+           uncompressed->getBytesEstimate());
+  entry = std::move(uncompressed);
+  return true;
+}
+
 std::pair<bool, std::shared_ptr<EpochRecordCacheEntry>>
 EpochRecordCache::getEntry(esn_t esn) const {
   if (esn.val_ < head_.load()) {
     return std::make_pair(false, nullptr);
   }
 
-  FairRWLock::ReadHolder read_guard(rw_lock_);
+  auto read_guard = lockForRead();
   if (esn.val_ < head_.load() || esn > maxESNToAccept()) {
     return std::make_pair(false, nullptr);
   }
@@ -578,7 +753,7 @@ EpochRecordCache::createSnapshotImpl(Snapshot::SnapshotType type,
     // We may only be contenting with writers running on storage threads that
     // are doing mutation. This only happens when there is another EpochRecovery
     // with a higer seal epoch going on.
-    FairRWLock::ReadHolder read_guard(rw_lock_);
+    auto read_guard = lockForRead();
     if (type == Snapshot::SnapshotType::FULL) {
       OffsetMap offsets_within_epoch = getOffsetsWithinEpoch();
       // Initialize header fields
@@ -653,6 +828,48 @@ EpochRecordCache::createSnapshotImpl(Snapshot::SnapshotType type,
     }
   }
 
+  // Decompress payloads outside the lock. The header accounts for the
+  // payloads as they are in the snapshot.
+  size_t records_uncompressed = 0;
+  size_t records_decompressed = 0;
+  for (auto& kv : snapshot->entry_map_) {
+    if (!kv.second->isPayloadCompressed()) {
+      ++records_uncompressed;
+      continue;
+    }
+    const size_t compressed_size = kv.second->payload.size();
+    if (!uncompressEntry(kv.second)) {
+      // Make the snapshot look like that of a disabled cache, so that it
+      // gets treated as a miss.
+      snapshot->entry_map_.clear();
+      if (snapshot->header_ != nullptr) {
+        CacheHeader& header = *snapshot->header_;
+        header.disabled = true;
+        header.flags = 0;
+        header.stored = StoredBefore::MAYBE;
+        header.head = ESN_INVALID.val();
+        header.first_seen_lng = ESN_INVALID.val();
+        header.max_seen_esn = ESN_INVALID.val();
+        header.max_seen_timestamp = 0;
+        header.buffer_entries = 0;
+        header.buffer_payload_bytes = 0;
+        snapshot->tail_record_.reset();
+      }
+      return snapshot;
+    }
+    ++records_decompressed;
+    if (snapshot->header_ != nullptr) {
+      snapshot->header_->buffer_payload_bytes +=
+          kv.second->payload.size() - compressed_size;
+    }
+  }
+  STAT_ADD(deps_->getStatsHolder(),
+           record_cache_snapshot_records_uncompressed,
+           records_uncompressed);
+  STAT_ADD(deps_->getStatsHolder(),
+           record_cache_snapshot_records_decompressed,
+           records_decompressed);
+
   return snapshot;
 }
 
@@ -818,7 +1035,7 @@ EpochRecordCache::Snapshot::ConstIterator::getRecord() const {
 }
 
 void EpochRecordCache::getDebugInfo(InfoRecordCacheTable& table) const {
-  FairRWLock::ReadHolder read_guard(rw_lock_);
+  auto read_guard = lockForRead();
   table.next()
       .set<0>(log_id_)
       .set<1>(shard_)
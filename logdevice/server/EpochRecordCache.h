@@ -12,9 +12,12 @@
 #include <cstdint>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <utility>
 
 #include <folly/SharedMutex.h>
+#include <folly/concurrency/AtomicSharedPtr.h>
 
 #include "logdevice/common/AdminCommandTable-fwd.h"
 #include "logdevice/common/CircularBuffer.h"
@@ -35,6 +38,11 @@ namespace facebook { namespace logdevice {
  *       read rarely only during log recovery procedures. Currently it is
  *       implemented as a circular buffer protected by a write favorable
  *       high performance lock.
+ *
+ *       The accessors used on the read path don't take the lock: LNG and
+ *       emptiness are read from atomics (validated with a seqlock where more
+ *       than one is involved), and the tail record is published as an
+ *       immutable copy.
  */
 
 class EpochRecordCacheEntry;
@@ -164,7 +172,7 @@ class EpochRecordCache {
    * @return     tail record (i.e., last per-epoch released) record of the
    *             epoch. Invalid record if the cache never stored or never
    *             evicted a record on per-epoch release. The return value is
-   *             correct only if the cache is consistent.
+   *             correct only if the cache is consistent. Doesn't block.
    */
   TailRecord getTailRecord() const;
 
@@ -175,7 +183,7 @@ class EpochRecordCache {
    * Note only valid if the epoch cache is consistent
    */
   esn_t getAuthoritativeRangeBegin() const {
-    return getAuthoritativeRangeBegin(tail_record_);
+    return getAuthoritativeRangeBegin(getTailRecord());
   }
 
   static esn_t getAuthoritativeRangeBegin(const TailRecord& tail) {
@@ -221,6 +229,20 @@ class EpochRecordCache {
     }
   }
 
+  /**
+   * Replaces the payloads of cached records with their LZ4-compressed form,
+   * to keep the epoch cached in less memory. Used by RecordCacheMonitorThread
+   * on epochs that are unlikely to take more writes, see
+   * --record-cache-compress-cold-epochs.
+   *
+   * Compression happens without holding the lock, so writers are only
+   * blocked while the compressed entries are swapped in. Snapshots always
+   * expose decompressed payloads.
+   *
+   * @return  number of payload bytes saved
+   */
+  size_t compressPayloads();
+
   /**
    * Disable the cache by disallowing further read and writes.
    * All existing cache entries will be disposed of.
@@ -378,7 +400,8 @@ class EpochRecordCache {
   std::unique_ptr<Snapshot> createSnapshot(esn_t esn_start = ESN_INVALID,
                                            esn_t esn_end = ESN_MAX) const;
 
-  // get a copy of Entry for a given esn, currently used for testing only
+  // get a copy of Entry for a given esn, currently used for testing only.
+  // Its payload may be compressed.
   std::pair<bool, std::shared_ptr<EpochRecordCacheEntry>>
   getEntry(esn_t esn) const;
 
@@ -426,6 +449,15 @@ class EpochRecordCache {
     return shard_;
   }
 
+  /**
+   * @return  a number that changes whenever the content of the cache changes.
+   *          It is odd while a change is in progress. Two snapshots taken at
+   *          the same even version have the same content.
+   */
+  uint64_t getVersion() const {
+    return seq_.load();
+  }
+
   // destructor calls disableCache() and drains all entries
   ~EpochRecordCache();
 
@@ -465,6 +497,17 @@ class EpochRecordCache {
   // NOTE: access must be protected by rw_lock_
   TailRecord tail_record_;
 
+  // Immutable copy of tail_record_ for getTailRecord(), nullptr if it is
+  // invalid. Replaced by publishTailRecord() whenever tail_record_ changes.
+  folly::atomic_shared_ptr<TailRecord> published_tail_record_;
+
+  // Seqlock over head_, max_seen_esn_ and published_tail_record_: odd while
+  // a writer holding rw_lock_ may be changing them. Lets empty() and
+  // emptyWithoutTailPayload() read them consistently without the lock.
+  // Every writer that changes the content of the cache bumps it, which also
+  // makes it usable as a content version, see getVersion().
+  std::atomic<uint64_t> seq_{0};
+
   // actual buffer for storing (pointers to) cache entries
   CircularBuffer<std::shared_ptr<EpochRecordCacheEntry>> buffer_;
 
@@ -483,6 +526,18 @@ class EpochRecordCache {
   std::atomic<bool> disabled_{false};
 
   /// helper functions
+  // Acquire rw_lock_, bumping a stat if another thread held it.
+  std::shared_lock<FairRWLock> lockForRead() const;
+  std::unique_lock<FairRWLock> lockForWrite();
+
+  // Calls `func` with a consistent view of the fields covered by seq_,
+  // without taking rw_lock_ unless writers keep changing them.
+  template <typename Func>
+  bool readConsistent(const Func& func) const;
+
+  // must be called with write lock of rw_lock_ held
+  void publishTailRecord();
+
   // @return   right end of the buffer
   esn_t maxESNToAccept() const {
     const esn_t::raw_type head = head_.load();
@@ -526,6 +581,11 @@ class EpochRecordCache {
   void noteEntryAdded(const EpochRecordCacheEntry& entry);
   void noteEntryRemoved(const EpochRecordCacheEntry& entry);
 
+  // @return  false if entry->isPayloadCompressed() and it couldn't be
+  //          decompressed. Otherwise replaces entry with its uncompressed
+  //          copy if needed and returns true.
+  bool uncompressEntry(std::shared_ptr<EpochRecordCacheEntry>& entry) const;
+
   /**
    * create a snapshot of the cache for reading, complexity is
    * O(N) where N is the number of entries in the cache to be included in
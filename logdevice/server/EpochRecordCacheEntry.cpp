@@ -10,6 +10,8 @@
 #include <algorithm>
 #include <cstring>
 
+#include <folly/compression/Compression.h>
+
 #include "logdevice/common/PayloadHolder.h"
 #include "logdevice/common/Worker.h"
 #include "logdevice/common/debug.h"
@@ -124,6 +126,7 @@ size_t EpochRecordCacheEntry::sizeInLinearBuffer() const {
 }
 
 ssize_t EpochRecordCacheEntry::toLinearBuffer(char* buffer, size_t size) const {
+  ld_check(!isPayloadCompressed());
   if (sizeInLinearBuffer() > size) {
     err = E::NOBUFS;
     return -1;
@@ -196,6 +199,80 @@ EpochRecordCacheEntry::createFromLinearBuffer(lsn_t lsn,
   return result;
 }
 
+// Payloads smaller than that are left uncompressed, LZ4 gains little on them.
+static constexpr size_t MIN_COMPRESSIBLE_PAYLOAD_SIZE = 128;
+
+std::shared_ptr<EpochRecordCacheEntry>
+EpochRecordCacheEntry::compressed(Disposer disposer) const {
+  ld_check(!isPayloadCompressed());
+  const size_t size = payload.size();
+  if (size < MIN_COMPRESSIBLE_PAYLOAD_SIZE) {
+    return nullptr;
+  }
+  auto codec = folly::io::getCodec(folly::io::CodecType::LZ4);
+  std::unique_ptr<folly::IOBuf> output;
+  try {
+    output = codec->compress(&payload.iobuf());
+  } catch (const std::exception& e) {
+    RATELIMIT_ERROR(std::chrono::seconds(10),
+                    1,
+                    "Failed to compress payload of record %s: %s",
+                    lsn_to_string(lsn).c_str(),
+                    e.what());
+    return nullptr;
+  }
+  if (output->computeChainDataLength() >= size) {
+    return nullptr;
+  }
+  output->coalesce();
+  return copyWithPayload(
+      PayloadHolder(std::move(*output), /* ignore_size_limit */ true),
+      size,
+      disposer);
+}
+
+std::shared_ptr<EpochRecordCacheEntry>
+EpochRecordCacheEntry::uncompressed(Disposer disposer) const {
+  ld_check(isPayloadCompressed());
+  auto codec = folly::io::getCodec(folly::io::CodecType::LZ4);
+  std::unique_ptr<folly::IOBuf> output;
+  try {
+    output = codec->uncompress(&payload.iobuf(), uncompressed_payload_size_);
+  } catch (const std::exception& e) {
+    RATELIMIT_ERROR(std::chrono::seconds(10),
+                    1,
+                    "Failed to decompress payload of record %s: %s",
+                    lsn_to_string(lsn).c_str(),
+                    e.what());
+    return nullptr;
+  }
+  output->coalesce();
+  return copyWithPayload(
+      PayloadHolder(std::move(*output), /* ignore_size_limit */ true),
+      0,
+      disposer);
+}
+
+std::shared_ptr<EpochRecordCacheEntry>
+EpochRecordCacheEntry::copyWithPayload(PayloadHolder payload_copy,
+                                       size_t uncompressed_payload_size,
+                                       Disposer disposer) const {
+  auto keys_copy = keys;
+  auto result = std::shared_ptr<EpochRecordCacheEntry>(
+      new EpochRecordCacheEntry(lsn,
+                                flags,
+                                timestamp,
+                                last_known_good,
+                                wave_or_recovery_epoch,
+                                copyset,
+                                offsets_within_epoch,
+                                std::move(keys_copy),
+                                payload_copy),
+      disposer);
+  result->uncompressed_payload_size_ = uncompressed_payload_size;
+  return result;
+}
+
 void EpochRecordCacheEntry::Disposer::operator()(EpochRecordCacheEntry* e) {
   std::unique_ptr<EpochRecordCacheEntry> entry_ptr(e);
   deps_->disposeOfCacheEntry(std::move(entry_ptr));
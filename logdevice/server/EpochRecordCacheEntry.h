@@ -57,9 +57,31 @@ class EpochRecordCacheEntry : public ZeroCopiedRecord {
   /**
    * Write a serialized representation of this cache to the given buffer.
    * Returns the resulting size, or -1 if the buffer size was too small.
+   * The payload must not be compressed.
    */
   ssize_t toLinearBuffer(char* buffer, size_t size) const;
 
+  /**
+   * @return  a copy of this entry with its payload compressed with LZ4, or
+   *          nullptr if the payload is too small to bother or doesn't get
+   *          smaller. The payload must not already be compressed.
+   */
+  std::shared_ptr<EpochRecordCacheEntry> compressed(Disposer disposer) const;
+
+  /**
+   * @return  a copy of this entry with its payload decompressed, or nullptr
+   *          if decompression failed. The payload must be compressed.
+   */
+  std::shared_ptr<EpochRecordCacheEntry> uncompressed(Disposer disposer) const;
+
+  /**
+   * @return  true if `payload` holds the LZ4-compressed payload of the record,
+   *          see EpochRecordCache::compressPayloads().
+   */
+  bool isPayloadCompressed() const {
+    return uncompressed_payload_size_ > 0;
+  }
+
   EpochRecordCacheEntry();
 
   EpochRecordCacheEntry(lsn_t lsn,
@@ -75,6 +97,14 @@ class EpochRecordCacheEntry : public ZeroCopiedRecord {
  private:
   int fromLinearBuffer(lsn_t lsn, const char* buffer, size_t size);
 
+  std::shared_ptr<EpochRecordCacheEntry>
+  copyWithPayload(PayloadHolder payload_copy,
+                  size_t uncompressed_payload_size,
+                  Disposer disposer) const;
+
+  // Size of the record's payload if `payload` is compressed, 0 otherwise.
+  size_t uncompressed_payload_size_{0};
+
   friend class ZeroCopiedRecord;
   friend class EpochRecordCacheSerializer::EpochRecordCacheCompare;
 };
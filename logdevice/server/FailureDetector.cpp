@@ -553,6 +553,23 @@ void FailureDetector::gossip() {
     }
   }
 
+  // Most messages may be delta messages, with full entries only for nodes
+  // that changed in the last `full_sync_frequency` rounds. Heartbeat counters
+  // change all the time, so they are sent for all nodes, in compact form.
+  ++gossip_round_;
+  const uint64_t full_sync_frequency = settings_->gossip_full_sync_frequency;
+  bool full_sync = full_sync_frequency <= 1 ||
+      rounds_since_full_sync_ + 1 >= full_sync_frequency ||
+      flags & GOSSIP_Message::HAS_IN_MEM_VERSIONS ||
+      flags & GOSSIP_Message::HAS_DURABLE_SNAPSHOT_VERSIONS;
+  if (!full_sync) {
+    folly::Optional<uint16_t> proto = getPeerProtocol(dest);
+    full_sync = !proto.hasValue() ||
+        *proto < Compatibility::ProtocolVersion::GOSSIP_DELTA_SUPPORT;
+  }
+  rounds_since_full_sync_ = full_sync ? 0 : rounds_since_full_sync_ + 1;
+  GOSSIP_Message::heartbeat_list_t heartbeat_list;
+
   for (auto serv_it = serv_disc->begin(); serv_it != serv_disc->end();
        ++serv_it) {
     if (nodes_.find(serv_it->first) == nodes_.end()) {
@@ -574,7 +591,26 @@ void FailureDetector::gossip() {
     gnode.failover_ = fdnode.failover_;
     gnode.is_node_starting_ = fdnode.is_node_starting_;
     gnode.node_status_ = fdnode.status_;
-    gossip_node_list.push_back(gnode);
+
+    const GOSSIP_Node& last = fdnode.last_gossiped_;
+    if (last.gossip_ts_ != gnode.gossip_ts_ ||
+        last.failover_ != gnode.failover_ ||
+        last.is_node_starting_ != gnode.is_node_starting_ ||
+        last.node_status_ != gnode.node_status_) {
+      fdnode.changed_at_round_ = gossip_round_;
+    }
+    fdnode.last_gossiped_ = gnode;
+
+    // Our own entry is always full, the receiver takes our status from it.
+    if (full_sync || serv_it->first == this_node.index() ||
+        gossip_round_ - fdnode.changed_at_round_ < full_sync_frequency) {
+      gossip_node_list.push_back(gnode);
+    } else {
+      heartbeat_list.push_back(
+          GOSSIP_Heartbeat{serv_it->first,
+                           gnode.gossip_,
+                           static_cast<uint32_t>(gnode.gossip_ts_.count())});
+    }
 
     if (flags & GOSSIP_Message::HAS_IN_MEM_VERSIONS ||
         flags & GOSSIP_Message::HAS_DURABLE_SNAPSHOT_VERSIONS) {
@@ -619,20 +655,24 @@ void FailureDetector::gossip() {
   skip_sending_versions_ = (skip_sending_versions_ + 1) %
       (settings_->gossip_include_rsm_versions_frequency);
 
+  if (!full_sync) {
+    STAT_INCR(getStats(), gossips_sent_delta);
+  }
+
   // bump the message sequence number
   ++current_msg_id_;
-  int rv = sendGossipMessage(
-      dest,
-      std::make_unique<GOSSIP_Message>(this_node,
-                                       std::move(gossip_node_list),
-                                       instance_id_,
-                                       getCurrentTimeInMillis(),
-                                       std::move(boycotts),
-                                       std::move(boycott_durations),
-                                       flags,
-                                       current_msg_id_,
-                                       registered_rsms_,
-                                       std::move(versions_list)));
+  auto msg = std::make_unique<GOSSIP_Message>(this_node,
+                                              std::move(gossip_node_list),
+                                              instance_id_,
+                                              getCurrentTimeInMillis(),
+                                              std::move(boycotts),
+                                              std::move(boycott_durations),
+                                              flags,
+                                              current_msg_id_,
+                                              registered_rsms_,
+                                              std::move(versions_list));
+  msg->heartbeat_list_ = std::move(heartbeat_list);
+  int rv = sendGossipMessage(dest, std::move(msg));
 
   if (rv != 0) {
     RATELIMIT_DEBUG(std::chrono::seconds(1),
@@ -898,6 +938,19 @@ void FailureDetector::onGossipReceived(const GOSSIP_Message& msg) {
     }
   }
 
+  // Heartbeats of a delta message. Only applied if we know the same instance
+  // of the node as the sender; otherwise we'll learn about it from a full
+  // entry.
+  for (const auto& hb : msg.heartbeat_list_) {
+    auto it = nodes_.find(hb.node_id_);
+    if (hb.node_id_ == this_index || it == nodes_.end() ||
+        static_cast<uint32_t>(it->second.gossip_ts_.count()) !=
+            hb.instance_tag_) {
+      continue;
+    }
+    it->second.gossip_ = std::min(it->second.gossip_, hb.gossip_);
+  }
+
   getBoycottTracker().updateReportedBoycotts(msg.boycott_list_);
   getBoycottTracker().updateReportedBoycottDurations(
       msg.boycott_durations_list_, std::chrono::system_clock::now());
@@ -1484,6 +1537,11 @@ void FailureDetector::broadcastBringupUpdate(
   }
 }
 
+folly::Optional<uint16_t> FailureDetector::getPeerProtocol(NodeID node) const {
+  return Worker::onThisThread()->sender().getSocketProtocolVersion(
+      node.index());
+}
+
 int FailureDetector::sendGossipMessage(NodeID node,
                                        std::unique_ptr<GOSSIP_Message> gossip) {
   ld_spew("Sending Gossip message to %s", node.toString().c_str());
@@ -336,6 +336,12 @@ class FailureDetector {
     // indicated by a setting GOSSIP_Message::LONG_TIME_SINCE_LAST_GOSSIP flag.
     bool stalled_gossip_processor_{false};
 
+    // For delta gossip messages: this node's entry as of the last gossip
+    // round, and the round in which anything other than the heartbeat
+    // counter last changed.
+    GOSSIP_Node last_gossiped_{};
+    uint64_t changed_at_round_{0};
+
     Node()
         : state_(NodeState::DEAD),
           blacklisted_(false),
@@ -426,6 +432,11 @@ class FailureDetector {
   // the tick counters in Node::gossip_ were last updated
   SteadyTimestamp last_gossip_tick_time_{SteadyTimestamp::min()};
 
+  // Number of times gossip() built a message, and how many of them since the
+  // last full one. See GossipSettings::gossip_full_sync_frequency.
+  uint64_t gossip_round_{0};
+  uint64_t rounds_since_full_sync_{0};
+
   // save pointer to the timer so we can explicitly trigger it to force retries
   ExponentialBackoffTimerNode* gossip_timer_node_{nullptr};
 
@@ -608,6 +619,8 @@ class FailureDetector {
 
   virtual ClusterState* getClusterState() const;
   virtual int sendGossipMessage(NodeID, std::unique_ptr<GOSSIP_Message>);
+  // Protocol of the connection to the node, folly::none if not known.
+  virtual folly::Optional<uint16_t> getPeerProtocol(NodeID) const;
 
   // checks whether gossip sender is aware of HM. If not, node status updates
   // from this sender should not be propagated.
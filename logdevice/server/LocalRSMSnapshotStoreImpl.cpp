@@ -77,7 +77,7 @@ void ReadRsmSnapshotStorageTask::onDone() {
           lsn_to_string(min_ver_).c_str(),
           metadata_out_.toString().c_str());
   cb_(status_,
-      status_ == E::OK ? metadata_out_.snapshot_blob_ : "",
+      status_ == E::OK ? std::move(metadata_out_.snapshot_blob_) : "",
       RSMSnapshotStore::SnapshotAttributes(
           metadata_out_.version_, metadata_out_.update_time_));
 }
@@ -91,10 +91,20 @@ void ReadRsmSnapshotStorageTask::onDropped() {
 }
 
 void LocalRSMSnapshotStoreImpl::getVersion(snapshot_ver_cb_t cb) {
+  if (last_known_version_ != LSN_INVALID) {
+    // Snapshots of this key are only written through this object, so the
+    // version we last read or wrote is still current.
+    cb(E::OK, last_known_version_);
+    return;
+  }
+
   auto cb_read_storage_task =
       [this, cb](Status st,
                  std::string /* unused */,
                  RSMSnapshotStore::SnapshotAttributes snapshot_attrs) {
+        if (st == E::OK) {
+          last_known_version_ = snapshot_attrs.base_version;
+        }
         cb(st, snapshot_attrs.base_version);
       };
   auto task = std::make_unique<ReadRsmSnapshotStorageTask>(
@@ -222,6 +232,9 @@ void LocalRSMSnapshotStoreImpl::getSnapshot(lsn_t min_ver, snapshot_cb_t cb) {
       [this, min_ver](Status st,
                       std::string snapshot_blob_out,
                       RSMSnapshotStore::SnapshotAttributes snapshot_attrs) {
+        if (st == E::OK) {
+          last_known_version_ = snapshot_attrs.base_version;
+        }
         read_cb_(st, std::move(snapshot_blob_out), snapshot_attrs);
         read_in_flight_ = false;
       };
@@ -254,6 +267,9 @@ void LocalRSMSnapshotStoreImpl::writeSnapshot(lsn_t snapshot_ver,
   write_in_flight_ = true;
   write_cb_ = std::move(cb);
   auto cb_write_storage_task = [this](Status st, lsn_t snapshot_ver_out) {
+    if (st == E::OK) {
+      last_known_version_ = snapshot_ver_out;
+    }
     write_cb_(st, snapshot_ver_out);
     write_in_flight_ = false;
   };
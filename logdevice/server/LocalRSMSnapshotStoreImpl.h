@@ -110,6 +110,10 @@ class LocalRSMSnapshotStoreImpl : public RSMSnapshotStore {
 
  private:
   shard_index_t shard_id_{-1};
+  // Version of the snapshot this store last read or wrote, LSN_INVALID if
+  // none yet. Lets getVersion() avoid reading the whole snapshot from the
+  // local log store just to find out its version.
+  lsn_t last_known_version_{LSN_INVALID};
   snapshot_cb_t read_cb_;
   completion_cb_t write_cb_;
   bool read_in_flight_{false};
@@ -17,6 +17,22 @@
 
 namespace facebook { namespace logdevice {
 
+static void bump_record_sent_stats(const RECORD_Message& msg) {
+  WORKER_TRAFFIC_CLASS_STAT_INCR(msg.tc_, record_messages_sent);
+  WORKER_TRAFFIC_CLASS_STAT_ADD(
+      msg.tc_, record_payload_bytes, msg.payload_.size());
+  WORKER_LOG_STAT_ADD(
+      msg.header_.log_id, record_payload_bytes, msg.payload_.size());
+  WORKER_LOG_STAT_INCR(msg.header_.log_id, records_sent);
+  // Bump the per-log-group stats
+  if (msg.log_group_path_) {
+    LOG_GROUP_TIME_SERIES_ADD(Worker::stats(),
+                              record_bytes,
+                              *msg.log_group_path_,
+                              msg.payload_.size());
+  }
+}
+
 void RECORD_onSent(const RECORD_Message& msg,
                    Status st,
                    const Address& to,
@@ -31,12 +47,7 @@ void RECORD_onSent(const RECORD_Message& msg,
   }
 
   ServerWorker* w = ServerWorker::onThisThread();
-  WORKER_TRAFFIC_CLASS_STAT_INCR(msg.tc_, record_messages_sent);
-  WORKER_TRAFFIC_CLASS_STAT_ADD(
-      msg.tc_, record_payload_bytes, msg.payload_.size());
-  WORKER_LOG_STAT_ADD(
-      msg.header_.log_id, record_payload_bytes, msg.payload_.size());
-  WORKER_LOG_STAT_INCR(msg.header_.log_id, records_sent);
+  bump_record_sent_stats(msg);
 
   if (msg.source_ == RECORD_Message::Source::CACHED_DIGEST) {
     // TODO 10173692: handle E::NOBUFS w/ traffic shaping
@@ -47,13 +58,28 @@ void RECORD_onSent(const RECORD_Message& msg,
   } else {
     w->serverReadStreams().onRecordSent(to.id_.client_, msg, enqueue_time);
   }
-  // Bump the per-log-group stats
-  if (msg.log_group_path_) {
-    LOG_GROUP_TIME_SERIES_ADD(Worker::stats(),
-                              record_bytes,
-                              *msg.log_group_path_,
-                              msg.payload_.size());
+}
+
+void RECORDS_BATCH_onSent(const RECORDS_BATCH_Message& msg,
+                          Status st,
+                          const Address& to,
+                          const SteadyTimestamp enqueue_time) {
+  if (st != E::OK) {
+    // See RECORD_onSent().
+    ld_debug("RECORDS_BATCH message to %s failed to send: %s",
+             Sender::describeConnection(to).c_str(),
+             error_description(st));
+    return;
+  }
+
+  WORKER_STAT_INCR(records_batch_messages_sent);
+  WORKER_STAT_ADD(records_batch_records_sent, msg.records_.size());
+  for (const auto& record : msg.records_) {
+    bump_record_sent_stats(*record);
   }
+  // Batches are only made by CatchupOneStream, never from cached digests.
+  ServerWorker::onThisThread()->serverReadStreams().onRecordsBatchSent(
+      to.id_.client_, msg, enqueue_time);
 }
 
 }} // namespace facebook::logdevice
@@ -8,6 +8,7 @@
 #pragma once
 
 #include "logdevice/common/protocol/Message.h"
+#include "logdevice/common/protocol/RECORDS_BATCH_Message.h"
 #include "logdevice/common/protocol/RECORD_Message.h"
 
 namespace facebook { namespace logdevice {
@@ -15,4 +16,8 @@ void RECORD_onSent(const RECORD_Message& msg,
                    Status st,
                    const Address& to,
                    const SteadyTimestamp enqueue_time);
+void RECORDS_BATCH_onSent(const RECORDS_BATCH_Message& msg,
+                          Status st,
+                          const Address& to,
+                          const SteadyTimestamp enqueue_time);
 }} // namespace facebook::logdevice
@@ -211,6 +211,7 @@ int RecordCache::putRecord(RecordID rid,
 
 std::pair<RecordCache::Result, std::shared_ptr<EpochRecordCache>>
 RecordCache::getEpochRecordCache(epoch_t epoch) const {
+  lookups_.fetch_add(1, std::memory_order_relaxed);
   std::shared_ptr<EpochRecordCache> epoch_cache = epoch_caches_.get(epoch.val_);
 
   if (epoch_cache != nullptr) {
@@ -430,6 +431,17 @@ void RecordCache::evictResetAllEpochs() {
   });
 }
 
+size_t RecordCache::compressColdEpochs() {
+  const epoch_t::raw_type next_epoch = next_epoch_to_cache_.load();
+  size_t bytes_saved = 0;
+  accessAllEpochCaches([&](EpochRecordCache& epoch_cache) {
+    if (epoch_cache.getEpoch().val_ + 1 < next_epoch) {
+      bytes_saved += epoch_cache.compressPayloads();
+    }
+  });
+  return bytes_saved;
+}
+
 size_t RecordCache::getPayloadSizeEstimate() const {
   size_t total_size = 0;
   accessAllEpochCaches([&](const EpochRecordCache& epoch_cache) {
@@ -438,6 +450,13 @@ size_t RecordCache::getPayloadSizeEstimate() const {
   return total_size;
 }
 
+void RecordCache::decayLookupCount() {
+  uint32_t lookups = lookups_.load(std::memory_order_relaxed);
+  while (!lookups_.compare_exchange_weak(
+      lookups, lookups / 2, std::memory_order_relaxed)) {
+  }
+}
+
 void RecordCache::getDebugInfo(InfoRecordCacheTable& table) const {
   accessAllEpochCaches([&table](const EpochRecordCache& epoch_cache) {
     epoch_cache.getDebugInfo(table);
@@ -174,12 +174,36 @@ class RecordCache {
    */
   void evictResetAllEpochs();
 
+  /**
+   * Compresses the payloads of records cached for all epochs but the latest
+   * one, see EpochRecordCache::compressPayloads(). Readers of older epochs
+   * are mostly log recovery, which can afford decompressing them.
+   *
+   * @return  number of payload bytes saved
+   */
+  size_t compressColdEpochs();
+
   /**
    * @return   the size estimate of the all record payloads currently stored
    *           in the record cache
    */
   size_t getPayloadSizeEstimate() const;
 
+  /**
+   * @return   number of calls to getEpochRecordCache() since the count was
+   *           last decayed, used by RecordCacheMonitorThread to evict the
+   *           logs in least demand first
+   */
+  uint32_t getLookupCount() const {
+    return lookups_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * Halves the lookup count so that it reflects recent demand rather than
+   * the whole lifetime of the cache.
+   */
+  void decayLookupCount();
+
   /**
    * Shutdown the cache, clearing all entries in all epochs. Caller should
    * ensure that cache is not used after shutdown() is called.
@@ -266,6 +290,9 @@ class RecordCache {
   // indicate the record cache is shutdown and shouldn't take new writes
   std::atomic<bool> shutdown_{false};
 
+  // see getLookupCount()
+  mutable std::atomic<uint32_t> lookups_{0};
+
   // actual implementation for evictResetEpoch(), must be called under
   // mutex_
   void evictResetEpochImpl(epoch_t epoch);
@@ -7,6 +7,7 @@
  */
 #include "logdevice/server/RecordCacheMonitorThread.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <functional>
 #include <queue>
@@ -45,6 +46,23 @@ void RecordCacheMonitorThread::threadMain() {
 
   while (!shutdown_.signaled()) {
     auto result = recordCacheNeedsEviction();
+    if (result.first &&
+        processor_->settings()->record_cache_compress_cold_epochs) {
+      const size_t bytes_saved = compressCaches();
+      if (bytes_saved > 0) {
+        RATELIMIT_INFO(std::chrono::seconds(10),
+                       1,
+                       "Saved %lu bytes by compressing older epochs in the "
+                       "record cache, %lu bytes needed to be freed.",
+                       bytes_saved,
+                       result.second);
+      }
+      if (bytes_saved >= result.second) {
+        result.first = false;
+      } else {
+        result.second -= bytes_saved;
+      }
+    }
     if (result.first) {
       RATELIMIT_INFO(
           std::chrono::seconds(10),
@@ -116,6 +134,7 @@ struct LogEntry {
   logid_t log_id;
   shard_index_t shard;
   size_t cache_size;
+  uint32_t lookups;
 
   bool operator>(const LogEntry& rhs) const {
     return cache_size > rhs.cache_size;
@@ -124,8 +143,26 @@ struct LogEntry {
 
 } // namespace
 
+size_t RecordCacheMonitorThread::compressCaches() {
+  size_t bytes_saved = 0;
+  processor_->getLogStorageStateMap().forEachLog(
+      [&bytes_saved](logid_t /*logid*/, const LogStorageState& state) {
+        if (state.record_cache_ != nullptr) {
+          bytes_saved += state.record_cache_->compressColdEpochs();
+        }
+        return 0;
+      });
+  return bytes_saved;
+}
+
 void RecordCacheMonitorThread::evictCaches(size_t target_bytes) {
   ld_check(target_bytes > 0);
+  if (processor_->settings()->record_cache_eviction_policy ==
+      Settings::RecordCacheEvictionPolicy::FREQUENCY) {
+    evictLeastLookedUpCaches(target_bytes);
+    return;
+  }
+
   using MinQueue = std::
       priority_queue<LogEntry, std::vector<LogEntry>, std::greater<LogEntry>>;
 
@@ -143,7 +180,7 @@ void RecordCacheMonitorThread::evictCaches(size_t target_bytes) {
       return 0;
     }
 
-    min_queue.push(LogEntry{logid, state.getShardIdx(), log_size});
+    min_queue.push(LogEntry{logid, state.getShardIdx(), log_size, 0});
     bytes_in_queue += log_size;
 
     // pop the queue until 1) it is empty or
@@ -188,6 +225,9 @@ void RecordCacheMonitorThread::evictCaches(size_t target_bytes) {
   STAT_ADD(processor_->stats_,
            record_cache_bytes_evicted_by_monitor,
            bytes_in_queue);
+  STAT_ADD(processor_->stats_,
+           record_cache_logs_evicted_by_size,
+           num_logs_evicted);
 
   RATELIMIT_INFO(
       std::chrono::seconds(10),
@@ -199,4 +239,75 @@ void RecordCacheMonitorThread::evictCaches(size_t target_bytes) {
       target_bytes);
 }
 
+void RecordCacheMonitorThread::evictLeastLookedUpCaches(size_t target_bytes) {
+  ld_check(target_bytes > 0);
+  auto& log_map = processor_->getLogStorageStateMap();
+
+  std::vector<LogEntry> entries;
+  log_map.forEachLog([&entries](logid_t logid, const LogStorageState& state) {
+    if (state.record_cache_ == nullptr) {
+      return 0;
+    }
+    const size_t log_size = state.record_cache_->getPayloadSizeEstimate();
+    if (log_size > 0) {
+      entries.push_back(LogEntry{logid,
+                                 state.getShardIdx(),
+                                 log_size,
+                                 state.record_cache_->getLookupCount()});
+    }
+    state.record_cache_->decayLookupCount();
+    return 0;
+  });
+
+  // Least looked up logs first, and the largest of them first so that as few
+  // logs as possible are evicted.
+  std::sort(entries.begin(),
+            entries.end(),
+            [](const LogEntry& lhs, const LogEntry& rhs) {
+              if (lhs.lookups != rhs.lookups) {
+                return lhs.lookups < rhs.lookups;
+              }
+              return lhs.cache_size > rhs.cache_size;
+            });
+
+  size_t bytes_evicted = 0;
+  size_t num_logs_evicted = 0;
+  for (const LogEntry& e : entries) {
+    if (bytes_evicted >= target_bytes) {
+      break;
+    }
+    auto& record_cache_ptr = log_map.get(e.log_id, e.shard).record_cache_;
+    // RecordCache pointer shouldn't get destroyed before this thread exists
+    ld_check(record_cache_ptr != nullptr);
+    record_cache_ptr->evictResetAllEpochs();
+    bytes_evicted += e.cache_size;
+    ++num_logs_evicted;
+  }
+
+  if (num_logs_evicted == 0) {
+    RATELIMIT_INFO(std::chrono::seconds(10),
+                   1,
+                   "Can't find a log to evict, nothing to do.");
+    return;
+  }
+
+  STAT_INCR(processor_->stats_, record_cache_eviction_performed_by_monitor);
+  STAT_ADD(processor_->stats_,
+           record_cache_bytes_evicted_by_monitor,
+           bytes_evicted);
+  STAT_ADD(processor_->stats_,
+           record_cache_logs_evicted_by_frequency,
+           num_logs_evicted);
+
+  RATELIMIT_INFO(
+      std::chrono::seconds(10),
+      1,
+      "Evicted %lu least looked up logs from the record cache out of %lu, "
+      "estimate actual total bytes evicted: %lu, bytes evicted target: %lu",
+      num_logs_evicted,
+      entries.size(),
+      bytes_evicted,
+      target_bytes);
+}
+
 }} // namespace facebook::logdevice
@@ -27,6 +27,12 @@ class ServerProcessor;
  *         epochs currently cached. This could help to leave more logs in the
  *         cache, achieving better availability in terms of logs and less seeks
  *         durng epoch recovery.
+ *
+ *         With --record-cache-eviction-policy=frequency, logs whose caches
+ *         were looked up the least are evicted first instead, largest first
+ *         among logs with as many lookups. Lookup counts are halved after
+ *         each eviction, in the spirit of TinyLFU's aging, so that logs that
+ *         stopped being read eventually become candidates.
  */
 
 class RecordCacheMonitorThread {
@@ -57,6 +63,15 @@ class RecordCacheMonitorThread {
 
   // Perform eviction for all logs, attempting to evict @param target_bytes
   void evictCaches(size_t target_bytes);
+
+  // Like evictCaches() but evicts the logs with the fewest lookups first,
+  // see RecordCache::getLookupCount(). Then decays the lookup counts of all
+  // logs.
+  void evictLeastLookedUpCaches(size_t target_bytes);
+
+  // Compress older epochs of all logs, see RecordCache::compressColdEpochs().
+  // @return  number of bytes saved
+  size_t compressCaches();
 };
 
 }} // namespace facebook::logdevice
@@ -16,6 +16,18 @@
 namespace facebook { namespace logdevice {
 
 Request::Execution ReleaseRequest::execute() {
+  if (!force_) {
+    LogStorageState& log_state =
+        ServerWorker::onThisThread()->processor_->getLogStorageStateMap().get(
+            rid_.logid, shard_);
+    // Clear the flag before reading the last released LSN so that a release
+    // racing with us either is seen here or posts a new request.
+    log_state.clearReleasePending(target_);
+    const lsn_t last_released = log_state.getLastReleasedLSN().value();
+    if (last_released > rid_.lsn()) {
+      rid_ = RecordID(last_released, rid_.logid);
+    }
+  }
   ld_spew("ReleaseRequest(%s) running on worker %s for shard %u",
           rid_.toString().c_str(),
           Worker::onThisThread()->getName().c_str(),
@@ -11,6 +11,7 @@
 #include "logdevice/common/Request.h"
 #include "logdevice/common/RequestType.h"
 #include "logdevice/common/debug.h"
+#include "logdevice/common/stats/Stats.h"
 #include "logdevice/common/types_internal.h"
 #include "logdevice/server/ServerProcessor.h"
 #include "logdevice/server/read_path/LogStorageStateMap.h"
@@ -26,6 +27,12 @@ enum class ReleaseType : uint8_t;
  *
  * The worker receiving this request reads the new record from the local log
  * store and sends it to clients reading from the log.
+ *
+ * At most one non-forced ReleaseRequest per log is queued on a worker at any
+ * time (see LogStorageState::markReleasePending()). Releases arriving while
+ * it is queued only advance the last released LSN, which the request reads
+ * when it runs, so a log released at a high rate doesn't flood the workers'
+ * request queues.
  */
 
 class ReleaseRequest : public Request {
@@ -78,9 +85,20 @@ class ReleaseRequest : public Request {
             return;
           }
 
+          LogStorageState& log_state =
+              processor->getLogStorageStateMap().get(rid.logid, shard);
+          if (!force && !log_state.markReleasePending(idx)) {
+            // The queued request will deliver this release too.
+            STAT_INCR(processor->stats_, release_requests_coalesced);
+            return;
+          }
+
           std::unique_ptr<Request> req =
               std::make_unique<ReleaseRequest>(idx, rid, shard, force);
           if (processor->postRequest(req) != 0) {
+            if (!force) {
+              log_state.clearReleasePending(idx);
+            }
             RATELIMIT_ERROR(std::chrono::seconds(10),
                             5,
                             "Could not propagate RELEASE %s to worker #%d.  "
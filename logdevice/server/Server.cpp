@@ -57,6 +57,7 @@
 #include "logdevice/server/ServerProcessor.h"
 #include "logdevice/server/UnreleasedRecordDetector.h"
 #include "logdevice/server/epoch_store/FileEpochStore.h"
+#include "logdevice/server/epoch_store/RocksDBEpochStore.h"
 #include "logdevice/server/epoch_store/ZookeeperEpochStore.h"
 #include "logdevice/server/fatalsignal.h"
 #include "logdevice/server/locallogstore/ClusterMarkerChecker.h"
@@ -705,6 +706,18 @@ bool Server::initListeners() {
         conn_budget_backlog_,
         server_settings_->enable_dscp_reflection);
 
+    // Same as connection_listener_ but on a unix domain socket, for
+    // co-located clients.
+    local_connection_listener_ = initListener<ConnectionListener>(
+        -1,
+        server_settings_->local_data_unix_socket,
+        false,
+        folly::getKeepAliveToken(connection_listener_loop_->getEventBase()),
+        conn_shared_state,
+        ConnectionKind::DATA,
+        conn_budget_backlog_,
+        server_settings_->enable_dscp_reflection);
+
     auto nodes_configuration = updateable_config_->getNodesConfiguration();
     ld_check(nodes_configuration);
     NodeID node_id = params_->getMyNodeID().value();
@@ -1101,7 +1114,10 @@ bool Server::initLogStorageStateMap() {
   for (shard_index_t shard = 0; shard < nshards; ++shard) {
     futures.push_back(std::async(
         std::launch::async,
-        [shard, &make_traverser, &sharded_store = sharded_store_]() {
+        [shard,
+         &make_traverser,
+         &sharded_store = sharded_store_,
+         &lsmap = log_storage_state_map_]() {
           ThreadID::set(ThreadID::UTILITY,
                         folly::sformat("ld:populateLogState{}", shard));
           auto store = sharded_store->getByIndex(shard);
@@ -1128,6 +1144,16 @@ bool Server::initLogStorageStateMap() {
                         ->last_released_lsn_,
                     LogStorageState::LastReleasedSource::LOCAL_LOG_STORE);
               });
+          auto make_seal_traverser = [&](LogStorageState::SealType type) {
+            return make_traverser(
+                shard,
+                [type](LogStorageState* log_state,
+                       std::unique_ptr<LogMetadata> meta) {
+                  log_state->updateSeal(
+                      dynamic_cast<SealMetadata*>(meta.get())->seal_, type);
+                });
+          };
+          std::vector<logid_t> logs;
           int rv = store->traverseLogsMetadata(
               LogMetadataType::TRIM_POINT, trim_point_traverser);
           if (rv != 0) {
@@ -1152,8 +1178,54 @@ bool Server::initLogStorageStateMap() {
             ld_error("Failed to populate Last Released LSN from shard %d: %s",
                      shard,
                      error_name(err));
+            goto out;
+          }
+
+          rv = store->traverseLogsMetadata(
+              LogMetadataType::SEAL,
+              make_seal_traverser(LogStorageState::SealType::NORMAL));
+          if (rv != 0) {
+            ld_error("Failed to populate Seals from shard %d: %s",
+                     shard,
+                     error_name(err));
+            goto out;
+          }
+
+          rv = store->traverseLogsMetadata(
+              LogMetadataType::SOFT_SEAL,
+              make_seal_traverser(LogStorageState::SealType::SOFT));
+          if (rv != 0) {
+            ld_error("Failed to populate Soft Seals from shard %d: %s",
+                     shard,
+                     error_name(err));
+            goto out;
           }
 
+          // All seals of the shard were read, so logs that have no seal are
+          // known to have an empty one, like RecoverSealTask would find.
+          // Otherwise the first STORE or read of each of these logs after
+          // startup would still need a storage task to find out.
+          lsmap->forEachLogOnShard(
+              shard, [&](logid_t log_id, const LogStorageState&) {
+                logs.push_back(log_id);
+                return 0;
+              });
+          for (logid_t log_id : logs) {
+            LogStorageState* log_state = lsmap->find(log_id, shard);
+            if (log_state == nullptr || log_state->hasPermanentError()) {
+              continue;
+            }
+            for (auto type : {LogStorageState::SealType::NORMAL,
+                              LogStorageState::SealType::SOFT}) {
+              if (!log_state->getSeal(type).has_value()) {
+                log_state->updateSeal(Seal(), type);
+              }
+            }
+          }
+          ld_info("Populated state of %lu logs from shard %d.",
+                  logs.size(),
+                  shard);
+
         out:
           if (rv != 0 && !sharded_store->switchToFailingLocalLogStore(shard)) {
             ld_critical("Failed to disable shard %d.", shard);
@@ -1314,7 +1386,20 @@ bool Server::initSequencers() {
   // Create an instance of EpochStore.
   std::unique_ptr<EpochStore> epoch_store;
 
-  if (!server_settings_->epoch_store_path.empty()) {
+  if (!server_settings_->epoch_store_rocksdb_path.empty()) {
+    try {
+      ld_info("Initializing RocksDBEpochStore");
+      epoch_store = std::make_unique<RocksDBEpochStore>(
+          server_settings_->epoch_store_rocksdb_path,
+          processor_->getRequestExecutor(),
+          processor_->getOptionalMyNodeID(),
+          updateable_config_->updateableNodesConfiguration());
+    } catch (const ConstructorFailed&) {
+      ld_error(
+          "Failed to construct RocksDBEpochStore: %s", error_description(err));
+      return false;
+    }
+  } else if (!server_settings_->epoch_store_path.empty()) {
     try {
       ld_info("Initializing FileEpochStore");
       epoch_store = std::make_unique<FileEpochStore>(
@@ -1678,6 +1763,11 @@ bool Server::startListening() {
     return false;
   }
 
+  if (local_connection_listener_ &&
+      !startConnectionListener(local_connection_listener_)) {
+    return false;
+  }
+
   if (gossip_listener_loop_ && !startConnectionListener(gossip_listener_)) {
     return false;
   }
@@ -1735,6 +1825,7 @@ void Server::gracefulShutdown() {
                   listeners_per_network_priority_,
                   gossip_listener_,
                   ssl_connection_listener_,
+                  local_connection_listener_,
                   server_to_server_listener_,
                   connection_listener_loop_,
                   gossip_listener_loop_,
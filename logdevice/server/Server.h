@@ -259,9 +259,15 @@ class Server {
     if (accept) {
       connection_listener_->startAcceptingConnections().wait();
       ssl_connection_listener_->startAcceptingConnections().wait();
+      if (local_connection_listener_) {
+        local_connection_listener_->startAcceptingConnections().wait();
+      }
     } else {
       connection_listener_->stopAcceptingConnections().wait();
       ssl_connection_listener_->stopAcceptingConnections().wait();
+      if (local_connection_listener_) {
+        local_connection_listener_->stopAcceptingConnections().wait();
+      }
     }
   }
 
@@ -291,6 +297,7 @@ class Server {
   std::unique_ptr<LogDeviceThriftServer> admin_server_handle_;
   std::unique_ptr<Listener> connection_listener_;
   std::unique_ptr<Listener> ssl_connection_listener_;
+  std::unique_ptr<Listener> local_connection_listener_;
   std::unique_ptr<Listener> gossip_listener_;
   std::unique_ptr<Listener> server_to_server_listener_;
   std::map<ServerSettings::ClientNetworkPriority, std::unique_ptr<Listener>>
@@ -15,6 +15,7 @@
 #include "logdevice/common/protocol/MessageTypeNames.h"
 #include "logdevice/common/protocol/RELEASE_Message.h"
 #include "logdevice/common/protocol/STOP_Message.h"
+#include "logdevice/common/protocol/STORES_BATCH_Message.h"
 #include "logdevice/common/protocol/STORE_Message.h"
 #include "logdevice/common/protocol/WINDOW_Message.h"
 #include "logdevice/common/util.h"
@@ -275,6 +276,13 @@ void ServerMessageDispatch::onSentImpl(const Message& msg,
       return RECORD_onSent(
           checked_downcast<const RECORD_Message&>(msg), st, to, enqueue_time);
 
+    case MessageType::RECORDS_BATCH:
+      return RECORDS_BATCH_onSent(
+          checked_downcast<const RECORDS_BATCH_Message&>(msg),
+          st,
+          to,
+          enqueue_time);
+
     case MessageType::SHARD_STATUS_UPDATE:
       return ServerWorker::onThisThread()
           ->serverReadStreams()
@@ -288,6 +296,13 @@ void ServerMessageDispatch::onSentImpl(const Message& msg,
       return STORE_onSent(
           checked_downcast<const STORE_Message&>(msg), st, to, enqueue_time);
 
+    case MessageType::STORES_BATCH:
+      for (const auto& store :
+           checked_downcast<const STORES_BATCH_Message&>(msg).stores_) {
+        STORE_onSent(*store, st, to, enqueue_time);
+      }
+      return;
+
     default:
       // By default, call the Message's onSent() implementation (for messages
       // whose handler lives in common/ with the Message subclass)
@@ -8,6 +8,7 @@
 
 #pragma once
 #include <string>
+#include <vector>
 
 #include <folly/Memory.h>
 #include <folly/Range.h>
@@ -16,6 +17,8 @@
 #include "logdevice/common/ServerRecordFilter.h"
 #include "logdevice/common/debug.h"
 #include "logdevice/server/ServerRecordEqualityFilter.h"
+#include "logdevice/server/ServerRecordInSetFilter.h"
+#include "logdevice/server/ServerRecordPrefixFilter.h"
 #include "logdevice/server/ServerRecordRangeFilter.h"
 
 namespace facebook { namespace logdevice {
@@ -30,7 +33,9 @@ class ServerRecordFilterFactory {
   /**
    *  @param type  specifies type of filter we are constructing here.
    *               Type is defined in ServerRecordFilter.h
-   *         key1  param for constructing ServerRecordFilter
+   *         key1  param for constructing ServerRecordFilter. For IN_SET
+   *               filters, the set of keys encoded with
+   *               ReadStreamAttributes::encodeKeySet().
    *         key2  param for constructing ServerRecordFilter, only used for
    *               ServerRecordRangeFilter. Serves as high_limit_.
    *  @return      unique_ptr to a ServerRecordFilter object; return nullptr
@@ -52,6 +57,18 @@ class ServerRecordFilterFactory {
           return nullptr;
         }
         return std::make_unique<ServerRecordRangeFilter>(key1, key2);
+      case ServerRecordFilterType::IN_SET: {
+        std::vector<folly::StringPiece> keys;
+        if (!ReadStreamAttributes::decodeKeySet(key1, &keys)) {
+          ld_error("ServerRecordInSetFilter failed to construct. Malformed "
+                   "set of keys of %zu bytes.",
+                   key1.size());
+          return nullptr;
+        }
+        return std::make_unique<ServerRecordInSetFilter>(keys);
+      }
+      case ServerRecordFilterType::PREFIX:
+        return std::make_unique<ServerRecordPrefixFilter>(key1);
       case ServerRecordFilterType::NOFILTER:
         return nullptr;
       default:
@@ -0,0 +1,59 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+#include <sstream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <folly/Range.h>
+
+#include "logdevice/common/ServerRecordFilter.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file ServerRecordInSetFilter passes records whose key is one of a set of
+ *       keys. It replaces an OR of equality filters, which a read stream
+ *       could otherwise only get by opening one stream per key.
+ *       Experimental feature: Use with caution.
+ */
+
+class ServerRecordInSetFilter final : public ServerRecordFilter {
+ public:
+  /**
+   * @param keys   keys of records to pass
+   */
+  explicit ServerRecordInSetFilter(const std::vector<folly::StringPiece>& keys)
+      : keys_(keys.begin(), keys.end()) {}
+
+  /**
+   * @param record_key   key of record or string you wish to be filtered
+   * @return             whether input string will be filtered out
+   */
+  bool operator()(folly::StringPiece record_key) override {
+    // TODO: avoid constructing a string once heterogeneous lookup is
+    // available
+    return keys_.count(record_key.str()) > 0;
+  }
+
+  /**
+   *  @return             A human-readable string which describes this
+   *                      server-side filter.
+   */
+  std::string toString() const override {
+    std::stringstream ss;
+    ss << "Server-side filter type: IN_SET, " << keys_.size() << " keys";
+    return ss.str();
+  }
+
+ private:
+  const std::unordered_set<std::string> keys_;
+};
+}} // namespace facebook::logdevice
@@ -184,6 +184,15 @@ void ServerSettings::defineSettings(SettingEasyInit& init) {
      SERVER | REQUIRES_RESTART | CLI_ONLY,
      SettingsCategory::Testing)
 
+    ("local-data-unix-socket", &local_data_unix_socket, "",
+     validate_unix_socket,
+     "Path to a unix domain socket the server will listen on for non-SSL "
+     "clients in addition to its data port. Clients running on the same host "
+     "can connect through it (see --local-data-unix-sockets) to skip the TCP "
+     "stack when reading.",
+     SERVER | REQUIRES_RESTART,
+     SettingsCategory::Network)
+
     ("port", &port, "16111", validate_port,
      "TCP port on which the server listens for non-SSL clients",
      SERVER | REQUIRES_RESTART | CLI_ONLY,
@@ -368,6 +377,13 @@ void ServerSettings::defineSettings(SettingEasyInit& init) {
      SERVER | REQUIRES_RESTART,
      SettingsCategory::Testing)
 
+    ("epoch-store-rocksdb-path", &epoch_store_rocksdb_path, "", nullptr,
+     "directory of a local RocksDB database holding the epoch store (for "
+     "testing and single-node setups only). Unlike --epoch-store-path, "
+     "scales to many logs. Takes precedence over --epoch-store-path.",
+     SERVER | REQUIRES_RESTART,
+     SettingsCategory::Testing)
+
     ("shutdown-timeout", &shutdown_timeout, "120s",
      [](std::chrono::milliseconds val) -> void {
        if (val.count() <= 0) {
@@ -431,6 +447,15 @@ void ServerSettings::defineSettings(SettingEasyInit& init) {
      SERVER | REQUIRES_RESTART,
      SettingsCategory::ResourceManagement)
 
+    ("dedicated-memory-arenas", &dedicated_memory_arenas, "false", nullptr,
+     "On startup, create dedicated jemalloc arenas for appenders, pooled "
+     "messages and the RocksDB block cache (unless "
+     "--rocksdb-use-nocachedump-memory-allocator is set), and report the "
+     "memory allocated from each of them in the memory_arena_* stats. Has no "
+     "effect if logdeviced is not linked with jemalloc.",
+     SERVER | REQUIRES_RESTART,
+     SettingsCategory::ResourceManagement)
+
     ("user", &user, "", nullptr,
      "user to switch to if server is run as root",
      SERVER | REQUIRES_RESTART,
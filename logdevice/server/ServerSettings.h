@@ -66,6 +66,9 @@ struct ServerSettings : public SettingsBundle {
 
   int port;
   std::string unix_socket;
+  // Path of an additional unix domain socket for non-SSL data connections
+  // from clients running on the same host.
+  std::string local_data_unix_socket;
   bool require_ssl_on_command_port;
   int ssl_command_port;
   bool admin_enabled;
@@ -78,6 +81,7 @@ struct ServerSettings : public SettingsBundle {
   std::string log_file;
   std::string config_path;
   std::string epoch_store_path;
+  std::string epoch_store_rocksdb_path;
   StoragePoolParams storage_pool_params;
   std::chrono::milliseconds shutdown_timeout;
   // Interval between invoking syncs for delayable storage tasks.
@@ -88,6 +92,7 @@ struct ServerSettings : public SettingsBundle {
   bool eagerly_allocate_fdtable;
   int num_reserved_fds;
   bool lock_memory;
+  bool dedicated_memory_arenas;
   std::string user;
   SequencerOptions sequencer;
   bool unmap_caches;
@@ -20,6 +20,7 @@
 #include "logdevice/server/storage/AllCachedDigests.h"
 #include "logdevice/server/storage/PurgeScheduler.h"
 #include "logdevice/server/storage/PurgeUncleanEpochs.h"
+#include "logdevice/server/storage/TrimMetadataBatcher.h"
 #include "logdevice/server/storage_tasks/PerWorkerStorageTaskQueue.h"
 #include "logdevice/server/storage_tasks/ShardedStorageThreadPool.h"
 
@@ -37,13 +38,15 @@ class ServerWorkerImpl {
   explicit ServerWorkerImpl(ServerWorker* w)
       : cachedDigests_(
             w->immutable_settings_->max_active_cached_digests,
-            w->immutable_settings_->max_cached_digest_record_queued_kb),
+            w->immutable_settings_->max_cached_digest_record_queued_kb,
+            w->immutable_settings_->cached_digest_snapshot_reuse_ttl),
         activePurges_(w->immutable_settings_->server ? N_PURGES_MAP_BUCKETS
                                                      : 1) {}
 
   AllCachedDigests cachedDigests_;
   PurgeUncleanEpochsMap activePurges_;
   ChunkRebuildingMap runningChunkRebuildings_;
+  std::unique_ptr<TrimMetadataBatcher> trimMetadataBatcher_;
 
   /**
    * Should only be instantiated on a single worker, decided by
@@ -167,6 +170,14 @@ ChunkRebuildingMap& ServerWorker::runningChunkRebuildings() const {
   return impl_->runningChunkRebuildings_;
 }
 
+TrimMetadataBatcher& ServerWorker::trimMetadataBatcher() const {
+  // Created lazily since its timer has to be created on the worker thread.
+  if (!impl_->trimMetadataBatcher_) {
+    impl_->trimMetadataBatcher_ = std::make_unique<TrimMetadataBatcher>();
+  }
+  return *impl_->trimMetadataBatcher_;
+}
+
 AllServerReadStreams& ServerWorker::serverReadStreams() const {
   ld_assert(server_read_streams_.get());
   return *server_read_streams_;
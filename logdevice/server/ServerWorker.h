@@ -27,6 +27,7 @@ class PurgeScheduler;
 class StorageThreadPool;
 class ServerProcessor;
 class ServerWorkerImpl;
+class TrimMetadataBatcher;
 
 struct ChunkRebuildingMap;
 struct PurgeUncleanEpochsMap;
@@ -72,6 +73,10 @@ class ServerWorker : public Worker {
 
   ChunkRebuildingMap& runningChunkRebuildings() const;
 
+  // Coalesces the trim points of TRIMs received by this worker into one
+  // storage task per shard, created on first use.
+  TrimMetadataBatcher& trimMetadataBatcher() const;
+
   // Intentionally shadows `Worker::processor_' to expose a more specific
   // subclass of Processor
   ServerProcessor* const processor_;
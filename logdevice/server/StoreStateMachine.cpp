@@ -435,6 +435,10 @@ void StoreStateMachine::execute() {
     return;
   }
 
+  if (Worker::settings().store_chain_forward_early) {
+    forwardEarly();
+  }
+
   if (message_->header_.flags & STORE_Header::REBUILDING) {
     // Accept this rebuilding store only if
     //  the lsn of the store is at or below last_released OR
@@ -634,6 +638,17 @@ void StoreStateMachine::storeAndForward() {
 
   const auto& worker_settings = Worker::settings();
 
+  bool write_find_time_index = worker_settings.write_find_time_index;
+  if (write_find_time_index &&
+      worker_settings.write_find_time_index_interval.count() > 0) {
+    if (LogStorageState* log_state =
+            worker->processor_->getLogStorageStateMap().find(log_id, shard_)) {
+      write_find_time_index = log_state->shouldWriteFindTimeIndexEntry(
+          std::chrono::milliseconds(header.timestamp),
+          worker_settings.write_find_time_index_interval);
+    }
+  }
+
   // First create a storage task for the local log store.  The constructor
   // will copy any needed data from the parameters (as well as attach to the
   // PayloadHolder), making the task self-sufficient.  We'll
@@ -649,38 +664,13 @@ void StoreStateMachine::storeAndForward() {
       message_->reply_to_,
       start_time_,
       durability_,
-      worker_settings.write_find_time_index,
+      write_find_time_index,
       merge_mutable_per_epoch_log_metadata,
       worker_settings.write_shard_id_in_copyset);
 
-  // Forward to next node in chain
-  if (header.flags & STORE_Header::CHAIN) {
-    if (message_->my_pos_in_copyset_ + 1 < header.copyset_size) {
-      ShardID next_dest =
-          message_->copyset_[message_->my_pos_in_copyset_ + 1].destination;
-
-      ld_debug("Forwarding a STORE %s that we got from %s to %s "
-               "(link #%d).",
-               header.rid.toString().c_str(),
-               Sender::describeConnection(from_).c_str(),
-               next_dest.toString().c_str(),
-               message_->my_pos_in_copyset_ + 1);
-
-      if (message_->my_pos_in_copyset_ == header.nsync) {
-        header.flags &= ~STORE_Header::SYNC;
-      }
-      header.copyset_offset = message_->my_pos_in_copyset_ + 1;
-      if (header.copyset_offset >= message_->extra_.first_amendable_offset) {
-        header.flags |= STORE_Header::AMEND;
-      }
-
-      int rv = worker->sender().sendMessage(
-          std::move(message_), next_dest.asNodeID());
-      if (rv != 0) {
-        // sendMessage() failed, we still own message_
-        message_->onForwardingFailure(err);
-      }
-    }
+  // Forward to next node in chain, unless execute() already did.
+  if (!forwarded_) {
+    forward(std::move(message_), from_);
   }
 
   // At this point message_ may already be destroyed if we forwarded to the next
@@ -690,4 +680,65 @@ void StoreStateMachine::storeAndForward() {
   worker->getStorageTaskQueueForShard(shard_)->putTask(std::move(task));
 }
 
+void StoreStateMachine::forward(std::unique_ptr<STORE_Message> msg,
+                                const Address& from) {
+  auto& header = msg->header_;
+  if (!(header.flags & STORE_Header::CHAIN) ||
+      msg->my_pos_in_copyset_ + 1 >= header.copyset_size) {
+    return;
+  }
+
+  ShardID next_dest = msg->copyset_[msg->my_pos_in_copyset_ + 1].destination;
+
+  ld_debug("Forwarding a STORE %s that we got from %s to %s "
+           "(link #%d).",
+           header.rid.toString().c_str(),
+           Sender::describeConnection(from).c_str(),
+           next_dest.toString().c_str(),
+           msg->my_pos_in_copyset_ + 1);
+
+  if (msg->my_pos_in_copyset_ == header.nsync) {
+    header.flags &= ~STORE_Header::SYNC;
+  }
+  header.copyset_offset = msg->my_pos_in_copyset_ + 1;
+  if (header.copyset_offset >= msg->extra_.first_amendable_offset) {
+    header.flags |= STORE_Header::AMEND;
+  }
+
+  int rv = Worker::onThisThread()->sender().sendMessage(
+      std::move(msg), next_dest.asNodeID());
+  if (rv != 0) {
+    // sendMessage() failed, we still own msg
+    msg->onForwardingFailure(err);
+  }
+}
+
+void StoreStateMachine::forwardEarly() {
+  const auto& header = message_->header_;
+  if (!(header.flags & STORE_Header::CHAIN) ||
+      (header.flags & STORE_Header::REBUILDING) ||
+      message_->my_pos_in_copyset_ + 1 >= header.copyset_size) {
+    return;
+  }
+
+  // The rest of the state machine still needs message_, so forward a copy.
+  // The copy shares the payload. Its header flags are copied verbatim
+  // because the constructor doesn't accept all of them.
+  auto copy = std::make_unique<STORE_Message>(header,
+                                              message_->copyset_.data(),
+                                              header.copyset_offset,
+                                              0,
+                                              message_->extra_,
+                                              message_->optional_keys_,
+                                              message_->payload_);
+  copy->header_.flags = header.flags;
+  copy->block_starting_lsn_ = message_->block_starting_lsn_;
+  copy->my_pos_in_copyset_ = message_->my_pos_in_copyset_;
+  copy->reply_to_ = message_->reply_to_;
+
+  forwarded_ = true;
+  WORKER_STAT_INCR(store_forwarded_early);
+  forward(std::move(copy), from_);
+}
+
 }} // namespace facebook::logdevice
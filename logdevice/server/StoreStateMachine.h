@@ -79,11 +79,25 @@ class StoreStateMachine {
   // enabled) and stores it in the local log store.
   void storeAndForward();
 
+  // Sends `msg` to the next node in its chain, if it's a chained STORE and
+  // we aren't the last link.
+  static void forward(std::unique_ptr<STORE_Message> msg, const Address& from);
+
+  // With --store-chain-forward-early, forwards a copy of message_ down the
+  // chain before the seal is known, so that the next link doesn't wait for
+  // a seal recovery or soft seal update on this node. Each link checks
+  // seals on its own and replies to the Appender directly, so this is no
+  // different from a direct wave where all recipients get the record at once.
+  void forwardEarly();
+
   std::unique_ptr<STORE_Message> message_;
   shard_index_t shard_;
   Address from_; // sender of the STORE message
   std::chrono::steady_clock::time_point start_time_;
   Durability durability_;
+
+  // True if forwardEarly() already sent the record down the chain.
+  bool forwarded_{false};
 };
 
 }} // namespace facebook::logdevice
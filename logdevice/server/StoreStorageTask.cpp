@@ -298,16 +298,19 @@ void StoreStorageTask::sendReply(Status status) const {
   }
 
   ServerWorker* worker = ServerWorker::onThisThread();
-  if (worker->getStorageTaskQueueForShard(reply_shard_idx_)->isOverloaded()) {
+  const ShardedStorageThreadPool* sharded_pool =
+      worker->processor_->sharded_storage_thread_pool_;
+  LocalLogStore& store =
+      sharded_pool->getByIndex(reply_shard_idx_).getLocalLogStore();
+  // Also tell the sequencer to pick other copysets if the store predicts that
+  // it'll have to stall writes soon.
+  if (worker->getStorageTaskQueueForShard(reply_shard_idx_)->isOverloaded() ||
+      store.getWritePressure() >= 1) {
     flags |= STORED_Header::OVERLOADED;
     WORKER_STAT_INCR(node_overloaded_sent);
   }
 
-  const ShardedStorageThreadPool* sharded_pool =
-      worker->processor_->sharded_storage_thread_pool_;
-  Status st = sharded_pool->getByIndex(reply_shard_idx_)
-                  .getLocalLogStore()
-                  .acceptingWrites();
+  Status st = store.acceptingWrites();
   if (st == E::LOW_ON_SPC) {
     flags |= STORED_Header::LOW_WATERMARK_NOSPC;
     WORKER_STAT_INCR(node_stored_low_on_space_sent);
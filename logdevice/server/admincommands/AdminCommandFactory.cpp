@@ -34,6 +34,7 @@
 #include "logdevice/server/admincommands/InfoGossip.h"
 #include "logdevice/server/admincommands/InfoGraylist.h"
 #include "logdevice/server/admincommands/InfoIterators.h"
+#include "logdevice/server/admincommands/InfoLatencyTraces.h"
 #include "logdevice/server/admincommands/InfoLogsConfigRsm.h"
 #include "logdevice/server/admincommands/InfoLogsDBMetadata.h"
 #include "logdevice/server/admincommands/InfoPartitions.h"
@@ -50,6 +51,7 @@
 #include "logdevice/server/admincommands/InfoSettings.h"
 #include "logdevice/server/admincommands/InfoShardOperationalState.h"
 #include "logdevice/server/admincommands/InfoShards.h"
+#include "logdevice/server/admincommands/InfoSlowExecutions.h"
 #include "logdevice/server/admincommands/InfoSockets.h"
 #include "logdevice/server/admincommands/InfoStorageTasks.h"
 #include "logdevice/server/admincommands/InfoStoredLogs.h"
@@ -101,6 +103,8 @@ AdminCommandFactory::AdminCommandFactory() {
 
   selector_.add<commands::Info>("info");
   selector_.add<commands::InfoAppendOutliers>("info append_outliers");
+  selector_.add<commands::InfoLatencyTraces>("info latency_traces");
+  selector_.add<commands::InfoSlowExecutions>("info slow_executions");
   selector_.add<commands::InfoGossip>("info gossip");
   selector_.add<commands::InfoBoycotts>("info boycotts");
   selector_.add<commands::InfoGraylist>("info graylist");
@@ -220,6 +224,8 @@ AdminCommandFactory::AdminCommandFactory() {
       "logsdb create", Restriction::LOCALHOST_ONLY);
   selector_.add<commands::PrependPartitions>(
       "logsdb prepend", Restriction::LOCALHOST_ONLY);
+  selector_.add<commands::ImportRecords>(
+      "logsdb import", Restriction::LOCALHOST_ONLY);
   selector_.add<commands::PrintLogsDBDirectories>("logsdb print_directory");
   selector_.add<commands::ApplyRetention>(
       "logsdb apply_retention_approximate", Restriction::LOCALHOST_ONLY);
@@ -7,6 +7,8 @@
  */
 #pragma once
 
+#include <limits>
+
 #include <folly/Memory.h>
 
 #include "logdevice/common/AdminCommandTable.h"
@@ -24,15 +26,17 @@ class InfoCatchupQueues : public AdminCommand {
   using AdminCommand::AdminCommand;
 
  private:
-  std::string type_;
-  folly::Optional<uint64_t> id_;
+  uint32_t client_idx_ = 0;
   bool json_ = false;
+  bool binary_ = false;
 
  public:
   void getOptions(
       boost::program_options::options_description& out_options) override {
     out_options.add_options()(
-        "json", boost::program_options::bool_switch(&json_));
+        "json", boost::program_options::bool_switch(&json_))(
+        "client", boost::program_options::value<uint32_t>(&client_idx_))(
+        "binary", boost::program_options::bool_switch(&binary_));
   }
 
   void getPositionalOptions(
@@ -40,11 +44,18 @@ class InfoCatchupQueues : public AdminCommand {
       override {}
 
   std::string getUsage() override {
-    return "info catchup_queues [--json]";
+    return "info catchup_queues [--client=<clientid>] [--json|--binary]";
   }
 
   void run() override {
-    InfoCatchupQueuesTable table(!json_,
+    if (client_idx_ > std::numeric_limits<int32_t>::max()) {
+      out_.printf("Invalid parameter for --client. Expected a valid client "
+                  "id, got %u.\r\n",
+                  client_idx_);
+      return;
+    }
+
+    InfoCatchupQueuesTable table(!json_ && !binary_,
                                  "Client",
                                  "Queued total",
                                  "Queued Immediate",
@@ -57,7 +68,12 @@ class InfoCatchupQueues : public AdminCommand {
     auto tables = run_on_all_workers(server_->getProcessor(), [&]() {
       InfoCatchupQueuesTable t(table);
       ServerWorker* w = ServerWorker::onThisThread();
-      w->serverReadStreams().getCatchupQueuesDebugInfo(t);
+      if (client_idx_ == 0) {
+        w->serverReadStreams().getCatchupQueuesDebugInfo(t);
+      } else {
+        w->serverReadStreams().getCatchupQueuesDebugInfo(
+            ClientID(client_idx_), t);
+      }
       return t;
     });
 
@@ -65,7 +81,11 @@ class InfoCatchupQueues : public AdminCommand {
       table.mergeWith(std::move(tables[i]));
     }
 
-    json_ ? table.printJson(out_) : table.print(out_);
+    if (binary_) {
+      table.printBinary(out_);
+    } else {
+      json_ ? table.printJson(out_) : table.print(out_);
+    }
   }
 };
 
@@ -0,0 +1,34 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include "logdevice/common/LatencyTrace.h"
+#include "logdevice/server/admincommands/AdminCommand.h"
+
+namespace facebook { namespace logdevice { namespace commands {
+
+/**
+ * Prints the time spent in each stage by recently sampled appends and
+ * storage tasks (see LatencyTrace), in the folded stacks format accepted by
+ * flamegraph.pl.
+ */
+class InfoLatencyTraces : public AdminCommand {
+  using AdminCommand::AdminCommand;
+
+ public:
+  std::string getUsage() override {
+    return "info latency_traces";
+  }
+
+  void run() override {
+    out_.printf(
+        "%s", LatencyTrace::toFoldedStacks(LatencyTrace::collect()).c_str());
+  }
+};
+
+}}} // namespace facebook::logdevice::commands
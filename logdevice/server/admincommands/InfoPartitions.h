@@ -86,6 +86,8 @@ class InfoPartitions : public AdminCommand {
                               "Rebuild Dirtied By",
                               "Under Replicated",
                               "Copyset Index Enabled",
+                              "Pending Compaction",
+                              "Est. Reclaimable Bytes",
                               // Level 2
                               "Approx. Obsolete Bytes");
 
@@ -122,6 +124,7 @@ class InfoPartitions : public AdminCommand {
         }
 
         auto partitions = partitioned_store->getPartitionList();
+        auto pending_compactions = partitioned_store->getPendingCompactions();
 
         for (auto partition : *partitions) {
           table.next()
@@ -179,17 +182,23 @@ class InfoPartitions : public AdminCommand {
                 .set<20>(toString(meta.getDirtiedBy(DataClass::REBUILD)))
                 .set<21>(partition->isUnderReplicated())
                 .set<22>(partition->is_csi_enabled_);
+
+            auto pending = pending_compactions.find(partition->id_);
+            if (pending != pending_compactions.end()) {
+              table.set<23>(pending->second.toString())
+                  .set<24>(pending->second.estimated_reclaimable_bytes);
+            }
           }
 
           if (level_ >= 2) {
-            table.set<23>(
+            table.set<25>(
                 partitioned_store->getApproximateObsoleteBytes(partition->id_));
           }
         }
       }
     }
 
-    constexpr std::array<int, maxLevel() + 1> num_stats_per_level = {8, 15, 1};
+    constexpr std::array<int, maxLevel() + 1> num_stats_per_level = {8, 17, 1};
     static_assert(table.numCols() ==
                       num_stats_per_level[0] + num_stats_per_level[1] +
                           num_stats_per_level[2],
@@ -27,6 +27,7 @@ class InfoReaders : public AdminCommand {
   std::string type_;
   folly::Optional<uint64_t> id_;
   bool json_ = false;
+  bool binary_ = false;
 
  public:
   void getOptions(
@@ -43,7 +44,8 @@ class InfoReaders : public AdminCommand {
         ->notifier([&] (uint64_t id) {
           id_ = id;
         }))
-      ("json", boost::program_options::bool_switch(&json_));
+      ("json", boost::program_options::bool_switch(&json_))
+      ("binary", boost::program_options::bool_switch(&binary_));
     // clang-format on
   }
 
@@ -55,7 +57,7 @@ class InfoReaders : public AdminCommand {
   }
 
   std::string getUsage() override {
-    return "info readers client|log|all [<clientid>|<logid>] [--json]";
+    return "info readers client|log|all [<clientid>|<logid>] [--json|--binary]";
   }
 
   void run() override {
@@ -88,7 +90,7 @@ class InfoReaders : public AdminCommand {
       ld_check(false);
     }
 
-    InfoReadersTable table(!json_,
+    InfoReadersTable table(!json_ && !binary_,
                            "Shard",
                            "Client",
                            "Log id",
@@ -134,7 +136,11 @@ class InfoReaders : public AdminCommand {
       table.mergeWith(std::move(tables[i]));
     }
 
-    json_ ? table.printJson(out_) : table.print(out_);
+    if (binary_) {
+      table.printBinary(out_);
+    } else {
+      json_ ? table.printJson(out_) : table.print(out_);
+    }
   }
 };
 
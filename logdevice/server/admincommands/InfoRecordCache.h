@@ -18,6 +18,7 @@ class InfoRecordCache : public AdminCommand {
   folly::Optional<logid_t> log_id_;
   shard_index_t shard_ = -1;
   bool json_ = false;
+  bool binary_ = false;
 
  public:
   void getOptions(boost::program_options::options_description& opts) override {
@@ -26,7 +27,8 @@ class InfoRecordCache : public AdminCommand {
         boost::program_options::value<logid_t::raw_type>()->notifier(
             [this](logid_t::raw_type id) { log_id_ = logid_t(id); }))(
         "shard", boost::program_options::value<shard_index_t>(&shard_))(
-        "json", boost::program_options::bool_switch(&json_));
+        "json", boost::program_options::bool_switch(&json_))(
+        "binary", boost::program_options::bool_switch(&binary_));
   }
 
   void getPositionalOptions(
@@ -36,7 +38,7 @@ class InfoRecordCache : public AdminCommand {
   }
 
   std::string getUsage() override {
-    return "info record_cache [<logid>] [--shard <shard>] [--json]";
+    return "info record_cache [<logid>] [--shard <shard>] [--json|--binary]";
   }
 
   void run() override {
@@ -65,7 +67,7 @@ class InfoRecordCache : public AdminCommand {
     LogStorageStateMap& state_map =
         server_->getServerProcessor()->getLogStorageStateMap();
 
-    InfoRecordCacheTable table(!json_,
+    InfoRecordCacheTable table(!json_ && !binary_,
                                "Log ID",
                                "Shard",
                                "Epoch",
@@ -108,7 +110,11 @@ class InfoRecordCache : public AdminCommand {
       }
     }
 
-    json_ ? table.printJson(out_) : table.print(out_);
+    if (binary_) {
+      table.printBinary(out_);
+    } else {
+      json_ ? table.printJson(out_) : table.print(out_);
+    }
   }
 };
 
@@ -0,0 +1,82 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <algorithm>
+
+#include "logdevice/common/AdminCommandTable.h"
+#include "logdevice/common/Worker.h"
+#include "logdevice/common/request_util.h"
+#include "logdevice/server/admincommands/AdminCommand.h"
+
+namespace facebook { namespace logdevice { namespace commands {
+
+/**
+ * Lists the longest requests and message callbacks that took longer than
+ * request-exec-threshold on each worker (see Worker::slowExecutions_),
+ * longest first.
+ */
+class InfoSlowExecutions : public AdminCommand {
+  using AdminCommand::AdminCommand;
+
+ private:
+  bool clear_ = false;
+  bool json_ = false;
+
+ public:
+  void getOptions(
+      boost::program_options::options_description& out_options) override {
+    out_options.add_options()(
+        "clear", boost::program_options::bool_switch(&clear_))(
+        "json", boost::program_options::bool_switch(&json_));
+  }
+
+  std::string getUsage() override {
+    return "info slow_executions [--clear] [--json]";
+  }
+
+  void run() override {
+    using Execution = std::pair<int, Worker::SlowExecution>;
+    auto per_worker = run_on_all_workers(server_->getProcessor(), [&]() {
+      Worker* w = Worker::onThisThread();
+      std::vector<Execution> res;
+      for (const auto& e : w->slowExecutions_) {
+        res.emplace_back(w->idx_.val(), e);
+      }
+      if (clear_) {
+        w->slowExecutions_.clear();
+      }
+      return res;
+    });
+
+    std::vector<Execution> executions;
+    for (auto& v : per_worker) {
+      executions.insert(executions.end(), v.begin(), v.end());
+    }
+    std::stable_sort(executions.begin(),
+                     executions.end(),
+                     [](const Execution& a, const Execution& b) {
+                       return a.second.duration > b.second.duration;
+                     });
+
+    InfoSlowExecutionsTable table(
+        !json_, "Worker", "Context", "Duration", "End time");
+    for (const auto& e : executions) {
+      table.next()
+          .set<0>(e.first)
+          .set<1>(e.second.context.describe())
+          .set<2>(e.second.duration)
+          .set<3>(std::chrono::duration_cast<std::chrono::milliseconds>(
+              e.second.end_time.time_since_epoch()));
+    }
+
+    json_ ? table.printJson(out_) : table.print(out_);
+  }
+};
+
+}}} // namespace facebook::logdevice::commands
@@ -21,13 +21,15 @@ class InfoStorageTasks : public AdminCommand {
  private:
   shard_index_t shard_ = -1;
   bool json_ = false;
+  bool binary_ = false;
 
  public:
   virtual void getOptions(
       boost::program_options::options_description& out_options) override {
     out_options.add_options()(
         "shard", boost::program_options::value<shard_index_t>(&shard_))(
-        "json", boost::program_options::bool_switch(&json_));
+        "json", boost::program_options::bool_switch(&json_))(
+        "binary", boost::program_options::bool_switch(&binary_));
   }
   virtual void getPositionalOptions(
       boost::program_options::positional_options_description& out_options)
@@ -35,11 +37,11 @@ class InfoStorageTasks : public AdminCommand {
     out_options.add("shard", 1);
   }
   virtual std::string getUsage() override {
-    return "info storage_tasks [<shard>] [--json]";
+    return "info storage_tasks [<shard>] [--json|--binary]";
   }
 
   virtual void run() override {
-    InfoStorageTasksTable table(!json_,
+    InfoStorageTasksTable table(!json_ && !binary_,
                                 "Shard",
                                 "Priority",
                                 "Is Write Queue",
@@ -55,7 +57,7 @@ class InfoStorageTasks : public AdminCommand {
                                 "Extra info");
 
     if (!server_->getProcessor()->runningOnStorageNode()) {
-      if (!json_) {
+      if (!json_ && !binary_) {
         out_.printf("Not a storage node.\r\n\r\n");
       }
       return;
@@ -67,7 +69,7 @@ class InfoStorageTasks : public AdminCommand {
 
     if (shard_ != -1) {
       if (shard_ < shard_lo || shard_ > shard_hi) {
-        if (!json_) {
+        if (!json_ && !binary_) {
           out_.printf("Shard index %d out of range [%d, %d]\r\n",
                       shard_,
                       shard_lo,
@@ -86,7 +88,9 @@ class InfoStorageTasks : public AdminCommand {
       pool->getStorageTaskDebugInfo(table);
     }
 
-    if (json_) {
+    if (binary_) {
+      table.printBinary(out_, table.numCols());
+    } else if (json_) {
       table.printJson(out_, table.numCols());
     } else {
       table.print(out_, table.numCols());
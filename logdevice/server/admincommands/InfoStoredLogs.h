@@ -27,23 +27,25 @@ class InfoStoredLogs : public AdminCommand {
  private:
   bool extended_ = false;
   bool json_ = false;
+  bool binary_ = false;
 
  public:
   void getOptions(
       boost::program_options::options_description& out_options) override {
     out_options.add_options()(
         "extended", boost::program_options::bool_switch(&extended_))(
-        "json", boost::program_options::bool_switch(&json_));
+        "json", boost::program_options::bool_switch(&json_))(
+        "binary", boost::program_options::bool_switch(&binary_));
   }
   void getPositionalOptions(
       boost::program_options::positional_options_description& /*out_options*/)
       override {}
   std::string getUsage() override {
-    return "info stored_logs [--extended] [--json]";
+    return "info stored_logs [--extended] [--json|--binary]";
   }
 
   void run() override {
-    InfoStoredLogsTable table(!json_,
+    InfoStoredLogsTable table(!json_ && !binary_,
                               "Log ID",
                               "Shard",
                               "Highest LSN",
@@ -82,7 +84,11 @@ class InfoStoredLogs : public AdminCommand {
     }
 
     size_t columns = extended_ ? table.numCols() : 1;
-    json_ ? table.printJson(out_, columns) : table.print(out_, columns);
+    if (binary_) {
+      table.printBinary(out_, columns);
+    } else {
+      json_ ? table.printJson(out_, columns) : table.print(out_, columns);
+    }
   }
 };
 
@@ -12,6 +12,7 @@
 #include "logdevice/common/AdminCommandTable.h"
 #include "logdevice/server/ServerWorker.h"
 #include "logdevice/server/admincommands/AdminCommand.h"
+#include "logdevice/server/locallogstore/LogsDBImport.h"
 #include "logdevice/server/locallogstore/PartitionedRocksDBStore.h"
 
 namespace facebook { namespace logdevice { namespace commands {
@@ -466,4 +467,79 @@ class ApplyRetention : public AdminCommand {
   }
 };
 
+class ImportRecords : public AdminCommand {
+  using AdminCommand::AdminCommand;
+
+ private:
+  shard_index_t shard_;
+  std::string path_;
+  size_t batch_size_ = 1024;
+
+ public:
+  void getOptions(
+      boost::program_options::options_description& out_options) override {
+    out_options.add_options()(
+        "shard",
+        boost::program_options::value<shard_index_t>(&shard_)->required())(
+        "path", boost::program_options::value<std::string>(&path_)->required())(
+        "batch-size",
+        boost::program_options::value<size_t>(&batch_size_)
+            ->default_value(batch_size_));
+  }
+  void getPositionalOptions(
+      boost::program_options::positional_options_description& out_options)
+      override {
+    out_options.add("shard", 1);
+    out_options.add("path", 1);
+  }
+  std::string getUsage() override {
+    return "logsdb import <shard> <path> [--batch-size=<records>]\r\n\r\n"
+           "Writes the records of an import file made with "
+           "LogsDBImportFileWriter\r\n"
+           "to the shard, see LogsDBImport.h. Blocks until done.\r\n";
+  }
+
+  void run() override {
+    if (batch_size_ == 0) {
+      out_.printf("Error: --batch-size must be positive\r\n");
+      return;
+    }
+    auto partitioned_store = getStore(server_, shard_, out_);
+    if (partitioned_store == nullptr) {
+      return;
+    }
+
+    ld_info("Importing records from %s into shard %d, triggered by admin "
+            "command",
+            path_.c_str(),
+            shard_);
+    LogsDBImportStats stats;
+    int rv = importLogsDBFile(
+        *partitioned_store,
+        path_,
+        batch_size_,
+        server_->getProcessor()->settings()->write_find_time_index,
+        &stats);
+    ld_info("Imported %lu records (%lu bytes) from %s into shard %d, skipped "
+            "%lu trimmed records%s",
+            stats.records,
+            stats.bytes,
+            path_.c_str(),
+            shard_,
+            stats.skipped_trimmed,
+            rv == 0 ? "" : ", failed");
+    if (rv != 0) {
+      out_.printf("Error: %s. Imported %lu records before the error.\r\n",
+                  error_description(err),
+                  stats.records);
+      return;
+    }
+    out_.printf("Imported %lu records (%lu bytes), skipped %lu trimmed "
+                "records\r\n",
+                stats.records,
+                stats.bytes,
+                stats.skipped_trimmed);
+  }
+};
+
 }}} // namespace facebook::logdevice::commands
@@ -0,0 +1,343 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/server/epoch_store/RocksDBEpochStore.h"
+
+#include <algorithm>
+
+#include <folly/Bits.h>
+#include <folly/hash/Hash.h>
+#include <rocksdb/write_batch.h>
+
+#include "logdevice/common/ConstructorFailed.h"
+#include "logdevice/common/EpochMetaDataUpdater.h"
+#include "logdevice/common/MetaDataLog.h"
+#include "logdevice/common/configuration/Configuration.h"
+#include "logdevice/common/configuration/LocalLogsConfig.h"
+#include "logdevice/common/debug.h"
+#include "logdevice/server/epoch_store/EpochMetaDataZRQ.h"
+#include "logdevice/server/epoch_store/EpochStoreEpochMetaDataFormat.h"
+#include "logdevice/server/epoch_store/GetLastCleanEpochZRQ.h"
+#include "logdevice/server/epoch_store/SetLastCleanEpochZRQ.h"
+
+namespace facebook { namespace logdevice {
+
+RocksDBEpochStore::RocksDBEpochStore(
+    std::string path,
+    RequestExecutor request_executor,
+    folly::Optional<NodeID> my_node_id,
+    std::shared_ptr<UpdateableNodesConfiguration> config)
+    : path_(std::move(path)),
+      request_executor_(std::move(request_executor)),
+      my_node_id_(std::move(my_node_id)),
+      config_(std::move(config)) {
+  ld_check(!path_.empty());
+
+  rocksdb::Options options;
+  options.create_if_missing = true;
+  rocksdb::DB* db;
+  rocksdb::Status status = rocksdb::DB::Open(options, path_, &db);
+  if (!status.ok()) {
+    ld_error("Failed to open epoch store database at %s: %s",
+             path_.c_str(),
+             status.ToString().c_str());
+    err = E::FAILED;
+    throw ConstructorFailed();
+  }
+  db_.reset(db);
+}
+
+RocksDBEpochStore::~RocksDBEpochStore() {}
+
+std::string RocksDBEpochStore::keyForLog(logid_t logid) {
+  // Metadata logs share the key of their data log, like in the other epoch
+  // stores. Big endian keeps keys sorted by log id.
+  uint64_t key = folly::Endian::big(MetaDataLog::dataLogID(logid).val_);
+  return std::string(reinterpret_cast<const char*>(&key), sizeof(key));
+}
+
+std::mutex& RocksDBEpochStore::lockForLog(logid_t logid) {
+  return log_locks_[folly::hash::twang_mix64(
+                        MetaDataLog::dataLogID(logid).val_) %
+                    log_locks_.size()];
+}
+
+int RocksDBEpochStore::getLastCleanEpoch(logid_t log_id,
+                                         EpochStore::CompletionLCE cf) {
+  auto log_metadata = LogMetaData::forNewLog(log_id);
+  auto zrq = std::unique_ptr<ZookeeperEpochStoreRequest>(
+      new GetLastCleanEpochZRQ(log_id, cf));
+  int rv = updateEpochStore(zrq, log_metadata);
+  zrq->postCompletion(
+      rv == 0 ? E::OK : err, std::move(log_metadata), request_executor_);
+  return 0;
+}
+
+int RocksDBEpochStore::getLastCleanEpochs(const std::vector<logid_t>& logids,
+                                          EpochStore::CompletionLCE cf) {
+  std::vector<std::string> keys;
+  keys.reserve(logids.size());
+  for (logid_t log_id : logids) {
+    keys.push_back(keyForLog(log_id));
+  }
+  std::vector<rocksdb::Slice> key_slices(keys.begin(), keys.end());
+  std::vector<std::string> values;
+  std::vector<rocksdb::Status> statuses =
+      db_->MultiGet(rocksdb::ReadOptions(), key_slices, &values);
+
+  for (size_t i = 0; i < logids.size(); ++i) {
+    auto log_metadata = LogMetaData::forNewLog(logids[i]);
+    auto zrq = std::unique_ptr<ZookeeperEpochStoreRequest>(
+        new GetLastCleanEpochZRQ(logids[i], cf));
+    Status st;
+    if (!statuses[i].ok() && !statuses[i].IsNotFound()) {
+      RATELIMIT_ERROR(std::chrono::seconds(1),
+                      10,
+                      "Failed to read metadata of log %lu: %s",
+                      logids[i].val_,
+                      statuses[i].ToString().c_str());
+      st = E::FAILED;
+    } else {
+      std::string unused;
+      int rv = applyRequest(zrq,
+                            statuses[i].ok() ? &values[i] : nullptr,
+                            log_metadata,
+                            &unused);
+      // A GetLastCleanEpochZRQ never asks for a write.
+      ld_check(rv != 0);
+      st = err;
+    }
+    zrq->postCompletion(st, std::move(log_metadata), request_executor_);
+  }
+  return 0;
+}
+
+int RocksDBEpochStore::setLastCleanEpoch(logid_t log_id,
+                                         epoch_t lce,
+                                         const TailRecord& tail_record,
+                                         EpochStore::CompletionLCE cf) {
+  if (!tail_record.isValid() || tail_record.containOffsetWithinEpoch()) {
+    RATELIMIT_CRITICAL(std::chrono::seconds(5),
+                       5,
+                       "INTERNAL ERROR: attempting to update LCE with invalid "
+                       "tail record! log %lu, lce %u, tail record flags: %u",
+                       log_id.val_,
+                       lce.val_,
+                       tail_record.header.flags);
+    err = E::INVALID_PARAM;
+    ld_check(false);
+    return -1;
+  }
+
+  auto log_metadata = LogMetaData::forNewLog(log_id);
+  auto zrq = std::unique_ptr<ZookeeperEpochStoreRequest>(
+      new SetLastCleanEpochZRQ(log_id, lce, tail_record, cf));
+  int rv = updateEpochStore(zrq, log_metadata);
+  zrq->postCompletion(
+      rv == 0 ? E::OK : err, std::move(log_metadata), request_executor_);
+  return 0;
+}
+
+int RocksDBEpochStore::createOrUpdateMetaData(
+    logid_t log_id,
+    std::shared_ptr<EpochMetaData::Updater> updater,
+    EpochStore::CompletionMetaData cf,
+    MetaDataTracer tracer,
+    WriteNodeID write_node_id) {
+  if (log_id <= LOGID_INVALID || log_id > LOGID_MAX) {
+    err = E::INVALID_PARAM;
+    return -1;
+  }
+
+  auto log_metadata = LogMetaData::forNewLog(log_id);
+  auto zrq = std::unique_ptr<ZookeeperEpochStoreRequest>(
+      new EpochMetaDataZRQ(log_id,
+                           cf,
+                           std::move(updater),
+                           std::move(tracer),
+                           write_node_id,
+                           config_->get(),
+                           my_node_id_));
+  int rv = updateEpochStore(zrq, log_metadata);
+  zrq->postCompletion(
+      rv == 0 ? E::OK : err, std::move(log_metadata), request_executor_);
+  return 0;
+}
+
+int RocksDBEpochStore::provisionMetaDataLogs(
+    std::shared_ptr<EpochMetaData::Updater> provisioner,
+    std::shared_ptr<Configuration> config) {
+  const auto& logs_config = config->localLogsConfig();
+  std::vector<logid_t> logids;
+  for (auto it = logs_config->logsBegin(); it != logs_config->logsEnd(); ++it) {
+    logids.push_back(logid_t(it->first));
+  }
+
+  std::vector<std::string> keys;
+  keys.reserve(logids.size());
+  for (logid_t log_id : logids) {
+    keys.push_back(keyForLog(log_id));
+  }
+  std::vector<rocksdb::Slice> key_slices(keys.begin(), keys.end());
+
+  // Hold the locks of all logs so that the batch doesn't overwrite
+  // concurrent updates. Locks are taken in address order to avoid deadlocks.
+  std::vector<std::mutex*> locks;
+  for (logid_t log_id : logids) {
+    locks.push_back(&lockForLog(log_id));
+  }
+  std::sort(locks.begin(), locks.end());
+  locks.erase(std::unique(locks.begin(), locks.end()), locks.end());
+  std::vector<std::unique_lock<std::mutex>> guards;
+  for (std::mutex* lock : locks) {
+    guards.emplace_back(*lock);
+  }
+
+  std::vector<std::string> values;
+  std::vector<rocksdb::Status> statuses =
+      db_->MultiGet(rocksdb::ReadOptions(), key_slices, &values);
+
+  rocksdb::WriteBatch batch;
+  for (size_t i = 0; i < logids.size(); ++i) {
+    if (!statuses[i].ok() && !statuses[i].IsNotFound()) {
+      ld_error("Failed to read metadata of log %lu: %s",
+               logids[i].val_,
+               statuses[i].ToString().c_str());
+      err = E::FAILED;
+      return -1;
+    }
+    auto log_metadata = LogMetaData::forNewLog(logids[i]);
+    auto zrq = std::unique_ptr<ZookeeperEpochStoreRequest>(
+        new EpochMetaDataZRQ(logids[i],
+                             [](auto, auto, auto, auto) {},
+                             provisioner,
+                             MetaDataTracer(),
+                             WriteNodeID::NO,
+                             config_->get(),
+                             folly::none));
+    std::string new_value;
+    int rv = applyRequest(zrq,
+                          statuses[i].ok() ? &values[i] : nullptr,
+                          log_metadata,
+                          &new_value);
+    if (rv != 0) {
+      if (err == E::UPTODATE) {
+        continue;
+      }
+      ld_error("Failed to provision initial metadata log for log %lu: "
+               "error code %s",
+               logids[i].val_,
+               error_name(err));
+      return -1;
+    }
+    batch.Put(keys[i], new_value);
+  }
+
+  rocksdb::WriteOptions write_options;
+  write_options.sync = true;
+  rocksdb::Status status = db_->Write(write_options, &batch);
+  if (!status.ok()) {
+    ld_error("Failed to write provisioned metadata of %zu logs: %s",
+             static_cast<size_t>(batch.Count()),
+             status.ToString().c_str());
+    err = E::FAILED;
+    return -1;
+  }
+  return 0;
+}
+
+int RocksDBEpochStore::applyRequest(
+    std::unique_ptr<ZookeeperEpochStoreRequest>& zrq,
+    const std::string* value,
+    LogMetaData& log_metadata,
+    std::string* out) {
+  if (value) {
+    auto deserialization_st =
+        zrq->deserializeLogMetaData(*value, log_metadata);
+    if (deserialization_st != E::OK) {
+      RATELIMIT_ERROR(std::chrono::seconds(1),
+                      1,
+                      "Failed to deserialize log metadata for log %lu",
+                      zrq->logid_.val_);
+      err = deserialization_st;
+      return -1;
+    }
+  }
+
+  auto next_step = zrq->applyChanges(log_metadata, value != nullptr);
+
+  switch (next_step) {
+    case ZookeeperEpochStoreRequest::NextStep::PROVISION:
+    case ZookeeperEpochStoreRequest::NextStep::MODIFY:
+      break;
+    case ZookeeperEpochStoreRequest::NextStep::STOP:
+      ld_check(
+          (dynamic_cast<GetLastCleanEpochZRQ*>(zrq.get()) && err == E::OK) ||
+          (dynamic_cast<EpochMetaDataZRQ*>(zrq.get()) && err == E::UPTODATE));
+      return -1;
+    case ZookeeperEpochStoreRequest::NextStep::FAILED:
+      return -1;
+  }
+
+  // Increment version and timestamp of log metadata.
+  log_metadata.touch();
+
+  {
+    // Still needed as it can modify the LogMetaData, see
+    // FileEpochStore::updateEpochStore().
+    char znode_value[EpochStoreEpochMetaDataFormat::BUFFER_LEN_MAX];
+    zrq->composeZnodeValue(log_metadata, znode_value, sizeof(znode_value));
+  }
+
+  *out = zrq->serializeLogMetaData(log_metadata);
+  return 0;
+}
+
+int RocksDBEpochStore::updateEpochStore(
+    std::unique_ptr<ZookeeperEpochStoreRequest>& zrq,
+    LogMetaData& log_metadata) {
+  const std::string key = keyForLog(zrq->logid_);
+  std::lock_guard<std::mutex> lock(lockForLog(zrq->logid_));
+
+  std::string value;
+  rocksdb::Status status = db_->Get(rocksdb::ReadOptions(), key, &value);
+  if (!status.ok() && !status.IsNotFound()) {
+    RATELIMIT_ERROR(std::chrono::seconds(1),
+                    10,
+                    "Failed to read metadata of log %lu: %s",
+                    zrq->logid_.val_,
+                    status.ToString().c_str());
+    err = E::FAILED;
+    return -1;
+  }
+
+  std::string new_value;
+  int rv = applyRequest(
+      zrq, status.ok() ? &value : nullptr, log_metadata, &new_value);
+  if (rv != 0) {
+    // A successful read-only request.
+    return err == E::OK ? 0 : -1;
+  }
+
+  // Concurrent synced writes share a WAL fsync: RocksDB groups the writes
+  // that are waiting behind the current write group into the next one.
+  rocksdb::WriteOptions write_options;
+  write_options.sync = true;
+  status = db_->Put(write_options, key, new_value);
+  if (!status.ok()) {
+    RATELIMIT_ERROR(std::chrono::seconds(1),
+                    10,
+                    "Failed to write metadata of log %lu: %s",
+                    zrq->logid_.val_,
+                    status.ToString().c_str());
+    err = E::FAILED;
+    return -1;
+  }
+  return 0;
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,120 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <array>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+#include <rocksdb/db.h>
+
+#include "logdevice/common/EpochStore.h"
+#include "logdevice/common/MetaDataTracer.h"
+#include "logdevice/common/RequestExecutor.h"
+#include "logdevice/server/epoch_store/ZookeeperEpochStoreRequest.h"
+
+/**
+ * @file  RocksDBEpochStore is an implementation of the EpochStore interface
+ *        that keeps the metadata of all logs in a local RocksDB database, one
+ *        key per log. Unlike FileEpochStore it doesn't need a file and a
+ *        flock() per log, so it's suitable for single-node setups and test
+ *        clusters with many logs.
+ */
+
+namespace facebook { namespace logdevice {
+
+class Configuration;
+
+class RocksDBEpochStore : public EpochStore, boost::noncopyable {
+ public:
+  /**
+   * @param path   directory of the RocksDB database, created if missing
+   *
+   * @throws ConstructorFailed if the database couldn't be opened, with err
+   *         set to FAILED.
+   */
+  RocksDBEpochStore(std::string path,
+                    RequestExecutor request_executor,
+                    folly::Optional<NodeID> my_node_id,
+                    std::shared_ptr<UpdateableNodesConfiguration> config);
+
+  ~RocksDBEpochStore() override;
+
+  int getLastCleanEpoch(logid_t logid, EpochStore::CompletionLCE cf) override;
+  int setLastCleanEpoch(logid_t logid,
+                        epoch_t lce,
+                        const TailRecord& tail_record,
+                        EpochStore::CompletionLCE cf) override;
+  int createOrUpdateMetaData(
+      logid_t logid,
+      std::shared_ptr<EpochMetaData::Updater> updater,
+      CompletionMetaData cf,
+      MetaDataTracer tracer,
+      WriteNodeID write_node_id = WriteNodeID::NO) override;
+
+  std::string identify() const override {
+    return std::string("rocksdb://") + path_;
+  }
+
+  /**
+   * Batched version of getLastCleanEpoch(). Reads the metadata of all logs
+   * with a single MultiGet() and calls cf once for each of them.
+   */
+  int getLastCleanEpochs(const std::vector<logid_t>& logids,
+                         EpochStore::CompletionLCE cf);
+
+  // Provisions metadata for logs in config. The metadata of all logs is read
+  // with a single MultiGet() and written with a single write batch.
+  int provisionMetaDataLogs(
+      std::shared_ptr<EpochMetaData::Updater> provision_updater,
+      std::shared_ptr<Configuration> config);
+
+ private:
+  /**
+   * Atomically executes the passed epoch store request. Return value and err
+   * are the same as for FileEpochStore::updateEpochStore().
+   */
+  int updateEpochStore(std::unique_ptr<ZookeeperEpochStoreRequest>& zrq,
+                       LogMetaData& log_metadata);
+
+  /**
+   * Applies zrq to the metadata read from the database (nullptr if the log
+   * has none yet).
+   *
+   * @return  0 and sets *out to the new serialized metadata if it must be
+   *          written, -1 otherwise with err set as for updateEpochStore().
+   */
+  int applyRequest(std::unique_ptr<ZookeeperEpochStoreRequest>& zrq,
+                   const std::string* value,
+                   LogMetaData& log_metadata,
+                   std::string* out);
+
+  static std::string keyForLog(logid_t logid);
+
+  std::mutex& lockForLog(logid_t logid);
+
+  std::string path_;
+
+  RequestExecutor request_executor_;
+  folly::Optional<NodeID> my_node_id_;
+
+  // Cluster config.
+  std::shared_ptr<UpdateableNodesConfiguration> config_;
+
+  std::unique_ptr<rocksdb::DB> db_;
+
+  // Read-modify-writes of the same log are serialized by one of these locks.
+  // Writes of different logs proceed concurrently and their WAL syncs are
+  // grouped by RocksDB.
+  std::array<std::mutex, 256> log_locks_;
+};
+
+}} // namespace facebook::logdevice
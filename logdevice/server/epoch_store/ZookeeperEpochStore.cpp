@@ -7,6 +7,7 @@
  */
 #include "logdevice/server/epoch_store/ZookeeperEpochStore.h"
 
+#include <algorithm>
 #include <cstring>
 
 #include <boost/filesystem.hpp>
@@ -244,20 +245,97 @@ void ZookeeperEpochStore::legacyWriteZnode(RequestContext&& context,
                                            std::string legacy_znode_value,
                                            zk::version_t legacy_znode_version) {
   std::string znode_path = context.zrq->getZnodePath(rootPath());
+  ZnodeWrite write{std::move(context),
+                   std::move(znode_path),
+                   std::move(legacy_znode_value),
+                   legacy_znode_version};
+  if (settings_->epoch_store_write_batch_size <= 1) {
+    setZnode(std::move(write));
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(write_batch_mutex_);
+    pending_writes_.push_back(std::move(write));
+  }
+  sendWriteBatches();
+}
+
+void ZookeeperEpochStore::setZnode(ZnodeWrite&& write) {
   // setData() below succeeds only if the current version number of
   // znode at znode_path matches the version that the znode had
   // when we read its value. Zookeeper atomically increments the version
   // number of znode on every write to that znode. If the versions do not
   // match zkSetCf() will be called with status ZBADVERSION. This ensures
   // that if our read-modify-write of znode_path succeeds, it was atomic.
-  auto cb = [this, context = std::move(context)](int res, zk::Stat) mutable {
+  auto cb = [this, context = std::move(write.context)](int res,
+                                                        zk::Stat) mutable {
     auto logid = context.zrq->logid_;
     postRequestCompletion(completionStatus(res, logid), std::move(context));
   };
-  zkclient_->setData(std::move(znode_path),
-                     std::move(legacy_znode_value),
+  zkclient_->setData(std::move(write.znode_path),
+                     std::move(write.znode_value),
                      std::move(cb),
-                     legacy_znode_version);
+                     write.znode_version);
+}
+
+void ZookeeperEpochStore::sendWriteBatches() {
+  while (true) {
+    std::vector<ZnodeWrite> batch;
+    {
+      std::lock_guard<std::mutex> lock(write_batch_mutex_);
+      if (pending_writes_.empty() ||
+          write_batches_in_flight_ >=
+              settings_->epoch_store_write_batches_in_flight) {
+        return;
+      }
+      const size_t batch_size = std::min(
+          pending_writes_.size(), settings_->epoch_store_write_batch_size);
+      batch.reserve(batch_size);
+      for (size_t i = 0; i < batch_size; ++i) {
+        batch.push_back(std::move(pending_writes_.front()));
+        pending_writes_.pop_front();
+      }
+      ++write_batches_in_flight_;
+    }
+    sendWriteBatch(std::move(batch));
+  }
+}
+
+void ZookeeperEpochStore::sendWriteBatch(std::vector<ZnodeWrite> batch) {
+  ld_check(!batch.empty());
+  // Like setData() in setZnode(), each set op only succeeds if the znode
+  // still has the version we read. A multi-op is atomic, so if any of the
+  // writes fails, none of them is applied.
+  std::vector<zk::Op> ops;
+  ops.reserve(batch.size());
+  for (const ZnodeWrite& write : batch) {
+    ops.emplace_back(ZookeeperClientBase::makeSetOp(
+        write.znode_path, write.znode_value, write.znode_version));
+  }
+  STAT_INCR(stats_, zookeeper_epoch_store_write_batches);
+
+  auto cb = [this, batch = std::move(batch)](
+                int rc, std::vector<zk::OpResponse> /* results */) mutable {
+    if (rc == ZOK) {
+      for (ZnodeWrite& write : batch) {
+        postRequestCompletion(E::OK, std::move(write.context));
+      }
+    } else {
+      // We don't know which of the writes caused the failure, let each of
+      // them find out on its own.
+      STAT_INCR(stats_, zookeeper_epoch_store_write_batches_failed);
+      for (ZnodeWrite& write : batch) {
+        setZnode(std::move(write));
+      }
+    }
+    {
+      std::lock_guard<std::mutex> lock(write_batch_mutex_);
+      ld_check(write_batches_in_flight_ > 0);
+      --write_batches_in_flight_;
+    }
+    sendWriteBatches();
+  };
+  zkclient_->multiOp(std::move(ops), std::move(cb));
 }
 
 void ZookeeperEpochStore::doubleWriteZnode(
@@ -447,6 +525,7 @@ done:
 
 void ZookeeperEpochStore::postRequestCompletion(Status st,
                                                 RequestContext&& context) {
+  const logid_t logid = context.zrq->logid_;
   if (st != E::SHUTDOWN || !shutting_down_.load()) {
     context.zrq->postCompletion(
         st, std::move(context.log_metadata), request_executor_);
@@ -456,6 +535,27 @@ void ZookeeperEpochStore::postRequestCompletion(Status st,
     // E::SHUTDOWN code if the ZookeeperClient is being destroyed due to
     // zookeeper quorum change, but the EpochStore is still there.
   }
+  onRequestDone(logid);
+}
+
+void ZookeeperEpochStore::onRequestDone(logid_t logid) {
+  logid = MetaDataLog::dataLogID(logid);
+  std::unique_ptr<ZookeeperEpochStoreRequest> next;
+  {
+    std::lock_guard<std::mutex> lock(queued_requests_mutex_);
+    auto it = queued_requests_.find(logid);
+    if (it == queued_requests_.end()) {
+      // The request was started while serialization was disabled.
+      return;
+    }
+    if (it->second.empty() || shutting_down_.load()) {
+      queued_requests_.erase(it);
+      return;
+    }
+    next = std::move(it->second.front());
+    it->second.pop_front();
+  }
+  startRequest(std::move(next));
 }
 
 folly::SemiFuture<ZookeeperEpochStore::ZnodeReadResult>
@@ -492,6 +592,27 @@ ZookeeperEpochStore::readMigrationZnode(const RequestContext& context) {
 int ZookeeperEpochStore::runRequest(
     std::unique_ptr<ZookeeperEpochStoreRequest> zrq) {
   ld_check(zrq);
+  if (settings_->epoch_store_serialize_log_requests) {
+    // Concurrent read-modify-writes of the same log would read the same
+    // znode versions, and all but one of them would fail with E::AGAIN and
+    // have to be retried by their callers. Run them one after another instead.
+    const logid_t logid = MetaDataLog::dataLogID(zrq->logid_);
+    std::lock_guard<std::mutex> lock(queued_requests_mutex_);
+    auto res = queued_requests_.emplace(
+        logid, std::deque<std::unique_ptr<ZookeeperEpochStoreRequest>>());
+    if (!res.second) {
+      STAT_INCR(stats_, zookeeper_epoch_store_requests_queued);
+      res.first->second.push_back(std::move(zrq));
+      return 0;
+    }
+  }
+  startRequest(std::move(zrq));
+  return 0;
+}
+
+void ZookeeperEpochStore::startRequest(
+    std::unique_ptr<ZookeeperEpochStoreRequest> zrq) {
+  ld_check(zrq);
   auto logid = zrq->logid_;
   RequestContext context{
       std::move(zrq),
@@ -518,8 +639,6 @@ int ZookeeperEpochStore::runRequest(
                            std::move(std::get<0>(results)).value(),
                            std::move(std::get<1>(results)).value());
       });
-
-  return 0;
 }
 
 int ZookeeperEpochStore::getLastCleanEpoch(logid_t logid, CompletionLCE cf) {
@@ -8,8 +8,12 @@
 #pragma once
 
 #include <chrono>
+#include <deque>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include <boost/noncopyable.hpp>
 #include <folly/Optional.h>
@@ -153,6 +157,31 @@ class ZookeeperEpochStore : public EpochStore, boost::noncopyable {
     RequestSettings settings;
   };
 
+  // A version-conditional write of a znode on behalf of a request.
+  struct ZnodeWrite {
+    RequestContext context;
+    std::string znode_path;
+    std::string znode_value;
+    zk::version_t znode_version;
+  };
+
+  // Writes waiting for a batch to be sent, see
+  // --epoch-store-write-batch-size. Protected by write_batch_mutex_.
+  std::deque<ZnodeWrite> pending_writes_;
+  size_t write_batches_in_flight_{0};
+  std::mutex write_batch_mutex_;
+
+  // Requests waiting for an earlier request for the same log to complete,
+  // see --epoch-store-serialize-log-requests. A log has an entry (possibly
+  // with an empty queue) iff one of its requests is in flight. Metadata logs
+  // share the entry of their data log since their znodes live under the same
+  // root. Protected by queued_requests_mutex_.
+  std::unordered_map<logid_t,
+                     std::deque<std::unique_ptr<ZookeeperEpochStoreRequest>>,
+                     logid_t::Hash>
+      queued_requests_;
+  std::mutex queued_requests_mutex_;
+
   /**
    * Run a zoo_aget() on a znode, optionally followed by a modify and a
    * version-conditional zoo_aset() of a new value into the same znode.
@@ -166,6 +195,18 @@ class ZookeeperEpochStore : public EpochStore, boost::noncopyable {
    */
   int runRequest(std::unique_ptr<ZookeeperEpochStoreRequest> zrq);
 
+  /**
+   * Reads the znodes of zrq and continues with onGetZnodeComplete(). Called
+   * by runRequest() once no other request for the same log is in flight.
+   */
+  void startRequest(std::unique_ptr<ZookeeperEpochStoreRequest> zrq);
+
+  /**
+   * Called when a request for logid completes. Starts the next queued
+   * request for the log, if any.
+   */
+  void onRequestDone(logid_t logid);
+
   /**
    * Schedules a request on the Processor after a Zookeeper modification
    * completes.
@@ -197,6 +238,14 @@ class ZookeeperEpochStore : public EpochStore, boost::noncopyable {
   void legacyWriteZnode(RequestContext&& context,
                         std::string legacy_znode_value,
                         zk::version_t legacy_znode_version);
+
+  // Writes a single znode with setData() and completes the request.
+  void setZnode(ZnodeWrite&& write);
+
+  // Sends batches of pending writes as multi-ops while there are pending
+  // writes and the limit of batches in flight isn't reached.
+  void sendWriteBatches();
+  void sendWriteBatch(std::vector<ZnodeWrite> batch);
   void doubleWriteZnode(RequestContext&& context,
                         std::string legacy_znode_value,
                         zk::version_t legacy_znode_version,
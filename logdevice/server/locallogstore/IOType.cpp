@@ -0,0 +1,28 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/server/locallogstore/IOType.h"
+
+namespace facebook { namespace logdevice {
+
+thread_local IOType ScopedIOType::current_ = IOType::NORMAL;
+
+const char* toString(IOType type) {
+  switch (type) {
+    case IOType::NORMAL:
+      return "normal";
+    case IOType::COMPACTION:
+      return "compaction";
+    case IOType::REBUILDING:
+      return "rebuilding";
+    case IOType::MAX:
+      break;
+  }
+  return "invalid";
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,62 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <cstdint>
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file
+ * What the local log store IO done by the current thread is for.
+ * RocksDBEnv uses it to pick a page cache policy for sst reads (see
+ * --rocksdb-compaction-read-cache-policy and
+ * --rocksdb-rebuilding-read-cache-policy), and to break down page cache hit
+ * stats by IO type.
+ *
+ * Set with ScopedIOType around code that does the IO. IO outside of any
+ * ScopedIOType is NORMAL.
+ */
+
+enum class IOType : uint8_t {
+  // Read path, write path and everything not covered below.
+  NORMAL = 0,
+  // Rocksdb compactions, including those LogsDB runs with CompactFiles().
+  COMPACTION,
+  // Shard scans of RebuildingReadStorageTask.
+  REBUILDING,
+
+  MAX
+};
+
+const char* toString(IOType type);
+
+class ScopedIOType {
+ public:
+  explicit ScopedIOType(IOType type) : prev_(current_) {
+    current_ = type;
+  }
+
+  ~ScopedIOType() {
+    current_ = prev_;
+  }
+
+  ScopedIOType(const ScopedIOType&) = delete;
+  ScopedIOType& operator=(const ScopedIOType&) = delete;
+
+  // IO type of the calling thread.
+  static IOType current() {
+    return current_;
+  }
+
+ private:
+  static thread_local IOType current_;
+  IOType prev_;
+};
+
+}} // namespace facebook::logdevice
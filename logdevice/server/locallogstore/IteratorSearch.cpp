@@ -7,6 +7,8 @@
  */
 #include "logdevice/server/locallogstore/IteratorSearch.h"
 
+#include <algorithm>
+
 #include "logdevice/server/locallogstore/RocksDBLocalLogStore.h"
 
 namespace facebook { namespace logdevice {
@@ -242,6 +244,62 @@ int IteratorSearch::executeWithIndex(lsn_t* result_lo, lsn_t* result_hi) {
     *result_hi = std::max(*result_hi, *result_lo + 1);
   }
 
+  if (index_type_ == FIND_TIME_INDEX &&
+      store_->getSettings()->find_time_index_scan_limit > 0) {
+    return scanBetweenIndexEntries(result_lo, result_hi);
+  }
+
+  return 0;
+}
+
+int IteratorSearch::scanBetweenIndexEntries(lsn_t* result_lo,
+                                            lsn_t* result_hi) {
+  const lsn_t first = std::max(*result_lo, lo_);
+  const lsn_t last = std::min(*result_hi == LSN_MAX ? LSN_MAX : *result_hi - 1,
+                              hi_);
+  if (first >= last) {
+    // No records between the index entries.
+    return 0;
+  }
+
+  LocalLogStore::ReadOptions options("FindTime::scanBetweenIndexEntries");
+  options.allow_blocking_io = allow_blocking_io_;
+  options.tailing = false;
+
+  auto it = std::make_unique<RocksDBLocalLogStore::CSIWrapper>(
+      store_, log_id_, options, cf_);
+
+  const size_t limit = store_->getSettings()->find_time_index_scan_limit;
+  size_t scanned = 0;
+  for (it->seek(first + 1); scanned < limit; it->next(), ++scanned) {
+    if (it->state() == IteratorState::WOULDBLOCK) {
+      ld_check(!allow_blocking_io_);
+      err = E::WOULDBLOCK;
+      return -1;
+    }
+    if (it->state() == IteratorState::AT_RECORD && it->getLSN() > last) {
+      break;
+    }
+    Evaluation ev = evaluateDatabaseResult(*it);
+    if (ev == Evaluation::ERROR) {
+      err = E::FAILED;
+      return -1;
+    }
+    if (it->state() != IteratorState::AT_RECORD) {
+      // End of log.
+      break;
+    }
+    if (ev == Evaluation::MOVE_HI) {
+      *result_hi = it->getLSN();
+      break;
+    }
+    *result_lo = it->getLSN();
+    if (std::chrono::steady_clock::now() >= deadline_) {
+      // Return what we have so far, the range is still correct.
+      break;
+    }
+  }
+
   return 0;
 }
 
@@ -82,6 +82,13 @@ class IteratorSearch {
   int executeWithBinarySearch(lsn_t* result_lo, lsn_t* result_hi);
 
   int executeWithIndex(lsn_t* result_lo, lsn_t* result_hi);
+
+  // The findTime index may be sparse (see
+  // Settings::write_find_time_index_interval), in which case the range
+  // between two consecutive index entries may contain many records. Reads up
+  // to RocksDBSettings::find_time_index_scan_limit records in
+  // (*result_lo, *result_hi) to narrow the range down.
+  int scanBetweenIndexEntries(lsn_t* result_lo, lsn_t* result_hi);
 };
 
 }} // namespace facebook::logdevice
@@ -7,8 +7,11 @@
  */
 #include "logdevice/server/locallogstore/LocalLogStore.h"
 
+#include <algorithm>
+
 #include <folly/hash/SpookyHashV2.h>
 
+#include "logdevice/common/CopySetMembership.h"
 #include "logdevice/common/LocalLogStoreRecordFormat.h"
 #include "logdevice/common/Random.h"
 #include "logdevice/common/SimpleEnumMap.h"
@@ -50,6 +53,27 @@ int LocalLogStore::findKey(logid_t /*log_id*/,
 
 void LocalLogStore::normalizeTimeRanges(RecordTimeIntervals&) const {}
 
+int LocalLogStore::updateLogMetadataBatch(
+    const std::vector<std::pair<logid_t, ComparableLogMetadata*>>& updates,
+    std::vector<Status>& statuses_out,
+    const WriteOptions& opts) {
+  statuses_out.assign(updates.size(), E::OK);
+  int rv = 0;
+  for (size_t i = 0; i < updates.size(); ++i) {
+    if (updateLogMetadata(updates[i].first, *updates[i].second, opts) != 0) {
+      statuses_out[i] =
+          err == E::UPTODATE ? E::UPTODATE : E::LOCAL_LOG_STORE_WRITE;
+      if (statuses_out[i] != E::UPTODATE) {
+        rv = -1;
+      }
+    }
+  }
+  if (rv != 0) {
+    err = E::LOCAL_LOG_STORE_WRITE;
+  }
+  return rv;
+}
+
 int LocalLogStore::registerOnFlushCallback(FlushCallback& cb) {
   std::unique_lock<std::mutex> lock(flushing_mtx_);
   ld_check(!cb.links.is_linked());
@@ -97,9 +121,8 @@ bool LocalLogStoreReadFilter::operator()(logid_t,
     // for shipping it. We should not be in the copyset.
     dd_assert(
         !scd_my_shard_id_.isValid() ||
-            std::find(copyset_original,
-                      copyset_original + copyset_size,
-                      scd_my_shard_id_) == copyset_original + copyset_size,
+            !copyset_membership::contains(
+                copyset_original, copyset_size, scd_my_shard_id_),
         "Record with DRAINED flag has copyset containing local ShardID");
     return false;
   }
@@ -108,18 +131,12 @@ bool LocalLogStoreReadFilter::operator()(logid_t,
   // least one rebuilding shard. If that's not the case, we will filter the
   // record.
   if (!required_in_copyset_.empty()) {
-    copyset_off_t i = 0;
-    for (; i < copyset_size; ++i) {
-      // We expect requried_in_copyset_ to be smaller than the size of
-      // the copyset, hence the use of std::find on a  vector instead of
-      // a std::unordered_set() here.
-      if (std::find(required_in_copyset_.begin(),
-                    required_in_copyset_.end(),
-                    copyset_original[i]) != required_in_copyset_.end()) {
-        break;
-      }
-    }
-    if (i == copyset_size) {
+    // We expect required_in_copyset_ to be small, hence the linear search
+    // instead of a std::unordered_set here.
+    if (!copyset_membership::containsAny(copyset_original,
+                                         copyset_size,
+                                         required_in_copyset_.data(),
+                                         required_in_copyset_.size())) {
       // We could not find a recipient in the copyset that's in the
       // required_in_copyset_ list, filter this record.
       return false;
@@ -143,7 +160,8 @@ bool LocalLogStoreReadFilter::operator()(logid_t,
   // Before doing the SCD calculation, prepare the effective copyset.
   const ShardID* copyset;
   copyset_custsz_t<8> copyset_reordered;
-  if (scd_copyset_reordering_ == SCDCopysetReordering::NONE) {
+  if (scd_copyset_reordering_ == SCDCopysetReordering::NONE &&
+      scd_preferred_nodes_.empty()) {
     copyset = copyset_original;
   } else {
     copyset_reordered.assign(copyset_original, copyset_original + copyset_size);
@@ -287,15 +305,31 @@ void LocalLogStoreReadFilter::applyCopysetReordering(
       break;
     }
     case SCDCopysetReordering::NONE:
-      // Asserting because we don't expect to get called but just returning in
-      // release builds is fine
-      ld_check(false);
+      // Only the client's preferred nodes are applied.
+      ld_check(!scd_preferred_nodes_.empty());
       break;
     default:
       ld_critical("Unsupported SCDCopysetReordering %d!",
                   static_cast<int>(scd_copyset_reordering_));
       std::abort();
   }
+
+  if (scd_preferred_nodes_.empty()) {
+    return;
+  }
+  // The client sends the same list to all storage shards it reads from, so
+  // this is consistent across servers as long as the list is. Nodes that are
+  // not in the list keep the order given by the reordering above.
+  auto rank = [&](const ShardID& shard) -> size_t {
+    auto it = std::find(
+        scd_preferred_nodes_.begin(), scd_preferred_nodes_.end(), shard.node());
+    return std::distance(scd_preferred_nodes_.begin(), it);
+  };
+  std::stable_sort(copyset,
+                   copyset + copyset_size,
+                   [&](const ShardID& a, const ShardID& b) {
+                     return rank(a) < rank(b);
+                   });
 }
 
 std::shared_ptr<const NodesConfiguration>
@@ -337,6 +337,11 @@ class LocalLogStore : boost::noncopyable {
     // if blocking I/O is allowed.
     bool inject_latency = false;
 
+    // If nonzero, the reader is going to scan forward through a lot of data,
+    // and the backing store may read this many bytes ahead when it has to go
+    // to disk. Makes sense only if blocking I/O is allowed.
+    size_t readahead_bytes = 0;
+
     // Only affects AllLogsIterator. If set to true, iterate over partitions
     // in reverse order. Inside each partition, still go in order of
     // *increasing* pair [log ID, LSN], and metadata+internal logs still go
@@ -410,8 +415,12 @@ class LocalLogStore : boost::noncopyable {
     // readily available in memory, we should deliver it.
     bool softLimitReached() {
       return read_record_bytes + read_csi_bytes >= max_bytes_to_read ||
-          (max_execution_time != std::chrono::milliseconds::max() &&
-           msec_since(read_start_time) >= max_execution_time.count());
+          executionTimeLimitReached();
+    }
+
+    bool executionTimeLimitReached() const {
+      return max_execution_time != std::chrono::milliseconds::max() &&
+          msec_since(read_start_time) >= max_execution_time.count();
     }
 
     bool readLimitReached() {
@@ -551,6 +560,16 @@ class LocalLogStore : boost::noncopyable {
     return WriteThrottleState::NONE;
   }
 
+  /**
+   * Graduated version of getWriteThrottleState(), see
+   * --rocksdb-predictive-write-throttling. 0 means writes aren't expected to
+   * be throttled soon, 1 means they are predicted to be stalled within the
+   * horizon. Low-priority writes are slowed down progressively in between.
+   */
+  virtual double getWritePressure() {
+    return 0;
+  }
+
   /**
    * Called once during shutdown.
    * Unblocks all current and future stallLowPriWrite() calls.
@@ -843,6 +862,27 @@ class LocalLogStore : boost::noncopyable {
                                 ComparableLogMetadata& metadata,
                                 const WriteOptions& opts = WriteOptions()) = 0;
 
+  /**
+   * Like updateLogMetadata(), for several entries at once. Stores that
+   * support it write all the updates in a single batch. The default
+   * implementation calls updateLogMetadata() for each entry.
+   *
+   * @param updates       pairs of log ID and metadata to be stored; as in
+   *                      updateLogMetadata(), metadata may be modified to
+   *                      reflect the current value in the local log store.
+   *                      The same log may appear more than once.
+   * @param statuses_out  set to the outcome for each entry of `updates`: OK,
+   *                      UPTODATE or LOCAL_LOG_STORE_WRITE, with the same
+   *                      meaning as the err set by updateLogMetadata()
+   *
+   * @return 0 if none of the entries failed with LOCAL_LOG_STORE_WRITE.
+   *         Otherwise -1 with err set to LOCAL_LOG_STORE_WRITE.
+   */
+  virtual int updateLogMetadataBatch(
+      const std::vector<std::pair<logid_t, ComparableLogMetadata*>>& updates,
+      std::vector<Status>& statuses_out,
+      const WriteOptions& opts = WriteOptions());
+
   /**
    * Option that decides whether to check seal metadata preemption for
    * PerEpochLogMetadata.
@@ -1117,12 +1157,17 @@ class LocalLogStoreReadFilter : public LocalLogStore::ReadFilter {
   // when SCDCopysetReordering::HASH_SHUFFLE_CLIENT_SEED is the active mode
   uint64_t csid_hash_pt1 = 0;
   uint64_t csid_hash_pt2 = 0;
+  // Nodes the client prefers to read from, fastest first. After
+  // `scd_copyset_reordering_' is applied, these nodes are moved to the front of
+  // the copyset, in this order.
+  std::vector<node_index_t> scd_preferred_nodes_;
   // If not null, this is the location of the client and local scd should be
   // used.
   std::unique_ptr<NodeLocation> client_location_;
 
   // When `scd_copyset_reordering_' != NONE, reorder the copyset using the
-  // chosen algorithm.  Public for testing.
+  // chosen algorithm, then move `scd_preferred_nodes_' to the front.  Public
+  // for testing.
   void applyCopysetReordering(ShardID* copyset,
                               copyset_size_t copyset_size) const;
 
@@ -0,0 +1,322 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/server/locallogstore/LogAppendMemTableRep.h"
+
+#include <algorithm>
+#include <new>
+#include <type_traits>
+
+#include "logdevice/common/checks.h"
+
+namespace facebook { namespace logdevice {
+
+class LogAppendMemTableRep::Iterator : public rocksdb::MemTableRep::Iterator {
+ public:
+  Iterator(LogAppendMemTableRep* rep, void* slot) : rep_(rep), slot_(slot) {}
+
+  ~Iterator() override {
+    // The slot may be reused as soon as it's released. This is the last
+    // thing that touches the object: members are trivially destructible and
+    // the base class destructor is empty.
+    if (slot_) {
+      rep_->releaseIteratorSlot(slot_);
+    }
+  }
+
+  bool Valid() const override {
+    return stream_ != nullptr;
+  }
+
+  const char* key() const override {
+    ld_check(Valid());
+    return entry_;
+  }
+
+  void Next() override {
+    ld_check(Valid());
+    {
+      folly::SharedMutex::ReadHolder lock(stream_->mutex);
+      relocate();
+      if (pos_ + 1 < stream_->entries.size()) {
+        entry_ = stream_->entries[++pos_];
+        return;
+      }
+    }
+    moveToFront(rep_->streamAfter(stream_->prefix));
+  }
+
+  void Prev() override {
+    ld_check(Valid());
+    {
+      folly::SharedMutex::ReadHolder lock(stream_->mutex);
+      relocate();
+      if (pos_ > 0) {
+        entry_ = stream_->entries[--pos_];
+        return;
+      }
+    }
+    moveToBack(rep_->streamBefore(stream_->prefix));
+  }
+
+  void Seek(const rocksdb::Slice& internal_key,
+            const char* /* memtable_key */) override {
+    rocksdb::Slice prefix = streamPrefix(internal_key);
+    Stream* stream = rep_->streamAtOrAfter(prefix);
+    if (stream != nullptr && rocksdb::Slice(stream->prefix) == prefix) {
+      folly::SharedMutex::ReadHolder lock(stream->mutex);
+      size_t pos = rep_->lowerBound(*stream, internal_key);
+      if (pos < stream->entries.size()) {
+        set(stream, pos);
+        return;
+      }
+      stream = rep_->streamAfter(prefix);
+    }
+    moveToFront(stream);
+  }
+
+  void SeekForPrev(const rocksdb::Slice& internal_key,
+                   const char* /* memtable_key */) override {
+    rocksdb::Slice prefix = streamPrefix(internal_key);
+    if (Stream* stream = rep_->findStream(prefix)) {
+      folly::SharedMutex::ReadHolder lock(stream->mutex);
+      const auto& entries = stream->entries;
+      // First entry > internal_key.
+      auto it = std::upper_bound(entries.begin(),
+                                 entries.end(),
+                                 internal_key,
+                                 [&](const rocksdb::Slice& k, const char* e) {
+                                   return rep_->cmp_(e, k) > 0;
+                                 });
+      if (it != entries.begin()) {
+        set(stream, it - entries.begin() - 1);
+        return;
+      }
+    }
+    moveToBack(rep_->streamBefore(prefix));
+  }
+
+  void SeekToFirst() override {
+    moveToFront(rep_->firstStream());
+  }
+
+  void SeekToLast() override {
+    moveToBack(rep_->lastStream());
+  }
+
+ private:
+  void set(Stream* stream, size_t pos) {
+    stream_ = stream;
+    pos_ = pos;
+    entry_ = stream->entries[pos];
+  }
+
+  // Inserts in the middle of the stream may have moved entry_ since we last
+  // looked. Stream mutex must be held.
+  void relocate() {
+    const auto& entries = stream_->entries;
+    if (pos_ < entries.size() && entries[pos_] == entry_) {
+      return;
+    }
+    pos_ = rep_->lowerBound(*stream_, rep_->cmp_.decode_key(entry_));
+    ld_check(pos_ < entries.size());
+    ld_check(entries[pos_] == entry_);
+  }
+
+  // Moves to the first entry of the first nonempty stream starting from
+  // `stream`. A stream may be empty if it was just created by an insert.
+  void moveToFront(Stream* stream) {
+    for (; stream != nullptr; stream = rep_->streamAfter(stream->prefix)) {
+      folly::SharedMutex::ReadHolder lock(stream->mutex);
+      if (!stream->entries.empty()) {
+        set(stream, 0);
+        return;
+      }
+    }
+    stream_ = nullptr;
+  }
+
+  void moveToBack(Stream* stream) {
+    for (; stream != nullptr; stream = rep_->streamBefore(stream->prefix)) {
+      folly::SharedMutex::ReadHolder lock(stream->mutex);
+      if (!stream->entries.empty()) {
+        set(stream, stream->entries.size() - 1);
+        return;
+      }
+    }
+    stream_ = nullptr;
+  }
+
+  LogAppendMemTableRep* rep_;
+  // Slot to return to rep_ on destruction, or nullptr if allocated with new.
+  void* slot_;
+
+  // nullptr if the iterator is not valid.
+  Stream* stream_ = nullptr;
+  // Position of entry_ in stream_->entries when we last looked.
+  size_t pos_ = 0;
+  const char* entry_ = nullptr;
+};
+
+struct LogAppendMemTableRep::IteratorSlot {
+  std::aligned_storage<sizeof(Iterator), alignof(Iterator)>::type storage;
+};
+
+LogAppendMemTableRep::LogAppendMemTableRep(
+    const rocksdb::MemTableRep::KeyComparator& cmp,
+    rocksdb::Allocator* allocator)
+    : MemTableRep(allocator), cmp_(cmp) {}
+
+LogAppendMemTableRep::~LogAppendMemTableRep() {
+  // All arena iterators must have been destroyed before the memtable.
+  ld_check(free_iterator_slots_.size() == iterator_slots_.size());
+}
+
+rocksdb::Slice
+LogAppendMemTableRep::streamPrefix(const rocksdb::Slice& internal_key) {
+  // Internal key is user key followed by 8 bytes of sequence number and type.
+  ld_check(internal_key.size() >= 8);
+  return rocksdb::Slice(
+      internal_key.data(),
+      std::min(kStreamPrefixSize, internal_key.size() - size_t(8)));
+}
+
+size_t LogAppendMemTableRep::lowerBound(
+    const Stream& stream,
+    const rocksdb::Slice& internal_key) const {
+  auto it = std::lower_bound(stream.entries.begin(),
+                             stream.entries.end(),
+                             internal_key,
+                             [&](const char* e, const rocksdb::Slice& k) {
+                               return cmp_(e, k) < 0;
+                             });
+  return it - stream.entries.begin();
+}
+
+void LogAppendMemTableRep::Insert(rocksdb::KeyHandle handle) {
+  const char* entry = static_cast<const char*>(handle);
+  Stream* stream = findOrCreateStream(streamPrefix(cmp_.decode_key(entry)));
+
+  folly::SharedMutex::WriteHolder lock(stream->mutex);
+  auto& entries = stream->entries;
+  size_t capacity_before = entries.capacity();
+  if (entries.empty() || cmp_(entries.back(), entry) < 0) {
+    entries.push_back(entry);
+  } else {
+    auto it = std::upper_bound(
+        entries.begin(), entries.end(), entry, [&](const char* a, const char* b) {
+          return cmp_(a, b) < 0;
+        });
+    entries.insert(it, entry);
+  }
+  if (entries.capacity() != capacity_before) {
+    memory_usage_.fetch_add((entries.capacity() - capacity_before) *
+                            sizeof(const char*));
+  }
+}
+
+bool LogAppendMemTableRep::Contains(const char* key) const {
+  rocksdb::Slice internal_key = cmp_.decode_key(key);
+  Stream* stream = findStream(streamPrefix(internal_key));
+  if (stream == nullptr) {
+    return false;
+  }
+  folly::SharedMutex::ReadHolder lock(stream->mutex);
+  size_t pos = lowerBound(*stream, internal_key);
+  return pos < stream->entries.size() &&
+      cmp_(stream->entries[pos], internal_key) == 0;
+}
+
+size_t LogAppendMemTableRep::ApproximateMemoryUsage() {
+  return memory_usage_.load();
+}
+
+LogAppendMemTableRep::Stream*
+LogAppendMemTableRep::findOrCreateStream(const rocksdb::Slice& prefix) {
+  Stream* stream = last_stream_.load(std::memory_order_acquire);
+  if (stream != nullptr && rocksdb::Slice(stream->prefix) == prefix) {
+    return stream;
+  }
+  stream = findStream(prefix);
+  if (stream == nullptr) {
+    folly::SharedMutex::WriteHolder lock(streams_mutex_);
+    auto& ptr = streams_[prefix.ToString()];
+    if (!ptr) {
+      ptr = std::make_unique<Stream>(prefix.ToString());
+      // Plus roughly the size of a map node.
+      memory_usage_.fetch_add(sizeof(Stream) + 4 * sizeof(void*));
+    }
+    stream = ptr.get();
+  }
+  last_stream_.store(stream, std::memory_order_release);
+  return stream;
+}
+
+LogAppendMemTableRep::Stream*
+LogAppendMemTableRep::findStream(const rocksdb::Slice& prefix) const {
+  folly::SharedMutex::ReadHolder lock(streams_mutex_);
+  auto it = streams_.find(prefix.ToString());
+  return it == streams_.end() ? nullptr : it->second.get();
+}
+
+LogAppendMemTableRep::Stream*
+LogAppendMemTableRep::streamAtOrAfter(const rocksdb::Slice& prefix) const {
+  folly::SharedMutex::ReadHolder lock(streams_mutex_);
+  auto it = streams_.lower_bound(prefix.ToString());
+  return it == streams_.end() ? nullptr : it->second.get();
+}
+
+LogAppendMemTableRep::Stream*
+LogAppendMemTableRep::streamAfter(const rocksdb::Slice& prefix) const {
+  folly::SharedMutex::ReadHolder lock(streams_mutex_);
+  auto it = streams_.upper_bound(prefix.ToString());
+  return it == streams_.end() ? nullptr : it->second.get();
+}
+
+LogAppendMemTableRep::Stream*
+LogAppendMemTableRep::streamBefore(const rocksdb::Slice& prefix) const {
+  folly::SharedMutex::ReadHolder lock(streams_mutex_);
+  auto it = streams_.lower_bound(prefix.ToString());
+  return it == streams_.begin() ? nullptr : std::prev(it)->second.get();
+}
+
+LogAppendMemTableRep::Stream* LogAppendMemTableRep::firstStream() const {
+  folly::SharedMutex::ReadHolder lock(streams_mutex_);
+  return streams_.empty() ? nullptr : streams_.begin()->second.get();
+}
+
+LogAppendMemTableRep::Stream* LogAppendMemTableRep::lastStream() const {
+  folly::SharedMutex::ReadHolder lock(streams_mutex_);
+  return streams_.empty() ? nullptr : streams_.rbegin()->second.get();
+}
+
+rocksdb::MemTableRep::Iterator*
+LogAppendMemTableRep::GetIterator(rocksdb::Arena* arena) {
+  if (arena == nullptr) {
+    return new Iterator(this, nullptr);
+  }
+  void* slot = allocateIteratorSlot();
+  return new (slot) Iterator(this, slot);
+}
+
+void* LogAppendMemTableRep::allocateIteratorSlot() {
+  std::lock_guard<std::mutex> lock(iterator_slots_mutex_);
+  if (free_iterator_slots_.empty()) {
+    iterator_slots_.push_back(std::make_unique<IteratorSlot>());
+    return &iterator_slots_.back()->storage;
+  }
+  void* slot = free_iterator_slots_.back();
+  free_iterator_slots_.pop_back();
+  return slot;
+}
+
+void LogAppendMemTableRep::releaseIteratorSlot(void* slot) {
+  std::lock_guard<std::mutex> lock(iterator_slots_mutex_);
+  free_iterator_slots_.push_back(slot);
+}
+
+}} // namespace facebook::logdevice
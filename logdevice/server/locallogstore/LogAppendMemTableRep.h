@@ -0,0 +1,158 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <folly/SharedMutex.h>
+#include <rocksdb/memtablerep.h>
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file A MemTableRep specialized for LogsDB key patterns.
+ *
+ *       Almost all keys LogDevice writes start with a one-byte key type
+ *       followed by a big-endian log id (see RocksDBKeyFormat.h), and within
+ *       a log they are written in nearly increasing order (data keys and
+ *       copyset index entries are keyed by LSN, findTime index entries by
+ *       timestamp). The default skiplist pays for the general case on every
+ *       insert: a O(log n) search over the entries of all logs, and CAS
+ *       contention between writers of unrelated logs.
+ *
+ *       This rep groups entries into streams by the first kStreamPrefixSize
+ *       bytes of the user key (i.e. key type and log id). Each stream is a
+ *       sorted vector of entries with its own lock. Inserting a key that is
+ *       greater than the last one of its stream is a push_back; out of order
+ *       keys are inserted in the middle of the vector, which is O(size of
+ *       the stream) but rare. Streams are kept in an ordered map, so that
+ *       iterating over the memtable visits streams in key order: this is
+ *       correct because the user comparator is bytewise and the stream
+ *       prefix is a prefix of every key in the stream.
+ *
+ *       Per-log scans, e.g. catch-up readers reading unflushed records, walk
+ *       a contiguous array of pointers instead of chasing skiplist nodes.
+ *
+ *       Iterators remember the entry they point to rather than only its
+ *       position, and re-locate it with a binary search if inserts shifted
+ *       the stream in the meantime. Entries are never removed, so this
+ *       always succeeds.
+ */
+
+class LogAppendMemTableRep : public rocksdb::MemTableRep {
+ public:
+  // Key type + log id.
+  static constexpr size_t kStreamPrefixSize = 9;
+
+  LogAppendMemTableRep(const rocksdb::MemTableRep::KeyComparator& cmp,
+                       rocksdb::Allocator* allocator);
+
+  ~LogAppendMemTableRep() override;
+
+  void Insert(rocksdb::KeyHandle handle) override;
+
+  // Writers to different streams only contend on the stream map lock, which
+  // is taken exclusively only when a new stream is created.
+  void InsertConcurrently(rocksdb::KeyHandle handle) override {
+    Insert(handle);
+  }
+
+  bool Contains(const char* key) const override;
+
+  size_t ApproximateMemoryUsage() override;
+
+  rocksdb::MemTableRep::Iterator* GetIterator(rocksdb::Arena* arena) override;
+
+ private:
+  class Iterator;
+  struct IteratorSlot;
+
+  struct Stream {
+    explicit Stream(std::string p) : prefix(std::move(p)) {}
+
+    const std::string prefix;
+    // Protects `entries`. Taken exclusively by inserts, shared by readers.
+    mutable folly::SharedMutex mutex;
+    // Sorted according to the memtable's KeyComparator.
+    std::vector<const char*> entries;
+  };
+
+  // Returns the stream prefix of an internal key.
+  static rocksdb::Slice streamPrefix(const rocksdb::Slice& internal_key);
+
+  // Index of the first entry of `stream` that is >= `internal_key`.
+  // Stream mutex must be held.
+  size_t lowerBound(const Stream& stream,
+                    const rocksdb::Slice& internal_key) const;
+
+  Stream* findOrCreateStream(const rocksdb::Slice& prefix);
+
+  // Lookups in the stream map. Return nullptr if there's no such stream.
+  Stream* findStream(const rocksdb::Slice& prefix) const;
+  // First stream with prefix >= `prefix`.
+  Stream* streamAtOrAfter(const rocksdb::Slice& prefix) const;
+  // First stream with prefix > `prefix`.
+  Stream* streamAfter(const rocksdb::Slice& prefix) const;
+  // Last stream with prefix < `prefix`.
+  Stream* streamBefore(const rocksdb::Slice& prefix) const;
+  Stream* firstStream() const;
+  Stream* lastStream() const;
+
+  // rocksdb requires iterators to be placed in the arena it passes to
+  // GetIterator(), but the Arena class isn't part of the public rocksdb API.
+  // Instead, arena iterators are placed in slots owned by this rep; rocksdb
+  // only calls the destructor of such iterators, which returns the slot.
+  void* allocateIteratorSlot();
+  void releaseIteratorSlot(void* slot);
+
+  const rocksdb::MemTableRep::KeyComparator& cmp_;
+
+  // Protects the structure of `streams_`. Streams are never removed.
+  mutable folly::SharedMutex streams_mutex_;
+  std::map<std::string, std::unique_ptr<Stream>> streams_;
+
+  // Stream of the last insert; consecutive inserts usually go to the same
+  // log.
+  std::atomic<Stream*> last_stream_{nullptr};
+
+  // Bytes used by the stream vectors and map. The entries themselves live in
+  // the memtable's allocator and are accounted by rocksdb.
+  std::atomic<size_t> memory_usage_{0};
+
+  std::mutex iterator_slots_mutex_;
+  std::vector<std::unique_ptr<IteratorSlot>> iterator_slots_;
+  std::vector<void*> free_iterator_slots_;
+};
+
+class LogAppendMemTableRepFactory : public rocksdb::MemTableRepFactory {
+ public:
+  using rocksdb::MemTableRepFactory::CreateMemTableRep;
+
+  rocksdb::MemTableRep*
+  CreateMemTableRep(const rocksdb::MemTableRep::KeyComparator& cmp,
+                    rocksdb::Allocator* allocator,
+                    const rocksdb::SliceTransform* /* unused */,
+                    rocksdb::Logger* /* unused */) override {
+    return new LogAppendMemTableRep(cmp, allocator);
+  }
+
+  const char* Name() const override {
+    return "LogAppendMemTableRepFactory";
+  }
+
+  bool IsInsertConcurrentlySupported() const override {
+    return true;
+  }
+};
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,243 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/server/locallogstore/LogsDBImport.h"
+
+#include <deque>
+#include <vector>
+
+#include <rocksdb/sst_file_reader.h>
+#include <rocksdb/sst_file_writer.h>
+
+#include "logdevice/common/LocalLogStoreRecordFormat.h"
+#include "logdevice/common/Metadata.h"
+#include "logdevice/common/debug.h"
+#include "logdevice/server/locallogstore/LocalLogStore.h"
+#include "logdevice/server/locallogstore/RocksDBKeyFormat.h"
+#include "logdevice/server/locallogstore/WriteOps.h"
+
+namespace facebook { namespace logdevice {
+
+using RocksDBKeyFormat::DataKey;
+
+LogsDBImportFileWriter::LogsDBImportFileWriter() = default;
+LogsDBImportFileWriter::~LogsDBImportFileWriter() = default;
+
+int LogsDBImportFileWriter::open(const std::string& path) {
+  writer_ = std::make_unique<rocksdb::SstFileWriter>(rocksdb::EnvOptions(),
+                                                     rocksdb::Options());
+  rocksdb::Status status = writer_->Open(path);
+  if (!status.ok()) {
+    ld_error("Failed to create import file %s: %s",
+             path.c_str(),
+             status.ToString().c_str());
+    writer_.reset();
+    err = E::FILE_OPEN;
+    return -1;
+  }
+  return 0;
+}
+
+int LogsDBImportFileWriter::add(logid_t log_id, lsn_t lsn, Slice record) {
+  ld_check(writer_);
+  if (LocalLogStoreRecordFormat::checkWellFormed(record) != 0) {
+    err = E::INVALID_PARAM;
+    return -1;
+  }
+  DataKey key(log_id, lsn);
+  rocksdb::Status status = writer_->Put(
+      key.sliceForWriting(),
+      rocksdb::Slice(reinterpret_cast<const char*>(record.data), record.size));
+  if (!status.ok()) {
+    // SstFileWriter rejects keys that aren't increasing.
+    err = status.IsInvalidArgument() ? E::INVALID_PARAM
+                                     : E::LOCAL_LOG_STORE_WRITE;
+    return -1;
+  }
+  return 0;
+}
+
+int LogsDBImportFileWriter::finish() {
+  ld_check(writer_);
+  rocksdb::Status status = writer_->Finish();
+  writer_.reset();
+  if (!status.ok()) {
+    ld_error("Failed to write import file: %s", status.ToString().c_str());
+    err = E::LOCAL_LOG_STORE_WRITE;
+    return -1;
+  }
+  return 0;
+}
+
+namespace {
+
+// A record read from the import file, with the buffers its PutWriteOp points
+// into.
+struct ImportedRecord {
+  std::string blob;
+  std::string csi_entry;
+  PutWriteOp op;
+};
+
+} // namespace
+
+int importLogsDBFile(LocalLogStore& store,
+                     const std::string& path,
+                     size_t batch_size,
+                     bool write_find_time_index,
+                     LogsDBImportStats* stats_out) {
+  ld_check(batch_size > 0);
+  ld_check(stats_out);
+
+  rocksdb::SstFileReader reader{rocksdb::Options()};
+  rocksdb::Status status = reader.Open(path);
+  if (!status.ok()) {
+    ld_error("Failed to open import file %s: %s",
+             path.c_str(),
+             status.ToString().c_str());
+    err = E::FILE_OPEN;
+    return -1;
+  }
+  std::unique_ptr<rocksdb::Iterator> it(
+      reader.NewIterator(rocksdb::ReadOptions()));
+
+  // Stable addresses, PutWriteOps point into the strings.
+  std::deque<ImportedRecord> batch;
+  auto write_batch = [&] {
+    if (batch.empty()) {
+      return 0;
+    }
+    std::vector<const WriteOp*> ops;
+    ops.reserve(batch.size());
+    for (const auto& r : batch) {
+      ops.push_back(&r.op);
+    }
+    store.stallLowPriWrite();
+    int rv = store.writeMulti(ops);
+    if (rv == 0) {
+      for (const auto& r : batch) {
+        ++stats_out->records;
+        stats_out->bytes += r.blob.size();
+      }
+    }
+    batch.clear();
+    return rv;
+  };
+
+  logid_t cur_log = LOGID_INVALID;
+  lsn_t trim_point = LSN_INVALID;
+  for (it->SeekToFirst(); it->Valid(); it->Next()) {
+    rocksdb::Slice key = it->key();
+    if (!DataKey::valid(key.data(), key.size())) {
+      ld_error(
+          "Import file %s has an entry that is not a record", path.c_str());
+      err = E::MALFORMED_RECORD;
+      return -1;
+    }
+    logid_t log_id = DataKey::getLogID(key.data());
+    lsn_t lsn = DataKey::getLSN(key.data());
+
+    if (log_id != cur_log) {
+      cur_log = log_id;
+      TrimMetadata trim_metadata;
+      int rv = store.readLogMetadata(log_id, &trim_metadata);
+      if (rv == 0) {
+        trim_point = trim_metadata.trim_point_;
+      } else if (err == E::NOTFOUND) {
+        trim_point = LSN_INVALID;
+      } else {
+        return -1;
+      }
+    }
+    if (lsn <= trim_point) {
+      ++stats_out->skipped_trimmed;
+      continue;
+    }
+
+    batch.emplace_back();
+    ImportedRecord& r = batch.back();
+    r.blob = it->value().ToString();
+    Slice blob(r.blob.data(), r.blob.size());
+
+    std::chrono::milliseconds timestamp;
+    LocalLogStoreRecordFormat::flags_t flags;
+    uint32_t wave;
+    copyset_size_t copyset_size;
+    std::vector<ShardID> copyset(COPYSET_SIZE_MAX);
+    std::map<KeyType, std::string> optional_keys;
+    int rv = LocalLogStoreRecordFormat::parse(blob,
+                                              &timestamp,
+                                              nullptr,
+                                              &flags,
+                                              &wave,
+                                              &copyset_size,
+                                              copyset.data(),
+                                              copyset.size(),
+                                              nullptr,
+                                              &optional_keys,
+                                              nullptr,
+                                              store.getShardIdx());
+    if (rv != 0 || LocalLogStoreRecordFormat::checkWellFormed(blob) != 0) {
+      ld_error("Malformed record %lu%s in import file %s",
+               log_id.val_,
+               lsn_to_string(lsn).c_str(),
+               path.c_str());
+      err = E::MALFORMED_RECORD;
+      return -1;
+    }
+    Slice csi_entry = LocalLogStoreRecordFormat::formCopySetIndexEntry(
+        wave,
+        copyset.data(),
+        copyset_size,
+        folly::Optional<lsn_t>(LSN_INVALID),
+        LocalLogStoreRecordFormat::formCopySetIndexFlags(flags),
+        &r.csi_entry);
+
+    std::vector<std::pair<char, std::string>> index_key_list;
+    if (write_find_time_index) {
+      uint64_t timestamp_big_endian = htobe64(timestamp.count());
+      index_key_list.emplace_back(
+          FIND_TIME_INDEX,
+          std::string(reinterpret_cast<const char*>(&timestamp_big_endian),
+                      sizeof(uint64_t)));
+    }
+    auto findkey = optional_keys.find(KeyType::FINDKEY);
+    if (findkey != optional_keys.end()) {
+      index_key_list.emplace_back(FIND_KEY_INDEX, std::move(findkey->second));
+    }
+
+    // The blob is the whole record, header and payload.
+    r.op = PutWriteOp(log_id,
+                      lsn,
+                      blob,
+                      Slice(),
+                      folly::none,
+                      folly::Optional<lsn_t>(LSN_INVALID),
+                      csi_entry,
+                      std::move(index_key_list),
+                      Durability::ASYNC_WRITE,
+                      /* is_rebuilding */ true);
+
+    if (batch.size() >= batch_size && write_batch() != 0) {
+      return -1;
+    }
+  }
+  if (!it->status().ok()) {
+    ld_error("Failed to read import file %s: %s",
+             path.c_str(),
+             it->status().ToString().c_str());
+    err = E::FILE_READ;
+    return -1;
+  }
+  if (write_batch() != 0) {
+    return -1;
+  }
+  // Records that weren't ingested as sst files are only in the WAL.
+  return store.sync(Durability::ASYNC_WRITE);
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,107 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "logdevice/common/Slice.h"
+#include "logdevice/include/types.h"
+
+namespace rocksdb {
+class SstFileWriter;
+}
+
+namespace facebook { namespace logdevice {
+
+class LocalLogStore;
+
+/**
+ * @file Bulk import of records that already have LSNs and copysets, e.g.
+ *       historical data migrated from another system, without going through
+ *       sequencers.
+ *
+ *       A tool writes the records into an import file with
+ *       LogsDBImportFileWriter: an sst file mapping DataKey to the record
+ *       blob in LocalLogStoreRecordFormat, as stored in LogsDB. Each storage
+ *       node then loads the files for its shards with importLogsDBFile()
+ *       (admin command `logsdb import`).
+ *
+ *       Records are written as rebuilding records. They go to the partitions
+ *       matching their timestamps, prepended if needed, with directory,
+ *       copyset index and index entries as for any other write. With
+ *       --rocksdb-rebuilding-ingest-min-records set, batches for old
+ *       partitions are ingested as sst files instead of going through the
+ *       memtables, so that imports are bound by disk bandwidth.
+ *
+ *       Only records are imported. Epoch metadata can be imported as records
+ *       of the metadata logs. Trim points are left alone: records at or
+ *       below the trim point of their log are skipped.
+ */
+
+class LogsDBImportFileWriter {
+ public:
+  LogsDBImportFileWriter();
+  ~LogsDBImportFileWriter();
+
+  /**
+   * @return 0 on success, -1 with err = FILE_OPEN on failure.
+   */
+  int open(const std::string& path);
+
+  /**
+   * Adds a record. Records must be added in order of increasing
+   * (log_id, lsn).
+   *
+   * @param record  record header formed by
+   *                LocalLogStoreRecordFormat::formRecordHeader(), followed by
+   *                the payload.
+   *
+   * @return 0 on success, -1 with err set to INVALID_PARAM if the record is
+   *         out of order or malformed, or to LOCAL_LOG_STORE_WRITE.
+   */
+  int add(logid_t log_id, lsn_t lsn, Slice record);
+
+  /**
+   * Writes out the file. Must be called after the last add().
+   *
+   * @return 0 on success, -1 with err = LOCAL_LOG_STORE_WRITE on failure.
+   */
+  int finish();
+
+ private:
+  std::unique_ptr<rocksdb::SstFileWriter> writer_;
+};
+
+struct LogsDBImportStats {
+  size_t records = 0;
+  size_t bytes = 0;
+  // Records at or below the trim point of their log.
+  size_t skipped_trimmed = 0;
+};
+
+/**
+ * Writes the records of the import file at `path` to `store`, `batch_size`
+ * records per writeMulti() call.
+ *
+ * @param write_find_time_index  whether to write findTime index entries, see
+ *                               Settings::write_find_time_index.
+ *
+ * @return 0 on success. -1 on failure, with err set to FILE_OPEN or
+ *         FILE_READ, MALFORMED_RECORD if the file has something other than
+ *         well-formed records, or the error of writeMulti(). The records
+ *         written before the failure stay; importing the file again is
+ *         fine.
+ */
+int importLogsDBFile(LocalLogStore& store,
+                     const std::string& path,
+                     size_t batch_size,
+                     bool write_find_time_index,
+                     LogsDBImportStats* stats_out);
+
+}} // namespace facebook::logdevice
@@ -9,13 +9,17 @@
 
 #include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <cstdlib>
 #include <iterator>
 #include <list>
+#include <numeric>
 
+#include <boost/filesystem.hpp>
 #include <folly/Conv.h>
 #include <folly/Likely.h>
 #include <folly/Optional.h>
+#include <folly/executors/thread_factory/NamedThreadFactory.h>
 #include <folly/hash/Hash.h>
 #include <rocksdb/cache.h>
 #include <rocksdb/compaction_filter.h>
@@ -34,6 +38,7 @@
 #include "logdevice/common/util.h"
 #include "logdevice/server/ServerProcessor.h"
 #include "logdevice/server/locallogstore/IOTracing.h"
+#include "logdevice/server/locallogstore/IOType.h"
 #include "logdevice/server/locallogstore/MemtableFlushedRequest.h"
 #include "logdevice/server/locallogstore/PartitionedRocksDBStoreFindKey.h"
 #include "logdevice/server/locallogstore/PartitionedRocksDBStoreFindTime.h"
@@ -366,6 +371,18 @@ void PartitionedRocksDBStore::init(const Configuration* config) {
   data_cf_options_.level0_stop_writes_trigger = 1 << 29;
   data_cf_options_.disable_auto_compactions = true;
 
+  // Cold partitions are compacted into a second path, see
+  // getCompactionOutputPathId(). New files (flushes) always go to the first
+  // one. rocksdb finds files in either path when reading.
+  const std::string& cold_path = getSettings()->partition_cold_path_;
+  if (!cold_path.empty()) {
+    auto shard_dir = boost::filesystem::path(db_path_).filename();
+    data_cf_options_.cf_paths = {
+        {db_path_, std::numeric_limits<uint64_t>::max()},
+        {(boost::filesystem::path(cold_path) / shard_dir).string(),
+         std::numeric_limits<uint64_t>::max()}};
+  }
+
   // Metadata column family, on the other hand, gets compacted and can have a
   // dedicated block cache. Partition directory is usually small, and 100%
   // cache hit ratio is expected most of the time. If someone accidentally
@@ -426,6 +443,15 @@ void PartitionedRocksDBStore::init(const Configuration* config) {
     }
   }
 
+  if ((getSettings()->iterator_parallel_seek_partitions > 1 ||
+       getSettings()->findkey_parallel_probes > 1) &&
+      getSettings()->iterator_parallel_seek_threads > 0) {
+    seek_probe_executor_ = std::make_unique<folly::CPUThreadPoolExecutor>(
+        getSettings()->iterator_parallel_seek_threads,
+        std::make_shared<folly::NamedThreadFactory>(
+            "ld:s" + std::to_string(getShardIdx()) + ":probe"));
+  }
+
   if (!getSettings()->read_only) {
     startBackgroundThreads();
     // Register flush callback
@@ -619,7 +645,7 @@ bool PartitionedRocksDBStore::open(
         name,
         name == METADATA_CF_NAME ? meta_cf_options
                                  : name == UNPARTITIONED_CF_NAME
-                ? rocksdb::ColumnFamilyOptions(rocksdb_config_.options_)
+                ? rocksdb_config_.getUnpartitionedCFOptions()
                 : name == SNAPSHOTS_CF_NAME
                     ? rocksdb::ColumnFamilyOptions(rocksdb_config_.options_)
                     : data_cf_options_);
@@ -728,8 +754,8 @@ bool PartitionedRocksDBStore::open(
 
   // Column family for unpartitioned logs behaves like RocksDBLocalLogStore.
   if (!unpartitioned_cf_ && !getSettings()->read_only) {
-    unpartitioned_cf_ =
-        createColumnFamily(UNPARTITIONED_CF_NAME, rocksdb_config_.options_);
+    unpartitioned_cf_ = createColumnFamily(
+        UNPARTITIONED_CF_NAME, rocksdb_config_.getUnpartitionedCFOptions());
   }
   if (!unpartitioned_cf_) {
     ld_error("Couldn't find/create unpartitioned column family");
@@ -1936,6 +1962,7 @@ PartitionedRocksDBStore::getWritePartition(
     STAT_INCR(stats_, logsdb_writes_dir_key_decrease);
 
     // Apply same as above in in-memory directory metadata
+    invalidateDirectoryIndex(log_state);
     auto hint_it = log_directory.erase(next_it);
     current_partition =
         &log_directory.emplace_hint(hint_it, lsn, new_next_partition)->second;
@@ -1967,6 +1994,7 @@ PartitionedRocksDBStore::getWritePartition(
     STAT_INCR(stats_, logsdb_writes_dir_key_add);
 
     // Add to in-memory directory metadata
+    invalidateDirectoryIndex(log_state);
     current_partition =
         &log_directory.emplace_hint(next_it, lsn, new_partition)->second;
     if (target_partition > max_used_partition) {
@@ -2394,6 +2422,51 @@ int PartitionedRocksDBStore::dataSize(logid_t log_id,
   return 0;
 }
 
+std::shared_ptr<const PartitionedRocksDBStore::DirectoryIndex>
+PartitionedRocksDBStore::getDirectoryIndex(LogState* log_state) const {
+  if (log_state->directory_index != nullptr) {
+    return log_state->directory_index;
+  }
+  const auto& log_directory = log_state->directory;
+  if (log_directory.empty()) {
+    return nullptr;
+  }
+
+  const size_t bytes = sizeof(DirectoryIndex) +
+      log_directory.size() * (sizeof(lsn_t) + sizeof(partition_id_t));
+  const size_t budget = getSettings()->directory_index_memory_budget;
+  if (directory_index_bytes_.load() + bytes > budget) {
+    STAT_INCR(stats_, logsdb_directory_index_over_budget);
+    return nullptr;
+  }
+
+  auto index = std::make_shared<DirectoryIndex>();
+  index->first_lsns.reserve(log_directory.size());
+  index->partition_ids.reserve(log_directory.size());
+  for (const auto& kv : log_directory) {
+    index->first_lsns.push_back(kv.first);
+    index->partition_ids.push_back(kv.second.id);
+  }
+  ld_check(std::is_sorted(
+      index->partition_ids.begin(), index->partition_ids.end()));
+
+  directory_index_bytes_ += index->memoryUsage();
+  STAT_INCR(stats_, logsdb_directory_index_rebuilds);
+  log_state->directory_index = std::move(index);
+  return log_state->directory_index;
+}
+
+void PartitionedRocksDBStore::invalidateDirectoryIndex(
+    LogState* log_state) const {
+  if (log_state->directory_index == nullptr) {
+    return;
+  }
+  // Readers may still hold a reference to the index, but it's short lived, so
+  // it's fine to stop counting it towards the budget right away.
+  directory_index_bytes_ -= log_state->directory_index->memoryUsage();
+  log_state->directory_index.reset();
+}
+
 bool PartitionedRocksDBStore::isLogEmpty(logid_t log_id,
                                          bool ignore_pseudorecords) const {
   auto logs_it = logs_.find(log_id.val_);
@@ -2660,7 +2733,14 @@ bool PartitionedRocksDBStore::shouldCreatePartition() {
 
     if (now >= partition->starting_timestamp &&
         now - partition->starting_timestamp >= partition_duration) {
-      return true;
+      // If the shard got few writes during the lifetime of this partition,
+      // let it cover a longer time range and don't create small partitions
+      // that each cost a column family. Same limit as above.
+      if (partition_limit_crossed ||
+          now - partition->starting_timestamp >= partition_duration * 3 ||
+          !isPartitionQuiet(partition)) {
+        return true;
+      }
     }
   }
 
@@ -2679,6 +2759,20 @@ bool PartitionedRocksDBStore::shouldCreatePartition() {
   return false;
 }
 
+bool PartitionedRocksDBStore::isPartitionQuiet(PartitionPtr partition) {
+  const size_t min_size = getSettings()->partition_duration_trigger_min_size_;
+  if (min_size == 0) {
+    return false;
+  }
+  // Include memtables: a partition that received little data may not have
+  // been flushed at all.
+  rocksdb::ColumnFamilyHandle* cf = partition->cf_->get();
+  RocksDBMemTableStats mem = getMemTableStats(cf);
+  uint64_t size = getApproximatePartitionSize(cf) + mem.active_memtable_size +
+      mem.immutable_memtable_size;
+  return size < min_size;
+}
+
 int PartitionedRocksDBStore::writeMulti(
     const std::vector<const WriteOp*>& writes_in,
     const WriteOptions& options) {
@@ -2820,6 +2914,77 @@ int PartitionedRocksDBStore::writeMulti(
   return rv;
 }
 
+void PartitionedRocksDBStore::ingestRebuildingWrites(
+    const std::vector<std::pair<PartitionPtr, size_t>>& rebuilding_writes,
+    std::vector<const WriteOp*>& writes,
+    std::vector<RocksDBCFPtr>& cf_ptrs,
+    std::vector<DirtyOp>& dirty_ops) {
+  const size_t min_records = getSettings()->rebuilding_ingest_min_records_;
+
+  std::map<partition_id_t, std::pair<PartitionPtr, std::vector<size_t>>>
+      by_partition;
+  for (const auto& w : rebuilding_writes) {
+    auto& entry = by_partition[w.first->id_];
+    entry.first = w.first;
+    entry.second.push_back(w.second);
+  }
+
+  std::vector<bool> ingested(writes.size(), false);
+  bool ingested_any = false;
+  for (const auto& kv : by_partition) {
+    const PartitionPtr& partition = kv.second.first;
+    const std::vector<size_t>& indices = kv.second.second;
+    if (indices.size() < min_records) {
+      continue;
+    }
+    std::vector<const PutWriteOp*> puts;
+    puts.reserve(indices.size());
+    for (size_t idx : indices) {
+      puts.push_back(static_cast<const PutWriteOp*>(writes[idx]));
+    }
+    std::string sst_path = folly::sformat("{}/rebuilding-ingest-{}-{}.sst",
+                                          db_path_,
+                                          partition->id_,
+                                          next_ingested_file_id_++);
+    // The partition can't be dropped while writeMultiImpl() holds the lock of
+    // an older or the same partition.
+    int rv = writer_->ingestPuts(puts, partition->cf_->get(), sst_path);
+    if (rv != 0) {
+      continue;
+    }
+    for (size_t idx : indices) {
+      // The records are in a synced sst file already, no need to track them
+      // as dirty.
+      writes[idx]->increaseDurabilityTo(Durability::SYNC_WRITE);
+      ingested[idx] = true;
+    }
+    ingested_any = true;
+  }
+  if (!ingested_any) {
+    return;
+  }
+
+  // Dirty ops are only made for writes below SYNC_WRITE, so the ones that
+  // are SYNC_WRITE now are the ingested ones.
+  dirty_ops.erase(std::remove_if(dirty_ops.begin(),
+                                 dirty_ops.end(),
+                                 [&](const DirtyOp& op) {
+                                   return op.write_op->durability() ==
+                                       Durability::SYNC_WRITE;
+                                 }),
+                  dirty_ops.end());
+  size_t j = 0;
+  for (size_t i = 0; i < writes.size(); ++i) {
+    if (!ingested[i]) {
+      writes[j] = writes[i];
+      cf_ptrs[j] = std::move(cf_ptrs[i]);
+      ++j;
+    }
+  }
+  writes.resize(j);
+  cf_ptrs.resize(j);
+}
+
 int PartitionedRocksDBStore::writeMultiImpl(
     const std::vector<const WriteOp*>& writes_in,
     const WriteOptions& options,
@@ -2867,6 +3032,12 @@ int PartitionedRocksDBStore::writeMultiImpl(
   // are leaving this RocksDB instance "dirty".
   std::vector<DirtyOp> dirty_ops;
 
+  // Rebuilding records for old partitions, with their index in `writes`.
+  // See ingestRebuildingWrites().
+  std::vector<std::pair<PartitionPtr, size_t>> rebuilding_writes;
+  const bool ingest_rebuilding =
+      getSettings()->rebuilding_ingest_min_records_ > 0;
+
   // Tasks to queue for WAL sync after partition timestamp updates.
   std::vector<std::unique_ptr<Partition::TimestampUpdateTask>>
       timestamp_update_tasks;
@@ -2916,8 +3087,16 @@ int PartitionedRocksDBStore::writeMultiImpl(
     return true;
   };
 
+  // Check all records of the batch at once, which is faster than one by one.
+  const bool verify_checksums = getSettings()->verify_checksum_during_store;
+  std::vector<int> well_formed;
+  if (verify_checksums) {
+    well_formed = RocksDBWriter::checkRecordsWellFormed(writes_in);
+  }
+
   ld_spew("------------- Write Batch Begin --------------");
-  for (const auto write : writes_in) {
+  for (size_t write_idx = 0; write_idx < writes_in.size(); ++write_idx) {
+    const WriteOp* write = writes_in[write_idx];
     // When testing, we may want to ignore rebuilding related writes.
     if (skip_rebuilding && write->getType() == WriteType::PUT &&
         static_cast<const PutWriteOp*>(write)->isRebuilding()) {
@@ -2931,11 +3110,10 @@ int PartitionedRocksDBStore::writeMultiImpl(
       case WriteType::PUT:
         // Verify checksums before attempting to actually write the records,
         // so that a corrupt record does not affect log state or directory.
-        if (getSettings()->verify_checksum_during_store) {
+        if (verify_checksums) {
           // Reject to store malformed records.
           const PutWriteOp* op = static_cast<const PutWriteOp*>(write);
-          int rv = LocalLogStoreRecordFormat::checkWellFormed(
-              op->record_header, op->data);
+          int rv = well_formed[write_idx];
           if (rv != 0) {
             RATELIMIT_ERROR(
                 std::chrono::seconds(10),
@@ -3117,6 +3295,12 @@ int PartitionedRocksDBStore::writeMultiImpl(
 
         cf_ptr = partition->cf_;
 
+        if (ingest_rebuilding && write->getType() == WriteType::PUT &&
+            static_cast<const PutWriteOp*>(write)->isRebuilding() &&
+            partition->id_ + 1 < latest_partition_id) {
+          rebuilding_writes.emplace_back(partition, writes.size());
+        }
+
         // Complain about suspicious writes.
         if (write->getType() != WriteType::PUT ||
             !(static_cast<const PutWriteOp*>(write))->isRebuilding()) {
@@ -3213,6 +3397,10 @@ int PartitionedRocksDBStore::writeMultiImpl(
   ld_check_eq(*min_target_partition_est, min_target_partition->id_);
   ld_check(!min_target_partition->is_dropped);
 
+  if (!rebuilding_writes.empty()) {
+    ingestRebuildingWrites(rebuilding_writes, writes, cf_ptrs, dirty_ops);
+  }
+
   // Go over all holders and mark beginning of write on the partition.
   std::vector<rocksdb::ColumnFamilyHandle*> cf_handles;
   cf_handles.reserve(cf_ptrs.size());
@@ -4054,6 +4242,48 @@ std::string PartitionedRocksDBStore::PartitionToCompact::toString() const {
   return s;
 }
 
+std::string PartitionedRocksDBStore::PendingCompaction::toString() const {
+  std::string s = folly::sformat(
+      "#{} {}", position, PartitionToCompact::reasonNames()[reason]);
+  if (postponed_by != nullptr) {
+    s += folly::sformat(" (postponed by {})", postponed_by);
+  }
+  return s;
+}
+
+std::map<partition_id_t, PartitionedRocksDBStore::PendingCompaction>
+PartitionedRocksDBStore::getPendingCompactions() const {
+  std::lock_guard<std::mutex> lock(pending_compactions_mutex_);
+  return pending_compactions_;
+}
+
+folly::Optional<std::chrono::microseconds>
+PartitionedRocksDBStore::getRecentSstReadLatency() {
+  if (!statistics_) {
+    return folly::none;
+  }
+  rocksdb::HistogramData data;
+  statistics_->histogramData(rocksdb::SST_READ_MICROS, &data);
+  uint64_t count = data.count - last_sst_read_count_;
+  uint64_t sum = data.sum - last_sst_read_micros_sum_;
+  last_sst_read_count_ = data.count;
+  last_sst_read_micros_sum_ = data.sum;
+  if (count == 0) {
+    return folly::none;
+  }
+  return std::chrono::microseconds(sum / count);
+}
+
+uint64_t PartitionedRocksDBStore::estimateCompactionCost(
+    const PartitionToCompact& to_compact) const {
+  if (to_compact.reason == PartitionToCompact::Reason::PARTIAL) {
+    return std::accumulate(to_compact.partial_compaction_file_sizes.begin(),
+                           to_compact.partial_compaction_file_sizes.end(),
+                           uint64_t(0));
+  }
+  return getApproximatePartitionSize(to_compact.partition->cf_->get());
+}
+
 bool PartitionedRocksDBStore::PartialCompactionEvaluator::evaluateAll(
     std::vector<PartitionToCompact>* out_to_compact,
     size_t max_results) {
@@ -4264,10 +4494,48 @@ void PartitionedRocksDBStore::getPartitionsForProactiveCompaction(
         partition->last_compaction_time == RecordTimestamp::min()) {
       out_to_compact->emplace_back(
           partition, PartitionToCompact::Reason::PROACTIVE);
+    } else if (getCompactionOutputPathId(partition) != 0 &&
+               hasFilesOutsideColdPath(partition)) {
+      // Move the partition to the cold path.
+      out_to_compact->emplace_back(
+          partition, PartitionToCompact::Reason::PROACTIVE);
     }
   }
 }
 
+uint32_t PartitionedRocksDBStore::getCompactionOutputPathId(
+    const PartitionPtr& partition) {
+  if (data_cf_options_.cf_paths.size() < 2) {
+    return 0;
+  }
+  // Never move the two latest partitions, they're likely still written to.
+  if (partition->id_ + 1 >= latest_.get()->id_) {
+    return 0;
+  }
+  RecordTimestamp max_ts = partition->max_timestamp.load();
+  if (max_ts != RecordTimestamp::min() &&
+      currentTime() - max_ts < getSettings()->partition_cold_age_) {
+    return 0;
+  }
+  return 1;
+}
+
+bool PartitionedRocksDBStore::hasFilesOutsideColdPath(
+    const PartitionPtr& partition) {
+  ld_check(data_cf_options_.cf_paths.size() >= 2);
+  const std::string& cold_path = data_cf_options_.cf_paths[1].path;
+  rocksdb::ColumnFamilyMetaData meta;
+  db_->GetColumnFamilyMetaData(partition->cf_->get(), &meta);
+  for (const auto& level : meta.levels) {
+    for (const auto& file : level.files) {
+      if (file.db_path != cold_path) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
 bool PartitionedRocksDBStore::getPartitionsForManualCompaction(
     std::vector<PartitionToCompact>* out_to_compact,
     size_t count,
@@ -4490,12 +4758,24 @@ int PartitionedRocksDBStore::trimLogsBasedOnTime(
   };
   std::map<std::chrono::seconds, DataForBacklogDuration> backlog_durations;
 
+  // Approximate size of records in each non-latest partition, in total and
+  // for logs that are trimmed in it. Only computed if
+  // partition_compaction_min_reclaim_ratio is set.
+  struct PartitionSizes {
+    size_t total_bytes = 0;
+    size_t trimmed_bytes = 0;
+  };
+  std::unordered_map<partition_id_t, PartitionSizes> partition_sizes;
+
   const partition_id_t latest = latest_.get()->id_;
   const auto partitions = partitions_.getVersion();
   const partition_id_t oldest_existing = partitions->firstID();
   const auto settings = getSettings();
   const auto now = currentTime().toSeconds();
   partition_id_t oldest_to_keep = latest;
+  const bool track_sizes = out_to_compact != nullptr &&
+      (settings->partition_compaction_min_reclaim_ratio > 0 ||
+       settings->partition_compaction_order_by_reclaim);
 
   PartitionDirectoryIterator iterator(*this);
   while (iterator.nextLog()) {
@@ -4587,6 +4867,14 @@ int PartitionedRocksDBStore::trimLogsBasedOnTime(
                cutoff_timestamp)) {
         // This is first partition that has non-trimmed records for this log.
         oldest_to_keep = std::min(oldest_to_keep, partition);
+        if (track_sizes) {
+          // The rest of the directory entries of this log only contribute
+          // to partition sizes.
+          do {
+            partition_sizes[iterator.getPartitionID()].total_bytes +=
+                iterator.getApproximateSizeBytes();
+          } while (iterator.nextPartition());
+        }
         break;
       }
 
@@ -4595,6 +4883,11 @@ int PartitionedRocksDBStore::trimLogsBasedOnTime(
           partition < duration_data->oldest_non_trimmed) {
         duration_data->partitions_with_trimmed_records.insert(partition);
       }
+      if (track_sizes) {
+        auto& sizes = partition_sizes[partition];
+        sizes.total_bytes += iterator.getApproximateSizeBytes();
+        sizes.trimmed_bytes += iterator.getApproximateSizeBytes();
+      }
     }
 
     if (new_trim_point > existing_trim_point) {
@@ -4643,6 +4936,22 @@ int PartitionedRocksDBStore::trimLogsBasedOnTime(
   }
 
   if (out_to_compact != nullptr) {
+    // Returns true if compacting the partition would reclaim too little space
+    // to be worth rewriting the rest of it.
+    auto too_little_to_reclaim = [&](partition_id_t partition) {
+      if (!track_sizes) {
+        return false;
+      }
+      auto it = partition_sizes.find(partition);
+      if (it == partition_sizes.end() || it->second.total_bytes == 0) {
+        // No size estimates. Compact as usual.
+        return false;
+      }
+      return it->second.trimmed_bytes <
+          settings->partition_compaction_min_reclaim_ratio *
+          it->second.total_bytes;
+    };
+
     for (auto& it : backlog_durations) {
       // Advise compacting those partitions for which all records for logs with
       // this backlog duration have been marked as trimmed.
@@ -4651,7 +4960,20 @@ int PartitionedRocksDBStore::trimLogsBasedOnTime(
         ld_check_lt(partition, it.second.oldest_non_trimmed);
         if (partition >= oldest_to_keep &&
             partitions->get(partition)->compacted_retention.load() < it.first) {
-          out_to_compact->emplace_back(partitions->get(partition), it.first);
+          if (too_little_to_reclaim(partition)) {
+            // compacted_retention stays as is, so the compaction will be
+            // reconsidered once more logs are trimmed from the partition.
+            STAT_INCR(stats_, partition_retention_compactions_skipped);
+            continue;
+          }
+          PartitionToCompact to_compact(partitions->get(partition), it.first);
+          auto sizes = partition_sizes.find(partition);
+          if (sizes != partition_sizes.end()) {
+            to_compact.estimated_bytes = sizes->second.total_bytes;
+            to_compact.estimated_reclaimable_bytes =
+                sizes->second.trimmed_bytes;
+          }
+          out_to_compact->push_back(std::move(to_compact));
         }
       }
     }
@@ -4811,23 +5133,26 @@ void PartitionedRocksDBStore::performCompactionInternal(
       if (to_compact.reason == PartitionToCompact::Reason::PARTIAL) {
         SCOPED_IO_TRACING_CONTEXT(
             getIOTracing(), "part-compact|cf:{}", partition->id_);
+        // CompactFiles() runs the compaction on this thread.
+        ScopedIOType io_type(IOType::COMPACTION);
         rocksdb::CompactionOptions options;
         options.compression = rocksdb_config_.options_.compression;
 
         status = db_->CompactFiles(options,
                                    partition->cf_->get(),
                                    to_compact.partial_compaction_filenames,
-                                   0 /* L0 */);
+                                   0 /* L0 */,
+                                   getCompactionOutputPathId(partition));
       } else {
         // This context currently doesn't do anything because full compactions
         // run on background threads. But let's keep it in case this changes.
         SCOPED_IO_TRACING_CONTEXT(
             getIOTracing(), "full-compact|cf:{}", partition->id_);
 
-        status = db_->CompactRange(rocksdb::CompactRangeOptions(),
-                                   partition->cf_->get(),
-                                   nullptr,
-                                   nullptr);
+        rocksdb::CompactRangeOptions options;
+        options.target_path_id = getCompactionOutputPathId(partition);
+        status = db_->CompactRange(
+            options, partition->cf_->get(), nullptr, nullptr);
       }
     }
 
@@ -5019,8 +5344,12 @@ bool PartitionedRocksDBStore::performStronglyFilteredCompactionInternal(
 
     SCOPED_IO_TRACING_CONTEXT(
         getIOTracing(), "filter-compact|cf:{}", partition->id_);
-    status = db_->CompactFiles(
-        options, partition->cf_->get(), files_to_compact, 0 /* L0 */);
+    ScopedIOType io_type(IOType::COMPACTION);
+    status = db_->CompactFiles(options,
+                               partition->cf_->get(),
+                               files_to_compact,
+                               0 /* L0 */,
+                               getCompactionOutputPathId(partition));
   }
 
   if (!status.ok()) {
@@ -5237,6 +5566,7 @@ void PartitionedRocksDBStore::cleanUpDirectory(
         // Delete the directory entry.
         batch.Delete(metadata_cf_->get(), it.key());
         // From in-memory directory as well
+        invalidateDirectoryIndex(log_state);
         in_memory_directory_it =
             log_state->directory.erase(in_memory_directory_it);
 
@@ -5989,6 +6319,19 @@ int PartitionedRocksDBStore::flushUnpartitionedMemtables(bool wait) {
 }
 
 int PartitionedRocksDBStore::flushAllMemtables(bool wait) {
+  if (wait) {
+    // Waiting for each flush before requesting the next one would flush the
+    // partitions one at a time. Request all of them first, so that they run
+    // concurrently on RocksDB's flush threads, whose number bounds the IO
+    // spent on them; then wait for them below. The second Flush() of a column
+    // family only waits for the flush requested here, unless new writes came
+    // in since.
+    int rv = flushAllMemtables(/* wait */ false);
+    if (rv != 0) {
+      return rv;
+    }
+  }
+
   if (latest_.get()) {
     auto partitions = getPartitionList();
     for (PartitionPtr partition : *partitions) {
@@ -6169,6 +6512,9 @@ void PartitionedRocksDBStore::loPriBackgroundThreadRun() {
       // no retention-based compactions
       to_compact.clear();
     }
+    if (getSettings()->partition_compaction_order_by_reclaim) {
+      PartitionToCompact::sortByReclaimRatio(&to_compact);
+    }
 
     SteadyTimestamp now = currentSteadyTime();
     SteadyTimestamp avoid_drops_until = avoid_drops_until_;
@@ -6203,6 +6549,7 @@ void PartitionedRocksDBStore::loPriBackgroundThreadRun() {
     // stall rebuilding.
     bool need_stall = max_pending_partial_compactions != 0 &&
         partial_compactions.size() >= max_pending_partial_compactions;
+    num_pending_partial_compactions_.store(partial_compactions.size());
     bool needed_stall = too_many_partial_compactions_.load();
     if (need_stall != needed_stall) {
       too_many_partial_compactions_.store(need_stall);
@@ -6275,6 +6622,50 @@ void PartitionedRocksDBStore::loPriBackgroundThreadRun() {
         shard_idx_,
         num_partial_compactions + num_partial_compactions_postponed);
 
+    {
+      std::lock_guard<std::mutex> lock(pending_compactions_mutex_);
+      pending_compactions_.clear();
+      for (size_t i = 0; i < to_compact.size(); ++i) {
+        const auto& p = to_compact[i];
+        pending_compactions_.emplace(
+            p.partition->id_,
+            PendingCompaction{i, p.reason, p.estimated_reclaimable_bytes});
+      }
+    }
+    auto postpone = [&](const PartitionToCompact& p, const char* by) {
+      std::lock_guard<std::mutex> lock(pending_compactions_mutex_);
+      auto it = pending_compactions_.find(p.partition->id_);
+      if (it != pending_compactions_.end()) {
+        it->second.postponed_by = by;
+      }
+    };
+
+    const rate_limit_t io_budget =
+        getSettings()->partition_compaction_io_budget;
+    if (io_budget != compaction_io_budget_limit_) {
+      compaction_io_budget_.update(io_budget);
+      compaction_io_budget_limit_ = io_budget;
+    }
+
+    // Back off if reads on this shard got slow. Compactions compete with them
+    // for disk IO, and usually can wait.
+    const std::chrono::microseconds max_read_latency =
+        getSettings()->partition_compaction_backoff_read_latency;
+    bool back_off = false;
+    if (max_read_latency.count() > 0) {
+      auto read_latency = getRecentSstReadLatency();
+      back_off = read_latency.has_value() && *read_latency > max_read_latency;
+      if (back_off) {
+        RATELIMIT_INFO(std::chrono::seconds(10),
+                       1,
+                       "Shard %u: postponing compactions because average sst "
+                       "read latency is %ldus, above %ldus",
+                       shard_idx_,
+                       read_latency->count(),
+                       max_read_latency.count());
+      }
+    }
+
     auto compactions_start_time = currentTime();
 
     compactMetadataCFIfNeeded();
@@ -6292,7 +6683,26 @@ void PartitionedRocksDBStore::loPriBackgroundThreadRun() {
         skip_sleep = true;
         break;
       }
+      // Manual compactions were explicitly requested, don't delay them.
+      if (p.reason != PartitionToCompact::Reason::MANUAL) {
+        if (back_off) {
+          postpone(p, "read latency");
+          PER_SHARD_STAT_INCR(
+              stats_, partition_compactions_postponed_read_latency, shard_idx_);
+          continue;
+        }
+        if (!compaction_io_budget_.isAllowed(estimateCompactionCost(p))) {
+          postpone(p, "io budget");
+          PER_SHARD_STAT_INCR(
+              stats_, partition_compactions_postponed_io_budget, shard_idx_);
+          continue;
+        }
+      }
       first = false;
+      {
+        std::lock_guard<std::mutex> lock(pending_compactions_mutex_);
+        pending_compactions_.erase(p.partition->id_);
+      }
       performCompactionInternal(p);
       // The list of partitions to compact can be merged above, but partition
       // compactions with type MANUAL should always take precedence over all
@@ -6394,7 +6804,8 @@ void PartitionedRocksDBStore::flushBackgroundThreadRun() {
                              flush_trigger,
                              max_individual_memtable_size,
                              low_watermark,
-                             getRocksDBLogStoreConfig());
+                             getRocksDBLogStoreConfig(),
+                             flushTriggerScale());
 
     std::vector<FlushEvaluator::CFData> non_zero_size_cf;
     FlushEvaluator::CFData metadata_cf_data{
@@ -6461,6 +6872,11 @@ void PartitionedRocksDBStore::flushBackgroundThreadRun() {
       bytes_written_since_flush_eval_.fetch_sub(bytes_since_prev_eval);
       last_flush_eval_stats_ = buf_stats;
       throttleIOIfNeeded(buf_stats, memory_limit);
+      updateWritePressure(
+          buf_stats,
+          memory_limit,
+          num_pending_partial_compactions_.load(),
+          getSettings()->partition_partial_compaction_stall_trigger_);
     }
 
     update_stats(buf_stats);
@@ -6680,6 +7096,20 @@ uint64_t PartitionedRocksDBStore::getTotalTrashSize() {
       : 0;
 }
 
+double PartitionedRocksDBStore::flushTriggerScale() const {
+  double spread = getSettings()->flush_trigger_spread;
+  ServerProcessor* processor = processor_.load();
+  if (spread <= 0 || !processor) {
+    return 1.0;
+  }
+  // Fractional parts of multiples of the golden ratio are evenly distributed
+  // in [0, 1) for any number of consecutive indices.
+  uint64_t key =
+      uint64_t(processor->getMyNodeID().index()) * num_shards_ + shard_idx_;
+  double phase = std::fmod(key * 0.6180339887498949, 1.0);
+  return 1.0 - spread * phase;
+}
+
 std::vector<CFData>
 FlushEvaluator::pickCFsToFlush(SteadyTimestamp now,
                                CFData& metadata_cf_data,
@@ -6689,6 +7119,12 @@ FlushEvaluator::pickCFsToFlush(SteadyTimestamp now,
   bool ld_managed_flushes = rocksdb_config_.use_ld_managed_flushes_;
   const auto use_age_size_flush_heuristic =
       settings->use_age_size_flush_heuristic;
+  const auto data_age_flush_trigger =
+      std::chrono::duration_cast<std::chrono::milliseconds>(
+          settings->partition_data_age_flush_trigger * time_trigger_scale_);
+  const auto idle_flush_trigger =
+      std::chrono::duration_cast<std::chrono::milliseconds>(
+          settings->partition_idle_flush_trigger * time_trigger_scale_);
   std::vector<CFData> out;
 
   // Total memory picked for flushing.
@@ -6767,18 +7203,17 @@ FlushEvaluator::pickCFsToFlush(SteadyTimestamp now,
     auto oldDataThresholdTriggered = [&] {
       auto& cf = cf_data.cf;
       SteadyTimestamp first_dirtied_time = cf->first_dirtied_time_;
-      return settings->partition_data_age_flush_trigger.count() > 0 &&
+      return data_age_flush_trigger.count() > 0 &&
           first_dirtied_time != SteadyTimestamp::min() &&
-          (now - first_dirtied_time) >
-          settings->partition_data_age_flush_trigger;
+          (now - first_dirtied_time) > data_age_flush_trigger;
     };
 
     auto idleThresholdTriggered = [&] {
       auto& latest_dirty_time = cf_data.latest_dirty_time;
-      return (settings->partition_idle_flush_trigger.count() > 0) &&
+      return (idle_flush_trigger.count() > 0) &&
           (latest_dirty_time != SteadyTimestamp::min()) &&
           (now > latest_dirty_time) &&
-          (now - latest_dirty_time) > settings->partition_idle_flush_trigger;
+          (now - latest_dirty_time) > idle_flush_trigger;
     };
 
     // We try to pick to flush those CFs that we cannot ignore:
@@ -12,6 +12,7 @@
 #include <chrono>
 #include <deque>
 #include <limits>
+#include <map>
 #include <mutex>
 #include <thread>
 #include <vector>
@@ -20,6 +21,7 @@
 #include <folly/SharedMutex.h>
 #include <folly/ThreadLocal.h>
 #include <folly/concurrency/ConcurrentHashMap.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <rocksdb/db.h>
 #include <rocksdb/iterator.h>
 #include <rocksdb/merge_operator.h>
@@ -28,6 +30,7 @@
 #include "logdevice/common/MetaDataLog.h"
 #include "logdevice/common/Metadata.h"
 #include "logdevice/common/RandomAccessQueue.h"
+#include "logdevice/common/RateLimiter.h"
 #include "logdevice/common/SingleEvent.h"
 #include "logdevice/common/Timestamp.h"
 #include "logdevice/common/UpdateableSharedPtr.h"
@@ -465,6 +468,10 @@ class PartitionedRocksDBStore : public RocksDBLogStoreBase {
                    std::chrono::steady_clock::time_point::max()) const override;
 
   // Approximate size of the data in the given log between the two timestamps.
+  // Only reads the log's in-memory directory: each entry has the number of
+  // payload bytes written to the log in the partition, counted at write time
+  // and persisted with the directory. Partitions partially covered by the
+  // time range are counted in proportion to the covered time. Does no IO.
   int dataSize(logid_t log_id,
                RecordTimestamp lo,
                RecordTimestamp hi,
@@ -819,6 +826,13 @@ class PartitionedRocksDBStore : public RocksDBLogStoreBase {
     std::vector<std::string> partial_compaction_filenames;
     std::vector<uint64_t> partial_compaction_file_sizes;
 
+    // If reason == RETENTION, estimated size of the partition and of the
+    // records of trimmed logs in it, according to partition directory.
+    // Only set if rocksdb-partition-compaction-min-reclaim-ratio or
+    // rocksdb-partition-compaction-order-by-reclaim is set, zero otherwise.
+    size_t estimated_bytes{0};
+    size_t estimated_reclaimable_bytes{0};
+
     PartitionToCompact(PartitionPtr p, Reason r)
         : partition(std::move(p)), reason(r) {
       ld_check(reason != Reason::RETENTION);
@@ -924,12 +938,47 @@ class PartitionedRocksDBStore : public RocksDBLogStoreBase {
       }
     }
 
+    // Stable-sorts compactions by the estimated fraction of the partition
+    // they reclaim, highest first. Compactions without estimates go last.
+    static void sortByReclaimRatio(std::vector<PartitionToCompact>* ps) {
+      ld_check(ps);
+      auto ratio = [](const PartitionToCompact& p) {
+        return p.estimated_bytes == 0
+            ? -1.
+            : 1. * p.estimated_reclaimable_bytes / p.estimated_bytes;
+      };
+      std::stable_sort(
+          ps->begin(),
+          ps->end(),
+          [&](const PartitionToCompact& a, const PartitionToCompact& b) {
+            return ratio(a) > ratio(b);
+          });
+    }
+
     std::string toString() const;
 
    private:
     size_t sort_order;
   };
 
+  // A compaction in the queue of the lo-pri background thread, as of its
+  // latest iteration. Reported by admin command "info partitions".
+  struct PendingCompaction {
+    // Position in the queue, 0 is the first compaction to run.
+    size_t position;
+    PartitionToCompact::Reason reason;
+    // See PartitionToCompact.
+    size_t estimated_reclaimable_bytes;
+    // Why the compaction was postponed, if it was.
+    const char* postponed_by = nullptr;
+
+    std::string toString() const;
+  };
+
+  // Returns the compactions that the lo-pri background thread planned in its
+  // latest iteration and hasn't done yet, by partition.
+  std::map<partition_id_t, PendingCompaction> getPendingCompactions() const;
+
   class PartialCompactionEvaluator {
    public:
     class Deps {
@@ -1074,13 +1123,16 @@ class PartitionedRocksDBStore : public RocksDBLogStoreBase {
                    uint64_t total_active_memory_trigger,
                    uint64_t max_memtable_size_trigger,
                    uint64_t total_active_low_watermark,
-                   const RocksDBLogStoreConfig& rocksdb_config)
+                   const RocksDBLogStoreConfig& rocksdb_config,
+                   double time_trigger_scale = 1.0)
         : shard_idx_(shard_idx),
           total_active_memory_trigger_(total_active_memory_trigger),
           max_memtable_size_trigger_(max_memtable_size_trigger),
           total_active_low_watermark_(total_active_low_watermark),
-          rocksdb_config_(rocksdb_config) {
+          rocksdb_config_(rocksdb_config),
+          time_trigger_scale_(time_trigger_scale) {
       ld_check(total_active_memory_trigger >= total_active_low_watermark);
+      ld_check(time_trigger_scale > 0 && time_trigger_scale <= 1);
     }
 
     ~FlushEvaluator() {}
@@ -1152,6 +1204,9 @@ class PartitionedRocksDBStore : public RocksDBLogStoreBase {
     const uint64_t max_memtable_size_trigger_;
     const uint64_t total_active_low_watermark_;
     const RocksDBLogStoreConfig& rocksdb_config_;
+    // Multiplier applied to the data age and idle flush triggers. See
+    // flushTriggerScale().
+    const double time_trigger_scale_;
     WriteBufStats buf_stats_;
   };
 
@@ -1188,6 +1243,24 @@ class PartitionedRocksDBStore : public RocksDBLogStoreBase {
   class FindTime;
   class FindKey;
 
+  // Compact, cache-friendly copy of the keys of LogState::directory: first_lsn
+  // and partition ID of each directory entry, in two parallel vectors sorted
+  // by first_lsn (and therefore by partition ID too). Immutable once built, so
+  // it can be binary searched without holding LogState::mutex.
+  struct DirectoryIndex {
+    std::vector<lsn_t> first_lsns;
+    std::vector<partition_id_t> partition_ids;
+
+    size_t size() const {
+      return first_lsns.size();
+    }
+    size_t memoryUsage() const {
+      return sizeof(DirectoryIndex) +
+          first_lsns.capacity() * sizeof(lsn_t) +
+          partition_ids.capacity() * sizeof(partition_id_t);
+    }
+  };
+
   struct LogState {
     // This struct is poor man's atomic<tuple<partition_id_t, lsn_t, lsn_t>>.
     // It maintains a partition ID and corresponding min and max LSNs, making
@@ -1239,6 +1312,12 @@ class PartitionedRocksDBStore : public RocksDBLogStoreBase {
 
     // Information about partitions used by this log, keyed by their first_lsn
     std::map<lsn_t, DirectoryEntry> directory;
+
+    // Index over the keys of `directory`, built lazily by getDirectoryIndex().
+    // Reset by invalidateDirectoryIndex() whenever directory entries are
+    // added, removed or have their first_lsn changed. Updates of max_lsn,
+    // flags and size don't invalidate it.
+    std::shared_ptr<const DirectoryIndex> directory_index;
   };
 
   using LogStateMap = folly::ConcurrentHashMap<logid_t::raw_type,
@@ -1247,6 +1326,18 @@ class PartitionedRocksDBStore : public RocksDBLogStoreBase {
 
   using LogLocks = FixedKeysMap<logid_t, std::unique_lock<std::mutex>>;
 
+  // Returns the DirectoryIndex of the given log, building it if needed.
+  // Must be called with locked log_state->mutex. Returns nullptr if the log
+  // has no directory entries, or if building the index would exceed
+  // --rocksdb-directory-index-memory-budget.
+  std::shared_ptr<const DirectoryIndex>
+  getDirectoryIndex(LogState* log_state) const;
+
+  // Drops the DirectoryIndex of the given log, if any. Must be called with
+  // locked log_state->mutex after changing the set of keys in
+  // log_state->directory.
+  void invalidateDirectoryIndex(LogState* log_state) const;
+
   // Opens the RocksDB instance. Called by the constructor.
   bool open(const std::vector<std::string>& column_families,
             const rocksdb::ColumnFamilyOptions& meta_cf_options,
@@ -1447,6 +1538,18 @@ class PartitionedRocksDBStore : public RocksDBLogStoreBase {
                      partition_id_t* min_target_partition    // in and out
   );
 
+  // Part of writeMultiImpl(). `rebuilding_writes` are indices in `writes` of
+  // rebuilding records going to partitions other than the two latest. If a
+  // partition has at least rebuilding_ingest_min_records_ of them, they are
+  // ingested into it as an sst file, promoted to SYNC_WRITE and removed from
+  // `writes`, `cf_ptrs` and `dirty_ops`. Partitions whose ingestion fails are
+  // left to the normal write path.
+  void ingestRebuildingWrites(
+      const std::vector<std::pair<PartitionPtr, size_t>>& rebuilding_writes,
+      std::vector<const WriteOp*>& writes,
+      std::vector<RocksDBCFPtr>& cf_ptrs,
+      std::vector<DirtyOp>& dirty_ops);
+
   // Returns an iterator over the metadata column family.
   RocksDBIterator createMetadataIterator(bool allow_blocking_io = true) const;
 
@@ -1515,10 +1618,28 @@ class PartitionedRocksDBStore : public RocksDBLogStoreBase {
   // Can be PARTITION_INVALID if nothing should be dopped.
   partition_id_t findObsoletePartitions();
 
-  // Gets partitions to compact based on proactive_compaction_enabled.
+  // Gets partitions to compact based on proactive_compaction_enabled, and
+  // cold partitions that still have files outside the cold path.
   void getPartitionsForProactiveCompaction(
       std::vector<PartitionToCompact>* out_to_compact);
 
+  // Index in data_cf_options_.cf_paths where compactions of the partition
+  // should put their output: 1 (the cold path) if it's configured and the
+  // partition's records are older than partition_cold_age_, 0 otherwise.
+  uint32_t getCompactionOutputPathId(const PartitionPtr& partition);
+
+  // True if some sst files of the partition aren't in the cold path.
+  bool hasFilesOutsideColdPath(const PartitionPtr& partition);
+
+  // Average latency of sst file reads since the previous call, according to
+  // rocksdb statistics. folly::none if statistics are disabled or there were
+  // no reads. Only called from the lo-pri background thread.
+  folly::Optional<std::chrono::microseconds> getRecentSstReadLatency();
+
+  // Estimated number of bytes that the compaction will read and write, for
+  // rocksdb-partition-compaction-io-budget.
+  uint64_t estimateCompactionCost(const PartitionToCompact& to_compact) const;
+
   // Gets partitions for partial compaction. Returns true if there are more
   // partial compactions to be done than the results added
   bool getPartitionsForPartialCompaction(
@@ -1667,6 +1788,15 @@ class PartitionedRocksDBStore : public RocksDBLogStoreBase {
 
   void flushBackgroundThreadRun();
 
+  // Returns the factor by which this shard's data age and idle flush triggers
+  // are shortened, in (1 - rocksdb-flush-trigger-spread, 1]. Replicas of a
+  // record receive it at about the same time, so with equal triggers they
+  // all flush the same partitions in the same evaluation round, and STOREs
+  // see the IO burst on the whole copyset at once. The factor is a
+  // deterministic function of node and shard index, spread evenly over the
+  // range, so that different nodes' flushes of the same data are staggered.
+  double flushTriggerScale() const;
+
   // Locked when creating/dropping partitions at the beginning of partition
   // list.
   mutable std::mutex oldest_partition_mutex_;
@@ -1736,6 +1866,23 @@ class PartitionedRocksDBStore : public RocksDBLogStoreBase {
 
   // If true, stall low-pri writes to wait for partial compactions to catch up.
   std::atomic<bool> too_many_partial_compactions_{false};
+  // How many partial compactions the lo-pri thread found last time, capped
+  // at the stall trigger. Used for write pressure.
+  std::atomic<size_t> num_pending_partial_compactions_{0};
+
+  // Compactions planned by the lo-pri thread, see getPendingCompactions().
+  mutable std::mutex pending_compactions_mutex_;
+  std::map<partition_id_t, PendingCompaction> pending_compactions_;
+
+  // Enforces rocksdb-partition-compaction-io-budget. Only used by the lo-pri
+  // thread, which also updates it when the setting changes.
+  RateLimiter compaction_io_budget_{RATE_UNLIMITED};
+  rate_limit_t compaction_io_budget_limit_{RATE_UNLIMITED};
+
+  // Sum and count of rocksdb::SST_READ_MICROS samples as of the previous
+  // call to getRecentSstReadLatency().
+  uint64_t last_sst_read_micros_sum_{0};
+  uint64_t last_sst_read_count_{0};
 
   // Approximate time when "metadata" CF was last compacted.
   SteadyTimestamp last_metadata_manual_compaction_time_;
@@ -1748,6 +1895,15 @@ class PartitionedRocksDBStore : public RocksDBLogStoreBase {
   std::mutex rebuilding_ranges_mutex_;
   RebuildingRangesVersion rebuilding_ranges_version_ = {0, 0};
 
+  // Total memoryUsage() of all DirectoryIndex objects currently referenced by
+  // LogStates.
+  mutable std::atomic<size_t> directory_index_bytes_{0};
+
+  // Used by Iterator to probe multiple partitions concurrently when seeking,
+  // and by FindKey to search the custom key directory. nullptr if parallel probing is disabled (see
+  // --rocksdb-iterator-parallel-seek-threads).
+  std::unique_ptr<folly::CPUThreadPoolExecutor> seek_probe_executor_;
+
  protected:
   enum class DeferInit {
     NO,
@@ -1765,6 +1921,9 @@ class PartitionedRocksDBStore : public RocksDBLogStoreBase {
   // bytes written since last flush evaluation
   std::atomic<uint64_t> bytes_written_since_flush_eval_{0};
 
+  // Used to name the sst files of ingestRebuildingWrites().
+  std::atomic<uint64_t> next_ingested_file_id_{0};
+
   // Protects last_flush_eval_stats_ and calls to throttleIOIfNeeded().
   // Can be locked on write path, so don't do anything slow while holding it.
   std::mutex throttle_eval_mutex_;
@@ -1829,6 +1988,10 @@ class PartitionedRocksDBStore : public RocksDBLogStoreBase {
   // latest partition is either too old or has too many L0 files.
   virtual bool shouldCreatePartition();
 
+  // True if the partition holds less than
+  // rocksdb-partition-duration-trigger-min-size bytes, counting memtables.
+  bool isPartitionQuiet(PartitionPtr partition);
+
   // Called on each iteration of each background thread. Sleeps between
   // iterations until some timeout expires or until shutdown is requested.
   // Can be mocked to control background thread from outside.
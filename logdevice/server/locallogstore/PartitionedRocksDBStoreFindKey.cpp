@@ -7,6 +7,9 @@
  */
 #include "logdevice/server/locallogstore/PartitionedRocksDBStoreFindKey.h"
 
+#include <folly/futures/Future.h>
+
+#include "logdevice/common/stats/Stats.h"
 #include "logdevice/server/locallogstore/RocksDBKeyFormat.h"
 #include "logdevice/server/locallogstore/RocksDBLocalLogStore.h"
 
@@ -68,17 +71,17 @@ int PartitionedRocksDBStore::FindKey::execute(lsn_t* lo, lsn_t* hi) {
   return 0;
 }
 
-int PartitionedRocksDBStore::FindKey::findPartitionLo(
-    PartitionPtr* out_partition_lo) {
-  ld_check(out_partition_lo != nullptr);
-
-  RocksDBIterator it = store_.createMetadataIterator(allow_blocking_io_);
+int PartitionedRocksDBStore::FindKey::probeDirectory(RocksDBIterator& it,
+                                                     partition_id_t mid,
+                                                     partition_id_t max,
+                                                     DirectoryProbe* out) {
+  ld_check(out != nullptr);
   auto it_error = [&] {
     rocksdb::Status status = it.status();
     if (status.ok()) {
       return false;
     }
-    err = status.IsIncomplete() ? E::WOULDBLOCK : E::FAILED;
+    out->status = status.IsIncomplete() ? E::WOULDBLOCK : E::FAILED;
     return true;
   };
   // Detect whether we are not in the CustomIndexDirectory for the log anymore.
@@ -95,57 +98,130 @@ int PartitionedRocksDBStore::FindKey::findPartitionLo(
     return false;
   };
 
+  out->mid = mid;
+  out->result = DirectoryProbe::NONE;
+  out->status = E::OK;
+
+  CustomIndexDirectoryKey key(logid_, FIND_KEY_INDEX, mid);
+  it.Seek(rocksdb::Slice(reinterpret_cast<const char*>(&key), sizeof(key)));
+  if (it_error()) {
+    return -1;
+  }
+
+  if (outside_dir()) {
+    return 0;
+  }
+
+  out->real_mid = CustomIndexDirectoryKey::getPartition(it.key().data());
+  if (out->real_mid > max) {
+    // There are no partitions between mid and max.
+    return 0;
+  }
+  ld_check(out->real_mid >= mid);
+
+  if (!CustomIndexDirectoryValue::valid(it.value().data(), it.value().size())) {
+    RATELIMIT_ERROR(std::chrono::seconds(1),
+                    1,
+                    "Current mid key %s is not valid",
+                    hexdump_buf(it.value().data(), it.value().size()).c_str());
+    out->status = E::FAILED;
+    return -1;
+  }
+
+  rocksdb::Slice mid_key = CustomIndexDirectoryValue::getKey(it.value().data());
+  std::string mid_key_string(mid_key.data(), mid_key.size());
+  out->result = mid_key_string.compare(key_) >= 0 ? DirectoryProbe::GEQ
+                                                  : DirectoryProbe::LESS;
+  out->lsn =
+      CustomIndexDirectoryValue::getLSN(it.value().data(), it.value().size());
+  return 0;
+}
+
+int PartitionedRocksDBStore::FindKey::findPartitionLo(
+    PartitionPtr* out_partition_lo) {
+  ld_check(out_partition_lo != nullptr);
+
+  // Each round of the search probes `num_probes` evenly spaced partitions.
+  // With more than one probe, each probe gets its own iterator and all but
+  // the first run on the store's probe executor.
+  folly::Executor* executor = store_.seek_probe_executor_.get();
+  size_t num_probes = 1;
+  if (executor != nullptr && allow_blocking_io_) {
+    num_probes =
+        std::max<size_t>(1, store_.getSettings()->findkey_parallel_probes);
+  }
+  std::vector<RocksDBIterator> iterators;
+  iterators.reserve(num_probes);
+  iterators.push_back(store_.createMetadataIterator(allow_blocking_io_));
+  std::vector<DirectoryProbe> probes;
+
   auto partitions = store_.getPartitionList();
   auto min = partitions->firstID();
   auto max = partitions->nextID() - 1;
 
   while (min <= max) {
-    const partition_id_t mid = (min + max) / 2;
+    // Pick probe points in [min, max]. With one probe it's the middle.
+    const partition_id_t span = max - min;
+    probes.clear();
+    for (size_t i = 1; i <= num_probes; ++i) {
+      partition_id_t mid = min + span * i / (num_probes + 1);
+      if (span < num_probes + 1) {
+        // Few partitions left. Avoid probing the same partition twice.
+        mid = min + std::min<partition_id_t>(i - 1, span);
+      }
+      if (probes.empty() || probes.back().mid < mid) {
+        probes.emplace_back();
+        probes.back().mid = mid;
+      }
+    }
+    while (iterators.size() < probes.size()) {
+      iterators.push_back(store_.createMetadataIterator(allow_blocking_io_));
+    }
 
-    CustomIndexDirectoryKey key(logid_, FIND_KEY_INDEX, mid);
-    it.Seek(rocksdb::Slice(reinterpret_cast<const char*>(&key), sizeof(key)));
-    if (it_error()) {
-      return -1;
+    std::vector<folly::Future<folly::Unit>> futures;
+    for (size_t i = 1; i < probes.size(); ++i) {
+      futures.push_back(folly::via(executor, [&, i] {
+        probeDirectory(iterators[i], probes[i].mid, max, &probes[i]);
+      }));
     }
+    probeDirectory(iterators[0], probes[0].mid, max, &probes[0]);
+    folly::collectAll(futures).wait();
+    STAT_INCR(store_.stats_, logsdb_findkey_directory_rounds);
+    STAT_ADD(store_.stats_, logsdb_findkey_directory_probes, probes.size());
 
-    if (outside_dir()) {
-      max = mid - 1;
-      continue;
+    for (const DirectoryProbe& probe : probes) {
+      if (probe.status != E::OK) {
+        err = probe.status;
+        return -1;
+      }
     }
 
-    auto real_mid = CustomIndexDirectoryKey::getPartition(it.key().data());
-    if (real_mid > max) {
-      // There are no partitions between mid and max, so only search between
-      // min and mid - 1.
-      max = mid - 1;
-      continue;
+    // Keys are non-decreasing with partition id, so the probe results are
+    // some LESS followed by some GEQ or NONE. The partition of the last LESS
+    // is the new lower bound, and the first probe after it the new upper
+    // bound.
+    size_t first_not_less = 0;
+    while (first_not_less < probes.size() &&
+           probes[first_not_less].result == DirectoryProbe::LESS) {
+      ++first_not_less;
     }
-    ld_check(real_mid >= mid);
-    ld_check(partitions->get(real_mid));
-
-    if (!CustomIndexDirectoryValue::valid(
-            it.value().data(), it.value().size())) {
-      RATELIMIT_ERROR(
-          std::chrono::seconds(1),
-          1,
-          "Current mid key %s is not valid",
-          hexdump_buf(it.value().data(), it.value().size()).c_str());
-      err = E::FAILED;
-      return -1;
+    if (first_not_less > 0) {
+      const DirectoryProbe& probe = probes[first_not_less - 1];
+      ld_check(partitions->get(probe.real_mid));
+      *out_partition_lo = partitions->get(probe.real_mid);
+      *lo_ = probe.lsn;
+      min = probe.real_mid + 1;
     }
-
-    rocksdb::Slice mid_key =
-        CustomIndexDirectoryValue::getKey(it.value().data());
-    std::string mid_key_string(mid_key.data(), mid_key.size());
-    if (mid_key_string.compare(key_) >= 0) {
-      *hi_ = CustomIndexDirectoryValue::getLSN(
-          it.value().data(), it.value().size());
-      max = mid - 1;
-    } else {
-      *out_partition_lo = partitions->get(real_mid);
-      *lo_ = CustomIndexDirectoryValue::getLSN(
-          it.value().data(), it.value().size());
-      min = real_mid + 1;
+    if (first_not_less < probes.size()) {
+      const DirectoryProbe& probe = probes[first_not_less];
+      if (probe.result == DirectoryProbe::GEQ) {
+        ld_check(partitions->get(probe.real_mid));
+        *hi_ = probe.lsn;
+      }
+      if (probe.mid == 0) {
+        break;
+      }
+      max = std::min(max, probe.mid - 1);
     }
   }
 
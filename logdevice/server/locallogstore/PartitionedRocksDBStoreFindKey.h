@@ -41,11 +41,42 @@ class PartitionedRocksDBStore::FindKey {
   int execute(lsn_t* lo, lsn_t* hi);
 
  private:
+  // Result of looking up the first directory entry at or after a partition.
+  struct DirectoryProbe {
+    // Partition the lookup started at.
+    partition_id_t mid;
+    // Partition of the entry found, if result != NONE.
+    partition_id_t real_mid;
+    // NONE if there's no entry in [mid, max]. Otherwise whether the entry's
+    // key is less than, or greater than or equal to, key_.
+    enum { NONE, LESS, GEQ } result;
+    // LSN of the entry found, if result != NONE.
+    lsn_t lsn;
+    // E::OK, E::FAILED or E::WOULDBLOCK. Not using `err` because probes may
+    // run on other threads.
+    Status status;
+  };
+
+  /**
+   * Seeks `it` to the first directory entry of the log in partitions
+   * [mid, max] and compares its key to key_.
+   *
+   * @return 0 on success, -1 on error with out->status set.
+   */
+  int probeDirectory(RocksDBIterator& it,
+                     partition_id_t mid,
+                     partition_id_t max,
+                     DirectoryProbe* out);
+
   /**
    * This function does a binary search on the metadata column family in order
    * to find the partition which contains the record with the LSN lo. During the
    * search, this function updates the range (lo, hi].
    *
+   * If --rocksdb-findkey-parallel-probes is greater than 1, blocking
+   * searches probe that many partitions concurrently in each round, i.e.
+   * the binary search becomes a k-ary one.
+   *
    * @param out_partition_lo On success, the PartitionPtr of the partition that
    *                         contains the lower bound is written at this memory
    *                         location.
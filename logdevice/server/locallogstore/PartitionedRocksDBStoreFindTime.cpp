@@ -7,6 +7,8 @@
  */
 #include "logdevice/server/locallogstore/PartitionedRocksDBStoreFindTime.h"
 
+#include <algorithm>
+
 #include "logdevice/common/Worker.h"
 #include "logdevice/common/util.h"
 #include "logdevice/server/locallogstore/IteratorSearch.h"
@@ -223,6 +225,10 @@ int PartitionedRocksDBStore::FindTime::findPartition(
   //         directory to get A.
   //     Set lo_ to max_lsn from A.
 
+  if (findPartitionUsingIndex(out_partition, out_first_lsn)) {
+    return 0;
+  }
+
   auto partitions = store_.getPartitionList();
   DirectoryIteratorBounds bounds(logid_);
   RocksDBIterator it =
@@ -419,6 +425,83 @@ int PartitionedRocksDBStore::FindTime::findPartition(
   return 0;
 }
 
+bool PartitionedRocksDBStore::FindTime::findPartitionUsingIndex(
+    PartitionPtr* out_partition,
+    lsn_t* out_first_lsn) const {
+  auto logs_it = store_.logs_.find(logid_.val_);
+  if (logs_it == store_.logs_.cend()) {
+    return false;
+  }
+  LogState* log_state = logs_it->second.get();
+
+  std::shared_ptr<const DirectoryIndex> index;
+  {
+    std::lock_guard<std::mutex> lock(log_state->mutex);
+    index = store_.getDirectoryIndex(log_state);
+  }
+  if (index == nullptr) {
+    return false;
+  }
+
+  // This is the same search as in findPartition() (see the comment there for
+  // partitions A, B, C and X), done on the index. Partition IDs in the index
+  // are increasing, and starting timestamps of partitions are nondecreasing,
+  // so the entries of partitions with starting_timestamp < timestamp_ form a
+  // prefix of the index. Entries of dropped partitions count as part of the
+  // prefix, entries of partitions created after this method was called don't.
+  auto partitions = store_.getPartitionList();
+  const std::vector<partition_id_t>& ids = index->partition_ids;
+  auto is_before_timestamp = [&](partition_id_t id) {
+    if (id < partitions->firstID()) {
+      return true;
+    }
+    if (id >= partitions->nextID()) {
+      return false;
+    }
+    PartitionPtr partition = partitions->get(id);
+    ld_check(partition);
+    return partition->starting_timestamp < timestamp_;
+  };
+  const size_t first_after =
+      std::partition_point(ids.begin(), ids.end(), is_before_timestamp) -
+      ids.begin();
+
+  // First entry after the prefix is C.
+  if (first_after < ids.size() && ids[first_after] < partitions->nextID()) {
+    *hi_ = std::min(*hi_, index->first_lsns[first_after]);
+  }
+
+  // Last entry of the prefix is X.
+  if (first_after == 0 || ids[first_after - 1] < partitions->firstID()) {
+    return true;
+  }
+  PartitionPtr left_partition = partitions->get(ids[first_after - 1]);
+  ld_check(left_partition);
+  ld_check(left_partition->starting_timestamp < timestamp_);
+
+  size_t a = first_after - 1;
+  PartitionPtr next_partition = partitions->get(left_partition->id_ + 1);
+  if (next_partition && next_partition->starting_timestamp < timestamp_) {
+    // 2a - left_partition is A, and B doesn't exist.
+  } else {
+    // 2b - left_partition is B, and A is the previous entry.
+    *out_partition = left_partition;
+    *out_first_lsn = index->first_lsns[a];
+    if (a == 0) {
+      return true;
+    }
+    --a;
+  }
+
+  // Get max_lsn of A. It's not in the index because it's updated on writes.
+  std::lock_guard<std::mutex> lock(log_state->mutex);
+  auto dir_it = log_state->directory.find(index->first_lsns[a]);
+  if (dir_it != log_state->directory.end() && dir_it->second.id == ids[a]) {
+    *lo_ = std::max(*lo_, dir_it->second.max_lsn);
+  }
+  return true;
+}
+
 int PartitionedRocksDBStore::FindTime::partitionSearch(
     rocksdb::ColumnFamilyHandle* cf) const {
   IteratorSearch search(&store_,
@@ -65,6 +65,17 @@ class PartitionedRocksDBStore::FindTime {
    */
   int findPartition(PartitionPtr* out_partition, lsn_t* out_first_lsn) const;
 
+  /**
+   * Same as findPartition() but uses the log's in-memory DirectoryIndex
+   * instead of reading the directory from rocksdb. Doesn't do any IO.
+   *
+   * @return  true on success, false if the index is not available (e.g. the
+   *          log is empty or the index is over memory budget), in which case
+   *          the caller should fall back to the rocksdb-based search.
+   */
+  bool findPartitionUsingIndex(PartitionPtr* out_partition,
+                               lsn_t* out_first_lsn) const;
+
   /**
    * Do a binary search or, if the findTime index is used, a seek on the given
    * column family, and update *lo_ and *hi_ with the result. Only one of *lo_
@@ -7,8 +7,11 @@
  */
 #include "logdevice/server/locallogstore/PartitionedRocksDBStoreIterators.h"
 
+#include <folly/futures/Future.h>
+
 #include "logdevice/common/debug.h"
 #include "logdevice/server/locallogstore/IOTracing.h"
+#include "logdevice/server/locallogstore/RocksDBCache.h"
 #include "logdevice/server/locallogstore/RocksDBKeyFormat.h"
 
 namespace facebook { namespace logdevice {
@@ -53,6 +56,7 @@ void PartitionedRocksDBStore::Iterator::setDataIteratorFromCurrent(
       options_.allow_copyset_index = current_.partition_->is_csi_enabled_;
       data_iterator_ = std::make_unique<RocksDBLocalLogStore::CSIWrapper>(
           pstore_, log_id_, options_, current_.partition_->cf_->get());
+      current_in_tail_ = isTailPartition(current_.partition_);
     }
     data_iterator_->min_ts_ = min_ts;
     data_iterator_->max_ts_ = max_ts;
@@ -61,6 +65,18 @@ void PartitionedRocksDBStore::Iterator::setDataIteratorFromCurrent(
   }
 }
 
+bool PartitionedRocksDBStore::Iterator::isTailPartition(
+    const PartitionPtr& partition) const {
+  const size_t num_tail_partitions =
+      pstore_->getSettings()->cache_tail_partitions_high_priority_;
+  if (num_tail_partitions == 0) {
+    return false;
+  }
+  PartitionPtr latest = pstore_->getLatestPartition();
+  return latest != nullptr &&
+      partition->id_ + num_tail_partitions > latest->id_;
+}
+
 void PartitionedRocksDBStore::Iterator::setMetaIteratorAndCurrentFromLSN(
     lsn_t lsn) {
   if (data_iterator_) {
@@ -378,6 +394,10 @@ void PartitionedRocksDBStore::Iterator::moveUntilValid(bool forward,
             !atOrphanedRecord());
 
   SCOPE_EXIT {
+    // Don't let unused probe iterators pin memtables.
+    probed_data_iterator_.reset();
+    probed_partition_.reset();
+
     ld_check(state_ != IteratorState::MAX);
     if (data_iterator_ == nullptr && current_.partition_ != nullptr) {
       // All partitions got filtered out or skipped.
@@ -386,6 +406,9 @@ void PartitionedRocksDBStore::Iterator::moveUntilValid(bool forward,
     }
   };
 
+  // Number of partitions this call has moved data_iterator_ to so far.
+  size_t partitions_visited = 0;
+
   // Move data_iterator_ from partition to partition until we find a good
   // record, or run out of partitions, or encounter an error.
   while (true) {
@@ -433,7 +456,14 @@ void PartitionedRocksDBStore::Iterator::moveUntilValid(bool forward,
     // Move meta_iterator_ and see if it still points to a directory entry.
 
     if (forward) {
-      meta_iterator_->Next();
+      // Only probe in parallel if we've already moved past a partition that
+      // turned out to have no suitable records. In the common case the very
+      // next partition has what we're looking for, and probing more
+      // partitions would be wasted work.
+      if (partitions_visited == 0 ||
+          !probePartitionsInParallel(current_lsn)) {
+        meta_iterator_->Next();
+      }
     } else if (!meta_iterator_is_at_prev) {
       meta_iterator_->Prev();
     }
@@ -493,8 +523,19 @@ void PartitionedRocksDBStore::Iterator::moveUntilValid(bool forward,
 
       // Set new_current as current_.
       setCurrent(new_current);
+      if (probed_data_iterator_ != nullptr) {
+        if (probed_partition_ == current_.partition_ && !data_iterator_) {
+          // probePartitionsInParallel() has already created and positioned
+          // an iterator in this partition. Reuse it; the seek below will be
+          // cheap since the relevant blocks were just read.
+          data_iterator_ = std::move(probed_data_iterator_);
+        }
+        probed_data_iterator_.reset();
+        probed_partition_.reset();
+      }
       setDataIteratorFromCurrent(filter);
     }
+    ++partitions_visited;
 
     if (it_stats) {
       ++it_stats->seen_logsdb_partitions;
@@ -546,6 +587,129 @@ void PartitionedRocksDBStore::Iterator::moveUntilValid(bool forward,
   }
 }
 
+bool PartitionedRocksDBStore::Iterator::probePartitionsInParallel(
+    lsn_t current_lsn) {
+  folly::Executor* executor = pstore_->seek_probe_executor_.get();
+  const size_t max_partitions =
+      pstore_->getSettings()->iterator_parallel_seek_partitions;
+  if (executor == nullptr || max_partitions < 2 ||
+      !options_.allow_blocking_io) {
+    // Non-blocking iterators are used on worker threads and only read from
+    // memory; there's nothing to gain from parallelizing them.
+    return false;
+  }
+  ld_check(meta_iterator_.has_value());
+  ld_check(latest_.partition_ != nullptr);
+
+  struct Candidate {
+    PartitionPtr partition;
+    lsn_t min_lsn;
+    lsn_t max_lsn;
+    // Declared after `partition` so that it's destroyed before the CF handle.
+    std::unique_ptr<RocksDBLocalLogStore::CSIWrapper> iterator;
+    bool has_record = false;
+  };
+
+  // Collect the upcoming directory entries for this log. Don't go past
+  // latest_, for consistency with moveUntilValid().
+  std::vector<Candidate> candidates;
+  while (candidates.size() < max_partitions) {
+    meta_iterator_->Next();
+    if (!meta_iterator_->Valid() || !meta_iterator_->status().ok()) {
+      break;
+    }
+    rocksdb::Slice key = meta_iterator_->key();
+    if (!PartitionDirectoryKey::valid(key.data(), key.size()) ||
+        PartitionDirectoryKey::getLogID(key.data()) != log_id_) {
+      break;
+    }
+    checkDirectoryValue();
+
+    Candidate c;
+    if (!pstore_->getPartition(
+            PartitionDirectoryKey::getPartition(key.data()), &c.partition)) {
+      // Partition dropped. moveUntilValid() skips such entries too.
+      STAT_INCR(pstore_->stats_, logsdb_iterator_partition_dropped);
+      continue;
+    }
+    c.min_lsn = PartitionDirectoryKey::getLSN(key.data());
+    c.max_lsn = PartitionDirectoryValue::getMaxLSN(
+        meta_iterator_->value().data(), meta_iterator_->value().size());
+    const bool reached_latest = c.partition->id_ >= latest_.partition_->id_;
+    candidates.push_back(std::move(c));
+    if (reached_latest) {
+      break;
+    }
+  }
+
+  if (candidates.empty()) {
+    // meta_iterator_ is past the last entry for this log (or has an error),
+    // and moveUntilValid() will see that.
+    return true;
+  }
+
+  auto probe = [&](Candidate& c) {
+    SCOPED_IO_TRACING_CONTEXT(store_->getIOTracing(), "p:probe");
+    LocalLogStore::ReadOptions options = options_;
+    options.allow_copyset_index = c.partition->is_csi_enabled_;
+    c.iterator = std::make_unique<RocksDBLocalLogStore::CSIWrapper>(
+        pstore_, log_id_, options, c.partition->cf_->get());
+    c.iterator->seek(std::max(current_lsn, c.min_lsn));
+    IteratorState s = c.iterator->state();
+    // Errors count as "has record" so that moveUntilValid() stops at this
+    // partition and reports the error.
+    c.has_record = s != IteratorState::AT_END &&
+        (s != IteratorState::AT_RECORD || c.iterator->getLSN() <= c.max_lsn);
+  };
+
+  // Probe the first candidate on this thread while the others are probed on
+  // the executor.
+  std::vector<folly::Future<folly::Unit>> futures;
+  futures.reserve(candidates.size() - 1);
+  for (size_t i = 1; i < candidates.size(); ++i) {
+    Candidate* c = &candidates[i];
+    futures.push_back(folly::via(executor, [&probe, c] { probe(*c); }));
+  }
+  probe(candidates[0]);
+  folly::collectAll(futures).wait();
+
+  size_t chosen = candidates.size() - 1;
+  for (size_t i = 0; i < candidates.size(); ++i) {
+    if (candidates[i].has_record) {
+      chosen = i;
+      break;
+    }
+  }
+  STAT_ADD(
+      pstore_->stats_, logsdb_iterator_partitions_probed, candidates.size());
+  STAT_ADD(
+      pstore_->stats_, logsdb_iterator_partitions_skipped_by_probe, chosen);
+
+  // Position meta_iterator_ on the chosen entry. SeekForPrev rather than Seek
+  // because the entry's min_lsn may have been decreased since we read it.
+  Candidate& c = candidates[chosen];
+  PartitionDirectoryKey key(log_id_, c.min_lsn, c.partition->id_);
+  meta_iterator_->SeekForPrev(
+      rocksdb::Slice(reinterpret_cast<const char*>(&key), sizeof(key)));
+  if (meta_iterator_->Valid() && meta_iterator_->status().ok() &&
+      current_.partition_ != nullptr) {
+    rocksdb::Slice found = meta_iterator_->key();
+    if (PartitionDirectoryKey::valid(found.data(), found.size()) &&
+        PartitionDirectoryKey::getLogID(found.data()) == log_id_ &&
+        PartitionDirectoryKey::getPartition(found.data()) ==
+            current_.partition_->id_) {
+      // The chosen entry was removed in the meantime, and we landed back on
+      // the current partition's entry.
+      meta_iterator_->Next();
+    }
+  }
+
+  probed_data_iterator_.reset();
+  probed_partition_ = c.partition;
+  probed_data_iterator_ = std::move(c.iterator);
+  return true;
+}
+
 void PartitionedRocksDBStore::Iterator::seek(lsn_t lsn,
                                              ReadFilter* filter,
                                              ReadStats* stats) {
@@ -554,6 +718,7 @@ void PartitionedRocksDBStore::Iterator::seek(lsn_t lsn,
   // Otherwise it may pin memtables indefinitely.
 
   SCOPED_IO_TRACING_CONTEXT(store_->getIOTracing(), "p:seek");
+  ScopedTailPartitionRead tail_read(&current_in_tail_);
   trackSeek(lsn, 0);
 
   // Reset sticky state on seeks.
@@ -652,6 +817,7 @@ void PartitionedRocksDBStore::Iterator::seek(lsn_t lsn,
 
 void PartitionedRocksDBStore::Iterator::seekForPrev(lsn_t lsn) {
   SCOPED_IO_TRACING_CONTEXT(store_->getIOTracing(), "p:seek-prev");
+  ScopedTailPartitionRead tail_read(&current_in_tail_);
   trackSeek(lsn, 0);
 
   // Reset sticky state on seeks.
@@ -724,6 +890,7 @@ void PartitionedRocksDBStore::Iterator::seekForPrev(lsn_t lsn) {
 void PartitionedRocksDBStore::Iterator::next(ReadFilter* filter,
                                              ReadStats* stats) {
   SCOPED_IO_TRACING_CONTEXT(store_->getIOTracing(), "p:next");
+  ScopedTailPartitionRead tail_read(&current_in_tail_);
 
   IteratorState s = state();
   ld_check_in(s, ({IteratorState::AT_RECORD, IteratorState::LIMIT_REACHED}));
@@ -757,6 +924,7 @@ void PartitionedRocksDBStore::Iterator::next(ReadFilter* filter,
 
 void PartitionedRocksDBStore::Iterator::prev() {
   SCOPED_IO_TRACING_CONTEXT(store_->getIOTracing(), "p:prev");
+  ScopedTailPartitionRead tail_read(&current_in_tail_);
   ld_assert(state() == IteratorState::AT_RECORD);
 
   PartitionInfo start = current_;
@@ -1341,6 +1509,8 @@ bool PartitionedRocksDBStore::PartitionDirectoryIterator::nextPartition() {
   }
   last_lsn_ = PartitionDirectoryValue::getMaxLSN(
       meta_it_.value().data(), meta_it_.value().size());
+  approximate_size_bytes_ = PartitionDirectoryValue::getApproximateSizeBytes(
+      meta_it_.value().data(), meta_it_.value().size());
 
   meta_it_.Next();
 
@@ -1357,6 +1527,12 @@ lsn_t PartitionedRocksDBStore::PartitionDirectoryIterator::getLastLSN() {
   return last_lsn_;
 }
 
+size_t
+PartitionedRocksDBStore::PartitionDirectoryIterator::getApproximateSizeBytes() {
+  ld_check(partition_id_ != PARTITION_INVALID);
+  return approximate_size_bytes_;
+}
+
 bool PartitionedRocksDBStore::PartitionDirectoryIterator::itValid() {
   return meta_it_.status().ok() && meta_it_.Valid() &&
       PartitionDirectoryKey::valid(
@@ -165,6 +165,20 @@ class PartitionedRocksDBStore::Iterator : public LocalLogStore::ReadIterator {
                                     partition_id_t partition_id,
                                     bool after);
 
+  // Used by moveUntilValid() when moving forward past a partition that had no
+  // suitable records, if parallel probing is enabled (see
+  // --rocksdb-iterator-parallel-seek-partitions). Reads up to that many
+  // directory entries for the log following meta_iterator_'s position and
+  // seeks a data iterator to `current_lsn` in each of these partitions
+  // concurrently on pstore_->seek_probe_executor_. Then positions
+  // meta_iterator_ on the first partition that has a non-orphaned record
+  // with lsn >= `current_lsn` (or on the last probed partition if none of
+  // them do), and saves the data iterator of that partition in
+  // probed_data_iterator_ for moveUntilValid() to reuse.
+  // Returns false if parallel probing is not applicable; in this case
+  // meta_iterator_ is left untouched.
+  bool probePartitionsInParallel(lsn_t current_lsn);
+
   // Prints a warning if the meta_iterator_ is pointing to a logsdb directory
   // with invalid value. Assumes that the key is valid.
   void checkDirectoryValue() const;
@@ -185,6 +199,9 @@ class PartitionedRocksDBStore::Iterator : public LocalLogStore::ReadIterator {
   // current_. Called before each filtered operation on data_iterator_.
   void assertDataIteratorHasCorrectTimeRange();
 
+  // See --rocksdb-cache-tail-partitions-high-priority.
+  bool isTailPartition(const PartitionPtr& partition) const;
+
   // Which partition data_iterator_ currently points to.
   // Shouldn't be destroyed before data_iterator_.
   // Whoever changes current_ is responsible for deleting data_iterator_ if
@@ -197,6 +214,11 @@ class PartitionedRocksDBStore::Iterator : public LocalLogStore::ReadIterator {
   // moveUntilValid() before next()/seek() returns.
   PartitionInfo current_;
 
+  // True if current_.partition_ is one of the newest partitions whose blocks
+  // are cached at high priority (see ScopedTailPartitionRead). Updated when
+  // data_iterator_ is created.
+  bool current_in_tail_ = false;
+
   // What we currently believe to be latest partition having data for this log.
   PartitionInfo latest_;
 
@@ -219,6 +241,12 @@ class PartitionedRocksDBStore::Iterator : public LocalLogStore::ReadIterator {
   // Data iterator (reads from an individual column family).
   std::unique_ptr<RocksDBLocalLogStore::CSIWrapper> data_iterator_;
 
+  // Data iterator created by probePartitionsInParallel() in partition
+  // probed_partition_. Adopted as data_iterator_ if moveUntilValid() moves to
+  // that partition, destroyed before moveUntilValid() returns otherwise.
+  PartitionPtr probed_partition_;
+  std::unique_ptr<RocksDBLocalLogStore::CSIWrapper> probed_data_iterator_;
+
   const PartitionedRocksDBStore* pstore_;
   LocalLogStore::ReadOptions options_;
 
@@ -383,6 +411,10 @@ class PartitionedRocksDBStore::PartitionDirectoryIterator {
   // this log (but not latest partition overall).
   lsn_t getLastLSN();
 
+  // Approximate size of records for current log in current partition, as
+  // recorded in the directory. Can be 0 for entries written by old versions.
+  size_t getApproximateSizeBytes();
+
  private:
   PartitionedRocksDBStore& store_;
   partition_id_t latest_partition_;
@@ -393,6 +425,7 @@ class PartitionedRocksDBStore::PartitionDirectoryIterator {
   lsn_t first_lsn_;
 
   lsn_t last_lsn_;
+  size_t approximate_size_bytes_;
 
   bool itValid();
   logid_t itLogID();
@@ -7,8 +7,12 @@
  */
 #include "logdevice/server/locallogstore/RocksDBCache.h"
 
+#include "logdevice/server/locallogstore/IOType.h"
+
 namespace facebook { namespace logdevice {
 
+thread_local const bool* ScopedTailPartitionRead::current_ = nullptr;
+
 RocksDBCache::RocksDBCache(
     UpdateableSettings<RocksDBSettings> rocksdb_settings,
     folly::Optional<std::shared_ptr<rocksdb::MemoryAllocator>>
@@ -36,6 +40,15 @@ rocksdb::Status RocksDBCache::Insert(const rocksdb::Slice& key,
                                                      void* value),
                                      Handle** handle,
                                      Priority priority) {
+  if (ScopedIOType::current() != IOType::NORMAL) {
+    // Don't let a compaction or rebuilding scan push out blocks that readers
+    // are going to need again.
+    if (rocksdb_settings_->cache_background_reads_low_priority_) {
+      return cache_->Insert(key, value, charge, deleter, handle, Priority::LOW);
+    }
+  } else if (ScopedTailPartitionRead::current()) {
+    priority = Priority::HIGH;
+  }
   if (charge <
       rocksdb_settings_->cache_small_block_threshold_for_high_priority_) {
     priority = Priority::HIGH;
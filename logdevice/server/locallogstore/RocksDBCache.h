@@ -16,7 +16,15 @@ namespace facebook { namespace logdevice {
 
 // Custom cache policy used for block cache.
 // Currently it just wraps the default LRU cache implementation,
-// with small tweaks.
+// with small tweaks to the priority blocks are inserted with:
+//  * blocks read by compactions and rebuilding go in at low priority (see
+//    --rocksdb-cache-background-reads-low-priority),
+//  * blocks that readers read from the newest partitions of a shard go in at
+//    high priority (see --rocksdb-cache-tail-partitions-high-priority and
+//    ScopedTailPartitionRead),
+//  * otherwise, small blocks go in at high priority.
+// The high priority pool (--rocksdb-cache-high-pri-pool-ratio) is the budget
+// for blocks that shouldn't be evicted by big scans.
 
 class RocksDBCache : public rocksdb::Cache {
  public:
@@ -63,4 +71,33 @@ class RocksDBCache : public rocksdb::Cache {
   UpdateableSettings<RocksDBSettings> rocksdb_settings_;
 };
 
+/**
+ * While in scope, blocks that the calling thread inserts into RocksDBCache
+ * are considered to belong to the newest partitions of the shard if *hot is
+ * true at the time of the insert. Takes a pointer rather than a value because
+ * a PartitionedRocksDBStore iterator may move to another partition in the
+ * middle of a seek or next.
+ */
+class ScopedTailPartitionRead {
+ public:
+  explicit ScopedTailPartitionRead(const bool* hot) : prev_(current_) {
+    current_ = hot;
+  }
+
+  ~ScopedTailPartitionRead() {
+    current_ = prev_;
+  }
+
+  ScopedTailPartitionRead(const ScopedTailPartitionRead&) = delete;
+  ScopedTailPartitionRead& operator=(const ScopedTailPartitionRead&) = delete;
+
+  static bool current() {
+    return current_ != nullptr && *current_;
+  }
+
+ private:
+  static thread_local const bool* current_;
+  const bool* prev_;
+};
+
 }} // namespace facebook::logdevice
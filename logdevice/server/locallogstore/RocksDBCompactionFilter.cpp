@@ -7,6 +7,8 @@
  */
 #include "logdevice/server/locallogstore/RocksDBCompactionFilter.h"
 
+#include <algorithm>
+
 #include <rocksdb/slice.h>
 
 #include "logdevice/common/LocalLogStoreRecordFormat.h"
@@ -462,13 +464,8 @@ void RocksDBCompactionFilter::getTrimInfo(logid_t log_id) {
   ld_spew("querying Processor for trim point/cutoff_timestamp of log %lu",
           log_id.val_);
 
-  LogStorageState* log_state = processor->getLogStorageStateMap().find(
-      log_id, storage_thread_pool_->getShardIdx());
-  if (log_state != nullptr) {
-    trim_point = log_state->getTrimPoint();
-    per_epoch_log_metadata_trim_point =
-        log_state->getPerEpochLogMetadataTrimPoint();
-  } else {
+  if (!findTrimPoints(
+          log_id, &trim_point, &per_epoch_log_metadata_trim_point)) {
     noteLogSkipped(log_id);
   }
 
@@ -502,6 +499,79 @@ void RocksDBCompactionFilter::getTrimInfo(logid_t log_id) {
   cache.per_epoch_log_metadata_trim_point = per_epoch_log_metadata_trim_point;
 }
 
+bool RocksDBCompactionFilter::findTrimPoints(
+    logid_t log_id,
+    lsn_t* out_trim_point,
+    folly::Optional<epoch_t>* out_metadata_trim_point) {
+  ++trim_info_lookups_;
+  size_t min_logs = settings_->compaction_trim_point_snapshot_min_logs;
+  if (!trim_point_snapshot_ && min_logs > 0 && trim_info_lookups_ >= min_logs) {
+    buildTrimPointSnapshot();
+  }
+
+  if (trim_point_snapshot_) {
+    const auto& ids = trim_point_snapshot_->log_ids;
+    auto it = std::lower_bound(ids.begin(), ids.end(), log_id.val_);
+    if (it != ids.end() && *it == log_id.val_) {
+      size_t i = it - ids.begin();
+      *out_trim_point = trim_point_snapshot_->trim_points[i];
+      *out_metadata_trim_point =
+          trim_point_snapshot_->per_epoch_log_metadata_trim_points[i];
+      return true;
+    }
+    // The log state may have been created after the snapshot, e.g. by
+    // flushSkippedLogs(). Fall through to the map.
+  }
+
+  LogStorageState* log_state =
+      storage_thread_pool_->getProcessor().getLogStorageStateMap().find(
+          log_id, storage_thread_pool_->getShardIdx());
+  if (log_state == nullptr) {
+    return false;
+  }
+  *out_trim_point = log_state->getTrimPoint();
+  *out_metadata_trim_point = log_state->getPerEpochLogMetadataTrimPoint();
+  return true;
+}
+
+void RocksDBCompactionFilter::buildTrimPointSnapshot() {
+  struct Entry {
+    logid_t::raw_type log_id;
+    lsn_t trim_point;
+    folly::Optional<epoch_t> metadata_trim_point;
+  };
+  std::vector<Entry> entries;
+  auto& map = storage_thread_pool_->getProcessor().getLogStorageStateMap();
+  map.forEachLogOnShard(storage_thread_pool_->getShardIdx(),
+                        [&](logid_t log_id, const LogStorageState& state) {
+                          entries.push_back(
+                              {log_id.val_,
+                               state.getTrimPoint(),
+                               state.getPerEpochLogMetadataTrimPoint()});
+                          return 0;
+                        });
+  std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+    return a.log_id < b.log_id;
+  });
+
+  auto snapshot = std::make_unique<TrimPointSnapshot>();
+  snapshot->log_ids.reserve(entries.size());
+  snapshot->trim_points.reserve(entries.size());
+  snapshot->per_epoch_log_metadata_trim_points.reserve(entries.size());
+  for (const Entry& e : entries) {
+    snapshot->log_ids.push_back(e.log_id);
+    snapshot->trim_points.push_back(e.trim_point);
+    snapshot->per_epoch_log_metadata_trim_points.push_back(
+        e.metadata_trim_point);
+  }
+  ld_debug("Took a snapshot of trim points of %zu logs of shard %d after %zu "
+           "lookups",
+           entries.size(),
+           storage_thread_pool_->getShardIdx(),
+           trim_info_lookups_);
+  trim_point_snapshot_ = std::move(snapshot);
+}
+
 void RocksDBCompactionFilter::noteLogSkipped(logid_t log_id) {
   logs_skipped_.push_back(log_id);
   if (logs_skipped_.size() == 128) {
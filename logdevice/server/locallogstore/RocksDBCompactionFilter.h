@@ -148,11 +148,41 @@ class RocksDBCompactionFilter : public rocksdb::CompactionFilter {
     folly::Optional<epoch_t> per_epoch_log_metadata_trim_point;
   } cache;
 
+  // Trim points of all logs of the shard, copied from LogStorageStateMap in
+  // one pass. Compactions of shards with many logs would otherwise do a hash
+  // map lookup for every log they encounter; once a compaction has looked up
+  // enough logs (see rocksdb-compaction-trim-point-snapshot-min-logs), it
+  // switches to binary searches in these compact sorted arrays.
+  //
+  // Trim points only move forward, so a stale snapshot is safe: records it
+  // fails to remove will be removed by the next compaction. This is the same
+  // guarantee `cache' provides.
+  struct TrimPointSnapshot {
+    // Sorted.
+    std::vector<logid_t::raw_type> log_ids;
+    // Parallel to log_ids.
+    std::vector<lsn_t> trim_points;
+    std::vector<folly::Optional<epoch_t>> per_epoch_log_metadata_trim_points;
+  };
+  std::unique_ptr<TrimPointSnapshot> trim_point_snapshot_;
+
+  // Number of getTrimInfo() cache misses so far.
+  size_t trim_info_lookups_ = 0;
+
   virtual std::chrono::milliseconds currentTime();
 
   // Makes sure `cache' is filled with information about the given log.
   void getTrimInfo(logid_t log_id);
 
+  // Finds the trim points of the given log, in trim_point_snapshot_ if there
+  // is one, in LogStorageStateMap otherwise. Returns false if the log has no
+  // LogStorageState.
+  bool findTrimPoints(logid_t log_id,
+                      lsn_t* out_trim_point,
+                      folly::Optional<epoch_t>* out_metadata_trim_point);
+
+  void buildTrimPointSnapshot();
+
   virtual Decision filterImpl(const rocksdb::Slice& key,
                               const rocksdb::Slice& value,
                               std::string* skip_until);
@@ -7,8 +7,15 @@
  */
 #include "logdevice/server/locallogstore/RocksDBEnv.h"
 
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <cstring>
+
 #include <boost/algorithm/string/predicate.hpp>
 #include <folly/Optional.h>
+#include <folly/ScopeGuard.h>
 #include <folly/ThreadLocal.h>
 
 #include "logdevice/common/ThreadID.h"
@@ -19,6 +26,10 @@
 #include "logdevice/server/locallogstore/LocalLogStore.h"
 #include "logdevice/server/locallogstore/ShardedRocksDBLocalLogStore.h"
 
+#ifdef LOGDEVICE_HAVE_LIBURING
+#include <liburing.h>
+#endif
+
 namespace facebook { namespace logdevice {
 
 void RocksDBEnv::Schedule(void (*function)(void* arg),
@@ -68,8 +79,15 @@ void RocksDBEnv::bgJobRun(void* arg) {
 
   thread_state.running_a_job = true;
 
-  // Actually run the job.
-  (*job->function)(job->arg);
+  {
+    // Low and bottom priority pools run compactions. Flushes, in the high
+    // priority pool, don't read sst files.
+    ScopedIOType io_type(job->pri == Priority::HIGH ? IOType::NORMAL
+                                                    : IOType::COMPACTION);
+
+    // Actually run the job.
+    (*job->function)(job->arg);
+  }
 
   thread_state.running_a_job = false;
 
@@ -274,8 +292,59 @@ RocksDBEnv::NewRandomAccessFile(const std::string& f,
       return status;
     }
   }
+  if (options.use_mmap_reads || options.use_direct_reads) {
+    *r = std::make_unique<RocksDBRandomAccessFile>(
+        std::move(file), tracing, settings_);
+    return rocksdb::Status::OK();
+  }
+
+  // Open our own descriptors for the file if we're going to read it bypassing
+  // rocksdb's file: for io_uring reads and for page cache policies.
+  const bool use_direct_fd =
+      settings_->compaction_read_cache_policy == SstReadCachePolicy::DIRECT ||
+      settings_->rebuilding_read_cache_policy == SstReadCachePolicy::DIRECT;
+  const bool use_fd = settings_->io_uring_reads || use_direct_fd ||
+      settings_->sst_read_page_cache_stats ||
+      settings_->compaction_read_cache_policy != SstReadCachePolicy::NORMAL ||
+      settings_->rebuilding_read_cache_policy != SstReadCachePolicy::NORMAL;
+  int fd = -1;
+  int direct_fd = -1;
+  if (use_fd) {
+    fd = ::open(f.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+      RATELIMIT_ERROR(std::chrono::seconds(10),
+                      2,
+                      "Failed to open %s: %s. Reading it without io_uring and "
+                      "page cache policies.",
+                      f.c_str(),
+                      strerror(errno));
+    } else if (use_direct_fd) {
+      direct_fd = ::open(f.c_str(), O_RDONLY | O_CLOEXEC | O_DIRECT);
+      if (direct_fd < 0) {
+        RATELIMIT_WARNING(std::chrono::seconds(10),
+                          2,
+                          "Failed to open %s with O_DIRECT: %s. Using "
+                          "posix_fadvise(DONTNEED) instead.",
+                          f.c_str(),
+                          strerror(errno));
+      }
+    }
+  }
+
+  if (settings_->io_uring_reads && fd >= 0) {
+#ifdef LOGDEVICE_HAVE_LIBURING
+    *r = std::make_unique<RocksDBIOUringRandomAccessFile>(
+        std::move(file), tracing, settings_, fd, direct_fd, stats_);
+    return rocksdb::Status::OK();
+#else
+    RATELIMIT_WARNING(std::chrono::minutes(10),
+                      1,
+                      "rocksdb-io-uring-reads is set, but logdeviced was "
+                      "built without liburing. Using pread().");
+#endif
+  }
   *r = std::make_unique<RocksDBRandomAccessFile>(
-      std::move(file), tracing, settings_);
+      std::move(file), tracing, settings_, fd, direct_fd, stats_);
   return rocksdb::Status::OK();
 }
 rocksdb::Status
@@ -431,14 +500,29 @@ rocksdb::Status RocksDBSequentialFile::PositionedRead(uint64_t offset,
 RocksDBRandomAccessFile::RocksDBRandomAccessFile(
     std::unique_ptr<rocksdb::RandomAccessFile> file,
     FileTracingInfo tracing,
-    UpdateableSettings<RocksDBSettings> settings)
+    UpdateableSettings<RocksDBSettings> settings,
+    int fd,
+    int direct_fd,
+    StatsHolder* stats)
     : rocksdb::RandomAccessFileWrapper(file.get()),
       file_(std::move(file)),
       tracing_(tracing),
-      settings_(settings) {}
+      settings_(settings),
+      fd_(fd),
+      direct_fd_(direct_fd),
+      // Per-shard stats need a shard.
+      stats_(tracing_.shard_idx >= 0 ? stats : nullptr) {
+  ld_check(direct_fd_ < 0 || fd_ >= 0);
+}
 RocksDBRandomAccessFile::~RocksDBRandomAccessFile() {
   SCOPED_IO_TRACED_OP(tracing_.io_tracing, "rf:{}|close", tracing_.filename);
   file_.reset();
+  if (direct_fd_ >= 0) {
+    ::close(direct_fd_);
+  }
+  if (fd_ >= 0) {
+    ::close(fd_);
+  }
 }
 rocksdb::Status RocksDBRandomAccessFile::Read(uint64_t offset,
                                               size_t n,
@@ -449,12 +533,42 @@ rocksdb::Status RocksDBRandomAccessFile::Read(uint64_t offset,
                       tracing_.filename,
                       offset,
                       n);
+  stallIfRequested();
+  const IOType io_type = ScopedIOType::current();
+  if (probesPageCache(io_type)) {
+    return cachePolicyRead(io_type, offset, n, result, scratch);
+  }
+  return rocksdb::RandomAccessFileWrapper::Read(offset, n, result, scratch);
+}
+#ifdef LOGDEVICED_ROCKSDB_HAS_MULTIREAD
+rocksdb::Status RocksDBRandomAccessFile::MultiRead(rocksdb::ReadRequest* reqs,
+                                                   size_t num_reqs) {
+  SCOPED_IO_TRACED_OP(tracing_.io_tracing,
+                      "rf:{}|MultiRead|n:{}|off:{}",
+                      tracing_.filename,
+                      num_reqs,
+                      num_reqs ? reqs[0].offset : 0);
+  stallIfRequested();
+  const IOType io_type = ScopedIOType::current();
+  if (probesPageCache(io_type)) {
+    for (size_t i = 0; i < num_reqs; ++i) {
+      reqs[i].status = cachePolicyRead(io_type,
+                                       reqs[i].offset,
+                                       reqs[i].len,
+                                       &reqs[i].result,
+                                       reqs[i].scratch);
+    }
+    return rocksdb::Status::OK();
+  }
+  return rocksdb::RandomAccessFileWrapper::MultiRead(reqs, num_reqs);
+}
+#endif
+void RocksDBRandomAccessFile::stallIfRequested() const {
   while (UNLIKELY(settings_->test_stall_sst_reads) &&
          boost::ends_with(tracing_.filename, ".sst")) {
     // Re-check the setting every 100ms.
     std::this_thread::sleep_for(std::chrono::milliseconds(100));
   }
-  return rocksdb::RandomAccessFileWrapper::Read(offset, n, result, scratch);
 }
 rocksdb::Status RocksDBRandomAccessFile::Prefetch(uint64_t offset, size_t n) {
   SCOPED_IO_TRACED_OP(tracing_.io_tracing,
@@ -462,6 +576,12 @@ rocksdb::Status RocksDBRandomAccessFile::Prefetch(uint64_t offset, size_t n) {
                       tracing_.filename,
                       offset,
                       n);
+  if (fd_ >= 0 &&
+      cachePolicy(ScopedIOType::current()) != SstReadCachePolicy::NORMAL) {
+    // readahead() would pull the whole range into page cache. Make rocksdb
+    // use its own prefetch buffer instead, which reads through Read().
+    return rocksdb::Status::NotSupported();
+  }
   return rocksdb::RandomAccessFileWrapper::Prefetch(offset, n);
 }
 size_t RocksDBRandomAccessFile::GetUniqueId(char* id, size_t max_size) const {
@@ -485,6 +605,435 @@ rocksdb::Status RocksDBRandomAccessFile::InvalidateCache(size_t offset,
                       length);
   return rocksdb::RandomAccessFileWrapper::InvalidateCache(offset, length);
 }
+SstReadCachePolicy RocksDBRandomAccessFile::cachePolicy(IOType type) const {
+  switch (type) {
+    case IOType::COMPACTION:
+      return settings_->compaction_read_cache_policy;
+    case IOType::REBUILDING:
+      return settings_->rebuilding_read_cache_policy;
+    case IOType::NORMAL:
+    case IOType::MAX:
+      break;
+  }
+  return SstReadCachePolicy::NORMAL;
+}
+bool RocksDBRandomAccessFile::probesPageCache(IOType type) const {
+  return fd_ >= 0 &&
+      (settings_->sst_read_page_cache_stats ||
+       cachePolicy(type) != SstReadCachePolicy::NORMAL);
+}
+rocksdb::Status
+RocksDBRandomAccessFile::cachePolicyRead(IOType type,
+                                         uint64_t offset,
+                                         size_t n,
+                                         rocksdb::Slice* result,
+                                         char* scratch) const {
+  ld_check(fd_ >= 0);
+  SstReadCachePolicy policy = cachePolicy(type);
+  if (policy == SstReadCachePolicy::DIRECT && direct_fd_ < 0) {
+    policy = SstReadCachePolicy::DONTNEED;
+  }
+
+  // First read whatever is in page cache without blocking on the disk.
+  size_t cached = 0;
+  bool probed = false;
+#ifdef RWF_NOWAIT
+  if (nowait_supported_.load(std::memory_order_relaxed)) {
+    iovec iov{scratch, n};
+    ssize_t rv;
+    do {
+      rv = ::preadv2(fd_, &iov, 1, offset, RWF_NOWAIT);
+    } while (rv < 0 && errno == EINTR);
+    if (rv >= 0) {
+      probed = true;
+      cached = rv;
+    } else if (errno == EAGAIN) {
+      probed = true;
+    } else if (errno == EOPNOTSUPP || errno == EINVAL || errno == ENOSYS) {
+      RATELIMIT_WARNING(std::chrono::minutes(10),
+                        1,
+                        "preadv2(RWF_NOWAIT) is not supported for %s: %s. "
+                        "Page cache policies will apply to whole reads, and "
+                        "page cache hits won't be counted.",
+                        tracing_.filename.c_str(),
+                        strerror(errno));
+      nowait_supported_.store(false, std::memory_order_relaxed);
+    } else {
+      return rocksdb::Status::IOError(
+          "preadv2() failed on " + tracing_.filename, strerror(errno));
+    }
+  }
+#endif
+
+  // Then read the rest, which may be nothing if the probe got it all or
+  // reached EOF.
+  size_t uncached = 0;
+  if (cached < n) {
+    const uint64_t rest_offset = offset + cached;
+    const size_t rest = n - cached;
+    rocksdb::Status st = policy == SstReadCachePolicy::DIRECT
+        ? directRead(rest_offset, rest, scratch + cached, &uncached)
+        : bufferedRead(rest_offset, rest, scratch + cached, &uncached);
+    if (!st.ok()) {
+      return st;
+    }
+    if (policy == SstReadCachePolicy::DIRECT) {
+      PER_SHARD_STAT_ADD(
+          stats_, sst_read_direct_bytes, tracing_.shard_idx, uncached);
+    } else if (policy == SstReadCachePolicy::DONTNEED && uncached > 0) {
+      // Only drops the pages fully inside the range, so the page shared with
+      // the cached part of the read stays.
+      ::posix_fadvise(fd_, rest_offset, uncached, POSIX_FADV_DONTNEED);
+      PER_SHARD_STAT_ADD(
+          stats_, sst_read_dontneed_bytes, tracing_.shard_idx, uncached);
+    }
+  }
+
+  if (probed) {
+    countPageCacheProbe(type, uncached == 0);
+  }
+  *result = rocksdb::Slice(scratch, cached + uncached);
+  return rocksdb::Status::OK();
+}
+rocksdb::Status
+RocksDBRandomAccessFile::bufferedRead(uint64_t offset,
+                                      size_t n,
+                                      char* scratch,
+                                      size_t* bytes_read) const {
+  *bytes_read = 0;
+  while (*bytes_read < n) {
+    ssize_t rv = ::pread(
+        fd_, scratch + *bytes_read, n - *bytes_read, offset + *bytes_read);
+    if (rv < 0 && errno == EINTR) {
+      continue;
+    }
+    if (rv < 0) {
+      return rocksdb::Status::IOError(
+          "pread() failed on " + tracing_.filename, strerror(errno));
+    }
+    if (rv == 0) {
+      break;
+    }
+    *bytes_read += rv;
+  }
+  return rocksdb::Status::OK();
+}
+rocksdb::Status RocksDBRandomAccessFile::directRead(uint64_t offset,
+                                                    size_t n,
+                                                    char* scratch,
+                                                    size_t* bytes_read) const {
+  // O_DIRECT needs offset, size and buffer aligned to the logical block size.
+  // 4 KiB covers all devices we run on.
+  constexpr size_t kAlignment = 4096;
+  const uint64_t start = offset / kAlignment * kAlignment;
+  const uint64_t end = (offset + n + kAlignment - 1) / kAlignment * kAlignment;
+  const size_t len = end - start;
+
+  void* buf;
+  int rv = ::posix_memalign(&buf, kAlignment, len);
+  if (rv != 0) {
+    return rocksdb::Status::IOError("posix_memalign() failed", strerror(rv));
+  }
+  SCOPE_EXIT {
+    ::free(buf);
+  };
+
+  size_t got = 0;
+  while (got < len) {
+    ssize_t r = ::pread(
+        direct_fd_, static_cast<char*>(buf) + got, len - got, start + got);
+    if (r < 0 && errno == EINTR) {
+      continue;
+    }
+    if (r < 0) {
+      return rocksdb::Status::IOError(
+          "O_DIRECT pread() failed on " + tracing_.filename, strerror(errno));
+    }
+    got += r;
+    if (r == 0 || got % kAlignment != 0) {
+      // EOF.
+      break;
+    }
+  }
+
+  const size_t skip = offset - start;
+  *bytes_read = got > skip ? std::min(n, got - skip) : 0;
+  std::memcpy(scratch, static_cast<char*>(buf) + skip, *bytes_read);
+  return rocksdb::Status::OK();
+}
+void RocksDBRandomAccessFile::countPageCacheProbe(IOType type, bool hit) const {
+  switch (type) {
+    case IOType::NORMAL:
+      if (hit) {
+        PER_SHARD_STAT_INCR(
+            stats_, sst_read_page_cache_hits_normal, tracing_.shard_idx);
+      } else {
+        PER_SHARD_STAT_INCR(
+            stats_, sst_read_page_cache_misses_normal, tracing_.shard_idx);
+      }
+      break;
+    case IOType::COMPACTION:
+      if (hit) {
+        PER_SHARD_STAT_INCR(
+            stats_, sst_read_page_cache_hits_compaction, tracing_.shard_idx);
+      } else {
+        PER_SHARD_STAT_INCR(
+            stats_, sst_read_page_cache_misses_compaction, tracing_.shard_idx);
+      }
+      break;
+    case IOType::REBUILDING:
+      if (hit) {
+        PER_SHARD_STAT_INCR(
+            stats_, sst_read_page_cache_hits_rebuilding, tracing_.shard_idx);
+      } else {
+        PER_SHARD_STAT_INCR(
+            stats_, sst_read_page_cache_misses_rebuilding, tracing_.shard_idx);
+      }
+      break;
+    case IOType::MAX:
+      ld_check(false);
+      break;
+  }
+}
+
+#ifdef LOGDEVICE_HAVE_LIBURING
+
+namespace {
+
+// An io_uring for the calling thread, set up on first use and torn down when
+// the thread exits.
+class ThreadIOUring {
+ public:
+  // Returns nullptr if the ring couldn't be set up, e.g. because the kernel
+  // doesn't support io_uring. `depth` is only used on first call.
+  static ThreadIOUring* get(unsigned depth) {
+    static thread_local ThreadIOUring ring;
+    if (!ring.initialized_ && !ring.failed_) {
+      int rv = io_uring_queue_init(depth, &ring.ring_, 0);
+      if (rv < 0) {
+        RATELIMIT_ERROR(std::chrono::seconds(10),
+                        2,
+                        "io_uring_queue_init() failed: %s. Falling back to "
+                        "pread() on this thread.",
+                        strerror(-rv));
+        ring.failed_ = true;
+      } else {
+        ring.initialized_ = true;
+        ring.depth_ = depth;
+      }
+    }
+    return ring.initialized_ ? &ring : nullptr;
+  }
+
+  ~ThreadIOUring() {
+    if (initialized_) {
+      io_uring_queue_exit(&ring_);
+    }
+  }
+
+  io_uring* ring() {
+    return &ring_;
+  }
+
+  unsigned depth() const {
+    return depth_;
+  }
+
+ private:
+  io_uring ring_;
+  unsigned depth_ = 0;
+  bool initialized_ = false;
+  bool failed_ = false;
+};
+
+} // namespace
+
+RocksDBIOUringRandomAccessFile::RocksDBIOUringRandomAccessFile(
+    std::unique_ptr<rocksdb::RandomAccessFile> file,
+    FileTracingInfo tracing,
+    UpdateableSettings<RocksDBSettings> settings,
+    int fd,
+    int direct_fd,
+    StatsHolder* stats)
+    : RocksDBRandomAccessFile(std::move(file),
+                              tracing,
+                              settings,
+                              fd,
+                              direct_fd,
+                              stats) {
+  ld_check(fd_ >= 0);
+}
+
+rocksdb::Status RocksDBIOUringRandomAccessFile::Read(uint64_t offset,
+                                                     size_t n,
+                                                     rocksdb::Slice* result,
+                                                     char* scratch) const {
+  SCOPED_IO_TRACED_OP(tracing_.io_tracing,
+                      "rf:{}|Read|off:{}|sz:{}|uring",
+                      tracing_.filename,
+                      offset,
+                      n);
+  stallIfRequested();
+  const IOType io_type = ScopedIOType::current();
+  if (probesPageCache(io_type)) {
+    return cachePolicyRead(io_type, offset, n, result, scratch);
+  }
+  ReadOp op{offset, n, scratch};
+  readBatch(&op, 1);
+  *result = rocksdb::Slice(scratch, op.bytes_read);
+  return op.status;
+}
+
+#ifdef LOGDEVICED_ROCKSDB_HAS_MULTIREAD
+rocksdb::Status RocksDBIOUringRandomAccessFile::MultiRead(
+    rocksdb::ReadRequest* reqs,
+    size_t num_reqs) {
+  SCOPED_IO_TRACED_OP(tracing_.io_tracing,
+                      "rf:{}|MultiRead|n:{}|off:{}|uring",
+                      tracing_.filename,
+                      num_reqs,
+                      num_reqs ? reqs[0].offset : 0);
+  stallIfRequested();
+  const IOType io_type = ScopedIOType::current();
+  if (probesPageCache(io_type)) {
+    for (size_t i = 0; i < num_reqs; ++i) {
+      reqs[i].status = cachePolicyRead(io_type,
+                                       reqs[i].offset,
+                                       reqs[i].len,
+                                       &reqs[i].result,
+                                       reqs[i].scratch);
+    }
+    return rocksdb::Status::OK();
+  }
+  std::vector<ReadOp> ops;
+  ops.reserve(num_reqs);
+  for (size_t i = 0; i < num_reqs; ++i) {
+    ops.push_back(ReadOp{reqs[i].offset, reqs[i].len, reqs[i].scratch});
+  }
+  readBatch(ops.data(), ops.size());
+  for (size_t i = 0; i < num_reqs; ++i) {
+    reqs[i].result = rocksdb::Slice(reqs[i].scratch, ops[i].bytes_read);
+    reqs[i].status = ops[i].status;
+  }
+  return rocksdb::Status::OK();
+}
+#endif
+
+void RocksDBIOUringRandomAccessFile::readBatch(ReadOp* ops, size_t n) const {
+  ThreadIOUring* ring =
+      ThreadIOUring::get(std::max(1ul, settings_->io_uring_queue_depth));
+
+  // Ops that still need bytes, as indices into `ops`.
+  std::vector<size_t> todo(n);
+  for (size_t i = 0; i < n; ++i) {
+    todo[i] = i;
+  }
+
+  while (!todo.empty()) {
+    if (ring == nullptr) {
+      // No io_uring on this thread; do the remaining reads the old way.
+      for (size_t i : todo) {
+        ReadOp& op = ops[i];
+        while (op.bytes_read < op.len) {
+          ssize_t rv = ::pread(fd_,
+                               op.scratch + op.bytes_read,
+                               op.len - op.bytes_read,
+                               op.offset + op.bytes_read);
+          if (rv < 0 && errno == EINTR) {
+            continue;
+          }
+          if (rv < 0) {
+            op.status = rocksdb::Status::IOError(
+                "pread() failed on " + tracing_.filename, strerror(errno));
+          }
+          if (rv <= 0) {
+            break;
+          }
+          op.bytes_read += rv;
+        }
+      }
+      return;
+    }
+
+    // Submit as many ops as fit in the ring.
+    const size_t batch = std::min<size_t>(todo.size(), ring->depth());
+    size_t submitted = 0;
+    for (; submitted < batch; ++submitted) {
+      io_uring_sqe* sqe = io_uring_get_sqe(ring->ring());
+      if (sqe == nullptr) {
+        break;
+      }
+      ReadOp& op = ops[todo[submitted]];
+      io_uring_prep_read(sqe,
+                         fd_,
+                         op.scratch + op.bytes_read,
+                         op.len - op.bytes_read,
+                         op.offset + op.bytes_read);
+      io_uring_sqe_set_data(
+          sqe,
+          reinterpret_cast<void*>(static_cast<uintptr_t>(todo[submitted])));
+    }
+    ld_check(submitted > 0);
+    PER_SHARD_STAT_INCR(stats_, io_uring_submits, tracing_.shard_idx);
+    PER_SHARD_STAT_ADD(
+        stats_, io_uring_reads, tracing_.shard_idx, submitted);
+    PER_SHARD_STAT_ADD(
+        stats_, io_uring_in_flight, tracing_.shard_idx, submitted);
+
+    int rv;
+    do {
+      rv = io_uring_submit_and_wait(ring->ring(), submitted);
+    } while (rv == -EINTR);
+    if (rv < 0) {
+      // Nothing was submitted. Let the pread() path above handle the rest.
+      PER_SHARD_STAT_ADD(
+          stats_, io_uring_in_flight, tracing_.shard_idx, -(int64_t)submitted);
+      RATELIMIT_ERROR(std::chrono::seconds(10),
+                      2,
+                      "io_uring_submit_and_wait() failed: %s",
+                      strerror(-rv));
+      ring = nullptr;
+      continue;
+    }
+
+    // Reap completions. Ops that got fewer bytes than asked for without
+    // reaching EOF go around again.
+    std::vector<size_t> again;
+    for (size_t reaped = 0; reaped < submitted; ++reaped) {
+      io_uring_cqe* cqe;
+      do {
+        rv = io_uring_wait_cqe(ring->ring(), &cqe);
+      } while (rv == -EINTR);
+      ld_check(rv == 0);
+      const size_t i =
+          static_cast<size_t>(reinterpret_cast<uintptr_t>(
+              io_uring_cqe_get_data(cqe)));
+      ld_check(i < n);
+      ReadOp& op = ops[i];
+      const int res = cqe->res;
+      io_uring_cqe_seen(ring->ring(), cqe);
+
+      if (res == -EINTR || res == -EAGAIN) {
+        again.push_back(i);
+      } else if (res < 0) {
+        op.status = rocksdb::Status::IOError(
+            "io_uring read failed on " + tracing_.filename, strerror(-res));
+      } else {
+        op.bytes_read += res;
+        if (res > 0 && op.bytes_read < op.len) {
+          again.push_back(i);
+        }
+      }
+    }
+    PER_SHARD_STAT_ADD(
+        stats_, io_uring_in_flight, tracing_.shard_idx, -(int64_t)submitted);
+
+    todo.erase(todo.begin(), todo.begin() + submitted);
+    todo.insert(todo.end(), again.begin(), again.end());
+  }
+}
+
+#endif // LOGDEVICE_HAVE_LIBURING
 
 RocksDBDirectory::RocksDBDirectory(std::unique_ptr<rocksdb::Directory> dir,
                                    FileTracingInfo tracing)
@@ -514,6 +1063,7 @@ FileTracingInfo RocksDBEnv::tracingInfoForPath(const std::string& path) {
           path, &shard_idx, &info.filename) &&
       shard_idx < io_tracing_by_shard_.size()) {
     info.io_tracing = io_tracing_by_shard_[shard_idx];
+    info.shard_idx = shard_idx;
   } else {
     // If path is in unexpected format, leave io_tracing null.
     info.filename = path;
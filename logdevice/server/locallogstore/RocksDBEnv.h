@@ -7,6 +7,7 @@
  */
 #pragma once
 
+#include <atomic>
 #include <condition_variable>
 #include <mutex>
 #include <queue>
@@ -18,6 +19,7 @@
 #include <rocksdb/env.h>
 
 #include "logdevice/server/locallogstore/IOTracing.h"
+#include "logdevice/server/locallogstore/IOType.h"
 #include "logdevice/server/locallogstore/LocalLogStore.h"
 #include "logdevice/server/locallogstore/RocksDBSettings.h"
 
@@ -25,6 +27,10 @@
 #define LOGDEVICED_ROCKSDB_HAS_WRAPPERS
 #endif
 
+#if ROCKSDB_MAJOR > 6 || (ROCKSDB_MAJOR == 6 && ROCKSDB_MINOR >= 4)
+#define LOGDEVICED_ROCKSDB_HAS_MULTIREAD
+#endif
+
 namespace facebook { namespace logdevice {
 
 class StatsHolder;
@@ -32,6 +38,8 @@ class StatsHolder;
 struct FileTracingInfo {
   IOTracing* io_tracing = nullptr;
   std::string filename;
+  // -1 if the file doesn't belong to a shard.
+  shard_index_t shard_idx = -1;
 };
 
 /**
@@ -270,27 +278,127 @@ class RocksDBSequentialFile : public rocksdb::SequentialFileWrapper {
   FileTracingInfo tracing_;
 };
 
+// Besides tracing, applies the page cache policy of the current thread's
+// IOType (see IOType.h and SstReadCachePolicy): reads of IO types with a
+// non-NORMAL policy first probe the page cache with preadv2(RWF_NOWAIT).
+// Hits are served from the page cache as usual. Misses are read with O_DIRECT
+// or followed by posix_fadvise(DONTNEED), so that compactions and rebuilding
+// don't evict the data that tailing readers need. If the kernel doesn't
+// support RWF_NOWAIT, the policy is applied to the whole read.
+// If rocksdb-sst-read-page-cache-stats is set, NORMAL reads probe the page
+// cache as well, just to count hits and misses.
 class RocksDBRandomAccessFile : public rocksdb::RandomAccessFileWrapper {
  public:
+  // `fd` and `direct_fd` are optional read-only descriptors for the same file,
+  // the latter opened with O_DIRECT, or -1. Takes ownership of them.
+  // Page cache policies are only applied if `fd` is given; if `direct_fd` is
+  // missing, DIRECT policy falls back to DONTNEED.
   RocksDBRandomAccessFile(std::unique_ptr<rocksdb::RandomAccessFile> file,
                           FileTracingInfo tracing,
-                          UpdateableSettings<RocksDBSettings> settings);
+                          UpdateableSettings<RocksDBSettings> settings,
+                          int fd = -1,
+                          int direct_fd = -1,
+                          StatsHolder* stats = nullptr);
   ~RocksDBRandomAccessFile() override;
 
   rocksdb::Status Read(uint64_t offset,
                        size_t n,
                        rocksdb::Slice* result,
                        char* scratch) const override;
+#ifdef LOGDEVICED_ROCKSDB_HAS_MULTIREAD
+  rocksdb::Status MultiRead(rocksdb::ReadRequest* reqs,
+                            size_t num_reqs) override;
+#endif
   rocksdb::Status Prefetch(uint64_t offset, size_t n) override;
   size_t GetUniqueId(char* id, size_t max_size) const override;
   void Hint(AccessPattern pattern) override;
   rocksdb::Status InvalidateCache(size_t offset, size_t length) override;
 
- private:
+ protected:
+  // Blocks while the rocksdb-test-stall-sst-reads setting is set.
+  void stallIfRequested() const;
+
+  SstReadCachePolicy cachePolicy(IOType type) const;
+
+  // True if reads of the given IO type should go through cachePolicyRead().
+  bool probesPageCache(IOType type) const;
+
+  // Reads through fd_, probing the page cache and applying cachePolicy(type)
+  // to the part of the read that missed it.
+  rocksdb::Status cachePolicyRead(IOType type,
+                                  uint64_t offset,
+                                  size_t n,
+                                  rocksdb::Slice* result,
+                                  char* scratch) const;
+
   std::unique_ptr<rocksdb::RandomAccessFile> file_;
   FileTracingInfo tracing_;
   UpdateableSettings<RocksDBSettings> settings_;
+  const int fd_;
+  const int direct_fd_;
+  // nullptr if the file doesn't belong to a shard.
+  StatsHolder* stats_;
+
+ private:
+  // pread()/O_DIRECT pread() loops; set `*bytes_read` to the number of bytes
+  // read before EOF.
+  rocksdb::Status bufferedRead(uint64_t offset,
+                               size_t n,
+                               char* scratch,
+                               size_t* bytes_read) const;
+  rocksdb::Status directRead(uint64_t offset,
+                             size_t n,
+                             char* scratch,
+                             size_t* bytes_read) const;
+
+  void countPageCacheProbe(IOType type, bool hit) const;
+
+  // Cleared if preadv2(RWF_NOWAIT) turns out to be unsupported.
+  mutable std::atomic<bool> nowait_supported_{true};
+};
+
+#ifdef LOGDEVICE_HAVE_LIBURING
+// A RocksDBRandomAccessFile that does its reads through an io_uring owned by
+// the calling thread instead of pread(). MultiRead() submits all requests at
+// once, so a batch of block fetches costs one syscall rather than one per
+// block. Everything except reads is delegated to the underlying file, which
+// in particular keeps GetUniqueId() (and so block cache keys) unchanged.
+// Used if rocksdb-io-uring-reads is set.
+class RocksDBIOUringRandomAccessFile : public RocksDBRandomAccessFile {
+ public:
+  // `fd` is required. See RocksDBRandomAccessFile's constructor.
+  RocksDBIOUringRandomAccessFile(
+      std::unique_ptr<rocksdb::RandomAccessFile> file,
+      FileTracingInfo tracing,
+      UpdateableSettings<RocksDBSettings> settings,
+      int fd,
+      int direct_fd,
+      StatsHolder* stats);
+
+  rocksdb::Status Read(uint64_t offset,
+                       size_t n,
+                       rocksdb::Slice* result,
+                       char* scratch) const override;
+#ifdef LOGDEVICED_ROCKSDB_HAS_MULTIREAD
+  rocksdb::Status MultiRead(rocksdb::ReadRequest* reqs,
+                            size_t num_reqs) override;
+#endif
+
+  struct ReadOp {
+    uint64_t offset;
+    size_t len;
+    char* scratch;
+    // Filled out by readBatch().
+    size_t bytes_read = 0;
+    rocksdb::Status status;
+  };
+
+ private:
+  // Reads all of `ops`, submitting up to the ring's queue depth at a time.
+  // Short reads are resubmitted until EOF.
+  void readBatch(ReadOp* ops, size_t n) const;
 };
+#endif // LOGDEVICE_HAVE_LIBURING
 
 class RocksDBDirectory : public rocksdb::DirectoryWrapper {
  public:
@@ -372,6 +372,10 @@ class RocksDBLocalLogStore::CSIWrapper::CopySetIndexIterator
   std::vector<ShardID> current_single_copyset_;
   LocalLogStoreRecordFormat::csi_flags_t current_single_flags_{0};
 
+  // Raw value of the CSI entry that current_single_* were parsed from, or
+  // empty if they aren't valid.
+  std::string current_raw_entry_;
+
   // Size of the copyset index entry (NB: not the record it represents) in
   // bytes. Used to apply disk i/o limits when reading.
   size_t current_entry_size_{0};
@@ -1151,8 +1155,18 @@ void RocksDBLocalLogStore::CSIWrapper::CopySetIndexIterator::
     return;
   }
 
+  // Records of a sticky copyset block are stored with identical CSI entries.
+  // Decode the copyset only once per run of such entries.
+  const rocksdb::Slice value = iterator_->value();
+  if (!current_raw_entry_.empty() && value == current_raw_entry_) {
+    current_entry_size_ = value.size();
+    state_ = IteratorState::AT_RECORD;
+    return;
+  }
+  current_raw_entry_.clear();
+
   if (!LocalLogStoreRecordFormat::parseCopySetIndexSingleEntry(
-          Slice(iterator_->value().data(), iterator_->value().size()),
+          Slice(value.data(), value.size()),
           &current_single_copyset_,
           &current_single_wave_,
           &current_single_flags_,
@@ -1170,7 +1184,8 @@ void RocksDBLocalLogStore::CSIWrapper::CopySetIndexIterator::
     return;
   }
 
-  current_entry_size_ = iterator_->value().size();
+  current_entry_size_ = value.size();
+  current_raw_entry_.assign(value.data(), value.size());
 
   dd_assert(current_single_copyset_.size() > 0,
             "Empty copyset in copyset index for log_id %lu, lsn %s",
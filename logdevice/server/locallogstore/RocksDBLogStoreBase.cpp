@@ -10,6 +10,7 @@
 #include <rocksdb/iostats_context.h>
 
 #include "logdevice/common/stats/PerShardHistograms.h"
+#include "logdevice/server/locallogstore/LogAppendMemTableRep.h"
 #include "logdevice/server/locallogstore/RocksDBCustomiser.h"
 #include "logdevice/server/locallogstore/RocksDBMemTableRep.h"
 #include "logdevice/server/locallogstore/RocksDBSettings.h"
@@ -132,10 +133,19 @@ int RocksDBLogStoreBase::isCFEmpty(rocksdb::ColumnFamilyHandle* cf) const {
 
 void RocksDBLogStoreBase::installMemTableRep() {
   auto create_memtable_factory = [this]() {
-    mtr_factory_ = std::make_shared<RocksDBMemTableRepFactory>(
-        this,
-        std::make_unique<rocksdb::SkipListFactory>(
-            getSettings()->skip_list_lookahead));
+    std::unique_ptr<rocksdb::MemTableRepFactory> factory;
+    switch (getSettings()->memtable_rep) {
+      case MemTableRepType::SKIP_LIST:
+        factory = std::make_unique<rocksdb::SkipListFactory>(
+            getSettings()->skip_list_lookahead);
+        break;
+      case MemTableRepType::LOG_APPEND:
+        factory = std::make_unique<LogAppendMemTableRepFactory>();
+        break;
+    }
+    ld_check(factory);
+    mtr_factory_ =
+        std::make_shared<RocksDBMemTableRepFactory>(this, std::move(factory));
   };
 
   if (!rocksdb_config_.options_.memtable_factory) {
@@ -295,6 +305,81 @@ void RocksDBLogStoreBase::throttleIOIfNeeded(WriteBufStats buf_stats,
   }
 }
 
+double RocksDBLogStoreBase::WritePressureEstimator::update(
+    SteadyTimestamp now,
+    uint64_t memtable_usage,
+    uint64_t memtable_stall_threshold,
+    uint64_t compaction_backlog,
+    uint64_t compaction_backlog_stall_threshold,
+    std::chrono::milliseconds horizon) {
+  double horizon_sec = to_sec_double(horizon);
+  ld_check(horizon_sec > 0);
+
+  if (last_update_time_ != SteadyTimestamp::min() && now > last_update_time_) {
+    double elapsed = to_sec_double(now - last_update_time_);
+    // Exponential moving average with a time constant of the horizon.
+    double weight = std::min(1., elapsed / horizon_sec);
+    auto smooth = [&](double& rate, uint64_t prev, uint64_t cur) {
+      double sample = (static_cast<double>(cur) - prev) / elapsed;
+      rate += weight * (sample - rate);
+    };
+    smooth(memtable_growth_rate_, last_memtable_usage_, memtable_usage);
+    smooth(compaction_backlog_growth_rate_,
+           last_compaction_backlog_,
+           compaction_backlog);
+  }
+  last_update_time_ = now;
+  last_memtable_usage_ = memtable_usage;
+  last_compaction_backlog_ = compaction_backlog;
+
+  // 0 at half the stall threshold, 1 at the threshold, linear in between.
+  auto ramp = [&](double value, double growth_rate, uint64_t threshold) {
+    if (threshold == 0) {
+      return 0.;
+    }
+    double predicted = value + std::max(0., growth_rate) * horizon_sec;
+    double start = threshold / 2.;
+    double r = (predicted - start) / (threshold - start);
+    return std::max(0., std::min(1., r));
+  };
+  return std::max(
+      ramp(memtable_usage, memtable_growth_rate_, memtable_stall_threshold),
+      ramp(compaction_backlog,
+           compaction_backlog_growth_rate_,
+           compaction_backlog_stall_threshold));
+}
+
+void RocksDBLogStoreBase::updateWritePressure(
+    const WriteBufStats& buf_stats,
+    uint64_t memory_limit,
+    uint64_t compaction_backlog,
+    uint64_t compaction_backlog_stall_threshold) {
+  auto settings = getSettings();
+  double pressure = 0;
+  if (settings->predictive_write_throttling_) {
+    // Same threshold as in throttleIOIfNeeded(). Without ld-managed flushes
+    // only the compaction backlog counts.
+    uint64_t memtable_stall_threshold = 0;
+    if (rocksdb_config_.use_ld_managed_flushes_) {
+      memtable_stall_threshold = static_cast<uint64_t>(
+          memory_limit / 2 * settings->low_pri_write_stall_threshold_percent /
+          100);
+    }
+    pressure =
+        write_pressure_estimator_.update(SteadyTimestamp::now(),
+                                         buf_stats.active_memory_usage,
+                                         memtable_stall_threshold,
+                                         compaction_backlog,
+                                         compaction_backlog_stall_threshold,
+                                         settings->write_pressure_horizon_);
+  }
+  write_pressure_.store(pressure);
+  PER_SHARD_STAT_SET(stats_,
+                     write_pressure_percent,
+                     shard_idx_,
+                     static_cast<int64_t>(pressure * 100));
+}
+
 void RocksDBLogStoreBase::disableWriteStalling() {
   {
     std::lock_guard<std::mutex> lock(throttle_state_mutex_);
@@ -307,6 +392,20 @@ void RocksDBLogStoreBase::stallLowPriWrite() {
   WriteThrottleState throttle = write_throttle_state_.load();
 
   if (throttle == WriteThrottleState::NONE) {
+    // Not stalled yet, but slow down in proportion to write pressure, so that
+    // flushes and compactions can catch up before we have to stall.
+    double pressure = write_pressure_.load();
+    std::chrono::microseconds delay =
+        to_usec(getSettings()->low_pri_write_max_delay_);
+    delay = std::chrono::microseconds(
+        static_cast<int64_t>(delay.count() * pressure));
+    if (delay.count() <= 0) {
+      return;
+    }
+    PER_SHARD_STAT_ADD(
+        stats_, low_pri_write_delay_microsec, shard_idx_, delay.count());
+    std::unique_lock<std::mutex> lock(throttle_state_mutex_);
+    throttle_state_cv_.wait_for(lock, delay, [&] { return disable_stalling_; });
     return;
   }
 
@@ -361,6 +460,10 @@ rocksdb::ReadOptions RocksDBLogStoreBase::translateReadOptions(
   // allows us to cache and reuse the iterator.
   rocks_options.tailing = opts.tailing;
 
+  if (opts.allow_blocking_io && opts.readahead_bytes > 0) {
+    rocks_options.readahead_size = opts.readahead_bytes;
+  }
+
   if (upper_bound != nullptr && !upper_bound->empty()) {
     // Since this iterator is only used to read data for a given log, setting
     // iterate_upper_bound allows RocksDB to release some resources when child
@@ -426,6 +529,13 @@ int RocksDBLogStoreBase::updateLogMetadata(logid_t log_id,
   return writer_->updateLogMetadata(
       log_id, metadata, write_options, getMetadataCFHandle());
 }
+int RocksDBLogStoreBase::updateLogMetadataBatch(
+    const std::vector<std::pair<logid_t, ComparableLogMetadata*>>& updates,
+    std::vector<Status>& statuses_out,
+    const WriteOptions& write_options) {
+  return writer_->updateLogMetadataBatch(
+      updates, statuses_out, write_options, getMetadataCFHandle());
+}
 int RocksDBLogStoreBase::updatePerEpochLogMetadata(
     logid_t log_id,
     epoch_t epoch,
@@ -371,6 +371,10 @@ class RocksDBLogStoreBase : public LocalLogStore {
       logid_t log_id,
       ComparableLogMetadata& metadata,
       const WriteOptions& write_options = WriteOptions()) override;
+  int updateLogMetadataBatch(
+      const std::vector<std::pair<logid_t, ComparableLogMetadata*>>& updates,
+      std::vector<Status>& statuses_out,
+      const WriteOptions& write_options = WriteOptions()) override;
   int updatePerEpochLogMetadata(
       logid_t log_id,
       epoch_t epoch,
@@ -422,6 +426,40 @@ class RocksDBLogStoreBase : public LocalLogStore {
     return write_throttle_state_.load();
   }
 
+  double getWritePressure() override {
+    return write_pressure_.load();
+  }
+
+  // Estimates write pressure (see LocalLogStore::getWritePressure()) from
+  // memtable usage and compaction backlog, extrapolated by their growth rates
+  // smoothed over the horizon. Growth is what writes add minus what flushes
+  // and compactions take away, so pressure rises early when writes outpace
+  // them, rather than when a stall threshold has already been crossed.
+  class WritePressureEstimator {
+   public:
+    // @param memtable_stall_threshold  active memtable size at which
+    //                                  throttleIOIfNeeded() stalls writes, or
+    //                                  0 to ignore memtables.
+    // @param compaction_backlog  e.g. number of pending partial compactions.
+    // @param compaction_backlog_stall_threshold  backlog at which the store
+    //                                            stalls writes, or 0.
+    // @return  write pressure, in [0, 1].
+    double update(SteadyTimestamp now,
+                  uint64_t memtable_usage,
+                  uint64_t memtable_stall_threshold,
+                  uint64_t compaction_backlog,
+                  uint64_t compaction_backlog_stall_threshold,
+                  std::chrono::milliseconds horizon);
+
+   private:
+    SteadyTimestamp last_update_time_{SteadyTimestamp::min()};
+    uint64_t last_memtable_usage_{0};
+    uint64_t last_compaction_backlog_{0};
+    // Smoothed growth rates, per second.
+    double memtable_growth_rate_{0};
+    double compaction_backlog_growth_rate_{0};
+  };
+
   // A wrapper around rocksdb::DB::Write() which also updates stats and injects
   // IO errors if needed. Subclasses can override it to add some hooks to all
   // rocksdb writes.
@@ -558,6 +596,14 @@ class RocksDBLogStoreBase : public LocalLogStore {
 
   void disableWriteStalling() override;
 
+  // Recalculates write pressure if predictive throttling is enabled. See
+  // WritePressureEstimator::update() for the compaction backlog arguments.
+  // Must not be called concurrently.
+  void updateWritePressure(const WriteBufStats& buf_stats,
+                           uint64_t memory_limit,
+                           uint64_t compaction_backlog,
+                           uint64_t compaction_backlog_stall_threshold);
+
   // Called from throttleIOIfNeeded(). If you're overriding
   // subclassSuggestedThrottleState(), you must call throttleIOIfNeeded()
   // periodically.
@@ -630,6 +676,10 @@ class RocksDBLogStoreBase : public LocalLogStore {
   // When write_throttle_state_ was recalculated.
   SteadyTimestamp last_throttle_update_time_{SteadyTimestamp::min()};
 
+  // See getWritePressure(). Only set by updateWritePressure().
+  std::atomic<double> write_pressure_{0};
+  WritePressureEstimator write_pressure_estimator_;
+
   // Installs a MemTableRepFactory so that LogDevice's MemTabelRep is
   // used when constructing all MemTables.
   void installMemTableRep();
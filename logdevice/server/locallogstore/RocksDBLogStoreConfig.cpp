@@ -9,6 +9,7 @@
 
 #include <rocksdb/db.h>
 #include <rocksdb/filter_policy.h>
+#include <rocksdb/memory_allocator.h>
 #include <rocksdb/options.h>
 #include <rocksdb/slice_transform.h>
 #include <rocksdb/sst_file_manager.h>
@@ -16,6 +17,7 @@
 #include <rocksdb/table.h>
 #include <rocksdb/write_buffer_manager.h>
 
+#include "logdevice/common/MemoryArenas.h"
 #include "logdevice/server/locallogstore/RocksDBCache.h"
 #include "logdevice/server/locallogstore/RocksDBCompactionFilter.h"
 #include "logdevice/server/locallogstore/RocksDBEnv.h"
@@ -231,11 +233,43 @@ RocksDBLogStoreConfig::RocksDBLogStoreConfig(
       metadata_options_.table_factory.reset(
           rocksdb::NewBlockBasedTableFactory(metadata_table_options_));
     }
+    if (rocksdb_settings_->metadata_compression_.has_value()) {
+      metadata_options_.compression =
+          rocksdb_settings_->metadata_compression_.value();
+    }
     if (rocksdb_settings_->enable_insert_hint_) {
       metadata_options_.memtable_insert_with_hint_prefix_extractor.reset(
           rocksdb::NewNoopTransform());
     }
+
+    // Unpartitioned column family shares the block cache with data
+    // partitions, but may use a different block size.
+    if (rocksdb_settings_->unpartitioned_block_size_ > 0) {
+      rocksdb::BlockBasedTableOptions unpartitioned_table_options =
+          table_options_;
+      unpartitioned_table_options.block_size =
+          rocksdb_settings_->unpartitioned_block_size_;
+      unpartitioned_table_options.flush_block_policy_factory = nullptr;
+      unpartitioned_table_factory_.reset(
+          rocksdb::NewBlockBasedTableFactory(unpartitioned_table_options));
+    }
+  }
+}
+
+rocksdb::ColumnFamilyOptions
+RocksDBLogStoreConfig::getUnpartitionedCFOptions() const {
+  rocksdb::ColumnFamilyOptions cf_options(options_);
+  if (!rocksdb_settings_->partitioned) {
+    return cf_options;
+  }
+  if (unpartitioned_table_factory_) {
+    cf_options.table_factory = unpartitioned_table_factory_;
+  }
+  if (rocksdb_settings_->unpartitioned_compression_.has_value()) {
+    cf_options.compression =
+        rocksdb_settings_->unpartitioned_compression_.value();
   }
+  return cf_options;
 }
 
 void RocksDBLogStoreConfig::createMergeOperator(shard_index_t this_shard) {
@@ -267,9 +301,33 @@ void RocksDBLogStoreConfig::addSstFileManagerForShard() {
   }
 }
 
+namespace {
+
+// Allocates blocks of the block caches from their dedicated memory arena, see
+// MemoryArenas.h.
+class ArenaMemoryAllocator : public rocksdb::MemoryAllocator {
+ public:
+  const char* Name() const override {
+    return "LogDeviceArenaMemoryAllocator";
+  }
+  void* Allocate(size_t size) override {
+    return MemoryArenas::allocate(MemoryArena::ROCKSDB_BLOCK_CACHE, size);
+  }
+  void Deallocate(void* p) override {
+    MemoryArenas::deallocate(p);
+  }
+};
+
+} // namespace
+
 std::shared_ptr<rocksdb::MemoryAllocator>
 RocksDBLogStoreConfig::getMemoryAllocator() {
   if (!rocksdb_settings_->use_nocachedump_memory_allocator) {
+    // The nodump allocator uses an arena of its own, so the dedicated arena
+    // is only used without it.
+    if (MemoryArenas::enabled()) {
+      return std::make_shared<ArenaMemoryAllocator>();
+    }
     return nullptr;
   }
 
@@ -8,6 +8,8 @@
 #pragma once
 
 #include <rocksdb/env.h>
+#include <rocksdb/options.h>
+#include <rocksdb/table.h>
 
 #include "logdevice/common/configuration/UpdateableConfig.h"
 #include "logdevice/common/settings/RebuildingSettings.h"
@@ -83,6 +85,20 @@ struct RocksDBLogStoreConfig {
   rocksdb::ColumnFamilyOptions metadata_options_;
   rocksdb::BlockBasedTableOptions metadata_table_options_;
 
+  // Table factory for the column family of unpartitioned logs, if
+  // rocksdb-unpartitioned-block-size asks for a different block size than
+  // data partitions (only if partitioned = true).
+  std::shared_ptr<rocksdb::TableFactory> unpartitioned_table_factory_;
+
+  /**
+   * Options for the column family of unpartitioned logs (metadata logs and
+   * internal logs) in PartitionedRocksDBStore: a copy of `options_` with
+   * block size and compression overridden by the rocksdb-unpartitioned-*
+   * settings. Computed on each call because `options_` is still modified
+   * after construction, e.g. by createMergeOperator().
+   */
+  rocksdb::ColumnFamilyOptions getUnpartitionedCFOptions() const;
+
   UpdateableSettings<RocksDBSettings> rocksdb_settings_;
   UpdateableSettings<RebuildingSettings> rebuilding_settings_;
 
@@ -32,6 +32,34 @@ using namespace facebook::logdevice::setting_validators;
 
 namespace facebook { namespace logdevice {
 
+namespace {
+
+rocksdb::CompressionType parse_compression_type(const std::string& val,
+                                                const char* option) {
+  if (val == "snappy") {
+    return rocksdb::kSnappyCompression;
+  } else if (val == "none") {
+    return rocksdb::kNoCompression;
+  } else if (val == "zlib") {
+    return rocksdb::kZlibCompression;
+  } else if (val == "bzip2") {
+    return rocksdb::kBZip2Compression;
+  } else if (val == "lz4") {
+    return rocksdb::kLZ4Compression;
+  } else if (val == "lz4hc") {
+    return rocksdb::kLZ4HCCompression;
+  } else if (val == "xpress") {
+    return rocksdb::kXpressCompression;
+  } else if (val == "zstd") {
+    return rocksdb::kZSTD;
+  } else {
+    throw boost::program_options::error("invalid value '" + val +
+                                        "' for option --" + option);
+  }
+}
+
+} // namespace
+
 void RocksDBSettings::defineSettings(SettingEasyInit& init) {
   using namespace SettingFlag;
 
@@ -59,27 +87,7 @@ void RocksDBSettings::defineSettings(SettingEasyInit& init) {
        &compression,
        "lz4",
        [](const std::string& val) {
-         if (val == "snappy") {
-           return rocksdb::kSnappyCompression;
-         } else if (val == "none") {
-           return rocksdb::kNoCompression;
-         } else if (val == "zlib") {
-           return rocksdb::kZlibCompression;
-         } else if (val == "bzip2") {
-           return rocksdb::kBZip2Compression;
-         } else if (val == "lz4") {
-           return rocksdb::kLZ4Compression;
-         } else if (val == "lz4hc") {
-           return rocksdb::kLZ4HCCompression;
-         } else if (val == "xpress") {
-           return rocksdb::kXpressCompression;
-         } else if (val == "zstd") {
-           return rocksdb::kZSTD;
-         } else {
-           throw boost::program_options::error(
-               "invalid value '" + val +
-               "' for option --rocksdb-compression-type");
-         }
+         return parse_compression_type(val, "rocksdb-compression-type");
        },
        "compression algorithm: 'lz4' (default), 'lz4hc', 'snappy', "
        "'zlib', 'bzip2', 'zstd', 'none'",
@@ -194,6 +202,16 @@ void RocksDBSettings::defineSettings(SettingEasyInit& init) {
        "of any issues caused by compaction optimizations.",
        SERVER | DEPRECATED,
        SettingsCategory::RocksDB);
+  init("rocksdb-compaction-trim-point-snapshot-min-logs",
+       &compaction_trim_point_snapshot_min_logs,
+       "10000",
+       nullptr,
+       "After a compaction has encountered this many different logs, it "
+       "copies the trim points of all logs of the shard into a sorted array "
+       "and looks them up there instead of in the log state map. This makes "
+       "compactions of shards with many logs cheaper in CPU. 0 disables.",
+       SERVER,
+       SettingsCategory::RocksDB);
   init("rocksdb-enable-insert-hint",
        &enable_insert_hint_,
        "true",
@@ -236,6 +254,29 @@ void RocksDBSettings::defineSettings(SettingEasyInit& init) {
        "--rocksdb-cache-high-pri-pool-ratio).",
        SERVER,
        SettingsCategory::RocksDB);
+  init("rocksdb-cache-background-reads-low-priority",
+       &cache_background_reads_low_priority_,
+       "false",
+       nullptr,
+       "If true, SST blocks read by compactions and rebuilding are added to "
+       "the block cache at low priority, even if they're smaller than "
+       "--rocksdb-cache-small-block-threshold-for-high-priority. Keeps a big "
+       "background scan from evicting the blocks that tailing readers use. "
+       "Only makes a difference if --rocksdb-cache-high-pri-pool-ratio is "
+       "nonzero.",
+       SERVER,
+       SettingsCategory::RocksDB);
+  init("rocksdb-cache-tail-partitions-high-priority",
+       &cache_tail_partitions_high_priority_,
+       "0",
+       nullptr,
+       "SST blocks that readers read from this many newest partitions of a "
+       "shard are added to the block cache at high priority, i.e. they share "
+       "the pool sized by --rocksdb-cache-high-pri-pool-ratio with index and "
+       "filter blocks and small blocks. 0 to disable. Only applies to "
+       "partitioned shards.",
+       SERVER,
+       SettingsCategory::RocksDB);
 
   init("rocksdb-read-amp-bytes-per-bit",
        &read_amp_bytes_per_bit_,
@@ -286,6 +327,81 @@ void RocksDBSettings::defineSettings(SettingEasyInit& init) {
        SERVER,
        SettingsCategory::LogsDB);
 
+  init("rocksdb-partition-compaction-min-reclaim-ratio",
+       &partition_compaction_min_reclaim_ratio,
+       "0",
+       [](double val) {
+         if (val < 0 || val > 1) {
+           throw boost::program_options::error(
+               "value of --rocksdb-partition-compaction-min-reclaim-ratio must "
+               "be in [0, 1]; " +
+               std::to_string(val) + " given.");
+         }
+       },
+       "Only run a retention-based compaction of a partition if at least this "
+       "fraction of its records belong to logs that are trimmed in it, "
+       "according to the size estimates in partition directory. A few logs "
+       "with long retention can keep a partition from being dropped for a "
+       "long time; without this limit, they get rewritten by a compaction "
+       "every time a shorter backlog duration expires. With it, the partition "
+       "is compacted once it's mostly trimmed, or dropped whole if that "
+       "happens first. 0 compacts whenever any backlog duration from "
+       "rocksdb-partition-compaction-schedule expires.",
+       SERVER,
+       SettingsCategory::LogsDB);
+
+  init("rocksdb-partition-compaction-order-by-reclaim",
+       &partition_compaction_order_by_reclaim,
+       "false",
+       nullptr,
+       "If true, retention-based compactions are ordered by the estimated "
+       "fraction of the partition that belongs to trimmed logs, according to "
+       "the size estimates in partition directory, highest first. Compacting "
+       "a partition rewrites the records that aren't trimmed, so this runs "
+       "first the compactions that reclaim the most space per byte of IO. If "
+       "false, they are ordered by backlog duration and partition age.",
+       SERVER,
+       SettingsCategory::LogsDB);
+
+  init("rocksdb-partition-compaction-io-budget",
+       &partition_compaction_io_budget,
+       "unlimited",
+       [](const std::string& val) {
+         rate_limit_t r;
+         int rv = parse_rate_limit(val.c_str(), &r);
+         if (rv != 0) {
+           throw boost::program_options::error(
+               "invalid value '" + val +
+               "' for option --rocksdb-partition-compaction-io-budget; "
+               "expected rate limit in format "
+               "<count><suffix>/<duration><unit>, e.g. 100G/1h or "
+               "\"unlimited\".");
+         }
+         return r;
+       },
+       "Limits how fast each shard starts partition compactions, in bytes of "
+       "compacted partitions (or sst files, for partial compactions) per unit "
+       "of time; format is <count><suffix>/<duration><unit>, e.g. 100G/1h. "
+       "Compactions over the budget are postponed to the next iterations of "
+       "the low-priority background thread, so that a burst of compactions "
+       "(e.g. after many logs expire at once) is spread over time instead of "
+       "competing with reads and writes. Manual compactions are not limited. "
+       "Unlike --rocksdb-compaction-ratelimit, this doesn't slow down "
+       "compactions, only delays starting them.",
+       SERVER,
+       SettingsCategory::LogsDB);
+
+  init("rocksdb-partition-compaction-backoff-read-latency",
+       &partition_compaction_backoff_read_latency,
+       "0us",
+       validate_nonnegative<ssize_t>(),
+       "If positive, the low-priority background thread of each shard "
+       "postpones partition compactions (except manual ones) while the "
+       "average latency of sst file reads on the shard since its previous "
+       "iteration is above this value. Requires --rocksdb-enable-statistics.",
+       SERVER,
+       SettingsCategory::LogsDB);
+
   init("rocksdb-proactive-compaction-enabled",
        &proactive_compaction_enabled,
        "false",
@@ -304,6 +420,35 @@ void RocksDBSettings::defineSettings(SettingEasyInit& init) {
        SERVER,
        SettingsCategory::RocksDB);
 
+  init("rocksdb-partition-cold-path",
+       &partition_cold_path_,
+       "",
+       nullptr,
+       "If not empty, partitions whose newest record is older than "
+       "--rocksdb-partition-cold-age are moved by compaction to a "
+       "subdirectory of this path, e.g. on a cheaper or remote-backed "
+       "device, keeping the shard directory for recent data. Reads are "
+       "served from either location transparently. Once some data was moved, "
+       "the path must stay configured for as long as the data is retained; "
+       "the shard won't open without it.",
+       SERVER | REQUIRES_RESTART,
+       SettingsCategory::LogsDB);
+
+  init("rocksdb-partition-cold-age",
+       &partition_cold_age_,
+       "1d",
+       [](std::chrono::seconds val) {
+         if (val.count() <= 0) {
+           throw boost::program_options::error(
+               "value of --rocksdb-partition-cold-age must be positive; " +
+               std::to_string(val.count()) + "s given.");
+         }
+       },
+       "Partitions whose newest record is older than this are moved to "
+       "--rocksdb-partition-cold-path, if it's set.",
+       SERVER,
+       SettingsCategory::LogsDB);
+
   init("rocksdb-partition-duration",
        &partition_duration_,
        "15min",
@@ -465,6 +610,20 @@ void RocksDBSettings::defineSettings(SettingEasyInit& init) {
        SERVER,
        SettingsCategory::LogsDB);
 
+  init("rocksdb-rebuilding-ingest-min-records",
+       &rebuilding_ingest_min_records_,
+       "0",
+       nullptr,
+       "If a write batch has at least this many rebuilding records for the "
+       "same partition other than the two latest, write them into an sst "
+       "file and ingest it into the partition, bypassing WAL and memtable. "
+       "This saves the memtable flushes and partial compactions that "
+       "rebuilding old partitions otherwise causes. Ingested records are "
+       "durable right away. Larger --write-batch-size and "
+       "--write-batch-bytes give larger files. 0 disables ingestion.",
+       SERVER,
+       SettingsCategory::LogsDB);
+
   init(
       "rocksdb-partition-count-soft-limit",
       &partition_count_soft_limit_,
@@ -641,6 +800,27 @@ void RocksDBSettings::defineSettings(SettingEasyInit& init) {
       SERVER,
       SettingsCategory::RocksDB);
 
+  init("rocksdb-flush-trigger-spread",
+       &flush_trigger_spread,
+       "0",
+       [](double val) {
+         if (val < 0 || val >= 1) {
+           throw boost::program_options::error(
+               "value of --rocksdb-flush-trigger-spread must be in [0, 1); " +
+               std::to_string(val) + " given.");
+         }
+       },
+       "Shorten rocksdb-partition-data-age-flush-trigger and "
+       "rocksdb-partition-idle-flush-trigger on each shard by a fraction in "
+       "[0, this value), chosen deterministically from node and shard index. "
+       "Since all replicas of a record receive it at about the same time, "
+       "equal triggers make the whole copyset flush the same data at once, "
+       "causing correlated IO bursts and STORE latency spikes. E.g. 0.3 "
+       "spreads the flushes of a 1200s data age trigger over 840s-1200s. "
+       "0 disables.",
+       SERVER,
+       SettingsCategory::RocksDB);
+
   init("rocksdb-partition-redirty-grace-period",
        &partition_redirty_grace_period,
        "5s",
@@ -744,6 +924,20 @@ void RocksDBSettings::defineSettings(SettingEasyInit& init) {
        SERVER,
        SettingsCategory::LogsDB);
 
+  init("rocksdb-group-commit",
+       &group_commit,
+       "false",
+       nullptr,
+       "If true, write batches that storage threads of a shard issue "
+       "concurrently are concatenated and written to rocksdb by one of the "
+       "threads, as one WAL write followed by one memtable-only write. "
+       "Without it, rocksdb can't merge the WAL writes of different threads "
+       "if they are interleaved with memtable-only (e.g. rebuilding) writes. "
+       "Syncing the WAL for SYNC_WRITE stores is already shared across "
+       "threads by the syncing storage thread.",
+       SERVER,
+       SettingsCategory::LogsDB);
+
   init("rocksdb-low-ioprio",
        &low_ioprio,
        "",
@@ -821,6 +1015,19 @@ void RocksDBSettings::defineSettings(SettingEasyInit& init) {
        SERVER,
        SettingsCategory::LogsDB);
 
+  init("rocksdb-wal-dir",
+       &wal_dir,
+       "",
+       nullptr,
+       "If not empty, each shard keeps its write-ahead log in subdirectory "
+       "shard<N> of this directory instead of in the shard's own directory. "
+       "Meant to put WALs on a dedicated low-latency device (e.g. NVMe), so "
+       "that the latency of durable writes doesn't depend on compactions and "
+       "rebuilding reads on the data disks. When this setting changes, WAL "
+       "files are moved to the new location before the shard is opened.",
+       SERVER | REQUIRES_RESTART,
+       SettingsCategory::LogsDB);
+
   init("rocksdb-wal-buffer-size",
        &wal_buffer_size,
        "8M",
@@ -870,6 +1077,21 @@ void RocksDBSettings::defineSettings(SettingEasyInit& init) {
        SERVER,
        SettingsCategory::LogsDB);
 
+  init("rocksdb-find-time-index-scan-limit",
+       &find_time_index_scan_limit,
+       "0",
+       nullptr,
+       "If --rocksdb-read-find-time-index is set, findTime looks up the two "
+       "index entries around the target timestamp and then reads up to this "
+       "many records between them to find the exact result. Needed if the "
+       "index is sparse (see --write-find-time-index-interval); should be "
+       "at least the number of records a log gets on this shard per index "
+       "interval. If the limit is reached, findTime returns the narrowed "
+       "range of LSNs it got so far. 0 means trusting the index entries, "
+       "which is exact if every record is indexed.",
+       SERVER,
+       SettingsCategory::LogsDB);
+
   init("rocksdb-read-only",
        &read_only,
        "false",
@@ -964,6 +1186,66 @@ void RocksDBSettings::defineSettings(SettingEasyInit& init) {
        SERVER,
        SettingsCategory::LogsDB);
 
+  init("rocksdb-directory-index-memory-budget",
+       &directory_index_memory_budget,
+       "256M",
+       parse_nonnegative<ssize_t>(),
+       "Maximum total memory per shard used by compact in-memory indexes of "
+       "the partition directory. Each log with data in partitions gets an "
+       "index of its directory entries sorted by LSN, used by findTime to "
+       "locate partitions with a binary search in memory instead of seeking "
+       "in the metadata column family. Indexes are built lazily and rebuilt "
+       "after the log's directory changes (e.g. after partitions are "
+       "dropped). Logs whose index doesn't fit in the budget fall back to "
+       "searching the on-disk directory. 0 disables the indexes.",
+       SERVER,
+       SettingsCategory::LogsDB);
+
+  init("rocksdb-iterator-parallel-seek-partitions",
+       &iterator_parallel_seek_partitions,
+       "0",
+       nullptr,
+       "When a blocking read iterator in partitioned mode has to move past "
+       "partitions to find the next record of a log (e.g. seeking to an LSN in "
+       "an old partition, or skipping partitions that have directory entries "
+       "but no records), probe up to this many upcoming partitions for the "
+       "log concurrently instead of one after another. 0 or 1 disables "
+       "parallel probing. Useful for backfill readers of logs spread over many "
+       "small partitions.",
+       SERVER | REQUIRES_RESTART,
+       SettingsCategory::LogsDB);
+
+  init("rocksdb-iterator-parallel-seek-threads",
+       &iterator_parallel_seek_threads,
+       "4",
+       [](int val) {
+         if (val < 0) {
+           throw boost::program_options::error(
+               "value of --rocksdb-iterator-parallel-seek-threads must be "
+               "non-negative, " + std::to_string(val) + " given.");
+         }
+       },
+       "Number of threads per shard used for probing partitions concurrently "
+       "when --rocksdb-iterator-parallel-seek-partitions or "
+       "--rocksdb-findkey-parallel-probes is greater than 1. 0 disables "
+       "parallel probing.",
+       SERVER | REQUIRES_RESTART,
+       SettingsCategory::LogsDB);
+
+  init("rocksdb-findkey-parallel-probes",
+       &findkey_parallel_probes,
+       "0",
+       nullptr,
+       "When findKey() searches the custom key directory of a log on a "
+       "storage thread, look up this many partitions concurrently in each "
+       "step of the search instead of one, turning the binary search into a "
+       "k-ary one with fewer sequential rounds. Helps when the directory "
+       "isn't cached and the log spans many partitions. 0 or 1 disables "
+       "parallel lookups. Uses the threads of "
+       "--rocksdb-iterator-parallel-seek-threads.",
+       SERVER | REQUIRES_RESTART,
+       SettingsCategory::LogsDB);
+
   init("rocksdb-test-corrupt-stores",
        &test_corrupt_stores,
        "false",
@@ -1064,6 +1346,20 @@ void RocksDBSettings::defineSettings(SettingEasyInit& init) {
        SERVER,
        SettingsCategory::LogsDB);
 
+  init("rocksdb-partition-duration-trigger-min-size",
+       &partition_duration_trigger_min_size_,
+       "0",
+       parse_nonnegative<ssize_t>(),
+       "if the latest partition (including memtables) is smaller than this "
+       "when it reaches rocksdb-partition-duration age, keep writing to it "
+       "until it's 3 times that old or reaches this size. Together with "
+       "rocksdb-partition-size-limit this adapts partition cutover to the "
+       "write rate of the shard: bursts of writes produce more partitions, "
+       "quiet periods fewer. Delays trimming of quiet partitions by up to 2 "
+       "partition durations; 0 disables",
+       SERVER,
+       SettingsCategory::LogsDB);
+
   init("rocksdb-compaction-max-bytes-at-once",
        &compaction_max_bytes_at_once,
        "1048576",
@@ -1128,6 +1424,52 @@ void RocksDBSettings::defineSettings(SettingEasyInit& init) {
        SERVER | REQUIRES_RESTART,
        SettingsCategory::RocksDB);
 
+  init("rocksdb-metadata-compression-type",
+       &metadata_compression_,
+       "",
+       [](const std::string& val) -> folly::Optional<rocksdb::CompressionType> {
+         if (val.empty()) {
+           return folly::none;
+         }
+         return parse_compression_type(
+             val, "rocksdb-metadata-compression-type");
+       },
+       "compression algorithm for metadata column family (if "
+       "--rocksdb-partitioned), one of the values accepted by "
+       "--rocksdb-compression-type; if empty, same as "
+       "--rocksdb-compression-type",
+       SERVER | REQUIRES_RESTART,
+       SettingsCategory::RocksDB);
+
+  init("rocksdb-unpartitioned-block-size",
+       &unpartitioned_block_size_,
+       "0",
+       parse_nonnegative<ssize_t>(),
+       "approximate size of the uncompressed data block for the column family "
+       "of unpartitioned logs (if --rocksdb-partitioned), i.e. metadata logs "
+       "and internal logs, whose records are usually small; if zero, same as "
+       "--rocksdb-block-size. If set, --rocksdb-flush-block-policy does not "
+       "apply to this column family",
+       SERVER | REQUIRES_RESTART,
+       SettingsCategory::RocksDB);
+
+  init("rocksdb-unpartitioned-compression-type",
+       &unpartitioned_compression_,
+       "",
+       [](const std::string& val) -> folly::Optional<rocksdb::CompressionType> {
+         if (val.empty()) {
+           return folly::none;
+         }
+         return parse_compression_type(
+             val, "rocksdb-unpartitioned-compression-type");
+       },
+       "compression algorithm for the column family of unpartitioned logs (if "
+       "--rocksdb-partitioned), one of the values accepted by "
+       "--rocksdb-compression-type; if empty, same as "
+       "--rocksdb-compression-type",
+       SERVER | REQUIRES_RESTART,
+       SettingsCategory::RocksDB);
+
   init("rocksdb-min-block-size",
        &min_block_size_,
        "16384",
@@ -1227,6 +1569,29 @@ void RocksDBSettings::defineSettings(SettingEasyInit& init) {
        SERVER | REQUIRES_RESTART,
        SettingsCategory::RocksDB);
 
+  init("rocksdb-memtable-rep",
+       &memtable_rep,
+       "skiplist",
+       [](const std::string& val) -> MemTableRepType {
+         if (val == "skiplist") {
+           return MemTableRepType::SKIP_LIST;
+         } else if (val == "log-append") {
+           return MemTableRepType::LOG_APPEND;
+         }
+         throw boost::program_options::error(
+             "value of --rocksdb-memtable-rep must be one of: skiplist, "
+             "log-append. Got: " +
+             val);
+       },
+       "Data structure of memtables. 'skiplist' - rocksdb's default "
+       "skiplist. 'log-append' - entries are grouped by log and key type into "
+       "sorted vectors, each with its own lock; inserts of increasing keys "
+       "within a log are appends, and per-log scans of unflushed data read "
+       "contiguous memory. Inserts of out of order keys cost O(number of "
+       "keys of the log in the memtable).",
+       SERVER | REQUIRES_RESTART,
+       SettingsCategory::RocksDB);
+
   init("rocksdb-max-open-files",
        &max_open_files,
        "10000",
@@ -1531,6 +1896,56 @@ void RocksDBSettings::defineSettings(SettingEasyInit& init) {
        SERVER,
        SettingsCategory::LogsDB);
 
+  init("rocksdb-predictive-write-throttling",
+       &predictive_write_throttling_,
+       "false",
+       nullptr,
+       "If true, throttle writes gradually before memtables or the backlog "
+       "of partial compactions get large enough to stall or reject them. "
+       "Low-priority writes (e.g. rebuilding) are delayed by up to "
+       "--rocksdb-low-pri-write-max-delay as active memtable size and the "
+       "number of pending partial compactions, extrapolated by their growth "
+       "over --rocksdb-write-pressure-horizon, approach "
+       "--rocksdb-low-pri-write-stall-threshold-percent and "
+       "--rocksdb-partition-partial-compaction-stall-trigger. Once they are "
+       "predicted to reach them, STORED replies tell sequencers that the node "
+       "is overloaded, so that they pick other copysets.",
+       SERVER,
+       SettingsCategory::LogsDB);
+
+  init("rocksdb-write-pressure-horizon",
+       &write_pressure_horizon_,
+       "10s",
+       [](std::chrono::milliseconds val) {
+         if (val.count() <= 0) {
+           throw boost::program_options::error(
+               "value of --rocksdb-write-pressure-horizon must be positive; " +
+               std::to_string(val.count()) + "ms given.");
+         }
+       },
+       "With --rocksdb-predictive-write-throttling, how far ahead to "
+       "extrapolate the growth of memtables and of the partial compaction "
+       "backlog",
+       SERVER,
+       SettingsCategory::LogsDB);
+
+  init("rocksdb-low-pri-write-max-delay",
+       &low_pri_write_max_delay_,
+       "20ms",
+       [](std::chrono::milliseconds val) {
+         if (val.count() < 0) {
+           throw boost::program_options::error(
+               "value of --rocksdb-low-pri-write-max-delay must be "
+               "non-negative; " +
+               std::to_string(val.count()) + "ms given.");
+         }
+       },
+       "With --rocksdb-predictive-write-throttling, how long each batch of "
+       "low-priority writes is delayed when the shard is predicted to stall "
+       "writes. Smaller predictions give proportionally shorter delays.",
+       SERVER,
+       SettingsCategory::LogsDB);
+
   init("rocksdb-arena-block-size",
        &arena_block_size,
        "4194304",
@@ -1547,6 +1962,78 @@ void RocksDBSettings::defineSettings(SettingEasyInit& init) {
        SERVER | REQUIRES_RESTART,
        SettingsCategory::RocksDB);
 
+  init("rocksdb-io-uring-reads",
+       &io_uring_reads,
+       "false",
+       nullptr,
+       "If true, reads from sst files go through a per-thread io_uring instead "
+       "of pread(), and the reads of a MultiRead() are submitted together. "
+       "Ignored if logdeviced was built without liburing, or if "
+       "--rocksdb-use-direct-reads is set.",
+       SERVER | REQUIRES_RESTART,
+       SettingsCategory::RocksDB);
+
+  init("rocksdb-io-uring-queue-depth",
+       &io_uring_queue_depth,
+       "32",
+       parse_positive<ssize_t>(),
+       "Number of entries in each thread's io_uring, i.e. the maximum number "
+       "of reads submitted at once. See --rocksdb-io-uring-reads.",
+       SERVER | REQUIRES_RESTART,
+       SettingsCategory::RocksDB);
+
+  auto parse_sst_read_cache_policy = [](const char* setting_name) {
+    return [setting_name](const std::string& val) -> SstReadCachePolicy {
+      if (val == "normal") {
+        return SstReadCachePolicy::NORMAL;
+      } else if (val == "dontneed") {
+        return SstReadCachePolicy::DONTNEED;
+      } else if (val == "direct") {
+        return SstReadCachePolicy::DIRECT;
+      }
+      throw boost::program_options::error(
+          std::string("value of --") + setting_name +
+          " must be one of: normal, dontneed, direct. Got: " + val);
+    };
+  };
+
+  init("rocksdb-compaction-read-cache-policy",
+       &compaction_read_cache_policy,
+       "normal",
+       parse_sst_read_cache_policy("rocksdb-compaction-read-cache-policy"),
+       "How compactions read sst files, to keep them from evicting data that "
+       "readers need from the OS page cache. 'normal' - buffered reads, "
+       "'dontneed' - buffered reads followed by posix_fadvise(DONTNEED) on "
+       "the pages that weren't cached before the read, 'direct' - reads that "
+       "miss the page cache use O_DIRECT. Pages that are already cached are "
+       "read from the cache and left there in all cases. Unlike "
+       "--rocksdb-use-direct-io-for-flush-and-compaction, doesn't affect "
+       "writes and doesn't require a separate table reader for compaction "
+       "inputs. Ignored if --rocksdb-use-direct-reads is set.",
+       SERVER | REQUIRES_RESTART,
+       SettingsCategory::RocksDB);
+
+  init("rocksdb-rebuilding-read-cache-policy",
+       &rebuilding_read_cache_policy,
+       "normal",
+       parse_sst_read_cache_policy("rocksdb-rebuilding-read-cache-policy"),
+       "Like --rocksdb-compaction-read-cache-policy, but for the shard scans "
+       "done by rebuilding.",
+       SERVER | REQUIRES_RESTART,
+       SettingsCategory::RocksDB);
+
+  init("rocksdb-sst-read-page-cache-stats",
+       &sst_read_page_cache_stats,
+       "false",
+       nullptr,
+       "If true, count page cache hits and misses of all sst reads, broken "
+       "down by IO type (normal, compaction, rebuilding). Each read is first "
+       "attempted with preadv2(RWF_NOWAIT), so a miss costs an extra syscall. "
+       "Reads of IO types with a non-normal read cache policy are always "
+       "counted.",
+       SERVER | REQUIRES_RESTART,
+       SettingsCategory::RocksDB);
+
   init("rocksdb-use-direct-io-for-flush-and-compaction",
        &use_direct_io_for_flush_and_compaction,
        "false",
@@ -9,6 +9,7 @@
 
 #include <atomic>
 #include <chrono>
+#include <string>
 
 #include <rocksdb/db.h>
 #include <rocksdb/options.h>
@@ -84,6 +85,26 @@ enum class WALBufferingMode {
   DELAYED_APPEND,
 };
 
+// How sst reads of a given IOType (see IOType.h) treat the OS page cache.
+// See RocksDBRandomAccessFile.
+enum class SstReadCachePolicy {
+  // Plain buffered reads.
+  NORMAL,
+  // Buffered reads, followed by posix_fadvise(POSIX_FADV_DONTNEED) on the
+  // pages that weren't cached before the read.
+  DONTNEED,
+  // Reads that miss the page cache go through an O_DIRECT file descriptor.
+  DIRECT,
+};
+
+// Data structure of the memtables. See RocksDBLogStoreBase::installMemTableRep.
+enum class MemTableRepType {
+  // rocksdb's default skiplist.
+  SKIP_LIST,
+  // LogAppendMemTableRep: sorted per-log vectors.
+  LOG_APPEND,
+};
+
 class RocksDBSettings : public SettingsBundle {
  public:
   const char* getName() const override {
@@ -117,10 +138,16 @@ class RocksDBSettings : public SettingsBundle {
   // position.
   int skip_list_lookahead;
 
+  MemTableRepType memtable_rep;
+
   WALBufferingMode wal_buffering;
 
   uint64_t wal_buffer_size;
 
+  // If not empty, directory on a dedicated device in which shards keep their
+  // write-ahead logs, see ShardedRocksDBLocalLogStore::placeWAL().
+  std::string wal_dir;
+
   // IO priority to request for lo-pri rocksdb threads.
   folly::Optional<std::pair<int, int>> low_ioprio;
 
@@ -150,11 +177,36 @@ class RocksDBSettings : public SettingsBundle {
   using compaction_schedule_t = std::vector<std::chrono::seconds>;
   folly::Optional<compaction_schedule_t> partition_compaction_schedule;
 
+  // Skip retention-based compaction of a partition until at least this
+  // fraction of its data (according to directory size estimates) belongs to
+  // trimmed logs. See .cpp.
+  double partition_compaction_min_reclaim_ratio;
+
+  // Order retention-based compactions by the estimated fraction of the
+  // partition they reclaim, highest first. See .cpp.
+  bool partition_compaction_order_by_reclaim;
+
+  // Approximate limit on the rate at which the lo-pri background thread
+  // schedules compactions, in bytes of partitions compacted. See .cpp.
+  rate_limit_t partition_compaction_io_budget;
+
+  // Postpone compactions while the recent average latency of sst file reads
+  // is above this. Zero to disable. See .cpp.
+  std::chrono::microseconds partition_compaction_backoff_read_latency;
+
   // whether we're going to proactively compact all partitions
   // (besides two latest) that were never compacted.
   // Compacting will be done in low priority background thread
   bool proactive_compaction_enabled;
 
+  // If not empty, partitions older than partition_cold_age_ are compacted
+  // into this directory (under the shard's subdirectory), e.g. a cheaper
+  // device. Reads go through rocksdb as before.
+  std::string partition_cold_path_;
+
+  // A partition is cold once its newest record is this old.
+  std::chrono::seconds partition_cold_age_;
+
   // A new partition is created every time one of the following thresholds
   // reached hit for the latest partition:
   //  * age,
@@ -163,6 +215,9 @@ class RocksDBSettings : public SettingsBundle {
   size_t partition_size_limit_;
   //  * number of level-0 files.
   size_t partition_file_limit_;
+  // If the latest partition is smaller than this, the age threshold is
+  // tripled.
+  size_t partition_duration_trigger_min_size_;
 
   // How much time to wait before trimming records for a log
   // that is no longer in the config.
@@ -190,6 +245,11 @@ class RocksDBSettings : public SettingsBundle {
   size_t partition_partial_compaction_max_num_per_loop_;
   size_t partition_partial_compaction_stall_trigger_;
 
+  // If a write batch has at least this many rebuilding records for a
+  // partition other than the two latest, build an sst file out of them and
+  // ingest it instead of writing them through the memtable. 0 disables.
+  size_t rebuilding_ingest_min_records_;
+
   // The largest l0 files that it is beneficial to compact on their own. note
   // that we can still compact larger files than this if that enables us to
   // compact a longer range of consecutive files. e.g. if there are smaller
@@ -250,6 +310,11 @@ class RocksDBSettings : public SettingsBundle {
   // its uncommitted data.
   std::chrono::milliseconds partition_idle_flush_trigger;
 
+  // The data age and idle flush triggers of each shard are shortened by a
+  // node-specific fraction in [0, flush_trigger_spread), to avoid all
+  // replicas of the same data flushing it at the same time.
+  double flush_trigger_spread;
+
   // Minimum guaranteed time period for a node to re-dirty a partition after
   // a MemTable is flushed without incurring a synchronous write penalty to
   // update the partition dirty metadata
@@ -270,6 +335,10 @@ class RocksDBSettings : public SettingsBundle {
   // Verify checksum on each store, reject with error if it fails (see .cpp)
   bool verify_checksum_during_store{true};
 
+  // Merge concurrent writeMulti() calls from different storage threads into
+  // a single rocksdb write. See RocksDBWriter::groupCommit().
+  bool group_commit;
+
   // Disable the iterate_upper_bound optimization.
   // TODO(#8945358): Remove this option once #8945358 is fixed.
   bool disable_iterate_upper_bound;
@@ -282,12 +351,24 @@ class RocksDBSettings : public SettingsBundle {
   // instead of doing a binary search in the relevant partition.
   bool read_find_time_index;
 
+  // With read_find_time_index, the maximum number of records findTime scans
+  // between two consecutive index entries to find the exact result.
+  size_t find_time_index_scan_limit;
+
   // If true, PartitionedRocksDBStore will be opened in read only mode.
   bool read_only;
 
   // If true, tracks iterator superversions for the info iterators admin command
   bool track_iterator_versions;
 
+  // See .cpp
+  size_t directory_index_memory_budget;
+
+  // See .cpp
+  size_t iterator_parallel_seek_partitions;
+  int iterator_parallel_seek_threads;
+  size_t findkey_parallel_probes;
+
   // See cpp file for doc.
   rate_limit_t compaction_rate_limit_;
 
@@ -320,6 +401,15 @@ class RocksDBSettings : public SettingsBundle {
   // same for metadata column family (if partitioned = true)
   size_t metadata_block_size_;
 
+  // compression for metadata column family (if partitioned = true);
+  // folly::none means same as `compression`
+  folly::Optional<rocksdb::CompressionType> metadata_compression_;
+
+  // block size and compression for the column family of unpartitioned logs
+  // (if partitioned = true); 0 and folly::none mean same as data partitions
+  size_t unpartitioned_block_size_;
+  folly::Optional<rocksdb::CompressionType> unpartitioned_compression_;
+
   // size of uncompressed block cache
   size_t cache_size_;
 
@@ -329,6 +419,14 @@ class RocksDBSettings : public SettingsBundle {
 
   size_t cache_small_block_threshold_for_high_priority_;
 
+  // If true, blocks read by compactions and rebuilding are inserted into the
+  // block cache at low priority, regardless of their size.
+  bool cache_background_reads_low_priority_;
+
+  // Blocks that readers read from this many newest partitions are inserted
+  // into the block cache at high priority. 0 to disable.
+  size_t cache_tail_partitions_high_priority_;
+
   // size of compressed block cache (disabled by default)
   size_t compressed_cache_size_;
 
@@ -357,6 +455,9 @@ class RocksDBSettings : public SettingsBundle {
   // See .cpp
   bool force_no_compaction_optimizations_;
 
+  // See .cpp
+  size_t compaction_trim_point_snapshot_min_logs;
+
   // Used for testing only. If true, a node will report all stores it receives
   // as corrupted.
   bool test_corrupt_stores{false};
@@ -399,6 +500,19 @@ class RocksDBSettings : public SettingsBundle {
   double low_pri_write_stall_threshold_percent;
   double pinned_memtables_limit_percent;
 
+  // If true, the flush thread estimates write pressure: how close memtable
+  // usage and the partial compaction backlog are to stalling writes,
+  // extrapolated by their recent growth. Low-priority writes are delayed in
+  // proportion to it, and stores are reported as overloaded to sequencers
+  // when it reaches 1.
+  bool predictive_write_throttling_;
+
+  // How far ahead write pressure extrapolates growth.
+  std::chrono::milliseconds write_pressure_horizon_;
+
+  // Delay of a low-priority write batch at write pressure 1.
+  std::chrono::milliseconds low_pri_write_max_delay_;
+
   // See .cpp
   std::chrono::milliseconds flush_trigger_check_interval;
 
@@ -447,6 +561,13 @@ class RocksDBSettings : public SettingsBundle {
   bool auto_create_shards;
   bool use_direct_reads;
   bool use_direct_io_for_flush_and_compaction;
+  // See RocksDBIOUringRandomAccessFile.
+  bool io_uring_reads;
+  size_t io_uring_queue_depth;
+  // See IOType.h and RocksDBRandomAccessFile.
+  SstReadCachePolicy compaction_read_cache_policy;
+  SstReadCachePolicy rebuilding_read_cache_policy;
+  bool sst_read_page_cache_stats;
   bool paranoid_checks;
 #ifdef LOGDEVICE_ROCKSDB_HAS_SKIP_CHECKING_SST_FILE_SIZES_ON_DB_OPEN
   bool skip_checking_sst_file_sizes_on_db_open;
@@ -8,9 +8,13 @@
 #include "logdevice/server/locallogstore/RocksDBWriter.h"
 
 #include <algorithm>
+#include <cstring>
+#include <limits>
+#include <map>
 
 #include <folly/small_vector.h>
 #include <rocksdb/env.h>
+#include <rocksdb/sst_file_writer.h>
 
 #include "logdevice/common/LocalLogStoreRecordFormat.h"
 #include "logdevice/common/Metadata.h"
@@ -32,6 +36,27 @@ static_assert(sizeof(DataKey) == 21, "expected 21");
 static_assert(sizeof(LogMetaKey) == 9, "expected 9");
 static_assert(sizeof(StoreMetaKey) == 1, "expected 1");
 
+std::vector<int> RocksDBWriter::checkRecordsWellFormed(
+    const std::vector<const WriteOp*>& writes) {
+  std::vector<std::pair<Slice, Slice>> records;
+  std::vector<size_t> indices;
+  for (size_t i = 0; i < writes.size(); ++i) {
+    if (writes[i]->getType() == WriteType::PUT) {
+      const PutWriteOp* op = static_cast<const PutWriteOp*>(writes[i]);
+      records.emplace_back(op->record_header, op->data);
+      indices.push_back(i);
+    }
+  }
+  std::vector<int> records_rv;
+  LocalLogStoreRecordFormat::checkWellFormed(records, records_rv);
+
+  std::vector<int> rv(writes.size(), 0);
+  for (size_t j = 0; j < indices.size(); ++j) {
+    rv[indices[j]] = records_rv[j];
+  }
+  return rv;
+}
+
 int RocksDBWriter::writeMulti(
     const std::vector<const WriteOp*>& writes,
     const LocalLogStore::WriteOptions& /*write_options*/,
@@ -50,16 +75,21 @@ int RocksDBWriter::writeMulti(
     return -1;
   }
 
-  size_t csi_entry_writes = 0;
-  size_t index_entry_writes = 0;
+  PutSizes sizes;
   SCOPE_EXIT {
-    STAT_ADD(store_->getStatsHolder(), csi_entry_writes, csi_entry_writes);
-    STAT_ADD(store_->getStatsHolder(), index_entry_writes, index_entry_writes);
+    STAT_ADD(
+        store_->getStatsHolder(), csi_entry_writes, sizes.csi_entry_writes);
+    STAT_ADD(
+        store_->getStatsHolder(), index_entry_writes, sizes.index_entry_writes);
   };
 
-  size_t record_bytes = 0;
-  size_t csi_bytes = 0;
-  size_t index_bytes = 0;
+  // Check all records of the batch at once, which is faster than one by one.
+  const bool verify_checksums = !skip_checksum_verification &&
+      store_->getSettings()->verify_checksum_during_store;
+  std::vector<int> well_formed;
+  if (verify_checksums) {
+    well_formed = checkRecordsWellFormed(writes);
+  }
 
   for (size_t i = 0; i < writes.size(); ++i) {
     const WriteOp* write = writes[i];
@@ -73,13 +103,9 @@ int RocksDBWriter::writeMulti(
       case WriteType::PUT: {
         const PutWriteOp* op = static_cast<const PutWriteOp*>(write);
 
-        DataKey key(op->log_id, op->lsn);
-
-        if (!skip_checksum_verification &&
-            store_->getSettings()->verify_checksum_during_store) {
+        if (verify_checksums) {
           // Reject to store malformed records.
-          rv = LocalLogStoreRecordFormat::checkWellFormed(
-              op->record_header, op->data);
+          rv = well_formed[i];
           if (rv != 0) {
             RATELIMIT_ERROR(std::chrono::seconds(10),
                             10,
@@ -108,86 +134,7 @@ int RocksDBWriter::writeMulti(
           }
         }
 
-        // NOTE: There is an assumption in prepare_write_op() in
-        // RocksDBWriterMergeOperator that the value in RocksDB will be
-        // exactly the concatenation of the header and data blobs.  If that
-        // ever changes here, take care to update the code there as well.
-        rocksdb::Slice key_slice =
-            key.sliceForWriting(op->TEST_data_key_format);
-
-        folly::small_vector<rocksdb::Slice, 3> value_slices;
-
-        // NOTE: At least RocksDBWriterMergeOperator and
-        // RocksDBCompactionFilter expect this format (header byte then same
-        // as normal non-merge stores).
-        value_slices.emplace_back(
-            &RocksDBWriterMergeOperator::DATA_MERGE_HEADER, 1);
-        value_slices.emplace_back(
-            reinterpret_cast<const char*>(op->record_header.data),
-            op->record_header.size);
-        value_slices.emplace_back(
-            reinterpret_cast<const char*>(op->data.data), op->data.size);
-
-        rocksdb_batch.Merge(
-            data_cf,
-            rocksdb::SliceParts(&key_slice, 1),
-            rocksdb::SliceParts(value_slices.data(), value_slices.size()));
-
-        record_bytes += key_slice.size();
-        for (const auto& s : value_slices) {
-          record_bytes += s.size();
-        }
-
-        if (op->copyset_index_lsn.has_value()) {
-          // Decide if we need to write a CSI entry.
-          // For internal logs, write CSI even if it's disabled in settings.
-          // This way if we want to enable CSI later we don't have to do
-          // any migration for internal logs.
-          if (store_->getSettings()->write_copyset_index_ ||
-              MetaDataLog::isMetaDataLog(op->log_id) ||
-              configuration::InternalLogs::isInternal(op->log_id)) {
-            // Writing copyset index entry
-            ++csi_entry_writes;
-            ld_check(op->copyset_index_entry.data);
-            ld_check(op->copyset_index_entry.size);
-            // TODO (t9002309): block records
-            ld_check(op->copyset_index_lsn.value() == LSN_INVALID);
-            lsn_t csi_lsn = op->lsn;
-
-            // Writing copyset index entry
-            CopySetIndexKey csi_key{op->log_id,
-                                    csi_lsn,
-                                    // TODO (t9002309): block records
-                                    CopySetIndexKey::SINGLE_ENTRY_TYPE};
-            Slice value = op->copyset_index_entry;
-            rocksdb::Slice csi_key_slice(
-                reinterpret_cast<const char*>(&csi_key), sizeof csi_key);
-            rocksdb::Slice value_slice(
-                reinterpret_cast<const char*>(value.data), value.size);
-            rocksdb_batch.Merge(data_cf, csi_key_slice, value_slice);
-
-            csi_bytes += csi_key_slice.size() + value_slice.size();
-          }
-        }
-
-        // Writing index entries
-        for (auto it = op->index_key_list.begin();
-             it != op->index_key_list.end();
-             ++it) {
-          // Writing a findTime or findKey index entry
-          ++index_entry_writes;
-
-          folly::small_vector<char, 26> index_key =
-              RocksDBKeyFormat::IndexKey::create(op->log_id,
-                                                 (*it).first,  // index type
-                                                 (*it).second, // key
-                                                 op->lsn);
-          rocksdb::Slice k_slice(index_key.data(), index_key.size());
-          rocksdb::Slice v_slice(nullptr, 0);
-          rocksdb_batch.Put(data_cf, k_slice, v_slice);
-
-          index_bytes += k_slice.size();
-        }
+        addPut(*op, data_cf, rocksdb_batch, sizes);
         break;
       }
 
@@ -385,22 +332,315 @@ int RocksDBWriter::writeMulti(
     }
   }
 
+  rocksdb::Status status = store_->getSettings()->group_commit
+      ? groupCommit(wal_batch, mem_batch)
+      : writeBatches(wal_batch, mem_batch);
+  if (!status.ok()) {
+    err = E::LOCAL_LOG_STORE_WRITE;
+    return -1;
+  }
+
+  STAT_ADD(store_->getStatsHolder(), record_bytes_written, sizes.record_bytes);
+  STAT_ADD(store_->getStatsHolder(), csi_bytes_written, sizes.csi_bytes);
+  STAT_ADD(store_->getStatsHolder(), index_bytes_written, sizes.index_bytes);
+  return 0;
+}
+
+void RocksDBWriter::addPut(const PutWriteOp& op,
+                           rocksdb::ColumnFamilyHandle* data_cf,
+                           rocksdb::WriteBatch& batch,
+                           PutSizes& sizes) {
+  DataKey key(op.log_id, op.lsn);
+
+  // NOTE: There is an assumption in prepare_write_op() in
+  // RocksDBWriterMergeOperator that the value in RocksDB will be
+  // exactly the concatenation of the header and data blobs.  If that
+  // ever changes here, take care to update the code there as well.
+  rocksdb::Slice key_slice = key.sliceForWriting(op.TEST_data_key_format);
+
+  folly::small_vector<rocksdb::Slice, 3> value_slices;
+
+  // NOTE: At least RocksDBWriterMergeOperator and
+  // RocksDBCompactionFilter expect this format (header byte then same
+  // as normal non-merge stores).
+  value_slices.emplace_back(&RocksDBWriterMergeOperator::DATA_MERGE_HEADER, 1);
+  value_slices.emplace_back(
+      reinterpret_cast<const char*>(op.record_header.data),
+      op.record_header.size);
+  value_slices.emplace_back(
+      reinterpret_cast<const char*>(op.data.data), op.data.size);
+
+  batch.Merge(data_cf,
+              rocksdb::SliceParts(&key_slice, 1),
+              rocksdb::SliceParts(value_slices.data(), value_slices.size()));
+
+  sizes.record_bytes += key_slice.size();
+  for (const auto& s : value_slices) {
+    sizes.record_bytes += s.size();
+  }
+
+  if (op.copyset_index_lsn.has_value()) {
+    // Decide if we need to write a CSI entry.
+    // For internal logs, write CSI even if it's disabled in settings.
+    // This way if we want to enable CSI later we don't have to do
+    // any migration for internal logs.
+    if (store_->getSettings()->write_copyset_index_ ||
+        MetaDataLog::isMetaDataLog(op.log_id) ||
+        configuration::InternalLogs::isInternal(op.log_id)) {
+      // Writing copyset index entry
+      ++sizes.csi_entry_writes;
+      ld_check(op.copyset_index_entry.data);
+      ld_check(op.copyset_index_entry.size);
+      // TODO (t9002309): block records
+      ld_check(op.copyset_index_lsn.value() == LSN_INVALID);
+      lsn_t csi_lsn = op.lsn;
+
+      // Writing copyset index entry
+      CopySetIndexKey csi_key{op.log_id,
+                              csi_lsn,
+                              // TODO (t9002309): block records
+                              CopySetIndexKey::SINGLE_ENTRY_TYPE};
+      Slice value = op.copyset_index_entry;
+      rocksdb::Slice csi_key_slice(
+          reinterpret_cast<const char*>(&csi_key), sizeof csi_key);
+      rocksdb::Slice value_slice(
+          reinterpret_cast<const char*>(value.data), value.size);
+      batch.Merge(data_cf, csi_key_slice, value_slice);
+
+      sizes.csi_bytes += csi_key_slice.size() + value_slice.size();
+    }
+  }
+
+  // Writing index entries
+  for (auto it = op.index_key_list.begin();
+       it != op.index_key_list.end();
+       ++it) {
+    // Writing a findTime or findKey index entry
+    ++sizes.index_entry_writes;
+
+    folly::small_vector<char, 26> index_key =
+        RocksDBKeyFormat::IndexKey::create(op.log_id,
+                                           (*it).first,  // index type
+                                           (*it).second, // key
+                                           op.lsn);
+    rocksdb::Slice k_slice(index_key.data(), index_key.size());
+    rocksdb::Slice v_slice(nullptr, 0);
+    batch.Put(data_cf, k_slice, v_slice);
+
+    sizes.index_bytes += k_slice.size();
+  }
+}
+
+int RocksDBWriter::ingestPuts(const std::vector<const PutWriteOp*>& writes,
+                              rocksdb::ColumnFamilyHandle* data_cf,
+                              const std::string& sst_path) {
+  ld_check(!writes.empty());
+  ld_check(data_cf);
+  if (read_only_) {
+    ld_check(false);
+    err = E::LOCAL_LOG_STORE_WRITE;
+    return -1;
+  }
+  if (store_->acceptingWrites() == E::DISABLED) {
+    err = E::LOCAL_LOG_STORE_WRITE;
+    return -1;
+  }
+
+  // Encode the writes the same way writeMulti() does, then pull the entries
+  // back out of the batch in key order.
+  rocksdb::WriteBatch batch;
+  PutSizes sizes;
+  for (const PutWriteOp* op : writes) {
+    addPut(*op, data_cf, batch, sizes);
+  }
+
+  struct Entry {
+    std::string key;
+    std::string value;
+    bool merge;
+  };
+  class Collector : public rocksdb::WriteBatch::Handler {
+   public:
+    rocksdb::Status PutCF(uint32_t /*cf*/,
+                          const rocksdb::Slice& key,
+                          const rocksdb::Slice& value) override {
+      entries.push_back(Entry{key.ToString(), value.ToString(), false});
+      return rocksdb::Status::OK();
+    }
+    rocksdb::Status MergeCF(uint32_t /*cf*/,
+                            const rocksdb::Slice& key,
+                            const rocksdb::Slice& value) override {
+      entries.push_back(Entry{key.ToString(), value.ToString(), true});
+      return rocksdb::Status::OK();
+    }
+    std::vector<Entry> entries;
+  };
+  Collector collector;
+  rocksdb::Status status = batch.Iterate(&collector);
+  ld_check(status.ok());
+
+  const rocksdb::Comparator* cmp = data_cf->GetComparator();
+  auto& entries = collector.entries;
+  std::sort(
+      entries.begin(), entries.end(), [&](const Entry& a, const Entry& b) {
+        return cmp->Compare(a.key, b.key) < 0;
+      });
+  for (size_t i = 1; i < entries.size(); ++i) {
+    if (cmp->Compare(entries[i - 1].key, entries[i].key) == 0) {
+      // Two writes of the same record. An sst file can only have one entry
+      // per key, let the caller write these through the memtable.
+      err = E::EXISTS;
+      return -1;
+    }
+  }
+
+  rocksdb::DB& db = store_->getDB();
+  rocksdb::Env* env = db.GetEnv();
+  rocksdb::SstFileWriter sst_writer(
+      rocksdb::EnvOptions(), db.GetOptions(data_cf), data_cf);
+  status = sst_writer.Open(sst_path);
+  for (size_t i = 0; status.ok() && i < entries.size(); ++i) {
+    status = entries[i].merge
+        ? sst_writer.Merge(entries[i].key, entries[i].value)
+        : sst_writer.Put(entries[i].key, entries[i].value);
+  }
+  if (status.ok()) {
+    status = sst_writer.Finish();
+  }
+  if (status.ok()) {
+    rocksdb::IngestExternalFileOptions options;
+    options.move_files = true;
+    // If the memtable has some of these keys, fail rather than flush it.
+    options.allow_blocking_flush = false;
+    status = db.IngestExternalFile(data_cf, {sst_path}, options);
+  }
+  if (!status.ok()) {
+    RATELIMIT_INFO(std::chrono::seconds(10),
+                   2,
+                   "Failed to ingest %lu records into column family %s: %s",
+                   writes.size(),
+                   data_cf->GetName().c_str(),
+                   status.ToString().c_str());
+    env->DeleteFile(sst_path);
+    err = E::LOCAL_LOG_STORE_WRITE;
+    return -1;
+  }
+
+  STAT_ADD(
+      store_->getStatsHolder(), csi_entry_writes, sizes.csi_entry_writes);
+  STAT_ADD(
+      store_->getStatsHolder(), index_entry_writes, sizes.index_entry_writes);
+  STAT_ADD(store_->getStatsHolder(), record_bytes_written, sizes.record_bytes);
+  STAT_ADD(store_->getStatsHolder(), csi_bytes_written, sizes.csi_bytes);
+  STAT_ADD(store_->getStatsHolder(), index_bytes_written, sizes.index_bytes);
+  STAT_INCR(store_->getStatsHolder(), rebuilding_sst_files_ingested);
+  STAT_ADD(
+      store_->getStatsHolder(), rebuilding_records_ingested, writes.size());
+  return 0;
+}
+
+rocksdb::Status RocksDBWriter::writeBatches(rocksdb::WriteBatch& wal_batch,
+                                            rocksdb::WriteBatch& mem_batch) {
   rocksdb::WriteOptions options;
   for (auto rocksdb_batch : {&wal_batch, &mem_batch}) {
     if (rocksdb_batch->Count() > 0) {
       rocksdb::Status status = store_->writeBatch(options, rocksdb_batch);
       if (!status.ok()) {
-        err = E::LOCAL_LOG_STORE_WRITE;
-        return -1;
+        return status;
       }
     }
     options.disableWAL = true;
   }
+  return rocksdb::Status::OK();
+}
 
-  STAT_ADD(store_->getStatsHolder(), record_bytes_written, record_bytes);
-  STAT_ADD(store_->getStatsHolder(), csi_bytes_written, csi_bytes);
-  STAT_ADD(store_->getStatsHolder(), index_bytes_written, index_bytes);
-  return 0;
+namespace {
+
+// rocksdb::WriteBatch::Data() is a 12-byte header (fixed64 sequence number,
+// fixed32 count) followed by the records. Records of several batches can be
+// concatenated into one batch by summing the counts.
+constexpr size_t kWriteBatchHeaderSize = 12;
+constexpr size_t kWriteBatchCountOffset = 8;
+
+void appendWriteBatch(std::string& rep,
+                      uint32_t& count,
+                      const rocksdb::WriteBatch& batch) {
+  if (batch.Count() == 0) {
+    return;
+  }
+  const std::string& data = batch.Data();
+  ld_check(data.size() >= kWriteBatchHeaderSize);
+  if (rep.empty()) {
+    rep = data;
+  } else {
+    rep.append(data, kWriteBatchHeaderSize, std::string::npos);
+  }
+  count += batch.Count();
+}
+
+rocksdb::WriteBatch finishWriteBatch(std::string rep, uint32_t count) {
+  if (rep.empty()) {
+    return rocksdb::WriteBatch();
+  }
+  uint32_t count_le = htole32(count);
+  std::memcpy(&rep[kWriteBatchCountOffset], &count_le, sizeof(count_le));
+  return rocksdb::WriteBatch(std::move(rep));
+}
+
+} // namespace
+
+rocksdb::Status RocksDBWriter::groupCommit(rocksdb::WriteBatch& wal_batch,
+                                           rocksdb::WriteBatch& mem_batch) {
+  GroupCommitWriter self{&wal_batch, &mem_batch};
+
+  std::unique_lock<std::mutex> lock(group_commit_mutex_);
+  group_commit_queue_.push_back(&self);
+  group_commit_cv_.wait(
+      lock, [&] { return self.done || !group_commit_leader_active_; });
+  if (self.done) {
+    // Written by another thread's group.
+    return self.status;
+  }
+
+  // Become the leader and take everyone who queued up while the previous
+  // group was being written.
+  group_commit_leader_active_ = true;
+  std::vector<GroupCommitWriter*> group;
+  group.swap(group_commit_queue_);
+  lock.unlock();
+
+  ld_check(!group.empty());
+  rocksdb::Status status;
+  if (group.size() == 1) {
+    status = writeBatches(wal_batch, mem_batch);
+  } else {
+    std::string wal_rep, mem_rep;
+    uint32_t wal_count = 0, mem_count = 0;
+    for (GroupCommitWriter* w : group) {
+      appendWriteBatch(wal_rep, wal_count, *w->wal_batch);
+      appendWriteBatch(mem_rep, mem_count, *w->mem_batch);
+    }
+    rocksdb::WriteBatch merged_wal =
+        finishWriteBatch(std::move(wal_rep), wal_count);
+    rocksdb::WriteBatch merged_mem =
+        finishWriteBatch(std::move(mem_rep), mem_count);
+    status = writeBatches(merged_wal, merged_mem);
+  }
+  STAT_INCR(store_->getStatsHolder(), group_commits);
+  STAT_ADD(store_->getStatsHolder(), group_commit_writers, group.size());
+
+  lock.lock();
+  for (GroupCommitWriter* w : group) {
+    w->status = status;
+    w->done = true;
+  }
+  group_commit_leader_active_ = false;
+  lock.unlock();
+  // Wakes up both the writers of this group and the ones queued for the next
+  // group, one of which will become its leader.
+  group_commit_cv_.notify_all();
+
+  return status;
 }
 
 // ====== Metadata operations ======
@@ -543,6 +783,140 @@ int RocksDBWriter::updateLogMetadata(
   return 0;
 }
 
+int RocksDBWriter::updateLogMetadataBatch(
+    const std::vector<std::pair<logid_t, ComparableLogMetadata*>>& updates,
+    std::vector<Status>& statuses_out,
+    const LocalLogStore::WriteOptions& /*write_options*/,
+    rocksdb::ColumnFamilyHandle* cf) {
+  statuses_out.assign(updates.size(), E::OK);
+  auto fail_all = [&] {
+    statuses_out.assign(updates.size(), E::LOCAL_LOG_STORE_WRITE);
+    err = E::LOCAL_LOG_STORE_WRITE;
+    return -1;
+  };
+  if (read_only_) {
+    ld_check(false);
+    return fail_all();
+  }
+  if (store_->acceptingWrites() == E::DISABLED) {
+    return fail_all();
+  }
+
+  // Take the locks of all the logs in a fixed order, so that concurrent
+  // batches can't deadlock.
+  std::vector<size_t> lock_idxs;
+  for (const auto& update : updates) {
+    lock_idxs.push_back(update.first.val_ % locks_.size());
+  }
+  std::sort(lock_idxs.begin(), lock_idxs.end());
+  lock_idxs.erase(
+      std::unique(lock_idxs.begin(), lock_idxs.end()), lock_idxs.end());
+  std::vector<std::unique_lock<std::mutex>> locks;
+  for (size_t idx : lock_idxs) {
+    locks.emplace_back(locks_[idx]);
+  }
+
+  // Entry to write for each metadata key. If the same key appears more than
+  // once, only the highest value is written and the other entries are
+  // resolved once the write is done.
+  std::map<std::pair<LogMetadataType, logid_t::raw_type>, size_t> to_write;
+  const size_t NONE = std::numeric_limits<size_t>::max();
+  std::vector<size_t> superseded_by(updates.size(), NONE);
+
+  for (size_t i = 0; i < updates.size(); ++i) {
+    const logid_t log_id = updates[i].first;
+    ComparableLogMetadata& metadata = *updates[i].second;
+    if (!metadata.valid()) {
+      RATELIMIT_CRITICAL(std::chrono::seconds(10),
+                         10,
+                         "INTERNAL ERROR: Not writing invalid metadata %s to "
+                         "persistent log store!",
+                         metadata.toString().c_str());
+      dd_assert(false, "invalid metadata");
+      statuses_out[i] = E::LOCAL_LOG_STORE_WRITE;
+      continue;
+    }
+
+    auto key = std::make_pair(metadata.getType(), log_id.val_);
+    auto written = to_write.find(key);
+    if (written != to_write.end()) {
+      ComparableLogMetadata& other = *updates[written->second].second;
+      if (other < metadata) {
+        superseded_by[written->second] = i;
+        written->second = i;
+      } else {
+        superseded_by[i] = written->second;
+      }
+      continue;
+    }
+
+    auto p = LogMetadataFactory::create(metadata.getType());
+    ld_assert(dynamic_cast<ComparableLogMetadata*>(p.get()) != nullptr);
+    ComparableLogMetadata* prev = static_cast<ComparableLogMetadata*>(p.get());
+    int rv = readLogMetadata(log_id, prev, cf);
+    if (rv == 0 && !(*prev < metadata)) {
+      metadata.deserialize(prev->serialize());
+      statuses_out[i] = E::UPTODATE;
+    } else if (rv != 0 && err != E::NOTFOUND) {
+      RATELIMIT_ERROR(std::chrono::seconds(1),
+                      10,
+                      "Reading existing metadata type %d for log %lu "
+                      "failed: %s",
+                      static_cast<int>(metadata.getType()),
+                      log_id.val_,
+                      error_description(err));
+      statuses_out[i] = E::LOCAL_LOG_STORE_WRITE;
+    } else {
+      to_write.emplace(key, i);
+    }
+  }
+
+  if (!to_write.empty()) {
+    rocksdb::WriteBatch batch;
+    for (const auto& kv : to_write) {
+      const logid_t log_id = updates[kv.second].first;
+      const ComparableLogMetadata& metadata = *updates[kv.second].second;
+      LogMetaKey key(metadata.getType(), log_id);
+      Slice value(metadata.serialize());
+      batch.Put(cf,
+                rocksdb::Slice(reinterpret_cast<const char*>(&key), sizeof key),
+                rocksdb::Slice(
+                    reinterpret_cast<const char*>(value.data), value.size));
+    }
+    rocksdb::Status status =
+        store_->writeBatch(rocksdb::WriteOptions(), &batch);
+    if (!status.ok()) {
+      for (const auto& kv : to_write) {
+        statuses_out[kv.second] = E::LOCAL_LOG_STORE_WRITE;
+      }
+    }
+  }
+
+  // Entries superseded by a later entry of the same batch are up to date if
+  // the later one was stored. Superseding entries come later, so resolve
+  // from the back.
+  for (size_t i = updates.size(); i-- > 0;) {
+    const size_t by = superseded_by[i];
+    if (by == NONE) {
+      continue;
+    }
+    if (statuses_out[by] == E::LOCAL_LOG_STORE_WRITE) {
+      statuses_out[i] = E::LOCAL_LOG_STORE_WRITE;
+    } else {
+      updates[i].second->deserialize(updates[by].second->serialize());
+      statuses_out[i] = E::UPTODATE;
+    }
+  }
+
+  for (Status st : statuses_out) {
+    if (st == E::LOCAL_LOG_STORE_WRITE) {
+      err = E::LOCAL_LOG_STORE_WRITE;
+      return -1;
+    }
+  }
+  return 0;
+}
+
 int RocksDBWriter::readPreviousPerEpochLogMetadata(
     logid_t log_id,
     epoch_t epoch,
@@ -7,6 +7,7 @@
  */
 #pragma once
 
+#include <condition_variable>
 #include <deque>
 #include <mutex>
 #include <string>
@@ -43,6 +44,7 @@ namespace facebook { namespace logdevice {
 
 class ComparableLogMetadata;
 class LogMetadata;
+class PutWriteOp;
 class StoreMetadata;
 class WriteOp;
 
@@ -82,6 +84,12 @@ class RocksDBWriter {
   //   separate call to writeBatch.
   // - If both settings are false, all operations are performed atomically with
   //   wal.
+  // Calls LocalLogStoreRecordFormat::checkWellFormed() on all PUT ops of
+  // `writes` at once. Returns its result for each op, 0 for other ops.
+  // Sets err to the error of the last malformed record, if any.
+  static std::vector<int>
+  checkRecordsWellFormed(const std::vector<const WriteOp*>& writes);
+
   int writeMulti(const std::vector<const WriteOp*>& writes,
                  const LocalLogStore::WriteOptions& write_options,
                  rocksdb::ColumnFamilyHandle* metadata_cf,
@@ -90,6 +98,17 @@ class RocksDBWriter {
                  rocksdb::WriteBatch& mem_batch,
                  bool skip_checksum_verification = false);
 
+  // Writes the records of `writes`, with their copyset index and index
+  // entries, into a new sst file at `sst_path` and ingests it into `data_cf`,
+  // bypassing WAL and memtable. The records are durable once this returns.
+  // Fails, without writing anything, if two of the writes are for the same
+  // record (err = EXISTS), or if the memtable of `data_cf` has some of the
+  // keys or rocksdb fails (err = LOCAL_LOG_STORE_WRITE). Checksums are not
+  // verified.
+  int ingestPuts(const std::vector<const PutWriteOp*>& writes,
+                 rocksdb::ColumnFamilyHandle* data_cf,
+                 const std::string& sst_path);
+
   int readLogMetadata(logid_t log_id,
                       LogMetadata* metadata,
                       rocksdb::ColumnFamilyHandle* cf);
@@ -101,6 +120,13 @@ class RocksDBWriter {
                         ComparableLogMetadata& metadata,
                         const LocalLogStore::WriteOptions& options,
                         rocksdb::ColumnFamilyHandle* cf);
+  // Reads the current values and writes the updates in one WriteBatch,
+  // holding the locks of all the logs involved.
+  int updateLogMetadataBatch(
+      const std::vector<std::pair<logid_t, ComparableLogMetadata*>>& updates,
+      std::vector<Status>& statuses_out,
+      const LocalLogStore::WriteOptions& options,
+      rocksdb::ColumnFamilyHandle* cf);
   int deleteStoreMetadata(const StoreMetadataType& type,
                           const LocalLogStore::WriteOptions& options,
                           rocksdb::ColumnFamilyHandle* cf);
@@ -397,6 +423,40 @@ class RocksDBWriter {
                          PerEpochLogMetadata& meta)> cb);
 
  private:
+  struct PutSizes {
+    size_t record_bytes = 0;
+    size_t csi_bytes = 0;
+    size_t index_bytes = 0;
+    size_t csi_entry_writes = 0;
+    size_t index_entry_writes = 0;
+  };
+  // Adds the data record, copyset index entry and index entries of `op` to
+  // `batch`.
+  void addPut(const PutWriteOp& op,
+              rocksdb::ColumnFamilyHandle* data_cf,
+              rocksdb::WriteBatch& batch,
+              PutSizes& sizes);
+
+  // Writes wal_batch, then mem_batch without WAL. Empty batches are skipped.
+  rocksdb::Status writeBatches(rocksdb::WriteBatch& wal_batch,
+                               rocksdb::WriteBatch& mem_batch);
+
+  // Group commit (see RocksDBSettings::group_commit). Concurrent callers of
+  // writeMulti() on different storage threads queue their batches; one of
+  // them becomes the leader, concatenates all queued batches into one WAL
+  // batch and one memtable-only batch, writes them, and hands the status to
+  // the others. This way rocksdb does one WAL write for the group instead of
+  // alternating between WAL and non-WAL writers, which it can't group
+  // together.
+  struct GroupCommitWriter {
+    rocksdb::WriteBatch* wal_batch;
+    rocksdb::WriteBatch* mem_batch;
+    rocksdb::Status status;
+    bool done = false;
+  };
+  rocksdb::Status groupCommit(rocksdb::WriteBatch& wal_batch,
+                              rocksdb::WriteBatch& mem_batch);
+
   int readPreviousPerEpochLogMetadata(logid_t log_id,
                                       epoch_t epoch,
                                       PerEpochLogMetadata* metadata,
@@ -409,6 +469,13 @@ class RocksDBWriter {
 
   std::atomic<FlushToken> next_wal_sync_token_{1};
   std::atomic<FlushToken> wal_synced_up_to_token_{0};
+
+  std::mutex group_commit_mutex_;
+  std::condition_variable group_commit_cv_;
+  // Writers waiting for the next group. Protected by group_commit_mutex_.
+  std::vector<GroupCommitWriter*> group_commit_queue_;
+  // True while a leader is writing a group.
+  bool group_commit_leader_active_ = false;
 };
 
 }} // namespace facebook::logdevice
@@ -11,6 +11,7 @@
 #include <cerrno>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <future>
 #include <thread>
 
@@ -19,7 +20,9 @@
 #include <folly/ScopeGuard.h>
 #include <rocksdb/db.h>
 #include <rocksdb/statistics.h>
+#include <fcntl.h>
 #include <sys/stat.h>
+#include <unistd.h>
 
 #include "logdevice/common/ConstructorFailed.h"
 #include "logdevice/common/RandomAccessQueue.h"
@@ -89,6 +92,141 @@ bool ShardedRocksDBLocalLogStore::createOrValidatePaths() {
     shard_paths_.at(shard_idx) = shard_path;
   }
 
+  if (!db_settings_->wal_dir.empty()) {
+    if (is_db_local_) {
+      wal_paths_.resize(nshards_);
+      for (shard_index_t shard_idx = 0; shard_idx < nshards_; ++shard_idx) {
+        wal_paths_[shard_idx] = fs::path(db_settings_->wal_dir) /
+            fs::path("shard" + std::to_string(shard_idx));
+      }
+    } else {
+      ld_warning("Ignoring --rocksdb-wal-dir: the databases are not local");
+    }
+  }
+
+  return true;
+}
+
+namespace {
+
+// Name of the file in a shard's directory containing the path of the
+// directory its write-ahead log is in, if not the shard's directory.
+const char* const WAL_DIR_FILE = "WAL_DIR";
+
+bool fsyncPath(const fs::path& path) {
+  int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return false;
+  }
+  int rv = ::fsync(fd);
+  ::close(fd);
+  return rv == 0;
+}
+
+} // namespace
+
+bool ShardedRocksDBLocalLogStore::placeWAL(shard_index_t shard_idx,
+                                           RocksDBLogStoreConfig& config) {
+  const fs::path& shard_path = shard_paths_[shard_idx];
+  const fs::path wal_path =
+      wal_paths_.empty() ? shard_path : wal_paths_[shard_idx];
+  const fs::path marker_path = shard_path / WAL_DIR_FILE;
+
+  fs::path prev_path = shard_path;
+  std::string contents;
+  if (folly::readFile(marker_path.c_str(), contents) && !contents.empty()) {
+    prev_path = contents;
+  }
+
+  if (wal_path != shard_path) {
+    config.options_.wal_dir = wal_path.string();
+  }
+  if (prev_path == wal_path) {
+    return true;
+  }
+
+  boost::system::error_code ec;
+  for (const fs::path& dir : {shard_path, wal_path}) {
+    fs::create_directories(dir, ec);
+    if (ec) {
+      ld_error("Failed to create directory %s: %s",
+               dir.c_str(),
+               ec.message().c_str());
+      return false;
+    }
+  }
+
+  // Copy the WAL files to the new location before updating WAL_DIR_FILE, and
+  // only then delete the old copies, so that a crash at any point leaves the
+  // files of the directory WAL_DIR_FILE refers to intact.
+  std::vector<fs::path> old_files;
+  if (fs::exists(prev_path, ec)) {
+    for (fs::directory_iterator it(prev_path, ec), end; !ec && it != end;
+         it.increment(ec)) {
+      if (it->path().extension() != ".log") {
+        continue;
+      }
+      fs::path dst = wal_path / it->path().filename();
+      fs::copy_file(
+          it->path(), dst, fs::copy_option::overwrite_if_exists, ec);
+      if (ec || !fsyncPath(dst)) {
+        ld_error("Failed to move WAL file %s to %s: %s",
+                 it->path().c_str(),
+                 wal_path.c_str(),
+                 ec ? ec.message().c_str() : strerror(errno));
+        return false;
+      }
+      old_files.push_back(it->path());
+    }
+  } else if (prev_path != shard_path) {
+    ld_error("WAL directory %s of shard %d does not exist. Writes in its WAL "
+             "files would be lost. Remove %s to open the shard without them.",
+             prev_path.c_str(),
+             shard_idx,
+             marker_path.c_str());
+    return false;
+  }
+  if (ec) {
+    ld_error("Failed to list WAL files in %s: %s",
+             prev_path.c_str(),
+             ec.message().c_str());
+    return false;
+  }
+  if (!fsyncPath(wal_path)) {
+    ld_error(
+        "Failed to sync directory %s: %s", wal_path.c_str(), strerror(errno));
+    return false;
+  }
+
+  try {
+    if (wal_path == shard_path) {
+      fs::remove(marker_path);
+    } else {
+      folly::writeFileAtomic(marker_path.string(), wal_path.string());
+    }
+  } catch (const std::exception& e) {
+    ld_error("Failed to update %s: %s", marker_path.c_str(), e.what());
+    return false;
+  }
+  if (!fsyncPath(shard_path)) {
+    ld_error(
+        "Failed to sync directory %s: %s", shard_path.c_str(), strerror(errno));
+    return false;
+  }
+
+  for (const fs::path& old_file : old_files) {
+    fs::remove(old_file, ec);
+    if (ec) {
+      ld_warning("Failed to remove old WAL file %s: %s",
+                 old_file.c_str(),
+                 ec.message().c_str());
+    }
+  }
+  ld_info("Moved %lu WAL files of shard %d from %s to %s",
+          old_files.size(),
+          shard_idx,
+          prev_path.c_str(),
+          wal_path.c_str());
   return true;
 }
 
@@ -202,10 +340,6 @@ void ShardedRocksDBLocalLogStore::init(
                 io_tracing_by_shard_[shard_idx].get()));
       }
 
-      RocksDBLogStoreFactory factory(
-          std::move(shard_config), settings, config, customiser_.get(), stats_);
-      std::unique_ptr<LocalLogStore> shard_store;
-
       // Treat the shard as failed if we find a file named
       // LOGDEVICE_DISABLED. Used by tests.
       bool should_open_shard =
@@ -213,6 +347,15 @@ void ShardedRocksDBLocalLogStore::init(
               disabled_shards_.begin(), disabled_shards_.end(), shard_idx) == 0;
 
       auto tstart = std::chrono::steady_clock::now();
+      if (should_open_shard && is_db_local_ &&
+          !placeWAL(shard_idx, shard_config)) {
+        // RocksDB would not replay the writes in the WAL files left behind.
+        should_open_shard = false;
+      }
+
+      RocksDBLogStoreFactory factory(
+          std::move(shard_config), settings, config, customiser_.get(), stats_);
+      std::unique_ptr<LocalLogStore> shard_store;
       if (should_open_shard) {
         shard_store = factory.create(shard_idx,
                                      nshards_,
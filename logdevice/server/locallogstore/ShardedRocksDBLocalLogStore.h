@@ -202,6 +202,13 @@ class ShardedRocksDBLocalLogStore : public ShardedLocalLogStore {
   // Returns false on error.
   bool createOrValidatePaths();
 
+  // Points `config` at the directory the shard's write-ahead log should be
+  // in (see --rocksdb-wal-dir). If the WAL files are somewhere else, e.g.
+  // because the setting was changed, moves them there first. Returns false
+  // if they couldn't be moved, in which case the shard must not be opened:
+  // RocksDB would silently skip the writes in them.
+  bool placeWAL(shard_index_t shard_idx, RocksDBLogStoreConfig& config);
+
   // Shutdown event to indicate that the sharded store is closing down.
   SingleEvent shutdown_event_;
 
@@ -244,6 +251,10 @@ class ShardedRocksDBLocalLogStore : public ShardedLocalLogStore {
   // For each shard, the directory containing the shard's database
   std::vector<boost::filesystem::path> shard_paths_;
 
+  // For each shard, the directory containing the shard's write-ahead log if
+  // --rocksdb-wal-dir is set. Empty otherwise.
+  std::vector<boost::filesystem::path> wal_paths_;
+
   // Shards we shouldn't open.
   std::vector<shard_index_t> disabled_shards_;
 
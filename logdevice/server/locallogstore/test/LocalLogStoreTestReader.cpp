@@ -64,6 +64,7 @@ LocalLogStoreTestReader::process(const TemporaryRocksDBStore* store,
                                        first_record_any_size_,
                                        filter_,
                                        CatchupEventTrigger::OTHER);
+  ctx.max_execution_time_ = context_max_execution_time_;
 
   Status st = LocalLogStoreReader::read(*it, cb, &ctx, nullptr, settings_);
   records = std::move(cb.getRecords());
@@ -60,6 +60,12 @@ class LocalLogStoreTestReader {
     settings_.max_record_read_execution_time = v;
     return *this;
   }
+  // sets ReadContext::max_execution_time_, as done for reads on workers
+  LocalLogStoreTestReader& context_max_execution_time(
+      std::chrono::milliseconds v) {
+    context_max_execution_time_ = v;
+    return *this;
+  }
   LocalLogStoreTestReader& filter(std::shared_ptr<LocalLogStoreReadFilter> f) {
     filter_ = std::move(f);
     return *this;
@@ -84,6 +90,8 @@ class LocalLogStoreTestReader {
   lsn_t last_released_{LSN_MAX};
   bool first_record_any_size_{false};
   size_t max_bytes_all_records_{1000000};
+  std::chrono::milliseconds context_max_execution_time_{
+      std::chrono::milliseconds::max()};
   std::shared_ptr<LocalLogStoreReadFilter> filter_;
   LocalLogStoreReader::ReadPointer read_ptr_{lsn_t{1}};
   int fail_after_ = -1;
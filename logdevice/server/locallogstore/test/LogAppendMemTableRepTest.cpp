@@ -0,0 +1,152 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/server/locallogstore/LogAppendMemTableRep.h"
+
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+
+#include <folly/Conv.h>
+#include <gtest/gtest.h>
+
+#include "logdevice/common/test/TestUtil.h"
+#include "rocksdb/db.h"
+
+using namespace facebook::logdevice;
+
+namespace {
+
+class LogAppendMemTableRepTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    temp_dir_ = std::make_unique<TemporaryDirectory>("LogAppendMemTableRep");
+    rocksdb::Options options;
+    options.create_if_missing = true;
+    options.memtable_factory = std::make_shared<LogAppendMemTableRepFactory>();
+    // Keep everything in the memtable.
+    options.write_buffer_size = 1024 * 1024 * 1024;
+    rocksdb::DB* db;
+    rocksdb::Status status =
+        rocksdb::DB::Open(options, temp_dir_->path().string(), &db);
+    ASSERT_TRUE(status.ok()) << status.ToString();
+    db_.reset(db);
+  }
+
+  void put(const std::string& key, const std::string& value) {
+    ASSERT_TRUE(db_->Put(rocksdb::WriteOptions(), key, value).ok());
+    expected_[key] = value;
+  }
+
+  // Checks that a forward and a backward scan of the DB match `expected_`.
+  void checkScans() {
+    std::unique_ptr<rocksdb::Iterator> it(
+        db_->NewIterator(rocksdb::ReadOptions()));
+    auto exp = expected_.begin();
+    for (it->SeekToFirst(); it->Valid(); it->Next(), ++exp) {
+      ASSERT_NE(expected_.end(), exp);
+      EXPECT_EQ(exp->first, it->key().ToString());
+      EXPECT_EQ(exp->second, it->value().ToString());
+    }
+    EXPECT_EQ(expected_.end(), exp);
+
+    auto rexp = expected_.rbegin();
+    for (it->SeekToLast(); it->Valid(); it->Prev(), ++rexp) {
+      ASSERT_NE(expected_.rend(), rexp);
+      EXPECT_EQ(rexp->first, it->key().ToString());
+    }
+    EXPECT_EQ(expected_.rend(), rexp);
+  }
+
+  // Key with the same layout as LogsDB data keys.
+  static std::string dataKey(uint64_t log, uint64_t lsn) {
+    uint64_t log_be = htobe64(log);
+    uint64_t lsn_be = htobe64(lsn);
+    std::string key = "d";
+    key.append(reinterpret_cast<const char*>(&log_be), sizeof(log_be));
+    key.append(reinterpret_cast<const char*>(&lsn_be), sizeof(lsn_be));
+    return key;
+  }
+
+  std::unique_ptr<TemporaryDirectory> temp_dir_;
+  std::unique_ptr<rocksdb::DB> db_;
+  std::map<std::string, std::string> expected_;
+};
+
+} // namespace
+
+TEST_F(LogAppendMemTableRepTest, Basic) {
+  put(dataKey(2, 1), "a");
+  put(dataKey(1, 5), "b");
+  put(dataKey(1, 3), "c");
+  put(dataKey(2, 2), "d");
+  // Keys shorter than the stream prefix.
+  put("d", "e");
+  put("da", "f");
+  put("", "g");
+  // Overwrite.
+  put(dataKey(1, 5), "h");
+  checkScans();
+
+  std::string value;
+  ASSERT_TRUE(db_->Get(rocksdb::ReadOptions(), dataKey(1, 5), &value).ok());
+  EXPECT_EQ("h", value);
+  EXPECT_TRUE(
+      db_->Get(rocksdb::ReadOptions(), dataKey(1, 4), &value).IsNotFound());
+
+  std::unique_ptr<rocksdb::Iterator> it(
+      db_->NewIterator(rocksdb::ReadOptions()));
+  it->Seek(dataKey(1, 4));
+  ASSERT_TRUE(it->Valid());
+  EXPECT_EQ(dataKey(1, 5), it->key().ToString());
+  it->Seek(dataKey(1, 6));
+  ASSERT_TRUE(it->Valid());
+  EXPECT_EQ(dataKey(2, 1), it->key().ToString());
+  it->SeekForPrev(dataKey(2, 0));
+  ASSERT_TRUE(it->Valid());
+  EXPECT_EQ(dataKey(1, 5), it->key().ToString());
+  it->SeekForPrev(dataKey(0, 0));
+  ASSERT_TRUE(it->Valid());
+  EXPECT_EQ("d", it->key().ToString());
+  it->Seek(dataKey(3, 0));
+  EXPECT_FALSE(it->Valid());
+}
+
+// Inserts while an iterator is open must not make it skip or repeat entries
+// that existed when it was positioned.
+TEST_F(LogAppendMemTableRepTest, InsertWhileIterating) {
+  for (uint64_t lsn = 10; lsn <= 100; lsn += 10) {
+    put(dataKey(1, lsn), "x");
+  }
+  std::unique_ptr<rocksdb::Iterator> it(
+      db_->NewIterator(rocksdb::ReadOptions()));
+  it->Seek(dataKey(1, 50));
+  ASSERT_TRUE(it->Valid());
+  put(dataKey(1, 5), "y");
+  put(dataKey(1, 15), "y");
+  it->Next();
+  ASSERT_TRUE(it->Valid());
+  EXPECT_EQ(dataKey(1, 60), it->key().ToString());
+  it->Prev();
+  it->Prev();
+  ASSERT_TRUE(it->Valid());
+  EXPECT_EQ(dataKey(1, 40), it->key().ToString());
+}
+
+TEST_F(LogAppendMemTableRepTest, MatchesMap) {
+  std::mt19937 rng(4242);
+  for (int i = 0; i < 5000; ++i) {
+    uint64_t log = rng() % 20;
+    // Mostly increasing LSNs per log, with some out of order ones.
+    uint64_t lsn = rng() % 10 == 0 ? rng() % 1000 : 1000 + i;
+    std::string key = rng() % 50 == 0 ? std::string(rng() % 12, 'd')
+                                      : dataKey(log, lsn);
+    put(key, folly::to<std::string>(i));
+  }
+  checkScans();
+}
@@ -14,6 +14,8 @@
 #include <queue>
 #include <set>
 
+#include <boost/filesystem.hpp>
+#include <folly/Format.h>
 #include <folly/Random.h>
 #include <folly/Varint.h>
 #include <gtest/gtest.h>
@@ -30,6 +32,7 @@
 #include "logdevice/common/test/TestUtil.h"
 #include "logdevice/common/util.h"
 #include "logdevice/server/ServerProcessor.h"
+#include "logdevice/server/locallogstore/LogsDBImport.h"
 #include "logdevice/server/locallogstore/PartitionMetadata.h"
 #include "logdevice/server/locallogstore/PartitionedRocksDBStoreIterators.h"
 #include "logdevice/server/locallogstore/RocksDBCompactionFilter.h"
@@ -3116,6 +3119,99 @@ TEST_F(PartitionedRocksDBStoreTest, CompactionScheduleBaseline) {
   EXPECT_EQ(2, stats.partitions_compacted);
 }
 
+// Retention-based compactions are skipped until a large enough part of the
+// partition is trimmed.
+TEST_F(PartitionedRocksDBStoreTest, CompactionMinReclaimRatio) {
+  updateSetting("rocksdb-partition-compaction-min-reclaim-ratio", "0.5");
+
+  // Logs 50, 150 and 250 have backlog durations of 1, 2 and 3 days.
+  put({TestRecord(logid_t(50), 10, BASE_TIME + HOUR)});
+  for (lsn_t lsn = 1; lsn <= 5; ++lsn) {
+    put({TestRecord(logid_t(150), lsn, BASE_TIME + HOUR)});
+  }
+  for (lsn_t lsn = 1; lsn <= 4; ++lsn) {
+    put({TestRecord(logid_t(250), lsn, BASE_TIME + HOUR)});
+  }
+  time_ = SystemTimestamp(std::chrono::milliseconds(BASE_TIME + HOUR));
+  store_->createPartition();
+
+  // Log 50 is trimmed, but it's only 10% of the partition.
+  time_ = SystemTimestamp(std::chrono::milliseconds(BASE_TIME + DAY * 2));
+  store_
+      ->backgroundThreadIteration(
+          PartitionedRocksDBStore::BackgroundThreadType::LO_PRI)
+      .wait();
+  auto stats = stats_.aggregate();
+  EXPECT_EQ(0, stats.partitions_compacted);
+  EXPECT_LT(0, stats.partition_retention_compactions_skipped);
+  EXPECT_EQ(10, getTrimPoint(logid_t(50)));
+
+  // Logs 50 and 150 are trimmed, 60% of the partition.
+  time_ = SystemTimestamp(std::chrono::milliseconds(BASE_TIME + DAY * 3));
+  store_
+      ->backgroundThreadIteration(
+          PartitionedRocksDBStore::BackgroundThreadType::LO_PRI)
+      .wait();
+  stats = stats_.aggregate();
+  EXPECT_EQ(1, stats.partitions_compacted);
+
+  auto data = readAndCheck();
+  ASSERT_EQ(2, data.size());
+  EXPECT_EQ(std::vector<lsn_t>(), data[0][logid_t(50)].records);
+  EXPECT_EQ(std::vector<lsn_t>(), data[0][logid_t(150)].records);
+  EXPECT_EQ(std::vector<lsn_t>({1, 2, 3, 4}), data[0][logid_t(250)].records);
+}
+
+// Compactions over rocksdb-partition-compaction-io-budget are postponed and
+// reported by getPendingCompactions().
+TEST_F(PartitionedRocksDBStoreTest, CompactionIOBudget) {
+  // Two partitions with records of logs 50 (1 day backlog) and 250 (3 days).
+  for (int i = 0; i < 2; ++i) {
+    put({TestRecord(logid_t(50), i + 1, BASE_TIME + HOUR * (i + 1)),
+         TestRecord(logid_t(250), i + 1, BASE_TIME + HOUR * (i + 1))});
+    setTime(BASE_TIME + HOUR * (i + 1));
+    store_->createPartition();
+  }
+  auto partitions = store_->getPartitionList();
+  ASSERT_EQ(3, partitions->size());
+
+  // The budget allows one compaction and then nothing for a very long time.
+  updateSetting("rocksdb-partition-compaction-io-budget", "1/1000h");
+  updateSetting("rocksdb-partition-compaction-order-by-reclaim", "true");
+
+  // Log 50 is trimmed from both partitions.
+  setTime(BASE_TIME + DAY * 2);
+  store_
+      ->backgroundThreadIteration(
+          PartitionedRocksDBStore::BackgroundThreadType::LO_PRI)
+      .wait();
+  auto stats = stats_.aggregate();
+  EXPECT_EQ(1, stats.partitions_compacted);
+  EXPECT_EQ(1,
+            stats.per_shard_stats->get(THIS_SHARD)
+                ->partition_compactions_postponed_io_budget);
+
+  auto pending = store_->getPendingCompactions();
+  ASSERT_EQ(1, pending.size());
+  const auto& p = pending.begin()->second;
+  EXPECT_EQ(PartitionedRocksDBStore::PartitionToCompact::Reason::RETENTION,
+            p.reason);
+  EXPECT_EQ(1, p.position);
+  EXPECT_GT(p.estimated_reclaimable_bytes, 0);
+  ASSERT_NE(nullptr, p.postponed_by);
+  EXPECT_EQ(std::string("io budget"), p.postponed_by);
+
+  // Lifting the budget lets the postponed compaction run.
+  updateSetting("rocksdb-partition-compaction-io-budget", "unlimited");
+  store_
+      ->backgroundThreadIteration(
+          PartitionedRocksDBStore::BackgroundThreadType::LO_PRI)
+      .wait();
+  stats = stats_.aggregate();
+  EXPECT_EQ(2, stats.partitions_compacted);
+  EXPECT_TRUE(store_->getPendingCompactions().empty());
+}
+
 // Test for RocksDBSettings proactive_compaction_enabled option.
 TEST_F(PartitionedRocksDBStoreTest, ProactiveCompaction) {
   closeStore();
@@ -3162,6 +3258,162 @@ TEST_F(PartitionedRocksDBStoreTest, ProactiveCompaction) {
   EXPECT_EQ(1, stats.partitions_compacted);
 }
 
+// Old partitions get compacted into --rocksdb-partition-cold-path and stay
+// readable.
+TEST_F(PartitionedRocksDBStoreTest, ColdPartitionPath) {
+  TemporaryDirectory cold_dir("ColdPartitionPath");
+  auto count_cold_files = [&] {
+    size_t n = 0;
+    for (boost::filesystem::recursive_directory_iterator it(cold_dir.path()),
+         end;
+         it != end;
+         ++it) {
+      n += it->path().extension() == ".sst";
+    }
+    return n;
+  };
+
+  closeStore();
+  ServerConfig::SettingsConfig s;
+  s["rocksdb-partition-cold-path"] = cold_dir.path().string();
+  s["rocksdb-partition-cold-age"] = "1h";
+  openStore(s);
+
+  put({TestRecord(logid_t(1), 1, BASE_TIME)});
+  store_->createPartition();
+  put({TestRecord(logid_t(1), 2, BASE_TIME + HOUR)});
+  store_->createPartition();
+  put({TestRecord(logid_t(1), 3, BASE_TIME + HOUR * 2)});
+
+  // Nothing is cold yet.
+  store_
+      ->backgroundThreadIteration(
+          PartitionedRocksDBStore::BackgroundThreadType::LO_PRI)
+      .wait();
+  EXPECT_EQ(0, stats_.aggregate().partitions_compacted);
+  EXPECT_EQ(0, count_cold_files());
+
+  // The oldest partition is cold now. The other two are the latest ones.
+  setTime(BASE_TIME + HOUR * 3);
+  store_
+      ->backgroundThreadIteration(
+          PartitionedRocksDBStore::BackgroundThreadType::LO_PRI)
+      .wait();
+  EXPECT_EQ(1, stats_.aggregate().partitions_compacted);
+  EXPECT_EQ(1, count_cold_files());
+
+  // Already moved, no more compactions.
+  store_
+      ->backgroundThreadIteration(
+          PartitionedRocksDBStore::BackgroundThreadType::LO_PRI)
+      .wait();
+  EXPECT_EQ(1, stats_.aggregate().partitions_compacted);
+
+  // Records are readable from both paths, also after reopening.
+  closeStore();
+  openStore(s);
+  auto data = readAndCheck();
+  ASSERT_EQ(3, data.size());
+  EXPECT_EQ(std::vector<lsn_t>({1}), data[0][logid_t(1)].records);
+  EXPECT_EQ(std::vector<lsn_t>({2}), data[1][logid_t(1)].records);
+  EXPECT_EQ(std::vector<lsn_t>({3}), data[2][logid_t(1)].records);
+}
+
+// Rebuilding records for old partitions are ingested as sst files when a
+// batch has enough of them.
+TEST_F(PartitionedRocksDBStoreTest, IngestRebuildingWrites) {
+  closeStore();
+  ServerConfig::SettingsConfig s;
+  s["rocksdb-rebuilding-ingest-min-records"] = "2";
+  openStore(s);
+
+  auto rebuild = [](lsn_t lsn, uint64_t timestamp) {
+    return TestRecord(logid_t(1),
+                      lsn,
+                      Durability::ASYNC_WRITE,
+                      TestRecord::StoreType::REBUILD,
+                      timestamp);
+  };
+
+  put({TestRecord(logid_t(1), 10, BASE_TIME)});
+  store_->createPartition();
+  put({TestRecord(logid_t(1), 20, BASE_TIME + HOUR)});
+  store_->createPartition();
+  put({TestRecord(logid_t(1), 30, BASE_TIME + HOUR * 2)});
+  // Ingestion doesn't flush memtables, it gives up if they overlap.
+  store_->flushAllMemtables();
+
+  // The two records for the oldest partition are ingested. The one for one
+  // of the two latest partitions goes through the memtable.
+  put({rebuild(11, BASE_TIME + 1),
+       rebuild(12, BASE_TIME + 2),
+       rebuild(21, BASE_TIME + HOUR + 1)});
+  auto stats = stats_.aggregate();
+  EXPECT_EQ(1, stats.rebuilding_sst_files_ingested);
+  EXPECT_EQ(2, stats.rebuilding_records_ingested);
+
+  // A single record is below the threshold.
+  put({rebuild(13, BASE_TIME + 3)});
+  EXPECT_EQ(1, stats_.aggregate().rebuilding_sst_files_ingested);
+
+  auto data = readAndCheck();
+  ASSERT_EQ(3, data.size());
+  EXPECT_EQ(std::vector<lsn_t>({10, 11, 12, 13}), data[0][logid_t(1)].records);
+  EXPECT_EQ(std::vector<lsn_t>({20, 21}), data[1][logid_t(1)].records);
+  EXPECT_EQ(std::vector<lsn_t>({30}), data[2][logid_t(1)].records);
+}
+
+// Records of an import file land in the partitions matching their timestamps,
+// except the ones at or below the trim point.
+TEST_F(PartitionedRocksDBStoreTest, ImportRecords) {
+  TemporaryDirectory dir("ImportRecords");
+  const std::string path = (dir.path() / "import.sst").string();
+
+  put({TestRecord(logid_t(1), 100, BASE_TIME + HOUR)});
+  ASSERT_EQ(0,
+            store_->writeLogMetadata(logid_t(2),
+                                     TrimMetadata{lsn_t(5)},
+                                     LocalLogStore::WriteOptions()));
+
+  std::vector<StoreChainLink> chain = formCopySet();
+  LogsDBImportFileWriter writer;
+  ASSERT_EQ(0, writer.open(path));
+  auto add = [&](logid_t log, lsn_t lsn, uint64_t timestamp) {
+    std::string buf;
+    formRecordHeader(
+        buf, formStoreHeader(timestamp, chain.size()), chain.data(), {});
+    buf += formTestPayload(log, lsn, timestamp);
+    return writer.add(log, lsn, Slice(buf.data(), buf.size()));
+  };
+  ASSERT_EQ(0, add(logid_t(1), 10, BASE_TIME - HOUR));
+  ASSERT_EQ(0, add(logid_t(1), 20, BASE_TIME + HOUR + 1));
+  ASSERT_EQ(0, add(logid_t(2), 5, BASE_TIME + HOUR + 2));
+  ASSERT_EQ(0, add(logid_t(2), 6, BASE_TIME + HOUR + 3));
+  // Out of order.
+  EXPECT_EQ(-1, add(logid_t(1), 30, BASE_TIME + HOUR));
+  EXPECT_EQ(E::INVALID_PARAM, err);
+  ASSERT_EQ(0, writer.finish());
+
+  LogsDBImportStats stats;
+  ASSERT_EQ(0, importLogsDBFile(*store_, path, 2, false, &stats));
+  EXPECT_EQ(3, stats.records);
+  EXPECT_EQ(1, stats.skipped_trimmed);
+
+  auto data = readAndCheck();
+  std::vector<lsn_t> log1, log2;
+  for (auto& partition : data) {
+    auto& r1 = partition[logid_t(1)].records;
+    auto& r2 = partition[logid_t(2)].records;
+    log1.insert(log1.end(), r1.begin(), r1.end());
+    log2.insert(log2.end(), r2.begin(), r2.end());
+  }
+  // The record older than all partitions went to a prepended partition.
+  EXPECT_GT(data.size(), 1);
+  EXPECT_EQ(std::vector<lsn_t>({10}), data[0][logid_t(1)].records);
+  EXPECT_EQ(std::vector<lsn_t>({10, 20, 100}), log1);
+  EXPECT_EQ(std::vector<lsn_t>({6}), log2);
+}
+
 TEST_F(PartitionedRocksDBStoreTest, MetaDataLogsAreUnpartitioned) {
   const logid_t data_log(10);
   const logid_t meta_log = MetaDataLog::metaDataLogID(data_log);
@@ -3318,6 +3570,57 @@ TEST_F(PartitionedRocksDBStoreTest, FindTimeSimple) {
   FINDTIME(logid, BASE_TIME + 90, LSN_INVALID, LSN_MAX, 60, LSN_MAX);
 }
 
+// Same as FindTimeSimple, but with the in-memory directory index disabled, so
+// that findTime() searches the directory in rocksdb.
+TEST_F(PartitionedRocksDBStoreTest, FindTimeWithoutDirectoryIndex) {
+  closeStore();
+  openStore({{"rocksdb-directory-index-memory-budget", "0"}});
+  logid_t logid(3);
+
+  put({TestRecord(logid, 10, BASE_TIME)});
+  time_ = SystemTimestamp(std::chrono::milliseconds(BASE_TIME));
+  store_->createPartition();
+  put({TestRecord(logid, 20, BASE_TIME + 1)});
+  put({TestRecord(logid, 30, BASE_TIME + 20)});
+  put({TestRecord(logid, 40, BASE_TIME + 30)});
+  put({TestRecord(logid, 50, BASE_TIME + 40)});
+  time_ = SystemTimestamp(std::chrono::milliseconds(BASE_TIME + 40));
+  store_->createPartition();
+  put({TestRecord(logid, 60, BASE_TIME + 50)});
+
+  FINDTIME(logid, BASE_TIME - 20, LSN_INVALID, LSN_MAX, LSN_INVALID, 10);
+  FINDTIME(logid, BASE_TIME + 20, LSN_INVALID, LSN_MAX, 20, 30);
+  FINDTIME(logid, BASE_TIME + 25, LSN_INVALID, LSN_MAX, 30, 40);
+  FINDTIME(logid, BASE_TIME + 30, LSN_INVALID, LSN_MAX, 30, 40);
+  FINDTIME(logid, BASE_TIME + 90, LSN_INVALID, LSN_MAX, 60, LSN_MAX);
+
+  Stats stats = stats_.aggregate();
+  EXPECT_EQ(0, stats.logsdb_directory_index_rebuilds);
+  EXPECT_GT(stats.logsdb_directory_index_over_budget, 0);
+}
+
+// The directory index should be rebuilt after partitions are dropped and
+// give the same results as before.
+TEST_F(PartitionedRocksDBStoreTest, FindTimeDirectoryIndexAfterDrop) {
+  logid_t logid(3);
+
+  put({TestRecord(logid, 10, BASE_TIME)});
+  time_ = SystemTimestamp(std::chrono::milliseconds(BASE_TIME + 10));
+  store_->createPartition();
+  put({TestRecord(logid, 20, BASE_TIME + 10)});
+  time_ = SystemTimestamp(std::chrono::milliseconds(BASE_TIME + 20));
+  store_->createPartition();
+  put({TestRecord(logid, 30, BASE_TIME + 20)});
+
+  FINDTIME(logid, BASE_TIME + 15, LSN_INVALID, LSN_MAX, 20, 30);
+  FINDTIME(logid, BASE_TIME + 25, LSN_INVALID, LSN_MAX, 30, LSN_MAX);
+  EXPECT_EQ(1, stats_.aggregate().logsdb_directory_index_rebuilds);
+
+  store_->dropPartitionsUpTo(ID0 + 1);
+  FINDTIME(logid, BASE_TIME + 15, LSN_INVALID, LSN_MAX, 20, 30);
+  FINDTIME(logid, BASE_TIME + 25, LSN_INVALID, LSN_MAX, 30, LSN_MAX);
+}
+
 TEST_F(PartitionedRocksDBStoreTest, FindTimeTimedout) {
   logid_t logid(3);
 
@@ -4029,6 +4332,46 @@ TEST_F(PartitionedRocksDBStoreTest, FindKeyStrictSameKeyAtPartitionBoundaries) {
   FINDKEY(logid, std::string("10000007"), 60, LSN_MAX, false);
 }
 
+// With --rocksdb-findkey-parallel-probes the directory search probes several
+// partitions per round; results must be the same as with the binary search.
+TEST_F(PartitionedRocksDBStoreTest, FindKeyParallelProbes) {
+  logid_t logid(3);
+  openStore({{"rocksdb-findkey-parallel-probes", "3"},
+             {"rocksdb-iterator-parallel-seek-threads", "2"}});
+
+  // Partition i has a record with key 2*i at LSN 10*(i+1). Every third
+  // partition is empty.
+  const int kPartitions = 20;
+  std::vector<lsn_t> lsns;
+  for (int i = 0; i < kPartitions; ++i) {
+    if (i % 3 != 2) {
+      lsns.push_back(10 * (i + 1));
+      put({TestRecord(logid,
+                      lsns.back(),
+                      false,
+                      BASE_TIME + 2 * i,
+                      folly::Optional<std::string>(
+                          folly::sformat("{:08}", 2 * i)))});
+    }
+    time_ = SystemTimestamp(std::chrono::milliseconds(BASE_TIME + 2 * i + 1));
+    store_->createPartition();
+  }
+
+  size_t idx = 0;
+  for (int i = 0; i < kPartitions; ++i) {
+    if (i % 3 == 2) {
+      continue;
+    }
+    lsn_t prev = idx == 0 ? LSN_INVALID : lsns[idx - 1];
+    lsn_t next = idx + 1 < lsns.size() ? lsns[idx + 1] : LSN_MAX;
+    FINDKEY(logid, folly::sformat("{:08}", 2 * i), prev, lsns[idx], false);
+    FINDKEY(logid, folly::sformat("{:08}", 2 * i + 1), lsns[idx], next, false);
+    ++idx;
+  }
+  EXPECT_GT(stats_.aggregate().logsdb_findkey_directory_probes,
+            stats_.aggregate().logsdb_findkey_directory_rounds);
+}
+
 TEST_F(PartitionedRocksDBStoreTest, FindKeyStrictSameMinKey) {
   logid_t logid(3);
   openStore();
@@ -4917,6 +5260,48 @@ TEST_F(PartitionedRocksDBStoreTest, TightDirectory) {
   ASSERT_EQ(20, data[1][logid].first_lsn);
 }
 
+// Iterator should skip partitions that have directory entries but no records
+// for the log, using concurrent probing if enabled.
+TEST_F(PartitionedRocksDBStoreTest, ParallelPartitionProbing) {
+  closeStore();
+  openStore({{"rocksdb-iterator-parallel-seek-partitions", "4"},
+             {"rocksdb-iterator-parallel-seek-threads", "2"}});
+  no_deletes_ = false;
+  logid_t logid(3);
+
+  put({TestRecord(logid, 5)});
+  // Ten partitions with directory entries for the log but no records.
+  for (lsn_t lsn = 10; lsn < 20; ++lsn) {
+    store_->createPartition();
+    put({TestRecord(logid, lsn)});
+    put({TestRecord(logid, lsn, TestRecord::Type::DELETE)});
+  }
+  store_->createPartition();
+  put({TestRecord(logid, 100), TestRecord(logid, 101)});
+
+  auto it = store_->read(
+      logid, LocalLogStore::ReadOptions("ParallelPartitionProbing"));
+  it->seek(1);
+  ASSERT_EQ(IteratorState::AT_RECORD, it->state());
+  EXPECT_EQ(5, it->getLSN());
+  it->next();
+  ASSERT_EQ(IteratorState::AT_RECORD, it->state());
+  EXPECT_EQ(100, it->getLSN());
+  it->next();
+  ASSERT_EQ(IteratorState::AT_RECORD, it->state());
+  EXPECT_EQ(101, it->getLSN());
+  it->next();
+  EXPECT_EQ(IteratorState::AT_END, it->state());
+
+  it->seek(12);
+  ASSERT_EQ(IteratorState::AT_RECORD, it->state());
+  EXPECT_EQ(100, it->getLSN());
+
+  Stats stats = stats_.aggregate();
+  EXPECT_GT(stats.logsdb_iterator_partitions_probed, 0);
+  EXPECT_GT(stats.logsdb_iterator_partitions_skipped_by_probe, 0);
+}
+
 // Check that event log records are not written to partitions.
 TEST_F(PartitionedRocksDBStoreTest, UnpartitionedEventLog) {
   put({TestRecord(
@@ -6094,6 +6479,75 @@ TEST_F(PartitionedRocksDBStoreTest, CompactionRangeSkip) {
   EXPECT_EQ(std::vector<lsn_t>({450}), data[0][logid_t(230)].records);
 }
 
+// Same trimming as above, but with trim points looked up in a snapshot taken
+// at the first log the filter encounters.
+TEST_F(PartitionedRocksDBStoreTest, CompactionTrimPointSnapshot) {
+  updateSetting("rocksdb-compaction-trim-point-snapshot-min-logs", "1");
+
+  put({TestRecord(logid_t(210), 100, BASE_TIME)});
+  put({TestRecord(logid_t(210), 250, BASE_TIME)});
+  put({TestRecord(logid_t(220), 200, BASE_TIME)});
+  put({TestRecord(logid_t(230), 300, BASE_TIME)});
+  put({TestRecord(logid_t(230), 450, BASE_TIME)});
+  put({TestRecord(logid_t(240), 400, BASE_TIME)});
+  store_->createPartition();
+
+  aligned_trims_ = false;
+  int rv = LocalLogStoreUtils::updateTrimPoints(
+      {{logid_t(220), 350}, {logid_t(230), 400}, {logid_t(240), 1000}},
+      processor_.get(),
+      *store_,
+      false,
+      &stats_);
+  EXPECT_EQ(0, rv);
+
+  store_->performCompaction(ID0);
+  EXPECT_EQ(1, stats_.aggregate().partitions_compacted);
+
+  auto data = readAndCheck();
+  ASSERT_EQ(2, data.size());
+  EXPECT_EQ(std::vector<lsn_t>({100, 250}), data[0][logid_t(210)].records);
+  EXPECT_EQ(std::vector<lsn_t>(), data[0][logid_t(220)].records);
+  EXPECT_EQ(std::vector<lsn_t>({450}), data[0][logid_t(230)].records);
+  EXPECT_EQ(std::vector<lsn_t>(), data[0][logid_t(240)].records);
+}
+
+// Small partitions get up to 3 times longer before the time trigger fires.
+TEST_F(PartitionedRocksDBStoreTest, QuietPartitionDurationTrigger) {
+  closeStore();
+  openStore({{"rocksdb-partition-duration", "10h"},
+             {"rocksdb-partition-duration-trigger-min-size", "1M"},
+             {"rocksdb-compression-type", "none"}});
+  EXPECT_EQ(1, store_->getPartitionList()->size());
+  put({TestRecord(logid_t(42), 1, BASE_TIME + HOUR)});
+
+  auto run_at = [&](uint64_t hours) {
+    time_ =
+        SystemTimestamp(std::chrono::milliseconds(BASE_TIME + HOUR * hours));
+    store_
+        ->backgroundThreadIteration(
+            PartitionedRocksDBStore::BackgroundThreadType::HI_PRI)
+        .wait();
+  };
+
+  // Past the partition duration, but the partition is small.
+  run_at(11);
+  EXPECT_EQ(1, store_->getPartitionList()->size());
+  run_at(29);
+  EXPECT_EQ(1, store_->getPartitionList()->size());
+  run_at(31);
+  EXPECT_EQ(2, store_->getPartitionList()->size());
+
+  // Once the partition is big enough, the regular duration applies.
+  std::string payload(100000, 'x');
+  for (lsn_t lsn = 2; lsn <= 20; ++lsn) {
+    put({TestRecord(logid_t(42), lsn, BASE_TIME + HOUR * 35)
+             .payload(Payload(payload.data(), payload.size()))});
+  }
+  run_at(42);
+  EXPECT_EQ(3, store_->getPartitionList()->size());
+}
+
 TEST_F(PartitionedRocksDBStoreTest, NewPartitionTriggers) {
   closeStore();
   openStore({{"rocksdb-partition-duration", "10h"},
@@ -7593,6 +8047,28 @@ TEST_F(PartitionedRocksDBStoreTest, MetadataCompactions) {
   EXPECT_EQ(1, store_->getNumL0Files(store_->getMetadataCFHandle()));
 }
 
+TEST_F(PartitionedRocksDBStoreTest, PerColumnFamilyOptions) {
+  closeStore();
+  openStore({{"rocksdb-compression-type", "lz4"},
+             {"rocksdb-metadata-compression-type", "none"},
+             {"rocksdb-unpartitioned-block-size", "4K"},
+             {"rocksdb-unpartitioned-compression-type", "lz4hc"}});
+
+  rocksdb::DB& db = store_->getDB();
+  auto data_options = db.GetOptions(store_->getLatestPartition()->cf_->get());
+  auto metadata_options = db.GetOptions(store_->getMetadataCFHandle());
+  auto unpartitioned_options =
+      db.GetOptions(store_->getUnpartitionedCFHandle());
+
+  EXPECT_EQ(rocksdb::kLZ4Compression, data_options.compression);
+  EXPECT_EQ(rocksdb::kNoCompression, metadata_options.compression);
+  EXPECT_EQ(rocksdb::kLZ4HCCompression, unpartitioned_options.compression);
+  EXPECT_NE(data_options.table_factory, unpartitioned_options.table_factory);
+
+  // Unpartitioned column family still uses the merge operator of data.
+  EXPECT_NE(nullptr, unpartitioned_options.merge_operator);
+}
+
 // TODO(T44746268): replace NDEBUG with folly::kIsDebug
 #ifdef NDEBUG
 #define IF_DEBUG(...)
@@ -9762,6 +10238,44 @@ TEST_F(PartitionedRocksDBStoreTest, PartitionFlushSimpleTests) {
   }
 }
 
+// Flush trigger scale shortens the data age trigger.
+TEST_F(PartitionedRocksDBStoreTest, PartitionFlushTriggerScaleTest) {
+  updateSetting("rocksdb-partition-data-age-flush-trigger", "100s");
+  updateSetting("rocksdb-partition-idle-flush-trigger", "0");
+  using FlushEvaluator = PartitionedRocksDBStore::FlushEvaluator;
+  using CFData = FlushEvaluator::CFData;
+  using RocksDBMemTableStats = PartitionedRocksDBStore::RocksDBMemTableStats;
+  uint64_t budget = 1000;
+
+  auto latest_partition = store_->getLatestPartition();
+  auto now = store_->currentSteadyTime();
+  latest_partition->cf_->first_dirtied_time_ = now - std::chrono::seconds(60);
+  SCOPE_EXIT {
+    latest_partition->cf_->first_dirtied_time_ = SteadyTimestamp::min();
+  };
+
+  auto evaluate = [&](double scale) {
+    FlushEvaluator evaluator(store_->getShardIdx(),
+                             budget,
+                             budget,
+                             budget / 2,
+                             store_->getRocksDBLogStoreConfig(),
+                             scale);
+    auto metadata_cf = store_->getMetadataCFPtr();
+    CFData metadata_cf_data{metadata_cf, RocksDBMemTableStats(), now};
+    std::vector<CFData> candidates{
+        {latest_partition->cf_, RocksDBMemTableStats{10, 0, 0}, now}};
+    return evaluator.pickCFsToFlush(now, metadata_cf_data, candidates);
+  };
+
+  // 60s old data is below the 100s trigger.
+  EXPECT_TRUE(evaluate(1.0).empty());
+  // But above the trigger shortened to 50s.
+  auto picked = evaluate(0.5);
+  ASSERT_EQ(1u, picked.size());
+  EXPECT_EQ(latest_partition->cf_->getID(), picked[0].cf->getID());
+}
+
 // Latest two partitions have different policy compared to other older
 // partitions. Run simple tests for them.
 TEST_F(PartitionedRocksDBStoreTest, FlushLatestPartitionsTest) {
@@ -10772,3 +11286,29 @@ TEST_F(PartitionedRocksDBStoreTest, BatchWithDelete) {
     EXPECT_EQ(1, nread);
   }
 }
+
+TEST(WritePressureEstimatorTest, Basic) {
+  RocksDBLogStoreBase::WritePressureEstimator estimator;
+  const std::chrono::milliseconds horizon(10000);
+  SteadyTimestamp t = SteadyTimestamp::now();
+
+  // Below half the threshold and not growing.
+  EXPECT_EQ(0, estimator.update(t, 400, 1000, 0, 50, horizon));
+  // Halfway between half the threshold and the threshold.
+  EXPECT_DOUBLE_EQ(0.5, estimator.update(t, 750, 1000, 0, 50, horizon));
+  // Backlog counts too.
+  EXPECT_DOUBLE_EQ(0.6, estimator.update(t, 0, 1000, 40, 50, horizon));
+
+  // Memtables growing by 30 bytes/s are predicted to grow by another 300 over
+  // the horizon. With an elapsed time equal to the horizon the smoothed rate
+  // is just the last sample.
+  EXPECT_EQ(0, estimator.update(t, 0, 1000, 0, 0, horizon));
+  t += horizon;
+  EXPECT_DOUBLE_EQ(0.2, estimator.update(t, 300, 1000, 0, 0, horizon));
+  // Shrinking isn't extrapolated.
+  t += horizon;
+  EXPECT_EQ(0, estimator.update(t, 0, 1000, 0, 0, horizon));
+
+  // Stall thresholds of 0 are ignored.
+  EXPECT_EQ(0, estimator.update(t, 1000, 0, 1000, 0, horizon));
+}
@@ -8,6 +8,7 @@
 #include "logdevice/server/locallogstore/RocksDBLocalLogStore.h"
 
 #include <memory>
+#include <thread>
 
 #include <folly/Memory.h>
 #include <folly/ScopeGuard.h>
@@ -507,6 +508,69 @@ TEST_F(RocksDBLocalLogStoreTest, WriteReadBackTest) {
   }
 }
 
+// Writes from many threads with group commit on, with both WAL and
+// memtable-only writes in each batch.
+TEST_F(RocksDBLocalLogStoreTest, GroupCommit) {
+  RocksDBSettings settings = RocksDBSettings::defaultTestSettings();
+  settings.group_commit = true;
+  RocksDBLogStoreConfig config(
+      UpdateableSettings<RocksDBSettings>(settings),
+      UpdateableSettings<RebuildingSettings>(),
+      &env_,
+      nullptr,
+      &stats_);
+  config.createMergeOperator(0);
+  TemporaryLogStore store([&](std::string path) {
+    return std::make_unique<RocksDBLocalLogStore>(
+        0,
+        1,
+        path,
+        config,
+        RocksDBCustomiser::defaultInstance(),
+        &stats_,
+        /* io_tracing */ nullptr);
+  });
+
+  const int kThreads = 8;
+  const lsn_t kRecordsPerThread = 200;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&, t] {
+      for (lsn_t lsn = 1; lsn <= kRecordsPerThread; lsn += 2) {
+        std::vector<PutWriteOp> ops;
+        for (lsn_t l : {lsn, lsn + 1}) {
+          ops.push_back(PutWriteOp{logid_t(t + 1),
+                                   l,
+                                   getHeader(),
+                                   Slice("abc", 3),
+                                   folly::none,
+                                   folly::none,
+                                   Slice(nullptr, 0),
+                                   {},
+                                   l % 2 ? Durability::ASYNC_WRITE
+                                         : Durability::MEMORY,
+                                   false});
+        }
+        ASSERT_EQ(0, store.writeMulti({&ops[0], &ops[1]}));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (int t = 0; t < kThreads; ++t) {
+    std::unique_ptr<LocalLogStore::ReadIterator> it = store.read(
+        logid_t(t + 1), LocalLogStore::ReadOptions("GroupCommit"));
+    it->seek(0);
+    lsn_t expected = 1;
+    for (; it->state() == IteratorState::AT_RECORD; ++expected, it->next()) {
+      EXPECT_EQ(expected, it->getLSN());
+    }
+    EXPECT_EQ(kRecordsPerThread + 1, expected);
+  }
+}
+
 TEST_F(RocksDBLocalLogStoreTest, BatchWithDelete) {
   auto store = createRocksDBLocalLogStore();
   std::vector<std::unique_ptr<WriteOp>> ops;
@@ -676,6 +740,42 @@ STORE_TEST(RocksDBLocalLogStoreTest, UpdateMetadata, store) {
       store.updateLogMetadata(logid_t(2), tm4, LocalLogStore::WriteOptions()));
 }
 
+STORE_TEST(RocksDBLocalLogStoreTest, UpdateMetadataBatch, store) {
+  TrimMetadata existing{100};
+  ASSERT_EQ(0,
+            store.writeLogMetadata(
+                logid_t(1), existing, LocalLogStore::WriteOptions()));
+
+  TrimMetadata older{50};   // log 1, lower than what's stored
+  TrimMetadata newer{200};  // log 1, higher than what's stored
+  TrimMetadata first{10};   // log 2, not stored yet
+  TrimMetadata second{30};  // log 2 again, supersedes `first`
+  TrimMetadata third{20};   // log 2 again, lower than `second`
+  std::vector<std::pair<logid_t, ComparableLogMetadata*>> updates{
+      {logid_t(1), &older},
+      {logid_t(1), &newer},
+      {logid_t(2), &first},
+      {logid_t(2), &second},
+      {logid_t(2), &third}};
+  std::vector<Status> statuses;
+  ASSERT_EQ(0,
+            store.updateLogMetadataBatch(
+                updates, statuses, LocalLogStore::WriteOptions()));
+
+  std::vector<Status> expected{
+      E::UPTODATE, E::OK, E::UPTODATE, E::OK, E::UPTODATE};
+  EXPECT_EQ(expected, statuses);
+  EXPECT_EQ(100, older.trim_point_);
+  EXPECT_EQ(30, first.trim_point_);
+  EXPECT_EQ(30, third.trim_point_);
+
+  TrimMetadata metadata;
+  ASSERT_EQ(0, store.readLogMetadata(logid_t(1), &metadata));
+  EXPECT_EQ(200, metadata.trim_point_);
+  ASSERT_EQ(0, store.readLogMetadata(logid_t(2), &metadata));
+  EXPECT_EQ(30, metadata.trim_point_);
+}
+
 STORE_TEST(RocksDBLocalLogStoreTest, WriteInvalidMetadata, store) {
   // turn off dd_assert()
   dbg::assertOnData = false;
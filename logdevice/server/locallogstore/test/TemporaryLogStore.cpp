@@ -124,6 +124,13 @@ int TemporaryLogStore::updateLogMetadata(logid_t log_id,
   return db_->updateLogMetadata(log_id, metadata, options);
 }
 
+int TemporaryLogStore::updateLogMetadataBatch(
+    const std::vector<std::pair<logid_t, ComparableLogMetadata*>>& updates,
+    std::vector<Status>& statuses_out,
+    const WriteOptions& options) {
+  return db_->updateLogMetadataBatch(updates, statuses_out, options);
+}
+
 int TemporaryLogStore::readStoreMetadata(StoreMetadata* metadata) {
   return db_->readStoreMetadata(metadata);
 }
@@ -91,6 +91,10 @@ class TemporaryLogStore : public LocalLogStore {
   int updateLogMetadata(logid_t log_id,
                         ComparableLogMetadata& metadata,
                         const WriteOptions& options) override;
+  int updateLogMetadataBatch(
+      const std::vector<std::pair<logid_t, ComparableLogMetadata*>>& updates,
+      std::vector<Status>& statuses_out,
+      const WriteOptions& options) override;
   int readStoreMetadata(StoreMetadata* metadata) override;
   int writeStoreMetadata(const StoreMetadata& metadata,
                          const WriteOptions& options) override;
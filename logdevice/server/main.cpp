@@ -24,6 +24,7 @@
 #include "logdevice/admin/settings/AdminServerSettings.h"
 #include "logdevice/common/BuildInfo.h"
 #include "logdevice/common/ConstructorFailed.h"
+#include "logdevice/common/MemoryArenas.h"
 #include "logdevice/common/NoopTraceLogger.h"
 #include "logdevice/common/Semaphore.h"
 #include "logdevice/common/StatsCollectionThread.h"
@@ -179,6 +180,16 @@ possibly_lock_mem(UpdateableSettings<ServerSettings> server_settings) {
   }
 }
 
+static void
+create_memory_arenas(UpdateableSettings<ServerSettings> server_settings) {
+  if (server_settings->dedicated_memory_arenas) {
+    // Must happen before workers start allocating appenders and messages.
+    if (!MemoryArenas::enable()) {
+      ld_warning("Using the default memory arena for all allocations");
+    }
+  }
+}
+
 /**
  * If running as root, attempt to switch to a different user specified on the
  * command line.
@@ -440,6 +451,7 @@ int main(int argc, const char** argv) {
 
   set_fd_limit(server_settings);
   possibly_lock_mem(server_settings);
+  create_memory_arenas(server_settings);
   drop_root(server_settings);
 
   // Run the StatsCollectionThread
@@ -97,6 +97,7 @@ Message::Disposition DATA_SIZE_onReceived(DATA_SIZE_Message* msg,
   if (!partitioned_store) {
     // Only supported on partitioned, rocksdb-based stores
     send_reply(from, header, E::NOTSUPPORTED, 0);
+    return Message::Disposition::NORMAL;
   }
 
   ld_debug("DATA_SIZE: log %lu in range [%lu,%lu]",
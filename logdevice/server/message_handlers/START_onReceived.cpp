@@ -268,7 +268,7 @@ Message::Disposition START_onReceived(START_Message* msg,
           ld_check(result.second == nullptr);
           FOLLY_FALLTHROUGH;
         case RecordCache::Result::HIT: {
-          std::unique_ptr<const EpochRecordCache::Snapshot> epoch_snapshot;
+          std::shared_ptr<const EpochRecordCache::Snapshot> epoch_snapshot;
           if (result.second != nullptr) {
             // if true, the epoch cache does not have all records requested
             // by the digest stream. It is possible that the LNG has been
@@ -287,9 +287,10 @@ Message::Disposition START_onReceived(START_Message* msg,
               // TODO (T35832374) : Remove enable_offset_map when OffsetMap is
               // supported by all servers
               bool enable_offset_map = w->settings().enable_offset_map;
-              // create an immutable snapshot of the epoch cache
-              epoch_snapshot =
-                  result.second->createSerializableSnapshot(enable_offset_map);
+              // create an immutable snapshot of the epoch cache, or reuse
+              // one taken for an earlier digest of the epoch
+              epoch_snapshot = w->cachedDigests().getEpochSnapshot(
+                  *result.second, enable_offset_map);
               ld_check(epoch_snapshot != nullptr);
               ld_check(epoch_snapshot->getHeader() != nullptr);
 
@@ -427,6 +428,11 @@ Message::Disposition START_onReceived(START_Message* msg,
       } else {
         stream->disableLocalScd();
       }
+      if (header.flags & START_Header::SCD_PREFERRED_NODES) {
+        stream->scd_preferred_nodes_ = msg->scd_preferred_nodes_;
+      } else {
+        stream->scd_preferred_nodes_.clear();
+      }
     } else {
       stream->disableSingleCopyDelivery();
     }
@@ -506,6 +512,7 @@ Message::Disposition START_onReceived(START_Message* msg,
                    "Server-side filtering is enabled. %s",
                    toString(*stream->filter_pred_).c_str());
   }
+  stream->sampling_ = msg->attrs_.sampling;
 
   w->processor_->getLogStorageStateMap().recoverLogState(
       header.log_id, shard_idx, LogStorageState::RecoverContext::START_MESSAGE);
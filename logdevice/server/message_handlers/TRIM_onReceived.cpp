@@ -9,9 +9,7 @@
 
 #include <string>
 
-#include "logdevice/common/Metadata.h"
 #include "logdevice/common/PermissionChecker.h"
-#include "logdevice/common/PrincipalIdentity.h"
 #include "logdevice/common/Processor.h"
 #include "logdevice/common/Sender.h"
 #include "logdevice/common/UpdateableSecurityInfo.h"
@@ -20,11 +18,7 @@
 #include "logdevice/common/stats/Stats.h"
 #include "logdevice/server/ServerProcessor.h"
 #include "logdevice/server/ServerWorker.h"
-#include "logdevice/server/locallogstore/LocalLogStore.h"
-#include "logdevice/server/read_path/LogStorageStateMap.h"
-#include "logdevice/server/storage_tasks/PerWorkerStorageTaskQueue.h"
-#include "logdevice/server/storage_tasks/StorageTask.h"
-#include "logdevice/server/storage_tasks/StorageThreadPool.h"
+#include "logdevice/server/storage/TrimMetadataBatcher.h"
 
 namespace facebook { namespace logdevice {
 
@@ -37,84 +31,6 @@ static void send_reply(const Address& to,
       std::make_unique<TRIMMED_Message>(header), to);
 }
 
-namespace {
-// A task to write the trim point to local log store
-class WriteTrimMetadataTask : public StorageTask {
- public:
-  explicit WriteTrimMetadataTask(logid_t log_id,
-                                 lsn_t trim_point,
-                                 const Address& reply_to,
-                                 request_id_t client_rqid,
-                                 std::string client_name,
-                                 std::string client_address,
-                                 PrincipalIdentity identity)
-      : StorageTask(StorageTask::Type::WRITE_TRIM_METADATA),
-        log_id_(log_id),
-        trim_point_(trim_point),
-        reply_to_(reply_to),
-        client_rqid_(client_rqid),
-        status_(E::OK),
-        client_name_(std::move(client_name)),
-        client_address_(std::move(client_address)),
-        identity_(std::move(identity)) {}
-
-  Principal getPrincipal() const override {
-    return Principal::METADATA;
-  }
-
-  void execute() override {
-    LocalLogStore& store = storageThreadPool_->getLocalLogStore();
-    LogStorageStateMap& map =
-        storageThreadPool_->getProcessor().getLogStorageStateMap();
-
-    TrimMetadata trim_metadata{trim_point_};
-    LocalLogStore::WriteOptions options;
-    int rv = store.updateLogMetadata(log_id_, trim_metadata, options);
-    if (rv != 0) {
-      // if local log store already contained a trim point with a higher LSN,
-      // report it as a success to the client
-      status_ = (err == E::UPTODATE ? E::OK : E::FAILED);
-      return;
-    }
-
-    LogStorageState* log_state =
-        map.insertOrGet(log_id_, storageThreadPool_->getShardIdx());
-    if (log_state == nullptr) {
-      status_ = E::FAILED;
-      return;
-    }
-
-    log_state->updateTrimPoint(trim_point_);
-    durability_ = Durability::SYNC_WRITE;
-  }
-
-  Durability durability() const override {
-    return durability_;
-  }
-
-  void onDone() override {
-    send_reply(
-        reply_to_, client_rqid_, status_, storageThreadPool_->getShardIdx());
-  }
-
-  void onDropped() override {
-    send_reply(
-        reply_to_, client_rqid_, E::FAILED, storageThreadPool_->getShardIdx());
-  }
-
- private:
-  logid_t log_id_;
-  lsn_t trim_point_;
-  Address reply_to_;
-  request_id_t client_rqid_;
-  Status status_;
-  Durability durability_ = Durability::INVALID;
-  std::string client_name_;
-  std::string client_address_;
-  PrincipalIdentity identity_;
-};
-} // namespace
-
 static Message::Disposition
 send_reply(TRIM_Message* msg,
            const Address& from,
@@ -169,17 +85,12 @@ send_reply(TRIM_Message* msg,
     return Message::Disposition::NORMAL;
   }
 
-  // queue a task that'll write trim_point to the log store, update the
-  // state map and send a reply to the client
-  auto task = std::make_unique<WriteTrimMetadataTask>(
-      header.log_id,
-      header.trim_point,
-      from,
-      header.client_rqid,
-      Sender::describeConnection(from),
-      info->peer_address.toStringNoPort(),
-      *info->principal);
-  worker->getStorageTaskQueueForShard(shard_idx)->putTask(std::move(task));
+  // queue the trim point to be written to the log store together with other
+  // trims of the shard; the storage task will update the state map and send
+  // a reply to the client
+  worker->trimMetadataBatcher().add(
+      shard_idx,
+      {header.log_id, header.trim_point, from, header.client_rqid});
 
   return Message::Disposition::NORMAL;
 }
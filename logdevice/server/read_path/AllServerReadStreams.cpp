@@ -18,6 +18,7 @@
 #include "logdevice/common/ShapingContainer.h"
 #include "logdevice/common/configuration/UpdateableConfig.h"
 #include "logdevice/common/debug.h"
+#include "logdevice/common/protocol/RECORDS_BATCH_Message.h"
 #include "logdevice/common/protocol/RECORD_Message.h"
 #include "logdevice/common/protocol/RELEASE_Message.h"
 #include "logdevice/common/protocol/SHARD_STATUS_UPDATE_Message.h"
@@ -29,6 +30,7 @@
 #include "logdevice/server/read_path/IteratorCache.h"
 #include "logdevice/server/storage_tasks/EpochOffsetStorageTask.h"
 #include "logdevice/server/storage_tasks/PerWorkerStorageTaskQueue.h"
+#include "logdevice/server/storage_tasks/ReadBatchStorageTask.h"
 #include "logdevice/server/storage_tasks/ReadStorageTask.h"
 #include "logdevice/server/storage_tasks/ShardedStorageThreadPool.h"
 
@@ -42,7 +44,8 @@ AllServerReadStreams::AllServerReadStreams(
     ServerProcessor* processor,
     StatsHolder* stats,
     bool on_worker_thread)
-    : real_time_record_buffer_(
+    : iterator_cache_lru_(settings),
+      real_time_record_buffer_(
           settings->real_time_max_bytes / settings->num_workers,
           settings->real_time_eviction_threshold_bytes / settings->num_workers,
           stats),
@@ -50,6 +53,7 @@ AllServerReadStreams::AllServerReadStreams(
       stats_(stats),
       settings_(settings),
       memory_budget_(max_read_storage_tasks_mem),
+      read_io_principal_scheduler_(stats),
       worker_id_(worker_id),
       log_storage_state_map_(log_storage_state_map),
       on_worker_thread_(on_worker_thread) {}
@@ -137,7 +141,8 @@ AllServerReadStreams::insertOrGet(ClientID client_id,
               &processor_->sharded_storage_thread_pool_->getByIndex(shard)
                    .getLocalLogStore(),
               log_id,
-              false /* created_for_rebuilding */);
+              false /* created_for_rebuilding */,
+              &iterator_cache_lru_);
     }
   } else {
     deref(insert_result.first).log_group_path_ = log_group_path;
@@ -301,6 +306,23 @@ void AllServerReadStreams::onRecordSent(ClientID client_id,
   }
 }
 
+void AllServerReadStreams::onRecordsBatchSent(
+    ClientID client_id,
+    const RECORDS_BATCH_Message& msg,
+    const SteadyTimestamp enqueue_time) {
+  auto it = client_states_.find(client_id);
+  if (it != client_states_.end()) {
+    ld_check(it->second.catchup_queue);
+    auto* stream = get(client_id,
+                       msg.header_.log_id,
+                       msg.header_.read_stream_id,
+                       msg.header_.shard);
+    it->second.catchup_queue->onRecordsBatchSent(msg, stream, enqueue_time);
+  } else {
+    // Client disconnected, nothing to do.
+  }
+}
+
 void AllServerReadStreams::onStartedSent(ClientID client_id,
                                          const STARTED_Message& msg,
                                          const SteadyTimestamp enqueue_time) {
@@ -377,6 +399,31 @@ void AllServerReadStreams::scheduleSendDelayedStorageTasks() {
   send_delayed_storage_tasks_timer_.activate(std::chrono::microseconds(0));
 }
 
+void AllServerReadStreams::waitForDRRTurn(ClientID client_id) {
+  drr_waiting_clients_.push_back(client_id);
+  if (!drr_turn_timer_.isAssigned()) {
+    drr_turn_timer_.assign([this] { giveDRRTurns(); });
+  }
+  if (!drr_turn_timer_.isActive()) {
+    drr_turn_timer_.activate(std::chrono::microseconds(0));
+  }
+}
+
+void AllServerReadStreams::giveDRRTurns() {
+  // A CatchupQueue may use up its new quantum right away and ask for another
+  // turn; it will get it on the next timer tick, behind the others.
+  std::vector<ClientID> clients;
+  clients.swap(drr_waiting_clients_);
+  for (ClientID client_id : clients) {
+    auto it = client_states_.find(client_id);
+    if (it == client_states_.end() || !it->second.catchup_queue) {
+      // Client disconnected while waiting.
+      continue;
+    }
+    it->second.catchup_queue->onDRRTurn();
+  }
+}
+
 Message::Disposition
 AllServerReadStreams::onWindowMessage(WINDOW_Message* msg,
                                       const Address& from) {
@@ -590,6 +637,15 @@ void AllServerReadStreams::getCatchupQueuesDebugInfo(
   }
 }
 
+void AllServerReadStreams::getCatchupQueuesDebugInfo(
+    ClientID client_id,
+    InfoCatchupQueuesTable& table) {
+  auto it = client_states_.find(client_id);
+  if (it != client_states_.end() && it->second.catchup_queue) {
+    it->second.catchup_queue->getDebugInfo(table);
+  }
+}
+
 void AllServerReadStreams::getReadStreamsDebugInfo(
     ClientID client_id,
     InfoReadersTable& table) const {
@@ -693,8 +749,58 @@ void AllServerReadStreams::sendStorageTask(
     shard_index_t shard) {
   ServerWorker* worker = ServerWorker::onThisThread();
   ld_check(worker);
+  const size_t batch_size = settings_->read_storage_task_batch_size;
+  if (batch_size <= 1) {
+    auto task_queue = worker->getStorageTaskQueueForShard(shard);
+    task_queue->putTask(std::move(task));
+    return;
+  }
+
+  ReadBatchKey key{shard,
+                   task->getThreadType(),
+                   task->getPriority(),
+                   task->getPrincipal()};
+  auto it = pending_read_batches_.find(key);
+  if (it == pending_read_batches_.end()) {
+    it = pending_read_batches_.emplace(key, decltype(it->second)()).first;
+  }
+  it->second.push_back(std::move(task));
+  if (it->second.size() >= batch_size) {
+    auto tasks = std::move(it->second);
+    pending_read_batches_.erase(it);
+    sendReadBatch(shard, std::move(tasks));
+    return;
+  }
+
+  if (!flush_read_batches_timer_.isAssigned()) {
+    flush_read_batches_timer_.assign([this] { flushReadBatches(); });
+  }
+  if (!flush_read_batches_timer_.isActive()) {
+    flush_read_batches_timer_.activate(std::chrono::microseconds(0));
+  }
+}
+
+void AllServerReadStreams::sendReadBatch(
+    shard_index_t shard,
+    std::vector<std::unique_ptr<ReadStorageTask>> tasks) {
+  ld_check(!tasks.empty());
+  ServerWorker* worker = ServerWorker::onThisThread();
+  ld_check(worker);
   auto task_queue = worker->getStorageTaskQueueForShard(shard);
-  task_queue->putTask(std::move(task));
+  if (tasks.size() == 1) {
+    task_queue->putTask(std::move(tasks.front()));
+  } else {
+    task_queue->putTask(
+        std::make_unique<ReadBatchStorageTask>(std::move(tasks)));
+  }
+}
+
+void AllServerReadStreams::flushReadBatches() {
+  auto batches = std::move(pending_read_batches_);
+  pending_read_batches_.clear();
+  for (auto& kv : batches) {
+    sendReadBatch(std::get<0>(kv.first), std::move(kv.second));
+  }
 }
 
 ResourceBudget& AllServerReadStreams::getMemoryBudget() {
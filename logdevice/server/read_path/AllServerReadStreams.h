@@ -10,7 +10,9 @@
 #include <map>
 #include <queue>
 #include <set>
+#include <tuple>
 #include <utility>
+#include <vector>
 
 #include <boost/multi_index/composite_key.hpp>
 #include <boost/multi_index/hashed_index.hpp>
@@ -25,6 +27,7 @@
 #include "logdevice/common/ResourceBudget.h"
 #include "logdevice/common/ShardAuthoritativeStatusMap.h"
 #include "logdevice/common/SocketCallback.h"
+#include "logdevice/common/StorageTask-enums.h"
 #include "logdevice/common/Timer.h"
 #include "logdevice/common/protocol/STARTED_Message.h"
 #include "logdevice/common/protocol/STOP_Message.h"
@@ -34,7 +37,9 @@
 #include "logdevice/common/types_internal.h"
 #include "logdevice/include/types.h"
 #include "logdevice/server/read_path/CatchupQueue.h"
+#include "logdevice/server/read_path/IteratorCache.h"
 #include "logdevice/server/read_path/LogStorageStateMap.h"
+#include "logdevice/server/read_path/ReadIoPrincipalScheduler.h"
 #include "logdevice/server/read_path/ReadIoShapingCallback.h"
 #include "logdevice/server/read_path/ServerReadStream.h"
 
@@ -52,6 +57,7 @@ namespace facebook { namespace logdevice {
 class EpochOffsetStorageTask;
 class ReadStorageTask;
 class RECORD_Message;
+class RECORDS_BATCH_Message;
 class StatsHolder;
 class ServerProcessor;
 class Worker;
@@ -177,6 +183,13 @@ class AllServerReadStreams : public ShardAuthoritativeStatusSubscriber {
                     const RECORD_Message& msg,
                     const SteadyTimestamp enqueue_time);
 
+  /**
+   * Same as onRecordSent() for a RECORDS_BATCH message.
+   */
+  void onRecordsBatchSent(ClientID client_id,
+                          const RECORDS_BATCH_Message& msg,
+                          const SteadyTimestamp enqueue_time);
+
   /**
    * Called when the messaging layer drains a STARTED message from the output
    * evbuffer.
@@ -202,6 +215,19 @@ class AllServerReadStreams : public ShardAuthoritativeStatusSubscriber {
    */
   void onReadTaskDropped(ReadStorageTask& task);
 
+  /**
+   * Called by a client's CatchupQueue when it used up its deficit round robin
+   * quantum (see Settings::catchup_queue_drr_quantum_bytes). The queue gets
+   * its next turn, through CatchupQueue::onDRRTurn(), in a later iteration of
+   * the event loop, after events of other clients already pending in this
+   * one. Clients waiting for a turn get them in the order they asked.
+   */
+  void waitForDRRTurn(ClientID client_id);
+
+  ReadIoPrincipalScheduler& readIoPrincipalScheduler() {
+    return read_io_principal_scheduler_;
+  }
+
   /**
    * Static handler for incoming WINDOW messages.  Validates a bit then calls
    * the instance method on the current Worker's AllServerReadStreams
@@ -334,6 +360,9 @@ class AllServerReadStreams : public ShardAuthoritativeStatusSubscriber {
   // debug information about ServerReadStream_s.
 
   void getCatchupQueuesDebugInfo(InfoCatchupQueuesTable& table);
+  // Only the CatchupQueue of the given client, if it is on this worker.
+  void getCatchupQueuesDebugInfo(ClientID client_id,
+                                 InfoCatchupQueuesTable& table);
 
   // All streams associated with a client.
   void getReadStreamsDebugInfo(ClientID client_id,
@@ -364,6 +393,9 @@ class AllServerReadStreams : public ShardAuthoritativeStatusSubscriber {
 
   /**
    * Send a ReadStorageTask for processing to PerWorkerStorageTaskQueue.
+   * If read storage task batching is enabled, the task may be held back until
+   * the end of the current event loop iteration and sent together with other
+   * tasks for the same shard as a ReadBatchStorageTask.
    * @param task Task to be processed.
    */
   virtual void sendStorageTask(std::unique_ptr<ReadStorageTask>&& task,
@@ -387,6 +419,10 @@ class AllServerReadStreams : public ShardAuthoritativeStatusSubscriber {
   // NOTE: updateSubscription(log_id) should be called whenever this changes
   //
 
+  // Bounds the number of streams below that hold cached iterators. Declared
+  // before streams_ so that it outlives their IteratorCaches.
+  IteratorCacheLRU iterator_cache_lru_;
+
   // Names for indexes
   struct FullKeyIndex {};
   struct LogIndex {};
@@ -548,6 +584,42 @@ class AllServerReadStreams : public ShardAuthoritativeStatusSubscriber {
   // away because it's not nice to post more tasks from onDropped() callback.
   Timer send_delayed_storage_tasks_timer_;
 
+  // ReadStorageTasks that were sent during the current event loop iteration
+  // and wait to be grouped into ReadBatchStorageTasks, keyed by everything
+  // that must be the same for all tasks in a batch.
+  // See Settings::read_storage_task_batch_size.
+  using ReadBatchKey = std::tuple<shard_index_t,
+                                  StorageTaskThreadType,
+                                  StorageTaskPriority,
+                                  StorageTaskPrincipal>;
+  std::map<ReadBatchKey, std::vector<std::unique_ptr<ReadStorageTask>>>
+      pending_read_batches_;
+
+  // A zero-delay timer to send the batches in pending_read_batches_.
+  Timer flush_read_batches_timer_;
+
+  // Sends the given tasks to the storage threads of `shard`, as a single
+  // ReadBatchStorageTask if there is more than one.
+  void sendReadBatch(shard_index_t shard,
+                     std::vector<std::unique_ptr<ReadStorageTask>> tasks);
+
+  // Sends all batches in pending_read_batches_.
+  void flushReadBatches();
+
+  // Clients whose CatchupQueues wait for their next deficit round robin turn,
+  // in the order they used up their quantum.
+  std::vector<ClientID> drr_waiting_clients_;
+
+  // A zero-delay timer to give the next turn to drr_waiting_clients_.
+  Timer drr_turn_timer_;
+
+  // Calls CatchupQueue::onDRRTurn() for every client in drr_waiting_clients_.
+  void giveDRRTurns();
+
+  // Shares read I/O bandwidth between principals, if
+  // Settings::read_throttling_share_by_principal is set.
+  ReadIoPrincipalScheduler read_io_principal_scheduler_;
+
   // Worker ID we are on, used to manage subscriptions for RELEASE messages.
   // In production, this is always equal to Worker::onThisThread()->idx_.  In
   // unit tests where there is no Worker, the test supplies a fake value.
@@ -15,6 +15,7 @@
 
 #include <folly/CppAttributes.h>
 #include <folly/Optional.h>
+#include <folly/ScopeGuard.h>
 
 #include "logdevice/common/BWAvailableCallback.h"
 #include "logdevice/common/Checksum.h"
@@ -24,6 +25,7 @@
 #include "logdevice/common/ServerRecordFilter.h"
 #include "logdevice/common/configuration/InternalLogs.h"
 #include "logdevice/common/protocol/GAP_Message.h"
+#include "logdevice/common/protocol/RECORDS_BATCH_Message.h"
 #include "logdevice/common/protocol/RECORD_Message.h"
 #include "logdevice/common/protocol/STARTED_Message.h"
 #include "logdevice/common/stats/Histogram.h"
@@ -166,7 +168,12 @@ EnumMap<CatchupOneStream::Action, std::string> CatchupOneStream::action_names;
  * different Callback buffers the records, making copies of all data and
  * passes them to the worker thread via the ReadStorageTask.  Once on a worker
  * thread, all records from the task are run through an instance of this class
- * and sent to the client.
+ * and sent to the client.  If the copies were made into IOBufs, RECORD
+ * messages share them instead of copying the payloads again.
+ *
+ * Records pushed from the real time buffer (see processRealTimeRecord()) are
+ * shared the same way, so all streams tailing a log reference a single copy
+ * of each released payload.
  */
 class ReadingCallback : public LocalLogStoreReader::Callback {
  public:
@@ -195,6 +202,10 @@ class ReadingCallback : public LocalLogStoreReader::Callback {
                     const ShardID* const copyset,
                     const OffsetMap& offsets_within_epoch);
 
+  // Ships a record from RealTimeRecordBuffer, sharing its payload with the
+  // RECORD message.
+  int processRealTimeRecord(const ZeroCopiedRecord& record);
+
  private:
   // Sends a RECORD_Message for the given record over the wire
   int shipRecord(lsn_t lsn,
@@ -221,10 +232,18 @@ class ReadingCallback : public LocalLogStoreReader::Callback {
   LocalLogStore* store_;
   ServerReadStream::RecordSource source_;
   CatchupEventTrigger catchup_reason_;
+  // Buffer owning the record currently being processed, if any. Only set
+  // for the duration of processRecord(const RawRecord&) and
+  // processRealTimeRecord().
+  const folly::IOBuf* record_buffer_ = nullptr;
 };
 
 int ReadingCallback::processRecord(const RawRecord& record) {
   const lsn_t lsn = record.lsn;
+  record_buffer_ = record.buffer.empty() ? nullptr : &record.buffer;
+  SCOPE_EXIT {
+    record_buffer_ = nullptr;
+  };
 
   // Parse the local log store blob
   std::chrono::milliseconds timestamp;
@@ -290,6 +309,24 @@ int ReadingCallback::processRecord(const RawRecord& record) {
                        offsets_within_epoch);
 }
 
+int ReadingCallback::processRealTimeRecord(const ZeroCopiedRecord& record) {
+  const folly::IOBuf& buffer = record.payload.iobuf();
+  record_buffer_ = buffer.empty() ? nullptr : &buffer;
+  SCOPE_EXIT {
+    record_buffer_ = nullptr;
+  };
+  return processRecord(record.lsn,
+                       std::chrono::milliseconds(record.timestamp),
+                       record.flags,
+                       record.keys,
+                       record.payload.getPayload(),
+                       record.wave_or_recovery_epoch,
+                       record.last_known_good,
+                       record.copyset.size(),
+                       record.copyset.data(),
+                       record.offsets_within_epoch);
+}
+
 int ReadingCallback::processRecord(
     const lsn_t lsn,
     const std::chrono::milliseconds timestamp,
@@ -305,11 +342,12 @@ int ReadingCallback::processRecord(
 
   // [Experimental Feature] If server-side filtering is enabled, we should
   // do filtering here. If record key can not pass record filter,
-  // filtered_out will be set to be true. A gap message with reason
-  // FILTERED_OUT will be sent to client-side.
-  bool filtered_out = false;
+  // filtered_out will be set to be true. The same goes for records dropped
+  // by sampling or outside the requested timestamp window. A gap message with
+  // reason FILTERED_OUT will be sent to client-side.
+  bool filtered_out = !stream_->sampling_.passes(lsn, timestamp);
 
-  if (stream_->filter_pred_ != nullptr &&
+  if (!filtered_out && stream_->filter_pred_ != nullptr &&
       (flags & LocalLogStoreRecordFormat::FLAG_OPTIONAL_KEYS)) {
     const auto it = optional_keys.find(KeyType::FILTERABLE);
     if (it != optional_keys.end()) {
@@ -649,6 +687,17 @@ int ReadingCallback::shipRecord(lsn_t lsn,
     h.length = static_cast<uint32_t>(payload.size());
     h.hash = checksum_32bit(Slice(payload));
     payload_holder = PayloadHolder::copyBuffer(&h, sizeof(h));
+  } else if (record_buffer_ != nullptr && payload.size() > 0 &&
+             (const uint8_t*)payload.data() >= record_buffer_->data() &&
+             (const uint8_t*)payload.data() + payload.size() <=
+                 record_buffer_->tail()) {
+    // The payload lies in a buffer that a storage thread copied out of the
+    // local log store, or in a record of the real time buffer. Share that
+    // buffer with the RECORD message instead of making another copy.
+    folly::IOBuf iobuf = record_buffer_->cloneAsValue();
+    iobuf.trimStart((const uint8_t*)payload.data() - iobuf.data());
+    iobuf.trimEnd(iobuf.length() - payload.size());
+    payload_holder = PayloadHolder(std::move(iobuf));
   } else {
     // Make private copy of the data so it is stable for the lifetime of
     // the, possibly deferred on transmission, RECORD message.
@@ -685,11 +734,20 @@ int ReadingCallback::shipRecord(lsn_t lsn,
   // Remember how much space we will take in the output evbuffer
   const auto msg_size = msg->size();
 
-  // Let the Sender deal with any traffic shaping induced deferral.
-  // We don't want to have to read the data again just because traffic
-  // shaping is pacing data.
-  int rv =
-      catchup_->deps_.sender_->sendMessage(std::move(msg), stream_->client_id_);
+  int rv;
+  if (catchup_->canBatchRecord(*msg)) {
+    rv = catchup_->batchRecord(std::move(msg), msg_size);
+  } else {
+    // Records batched so far must reach the client before this one.
+    rv = catchup_->flushRecordsBatch();
+    if (rv == 0) {
+      // Let the Sender deal with any traffic shaping induced deferral.
+      // We don't want to have to read the data again just because traffic
+      // shaping is pacing data.
+      rv = catchup_->deps_.sender_->sendMessage(
+          std::move(msg), stream_->client_id_);
+    }
+  }
 
   if (rv != 0) {
     ld_check(err != E::CBREGISTERED);
@@ -1235,17 +1293,7 @@ CatchupOneStream::Action CatchupOneStream::pushReleasedRecords(
 
       nrecords++;
 
-      int rv =
-          callback.processRecord(entry->lsn,
-                                 std::chrono::milliseconds(entry->timestamp),
-                                 entry->flags,
-                                 entry->keys,
-                                 entry->payload.getPayload(),
-                                 entry->wave_or_recovery_epoch,
-                                 entry->last_known_good,
-                                 entry->copyset.size(),
-                                 entry->copyset.data(),
-                                 entry->offsets_within_epoch);
+      int rv = callback.processRealTimeRecord(*entry);
       if (rv != 0) {
         ld_check_ne(err, E::CBREGISTERED);
         status = E::ABORTED;
@@ -1260,7 +1308,11 @@ CatchupOneStream::Action CatchupOneStream::pushReleasedRecords(
     }
   }
 
-  if (read_ctx.read_ptr_.lsn > stream_->getReadPtr().lsn) {
+  // If a record couldn't be shipped, the stream's read pointer is already
+  // where the next attempt needs to start. It may have been rewound by
+  // flushRecordsBatch().
+  if (status != E::ABORTED &&
+      read_ctx.read_ptr_.lsn > stream_->getReadPtr().lsn) {
     stream_->setReadPtr(read_ctx.read_ptr_.lsn);
   }
 
@@ -1307,7 +1359,19 @@ CatchupOneStream::readNonBlocking(WeakRef<CatchupQueue> /*catchup_queue*/,
                            stream_,
                            ServerReadStream::RecordSource::NON_BLOCKING,
                            read_ctx.catchup_reason_);
+  read_ctx.max_execution_time_ =
+      deps_.getSettings().max_worker_read_execution_time;
   Status status = deps_.read(read_iterator.get(), callback, &read_ctx);
+  // A storage task may continue this read, it shouldn't inherit the limit.
+  read_ctx.max_execution_time_ = std::chrono::milliseconds::max();
+
+  if (status == E::PARTIAL && read_ctx.it_stats_.executionTimeLimitReached()) {
+    // Taking long likely means the read needs more than what's in memory.
+    // Let a storage thread continue from where we stopped rather than
+    // blocking the worker again in the next batch.
+    WORKER_STAT_INCR(non_blocking_reads_time_limit);
+    status = E::WOULDBLOCK;
+  }
 
   stream_ld_debug(*stream_,
                   "got %d records without blocking, status=%s",
@@ -1326,6 +1390,11 @@ CatchupOneStream::readNonBlocking(WeakRef<CatchupQueue> /*catchup_queue*/,
   ld_check(status != E::CBREGISTERED);
   ld_check(status != E::NOBUFS);
 
+  // A storage task may follow, send what we have so far.
+  if (flushRecordsBatch() != 0) {
+    status = E::ABORTED;
+  }
+
   if (status == E::WOULDBLOCK) {
     // E::WOULDBLOCK should not be returned if we already shipped more than the
     // limit.
@@ -1374,6 +1443,11 @@ void CatchupOneStream::readOnStorageThread(
   options.allow_copyset_index = true;
   options.csi_data_only = stream_->csi_data_only_;
   options.inject_latency = inject_latency;
+  // Reads that got here missed the cache and are likely backfilling old
+  // data, so let the store read ahead by up to one batch worth of records.
+  options.readahead_bytes =
+      std::min<size_t>(read_ctx.max_bytes_to_deliver_,
+                       deps_.getSettings().catchup_readahead_max_bytes);
 
   std::weak_ptr<LocalLogStore::ReadIterator> read_iterator;
   if (stream_->iterator_cache_ && stream_->iterator_cache_->valid(options)) {
@@ -1430,6 +1504,7 @@ CatchupOneStream::read(CatchupQueueDependencies& deps,
                                     allow_storage_task,
                                     catchup_reason,
                                     stream->read_shaping_cb_);
+  ld_check(catchup.batched_records_.empty());
   return std::make_pair(action, catchup.record_bytes_queued_);
 }
 
@@ -1440,6 +1515,7 @@ CatchupOneStream::onReadTaskDone(CatchupQueueDependencies& deps,
   auto& resume_cb = task.catchup_queue_.get()->resumeCallback();
   CatchupOneStream catchup(deps, stream, resume_cb);
   Action action = catchup.processTask(task);
+  ld_check(catchup.batched_records_.empty());
   return std::make_pair(action, catchup.record_bytes_queued_);
 }
 
@@ -1632,6 +1708,85 @@ int CatchupOneStream::sendGapFilteredOutIfNeeded(lsn_t trim_point) {
   return 0;
 }
 
+bool CatchupOneStream::canBatchRecord(const RECORD_Message& msg) const {
+  const size_t max_payload = deps_.getSettings().records_batch_max_payload;
+  return max_payload > 0 && msg.payload_.size() <= max_payload &&
+      stream_->proto_ >= Compatibility::RECORDS_BATCH_SUPPORT &&
+      RECORDS_BATCH_Message::canBatch(msg);
+}
+
+int CatchupOneStream::batchRecord(std::unique_ptr<RECORD_Message> msg,
+                                  size_t msg_size) {
+  // The sum of the sizes of individual RECORD messages is an overestimate of
+  // the size of the batch.
+  const int max_records_kb = deps_.getSettings().output_max_records_kb;
+  const size_t max_bytes = max_records_kb > 0
+      ? std::min(size_t(max_records_kb) * 1024, size_t(Message::MAX_LEN))
+      : size_t(Message::MAX_LEN);
+  if (!batched_records_.empty() &&
+      batched_records_bytes_ + msg_size > max_bytes) {
+    if (flushRecordsBatch() != 0) {
+      return -1;
+    }
+  }
+
+  if (batched_records_.empty()) {
+    batch_start_.last_delivered_lsn = stream_->last_delivered_lsn_;
+    batch_start_.last_delivered_record = stream_->last_delivered_record_;
+    batch_start_.read_ptr = stream_->getReadPtr().lsn;
+    batch_start_.filtered_out_end_lsn = stream_->filtered_out_end_lsn_;
+  }
+  batched_records_.push_back(std::move(msg));
+  batched_records_bytes_ += msg_size;
+  return 0;
+}
+
+int CatchupOneStream::flushRecordsBatch() {
+  if (batched_records_.empty()) {
+    return 0;
+  }
+
+  auto records = std::move(batched_records_);
+  batched_records_.clear();
+  const size_t batched_bytes = batched_records_bytes_;
+  batched_records_bytes_ = 0;
+  ld_check(record_bytes_queued_ >= batched_bytes);
+  record_bytes_queued_ -= batched_bytes;
+
+  int rv;
+  size_t msg_size;
+  if (records.size() == 1) {
+    msg_size = batched_bytes;
+    rv = deps_.sender_->sendMessage(
+        std::move(records.front()), stream_->client_id_);
+  } else {
+    auto msg = std::make_unique<RECORDS_BATCH_Message>(
+        std::move(records), stream_->trafficClass());
+    msg_size = msg->size();
+    rv = deps_.sender_->sendMessage(std::move(msg), stream_->client_id_);
+  }
+
+  if (rv != 0) {
+    // Nothing was sent to the client since the first batched record was
+    // shipped, so the stream can go back to where it was at that point.
+    stream_ld_debug(*stream_,
+                    "Failed to send a batch of records, rewinding to %s: %s",
+                    lsn_to_string(batch_start_.read_ptr).c_str(),
+                    error_description(err));
+    STAT_INCR(deps_.getStatsHolder(), records_batch_send_failed);
+    stream_->last_delivered_lsn_ = batch_start_.last_delivered_lsn;
+    stream_->last_delivered_record_ = batch_start_.last_delivered_record;
+    stream_->filtered_out_end_lsn_ = batch_start_.filtered_out_end_lsn;
+    stream_->setReadPtr(batch_start_.read_ptr);
+    return -1;
+  }
+
+  ld_check(record_bytes_queued_ <=
+           std::numeric_limits<size_t>::max() - msg_size);
+  record_bytes_queued_ += msg_size;
+  return 0;
+}
+
 CatchupOneStream::Action CatchupOneStream::processRecords(
     const std::vector<RawRecord>& records,
     server_read_stream_version_t version,
@@ -1664,6 +1819,12 @@ CatchupOneStream::Action CatchupOneStream::handleBatchEnd(
     Status status,
     const LocalLogStoreReader::ReadPointer& read_ptr) {
   ld_check(status != E::CBREGISTERED);
+  if (flushRecordsBatch() != 0) {
+    // The stream was rewound to the first batched record. Try again later.
+    ld_check(err != E::CBREGISTERED);
+    status = E::ABORTED;
+  }
+
   if (status != E::ABORTED && status != E::CBREGISTERED &&
       stream_->getReadPtr().lsn <= read_ptr.lsn) {
     // Update the read pointer here to account for skipped records.
@@ -1791,6 +1952,11 @@ int CatchupOneStream::sendGAP(lsn_t end_lsn,
                               GapReason reason,
                               lsn_t start_lsn) {
   ld_check(stream_);
+  // Records shipped so far must reach the client before the gap.
+  if (flushRecordsBatch() != 0) {
+    return -1;
+  }
+
   if (start_lsn == LSN_INVALID) {
     start_lsn = stream_->need_to_deliver_lsn_zero_
         ? LSN_INVALID
@@ -1866,6 +2032,7 @@ CatchupOneStream::createReadContext(lsn_t last_released_lsn,
     filter->scd_copyset_reordering_ = stream_->scdCopysetReordering();
     stream_->csidHash(filter->csid_hash_pt1, filter->csid_hash_pt2);
     filter->scd_known_down_ = stream_->getKnownDown();
+    filter->scd_preferred_nodes_ = stream_->scd_preferred_nodes_;
 
     if (stream_->localScdEnabled()) {
       auto client_location = std::make_unique<NodeLocation>();
@@ -1955,16 +2122,19 @@ int CatchupOneStream::readLastKnownGood(WeakRef<CatchupQueue> catchup_queue,
         // Cache hit (typical case).
         stream.last_known_good_ =
             compose_lsn(epoch, cache_result.second->getLNG());
+        STAT_INCR(deps_.getStatsHolder(), record_cache_lng_hit);
         return 0;
       case RecordCache::Result::NO_RECORD:
         // Guaranteed no records for desired epoch. Cannot possibly have
         // metadata either.
         stream.last_known_good_ = LSN_INVALID;
+        STAT_INCR(deps_.getStatsHolder(), record_cache_lng_hit);
         return 0;
       case RecordCache::Result::MISS:
         // Cache miss. This can happen if the storage node was restarted,
-        // because the RecordCache is not rebuilt. We have to read the metadata
-        // from the log store.
+        // because the RecordCache is not rebuilt, or if the log was evicted
+        // from the cache. We have to read the metadata from the log store.
+        STAT_INCR(deps_.getStatsHolder(), record_cache_lng_miss);
         break;
     }
   }
@@ -7,10 +7,13 @@
  */
 #pragma once
 
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "logdevice/common/StorageTask-enums.h"
 #include "logdevice/common/WeakRefHolder.h"
+#include "logdevice/common/protocol/RECORD_Message.h"
 #include "logdevice/common/types_internal.h"
 #include "logdevice/include/EnumMap.h"
 #include "logdevice/include/Err.h"
@@ -323,6 +326,35 @@ class CatchupOneStream {
    */
   int sendGapFilteredOutIfNeeded(lsn_t trim_point);
 
+  /**
+   * @return true if the record can be delivered in a RECORDS_BATCH message
+   *         rather than on its own, see --records-batch-max-payload.
+   */
+  bool canBatchRecord(const RECORD_Message& msg) const;
+
+  /**
+   * Called by ReadingCallback instead of sending a RECORD message that
+   * canBatchRecord() allows. Adds the record to batched_records_, first
+   * flushing them if the batch would exceed --output-max-records-kb. Must be
+   * called before the stream's state is updated for the record.
+   *
+   * @return 0 on success, -1 if flushRecordsBatch() failed.
+   */
+  int batchRecord(std::unique_ptr<RECORD_Message> msg, size_t msg_size);
+
+  /**
+   * Sends batched_records_ in a RECORDS_BATCH message (or a RECORD message
+   * if there is only one). Must be called before sending anything else to the
+   * client, so that records and gaps get delivered in order.
+   *
+   * If the message can't be sent, rewinds the stream to the first batched
+   * record so that the records are read and shipped again later.
+   *
+   * @return On success, returns 0. On failure, returns -1 with err set
+   *         according to Sender::sendMessage().
+   */
+  int flushRecordsBatch();
+
   CatchupQueueDependencies& deps_;
   ServerReadStream* stream_{nullptr};
   BWAvailableCallback& resume_cb_;
@@ -330,6 +362,21 @@ class CatchupOneStream {
   // Current amount of bytes we have enqueued in the output evbuffer so far.
   size_t record_bytes_queued_;
 
+  // Records shipped by ReadingCallback that flushRecordsBatch() will send,
+  // and the sum of their sizes, which is already included in
+  // record_bytes_queued_.
+  std::vector<std::unique_ptr<RECORD_Message>> batched_records_;
+  size_t batched_records_bytes_{0};
+
+  // State of stream_ before the first record in batched_records_ was shipped.
+  // Restored if flushRecordsBatch() fails.
+  struct {
+    lsn_t last_delivered_lsn;
+    lsn_t last_delivered_record;
+    lsn_t read_ptr;
+    lsn_t filtered_out_end_lsn;
+  } batch_start_{};
+
   friend class ReadingCallback;
 };
 
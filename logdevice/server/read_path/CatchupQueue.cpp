@@ -13,12 +13,15 @@
 #include "logdevice/common/BackoffTimer.h"
 #include "logdevice/common/ExponentialBackoffTimer.h"
 #include "logdevice/common/LocalLogStoreRecordFormat.h"
+#include "logdevice/common/PrincipalIdentity.h"
+#include "logdevice/common/SecurityInformation.h"
 #include "logdevice/common/ShapingContainer.h"
 #include "logdevice/common/SocketSender.h"
 #include "logdevice/common/Timer.h"
 #include "logdevice/common/configuration/Configuration.h"
 #include "logdevice/common/debug.h"
 #include "logdevice/common/protocol/Message.h"
+#include "logdevice/common/protocol/RECORDS_BATCH_Message.h"
 #include "logdevice/common/protocol/RECORD_Message.h"
 #include "logdevice/common/protocol/STARTED_Message.h"
 #include "logdevice/include/Err.h"
@@ -176,6 +179,9 @@ void CatchupQueue::pushRecords(CatchupEventTrigger catchup_reason) {
   processDelayedQueue();
 
   if (queue_.empty()) {
+    // No backlog, so the client no longer competes for DRR turns.
+    drr_backlogged_ = false;
+
     // use ping timer to make sure that we eventually process read streams in
     // queue_delayed_
     adjustPingTimer();
@@ -184,6 +190,25 @@ void CatchupQueue::pushRecords(CatchupEventTrigger catchup_reason) {
     return;
   }
 
+  if (drr_waiting_) {
+    catchup_queue_ld_debug("Waiting for a deficit round robin turn");
+    return;
+  }
+
+  // If reading is shared between clients with deficit round robin, a client
+  // that just became backlogged starts with a full quantum. Otherwise it
+  // keeps reading until it used up the deficit of its current turn.
+  const size_t drr_quantum = deps_->getDRRQuantumBytes(client_id_);
+  if (drr_quantum == 0) {
+    drr_backlogged_ = false;
+  } else if (!drr_backlogged_) {
+    drr_backlogged_ = true;
+    drr_deficit_ = drr_quantum;
+  } else if (waitForDRRTurnIfNeeded(drr_quantum)) {
+    adjustPingTimer();
+    return;
+  }
+
   size_t max_record_bytes_queued = deps_->getMaxRecordBytesQueued(client_id_);
 
   // We limit the number of iterations in that loop in order to yield in the
@@ -196,7 +221,8 @@ void CatchupQueue::pushRecords(CatchupEventTrigger catchup_reason) {
   auto next_from_queue = queue_.begin();
   size_t storage_task_count = 0;
   for (size_t i = 0; i < max_iterations && next_from_queue != queue_.end() &&
-       record_bytes_queued_ < max_record_bytes_queued;
+       record_bytes_queued_ < max_record_bytes_queued &&
+       (drr_quantum == 0 || drr_deficit_ > 0);
        ++i) {
     auto stream = next_from_queue;
     ++next_from_queue;
@@ -261,6 +287,7 @@ void CatchupQueue::pushRecords(CatchupEventTrigger catchup_reason) {
                                !storage_task_in_flight_,
                                catchup_reason);
     record_bytes_queued_ += n_bytes_queued;
+    chargeDRR(n_bytes_queued);
 
     // Note: storage_task_in_flight_ is NOT updated in the above call to
     // CatchupOneStream::read(), but stream->storage_task_in_flight_ is.  Also,
@@ -360,6 +387,8 @@ void CatchupQueue::pushRecords(CatchupEventTrigger catchup_reason) {
     ld_check_le(storage_task_count, 1);
   }
 
+  waitForDRRTurnIfNeeded(drr_quantum);
+
   // Depending on the outcome of the above loop, under certain error
   // conditions we need to schedule a timer to try again later.  Or if we
   // recovered from such an error condition, now is the time to cancel the
@@ -416,23 +445,42 @@ int CatchupQueue::notifyShardError(ServerReadStream* stream) {
 void CatchupQueue::onRecordSent(const RECORD_Message& msg,
                                 ServerReadStream* stream,
                                 const SteadyTimestamp enqueue_time) {
-  const auto msg_size = msg.size();
-  ld_check(record_bytes_queued_ >= msg_size);
-  record_bytes_queued_ -= msg_size;
-  ld_spew("record drained, record_bytes_queued_ = %zu", record_bytes_queued_);
-
   // Try to make progress on the queue after validations are completed.
   // We do this after all validations because pushRecords() can destroy
   // the stream.
   SCOPE_EXIT {
-    if (record_bytes_queued_ == 0) {
-      catchup_queue_ld_debug("Output evbuffer drained");
-      // Only trigger more work when we have flushed all RECORD messages out of
-      // the output evbuffer
-      pushRecords();
-    }
+    onRecordBytesDrained(msg.size());
   };
+  checkRecordSent(msg, stream, enqueue_time);
+}
 
+void CatchupQueue::onRecordsBatchSent(const RECORDS_BATCH_Message& msg,
+                                      ServerReadStream* stream,
+                                      const SteadyTimestamp enqueue_time) {
+  SCOPE_EXIT {
+    onRecordBytesDrained(msg.size());
+  };
+  for (const auto& record : msg.records_) {
+    checkRecordSent(*record, stream, enqueue_time);
+  }
+}
+
+void CatchupQueue::onRecordBytesDrained(size_t msg_size) {
+  ld_check(record_bytes_queued_ >= msg_size);
+  record_bytes_queued_ -= msg_size;
+  ld_spew("record drained, record_bytes_queued_ = %zu", record_bytes_queued_);
+
+  if (record_bytes_queued_ == 0) {
+    catchup_queue_ld_debug("Output evbuffer drained");
+    // Only trigger more work when we have flushed all RECORD messages out of
+    // the output evbuffer
+    pushRecords();
+  }
+}
+
+void CatchupQueue::checkRecordSent(const RECORD_Message& msg,
+                                   ServerReadStream* stream,
+                                   const SteadyTimestamp enqueue_time) {
   if (stream == nullptr) {
     // Stream has been reaped. Nothing to validate.
     return;
@@ -638,6 +686,26 @@ void CatchupQueueDependencies::eraseStream(ClientID client_id,
   all_server_read_streams_->erase(client_id, log_id, read_stream_id, shard);
 }
 
+// Returns the entry of the principals config for the client, or nullptr if
+// there is none.
+static std::shared_ptr<const Principal> findClientPrincipal(Worker* w,
+                                                            ClientID client) {
+  const PrincipalIdentity* identity = w->sender().getPrincipal(Address(client));
+  // identity could be nullptr if the connection was closed
+  if (identity) {
+    auto scfg = w->getServerConfig();
+    // Same as for max_read_traffic_class, the first identity that has an
+    // entry in the principals config decides.
+    for (const auto& id : identity->identities) {
+      auto principal = scfg->getPrincipalByName(&id.second);
+      if (principal != nullptr) {
+        return principal;
+      }
+    }
+  }
+  return nullptr;
+}
+
 bool CatchupQueueDependencies::canIssueReadIO(
     ReadIoShapingCallback& on_bw_avail,
     ServerReadStream* stream) {
@@ -656,12 +724,43 @@ bool CatchupQueueDependencies::canIssueReadIO(
     return true;
   }
 
-  // Lock to prevent race between registering for bandwidth and
-  // a bandwidth deposit from the TrafficShaper.
   ShapingContainer& read_container = w->readShapingContainer();
   auto& flow_group = read_container.getFlowGroup(NodeLocationScope::NODE);
 
   STAT_INCR(getStatsHolder(), read_throttling_num_throttle_checks);
+  if (Worker::settings().read_throttling_share_by_principal) {
+    ReadIoPrincipalScheduler::PrincipalInfo principal_info{"default"};
+    auto principal = findClientPrincipal(w, stream->client_id_);
+    if (principal) {
+      principal_info.name = principal->name;
+      principal_info.weight = principal->read_share;
+      principal_info.min_bytes_per_sec = principal->min_read_bytes_per_sec;
+    }
+    bool admitted = all_server_read_streams_->readIoPrincipalScheduler().admit(
+        *stream,
+        principal_info,
+        w->processor_->getWorkerCount(WorkerType::GENERAL),
+        on_bw_avail.cost(),
+        flow_group,
+        read_container.flow_meters_mutex_);
+    if (admitted) {
+      STAT_INCR(getStatsHolder(), read_throttling_num_reads_allowed);
+    } else {
+      STAT_INCR(getStatsHolder(), read_throttling_num_reads_throttled);
+      ld_spew("Throttled: log:%lu, principal:%s",
+              logid.val_,
+              principal_info.name.c_str());
+    }
+    return admitted;
+  }
+
+  if (flow_group.drain(on_bw_avail.cost(), rp)) {
+    STAT_INCR(getStatsHolder(), read_throttling_num_reads_allowed);
+    return true;
+  }
+
+  // Lock to prevent race between registering for bandwidth and
+  // a bandwidth deposit from the TrafficShaper.
   std::unique_lock<std::mutex> lock(read_container.flow_meters_mutex_);
   if (!flow_group.drain(on_bw_avail.cost(), rp)) {
     flow_group.push(on_bw_avail, rp);
@@ -779,6 +878,20 @@ const Settings& CatchupQueueDependencies::getSettings() const {
   return Worker::settings();
 }
 
+size_t CatchupQueueDependencies::getDRRQuantumBytes(ClientID client) {
+  const size_t quantum = Worker::settings().catchup_queue_drr_quantum_bytes;
+  if (quantum == 0) {
+    return 0;
+  }
+
+  auto principal = findClientPrincipal(Worker::onThisThread(), client);
+  return principal ? quantum * principal->read_share : quantum;
+}
+
+void CatchupQueueDependencies::waitForDRRTurn(ClientID client) {
+  all_server_read_streams_->waitForDRRTurn(client);
+}
+
 void CatchupQueue::readThrottlingOnReadTaskDone(const ReadStorageTask& task) {
   // Reconcile our cost estimate with the actual cost of performing this I/O
   size_t cost_estimate = task.getThrottlingEstimate();
@@ -827,9 +940,7 @@ void CatchupQueue::readThrottlingOnReadTaskDone(const ReadStorageTask& task) {
              overflow_credits);
   } else if (cost_estimate < task.total_bytes_) {
     // more credits were used than initially requested, debit the excess
-    auto lock = read_container.lock();
     fg.debitMeter(p, task.total_bytes_ - cost_estimate);
-    lock.unlock();
     STAT_ADD(deps_->getStatsHolder(),
              read_throttling_excess_bytes_read_from_rocksdb,
              task.total_bytes_ - cost_estimate);
@@ -879,6 +990,7 @@ void CatchupQueue::onReadTaskDone(const ReadStorageTask& task) {
   std::tie(act, n_bytes_queued) =
       CatchupOneStream::onReadTaskDone(*deps_, stream, task);
   record_bytes_queued_ += n_bytes_queued;
+  chargeDRR(n_bytes_queued);
 
   onBatchComplete(stream);
 
@@ -957,7 +1069,7 @@ void CatchupQueue::adjustPingTimer() {
   // there is still work to do, then we need to activate the timer to retry
   // later.
   if (record_bytes_queued_ == 0 && !resume_cb_.active() &&
-      !storage_task_in_flight_ &&
+      !storage_task_in_flight_ && !drr_waiting_ &&
       (!queue_.empty() || !queue_delayed_.empty())) {
     STAT_INCR(deps_->getStatsHolder(), read_streams_transient_errors);
     catchup_queue_ld_debug("Activate ping timer with timeout=%lu",
@@ -969,6 +1081,40 @@ void CatchupQueue::adjustPingTimer() {
   }
 }
 
+void CatchupQueue::chargeDRR(size_t n_bytes) {
+  if (drr_backlogged_) {
+    drr_deficit_ -= static_cast<int64_t>(n_bytes);
+  }
+}
+
+bool CatchupQueue::waitForDRRTurnIfNeeded(size_t drr_quantum) {
+  if (drr_waiting_) {
+    return true;
+  }
+  if (drr_quantum == 0 || drr_deficit_ > 0 || queue_.empty()) {
+    return false;
+  }
+  catchup_queue_ld_debug("Used up the deficit round robin quantum");
+  STAT_INCR(deps_->getStatsHolder(), catchup_queue_drr_waits);
+  drr_waiting_ = true;
+  deps_->waitForDRRTurn(client_id_);
+  return true;
+}
+
+void CatchupQueue::onDRRTurn() {
+  if (!drr_waiting_) {
+    // The client reconnected with the same ClientID after asking for a turn.
+    return;
+  }
+  drr_waiting_ = false;
+  if (drr_backlogged_) {
+    // Like in DRRScheduler, a turn adds a quantum to what's left of the
+    // deficit, so a batch that overshot the last turn is paid back.
+    drr_deficit_ += deps_->getDRRQuantumBytes(client_id_);
+  }
+  pushRecords();
+}
+
 void CatchupQueue::onReadLngTaskDone(ServerReadStream* stream) {
   catchup_queue_ld_debug("ReadLngTask done");
   onStorageTaskStopped(stream);
@@ -52,6 +52,7 @@ class LogStorageStateMap;
 class ReadIoShapingCallback;
 class ReadStorageTask;
 class RECORD_Message;
+class RECORDS_BATCH_Message;
 class SenderBase;
 class SenderProxy;
 class ServerReadStream;
@@ -159,10 +160,24 @@ class CatchupQueueDependencies {
   /**
    * Checks with underlying FlowGroup's(corresponding to stream's priority)
    * FlowMeter if sufficient bandwidth exists to allow a read storage task.
+   * With Settings::read_throttling_share_by_principal, asks the worker's
+   * ReadIoPrincipalScheduler instead.
    */
   virtual bool canIssueReadIO(ReadIoShapingCallback& on_bw_avail,
                               ServerReadStream* stream);
 
+  /**
+   * Returns how many record bytes the client may queue per deficit round
+   * robin turn: Settings::catchup_queue_drr_quantum_bytes times the
+   * read_share of the client's principal. 0 if DRR is disabled.
+   */
+  virtual size_t getDRRQuantumBytes(ClientID client);
+
+  /**
+   * Proxy for AllServerReadStreams::waitForDRRTurn().
+   */
+  virtual void waitForDRRTurn(ClientID client);
+
   virtual ~CatchupQueueDependencies();
 
  public:
@@ -234,6 +249,13 @@ class CatchupQueue {
                     ServerReadStream*,
                     const SteadyTimestamp enqueue_time);
 
+  /**
+   * Same as onRecordSent() for a RECORDS_BATCH message.
+   */
+  void onRecordsBatchSent(const RECORDS_BATCH_Message& msg,
+                          ServerReadStream*,
+                          const SteadyTimestamp enqueue_time);
+
   /**
    * Called when a gap message is drained from the output evbuffer and
    * sent over the network.
@@ -273,6 +295,13 @@ class CatchupQueue {
    */
   void add(ServerReadStream& stream, PushMode mode = PushMode::IMMEDIATE);
 
+  /**
+   * Called by AllServerReadStreams when this queue gets its next deficit
+   * round robin turn after waitForDRRTurn(). Adds a quantum to the deficit and
+   * resumes reading.
+   */
+  void onDRRTurn();
+
   void getDebugInfo(InfoCatchupQueuesTable& table);
 
   void blockUnBlock(bool block);
@@ -321,6 +350,34 @@ class CatchupQueue {
   // network.
   size_t record_bytes_queued_ = 0;
 
+  // Deficit round robin state, used if getDRRQuantumBytes() is positive.
+  // drr_deficit_ is how many more record bytes we may queue in this turn; it
+  // goes negative if the last batch overshot it. Once it is used up, we
+  // wait for AllServerReadStreams to call onDRRTurn() (drr_waiting_ is true
+  // meanwhile). A client that stops being backlogged (queue_ empties) forgets
+  // its deficit and starts with a fresh quantum the next time.
+  int64_t drr_deficit_ = 0;
+  bool drr_backlogged_ = false;
+  bool drr_waiting_ = false;
+
+  // Charges `n_bytes` queued records against drr_deficit_.
+  void chargeDRR(size_t n_bytes);
+
+  // Asks AllServerReadStreams for the next turn if this turn's deficit is used
+  // up while streams are still waiting to be read. Returns true if we are
+  // waiting for a turn.
+  bool waitForDRRTurnIfNeeded(size_t drr_quantum);
+
+  // Called when `msg_size` bytes of record messages were drained from the
+  // output evbuffer.
+  void onRecordBytesDrained(size_t msg_size);
+
+  // Checks that a record a client was sent doesn't violate the stream's
+  // delivery order and updates ServerReadStream::sent_state.
+  void checkRecordSent(const RECORD_Message& msg,
+                       ServerReadStream* stream,
+                       const SteadyTimestamp enqueue_time);
+
   // Is there a storage task in flight for this catchup queue?  We only allow
   // one at a time.
   bool storage_task_in_flight_ = false;
@@ -15,6 +15,13 @@
 
 namespace facebook { namespace logdevice {
 
+IteratorCache::~IteratorCache() {
+  // If the LRU was destroyed first, clearing its list unlinked us.
+  if (lru_hook_.is_linked()) {
+    lru_->remove(*this);
+  }
+}
+
 std::shared_ptr<LocalLogStore::ReadIterator>
 IteratorCache::createOrGet(const LocalLogStore::ReadOptions& options) {
   auto& wrapper = getWrapper(options);
@@ -25,7 +32,10 @@ IteratorCache::createOrGet(const LocalLogStore::ReadOptions& options) {
   }
   wrapper.last_used = std::chrono::steady_clock::now();
 
-  return wrapper.iterator;
+  // Copy before updateLRU(), which may release iterators of other caches.
+  auto iterator = wrapper.iterator;
+  updateLRU();
+  return iterator;
 }
 
 bool IteratorCache::valid(const LocalLogStore::ReadOptions& options) {
@@ -37,6 +47,7 @@ void IteratorCache::set(const LocalLogStore::ReadOptions& options,
   auto& wrapper = getWrapper(options);
   wrapper.iterator = iter;
   wrapper.last_used = std::chrono::steady_clock::now();
+  updateLRU();
 }
 
 void IteratorCache::invalidateIfUnused(
@@ -48,6 +59,53 @@ void IteratorCache::invalidateIfUnused(
       WORKER_STAT_INCR(iterator_invalidations);
     }
   }
+  if (lru_hook_.is_linked() && !blocking_.iterator && !nonblocking_.iterator) {
+    lru_->remove(*this);
+  }
+}
+
+void IteratorCache::invalidate() {
+  blocking_.iterator.reset();
+  nonblocking_.iterator.reset();
+  if (lru_hook_.is_linked()) {
+    lru_->remove(*this);
+  }
+}
+
+void IteratorCache::updateLRU() {
+  if (!lru_) {
+    return;
+  }
+  if (blocking_.iterator || nonblocking_.iterator) {
+    lru_->touch(*this);
+  } else if (lru_hook_.is_linked()) {
+    lru_->remove(*this);
+  }
+}
+
+void IteratorCacheLRU::touch(IteratorCache& cache) {
+  if (cache.lru_hook_.is_linked()) {
+    list_.erase(list_.iterator_to(cache));
+  } else {
+    ++size_;
+  }
+  list_.push_back(cache);
+
+  const size_t max_caches = settings_->iterator_cache_max_streams;
+  while (max_caches > 0 && size_ > max_caches) {
+    // `cache` is at the back and max_caches >= 1, so it's never evicted here.
+    IteratorCache& lru = list_.front();
+    ld_check(&lru != &cache);
+    lru.invalidate();
+    WORKER_STAT_INCR(iterator_cache_lru_evictions);
+  }
+}
+
+void IteratorCacheLRU::remove(IteratorCache& cache) {
+  ld_check(cache.lru_hook_.is_linked());
+  ld_check(size_ > 0);
+  list_.erase(list_.iterator_to(cache));
+  --size_;
 }
 
 }} // namespace facebook::logdevice
@@ -12,6 +12,10 @@
 #include <memory>
 #include <mutex>
 
+#include <folly/IntrusiveList.h>
+
+#include "logdevice/common/settings/Settings.h"
+#include "logdevice/common/settings/UpdateableSettings.h"
 #include "logdevice/server/locallogstore/LocalLogStore.h"
 
 namespace facebook { namespace logdevice {
@@ -22,15 +26,26 @@ namespace facebook { namespace logdevice {
  *        requested; future calls to getIterator() will return the cached value.
  */
 
+class IteratorCacheLRU;
+
 class IteratorCache {
  public:
+  /**
+   * @param lru  If not nullptr, the cache registers with it while it holds
+   *             iterators, and may be asked to release them if too many
+   *             caches hold iterators. Must outlive the cache.
+   */
   explicit IteratorCache(LocalLogStore* store,
                          logid_t log_id,
-                         bool created_by_rebuilding)
+                         bool created_by_rebuilding,
+                         IteratorCacheLRU* lru = nullptr)
       : store_(store),
         log_id_(log_id),
+        lru_(lru),
         created_by_rebuilding_(created_by_rebuilding) {}
 
+  ~IteratorCache();
+
   /**
    * Creates a new one or returns an existing (cached) read iterator
    * corresponding to the specified ReadOptions.
@@ -66,6 +81,12 @@ class IteratorCache {
   void invalidateIfUnused(std::chrono::steady_clock::time_point now,
                           std::chrono::milliseconds ttl);
 
+  /**
+   * Releases all cached iterators. Storage tasks that already took one keep
+   * it until they complete.
+   */
+  void invalidate();
+
   /**
    * Get direct access to underlying store.
    */
@@ -93,15 +114,71 @@ class IteratorCache {
     return options.allow_blocking_io ? blocking_ : nonblocking_;
   }
 
+  // Moves this cache to the most recently used end of lru_, or removes it
+  // from lru_ if it no longer holds any iterators.
+  void updateLRU();
+
   LocalLogStore* store_;
   logid_t log_id_;
 
   IterWrapper blocking_;
   IterWrapper nonblocking_;
 
+  IteratorCacheLRU* lru_;
+
+  // Links this cache in lru_ while it holds iterators.
+  folly::IntrusiveListHook lru_hook_;
+
+  friend class IteratorCacheLRU;
+
  public:
   // Context for tracking iterators
   bool created_by_rebuilding_;
 };
 
+/**
+ * Bounds how many IteratorCaches of a worker hold iterators at a time.
+ *
+ * Every cached iterator pins memtables and SST files of its log store, so
+ * thousands of idle-but-connected readers can pin a lot of memory and hold
+ * back compactions until iterator-cache-ttl expires. IteratorCaches that hold
+ * iterators are kept in LRU order; once there are more than
+ * Settings::iterator_cache_max_streams of them, the least recently used ones
+ * release their iterators. A ReadStorageTask locks the cached iterator when it
+ * starts, so an iterator is only ever released between tasks, and the next
+ * task of that stream creates a new one.
+ *
+ * Not thread-safe; each worker has its own instance.
+ */
+class IteratorCacheLRU {
+ public:
+  explicit IteratorCacheLRU(UpdateableSettings<Settings> settings)
+      : settings_(std::move(settings)) {}
+
+  /**
+   * Marks `cache` as most recently used, then releases the iterators of the
+   * least recently used caches if there are too many.
+   */
+  void touch(IteratorCache& cache);
+
+  /**
+   * Forgets `cache`, which no longer holds iterators.
+   */
+  void remove(IteratorCache& cache);
+
+  /**
+   * @return number of caches that currently hold iterators.
+   */
+  size_t size() const {
+    return size_;
+  }
+
+ private:
+  UpdateableSettings<Settings> settings_;
+
+  // From least to most recently used.
+  folly::IntrusiveList<IteratorCache, &IteratorCache::lru_hook_> list_;
+  size_t size_ = 0;
+};
+
 }} // namespace facebook::logdevice
@@ -73,9 +73,8 @@ Status readImpl(LocalLogStore::ReadIterator& read_iterator,
       std::min(std::min(read_ctx->until_lsn_, read_ctx->last_released_lsn_),
                read_ctx->window_high_);
   read_ctx->it_stats_.stop_reading_after_timestamp = read_ctx->ts_window_high_;
-  read_ctx->it_stats_.max_execution_time =
-      std::min(settings.max_record_read_execution_time,
-               std::chrono::milliseconds::max());
+  read_ctx->it_stats_.max_execution_time = std::min(
+      settings.max_record_read_execution_time, read_ctx->max_execution_time_);
   // set the read_start_time
   read_ctx->it_stats_.read_start_time = std::chrono::steady_clock::now();
 
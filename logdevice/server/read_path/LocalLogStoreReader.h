@@ -12,6 +12,7 @@
 #include <cstdlib>
 
 #include <boost/noncopyable.hpp>
+#include <folly/io/IOBuf.h>
 
 #include "logdevice/common/CopySet.h"
 #include "logdevice/common/LocalLogStoreRecordFormat.h"
@@ -55,6 +56,20 @@ class RawRecord : boost::noncopyable {
         owned(owned),
         from_under_replicated_region(from_under_replicated_region) {}
 
+  // The blob is the contents of `buffer`, which the record takes ownership of.
+  // Parts of the blob (e.g. the payload) can then be handed to outgoing
+  // messages by cloning `buffer` rather than copying the data.
+  RawRecord(lsn_t lsn,
+            folly::IOBuf buffer,
+            bool from_under_replicated_region = false)
+      : lsn(lsn),
+        blob(buffer.data(), buffer.length()),
+        owned(false),
+        from_under_replicated_region(from_under_replicated_region),
+        buffer(std::move(buffer)) {
+    ld_check(!this->buffer.isChained());
+  }
+
   ~RawRecord() {
     if (owned) {
       std::free(const_cast<void*>(blob.data));
@@ -65,7 +80,8 @@ class RawRecord : boost::noncopyable {
       : lsn(other.lsn),
         blob(other.blob),
         owned(other.owned),
-        from_under_replicated_region(other.from_under_replicated_region) {
+        from_under_replicated_region(other.from_under_replicated_region),
+        buffer(std::move(other.buffer)) {
     other.lsn = LSN_INVALID;
     other.blob = Slice();
     other.owned = false;
@@ -76,6 +92,8 @@ class RawRecord : boost::noncopyable {
   Slice blob;
   bool owned;
   bool from_under_replicated_region;
+  // If not empty, owns the memory `blob` points to.
+  folly::IOBuf buffer;
 };
 
 namespace LocalLogStoreReader {
@@ -139,6 +157,11 @@ struct ReadContext {
   std::shared_ptr<LocalLogStore::ReadFilter> lls_filter_;
   // A reason of the current catchup
   CatchupEventTrigger catchup_reason_;
+  // Time a single read() may take, on top of
+  // --max-record-read-execution-time. Tightened for reads done on worker
+  // threads.
+  std::chrono::milliseconds max_execution_time_{
+      std::chrono::milliseconds::max()};
   // Iterator statistics. Reset by LocalLogStoreReader::read().
   // It duplicates some of the stopping conditions, e.g.
   // the lsn in it_stats_.stop_reading_after is usually set to
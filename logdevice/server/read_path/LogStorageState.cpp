@@ -135,11 +135,32 @@ void LogStorageState::updateLastCleanEpoch(epoch_t epoch) {
   atomic_fetch_max(last_clean_epoch_, epoch.val_);
 }
 
+bool LogStorageState::shouldWriteFindTimeIndexEntry(
+    std::chrono::milliseconds timestamp,
+    std::chrono::milliseconds interval) {
+  auto last = last_find_time_index_timestamp_.load();
+  while (true) {
+    if (timestamp < last) {
+      // Out of order record. Index it but don't move the sampling point, so
+      // that records arriving in order keep being sampled at `interval`.
+      return true;
+    }
+    if (last != std::chrono::milliseconds::min() &&
+        timestamp - last < interval) {
+      return false;
+    }
+    if (last_find_time_index_timestamp_.compare_exchange_weak(
+            last, timestamp)) {
+      return true;
+    }
+  }
+}
+
 void LogStorageState::updateEpochOffsetMap(
     std::pair<epoch_t, OffsetMap> epoch_offsets) {
   RWLock::WriteHolder write_guard(rw_lock_);
   if (latest_epoch_offsets_.has_value() &&
-      latest_epoch_offsets_.value().first < epoch_offsets.first) {
+      epoch_offsets.first < latest_epoch_offsets_.value().first) {
     // No updates needed for older epoch.
     return;
   }
@@ -235,6 +235,17 @@ class LogStorageState {
 
   void updateLastCleanEpoch(epoch_t epoch);
 
+  /**
+   * Decides whether a record with the given timestamp should get an entry in
+   * the findTime index, if the index is sparse with the given interval
+   * (see Settings::write_find_time_index_interval). Returns true if at least
+   * `interval` passed since the timestamp of the last record for which this
+   * method returned true, or if `timestamp` is lower than that (e.g. the
+   * record was rebuilt or the sequencer's clock went back).
+   */
+  bool shouldWriteFindTimeIndexEntry(std::chrono::milliseconds timestamp,
+                                     std::chrono::milliseconds interval);
+
   void updateEpochOffsetMap(std::pair<epoch_t, OffsetMap>);
 
   /**
@@ -255,6 +266,27 @@ class LogStorageState {
     subscribed_workers_.reset(id.val_);
   }
 
+  /**
+   * Marks a ReleaseRequest for this log as queued on worker `id`.
+   *
+   * @return true if none was queued yet and the caller should post one.
+   *         false if one is already queued; it hasn't run yet and will pick
+   *         up the latest last released LSN when it does.
+   */
+  bool markReleasePending(worker_id_t id) {
+    ld_check(id.val_ >= 0);
+    return !release_pending_workers_.set(id.val_);
+  }
+
+  /**
+   * Called by the queued ReleaseRequest right before it reads the last
+   * released LSN, and when posting it failed.
+   */
+  void clearReleasePending(worker_id_t id) {
+    ld_check(id.val_ >= 0);
+    release_pending_workers_.reset(id.val_);
+  }
+
   /**
    * Implementation of LogStorageStateMap::recoverLogState().
    */
@@ -392,10 +424,20 @@ class LogStorageState {
   // notified, for example, when a new record is released for delivery.
   folly::ConcurrentBitSet<MAX_WORKERS> subscribed_workers_;
 
+  // Workers that have a non-forced ReleaseRequest for this log queued. Further
+  // releases don't post another one until it runs, so a busy log costs each
+  // worker at most one queued request at a time.
+  folly::ConcurrentBitSet<MAX_WORKERS> release_pending_workers_;
+
   // Latest time (number of microseconds since steady_clock's epoch) when
   // some storage node tried to recover the state.
   std::atomic<std::chrono::microseconds> last_recovery_time_{};
 
+  // Timestamp of the last record that got an entry in the findTime index,
+  // if the index is sparse. @see shouldWriteFindTimeIndexEntry().
+  std::atomic<std::chrono::milliseconds> last_find_time_index_timestamp_{
+      std::chrono::milliseconds::min()};
+
   // A grace period for delaying the deletion of data for this log.
   // This is useful in cases, when the log is accidentally removed
   // from logs config.
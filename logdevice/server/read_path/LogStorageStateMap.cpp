@@ -19,48 +19,103 @@
 
 namespace facebook { namespace logdevice {
 
-LogStorageState* LogStorageStateMap::insertOrGet(logid_t log_id,
-                                                 shard_index_t shard_idx) {
-  Map& map = *shard_map_[shard_idx];
+LogStorageStateMap::ShardMap::ShardMap()
+    : chunks_(new std::atomic<Chunk*>[NUM_CHUNKS]()) {}
+
+LogStorageStateMap::ShardMap::~ShardMap() {
+  clear();
+}
+
+LogStorageState* LogStorageStateMap::ShardMap::find(logid_t log_id) const {
+  if (log_id.val_ >= DENSE_LOG_ID_LIMIT) {
+    auto it = outliers_.find(log_id.val_);
+    return it != outliers_.cend() ? it->second.get() : nullptr;
+  }
+  const Chunk* chunk =
+      chunks_[log_id.val_ >> CHUNK_BITS].load(std::memory_order_acquire);
+  if (chunk == nullptr) {
+    return nullptr;
+  }
+  return (*chunk)[log_id.val_ & (CHUNK_SIZE - 1)].load(
+      std::memory_order_acquire);
+}
 
-  // First try a lookup to avoid memory allocation in the common case
-  auto it = map.find(log_id.val_);
-  if (it != map.cend()) {
-    return it->second.get();
+LogStorageState* LogStorageStateMap::ShardMap::insertOrGet(
+    logid_t log_id,
+    folly::FunctionRef<std::unique_ptr<LogStorageState>()> make) {
+  if (log_id.val_ >= DENSE_LOG_ID_LIMIT) {
+    // First try a lookup to avoid memory allocation in the common case
+    auto it = outliers_.find(log_id.val_);
+    if (it != outliers_.cend()) {
+      return it->second.get();
+    }
+    // Whether or not we were the ones to insert or some other thread beat us
+    // to it, return a pointer to whatever ended up in the map.
+    return outliers_.emplace(log_id.val_, make()).first->second.get();
   }
 
-  // No state for this log yet.
-  auto insert_result =
-      map.emplace(log_id.val(),
-                  std::make_unique<LogStorageState>(
-                      log_id, shard_idx, this, cache_disposal_.get()));
+  std::atomic<Chunk*>& chunk_ptr = chunks_[log_id.val_ >> CHUNK_BITS];
+  Chunk* chunk = chunk_ptr.load(std::memory_order_acquire);
+  if (chunk == nullptr) {
+    auto new_chunk = std::make_unique<Chunk>();
+    if (chunk_ptr.compare_exchange_strong(
+            chunk, new_chunk.get(), std::memory_order_acq_rel)) {
+      chunk = new_chunk.release();
+    }
+    // Otherwise `chunk` is now the one another thread inserted.
+  }
 
-  // Whether or not we were the ones to insert or some other thread beat us
-  // to it, return a pointer to whatever ended up in the map.
-  return insert_result.first->second.get();
+  std::atomic<LogStorageState*>& slot =
+      (*chunk)[log_id.val_ & (CHUNK_SIZE - 1)];
+  LogStorageState* state = slot.load(std::memory_order_acquire);
+  if (state == nullptr) {
+    std::unique_ptr<LogStorageState> new_state = make();
+    if (slot.compare_exchange_strong(
+            state, new_state.get(), std::memory_order_acq_rel)) {
+      state = new_state.release();
+    }
+  }
+  return state;
+}
+
+void LogStorageStateMap::ShardMap::clear() {
+  for (size_t i = 0; i < NUM_CHUNKS; ++i) {
+    std::unique_ptr<Chunk> chunk(chunks_[i].exchange(nullptr));
+    if (chunk == nullptr) {
+      continue;
+    }
+    for (auto& slot : *chunk) {
+      delete slot.exchange(nullptr);
+    }
+  }
+  outliers_.clear();
+}
+
+LogStorageState* LogStorageStateMap::insertOrGet(logid_t log_id,
+                                                 shard_index_t shard_idx) {
+  ld_check(shard_idx < shard_map_.size());
+  return shard_map_[shard_idx]->insertOrGet(log_id, [&] {
+    return std::make_unique<LogStorageState>(
+        log_id, shard_idx, this, cache_disposal_.get());
+  });
 }
 
 LogStorageState* LogStorageStateMap::find(logid_t log_id,
                                           shard_index_t shard_idx) {
   ld_check(shard_idx < shard_map_.size());
-  Map& map = *shard_map_[shard_idx];
-  auto it = map.find(log_id.val_);
-  return it != map.cend() ? it->second.get() : nullptr;
+  return shard_map_[shard_idx]->find(log_id);
 }
 
 LogStorageState& LogStorageStateMap::get(logid_t log_id,
                                          shard_index_t shard_idx) {
-  ld_check(shard_idx < shard_map_.size());
-  Map& map = *shard_map_[shard_idx];
-  auto it = map.find(log_id.val_);
-  ld_check(it != map.cend());
-  return *(it->second);
+  LogStorageState* state = find(log_id, shard_idx);
+  ld_check(state != nullptr);
+  return *state;
 }
 
 void LogStorageStateMap::clear() {
   for (shard_index_t s = 0; s < num_shards_; ++s) {
-    Map& map = *shard_map_[s];
-    map.clear();
+    shard_map_[s]->clear();
   }
 }
 
@@ -91,13 +146,11 @@ LogStorageStateMap::ReleaseStates
 LogStorageStateMap::getAllLastReleasedLSNs(shard_index_t shard) const {
   ReleaseStates states;
 
-  for (auto entry = shard_map_[shard]->cbegin();
-       entry != shard_map_[shard]->cend();
-       ++entry) {
-    LogStorageState::LastReleasedLSN last_released =
-        entry->second->getLastReleasedLSN();
-    states.emplace_back(logid_t(entry->first), last_released.value());
-  }
+  forEachLogOnShard(
+      shard, [&](logid_t log_id, const LogStorageState& log_state) {
+        states.emplace_back(log_id, log_state.getLastReleasedLSN().value());
+        return 0;
+      });
 
   return states;
 }
@@ -119,14 +172,12 @@ void LogStorageStateMap::shutdownRecordCaches() {
   if (cache_disposal_ == nullptr) {
     return;
   }
-  for (shard_index_t i = 0; i < num_shards_; ++i) {
-    for (auto entry = shard_map_[i]->cbegin(); entry != shard_map_[i]->cend();
-         ++entry) {
-      if (entry->second->record_cache_ != nullptr) {
-        entry->second->record_cache_->shutdown();
-      }
+  forEachLog([](logid_t, const LogStorageState& log_state) {
+    if (log_state.record_cache_ != nullptr) {
+      log_state.record_cache_->shutdown();
     }
-  }
+    return 0;
+  });
 }
 
 void LogStorageStateMap::shutdownRecordCacheMonitor() {
@@ -157,12 +208,12 @@ StatsHolder* LogStorageStateMap::getStats() {
   return stats_;
 }
 
-std::vector<std::unique_ptr<LogStorageStateMap::Map>>
+std::vector<std::unique_ptr<LogStorageStateMap::ShardMap>>
 LogStorageStateMap::makeMap(shard_size_t num_shards) {
-  std::vector<std::unique_ptr<Map>> ret;
+  std::vector<std::unique_ptr<ShardMap>> ret;
 
   for (shard_index_t s = 0; s < num_shards; ++s) {
-    ret.push_back(std::make_unique<Map>());
+    ret.push_back(std::make_unique<ShardMap>());
   }
 
   return ret;
@@ -7,11 +7,13 @@
  */
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <functional>
 #include <memory>
 #include <vector>
 
+#include <folly/Function.h>
 #include <folly/concurrency/ConcurrentHashMap.h>
 
 #include "logdevice/common/types_internal.h"
@@ -34,7 +36,6 @@ class LogStorageStateMap {
  public:
   /**
    * @param num_shards         Number of shards on this node
-   *                           map, required by AtomicHashMap
    * @param recovery_interval  interval between consecutive attempts to recover
    *                           log state
    */
@@ -176,14 +177,67 @@ class LogStorageStateMap {
   // initialization.
   ServerProcessor* processor_;
 
-  // use Hash64 to mitigate the effect of logid (data and metadata) collision
-  using Map = folly::ConcurrentHashMap<logid_t::raw_type,
-                                       std::unique_ptr<LogStorageState>,
-                                       Hash64<logid_t::raw_type>>;
+  /**
+   * LogStorageStates of the logs of one shard.
+   *
+   * It is hit by every STORE, RELEASE and read, so log ids below
+   * DENSE_LOG_ID_LIMIT, where data logs are usually allocated, are looked up
+   * in a two-level table indexed by log id: a lookup is two dependent loads,
+   * without hashing or locking. Chunks of the table and the states in them
+   * are created on first access with a compare-and-swap, and only destroyed
+   * by clear(). Other log ids, such as metadata logs, go to a concurrent hash
+   * map.
+   */
+  class ShardMap {
+   public:
+    static constexpr size_t CHUNK_BITS = 10;
+    static constexpr size_t CHUNK_SIZE = size_t(1) << CHUNK_BITS;
+    static constexpr size_t NUM_CHUNKS = 4096;
+    static constexpr logid_t::raw_type DENSE_LOG_ID_LIMIT =
+        CHUNK_SIZE * NUM_CHUNKS;
+
+    ShardMap();
+    ~ShardMap();
+
+    ShardMap(const ShardMap&) = delete;
+    ShardMap& operator=(const ShardMap&) = delete;
+
+    LogStorageState* find(logid_t log_id) const;
+
+    /**
+     * @param make  called to create the state if there is none yet. If
+     *              another thread inserts one concurrently, the state
+     *              returned by `make` is destroyed and the other one is
+     *              returned.
+     */
+    LogStorageState*
+    insertOrGet(logid_t log_id,
+                folly::FunctionRef<std::unique_ptr<LogStorageState>()> make);
+
+    // See forEachLogOnShard().
+    template <typename Func>
+    int forEach(const Func& func) const;
+
+    // Not thread safe.
+    void clear();
+
+   private:
+    using Chunk = std::array<std::atomic<LogStorageState*>, CHUNK_SIZE>;
 
-  const std::vector<std::unique_ptr<Map>> shard_map_;
+    // NUM_CHUNKS pointers, nullptr until a log of the chunk is inserted.
+    std::unique_ptr<std::atomic<Chunk*>[]> chunks_;
 
-  static std::vector<std::unique_ptr<Map>> makeMap(shard_size_t num_shards);
+    // use Hash64 to mitigate the effect of logid (data and metadata) collision
+    folly::ConcurrentHashMap<logid_t::raw_type,
+                             std::unique_ptr<LogStorageState>,
+                             Hash64<logid_t::raw_type>>
+        outliers_;
+  };
+
+  const std::vector<std::unique_ptr<ShardMap>> shard_map_;
+
+  static std::vector<std::unique_ptr<ShardMap>>
+  makeMap(shard_size_t num_shards);
 
   // Attempt to recover log state only once this many usecs.
   std::chrono::microseconds state_recovery_interval_;
@@ -200,8 +254,26 @@ template <typename Func>
 int LogStorageStateMap::forEachLogOnShard(shard_index_t shard,
                                           const Func& func) const {
   ld_check(shard < shard_map_.size());
-  for (auto kv = shard_map_[shard]->cbegin(); kv != shard_map_[shard]->cend();
-       ++kv) {
+  return shard_map_[shard]->forEach(func);
+}
+
+template <typename Func>
+int LogStorageStateMap::ShardMap::forEach(const Func& func) const {
+  for (size_t i = 0; i < NUM_CHUNKS; ++i) {
+    const Chunk* chunk = chunks_[i].load(std::memory_order_acquire);
+    if (chunk == nullptr) {
+      continue;
+    }
+    for (size_t j = 0; j < CHUNK_SIZE; ++j) {
+      const LogStorageState* state =
+          (*chunk)[j].load(std::memory_order_acquire);
+      if (state != nullptr &&
+          func(logid_t((i << CHUNK_BITS) | j), *state) != 0) {
+        return -1;
+      }
+    }
+  }
+  for (auto kv = outliers_.cbegin(); kv != outliers_.cend(); ++kv) {
     if (kv->second != nullptr) {
       if (func(logid_t(kv->first), *kv->second) != 0) {
         return -1;
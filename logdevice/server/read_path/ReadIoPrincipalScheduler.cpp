@@ -0,0 +1,261 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "logdevice/server/read_path/ReadIoPrincipalScheduler.h"
+
+#include <algorithm>
+
+#include "logdevice/common/FlowGroup.h"
+#include "logdevice/common/debug.h"
+#include "logdevice/common/stats/Stats.h"
+#include "logdevice/server/read_path/ServerReadStream.h"
+
+namespace facebook { namespace logdevice {
+
+ReadIoPrincipalScheduler::ReadIoPrincipalScheduler(StatsHolder* stats)
+    : stats_(stats) {
+  for (auto& waker : wakers_) {
+    waker.scheduler_ = this;
+  }
+}
+
+void ReadIoPrincipalScheduler::Waker::operator()(FlowGroup&, std::mutex&) {
+  scheduler_->onBandwidthAvailable(priority());
+}
+
+ReadIoPrincipalScheduler::PrincipalState&
+ReadIoPrincipalScheduler::getState(const PrincipalInfo& principal,
+                                   size_t num_workers) {
+  auto it = principals_.find(principal.name);
+  if (it == principals_.end()) {
+    it = principals_.emplace(principal.name, PrincipalState()).first;
+    it->second.tags = {"principal:" + principal.name};
+    it->second.guarantee_refilled_at = std::chrono::steady_clock::now();
+  }
+  // The principals config may have changed since the last call.
+  PrincipalState& state = it->second;
+  state.weight = std::max<uint64_t>(principal.weight, 1);
+  state.guarantee_rate =
+      double(principal.min_bytes_per_sec) / std::max<size_t>(num_workers, 1);
+  return state;
+}
+
+void ReadIoPrincipalScheduler::refillGuarantee(PrincipalState& state) {
+  auto now = std::chrono::steady_clock::now();
+  double elapsed_sec =
+      std::chrono::duration<double>(now - state.guarantee_refilled_at).count();
+  state.guarantee_refilled_at = now;
+  // Allow a burst of one second of guaranteed bandwidth, or one read if
+  // that's more.
+  const double burst =
+      std::max(state.guarantee_rate, double(state.guarantee_cost));
+  state.guarantee_tokens = std::min(
+      burst, state.guarantee_tokens + elapsed_sec * state.guarantee_rate);
+}
+
+std::chrono::microseconds
+ReadIoPrincipalScheduler::timeUntilGuarantee(const PrincipalState& state) {
+  double missing = state.guarantee_cost - state.guarantee_tokens;
+  return std::chrono::microseconds(
+      int64_t(std::max(missing, 0.) / state.guarantee_rate * 1e6));
+}
+
+bool ReadIoPrincipalScheduler::takeGuarantee(PrincipalState& state,
+                                             size_t cost) {
+  if (state.guarantee_rate <= 0) {
+    return false;
+  }
+  state.guarantee_cost = cost;
+  refillGuarantee(state);
+  if (state.guarantee_tokens < cost) {
+    return false;
+  }
+  state.guarantee_tokens -= cost;
+  return true;
+}
+
+bool ReadIoPrincipalScheduler::admit(ServerReadStream& stream,
+                                     const PrincipalInfo& principal,
+                                     size_t num_workers,
+                                     size_t cost,
+                                     FlowGroup& flow_group,
+                                     std::mutex& flow_meters_mutex) {
+  if (stream.isThrottled()) {
+    // Already waiting for bandwidth.
+    err = E::CBREGISTERED;
+    return false;
+  }
+
+  flow_group_ = &flow_group;
+  flow_meters_mutex_ = &flow_meters_mutex;
+  PrincipalState& state = getState(principal, num_workers);
+  const Priority p = stream.getReadPriority();
+
+  if (takeGuarantee(state, cost)) {
+    // Count the read against the budget even if there is no credit left.
+    if (!flow_group.drain(cost, p)) {
+      flow_group.debitMeter(p, cost);
+    }
+    TAGGED_STAT_ADD(
+        stats_, state.tags, read_throttling_principal_bytes_guaranteed, cost);
+    TAGGED_STAT_ADD(
+        stats_, state.tags, read_throttling_principal_bytes_admitted, cost);
+    return true;
+  }
+
+  if (!flow_group.drain(cost, p)) {
+    // Lock to prevent race between registering for bandwidth and
+    // a bandwidth deposit from the TrafficShaper.
+    std::unique_lock<std::mutex> lock(flow_meters_mutex);
+    if (!flow_group.drain(cost, p)) {
+      if (state.num_waiting == 0) {
+        state.vtime = std::max(state.vtime, clock_);
+      }
+      state.waiting[asInt(p)].push_back(stream.createRef());
+      ++state.num_waiting;
+      ++num_waiting_[asInt(p)];
+      if (!wakers_[asInt(p)].active()) {
+        flow_group.push(wakers_[asInt(p)], p);
+      }
+      lock.unlock();
+
+      stream.markThrottled(true);
+      TAGGED_STAT_INCR(
+          stats_, state.tags, read_throttling_principal_reads_throttled);
+      if (state.guarantee_rate > 0) {
+        // Wake it up when the guarantee refills.
+        activateWakeTimer(timeUntilGuarantee(state));
+      }
+      err = E::CBREGISTERED;
+      return false;
+    }
+  }
+
+  state.vtime += double(cost) / state.weight;
+  TAGGED_STAT_ADD(
+      stats_, state.tags, read_throttling_principal_bytes_admitted, cost);
+  return true;
+}
+
+bool ReadIoPrincipalScheduler::wakeFrom(PrincipalState& state, Priority p) {
+  auto& waiting = state.waiting[asInt(p)];
+  while (!waiting.empty()) {
+    ServerReadStream* stream = waiting.front().get();
+    waiting.pop_front();
+    --state.num_waiting;
+    --num_waiting_[asInt(p)];
+    if (stream == nullptr) {
+      // Stream was closed while waiting.
+      continue;
+    }
+    clock_ = std::max(clock_, state.vtime);
+    // Unthrottles the stream and lets its CatchupQueue try again.
+    stream->readShapingCallback()(*flow_group_, *flow_meters_mutex_);
+    return true;
+  }
+  return false;
+}
+
+bool ReadIoPrincipalScheduler::wakeOne(Priority p) {
+  while (num_waiting_[asInt(p)] > 0) {
+    PrincipalState* next = nullptr;
+    for (auto& kv : principals_) {
+      PrincipalState& state = kv.second;
+      if (!state.waiting[asInt(p)].empty() &&
+          (next == nullptr || state.vtime < next->vtime)) {
+        next = &state;
+      }
+    }
+    ld_check(next != nullptr);
+    if (wakeFrom(*next, p)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void ReadIoPrincipalScheduler::onBandwidthAvailable(Priority p) {
+  wakeOne(p);
+  if (num_waiting_[asInt(p)] > 0) {
+    activateWakeTimer(std::chrono::microseconds(0));
+  }
+}
+
+void ReadIoPrincipalScheduler::wakeWaiting() {
+  if (flow_group_ == nullptr) {
+    return;
+  }
+
+  // Waking a stream may call admit() and add principals, so don't iterate
+  // over principals_ while waking. Pointers to its elements stay valid.
+  std::vector<PrincipalState*> guaranteed;
+  for (auto& kv : principals_) {
+    if (kv.second.num_waiting > 0 && kv.second.guarantee_rate > 0) {
+      guaranteed.push_back(&kv.second);
+    }
+  }
+
+  auto next_refill = std::chrono::microseconds::max();
+  for (Priority p = Priority::MAX; p < Priority::NUM_PRIORITIES;
+       p = priorityBelow(p)) {
+    // First streams of principals that can use their guarantee.
+    for (PrincipalState* state : guaranteed) {
+      while (!state->waiting[asInt(p)].empty()) {
+        // The woken stream's admit() takes the tokens.
+        refillGuarantee(*state);
+        if (state->guarantee_tokens < state->guarantee_cost) {
+          next_refill = std::min(next_refill, timeUntilGuarantee(*state));
+          break;
+        }
+        if (!wakeFrom(*state, p)) {
+          break;
+        }
+      }
+    }
+
+    // Then everyone else in fair order, while the FlowGroup has bandwidth.
+    // Bounded by the number of streams waiting now, in case woken streams
+    // keep being throttled again.
+    for (size_t n = num_waiting_[asInt(p)]; n > 0; --n) {
+      if (wakers_[asInt(p)].active()) {
+        // The FlowGroup will call us when there is bandwidth.
+        break;
+      }
+      {
+        std::lock_guard<std::mutex> lock(*flow_meters_mutex_);
+        if (!flow_group_->canDrain(p)) {
+          flow_group_->push(wakers_[asInt(p)], p);
+          break;
+        }
+      }
+      if (!wakeOne(p)) {
+        break;
+      }
+    }
+  }
+
+  if (next_refill != std::chrono::microseconds::max()) {
+    activateWakeTimer(next_refill);
+  }
+}
+
+void ReadIoPrincipalScheduler::activateWakeTimer(
+    std::chrono::microseconds delay) {
+  if (!wake_timer_.isAssigned()) {
+    wake_timer_.assign([this] { wakeWaiting(); });
+  }
+  // Don't wake up more often than once a millisecond for guarantees.
+  if (delay.count() > 0) {
+    delay = std::max(delay, std::chrono::microseconds(1000));
+  }
+  if (!wake_timer_.isActive() || delay.count() == 0) {
+    wake_timer_.activate(delay);
+  }
+}
+
+}} // namespace facebook::logdevice
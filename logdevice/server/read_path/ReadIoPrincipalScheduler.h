@@ -0,0 +1,168 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "logdevice/common/BWAvailableCallback.h"
+#include "logdevice/common/Priority.h"
+#include "logdevice/common/Timer.h"
+#include "logdevice/common/WeakRefHolder.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file Splits a worker's read I/O bandwidth, i.e. the NODE FlowGroup of
+ *       Worker::readShapingContainer(), between client principals. Used by
+ *       CatchupQueueDependencies::canIssueReadIO() when
+ *       Settings::read_throttling_share_by_principal is set.
+ *
+ *       - A principal with min_read_bytes_per_sec gets a token bucket
+ *         refilled at that rate (divided by the number of workers, each of
+ *         which has its own scheduler). While it has tokens, reads of the
+ *         principal's clients are admitted even if the FlowGroup has no
+ *         credit; the FlowGroup's meter is debited anyway, so that the
+ *         guaranteed reads count against everyone else's budget.
+ *       - Otherwise reads are admitted if the FlowGroup has credit. If not,
+ *         the read stream waits in a queue of its principal, instead of
+ *         registering its own ReadIoShapingCallback with the FlowGroup. One
+ *         callback per priority stands in for all waiting streams. When
+ *         bandwidth becomes available, streams are woken in weighted fair
+ *         order: the principal with the least virtual time (bytes admitted
+ *         divided by Principal::read_share) goes first.
+ *
+ *       Not thread-safe. Each worker has its own instance, owned by
+ *       AllServerReadStreams.
+ */
+
+class FlowGroup;
+class ServerReadStream;
+class StatsHolder;
+
+class ReadIoPrincipalScheduler {
+ public:
+  struct PrincipalInfo {
+    std::string name;
+    // Principal::read_share, at least 1.
+    uint64_t weight = 1;
+    // Principal::min_read_bytes_per_sec of the whole node.
+    uint64_t min_bytes_per_sec = 0;
+  };
+
+  explicit ReadIoPrincipalScheduler(StatsHolder* stats);
+
+  /**
+   * Decides whether `stream` can issue a read of estimated size `cost` from
+   * `flow_group` (protected by `flow_meters_mutex`), on behalf of
+   * `principal`.
+   *
+   * @param num_workers  number of workers sharing the principal's guarantee.
+   * @return  true if the read can go ahead. Otherwise sets err to
+   *          E::CBREGISTERED; the stream is marked throttled and will be
+   *          woken through its ReadIoShapingCallback.
+   */
+  bool admit(ServerReadStream& stream,
+             const PrincipalInfo& principal,
+             size_t num_workers,
+             size_t cost,
+             FlowGroup& flow_group,
+             std::mutex& flow_meters_mutex);
+
+ private:
+  // Registered with the FlowGroup, on behalf of all waiting streams of a
+  // priority.
+  class Waker : public BWAvailableCallback {
+   public:
+    void operator()(FlowGroup&, std::mutex&) override;
+
+    ReadIoPrincipalScheduler* scheduler_{nullptr};
+  };
+
+  struct PrincipalState {
+    // Tags for per-principal stats.
+    std::vector<std::string> tags;
+    uint64_t weight = 1;
+
+    // Guarantee token bucket. Not used if rate is 0.
+    double guarantee_rate = 0; // bytes per second
+    double guarantee_tokens = 0;
+    std::chrono::steady_clock::time_point guarantee_refilled_at;
+    // Cost of the last read that asked for the guarantee. Waiting streams
+    // are woken when the bucket has that much.
+    size_t guarantee_cost = 0;
+
+    // Bytes admitted through the FlowGroup, divided by weight. Only compared
+    // between principals with waiting streams; a principal that starts
+    // waiting is moved up to clock_, so that it doesn't get ahead for the
+    // time it wasn't reading.
+    double vtime = 0;
+
+    std::array<std::deque<WeakRef<ServerReadStream>>,
+               asInt(Priority::NUM_PRIORITIES)>
+        waiting;
+    // Total size of `waiting`.
+    size_t num_waiting = 0;
+  };
+
+  PrincipalState& getState(const PrincipalInfo& principal, size_t num_workers);
+
+  void refillGuarantee(PrincipalState& state);
+
+  // How long until the guarantee bucket has enough for the last read that
+  // asked for it.
+  static std::chrono::microseconds
+  timeUntilGuarantee(const PrincipalState& state);
+
+  // Refills the guarantee bucket, then takes `cost` from it if it has enough.
+  bool takeGuarantee(PrincipalState& state, size_t cost);
+
+  // Wakes the first live waiting stream at priority p of the principal with
+  // the least vtime. Returns false if there were no waiting streams.
+  bool wakeOne(Priority p);
+
+  // Wakes the first live waiting stream at priority p of `state`.
+  bool wakeFrom(PrincipalState& state, Priority p);
+
+  // Wakes streams at all priorities while bandwidth or guarantees are
+  // available, registers the wakers for the rest and schedules wake_timer_
+  // for the next guarantee refill.
+  void wakeWaiting();
+
+  void activateWakeTimer(std::chrono::microseconds delay);
+
+  void onBandwidthAvailable(Priority p);
+
+  StatsHolder* stats_;
+
+  std::unordered_map<std::string, PrincipalState> principals_;
+
+  std::array<size_t, asInt(Priority::NUM_PRIORITIES)> num_waiting_{};
+  std::array<Waker, asInt(Priority::NUM_PRIORITIES)> wakers_;
+
+  // vtime of the principal that was woken last.
+  double clock_ = 0;
+
+  // The FlowGroup and lock given to the last admit() call. The same for all
+  // calls on a worker.
+  FlowGroup* flow_group_{nullptr};
+  std::mutex* flow_meters_mutex_{nullptr};
+
+  // Calls wakeWaiting(). Activated with zero delay to keep waking streams
+  // after a Waker was called: the Waker itself only wakes one, because it
+  // can't register itself again with the FlowGroup while being called.
+  // Otherwise activated for when a waiting principal's guarantee refills.
+  Timer wake_timer_;
+};
+
+}} // namespace facebook::logdevice
@@ -175,6 +175,7 @@ void ServerReadStream::disableSingleCopyDelivery() {
   scd_enabled_ = false;
   known_down_.clear();
   self_in_known_down_ = false;
+  scd_preferred_nodes_.clear();
 }
 
 void ServerReadStream::enableLocalScd(const std::string& client_location) {
@@ -248,6 +248,10 @@ class ServerReadStream : boost::noncopyable {
     read_shaping_cb_.addCQRef(cq);
   }
 
+  ReadIoShapingCallback& readShapingCallback() {
+    return read_shaping_cb_;
+  }
+
   size_t getCurrentMeterLevel() const {
     auto w = Worker::onThisThread();
     ShapingContainer& read_container = w->readShapingContainer();
@@ -525,10 +529,19 @@ class ServerReadStream : boost::noncopyable {
   // by ServerRecordFilterFactory.
   std::unique_ptr<ServerRecordFilter> filter_pred_;
 
+  // Sampling and timestamp window requested by the client. Applied together
+  // with filter_pred_.
+  ServerRecordSampling sampling_;
+
   // The location of the client reader.
   // Only used if local_scd_enabled_ is set to true.
   std::string client_location_;
 
+  // Nodes the client prefers to read from, fastest first. Moved to the front
+  // of copysets when deciding which shard ships a record.
+  // Only used if scd_enabled_ is set to true.
+  std::vector<node_index_t> scd_preferred_nodes_;
+
   // Cached log range value, used for per-log-stats in the RECORD_Message's
   // onSent handler
   std::shared_ptr<std::string> log_group_path_;
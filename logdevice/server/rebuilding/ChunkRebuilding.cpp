@@ -9,6 +9,10 @@
 
 #include "logdevice/common/AdminCommandTable.h"
 #include "logdevice/common/Processor.h"
+#include "logdevice/common/Sender.h"
+#include "logdevice/common/protocol/Compatibility.h"
+#include "logdevice/common/protocol/STORES_BATCH_Message.h"
+#include "logdevice/common/stats/Stats.h"
 #include "logdevice/server/ServerWorker.h"
 #include "logdevice/server/rebuilding/ShardRebuilding.h"
 
@@ -74,9 +78,94 @@ void ChunkRebuilding::start() {
                                                 data_->replication);
   }
   numInFlight_ = rrStores_.size();
+  numStoresInFlight_ = rrStores_.size();
+  storeBatching_ = rebuildingSettings_->store_batch_max_bytes > 0;
+  batchingStores_ = storeBatching_;
   for (size_t i = 0; i < rrStores_.size(); ++i) {
     rrStores_[i]->start(readOnly_);
   }
+  batchingStores_ = false;
+  flushStoreBatches();
+}
+
+bool ChunkRebuilding::batchStore(std::unique_ptr<STORE_Message>& msg,
+                                 ShardID to) {
+  if (!batchingStores_) {
+    return false;
+  }
+  Sender& sender = Worker::onThisThread()->sender();
+  folly::Optional<uint16_t> proto = sender.getSocketProtocolVersion(to.node());
+  if (!proto.hasValue() || *proto < Compatibility::STORES_BATCH_SUPPORT) {
+    return false;
+  }
+  // The setting may have been changed to 0 since start().
+  const size_t max_bytes = rebuildingSettings_->store_batch_max_bytes;
+  const size_t bytes = msg->size(*proto);
+  if (bytes >= max_bytes) {
+    return false;
+  }
+
+  StoreBatch& batch = storeBatches_[to.node()];
+  batch.stores.emplace_back(to, std::move(msg));
+  batch.bytes += bytes;
+  if (batch.bytes >= max_bytes) {
+    flushStoreBatch(to.node());
+  }
+  return true;
+}
+
+void ChunkRebuilding::flushStoreBatches() {
+  while (!storeBatches_.empty()) {
+    flushStoreBatch(storeBatches_.begin()->first);
+  }
+}
+
+void ChunkRebuilding::flushStoreBatch(node_index_t node) {
+  auto it = storeBatches_.find(node);
+  if (it == storeBatches_.end()) {
+    return;
+  }
+  StoreBatch batch = std::move(it->second);
+  storeBatches_.erase(it);
+  ld_check(!batch.stores.empty());
+
+  std::vector<std::pair<lsn_t, ShardID>> sent;
+  std::vector<std::unique_ptr<STORE_Message>> stores;
+  for (auto& store : batch.stores) {
+    sent.emplace_back(store.second->getHeader().rid.lsn(), store.first);
+    stores.push_back(std::move(store.second));
+  }
+
+  Sender& sender = Worker::onThisThread()->sender();
+  const NodeID dest = batch.stores[0].first.asNodeID();
+  int rv;
+  if (stores.size() == 1) {
+    rv = sender.sendMessage(std::move(stores[0]), dest);
+  } else {
+    rv = sender.sendMessage(
+        std::make_unique<STORES_BATCH_Message>(std::move(stores)), dest);
+    if (rv == 0) {
+      WORKER_STAT_INCR(rebuilding_store_batches_sent);
+      WORKER_STAT_ADD(rebuilding_stores_batched, sent.size());
+    }
+  }
+  const Status st = rv == 0 ? E::OK : err;
+
+  for (const auto& s : sent) {
+    RecordRebuildingBase* r = findRecordRebuilding(s.first);
+    if (r != nullptr) {
+      r->onStoreBatchSent(s.second, st);
+    }
+  }
+}
+
+RecordRebuildingBase* ChunkRebuilding::findRecordRebuilding(lsn_t lsn) {
+  ssize_t idx = data_->findLSN(lsn);
+  ld_check(idx >= 0);
+  if (rrStores_.at(idx) != nullptr) {
+    return rrStores_[idx].get();
+  }
+  return rrAmends_.at(idx).get();
 }
 
 bool ChunkRebuilding::onStoreSent(Status st,
@@ -183,7 +272,32 @@ void ChunkRebuilding::onAllStoresReceived(
                                                   amend_state->newCopyset_,
                                                   amend_state->amendRecipients_,
                                                   amend_state->rebuildingWave_);
-  amend->start(readOnly_);
+  ld_check(numStoresInFlight_ > 0);
+  --numStoresInFlight_;
+  if (!storeBatching_) {
+    amend->start(readOnly_);
+    return;
+  }
+
+  pendingAmends_.push_back(idx);
+  if (numStoresInFlight_ == 0) {
+    startPendingAmends();
+  }
+}
+
+void ChunkRebuilding::startPendingAmends() {
+  std::vector<size_t> pending = std::move(pendingAmends_);
+  pendingAmends_.clear();
+  batchingStores_ = true;
+  for (size_t idx : pending) {
+    // If the amend completes right away, onAmendDone() leaves the rest to us.
+    rrAmends_.at(idx)->start(readOnly_);
+  }
+  batchingStores_ = false;
+  flushStoreBatches();
+  if (numInFlight_ == 0) {
+    onAllDone();
+  }
 }
 void ChunkRebuilding::onCopysetInvalid(lsn_t lsn) {
   onAmendDone(lsn);
@@ -207,24 +321,29 @@ void ChunkRebuilding::onAmendDone(lsn_t lsn) {
   amend.reset();
   --numInFlight_;
 
-  if (numInFlight_ == 0) {
-    owner_.postCallbackRequest([chunk_id = chunkID_,
-                                oldest_timestamp = data_->oldestTimestamp](
-                                   ShardRebuilding* shard_rebuilding) {
-      if (!shard_rebuilding) {
-        RATELIMIT_INFO(
-            std::chrono::seconds(10),
-            1,
-            "ShardRebuilding went away while ChunkRebuilding was in flight.");
-        return;
-      }
-      shard_rebuilding->onChunkRebuildingDone(chunk_id, oldest_timestamp);
-    });
-
-    deleteThis();
+  if (numInFlight_ == 0 && !batchingStores_) {
+    onAllDone();
   }
 }
 
+void ChunkRebuilding::onAllDone() {
+  ld_check_eq(numInFlight_, 0);
+  owner_.postCallbackRequest([chunk_id = chunkID_,
+                              oldest_timestamp = data_->oldestTimestamp](
+                                 ShardRebuilding* shard_rebuilding) {
+    if (!shard_rebuilding) {
+      RATELIMIT_INFO(
+          std::chrono::seconds(10),
+          1,
+          "ShardRebuilding went away while ChunkRebuilding was in flight.");
+      return;
+    }
+    shard_rebuilding->onChunkRebuildingDone(chunk_id, oldest_timestamp);
+  });
+
+  deleteThis();
+}
+
 void ChunkRebuilding::deleteThis() {
   ServerWorker::onThisThread()->runningChunkRebuildings().map.erase(chunkID_);
 }
@@ -7,6 +7,10 @@
  */
 #pragma once
 
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 #include "logdevice/common/AdminCommandTable-fwd.h"
 #include "logdevice/common/PayloadHolder.h"
 #include "logdevice/server/locallogstore/LocalLogStore.h"
@@ -184,6 +188,9 @@ class ChunkRebuilding : public RecordRebuildingOwner {
   onAllAmendsReceived(lsn_t lsn,
                       std::unique_ptr<FlushTokenMap> flushTokenMap) override;
 
+  // Queues the STORE if we're currently batching STOREs, see storeBatches_.
+  bool batchStore(std::unique_ptr<STORE_Message>& msg, ShardID to) override;
+
   // Unregisters itself from ServerWorker's ChunkRebuildingMap.
   void deleteThis();
 
@@ -206,10 +213,37 @@ class ChunkRebuilding : public RecordRebuildingOwner {
   std::vector<std::unique_ptr<RecordRebuildingAmend>> rrAmends_;
 
   size_t numInFlight_ = 0;
+  // Number of records that haven't been stored yet (that are in rrStores_).
+  size_t numStoresInFlight_ = 0;
 
   bool readOnly_ = false;
 
+  // Whether rebuilding-store-batch-max-bytes was set when we started.
+  // If so, STOREs that RecordRebuildings send while we start them (while
+  // batchingStores_ is true) are queued in storeBatches_ by recipient node,
+  // and sent as STORES_BATCH messages once they're all started.
+  bool storeBatching_ = false;
+  bool batchingStores_ = false;
+  struct StoreBatch {
+    std::vector<std::pair<ShardID, std::unique_ptr<STORE_Message>>> stores;
+    size_t bytes = 0;
+  };
+  std::unordered_map<node_index_t, StoreBatch> storeBatches_;
+
+  // With store batching, amends don't start as soon as their record is
+  // stored, but together once all records are. Indices in rrAmends_.
+  std::vector<size_t> pendingAmends_;
+
+  void flushStoreBatches();
+  void flushStoreBatch(node_index_t node);
+  // RecordRebuildingStore or RecordRebuildingAmend currently running for
+  // `lsn`, or nullptr.
+  RecordRebuildingBase* findRecordRebuilding(lsn_t lsn);
+
+  void startPendingAmends();
   void onAmendDone(lsn_t lsn);
+  // Reports completion to ShardRebuilding and deletes this.
+  void onAllDone();
 };
 
 class StartChunkRebuildingRequest : public Request {
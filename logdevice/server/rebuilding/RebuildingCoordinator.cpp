@@ -7,6 +7,8 @@
  */
 #include "logdevice/server/rebuilding/RebuildingCoordinator.h"
 
+#include <cmath>
+
 #include <folly/hash/Hash.h>
 
 #include "logdevice/admin/maintenance/MaintenanceManagerTracer.h"
@@ -356,6 +358,25 @@ void RebuildingCoordinator::startOnWorkerThread() {
   nonAuthoratitiveRebuildingChecker_ =
       std::make_unique<NonAuthoritativeRebuildingChecker>(
           rebuildingSettings_, event_log_, myNodeId_);
+
+  throttle_ = std::make_unique<RebuildingThrottle>(rebuildingSettings_);
+  throttleTimer_ = std::make_unique<Timer>([this] { onThrottleTimer(); });
+  throttleTimer_->activate(rebuildingSettings_->throttle_interval);
+  WORKER_STAT_SET(rebuilding_throttle_percent, 100);
+}
+
+void RebuildingCoordinator::onThrottleTimer() {
+  const double prev_factor = throttle_->getFactor();
+  const double factor = throttle_->update(getStats());
+  if (factor != prev_factor) {
+    for (auto& s : shardsRebuilding_) {
+      if (s.second.shardRebuilding != nullptr) {
+        s.second.shardRebuilding->setThroughputFactor(factor);
+      }
+    }
+  }
+  WORKER_STAT_SET(rebuilding_throttle_percent, std::lround(factor * 100));
+  throttleTimer_->activate(rebuildingSettings_->throttle_interval);
 }
 
 void RebuildingCoordinator::shutdown() {
@@ -368,6 +389,7 @@ void RebuildingCoordinator::shutdown() {
   writer_.reset();
   nonAuthoratitiveRebuildingChecker_.reset();
   planning_timer_.reset();
+  throttleTimer_.reset();
   shuttingDown_ = true;
 }
 
@@ -1488,6 +1510,9 @@ void RebuildingCoordinator::onFinishedRetrievingPlans(uint32_t shard_idx,
                               rebuildingSettings_);
     shard_state.shardRebuilding->advanceGlobalWindow(
         shard_state.globalWindowEnd);
+    if (throttle_ != nullptr) {
+      shard_state.shardRebuilding->setThroughputFactor(throttle_->getFactor());
+    }
     shard_state.shardRebuilding->start(std::move(shard_state.logsWithPlan));
   }
 }
@@ -30,6 +30,7 @@
 #include "logdevice/server/rebuilding/NonAuthoritativeRebuildingChecker.h"
 #include "logdevice/server/rebuilding/RebuildingPlanner.h"
 #include "logdevice/server/rebuilding/RebuildingSupervisor.h"
+#include "logdevice/server/rebuilding/RebuildingThrottle.h"
 
 /**
  * @file RebuildingCoordinator coordinates all RebuildingPlanner and
@@ -756,6 +757,11 @@ class RebuildingCoordinator : public RebuildingPlanner::Listener,
   std::unique_ptr<NonAuthoritativeRebuildingChecker>
       nonAuthoratitiveRebuildingChecker_;
 
+  // Adjusts throughput of ShardRebuildings based on foreground latencies.
+  std::unique_ptr<RebuildingThrottle> throttle_;
+  std::unique_ptr<Timer> throttleTimer_;
+  void onThrottleTimer();
+
   friend class RebuildingCoordinatorTest;
 };
 
@@ -66,6 +66,7 @@ RebuildingPlanner::RebuildingPlanner(
     : parameters_(std::move(parameters)),
       rebuildingSets_(std::move(rebuilding_sets)),
       rebuildingSettings_(rebuilding_settings),
+      config_(config),
       listener_(listener),
       callbackHelper_(this) {
   ld_check(listener);
@@ -144,8 +145,24 @@ void RebuildingPlanner::onLogsEnumerated(
   // `this` may be destroyed here.
 }
 
+size_t RebuildingPlanner::getMaxSyncSequencerRequestsInFlight() const {
+  const size_t max = rebuildingSettings_->max_get_seq_state_in_flight;
+  const size_t per_sequencer =
+      rebuildingSettings_->max_get_seq_state_in_flight_per_sequencer;
+  if (per_sequencer == 0) {
+    return max;
+  }
+  const auto& membership =
+      config_->getNodesConfiguration()->getSequencerMembership();
+  size_t num_sequencers = 0;
+  for (node_index_t node : *membership) {
+    num_sequencers += membership->isSequencingEnabled(node);
+  }
+  return std::max(max, per_sequencer * num_sequencers);
+}
+
 void RebuildingPlanner::maybeSendMoreRequests() {
-  const auto max = rebuildingSettings_->max_get_seq_state_in_flight;
+  const auto max = getMaxSyncSequencerRequestsInFlight();
 
   while (!remaining_.empty() && inFlight_ < max) {
     logid_t logid = remaining_.back();
@@ -147,6 +147,7 @@ class RebuildingPlanner : public RebuildingLogEnumerator::Listener {
   ParametersPerShard parameters_;
   RebuildingSets rebuildingSets_;
   UpdateableSettings<RebuildingSettings> rebuildingSettings_;
+  std::shared_ptr<UpdateableConfig> config_;
   Listener* listener_;
   std::unique_ptr<RebuildingLogEnumerator> log_enumerator_;
 
@@ -163,6 +164,10 @@ class RebuildingPlanner : public RebuildingLogEnumerator::Listener {
   // May destroy `this`.
   void maybeSendMoreRequests();
 
+  // How many SyncSequencerRequests we can have in flight, see
+  // rebuilding-max-get-seq-state-in-flight[-per-sequencer].
+  size_t getMaxSyncSequencerRequestsInFlight() const;
+
   void sendSyncSequencerRequest(logid_t logid);
 
   // Calls the onRetrievedPlanForLog() method of the listener.
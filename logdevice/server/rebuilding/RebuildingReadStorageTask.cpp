@@ -8,7 +8,9 @@
 #include "logdevice/server/rebuilding/RebuildingReadStorageTask.h"
 
 #include "logdevice/common/AdminCommandTable.h"
+#include "logdevice/common/CopySetMembership.h"
 #include "logdevice/server/ServerProcessor.h"
+#include "logdevice/server/locallogstore/IOType.h"
 #include "logdevice/server/storage_tasks/StorageThreadPool.h"
 
 namespace facebook { namespace logdevice {
@@ -24,6 +26,9 @@ void RebuildingReadStorageTask::execute() {
     return;
   }
 
+  // Let RocksDBEnv apply --rocksdb-rebuilding-read-cache-policy.
+  ScopedIOType io_type(IOType::REBUILDING);
+
   auto start_time = SteadyTimestamp::now();
 
   // Let's just lock the mutex for the whole duration of the storage task.
@@ -47,6 +52,10 @@ void RebuildingReadStorageTask::execute() {
     LocalLogStore::ReadOptions opts(
         "RebuildingReadStorageTask", /* rebuilding */ true);
     opts.fill_cache = context->rebuildingSettings->use_rocksdb_cache;
+    // The filter is applied to copyset index entries first, and the data
+    // iterator is only moved to records that pass it. Runs of passing records
+    // are read sequentially, isolated ones with a seek. So rebuilding only
+    // reads payloads of records it's going to re-replicate.
     opts.allow_copyset_index = true;
     opts.new_to_old = context->rebuildingSettings->new_to_old;
 
@@ -512,6 +521,15 @@ void RebuildingReadStorageTask::updateTrimPoint(logid_t log,
 
 RebuildingReadStorageTask::Filter::Filter(Context* context) : context(context) {
   scd_my_shard_id_ = context->myShardID;
+  // containsAny() compares every copyset entry with every shard, so it's
+  // only faster than hash lookups for small rebuilding sets.
+  if (context->rebuildingSet &&
+      context->rebuildingSet->shards.size() <= kMaxRebuildingShardsToScan) {
+    for (const auto& kv : context->rebuildingSet->shards) {
+      rebuildingShards.push_back(kv.first);
+    }
+    scanRebuildingShards = true;
+  }
 }
 
 void RebuildingReadStorageTask::Filter::clearStats() {
@@ -668,6 +686,18 @@ operator()(logid_t log,
     return false;
   }
 
+  // Fast path for the most common case: none of the copyset is being rebuilt.
+  // populateFilterParams() would come to the same conclusion, but with a hash
+  // map lookup per copyset entry.
+  if (scanRebuildingShards &&
+      !copyset_membership::containsAny(copyset,
+                                        copyset_size,
+                                        rebuildingShards.data(),
+                                        rebuildingShards.size())) {
+    noteRecordFiltered(FilteredReason::NOT_DIRTY, late);
+    return false;
+  }
+
   // TODO(T47692209): optimize the filter algorithm such that draining shards
   // take a fair share of the rebuilding load.
   bool try_filter_relocate = context->rebuildingSet->filter_relocate_shards;
@@ -239,6 +239,14 @@ class RebuildingReadStorageTask : public StorageTask {
     RebuildingReadStorageTask* task;
     Context* context;
 
+    // Shards of context->rebuildingSet, flattened for
+    // copyset_membership::containsAny(). Only filled out, and
+    // scanRebuildingShards set, if there are at most
+    // kMaxRebuildingShardsToScan of them.
+    static constexpr size_t kMaxRebuildingShardsToScan = 32;
+    std::vector<ShardID> rebuildingShards;
+    bool scanRebuildingShards = false;
+
     // Just a cache to avoid lookup in context->logs.
     // If currentLog is valid but currentLogState is nullptr, it means this log
     // is not in context->logs, i.e. we're not interested in it.
@@ -0,0 +1,107 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/server/rebuilding/RebuildingThrottle.h"
+
+#include <algorithm>
+
+#include "logdevice/common/debug.h"
+#include "logdevice/common/stats/Stats.h"
+
+namespace facebook { namespace logdevice {
+
+RebuildingThrottle::RebuildingThrottle(
+    UpdateableSettings<RebuildingSettings> rebuilding_settings)
+    : rebuildingSettings_(rebuilding_settings) {}
+
+bool RebuildingThrottle::enabled() const {
+  return rebuildingSettings_->throttle_store_latency_p99.count() > 0 ||
+      rebuildingSettings_->throttle_read_latency_p99.count() > 0;
+}
+
+// Adds `hist` to `out` for all shards.
+static void mergeShards(const PerShardHistograms::latency_histogram_t& hist,
+                        HistogramInterface& out) {
+  for (shard_index_t shard = 0; shard < hist.getNumShards(); ++shard) {
+    out.merge(*hist.get(shard));
+  }
+}
+
+// p99 of samples added to `cur` since it was equal to `prev`. Updates `prev`.
+static std::chrono::microseconds windowP99(const LatencyHistogram& cur,
+                                           LatencyHistogram& prev) {
+  LatencyHistogram window;
+  window.assign(cur);
+  window.subtract(prev);
+  prev.assign(cur);
+  return std::chrono::microseconds(window.estimatePercentile(.99));
+}
+
+double RebuildingThrottle::update(StatsHolder* stats) {
+  if (!enabled() || stats == nullptr) {
+    factor_ = 1;
+    return factor_;
+  }
+
+  LatencyHistogram store_latency;
+  LatencyHistogram read_latency;
+  stats->runForEach([&](Stats& s) {
+    if (!s.per_shard_histograms) {
+      return;
+    }
+    auto& h = *s.per_shard_histograms;
+    // Foreground stores, i.e. not counting rebuilding stores.
+    mergeShards(h.store_latency, store_latency);
+    // Foreground reads: read stream batches served from backlog and tail.
+    mergeShards(
+        h.storage_tasks[static_cast<int>(StorageTaskType::READ_BACKLOG)],
+        read_latency);
+    mergeShards(h.storage_tasks[static_cast<int>(StorageTaskType::READ_TAIL)],
+                read_latency);
+  });
+
+  return update(windowP99(store_latency, prevStoreLatency_),
+                windowP99(read_latency, prevReadLatency_));
+}
+
+double RebuildingThrottle::update(std::chrono::microseconds store_p99,
+                                  std::chrono::microseconds read_p99) {
+  if (!enabled()) {
+    factor_ = 1;
+    return factor_;
+  }
+
+  auto over_target = [](std::chrono::microseconds p99,
+                         std::chrono::milliseconds target) {
+    return target.count() > 0 && p99 > target;
+  };
+  const double min_factor = rebuildingSettings_->throttle_min_percent / 100.;
+
+  double prev_factor = factor_;
+  if (over_target(store_p99, rebuildingSettings_->throttle_store_latency_p99) ||
+      over_target(read_p99, rebuildingSettings_->throttle_read_latency_p99)) {
+    // Back off quickly.
+    factor_ = std::max(min_factor, factor_ / 2);
+  } else {
+    factor_ = std::min(1., factor_ + kIncreaseStep);
+  }
+  factor_ = std::max(factor_, min_factor);
+
+  if (factor_ != prev_factor) {
+    RATELIMIT_INFO(std::chrono::seconds(10),
+                   2,
+                   "Rebuilding throughput factor changed from %.2f to %.2f. "
+                   "Foreground p99 latencies: store %.3fms, read %.3fms.",
+                   prev_factor,
+                   factor_,
+                   store_p99.count() / 1e3,
+                   read_p99.count() / 1e3);
+  }
+  return factor_;
+}
+
+}} // namespace facebook::logdevice
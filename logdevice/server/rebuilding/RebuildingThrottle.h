@@ -0,0 +1,67 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <chrono>
+
+#include "logdevice/common/settings/RebuildingSettings.h"
+#include "logdevice/common/settings/UpdateableSettings.h"
+#include "logdevice/common/stats/Histogram.h"
+
+namespace facebook { namespace logdevice {
+
+class StatsHolder;
+
+/**
+ * @file Closed-loop controller of how hard rebuilding on this node pushes.
+ *
+ * Periodically looks at the p99 latency of foreground stores and reads on this
+ * node over the last interval. While both are within their targets
+ * (rebuilding-throttle-store-latency-p99, rebuilding-throttle-read-latency-p99)
+ * the throughput factor grows additively up to 1; when either is over target,
+ * the factor is halved, down to rebuilding-throttle-min-percent.
+ * ShardRebuilding scales its limits on re-replication in flight by the factor,
+ * which throttles both rebuilding stores and, through the read buffer,
+ * rebuilding reads.
+ *
+ * If neither target is set, the factor stays at 1.
+ */
+
+class RebuildingThrottle {
+ public:
+  explicit RebuildingThrottle(
+      UpdateableSettings<RebuildingSettings> rebuilding_settings);
+
+  // Samples the foreground latency histograms in `stats` and updates the
+  // factor based on latencies since the previous call. Returns the new factor.
+  double update(StatsHolder* stats);
+
+  // Updates the factor based on p99 latencies observed during the last
+  // interval. Zero means no samples. Returns the new factor.
+  double update(std::chrono::microseconds store_p99,
+                std::chrono::microseconds read_p99);
+
+  double getFactor() const {
+    return factor_;
+  }
+
+  bool enabled() const;
+
+ private:
+  UpdateableSettings<RebuildingSettings> rebuildingSettings_;
+  double factor_ = 1;
+
+  // Cumulative histograms as of the previous update(StatsHolder*).
+  LatencyHistogram prevStoreLatency_;
+  LatencyHistogram prevReadLatency_;
+
+  // How much the factor grows per interval while latencies are within target.
+  static constexpr double kIncreaseStep = 0.1;
+};
+
+}} // namespace facebook::logdevice
@@ -283,6 +283,12 @@ int RecordRebuildingBase::sendStore(StageRecipients::Type type,
 
   auto message = buildStoreMessage(recipient.shard_, amend);
 
+  if (owner_->batchStore(message, recipient.shard_)) {
+    // The owner will send it along with other records' STOREs and call
+    // onStoreBatchSent().
+    return 0;
+  }
+
   ld_spew("sending STORE%s %lu%s to %s",
           amend ? " (amend)" : "",
           owner_->getLogID().val_,
@@ -319,6 +325,39 @@ int RecordRebuildingBase::sendStore(StageRecipients::Type type,
   return 0;
 }
 
+void RecordRebuildingBase::onStoreBatchSent(ShardID to, Status st) {
+  RecipientNode* r = findRecipient(to);
+  if (r == nullptr || r->succeeded) {
+    return;
+  }
+  if (st != E::OK) {
+    const bool amend =
+        curStageRecipient_->type == StageRecipients::Type::AMEND;
+    traceEvent(amend ? "SEND_AMEND_FAILED" : "SEND_STORE_FAILED",
+               error_name(st));
+    RATELIMIT_WARNING(std::chrono::seconds(10),
+                      2,
+                      "Failed to send STORE%s to %s: %s",
+                      amend ? " (amend)" : "",
+                      to.toString().c_str(),
+                      error_description(st));
+    activateRetryTimer();
+    return;
+  }
+  // The batch was sent without our socket callback, install it now.
+  int rv = Worker::onThisThread()->sender().registerOnConnectionClosed(
+      Address(to.asNodeID()), r->on_socket_close);
+  if (rv != 0) {
+    // The connection is already gone. We won't hear back, resend.
+    ld_debug("Failed to install socket callback for STORE of %lu%s to %s: %s",
+             owner_->getLogID().val_,
+             lsn_to_string(lsn_).c_str(),
+             to.toString().c_str(),
+             error_name(err));
+    activateRetryTimer();
+  }
+}
+
 std::unique_ptr<STORE_Message>
 RecordRebuildingBase::buildStoreMessage(ShardID target_shard, bool amend) {
   RebuildingStoreChain copyset(newCopyset_.size());
@@ -156,6 +156,14 @@ class RecordRebuildingOwner {
   virtual void
   onAllAmendsReceived(lsn_t lsn,
                       std::unique_ptr<FlushTokenMap> flushTokenMap) = 0;
+
+  // Lets the owner send STOREs of several records to the same node in one
+  // STORES_BATCH message. If the owner takes `msg`, it returns true and later
+  // calls RecordRebuildingBase::onStoreBatchSent().
+  virtual bool batchStore(std::unique_ptr<STORE_Message>& /* msg */,
+                          ShardID /* to */) {
+    return false;
+  }
 };
 
 class RecordRebuildingBase : public RecordRebuildingInterface {
@@ -252,6 +260,11 @@ class RecordRebuildingBase : public RecordRebuildingInterface {
 
   void onConnectionClosed(ShardID shard);
 
+  // Called by the owner when a STORE it took in batchStore() was passed to
+  // Sender (st == E::OK), or couldn't be (st is the error of
+  // Sender::sendMessage()).
+  void onStoreBatchSent(ShardID to, Status st);
+
   void onAmendedSelf(Status status,
                      FlushToken flush_token = FlushToken_INVALID);
 
@@ -21,6 +21,19 @@ static constexpr std::chrono::milliseconds PROFILING_TIMER_PERIOD =
 
 std::atomic<chunk_rebuilding_id_t::raw_type> ShardRebuilding::nextChunkID_{0};
 
+// Don't use timestamp window (both local and global) for metadata/internal
+// logs. These logs are not stored in partitions and are read in log-by-log
+// order rather than roughly chronological (partition-by-partition) order,
+// so timestamp windows make no sense for these logs. The recipient storage
+// nodes also don't care how spread out the timestamps of these records are,
+// since they're all going to the same "unpartitioned" column family, unlike
+// data log records that go to many different partitions.
+// All metadata/internal logs are read before any data logs.
+static bool isLogExemptedFromWindow(logid_t log) {
+  return MetaDataLog::isMetaDataLog(log) ||
+      configuration::InternalLogs::isInternal(log);
+}
+
 ShardRebuilding::ShardRebuilding(
     shard_index_t shard,
     lsn_t rebuilding_version,
@@ -65,30 +78,43 @@ void ShardRebuilding::start(
     std::unordered_map<logid_t, std::unique_ptr<RebuildingPlan>> plan) {
   numLogs_ = plan.size();
   startTime_ = SteadyTimestamp::now();
-  readingProgressTimestamp_ = direction_.firstTimestamp();
   readRateLimiter_ = RateLimiter(rebuildingSettings_->rate_limit);
-  readContext_ = std::make_shared<RebuildingReadStorageTask::Context>();
-  readContext_->onDone = [this, this_ref = callbackHelper_.getHolder().ref()](
-                             std::vector<std::unique_ptr<ChunkData>> chunks) {
-    if (this_ref.get() != nullptr) {
-      onReadTaskDone(std::move(chunks));
-    }
-  };
-  readContext_->rebuildingSet = rebuildingSet_;
-  readContext_->rebuildingSettings = rebuildingSettings_;
-  readContext_->myShardID = ShardID(getMyNodeIndex(), shard_);
-  readContext_->progressTimestamp = direction_.firstTimestamp();
+
+  // The number of cursors is fixed for the lifetime of this ShardRebuilding.
+  // Don't create cursors that would have no logs to read.
+  const size_t num_cursors = std::max<size_t>(
+      1, std::min(rebuildingSettings_->read_cursors, plan.size()));
+  readCursors_.resize(num_cursors);
+  for (size_t i = 0; i < num_cursors; ++i) {
+    ReadCursor& cursor = readCursors_[i];
+    cursor.context = std::make_shared<RebuildingReadStorageTask::Context>();
+    cursor.context->onDone =
+        [this, i, this_ref = callbackHelper_.getHolder().ref()](
+            std::vector<std::unique_ptr<ChunkData>> chunks) {
+          if (this_ref.get() != nullptr) {
+            onReadTaskDone(i, std::move(chunks));
+          }
+        };
+    cursor.context->rebuildingSet = rebuildingSet_;
+    cursor.context->rebuildingSettings = rebuildingSettings_;
+    cursor.context->myShardID = ShardID(getMyNodeIndex(), shard_);
+    cursor.context->progressTimestamp = direction_.firstTimestamp();
+    cursor.readingProgressTimestamp = direction_.firstTimestamp();
+    cursor.iteratorInvalidationTimer =
+        createTimer([this, i] { invalidateIterator(i); });
+  }
 
   for (const auto& log_plan : plan) {
-    auto ins = readContext_->logs.emplace(
-        std::piecewise_construct,
-        std::forward_as_tuple(log_plan.first),
-        std::forward_as_tuple(std::move(*log_plan.second)));
+    auto& logs = readCursors_[log_plan.first.val() % num_cursors].context->logs;
+    auto ins = logs.emplace(std::piecewise_construct,
+                            std::forward_as_tuple(log_plan.first),
+                            std::forward_as_tuple(std::move(*log_plan.second)));
     ld_check(ins.second);
   }
 
+  clampReadAhead();
+
   delayedReadTimer_ = createTimer([this] { tryMakeProgress(); });
-  iteratorInvalidationTimer_ = createTimer([this] { invalidateIterator(); });
   profilingTimer_ = createTimer([this] {
     flushCurrentStateTime();
     profilingTimer_->activate(PROFILING_TIMER_PERIOD);
@@ -101,51 +127,114 @@ void ShardRebuilding::start(
 
 void ShardRebuilding::advanceGlobalWindow(RecordTimestamp new_window_end) {
   globalWindowEnd_ = new_window_end;
-  if (readContext_ != nullptr) {
+  if (!readCursors_.empty()) {
     tryMakeProgress();
   } else {
     // start() hasn't been called yet.
   }
 }
 
+void ShardRebuilding::clampReadAhead() {
+  const size_t num_cursors = std::max<size_t>(1, readCursors_.size());
+  const size_t read_batch_size = rebuildingSettings_->max_batch_bytes;
+  const size_t budget = rebuildingSettings_->read_buffer_max_bytes;
+  if (budget == 0) {
+    // Fixed read ahead of 3x max read batch size per cursor.
+    readAheadBytes_ = read_batch_size * 3 * num_cursors;
+    return;
+  }
+  // Always allow each cursor to have one batch in its read buffer while the
+  // next one is being read, even if the budget is smaller than that.
+  const size_t min_read_ahead = read_batch_size * 2 * num_cursors;
+  const size_t max_read_ahead = std::max(budget, min_read_ahead);
+  if (readAheadBytes_ == 0) {
+    // Start where the fixed read ahead would be.
+    readAheadBytes_ = read_batch_size * 3 * num_cursors;
+  }
+  readAheadBytes_ =
+      std::min(std::max(readAheadBytes_, min_read_ahead), max_read_ahead);
+}
+
+void ShardRebuilding::adjustReadAhead(const ReadCursor& cursor) {
+  if (rebuildingSettings_->read_buffer_max_bytes == 0) {
+    return;
+  }
+  const size_t read_batch_size = rebuildingSettings_->max_batch_bytes;
+  if (nextChunkCursor() == nullptr &&
+      chunkRebuildingRecordsInFlight_ < maxRecordsInFlight() &&
+      chunkRebuildingBytesInFlight_ < maxRecordBytesInFlight()) {
+    // Re-replication could have taken more records but had none: read
+    // further ahead.
+    readAheadBytes_ += read_batch_size;
+  } else if (bytesInReadBuffer_ > 0 &&
+             bytesInReadBuffer_ >= cursor.bytesInReadBufferAtReadStart) {
+    // Nothing was taken from read buffers while we were reading.
+    // Re-replication is the bottleneck, and reading ahead further only takes
+    // memory.
+    readAheadBytes_ -= std::min(readAheadBytes_, read_batch_size);
+  }
+  clampReadAhead();
+}
+
 void ShardRebuilding::sendStorageTaskIfNeeded() {
   const size_t read_batch_size = rebuildingSettings_->max_batch_bytes;
-  // Hard code max size of readBuffer_ as 3x max read batch size.
-  // This could be a separate setting, but that doesn't seem very useful.
-  const size_t max_read_buffer_size = read_batch_size * 3;
 
   // Note that reading is not affected by global window or
-  // max_record_bytes_in_flight. Reading just tries to keep readBuffer_
+  // max_record_bytes_in_flight. Reading just tries to keep read buffers
   // reasonably full.
-  if (completed_ || storageTaskInFlight_ || readContext_->reachedEnd ||
-      readContext_->persistentError ||
-      bytesInReadBuffer_ + read_batch_size > max_read_buffer_size ||
+  if (completed_ || anyPersistentError() ||
       rebuildingSettings_->test_stall_rebuilding) {
     return;
   }
 
-  // Consult rate limiter. Use zero cost for now. We'll tell rate limiter the
-  // actual cost in bytes once the storage task is done.
-  std::chrono::steady_clock::duration to_wait;
-  bool allowed = readRateLimiter_.isAllowed(
-      0, &to_wait, std::chrono::steady_clock::duration::zero());
-  if (!allowed) {
-    if (to_wait != std::chrono::steady_clock::duration::max()) {
-      delayedReadTimer_->activate(
-          std::chrono::duration_cast<std::chrono::microseconds>(to_wait));
+  while (true) {
+    // Among cursors that can read, pick the one with the fewest chunks
+    // buffered.
+    ReadCursor* cursor = nullptr;
+    size_t cursor_idx = 0;
+    for (size_t i = 0; i < readCursors_.size(); ++i) {
+      ReadCursor& c = readCursors_[i];
+      if (c.storageTaskInFlight || c.context->reachedEnd) {
+        continue;
+      }
+      if (cursor == nullptr ||
+          c.readBuffer.size() < cursor->readBuffer.size()) {
+        cursor = &c;
+        cursor_idx = i;
+      }
+    }
+    if (cursor == nullptr ||
+        bytesInReadBuffer_ + read_batch_size * (storageTasksInFlight_ + 1) >
+            readAheadBytes_) {
+      return;
+    }
+
+    // Consult rate limiter. Use zero cost for now. We'll tell rate limiter the
+    // actual cost in bytes once the storage task is done.
+    std::chrono::steady_clock::duration to_wait;
+    bool allowed = readRateLimiter_.isAllowed(
+        0, &to_wait, std::chrono::steady_clock::duration::zero());
+    if (!allowed) {
+      if (to_wait != std::chrono::steady_clock::duration::max()) {
+        delayedReadTimer_->activate(
+            std::chrono::duration_cast<std::chrono::microseconds>(to_wait));
+      }
+      return;
     }
-    return;
-  }
 
-  if (readContext_->iterator != nullptr) {
-    iteratorInvalidationTimer_->cancel();
+    if (cursor->context->iterator != nullptr) {
+      cursor->iteratorInvalidationTimer->cancel();
+    }
+    cursor->storageTaskInFlight = true;
+    ++storageTasksInFlight_;
+    cursor->bytesInReadBufferAtReadStart = bytesInReadBuffer_;
+    putStorageTask(cursor_idx);
   }
-  storageTaskInFlight_ = true;
-  putStorageTask();
 }
 
-void ShardRebuilding::putStorageTask() {
-  auto task = std::make_unique<RebuildingReadStorageTask>(readContext_);
+void ShardRebuilding::putStorageTask(size_t cursor) {
+  auto task =
+      std::make_unique<RebuildingReadStorageTask>(readCursors_[cursor].context);
   auto task_queue =
       ServerWorker::onThisThread()->getStorageTaskQueueForShard(shard_);
   task_queue->putTask(std::move(task));
@@ -160,102 +249,153 @@ ShardRebuilding::createTimer(std::function<void()> cb) {
   return std::make_unique<Timer>(cb);
 }
 
-void ShardRebuilding::invalidateIterator() {
-  ld_info("Invalidating rebuilding iterator in shard %u", shard_);
-  ld_check(!storageTaskInFlight_);
-  ld_check(readContext_->iterator != nullptr);
-  readContext_->iterator->invalidate();
+void ShardRebuilding::invalidateIterator(size_t cursor_idx) {
+  ReadCursor& cursor = readCursors_[cursor_idx];
+  ld_info("Invalidating rebuilding iterator %lu in shard %u",
+          cursor_idx,
+          shard_);
+  ld_check(!cursor.storageTaskInFlight);
+  ld_check(cursor.context->iterator != nullptr);
+  cursor.context->iterator->invalidate();
+}
+
+const ShardRebuilding::ReadCursor* ShardRebuilding::nextChunkCursor() const {
+  const ReadCursor* best = nullptr;
+  for (const ReadCursor& cursor : readCursors_) {
+    if (cursor.readBuffer.empty()) {
+      continue;
+    }
+    const ChunkData& chunk = *cursor.readBuffer.front();
+    if (isLogExemptedFromWindow(chunk.address.log)) {
+      return &cursor;
+    }
+    if (best == nullptr ||
+        direction_.timestampCmp(chunk.oldestTimestamp,
+                                best->readBuffer.front()->oldestTimestamp) <
+            0) {
+      best = &cursor;
+    }
+  }
+  return best;
+}
+
+ShardRebuilding::ReadCursor* ShardRebuilding::nextChunkCursor() {
+  return const_cast<ReadCursor*>(
+      static_cast<const ShardRebuilding*>(this)->nextChunkCursor());
+}
+
+bool ShardRebuilding::anyPersistentError() const {
+  for (const ReadCursor& cursor : readCursors_) {
+    // We're not allowed to look at the context while a task is in flight.
+    if (!cursor.storageTaskInFlight && cursor.context->persistentError) {
+      return true;
+    }
+  }
+  return false;
+}
+
+RecordTimestamp ShardRebuilding::readingProgressTimestamp() const {
+  RecordTimestamp res = direction_.lastTimestamp();
+  for (const ReadCursor& cursor : readCursors_) {
+    res = direction_.firstTimestamp(res, cursor.readingProgressTimestamp);
+  }
+  return res;
+}
+
+double ShardRebuilding::readingProgress() const {
+  double sum = 0;
+  for (const ReadCursor& cursor : readCursors_) {
+    if (cursor.readingProgress < 0) {
+      return -1;
+    }
+    sum += cursor.readingProgress;
+  }
+  return readCursors_.empty() ? 0 : sum / readCursors_.size();
 }
 
 void ShardRebuilding::onReadTaskDone(
+    size_t cursor_idx,
     std::vector<std::unique_ptr<ChunkData>> chunks) {
+  ReadCursor& cursor = readCursors_[cursor_idx];
+  ld_check(cursor.storageTaskInFlight);
+
   // Report the cost of this read task to rate limiter.
   std::chrono::steady_clock::duration unused;
-  readRateLimiter_.isAllowed(readContext_->bytesRead, &unused);
+  readRateLimiter_.isAllowed(cursor.context->bytesRead, &unused);
+
+  adjustReadAhead(cursor);
 
   for (auto& c : chunks) {
     bytesInReadBuffer_ += c->totalBytes();
   }
-  readBuffer_.insert(readBuffer_.end(),
-                     std::make_move_iterator(chunks.begin()),
-                     std::make_move_iterator(chunks.end()));
-  storageTaskInFlight_ = false;
+  cursor.readBuffer.insert(cursor.readBuffer.end(),
+                           std::make_move_iterator(chunks.begin()),
+                           std::make_move_iterator(chunks.end()));
+  cursor.storageTaskInFlight = false;
+  ld_check_gt(storageTasksInFlight_, 0);
+  --storageTasksInFlight_;
   ++readTasksDone_;
-  nextLocation_ = readContext_->nextLocation;
-  readingProgressTimestamp_ = readContext_->progressTimestamp;
-  readingProgress_ = readContext_->progress;
-  if (readContext_->iterator != nullptr) {
-    iteratorInvalidationTimer_->activate(getIteratorTTL());
+  cursor.nextLocation = cursor.context->nextLocation;
+  cursor.readingProgressTimestamp = cursor.context->progressTimestamp;
+  cursor.readingProgress = cursor.context->progress;
+  if (cursor.context->iterator != nullptr) {
+    cursor.iteratorInvalidationTimer->activate(getIteratorTTL());
   }
   tryMakeProgress();
 }
 
 void ShardRebuilding::startSomeChunkRebuildingsIfNeeded() {
-  const size_t max_records_in_flight =
-      rebuildingSettings_->max_records_in_flight;
-  const size_t max_bytes_in_flight =
-      rebuildingSettings_->max_record_bytes_in_flight;
+  const size_t max_records_in_flight = maxRecordsInFlight();
+  const size_t max_bytes_in_flight = maxRecordBytesInFlight();
   const bool new_to_old = rebuildingSettings_->new_to_old;
 
-  auto is_log_exempted_from_window = [&](logid_t log) {
-    // Don't use timestamp window (both local and global) for metadata/internal
-    // logs. These logs are not stored in partitions and are read in log-by-log
-    // order rather than roughly chronological (partition-by-partition) order,
-    // so timestamp windows make no sense for these logs. The recipient storage
-    // nodes also don't care how spread out the timestamps of these records are,
-    // since they're all going to the same "unpartitioned" column family, unlike
-    // data log records that go to many different partitions.
-    // All metadata/internal logs are read before any data logs.
-    return MetaDataLog::isMetaDataLog(log) ||
-        configuration::InternalLogs::isInternal(log);
-  };
-
-  auto record_rebuildings_are_too_spread_out = [&] {
+  auto record_rebuildings_are_too_spread_out = [&](const ChunkData& next) {
     if (chunkRebuildings_.empty()) {
       return false;
     }
-    if (is_log_exempted_from_window(readBuffer_.front()->address.log)) {
+    if (isLogExemptedFromWindow(next.address.log)) {
       return false;
     }
     // How far ahead is the next record in read buffer compared to the ~oldest
     // in-flight ChunkRebuilding.
-    // Note that timestamps in readBuffer_ are not always monotonic - they
+    // Note that timestamps in read buffers are not always monotonic - they
     // go up and down multiple times inside each partition (once for each log),
     // so these timestamps should be considered to be at roughly partition
     // granularity, and `diff` may be negative.
     std::chrono::milliseconds diff;
     if (new_to_old) {
       diff = chunkRebuildings_.rbegin()->first.oldestTimestamp -
-          readBuffer_.front()->oldestTimestamp;
+          next.oldestTimestamp;
     } else {
-      diff = readBuffer_.front()->oldestTimestamp -
+      diff = next.oldestTimestamp -
           chunkRebuildings_.begin()->first.oldestTimestamp;
     }
     return diff > rebuildingSettings_->local_window;
   };
 
-  while (!readBuffer_.empty() &&
+  ReadCursor* cursor;
+  while ((cursor = nextChunkCursor()) != nullptr &&
          chunkRebuildingRecordsInFlight_ < max_records_in_flight &&
          chunkRebuildingBytesInFlight_ < max_bytes_in_flight &&
-         !record_rebuildings_are_too_spread_out()) {
-    if (!is_log_exempted_from_window(readBuffer_.front()->address.log) &&
-        direction_.timestampCmp(
-            readBuffer_.front()->oldestTimestamp, globalWindowEnd_) > 0) {
-      // The next record in readBuffer_ is below global window end.
+         !record_rebuildings_are_too_spread_out(*cursor->readBuffer.front())) {
+    const ChunkData& next = *cursor->readBuffer.front();
+    if (!isLogExemptedFromWindow(next.address.log) &&
+        direction_.timestampCmp(next.oldestTimestamp, globalWindowEnd_) > 0) {
+      // The next record in read buffers is below global window end.
       // Wait for global window to advance.
       //
       // Note that we'll eventually make progress even if global window is very
       // small; worst case is: eventually we'll finish in-flight chunk
       // rebuildings, the code below will report
-      // progress_timestamp = readBuffer_.front()->oldestTimestamp, other donors
+      // progress_timestamp = next.oldestTimestamp, other donors
       // will rebuild up to that timestamp, and global window will advance past
       // it.
       break;
     }
 
     chunk_rebuilding_id_t chunk_id{++nextChunkID_};
-    std::unique_ptr<ChunkData> chunk = std::move(readBuffer_.front());
-    readBuffer_.pop_front();
+    std::unique_ptr<ChunkData> chunk = std::move(cursor->readBuffer.front());
+    cursor->readBuffer.pop_front();
     ld_check_ge(bytesInReadBuffer_, chunk->totalBytes());
     bytesInReadBuffer_ -= chunk->totalBytes();
 
@@ -285,7 +425,7 @@ void ShardRebuilding::startSomeChunkRebuildingsIfNeeded() {
   // can update the position of the global window.
   // If no chunks are in flight, and we're blocked on global window, report the
   // exact timestamp to which global window has to slide to unblock us
-  // (readBuffer_.front()->oldestTimestamp).
+  // (oldestTimestamp of the next chunk in read buffers).
   // Note that progress_timestamp is not always monotonic: it can go backwards
   // a little, usually within one partition; that's ok, RebuildingCoordinator
   // ignores progress reports that don't move forward.
@@ -294,16 +434,17 @@ void ShardRebuilding::startSomeChunkRebuildingsIfNeeded() {
     // If there are some records in flight, use the oldest one.
     const auto& chunk =
         new_to_old ? *chunkRebuildings_.rbegin() : *chunkRebuildings_.begin();
-    if (!is_log_exempted_from_window(chunk.second.address.log)) {
+    if (!isLogExemptedFromWindow(chunk.second.address.log)) {
       progress_timestamp = chunk.first.oldestTimestamp;
     } else {
       // We're still rebuilding internal logs, leave progress_timestamp at
       // negative infinity.
     }
-  } else if (!readBuffer_.empty()) {
+  } else if ((cursor = nextChunkCursor()) != nullptr) {
     // If there are some records in buffer, use the first one.
-    if (!is_log_exempted_from_window(readBuffer_.front()->address.log)) {
-      progress_timestamp = readBuffer_.front()->oldestTimestamp;
+    const ChunkData& next = *cursor->readBuffer.front();
+    if (!isLogExemptedFromWindow(next.address.log)) {
+      progress_timestamp = next.oldestTimestamp;
     } else {
       // We're still rebuilding internal/metadata logs. Don't report progress
       // until that is done.
@@ -314,10 +455,10 @@ void ShardRebuilding::startSomeChunkRebuildingsIfNeeded() {
     // anyway, because reading can be slow even if we're filtering everything.
     // Reporting the progress allows other donors to make progress (if global
     // window is enabled), and keeps progress stat up to date.
-    progress_timestamp = readingProgressTimestamp_;
+    progress_timestamp = readingProgressTimestamp();
   }
   listener_->onShardRebuildingProgress(
-      shard_, progress_timestamp, readingProgress_);
+      shard_, progress_timestamp, readingProgress());
 }
 
 worker_id_t
@@ -376,11 +517,15 @@ void ShardRebuilding::finalizeIfNeeded() {
   // ShardRebuilding indefinitely; usually this happens if our own disk is
   // broken, in which case self-initiated rebuilding will soon request a
   // rebuilding, and this ShardRebuilding will be aborted.
-  if (completed_ || storageTaskInFlight_ || !readContext_->reachedEnd ||
-      readContext_->persistentError || !readBuffer_.empty() ||
-      !chunkRebuildings_.empty()) {
+  if (completed_ || storageTasksInFlight_ > 0 || anyPersistentError() ||
+      nextChunkCursor() != nullptr || !chunkRebuildings_.empty()) {
     return;
   }
+  for (const ReadCursor& cursor : readCursors_) {
+    if (!cursor.context->reachedEnd) {
+      return;
+    }
+  }
   completed_ = true;
   ld_info("Rebuilt shard %u in %.3fs (%s). Rebuilt %lu chunks, %lu records, "
           "%lu bytes. Executed %lu read storage tasks.",
@@ -411,9 +556,33 @@ void ShardRebuilding::noteConfigurationChanged() {
 
 void ShardRebuilding::noteRebuildingSettingsChanged() {
   readRateLimiter_.update(rebuildingSettings_->rate_limit);
+  clampReadAhead();
   tryMakeProgress();
 }
 
+void ShardRebuilding::setThroughputFactor(double factor) {
+  ld_check(factor > 0 && factor <= 1);
+  if (factor == throughputFactor_) {
+    return;
+  }
+  throughputFactor_ = factor;
+  if (!readCursors_.empty()) {
+    tryMakeProgress();
+  } else {
+    // start() hasn't been called yet.
+  }
+}
+
+size_t ShardRebuilding::maxRecordsInFlight() const {
+  return std::max<size_t>(
+      1, rebuildingSettings_->max_records_in_flight * throughputFactor_);
+}
+
+size_t ShardRebuilding::maxRecordBytesInFlight() const {
+  return std::max<size_t>(
+      1, rebuildingSettings_->max_record_bytes_in_flight * throughputFactor_);
+}
+
 void ShardRebuilding::getDebugInfo(InfoRebuildingShardsTable& table) const {
   // Some measure of how far we have progressed, in terms of record timestamps.
   if (!chunkRebuildings_.empty()) {
@@ -421,35 +590,50 @@ void ShardRebuilding::getDebugInfo(InfoRebuildingShardsTable& table) const {
                       ? chunkRebuildings_.rbegin()->first
                       : chunkRebuildings_.begin()->first)
                      .oldestTimestamp.toMilliseconds());
-  } else if (!readBuffer_.empty()) {
-    table.set<4>(readBuffer_.front()->oldestTimestamp.toMilliseconds());
+  } else if (const ReadCursor* cursor = nextChunkCursor()) {
+    table.set<4>(cursor->readBuffer.front()->oldestTimestamp.toMilliseconds());
   } else {
-    table.set<4>(readingProgressTimestamp_.toMilliseconds());
+    table.set<4>(readingProgressTimestamp().toMilliseconds());
   }
   // Total memory used.
   table.set<6>(bytesInReadBuffer_ + chunkRebuildingBytesInFlight_);
   table.set<7>(numLogs_);
   table.set<9>(describeTimeByState());
-  table.set<10>(storageTaskInFlight_);
-  if (!storageTaskInFlight_) {
-    table.set<11>(readContext_->persistentError);
+  table.set<10>(storageTasksInFlight_ > 0);
+  if (storageTasksInFlight_ == 0) {
+    table.set<11>(anyPersistentError());
   }
   table.set<12>(bytesInReadBuffer_);
   // TODO (#24665001):
   //   When ChunkRebuilding gets reimplemented to process all records at once,
   //   change this into number of chunks in flight.
   table.set<13>(chunkRebuildingRecordsInFlight_);
-  if (nextLocation_ != nullptr) {
-    table.set<14>(nextLocation_->toString());
+  std::string next_locations;
+  for (const ReadCursor& cursor : readCursors_) {
+    if (cursor.nextLocation != nullptr) {
+      if (!next_locations.empty()) {
+        next_locations += "; ";
+      }
+      next_locations += cursor.nextLocation->toString();
+    }
+  }
+  if (!next_locations.empty()) {
+    table.set<14>(next_locations);
   }
-  table.set<15>(readingProgress_);
+  table.set<15>(readingProgress());
 }
 
 std::function<void(InfoRebuildingLogsTable&)>
 ShardRebuilding::beginGetLogsDebugInfo() const {
-  ld_check(readContext_ != nullptr);
-  return [context = readContext_](InfoRebuildingLogsTable& table) {
-    context->getLogsDebugInfo(table);
+  ld_check(!readCursors_.empty());
+  std::vector<std::shared_ptr<RebuildingReadStorageTask::Context>> contexts;
+  for (const ReadCursor& cursor : readCursors_) {
+    contexts.push_back(cursor.context);
+  }
+  return [contexts = std::move(contexts)](InfoRebuildingLogsTable& table) {
+    for (const auto& context : contexts) {
+      context->getLogsDebugInfo(table);
+    }
   };
 }
 
@@ -503,22 +687,23 @@ void ShardRebuilding::flushCurrentStateTime() {
 }
 void ShardRebuilding::updateProfilingState() {
   ProfilingState new_state;
+  const ReadCursor* next_cursor = nextChunkCursor();
   if (chunkRebuildings_.empty()) {
-    if (storageTaskInFlight_) {
+    if (storageTasksInFlight_ > 0) {
       new_state = ProfilingState::WAITING_FOR_READ;
-    } else if (readBuffer_.empty()) {
+    } else if (next_cursor == nullptr) {
       new_state = ProfilingState::RATE_LIMITED;
     } else {
       new_state = ProfilingState::STALLED;
     }
   } else {
-    new_state = storageTaskInFlight_
+    new_state = storageTasksInFlight_ > 0
         ? ProfilingState::FULLY_OCCUPIED
         : ProfilingState::WAITING_FOR_REREPLICATION;
   }
   if (new_state != profilingState_) {
     // Log a message if we started or stopped waiting on global window.
-    if (storageTaskInFlight_ || !readContext_->persistentError) {
+    if (storageTasksInFlight_ > 0 || !anyPersistentError()) {
       if (new_state == ProfilingState::STALLED) {
         PER_SHARD_STAT_SET(
             getStats(), rebuilding_global_window_waiting_flag, shard_, 1);
@@ -526,9 +711,10 @@ void ShardRebuilding::updateProfilingState() {
                 "slide. Next timestamp to rebuild: %s, global window end: %s, "
                 "total wait time so far: %.3fs",
                 shard_,
-                readBuffer_.empty()
-                    ? "none"
-                    : readBuffer_.front()->oldestTimestamp.toString().c_str(),
+                next_cursor == nullptr ? "none"
+                                       : next_cursor->readBuffer.front()
+                                             ->oldestTimestamp.toString()
+                                             .c_str(),
                 globalWindowEnd_.toString().c_str(),
                 totalTimeByState_[(int)ProfilingState::STALLED].count() / 1e3);
       } else if (profilingState_ == ProfilingState::STALLED) {
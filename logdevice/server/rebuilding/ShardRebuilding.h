@@ -34,8 +34,10 @@ class ShardRebuilding : public ShardRebuildingInterface {
   void advanceGlobalWindow(RecordTimestamp new_window_end) override;
   void noteConfigurationChanged() override;
   void noteRebuildingSettingsChanged() override;
+  void setThroughputFactor(double factor) override;
 
-  void onReadTaskDone(std::vector<std::unique_ptr<ChunkData>> chunks);
+  void onReadTaskDone(size_t cursor,
+                      std::vector<std::unique_ptr<ChunkData>> chunks);
   void onChunkRebuildingDone(chunk_rebuilding_id_t chunk_id,
                              RecordTimestamp oldest_timestamp);
 
@@ -56,7 +58,7 @@ class ShardRebuilding : public ShardRebuildingInterface {
   virtual worker_id_t startChunkRebuilding(std::unique_ptr<ChunkData> chunk,
                                            chunk_rebuilding_id_t chunk_id);
   virtual std::chrono::milliseconds getIteratorTTL();
-  virtual void putStorageTask();
+  virtual void putStorageTask(size_t cursor);
   virtual std::unique_ptr<TimerInterface> createTimer(std::function<void()> cb);
 
  protected:
@@ -81,6 +83,42 @@ class ShardRebuilding : public ShardRebuildingInterface {
     worker_id_t workerID;
   };
 
+  // An independent reader of a subset of the logs. Each cursor has its own
+  // iterator and at most one RebuildingReadStorageTask in flight, so with
+  // multiple cursors the shard is read with multiple concurrent storage tasks.
+  struct ReadCursor {
+    // The reading context is shared between us and the storage task.
+    // When a storage task is in flight, we're not allowed to access the
+    // context.
+    std::shared_ptr<RebuildingReadStorageTask::Context> context;
+    bool storageTaskInFlight = false;
+
+    // Records we've read but haven't started ChunkRebuilding yet.
+    std::deque<std::unique_ptr<ChunkData>> readBuffer;
+    // ShardRebuilding::bytesInReadBuffer_ when the storage task in flight was
+    // sent.
+    size_t bytesInReadBufferAtReadStart = 0;
+
+    // If iterator doesn't get seeked for some time, this timer fires and
+    // invalidates it. For rocksdb-based LocalLogStore implementations the
+    // invalidation prevents the iterator from pinning old versions of
+    // data indefinitely.
+    std::unique_ptr<TimerInterface> iteratorInvalidationTimer;
+
+    // These are duplicated from context to make sure we always have
+    // lock-free access to them.
+    std::shared_ptr<LocalLogStore::AllLogsIterator::Location> nextLocation;
+    // How far the iterator has read, approximately.
+    // Note that this may not correspond to any record.
+    // In particular, if we're filtering out very long ranges of data, this
+    // iterator will show progress of the filtering, while any record-based
+    // indicators would stand still until we find a record that passes filter.
+    RecordTimestamp readingProgressTimestamp;
+    // Value between 0 and 1 indicating approximately what fraction of the data
+    // we have read. -1 means not supported.
+    double readingProgress = 0;
+  };
+
   lsn_t rebuildingVersion_{LSN_INVALID};
   lsn_t restartVersion_{LSN_INVALID};
   uint32_t shard_;
@@ -94,20 +132,25 @@ class ShardRebuilding : public ShardRebuildingInterface {
 
   RecordTimestamp globalWindowEnd_;
 
-  // There's at most one RebuildingReadStorageTask in flight at any time.
-  bool storageTaskInFlight_ = false;
-  // The reading context is shared between us and the storage task.
-  // When a storage task is in flight, we're not allowed to access the context.
-  std::shared_ptr<RebuildingReadStorageTask::Context> readContext_;
+  // Logs are split among rebuilding-read-cursors cursors. Each cursor has at
+  // most one RebuildingReadStorageTask in flight.
+  std::vector<ReadCursor> readCursors_;
+  size_t storageTasksInFlight_ = 0;
 
   RateLimiter readRateLimiter_;
   // The timer is used when readRateLimiter_ tells us to wait before reading.
   std::unique_ptr<TimerInterface> delayedReadTimer_;
 
-  // Records we've read but haven't started ChunkRebuilding yet.
-  std::deque<std::unique_ptr<ChunkData>> readBuffer_;
+  // Total size of the cursors' read buffers.
   size_t bytesInReadBuffer_ = 0;
 
+  // We only send a storage task if the read buffers plus a full read batch for
+  // each storage task in flight, including the new one, would fit in this many
+  // bytes. If rebuilding-read-buffer-max-bytes is set, it adapts within
+  // [2 * max_batch_bytes * cursors, rebuilding-read-buffer-max-bytes],
+  // see adjustReadAhead(). Otherwise it's 3 * max_batch_bytes * cursors.
+  size_t readAheadBytes_ = 0;
+
   // Information about in-flight ChunkRebuildings.
   // Used for finding the timestamp of the oldest/newest record being rebuilt,
   // to make sure it's not too far behind.
@@ -119,11 +162,13 @@ class ShardRebuilding : public ShardRebuildingInterface {
   size_t chunkRebuildingRecordsInFlight_ = 0;
   size_t chunkRebuildingBytesInFlight_ = 0;
 
-  // If iterator doesn't get seeked for some time, this timer fires and
-  // invalidates it. For rocksdb-based LocalLogStore implementations the
-  // invalidation prevents the iterator from pinning old versions of
-  // data indefinitely.
-  std::unique_ptr<TimerInterface> iteratorInvalidationTimer_;
+  // Set by RebuildingCoordinator based on foreground latencies, see
+  // RebuildingThrottle. Scales the limits below.
+  double throughputFactor_ = 1;
+  // rebuilding-max-records-in-flight and rebuilding-max-record-bytes-in-flight
+  // scaled by throughputFactor_.
+  size_t maxRecordsInFlight() const;
+  size_t maxRecordBytesInFlight() const;
 
   WorkerCallbackHelper<ShardRebuilding> callbackHelper_;
 
@@ -136,7 +181,22 @@ class ShardRebuilding : public ShardRebuildingInterface {
   void startSomeChunkRebuildingsIfNeeded();
   void finalizeIfNeeded();
 
-  void invalidateIterator();
+  void invalidateIterator(size_t cursor);
+
+  // Returns the cursor whose next buffered chunk should be rebuilt first, or
+  // nullptr if all read buffers are empty. Chunks of metadata and internal
+  // logs go first, then the chunk with the least advanced timestamp.
+  ReadCursor* nextChunkCursor();
+  const ReadCursor* nextChunkCursor() const;
+  bool anyPersistentError() const;
+
+  // Called when a storage task comes back, before its chunks are added to
+  // the read buffer. Reads further ahead if ChunkRebuildings ran out of
+  // records while we were reading, and less far if the buffer didn't drain at
+  // all.
+  void adjustReadAhead(const ReadCursor& cursor);
+  // Clamps readAheadBytes_ to the current settings.
+  void clampReadAhead();
 
   void tryMakeProgress();
 
@@ -177,23 +237,15 @@ class ShardRebuilding : public ShardRebuildingInterface {
   size_t recordsRebuilt_ = 0;
   size_t bytesRebuilt_ = 0;
   size_t readTasksDone_ = 0;
-  // These are duplicated from readContext_ to make sure we always have
-  // lock-free access to them.
   size_t numLogs_;
-  std::shared_ptr<LocalLogStore::AllLogsIterator::Location> nextLocation_;
   // Calls flushCurrentStateTime() every minute, to make sure we're publishing
   // accurate time spent in each state even when state doesn't change often.
   std::unique_ptr<TimerInterface> profilingTimer_;
 
-  // How far the iterator has read, approximately.
-  // Note that this may not correspond to any record.
-  // In particular, if we're filtering out very long ranges of data, this
-  // iterator will show progress of the filtering, while any record-based
-  // indicators would stand still until we find a record that passes filter.
-  RecordTimestamp readingProgressTimestamp_;
-  // Value between 0 and 1 indicating approximately what fraction of the data
-  // we have read. -1 means not supported.
-  double readingProgress_ = 0;
+  // How far the least advanced cursor has read, and the average fraction of
+  // data read by the cursors (-1 if not supported). See ReadCursor.
+  RecordTimestamp readingProgressTimestamp() const;
+  double readingProgress() const;
 
   // Advances currentStateStartTime_ to current time, updating totalTimeByState_
   // and stats as needed.
@@ -138,6 +138,7 @@ void shutdown_server(
         listeners_per_priority,
     std::unique_ptr<Listener>& gossip_listener,
     std::unique_ptr<Listener>& ssl_connection_listener,
+    std::unique_ptr<Listener>& local_connection_listener,
     std::unique_ptr<Listener>& server_to_server_listener,
     std::unique_ptr<folly::EventBaseThread>& connection_listener_loop,
     std::unique_ptr<folly::EventBaseThread>& gossip_listener_loop,
@@ -217,6 +218,10 @@ void shutdown_server(
     closed_listeners.emplace_back(
         ssl_connection_listener->stopAcceptingConnections());
   }
+  if (local_connection_listener) {
+    closed_listeners.emplace_back(
+        local_connection_listener->stopAcceptingConnections());
+  }
   if (server_to_server_listener) {
     closed_listeners.emplace_back(
         server_to_server_listener->stopAcceptingConnections());
@@ -228,6 +233,7 @@ void shutdown_server(
   gossip_listener.reset();
   gossip_listener_loop.reset();
   ssl_connection_listener.reset();
+  local_connection_listener.reset();
   listeners_per_priority.clear();
   server_to_server_listener.reset();
   server_to_server_listener_loop.reset();
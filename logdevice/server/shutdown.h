@@ -46,8 +46,8 @@ class ClusterMaintenanceStateMachine;
  *      different server.
  *   2. Stop admitting new requests into API and admin Thrift servers
  *   3. Destroys ConnectionListener, CommandListener, GossipListener,
- *      SSL connection and command listeners to stop accepting new
- *      connections.
+ *      SSL connection and command listeners and the local data listener to
+ *      stop accepting new connections.
  *   4. accepting_work_ is set to false on all Workers. This prevents worker
  *      threads from taking new work.
  *   5. ShardedStorageThreadPool's shutdown() method is called. All queued tasks
@@ -66,6 +66,7 @@ void shutdown_server(
         listeners_per_priority,
     std::unique_ptr<Listener>& gossip_listener,
     std::unique_ptr<Listener>& ssl_connection_listener,
+    std::unique_ptr<Listener>& local_connection_listener,
     std::unique_ptr<Listener>& server_to_server_listener,
     std::unique_ptr<folly::EventBaseThread>& connection_listener_loop,
     std::unique_ptr<folly::EventBaseThread>& gossip_listener_loop,
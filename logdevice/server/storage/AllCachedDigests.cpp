@@ -46,7 +46,7 @@ std::pair<CachedDigest*, bool> ClientDigests::insert(
     shard_index_t shard,
     read_stream_id_t rid,
     lsn_t start_lsn,
-    std::unique_ptr<const EpochRecordCache::Snapshot> epoch_snapshot) {
+    std::shared_ptr<const EpochRecordCache::Snapshot> epoch_snapshot) {
   auto result = digests_map_.insert(std::make_pair(rid, nullptr));
   if (!result.second) {
     // item already there
@@ -82,20 +82,69 @@ void ClientDigests::registerDisconnectCallback(
 //////   AllCachedDigests  ///////
 
 AllCachedDigests::AllCachedDigests(size_t max_active_digests,
-                                   size_t max_kbytes_queued_per_client)
+                                   size_t max_kbytes_queued_per_client,
+                                   std::chrono::milliseconds snapshot_reuse_ttl)
     : max_active_cached_digests_(max_active_digests),
-      max_kbytes_queued_per_client_(max_kbytes_queued_per_client) {
+      max_kbytes_queued_per_client_(max_kbytes_queued_per_client),
+      snapshot_reuse_ttl_(snapshot_reuse_ttl) {
   ld_check(max_active_cached_digests_ > 0);
   ld_check(max_kbytes_queued_per_client_ > 0);
 }
 
+std::shared_ptr<const EpochRecordCache::Snapshot>
+AllCachedDigests::getEpochSnapshot(const EpochRecordCache& epoch_cache,
+                                   bool enable_offset_map) {
+  if (snapshot_reuse_ttl_ <= std::chrono::milliseconds::zero()) {
+    return epoch_cache.createSerializableSnapshot(enable_offset_map);
+  }
+
+  const auto now = std::chrono::steady_clock::now();
+  expireSnapshots(now);
+
+  const SnapshotKey key{epoch_cache.getLogId(),
+                        epoch_cache.getShardIndex(),
+                        epoch_cache.getEpoch()};
+  // an odd version means a writer is changing the cache right now
+  const uint64_t version = epoch_cache.getVersion();
+  auto it = snapshots_.find(key);
+  if (it != snapshots_.end() && it->second.version == version &&
+      it->second.enable_offset_map == enable_offset_map) {
+    WORKER_STAT_INCR(record_cache_digest_snapshot_reused);
+    return it->second.snapshot;
+  }
+
+  std::shared_ptr<const EpochRecordCache::Snapshot> snapshot =
+      epoch_cache.createSerializableSnapshot(enable_offset_map);
+  if (version % 2 == 0 && epoch_cache.getVersion() == version) {
+    // the cache did not change while the snapshot was being taken
+    snapshots_[key] =
+        ReusableSnapshot{snapshot, version, enable_offset_map, now};
+    snapshot_expiry_.emplace_back(now, key);
+  }
+  return snapshot;
+}
+
+void AllCachedDigests::expireSnapshots(
+    std::chrono::steady_clock::time_point now) {
+  while (!snapshot_expiry_.empty() &&
+         snapshot_expiry_.front().first + snapshot_reuse_ttl_ <= now) {
+    auto it = snapshots_.find(snapshot_expiry_.front().second);
+    // the snapshot may have been replaced by a newer one since
+    if (it != snapshots_.end() &&
+        it->second.created == snapshot_expiry_.front().first) {
+      snapshots_.erase(it);
+    }
+    snapshot_expiry_.pop_front();
+  }
+}
+
 Status AllCachedDigests::startDigest(
     logid_t log_id,
     shard_index_t shard,
     read_stream_id_t rid,
     ClientID client_id,
     lsn_t start_lsn,
-    std::unique_ptr<const EpochRecordCache::Snapshot> epoch_snapshot) {
+    std::shared_ptr<const EpochRecordCache::Snapshot> epoch_snapshot) {
   ClientDigests* client_digests = insertOrGet(client_id);
   ld_check(client_digests != nullptr);
 
@@ -187,6 +236,8 @@ void AllCachedDigests::clear() {
   }
   clients_.clear();
   num_active_digests_ = 0;
+  snapshots_.clear();
+  snapshot_expiry_.clear();
 }
 
 bool AllCachedDigests::canStartDigest() const {
@@ -280,7 +331,7 @@ std::unique_ptr<CachedDigest> AllCachedDigests::createCachedDigest(
     read_stream_id_t rid,
     ClientID client_id,
     lsn_t start_lsn,
-    std::unique_ptr<const EpochRecordCache::Snapshot> epoch_snapshot,
+    std::shared_ptr<const EpochRecordCache::Snapshot> epoch_snapshot,
     ClientDigests* client_digests) {
   return std::make_unique<CachedDigest>(log_id,
                                         shard,
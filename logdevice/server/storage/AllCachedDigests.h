@@ -7,7 +7,11 @@
  */
 #pragma once
 
+#include <chrono>
+#include <deque>
+#include <map>
 #include <queue>
+#include <tuple>
 #include <unordered_map>
 
 #include "logdevice/common/SocketCallback.h"
@@ -47,7 +51,7 @@ class ClientDigests {
          shard_index_t shard,
          read_stream_id_t rid,
          lsn_t start_lsn,
-         std::unique_ptr<const EpochRecordCache::Snapshot> epoch_snapshot);
+         std::shared_ptr<const EpochRecordCache::Snapshot> epoch_snapshot);
 
   /**
    * Get the CachedDigest instance by read stream id, nullptr if the read stream
@@ -114,9 +118,15 @@ class AllCachedDigests {
    *
    * @param max_bytes_queued_per_client_kb    maximum number of record bytes
    *                                          enqueued for each client
+   *
+   * @param snapshot_reuse_ttl     how long epoch cache snapshots are kept for
+   *                               reuse by later digests of the same epoch,
+   *                               see getEpochSnapshot(). 0 disables reuse.
    */
   AllCachedDigests(size_t max_active_digests,
-                   size_t max_bytes_queued_per_client_kb);
+                   size_t max_bytes_queued_per_client_kb,
+                   std::chrono::milliseconds snapshot_reuse_ttl =
+                       std::chrono::milliseconds::zero());
 
   virtual ~AllCachedDigests() {}
 
@@ -146,7 +156,18 @@ class AllCachedDigests {
               read_stream_id_t rid,
               ClientID client_id,
               lsn_t start_lsn,
-              std::unique_ptr<const EpochRecordCache::Snapshot> epoch_snapshot);
+              std::shared_ptr<const EpochRecordCache::Snapshot> epoch_snapshot);
+
+  /**
+   * Take a FULL snapshot of @param epoch_cache for a digest. When recovery
+   * of an epoch is restarted or retried by another sequencer, the same
+   * digest is usually requested again shortly after. If a snapshot taken for
+   * an earlier digest of the epoch is younger than snapshot_reuse_ttl and the
+   * cache has not changed since, that snapshot is returned instead of
+   * copying the cache again.
+   */
+  std::shared_ptr<const EpochRecordCache::Snapshot>
+  getEpochSnapshot(const EpochRecordCache& epoch_cache, bool enable_offset_map);
 
   /**
    * Called when a CachedDigest instance is destroyed. @param active is true
@@ -192,7 +213,7 @@ class AllCachedDigests {
       read_stream_id_t rid,
       ClientID client_id,
       lsn_t start_lsn,
-      std::unique_ptr<const EpochRecordCache::Snapshot> epoch_snapshot,
+      std::shared_ptr<const EpochRecordCache::Snapshot> epoch_snapshot,
       ClientDigests* client_digests);
 
   // used in tests
@@ -202,6 +223,10 @@ class AllCachedDigests {
     return queue_.size();
   }
 
+  size_t numReusableSnapshots() const {
+    return snapshots_.size();
+  }
+
   std::unique_ptr<Timer>& getRescheduleTimer() {
     return reschedule_timer_;
   }
@@ -231,6 +256,25 @@ class AllCachedDigests {
   // waiting to be started
   std::queue<std::pair<ClientID, read_stream_id_t>> queue_;
 
+  const std::chrono::milliseconds snapshot_reuse_ttl_;
+
+  // epoch cache snapshots kept for reuse by getEpochSnapshot()
+  struct ReusableSnapshot {
+    std::shared_ptr<const EpochRecordCache::Snapshot> snapshot;
+    // EpochRecordCache::getVersion() at the time the snapshot was taken
+    uint64_t version;
+    bool enable_offset_map;
+    std::chrono::steady_clock::time_point created;
+  };
+  using SnapshotKey = std::tuple<logid_t, shard_index_t, epoch_t>;
+  std::map<SnapshotKey, ReusableSnapshot> snapshots_;
+  // keys of snapshots_ in order of creation, for expiring them
+  std::deque<std::pair<std::chrono::steady_clock::time_point, SnapshotKey>>
+      snapshot_expiry_;
+
+  // drop reusable snapshots older than snapshot_reuse_ttl_
+  void expireSnapshots(std::chrono::steady_clock::time_point now);
+
   // To support yielding/re-entrance in scheduleMoreDigests()
   bool scheduling_{false};
   std::unique_ptr<Timer> reschedule_timer_;
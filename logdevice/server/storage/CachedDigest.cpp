@@ -32,7 +32,7 @@ CachedDigest::CachedDigest(logid_t log_id,
                            read_stream_id_t stream_id,
                            ClientID client_id,
                            lsn_t start_lsn,
-                           std::unique_ptr<const Snapshot> snapshot,
+                           std::shared_ptr<const Snapshot> snapshot,
                            ClientDigests* client_digests,
                            AllCachedDigests* all_digests)
     : sender_(std::make_unique<SenderProxy>()),
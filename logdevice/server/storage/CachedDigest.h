@@ -54,7 +54,9 @@ class CachedDigest {
    *  constructed, and will only become active when start() is called.
    *
    *  @param epoch_snapshot  Snapshot of epoch record cache, must be a FULL
-   *                         snapshot taken after digest request is received.
+   *                         snapshot taken after digest request is received,
+   *                         or one with the same content reused from an
+   *                         earlier digest of the epoch.
    *                         nullptr if the digesting epoch is _empty_
    *  @param client_digests  parent object that manages all CachedDigest_s for a
    *                         client connection. can be nullptr in tests
@@ -65,7 +67,7 @@ class CachedDigest {
                read_stream_id_t stream_id,
                ClientID client_id,
                lsn_t start_lsn,
-               std::unique_ptr<const EpochRecordCache::Snapshot> epoch_snapshot,
+               std::shared_ptr<const EpochRecordCache::Snapshot> epoch_snapshot,
                ClientDigests* client_digests,
                AllCachedDigests* all_digests);
 
@@ -134,7 +136,7 @@ class CachedDigest {
   const bool epoch_empty_;
 
   // cache that contains unclean records of the epoch
-  std::unique_ptr<const EpochRecordCache::Snapshot> epoch_snapshot_;
+  std::shared_ptr<const EpochRecordCache::Snapshot> epoch_snapshot_;
   // iterator of the epoch cache snapshot
   std::unique_ptr<EpochRecordCache::Snapshot::ConstIterator> snapshot_iterator_;
 
@@ -108,7 +108,10 @@ Message::Disposition PurgeCoordinator::onReceived(CLEAN_Message* msg,
 
   ServerProcessor* const processor = w->processor_;
 
-  const shard_size_t n_shards = w->getNodesConfiguration()->getNumShards();
+  shard_size_t n_shards;
+  w->withNodesConfiguration([&](const auto& nodes_configuration) {
+    n_shards = nodes_configuration.getNumShards();
+  });
   shard_index_t shard = msg->header_.shard;
   if (shard >= n_shards) {
     RATELIMIT_ERROR(std::chrono::seconds(10),
@@ -198,7 +201,10 @@ Message::Disposition PurgeCoordinator::onReceived(RELEASE_Message* msg,
 
   const RELEASE_Header& header = msg->getHeader();
 
-  const shard_size_t n_shards = w->getNodesConfiguration()->getNumShards();
+  shard_size_t n_shards;
+  w->withNodesConfiguration([&](const auto& nodes_configuration) {
+    n_shards = nodes_configuration.getNumShards();
+  });
   shard_index_t shard = header.shard;
   ld_check(shard != -1);
 
@@ -289,7 +295,10 @@ Message::Disposition PurgeCoordinator::onReceived(RELEASE_Message* msg,
 
   auto peer_nid = peer_idx ? NodeID(*peer_idx) : NodeID();
   checked_downcast<PurgeCoordinator&>(*log_state->purge_coordinator_)
-      .onReleaseMessage(header.rid.lsn(), peer_nid, header.release_type);
+      .onReleaseMessage(header.rid.lsn(),
+                        peer_nid,
+                        header.release_type,
+                        std::move(msg->epoch_offsets_));
 
   return Message::Disposition::NORMAL;
 }
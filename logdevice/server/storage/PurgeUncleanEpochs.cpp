@@ -727,33 +727,6 @@ PurgeUncleanEpochs::~PurgeUncleanEpochs() {}
 // Implementation of PurgeWriteLastCleanTask
 //
 
-void PurgeWriteLastCleanTask::execute() {
-  LogStorageStateMap& state_map =
-      storageThreadPool_->getProcessor().getLogStorageStateMap();
-
-  LogStorageState* log_state =
-      state_map.find(log_id_, storageThreadPool_->getShardIdx());
-  ld_check(log_state != nullptr);
-  executeImpl(storageThreadPool_->getLocalLogStore(), log_state);
-}
-
-void PurgeWriteLastCleanTask::executeImpl(LocalLogStore& store,
-                                          LogStorageState* /*log_state*/) {
-  LocalLogStore::WriteOptions options;
-  int rv = store.writeLogMetadata(log_id_, LastCleanMetadata(epoch_), options);
-  status_ = rv == 0 ? E::OK : E::FAILED;
-
-  // Note that here we no longer notify record cache on the local LCE
-  // advancement for eviction purpose. Instead we would like to defer it
-  // once we process the release we received. The reason is that recovery
-  // may get restarted while in the cleaning phase and some of the CLEANs
-  // are already processed by storage nodes. If we perform eviction as soon as
-  // local LCE advances. The next recovery instance may suffer from a record
-  // cache miss for getting the epoch. On the other hand, it is safe to defer
-  // the eviction until RELEASEs are received because it is certain that epoch
-  // recovery has successfully finished for the given epoch
-}
-
 void PurgeWriteLastCleanTask::onDone() {
   PurgeUncleanEpochs* driver = driver_.get();
   if (driver != nullptr) {
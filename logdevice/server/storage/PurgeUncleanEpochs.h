@@ -18,6 +18,7 @@
 
 #include "logdevice/common/AdminCommandTable-fwd.h"
 #include "logdevice/common/IntrusiveUnorderedMap.h"
+#include "logdevice/common/Metadata.h"
 #include "logdevice/common/NodeSetFinder.h"
 #include "logdevice/common/ResourceBudget.h"
 #include "logdevice/common/Seal.h"
@@ -31,6 +32,7 @@
 #include "logdevice/include/Record.h"
 #include "logdevice/server/storage/SealStorageTask.h"
 #include "logdevice/server/storage_tasks/StorageTask.h"
+#include "logdevice/server/storage_tasks/WriteStorageTask.h"
 
 namespace facebook { namespace logdevice {
 
@@ -325,33 +327,61 @@ class PurgeUncleanEpochs : public IntrusiveUnorderedMapHook {
   friend class MockPurgeUncleanEpochs;
 };
 
-class PurgeWriteLastCleanTask : public StorageTask {
+/**
+ * Persists the new last clean epoch of a log. This is a WriteStorageTask so
+ * that, when many logs finish purging at about the same time (e.g., after a
+ * cluster-wide sequencer restart), the storage thread groups their
+ * LastCleanMetadata writes into one write batch and one sync instead of
+ * issuing a synchronous write for each log.
+ *
+ * Note that the record cache is not notified of the local LCE advancement
+ * here. Eviction is deferred until the release is processed: recovery may
+ * get restarted while in the cleaning phase after some CLEANs were already
+ * processed, and evicting as soon as the local LCE advances would make the
+ * next recovery instance miss the record cache for the epoch. It is safe to
+ * evict once RELEASEs are received because epoch recovery has then certainly
+ * finished for the epoch.
+ */
+class PurgeWriteLastCleanTask : public WriteStorageTask {
  public:
   PurgeWriteLastCleanTask(logid_t log_id,
                           epoch_t epoch,
                           WeakRef<PurgeUncleanEpochs> driver)
-      : StorageTask(StorageTask::Type::PURGE_WRITE_LAST_CLEAN),
-        log_id_(log_id),
-        epoch_(epoch),
+      : WriteStorageTask(StorageTask::Type::PURGE_WRITE_LAST_CLEAN),
+        metadata_(epoch),
+        write_op_(log_id, &metadata_, Durability::SYNC_WRITE),
         driver_(std::move(driver)) {}
 
-  void execute() override;
-  // @param log_state may be nullptr in tests
-  void executeImpl(LocalLogStore& store, LogStorageState* log_state);
-  Durability durability() const override {
-    return Durability::SYNC_WRITE;
-  }
   void onDone() override;
   void onDropped() override;
   StorageTaskPriority getPriority() const override {
     return StorageTaskPriority::HIGH;
   }
 
+  size_t getNumWriteOps() const override {
+    return 1;
+  }
+
+  size_t getWriteOps(const WriteOp** write_ops,
+                     size_t write_ops_len) const override {
+    if (write_ops_len > 0) {
+      write_ops[0] = &write_op_;
+      return 1;
+    } else {
+      return 0;
+    }
+  }
+
+  bool allowIfStoreIsNotAcceptingWrites(Status status) const override {
+    // Advancing the last clean epoch unblocks releases, allow it when running
+    // out of space.
+    return status == E::NOSPC;
+  }
+
  private:
-  const logid_t log_id_;
-  epoch_t epoch_;
+  LastCleanMetadata metadata_;
+  PutLogMetadataWriteOp write_op_;
   WeakRef<PurgeUncleanEpochs> driver_;
-  Status status_;
 };
 
 // Wrapper instead of typedef to allow forward-declaring in Worker.h
@@ -0,0 +1,154 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/server/storage/TrimMetadataBatcher.h"
+
+#include <memory>
+#include <utility>
+
+#include "logdevice/common/Metadata.h"
+#include "logdevice/common/Sender.h"
+#include "logdevice/common/protocol/TRIMMED_Message.h"
+#include "logdevice/common/stats/Stats.h"
+#include "logdevice/server/ServerProcessor.h"
+#include "logdevice/server/ServerWorker.h"
+#include "logdevice/server/locallogstore/LocalLogStore.h"
+#include "logdevice/server/read_path/LogStorageStateMap.h"
+#include "logdevice/server/storage_tasks/PerWorkerStorageTaskQueue.h"
+#include "logdevice/server/storage_tasks/StorageTask.h"
+#include "logdevice/server/storage_tasks/StorageThreadPool.h"
+
+namespace facebook { namespace logdevice {
+
+namespace {
+
+void send_reply(const Address& to,
+                request_id_t client_rqid,
+                Status status,
+                shard_index_t shard) {
+  TRIMMED_Header header = {client_rqid, status, shard};
+  Worker::onThisThread()->sender().sendMessage(
+      std::make_unique<TRIMMED_Message>(header), to);
+}
+
+// A task to write trim points to the local log store
+class WriteTrimMetadataTask : public StorageTask {
+ public:
+  explicit WriteTrimMetadataTask(std::vector<TrimMetadataBatcher::Trim> trims)
+      : StorageTask(StorageTask::Type::WRITE_TRIM_METADATA),
+        trims_(std::move(trims)),
+        statuses_(trims_.size(), E::FAILED) {}
+
+  Principal getPrincipal() const override {
+    return Principal::METADATA;
+  }
+
+  void execute() override {
+    LocalLogStore& store = storageThreadPool_->getLocalLogStore();
+    LogStorageStateMap& map =
+        storageThreadPool_->getProcessor().getLogStorageStateMap();
+
+    std::vector<TrimMetadata> metadata;
+    metadata.reserve(trims_.size());
+    std::vector<std::pair<logid_t, ComparableLogMetadata*>> updates;
+    for (const auto& trim : trims_) {
+      metadata.push_back(TrimMetadata{trim.trim_point});
+      updates.emplace_back(trim.log_id, &metadata.back());
+    }
+    std::vector<Status> statuses;
+    LocalLogStore::WriteOptions options;
+    store.updateLogMetadataBatch(updates, statuses, options);
+    ld_check(statuses.size() == trims_.size());
+
+    for (size_t i = 0; i < trims_.size(); ++i) {
+      if (statuses[i] != E::OK) {
+        // if local log store already contained a trim point with a higher
+        // LSN, report it as a success to the client
+        statuses_[i] = statuses[i] == E::UPTODATE ? E::OK : E::FAILED;
+        continue;
+      }
+
+      LogStorageState* log_state =
+          map.insertOrGet(trims_[i].log_id, storageThreadPool_->getShardIdx());
+      if (log_state == nullptr) {
+        statuses_[i] = E::FAILED;
+        continue;
+      }
+
+      log_state->updateTrimPoint(trims_[i].trim_point);
+      statuses_[i] = E::OK;
+      durability_ = Durability::SYNC_WRITE;
+    }
+  }
+
+  Durability durability() const override {
+    return durability_;
+  }
+
+  void onDone() override {
+    for (size_t i = 0; i < trims_.size(); ++i) {
+      send_reply(trims_[i].reply_to,
+                 trims_[i].client_rqid,
+                 statuses_[i],
+                 storageThreadPool_->getShardIdx());
+    }
+  }
+
+  void onDropped() override {
+    for (const auto& trim : trims_) {
+      send_reply(trim.reply_to,
+                 trim.client_rqid,
+                 E::FAILED,
+                 storageThreadPool_->getShardIdx());
+    }
+  }
+
+ private:
+  std::vector<TrimMetadataBatcher::Trim> trims_;
+  std::vector<Status> statuses_;
+  Durability durability_ = Durability::INVALID;
+};
+
+} // namespace
+
+TrimMetadataBatcher::TrimMetadataBatcher() : timer_([this] { flushAll(); }) {}
+
+void TrimMetadataBatcher::add(shard_index_t shard_idx, Trim trim) {
+  auto& pending = pending_[shard_idx];
+  pending.push_back(std::move(trim));
+  if (pending.size() >= MAX_TRIMS_PER_TASK) {
+    flush(shard_idx);
+  } else if (!timer_.isActive()) {
+    timer_.activate(std::chrono::microseconds(0));
+  }
+}
+
+void TrimMetadataBatcher::flushAll() {
+  timer_.cancel();
+  while (!pending_.empty()) {
+    flush(pending_.begin()->first);
+  }
+}
+
+void TrimMetadataBatcher::flush(shard_index_t shard_idx) {
+  auto it = pending_.find(shard_idx);
+  if (it == pending_.end()) {
+    return;
+  }
+  std::vector<Trim> trims = std::move(it->second);
+  pending_.erase(it);
+
+  ServerWorker* worker = ServerWorker::onThisThread();
+  if (trims.size() > 1) {
+    WORKER_STAT_INCR(trim_metadata_batches);
+    WORKER_STAT_ADD(trim_metadata_batched, trims.size());
+  }
+  auto task = std::make_unique<WriteTrimMetadataTask>(std::move(trims));
+  worker->getStorageTaskQueueForShard(shard_idx)->putTask(std::move(task));
+}
+
+}} // namespace facebook::logdevice
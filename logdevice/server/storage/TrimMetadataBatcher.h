@@ -0,0 +1,73 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include "logdevice/common/Address.h"
+#include "logdevice/common/Timer.h"
+#include "logdevice/common/types_internal.h"
+#include "logdevice/include/types.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file Coalesces the trim points that TRIM messages received by a worker ask
+ *       to store on the same shard into one storage task, which writes them
+ *       with a single LocalLogStore::updateLogMetadataBatch() call. When a
+ *       client trims many logs at once, their TRIMs arrive in TRIMS_BATCH
+ *       messages and are dispatched back to back, so all of them end up in
+ *       the same task rather than in one task and one write each.
+ *
+ *       Trims wait for a zero-delay timer, i.e. until the worker is done with
+ *       the events at hand, or until MAX_TRIMS_PER_TASK of them are queued
+ *       for the shard. Each sender gets its own TRIMMED reply once the task
+ *       is done.
+ *
+ *       One instance per ServerWorker, see ServerWorker::trimMetadataBatcher().
+ */
+
+class TrimMetadataBatcher {
+ public:
+  // A trim point to store, and where to reply.
+  struct Trim {
+    logid_t log_id;
+    lsn_t trim_point;
+    Address reply_to;
+    request_id_t client_rqid;
+  };
+
+  // Flush a shard's trims into a storage task once this many are queued.
+  static constexpr size_t MAX_TRIMS_PER_TASK = 10000;
+
+  TrimMetadataBatcher();
+
+  TrimMetadataBatcher(const TrimMetadataBatcher&) = delete;
+  TrimMetadataBatcher& operator=(const TrimMetadataBatcher&) = delete;
+
+  /**
+   * Queues `trim` to be written to shard `shard_idx`.
+   */
+  void add(shard_index_t shard_idx, Trim trim);
+
+  /**
+   * Hands everything queued to the storage threads.
+   */
+  void flushAll();
+
+ private:
+  void flush(shard_index_t shard_idx);
+
+  std::unordered_map<shard_index_t, std::vector<Trim>> pending_;
+
+  // Zero-delay timer activated when the first trim is queued.
+  Timer timer_;
+};
+
+}} // namespace facebook::logdevice
@@ -23,6 +23,7 @@
 namespace facebook { namespace logdevice {
 
 void ExecStorageThread::run() {
+  pool_->setCpuAffinityOfThisThread();
   pool_->getLocalLogStore().onStorageThreadStarted();
 
   auto settings = pool_->getSettings().get();
@@ -54,9 +55,15 @@ void ExecStorageThread::run() {
           queueing_usec);
     }
 
+    if (task->latency_trace_) {
+      task->latency_trace_->mark("queue");
+    }
     auto execution_start_time = std::chrono::steady_clock::now();
     task->execute();
     auto execution_end_time = std::chrono::steady_clock::now();
+    if (task->latency_trace_) {
+      task->latency_trace_->mark("execute");
+    }
     auto usec = SystemTimestamp(execution_end_time - execution_start_time)
                     .toMicroseconds()
                     .count();
@@ -100,11 +107,18 @@ void ExecStorageThread::run() {
        task->bytesProcessed(0);
     */
 
+    // The task may have been taken from another shard's queue.  Its pool's
+    // syncing thread is the one that must sync it.
+    StorageThreadPool* task_pool = task->getStorageThreadPool();
+    ld_check(task_pool);
     if (task->durability() == Durability::SYNC_WRITE) {
-      pool_->enqueueForSync(std::move(task));
+      task_pool->enqueueForSync(std::move(task));
     } else {
       StorageTaskResponse::sendBackToWorker(std::move(task));
     }
+    if (task_pool != pool_) {
+      task_pool->onStolenTaskDone();
+    }
   }
   ld_info("ExecStorageThread exiting");
 }
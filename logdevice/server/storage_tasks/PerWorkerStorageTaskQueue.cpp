@@ -100,6 +100,9 @@ void PerWorkerStorageTaskQueue::putTask(std::unique_ptr<StorageTask>&& task) {
   task->reply_worker_idx_ = Worker::onThisThread()->idx_;
   task->stats_ = Worker::stats();
   task->enqueue_time_ = std::chrono::steady_clock::now();
+  task->latency_trace_ =
+      LatencyTrace::maybeStart(storageTaskTypeNames[task->getType()].c_str(),
+                               Worker::settings().latency_trace_sample_rate);
 
   StorageThreadPool* pool =
       &ServerWorker::onThisThread()
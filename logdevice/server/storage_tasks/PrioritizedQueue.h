@@ -9,6 +9,7 @@
 
 #include <array>
 #include <atomic>
+#include <chrono>
 #include <memory>
 #include <mutex>
 #include <shared_mutex>
@@ -71,6 +72,15 @@ class PrioritizedQueue {
     return true;
   }
 
+  // same as blockingRead(), but gives up after `timeout`
+  bool timedRead(T& out, std::chrono::milliseconds timeout) {
+    if (sem_.timedwait(timeout) != 0) {
+      return false;
+    }
+    readQueueGuaranteedNonEmpty(out);
+    return true;
+  }
+
   void readQueueGuaranteedNonEmpty(T& out) {
     std::shared_lock<folly::SharedMutex> l(introspection_mutex_);
 
@@ -0,0 +1,81 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/server/storage_tasks/ReadBatchStorageTask.h"
+
+#include <algorithm>
+
+#include <folly/Format.h>
+
+#include "logdevice/common/debug.h"
+#include "logdevice/common/stats/Stats.h"
+#include "logdevice/server/storage_tasks/StorageThreadPool.h"
+
+namespace facebook { namespace logdevice {
+
+ReadBatchStorageTask::ReadBatchStorageTask(
+    std::vector<std::unique_ptr<ReadStorageTask>> tasks)
+    : StorageTask(StorageTask::Type::READ_BATCH), tasks_(std::move(tasks)) {
+  ld_check(!tasks_.empty());
+  for (const auto& task : tasks_) {
+    ld_check(task);
+    ld_check(task->getThreadType() == getThreadType());
+    ld_check(task->getPriority() == getPriority());
+    ld_check(task->getPrincipal() == getPrincipal());
+  }
+  // Let the scheduler account for the batch as for all its members.
+  reqSize(tasks_.size());
+}
+
+void ReadBatchStorageTask::execute() {
+  // Read in key order of the local log store: logs are laid out one after
+  // another, and within a log records are sorted by LSN.
+  std::stable_sort(tasks_.begin(),
+                   tasks_.end(),
+                   [](const std::unique_ptr<ReadStorageTask>& a,
+                      const std::unique_ptr<ReadStorageTask>& b) {
+                     return std::make_pair(a->read_ctx_.logid_,
+                                           a->read_ctx_.read_ptr_.lsn) <
+                         std::make_pair(b->read_ctx_.logid_,
+                                        b->read_ctx_.read_ptr_.lsn);
+                   });
+
+  for (auto& task : tasks_) {
+    task->setStorageThreadPool(storageThreadPool_);
+    task->setStorageThread(storageThread_);
+    task->execution_start_time_ = std::chrono::steady_clock::now();
+    task->execute();
+    task->execution_end_time_ = std::chrono::steady_clock::now();
+  }
+
+  STAT_INCR(storageThreadPool_->stats(), read_storage_task_batches);
+  STAT_ADD(storageThreadPool_->stats(),
+           read_storage_tasks_batched,
+           tasks_.size());
+}
+
+void ReadBatchStorageTask::onDone() {
+  for (auto& task : tasks_) {
+    task->onDone();
+  }
+}
+
+void ReadBatchStorageTask::onDropped() {
+  for (auto& task : tasks_) {
+    task->onDropped();
+  }
+}
+
+void ReadBatchStorageTask::getDebugInfoDetailed(
+    StorageTaskDebugInfo& info) const {
+  const ReadStorageTask& first = *tasks_.front();
+  info.log_id = first.read_ctx_.logid_;
+  info.lsn = first.read_ctx_.read_ptr_.lsn;
+  info.extra_info = folly::sformat("Batch of {} read tasks", tasks_.size());
+}
+
+}} // namespace facebook::logdevice
@@ -0,0 +1,75 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "logdevice/server/storage_tasks/ReadStorageTask.h"
+#include "logdevice/server/storage_tasks/StorageTask.h"
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file
+ *
+ * A group of ReadStorageTasks for the same shard that are executed together
+ * by a single storage thread.
+ *
+ * When many read streams need to catch up at the same time (e.g. thousands
+ * of tailing readers falling slightly behind after a memtable flush),
+ * AllServerReadStreams would otherwise issue one tiny ReadStorageTask per
+ * stream.  Each of them takes a slot in the storage thread queue, wakes up a
+ * storage thread and goes through its own response on the way back.
+ *
+ * Instead, AllServerReadStreams collects the tasks it sends during one event
+ * loop iteration and wraps them into ReadBatchStorageTasks (see
+ * Settings::read_storage_task_batch_size).  On the storage thread the batch
+ * executes the individual tasks sorted by (log id, read pointer), so that
+ * consecutive reads touch neighbouring keys of the local log store.  Each
+ * individual task keeps its own read context, byte budget and memory token.
+ * Back on the worker thread, the individual tasks' onDone() or onDropped()
+ * callbacks are called as if they were sent on their own.
+ *
+ * All tasks in a batch must have the same thread type, priority and
+ * principal, so that the batch is scheduled exactly like its members.
+ */
+
+class ReadBatchStorageTask : public StorageTask {
+ public:
+  explicit ReadBatchStorageTask(
+      std::vector<std::unique_ptr<ReadStorageTask>> tasks);
+
+  void execute() override;
+
+  void onDone() override;
+
+  void onDropped() override;
+
+  ThreadType getThreadType() const override {
+    return tasks_.front()->getThreadType();
+  }
+
+  StorageTaskPriority getPriority() const override {
+    return tasks_.front()->getPriority();
+  }
+
+  Principal getPrincipal() const override {
+    return tasks_.front()->getPrincipal();
+  }
+
+  size_t size() const {
+    return tasks_.size();
+  }
+
+ private:
+  void getDebugInfoDetailed(StorageTaskDebugInfo&) const override;
+
+  std::vector<std::unique_ptr<ReadStorageTask>> tasks_;
+};
+}} // namespace facebook::logdevice
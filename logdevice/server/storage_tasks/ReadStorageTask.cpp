@@ -34,6 +34,8 @@ namespace facebook { namespace logdevice {
  */
 class StorageThreadCallback : public LocalLogStoreReader::Callback {
  public:
+  explicit StorageThreadCallback(bool zero_copy) : zero_copy_(zero_copy) {}
+
   int processRecord(const RawRecord& raw_record) override;
   ReadStorageTask::RecordContainer&& releaseRecords() {
     return std::move(records_);
@@ -44,6 +46,9 @@ class StorageThreadCallback : public LocalLogStoreReader::Callback {
   }
 
  private:
+  // If true, copy records into IOBufs that RECORD messages can share.
+  // See Settings::read_storage_task_zero_copy.
+  const bool zero_copy_;
   size_t total_bytes_{0}; // Used for stats.
   ReadStorageTask::RecordContainer records_;
 };
@@ -140,13 +145,13 @@ void ReadStorageTask::execute() {
 
     ld_check(owned_iterator_);
 
-    StorageThreadCallback callback;
-    Status status =
-        LocalLogStoreReader::read(*owned_iterator_,
-                                  callback,
-                                  &read_ctx_,
-                                  storageThreadPool_->stats(),
-                                  *storageThreadPool_->getSettings().get());
+    auto settings = storageThreadPool_->getSettings().get();
+    StorageThreadCallback callback(settings->read_storage_task_zero_copy);
+    Status status = LocalLogStoreReader::read(*owned_iterator_,
+                                              callback,
+                                              &read_ctx_,
+                                              storageThreadPool_->stats(),
+                                              *settings);
 
     // The `read()` call populated `callback` with some records.  Now move them
     // into the ReadStorageTask instance, which will get passed back to the
@@ -229,12 +234,23 @@ int StorageThreadCallback::processRecord(const RawRecord& record) {
   // data out of the local log store into a malloc'd buffer, since records
   // will only get passed to the messaging layer at some later time (when the
   // worker thread gets around to processing the ReadStorageTask result).
+  total_bytes_ += record.blob.size;
+  if (zero_copy_) {
+    // Copy into an IOBuf, so that the payload can later be attached to the
+    // RECORD message without another copy.
+    records_.emplace_back(
+        record.lsn,
+        folly::IOBuf(
+            folly::IOBuf::COPY_BUFFER, record.blob.data, record.blob.size),
+        record.from_under_replicated_region);
+    return 0;
+  }
+
   void* blob_copy = malloc(record.blob.size);
   if (blob_copy == nullptr) {
     throw std::bad_alloc();
   }
   memcpy(blob_copy, record.blob.data, record.blob.size);
-  total_bytes_ += record.blob.size;
 
   records_.emplace_back( // creating a RawRecord
       record.lsn,
@@ -7,6 +7,12 @@
  */
 #include "logdevice/server/storage_tasks/RecordCacheRepopulationTask.h"
 
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <utility>
+
 #include "logdevice/common/Processor.h"
 #include "logdevice/common/Worker.h"
 #include "logdevice/common/debug.h"
@@ -56,19 +62,37 @@ void RecordCacheRepopulationTask::execute() {
       storageThreadPool_->getProcessor().settings()->record_cache_max_size /
       sharded_store->numShards();
 
+  const size_t num_threads =
+      storageThreadPool_->getProcessor()
+          .settings()
+          ->record_cache_repopulation_threads;
+
+  // With more than one thread, blobs are copied out here and deserialized
+  // once they have all been read.
+  std::vector<std::pair<logid_t, std::string>> blobs;
+  size_t bytes_read = 0;
+
   LocalLogStore::LogSnapshotBlobCallback repopulate = [&](logid_t log_id,
                                                           Slice data) {
     if (bytes_limit_per_shard > 0 &&
-        repopulated_bytes + data.size > bytes_limit_per_shard) {
+        bytes_read + data.size > bytes_limit_per_shard) {
       ld_error("Repopulating saved snapshot of record cache on shard %d "
                "reached the byte limit of %lu bytes per-shard. Already "
                "populated %lu bytes. Stop populating record caches on "
                "this shard.",
                shard_idx_,
                bytes_limit_per_shard,
-               repopulated_bytes);
+               bytes_read);
       return -1;
     }
+    bytes_read += data.size;
+
+    if (num_threads > 1) {
+      blobs.emplace_back(
+          log_id,
+          std::string(reinterpret_cast<const char*>(data.data), data.size));
+      return 0;
+    }
 
     int rv = log_storage_state_map.repopulateRecordCacheFromLinearBuffer(
         log_id,
@@ -84,6 +108,40 @@ void RecordCacheRepopulationTask::execute() {
 
   int rv = shard.readAllLogSnapshotBlobs(
       LocalLogStore::LogSnapshotBlobType::RECORD_CACHE, repopulate);
+
+  if (!blobs.empty()) {
+    // Logs are independent, split them among the threads.
+    std::atomic<size_t> next_blob{0};
+    std::atomic<size_t> caches{0};
+    std::atomic<size_t> bytes{0};
+    std::atomic<bool> failed{false};
+    auto repopulate_blobs = [&] {
+      for (size_t i = next_blob++; i < blobs.size(); i = next_blob++) {
+        const std::string& data = blobs[i].second;
+        if (log_storage_state_map.repopulateRecordCacheFromLinearBuffer(
+                blobs[i].first, shard_idx_, data.data(), data.size()) == 0) {
+          ++caches;
+          bytes += data.size();
+        } else {
+          failed.store(true);
+        }
+      }
+    };
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < std::min(num_threads, blobs.size()); ++i) {
+      threads.emplace_back(repopulate_blobs);
+    }
+    repopulate_blobs();
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    repopulated_caches += caches.load();
+    repopulated_bytes += bytes.load();
+    if (failed.load()) {
+      rv = -1;
+    }
+  }
+
   if (rv == 0) {
     status_ = E::OK;
   } else {
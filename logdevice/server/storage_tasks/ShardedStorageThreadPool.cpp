@@ -35,5 +35,17 @@ ShardedStorageThreadPool::ShardedStorageThreadPool(
                                             stats,
                                             trace_logger));
   }
+
+  // Let idle threads of each shard help out the other shards, if enabled in
+  // settings.
+  for (auto& pool : pools_) {
+    std::vector<StorageThreadPool*> peers;
+    for (auto& other : pools_) {
+      if (other != pool) {
+        peers.push_back(other.get());
+      }
+    }
+    pool->setStealingPeers(std::move(peers));
+  }
 }
 }} // namespace facebook::logdevice
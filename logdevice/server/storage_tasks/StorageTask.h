@@ -12,6 +12,7 @@
 
 #include "logdevice/common/AdminCommandTable-fwd.h"
 #include "logdevice/common/DRRScheduler.h"
+#include "logdevice/common/LatencyTrace.h"
 #include "logdevice/common/StorageTask-enums.h"
 #include "logdevice/common/StorageTaskDebugInfo.h"
 #include "logdevice/common/Timestamp.h"
@@ -188,6 +189,10 @@ class StorageTask {
     storageThreadPool_ = ptr;
   }
 
+  StorageThreadPool* getStorageThreadPool() const {
+    return storageThreadPool_;
+  }
+
   /**
    * Called by StorageThread before execute() to provide tasks access to the
    * StorageThread instance processing the task.
@@ -253,6 +258,11 @@ class StorageTask {
   // Time this task execution was finished
   folly::Optional<std::chrono::steady_clock::time_point> execution_end_time_;
 
+  // Breakdown of this task's latency by stage, if it was sampled. Started by
+  // PerWorkerStorageTaskQueue::putTask(), finished once the worker has
+  // processed the reply.
+  std::unique_ptr<LatencyTrace> latency_trace_;
+
   // This field is useful for IO scheduling. The default size of the task is 1.
   // This implies request based scheduling as each request has the same size.
   // Different Principals get different requests/sec. The caller may update the
@@ -61,6 +61,10 @@ Request::Execution StorageTaskResponse::execute() {
   ServerWorker* worker = ServerWorker::onThisThread();
   worker->getStorageTaskQueueForShard(task_->reply_shard_idx_)->onReply(*task_);
 
+  if (task_->latency_trace_) {
+    task_->latency_trace_->mark("reply");
+  }
+
   if (task_->dropped_from_storage_thread_queue_) {
     WORKER_STORAGE_TASK_STAT_INCR(
         task_->getThreadType(), storage_tasks_dropped);
@@ -69,6 +73,11 @@ Request::Execution StorageTaskResponse::execute() {
     task_->onDone();
   }
 
+  if (task_->latency_trace_) {
+    task_->latency_trace_->mark("on_done");
+    task_->latency_trace_->finish();
+  }
+
   return Execution::COMPLETE;
 }
 
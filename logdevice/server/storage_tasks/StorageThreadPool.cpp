@@ -7,6 +7,9 @@
  */
 #include "logdevice/server/storage_tasks/StorageThreadPool.h"
 
+#include <chrono>
+#include <thread>
+
 #include <folly/Memory.h>
 
 #include "logdevice/common/AdminCommandTable.h"
@@ -14,6 +17,7 @@
 #include "logdevice/common/StorageTask-enums.h"
 #include "logdevice/common/debug.h"
 #include "logdevice/common/stats/Stats.h"
+#include "logdevice/common/util.h"
 #include "logdevice/server/RecordCachePersistence.h"
 #include "logdevice/server/locallogstore/LocalLogStore.h"
 #include "logdevice/server/storage_tasks/ExecStorageThread.h"
@@ -169,6 +173,14 @@ StorageThreadPool::StorageThreadPool(
   }
 }
 
+void StorageThreadPool::setCpuAffinityOfThisThread() {
+  auto settings = settings_.get();
+  const auto& cpus = settings->storage_thread_cpus;
+  if (!cpus.empty()) {
+    set_cpu_affinity_of_this_thread(cpus[shard_idx_ % cpus.size()]);
+  }
+}
+
 std::array<size_t, (size_t)ThreadType::MAX>
 StorageThreadPool::computeActualQueueSizes(size_t task_queue_size) const {
   std::array<size_t, (size_t)ThreadType::MAX> actual_queue_sizes;
@@ -280,6 +292,13 @@ void StorageThreadPool::join() {
   }
   exec_threads_.clear();
 
+  // Threads of other pools may be just finishing tasks they took from us and
+  // may still hand them to our syncing thread.
+  while (stolen_tasks_in_flight_.load() > 0) {
+    /* sleep override */
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
   // Now that all exec threads are done, also stop the syncing thread.  We do
   // it here not in shutDown() because exec threads shutting down may have
   // generated work for the syncing thread; if not, it will shut down quickly.
@@ -369,7 +388,25 @@ StorageThreadPool::blockingGetTask(StorageTask::ThreadType type) {
 
   while (true) {
     StorageTask* rawptr;
-    if (useDRR_ && (type == StorageTask::ThreadType::SLOW)) {
+    const bool drr = useDRR_ && (type == StorageTask::ThreadType::SLOW);
+    if (stealing_enabled_.load(std::memory_order_acquire) &&
+        !shutting_down_.load()) {
+      // Wait for our own tasks for a while, then see if another shard has
+      // more work than it can handle.
+      auto timeout = settings_->storage_threads_steal_idle_interval;
+      if (drr) {
+        rawptr = task_queue.drrQueue.timedDequeue(timeout);
+      } else if (!task_queue.queue.timedRead(rawptr, timeout)) {
+        rawptr = nullptr;
+      }
+      if (rawptr == nullptr) {
+        auto stolen = tryStealTask(type);
+        if (stolen) {
+          return stolen;
+        }
+        continue;
+      }
+    } else if (drr) {
       rawptr = task_queue.drrQueue.blockingDequeue();
     } else {
       task_queue.queue.blockingRead(rawptr);
@@ -399,6 +436,86 @@ StorageThreadPool::blockingGetTask(StorageTask::ThreadType type) {
   }
 }
 
+void StorageThreadPool::setStealingPeers(
+    std::vector<StorageThreadPool*> peers) {
+  ld_check(!stealing_enabled_.load());
+  if (!settings_->storage_threads_steal_tasks || peers.empty()) {
+    return;
+  }
+  stealing_peers_ = std::move(peers);
+  stealing_enabled_.store(true, std::memory_order_release);
+}
+
+ssize_t StorageThreadPool::queueSize(StorageTask::ThreadType type) {
+  type = getThreadType(type);
+  if (useDRR_ && (type == StorageTask::ThreadType::SLOW)) {
+    return taskQueues_[type].drrQueue.size();
+  }
+  return taskQueues_[type].queue.size();
+}
+
+std::unique_ptr<StorageTask>
+StorageThreadPool::tryGiveAwayTask(StorageTask::ThreadType type) {
+  if (shutting_down_.load()) {
+    return nullptr;
+  }
+  type = getThreadType(type);
+  auto& task_queue = taskQueues_[type];
+  const bool drr = useDRR_ && (type == StorageTask::ThreadType::SLOW);
+
+  StorageTask* rawptr = nullptr;
+  if (drr) {
+    rawptr = task_queue.drrQueue.dequeue();
+  } else if (!task_queue.queue.read(rawptr)) {
+    rawptr = nullptr;
+  }
+  if (rawptr == nullptr) {
+    return nullptr;
+  }
+
+  std::unique_ptr<StorageTask> task(rawptr);
+  if (task->getType() == StorageTask::Type::STOP_EXEC) {
+    // Shutdown started after the check above.  Stop tasks are meant for our
+    // own threads, put it back.
+    if (drr) {
+      uint64_t principal = static_cast<uint64_t>(task->getPrincipal());
+      task_queue.drrQueue.enqueue(task.release(), principal);
+    } else {
+      task_queue.queue.blockingWrite(task.release());
+    }
+    return nullptr;
+  }
+
+  STORAGE_TASK_STAT_DECR(stats_, type, num_storage_tasks);
+  ++stolen_tasks_in_flight_;
+  return task;
+}
+
+std::unique_ptr<StorageTask>
+StorageThreadPool::tryStealTask(StorageTask::ThreadType type) {
+  // Pick the peer with the longest queue.  Sizes are racy, so this is only a
+  // hint; the victim's idle threads may beat us to it.
+  StorageThreadPool* victim = nullptr;
+  ssize_t victim_queue_size = 0;
+  for (StorageThreadPool* peer : stealing_peers_) {
+    ssize_t size = peer->queueSize(type);
+    if (size > victim_queue_size) {
+      victim = peer;
+      victim_queue_size = size;
+    }
+  }
+  if (victim == nullptr) {
+    return nullptr;
+  }
+
+  auto task = victim->tryGiveAwayTask(type);
+  if (task) {
+    STAT_INCR(stats_, storage_tasks_stolen);
+    STORAGE_TASK_STAT_INCR(stats_, type, storage_tasks_dequeued);
+  }
+  return task;
+}
+
 folly::small_vector<std::unique_ptr<WriteStorageTask>, 4>
 StorageThreadPool::tryGetWriteBatch(StorageTask::ThreadType thread_type,
                                     size_t max_count,
@@ -107,6 +107,12 @@ class StorageThreadPool {
     return shard_idx_;
   }
 
+  /**
+   * Restricts the calling thread to the CPUs --storage-thread-cpus assigns to
+   * this shard, if any. Called by storage threads when they start.
+   */
+  void setCpuAffinityOfThisThread();
+
   // If true, storage tasks of type FAST_STALLABLE should stall writes
   bool writeStallingEnabled() const {
     return nthreads_fast_stallable_ > 0;
@@ -171,9 +177,29 @@ class StorageThreadPool {
   /**
    * Gets a task from the queue, blocking if there are none.  Used by storage
    * threads to get work to do.
+   *
+   * If task stealing is enabled (see setStealingPeers()), this may return a
+   * task that belongs to another pool.  The caller must then call
+   * onStolenTaskDone() on that pool once it has passed the task on.
    */
   std::unique_ptr<StorageTask> blockingGetTask(StorageTask::ThreadType type);
 
+  /**
+   * Lets idle storage threads of this pool execute tasks queued in the other
+   * given pools, if enabled by Settings::storage_threads_steal_tasks.  Called
+   * by ShardedStorageThreadPool once all pools are constructed.
+   */
+  void setStealingPeers(std::vector<StorageThreadPool*> peers);
+
+  /**
+   * Called by a storage thread of another pool after it has executed a task
+   * taken from this pool and sent it back to the worker or to our syncing
+   * thread.
+   */
+  void onStolenTaskDone() {
+    --stolen_tasks_in_flight_;
+  }
+
   /**
    * Tries to get a batch of WriteStorageTasks from the write queue.
    * @return nullptr if write queue was empty
@@ -296,5 +322,31 @@ class StorageThreadPool {
 
   StorageTask::ThreadType getThreadType(const StorageTask& task) const;
   StorageTask::ThreadType getThreadType(StorageTask::ThreadType type) const;
+
+  // Other pools whose queues our idle threads take tasks from.  Written once
+  // by setStealingPeers() before stealing_enabled_ is set.
+  std::vector<StorageThreadPool*> stealing_peers_;
+  std::atomic<bool> stealing_enabled_{false};
+
+  // Number of our tasks currently being executed by threads of other pools.
+  // join() waits for them before stopping the syncing thread.
+  std::atomic<int64_t> stolen_tasks_in_flight_{0};
+
+  /**
+   * Non-blocking: takes a task destined for threads of the given type out of
+   * our queue, for a thread of another pool to execute.  Returns nullptr if
+   * there is nothing to take.
+   */
+  std::unique_ptr<StorageTask> tryGiveAwayTask(StorageTask::ThreadType type);
+
+  /**
+   * Number of tasks currently queued for threads of the given type.
+   */
+  ssize_t queueSize(StorageTask::ThreadType type);
+
+  /**
+   * Looks for a task in the busiest peer's queue.
+   */
+  std::unique_ptr<StorageTask> tryStealTask(StorageTask::ThreadType type);
 };
 }} // namespace facebook::logdevice
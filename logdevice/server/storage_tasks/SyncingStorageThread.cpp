@@ -53,6 +53,7 @@ void SyncingStorageThread::stopProcessingTasks() {
 }
 
 void SyncingStorageThread::run() {
+  pool_->setCpuAffinityOfThisThread();
   pool_->getLocalLogStore().onStorageThreadStarted();
   SlowStorageTasksTracer slow_task_tracer{pool_->getTraceLogger()};
 
@@ -158,6 +159,9 @@ void SyncingStorageThread::run() {
 
       for (auto& ptr : batch) {
         if (ptr) {
+          if (ptr->latency_trace_) {
+            ptr->latency_trace_->mark("sync");
+          }
           ptr->onSynced();
           StorageTaskResponse::sendBackToWorker(std::move(ptr));
         } else {
@@ -121,6 +121,9 @@ void WriteBatchStorageTask::execute() {
           reply_shard_idx_,
           usec_since(write->enqueue_time_));
     }
+    if (write->latency_trace_) {
+      write->latency_trace_->mark("queue");
+    }
   }
 
   if (thread_type_ == StorageTask::ThreadType::FAST_STALLABLE) {
@@ -140,6 +143,9 @@ void WriteBatchStorageTask::execute() {
       continue;
     }
     write->status_ = status;
+    if (write->latency_trace_) {
+      write->latency_trace_->mark("write");
+    }
     if (status == E::OK) {
       // store success, try to insert the stored record into the record
       // cache. Perform insertion on the storage thread rather than the
@@ -174,7 +180,8 @@ void WriteBatchStorageTask::execute() {
 bool WriteBatchStorageTask::throttleIfNeeded() {
   auto& store = storageThreadPool_->getLocalLogStore();
   auto writes_throttle_state = store.getWriteThrottleState();
-  if (writes_throttle_state == LocalLogStore::WriteThrottleState::NONE) {
+  if (writes_throttle_state == LocalLogStore::WriteThrottleState::NONE &&
+      store.getWritePressure() == 0) {
     return false;
   }
 
@@ -590,6 +590,7 @@ class AllCachedDigestsTest : public ::testing::Test {
   size_t max_active_digests_{10};
   size_t max_bytes_queued_per_client_kb_{800};
   size_t max_streams_per_batch_{200};
+  std::chrono::milliseconds snapshot_reuse_ttl_{0};
   bool can_push_ = false;
 
   void setUp();
@@ -659,7 +660,8 @@ class MockAllCachedDigests : public AllCachedDigests {
  public:
   explicit MockAllCachedDigests(AllCachedDigestsTest* test)
       : AllCachedDigests(test->max_active_digests_,
-                         test->max_bytes_queued_per_client_kb_),
+                         test->max_bytes_queued_per_client_kb_,
+                         test->snapshot_reuse_ttl_),
         test_(test) {}
 
   std::unique_ptr<CachedDigest> createCachedDigest(
@@ -668,7 +670,7 @@ class MockAllCachedDigests : public AllCachedDigests {
       read_stream_id_t rid,
       ClientID client_id,
       lsn_t start_lsn,
-      std::unique_ptr<const EpochRecordCache::Snapshot> epoch_snapshot,
+      std::shared_ptr<const EpochRecordCache::Snapshot> epoch_snapshot,
       ClientDigests* client_digests) override {
     return std::make_unique<DummyCachedDigest>(
         test_, client_id, rid, client_digests, this);
@@ -698,6 +700,70 @@ void AllCachedDigestsTest::setUp() {
   digests_ = std::make_unique<MockAllCachedDigests>(this);
 }
 
+// A digest of the same epoch reuses the previous snapshot until the epoch
+// cache changes.
+TEST_F(AllCachedDigestsTest, SnapshotReuse) {
+  snapshot_reuse_ttl_ = std::chrono::hours(1);
+  setUp();
+  MockEpochRecordCacheDependencies cache_deps;
+  EpochRecordCache cache(LOG_ID,
+                         SHARD,
+                         EPOCH,
+                         &cache_deps,
+                         16,
+                         EpochRecordCache::TailOptimized::NO,
+                         EpochRecordCache::StoredBefore::NEVER);
+  auto put_record = [&](esn_t esn) {
+    lsn_t lsn = compose_lsn(EPOCH, esn);
+    cache.putRecord(RecordID(lsn, LOG_ID),
+                    /*timestamp=*/esn.val_,
+                    /*lng=*/ESN_INVALID,
+                    /*wave=*/1,
+                    copyset_t({N0, N1}),
+                    /*flags=*/0,
+                    std::map<KeyType, std::string>{},
+                    PayloadHolder::copyBuffer(&lsn, sizeof(lsn)));
+  };
+  put_record(esn_t(1));
+
+  auto snapshot1 = digests_->getEpochSnapshot(cache, false);
+  auto snapshot2 = digests_->getEpochSnapshot(cache, false);
+  ASSERT_NE(nullptr, snapshot1);
+  EXPECT_EQ(snapshot1, snapshot2);
+  EXPECT_EQ(1, digests_->numReusableSnapshots());
+
+  // a different offset map setting needs a new snapshot
+  auto snapshot3 = digests_->getEpochSnapshot(cache, true);
+  EXPECT_NE(snapshot1, snapshot3);
+
+  // new records invalidate the snapshot
+  put_record(esn_t(2));
+  auto snapshot4 = digests_->getEpochSnapshot(cache, true);
+  EXPECT_NE(snapshot3, snapshot4);
+  EXPECT_TRUE(snapshot4->getRecord(esn_t(2)).first);
+  EXPECT_FALSE(snapshot3->getRecord(esn_t(2)).first);
+
+  digests_->clear();
+  EXPECT_EQ(0, digests_->numReusableSnapshots());
+}
+
+// Reuse is disabled by default.
+TEST_F(AllCachedDigestsTest, SnapshotReuseDisabled) {
+  setUp();
+  MockEpochRecordCacheDependencies cache_deps;
+  EpochRecordCache cache(LOG_ID,
+                         SHARD,
+                         EPOCH,
+                         &cache_deps,
+                         16,
+                         EpochRecordCache::TailOptimized::NO,
+                         EpochRecordCache::StoredBefore::NEVER);
+  auto snapshot1 = digests_->getEpochSnapshot(cache, false);
+  auto snapshot2 = digests_->getEpochSnapshot(cache, false);
+  EXPECT_NE(snapshot1, snapshot2);
+  EXPECT_EQ(0, digests_->numReusableSnapshots());
+}
+
 TEST_F(AllCachedDigestsTest, MaximumDigestsPerIteration) {
   max_active_digests_ = 10;
   max_streams_per_batch_ = 233;
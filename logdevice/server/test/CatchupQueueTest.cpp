@@ -158,6 +158,12 @@ class CatchupQueueTest : public ::testing::Test {
     return it->second.catchup_queue->queue_.size();
   }
 
+  void giveDRRTurn(ClientID client_id) {
+    auto it = streams_.client_states_.find(client_id);
+    ld_check(it != streams_.client_states_.end());
+    it->second.catchup_queue->onDRRTurn();
+  }
+
   BackoffTimer* getPingTimer(ClientID client_id) {
     auto it = streams_.client_states_.find(client_id);
     ld_check(it != streams_.client_states_.end());
@@ -318,6 +324,11 @@ class CatchupQueueTest : public ::testing::Test {
   // creating a StorageTask.
   int n_non_blocking_read_attempts_{0};
 
+  // Deficit round robin quantum returned by getDRRQuantumBytes(), and the
+  // number of times the CatchupQueue asked for a turn.
+  size_t drr_quantum_{0};
+  int n_drr_waits_{0};
+
   // Used when calling callback_.  Currently, the callback doesn't actually use
   // it.
   std::unique_ptr<FlowGroup> flow_group_{nullptr};
@@ -450,6 +461,14 @@ class MockCatchupQueueDependencies : public CatchupQueueDependencies {
     return 128 * 1024;
   }
 
+  size_t getDRRQuantumBytes(ClientID) override {
+    return test_.drr_quantum_;
+  }
+
+  void waitForDRRTurn(ClientID) override {
+    test_.n_drr_waits_++;
+  }
+
   const Settings& getSettings() const override {
     return *settings_.get();
   }
@@ -580,6 +599,62 @@ TEST_F(CatchupQueueTest, LargeRecordPauses) {
   }
 }
 
+/**
+ * With deficit round robin enabled, a client that queued its quantum of record
+ * bytes stops reading until it gets its next turn, even if there is room in
+ * the output evbuffer.
+ */
+TEST_F(CatchupQueueTest, DRRQuantumUsedUp) {
+  read_stream_id_t id1(1);
+  read_stream_id_t id2(2);
+  drr_quantum_ = 8000;
+
+  setLastReleasedLSN(LSN_MAX);
+
+  ServerReadStream& stream1 = createStream(id1);
+  stream1.setReadPtr(100);
+  stream1.last_delivered_lsn_ = 100 - 1;
+  notifyNeedsCatchup(stream1, id1);
+  ServerReadStream& stream2 = createStream(id2);
+  stream2.setReadPtr(200);
+  stream2.last_delivered_lsn_ = 200 - 1;
+  notifyNeedsCatchup(stream2, id2);
+
+  ASSERT_EQ(1, tasks_.size());
+  std::unique_ptr<ReadStorageTask> task = std::move(tasks_.front());
+  tasks_.clear();
+
+  // The task returns more than a quantum worth of records.
+  ReadStorageTask::RecordContainer records;
+  records.push_back(createFakeRecord(100, 5000));
+  records.push_back(createFakeRecord(101, 5000));
+  task->status_ = E::BYTE_LIMIT_REACHED;
+  task->records_ = std::move(records);
+  task->read_ctx_.read_ptr_ = {lsn_t{102}};
+  streams_.onReadTaskDone(*task);
+  ASSERT_EQ(0, tasks_.size());
+
+  // The records drain, but the quantum is used up, so we wait for a turn
+  // instead of reading stream2.
+  SteadyTimestamp enqueue_time = SteadyTimestamp::now();
+  auto msg = createFakeStartedMessage(id1, filter_version_t(0), E::OK);
+  streams_.onStartedSent(client_id_, *msg, enqueue_time);
+  auto msg1 = createFakeRecordMessage(id1, 100, 5000);
+  auto msg2 = createFakeRecordMessage(id1, 101, 5000);
+  streams_.onRecordSent(client_id_, *msg1, enqueue_time);
+  streams_.onRecordSent(client_id_, *msg2, enqueue_time);
+  ASSERT_EQ(0, tasks_.size());
+  ASSERT_EQ(1, n_drr_waits_);
+  ASSERT_FALSE(getPingTimer(client_id_)->isActive());
+
+  // The next turn pays back the overshoot and leaves enough to read stream2.
+  giveDRRTurn(client_id_);
+  ASSERT_EQ(1, tasks_.size());
+  task = std::move(tasks_.front());
+  ASSERT_EQ(200, task->read_ctx_.read_ptr_.lsn);
+  ASSERT_EQ(1, n_drr_waits_);
+}
+
 /**
  * Verifies fix for #2856309.
  */
@@ -626,6 +701,40 @@ TEST_F(CatchupQueueTest, RecordBytesQueuedCounterPersists) {
   ASSERT_EQ(expected_sz, getCatchupQueueRecordBytesQueued(client_id_));
 }
 
+/**
+ * If the storage thread handed over records in IOBufs, RECORD messages should
+ * share those buffers rather than copy the payloads.
+ */
+TEST_F(CatchupQueueTest, RecordPayloadSharesStorageTaskBuffer) {
+  read_stream_id_t read_stream_id(1);
+  ServerReadStream& stream = createStream(read_stream_id);
+  notifyNeedsCatchup(stream, read_stream_id);
+
+  ASSERT_EQ(1, tasks_.size());
+  std::unique_ptr<ReadStorageTask> task = std::move(tasks_.front());
+  tasks_.clear();
+  messages_.clear();
+
+  RawRecord malloced = createFakeRecord(1, 100);
+  folly::IOBuf buffer(
+      folly::IOBuf::COPY_BUFFER, malloced.blob.data, malloced.blob.size);
+  uint8_t* payload_begin = buffer.writableTail() - 100;
+  std::memset(payload_begin, 'x', 100);
+  ReadStorageTask::RecordContainer records;
+  records.emplace_back(lsn_t(1), std::move(buffer));
+  task->status_ = E::CAUGHT_UP;
+  task->records_ = std::move(records);
+  task->read_ctx_.read_ptr_ = {lsn_t{2}};
+  streams_.onReadTaskDone(*task);
+
+  ASSERT_EQ(1, messages_.size());
+  RECORD_Message* msg = dynamic_cast<RECORD_Message*>(messages_[0].first.get());
+  ASSERT_NE(nullptr, msg);
+  ASSERT_EQ(100, msg->payload_.size());
+  EXPECT_EQ(payload_begin, msg->payload_.iobuf().data());
+  EXPECT_EQ(std::string(100, 'x'), msg->payload_.getPayload().toString());
+}
+
 TEST_F(CatchupQueueTest, ByteLimitReachedButOutputBufferEmptied) {
   read_stream_id_t read_stream_id(1);
   ServerReadStream& stream = createStream(read_stream_id);
@@ -1840,6 +1949,119 @@ TEST_F(CatchupQueueTest, ServerRecordFilterFeatureTest) {
   // filter_key1 > filter_key2, an error message should be printed
   // ServerRecordFilterFactory should return a nullptr
   filterTestHelper(ServerRecordFilterType::RANGE, "b", "a", "", ")");
+
+  // Test case 10: IN_SET filter   check: in {"red", "green", ""}
+  // Expect: filter out records with key "blue"
+  //         records with "green" will pass
+  const std::string set_key =
+      ReadStreamAttributes::inSet({"red", "green", ""}).filter_key1;
+  filterTestHelper(
+      ServerRecordFilterType::IN_SET, set_key, "", "green", "blue");
+
+  // Test case 11: IN_SET filter   check: in {"red", "green", ""}
+  // Expect: filter out records with key "gree"
+  //         records with "" will pass
+  filterTestHelper(ServerRecordFilterType::IN_SET, set_key, "", "", "gree");
+
+  // Test case 12: PREFIX filter   check: starts with "2017"
+  // Expect: filter out records with key "201"
+  //         records with "20170630" will pass
+  filterTestHelper(
+      ServerRecordFilterType::PREFIX, "2017", "", "20170630", "201");
+
+  // Test case 13: PREFIX filter   check: starts with ""
+  // Expect: every record passes
+  ASSERT_TRUE((*ServerRecordFilterFactory::create(
+      ServerRecordFilterType::PREFIX, "", ""))("anything"));
+}
+
+TEST_F(CatchupQueueTest, ServerRecordInSetFilterMalformedKeys) {
+  std::string set_key = ReadStreamAttributes::encodeKeySet({"abc", "def"});
+  ASSERT_NE(nullptr,
+            ServerRecordFilterFactory::create(
+                ServerRecordFilterType::IN_SET, set_key, ""));
+  // Truncate the last key.
+  set_key.pop_back();
+  ASSERT_EQ(nullptr,
+            ServerRecordFilterFactory::create(
+                ServerRecordFilterType::IN_SET, set_key, ""));
+  // Truncate in the middle of a length.
+  ASSERT_EQ(nullptr,
+            ServerRecordFilterFactory::create(
+                ServerRecordFilterType::IN_SET, "ab", ""));
+  // An empty set passes nothing.
+  auto filter = ServerRecordFilterFactory::create(
+      ServerRecordFilterType::IN_SET, "", "");
+  ASSERT_NE(nullptr, filter);
+  ASSERT_FALSE((*filter)(""));
+}
+
+// Storage nodes drop records by LSN hash and timestamp window, independently
+// of the key filter and of whether records have keys.
+TEST_F(CatchupQueueTest, ServerRecordSampling) {
+  resetCatchupQueue();
+  read_stream_id_t read_stream_id(1);
+  ServerReadStream& stream = createStream(read_stream_id);
+  stream.sampling_.one_in = 4;
+  notifyNeedsCatchup(stream, read_stream_id, /* more_data */ true);
+  ASSERT_EQ(/*STARTED*/ 1, messages_.size());
+  messages_.clear();
+
+  ASSERT_EQ(1, tasks_.size());
+  auto task = std::move(tasks_.front());
+  task->status_ = E::CAUGHT_UP;
+  task->records_ = ReadStorageTask::RecordContainer();
+  std::vector<lsn_t> expected;
+  for (lsn_t lsn = 1; lsn <= 100; ++lsn) {
+    task->records_.push_back(createFakeRecord(lsn, 100));
+    if (stream.sampling_.passes(lsn, std::chrono::milliseconds(0))) {
+      expected.push_back(lsn);
+    }
+  }
+  ASSERT_FALSE(expected.empty());
+  ASSERT_LT(expected.size(), 100u);
+  streams_.onReadTaskDone(*task);
+
+  // Records and FILTERED_OUT gaps cover all LSNs in order.
+  std::vector<lsn_t> delivered;
+  lsn_t next_lsn = 1;
+  for (auto& msg : messages_) {
+    if (auto record = dynamic_cast<RECORD_Message*>(msg.first.get())) {
+      ASSERT_EQ(next_lsn, getHeader(*record).lsn);
+      delivered.push_back(next_lsn);
+      ++next_lsn;
+    } else {
+      auto gap = dynamic_cast<GAP_Message*>(msg.first.get());
+      ASSERT_NE(nullptr, gap);
+      ASSERT_EQ(GapReason::FILTERED_OUT, gap->getHeader().reason);
+      ASSERT_EQ(next_lsn, gap->getHeader().start_lsn);
+      next_lsn = gap->getHeader().end_lsn + 1;
+    }
+  }
+  ASSERT_EQ(expected, delivered);
+  messages_.clear();
+
+  // A timestamp window excluding all records filters everything out.
+  resetCatchupQueue();
+  read_stream_id_t read_stream_id2(2);
+  ServerReadStream& stream2 = createStream(read_stream_id2);
+  stream2.sampling_.min_timestamp = std::chrono::milliseconds(1);
+  notifyNeedsCatchup(stream2, read_stream_id2, /* more_data */ true);
+  ASSERT_EQ(/*STARTED*/ 1, messages_.size());
+  messages_.clear();
+  ASSERT_EQ(1, tasks_.size());
+  task = std::move(tasks_.front());
+  task->status_ = E::CAUGHT_UP;
+  task->records_ = ReadStorageTask::RecordContainer();
+  for (lsn_t lsn = 1; lsn <= 10; ++lsn) {
+    task->records_.push_back(createFakeRecord(lsn, 100));
+  }
+  streams_.onReadTaskDone(*task);
+  for (auto& msg : messages_) {
+    ASSERT_EQ(nullptr, dynamic_cast<RECORD_Message*>(msg.first.get()));
+  }
+  tasks_.clear();
+  messages_.clear();
 }
 
 TEST_F(CatchupQueueTest, MergeFilteredOutGapOnServerSide1) {
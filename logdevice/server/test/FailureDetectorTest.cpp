@@ -81,6 +81,9 @@ class MockFailureDetector : public FailureDetector {
     messages_.emplace_back(node, std::move(msg));
     return 0;
   }
+  folly::Optional<uint16_t> getPeerProtocol(NodeID) const override {
+    return Compatibility::MAX_PROTOCOL_SUPPORTED;
+  }
   std::shared_ptr<const configuration::nodes::NodesConfiguration>
   getNodesConfiguration() const override {
     return nodes_config_;
@@ -394,6 +397,14 @@ TEST_F(FailureDetectorTest, RoundRobinGossip) {
   simulate(20, settings);
 }
 
+TEST_F(FailureDetectorTest, RandomGossipWithDeltas) {
+  GossipSettings settings = create_default_settings<GossipSettings>();
+  settings.mode = GossipSettings::SelectionMode::RANDOM;
+  settings.suspect_duration = std::chrono::milliseconds(0);
+  settings.gossip_full_sync_frequency = 5;
+  simulate(20, settings);
+}
+
 namespace {
 // simulates a single round of gossiping between two nodes
 void gossip_round(MockFailureDetector* d1, MockFailureDetector* d2) {
@@ -526,6 +537,74 @@ TEST_F(FailureDetectorTest, Failover) {
   shutdown_processors(processors);
 }
 
+// With gossip-full-sync-frequency, entries that didn't change recently are
+// sent as heartbeats only, except in every few messages.
+TEST_F(FailureDetectorTest, DeltaGossip) {
+  const int num_nodes = 2;
+
+  GossipSettings settings = create_default_settings<GossipSettings>();
+  settings.gossip_failure_threshold = 10;
+  settings.suspect_duration = std::chrono::milliseconds(0);
+  settings.mode = GossipSettings::SelectionMode::ROUND_ROBIN;
+  settings.gossip_full_sync_frequency = 4;
+
+  std::vector<std::shared_ptr<ServerProcessor>> processors;
+  detector_list_t detectors;
+
+  std::tie(processors, detectors) =
+      create_processors_and_detectors(num_nodes, settings);
+
+  for (int i = 0; i <= settings.min_gossips_for_stable_state + 4; ++i) {
+    gossip_round(detectors[0], detectors[1]);
+  }
+
+  size_t num_full = 0;
+  size_t num_delta = 0;
+  for (int i = 0; i < 16; ++i) {
+    detectors[0]->advanceTime();
+    for (auto& msg : detectors[0]->messages_) {
+      if (msg.second->heartbeat_list_.empty()) {
+        EXPECT_EQ(num_nodes, msg.second->node_list_.size());
+        ++num_full;
+      } else {
+        // Only the sender's own entry is full.
+        ASSERT_EQ(1, msg.second->node_list_.size());
+        EXPECT_EQ(0, msg.second->node_list_[0].node_id_);
+        ASSERT_EQ(1, msg.second->heartbeat_list_.size());
+        EXPECT_EQ(1, msg.second->heartbeat_list_[0].node_id_);
+        ++num_delta;
+      }
+      detectors[1]->onGossipReceived(*msg.second);
+    }
+    detectors[0]->messages_.clear();
+    detectors[1]->advanceTime();
+    for (auto& msg : detectors[1]->messages_) {
+      detectors[0]->onGossipReceived(*msg.second);
+    }
+    detectors[1]->messages_.clear();
+  }
+  EXPECT_GT(num_full, 0);
+  EXPECT_GT(num_delta, num_full);
+
+  for (node_index_t idx = 0; idx < num_nodes; ++idx) {
+    EXPECT_TRUE(detectors[0]->isAlive(idx));
+    EXPECT_TRUE(detectors[1]->isAlive(idx));
+  }
+
+  // N1 passes on N0's failover in full right away.
+  detectors[0]->failover();
+  gossip_round(detectors[0], detectors[1]);
+  detectors[1]->advanceTime();
+  bool found = false;
+  for (auto& msg : detectors[1]->messages_) {
+    for (const auto& node : msg.second->node_list_) {
+      found |= node.node_id_ == 0 && node.failover_.count() > 0;
+    }
+  }
+  EXPECT_TRUE(found);
+  shutdown_processors(processors);
+}
+
 // Simulates a node that is stuck not loading Logsconfig. It must be flagged
 // correctly as "STARTING".
 TEST_F(FailureDetectorTest, Starting) {
@@ -360,3 +360,47 @@ TEST(GOSSIP_MessageTest, SerializeAndDeserializeWithVersions) {
     serializeAndDeserializeTest(params);
   }
 }
+
+TEST(GOSSIP_MessageTest, SerializeAndDeserializeHeartbeats) {
+  for (uint16_t proto : {uint16_t(Compatibility::GOSSIP_DELTA_SUPPORT - 1),
+                         Compatibility::MAX_PROTOCOL_SUPPORTED}) {
+    GOSSIP_Message msg(NodeID{1},
+                       {{1, 0, 10ms, 0ms, 0}},
+                       1ms,
+                       1ms,
+                       {},
+                       {},
+                       0,
+                       0,
+                       {},
+                       {});
+    msg.heartbeat_list_ = {{0, 3, 5}, {2, 7, 11}};
+
+    std::unique_ptr<folly::IOBuf> buffer =
+        folly::IOBuf::create(IOBUF_ALLOCATION_UNIT);
+    ProtocolWriter writer(msg.type_, buffer.get(), proto);
+    msg.serialize(writer);
+    ASSERT_GT(writer.result(), 0);
+
+    ProtocolReader reader(msg.type_, std::move(buffer), proto);
+    std::unique_ptr<Message> deserialized_msg_base =
+        GOSSIP_Message::deserialize(reader).msg;
+    ASSERT_NE(nullptr, deserialized_msg_base);
+    auto deserialized_msg =
+        static_cast<GOSSIP_Message*>(deserialized_msg_base.get());
+    checkNodeList(msg.node_list_, deserialized_msg->node_list_);
+
+    const auto& heartbeats = deserialized_msg->heartbeat_list_;
+    if (proto < Compatibility::GOSSIP_DELTA_SUPPORT) {
+      EXPECT_TRUE(heartbeats.empty());
+      continue;
+    }
+    ASSERT_EQ(2, heartbeats.size());
+    EXPECT_EQ(0, heartbeats[0].node_id_);
+    EXPECT_EQ(3, heartbeats[0].gossip_);
+    EXPECT_EQ(5, heartbeats[0].instance_tag_);
+    EXPECT_EQ(2, heartbeats[1].node_id_);
+    EXPECT_EQ(7, heartbeats[1].gossip_);
+    EXPECT_EQ(11, heartbeats[1].instance_tag_);
+  }
+}
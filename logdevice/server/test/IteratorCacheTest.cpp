@@ -0,0 +1,95 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/server/read_path/IteratorCache.h"
+
+#include <gtest/gtest.h>
+
+#include "logdevice/common/settings/SettingsUpdater.h"
+#include "logdevice/server/locallogstore/test/TemporaryLogStore.h"
+
+using namespace facebook::logdevice;
+
+class IteratorCacheTest : public ::testing::Test {
+ public:
+  IteratorCacheTest() : lru_(settings_) {
+    options_.tailing = true;
+  }
+
+  void setMaxStreams(size_t max) {
+    SettingsUpdater u;
+    u.registerSettings(settings_);
+    u.setFromConfig({{"iterator-cache-max-streams", std::to_string(max)}});
+  }
+
+  std::unique_ptr<IteratorCache> createCache(logid_t log_id) {
+    return std::make_unique<IteratorCache>(
+        &store_, log_id, /* created_by_rebuilding */ false, &lru_);
+  }
+
+  UpdateableSettings<Settings> settings_;
+  TemporaryRocksDBStore store_;
+  IteratorCacheLRU lru_;
+  LocalLogStore::ReadOptions options_{"IteratorCacheTest"};
+};
+
+// Once more caches hold iterators than allowed, the least recently used ones
+// release theirs.
+TEST_F(IteratorCacheTest, LRUEviction) {
+  setMaxStreams(2);
+  auto cache1 = createCache(logid_t(1));
+  auto cache2 = createCache(logid_t(2));
+  auto cache3 = createCache(logid_t(3));
+
+  cache1->createOrGet(options_);
+  cache2->createOrGet(options_);
+  ASSERT_EQ(2, lru_.size());
+
+  // Using cache1 again makes cache2 the least recently used one.
+  cache1->createOrGet(options_);
+  cache3->createOrGet(options_);
+  EXPECT_EQ(2, lru_.size());
+  EXPECT_TRUE(cache1->valid(options_));
+  EXPECT_FALSE(cache2->valid(options_));
+  EXPECT_TRUE(cache3->valid(options_));
+
+  // Destroyed or emptied caches leave the LRU.
+  cache3.reset();
+  EXPECT_EQ(1, lru_.size());
+  cache1->invalidate();
+  EXPECT_EQ(0, lru_.size());
+}
+
+// An iterator handed out before eviction stays usable until it's dropped.
+TEST_F(IteratorCacheTest, EvictedIteratorStaysAlive) {
+  setMaxStreams(1);
+  auto cache1 = createCache(logid_t(1));
+  auto cache2 = createCache(logid_t(2));
+
+  auto iterator = cache1->createOrGet(options_);
+  std::weak_ptr<LocalLogStore::ReadIterator> weak = iterator;
+  cache2->createOrGet(options_);
+  EXPECT_FALSE(cache1->valid(options_));
+  EXPECT_FALSE(weak.expired());
+
+  iterator.reset();
+  EXPECT_TRUE(weak.expired());
+}
+
+// 0 means no limit.
+TEST_F(IteratorCacheTest, Unlimited) {
+  setMaxStreams(0);
+  std::vector<std::unique_ptr<IteratorCache>> caches;
+  for (int i = 1; i <= 10; ++i) {
+    caches.push_back(createCache(logid_t(i)));
+    caches.back()->createOrGet(options_);
+  }
+  EXPECT_EQ(10, lru_.size());
+  for (const auto& cache : caches) {
+    EXPECT_TRUE(cache->valid(options_));
+  }
+}
@@ -370,6 +370,38 @@ TEST_P(LocalLogStoreReaderTest, ZeroExecutionTime_) {
   ASSERT_EQ(E::PARTIAL, st);
   ASSERT_EQ(1, records.size());
 }
+
+// The tighter of the setting and the limit in ReadContext applies.
+TEST_P(LocalLogStoreReaderTest, ZeroContextExecutionTime) {
+  auto store = createStore({{1, 1, {N1, N2, N3, N4}},
+                            {2, 1, {N1, N2, N3, N4}},
+                            {3, 1, {N1, N2, N3, N4}},
+                            {4, 1, {N1, N2, N3, N4}}});
+
+  std::vector<RawRecord> records;
+  Status st = ReadOperation()
+                  .use_csi(useCSI())
+                  .until_lsn(4)
+                  .window_high(4)
+                  .last_released(4)
+                  .context_max_execution_time(std::chrono::milliseconds::zero())
+                  .process(store.get(), records);
+  ASSERT_EQ(E::PARTIAL, st);
+  ASSERT_EQ(1, records.size());
+
+  records.clear();
+  st = ReadOperation()
+           .use_csi(useCSI())
+           .until_lsn(4)
+           .window_high(4)
+           .last_released(4)
+           .max_execution_time(std::chrono::milliseconds::zero())
+           .context_max_execution_time(std::chrono::seconds(10))
+           .process(store.get(), records);
+  ASSERT_EQ(E::PARTIAL, st);
+  ASSERT_EQ(1, records.size());
+}
+
 /**
  * If the local log store contains an old-format and a new-format DataKey with
  * the same log ID and LSN, LocalLogStoreReader only delivers the copy with the
@@ -1283,6 +1315,37 @@ TEST(LocalLogStoreReaderTest, HashShuffleFixed) {
             shuf_v1(c({79, 76, 13, 71, 68, 47, 26, 23, 16, 28})));
 }
 
+// Nodes preferred by the client are moved to the front of the shuffled
+// copyset, in the client's order. Other nodes keep their shuffled order.
+TEST(LocalLogStoreReaderTest, PreferredNodesReordering) {
+  auto c = [&](const std::vector<node_index_t>& in) {
+    std::vector<ShardID> out;
+    for (node_index_t n : in) {
+      out.push_back(ShardID(n, 0));
+    }
+    return out;
+  };
+  auto reorder = [](SCDCopysetReordering reordering,
+                    std::vector<node_index_t> preferred,
+                    std::vector<ShardID> v) {
+    LLSFilter filter;
+    filter.scd_copyset_reordering_ = reordering;
+    filter.scd_preferred_nodes_ = std::move(preferred);
+    filter.applyCopysetReordering(v.data(), v.size());
+    return v;
+  };
+
+  EXPECT_EQ(c({3, 1, 2}),
+            reorder(SCDCopysetReordering::NONE, {3}, c({1, 2, 3})));
+  EXPECT_EQ(c({2, 1, 3}),
+            reorder(SCDCopysetReordering::NONE, {7, 2, 1}, c({1, 2, 3})));
+  // Same as HashShuffleFixed, then 9 and 0 moved to the front.
+  EXPECT_EQ(c({9, 0, 5, 8, 1, 7, 6, 2, 4, 3}),
+            reorder(SCDCopysetReordering::HASH_SHUFFLE,
+                    {9, 0},
+                    c({8, 7, 0, 9, 5, 4, 2, 3, 6, 1})));
+}
+
 // A basic test where we check that records are filtered properly when local scd
 // is in use.
 TEST_P(LocalLogStoreReaderTest, LocalScdSimple) {
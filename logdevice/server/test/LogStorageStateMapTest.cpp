@@ -8,12 +8,14 @@
 #include "logdevice/server/read_path/LogStorageStateMap.h"
 
 #include <deque>
+#include <set>
 #include <thread>
 #include <vector>
 
 #include <boost/noncopyable.hpp>
 #include <gtest/gtest.h>
 
+#include "logdevice/common/MetaDataLog.h"
 #include "logdevice/common/debug.h"
 #include "logdevice/include/Err.h"
 #include "logdevice/include/types.h"
@@ -102,6 +104,61 @@ TEST(LogStorageStateMapTest, StressTestLSNUpdating) {
   }
 }
 
+/**
+ * Logs with small ids live in the dense table, the others (here a metadata
+ * log and a log past the table) in the fallback hash map. Both must be found
+ * and iterated over, and concurrent insertions of the same log must agree on
+ * one state.
+ */
+TEST(LogStorageStateMapTest, DenseAndSparseLogIds) {
+  LogStorageStateMap map(2, /*stats*/ nullptr, /*record_cache*/ false);
+  const std::vector<logid_t> logs = {logid_t(1),
+                                     logid_t(1023),
+                                     logid_t(1024),
+                                     logid_t(5000000),
+                                     MetaDataLog::metaDataLogID(logid_t(1))};
+
+  for (logid_t log_id : logs) {
+    EXPECT_EQ(nullptr, map.find(log_id, THIS_SHARD));
+  }
+
+  std::vector<std::thread> threads;
+  std::vector<std::vector<LogStorageState*>> inserted(STRESS_TEST_THREADS);
+  for (int i = 0; i < STRESS_TEST_THREADS; ++i) {
+    threads.emplace_back([&, i] {
+      for (logid_t log_id : logs) {
+        inserted[i].push_back(map.insertOrGet(log_id, THIS_SHARD));
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  for (size_t j = 0; j < logs.size(); ++j) {
+    LogStorageState* state = map.find(logs[j], THIS_SHARD);
+    ASSERT_NE(nullptr, state);
+    for (int i = 0; i < STRESS_TEST_THREADS; ++i) {
+      EXPECT_EQ(state, inserted[i][j]);
+    }
+    // Shards are separate.
+    EXPECT_EQ(nullptr, map.find(logs[j], THIS_SHARD + 1));
+  }
+
+  std::set<logid_t> seen;
+  map.forEachLogOnShard(
+      THIS_SHARD, [&](logid_t log_id, const LogStorageState&) {
+        EXPECT_TRUE(seen.insert(log_id).second);
+        return 0;
+      });
+  EXPECT_EQ(std::set<logid_t>(logs.begin(), logs.end()), seen);
+
+  map.clear();
+  for (logid_t log_id : logs) {
+    EXPECT_EQ(nullptr, map.find(log_id, THIS_SHARD));
+  }
+}
+
 /**
  * Basic test for worker subscriptions.
  */
@@ -146,3 +203,27 @@ TEST(LogStorageStateMapTest, LastReleasedLSNSource) {
   EXPECT_EQ(
       LogStorageState::LastReleasedSource::RELEASE, released_state.source());
 }
+
+TEST(LogStorageStateMapTest, SparseFindTimeIndex) {
+  using std::chrono::milliseconds;
+  LogStorageStateMap map(1, /*stats*/ nullptr, /*record_cache*/ false);
+  LogStorageState log_state(logid_t(42), THIS_SHARD, &map);
+  const milliseconds interval(100);
+
+  EXPECT_TRUE(log_state.shouldWriteFindTimeIndexEntry(milliseconds(1000),
+                                                      interval));
+  EXPECT_FALSE(log_state.shouldWriteFindTimeIndexEntry(milliseconds(1050),
+                                                       interval));
+  EXPECT_FALSE(log_state.shouldWriteFindTimeIndexEntry(milliseconds(1099),
+                                                       interval));
+  EXPECT_TRUE(log_state.shouldWriteFindTimeIndexEntry(milliseconds(1100),
+                                                      interval));
+  // Records with timestamps going back are always indexed and don't move
+  // the sampling point.
+  EXPECT_TRUE(log_state.shouldWriteFindTimeIndexEntry(milliseconds(500),
+                                                      interval));
+  EXPECT_FALSE(log_state.shouldWriteFindTimeIndexEntry(milliseconds(1150),
+                                                       interval));
+  EXPECT_TRUE(log_state.shouldWriteFindTimeIndexEntry(milliseconds(1300),
+                                                      interval));
+}
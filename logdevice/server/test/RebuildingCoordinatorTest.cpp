@@ -153,6 +153,7 @@ class MockedShardRebuilding : public ShardRebuildingInterface {
 
   void noteConfigurationChanged() override {}
   void noteRebuildingSettingsChanged() override {}
+  void setThroughputFactor(double /* unused */) override {}
 
   // Fills the current row of @param table with debug information about the
   // state of rebuilding for this shard. Used by admin commands.
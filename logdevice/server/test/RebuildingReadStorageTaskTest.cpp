@@ -616,6 +616,52 @@ TEST_P(RebuildingReadStorageTaskTest, TimeRanges) {
   }
 }
 
+// Records whose copyset doesn't intersect the rebuilding set should be
+// filtered out based on copyset index alone, without reading their payloads.
+TEST_P(RebuildingReadStorageTaskTest, PayloadsReadOnlyForRebuiltRecords) {
+  logid_t L1(1);
+  auto& P = partition_start;
+  ReplicationProperty R({{NodeLocationScope::NODE, 3}});
+  StorageSet all_nodes{N0, N1, N2, N3, N4, N5, N6, N7, N8, N9};
+  Slice big_payload = Slice::fromString(BIG_PAYLOAD);
+
+  auto rebuilding_set = std::make_shared<RebuildingSet>();
+  rebuilding_set->shards.emplace(
+      N2, RebuildingNodeInfo(RebuildingMode::RESTORE));
+  auto c = createContext(rebuilding_set);
+  c->logs[L1].plan.untilLSN = LSN_MAX;
+  c->logs[L1].plan.addEpochRange(
+      EPOCH_INVALID, EPOCH_MAX, std::make_shared<EpochMetaData>(all_nodes, R));
+
+  // 100 big records that don't need rebuilding, then one that does.
+  for (size_t i = 1; i <= 100; ++i) {
+    store->putRecord(
+        L1, mklsn(1, i), P[0] + MINUTE, {N1, N3, N4}, 0, big_payload); // -
+  }
+  store->putRecord(
+      L1, mklsn(1, 101), P[0] + MINUTE, {N1, N3, N2}, 0, big_payload); // +
+
+  std::vector<ChunkDescription> all_chunks;
+  while (!c->reachedEnd) {
+    MockRebuildingReadStorageTask task(this, c);
+    task.execute();
+    task.onDone();
+    ASSERT_FALSE(c->persistentError);
+    auto converted = convertChunks(chunks);
+    all_chunks.insert(all_chunks.end(), converted.begin(), converted.end());
+  }
+  EXPECT_EQ(std::vector<ChunkDescription>(
+                {{L1, mklsn(1, 101), 1, /* big */ true}}),
+            all_chunks);
+
+#define SHARD_STAT(s) stats.get().per_shard_stats->get(0)->s
+  EXPECT_GE(SHARD_STAT(rebuilding_num_csi_entries_read), 101);
+  EXPECT_EQ(1, SHARD_STAT(rebuilding_num_records_read));
+  EXPECT_LT(SHARD_STAT(rebuilding_num_record_bytes_read),
+            BIG_PAYLOAD.size() * 2);
+#undef SHARD_STAT
+}
+
 INSTANTIATE_TEST_CASE_P(P,
                         RebuildingReadStorageTaskTest,
                         ::testing::Values(false, true));
@@ -0,0 +1,85 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/server/rebuilding/RebuildingThrottle.h"
+
+#include <gtest/gtest.h>
+
+#include "logdevice/common/settings/SettingsUpdater.h"
+#include "logdevice/common/stats/Stats.h"
+
+using namespace facebook::logdevice;
+using namespace std::chrono_literals;
+
+class RebuildingThrottleTest : public ::testing::Test {
+ public:
+  RebuildingThrottleTest() : throttle_(settings_) {}
+
+  void setSettings(std::unordered_map<std::string, std::string> values) {
+    SettingsUpdater u;
+    u.registerSettings(settings_);
+    u.setFromConfig(values);
+  }
+
+  UpdateableSettings<RebuildingSettings> settings_;
+  RebuildingThrottle throttle_;
+};
+
+// Without latency targets the factor stays at 1.
+TEST_F(RebuildingThrottleTest, Disabled) {
+  EXPECT_FALSE(throttle_.enabled());
+  EXPECT_EQ(1, throttle_.update(1s, 1s));
+}
+
+// Halves the factor while over target, down to the minimum; grows it back
+// additively once latencies recover.
+TEST_F(RebuildingThrottleTest, AIMD) {
+  setSettings({{"rebuilding-throttle-store-latency-p99", "10ms"},
+               {"rebuilding-throttle-min-percent", "20"}});
+  ASSERT_TRUE(throttle_.enabled());
+
+  EXPECT_DOUBLE_EQ(1, throttle_.update(5ms, 0us));
+  EXPECT_DOUBLE_EQ(.5, throttle_.update(20ms, 0us));
+  EXPECT_DOUBLE_EQ(.25, throttle_.update(20ms, 0us));
+  EXPECT_DOUBLE_EQ(.2, throttle_.update(20ms, 0us));
+  EXPECT_DOUBLE_EQ(.2, throttle_.update(20ms, 0us));
+
+  // Read latency has no target, so it's ignored.
+  EXPECT_NEAR(.3, throttle_.update(5ms, 1s), 1e-9);
+  EXPECT_NEAR(.4, throttle_.update(0us, 0us), 1e-9);
+  for (int i = 0; i < 10; ++i) {
+    throttle_.update(5ms, 0us);
+  }
+  EXPECT_DOUBLE_EQ(1, throttle_.getFactor());
+}
+
+// Either signal being over target is enough to back off.
+TEST_F(RebuildingThrottleTest, ReadLatency) {
+  setSettings({{"rebuilding-throttle-store-latency-p99", "10ms"},
+               {"rebuilding-throttle-read-latency-p99", "50ms"}});
+  EXPECT_DOUBLE_EQ(.5, throttle_.update(5ms, 100ms));
+  EXPECT_NEAR(.6, throttle_.update(5ms, 40ms), 1e-9);
+}
+
+// Only latencies since the previous update are considered.
+TEST_F(RebuildingThrottleTest, Window) {
+  setSettings({{"rebuilding-throttle-store-latency-p99", "10ms"}});
+  StatsHolder stats(StatsParams().setIsServer(true));
+
+  for (int i = 0; i < 1000; ++i) {
+    PER_SHARD_HISTOGRAM_ADD(&stats, store_latency, i % 2, 100000);
+  }
+  EXPECT_DOUBLE_EQ(.5, throttle_.update(&stats));
+
+  // No new samples.
+  EXPECT_NEAR(.6, throttle_.update(&stats), 1e-9);
+
+  for (int i = 0; i < 1000; ++i) {
+    PER_SHARD_HISTOGRAM_ADD(&stats, store_latency, i % 2, 1000);
+  }
+  EXPECT_NEAR(.7, throttle_.update(&stats), 1e-9);
+}
@@ -724,6 +724,112 @@ TEST_F(EpochRecordCacheTest, Snapshot) {
   ASSERT_EQ(lsn(EPOCH, 9), *((lsn_t*)record.payload_raw.data));
 }
 
+TEST_F(EpochRecordCacheTest, CompressPayloads) {
+  capacity_ = 64;
+  stored_before_ = StoredBefore::NEVER;
+  tail_optimized_ = true;
+  create();
+
+  const size_t payload_size = 1024;
+  auto put = [&](esn_t::raw_type esn, char fill) {
+    return cache_->putRecord(RecordID(lsn(EPOCH, esn), LOG_ID),
+                             lsn(EPOCH, esn),
+                             esn_t(2),
+                             1,
+                             copyset_t({N0, N1, N2}),
+                             STORE_flags_t(0),
+                             KeysType(),
+                             createPayload(payload_size, fill));
+  };
+  ASSERT_EQ(0, put(3, 'a'));
+  ASSERT_EQ(0, put(4, 'b'));
+  // too small to be compressed
+  ASSERT_EQ(0, putRecord(cache_.get(), lsn(EPOCH, 5), 2));
+  const size_t bytes_before = cache_->bufferedPayloadBytes();
+  ASSERT_EQ(2 * payload_size + sizeof(lsn_t), bytes_before);
+
+  const size_t bytes_saved = cache_->compressPayloads();
+  ASSERT_GT(bytes_saved, 0u);
+  ASSERT_EQ(bytes_before - bytes_saved, cache_->bufferedPayloadBytes());
+  ASSERT_EQ(3, cache_->bufferedRecords());
+  ASSERT_TRUE(cache_->getEntry(esn_t(3)).second->isPayloadCompressed());
+  ASSERT_TRUE(cache_->getEntry(esn_t(4)).second->isPayloadCompressed());
+  ASSERT_FALSE(cache_->getEntry(esn_t(5)).second->isPayloadCompressed());
+  // nothing left to compress
+  ASSERT_EQ(0, cache_->compressPayloads());
+
+  // snapshots see the original payloads
+  auto snapshot = cache_->createSnapshot();
+  auto result = snapshot->getRecord(esn_t(4));
+  ASSERT_TRUE(result.first);
+  Slice payload = result.second.payload_raw;
+  ASSERT_EQ(payload_size, payload.size);
+  ASSERT_EQ(std::string(payload_size, 'b'),
+            std::string(static_cast<const char*>(payload.data), payload.size));
+  payload = snapshot->getRecord(esn_t(5)).second.payload_raw;
+  ASSERT_EQ(lsn(EPOCH, 5), *(const lsn_t*)payload.data);
+
+  // a serializable snapshot can repopulate an identical cache
+  auto full_snapshot = cache_->createSerializableSnapshot();
+  ASSERT_EQ(bytes_before, full_snapshot->getHeader()->buffer_payload_bytes);
+  auto repopulated = EpochRecordCache::createFromSnapshot(
+      LOG_ID, SHARD, *full_snapshot, deps_.get());
+  ASSERT_NE(nullptr, repopulated);
+  ASSERT_EQ(bytes_before, repopulated->bufferedPayloadBytes());
+
+  // released records, including the tail, get their payloads back
+  cache_->advanceLNG(esn_t(4));
+  ASSERT_TRUE(cache_->isConsistent());
+  ASSERT_EQ(1, cache_->bufferedRecords());
+  TailRecord tail = cache_->getTailRecord();
+  ASSERT_TRUE(tail.isValid());
+  ASSERT_EQ(lsn(EPOCH, 4), tail.header.lsn);
+  ASSERT_EQ(payload_size, tail.getPayloadSlice().size);
+  ASSERT_EQ('b', *static_cast<const char*>(tail.getPayloadSlice().data));
+}
+
+TEST_F(EpochRecordCacheTest, EmptyAndTailRecordWithoutLock) {
+  capacity_ = 64;
+  stored_before_ = StoredBefore::NEVER;
+  tail_optimized_ = true;
+  create();
+
+  ASSERT_TRUE(cache_->empty());
+  ASSERT_TRUE(cache_->emptyWithoutTailPayload());
+  int rv = putRecord(cache_.get(), lsn(EPOCH, 3), 2);
+  ASSERT_EQ(0, rv);
+  ASSERT_FALSE(cache_->empty());
+
+  // tail record published by eviction is seen by readers on other threads,
+  // in LSN order
+  std::atomic<bool> done{false};
+  std::thread reader([&] {
+    lsn_t last_seen = LSN_INVALID;
+    while (!done.load()) {
+      TailRecord tail = cache_->getTailRecord();
+      if (tail.isValid()) {
+        EXPECT_GE(tail.header.lsn, last_seen);
+        last_seen = tail.header.lsn;
+      }
+    }
+  });
+  for (esn_t::raw_type esn = 4; esn < 50; ++esn) {
+    rv = putRecord(cache_.get(), lsn(EPOCH, esn), esn - 1);
+    ASSERT_EQ(0, rv);
+  }
+  done.store(true);
+  reader.join();
+
+  cache_->advanceLNG(esn_t(49));
+  ASSERT_TRUE(cache_->empty());
+  ASSERT_FALSE(cache_->emptyWithoutTailPayload());
+  ASSERT_TAIL_RECORD(cache_, lsn(EPOCH, 49));
+
+  cache_->disableCache();
+  ASSERT_FALSE(cache_->getTailRecord().isValid());
+  ASSERT_TRUE(cache_->emptyWithoutTailPayload());
+}
+
 TEST_F(EpochRecordCacheTest, MultithreadedAppend) {
   multi_threaded_ = true;
   capacity_ = 64;
@@ -1570,6 +1676,27 @@ TEST_F(RecordCacheTest, Basic) {
   ASSERT_EQ(-1, rv);
 }
 
+TEST_F(RecordCacheTest, LookupCount) {
+  epoch_cache_capacity_ = 10;
+  create();
+  ASSERT_EQ(0u, cache_->getLookupCount());
+
+  // misses count as much as hits, they are demand for the cache as well
+  cache_->getEpochRecordCache(EPOCH);
+  int rv = putRecord(cache_.get(), lsn(EPOCH, 4), 2);
+  ASSERT_EQ(0, rv);
+  for (int i = 0; i < 4; ++i) {
+    cache_->getEpochRecordCache(EPOCH);
+  }
+  ASSERT_EQ(5u, cache_->getLookupCount());
+
+  cache_->decayLookupCount();
+  ASSERT_EQ(2u, cache_->getLookupCount());
+  cache_->decayLookupCount();
+  cache_->decayLookupCount();
+  ASSERT_EQ(0u, cache_->getLookupCount());
+}
+
 TEST_F(RecordCacheTest, EmptyCacheWithNonAuthoritativeEpoch) {
   epoch_cache_capacity_ = 10;
   initial_seal_epoch_ = epoch_t(2);
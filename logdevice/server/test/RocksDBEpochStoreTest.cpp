@@ -0,0 +1,172 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include "logdevice/server/epoch_store/RocksDBEpochStore.h"
+
+#include <memory>
+
+#include <gtest/gtest.h>
+
+#include "logdevice/common/EpochMetaDataUpdater.h"
+#include "logdevice/common/MetaDataLog.h"
+#include "logdevice/common/configuration/UpdateableConfig.h"
+#include "logdevice/common/nodeset_selection/NodeSetSelectorFactory.h"
+#include "logdevice/common/test/InlineRequestPoster.h"
+#include "logdevice/common/test/TestUtil.h"
+
+using namespace facebook::logdevice;
+
+#define TEST_CLUSTER "nodeset_test" // fake LD cluster name to use
+
+class RocksDBEpochStoreTest : public ::testing::Test {
+ public:
+  RocksDBEpochStoreTest()
+      : temp_dir_(
+            std::make_unique<TemporaryDirectory>("RocksDBEpochStoreTest")) {}
+
+  void SetUp() override {
+    dbg::assertOnData = true;
+    std::shared_ptr<Configuration> cfg_in =
+        Configuration::fromJsonFile(TEST_CONFIG_FILE(TEST_CLUSTER ".conf"))
+            ->withNodesConfiguration(createSimpleNodesConfig(11));
+    ld_check(cfg_in);
+    cluster_config_ = std::make_shared<UpdateableConfig>(std::move(cfg_in));
+    poster_ = std::make_unique<InlineRequestPoster>();
+    openStore();
+    ASSERT_EQ(0, provision());
+  }
+
+  void openStore() {
+    store_.reset();
+    store_ = std::make_unique<RocksDBEpochStore>(
+        temp_dir_->path().string(),
+        RequestExecutor(poster_.get()),
+        folly::none,
+        cluster_config_->updateableNodesConfiguration());
+  }
+
+  int provision() {
+    auto config = cluster_config_->get();
+    return store_->provisionMetaDataLogs(
+        std::make_shared<CustomEpochMetaDataUpdater>(
+            config,
+            config->getNodesConfiguration(),
+            NodeSetSelectorFactory::create(NodeSetSelectorType::RANDOM),
+            EpochMetaData::Updater::Options()
+                .setUseStorageSetFormat()
+                .setProvisionIfEmpty()),
+        config);
+  }
+
+  TailRecord makeTail(logid_t logid, lsn_t lsn) {
+    return TailRecord(
+        {logid,
+         lsn,
+         15,
+         {BYTE_OFFSET_INVALID /* deprecated, use OffsetMap instead */},
+         0,
+         {}},
+        OffsetMap({{BYTE_OFFSET, 100}}),
+        PayloadHolder());
+  }
+
+ private:
+  std::unique_ptr<TemporaryDirectory> temp_dir_;
+
+ public:
+  std::unique_ptr<RequestPoster> poster_;
+  std::shared_ptr<UpdateableConfig> cluster_config_;
+  std::unique_ptr<RocksDBEpochStore> store_;
+};
+
+TEST_F(RocksDBEpochStoreTest, NextEpochWithMetaData) {
+  for (uint32_t expected_epoch : {2, 3}) {
+    store_->createOrUpdateMetaData(
+        logid_t(1),
+        std::make_shared<EpochMetaDataUpdateToNextEpoch>(
+            EpochMetaData::Updater::Options().setProvisionIfEmpty()),
+        [expected_epoch](Status status,
+                         logid_t,
+                         std::unique_ptr<EpochMetaData> info,
+                         std::unique_ptr<EpochStoreMetaProperties>) {
+          ASSERT_EQ(E::OK, status);
+          ASSERT_NE(nullptr, info);
+          EXPECT_TRUE(info->isValid());
+          EXPECT_EQ(expected_epoch, info->h.epoch.val());
+        },
+        MetaDataTracer());
+  }
+}
+
+// Metadata survives reopening the database, and provisioning already
+// provisioned logs is a no-op.
+TEST_F(RocksDBEpochStoreTest, Reopen) {
+  store_->createOrUpdateMetaData(
+      logid_t(1),
+      std::make_shared<EpochMetaDataUpdateToNextEpoch>(
+          EpochMetaData::Updater::Options()),
+      [](Status status,
+         logid_t,
+         std::unique_ptr<EpochMetaData> info,
+         std::unique_ptr<EpochStoreMetaProperties>) {
+        ASSERT_EQ(E::OK, status);
+        EXPECT_EQ(2, info->h.epoch.val());
+      },
+      MetaDataTracer());
+
+  openStore();
+  ASSERT_EQ(0, provision());
+
+  store_->createOrUpdateMetaData(
+      logid_t(1),
+      std::make_shared<EpochMetaDataUpdateToNextEpoch>(
+          EpochMetaData::Updater::Options()),
+      [](Status status,
+         logid_t,
+         std::unique_ptr<EpochMetaData> info,
+         std::unique_ptr<EpochStoreMetaProperties>) {
+        ASSERT_EQ(E::OK, status);
+        EXPECT_EQ(3, info->h.epoch.val());
+      },
+      MetaDataTracer());
+}
+
+TEST_F(RocksDBEpochStoreTest, LastCleanEpoch) {
+  const logid_t data_log(1);
+  const logid_t metadata_log = MetaDataLog::metaDataLogID(data_log);
+
+  store_->setLastCleanEpoch(
+      data_log,
+      epoch_t(10),
+      makeTail(data_log, lsn_t(200)),
+      [](Status status, logid_t, epoch_t, TailRecord) {
+        ASSERT_EQ(E::OK, status);
+      });
+  // Stale update.
+  store_->setLastCleanEpoch(
+      data_log,
+      epoch_t(5),
+      makeTail(data_log, lsn_t(100)),
+      [](Status status, logid_t, epoch_t, TailRecord) {
+        EXPECT_EQ(E::STALE, status);
+      });
+
+  std::vector<logid_t> logids{data_log, metadata_log, logid_t(2)};
+  std::vector<std::pair<logid_t, epoch_t>> results;
+  store_->getLastCleanEpochs(
+      logids,
+      [&](Status status, logid_t logid, epoch_t epoch, TailRecord tail) {
+        ASSERT_EQ(E::OK, status);
+        EXPECT_TRUE(tail.isValid());
+        results.emplace_back(logid, epoch);
+      });
+  std::vector<std::pair<logid_t, epoch_t>> expected{
+      {data_log, epoch_t(10)},
+      {metadata_log, EPOCH_INVALID},
+      {logid_t(2), EPOCH_INVALID}};
+  EXPECT_EQ(expected, results);
+}
@@ -7,6 +7,8 @@
  */
 #include "logdevice/server/rebuilding/ShardRebuilding.h"
 
+#include <set>
+
 #include <gtest/gtest.h>
 
 #include "logdevice/common/settings/SettingsUpdater.h"
@@ -31,7 +33,9 @@ class MockedShardRebuilding : public ShardRebuilding,
   };
 
   StatsHolder stats;
+  // True if any read cursor has a storage task in flight.
   bool taskInFlight = false;
+  std::set<size_t> cursorsInFlight;
   bool waitingForGlobalWindow = false;
   bool completed = false;
 
@@ -116,11 +120,21 @@ class MockedShardRebuilding : public ShardRebuilding,
         ChunkInfo{.id = chunk_id, .data = std::move(chunk), .worker = worker});
     return worker;
   }
-  void putStorageTask() override {
-    EXPECT_FALSE(taskInFlight);
+  void putStorageTask(size_t cursor) override {
+    EXPECT_FALSE(cursorsInFlight.count(cursor));
+    cursorsInFlight.insert(cursor);
     taskInFlight = true;
   }
 
+  size_t numCursors() const {
+    return readCursors_.size();
+  }
+  const std::unordered_map<logid_t,
+                           RebuildingReadStorageTask::Context::LogState>&
+  cursorLogs(size_t cursor) const {
+    return readCursors_.at(cursor).context->logs;
+  }
+
   void onShardRebuildingComplete(uint32_t shard_idx) override {
     EXPECT_EQ(shard_idx, SHARD_IDX);
     EXPECT_FALSE(completed);
@@ -148,25 +162,30 @@ class MockedShardRebuilding : public ShardRebuilding,
   }
 
   void simulateReadTaskDone(std::vector<ChunkData*> chunks,
-                            bool reached_end = false) {
-    ld_check(taskInFlight);
-    taskInFlight = false;
-
-    ld_check(!readContext_->reachedEnd);
-    readContext_->reachedEnd = reached_end;
+                            bool reached_end = false,
+                            size_t cursor = 0) {
+    ld_check(cursorsInFlight.count(cursor));
+    cursorsInFlight.erase(cursor);
+    taskInFlight = !cursorsInFlight.empty();
+
+    auto& context = readCursors_.at(cursor).context;
+    ld_check(!context->reachedEnd);
+    context->reachedEnd = reached_end;
     auto before = SteadyTimestamp::now();
-    readContext_->onDone(
+    context->onDone(
         std::vector<std::unique_ptr<ChunkData>>(chunks.begin(), chunks.end()));
     globalWindowWaitingMayHaveChanged(before);
   }
 
-  void simulatePersistentError() {
-    ld_check(taskInFlight);
-    taskInFlight = false;
+  void simulatePersistentError(size_t cursor = 0) {
+    ld_check(cursorsInFlight.count(cursor));
+    cursorsInFlight.erase(cursor);
+    taskInFlight = !cursorsInFlight.empty();
 
-    readContext_->persistentError = true;
+    auto& context = readCursors_.at(cursor).context;
+    context->persistentError = true;
     auto before = SteadyTimestamp::now();
-    readContext_->onDone({});
+    context->onDone({});
     globalWindowWaitingMayHaveChanged(before);
   }
 
@@ -238,7 +257,7 @@ ChunkData* makeChunk(logid_t log,
 TEST_P(ShardRebuildingTest, Basic) {
   MockedShardRebuilding reb(rebuildingSettings_);
   // ShardRebuilding doesn't directly use rebuilding plan, it just passes it to
-  // readContext_. So we can pass an empty plan.
+  // the read cursors' contexts. So we can pass an empty plan.
   reb.start({});
   EXPECT_TRUE(reb.taskInFlight);
   EXPECT_EQ(0, reb.chunkRebuildings.size());
@@ -528,6 +547,124 @@ TEST_P(ShardRebuildingTest, WindowsAndInternalLogs) {
   EXPECT_DONOR_PROGRESS(BASE_TIME + direction * HOUR);
 }
 
+// With rebuilding-read-buffer-max-bytes set, the donor reads further ahead
+// after re-replication ran out of records, and less far when the read buffer
+// didn't drain while reading.
+TEST_P(ShardRebuildingTest, AdaptiveReadAhead) {
+  rebuildingSettingsUpdater_.setFromCLI(
+      {{"rebuilding-max-batch-bytes", "100"},
+       {"rebuilding-read-buffer-max-bytes", "1000"}});
+
+  int direction = GetParam() ? -1 : +1; // new to old: -1, old to new: +1
+
+  MockedShardRebuilding reb(rebuildingSettings_);
+  // Keep records in the read buffer by not letting them past global window.
+  reb.simulateAdvanceGlobalWindow(BASE_TIME - direction * MINUTE);
+  reb.start({});
+  EXPECT_TRUE(reb.taskInFlight);
+
+  // The read buffer was empty and nothing was being rebuilt, so the read ahead
+  // grows from 300 to 400 bytes. 250 + 100 fits, another task is sent.
+  reb.simulateReadTaskDone(
+      {makeChunk(logid_t(1), 100, 101, 250, BASE_TIME + direction * MINUTE)});
+  EXPECT_TRUE(reb.taskInFlight);
+  ASSERT_EQ(0, reb.chunkRebuildings.size());
+
+  // The read buffer didn't drain while reading, so the read ahead shrinks
+  // back to 300 bytes. 350 + 100 doesn't fit.
+  reb.simulateReadTaskDone(
+      {makeChunk(logid_t(1), 102, 102, 100, BASE_TIME + direction * MINUTE)});
+  EXPECT_FALSE(reb.taskInFlight);
+  ASSERT_EQ(0, reb.chunkRebuildings.size());
+
+  // Once the buffered chunks are rebuilt, reading resumes.
+  reb.simulateAdvanceGlobalWindow(BASE_TIME + direction * HOUR);
+  ASSERT_EQ(2, reb.chunkRebuildings.size());
+  EXPECT_TRUE(reb.taskInFlight);
+}
+
+// The throughput factor set by RebuildingCoordinator scales the limits on
+// re-replication in flight.
+TEST_P(ShardRebuildingTest, ThroughputFactor) {
+  rebuildingSettingsUpdater_.setFromCLI(
+      {{"rebuilding-max-records-in-flight", "8"}});
+
+  MockedShardRebuilding reb(rebuildingSettings_);
+  reb.setThroughputFactor(.5);
+  reb.start({});
+
+  // 4 chunks of 2 records each; only 4 records may be in flight.
+  reb.simulateReadTaskDone({makeChunk(logid_t(1), 100, 101, 10, BASE_TIME),
+                            makeChunk(logid_t(1), 102, 103, 10, BASE_TIME),
+                            makeChunk(logid_t(1), 104, 105, 10, BASE_TIME),
+                            makeChunk(logid_t(1), 106, 107, 10, BASE_TIME)});
+  ASSERT_EQ(2, reb.chunkRebuildings.size());
+
+  // Back to full speed, the rest of the buffered chunks start.
+  reb.setThroughputFactor(1);
+  ASSERT_EQ(4, reb.chunkRebuildings.size());
+}
+
+// Logs are split among read cursors, which read concurrently within the
+// shared read ahead budget. Chunks are rebuilt in timestamp order across
+// cursors.
+TEST_P(ShardRebuildingTest, MultipleReadCursors) {
+  rebuildingSettingsUpdater_.setFromCLI(
+      {{"rebuilding-max-batch-bytes", "100"},
+       {"rebuilding-read-cursors", "2"}});
+
+  int direction = GetParam() ? -1 : +1; // new to old: -1, old to new: +1
+
+  MockedShardRebuilding reb(rebuildingSettings_);
+  // Keep records in the read buffers by not letting them past global window.
+  reb.simulateAdvanceGlobalWindow(BASE_TIME - direction * MINUTE);
+  std::unordered_map<logid_t, std::unique_ptr<RebuildingPlan>> plan;
+  for (logid_t::raw_type log = 1; log <= 4; ++log) {
+    plan.emplace(logid_t(log), std::make_unique<RebuildingPlan>());
+  }
+  reb.start(std::move(plan));
+
+  // Both cursors read, each getting two of the logs.
+  ASSERT_EQ(2, reb.numCursors());
+  EXPECT_EQ(2, reb.cursorLogs(0).size());
+  EXPECT_EQ(2, reb.cursorLogs(1).size());
+  EXPECT_TRUE(reb.cursorLogs(0).count(logid_t(2)));
+  EXPECT_TRUE(reb.cursorLogs(1).count(logid_t(1)));
+  EXPECT_EQ(std::set<size_t>({0, 1}), reb.cursorsInFlight);
+
+  // Read ahead is 600 bytes. With 300 bytes buffered, batches for both
+  // cursors fit, but with 450 bytes only one does.
+  reb.simulateReadTaskDone(
+      {makeChunk(
+          logid_t(1), 100, 101, 300, BASE_TIME + direction * MINUTE * 30)},
+      false,
+      1);
+  EXPECT_EQ(std::set<size_t>({0, 1}), reb.cursorsInFlight);
+  reb.simulateReadTaskDone(
+      {makeChunk(logid_t(2), 100, 100, 150, BASE_TIME + direction * MINUTE)},
+      false,
+      0);
+  EXPECT_EQ(std::set<size_t>({1}), reb.cursorsInFlight);
+  reb.simulateReadTaskDone({}, true, 1);
+  EXPECT_EQ(std::set<size_t>({0}), reb.cursorsInFlight);
+  reb.simulateReadTaskDone({}, true, 0);
+  EXPECT_TRUE(reb.cursorsInFlight.empty());
+  ASSERT_EQ(0, reb.chunkRebuildings.size());
+
+  // The less advanced chunk is rebuilt first, regardless of which cursor read
+  // it.
+  reb.simulateAdvanceGlobalWindow(BASE_TIME + direction * HOUR);
+  ASSERT_EQ(2, reb.chunkRebuildings.size());
+  EXPECT_EQ(logid_t(2), reb.chunkRebuildings[0].data->address.log);
+  EXPECT_EQ(logid_t(1), reb.chunkRebuildings[1].data->address.log);
+
+  // Rebuilding completes once all cursors reached the end.
+  reb.simulateChunkRebuildingDone(0);
+  EXPECT_FALSE(reb.completed);
+  reb.simulateChunkRebuildingDone(0);
+  EXPECT_TRUE(reb.completed);
+}
+
 // TODO: getDebugInfo()
 // TODO: getDebugInfo() while waiting for global window
 // TODO: getDebugInfo() while have and don't have storage task in flight
@@ -136,6 +136,59 @@ TEST(StorageThreadPoolTest, Basic) {
   }
 }
 
+/**
+ * With task stealing enabled, an idle thread of one shard should execute
+ * tasks queued in another shard whose threads are all busy. The second
+ * iteration drives the DRR scheduler code path.
+ */
+TEST(StorageThreadPoolTest, StealTasksFromBusyShard) {
+  for (int testIter = 0; testIter < 2; testIter++) {
+    Settings init_settings = create_default_settings<Settings>();
+    init_settings.storage_threads_steal_tasks = true;
+    init_settings.storage_threads_steal_idle_interval =
+        std::chrono::milliseconds(1);
+    if (testIter == 1) {
+      init_settings.storage_tasks_use_drr = true;
+    }
+    UpdateableSettings<Settings> settings(init_settings);
+    UpdateableSettings<ServerSettings> server_settings(
+        create_default_settings<ServerSettings>());
+
+    Params params;
+    params[(size_t)StorageTaskThreadType::SLOW].nthreads = 1;
+
+    TemporaryRocksDBStore store0;
+    TemporaryRocksDBStore store1;
+    auto pool0 = std::make_unique<StorageThreadPool>(
+        0, 2, params, server_settings, settings, &store0, 16);
+    auto pool1 = std::make_unique<StorageThreadPool>(
+        1, 2, params, server_settings, settings, &store1, 16);
+    pool0->setStealingPeers({pool1.get()});
+    pool1->setStealingPeers({pool0.get()});
+
+    // Keep the only thread of shard 0 busy.
+    folly::Baton<> started, unblock;
+    ASSERT_TRUE(pool0->blockingPutTask(
+        std::make_unique<TestTask>(StorageTaskThreadType::SLOW, [&] {
+          started.post();
+          unblock.wait();
+        })));
+    started.wait();
+
+    // This task can only run if shard 1 takes it.
+    folly::Baton<> done;
+    ASSERT_TRUE(pool0->blockingPutTask(std::make_unique<TestTask>(
+        StorageTaskThreadType::SLOW, [&] { done.post(); })));
+    EXPECT_TRUE(done.try_wait_for(std::chrono::seconds(10)));
+
+    unblock.post();
+    pool0->shutDown();
+    pool1->shutDown();
+    pool0->join();
+    pool1->join();
+  }
+}
+
 // A slow storage task that needs syncing should not be dropped on the floor
 // during shutdown
 TEST(StorageThreadPoolTest, SyncingShutdown) {
@@ -127,6 +127,7 @@ void shutdown_test_server(std::shared_ptr<ServerProcessor>& processor) {
   std::unique_ptr<Listener> connection_listener;
   std::unique_ptr<Listener> gossip_listener;
   std::unique_ptr<Listener> ssl_connection_listener;
+  std::unique_ptr<Listener> local_connection_listener;
   std::unique_ptr<Listener> server_to_server_listener;
   std::map<ClientNetworkPriority, std::unique_ptr<Listener>>
       listeners_per_priority;
@@ -152,6 +153,7 @@ void shutdown_test_server(std::shared_ptr<ServerProcessor>& processor) {
                   listeners_per_priority,
                   gossip_listener,
                   ssl_connection_listener,
+                  local_connection_listener,
                   server_to_server_listener,
                   connection_listener_loop,
                   gossip_listener_loop,
@@ -598,6 +598,39 @@ TEST_P(ZookeeperEpochStoreTest, LastCleanEpoch) {
   }
 }
 
+/**
+ *  Same as LastCleanEpoch, with znode writes batched into multi-ops. Several
+ *  requests per log (not serialized by the epoch store) make writes of the
+ *  same znode land in the same batch, which fails the whole batch and has its
+ *  writes retried one by one.
+ */
+TEST_P(ZookeeperEpochStoreTest, LastCleanEpochBatchedWrites) {
+  SettingsUpdater updater;
+  updater.registerSettings(processor->updateableSettings());
+  updater.setFromAdminCmd("epoch-store-write-batch-size", "4");
+  updater.setFromAdminCmd("epoch-store-write-batches-in-flight", "2");
+  updater.setFromAdminCmd("epoch-store-serialize-log-requests", "false");
+
+  LastCleanEpochTestRequest::completedRequestCnt.store(0);
+  const int requests_per_log = 3;
+  int n_requests_posted = 0;
+  for (logid_t logid : VALID_LOG_IDS) {
+    for (logid_t lid : {logid, MetaDataLog::metaDataLogID(logid)}) {
+      for (int i = 0; i < requests_per_log; ++i) {
+        std::unique_ptr<Request> rq =
+            std::make_unique<LastCleanEpochTestRequest>(epochstore.get(), lid);
+        ASSERT_EQ(0, processor->postRequest(rq));
+        ++n_requests_posted;
+      }
+    }
+  }
+
+  while (LastCleanEpochTestRequest::completedRequestCnt < n_requests_posted) {
+    /* sleep override */
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  }
+}
+
 /**
  *  Post NextEpochTestRequests for logs 1 and 2, then post another one
  *  for log 3, which does not exist. Wait for replies.
@@ -812,6 +845,47 @@ TEST_P(ZookeeperEpochStoreTest, MetaProperties) {
   }
 }
 
+/**
+ *  Concurrent LCE updates of the same log are run one after another, so none
+ *  of them fails with a version conflict and the last one wins.
+ */
+TEST_P(ZookeeperEpochStoreTest, LastCleanEpochSerializedPerLog) {
+  SettingsUpdater updater;
+  updater.registerSettings(processor->updateableSettings());
+  updater.setFromAdminCmd("epoch-store-serialize-log-requests", "true");
+
+  const int n_requests = 5;
+  const epoch_t base_lce(3559930028);
+  Semaphore sem;
+  for (int i = 1; i <= n_requests; ++i) {
+    const epoch_t lce(base_lce.val_ + i);
+    const lsn_t tail_lsn = compose_lsn(epoch_t(lce.val_ - 1), esn_t(1));
+    int rv = epochstore->setLastCleanEpoch(
+        logid_t(1),
+        lce,
+        gen_tail_record_with_payload(logid_t(1), tail_lsn, 1, OffsetMap()),
+        [&sem, lce](Status st, logid_t logid, epoch_t new_lce, TailRecord) {
+          EXPECT_EQ(E::OK, st);
+          EXPECT_EQ(logid_t(1), logid);
+          EXPECT_EQ(lce, new_lce);
+          sem.post();
+        });
+    ASSERT_EQ(0, rv);
+  }
+  for (int i = 0; i < n_requests; ++i) {
+    sem.wait();
+  }
+
+  int rv = epochstore->getLastCleanEpoch(
+      logid_t(1), [&](Status st, logid_t, epoch_t lce, TailRecord) {
+        EXPECT_EQ(E::OK, st);
+        EXPECT_EQ(epoch_t(base_lce.val_ + n_requests), lce);
+        sem.post();
+      });
+  ASSERT_EQ(0, rv);
+  sem.wait();
+}
+
 TEST_P(ZookeeperEpochStoreTest, LastCleanEpochWithTailRecord) {
   Semaphore sem;
 
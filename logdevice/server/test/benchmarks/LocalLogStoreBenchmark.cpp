@@ -0,0 +1,486 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include <chrono>
+#include <deque>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <folly/Benchmark.h>
+#include <folly/Format.h>
+#include <folly/experimental/TestUtil.h>
+#include <gflags/gflags.h>
+
+#include "logdevice/common/LocalLogStoreRecordFormat.h"
+#include "logdevice/common/debug.h"
+#include "logdevice/common/types_internal.h"
+#include "logdevice/server/locallogstore/PartitionedRocksDBStore.h"
+#include "logdevice/server/locallogstore/RocksDBCustomiser.h"
+#include "logdevice/server/locallogstore/RocksDBLogStoreConfig.h"
+#include "logdevice/server/locallogstore/WriteOps.h"
+
+using namespace facebook::logdevice;
+
+/**
+ * @file: benchmarks of the storage hot path: writing batches of records into
+ *        PartitionedRocksDBStore, seeking read iterators, findTime/findKey
+ *        and compacting partitions, as a function of the number of
+ *        partitions, plus encoding and parsing of the record header
+ *        (LocalLogStoreRecordFormat), which reads and compactions do for
+ *        every record.
+ *
+ *        Stores are created in --store_dir. The default is a tmpfs, which
+ *        measures CPU overhead of LogDevice and RocksDB; point it at an
+ *        NVMe-backed filesystem to include the device.
+ */
+
+DEFINE_string(store_dir,
+              "/dev/shm",
+              "Directory in which to create temporary stores.");
+DEFINE_int32(num_logs, 1000, "Number of logs records are spread across.");
+DEFINE_int32(record_size, 1024, "Payload size of each record, in bytes.");
+DEFINE_int32(write_batch_size,
+             64,
+             "Number of records in each writeMulti() call.");
+DEFINE_int32(records_per_partition,
+             4,
+             "Number of records of each log written to each partition of the "
+             "stores used by read benchmarks.");
+
+namespace {
+
+const copyset_t COPYSET = {ShardID(1, 0), ShardID(2, 0), ShardID(3, 0)};
+
+// Timestamps of records and keys are derived from the ESN, so that reads can
+// compute valid targets without looking at the store.
+const std::chrono::milliseconds BASE_TIMESTAMP(1000000000000);
+
+std::string findKeyFor(esn_t esn) {
+  return folly::sformat("{:016}", esn.val_);
+}
+
+// Forms the header, CSI entry and index entries of records and keeps them
+// alive until the write.
+class RecordBatch {
+ public:
+  void add(logid_t log, esn_t esn, const Slice& payload) {
+    const LocalLogStoreRecordFormat::flags_t flags =
+        LocalLogStoreRecordFormat::FLAG_SHARD_ID |
+        LocalLogStoreRecordFormat::FLAG_CHECKSUM_PARITY |
+        LocalLogStoreRecordFormat::FLAG_CUSTOM_KEY;
+    const std::chrono::milliseconds timestamp = BASE_TIMESTAMP +
+        std::chrono::milliseconds(esn.val_);
+    std::map<KeyType, std::string> keys{{KeyType::FINDKEY, findKeyFor(esn)}};
+
+    header_bufs_.emplace_back();
+    Slice header = LocalLogStoreRecordFormat::formRecordHeader(
+        timestamp.count(),
+        esn_t(0), // LNG
+        flags,
+        1, // wave
+        folly::Range<const ShardID*>(COPYSET.data(), COPYSET.size()),
+        OffsetMap(),
+        keys,
+        &header_bufs_.back());
+
+    csi_bufs_.emplace_back();
+    Slice csi_entry = LocalLogStoreRecordFormat::formCopySetIndexEntry(
+        1, // wave
+        COPYSET.data(),
+        COPYSET.size(),
+        LSN_INVALID, // block starting LSN
+        LocalLogStoreRecordFormat::formCopySetIndexFlags(flags),
+        &csi_bufs_.back());
+
+    uint64_t timestamp_big_endian = htobe64(timestamp.count());
+    std::vector<std::pair<char, std::string>> index_key_list;
+    index_key_list.emplace_back(
+        FIND_TIME_INDEX,
+        std::string(reinterpret_cast<const char*>(&timestamp_big_endian),
+                    sizeof(timestamp_big_endian)));
+    index_key_list.emplace_back(
+        FIND_KEY_INDEX, std::move(keys[KeyType::FINDKEY]));
+
+    ops_.emplace_back(log,
+                      compose_lsn(epoch_t(1), esn),
+                      header,
+                      payload,
+                      node_index_t(1), // coordinator
+                      LSN_INVALID,     // block starting LSN
+                      csi_entry,
+                      std::move(index_key_list),
+                      Durability::ASYNC_WRITE,
+                      false); // is_rebuilding
+    op_ptrs_.push_back(&ops_.back());
+  }
+
+  void write(LocalLogStore& store) {
+    int rv = store.writeMulti(op_ptrs_);
+    ld_check(rv == 0);
+  }
+
+  void clear() {
+    header_bufs_.clear();
+    csi_bufs_.clear();
+    ops_.clear();
+    op_ptrs_.clear();
+  }
+
+ private:
+  std::deque<std::string> header_bufs_;
+  std::deque<std::string> csi_bufs_;
+  std::deque<PutWriteOp> ops_;
+  std::vector<const WriteOp*> op_ptrs_;
+};
+
+// PartitionedRocksDBStore with a fake clock, so that each partition covers
+// the timestamps of the records written into it.
+class BenchmarkPartitionedStore : public PartitionedRocksDBStore {
+ public:
+  BenchmarkPartitionedStore(const std::string& path,
+                            RocksDBLogStoreConfig rocksdb_config,
+                            const SystemTimestamp* time)
+      : PartitionedRocksDBStore(0,
+                                1,
+                                path,
+                                std::move(rocksdb_config),
+                                /* config */ nullptr,
+                                RocksDBCustomiser::defaultInstance(),
+                                /* stats */ nullptr,
+                                /* io_tracing */ nullptr,
+                                DeferInit::YES),
+        time_(time) {
+    PartitionedRocksDBStore::init(nullptr);
+  }
+
+  SystemTimestamp currentTime() override {
+    return *time_;
+  }
+
+ private:
+  const SystemTimestamp* time_;
+};
+
+class BenchmarkStore {
+ public:
+  BenchmarkStore() : dir_("ld-storage-bench", FLAGS_store_dir) {
+    UpdateableSettings<RocksDBSettings> settings(
+        RocksDBSettings::defaultTestSettings());
+    UpdateableSettings<RebuildingSettings> rebuilding_settings;
+    RocksDBLogStoreConfig rocksdb_config(
+        settings, rebuilding_settings, nullptr, nullptr, nullptr);
+    rocksdb_config.createMergeOperator(0);
+
+    store_ = std::make_unique<BenchmarkPartitionedStore>(
+        dir_.path().string(), std::move(rocksdb_config), &time_);
+  }
+
+  ~BenchmarkStore() {
+    // Close RocksDB before the directory is removed.
+    store_.reset();
+  }
+
+  PartitionedRocksDBStore& store() {
+    return *store_;
+  }
+
+  // Fills `num_partitions` partitions with --records_per_partition records
+  // of each log. ESNs of records in partition p are in
+  // [p * records_per_partition + 1, (p + 1) * records_per_partition].
+  void populate(size_t num_partitions) {
+    const std::string payload(FLAGS_record_size, 'x');
+    RecordBatch batch;
+    esn_t::raw_type esn = 1;
+    for (size_t p = 0; p < num_partitions; ++p) {
+      if (p > 0) {
+        time_ =
+            SystemTimestamp(BASE_TIMESTAMP + std::chrono::milliseconds(esn));
+        store_->createPartition();
+      }
+      for (int i = 0; i < FLAGS_records_per_partition; ++i, ++esn) {
+        for (int log = 1; log <= FLAGS_num_logs; ++log) {
+          batch.add(logid_t(log), esn_t(esn), Slice::fromString(payload));
+        }
+        batch.write(*store_);
+        batch.clear();
+      }
+    }
+    int rv = store_->sync(Durability::ASYNC_WRITE);
+    ld_check(rv == 0);
+    max_esn_ = esn - 1;
+  }
+
+  esn_t::raw_type maxESN() const {
+    return max_esn_;
+  }
+
+ private:
+  folly::test::TemporaryDirectory dir_;
+  SystemTimestamp time_{BASE_TIMESTAMP};
+  std::unique_ptr<BenchmarkPartitionedStore> store_;
+  esn_t::raw_type max_esn_ = 0;
+};
+
+// Populating a store takes much longer than the benchmarks reading it, so
+// stores are populated once per partition count and shared by benchmarks.
+BenchmarkStore& populatedStore(size_t num_partitions) {
+  static std::map<size_t, std::unique_ptr<BenchmarkStore>> stores;
+  auto& store = stores[num_partitions];
+  if (!store) {
+    store = std::make_unique<BenchmarkStore>();
+    store->populate(num_partitions);
+  }
+  return *store;
+}
+
+std::mt19937_64& rng() {
+  static std::mt19937_64 rng(0xfaceb00c);
+  return rng;
+}
+
+logid_t randomLog() {
+  std::uniform_int_distribution<logid_t::raw_type> dis(1, FLAGS_num_logs);
+  return logid_t(dis(rng()));
+}
+
+esn_t randomESN(const BenchmarkStore& store) {
+  std::uniform_int_distribution<esn_t::raw_type> dis(1, store.maxESN());
+  return esn_t(dis(rng()));
+}
+
+} // namespace
+
+// Time per record, written in batches of --write_batch_size records spread
+// across --num_logs logs.
+BENCHMARK(WriteBatch, iters) {
+  std::unique_ptr<BenchmarkStore> store;
+  std::string payload;
+  RecordBatch batch;
+  BENCHMARK_SUSPEND {
+    store = std::make_unique<BenchmarkStore>();
+    payload.assign(FLAGS_record_size, 'x');
+  }
+
+  esn_t::raw_type esn = 1;
+  int log = 1;
+  for (size_t i = 0; i < iters;) {
+    for (int j = 0; j < FLAGS_write_batch_size && i < iters; ++j, ++i) {
+      batch.add(logid_t(log), esn_t(esn), Slice::fromString(payload));
+      if (++log > FLAGS_num_logs) {
+        log = 1;
+        ++esn;
+      }
+    }
+    batch.write(store->store());
+    batch.clear();
+  }
+
+  BENCHMARK_SUSPEND {
+    store.reset();
+  }
+}
+
+BENCHMARK_DRAW_LINE();
+
+void Seek(unsigned iters, size_t num_partitions) {
+  std::vector<std::unique_ptr<LocalLogStore::ReadIterator>> iterators;
+  std::vector<std::pair<logid_t, lsn_t>> targets;
+  BENCHMARK_SUSPEND {
+    BenchmarkStore& store = populatedStore(num_partitions);
+    LocalLogStore::ReadOptions options("LocalLogStoreBenchmark");
+    for (int log = 1; log <= FLAGS_num_logs; ++log) {
+      iterators.push_back(store.store().read(logid_t(log), options));
+    }
+    for (unsigned i = 0; i < iters; ++i) {
+      targets.emplace_back(
+          randomLog(), compose_lsn(epoch_t(1), randomESN(store)));
+    }
+  }
+
+  for (const auto& target : targets) {
+    auto& it = iterators[target.first.val_ - 1];
+    it->seek(target.second);
+    folly::doNotOptimizeAway(it->state());
+  }
+
+  BENCHMARK_SUSPEND {
+    iterators.clear();
+  }
+}
+
+BENCHMARK_PARAM(Seek, 1)
+BENCHMARK_PARAM(Seek, 8)
+BENCHMARK_PARAM(Seek, 64)
+
+BENCHMARK_DRAW_LINE();
+
+void FindTime(unsigned iters, size_t num_partitions) {
+  BenchmarkStore* store = nullptr;
+  std::vector<std::pair<logid_t, std::chrono::milliseconds>> targets;
+  BENCHMARK_SUSPEND {
+    store = &populatedStore(num_partitions);
+    for (unsigned i = 0; i < iters; ++i) {
+      targets.emplace_back(
+          randomLog(),
+          BASE_TIMESTAMP + std::chrono::milliseconds(randomESN(*store).val_));
+    }
+  }
+
+  for (const auto& target : targets) {
+    lsn_t lo, hi;
+    int rv = store->store().findTime(target.first, target.second, &lo, &hi);
+    folly::doNotOptimizeAway(rv);
+  }
+}
+
+BENCHMARK_PARAM(FindTime, 1)
+BENCHMARK_PARAM(FindTime, 8)
+BENCHMARK_PARAM(FindTime, 64)
+
+BENCHMARK_DRAW_LINE();
+
+void FindKey(unsigned iters, size_t num_partitions) {
+  BenchmarkStore* store = nullptr;
+  std::vector<std::pair<logid_t, std::string>> targets;
+  BENCHMARK_SUSPEND {
+    store = &populatedStore(num_partitions);
+    for (unsigned i = 0; i < iters; ++i) {
+      targets.emplace_back(randomLog(), findKeyFor(randomESN(*store)));
+    }
+  }
+
+  for (const auto& target : targets) {
+    lsn_t lo, hi;
+    int rv = store->store().findKey(target.first, target.second, &lo, &hi);
+    folly::doNotOptimizeAway(rv);
+  }
+}
+
+BENCHMARK_PARAM(FindKey, 1)
+BENCHMARK_PARAM(FindKey, 8)
+BENCHMARK_PARAM(FindKey, 64)
+
+BENCHMARK_DRAW_LINE();
+
+// Time per record to compact a partition holding --records_per_partition
+// records of each log.
+BENCHMARK_MULTI(CompactPartition, iters) {
+  size_t records = 0;
+  for (size_t i = 0; i < iters; ++i) {
+    std::unique_ptr<BenchmarkStore> store;
+    partition_id_t partition;
+    BENCHMARK_SUSPEND {
+      store = std::make_unique<BenchmarkStore>();
+      store->populate(1);
+      partition = store->store().getPartitionList()->nextID() - 1;
+      // Compact a partition that no longer receives writes, like the
+      // periodic compactions do.
+      store->store().createPartition();
+      records += FLAGS_num_logs * FLAGS_records_per_partition;
+    }
+
+    store->store().performCompaction(partition);
+
+    BENCHMARK_SUSPEND {
+      store.reset();
+    }
+  }
+  return records;
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(FormRecordHeader, iters) {
+  std::map<KeyType, std::string> keys{{KeyType::FINDKEY, findKeyFor(esn_t(1))}};
+  std::string buf;
+  for (size_t i = 0; i < iters; ++i) {
+    Slice header = LocalLogStoreRecordFormat::formRecordHeader(
+        BASE_TIMESTAMP.count() + i,
+        esn_t(0), // LNG
+        LocalLogStoreRecordFormat::FLAG_SHARD_ID |
+            LocalLogStoreRecordFormat::FLAG_CHECKSUM_PARITY |
+            LocalLogStoreRecordFormat::FLAG_CUSTOM_KEY,
+        1, // wave
+        folly::Range<const ShardID*>(COPYSET.data(), COPYSET.size()),
+        OffsetMap(),
+        keys,
+        &buf);
+    folly::doNotOptimizeAway(header.size);
+  }
+}
+
+BENCHMARK(ParseRecord, iters) {
+  std::string blob;
+  BENCHMARK_SUSPEND {
+    std::map<KeyType, std::string> keys{
+        {KeyType::FINDKEY, findKeyFor(esn_t(1))}};
+    Slice header = LocalLogStoreRecordFormat::formRecordHeader(
+        BASE_TIMESTAMP.count(),
+        esn_t(0), // LNG
+        LocalLogStoreRecordFormat::FLAG_SHARD_ID |
+            LocalLogStoreRecordFormat::FLAG_CHECKSUM_PARITY |
+            LocalLogStoreRecordFormat::FLAG_CUSTOM_KEY,
+        1, // wave
+        folly::Range<const ShardID*>(COPYSET.data(), COPYSET.size()),
+        OffsetMap(),
+        keys,
+        &blob);
+    ld_check(header.size == blob.size());
+    blob.append(FLAGS_record_size, 'x');
+  }
+
+  ShardID copyset[COPYSET_SIZE_MAX];
+  for (size_t i = 0; i < iters; ++i) {
+    std::chrono::milliseconds timestamp;
+    LocalLogStoreRecordFormat::flags_t flags;
+    copyset_size_t copyset_size;
+    Payload payload;
+    int rv = LocalLogStoreRecordFormat::parse(Slice::fromString(blob),
+                                              &timestamp,
+                                              nullptr, // LNG
+                                              &flags,
+                                              nullptr, // wave
+                                              &copyset_size,
+                                              copyset,
+                                              COPYSET_SIZE_MAX,
+                                              nullptr, // offsets
+                                              nullptr, // keys
+                                              &payload,
+                                              0); // this shard
+    ld_check(rv == 0);
+    folly::doNotOptimizeAway(payload.size());
+  }
+}
+
+// What the compaction filter does for each record it doesn't drop early.
+BENCHMARK(ParseTimestamp, iters) {
+  std::string blob;
+  BENCHMARK_SUSPEND {
+    LocalLogStoreRecordFormat::formRecordHeader(
+        BASE_TIMESTAMP.count(),
+        esn_t(0), // LNG
+        LocalLogStoreRecordFormat::FLAG_SHARD_ID |
+            LocalLogStoreRecordFormat::FLAG_CHECKSUM_PARITY,
+        1, // wave
+        folly::Range<const ShardID*>(COPYSET.data(), COPYSET.size()),
+        OffsetMap(),
+        std::map<KeyType, std::string>(),
+        &blob);
+    blob.append(FLAGS_record_size, 'x');
+  }
+
+  for (size_t i = 0; i < iters; ++i) {
+    std::chrono::milliseconds timestamp;
+    int rv = LocalLogStoreRecordFormat::parseTimestamp(
+        Slice::fromString(blob), &timestamp);
+    folly::doNotOptimizeAway(rv);
+    folly::doNotOptimizeAway(timestamp);
+  }
+}
@@ -25,8 +25,8 @@ const shard_index_t SHARD_IDX = 0;
 
 /**
  * @file: a benchmark for testing time spent on accessing LogStorageStateMap
- *        populated with different logids. The performance is directly related
- *        to the internal AtomicHashMap, and specifically, its hash function.
+ *        populated with different logids. Data logs are looked up in the
+ *        map's dense table, metadata logs in its fallback hash map.
  */
 
 // range 1..100000
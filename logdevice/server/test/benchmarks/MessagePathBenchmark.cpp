@@ -0,0 +1,265 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include <folly/Conv.h>
+#include <folly/Format.h>
+#include <folly/Singleton.h>
+#include <folly/String.h>
+#include <gflags/gflags.h>
+
+#include "logdevice/common/Request.h"
+#include "logdevice/common/Semaphore.h"
+#include "logdevice/common/Sender.h"
+#include "logdevice/common/Timestamp.h"
+#include "logdevice/common/Worker.h"
+#include "logdevice/common/protocol/Message.h"
+#include "logdevice/common/protocol/ProtocolWriter.h"
+#include "logdevice/common/request_util.h"
+#include "logdevice/common/test/TestUtil.h"
+#include "logdevice/common/types_internal.h"
+#include "logdevice/lib/ClientImpl.h"
+#include "logdevice/test/utils/IntegrationTestUtils.h"
+
+DEFINE_string(num_server_workers,
+              "ncores",
+              "number of worker threads for the node");
+DEFINE_string(num_client_workers,
+              "ncores",
+              "number of worker threads for the client");
+DEFINE_int32(
+    max_sends_per_iteration,
+    1000,
+    "a cap on the number of messages to send in a single event loop iteration");
+DEFINE_int64(messages, 1000000, "number of messages sent per configuration");
+DEFINE_string(message_sizes,
+              "0,100,1024,65536",
+              "comma-separated list of message body sizes to run with, in "
+              "bytes");
+DEFINE_string(checksumming,
+              "off,on",
+              "comma-separated list of protocol checksumming modes to run "
+              "with");
+DEFINE_string(tls, "off,on", "comma-separated list of TLS modes to run with");
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file Loopback benchmark of the message path: Sender, Connection and
+ *       ProtocolHandler on the client side, and the same stack plus message
+ *       parsing and dispatch on a single logdeviced.
+ *
+ *       For each combination of --message_sizes, --checksumming and --tls,
+ *       creates a client with the corresponding settings and sends
+ *       --messages messages with a body of the given size to the node, spread
+ *       over all client workers. Prints messages/sec and bytes/sec per client
+ *       worker until it sent its share, and for the whole run until the node
+ *       received all the messages.
+ *
+ *       Messages pretend to be TEST messages, which the node parses and
+ *       drops, so the numbers exclude any storage or sequencing work. Body
+ *       sizes of about 100 bytes and 64KB stand for small and large STORE or
+ *       RECORD messages.
+ */
+
+namespace {
+
+// Pretends to be TEST_Message, with a body of a given size. The recipient
+// deserializes and discards it as a TEST_Message.
+class SizedTestMessage : public Message {
+ public:
+  explicit SizedTestMessage(const std::string& body)
+      : Message(MessageType::TEST, TrafficClass::REBUILD), body_(body) {}
+
+  void serialize(ProtocolWriter& writer) const override {
+    writer.write(body_.data(), body_.size());
+  }
+  Disposition onReceived(const Address& /*from*/) override {
+    return Disposition::NORMAL;
+  }
+
+ private:
+  const std::string& body_;
+};
+
+std::vector<std::string> parseList(const std::string& flag) {
+  std::vector<std::string> res;
+  folly::split(',', flag, res, /* ignoreEmpty */ true);
+  return res;
+}
+
+std::unique_ptr<IntegrationTestUtils::Cluster> createCluster() {
+  return IntegrationTestUtils::ClusterFactory()
+      .setParam("--num-workers", FLAGS_num_server_workers)
+      .setParam("--ssl-cert-path", TEST_SSL_FILE("logdevice_test_valid.cert"))
+      .setParam("--ssl-key-path", TEST_SSL_FILE("logdevice_test.key"))
+      .setParam("--ssl-ca-path", TEST_SSL_FILE("logdevice_test_valid_ca.cert"))
+      .create(1);
+}
+
+std::shared_ptr<Client> createClient(IntegrationTestUtils::Cluster& cluster,
+                                     bool checksumming,
+                                     bool tls) {
+  std::unique_ptr<ClientSettings> settings{ClientSettings::create()};
+  std::vector<std::pair<std::string, std::string>> values = {
+      {"num-workers", FLAGS_num_client_workers},
+      {"execute-requests", "1"},
+      {"checksumming-enabled", checksumming ? "true" : "false"}};
+  if (tls) {
+    values.insert(
+        values.end(),
+        {{"ssl-cert-path", TEST_SSL_FILE("logdevice_test_valid.cert")},
+         {"ssl-key-path", TEST_SSL_FILE("logdevice_test.key")},
+         {"ssl-ca-path", TEST_SSL_FILE("logdevice_test_valid_ca.cert")},
+         {"ssl-load-client-cert", "true"},
+         {"ssl-boundary", "node"}});
+  }
+  for (const auto& kv : values) {
+    if (settings->set(kv.first.c_str(), kv.second.c_str()) != 0) {
+      ld_error("Unable to set client %s to %s",
+               kv.first.c_str(),
+               kv.second.c_str());
+      exit(1);
+    }
+  }
+  return cluster.createClient(getDefaultTestTimeout(), std::move(settings));
+}
+
+void runConfiguration(IntegrationTestUtils::Cluster& cluster,
+                      size_t message_size,
+                      bool checksumming,
+                      bool tls) {
+  auto client = createClient(cluster, checksumming, tls);
+  Processor* processor =
+      &checked_downcast<ClientImpl*>(client.get())->getProcessor();
+  const std::string body(message_size, 'm');
+
+  auto worker_counter = run_on_all_workers(processor, [&]() { return 1; });
+  size_t num_workers =
+      std::accumulate(worker_counter.begin(), worker_counter.end(), 0);
+  auto received = [&]() -> uint64_t {
+    return cluster.getNode(0).stats()["message_received.TEST"];
+  };
+
+  // Make sure all workers are connected before starting the clock.
+  const uint64_t received_before = received() + num_workers;
+  run_on_all_workers(processor, [&]() {
+    Worker::onThisThread()->sender().sendMessage(
+        std::make_unique<SizedTestMessage>(body), Address(NodeID(0)));
+    return 0;
+  });
+  wait_until("connections established",
+             [&]() { return received() >= received_before; });
+
+  // Separate work among worker threads
+  std::vector<size_t> per_worker_messages;
+  size_t remaining_messages = FLAGS_messages;
+  for (size_t remaining_workers = num_workers; remaining_workers > 0;
+       --remaining_workers) {
+    size_t wm = remaining_messages / remaining_workers;
+    per_worker_messages.push_back(wm);
+    remaining_messages -= wm;
+  }
+  std::vector<size_t> per_worker_to_send = per_worker_messages;
+  std::vector<int64_t> per_worker_usec(num_workers);
+
+  // Body of the main request running on the workers. Posts itself to the
+  // worker again from time to time to yield to the event loop for flushing
+  Semaphore sem;
+  auto start = SteadyTimestamp::now();
+  std::function<int()> callback_fn;
+  callback_fn = [&]() {
+    auto w = Worker::onThisThread();
+    size_t& to_send = per_worker_to_send.at(w->idx_.val());
+    size_t sent_in_this_iteration = 0;
+    Address addr(NodeID(0));
+    while (to_send) {
+      int rv = w->sender().sendMessage(
+          std::make_unique<SizedTestMessage>(body), addr);
+      if (rv == 0) {
+        --to_send;
+        ++sent_in_this_iteration;
+      }
+      if (rv != 0 || sent_in_this_iteration >= FLAGS_max_sends_per_iteration) {
+        // Either our send failed or we sent enough in this iteration - post
+        // another request and yield to the event loop
+        auto callback_copy = callback_fn;
+        run_on_worker_nonblocking(processor,
+                                  w->idx_,
+                                  w->worker_type_,
+                                  RequestType::ADMIN_CMD_UTIL_INTERNAL,
+                                  std::move(callback_copy),
+                                  true);
+        return 0;
+      }
+    }
+    per_worker_usec.at(w->idx_.val()) = usec_since(start);
+    sem.post();
+    return 0;
+  };
+
+  start = SteadyTimestamp::now();
+  run_on_all_workers(processor, callback_fn);
+  for (size_t i = 0; i < num_workers; ++i) {
+    sem.wait();
+  }
+
+  const std::string config =
+      folly::sformat("size={} checksumming={} tls={}",
+                     message_size,
+                     checksumming ? "on" : "off",
+                     tls ? "on" : "off");
+  auto output = [&](const std::string& what, size_t messages, int64_t usec) {
+    usec = std::max<int64_t>(usec, 1);
+    ld_info("%s %s: %zu messages in %ld usec, %.3fM msgs/sec, %.1f MB/sec",
+            config.c_str(),
+            what.c_str(),
+            messages,
+            usec,
+            double(messages) / usec,
+            double(messages) * message_size / usec);
+  };
+  for (size_t i = 0; i < num_workers; ++i) {
+    output(folly::sformat("sent by worker {}", i),
+           per_worker_messages[i],
+           per_worker_usec[i]);
+  }
+  wait_until("all messages received", [&]() {
+    return received() - received_before >= uint64_t(FLAGS_messages);
+  });
+  output("sent and received", FLAGS_messages, usec_since(start));
+}
+
+} // namespace
+
+void runBenchmark() {
+  auto cluster = createCluster();
+  for (const std::string& size : parseList(FLAGS_message_sizes)) {
+    for (const std::string& checksumming : parseList(FLAGS_checksumming)) {
+      for (const std::string& tls : parseList(FLAGS_tls)) {
+        runConfiguration(*cluster,
+                         folly::to<size_t>(size),
+                         checksumming == "on",
+                         tls == "on");
+      }
+    }
+  }
+}
+
+}} // namespace facebook::logdevice
+
+int main(int argc, char** argv) {
+  folly::SingletonVault::singleton()->registrationComplete();
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  facebook::logdevice::runBenchmark();
+  return 0;
+}
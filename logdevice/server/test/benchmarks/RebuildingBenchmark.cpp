@@ -0,0 +1,408 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <folly/Format.h>
+#include <folly/Singleton.h>
+#include <folly/String.h>
+#include <gflags/gflags.h>
+#include <unistd.h>
+
+#include "logdevice/common/Semaphore.h"
+#include "logdevice/common/debug.h"
+#include "logdevice/common/stats/Histogram.h"
+#include "logdevice/common/test/TestUtil.h"
+#include "logdevice/include/Client.h"
+#include "logdevice/include/Err.h"
+#include "logdevice/test/utils/IntegrationTestUtils.h"
+
+DEFINE_int32(nodes, 5, "number of nodes in the cluster");
+DEFINE_int32(shards, 2, "number of shards per node");
+DEFINE_int32(replication, 3, "replication factor of data logs");
+DEFINE_int32(logs, 16, "number of data logs");
+DEFINE_int32(record_size, 1024, "payload size of each record, in bytes");
+DEFINE_int64(data_mb, 256, "total payload written before rebuilding, in MB");
+DEFINE_int32(fill_window, 1000, "max appends in flight while filling");
+DEFINE_int32(rebuild_node, 1, "node whose shard gets rebuilt");
+DEFINE_int32(rebuild_shard, 0, "shard that gets rebuilt");
+DEFINE_double(foreground_appends_per_sec,
+              100,
+              "rate of appends sent while rebuilding, to measure the impact "
+              "of rebuilding on foreground latency; 0 to disable");
+DEFINE_int32(baseline_sec,
+             5,
+             "seconds of foreground traffic reported before rebuilding starts");
+DEFINE_int32(report_interval_ms, 1000, "how often to print a report line");
+DEFINE_int32(timeout_sec, 3600, "give up if rebuilding takes longer");
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file Measures how fast a shard rebuilds, outside of any correctness test.
+ *
+ *       Fills a local cluster with --data_mb of records, kills
+ *       --rebuild_node, wipes its --rebuild_shard and requests rebuilding of
+ *       that shard. While the shard rebuilds, prints one line per
+ *       --report_interval_ms with:
+ *        - records and bytes rebuilt per second, summed over donors, from the
+ *          records_rebuilt and bytes_rebuilt stats,
+ *        - CPU utilization and bytes read and written per second, summed over
+ *          donor processes, from /proc,
+ *        - latency percentiles of foreground appends sent at a steady
+ *          --foreground_appends_per_sec, measured from their scheduled start
+ *          time so that stalls are not hidden.
+ *       The same foreground report is printed for --baseline_sec before
+ *       rebuilding starts, for comparison.
+ *
+ *       Run with a release build, with enough disk space for --data_mb times
+ *       --replication in the IntegrationTestUtils data directory.
+ */
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const logid_t FIRST_LOG(1);
+
+// Resource usage of a process, from /proc/<pid>.
+struct ProcessUsage {
+  double cpu_sec = 0;
+  uint64_t read_bytes = 0;
+  uint64_t write_bytes = 0;
+};
+
+ProcessUsage getProcessUsage(pid_t pid) {
+  ProcessUsage usage;
+  std::ifstream stat_file(folly::sformat("/proc/{}/stat", pid));
+  std::string stat;
+  std::getline(stat_file, stat);
+  // Fields after the command name, which is in parentheses and may contain
+  // spaces. utime and stime are the 14th and 15th fields of the file.
+  auto pos = stat.rfind(')');
+  if (pos != std::string::npos) {
+    std::vector<folly::StringPiece> fields;
+    folly::split(' ', folly::StringPiece(stat).subpiece(pos + 2), fields);
+    if (fields.size() > 12) {
+      usage.cpu_sec = (folly::to<double>(fields[11]) +
+                       folly::to<double>(fields[12])) /
+          sysconf(_SC_CLK_TCK);
+    }
+  }
+
+  std::ifstream io_file(folly::sformat("/proc/{}/io", pid));
+  std::string key;
+  uint64_t value;
+  while (io_file >> key >> value) {
+    if (key == "read_bytes:") {
+      usage.read_bytes = value;
+    } else if (key == "write_bytes:") {
+      usage.write_bytes = value;
+    }
+  }
+  return usage;
+}
+
+// Counters of all donors, summed.
+struct DonorCounters {
+  int64_t records_rebuilt = 0;
+  int64_t bytes_rebuilt = 0;
+  ProcessUsage usage;
+};
+
+DonorCounters getDonorCounters(IntegrationTestUtils::Cluster& cluster) {
+  DonorCounters res;
+  for (auto& it : cluster.getNodes()) {
+    auto& node = *it.second;
+    if (it.first == FLAGS_rebuild_node || !node.isRunning()) {
+      continue;
+    }
+    for (const auto& kv : node.stats()) {
+      // Per-shard stats are named <stat>.shard<idx>.
+      if (folly::StringPiece(kv.first).startsWith("records_rebuilt.shard")) {
+        res.records_rebuilt += kv.second;
+      } else if (folly::StringPiece(kv.first).startsWith(
+                     "bytes_rebuilt.shard")) {
+        res.bytes_rebuilt += kv.second;
+      }
+    }
+    auto usage = getProcessUsage(node.logdeviced_->pid());
+    res.usage.cpu_sec += usage.cpu_sec;
+    res.usage.read_bytes += usage.read_bytes;
+    res.usage.write_bytes += usage.write_bytes;
+  }
+  return res;
+}
+
+void fill(Client& client) {
+  const uint64_t num_records =
+      (uint64_t(FLAGS_data_mb) << 20) / std::max(1, FLAGS_record_size);
+  ld_info("Writing %" PRIu64 " records of %d bytes to %d logs",
+          num_records,
+          FLAGS_record_size,
+          FLAGS_logs);
+  Semaphore window(FLAGS_fill_window);
+  std::atomic<uint64_t> failed{0};
+  const std::string payload(FLAGS_record_size, 'x');
+  auto start = Clock::now();
+  for (uint64_t i = 0; i < num_records; ++i) {
+    window.wait();
+    logid_t log(FIRST_LOG.val() + i % FLAGS_logs);
+    int rv = client.append(
+        log, payload, [&](Status st, const DataRecord& /* record */) {
+          if (st != E::OK) {
+            ++failed;
+          }
+          window.post();
+        });
+    if (rv != 0) {
+      ++failed;
+      window.post();
+    }
+  }
+  for (int i = 0; i < FLAGS_fill_window; ++i) {
+    window.wait();
+  }
+  double sec = std::chrono::duration<double>(Clock::now() - start).count();
+  ld_info("Wrote %" PRIu64 " records in %.1fs, %" PRIu64 " failed",
+          num_records,
+          sec,
+          failed.load());
+}
+
+// Sends appends at a steady rate, regardless of how long previous appends
+// take, and records their latency from the time they were scheduled.
+class ForegroundWriter {
+ public:
+  explicit ForegroundWriter(std::shared_ptr<Client> client)
+      : client_(std::move(client)) {
+    if (FLAGS_foreground_appends_per_sec > 0) {
+      thread_ = std::thread([this] { run(); });
+    }
+  }
+
+  ~ForegroundWriter() {
+    stop_ = true;
+    if (thread_.joinable()) {
+      thread_.join();
+    }
+    // Wait for callbacks referencing this object.
+    while (in_flight_.load() > 0) {
+      /* sleep override */
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+  }
+
+  // Latency percentiles and failures since the previous call.
+  std::string report() {
+    LogLinearLatencyHistogram total;
+    total.assign(latency_us_);
+    LogLinearLatencyHistogram interval;
+    interval.assign(total);
+    interval.subtract(prev_latency_us_);
+    prev_latency_us_.assign(total);
+
+    const std::array<double, 3> pcts = {.5, .99, 1.};
+    std::array<int64_t, 3> values;
+    uint64_t count;
+    interval.estimatePercentiles(
+        pcts.data(), pcts.size(), values.data(), &count);
+    return folly::sformat("fg_appends={} fg_failed={} fg_p50_ms={:.1f} "
+                          "fg_p99_ms={:.1f} fg_max_ms={:.1f}",
+                          count,
+                          failed_.exchange(0),
+                          values[0] / 1e3,
+                          values[1] / 1e3,
+                          values[2] / 1e3);
+  }
+
+ private:
+  void run() {
+    const auto start = Clock::now();
+    const std::string payload(FLAGS_record_size, 'y');
+    for (uint64_t i = 0; !stop_; ++i) {
+      auto intended = start +
+          std::chrono::duration_cast<Clock::duration>(
+              std::chrono::duration<double>(
+                  i / FLAGS_foreground_appends_per_sec));
+      std::this_thread::sleep_until(intended);
+      logid_t log(FIRST_LOG.val() + i % FLAGS_logs);
+      ++in_flight_;
+      int rv = client_->append(
+          log, payload, [this, intended](Status st, const DataRecord&) {
+            if (st == E::OK) {
+              latency_us_.add(
+                  std::chrono::duration_cast<std::chrono::microseconds>(
+                      Clock::now() - intended)
+                      .count());
+            } else {
+              ++failed_;
+            }
+            --in_flight_;
+          });
+      if (rv != 0) {
+        ++failed_;
+        --in_flight_;
+      }
+    }
+  }
+
+  std::shared_ptr<Client> client_;
+  std::thread thread_;
+  std::atomic<bool> stop_{false};
+  std::atomic<uint64_t> in_flight_{0};
+  std::atomic<uint64_t> failed_{0};
+  LogLinearLatencyHistogram latency_us_;
+  // Value of latency_us_ at the previous report().
+  LogLinearLatencyHistogram prev_latency_us_;
+};
+
+int run() {
+  auto log_attrs = logsconfig::LogAttributes()
+                       .with_replicationFactor(FLAGS_replication)
+                       .with_syncedCopies(0)
+                       .with_maxWritesInFlight(FLAGS_fill_window);
+  auto internal_log_attrs =
+      logsconfig::LogAttributes().with_replicationFactor(
+          std::min(FLAGS_replication, FLAGS_nodes - 1));
+  auto cluster =
+      IntegrationTestUtils::ClusterFactory()
+          .setParam("--disable-rebuilding", "false")
+          .setParam("--disabled-retry-interval", "0s")
+          .setParam("--gossip-enabled", "true")
+          .setParam("--rocksdb-partitioned", "true")
+          .setLogGroupName("rebuilding-benchmark")
+          .setLogAttributes(log_attrs)
+          .setEventLogAttributes(internal_log_attrs)
+          .setMaintenanceLogAttributes(internal_log_attrs)
+          .setNumDBShards(FLAGS_shards)
+          .setNumLogs(FLAGS_logs)
+          .useStandaloneAdminServer(true)
+          .create(FLAGS_nodes);
+  if (!cluster) {
+    ld_error("Failed to create cluster");
+    return 1;
+  }
+  cluster->waitUntilAllSequencersQuiescent();
+  std::shared_ptr<Client> client = cluster->createClient();
+  cluster->getAdminServer()->waitUntilFullyLoaded();
+
+  fill(*client);
+
+  ForegroundWriter foreground(client);
+  auto print_report = [&](const char* phase,
+                          Clock::time_point start,
+                          const DonorCounters& prev,
+                          const DonorCounters& cur,
+                          double interval_sec) {
+    double elapsed =
+        std::chrono::duration<double>(Clock::now() - start).count();
+    std::cout << folly::sformat(
+                     "{} t={:.1f}s rebuilt_records_per_sec={:.0f} "
+                     "rebuilt_bytes_per_sec={:.0f} donor_cpu_pct={:.1f} "
+                     "donor_read_bytes_per_sec={:.0f} "
+                     "donor_write_bytes_per_sec={:.0f} {}",
+                     phase,
+                     elapsed,
+                     (cur.records_rebuilt - prev.records_rebuilt) /
+                         interval_sec,
+                     (cur.bytes_rebuilt - prev.bytes_rebuilt) / interval_sec,
+                     100 * (cur.usage.cpu_sec - prev.usage.cpu_sec) /
+                         interval_sec,
+                     (cur.usage.read_bytes - prev.usage.read_bytes) /
+                         interval_sec,
+                     (cur.usage.write_bytes - prev.usage.write_bytes) /
+                         interval_sec,
+                     foreground.report())
+              << std::endl;
+  };
+  const std::chrono::milliseconds interval(FLAGS_report_interval_ms);
+  const double interval_sec = FLAGS_report_interval_ms / 1e3;
+
+  // Baseline, without rebuilding.
+  auto start = Clock::now();
+  DonorCounters prev = getDonorCounters(*cluster);
+  while (Clock::now() - start < std::chrono::seconds(FLAGS_baseline_sec)) {
+    /* sleep override */
+    std::this_thread::sleep_for(interval);
+    DonorCounters cur = getDonorCounters(*cluster);
+    print_report("baseline", start, prev, cur, interval_sec);
+    prev = cur;
+  }
+
+  const ShardID shard(FLAGS_rebuild_node, FLAGS_rebuild_shard);
+  ld_info("Killing N%d and wiping shard %d", shard.node(), shard.shard());
+  cluster->getNode(shard.node()).kill();
+  cluster->getNode(shard.node()).wipeShard(shard.shard());
+  if (!cluster->applyInternalMaintenance(
+          *client, shard.node(), shard.shard(), "rebuilding benchmark")) {
+    ld_error("Failed to request rebuilding: %s", error_name(err));
+    return 1;
+  }
+
+  // Owned by the waiter thread too, since it's detached on timeout.
+  auto done = std::make_shared<std::atomic<bool>>(false);
+  std::thread waiter([client, shard, done] {
+    IntegrationTestUtils::waitUntilShardHasEventLogState(
+        client, shard, AuthoritativeStatus::AUTHORITATIVE_EMPTY, true);
+    *done = true;
+  });
+
+  const DonorCounters initial = getDonorCounters(*cluster);
+  prev = initial;
+  start = Clock::now();
+  while (!*done &&
+         Clock::now() - start < std::chrono::seconds(FLAGS_timeout_sec)) {
+    /* sleep override */
+    std::this_thread::sleep_for(interval);
+    DonorCounters cur = getDonorCounters(*cluster);
+    print_report("rebuilding", start, prev, cur, interval_sec);
+    prev = cur;
+  }
+  const double total_sec =
+      std::chrono::duration<double>(Clock::now() - start).count();
+  if (!*done) {
+    ld_error("Rebuilding didn't complete in %d seconds", FLAGS_timeout_sec);
+    // The waiter thread can't be interrupted.
+    waiter.detach();
+    return 1;
+  }
+  waiter.join();
+
+  const DonorCounters final_counters = getDonorCounters(*cluster);
+  std::cout << folly::sformat(
+                   "done rebuilding_sec={:.1f} records_rebuilt={} "
+                   "bytes_rebuilt={} avg_records_per_sec={:.0f} "
+                   "avg_bytes_per_sec={:.0f}",
+                   total_sec,
+                   final_counters.records_rebuilt - initial.records_rebuilt,
+                   final_counters.bytes_rebuilt - initial.bytes_rebuilt,
+                   (final_counters.records_rebuilt - initial.records_rebuilt) /
+                       total_sec,
+                   (final_counters.bytes_rebuilt - initial.bytes_rebuilt) /
+                       total_sec)
+            << std::endl;
+  return 0;
+}
+
+} // namespace
+
+}} // namespace facebook::logdevice
+
+int main(int argc, char** argv) {
+  folly::SingletonVault::singleton()->registrationComplete();
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  return facebook::logdevice::run();
+}
@@ -0,0 +1,371 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <folly/Format.h>
+#include <folly/Singleton.h>
+#include <gflags/gflags.h>
+
+#include "logdevice/common/Semaphore.h"
+#include "logdevice/common/debug.h"
+#include "logdevice/common/test/TestUtil.h"
+#include "logdevice/common/types_internal.h"
+#include "logdevice/include/Client.h"
+#include "logdevice/include/Err.h"
+#include "logdevice/test/utils/IntegrationTestUtils.h"
+
+DEFINE_int32(nodes, 5, "number of nodes in the cluster");
+DEFINE_int32(replication, 2, "replication factor of data logs");
+DEFINE_int32(logs, 1000, "number of data logs");
+DEFINE_int32(kill_node, 1, "node that gets killed");
+DEFINE_double(appends_per_sec,
+              1000,
+              "total rate of background appends, spread over all logs; "
+              "0 to disable");
+DEFINE_int32(probe_window,
+             10000,
+             "max probe appends in flight; with more logs than this, "
+             "time-to-first-append includes waiting for the window");
+DEFINE_int32(retry_delay_ms, 100, "delay before retrying a failed probe");
+DEFINE_int32(report_interval_ms, 1000, "how often to print a report line");
+DEFINE_int32(timeout_sec, 600, "give up if failover takes longer");
+
+namespace facebook { namespace logdevice {
+
+/**
+ * @file Measures how long it takes for logs to become writable again after
+ *       their sequencer node dies, and how that scales with the number of
+ *       logs.
+ *
+ *       Starts a local cluster with hash-based sequencer placement and
+ *       --logs logs, sends background appends at --appends_per_sec and
+ *       appends once to every log so that all sequencers are active. Then
+ *       kills --kill_node and immediately appends to every log again,
+ *       retrying failed appends every --retry_delay_ms, until each log
+ *       accepts an append. While doing so, prints one line per
+ *       --report_interval_ms with the number of logs that accepted an append
+ *       so far and the rate of sequencer activations and completed log
+ *       recoveries on the surviving nodes.
+ *
+ *       In the end, prints the distribution of time-to-first-successful-append
+ *       since the kill, both for all logs and for the logs that moved to a
+ *       new epoch (i.e. that failed over), and the log recovery duration
+ *       distribution of each surviving node from its log_recovery_latency
+ *       histogram. Run with increasing --logs, up to 100k, to see where
+ *       failover stops scaling linearly.
+ */
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const logid_t FIRST_LOG(1);
+
+logid_t logAt(size_t idx) {
+  return logid_t(FIRST_LOG.val() + idx);
+}
+
+// Sends open-loop appends at --appends_per_sec, round robin over all logs.
+class BackgroundWriter {
+ public:
+  explicit BackgroundWriter(std::shared_ptr<Client> client)
+      : client_(std::move(client)) {
+    if (FLAGS_appends_per_sec > 0) {
+      thread_ = std::thread([this] { run(); });
+    }
+  }
+
+  ~BackgroundWriter() {
+    stop_ = true;
+    if (thread_.joinable()) {
+      thread_.join();
+    }
+    while (in_flight_.load() > 0) {
+      /* sleep override */
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+  }
+
+  // Number of failed appends since the previous call.
+  uint64_t failed() {
+    return failed_.exchange(0);
+  }
+
+ private:
+  void run() {
+    const auto start = Clock::now();
+    const std::string payload(100, 'b');
+    for (uint64_t i = 0; !stop_; ++i) {
+      std::this_thread::sleep_until(
+          start +
+          std::chrono::duration_cast<Clock::duration>(
+              std::chrono::duration<double>(i / FLAGS_appends_per_sec)));
+      ++in_flight_;
+      int rv = client_->append(
+          logAt(i % FLAGS_logs), payload, [this](Status st, const DataRecord&) {
+            if (st != E::OK) {
+              ++failed_;
+            }
+            --in_flight_;
+          });
+      if (rv != 0) {
+        ++failed_;
+        --in_flight_;
+      }
+    }
+  }
+
+  std::shared_ptr<Client> client_;
+  std::thread thread_;
+  std::atomic<bool> stop_{false};
+  std::atomic<uint64_t> in_flight_{0};
+  std::atomic<uint64_t> failed_{0};
+};
+
+// Appends once to every log, retrying failed appends until each log accepts
+// one, and records when that happened and in which epoch.
+class Prober {
+ public:
+  explicit Prober(Client& client)
+      : client_(client),
+        window_(FLAGS_probe_window),
+        first_success_(FLAGS_logs, Clock::time_point::max()),
+        epochs_(FLAGS_logs, EPOCH_INVALID) {}
+
+  // Calls `report` every --report_interval_ms until all logs accepted an
+  // append or --timeout_sec passes. Returns false on timeout.
+  bool run(std::function<void(size_t succeeded)> report) {
+    start_ = Clock::now();
+    auto next_report = start_ + interval();
+    for (size_t idx = 0; idx < size_t(FLAGS_logs); ++idx) {
+      window_.wait();
+      probe(idx);
+    }
+    while (succeeded_.load() < size_t(FLAGS_logs)) {
+      if (Clock::now() - start_ > std::chrono::seconds(FLAGS_timeout_sec)) {
+        return false;
+      }
+      /* sleep override */
+      std::this_thread::sleep_for(
+          std::chrono::milliseconds(FLAGS_retry_delay_ms));
+      std::vector<size_t> retry;
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        retry.swap(retry_);
+      }
+      for (size_t idx : retry) {
+        window_.wait();
+        probe(idx);
+      }
+      if (Clock::now() >= next_report) {
+        report(succeeded_.load());
+        next_report += interval();
+      }
+    }
+    // Wait for the window to drain, so that no callbacks run after this.
+    for (int i = 0; i < FLAGS_probe_window; ++i) {
+      window_.wait();
+    }
+    return true;
+  }
+
+  Clock::time_point startTime() const {
+    return start_;
+  }
+  // Indexed by log; Clock::time_point::max() if the log didn't accept any
+  // append.
+  const std::vector<Clock::time_point>& firstSuccess() const {
+    return first_success_;
+  }
+  // Epoch of the first successful append to each log.
+  const std::vector<epoch_t>& epochs() const {
+    return epochs_;
+  }
+
+ private:
+  static std::chrono::milliseconds interval() {
+    return std::chrono::milliseconds(FLAGS_report_interval_ms);
+  }
+
+  void probe(size_t idx) {
+    auto cb = [this, idx](Status st, const DataRecord& record) {
+      if (st == E::OK) {
+        first_success_[idx] = Clock::now();
+        epochs_[idx] = lsn_to_epoch(record.attrs.lsn);
+        ++succeeded_;
+      } else {
+        std::lock_guard<std::mutex> lock(mutex_);
+        retry_.push_back(idx);
+      }
+      window_.post();
+    };
+    if (client_.append(logAt(idx), "probe", cb) != 0) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      retry_.push_back(idx);
+      window_.post();
+    }
+  }
+
+  Client& client_;
+  Semaphore window_;
+  Clock::time_point start_;
+  std::vector<Clock::time_point> first_success_;
+  std::vector<epoch_t> epochs_;
+  std::atomic<size_t> succeeded_{0};
+
+  std::mutex mutex_;
+  // Logs whose probe failed and needs to be retried.
+  std::vector<size_t> retry_;
+};
+
+// Sum of the given stat over all running nodes.
+int64_t sumStat(IntegrationTestUtils::Cluster& cluster,
+                const std::string& name) {
+  int64_t sum = 0;
+  for (auto& it : cluster.getNodes()) {
+    if (it.second->isRunning()) {
+      auto stats = it.second->stats();
+      auto stat = stats.find(name);
+      if (stat != stats.end()) {
+        sum += stat->second;
+      }
+    }
+  }
+  return sum;
+}
+
+std::string percentiles(std::vector<double> values) {
+  if (values.empty()) {
+    return "count=0";
+  }
+  std::sort(values.begin(), values.end());
+  auto at = [&](double p) {
+    return values[std::min(values.size() - 1, size_t(p * values.size()))];
+  };
+  return folly::sformat("count={} p50={:.3f} p90={:.3f} p99={:.3f} max={:.3f}",
+                        values.size(),
+                        at(.5),
+                        at(.9),
+                        at(.99),
+                        values.back());
+}
+
+int run() {
+  auto log_attrs =
+      logsconfig::LogAttributes().with_replicationFactor(FLAGS_replication);
+  auto nodes_configuration = createSimpleNodesConfig(FLAGS_nodes);
+  auto cluster = IntegrationTestUtils::ClusterFactory()
+                     .setNodes(nodes_configuration)
+                     .useHashBasedSequencerAssignment()
+                     .setLogGroupName("sequencer-failover-benchmark")
+                     .setLogAttributes(log_attrs)
+                     .setNumLogs(FLAGS_logs)
+                     .create(FLAGS_nodes);
+  if (!cluster) {
+    ld_error("Failed to create cluster");
+    return 1;
+  }
+  for (node_index_t idx = 0; idx < FLAGS_nodes; ++idx) {
+    cluster->waitUntilGossip(/* alive */ true, idx);
+  }
+  std::shared_ptr<Client> client = cluster->createClient();
+
+  BackgroundWriter background(client);
+
+  ld_info("Activating sequencers of %d logs", FLAGS_logs);
+  Prober activation(*client);
+  if (!activation.run([](size_t) {})) {
+    ld_error("Not all logs accepted an append in %d seconds",
+             FLAGS_timeout_sec);
+    return 1;
+  }
+
+  ld_info("Killing N%d", FLAGS_kill_node);
+  cluster->getNode(FLAGS_kill_node).kill();
+  // Only count background failures that happen after the kill.
+  background.failed();
+
+  int64_t prev_activations = sumStat(*cluster, "sequencer_activations");
+  int64_t prev_recoveries = sumStat(*cluster, "recovery_success");
+  Prober failover(*client);
+  const double interval_sec = FLAGS_report_interval_ms / 1e3;
+  bool ok = failover.run([&](size_t succeeded) {
+    int64_t activations = sumStat(*cluster, "sequencer_activations");
+    int64_t recoveries = sumStat(*cluster, "recovery_success");
+    std::cout << folly::sformat(
+                     "t={:.1f}s logs_writable={} activations_per_sec={:.0f} "
+                     "recoveries_per_sec={:.0f} background_failed={}",
+                     std::chrono::duration<double>(Clock::now() -
+                                                   failover.startTime())
+                         .count(),
+                     succeeded,
+                     (activations - prev_activations) / interval_sec,
+                     (recoveries - prev_recoveries) / interval_sec,
+                     background.failed())
+              << std::endl;
+    prev_activations = activations;
+    prev_recoveries = recoveries;
+  });
+  if (!ok) {
+    ld_error("Not all logs accepted an append in %d seconds after the kill",
+             FLAGS_timeout_sec);
+    return 1;
+  }
+
+  std::vector<double> all;
+  std::vector<double> failed_over;
+  for (size_t idx = 0; idx < size_t(FLAGS_logs); ++idx) {
+    double sec = std::chrono::duration<double>(failover.firstSuccess()[idx] -
+                                               failover.startTime())
+                     .count();
+    all.push_back(sec);
+    if (failover.epochs()[idx] != activation.epochs()[idx]) {
+      failed_over.push_back(sec);
+    }
+  }
+  std::cout << "first_append_sec all " << percentiles(all) << std::endl;
+  std::cout << "first_append_sec failed_over " << percentiles(failed_over)
+            << std::endl;
+
+  for (auto& it : cluster->getNodes()) {
+    if (!it.second->isRunning()) {
+      continue;
+    }
+    auto rows = it.second->sendJsonCommand(
+        "stats2 histogram log_recovery_latency --json");
+    for (auto& row : rows) {
+      std::cout << folly::sformat(
+                       "recovery_usec N{} count={} p50={} p99={} max={}",
+                       it.first,
+                       row["count"],
+                       row["p50"],
+                       row["p99"],
+                       row["max"])
+                << std::endl;
+    }
+  }
+  return 0;
+}
+
+} // namespace
+
+}} // namespace facebook::logdevice
+
+int main(int argc, char** argv) {
+  folly::SingletonVault::singleton()->registrationComplete();
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  return facebook::logdevice::run();
+}
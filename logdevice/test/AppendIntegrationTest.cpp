@@ -1102,6 +1102,68 @@ TEST_F(AppendIntegrationTest, StatsWithSequencerBatching) {
   AppendIntegrationTest_Stats_impl(true);
 }
 
+// With --store-chain-forward-early, chained STOREs are forwarded before the
+// seal is checked; records must still be fully replicated and readable.
+TEST_F(AppendIntegrationTest, ChainForwardEarly) {
+  const int NAPPENDS = 50;
+  auto cluster =
+      IntegrationTestUtils::ClusterFactory()
+          .setLogAttributes(
+              IntegrationTestUtils::ClusterFactory::createDefaultLogAttributes(
+                  3))
+          .setParam("--store-chain-forward-early", "true")
+          .create(4);
+  std::shared_ptr<Client> client = cluster->createClient();
+  lsn_t first = LSN_INVALID;
+  for (int i = 0; i < NAPPENDS; ++i) {
+    lsn_t lsn = client->appendSync(logid_t(1), std::to_string(i));
+    ASSERT_NE(LSN_INVALID, lsn);
+    if (first == LSN_INVALID) {
+      first = lsn;
+    }
+  }
+
+  int64_t forwarded_early = 0;
+  for (auto& it : cluster->getNodes()) {
+    forwarded_early += it.second->stats()["store_forwarded_early"];
+  }
+  EXPECT_GT(forwarded_early, 0);
+
+  auto reader = client->createReader(1);
+  ASSERT_EQ(0, reader->startReading(logid_t(1), first));
+  std::vector<std::unique_ptr<DataRecord>> records;
+  GapRecord gap;
+  while (records.size() < NAPPENDS) {
+    ASSERT_GE(reader->read(NAPPENDS - records.size(), &records, &gap), 0);
+  }
+  for (int i = 0; i < NAPPENDS; ++i) {
+    EXPECT_EQ(std::to_string(i), records[i]->payload.toString());
+  }
+}
+
+// Sequential appends should reuse the memory of earlier Appenders, unless
+// pooling is disabled.
+TEST_F(AppendIntegrationTest, AppenderPool) {
+  const int NAPPENDS = 100;
+  for (const char* pool_size : {"1024", "0"}) {
+    auto cluster = IntegrationTestUtils::ClusterFactory()
+                       .setParam("--appender-pool-size", pool_size)
+                       .create(1);
+    std::shared_ptr<Client> client = cluster->createClient();
+    for (int i = 0; i < NAPPENDS; ++i) {
+      ASSERT_NE(LSN_INVALID, client->appendSync(logid_t(1), "foo"));
+    }
+    auto stats = cluster->getNode(0).stats();
+    if (std::string(pool_size) == "0") {
+      EXPECT_EQ(0, stats["appender_pool_reused"]);
+    } else {
+      EXPECT_GT(stats["appender_pool_reused"], 0);
+    }
+    EXPECT_GE(stats["appender_pool_reused"] + stats["appender_pool_allocated"],
+              NAPPENDS);
+  }
+}
+
 TEST_F(AppendIntegrationTest, AppendOversizedPayloadGroup) {
   const logid_t logid{1};
 
@@ -13,6 +13,7 @@
 #include <gtest/gtest.h>
 
 #include "logdevice/common/AppendRequest.h"
+#include "logdevice/common/Semaphore.h"
 #include "logdevice/common/configuration/Configuration.h"
 #include "logdevice/common/configuration/UpdateableConfig.h"
 #include "logdevice/common/settings/Settings.h"
@@ -35,6 +36,48 @@ TEST_F(FindTimeIntegrationTest, FindTimeInvalidLogid) {
   ASSERT_EQ(LSN_INVALID, lsn);
 }
 
+// findTimeBatch() reports the result of each log in the order the logs were
+// passed, whether or not it has more logs than it runs at once.
+TEST_F(FindTimeIntegrationTest, FindTimeBatch) {
+  auto cluster = IntegrationTestUtils::ClusterFactory().setNumLogs(3).create(2);
+  std::unique_ptr<ClientSettings> client_settings(ClientSettings::create());
+  ASSERT_EQ(0, client_settings->set("batch-api-max-in-flight", 2));
+  std::shared_ptr<Client> client =
+      cluster->createClient(testTimeout(), std::move(client_settings));
+  cluster->waitForRecovery();
+
+  ASSERT_EQ(0, client->trimSync(logid_t(2), 100));
+
+  Semaphore sem;
+  std::vector<Status> statuses;
+  std::vector<lsn_t> results;
+  int rv = client->findTimeBatch(
+      {logid_t(1), logid_t(2), LOGID_INVALID, logid_t(3), logid_t(1)},
+      std::chrono::milliseconds::zero(),
+      [&](std::vector<Status> st, std::vector<lsn_t> res) {
+        statuses = std::move(st);
+        results = std::move(res);
+        sem.post();
+      });
+  ASSERT_EQ(0, rv);
+  sem.wait();
+
+  EXPECT_EQ(
+      std::vector<Status>({E::OK, E::OK, E::INVALID_PARAM, E::OK, E::OK}),
+      statuses);
+  ASSERT_EQ(5, results.size());
+  EXPECT_EQ(1, results[0]);
+  EXPECT_EQ(101, results[1]);
+  EXPECT_EQ(LSN_INVALID, results[2]);
+  EXPECT_EQ(1, results[3]);
+  EXPECT_EQ(1, results[4]);
+
+  EXPECT_EQ(-1,
+            client->findTimeBatch(
+                {}, std::chrono::milliseconds::zero(), [](auto, auto) {}));
+  EXPECT_EQ(E::INVALID_PARAM, err);
+}
+
 static void
 find_time_zero_trim(std::shared_ptr<Client> client,
                     FindKeyAccuracy accuracy = FindKeyAccuracy::STRICT) {
@@ -367,6 +367,75 @@ TEST_F(IsLogEmptyTest, SingleEpochTest) {
   }));
 }
 
+// isLogEmptyBatch(), getTailAttributesBatch() and getHeadAttributesBatch()
+// report the same as their single-log versions, in the order of the logs.
+TEST_F(IsLogEmptyTest, BatchTest) {
+  init();
+  cluster_->waitForRecovery();
+  writeRecords({2, 3});
+
+  const std::vector<logid_t> logs{logid_t(1), logid_t(2), logid_t(3)};
+  const std::vector<logid_t> nonempty_logs{logid_t(2), logid_t(3)};
+  {
+    Semaphore sem;
+    std::vector<Status> statuses;
+    std::vector<bool> empty;
+    ASSERT_EQ(0,
+              client_->isLogEmptyBatch(
+                  logs, [&](std::vector<Status> st, std::vector<bool> e) {
+                    statuses = std::move(st);
+                    empty = std::move(e);
+                    sem.post();
+                  }));
+    sem.wait();
+    EXPECT_EQ(std::vector<Status>(3, E::OK), statuses);
+    EXPECT_EQ(std::vector<bool>({true, false, false}), empty);
+  }
+  {
+    Semaphore sem;
+    std::vector<Status> statuses;
+    std::vector<std::unique_ptr<LogTailAttributes>> attrs;
+    ASSERT_EQ(0,
+              client_->getTailAttributesBatch(
+                  nonempty_logs,
+                  [&](std::vector<Status> st,
+                      std::vector<std::unique_ptr<LogTailAttributes>> a) {
+                    statuses = std::move(st);
+                    attrs = std::move(a);
+                    sem.post();
+                  }));
+    sem.wait();
+    ASSERT_EQ(std::vector<Status>(2, E::OK), statuses);
+    for (size_t i = 0; i < nonempty_logs.size(); ++i) {
+      auto single = client_->getTailAttributesSync(nonempty_logs[i]);
+      ASSERT_NE(nullptr, single);
+      ASSERT_NE(nullptr, attrs[i]);
+      EXPECT_EQ(
+          single->last_released_real_lsn, attrs[i]->last_released_real_lsn);
+    }
+  }
+  {
+    Semaphore sem;
+    std::vector<Status> statuses;
+    std::vector<std::unique_ptr<LogHeadAttributes>> attrs;
+    ASSERT_EQ(0,
+              client_->getHeadAttributesBatch(
+                  logs,
+                  [&](std::vector<Status> st,
+                      std::vector<std::unique_ptr<LogHeadAttributes>> a) {
+                    statuses = std::move(st);
+                    attrs = std::move(a);
+                    sem.post();
+                  }));
+    sem.wait();
+    ASSERT_EQ(std::vector<Status>(3, E::OK), statuses);
+    for (size_t i = 0; i < logs.size(); ++i) {
+      ASSERT_NE(nullptr, attrs[i]);
+      EXPECT_EQ(LSN_INVALID, attrs[i]->trim_point);
+    }
+  }
+}
+
 TEST_F(IsLogEmptyTest, FewEpochTest) {
   init();
 
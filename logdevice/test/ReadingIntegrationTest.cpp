@@ -5,6 +5,7 @@
  * This source code is licensed under the BSD-style license found in the
  * LICENSE file in the root directory of this source tree.
  */
+#include <algorithm>
 #include <chrono>
 #include <memory>
 #include <thread>
@@ -28,6 +29,7 @@
 #include "logdevice/common/types_internal.h"
 #include "logdevice/include/BufferedWriteDecoder.h"
 #include "logdevice/include/Client.h"
+#include "logdevice/include/PayloadFetcher.h"
 #include "logdevice/include/types.h"
 #include "logdevice/lib/ClientImpl.h"
 #include "logdevice/test/utils/IntegrationTestBase.h"
@@ -2085,6 +2087,53 @@ TEST_P(ReadingIntegrationTest, ReadCompressedPayloadGroups) {
                 .toStdString());
 }
 
+// Reads headers without payloads, then fetches the payloads of some of the
+// records with PayloadFetcher.
+TEST_P(ReadingIntegrationTest, FetchPayloadsAfterReadingHeaders) {
+  auto cluster = clusterFactory().create(2);
+  std::shared_ptr<Client> client = cluster->createClient();
+
+  const logid_t logid(1);
+  const size_t num_records = 10;
+  std::map<lsn_t, std::string> appended;
+  for (size_t i = 0; i < num_records; ++i) {
+    std::string data("data" + std::to_string(i));
+    lsn_t lsn = client->appendSync(logid, data);
+    ASSERT_NE(LSN_INVALID, lsn);
+    appended[lsn] = data;
+  }
+
+  std::unique_ptr<Reader> reader(client->createReader(1));
+  reader->withoutPayload();
+  reader->startReading(
+      logid, appended.begin()->first, appended.rbegin()->first);
+  std::vector<std::unique_ptr<DataRecord>> headers;
+  while (reader->isReadingAny()) {
+    GapRecord gap;
+    reader->read(num_records, &headers, &gap);
+  }
+  ASSERT_EQ(num_records, headers.size());
+
+  // Pick a run of consecutive records and a few isolated ones.
+  std::vector<lsn_t> picked;
+  for (size_t i : {1, 2, 3, 6, 9}) {
+    EXPECT_EQ(0, headers[i]->payload.size());
+    picked.push_back(headers[i]->attrs.lsn);
+  }
+  std::reverse(picked.begin(), picked.end());
+
+  auto fetcher = PayloadFetcher::create(client, getDefaultTestTimeout());
+  ASSERT_NE(nullptr, fetcher);
+  std::vector<std::unique_ptr<DataRecord>> records;
+  ASSERT_EQ(0, fetcher->fetch(logid, picked, &records));
+  ASSERT_EQ(picked.size(), records.size());
+  std::sort(picked.begin(), picked.end());
+  for (size_t i = 0; i < records.size(); ++i) {
+    EXPECT_EQ(picked[i], records[i]->attrs.lsn);
+    EXPECT_EQ(appended[picked[i]], records[i]->payload.toString());
+  }
+}
+
 INSTANTIATE_TEST_CASE_P(ReadingIntegrationTest,
                         ReadingIntegrationTest,
                         ::testing::Values(false, true));
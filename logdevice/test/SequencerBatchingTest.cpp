@@ -527,3 +527,77 @@ TEST_F(SequencerBatchingTest, DifferentLogGroupSettingsReloading) {
   ASSERT_EQ(1, lsns.size());
   checkCompression(Compression::LZ4_HC);
 }
+
+// With adaptive batching, a log that gets fewer than two appends per time
+// trigger should have its batches flushed without waiting.
+TEST_F(SequencerBatchingTest, AdaptiveLowRate) {
+  auto cluster = IntegrationTestUtils::ClusterFactory()
+                     .setParam("--sequencer-batching")
+                     .setParam("--sequencer-batching-time-trigger", "1s")
+                     .setParam("--sequencer-batching-adaptive")
+                     .create(1);
+  auto client = cluster->createClient(this->testTimeout());
+
+  const int NWRITES = 3;
+  for (int i = 0; i < NWRITES; ++i) {
+    lsn_t lsn = client->appendSync(logid_t(1), "payload" + std::to_string(i));
+    ASSERT_NE(LSN_INVALID, lsn);
+    /* sleep override */
+    std::this_thread::sleep_for(std::chrono::seconds(2));
+  }
+
+  auto stats = cluster->getNode(0).stats();
+  EXPECT_EQ(NWRITES, stats["seq_batching_adaptive_no_delay"]);
+}
+
+// Batches of a single log, with their Appenders spread over several workers,
+// all get stored and read back.
+TEST_F(SequencerBatchingTest, AppenderSpread) {
+  auto cluster = IntegrationTestUtils::ClusterFactory()
+                     .setParam("--num-workers", "4")
+                     .setParam("--sequencer-batching")
+                     .setParam("--sequencer-batching-size-trigger", "100")
+                     .setParam("--sequencer-batching-appender-spread", "4")
+                     .create(1);
+  auto client = cluster->createClient(this->testTimeout());
+
+  std::mutex mutex;
+  std::set<lsn_t> lsns;
+  Semaphore sem;
+  auto cb = [&](Status st, const DataRecord& record) {
+    std::lock_guard<std::mutex> guard(mutex);
+    EXPECT_EQ(E::OK, st);
+    lsns.insert(record.attrs.lsn);
+    sem.post();
+  };
+
+  const int NWRITES = 200;
+  std::multiset<std::string> payloads_written;
+  for (int i = 0; i < NWRITES; ++i) {
+    std::string payload = "payloadcompressible" + std::to_string(i);
+    payloads_written.insert(payload);
+    ASSERT_EQ(0, client->append(logid_t(1), std::move(payload), cb));
+  }
+  for (int i = 0; i < NWRITES; ++i) {
+    sem.wait();
+  }
+  ASSERT_GT(lsns.size(), 1);
+
+  auto stats = cluster->getNode(0).stats();
+  EXPECT_GT(stats["seq_batching_appends_offloaded"], 0);
+
+  auto reader = client->createReader(1);
+  ASSERT_EQ(
+      0, reader->startReading(logid_t(1), *lsns.begin(), *lsns.rbegin()));
+  std::multiset<std::string> payloads_read;
+  while (payloads_read.size() < NWRITES) {
+    std::vector<std::unique_ptr<DataRecord>> data;
+    GapRecord gap;
+    int nread = reader->read(NWRITES, &data, &gap);
+    ASSERT_GE(nread, 0);
+    for (const auto& record : data) {
+      payloads_read.insert(convert(record->payloads));
+    }
+  }
+  ASSERT_EQ(payloads_written, payloads_read);
+}
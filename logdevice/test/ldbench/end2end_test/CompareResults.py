@@ -0,0 +1,139 @@
+#!/usr/bin/env python3
+
+# Copyright (c) Facebook, Inc. and its affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+# Compares the results of an ldbench run against a stored baseline.
+#
+# Both arguments are directories containing the summary_*.json files written
+# by ldbench workers run with --publish-dir (e.g. the collection-dir of an
+# end-to-end test). Summaries are grouped by bench name and options hash, so
+# only runs with the same benchmark options are compared. Within a group,
+# throughput is summed over workers and latency percentiles are the maximum
+# over workers.
+#
+# Prints one line per compared metric and exits with status 1 if any metric
+# regressed by more than the given threshold.
+#
+# Usage:
+#   CompareResults.py BASELINE_DIR CURRENT_DIR [--throughput-threshold 0.05]
+#                     [--latency-threshold 0.1]
+
+import argparse
+import glob
+import json
+import logging
+import sys
+
+
+# (metric, how to aggregate over workers, True if higher is better)
+METRICS = [
+    ("success_per_sec", sum, True),
+    ("success_byte_per_sec", sum, True),
+    ("latency_us_p50", max, False),
+    ("latency_us_p99", max, False),
+    ("latency_us_p999", max, False),
+]
+
+
+# Returns {(bench_name, options_hash): [summary, ...]} for all summaries in
+# `directory`.
+def loadSummaries(directory):
+    groups = {}
+    for file_name in sorted(glob.glob(f"{directory}/summary_*.json")):
+        with open(file_name, "r") as summary_file:
+            summary = json.load(summary_file)
+        key = (summary["bench_name"], summary["options_hash"])
+        groups.setdefault(key, []).append(summary)
+    return groups
+
+
+def aggregate(summaries):
+    result = {}
+    for metric, agg, _ in METRICS:
+        values = [s["results"][metric] for s in summaries if metric in s["results"]]
+        if values:
+            result[metric] = agg(values)
+    return result
+
+
+def buildName(summaries):
+    build = summaries[0]["build"]
+    return build.get("revision") or build.get("version", "unknown")
+
+
+def compare(baseline, current, throughput_threshold, latency_threshold):
+    logger = logging.getLogger("compare")
+    regressed = False
+    for key in sorted(current):
+        bench_name, options_hash = key
+        if key not in baseline:
+            logger.warning(
+                "No baseline for %s with options %s", bench_name, options_hash
+            )
+            continue
+        print(
+            f"{bench_name} options={options_hash} "
+            f"baseline={buildName(baseline[key])} "
+            f"current={buildName(current[key])}"
+        )
+        if (
+            baseline[key][0]["client_settings_hash"]
+            != current[key][0]["client_settings_hash"]
+        ):
+            print("  note: client settings differ from the baseline")
+        old = aggregate(baseline[key])
+        new = aggregate(current[key])
+        for metric, _, higher_is_better in METRICS:
+            if metric not in old or metric not in new or old[metric] == 0:
+                continue
+            change = (new[metric] - old[metric]) / old[metric]
+            if higher_is_better:
+                bad = change < -throughput_threshold
+            else:
+                bad = change > latency_threshold
+            regressed |= bad
+            print(
+                f"  {metric}: {old[metric]:.1f} -> {new[metric]:.1f} "
+                f"({change:+.1%}){' REGRESSION' if bad else ''}"
+            )
+    return regressed
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Compare ldbench results against a baseline"
+    )
+    parser.add_argument("baseline_dir")
+    parser.add_argument("current_dir")
+    parser.add_argument(
+        "--throughput-threshold",
+        type=float,
+        default=0.05,
+        help="relative throughput decrease reported as a regression",
+    )
+    parser.add_argument(
+        "--latency-threshold",
+        type=float,
+        default=0.1,
+        help="relative latency increase reported as a regression",
+    )
+    args = parser.parse_args()
+    logging.basicConfig()
+
+    baseline = loadSummaries(args.baseline_dir)
+    current = loadSummaries(args.current_dir)
+    if not current:
+        logging.error("No summary files in %s", args.current_dir)
+        return 2
+    regressed = compare(
+        baseline, current, args.throughput_threshold, args.latency_threshold
+    )
+    return 1 if regressed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -48,6 +48,8 @@ class AggregatedEvents:
 #   3. produce a figure using the aggregated results
 class Results(ExecutionBase):
     remote_path_temp = Template("${host}:${dir}/*.csv")
+    # run summaries, see CompareResults.py
+    remote_summary_path_temp = Template("${host}:${dir}/summary_*.json")
 
     def __init__(
         self, hosts, publish_dir, throughput_interval, collection_dict, collect_inst
@@ -76,6 +78,11 @@ class Results(ExecutionBase):
             collect_command.append(
                 self.remote_path_temp.substitute(host=host, dir=self.remote_dir)
             )
+            collect_command.append(
+                self.remote_summary_path_temp.substitute(
+                    host=host, dir=self.remote_dir
+                )
+            )
             collect_command.append(self.local_dir)
             self.logger.info(collect_command)
             collect_proc = subprocess.Popen(collect_command)
@@ -226,3 +226,47 @@ TEST_F(WorkerUtilTest, RandomEventSequence) {
   EXPECT_NEAR(cnt_hi, 5e3, 1e3);
   EXPECT_NEAR(cnt_lo, 5e3, 1e3);
 }
+
+TEST_F(WorkerUtilTest, TrafficTrace) {
+  TrafficTrace t;
+  std::string error;
+  ASSERT_TRUE(t.parse("# comment\n"
+                      "step=10s\n"
+                      "\n"
+                      "log=1 appends=1,2.5 payload=1,1 readers=2\n"
+                      "  log=7   readers=3 backlog=0,1  \n"
+                      "log=8 appends=4 payload=constant spikiness=50%/10%/1s\n",
+                      &error))
+      << error;
+  EXPECT_EQ(10, t.step_sec);
+  ASSERT_EQ(3, t.logs.size());
+
+  EXPECT_EQ(1, t.logs[0].log_id);
+  EXPECT_EQ(std::vector<double>({1, 2.5}), t.logs[0].appends_per_sec);
+  EXPECT_EQ(std::vector<double>({.5, 1}), t.logs[0].payload_size.p);
+  EXPECT_EQ(2, t.logs[0].readers);
+  EXPECT_FALSE(t.logs[0].has_read_backlog);
+
+  EXPECT_EQ(7, t.logs[1].log_id);
+  EXPECT_EQ(std::vector<double>({0}), t.logs[1].appends_per_sec);
+  EXPECT_EQ(3, t.logs[1].readers);
+  EXPECT_TRUE(t.logs[1].has_read_backlog);
+  EXPECT_EQ(std::vector<double>({0, 1}), t.logs[1].read_backlog_sec.p);
+
+  EXPECT_EQ(8, t.logs[2].log_id);
+  EXPECT_EQ(0, t.logs[2].readers);
+  EXPECT_EQ(.5, t.logs[2].spikiness.spike_load_fraction);
+
+  EXPECT_FALSE(t.parse("", &error));
+  EXPECT_EQ("no logs", error);
+  EXPECT_FALSE(t.parse("log=1\nlog=1\n", &error));
+  EXPECT_EQ("line 2: invalid or duplicate log id", error);
+  EXPECT_FALSE(t.parse("log=1 appends=1\n", &error));
+  EXPECT_EQ("line 1: missing payload", error);
+  EXPECT_FALSE(t.parse("log=1 appends=-1 payload=1\n"));
+  EXPECT_FALSE(t.parse("readers=1\n"));
+  EXPECT_FALSE(t.parse("log=1 foo=bar\n"));
+  EXPECT_FALSE(t.parse("log=1 readers\n"));
+  EXPECT_FALSE(t.parse("step=1s log=1\n"));
+  EXPECT_FALSE(t.parse("step=0s\nlog=1\n"));
+}
@@ -8,11 +8,31 @@
 
 #include "logdevice/test/ldbench/worker/BenchStats.h"
 
+#include <array>
 #include <functional>
 #include <iostream>
 
 namespace facebook { namespace logdevice { namespace ldbench {
 
+namespace {
+
+// Adds count and percentiles of `hist` to `out` as <prefix>_p50 etc.
+void addLatencyPercentiles(const LogLinearHistogram& hist,
+                           const std::string& prefix,
+                           folly::dynamic& out) {
+  const std::array<double, 5> pcts = {.5, .9, .99, .999, 1.};
+  const std::array<const char*, 5> names = {"p50", "p90", "p99", "p999", "max"};
+  std::array<int64_t, 5> values;
+  uint64_t count;
+  hist.estimatePercentiles(pcts.data(), pcts.size(), values.data(), &count);
+  out[prefix + "_count"] = count;
+  for (size_t i = 0; i < pcts.size(); ++i) {
+    out[prefix + "_" + names[i]] = values[i];
+  }
+}
+
+} // namespace
+
 BenchStats::BenchStats(const std::string& type)
     : success_(0),
       success_byte_(0),
@@ -59,12 +79,21 @@ void BenchStats::incStat(StatsType attr, int64_t num) {
   }
 }
 
+void BenchStats::addLatency(std::chrono::microseconds latency) {
+  latency_us_.add(latency.count());
+}
+
+void BenchStats::mergeLatencyInto(LogLinearHistogram& out) const {
+  out.merge(latency_us_);
+}
+
 void BenchStats::aggregate(const BenchStats& stats) {
   success_ += stats.getAttr(StatsType::SUCCESS);
   success_byte_ += stats.getAttr(StatsType::SUCCESS_BYTE);
   failure_ += stats.getAttr(StatsType::FAILURE);
   skipped_ += stats.getAttr(StatsType::SKIPPED);
   in_flight_ += stats.getAttr(StatsType::INFLIGHT);
+  stats.mergeLatencyInto(latency_us_);
   return;
 }
 
@@ -82,6 +111,7 @@ folly::dynamic BenchStats::collectStatsAsPairs() {
   stats_res["fail"] = failure_.load();
   stats_res["skipped"] = skipped_.load();
   stats_res["inflight"] = in_flight_.load();
+  addLatencyPercentiles(latency_us_, "latency_us", stats_res);
   return stats_res;
 }
 
@@ -114,6 +144,14 @@ folly::dynamic BenchStatsHolder::aggregateAllStats() {
   return result.collectStatsAsPairs();
 }
 
+void BenchStatsHolder::aggregateAllLatencies(LogLinearHistogram& out) {
+  std::lock_guard<std::mutex> lock(aggregated_stats_mutex_);
+  aggregated_stats_.mergeLatencyInto(out);
+  for (auto& x : bench_thread_stats_.accessAllThreads()) {
+    x.stats_.mergeLatencyInto(out);
+  }
+}
+
 BenchStatsCollectionThread::BenchStatsCollectionThread(
     std::shared_ptr<BenchStatsHolder> stats_source,
     std::shared_ptr<StatsStore> stats_store,
@@ -140,6 +178,13 @@ void BenchStatsCollectionThread::statsCollectionFunction() {
   auto cur_stats = stats_source_->aggregateAllStats();
   cur_stats["timestamp"] =
       std::chrono::system_clock::now().time_since_epoch().count();
+  LogLinearLatencyHistogram latency_us;
+  stats_source_->aggregateAllLatencies(latency_us);
+  LogLinearLatencyHistogram interval_latency_us;
+  interval_latency_us.assign(latency_us);
+  interval_latency_us.subtract(prev_latency_us_);
+  prev_latency_us_.assign(latency_us);
+  addLatencyPercentiles(interval_latency_us, "interval_latency_us", cur_stats);
   stats_store_->writeCurrentStats(cur_stats);
   return;
 }
@@ -15,6 +15,7 @@
 #include <folly/experimental/FunctionScheduler.h>
 
 #include "logdevice/common/checks.h"
+#include "logdevice/common/stats/Histogram.h"
 #include "logdevice/test/ldbench/worker/StatsStore.h"
 
 namespace facebook { namespace logdevice { namespace ldbench {
@@ -41,6 +42,19 @@ class BenchStats {
    */
   void incStat(StatsType attr, int64_t num);
 
+  /**
+   * Record the latency of a completed request, measured from the time the
+   * request was intended to start rather than from the time it was actually
+   * sent, so that requests delayed by a slow system are not under-reported
+   * (coordinated omission).
+   */
+  void addLatency(std::chrono::microseconds latency);
+
+  /**
+   * Add the latency histogram of this object to `out`.
+   */
+  void mergeLatencyInto(LogLinearHistogram& out) const;
+
   /**
    * Aggregate its own attributes with another BenchStats object
    */
@@ -64,6 +78,7 @@ class BenchStats {
   std::atomic<int64_t> in_flight_;    // total number of in-flights records
   std::atomic<int64_t> failure_;      // total number of failed records
   std::atomic<int64_t> skipped_;      // total number of skipped records
+  LogLinearLatencyHistogram latency_us_; // latencies from intended start
   std::string type_;                  // request types for different workloads
 };
 
@@ -95,6 +110,12 @@ class BenchStatsHolder {
    */
   folly::dynamic aggregateAllStats();
 
+  /**
+   * Aggregate latency histograms from all threads including who have joined
+   * into `out`.
+   */
+  void aggregateAllLatencies(LogLinearHistogram& out);
+
   /**
    * Display every local BenchStats
    * This is a debug function
@@ -164,11 +185,15 @@ class BenchStatsCollectionThread {
   ~BenchStatsCollectionThread();
   /**
    * Collect stats from stats_source and publish it to stats_des
-   * with time interval (second)
+   * with time interval (second).
+   * Counters are cumulative, latency percentiles prefixed with "interval_"
+   * only cover the requests completed since the previous collection.
    */
   void statsCollectionFunction();
 
  private:
+  // Aggregated latencies as of the previous collection.
+  LogLinearLatencyHistogram prev_latency_us_;
   std::shared_ptr<BenchStatsHolder> stats_source_;
   std::shared_ptr<StatsStore> stats_store_;
   std::chrono::seconds interval_;
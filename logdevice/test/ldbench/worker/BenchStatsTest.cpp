@@ -8,6 +8,7 @@
 
 #include "logdevice/test/ldbench/worker/BenchStats.h"
 
+#include <chrono>
 #include <vector>
 
 #include <gtest/gtest.h>
@@ -38,4 +39,21 @@ TEST_F(BenchStatsTest, updateStatsTest) {
   EXPECT_EQ(3, stats_obj2["success"].asInt());
 }
 
+TEST_F(BenchStatsTest, latencyTest) {
+  folly::dynamic stats_obj = bench_stats->collectStatsAsPairs();
+  EXPECT_EQ(0, stats_obj["latency_us_count"].asInt());
+  for (int i = 1; i <= 100; ++i) {
+    bench_stats->addLatency(std::chrono::milliseconds(i));
+  }
+  BenchStats stats_temp("append_sync");
+  stats_temp.addLatency(std::chrono::seconds(10));
+  bench_stats->aggregate(stats_temp);
+  stats_obj = bench_stats->collectStatsAsPairs();
+  EXPECT_EQ(101, stats_obj["latency_us_count"].asInt());
+  // Log-linear buckets are within 12.5% of the value.
+  EXPECT_NEAR(50000, stats_obj["latency_us_p50"].asInt(), 50000 / 8);
+  EXPECT_NEAR(99000, stats_obj["latency_us_p99"].asInt(), 99000 / 8);
+  EXPECT_NEAR(10000000, stats_obj["latency_us_max"].asInt(), 10000000 / 8);
+}
+
 }}} // namespace facebook::logdevice::ldbench
@@ -0,0 +1,337 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "logdevice/common/debug.h"
+#include "logdevice/include/AsyncReader.h"
+#include "logdevice/include/Client.h"
+#include "logdevice/include/Err.h"
+#include "logdevice/include/Record.h"
+#include "logdevice/include/types.h"
+#include "logdevice/test/ldbench/worker/Options.h"
+#include "logdevice/test/ldbench/worker/Worker.h"
+#include "logdevice/test/ldbench/worker/WorkerRegistry.h"
+
+namespace facebook { namespace logdevice { namespace ldbench {
+namespace {
+
+static constexpr const char* BENCH_NAME = "catchup_storm";
+
+/**
+ * Catch-up storm benchmark worker.
+ *
+ * Reproduces what happens after a deploy of a large consumer fleet: many
+ * tailers stall at the same time and then all come back at once to read the
+ * backlog that accumulated in the meantime.
+ *
+ * Starts --fanout tailing AsyncReaders per log, each reading its log from the
+ * tail. After --warmup-duration seconds, pauses all readers for
+ * --catchup-pause-duration, either by refusing records (so that client flow
+ * control stops the read streams) or, with --catchup-stop-reading, by
+ * stopping the read streams. Then resumes all readers at once and waits for
+ * each of them to catch up with the tail of its log as of the resume time,
+ * for at most --duration seconds.
+ *
+ * Some other worker (e.g. "write") is expected to write to the logs while
+ * the readers are paused. Prints the distribution of catch-up times and the
+ * number of records and bytes read while catching up. The latter can be
+ * compared with the read and CPU stats of storage nodes over the same period
+ * to estimate server-side amplification.
+ */
+class CatchupStormWorker final : public Worker {
+ public:
+  using Worker::Worker;
+  ~CatchupStormWorker() override;
+  int run() override;
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  struct ReaderState {
+    explicit ReaderState(logid_t log) : log_id(log) {}
+
+    logid_t log_id;
+    std::unique_ptr<AsyncReader> reader;
+    // Highest LSN delivered so far, as a record or as the end of a gap.
+    std::atomic<lsn_t> last_lsn{LSN_INVALID};
+    // Tail LSN of the log at the time readers were resumed.
+    lsn_t target_lsn = LSN_MAX;
+    // Set once last_lsn reaches target_lsn.
+    std::atomic<bool> caught_up{false};
+    Clock::duration catchup_time{};
+  };
+
+  // Sleeps until `duration` passes or stop() is called.
+  void sleepFor(Clock::duration duration);
+  bool startReader(ReaderState& state, lsn_t from_lsn);
+  bool pauseReaders();
+  bool resumeReaders();
+  void onDelivered(ReaderState& state, lsn_t lsn);
+  void printResult(Clock::duration max_wait);
+
+  std::vector<std::unique_ptr<ReaderState>> readers_;
+
+  // If true, readers refuse records. Only used without
+  // --catchup-stop-reading.
+  std::atomic<bool> paused_{false};
+  // True between resuming the readers and the end of the benchmark.
+  std::atomic<bool> catching_up_{false};
+  Clock::time_point resume_time_;
+
+  std::atomic<uint64_t> catchup_records_{0};
+  std::atomic<uint64_t> catchup_bytes_{0};
+
+  std::mutex mutex_;
+  std::condition_variable cond_var_;
+  size_t num_caught_up_ = 0;
+};
+
+CatchupStormWorker::~CatchupStormWorker() {
+  // Make sure no callbacks are called after this subclass is destroyed.
+  readers_.clear();
+  destroyClient();
+}
+
+int CatchupStormWorker::run() {
+  std::vector<logid_t> all_logs;
+  if (getLogs(all_logs)) {
+    return 1;
+  }
+  auto logs = getLogsPartition(all_logs);
+  LogToLsnMap tail_lsns;
+  if (getTailLSNs(tail_lsns, logs)) {
+    return 1;
+  }
+
+  const size_t readers_per_log =
+      std::max<size_t>(1, std::llround(options.fanout));
+  ld_info("Starting %zu readers on %zu logs",
+          readers_per_log * logs.size(),
+          logs.size());
+  for (logid_t log : logs) {
+    for (size_t i = 0; i < readers_per_log; ++i) {
+      readers_.push_back(std::make_unique<ReaderState>(log));
+      readers_.back()->last_lsn = tail_lsns.at(log.val());
+      if (startReader(*readers_.back(), tail_lsns.at(log.val()) + 1)) {
+        return 1;
+      }
+    }
+  }
+
+  ld_info(
+      "Performing warm-up for %" PRIu64 " seconds", options.warmup_duration);
+  sleepFor(std::chrono::seconds(options.warmup_duration));
+
+  ld_info("Pausing readers for %.3f seconds",
+          options.catchup_pause_duration.count() / 1e3);
+  if (pauseReaders()) {
+    return 1;
+  }
+  sleepFor(options.catchup_pause_duration);
+
+  if (getTailLSNs(tail_lsns, logs)) {
+    return 1;
+  }
+  for (auto& state : readers_) {
+    state->target_lsn = tail_lsns.at(state->log_id.val());
+  }
+
+  ld_info("Resuming all readers");
+  resume_time_ = Clock::now();
+  catching_up_ = true;
+  for (auto& state : readers_) {
+    // Readers that were already at the tail when paused have nothing to
+    // catch up on.
+    onDelivered(*state, state->last_lsn.load());
+  }
+  if (resumeReaders()) {
+    return 1;
+  }
+
+  const Clock::duration max_wait = options.duration >= 0
+      ? Clock::duration(std::chrono::seconds(options.duration))
+      : Clock::duration::max();
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (num_caught_up_ < readers_.size() && !isStopped() &&
+           Clock::now() - resume_time_ < max_wait) {
+      // Wake up periodically to notice stop().
+      cond_var_.wait_for(lock, std::chrono::milliseconds(100));
+    }
+  }
+  catching_up_ = false;
+
+  printResult(max_wait);
+  return 0;
+}
+
+void CatchupStormWorker::sleepFor(Clock::duration duration) {
+  const auto end_time = Clock::now() + duration;
+  while (!isStopped() && Clock::now() < end_time) {
+    /* sleep override */
+    std::this_thread::sleep_for(
+        std::min<Clock::duration>(std::chrono::milliseconds(100),
+                                  end_time - Clock::now()));
+  }
+}
+
+bool CatchupStormWorker::startReader(ReaderState& state, lsn_t from_lsn) {
+  if (!state.reader) {
+    state.reader = client_->createAsyncReader();
+    state.reader->setRecordCallback(
+        [this, &state](std::unique_ptr<DataRecord>& record) {
+          if (paused_) {
+            // Will be redelivered after resumeReading().
+            return false;
+          }
+          if (catching_up_) {
+            ++catchup_records_;
+            catchup_bytes_ += record->payload.size();
+          }
+          onDelivered(state, record->attrs.lsn);
+          return true;
+        });
+    state.reader->setGapCallback([this, &state](const GapRecord& gap) {
+      if (paused_) {
+        return false;
+      }
+      onDelivered(state, gap.hi);
+      return true;
+    });
+  }
+
+  auto attrs = getReadAttrs();
+  if (state.reader->startReading(state.log_id, from_lsn, LSN_MAX, &attrs) !=
+      0) {
+    ld_error("Failed to start reading log %" PRIu64 ": %s",
+             state.log_id.val(),
+             error_name(err));
+    return true;
+  }
+  return false;
+}
+
+bool CatchupStormWorker::pauseReaders() {
+  if (!options.catchup_stop_reading) {
+    paused_ = true;
+    return false;
+  }
+  for (auto& state : readers_) {
+    if (state->reader->stopReading(state->log_id) != 0) {
+      ld_error("Failed to stop reading log %" PRIu64 ": %s",
+               state->log_id.val(),
+               error_name(err));
+      return true;
+    }
+  }
+  return false;
+}
+
+bool CatchupStormWorker::resumeReaders() {
+  if (!options.catchup_stop_reading) {
+    paused_ = false;
+    for (auto& state : readers_) {
+      // Not checking the result: delivery is retried on a timer anyway.
+      state->reader->resumeReading(state->log_id);
+    }
+    return false;
+  }
+  for (auto& state : readers_) {
+    if (startReader(*state, state->last_lsn.load() + 1)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void CatchupStormWorker::onDelivered(ReaderState& state, lsn_t lsn) {
+  lsn_t prev = state.last_lsn.load();
+  while (prev < lsn && !state.last_lsn.compare_exchange_weak(prev, lsn)) {
+  }
+  if (!catching_up_ || lsn < state.target_lsn ||
+      state.caught_up.exchange(true)) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    state.catchup_time = Clock::now() - resume_time_;
+    ++num_caught_up_;
+  }
+  cond_var_.notify_all();
+}
+
+void CatchupStormWorker::printResult(Clock::duration max_wait) {
+  std::vector<double> times;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& state : readers_) {
+      if (state->caught_up) {
+        times.push_back(
+            std::chrono::duration_cast<std::chrono::duration<double>>(
+                state->catchup_time)
+                .count());
+      }
+    }
+  }
+  std::sort(times.begin(), times.end());
+  auto percentile = [&](double p) {
+    if (times.empty()) {
+      return 0.0;
+    }
+    return times[std::min(times.size() - 1, size_t(p * times.size()))];
+  };
+
+  if (times.size() < readers_.size()) {
+    ld_warning("%zu out of %zu readers didn't catch up in %.3f seconds",
+               readers_.size() - times.size(),
+               readers_.size(),
+               std::chrono::duration_cast<std::chrono::duration<double>>(
+                   std::min(max_wait, Clock::now() - resume_time_))
+                   .count());
+  }
+
+  std::cout << "readers " << readers_.size() << '\n';
+  std::cout << "readers_caught_up " << times.size() << '\n';
+  std::cout << "catchup_sec_p50 " << percentile(.5) << '\n';
+  std::cout << "catchup_sec_p90 " << percentile(.9) << '\n';
+  std::cout << "catchup_sec_p99 " << percentile(.99) << '\n';
+  std::cout << "catchup_sec_max " << (times.empty() ? 0.0 : times.back())
+            << '\n';
+  std::cout << "catchup_records " << catchup_records_.load() << '\n';
+  std::cout << "catchup_bytes " << catchup_bytes_.load() << '\n';
+}
+
+} // namespace
+
+void registerCatchupStormWorker() {
+  registerWorkerImpl(BENCH_NAME,
+                     []() -> std::unique_ptr<Worker> {
+                       return std::make_unique<CatchupStormWorker>();
+                     },
+                     OptionsRestrictions({"fanout",
+                                          "warmup-duration",
+                                          "duration",
+                                          "catchup-pause-duration",
+                                          "catchup-stop-reading",
+                                          "filter-type"},
+                                         {PartitioningMode::LOG}));
+}
+
+}}} // namespace facebook::logdevice::ldbench
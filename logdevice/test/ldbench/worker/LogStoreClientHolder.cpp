@@ -9,12 +9,17 @@
 #include "logdevice/test/ldbench/worker/LogStoreClientHolder.h"
 
 #include <chrono>
+#include <fstream>
 #include <functional>
 #include <memory>
 
 #include <folly/Random.h>
+#include <folly/json.h>
 
+#include "logdevice/common/BuildInfo.h"
 #include "logdevice/common/ConstructorFailed.h"
+#include "logdevice/common/debug.h"
+#include "logdevice/lib/ClientSettingsImpl.h"
 #include "logdevice/test/ldbench/worker/BenchStats.h"
 #include "logdevice/test/ldbench/worker/BenchTracer.h"
 #include "logdevice/test/ldbench/worker/FileBasedEventStore.h"
@@ -24,6 +29,7 @@
 #include "logdevice/test/ldbench/worker/LogStoreReader.h"
 #include "logdevice/test/ldbench/worker/Options.h"
 #include "logdevice/test/ldbench/worker/RecordWriterInfo.h"
+#include "logdevice/test/ldbench/worker/RunSummary.h"
 
 #ifdef BUILDKAFKA
 #include "logdevice/test/ldbench/worker/KafkaClient.h"
@@ -47,6 +53,11 @@ LogStoreClientHolder::LogStoreClientHolder() {
                                                     options.worker_id_index,
                                                     "_.csv");
     stats_store_ = std::make_shared<FileBasedStatsStore>(stats_file);
+    summary_file_ = folly::to<std::string>(options.publish_dir,
+                                           "/summary_",
+                                           filename,
+                                           options.worker_id_index,
+                                           "_.json");
     // create collection thread for stats
     collect_thread_ = std::make_unique<BenchStatsCollectionThread>(
         bench_stats_holder_, stats_store_, options.stats_interval);
@@ -91,7 +102,30 @@ LogStoreClientHolder::LogStoreClientHolder() {
                 std::placeholders::_5));
 }
 
-LogStoreClientHolder::~LogStoreClientHolder() {}
+LogStoreClientHolder::~LogStoreClientHolder() {
+  if (!summary_file_.empty()) {
+    writeSummary();
+  }
+}
+
+void LogStoreClientHolder::writeSummary() {
+  std::shared_ptr<BuildInfo> build_info;
+  auto settings = dynamic_cast<ClientSettingsImpl*>(client_settings.get());
+  if (settings) {
+    build_info = settings->getPluginRegistry()->getSinglePlugin<BuildInfo>(
+        PluginType::BUILD_INFO);
+  }
+  double duration_sec = std::chrono::duration<double>(
+                            std::chrono::steady_clock::now() - start_time_)
+                            .count();
+  folly::dynamic summary = buildRunSummary(
+      build_info.get(), bench_stats_holder_->aggregateAllStats(), duration_sec);
+  std::ofstream out(summary_file_);
+  out << folly::toPrettyJson(summary) << std::endl;
+  if (!out) {
+    ld_error("Failed to write run summary to %s", summary_file_.c_str());
+  }
+}
 
 std::unique_ptr<LogStoreReader> LogStoreClientHolder::createReader() {
   return client_->createReader();
@@ -109,6 +143,14 @@ bool LogStoreClientHolder::append(LogIDType log_id,
   return rv;
 }
 
+Context LogStoreClientHolder::intendedStartContext(
+    std::chrono::steady_clock::time_point intended_start) {
+  auto us = std::chrono::duration_cast<std::chrono::microseconds>(
+      intended_start.time_since_epoch());
+  // Steady clock epoch is usually boot time, so this is never 0 in practice.
+  return reinterpret_cast<Context>(static_cast<uintptr_t>(us.count()));
+}
+
 bool LogStoreClientHolder::getTail(
     LogIDType logid,
     std::function<void(bool, LogPositionType)> worker_cb) {
@@ -182,7 +224,15 @@ void LogStoreClientHolder::onAppendDone(bool successful,
   bench_stats_holder_->getOrCreateTLStats()->incStat(
       StatsType::INFLIGHT, -1 * static_cast<int64_t>(contexts.size()));
   uint64_t payload_size = 0;
+  const auto now_us = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now().time_since_epoch());
   for (auto it = contexts.begin(); it != contexts.end(); it++) {
+    if (successful && it->first != nullptr) {
+      auto intended_us = std::chrono::microseconds(
+          reinterpret_cast<uintptr_t>(it->first));
+      bench_stats_holder_->getOrCreateTLStats()->addLatency(now_us -
+                                                            intended_us);
+    }
     const std::string& payload = std::get<std::string>(it->second);
     payload_size += payload.size();
     // start to sample event
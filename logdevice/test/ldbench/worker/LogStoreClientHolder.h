@@ -48,10 +48,20 @@ class LogStoreClientHolder {
    * @param
    *  id -- log id
    *  payload
-   *  Context -- a void * to identify the record
+   *  Context -- a void * to identify the record. If not null, it's the
+   *             steady_clock time, in microseconds since epoch, at which the
+   *             append was intended to start (see intendedStartContext());
+   *             the latency from that time is recorded in BenchStats when
+   *             the append succeeds.
    */
   bool append(LogIDType log_id, std::string payload, Context context);
 
+  /**
+   * Context for append() that makes it record latency from `intended_start`.
+   */
+  static Context
+  intendedStartContext(std::chrono::steady_clock::time_point intended_start);
+
   /**
    * Get all logs in the system
    */
@@ -138,6 +148,11 @@ class LogStoreClientHolder {
                 const std::string& payload,
                 std::string& event_name);
 
+  /**
+   * Write the run summary (see RunSummary.h) to summary_file_.
+   */
+  void writeSummary();
+
   // Explaination of define order
   // callbacks of client use everything so client go first
   // bench_tracer uses event_store
@@ -149,5 +164,9 @@ class LogStoreClientHolder {
   std::shared_ptr<EventStore> event_store_;
   std::unique_ptr<BenchTracer> bench_tracer_;
   std::unique_ptr<LogStoreClient> client_;
+  // Empty if --publish-dir isn't set.
+  std::string summary_file_;
+  std::chrono::steady_clock::time_point start_time_{
+      std::chrono::steady_clock::now()};
 };
 }}} // namespace facebook::logdevice::ldbench
@@ -15,6 +15,7 @@
 #include <boost/program_options.hpp>
 #include <folly/Optional.h>
 #include <folly/Random.h>
+#include <folly/String.h>
 #include <folly/experimental/EnvUtil.h>
 
 #include "logdevice/common/buffered_writer/BufferedWriterOptionsUtil.h"
@@ -509,6 +510,16 @@ void Options::get_named_options(options_description& named) {
             }
           }),
       "Like --max-appends-in-flight but in bytes.");
+  named.add_options()(
+      "open-loop",
+      value<bool>(&open_loop)->default_value(false),
+      "Send every append at its scheduled time, even if the worker has "
+      "fallen behind schedule or --max-appends-in-flight or "
+      "--max-append-bytes-in-flight is exceeded, instead of skipping it. "
+      "Without this option, appends skipped while the cluster is slow are "
+      "missing from latency stats. With it, in-flight appends are unbounded. "
+      "Either way, append latency in published stats is measured from the "
+      "time each append was scheduled to start.");
   named.add_options()("use-buffered-writer",
                       value<bool>(&use_buffered_writer)->default_value(false),
                       "Append using BufferedWriter.");
@@ -592,6 +603,27 @@ void Options::get_named_options(options_description& named) {
       "Describes the variation of timestamps for which to do findTime calls, "
       "as a distance from findtime-avg-minutes-ago. See doc/ldbench.md for "
       "details. The default is no variation.");
+  named.add_options()(
+      "catchup-pause-duration",
+      chrono_value(&catchup_pause_duration),
+      "How long catchup_storm readers are paused before all of them are "
+      "resumed at once.");
+  named.add_options()(
+      "catchup-stop-reading",
+      value<bool>(&catchup_stop_reading)->default_value(false),
+      "If true, catchup_storm stops the read streams of paused readers and "
+      "starts them again on resume. Otherwise paused readers refuse records, "
+      "and read streams are stopped by client-side flow control.");
+  named.add_options()(
+      "trace-file",
+      value<std::string>(&trace_file),
+      "Path to the traffic trace replayed by trace_replay. See doc/ldbench.md "
+      "for the format.");
+  named.add_options()(
+      "trace-rate-multiplier",
+      value<double>(&trace_rate_multiplier)->default_value(1),
+      "Multiplies all append rates in the trace replayed by trace_replay, "
+      "e.g. to project load growth.");
   named.add_options()(
       "log-requests-per-sec-distribution",
       value<std::string>()
@@ -701,10 +733,22 @@ folly::Optional<int> parse_commandline_options(ClientSettingsImpl& settings,
     argc = tmp_argc;
     command_line_parser parser(argc, argv);
     parser.options(named).positional(positional);
-    store(parser.run(), parsed);
+    auto parsed_options = parser.run();
+    for (const auto& opt : parsed_options.options) {
+      options.command_line_options[opt.string_key] =
+          folly::join(" ", opt.value);
+    }
+    store(parsed_options, parsed);
   };
   settings.getSettingsUpdater()->parseFromCLI(
       argc, argv, SettingsUpdater::mustBeClientOption, fallback_parser);
+  for (const auto& kv : settings.getSettingsUpdater()->getState()) {
+    auto value = settings.getSettingsUpdater()->getValueFromSource(
+        kv.first, SettingsUpdater::Source::CLI);
+    if (value.has_value()) {
+      options.command_line_settings[kv.first] = value.value();
+    }
+  }
 
   // Create list of registered benchmark names.
   const auto& bench_map = getWorkerFactoryMap();
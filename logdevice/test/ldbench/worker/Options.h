@@ -10,6 +10,7 @@
 
 #include <chrono>
 #include <cstdint>
+#include <map>
 #include <ostream>
 #include <set>
 #include <string>
@@ -69,6 +70,10 @@ struct Options {
   double write_bytes_increase_factor; // increasing factor of throughput
   std::string sys_name;               // logdevice or kafka
   SystemTimestamp start_time;         // worker start time
+  // Benchmark options and client settings given on the command line, as
+  // name -> value. Recorded in the run summary, see publish_dir.
+  std::map<std::string, std::string> command_line_options;
+  std::map<std::string, std::string> command_line_settings;
 
   // Options shared by all worker types.
   // Define on which logs the workers should operate, and how to partition the
@@ -123,6 +128,7 @@ struct Options {
   BufferedWriter::Options buffered_writer_options;
   double payload_entropy;
   double payload_entropy_sequencer;
+  bool open_loop;
 
   // Options of metadata API benchmarks.
   uint64_t meta_requests_per_sec;
@@ -133,6 +139,14 @@ struct Options {
   std::chrono::milliseconds findtime_avg_time_ago = std::chrono::minutes(30);
   Log2Histogram findtime_timestamp_distribution;
 
+  // Options of "catchup_storm" bench.
+  std::chrono::milliseconds catchup_pause_duration = std::chrono::minutes(1);
+  bool catchup_stop_reading;
+
+  // Options of "trace_replay" bench.
+  std::string trace_file;
+  double trace_rate_multiplier;
+
   // Populates the given options description with the options pointing to fields
   // of this Options instance.
   void get_named_options(boost::program_options::options_description&);
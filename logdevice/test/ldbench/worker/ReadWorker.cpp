@@ -14,6 +14,7 @@
 #include <thread>
 #include <unordered_set>
 
+#include <folly/Format.h>
 #include <folly/Random.h>
 #include <folly/ThreadLocal.h>
 
@@ -25,6 +26,7 @@
 #include "logdevice/common/stats/Histogram.h"
 #include "logdevice/common/util.h"
 #include "logdevice/include/types.h"
+#include "logdevice/lib/ClientImpl.h"
 #include "logdevice/lib/ClientSettingsImpl.h"
 #include "logdevice/test/ldbench/worker/LogStoreClientHolder.h"
 #include "logdevice/test/ldbench/worker/LogStoreReader.h"
@@ -128,6 +130,30 @@ class ReadWorker final : public Worker {
 
   void maybeSetBacklogDepth(LogTailerState* tailer);
 
+  // Cumulative client CPU time in each stage of the read path, exclusive of
+  // the other stages. Measured with --client-read-stage-timing.
+  struct ReadStageTimes {
+    // Parsing RECORD and GAP messages and everything on the worker before
+    // and after ClientReadStream.
+    int64_t receive_usec = 0;
+    // ClientReadStream buffering, gap detection and flow control.
+    int64_t stream_usec = 0;
+    // Decoding buffered writes.
+    int64_t decode_usec = 0;
+    // Running our record callbacks.
+    int64_t callback_usec = 0;
+    // The rest of AsyncReader's delivery, e.g. gap callbacks.
+    int64_t other_usec = 0;
+  };
+
+  // Returns folly::none if the client doesn't measure the stages.
+  folly::Optional<ReadStageTimes> getReadStageTimes() const;
+  void printReadStageTimes(const char* what,
+                           const ReadStageTimes& times,
+                           const ReadStageTimes& prev,
+                           uint64_t nrecords,
+                           double seconds);
+
   std::atomic<uint64_t> nrecords_{0};
   std::atomic<uint64_t> ngaps_{0};
   std::atomic<uint64_t> nrestarts_{0};
@@ -141,6 +167,7 @@ class ReadWorker final : public Worker {
   // Values of the above atomic at the time of previous call to printProgress().
   uint64_t prev_nrecords_ = 0;
   uint64_t prev_nbytes_ = 0;
+  ReadStageTimes prev_stage_times_;
 
   std::vector<ReaderState> readers_;
   std::unordered_map<logid_t, LogState, logid_t::Hash> logs_;
@@ -666,6 +693,15 @@ int ReadWorker::run() {
     // startReading() we always check isStopped().
   }
 
+  auto stage_times = getReadStageTimes();
+  if (stage_times.hasValue()) {
+    printReadStageTimes("total",
+                        *stage_times,
+                        ReadStageTimes(),
+                        nrecords_.load(),
+                        actual_duration_ms.count() / 1000.);
+  }
+
   ld_info("Destroying readers");
   for (auto& r : readers_) {
     r.reader.reset();
@@ -687,8 +723,8 @@ void ReadWorker::printProgress(double seconds_since_start,
                                double seconds_since_last_call) {
   uint64_t nrecords = nrecords_.load();
   uint64_t nbytes = nbytes_.load();
-  double records_per_sec =
-      (nrecords - prev_nrecords_) / seconds_since_last_call;
+  uint64_t interval_records = nrecords - prev_nrecords_;
+  double records_per_sec = interval_records / seconds_since_last_call;
   double bytes_per_sec = (nbytes - prev_nbytes_) / seconds_since_last_call;
 
   prev_nrecords_ = nrecords;
@@ -708,6 +744,77 @@ void ReadWorker::printProgress(double seconds_since_start,
           num_tailers_,
           commaprint_r((uint64_t)records_per_sec, &bufs[2][0], 32),
           commaprint_r((uint64_t)bytes_per_sec, &bufs[3][0], 32));
+
+  auto stage_times = getReadStageTimes();
+  if (stage_times.hasValue()) {
+    printReadStageTimes("last interval",
+                        *stage_times,
+                        prev_stage_times_,
+                        interval_records,
+                        seconds_since_last_call);
+    prev_stage_times_ = *stage_times;
+  }
+}
+
+folly::Optional<ReadWorker::ReadStageTimes>
+ReadWorker::getReadStageTimes() const {
+  if (options.sys_name != "logdevice" || options.pretend) {
+    return folly::none;
+  }
+  auto client_settings =
+      dynamic_cast<ClientSettingsImpl*>(&client_->settings());
+  ld_check(client_settings != nullptr);
+  if (!client_settings->getSettings()->client_read_stage_timing) {
+    return folly::none;
+  }
+  StatsHolder* holder = static_cast<ClientImpl*>(client_.get())->stats();
+  if (holder == nullptr) {
+    return folly::none;
+  }
+  Stats stats = holder->aggregate();
+  int64_t worker_usec = 0;
+  for (MessageType type : {MessageType::RECORD, MessageType::GAP}) {
+    const auto& per_type = stats.per_message_type_stats[static_cast<int>(type)];
+    worker_usec += per_type.message_worker_usec;
+  }
+  // The stats are nested, see common_stats.inc. The delivery of records
+  // redelivered on a timer isn't part of handling a message, hence the
+  // clamping.
+  auto exclusive = [](int64_t total, int64_t nested) {
+    return std::max<int64_t>(0, total - nested);
+  };
+  ReadStageTimes times;
+  times.receive_usec = exclusive(worker_usec, stats.client_read_stream_usec);
+  times.stream_usec =
+      exclusive(stats.client_read_stream_usec, stats.client_read_delivery_usec);
+  times.decode_usec = stats.client_read_decode_usec;
+  times.callback_usec = stats.client_read_callback_usec;
+  times.other_usec = exclusive(
+      stats.client_read_delivery_usec,
+      stats.client_read_decode_usec + stats.client_read_callback_usec);
+  return times;
+}
+
+void ReadWorker::printReadStageTimes(const char* what,
+                                     const ReadStageTimes& times,
+                                     const ReadStageTimes& prev,
+                                     uint64_t nrecords,
+                                     double seconds) {
+  // Prints CPU usage of a stage as a percentage of one core, and per record.
+  auto stage = [&](int64_t usec, int64_t prev_usec) {
+    int64_t diff = std::max<int64_t>(0, usec - prev_usec);
+    return folly::sformat("{:.1f}% ({:.2f}us/rec)",
+                          seconds > 0 ? diff / seconds / 1e4 : 0.,
+                          nrecords > 0 ? double(diff) / nrecords : 0.);
+  };
+  ld_info("client read CPU, %s: receive: %s, read stream: %s, decode: %s, "
+          "callback: %s, other delivery: %s",
+          what,
+          stage(times.receive_usec, prev.receive_usec).c_str(),
+          stage(times.stream_usec, prev.stream_usec).c_str(),
+          stage(times.decode_usec, prev.decode_usec).c_str(),
+          stage(times.callback_usec, prev.callback_usec).c_str(),
+          stage(times.other_usec, prev.other_usec).c_str());
 }
 
 void ReadWorker::dumpDebugInfo() {
@@ -0,0 +1,74 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "logdevice/test/ldbench/worker/RunSummary.h"
+
+#include <folly/Format.h>
+#include <folly/Hash.h>
+
+#include "logdevice/common/BuildInfo.h"
+#include "logdevice/test/ldbench/worker/Options.h"
+
+namespace facebook { namespace logdevice { namespace ldbench {
+
+std::string hashOptions(const std::map<std::string, std::string>& values) {
+  uint64_t hash = folly::hash::FNV_64_HASH_START;
+  for (const auto& kv : values) {
+    if (kv.first == "publish-dir" || kv.first == "worker-id-index") {
+      continue;
+    }
+    // Include the separators, so that e.g. {"ab": "c"} and {"a": "bc"} are
+    // different.
+    hash = folly::hash::fnv64_buf(kv.first.data(), kv.first.size(), hash);
+    hash = folly::hash::fnv64_buf("=", 1, hash);
+    hash = folly::hash::fnv64_buf(kv.second.data(), kv.second.size(), hash);
+    hash = folly::hash::fnv64_buf("\n", 1, hash);
+  }
+  return folly::sformat("{:016x}", hash);
+}
+
+folly::dynamic buildRunSummary(BuildInfo* build_info,
+                               const folly::dynamic& stats,
+                               double duration_sec) {
+  folly::dynamic build = folly::dynamic::object("version", LOGDEVICE_VERSION);
+  if (build_info) {
+    build["version"] = build_info->version();
+    build["revision"] = build_info->buildRevision();
+    build["upstream_revision"] = build_info->buildUpstreamRevision();
+    build["build_time"] = build_info->buildTime();
+    build["package"] = build_info->packageNameWithVersion();
+  }
+
+  folly::dynamic opts = folly::dynamic::object;
+  for (const auto& kv : options.command_line_options) {
+    opts[kv.first] = kv.second;
+  }
+  folly::dynamic settings = folly::dynamic::object;
+  for (const auto& kv : options.command_line_settings) {
+    settings[kv.first] = kv.second;
+  }
+
+  folly::dynamic results = stats;
+  results["duration_sec"] = duration_sec;
+  if (duration_sec > 0 && stats.isObject()) {
+    results["success_per_sec"] =
+        stats.getDefault("success", 0).asInt() / duration_sec;
+    results["success_byte_per_sec"] =
+        stats.getDefault("success_byte", 0).asInt() / duration_sec;
+  }
+
+  return folly::dynamic::object("bench_name", options.bench_name)(
+      "worker_id_index", options.worker_id_index)("build", std::move(build))(
+      "options", std::move(opts))(
+      "options_hash", hashOptions(options.command_line_options))(
+      "client_settings", std::move(settings))(
+      "client_settings_hash", hashOptions(options.command_line_settings))(
+      "results", std::move(results));
+}
+
+}}} // namespace facebook::logdevice::ldbench
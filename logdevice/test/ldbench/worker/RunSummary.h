@@ -0,0 +1,47 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <map>
+#include <string>
+
+#include <folly/dynamic.h>
+
+namespace facebook { namespace logdevice {
+
+class BuildInfo;
+
+namespace ldbench {
+
+/**
+ * Returns a hex digest of the given name -> value map that doesn't depend on
+ * the order in which the options were given. Options that differ between the
+ * workers of the same run (publish-dir, worker-id-index) are ignored, so that
+ * all workers of a run, and runs with the same configuration, get the same
+ * hash.
+ */
+std::string hashOptions(const std::map<std::string, std::string>& values);
+
+/**
+ * Builds the machine-readable summary of a finished run, written to
+ * <publish-dir>/summary_<bench><worker-id-index>_.json. Contains:
+ *  - "build": version and revision of the binary, from `build_info`,
+ *  - "options" and "client_settings": what was given on the command line,
+ *    and their hashes, "options_hash" and "client_settings_hash", so that
+ *    results of comparable runs can be matched,
+ *  - "results": final cumulative `stats`, as published in the stats file,
+ *    plus throughput over `duration_sec`.
+ *
+ * @param build_info  may be nullptr.
+ */
+folly::dynamic buildRunSummary(BuildInfo* build_info,
+                               const folly::dynamic& stats,
+                               double duration_sec);
+
+}}} // namespace facebook::logdevice::ldbench
@@ -0,0 +1,54 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "logdevice/test/ldbench/worker/RunSummary.h"
+
+#include <gtest/gtest.h>
+
+#include "logdevice/test/ldbench/worker/Options.h"
+
+namespace facebook { namespace logdevice { namespace ldbench {
+
+TEST(RunSummaryTest, hashOptions) {
+  std::map<std::string, std::string> a = {
+      {"bench-name", "write"}, {"duration", "60"}};
+  std::string hash = hashOptions(a);
+  EXPECT_EQ(16, hash.size());
+
+  // Options that differ between workers of the same run are ignored.
+  auto b = a;
+  b["publish-dir"] = "/tmp/results";
+  b["worker-id-index"] = "3";
+  EXPECT_EQ(hash, hashOptions(b));
+
+  b["duration"] = "61";
+  EXPECT_NE(hash, hashOptions(b));
+
+  // Keys and values can't be confused.
+  EXPECT_NE(hashOptions({{"ab", "c"}}), hashOptions({{"a", "bc"}}));
+}
+
+TEST(RunSummaryTest, buildRunSummary) {
+  options.bench_name = "write";
+  options.command_line_options = {{"bench-name", "write"}};
+  options.command_line_settings = {{"num-workers", "4"}};
+
+  folly::dynamic stats =
+      folly::dynamic::object("success", 1000)("success_byte", 4000);
+  folly::dynamic summary = buildRunSummary(nullptr, stats, 10.);
+  EXPECT_EQ("write", summary["bench_name"].asString());
+  EXPECT_EQ("4", summary["client_settings"]["num-workers"].asString());
+  EXPECT_EQ(hashOptions(options.command_line_options),
+            summary["options_hash"].asString());
+  EXPECT_TRUE(summary["build"].count("version"));
+  EXPECT_EQ(1000, summary["results"]["success"].asInt());
+  EXPECT_DOUBLE_EQ(100., summary["results"]["success_per_sec"].asDouble());
+  EXPECT_DOUBLE_EQ(400., summary["results"]["success_byte_per_sec"].asDouble());
+}
+
+}}} // namespace facebook::logdevice::ldbench
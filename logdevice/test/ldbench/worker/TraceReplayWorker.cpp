@@ -0,0 +1,409 @@
+/**
+ * Copyright (c) 2017-present, Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <folly/FileUtil.h>
+#include <folly/hash/Hash.h>
+
+#include "logdevice/common/LibeventTimer.h"
+#include "logdevice/common/debug.h"
+#include "logdevice/common/util.h"
+#include "logdevice/include/AsyncReader.h"
+#include "logdevice/include/Client.h"
+#include "logdevice/include/Err.h"
+#include "logdevice/include/Record.h"
+#include "logdevice/include/types.h"
+#include "logdevice/test/ldbench/worker/BenchStats.h"
+#include "logdevice/test/ldbench/worker/LogStoreClientHolder.h"
+#include "logdevice/test/ldbench/worker/Options.h"
+#include "logdevice/test/ldbench/worker/Worker.h"
+#include "logdevice/test/ldbench/worker/WorkerRegistry.h"
+#include "logdevice/test/ldbench/worker/util.h"
+
+namespace facebook { namespace logdevice { namespace ldbench {
+namespace {
+
+static constexpr const char* BENCH_NAME = "trace_replay";
+
+/**
+ * Trace replay benchmark worker.
+ *
+ * Replays the traffic shape described by --trace-file (see TrafficTrace and
+ * doc/ldbench.md): for each log of this worker's partition, appends at the
+ * per-log rate curve of the trace, with payload sizes and burstiness from the
+ * trace, and keeps the given number of readers tailing the log, each starting
+ * at the tail or at a point in the past drawn from the trace's backlog
+ * distribution. Append rates can be scaled with --trace-rate-multiplier.
+ *
+ * Appends are scheduled like in the "write" bench, including --open-loop and
+ * the in-flight limits, and their latency is published in BenchStats.
+ */
+class TraceReplayWorker final : public Worker {
+ public:
+  using Worker::Worker;
+  ~TraceReplayWorker() override;
+  int run() override;
+
+ private:
+  struct LogState {
+    explicit LogState(const TrafficTrace::LogTraffic& t)
+        : traffic(t), append_generator(t.spikiness) {}
+
+    const TrafficTrace::LogTraffic& traffic;
+    RandomEventSequence append_generator;
+    RandomEventSequence::State append_generator_state;
+    // Index of the current step of traffic.appends_per_sec, not wrapped
+    // around.
+    uint64_t step = 0;
+    LibeventTimer next_append_timer;
+    // steadyTime() at which next_append_timer is supposed to fire.
+    double next_append_time;
+  };
+
+  struct ReaderState {
+    explicit ReaderState(logid_t log) : log_id(log) {}
+
+    logid_t log_id;
+    std::unique_ptr<AsyncReader> reader;
+  };
+
+  // Initializes the append generator of `state` for its current step,
+  // starting at `time`.
+  void startStep(LogState* state, double time);
+  // Returns the time of the next append to the log.
+  double nextAppendTime(LogState* state);
+  // Appends whatever is due and schedules the next append.
+  void onAppendTimer(LogState* state);
+  void maybeAppend(LogState* state, double intended_time);
+
+  void startReader(ReaderState* state, double backlog_sec);
+  void onReaderStartLSN(ReaderState* state, Status st, lsn_t from_lsn);
+
+  void onAppendDone(LogIDType log_id,
+                    bool successful,
+                    bool buffered,
+                    uint64_t num_records,
+                    uint64_t payload_bytes) override;
+
+  void printProgress(double seconds_since_start,
+                     double seconds_since_last_call) override;
+
+  TrafficTrace trace_;
+  std::unordered_map<logid_t, std::unique_ptr<LogState>, logid_t::Hash> logs_;
+  std::vector<std::unique_ptr<ReaderState>> readers_;
+  double start_time_;
+
+  std::atomic<uint64_t> appends_in_flight_{0};
+  std::atomic<uint64_t> append_bytes_in_flight_{0};
+  std::atomic<uint64_t> appends_succeeded_{0};
+  std::atomic<uint64_t> appends_failed_{0};
+  std::atomic<uint64_t> appends_skipped_{0};
+  std::atomic<uint64_t> bytes_appended_since_last_call_{0};
+
+  std::atomic<uint64_t> readers_started_{0};
+  std::atomic<uint64_t> readers_failed_{0};
+  std::atomic<uint64_t> records_read_{0};
+  std::atomic<uint64_t> bytes_read_{0};
+  std::atomic<uint64_t> bytes_read_since_last_call_{0};
+};
+
+static double steadyTime() {
+  return std::chrono::duration_cast<std::chrono::duration<double>>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+TraceReplayWorker::~TraceReplayWorker() {
+  // Make sure no callbacks are called after this subclass is destroyed.
+  readers_.clear();
+  destroyClient();
+}
+
+void TraceReplayWorker::startStep(LogState* state, double time) {
+  const auto& rates = state->traffic.appends_per_sec;
+  double rate =
+      rates[state->step % rates.size()] * options.trace_rate_multiplier;
+  // Shift spikes the same way in every step and on every worker.
+  double z = folly::hash::hash_128_to_64(state->traffic.log_id, 152004) /
+      (std::numeric_limits<uint64_t>::max() + 1.);
+  state->append_generator_state =
+      state->append_generator.newState(rate, time, z);
+}
+
+double TraceReplayWorker::nextAppendTime(LogState* state) {
+  while (true) {
+    double step_end = start_time_ + (state->step + 1) * trace_.step_sec;
+    double t = state->append_generator.nextEvent(state->append_generator_state);
+    if (t < step_end) {
+      return t;
+    }
+    // No more appends in this step. Poisson process is memoryless, so we can
+    // just start a new sequence at the end of the step.
+    ++state->step;
+    startStep(state, step_end);
+  }
+}
+
+void TraceReplayWorker::onAppendTimer(LogState* state) {
+  double now = steadyTime();
+  double t = state->next_append_time;
+  while (t < now) {
+    if (t >= now - 0.010 || options.open_loop) {
+      // Libevent timers have ~1ms granularity, so we may need to do multiple
+      // appends per timer callback. See WriteWorker.
+      maybeAppend(state, t);
+    } else {
+      // We're too far behind. Skip appends to avoid falling behind
+      // indefinitely far.
+      ++appends_skipped_;
+      client_holder_->getBenchStatsHolder()->getOrCreateTLStats()->incStat(
+          StatsType::SKIPPED, 1);
+    }
+    t = nextAppendTime(state);
+  }
+  state->next_append_time = t;
+  state->next_append_timer.activate(
+      std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::duration<double>(t - now)));
+}
+
+void TraceReplayWorker::maybeAppend(LogState* state, double intended_time) {
+  if (!options.open_loop &&
+      (append_bytes_in_flight_.load() >= options.max_append_bytes_in_flight ||
+       appends_in_flight_.load() >= options.max_appends_in_flight)) {
+    ++appends_skipped_;
+    client_holder_->getBenchStatsHolder()->getOrCreateTLStats()->incStat(
+        StatsType::SKIPPED, 1);
+    return;
+  }
+
+  uint64_t payload_size = (uint64_t)state->traffic.payload_size.sample();
+  auto intended_start = std::chrono::steady_clock::time_point(
+      std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+          std::chrono::duration<double>(intended_time)));
+  bool ok = client_holder_->append(
+      state->traffic.log_id,
+      generatePayload(payload_size),
+      LogStoreClientHolder::intendedStartContext(intended_start));
+  if (ok) {
+    ++appends_in_flight_;
+    append_bytes_in_flight_ += payload_size;
+  } else {
+    ++appends_failed_;
+  }
+}
+
+void TraceReplayWorker::onAppendDone(LogIDType /* log_id */,
+                                     bool successful,
+                                     bool /* buffered */,
+                                     uint64_t num_records,
+                                     uint64_t payload_bytes) {
+  if (successful) {
+    appends_succeeded_ += num_records;
+    bytes_appended_since_last_call_ += payload_bytes;
+  } else {
+    appends_failed_ += num_records;
+  }
+  appends_in_flight_ -= num_records;
+  append_bytes_in_flight_ -= payload_bytes;
+}
+
+void TraceReplayWorker::startReader(ReaderState* state, double backlog_sec) {
+  state->reader = client_->createAsyncReader();
+  state->reader->setRecordCallback(
+      [this](std::unique_ptr<DataRecord>& record) {
+        ++records_read_;
+        bytes_read_ += record->payload.size();
+        bytes_read_since_last_call_ += record->payload.size();
+        return true;
+      });
+  state->reader->setGapCallback([](const GapRecord&) { return true; });
+
+  int rv;
+  if (backlog_sec > 0) {
+    auto ts = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch() -
+        std::chrono::duration<double>(backlog_sec));
+    rv = findTime(state->log_id, ts, [this, state](Status st, lsn_t lsn) {
+      onReaderStartLSN(state, st, lsn);
+    });
+  } else {
+    rv = getTailLSN(state->log_id, [this, state](Status st, lsn_t lsn) {
+      onReaderStartLSN(state, st, lsn == LSN_INVALID ? LSN_OLDEST : lsn + 1);
+    });
+  }
+  if (rv != 0) {
+    onReaderStartLSN(state, err, LSN_INVALID);
+  }
+}
+
+void TraceReplayWorker::onReaderStartLSN(ReaderState* state,
+                                         Status st,
+                                         lsn_t from_lsn) {
+  if (st == E::OK) {
+    auto attrs = getReadAttrs();
+    if (state->reader->startReading(
+            state->log_id, from_lsn, LSN_MAX, &attrs) == 0) {
+      ++readers_started_;
+      return;
+    }
+    st = err;
+  }
+  ++readers_failed_;
+  RATELIMIT_ERROR(std::chrono::seconds(10),
+                  2,
+                  "Failed to start reader of log %" PRIu64 ": %s",
+                  state->log_id.val(),
+                  error_name(st));
+}
+
+void TraceReplayWorker::printProgress(double seconds_since_start,
+                                      double seconds_since_last_call) {
+  std::array<std::array<char, 32>, 6> bufs; // for commaprint_r()
+  ld_info(
+      "ran for: %.3fs, appends: %s ok, %s failed, %s skipped, "
+      "append bytes/sec: %s, readers: %s, read bytes/sec: %s",
+      seconds_since_start,
+      commaprint_r(appends_succeeded_.load(), &bufs[0][0], 32),
+      commaprint_r(appends_failed_.load(), &bufs[1][0], 32),
+      commaprint_r(appends_skipped_.load(), &bufs[2][0], 32),
+      commaprint_r(uint64_t(bytes_appended_since_last_call_.exchange(0) /
+                            seconds_since_last_call),
+                   &bufs[3][0],
+                   32),
+      commaprint_r(readers_started_.load(), &bufs[4][0], 32),
+      commaprint_r(uint64_t(bytes_read_since_last_call_.exchange(0) /
+                            seconds_since_last_call),
+                   &bufs[5][0],
+                   32));
+}
+
+int TraceReplayWorker::run() {
+  std::string contents;
+  if (!folly::readFile(options.trace_file.c_str(), contents)) {
+    ld_error("Failed to read trace file %s", options.trace_file.c_str());
+    return 1;
+  }
+  std::string error;
+  if (!trace_.parse(contents, &error)) {
+    ld_error("Invalid trace file %s: %s",
+             options.trace_file.c_str(),
+             error.c_str());
+    return 1;
+  }
+
+  std::vector<logid_t> all_logs;
+  std::unordered_map<logid_t, const TrafficTrace::LogTraffic*, logid_t::Hash>
+      traffic;
+  for (const auto& t : trace_.logs) {
+    all_logs.push_back(logid_t(t.log_id));
+    traffic[logid_t(t.log_id)] = &t;
+  }
+  auto logs = getLogsPartition(all_logs);
+  if (logs.empty()) {
+    return 0;
+  }
+
+  for (logid_t log : logs) {
+    const auto& t = *traffic.at(log);
+    for (uint64_t i = 0; i < t.readers; ++i) {
+      readers_.push_back(std::make_unique<ReaderState>(log));
+    }
+  }
+
+  ev_->add([&] {
+    waitUntilStartTime();
+    start_time_ = steadyTime();
+
+    ld_info("Starting %zu readers", readers_.size());
+    for (auto& reader : readers_) {
+      const auto& t = *traffic.at(reader->log_id);
+      startReader(
+          reader.get(), t.has_read_backlog ? t.read_backlog_sec.sample() : 0);
+    }
+
+    ld_info("Starting appends in %zu logs", logs.size());
+    for (logid_t log : logs) {
+      const auto& t = *traffic.at(log);
+      if (std::all_of(t.appends_per_sec.begin(),
+                      t.appends_per_sec.end(),
+                      [](double x) { return x == 0; }) ||
+          options.trace_rate_multiplier == 0) {
+        // Read-only log.
+        continue;
+      }
+      auto state = std::make_unique<LogState>(t);
+      LogState* s = state.get();
+      logs_.emplace(log, std::move(state));
+      s->next_append_timer.assign(
+          &ev_->getEvBase(), [this, s] { onAppendTimer(s); });
+      startStep(s, start_time_);
+      s->next_append_time = nextAppendTime(s);
+      s->next_append_timer.activate(
+          std::chrono::duration_cast<std::chrono::microseconds>(
+              std::chrono::duration<double>(
+                  std::max(0., s->next_append_time - steadyTime()))));
+    }
+  });
+
+  std::chrono::milliseconds actual_duration_ms = sleepForDurationOfTheBench();
+
+  ld_info("Stopping appends and readers");
+  executeOnEventLoopSync([&] {
+    for (auto& kv : logs_) {
+      kv.second->next_append_timer.cancel();
+    }
+  });
+  for (auto& reader : readers_) {
+    if (reader->reader) {
+      reader->reader->stopReading(reader->log_id);
+    }
+  }
+  while (appends_in_flight_.load() > 0) {
+    /* sleep override */
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+
+  std::cout << actual_duration_ms.count() << ' ' << appends_succeeded_ << ' '
+            << appends_failed_ << ' ' << appends_skipped_ << ' '
+            << readers_started_ << ' ' << readers_failed_ << ' '
+            << records_read_ << ' ' << bytes_read_ << std::endl;
+  return 0;
+}
+
+} // namespace
+
+void registerTraceReplayWorker() {
+  registerWorkerImpl(BENCH_NAME,
+                     []() -> std::unique_ptr<Worker> {
+                       return std::make_unique<TraceReplayWorker>();
+                     },
+                     OptionsRestrictions({"duration",
+                                          "trace-file",
+                                          "trace-rate-multiplier",
+                                          "max-appends-in-flight",
+                                          "max-append-bytes-in-flight",
+                                          "open-loop",
+                                          "start-time",
+                                          "filter-type"},
+                                         {PartitioningMode::LOG}));
+}
+
+}}} // namespace facebook::logdevice::ldbench
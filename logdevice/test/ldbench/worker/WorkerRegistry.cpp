@@ -26,6 +26,8 @@ const WorkerFactoryMap& getWorkerFactoryMap() {
   registerWriteSaturationWorker();
   registerIsLogEmptyWorker();
   registerFindTimeWorker();
+  registerCatchupStormWorker();
+  registerTraceReplayWorker();
 
   return getWorkerFactoryMapImpl();
 }
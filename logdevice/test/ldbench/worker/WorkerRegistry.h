@@ -67,6 +67,8 @@ void registerReadYourWriteLatencyWorker();
 void registerWriteSaturationWorker();
 void registerIsLogEmptyWorker();
 void registerFindTimeWorker();
+void registerCatchupStormWorker();
+void registerTraceReplayWorker();
 
 } // namespace ldbench
 }} // namespace facebook::logdevice
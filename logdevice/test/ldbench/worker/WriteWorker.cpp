@@ -6,7 +6,9 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <chrono>
 #include <iostream>
+#include <vector>
 
 #include "logdevice/common/LibeventTimer.h"
 #include "logdevice/common/Random.h"
@@ -32,6 +34,11 @@ class WriteWorker final : public Worker {
 
     RandomEventSequence::State append_generator_state;
     LibeventTimer next_append_timer;
+    // steadyTime() at which next_append_timer is supposed to fire.
+    double next_append_time = 0;
+    // Intended start times of the appends to do in the current timer
+    // callback. See activateNextAppendTimer().
+    std::vector<double> due_append_times;
     double payload_size_multiplier;
 
     // See makePayload() for explanation.
@@ -41,11 +48,16 @@ class WriteWorker final : public Worker {
     explicit LogState(logid_t log) : log_id(log) {}
   };
 
-  // Returns how many appends we need to do now. Typically 1, but can be more
-  // if timer is ticking slower than our target rate of appends.
-  size_t activateNextAppendTimer(LogState* state);
+  // Fills state->due_append_times with the intended start times of the
+  // appends we need to do now. Typically 1, but can be more if timer is
+  // ticking slower than our target rate of appends.
+  void activateNextAppendTimer(LogState* state);
 
-  void maybeAppend(LogState* state);
+  // Appends a record, unless in-flight limits are exceeded. intended_time is
+  // the steadyTime() at which the append was scheduled; latency is measured
+  // from it, so that appends delayed by a late timer or a busy event loop are
+  // not reported as faster than they were.
+  void maybeAppend(LogState* state, double intended_time);
 
   void updateThroughput();
 
@@ -238,10 +250,11 @@ void WriteWorker::printProgress(double seconds_since_start,
           commaprint_r(uint64_t(bytes_per_sec), &bufs[5][0], 32));
 }
 
-size_t WriteWorker::activateNextAppendTimer(LogState* state) {
+void WriteWorker::activateNextAppendTimer(LogState* state) {
   double now = steadyTime();
   double t;
-  size_t to_append = 1;
+  state->due_append_times.clear();
+  state->due_append_times.push_back(state->next_append_time);
   while (true) {
     t = append_generator_.nextEvent(state->append_generator_state);
     if (t >= now) {
@@ -255,8 +268,12 @@ size_t WriteWorker::activateNextAppendTimer(LogState* state) {
     if (t >= now - 0.010) { // 10 ms ago
       // If we missed a few events because the timer was a little late, let's
       // do as many extra appends as many events we missed.
-      ++to_append;
+      state->due_append_times.push_back(t);
       STAT_INCR(stats_.get(), ldbench->writer_append_timer_slightly_late);
+    } else if (options.open_loop) {
+      // In open-loop mode we never drop appends, however far behind we are.
+      // Their latency will include the time they spent waiting here.
+      state->due_append_times.push_back(t);
     } else {
       // But if we're too far behind, it means we're probably out of CPU and
       // can't keep up with the append rate.
@@ -267,20 +284,23 @@ size_t WriteWorker::activateNextAppendTimer(LogState* state) {
           StatsType::SKIPPED, 1);
     }
   }
+  state->next_append_time = t;
   state->next_append_timer.activate(
       std::chrono::duration_cast<std::chrono::microseconds>(
           std::chrono::duration<double>(t - now)));
-  return to_append;
 }
 
-void WriteWorker::maybeAppend(LogState* state) {
-  if (append_bytes_in_flight_.load() >= options.max_append_bytes_in_flight) {
+void WriteWorker::maybeAppend(LogState* state, double intended_time) {
+  // In open-loop mode in-flight limits don't apply.
+  if (!options.open_loop &&
+      append_bytes_in_flight_.load() >= options.max_append_bytes_in_flight) {
     ++appends_skipped_;
     STAT_INCR(stats_.get(), ldbench->writer_appends_skipped_bytes_in_flight);
     client_holder_->getBenchStatsHolder()->getOrCreateTLStats()->incStat(
         StatsType::SKIPPED, 1);
     return;
-  } else if (appends_in_flight_.load() >= options.max_appends_in_flight) {
+  } else if (!options.open_loop &&
+             appends_in_flight_.load() >= options.max_appends_in_flight) {
     ++appends_skipped_;
     STAT_INCR(stats_.get(), ldbench->writer_appends_skipped_appends_in_flight);
     client_holder_->getBenchStatsHolder()->getOrCreateTLStats()->incStat(
@@ -315,9 +335,13 @@ void WriteWorker::maybeAppend(LogState* state) {
     });
     failed = false;
   } else {
-    failed = !(client_holder_->append(state->log_id.val(),
-                                      std::move(payload),
-                                      reinterpret_cast<void*>(payload_size)));
+    auto intended_start = std::chrono::steady_clock::time_point(
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(intended_time)));
+    failed = !(client_holder_->append(
+        state->log_id.val(),
+        std::move(payload),
+        LogStoreClientHolder::intendedStartContext(intended_start)));
   }
   if (failed) {
     ++appends_failed_;
@@ -488,9 +512,9 @@ int WriteWorker::run() {
     for (auto& kv : logs_) {
       auto state = kv.second.get();
       state->next_append_timer.assign(&ev_->getEvBase(), [this, state] {
-        size_t to_append = activateNextAppendTimer(state);
-        for (size_t i = 0; i < to_append; ++i) {
-          maybeAppend(state);
+        activateNextAppendTimer(state);
+        for (double intended_time : state->due_append_times) {
+          maybeAppend(state, intended_time);
         }
       });
     }
@@ -581,6 +605,7 @@ void registerWriteWorker() {
                              "payload-entropy-sequencer",
                              "start-time",
                              "record-writer-info",
+                             "open-loop",
                          },
                          {PartitioningMode::LOG, PartitioningMode::RECORD},
                          OptionsRestrictions::AllowBufferedWriterOptions::YES));
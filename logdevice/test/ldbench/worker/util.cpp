@@ -9,7 +9,10 @@
 #include "logdevice/test/ldbench/worker/util.h"
 
 #include <algorithm>
+#include <chrono>
+#include <unordered_set>
 
+#include <folly/Conv.h>
 #include <folly/Random.h>
 #include <folly/String.h>
 
@@ -362,4 +365,119 @@ double RandomEventSequence::nextEvent(State& state) const {
   return spikiness.transform(state.prev_virtual_time) + state.offset;
 }
 
+bool TrafficTrace::parse(const std::string& s, std::string* out_error) {
+  size_t line_num = 0;
+#define ERR(msg)                                                          \
+  do {                                                                    \
+    if (out_error) {                                                      \
+      *out_error = folly::to<std::string>("line ", line_num, ": ", msg); \
+    }                                                                     \
+    return false;                                                         \
+  } while (false)
+
+  step_sec = 60;
+  logs.clear();
+  std::unordered_set<uint64_t> seen_logs;
+  std::vector<folly::StringPiece> lines;
+  folly::split('\n', s, lines);
+  for (folly::StringPiece line : lines) {
+    ++line_num;
+    line = folly::trimWhitespace(line);
+    if (line.empty() || line.startsWith('#')) {
+      continue;
+    }
+
+    std::vector<folly::StringPiece> tokens;
+    folly::split(' ', line, tokens, /* ignoreEmpty */ true);
+    LogTraffic log;
+    bool is_step = false;
+    bool have_log_id = false;
+    bool have_payload_size = false;
+    for (folly::StringPiece token : tokens) {
+      folly::StringPiece key, value;
+      if (!folly::split('=', token, key, value) || value.empty()) {
+        ERR("expected key=value");
+      }
+
+      if (key == "step") {
+        if (tokens.size() != 1) {
+          ERR("step must be on its own line");
+        }
+        std::chrono::duration<double> d;
+        if (parse_chrono_string(value.str(), &d) != 0 || d.count() <= 0) {
+          ERR("invalid step");
+        }
+        step_sec = d.count();
+        is_step = true;
+      } else if (key == "log") {
+        auto id = folly::tryTo<uint64_t>(value);
+        if (!id.hasValue() || !seen_logs.insert(id.value()).second) {
+          ERR("invalid or duplicate log id");
+        }
+        log.log_id = id.value();
+        have_log_id = true;
+      } else if (key == "appends") {
+        std::vector<folly::StringPiece> rates;
+        folly::split(',', value, rates);
+        for (folly::StringPiece r : rates) {
+          auto x = folly::tryTo<double>(r);
+          if (!x.hasValue() || x.value() < 0) {
+            ERR("invalid append rate");
+          }
+          log.appends_per_sec.push_back(x.value());
+        }
+      } else if (key == "payload") {
+        if (!log.payload_size.parse(value.str())) {
+          ERR("invalid payload size histogram");
+        }
+        have_payload_size = true;
+      } else if (key == "spikiness") {
+        std::string error;
+        if (!log.spikiness.parse(value.str(), &error)) {
+          ERR("invalid spikiness: " + error);
+        }
+      } else if (key == "readers") {
+        auto x = folly::tryTo<uint64_t>(value);
+        if (!x.hasValue()) {
+          ERR("invalid number of readers");
+        }
+        log.readers = x.value();
+      } else if (key == "backlog") {
+        if (!log.read_backlog_sec.parse(value.str())) {
+          ERR("invalid backlog histogram");
+        }
+        log.has_read_backlog = true;
+      } else {
+        ERR("unknown key " + key.str());
+      }
+    }
+
+    if (is_step) {
+      continue;
+    }
+    if (!have_log_id) {
+      ERR("missing log");
+    }
+    if (log.appends_per_sec.empty()) {
+      log.appends_per_sec.push_back(0);
+    }
+    if (!have_payload_size &&
+        std::any_of(log.appends_per_sec.begin(),
+                    log.appends_per_sec.end(),
+                    [](double x) { return x > 0; })) {
+      ERR("missing payload");
+    }
+    logs.push_back(std::move(log));
+  }
+
+  if (logs.empty()) {
+    if (out_error) {
+      *out_error = "no logs";
+    }
+    return false;
+  }
+  return true;
+#undef ERR
+}
+
 }}} // namespace facebook::logdevice::ldbench
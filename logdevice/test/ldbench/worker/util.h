@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -164,4 +165,32 @@ struct RandomEventSequence {
   double nextEvent(State& state) const;
 };
 
+// Per-log traffic shape replayed by the "trace_replay" worker. Usually
+// produced offline by aggregating ClientAppendTracer and ClientReadTracer
+// samples. See ldbench.md for the file format.
+struct TrafficTrace {
+  struct LogTraffic {
+    uint64_t log_id;
+    // Average number of appends per second during each consecutive step of
+    // step_sec seconds. Repeats from the beginning when exhausted.
+    std::vector<double> appends_per_sec;
+    // Distribution of payload sizes in bytes.
+    Log2Histogram payload_size;
+    Spikiness spikiness;
+    // Number of readers of the log.
+    uint64_t readers = 0;
+    // Distribution of how far behind the tail, in seconds, readers start
+    // reading. If false, readers start at the tail.
+    bool has_read_backlog = false;
+    Log2Histogram read_backlog_sec;
+  };
+
+  double step_sec = 60;
+  std::vector<LogTraffic> logs;
+
+  // Parses the contents of a trace file.
+  // Returns true on success, false on failure.
+  bool parse(const std::string& s, std::string* out_error = nullptr);
+};
+
 }}} // namespace facebook::logdevice::ldbench